@@ -16,6 +16,19 @@ export LDFLAGS="${LDFLAGS} -s DISABLE_EXCEPTION_CATCHING=1"
 export LDFLAGS="${LDFLAGS} -s ELIMINATE_DUPLICATE_FUNCTIONS=1"
 export LDFLAGS="${LDFLAGS} -s NODEJS_CATCH_EXIT=0"
 export CFLAGS="-Os"
+if [ -n "$LIBSODIUM_WASM_SIMD" ]; then
+  export CFLAGS="${CFLAGS} -msimd128"
+fi
+# LIBSODIUM_WASM_THREADS=<n> fills Argon2 lanes in a pool of n workers;
+# this requires SharedArrayBuffer, so the module must be cross-origin isolated
+if [ -n "$LIBSODIUM_WASM_THREADS" ]; then
+  export CFLAGS="${CFLAGS} -pthread"
+  export LDFLAGS="${LDFLAGS} -s USE_PTHREADS=1"
+  export LDFLAGS="${LDFLAGS} -s PTHREAD_POOL_SIZE=${LIBSODIUM_WASM_THREADS}"
+  export CONFIG_THREADS="--with-pthreads"
+else
+  export CONFIG_THREADS="--without-pthreads"
+fi
 
 echo
 if [ "x$1" = "x--standard" ]; then
@@ -64,7 +77,7 @@ rm -f "$DONE_FILE"
 echo
 
 emconfigure ./configure $CONFIG_EXTRA --disable-shared --prefix="$PREFIX" \
-  --without-pthreads \
+  $CONFIG_THREADS \
   --disable-ssp --disable-asm --disable-pie \
   CFLAGS="$CFLAGS" &&
   emmake make clean
@@ -74,11 +87,20 @@ if [ "$DIST" = yes ]; then
   emccLibsodium() {
     outFile="${1}"
     shift
-    emcc "$CFLAGS" --llvm-lto 1 $CPPFLAGS $LDFLAGS $JS_EXPORTS_FLAGS ${@} \
+    emcc $CFLAGS --llvm-lto 1 $CPPFLAGS $LDFLAGS $JS_EXPORTS_FLAGS ${@} \
       "${PREFIX}/lib/libsodium.a" -o "${outFile}" || exit 1
   }
   emmake make $MAKE_FLAGS install || exit 1
-  emccLibsodium "${PREFIX}/lib/libsodium.asm.tmp.js" -Oz -s WASM=0
+  if [ -n "$LIBSODIUM_WASM_SIMD" ]; then
+    # There is no asm.js fallback for runtimes without SIMD support
+    echo "reject(new Error('WebAssembly SIMD is not supported'));" \
+      >"${PREFIX}/lib/libsodium.asm.tmp.js"
+  elif [ -n "$LIBSODIUM_WASM_THREADS" ]; then
+    echo "reject(new Error('SharedArrayBuffer is not available'));" \
+      >"${PREFIX}/lib/libsodium.asm.tmp.js"
+  else
+    emccLibsodium "${PREFIX}/lib/libsodium.asm.tmp.js" -Oz -s WASM=0
+  fi
   emccLibsodium "${PREFIX}/lib/libsodium.wasm.tmp.js" -O3 -s WASM=1
 
   cat >"${PREFIX}/lib/libsodium.js" <<-EOM
@@ -21,6 +21,9 @@ mkdir -p $PREFIX || exit 1
 
 export CC="clang"
 export CFLAGS="-DED25519_NONDETERMINISTIC=1 --target=wasm32-wasi --sysroot=${WASI_LIBC} -O2"
+if [ -n "$LIBSODIUM_WASM_SIMD" ]; then
+  export CFLAGS="${CFLAGS} -msimd128"
+fi
 export LDFLAGS="-s -Wl,--stack-first"
 export NM="llvm-nm"
 export AR="llvm-ar"
@@ -2,9 +2,27 @@
 #include <errno.h>
 #include <stdlib.h>
 
+#include "core.h"
 #include "crypto_aead_aegis128l.h"
+#include "crypto_verify_16.h"
+#include "crypto_verify_32.h"
 #include "private/common.h"
+#include "private/implementations.h"
 #include "randombytes.h"
+#include "runtime.h"
+#include "utils.h"
+
+#include "aegis128l.h"
+#include "soft/aead_aegis128l_soft.h"
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+# include "aesni/aead_aegis128l_aesni.h"
+#endif
+#ifdef HAVE_ARMCRYPTO
+# include "armcrypto/aead_aegis128l_armcrypto.h"
+#endif
+
+static const crypto_aead_aegis128l_implementation *implementation =
+    &crypto_aead_aegis128l_soft_implementation;
 
 size_t
 crypto_aead_aegis128l_keybytes(void)
@@ -36,18 +54,84 @@ crypto_aead_aegis128l_messagebytes_max(void)
     return crypto_aead_aegis128l_MESSAGEBYTES_MAX;
 }
 
+size_t
+crypto_aead_aegis128l_statebytes(void)
+{
+    return sizeof(crypto_aead_aegis128l_state);
+}
+
 void
 crypto_aead_aegis128l_keygen(unsigned char k[crypto_aead_aegis128l_KEYBYTES])
 {
     randombytes_buf(k, crypto_aead_aegis128l_KEYBYTES);
 }
 
-#if !((defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)) || \
-      defined(HAVE_ARMCRYPTO))
+size_t
+crypto_aead_aegis128l_macbytes_min(void)
+{
+    return crypto_aead_aegis128l_MACBYTES_MIN;
+}
+
+size_t
+crypto_aead_aegis128l_macbytes_max(void)
+{
+    return crypto_aead_aegis128l_MACBYTES_MAX;
+}
 
-#ifndef ENOSYS
-# define ENOSYS ENXIO
-#endif
+size_t
+crypto_aead_aegis128l_macbytes(void)
+{
+    return crypto_aead_aegis128l_MACBYTES;
+}
+
+int
+crypto_aead_aegis128l_mac(unsigned char *out, size_t outlen, const unsigned char *in,
+                          unsigned long long inlen, const unsigned char *npub,
+                          const unsigned char *k)
+{
+    crypto_aead_aegis128l_state state;
+    int                         ret;
+
+    if (outlen != crypto_aead_aegis128l_MACBYTES_MIN &&
+        outlen != crypto_aead_aegis128l_MACBYTES_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (crypto_aead_aegis128l_mac_init(&state, npub, k) != 0) {
+        return -1;
+    }
+    crypto_aead_aegis128l_mac_update(&state, in, inlen);
+    ret = crypto_aead_aegis128l_mac_final(&state, out, outlen);
+    sodium_memzero(&state, sizeof state);
+
+    return ret;
+}
+
+int
+crypto_aead_aegis128l_mac_final_verify(crypto_aead_aegis128l_state *state,
+                                       const unsigned char *mac, size_t maclen)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[crypto_aead_aegis128l_MACBYTES_MAX];
+    int                            ret;
+
+    if (crypto_aead_aegis128l_mac_final(state, computed_mac, maclen) != 0) {
+        return -1;
+    }
+    if (maclen == 16U) {
+        ret = crypto_verify_16(computed_mac, mac);
+    } else {
+        ret = crypto_verify_32(computed_mac, mac);
+    }
+    sodium_memzero(computed_mac, sizeof computed_mac);
+
+    return ret;
+}
+
+int
+crypto_aead_aegis128l_is_available(void)
+{
+    return 1;
+}
 
 int
 crypto_aead_aegis128l_encrypt_detached(unsigned char *c, unsigned char *mac,
@@ -56,8 +140,8 @@ crypto_aead_aegis128l_encrypt_detached(unsigned char *c, unsigned char *mac,
                                        unsigned long long adlen, const unsigned char *nsec,
                                        const unsigned char *npub, const unsigned char *k)
 {
-    errno = ENOSYS;
-    return -1;
+    return implementation->encrypt_detached(c, mac, maclen_p, m, mlen, ad, adlen,
+                                            nsec, npub, k);
 }
 
 int
@@ -66,8 +150,21 @@ crypto_aead_aegis128l_encrypt(unsigned char *c, unsigned long long *clen_p, cons
                               unsigned long long adlen, const unsigned char *nsec,
                               const unsigned char *npub, const unsigned char *k)
 {
-    errno = ENOSYS;
-    return -1;
+    unsigned long long clen = 0ULL;
+    int                ret;
+
+    if (mlen > crypto_aead_aegis128l_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    ret = implementation->encrypt_detached(c, c + mlen, NULL, m, mlen,
+                                           ad, adlen, nsec, npub, k);
+    if (clen_p != NULL) {
+        if (ret == 0) {
+            clen = mlen + crypto_aead_aegis128l_ABYTES;
+        }
+        *clen_p = clen;
+    }
+    return ret;
 }
 
 int
@@ -76,8 +173,7 @@ crypto_aead_aegis128l_decrypt_detached(unsigned char *m, unsigned char *nsec, co
                                        const unsigned char *ad, unsigned long long adlen,
                                        const unsigned char *npub, const unsigned char *k)
 {
-    errno = ENOSYS;
-    return -1;
+    return implementation->decrypt_detached(m, nsec, c, clen, mac, ad, adlen, npub, k);
 }
 
 int
@@ -86,14 +182,125 @@ crypto_aead_aegis128l_decrypt(unsigned char *m, unsigned long long *mlen_p, unsi
                               const unsigned char *ad, unsigned long long adlen,
                               const unsigned char *npub, const unsigned char *k)
 {
-    errno = ENOSYS;
-    return -1;
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+
+    if (clen >= crypto_aead_aegis128l_ABYTES) {
+        ret = implementation->decrypt_detached(m, nsec, c, clen - crypto_aead_aegis128l_ABYTES,
+                                               c + clen - crypto_aead_aegis128l_ABYTES,
+                                               ad, adlen, npub, k);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_aegis128l_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
 }
 
 int
-crypto_aead_aegis128l_is_available(void)
+crypto_aead_aegis128l_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                                           unsigned char *mac, unsigned long long *maclen_p,
+                                           const crypto_aead_iovec *m, size_t m_count,
+                                           const crypto_aead_iovec *ad, size_t ad_count,
+                                           const unsigned char *nsec,
+                                           const unsigned char *npub, const unsigned char *k)
 {
-    return 0;
+    return implementation->encrypt_detached_iov(c, c_count, mac, maclen_p, m, m_count,
+                                                ad, ad_count, nsec, npub, k);
 }
 
+int
+crypto_aead_aegis128l_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                                           unsigned char *nsec,
+                                           const crypto_aead_iovec *c, size_t c_count,
+                                           const unsigned char *mac,
+                                           const crypto_aead_iovec *ad, size_t ad_count,
+                                           const unsigned char *npub, const unsigned char *k)
+{
+    return implementation->decrypt_detached_iov(m, m_count, nsec, c, c_count, mac,
+                                                ad, ad_count, npub, k);
+}
+
+int
+crypto_aead_aegis128l_init(crypto_aead_aegis128l_state *state, const unsigned char *npub,
+                           const unsigned char *k)
+{
+    return implementation->init(state, npub, k);
+}
+
+int
+crypto_aead_aegis128l_update_ad(crypto_aead_aegis128l_state *state, const unsigned char *ad,
+                                unsigned long long adlen)
+{
+    return implementation->update_ad(state, ad, adlen);
+}
+
+int
+crypto_aead_aegis128l_encrypt_update(crypto_aead_aegis128l_state *state, unsigned char *c,
+                                     const unsigned char *m, unsigned long long mlen)
+{
+    return implementation->encrypt_update(state, c, m, mlen);
+}
+
+int
+crypto_aead_aegis128l_encrypt_final(crypto_aead_aegis128l_state *state, unsigned char *mac)
+{
+    return implementation->encrypt_final(state, mac);
+}
+
+int
+crypto_aead_aegis128l_decrypt_update(crypto_aead_aegis128l_state *state, unsigned char *m,
+                                     const unsigned char *c, unsigned long long clen)
+{
+    return implementation->decrypt_update(state, m, c, clen);
+}
+
+int
+crypto_aead_aegis128l_decrypt_final(crypto_aead_aegis128l_state *state, const unsigned char *mac)
+{
+    return implementation->decrypt_final(state, mac);
+}
+
+int
+crypto_aead_aegis128l_mac_init(crypto_aead_aegis128l_state *state, const unsigned char *npub,
+                               const unsigned char *k)
+{
+    return implementation->mac_init(state, npub, k);
+}
+
+int
+crypto_aead_aegis128l_mac_update(crypto_aead_aegis128l_state *state, const unsigned char *in,
+                                 unsigned long long inlen)
+{
+    return implementation->mac_update(state, in, inlen);
+}
+
+int
+crypto_aead_aegis128l_mac_final(crypto_aead_aegis128l_state *state, unsigned char *out, size_t outlen)
+{
+    return implementation->mac_final(state, out, outlen);
+}
+
+int
+_crypto_aead_aegis128l_pick_best_implementation(void)
+{
+    implementation = &crypto_aead_aegis128l_soft_implementation;
+    _sodium_implementation_selected("aes", "soft");
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+    if (sodium_runtime_has_aesni() &&
+        _sodium_implementation_allowed("aes", "aesni")) {
+        implementation = &crypto_aead_aegis128l_aesni_implementation;
+        _sodium_implementation_selected("aes", "aesni");
+    }
+#endif
+#ifdef HAVE_ARMCRYPTO
+    if (sodium_runtime_has_armcrypto() &&
+        _sodium_implementation_allowed("aes", "armcrypto")) {
+        implementation = &crypto_aead_aegis128l_armcrypto_implementation;
+        _sodium_implementation_selected("aes", "armcrypto");
+    }
 #endif
+    return 0;
+}
@@ -14,8 +14,10 @@
 #include "runtime.h"
 #include "utils.h"
 
+#include "private/aead_iov.h"
 #include "private/common.h"
 #include "private/sse2_64_32.h"
+#include "private/stats.h"
 
 #if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
 
@@ -27,6 +29,8 @@
 #include <tmmintrin.h>
 #include <wmmintrin.h>
 
+#include "aead_aegis128l_aesni.h"
+
 static inline void
 crypto_aead_aegis128l_update(__m128i *const state, const __m128i d1, const __m128i d2)
 {
@@ -47,7 +51,7 @@ crypto_aead_aegis128l_update(__m128i *const state, const __m128i d1, const __m12
 }
 
 static void
-crypto_aead_aegis128l_init(const unsigned char *key, const unsigned char *nonce, __m128i *const state)
+crypto_aead_aegis128l_init_state(const unsigned char *key, const unsigned char *nonce, __m128i *const state)
 {
     const __m128i c1 = _mm_set_epi8(0xdd, 0x28, 0xb5, 0x73, 0x42, 0x31, 0x11, 0x20, 0xf1, 0x2f, 0xc2, 0x6d,
                                     0x55, 0x18, 0x3d, 0xdb);
@@ -74,8 +78,8 @@ crypto_aead_aegis128l_init(const unsigned char *key, const unsigned char *nonce,
 }
 
 static void
-crypto_aead_aegis128l_mac(unsigned char *mac, unsigned long long adlen, unsigned long long mlen,
-                          __m128i *const state)
+crypto_aead_aegis128l_finalize(unsigned char *mac, unsigned long long adlen, unsigned long long mlen,
+                               __m128i *const state)
 {
     __m128i tmp;
     int     i;
@@ -138,20 +142,21 @@ crypto_aead_aegis128l_dec(unsigned char *const dst, const unsigned char *const s
     crypto_aead_aegis128l_update(state, msg0, msg1);
 }
 
-int
-crypto_aead_aegis128l_encrypt_detached(unsigned char *c, unsigned char *mac,
-                                       unsigned long long *maclen_p, const unsigned char *m,
-                                       unsigned long long mlen, const unsigned char *ad,
-                                       unsigned long long adlen, const unsigned char *nsec,
-                                       const unsigned char *npub, const unsigned char *k)
+static int
+aegis128l_aesni_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                 unsigned long long *maclen_p, const unsigned char *m,
+                                 unsigned long long mlen, const unsigned char *ad,
+                                 unsigned long long adlen, const unsigned char *nsec,
+                                 const unsigned char *npub, const unsigned char *k)
 {
     __m128i                        state[8];
     CRYPTO_ALIGN(16) unsigned char src[32];
     CRYPTO_ALIGN(16) unsigned char dst[32];
     unsigned long long i;
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
-    crypto_aead_aegis128l_init(k, npub, state);
+    crypto_aead_aegis128l_init_state(k, npub, state);
 
     for (i = 0ULL; i + 32ULL <= adlen; i += 32ULL) {
         crypto_aead_aegis128l_enc(dst, ad + i, state);
@@ -171,7 +176,7 @@ crypto_aead_aegis128l_encrypt_detached(unsigned char *c, unsigned char *mac,
         memcpy(c + i, dst, mlen & 0x1f);
     }
 
-    crypto_aead_aegis128l_mac(mac, adlen, mlen, state);
+    crypto_aead_aegis128l_finalize(mac, adlen, mlen, state);
     sodium_memzero(state, sizeof state);
     sodium_memzero(src, sizeof src);
     sodium_memzero(dst, sizeof dst);
@@ -179,37 +184,15 @@ crypto_aead_aegis128l_encrypt_detached(unsigned char *c, unsigned char *mac,
     if (maclen_p != NULL) {
         *maclen_p = 16ULL;
     }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
     return 0;
 }
 
-int
-crypto_aead_aegis128l_encrypt(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
-                              unsigned long long mlen, const unsigned char *ad,
-                              unsigned long long adlen, const unsigned char *nsec,
-                              const unsigned char *npub, const unsigned char *k)
-{
-    unsigned long long clen = 0ULL;
-    int                ret;
-
-    if (mlen > crypto_aead_aegis128l_MESSAGEBYTES_MAX) {
-        sodium_misuse();
-    }
-    ret = crypto_aead_aegis128l_encrypt_detached(c, c + mlen, NULL, m, mlen,
-                                                 ad, adlen, nsec, npub, k);
-    if (clen_p != NULL) {
-        if (ret == 0) {
-            clen = mlen + 16ULL;
-        }
-        *clen_p = clen;
-    }
-    return ret;
-}
-
-int
-crypto_aead_aegis128l_decrypt_detached(unsigned char *m, unsigned char *nsec, const unsigned char *c,
-                                       unsigned long long clen, const unsigned char *mac,
-                                       const unsigned char *ad, unsigned long long adlen,
-                                       const unsigned char *npub, const unsigned char *k)
+static int
+aegis128l_aesni_decrypt_detached(unsigned char *m, unsigned char *nsec, const unsigned char *c,
+                                 unsigned long long clen, const unsigned char *mac,
+                                 const unsigned char *ad, unsigned long long adlen,
+                                 const unsigned char *npub, const unsigned char *k)
 {
     __m128i                        state[8];
     CRYPTO_ALIGN(16) unsigned char src[32];
@@ -218,10 +201,11 @@ crypto_aead_aegis128l_decrypt_detached(unsigned char *m, unsigned char *nsec, co
     unsigned long long i;
     unsigned long long mlen;
     int                ret;
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
     mlen = clen;
-    crypto_aead_aegis128l_init(k, npub, state);
+    crypto_aead_aegis128l_init_state(k, npub, state);
 
     for (i = 0ULL; i + 32ULL <= adlen; i += 32ULL) {
         crypto_aead_aegis128l_enc(dst, ad + i, state);
@@ -254,48 +238,555 @@ crypto_aead_aegis128l_decrypt_detached(unsigned char *m, unsigned char *nsec, co
                                  _mm_loadu_si128((const __m128i *) (const void *) (dst + 16)));
     }
 
-    crypto_aead_aegis128l_mac(computed_mac, adlen, mlen, state);
+    crypto_aead_aegis128l_finalize(computed_mac, adlen, mlen, state);
     sodium_memzero(state, sizeof state);
     sodium_memzero(src, sizeof src);
     sodium_memzero(dst, sizeof dst);
     ret = crypto_verify_16(computed_mac, mac);
     sodium_memzero(computed_mac, sizeof computed_mac);
     if (m == NULL) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
         return ret;
     }
     if (ret != 0) {
         memset(m, 0, mlen);
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
         return -1;
     }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
     return 0;
 }
 
-int
-crypto_aead_aegis128l_decrypt(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
-                              const unsigned char *c, unsigned long long clen,
-                              const unsigned char *ad, unsigned long long adlen,
-                              const unsigned char *npub, const unsigned char *k)
+static void
+crypto_aead_aegis128l_absorb_iov(const crypto_aead_iovec *ad_iov, size_t ad_count,
+                                 unsigned long long adlen, __m128i *const state)
+{
+    aead_iov_cursor                ad;
+    CRYPTO_ALIGN(16) unsigned char src[32];
+    CRYPTO_ALIGN(16) unsigned char dst[32];
+    const unsigned char           *in;
+    size_t                         run;
+    size_t                         i;
+
+    aead_iov_cursor_init(&ad, ad_iov, ad_count);
+    while (adlen >= 32U) {
+        run = aead_iov_cursor_run(NULL, &ad, 32U);
+        if (run > 0U) {
+            in = aead_iov_cursor_ptr(&ad);
+            for (i = 0U; i < run; i += 32U) {
+                crypto_aead_aegis128l_enc(dst, in + i, state);
+            }
+            aead_iov_cursor_advance(&ad, run);
+        } else {
+            run = 32U;
+            aead_iov_cursor_gather(&ad, src, run);
+            crypto_aead_aegis128l_enc(dst, src, state);
+        }
+        adlen -= run;
+    }
+    if (adlen > 0U) {
+        memset(src, 0, 32);
+        aead_iov_cursor_gather(&ad, src, (size_t) adlen);
+        crypto_aead_aegis128l_enc(dst, src, state);
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
+
+static void
+crypto_aead_aegis128l_enc_iov(const crypto_aead_iovec *c_iov, size_t c_count,
+                              const crypto_aead_iovec *m_iov, size_t m_count,
+                              unsigned long long mlen, __m128i *const state)
 {
-    unsigned long long mlen = 0ULL;
-    int                ret  = -1;
+    aead_iov_cursor                c;
+    aead_iov_cursor                m;
+    CRYPTO_ALIGN(16) unsigned char src[32];
+    CRYPTO_ALIGN(16) unsigned char dst[32];
+    unsigned char                 *out;
+    const unsigned char           *in;
+    size_t                         run;
+    size_t                         i;
+
+    aead_iov_cursor_init(&c, c_iov, c_count);
+    aead_iov_cursor_init(&m, m_iov, m_count);
+    while (mlen >= 32U) {
+        run = aead_iov_cursor_run(&c, &m, 32U);
+        if (run > 0U) {
+            out = aead_iov_cursor_ptr(&c);
+            in  = aead_iov_cursor_ptr(&m);
+            for (i = 0U; i < run; i += 32U) {
+                crypto_aead_aegis128l_enc(out + i, in + i, state);
+            }
+            aead_iov_cursor_advance(&c, run);
+            aead_iov_cursor_advance(&m, run);
+        } else {
+            run = 32U;
+            aead_iov_cursor_gather(&m, src, run);
+            crypto_aead_aegis128l_enc(dst, src, state);
+            aead_iov_cursor_scatter(&c, dst, run);
+        }
+        mlen -= run;
+    }
+    if (mlen > 0U) {
+        memset(src, 0, 32);
+        aead_iov_cursor_gather(&m, src, (size_t) mlen);
+        crypto_aead_aegis128l_enc(dst, src, state);
+        aead_iov_cursor_scatter(&c, dst, (size_t) mlen);
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
 
-    if (clen >= 16ULL) {
-        ret = crypto_aead_aegis128l_decrypt_detached
-            (m, nsec, c, clen - 16ULL, c + clen - 16ULL, ad, adlen, npub, k);
+static void
+crypto_aead_aegis128l_dec_iov(const crypto_aead_iovec *m_iov, size_t m_count,
+                              const crypto_aead_iovec *c_iov, size_t c_count,
+                              unsigned long long mlen, __m128i *const state)
+{
+    aead_iov_cursor                m;
+    aead_iov_cursor                c;
+    CRYPTO_ALIGN(16) unsigned char src[32];
+    CRYPTO_ALIGN(16) unsigned char dst[32];
+    unsigned char                 *out;
+    const unsigned char           *in;
+    size_t                         run;
+    size_t                         i;
+
+    aead_iov_cursor_init(&m, m_iov, m_iov != NULL ? m_count : 0U);
+    aead_iov_cursor_init(&c, c_iov, c_count);
+    while (mlen >= 32U) {
+        run = aead_iov_cursor_run(m_iov != NULL ? &m : NULL, &c, 32U);
+        if (run > 0U) {
+            in = aead_iov_cursor_ptr(&c);
+            if (m_iov != NULL) {
+                out = aead_iov_cursor_ptr(&m);
+                for (i = 0U; i < run; i += 32U) {
+                    crypto_aead_aegis128l_dec(out + i, in + i, state);
+                }
+                aead_iov_cursor_advance(&m, run);
+            } else {
+                for (i = 0U; i < run; i += 32U) {
+                    crypto_aead_aegis128l_dec(dst, in + i, state);
+                }
+            }
+            aead_iov_cursor_advance(&c, run);
+        } else {
+            run = 32U;
+            aead_iov_cursor_gather(&c, src, run);
+            crypto_aead_aegis128l_dec(dst, src, state);
+            if (m_iov != NULL) {
+                aead_iov_cursor_scatter(&m, dst, run);
+            }
+        }
+        mlen -= run;
     }
-    if (mlen_p != NULL) {
-        if (ret == 0) {
-            mlen = clen - 16ULL;
+    if (mlen > 0U) {
+        memset(src, 0, 32);
+        aead_iov_cursor_gather(&c, src, (size_t) mlen);
+        crypto_aead_aegis128l_dec(dst, src, state);
+        if (m_iov != NULL) {
+            aead_iov_cursor_scatter(&m, dst, (size_t) mlen);
         }
-        *mlen_p = mlen;
+        memset(dst, 0, (size_t) mlen);
+        state[0] = _mm_xor_si128(state[0],
+                                 _mm_loadu_si128((const __m128i *) (const void *) dst));
+        state[4] = _mm_xor_si128(state[4],
+                                 _mm_loadu_si128((const __m128i *) (const void *) (dst + 16)));
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
+
+static int
+aegis128l_aesni_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                                     unsigned char *mac, unsigned long long *maclen_p,
+                                     const crypto_aead_iovec *m, size_t m_count,
+                                     const crypto_aead_iovec *ad, size_t ad_count,
+                                     const unsigned char *nsec,
+                                     const unsigned char *npub, const unsigned char *k)
+{
+    __m128i            state[8];
+    unsigned long long adlen;
+    unsigned long long mlen;
+    unsigned long long clen;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&mlen, m, m_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 || clen != mlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_aegis128l_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    crypto_aead_aegis128l_init_state(k, npub, state);
+    crypto_aead_aegis128l_absorb_iov(ad, ad_count, adlen, state);
+    crypto_aead_aegis128l_enc_iov(c, c_count, m, m_count, mlen, state);
+    crypto_aead_aegis128l_finalize(mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+
+    if (maclen_p != NULL) {
+        *maclen_p = 16ULL;
+    }
+    return 0;
+}
+
+static int
+aegis128l_aesni_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                                     unsigned char *nsec,
+                                     const crypto_aead_iovec *c, size_t c_count,
+                                     const unsigned char *mac,
+                                     const crypto_aead_iovec *ad, size_t ad_count,
+                                     const unsigned char *npub, const unsigned char *k)
+{
+    __m128i                        state[8];
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    unsigned long long             adlen;
+    unsigned long long             mlen;
+    unsigned long long             clen;
+    int                            ret;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 ||
+        (m != NULL && (aead_iov_total(&mlen, m, m_count) != 0 ||
+                       mlen != clen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    mlen = clen;
+    crypto_aead_aegis128l_init_state(k, npub, state);
+    crypto_aead_aegis128l_absorb_iov(ad, ad_count, adlen, state);
+    crypto_aead_aegis128l_dec_iov(m, m_count, c, c_count, mlen, state);
+    crypto_aead_aegis128l_finalize(computed_mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        aead_iov_memzero(m, m_count);
+        return -1;
+    }
+    return 0;
+}
+
+/* keystream for the next block, without updating the state */
+static void
+crypto_aead_aegis128l_keystream(unsigned char *const ks, const __m128i *const state)
+{
+    __m128i tmp0, tmp1;
+
+    tmp0 = _mm_xor_si128(state[6], state[1]);
+    tmp1 = _mm_xor_si128(state[2], state[5]);
+    tmp0 = _mm_xor_si128(tmp0, _mm_and_si128(state[2], state[3]));
+    tmp1 = _mm_xor_si128(tmp1, _mm_and_si128(state[6], state[7]));
+    _mm_storeu_si128((__m128i *) (void *) ks, tmp0);
+    _mm_storeu_si128((__m128i *) (void *) (ks + 16), tmp1);
+}
+
+typedef struct aegis128l_state {
+    __m128i            state[8];
+    unsigned char      buf[32]; /* pending additional data or plaintext */
+    unsigned long long adlen;
+    unsigned long long mlen;
+    size_t             pos;
+    int                ad_done;
+} aegis128l_state;
+
+/* absorb the pending partial block, zero-padded */
+static void
+crypto_aead_aegis128l_stream_flush(aegis128l_state *const st)
+{
+    if (st->pos > 0U) {
+        memset(st->buf + st->pos, 0, 32U - st->pos);
+        crypto_aead_aegis128l_enc(st->buf, st->buf, st->state);
+        st->pos = 0U;
+    }
+}
+
+/*
+ * Encrypt or decrypt up to the next block boundary, buffering the plaintext
+ * until the block is complete. Returns the number of bytes processed.
+ */
+static size_t
+crypto_aead_aegis128l_stream_partial(aegis128l_state *const st, unsigned char *out,
+                                     const unsigned char *in, unsigned long long len,
+                                     int encrypt)
+{
+    CRYPTO_ALIGN(16) unsigned char ks[32];
+    unsigned char                  t;
+    size_t                         i;
+
+    crypto_aead_aegis128l_keystream(ks, st->state);
+    for (i = 0U; i < len && st->pos < 32U; i++) {
+        t                = in[i];
+        out[i]           = t ^ ks[st->pos];
+        st->buf[st->pos] = encrypt ? t : out[i];
+        st->pos++;
     }
+    if (st->pos == 32U) {
+        crypto_aead_aegis128l_enc(ks, st->buf, st->state);
+        st->pos = 0U;
+    }
+    sodium_memzero(ks, sizeof ks);
+
+    return i;
+}
+
+static void
+crypto_aead_aegis128l_stream_update(aegis128l_state *const st, unsigned char *out,
+                                    const unsigned char *in, unsigned long long len,
+                                    int encrypt)
+{
+    unsigned long long i = 0ULL;
+
+    if (len > crypto_aead_aegis128l_MESSAGEBYTES_MAX - st->mlen) {
+        sodium_misuse();
+    }
+    if (st->ad_done == 0) {
+        crypto_aead_aegis128l_stream_flush(st);
+        st->ad_done = 1;
+    }
+    st->mlen += len;
+    if (st->pos > 0U) {
+        i = crypto_aead_aegis128l_stream_partial(st, out, in, len, encrypt);
+    }
+    if (encrypt) {
+        for (; i + 32ULL <= len; i += 32ULL) {
+            crypto_aead_aegis128l_enc(out + i, in + i, st->state);
+        }
+    } else {
+        for (; i + 32ULL <= len; i += 32ULL) {
+            crypto_aead_aegis128l_dec(out + i, in + i, st->state);
+        }
+    }
+    if (i < len) {
+        crypto_aead_aegis128l_stream_partial(st, out + i, in + i, len - i, encrypt);
+    }
+}
+
+static void
+crypto_aead_aegis128l_stream_final(aegis128l_state *const st, unsigned char *mac)
+{
+    crypto_aead_aegis128l_stream_flush(st);
+    crypto_aead_aegis128l_finalize(mac, st->adlen, st->mlen, st->state);
+    sodium_memzero(st, sizeof *st);
+}
+
+static int
+aegis128l_aesni_init(crypto_aead_aegis128l_state *state_, const unsigned char *npub,
+                     const unsigned char *k)
+{
+    aegis128l_state *st = (aegis128l_state *) (void *) state_;
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    memset(st, 0, sizeof *st);
+    crypto_aead_aegis128l_init_state(k, npub, st->state);
+
+    return 0;
+}
+
+static int
+aegis128l_aesni_update_ad(crypto_aead_aegis128l_state *state_, const unsigned char *ad,
+                          unsigned long long adlen)
+{
+    aegis128l_state   *st = (aegis128l_state *) (void *) state_;
+    unsigned long long i  = 0ULL;
+    size_t             n;
+
+    if (st->ad_done != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    st->adlen += adlen;
+    if (st->pos > 0U) {
+        n = 32U - st->pos;
+        if (n > adlen) {
+            n = (size_t) adlen;
+        }
+        memcpy(st->buf + st->pos, ad, n);
+        st->pos += n;
+        i = n;
+        if (st->pos == 32U) {
+            crypto_aead_aegis128l_enc(st->buf, st->buf, st->state);
+            st->pos = 0U;
+        }
+    }
+    for (; i + 32ULL <= adlen; i += 32ULL) {
+        crypto_aead_aegis128l_enc(st->buf, ad + i, st->state);
+    }
+    if (i < adlen) {
+        st->pos = (size_t) (adlen - i);
+        memcpy(st->buf, ad + i, st->pos);
+    }
+    return 0;
+}
+
+static int
+aegis128l_aesni_encrypt_update(crypto_aead_aegis128l_state *state_, unsigned char *c,
+                               const unsigned char *m, unsigned long long mlen)
+{
+    crypto_aead_aegis128l_stream_update((aegis128l_state *) (void *) state_, c, m, mlen, 1);
+
+    return 0;
+}
+
+static int
+aegis128l_aesni_encrypt_final(crypto_aead_aegis128l_state *state_, unsigned char *mac)
+{
+    crypto_aead_aegis128l_stream_final((aegis128l_state *) (void *) state_, mac);
+
+    return 0;
+}
+
+static int
+aegis128l_aesni_decrypt_update(crypto_aead_aegis128l_state *state_, unsigned char *m,
+                               const unsigned char *c, unsigned long long clen)
+{
+    crypto_aead_aegis128l_stream_update((aegis128l_state *) (void *) state_, m, c, clen, 0);
+
+    return 0;
+}
+
+static int
+aegis128l_aesni_decrypt_final(crypto_aead_aegis128l_state *state_, const unsigned char *mac)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    int                            ret;
+
+    crypto_aead_aegis128l_stream_final((aegis128l_state *) (void *) state_, computed_mac);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+
     return ret;
 }
 
-int
-crypto_aead_aegis128l_is_available(void)
+static inline void
+crypto_aead_aegis128l_absorb(const unsigned char *const src, __m128i *const state)
 {
-    return sodium_runtime_has_aesni();
+    __m128i msg0, msg1;
+
+    msg0 = _mm_loadu_si128((const __m128i *) (const void *) src);
+    msg1 = _mm_loadu_si128((const __m128i *) (const void *) (src + 16));
+    crypto_aead_aegis128l_update(state, msg0, msg1);
 }
 
+/* AEGIS-MAC finalization: the tag length takes the place of the message length */
+static void
+crypto_aead_aegis128l_mac_finalize(unsigned char *out, size_t outlen, unsigned long long inlen,
+                                   __m128i *const state)
+{
+    __m128i tmp;
+    int     i;
+
+    tmp = _mm_set_epi64x(outlen << 3, inlen << 3);
+    tmp = _mm_xor_si128(tmp, state[2]);
+
+    for (i = 0; i < 7; i++) {
+        crypto_aead_aegis128l_update(state, tmp, tmp);
+    }
+
+    if (outlen == 16U) {
+        tmp = _mm_xor_si128(state[6], state[5]);
+        tmp = _mm_xor_si128(tmp, state[4]);
+        tmp = _mm_xor_si128(tmp, state[3]);
+        tmp = _mm_xor_si128(tmp, state[2]);
+        tmp = _mm_xor_si128(tmp, state[1]);
+        tmp = _mm_xor_si128(tmp, state[0]);
+        _mm_storeu_si128((__m128i *) (void *) out, tmp);
+    } else {
+        tmp = _mm_xor_si128(state[0], state[1]);
+        tmp = _mm_xor_si128(tmp, state[2]);
+        tmp = _mm_xor_si128(tmp, state[3]);
+        _mm_storeu_si128((__m128i *) (void *) out, tmp);
+        tmp = _mm_xor_si128(state[4], state[5]);
+        tmp = _mm_xor_si128(tmp, state[6]);
+        tmp = _mm_xor_si128(tmp, state[7]);
+        _mm_storeu_si128((__m128i *) (void *) (out + 16), tmp);
+    }
+}
+
+static int
+aegis128l_aesni_mac_init(crypto_aead_aegis128l_state *state_, const unsigned char *npub,
+                         const unsigned char *k)
+{
+    static const unsigned char zero_npub[crypto_aead_aegis128l_NPUBBYTES];
+    aegis128l_state *st = (aegis128l_state *) (void *) state_;
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    memset(st, 0, sizeof *st);
+    crypto_aead_aegis128l_init_state(k, npub != NULL ? npub : zero_npub, st->state);
+
+    return 0;
+}
+
+static int
+aegis128l_aesni_mac_update(crypto_aead_aegis128l_state *state_, const unsigned char *in,
+                           unsigned long long inlen)
+{
+    aegis128l_state   *st = (aegis128l_state *) (void *) state_;
+    unsigned long long i  = 0ULL;
+    size_t             n;
+
+    st->adlen += inlen;
+    if (st->pos > 0U) {
+        n = 32U - st->pos;
+        if (n > inlen) {
+            n = (size_t) inlen;
+        }
+        memcpy(st->buf + st->pos, in, n);
+        st->pos += n;
+        i = n;
+        if (st->pos == 32U) {
+            crypto_aead_aegis128l_absorb(st->buf, st->state);
+            st->pos = 0U;
+        }
+    }
+    for (; i + 32ULL <= inlen; i += 32ULL) {
+        crypto_aead_aegis128l_absorb(in + i, st->state);
+    }
+    if (i < inlen) {
+        st->pos = (size_t) (inlen - i);
+        memcpy(st->buf, in + i, st->pos);
+    }
+    return 0;
+}
+
+static int
+aegis128l_aesni_mac_final(crypto_aead_aegis128l_state *state_, unsigned char *out, size_t outlen)
+{
+    aegis128l_state *st = (aegis128l_state *) (void *) state_;
+
+    if (outlen != crypto_aead_aegis128l_MACBYTES_MIN && outlen != crypto_aead_aegis128l_MACBYTES_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (st->pos > 0U) {
+        memset(st->buf + st->pos, 0, 32U - st->pos);
+        crypto_aead_aegis128l_absorb(st->buf, st->state);
+    }
+    crypto_aead_aegis128l_mac_finalize(out, outlen, st->adlen, st->state);
+    sodium_memzero(st, sizeof *st);
+
+    return 0;
+}
+
+struct crypto_aead_aegis128l_implementation crypto_aead_aegis128l_aesni_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis128l_aesni_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis128l_aesni_decrypt_detached,
+    SODIUM_C99(.encrypt_detached_iov =) aegis128l_aesni_encrypt_detached_iov,
+    SODIUM_C99(.decrypt_detached_iov =) aegis128l_aesni_decrypt_detached_iov,
+    SODIUM_C99(.init =) aegis128l_aesni_init,
+    SODIUM_C99(.update_ad =) aegis128l_aesni_update_ad,
+    SODIUM_C99(.encrypt_update =) aegis128l_aesni_encrypt_update,
+    SODIUM_C99(.encrypt_final =) aegis128l_aesni_encrypt_final,
+    SODIUM_C99(.decrypt_update =) aegis128l_aesni_decrypt_update,
+    SODIUM_C99(.decrypt_final =) aegis128l_aesni_decrypt_final,
+    SODIUM_C99(.mac_init =) aegis128l_aesni_mac_init,
+    SODIUM_C99(.mac_update =) aegis128l_aesni_mac_update,
+    SODIUM_C99(.mac_final =) aegis128l_aesni_mac_final
+};
+
 #endif
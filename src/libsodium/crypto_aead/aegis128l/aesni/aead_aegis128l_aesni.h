@@ -0,0 +1,9 @@
+#ifndef aead_aegis128l_aesni_H
+#define aead_aegis128l_aesni_H
+
+#include "../aegis128l.h"
+
+extern struct crypto_aead_aegis128l_implementation
+    crypto_aead_aegis128l_aesni_implementation;
+
+#endif
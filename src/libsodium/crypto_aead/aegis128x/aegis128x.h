@@ -0,0 +1,15 @@
+#ifndef aegis128x_H
+#define aegis128x_H
+
+typedef struct crypto_aead_aegis128x_implementation {
+    int (*encrypt_detached)(unsigned char *c, unsigned char *mac,
+                            const unsigned char *m, unsigned long long mlen,
+                            const unsigned char *ad, unsigned long long adlen,
+                            const unsigned char *npub, const unsigned char *k);
+    int (*decrypt_detached)(unsigned char *m, const unsigned char *c,
+                            unsigned long long clen, const unsigned char *mac,
+                            const unsigned char *ad, unsigned long long adlen,
+                            const unsigned char *npub, const unsigned char *k);
+} crypto_aead_aegis128x_implementation;
+
+#endif
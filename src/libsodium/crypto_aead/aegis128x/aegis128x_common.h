@@ -0,0 +1,259 @@
+/*
+ * AEGIS-128X, as specified in draft-irtf-cfrg-aegis-aead.
+ *
+ * D independent AEGIS-128L states are stored lane-wise: aes_block_t holds
+ * the same state word for all of them, so that each AES round operates on
+ * D blocks at once. The includer defines D, aes_block_t, the AES_BLOCK_*
+ * and AES_ENC operations, as well as FN() to name the functions.
+ */
+
+#define RATE (32 * D)
+
+static inline void
+FN(update)(aes_block_t *const state, const aes_block_t d1, const aes_block_t d2)
+{
+    aes_block_t tmp;
+
+    tmp      = state[7];
+    state[7] = AES_ENC(state[6], state[7]);
+    state[6] = AES_ENC(state[5], state[6]);
+    state[5] = AES_ENC(state[4], state[5]);
+    state[4] = AES_ENC(state[3], state[4]);
+    state[3] = AES_ENC(state[2], state[3]);
+    state[2] = AES_ENC(state[1], state[2]);
+    state[1] = AES_ENC(state[0], state[1]);
+    state[0] = AES_ENC(tmp, state[0]);
+
+    state[0] = AES_BLOCK_XOR(state[0], d1);
+    state[4] = AES_BLOCK_XOR(state[4], d2);
+}
+
+static aes_block_t
+FN(load_rep)(const unsigned char *in)
+{
+    CRYPTO_ALIGN(32) unsigned char t[RATE / 2];
+    size_t                         i;
+
+    for (i = 0U; i < D; i++) {
+        memcpy(t + i * 16U, in, 16U);
+    }
+    return AES_BLOCK_LOAD(t);
+}
+
+static void
+FN(init_state)(const unsigned char *key, const unsigned char *nonce, aes_block_t *const state)
+{
+    static CRYPTO_ALIGN(16) const unsigned char c0_[] = {
+        0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x08, 0x0d, 0x15, 0x22, 0x37, 0x59,
+        0x90, 0xe9, 0x79, 0x62
+    };
+    static CRYPTO_ALIGN(16) const unsigned char c1_[] = {
+        0xdb, 0x3d, 0x18, 0x55, 0x6d, 0xc2, 0x2f, 0xf1, 0x20, 0x11, 0x31, 0x42,
+        0x73, 0xb5, 0x28, 0xdd
+    };
+    CRYPTO_ALIGN(32) unsigned char ctx_[RATE / 2];
+    aes_block_t                    c0, c1, ctx, k, n;
+    size_t                         i;
+
+    /* lane i is tagged with its index and with the degree, minus one */
+    memset(ctx_, 0, sizeof ctx_);
+    for (i = 0U; i < D; i++) {
+        ctx_[i * 16U]      = (unsigned char) i;
+        ctx_[i * 16U + 1U] = (unsigned char) (D - 1);
+    }
+    ctx = AES_BLOCK_LOAD(ctx_);
+    c0  = FN(load_rep)(c0_);
+    c1  = FN(load_rep)(c1_);
+    k   = FN(load_rep)(key);
+    n   = FN(load_rep)(nonce);
+
+    state[0] = AES_BLOCK_XOR(k, n);
+    state[1] = c1;
+    state[2] = c0;
+    state[3] = c1;
+    state[4] = AES_BLOCK_XOR(k, n);
+    state[5] = AES_BLOCK_XOR(k, c0);
+    state[6] = AES_BLOCK_XOR(k, c1);
+    state[7] = AES_BLOCK_XOR(k, c0);
+    for (i = 0U; i < 10U; i++) {
+        state[3] = AES_BLOCK_XOR(state[3], ctx);
+        state[7] = AES_BLOCK_XOR(state[7], ctx);
+        FN(update)(state, n, k);
+    }
+}
+
+static void
+FN(mac)(unsigned char *mac, unsigned long long adlen, unsigned long long mlen,
+        aes_block_t *const state)
+{
+    CRYPTO_ALIGN(16) unsigned char sizes[16];
+    CRYPTO_ALIGN(32) unsigned char t[RATE / 2];
+    aes_block_t                    tmp;
+    size_t                         i;
+    size_t                         j;
+
+    STORE64_LE(sizes, adlen << 3);
+    STORE64_LE(sizes + 8, mlen << 3);
+    tmp = AES_BLOCK_XOR(FN(load_rep)(sizes), state[2]);
+
+    for (i = 0U; i < 7U; i++) {
+        FN(update)(state, tmp, tmp);
+    }
+
+    tmp = AES_BLOCK_XOR(state[6], state[5]);
+    tmp = AES_BLOCK_XOR(tmp, state[4]);
+    tmp = AES_BLOCK_XOR(tmp, state[3]);
+    tmp = AES_BLOCK_XOR(tmp, state[2]);
+    tmp = AES_BLOCK_XOR(tmp, state[1]);
+    tmp = AES_BLOCK_XOR(tmp, state[0]);
+
+    AES_BLOCK_STORE(t, tmp);
+    for (i = 1U; i < D; i++) {
+        for (j = 0U; j < 16U; j++) {
+            t[j] ^= t[i * 16U + j];
+        }
+    }
+    memcpy(mac, t, 16U);
+}
+
+static inline void
+FN(enc)(unsigned char *const dst, const unsigned char *const src, aes_block_t *const state)
+{
+    aes_block_t msg0, msg1;
+    aes_block_t tmp0, tmp1;
+
+    msg0 = AES_BLOCK_LOAD(src);
+    msg1 = AES_BLOCK_LOAD(src + RATE / 2);
+    tmp0 = AES_BLOCK_XOR(msg0, state[6]);
+    tmp0 = AES_BLOCK_XOR(tmp0, state[1]);
+    tmp1 = AES_BLOCK_XOR(msg1, state[2]);
+    tmp1 = AES_BLOCK_XOR(tmp1, state[5]);
+    tmp0 = AES_BLOCK_XOR(tmp0, AES_BLOCK_AND(state[2], state[3]));
+    tmp1 = AES_BLOCK_XOR(tmp1, AES_BLOCK_AND(state[6], state[7]));
+    AES_BLOCK_STORE(dst, tmp0);
+    AES_BLOCK_STORE(dst + RATE / 2, tmp1);
+
+    FN(update)(state, msg0, msg1);
+}
+
+static inline void
+FN(dec)(unsigned char *const dst, const unsigned char *const src, aes_block_t *const state)
+{
+    aes_block_t msg0, msg1;
+
+    msg0 = AES_BLOCK_LOAD(src);
+    msg1 = AES_BLOCK_LOAD(src + RATE / 2);
+    msg0 = AES_BLOCK_XOR(msg0, state[6]);
+    msg0 = AES_BLOCK_XOR(msg0, state[1]);
+    msg1 = AES_BLOCK_XOR(msg1, state[2]);
+    msg1 = AES_BLOCK_XOR(msg1, state[5]);
+    msg0 = AES_BLOCK_XOR(msg0, AES_BLOCK_AND(state[2], state[3]));
+    msg1 = AES_BLOCK_XOR(msg1, AES_BLOCK_AND(state[6], state[7]));
+    AES_BLOCK_STORE(dst, msg0);
+    AES_BLOCK_STORE(dst + RATE / 2, msg1);
+
+    FN(update)(state, msg0, msg1);
+}
+
+static int
+FN(encrypt_detached)(unsigned char *c, unsigned char *mac, const unsigned char *m,
+                     unsigned long long mlen, const unsigned char *ad,
+                     unsigned long long adlen, const unsigned char *npub,
+                     const unsigned char *k)
+{
+    aes_block_t                    state[8];
+    CRYPTO_ALIGN(32) unsigned char src[RATE];
+    CRYPTO_ALIGN(32) unsigned char dst[RATE];
+    unsigned long long             i;
+
+    FN(init_state)(k, npub, state);
+
+    for (i = 0ULL; i + RATE <= adlen; i += RATE) {
+        FN(enc)(dst, ad + i, state);
+    }
+    if (adlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, ad + i, adlen & (RATE - 1));
+        FN(enc)(dst, src, state);
+    }
+    for (i = 0ULL; i + RATE <= mlen; i += RATE) {
+        FN(enc)(c + i, m + i, state);
+    }
+    if (mlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, m + i, mlen & (RATE - 1));
+        FN(enc)(dst, src, state);
+        memcpy(c + i, dst, mlen & (RATE - 1));
+    }
+
+    FN(mac)(mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+
+    return 0;
+}
+
+static int
+FN(decrypt_detached)(unsigned char *m, const unsigned char *c, unsigned long long clen,
+                     const unsigned char *mac, const unsigned char *ad,
+                     unsigned long long adlen, const unsigned char *npub,
+                     const unsigned char *k)
+{
+    aes_block_t                    state[8];
+    CRYPTO_ALIGN(32) unsigned char src[RATE];
+    CRYPTO_ALIGN(32) unsigned char dst[RATE];
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    unsigned long long             i;
+    unsigned long long             mlen;
+    int                            ret;
+
+    mlen = clen;
+    FN(init_state)(k, npub, state);
+
+    for (i = 0ULL; i + RATE <= adlen; i += RATE) {
+        FN(enc)(dst, ad + i, state);
+    }
+    if (adlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, ad + i, adlen & (RATE - 1));
+        FN(enc)(dst, src, state);
+    }
+    if (m != NULL) {
+        for (i = 0ULL; i + RATE <= mlen; i += RATE) {
+            FN(dec)(m + i, c + i, state);
+        }
+    } else {
+        for (i = 0ULL; i + RATE <= mlen; i += RATE) {
+            FN(dec)(dst, c + i, state);
+        }
+    }
+    if (mlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, c + i, mlen & (RATE - 1));
+        FN(dec)(dst, src, state);
+        if (m != NULL) {
+            memcpy(m + i, dst, mlen & (RATE - 1));
+        }
+        memset(dst, 0, mlen & (RATE - 1));
+        state[0] = AES_BLOCK_XOR(state[0], AES_BLOCK_LOAD(dst));
+        state[4] = AES_BLOCK_XOR(state[4], AES_BLOCK_LOAD(dst + RATE / 2));
+    }
+
+    FN(mac)(computed_mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        memset(m, 0, mlen);
+        return -1;
+    }
+    return 0;
+}
+
+#undef RATE
@@ -0,0 +1,11 @@
+#ifndef aead_aegis128x_aesni_H
+#define aead_aegis128x_aesni_H
+
+#include "../aegis128x.h"
+
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x2_aesni_implementation;
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x4_aesni_implementation;
+
+#endif
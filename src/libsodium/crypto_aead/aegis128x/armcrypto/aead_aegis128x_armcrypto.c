@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "utils.h"
+
+#include "private/common.h"
+
+#ifdef HAVE_ARMCRYPTO
+
+#include <arm_neon.h>
+
+#include "aead_aegis128x_armcrypto.h"
+
+typedef struct aes_block2_t {
+    uint8x16_t b0, b1;
+} aes_block2_t;
+
+typedef struct aes_block4_t {
+    uint8x16_t b0, b1, b2, b3;
+} aes_block4_t;
+
+static inline aes_block2_t
+aes_block2_load(const unsigned char *a)
+{
+    aes_block2_t r;
+
+    r.b0 = vld1q_u8(a);
+    r.b1 = vld1q_u8(a + 16);
+    return r;
+}
+
+static inline void
+aes_block2_store(unsigned char *a, const aes_block2_t b)
+{
+    vst1q_u8(a, b.b0);
+    vst1q_u8(a + 16, b.b1);
+}
+
+static inline aes_block2_t
+aes_block2_xor(const aes_block2_t a, const aes_block2_t b)
+{
+    aes_block2_t r;
+
+    r.b0 = veorq_u8(a.b0, b.b0);
+    r.b1 = veorq_u8(a.b1, b.b1);
+    return r;
+}
+
+static inline aes_block2_t
+aes_block2_and(const aes_block2_t a, const aes_block2_t b)
+{
+    aes_block2_t r;
+
+    r.b0 = vandq_u8(a.b0, b.b0);
+    r.b1 = vandq_u8(a.b1, b.b1);
+    return r;
+}
+
+static inline aes_block2_t
+aes_block2_enc(const aes_block2_t a, const aes_block2_t b)
+{
+    const uint8x16_t zero = vmovq_n_u8(0);
+    aes_block2_t     r;
+
+    r.b0 = veorq_u8(vaesmcq_u8(vaeseq_u8(a.b0, zero)), b.b0);
+    r.b1 = veorq_u8(vaesmcq_u8(vaeseq_u8(a.b1, zero)), b.b1);
+    return r;
+}
+
+static inline aes_block4_t
+aes_block4_load(const unsigned char *a)
+{
+    aes_block4_t r;
+
+    r.b0 = vld1q_u8(a);
+    r.b1 = vld1q_u8(a + 16);
+    r.b2 = vld1q_u8(a + 32);
+    r.b3 = vld1q_u8(a + 48);
+    return r;
+}
+
+static inline void
+aes_block4_store(unsigned char *a, const aes_block4_t b)
+{
+    vst1q_u8(a, b.b0);
+    vst1q_u8(a + 16, b.b1);
+    vst1q_u8(a + 32, b.b2);
+    vst1q_u8(a + 48, b.b3);
+}
+
+static inline aes_block4_t
+aes_block4_xor(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+
+    r.b0 = veorq_u8(a.b0, b.b0);
+    r.b1 = veorq_u8(a.b1, b.b1);
+    r.b2 = veorq_u8(a.b2, b.b2);
+    r.b3 = veorq_u8(a.b3, b.b3);
+    return r;
+}
+
+static inline aes_block4_t
+aes_block4_and(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+
+    r.b0 = vandq_u8(a.b0, b.b0);
+    r.b1 = vandq_u8(a.b1, b.b1);
+    r.b2 = vandq_u8(a.b2, b.b2);
+    r.b3 = vandq_u8(a.b3, b.b3);
+    return r;
+}
+
+static inline aes_block4_t
+aes_block4_enc(const aes_block4_t a, const aes_block4_t b)
+{
+    const uint8x16_t zero = vmovq_n_u8(0);
+    aes_block4_t     r;
+
+    r.b0 = veorq_u8(vaesmcq_u8(vaeseq_u8(a.b0, zero)), b.b0);
+    r.b1 = veorq_u8(vaesmcq_u8(vaeseq_u8(a.b1, zero)), b.b1);
+    r.b2 = veorq_u8(vaesmcq_u8(vaeseq_u8(a.b2, zero)), b.b2);
+    r.b3 = veorq_u8(vaesmcq_u8(vaeseq_u8(a.b3, zero)), b.b3);
+    return r;
+}
+
+#define D 2
+#define aes_block_t     aes_block2_t
+#define AES_BLOCK_LOAD  aes_block2_load
+#define AES_BLOCK_STORE aes_block2_store
+#define AES_BLOCK_XOR   aes_block2_xor
+#define AES_BLOCK_AND   aes_block2_and
+#define AES_ENC         aes_block2_enc
+#define FN(name)        aegis128x2_armcrypto_##name
+#include "../aegis128x_common.h"
+#undef D
+#undef aes_block_t
+#undef AES_BLOCK_LOAD
+#undef AES_BLOCK_STORE
+#undef AES_BLOCK_XOR
+#undef AES_BLOCK_AND
+#undef AES_ENC
+#undef FN
+
+#define D 4
+#define aes_block_t     aes_block4_t
+#define AES_BLOCK_LOAD  aes_block4_load
+#define AES_BLOCK_STORE aes_block4_store
+#define AES_BLOCK_XOR   aes_block4_xor
+#define AES_BLOCK_AND   aes_block4_and
+#define AES_ENC         aes_block4_enc
+#define FN(name)        aegis128x4_armcrypto_##name
+#include "../aegis128x_common.h"
+#undef D
+#undef aes_block_t
+#undef AES_BLOCK_LOAD
+#undef AES_BLOCK_STORE
+#undef AES_BLOCK_XOR
+#undef AES_BLOCK_AND
+#undef AES_ENC
+#undef FN
+
+struct crypto_aead_aegis128x_implementation crypto_aead_aegis128x2_armcrypto_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis128x2_armcrypto_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis128x2_armcrypto_decrypt_detached
+};
+
+struct crypto_aead_aegis128x_implementation crypto_aead_aegis128x4_armcrypto_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis128x4_armcrypto_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis128x4_armcrypto_decrypt_detached
+};
+
+#endif
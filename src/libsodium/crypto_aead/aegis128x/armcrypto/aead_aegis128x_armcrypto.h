@@ -0,0 +1,11 @@
+#ifndef aead_aegis128x_armcrypto_H
+#define aead_aegis128x_armcrypto_H
+
+#include "../aegis128x.h"
+
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x2_armcrypto_implementation;
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x4_armcrypto_implementation;
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef aead_aegis128x_soft_H
+#define aead_aegis128x_soft_H
+
+#include "../aegis128x.h"
+
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x2_soft_implementation;
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x4_soft_implementation;
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef aead_aegis128x_vaes_H
+#define aead_aegis128x_vaes_H
+
+#include "../aegis128x.h"
+
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x2_vaes_implementation;
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x4_vaes_implementation;
+extern struct crypto_aead_aegis128x_implementation
+    crypto_aead_aegis128x4_vaes512_implementation;
+
+#endif
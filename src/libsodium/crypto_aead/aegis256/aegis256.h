@@ -0,0 +1,45 @@
+#ifndef aegis256_H
+#define aegis256_H
+
+#include "crypto_aead_aegis256.h"
+
+typedef struct crypto_aead_aegis256_implementation {
+    int (*encrypt_detached)(unsigned char *c, unsigned char *mac,
+                            unsigned long long *maclen_p, const unsigned char *m,
+                            unsigned long long mlen, const unsigned char *ad,
+                            unsigned long long adlen, const unsigned char *nsec,
+                            const unsigned char *npub, const unsigned char *k);
+    int (*decrypt_detached)(unsigned char *m, unsigned char *nsec, const unsigned char *c,
+                            unsigned long long clen, const unsigned char *mac,
+                            const unsigned char *ad, unsigned long long adlen,
+                            const unsigned char *npub, const unsigned char *k);
+    int (*encrypt_detached_iov)(const crypto_aead_iovec *c, size_t c_count,
+                                unsigned char *mac, unsigned long long *maclen_p,
+                                const crypto_aead_iovec *m, size_t m_count,
+                                const crypto_aead_iovec *ad, size_t ad_count,
+                                const unsigned char *nsec,
+                                const unsigned char *npub, const unsigned char *k);
+    int (*decrypt_detached_iov)(const crypto_aead_iovec *m, size_t m_count,
+                                unsigned char *nsec,
+                                const crypto_aead_iovec *c, size_t c_count,
+                                const unsigned char *mac,
+                                const crypto_aead_iovec *ad, size_t ad_count,
+                                const unsigned char *npub, const unsigned char *k);
+    int (*init)(crypto_aead_aegis256_state *state, const unsigned char *npub,
+                const unsigned char *k);
+    int (*update_ad)(crypto_aead_aegis256_state *state, const unsigned char *ad,
+                     unsigned long long adlen);
+    int (*encrypt_update)(crypto_aead_aegis256_state *state, unsigned char *c,
+                          const unsigned char *m, unsigned long long mlen);
+    int (*encrypt_final)(crypto_aead_aegis256_state *state, unsigned char *mac);
+    int (*decrypt_update)(crypto_aead_aegis256_state *state, unsigned char *m,
+                          const unsigned char *c, unsigned long long clen);
+    int (*decrypt_final)(crypto_aead_aegis256_state *state, const unsigned char *mac);
+    int (*mac_init)(crypto_aead_aegis256_state *state, const unsigned char *npub,
+                    const unsigned char *k);
+    int (*mac_update)(crypto_aead_aegis256_state *state, const unsigned char *in,
+                      unsigned long long inlen);
+    int (*mac_final)(crypto_aead_aegis256_state *state, unsigned char *out, size_t outlen);
+} crypto_aead_aegis256_implementation;
+
+#endif
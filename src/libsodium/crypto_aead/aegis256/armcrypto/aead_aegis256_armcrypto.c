@@ -10,12 +10,16 @@
 #include "runtime.h"
 #include "utils.h"
 
+#include "private/aead_iov.h"
 #include "private/common.h"
+#include "private/stats.h"
 
 #ifdef HAVE_ARMCRYPTO
 
 # include <arm_neon.h>
 
+#include "aead_aegis256_armcrypto.h"
+
 static inline void
 crypto_aead_aegis256_update(uint8x16_t *const state, const uint8x16_t data)
 {
@@ -32,8 +36,8 @@ crypto_aead_aegis256_update(uint8x16_t *const state, const uint8x16_t data)
 }
 
 static void
-crypto_aead_aegis256_init(const unsigned char *key, const unsigned char *nonce,
-                          uint8x16_t *const state)
+crypto_aead_aegis256_init_state(const unsigned char *key, const unsigned char *nonce,
+                                uint8x16_t *const state)
 {
     static CRYPTO_ALIGN(16) const unsigned char c1_[] = {
         0xdb, 0x3d, 0x18, 0x55, 0x6d, 0xc2, 0x2f, 0xf1, 0x20, 0x11, 0x31, 0x42,
@@ -70,8 +74,8 @@ crypto_aead_aegis256_init(const unsigned char *key, const unsigned char *nonce,
 }
 
 static void
-crypto_aead_aegis256_mac(unsigned char *mac, unsigned long long adlen,
-                         unsigned long long mlen, uint8x16_t *const state)
+crypto_aead_aegis256_finalize(unsigned char *mac, unsigned long long adlen,
+                              unsigned long long mlen, uint8x16_t *const state)
 {
     uint8x16_t tmp;
     int        i;
@@ -129,20 +133,21 @@ crypto_aead_aegis256_dec(unsigned char *const dst,
     crypto_aead_aegis256_update(state, msg);
 }
 
-int
-crypto_aead_aegis256_encrypt_detached(unsigned char *c, unsigned char *mac,
-                                      unsigned long long *maclen_p, const unsigned char *m,
-                                      unsigned long long mlen, const unsigned char *ad,
-                                      unsigned long long adlen, const unsigned char *nsec,
-                                      const unsigned char *npub, const unsigned char *k)
+static int
+aegis256_armcrypto_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                    unsigned long long *maclen_p, const unsigned char *m,
+                                    unsigned long long mlen, const unsigned char *ad,
+                                    unsigned long long adlen, const unsigned char *nsec,
+                                    const unsigned char *npub, const unsigned char *k)
 {
     uint8x16_t                     state[6];
     CRYPTO_ALIGN(16) unsigned char src[16];
     CRYPTO_ALIGN(16) unsigned char dst[16];
     unsigned long long i;
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
-    crypto_aead_aegis256_init(k, npub, state);
+    crypto_aead_aegis256_init_state(k, npub, state);
 
     for (i = 0ULL; i + 16ULL <= adlen; i += 16ULL) {
         crypto_aead_aegis256_enc(dst, ad + i, state);
@@ -162,7 +167,7 @@ crypto_aead_aegis256_encrypt_detached(unsigned char *c, unsigned char *mac,
         memcpy(c + i, dst, mlen & 0xf);
     }
 
-    crypto_aead_aegis256_mac(mac, adlen, mlen, state);
+    crypto_aead_aegis256_finalize(mac, adlen, mlen, state);
     sodium_memzero(state, sizeof state);
     sodium_memzero(src, sizeof src);
     sodium_memzero(dst, sizeof dst);
@@ -170,37 +175,15 @@ crypto_aead_aegis256_encrypt_detached(unsigned char *c, unsigned char *mac,
     if (maclen_p != NULL) {
         *maclen_p = 16ULL;
     }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
     return 0;
 }
 
-int
-crypto_aead_aegis256_encrypt(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
-                             unsigned long long mlen, const unsigned char *ad,
-                             unsigned long long adlen, const unsigned char *nsec,
-                             const unsigned char *npub, const unsigned char *k)
-{
-    unsigned long long clen = 0ULL;
-    int                ret;
-
-    if (mlen > crypto_aead_aegis256_MESSAGEBYTES_MAX) {
-        sodium_misuse();
-    }
-    ret = crypto_aead_aegis256_encrypt_detached(c, c + mlen, NULL, m, mlen,
-                                                ad, adlen, nsec, npub, k);
-    if (clen_p != NULL) {
-        if (ret == 0) {
-            clen = mlen + 16ULL;
-        }
-        *clen_p = clen;
-    }
-    return ret;
-}
-
-int
-crypto_aead_aegis256_decrypt_detached(unsigned char *m, unsigned char *nsec, const unsigned char *c,
-                                      unsigned long long clen, const unsigned char *mac,
-                                      const unsigned char *ad, unsigned long long adlen,
-                                      const unsigned char *npub, const unsigned char *k)
+static int
+aegis256_armcrypto_decrypt_detached(unsigned char *m, unsigned char *nsec, const unsigned char *c,
+                                    unsigned long long clen, const unsigned char *mac,
+                                    const unsigned char *ad, unsigned long long adlen,
+                                    const unsigned char *npub, const unsigned char *k)
 {
     uint8x16_t                     state[6];
     CRYPTO_ALIGN(16) unsigned char src[16];
@@ -209,10 +192,11 @@ crypto_aead_aegis256_decrypt_detached(unsigned char *m, unsigned char *nsec, con
     unsigned long long i;
     unsigned long long mlen;
     int                ret;
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
     mlen = clen;
-    crypto_aead_aegis256_init(k, npub, state);
+    crypto_aead_aegis256_init_state(k, npub, state);
 
     for (i = 0ULL; i + 16ULL <= adlen; i += 16ULL) {
         crypto_aead_aegis256_enc(dst, ad + i, state);
@@ -242,48 +226,544 @@ crypto_aead_aegis256_decrypt_detached(unsigned char *m, unsigned char *nsec, con
         state[0] = veorq_u8(state[0], vld1q_u8(dst));
     }
 
-    crypto_aead_aegis256_mac(computed_mac, adlen, mlen, state);
+    crypto_aead_aegis256_finalize(computed_mac, adlen, mlen, state);
     sodium_memzero(state, sizeof state);
     sodium_memzero(src, sizeof src);
     sodium_memzero(dst, sizeof dst);
     ret = crypto_verify_16(computed_mac, mac);
     sodium_memzero(computed_mac, sizeof computed_mac);
     if (m == NULL) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
         return ret;
     }
     if (ret != 0) {
         memset(m, 0, mlen);
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
         return -1;
     }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
     return 0;
 }
 
-int
-crypto_aead_aegis256_decrypt(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
-                             const unsigned char *c, unsigned long long clen,
-                             const unsigned char *ad, unsigned long long adlen,
-                             const unsigned char *npub, const unsigned char *k)
+static void
+crypto_aead_aegis256_absorb_iov(const crypto_aead_iovec *ad_iov, size_t ad_count,
+                                unsigned long long adlen, uint8x16_t *const state)
+{
+    aead_iov_cursor                ad;
+    CRYPTO_ALIGN(16) unsigned char src[16];
+    CRYPTO_ALIGN(16) unsigned char dst[16];
+    const unsigned char           *in;
+    size_t                         run;
+    size_t                         i;
+
+    aead_iov_cursor_init(&ad, ad_iov, ad_count);
+    while (adlen >= 16U) {
+        run = aead_iov_cursor_run(NULL, &ad, 16U);
+        if (run > 0U) {
+            in = aead_iov_cursor_ptr(&ad);
+            for (i = 0U; i < run; i += 16U) {
+                crypto_aead_aegis256_enc(dst, in + i, state);
+            }
+            aead_iov_cursor_advance(&ad, run);
+        } else {
+            run = 16U;
+            aead_iov_cursor_gather(&ad, src, run);
+            crypto_aead_aegis256_enc(dst, src, state);
+        }
+        adlen -= run;
+    }
+    if (adlen > 0U) {
+        memset(src, 0, 16);
+        aead_iov_cursor_gather(&ad, src, (size_t) adlen);
+        crypto_aead_aegis256_enc(dst, src, state);
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
+
+static void
+crypto_aead_aegis256_enc_iov(const crypto_aead_iovec *c_iov, size_t c_count,
+                             const crypto_aead_iovec *m_iov, size_t m_count,
+                             unsigned long long mlen, uint8x16_t *const state)
 {
-    unsigned long long mlen = 0ULL;
-    int                ret  = -1;
+    aead_iov_cursor                c;
+    aead_iov_cursor                m;
+    CRYPTO_ALIGN(16) unsigned char src[16];
+    CRYPTO_ALIGN(16) unsigned char dst[16];
+    unsigned char                 *out;
+    const unsigned char           *in;
+    size_t                         run;
+    size_t                         i;
+
+    aead_iov_cursor_init(&c, c_iov, c_count);
+    aead_iov_cursor_init(&m, m_iov, m_count);
+    while (mlen >= 16U) {
+        run = aead_iov_cursor_run(&c, &m, 16U);
+        if (run > 0U) {
+            out = aead_iov_cursor_ptr(&c);
+            in  = aead_iov_cursor_ptr(&m);
+            for (i = 0U; i < run; i += 16U) {
+                crypto_aead_aegis256_enc(out + i, in + i, state);
+            }
+            aead_iov_cursor_advance(&c, run);
+            aead_iov_cursor_advance(&m, run);
+        } else {
+            run = 16U;
+            aead_iov_cursor_gather(&m, src, run);
+            crypto_aead_aegis256_enc(dst, src, state);
+            aead_iov_cursor_scatter(&c, dst, run);
+        }
+        mlen -= run;
+    }
+    if (mlen > 0U) {
+        memset(src, 0, 16);
+        aead_iov_cursor_gather(&m, src, (size_t) mlen);
+        crypto_aead_aegis256_enc(dst, src, state);
+        aead_iov_cursor_scatter(&c, dst, (size_t) mlen);
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
 
-    if (clen >= 16ULL) {
-        ret = crypto_aead_aegis256_decrypt_detached(m, nsec, c, clen - 16ULL, c + clen - 16ULL, ad,
-                                                    adlen, npub, k);
+static void
+crypto_aead_aegis256_dec_iov(const crypto_aead_iovec *m_iov, size_t m_count,
+                             const crypto_aead_iovec *c_iov, size_t c_count,
+                             unsigned long long mlen, uint8x16_t *const state)
+{
+    aead_iov_cursor                m;
+    aead_iov_cursor                c;
+    CRYPTO_ALIGN(16) unsigned char src[16];
+    CRYPTO_ALIGN(16) unsigned char dst[16];
+    unsigned char                 *out;
+    const unsigned char           *in;
+    size_t                         run;
+    size_t                         i;
+
+    aead_iov_cursor_init(&m, m_iov, m_iov != NULL ? m_count : 0U);
+    aead_iov_cursor_init(&c, c_iov, c_count);
+    while (mlen >= 16U) {
+        run = aead_iov_cursor_run(m_iov != NULL ? &m : NULL, &c, 16U);
+        if (run > 0U) {
+            in = aead_iov_cursor_ptr(&c);
+            if (m_iov != NULL) {
+                out = aead_iov_cursor_ptr(&m);
+                for (i = 0U; i < run; i += 16U) {
+                    crypto_aead_aegis256_dec(out + i, in + i, state);
+                }
+                aead_iov_cursor_advance(&m, run);
+            } else {
+                for (i = 0U; i < run; i += 16U) {
+                    crypto_aead_aegis256_dec(dst, in + i, state);
+                }
+            }
+            aead_iov_cursor_advance(&c, run);
+        } else {
+            run = 16U;
+            aead_iov_cursor_gather(&c, src, run);
+            crypto_aead_aegis256_dec(dst, src, state);
+            if (m_iov != NULL) {
+                aead_iov_cursor_scatter(&m, dst, run);
+            }
+        }
+        mlen -= run;
     }
-    if (mlen_p != NULL) {
-        if (ret == 0) {
-            mlen = clen - 16ULL;
+    if (mlen > 0U) {
+        memset(src, 0, 16);
+        aead_iov_cursor_gather(&c, src, (size_t) mlen);
+        crypto_aead_aegis256_dec(dst, src, state);
+        if (m_iov != NULL) {
+            aead_iov_cursor_scatter(&m, dst, (size_t) mlen);
         }
-        *mlen_p = mlen;
+        memset(dst, 0, (size_t) mlen);
+        state[0] = veorq_u8(state[0], vld1q_u8(dst));
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
+
+static int
+aegis256_armcrypto_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                                        unsigned char *mac, unsigned long long *maclen_p,
+                                        const crypto_aead_iovec *m, size_t m_count,
+                                        const crypto_aead_iovec *ad, size_t ad_count,
+                                        const unsigned char *nsec,
+                                        const unsigned char *npub, const unsigned char *k)
+{
+    uint8x16_t         state[6];
+    unsigned long long adlen;
+    unsigned long long mlen;
+    unsigned long long clen;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&mlen, m, m_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 || clen != mlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_aegis256_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    crypto_aead_aegis256_init_state(k, npub, state);
+    crypto_aead_aegis256_absorb_iov(ad, ad_count, adlen, state);
+    crypto_aead_aegis256_enc_iov(c, c_count, m, m_count, mlen, state);
+    crypto_aead_aegis256_finalize(mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+
+    if (maclen_p != NULL) {
+        *maclen_p = 16ULL;
+    }
+    return 0;
+}
+
+static int
+aegis256_armcrypto_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                                        unsigned char *nsec,
+                                        const crypto_aead_iovec *c, size_t c_count,
+                                        const unsigned char *mac,
+                                        const crypto_aead_iovec *ad, size_t ad_count,
+                                        const unsigned char *npub, const unsigned char *k)
+{
+    uint8x16_t                     state[6];
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    unsigned long long             adlen;
+    unsigned long long             mlen;
+    unsigned long long             clen;
+    int                            ret;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 ||
+        (m != NULL && (aead_iov_total(&mlen, m, m_count) != 0 ||
+                       mlen != clen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    mlen = clen;
+    crypto_aead_aegis256_init_state(k, npub, state);
+    crypto_aead_aegis256_absorb_iov(ad, ad_count, adlen, state);
+    crypto_aead_aegis256_dec_iov(m, m_count, c, c_count, mlen, state);
+    crypto_aead_aegis256_finalize(computed_mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        aead_iov_memzero(m, m_count);
+        return -1;
+    }
+    return 0;
+}
+
+/* keystream for the next block, without updating the state */
+static void
+crypto_aead_aegis256_keystream(unsigned char *const ks, const uint8x16_t *const state)
+{
+    uint8x16_t tmp;
+
+    tmp = veorq_u8(state[5], state[4]);
+    tmp = veorq_u8(tmp, state[1]);
+    tmp = veorq_u8(tmp, vandq_u8(state[2], state[3]));
+    vst1q_u8(ks, tmp);
+}
+
+typedef struct aegis256_state {
+    uint8x16_t         state[6];
+    unsigned char      buf[16]; /* pending additional data or plaintext */
+    unsigned long long adlen;
+    unsigned long long mlen;
+    size_t             pos;
+    int                ad_done;
+} aegis256_state;
+
+/* absorb the pending partial block, zero-padded */
+static void
+crypto_aead_aegis256_stream_flush(aegis256_state *const st)
+{
+    if (st->pos > 0U) {
+        memset(st->buf + st->pos, 0, 16U - st->pos);
+        crypto_aead_aegis256_enc(st->buf, st->buf, st->state);
+        st->pos = 0U;
+    }
+}
+
+/*
+ * Encrypt or decrypt up to the next block boundary, buffering the plaintext
+ * until the block is complete. Returns the number of bytes processed.
+ */
+static size_t
+crypto_aead_aegis256_stream_partial(aegis256_state *const st, unsigned char *out,
+                                    const unsigned char *in, unsigned long long len,
+                                    int encrypt)
+{
+    CRYPTO_ALIGN(16) unsigned char ks[16];
+    unsigned char                  t;
+    size_t                         i;
+
+    crypto_aead_aegis256_keystream(ks, st->state);
+    for (i = 0U; i < len && st->pos < 16U; i++) {
+        t                = in[i];
+        out[i]           = t ^ ks[st->pos];
+        st->buf[st->pos] = encrypt ? t : out[i];
+        st->pos++;
     }
+    if (st->pos == 16U) {
+        crypto_aead_aegis256_enc(ks, st->buf, st->state);
+        st->pos = 0U;
+    }
+    sodium_memzero(ks, sizeof ks);
+
+    return i;
+}
+
+static void
+crypto_aead_aegis256_stream_update(aegis256_state *const st, unsigned char *out,
+                                   const unsigned char *in, unsigned long long len,
+                                   int encrypt)
+{
+    unsigned long long i = 0ULL;
+
+    if (len > crypto_aead_aegis256_MESSAGEBYTES_MAX - st->mlen) {
+        sodium_misuse();
+    }
+    if (st->ad_done == 0) {
+        crypto_aead_aegis256_stream_flush(st);
+        st->ad_done = 1;
+    }
+    st->mlen += len;
+    if (st->pos > 0U) {
+        i = crypto_aead_aegis256_stream_partial(st, out, in, len, encrypt);
+    }
+    if (encrypt) {
+        for (; i + 16ULL <= len; i += 16ULL) {
+            crypto_aead_aegis256_enc(out + i, in + i, st->state);
+        }
+    } else {
+        for (; i + 16ULL <= len; i += 16ULL) {
+            crypto_aead_aegis256_dec(out + i, in + i, st->state);
+        }
+    }
+    if (i < len) {
+        crypto_aead_aegis256_stream_partial(st, out + i, in + i, len - i, encrypt);
+    }
+}
+
+static void
+crypto_aead_aegis256_stream_final(aegis256_state *const st, unsigned char *mac)
+{
+    crypto_aead_aegis256_stream_flush(st);
+    crypto_aead_aegis256_finalize(mac, st->adlen, st->mlen, st->state);
+    sodium_memzero(st, sizeof *st);
+}
+
+static int
+aegis256_armcrypto_init(crypto_aead_aegis256_state *state_, const unsigned char *npub,
+                        const unsigned char *k)
+{
+    aegis256_state *st = (aegis256_state *) (void *) state_;
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    memset(st, 0, sizeof *st);
+    crypto_aead_aegis256_init_state(k, npub, st->state);
+
+    return 0;
+}
+
+static int
+aegis256_armcrypto_update_ad(crypto_aead_aegis256_state *state_, const unsigned char *ad,
+                             unsigned long long adlen)
+{
+    aegis256_state    *st = (aegis256_state *) (void *) state_;
+    unsigned long long i  = 0ULL;
+    size_t             n;
+
+    if (st->ad_done != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    st->adlen += adlen;
+    if (st->pos > 0U) {
+        n = 16U - st->pos;
+        if (n > adlen) {
+            n = (size_t) adlen;
+        }
+        memcpy(st->buf + st->pos, ad, n);
+        st->pos += n;
+        i = n;
+        if (st->pos == 16U) {
+            crypto_aead_aegis256_enc(st->buf, st->buf, st->state);
+            st->pos = 0U;
+        }
+    }
+    for (; i + 16ULL <= adlen; i += 16ULL) {
+        crypto_aead_aegis256_enc(st->buf, ad + i, st->state);
+    }
+    if (i < adlen) {
+        st->pos = (size_t) (adlen - i);
+        memcpy(st->buf, ad + i, st->pos);
+    }
+    return 0;
+}
+
+static int
+aegis256_armcrypto_encrypt_update(crypto_aead_aegis256_state *state_, unsigned char *c,
+                                  const unsigned char *m, unsigned long long mlen)
+{
+    crypto_aead_aegis256_stream_update((aegis256_state *) (void *) state_, c, m, mlen, 1);
+
+    return 0;
+}
+
+static int
+aegis256_armcrypto_encrypt_final(crypto_aead_aegis256_state *state_, unsigned char *mac)
+{
+    crypto_aead_aegis256_stream_final((aegis256_state *) (void *) state_, mac);
+
+    return 0;
+}
+
+static int
+aegis256_armcrypto_decrypt_update(crypto_aead_aegis256_state *state_, unsigned char *m,
+                                  const unsigned char *c, unsigned long long clen)
+{
+    crypto_aead_aegis256_stream_update((aegis256_state *) (void *) state_, m, c, clen, 0);
+
+    return 0;
+}
+
+static int
+aegis256_armcrypto_decrypt_final(crypto_aead_aegis256_state *state_, const unsigned char *mac)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    int                            ret;
+
+    crypto_aead_aegis256_stream_final((aegis256_state *) (void *) state_, computed_mac);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+
     return ret;
 }
 
-int
-crypto_aead_aegis256_is_available(void)
+static inline void
+crypto_aead_aegis256_absorb(const unsigned char *const src, uint8x16_t *const state)
+{
+    crypto_aead_aegis256_update(state, vld1q_u8(src));
+}
+
+/* AEGIS-MAC finalization: the tag length takes the place of the message length */
+static void
+crypto_aead_aegis256_mac_finalize(unsigned char *out, size_t outlen, unsigned long long inlen,
+                                  uint8x16_t *const state)
 {
-    return sodium_runtime_has_armcrypto();
+    uint8x16_t tmp;
+    int        i;
+
+    tmp = vreinterpretq_u8_u64(vsetq_lane_u64(outlen << 3,
+                                              vmovq_n_u64(inlen << 3), 1));
+    tmp = veorq_u8(tmp, state[3]);
+
+    for (i = 0; i < 7; i++) {
+        crypto_aead_aegis256_update(state, tmp);
+    }
+
+    if (outlen == 16U) {
+        tmp = veorq_u8(state[5], state[4]);
+        tmp = veorq_u8(tmp, state[3]);
+        tmp = veorq_u8(tmp, state[2]);
+        tmp = veorq_u8(tmp, state[1]);
+        tmp = veorq_u8(tmp, state[0]);
+        vst1q_u8(out, tmp);
+    } else {
+        tmp = veorq_u8(state[0], state[1]);
+        tmp = veorq_u8(tmp, state[2]);
+        vst1q_u8(out, tmp);
+        tmp = veorq_u8(state[3], state[4]);
+        tmp = veorq_u8(tmp, state[5]);
+        vst1q_u8(out + 16, tmp);
+    }
 }
 
+static int
+aegis256_armcrypto_mac_init(crypto_aead_aegis256_state *state_, const unsigned char *npub,
+                            const unsigned char *k)
+{
+    static const unsigned char zero_npub[crypto_aead_aegis256_NPUBBYTES];
+    aegis256_state *st = (aegis256_state *) (void *) state_;
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    memset(st, 0, sizeof *st);
+    crypto_aead_aegis256_init_state(k, npub != NULL ? npub : zero_npub, st->state);
+
+    return 0;
+}
+
+static int
+aegis256_armcrypto_mac_update(crypto_aead_aegis256_state *state_, const unsigned char *in,
+                              unsigned long long inlen)
+{
+    aegis256_state    *st = (aegis256_state *) (void *) state_;
+    unsigned long long i  = 0ULL;
+    size_t             n;
+
+    st->adlen += inlen;
+    if (st->pos > 0U) {
+        n = 16U - st->pos;
+        if (n > inlen) {
+            n = (size_t) inlen;
+        }
+        memcpy(st->buf + st->pos, in, n);
+        st->pos += n;
+        i = n;
+        if (st->pos == 16U) {
+            crypto_aead_aegis256_absorb(st->buf, st->state);
+            st->pos = 0U;
+        }
+    }
+    for (; i + 16ULL <= inlen; i += 16ULL) {
+        crypto_aead_aegis256_absorb(in + i, st->state);
+    }
+    if (i < inlen) {
+        st->pos = (size_t) (inlen - i);
+        memcpy(st->buf, in + i, st->pos);
+    }
+    return 0;
+}
+
+static int
+aegis256_armcrypto_mac_final(crypto_aead_aegis256_state *state_, unsigned char *out, size_t outlen)
+{
+    aegis256_state *st = (aegis256_state *) (void *) state_;
+
+    if (outlen != crypto_aead_aegis256_MACBYTES_MIN && outlen != crypto_aead_aegis256_MACBYTES_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (st->pos > 0U) {
+        memset(st->buf + st->pos, 0, 16U - st->pos);
+        crypto_aead_aegis256_absorb(st->buf, st->state);
+    }
+    crypto_aead_aegis256_mac_finalize(out, outlen, st->adlen, st->state);
+    sodium_memzero(st, sizeof *st);
+
+    return 0;
+}
+
+struct crypto_aead_aegis256_implementation crypto_aead_aegis256_armcrypto_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis256_armcrypto_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis256_armcrypto_decrypt_detached,
+    SODIUM_C99(.encrypt_detached_iov =) aegis256_armcrypto_encrypt_detached_iov,
+    SODIUM_C99(.decrypt_detached_iov =) aegis256_armcrypto_decrypt_detached_iov,
+    SODIUM_C99(.init =) aegis256_armcrypto_init,
+    SODIUM_C99(.update_ad =) aegis256_armcrypto_update_ad,
+    SODIUM_C99(.encrypt_update =) aegis256_armcrypto_encrypt_update,
+    SODIUM_C99(.encrypt_final =) aegis256_armcrypto_encrypt_final,
+    SODIUM_C99(.decrypt_update =) aegis256_armcrypto_decrypt_update,
+    SODIUM_C99(.decrypt_final =) aegis256_armcrypto_decrypt_final,
+    SODIUM_C99(.mac_init =) aegis256_armcrypto_mac_init,
+    SODIUM_C99(.mac_update =) aegis256_armcrypto_mac_update,
+    SODIUM_C99(.mac_final =) aegis256_armcrypto_mac_final
+};
+
 #endif
@@ -0,0 +1,9 @@
+#ifndef aead_aegis256_soft_H
+#define aead_aegis256_soft_H
+
+#include "../aegis256.h"
+
+extern struct crypto_aead_aegis256_implementation
+    crypto_aead_aegis256_soft_implementation;
+
+#endif
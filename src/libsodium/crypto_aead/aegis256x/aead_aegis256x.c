@@ -0,0 +1,347 @@
+#include <errno.h>
+#include <stdlib.h>
+
+#include "core.h"
+#include "crypto_aead_aegis256x.h"
+#include "private/common.h"
+#include "private/implementations.h"
+#include "private/stats.h"
+#include "randombytes.h"
+#include "runtime.h"
+
+#include "aegis256x.h"
+#include "soft/aead_aegis256x_soft.h"
+#if defined(HAVE_VAESINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+# include "vaes/aead_aegis256x_vaes.h"
+#endif
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+# include "aesni/aead_aegis256x_aesni.h"
+#endif
+#ifdef HAVE_ARMCRYPTO
+# include "armcrypto/aead_aegis256x_armcrypto.h"
+#endif
+
+#ifndef ENOSYS
+# define ENOSYS ENXIO
+#endif
+
+static const crypto_aead_aegis256x_implementation *implementation_x2 = NULL;
+static const crypto_aead_aegis256x_implementation *implementation_x4 = NULL;
+
+size_t
+crypto_aead_aegis256x2_keybytes(void)
+{
+    return crypto_aead_aegis256x2_KEYBYTES;
+}
+
+size_t
+crypto_aead_aegis256x2_nsecbytes(void)
+{
+    return crypto_aead_aegis256x2_NSECBYTES;
+}
+
+size_t
+crypto_aead_aegis256x2_npubbytes(void)
+{
+    return crypto_aead_aegis256x2_NPUBBYTES;
+}
+
+size_t
+crypto_aead_aegis256x2_abytes(void)
+{
+    return crypto_aead_aegis256x2_ABYTES;
+}
+
+size_t
+crypto_aead_aegis256x2_messagebytes_max(void)
+{
+    return crypto_aead_aegis256x2_MESSAGEBYTES_MAX;
+}
+
+void
+crypto_aead_aegis256x2_keygen(unsigned char k[crypto_aead_aegis256x2_KEYBYTES])
+{
+    randombytes_buf(k, crypto_aead_aegis256x2_KEYBYTES);
+}
+
+int
+crypto_aead_aegis256x2_is_available(void)
+{
+    return implementation_x2 != NULL;
+}
+
+int
+crypto_aead_aegis256x2_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                        unsigned long long *maclen_p, const unsigned char *m,
+                                        unsigned long long mlen, const unsigned char *ad,
+                                        unsigned long long adlen, const unsigned char *nsec,
+                                        const unsigned char *npub, const unsigned char *k)
+{
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (implementation_x2 == NULL) {
+        errno = ENOSYS;
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+        return -1;
+    }
+    if (mlen > crypto_aead_aegis256x2_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    implementation_x2->encrypt_detached(c, mac, m, mlen, ad, adlen, npub, k);
+    if (maclen_p != NULL) {
+        *maclen_p = crypto_aead_aegis256x2_ABYTES;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return 0;
+}
+
+int
+crypto_aead_aegis256x2_encrypt(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
+                               unsigned long long mlen, const unsigned char *ad,
+                               unsigned long long adlen, const unsigned char *nsec,
+                               const unsigned char *npub, const unsigned char *k)
+{
+    unsigned long long clen = 0ULL;
+    int                ret;
+
+    if (mlen > crypto_aead_aegis256x2_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    ret = crypto_aead_aegis256x2_encrypt_detached(c, c + mlen, NULL, m, mlen,
+                                                  ad, adlen, nsec, npub, k);
+    if (clen_p != NULL) {
+        if (ret == 0) {
+            clen = mlen + crypto_aead_aegis256x2_ABYTES;
+        }
+        *clen_p = clen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aegis256x2_decrypt_detached(unsigned char *m, unsigned char *nsec, const unsigned char *c,
+                                        unsigned long long clen, const unsigned char *mac,
+                                        const unsigned char *ad, unsigned long long adlen,
+                                        const unsigned char *npub, const unsigned char *k)
+{
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (implementation_x2 == NULL) {
+        errno = ENOSYS;
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+        return -1;
+    }
+    if (clen > crypto_aead_aegis256x2_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    ret = implementation_x2->decrypt_detached(m, c, clen, mac, ad, adlen, npub, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+
+    return ret;
+}
+
+int
+crypto_aead_aegis256x2_decrypt(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
+                               const unsigned char *c, unsigned long long clen,
+                               const unsigned char *ad, unsigned long long adlen,
+                               const unsigned char *npub, const unsigned char *k)
+{
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+
+    if (clen >= crypto_aead_aegis256x2_ABYTES) {
+        ret = crypto_aead_aegis256x2_decrypt_detached
+            (m, nsec, c, clen - crypto_aead_aegis256x2_ABYTES,
+             c + clen - crypto_aead_aegis256x2_ABYTES, ad, adlen, npub, k);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_aegis256x2_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+size_t
+crypto_aead_aegis256x4_keybytes(void)
+{
+    return crypto_aead_aegis256x4_KEYBYTES;
+}
+
+size_t
+crypto_aead_aegis256x4_nsecbytes(void)
+{
+    return crypto_aead_aegis256x4_NSECBYTES;
+}
+
+size_t
+crypto_aead_aegis256x4_npubbytes(void)
+{
+    return crypto_aead_aegis256x4_NPUBBYTES;
+}
+
+size_t
+crypto_aead_aegis256x4_abytes(void)
+{
+    return crypto_aead_aegis256x4_ABYTES;
+}
+
+size_t
+crypto_aead_aegis256x4_messagebytes_max(void)
+{
+    return crypto_aead_aegis256x4_MESSAGEBYTES_MAX;
+}
+
+void
+crypto_aead_aegis256x4_keygen(unsigned char k[crypto_aead_aegis256x4_KEYBYTES])
+{
+    randombytes_buf(k, crypto_aead_aegis256x4_KEYBYTES);
+}
+
+int
+crypto_aead_aegis256x4_is_available(void)
+{
+    return implementation_x4 != NULL;
+}
+
+int
+crypto_aead_aegis256x4_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                        unsigned long long *maclen_p, const unsigned char *m,
+                                        unsigned long long mlen, const unsigned char *ad,
+                                        unsigned long long adlen, const unsigned char *nsec,
+                                        const unsigned char *npub, const unsigned char *k)
+{
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (implementation_x4 == NULL) {
+        errno = ENOSYS;
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+        return -1;
+    }
+    if (mlen > crypto_aead_aegis256x4_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    implementation_x4->encrypt_detached(c, mac, m, mlen, ad, adlen, npub, k);
+    if (maclen_p != NULL) {
+        *maclen_p = crypto_aead_aegis256x4_ABYTES;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return 0;
+}
+
+int
+crypto_aead_aegis256x4_encrypt(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
+                               unsigned long long mlen, const unsigned char *ad,
+                               unsigned long long adlen, const unsigned char *nsec,
+                               const unsigned char *npub, const unsigned char *k)
+{
+    unsigned long long clen = 0ULL;
+    int                ret;
+
+    if (mlen > crypto_aead_aegis256x4_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    ret = crypto_aead_aegis256x4_encrypt_detached(c, c + mlen, NULL, m, mlen,
+                                                  ad, adlen, nsec, npub, k);
+    if (clen_p != NULL) {
+        if (ret == 0) {
+            clen = mlen + crypto_aead_aegis256x4_ABYTES;
+        }
+        *clen_p = clen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aegis256x4_decrypt_detached(unsigned char *m, unsigned char *nsec, const unsigned char *c,
+                                        unsigned long long clen, const unsigned char *mac,
+                                        const unsigned char *ad, unsigned long long adlen,
+                                        const unsigned char *npub, const unsigned char *k)
+{
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (implementation_x4 == NULL) {
+        errno = ENOSYS;
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+        return -1;
+    }
+    if (clen > crypto_aead_aegis256x4_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    ret = implementation_x4->decrypt_detached(m, c, clen, mac, ad, adlen, npub, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+
+    return ret;
+}
+
+int
+crypto_aead_aegis256x4_decrypt(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
+                               const unsigned char *c, unsigned long long clen,
+                               const unsigned char *ad, unsigned long long adlen,
+                               const unsigned char *npub, const unsigned char *k)
+{
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+
+    if (clen >= crypto_aead_aegis256x4_ABYTES) {
+        ret = crypto_aead_aegis256x4_decrypt_detached
+            (m, nsec, c, clen - crypto_aead_aegis256x4_ABYTES,
+             c + clen - crypto_aead_aegis256x4_ABYTES, ad, adlen, npub, k);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_aegis256x4_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+int
+_crypto_aead_aegis256x_pick_best_implementation(void)
+{
+    implementation_x2 = &crypto_aead_aegis256x2_soft_implementation;
+    implementation_x4 = &crypto_aead_aegis256x4_soft_implementation;
+#if defined(HAVE_VAESINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+    if (sodium_runtime_has_vaes() &&
+        _sodium_implementation_allowed("aes", "aesni")) {
+        implementation_x2 = &crypto_aead_aegis256x2_vaes_implementation;
+        implementation_x4 = &crypto_aead_aegis256x4_vaes_implementation;
+# ifdef HAVE_AVX512FINTRIN_H
+        if (sodium_runtime_has_avx512f() &&
+            _sodium_runtime_use_512bit_vectors()) {
+            implementation_x4 = &crypto_aead_aegis256x4_vaes512_implementation;
+        }
+# endif
+        return 0;
+    }
+#endif
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+    if (sodium_runtime_has_aesni() &&
+        _sodium_implementation_allowed("aes", "aesni")) {
+        implementation_x2 = &crypto_aead_aegis256x2_aesni_implementation;
+        implementation_x4 = &crypto_aead_aegis256x4_aesni_implementation;
+        return 0;
+    }
+#endif
+#ifdef HAVE_ARMCRYPTO
+    if (sodium_runtime_has_armcrypto() &&
+        _sodium_implementation_allowed("aes", "armcrypto")) {
+        implementation_x2 = &crypto_aead_aegis256x2_armcrypto_implementation;
+        implementation_x4 = &crypto_aead_aegis256x4_armcrypto_implementation;
+        return 0;
+    }
+#endif
+    return 0;
+}
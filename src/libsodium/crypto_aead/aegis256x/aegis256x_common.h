@@ -0,0 +1,253 @@
+/*
+ * AEGIS-256X, as specified in draft-irtf-cfrg-aegis-aead.
+ *
+ * D independent AEGIS-256 states are stored lane-wise: aes_block_t holds
+ * the same state word for all of them, so that each AES round operates on
+ * D blocks at once. The includer defines D, aes_block_t, the AES_BLOCK_*
+ * and AES_ENC operations, as well as FN() to name the functions.
+ */
+
+#define RATE (16 * D)
+
+static inline void
+FN(update)(aes_block_t *const state, const aes_block_t data)
+{
+    aes_block_t tmp;
+
+    tmp      = AES_ENC(state[5], state[0]);
+    state[5] = AES_ENC(state[4], state[5]);
+    state[4] = AES_ENC(state[3], state[4]);
+    state[3] = AES_ENC(state[2], state[3]);
+    state[2] = AES_ENC(state[1], state[2]);
+    state[1] = AES_ENC(state[0], state[1]);
+    state[0] = AES_BLOCK_XOR(tmp, data);
+}
+
+static aes_block_t
+FN(load_rep)(const unsigned char *in)
+{
+    CRYPTO_ALIGN(32) unsigned char t[RATE];
+    size_t                         i;
+
+    for (i = 0U; i < D; i++) {
+        memcpy(t + i * 16U, in, 16U);
+    }
+    return AES_BLOCK_LOAD(t);
+}
+
+static void
+FN(init_state)(const unsigned char *key, const unsigned char *nonce, aes_block_t *const state)
+{
+    static CRYPTO_ALIGN(16) const unsigned char c0_[] = {
+        0x00, 0x01, 0x01, 0x02, 0x03, 0x05, 0x08, 0x0d, 0x15, 0x22, 0x37, 0x59,
+        0x90, 0xe9, 0x79, 0x62
+    };
+    static CRYPTO_ALIGN(16) const unsigned char c1_[] = {
+        0xdb, 0x3d, 0x18, 0x55, 0x6d, 0xc2, 0x2f, 0xf1, 0x20, 0x11, 0x31, 0x42,
+        0x73, 0xb5, 0x28, 0xdd
+    };
+    CRYPTO_ALIGN(32) unsigned char ctx_[RATE];
+    aes_block_t                    c0, c1, ctx, k0, k1, k0n0, k1n1;
+    size_t                         i;
+
+    /* lane i is tagged with its index and with the degree, minus one */
+    memset(ctx_, 0, sizeof ctx_);
+    for (i = 0U; i < D; i++) {
+        ctx_[i * 16U]      = (unsigned char) i;
+        ctx_[i * 16U + 1U] = (unsigned char) (D - 1);
+    }
+    ctx  = AES_BLOCK_LOAD(ctx_);
+    c0   = FN(load_rep)(c0_);
+    c1   = FN(load_rep)(c1_);
+    k0   = FN(load_rep)(key);
+    k1   = FN(load_rep)(key + 16);
+    k0n0 = AES_BLOCK_XOR(k0, FN(load_rep)(nonce));
+    k1n1 = AES_BLOCK_XOR(k1, FN(load_rep)(nonce + 16));
+
+    state[0] = k0n0;
+    state[1] = k1n1;
+    state[2] = c1;
+    state[3] = c0;
+    state[4] = AES_BLOCK_XOR(k0, c0);
+    state[5] = AES_BLOCK_XOR(k1, c1);
+    for (i = 0U; i < 4U; i++) {
+        state[3] = AES_BLOCK_XOR(state[3], ctx);
+        state[5] = AES_BLOCK_XOR(state[5], ctx);
+        FN(update)(state, k0);
+        state[3] = AES_BLOCK_XOR(state[3], ctx);
+        state[5] = AES_BLOCK_XOR(state[5], ctx);
+        FN(update)(state, k1);
+        state[3] = AES_BLOCK_XOR(state[3], ctx);
+        state[5] = AES_BLOCK_XOR(state[5], ctx);
+        FN(update)(state, k0n0);
+        state[3] = AES_BLOCK_XOR(state[3], ctx);
+        state[5] = AES_BLOCK_XOR(state[5], ctx);
+        FN(update)(state, k1n1);
+    }
+}
+
+static void
+FN(mac)(unsigned char *mac, unsigned long long adlen, unsigned long long mlen,
+        aes_block_t *const state)
+{
+    CRYPTO_ALIGN(16) unsigned char sizes[16];
+    CRYPTO_ALIGN(32) unsigned char t[RATE];
+    aes_block_t                    tmp;
+    size_t                         i;
+    size_t                         j;
+
+    STORE64_LE(sizes, adlen << 3);
+    STORE64_LE(sizes + 8, mlen << 3);
+    tmp = AES_BLOCK_XOR(FN(load_rep)(sizes), state[3]);
+
+    for (i = 0U; i < 7U; i++) {
+        FN(update)(state, tmp);
+    }
+
+    tmp = AES_BLOCK_XOR(state[5], state[4]);
+    tmp = AES_BLOCK_XOR(tmp, state[3]);
+    tmp = AES_BLOCK_XOR(tmp, state[2]);
+    tmp = AES_BLOCK_XOR(tmp, state[1]);
+    tmp = AES_BLOCK_XOR(tmp, state[0]);
+
+    AES_BLOCK_STORE(t, tmp);
+    for (i = 1U; i < D; i++) {
+        for (j = 0U; j < 16U; j++) {
+            t[j] ^= t[i * 16U + j];
+        }
+    }
+    memcpy(mac, t, 16U);
+}
+
+static inline void
+FN(enc)(unsigned char *const dst, const unsigned char *const src, aes_block_t *const state)
+{
+    aes_block_t msg;
+    aes_block_t tmp;
+
+    msg = AES_BLOCK_LOAD(src);
+    tmp = AES_BLOCK_XOR(msg, state[5]);
+    tmp = AES_BLOCK_XOR(tmp, state[4]);
+    tmp = AES_BLOCK_XOR(tmp, state[1]);
+    tmp = AES_BLOCK_XOR(tmp, AES_BLOCK_AND(state[2], state[3]));
+    AES_BLOCK_STORE(dst, tmp);
+
+    FN(update)(state, msg);
+}
+
+static inline void
+FN(dec)(unsigned char *const dst, const unsigned char *const src, aes_block_t *const state)
+{
+    aes_block_t msg;
+
+    msg = AES_BLOCK_LOAD(src);
+    msg = AES_BLOCK_XOR(msg, state[5]);
+    msg = AES_BLOCK_XOR(msg, state[4]);
+    msg = AES_BLOCK_XOR(msg, state[1]);
+    msg = AES_BLOCK_XOR(msg, AES_BLOCK_AND(state[2], state[3]));
+    AES_BLOCK_STORE(dst, msg);
+
+    FN(update)(state, msg);
+}
+
+static int
+FN(encrypt_detached)(unsigned char *c, unsigned char *mac, const unsigned char *m,
+                     unsigned long long mlen, const unsigned char *ad,
+                     unsigned long long adlen, const unsigned char *npub,
+                     const unsigned char *k)
+{
+    aes_block_t                    state[6];
+    CRYPTO_ALIGN(32) unsigned char src[RATE];
+    CRYPTO_ALIGN(32) unsigned char dst[RATE];
+    unsigned long long             i;
+
+    FN(init_state)(k, npub, state);
+
+    for (i = 0ULL; i + RATE <= adlen; i += RATE) {
+        FN(enc)(dst, ad + i, state);
+    }
+    if (adlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, ad + i, adlen & (RATE - 1));
+        FN(enc)(dst, src, state);
+    }
+    for (i = 0ULL; i + RATE <= mlen; i += RATE) {
+        FN(enc)(c + i, m + i, state);
+    }
+    if (mlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, m + i, mlen & (RATE - 1));
+        FN(enc)(dst, src, state);
+        memcpy(c + i, dst, mlen & (RATE - 1));
+    }
+
+    FN(mac)(mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+
+    return 0;
+}
+
+static int
+FN(decrypt_detached)(unsigned char *m, const unsigned char *c, unsigned long long clen,
+                     const unsigned char *mac, const unsigned char *ad,
+                     unsigned long long adlen, const unsigned char *npub,
+                     const unsigned char *k)
+{
+    aes_block_t                    state[6];
+    CRYPTO_ALIGN(32) unsigned char src[RATE];
+    CRYPTO_ALIGN(32) unsigned char dst[RATE];
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    unsigned long long             i;
+    unsigned long long             mlen;
+    int                            ret;
+
+    mlen = clen;
+    FN(init_state)(k, npub, state);
+
+    for (i = 0ULL; i + RATE <= adlen; i += RATE) {
+        FN(enc)(dst, ad + i, state);
+    }
+    if (adlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, ad + i, adlen & (RATE - 1));
+        FN(enc)(dst, src, state);
+    }
+    if (m != NULL) {
+        for (i = 0ULL; i + RATE <= mlen; i += RATE) {
+            FN(dec)(m + i, c + i, state);
+        }
+    } else {
+        for (i = 0ULL; i + RATE <= mlen; i += RATE) {
+            FN(dec)(dst, c + i, state);
+        }
+    }
+    if (mlen & (RATE - 1)) {
+        memset(src, 0, RATE);
+        memcpy(src, c + i, mlen & (RATE - 1));
+        FN(dec)(dst, src, state);
+        if (m != NULL) {
+            memcpy(m + i, dst, mlen & (RATE - 1));
+        }
+        memset(dst, 0, mlen & (RATE - 1));
+        state[0] = AES_BLOCK_XOR(state[0], AES_BLOCK_LOAD(dst));
+    }
+
+    FN(mac)(computed_mac, adlen, mlen, state);
+    sodium_memzero(state, sizeof state);
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        memset(m, 0, mlen);
+        return -1;
+    }
+    return 0;
+}
+
+#undef RATE
@@ -0,0 +1,11 @@
+#ifndef aead_aegis256x_aesni_H
+#define aead_aegis256x_aesni_H
+
+#include "../aegis256x.h"
+
+extern struct crypto_aead_aegis256x_implementation
+    crypto_aead_aegis256x2_aesni_implementation;
+extern struct crypto_aead_aegis256x_implementation
+    crypto_aead_aegis256x4_aesni_implementation;
+
+#endif
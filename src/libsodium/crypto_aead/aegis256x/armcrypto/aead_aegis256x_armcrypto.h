@@ -0,0 +1,11 @@
+#ifndef aead_aegis256x_armcrypto_H
+#define aead_aegis256x_armcrypto_H
+
+#include "../aegis256x.h"
+
+extern struct crypto_aead_aegis256x_implementation
+    crypto_aead_aegis256x2_armcrypto_implementation;
+extern struct crypto_aead_aegis256x_implementation
+    crypto_aead_aegis256x4_armcrypto_implementation;
+
+#endif
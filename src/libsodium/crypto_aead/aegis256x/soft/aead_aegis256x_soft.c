@@ -0,0 +1,177 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "utils.h"
+
+#include "private/common.h"
+#include "private/softaes.h"
+
+#include "aead_aegis256x_soft.h"
+
+/*
+ * Portable, constant-time implementation for CPUs without AES instructions.
+ * softaes_enc4() computes 4 AES rounds at once, so that AEGIS-256X4 uses it
+ * at full width, and AEGIS-256X2 at half width.
+ */
+
+typedef struct aes_block2_t {
+    uint64_t w[4];
+} aes_block2_t;
+
+typedef struct aes_block4_t {
+    uint64_t w[8];
+} aes_block4_t;
+
+static inline aes_block2_t
+aes_block2_load(const unsigned char *a)
+{
+    aes_block2_t r;
+
+    memcpy(&r, a, sizeof r);
+    return r;
+}
+
+static inline void
+aes_block2_store(unsigned char *a, const aes_block2_t b)
+{
+    memcpy(a, &b, sizeof b);
+}
+
+static inline aes_block2_t
+aes_block2_xor(const aes_block2_t a, const aes_block2_t b)
+{
+    aes_block2_t r;
+    size_t       i;
+
+    for (i = 0U; i < 4U; i++) {
+        r.w[i] = a.w[i] ^ b.w[i];
+    }
+    return r;
+}
+
+static inline aes_block2_t
+aes_block2_and(const aes_block2_t a, const aes_block2_t b)
+{
+    aes_block2_t r;
+    size_t       i;
+
+    for (i = 0U; i < 4U; i++) {
+        r.w[i] = a.w[i] & b.w[i];
+    }
+    return r;
+}
+
+static inline aes_block2_t
+aes_block2_enc(const aes_block2_t a, const aes_block2_t b)
+{
+    CRYPTO_ALIGN(16) unsigned char in[64];
+    CRYPTO_ALIGN(16) unsigned char rk[64];
+    CRYPTO_ALIGN(16) unsigned char out[64];
+
+    memcpy(in, &a, sizeof a);
+    memcpy(rk, &b, sizeof b);
+    memset(in + sizeof a, 0, sizeof in - sizeof a);
+    memset(rk + sizeof b, 0, sizeof rk - sizeof b);
+    softaes_enc4(out, in, rk);
+
+    return aes_block2_load(out);
+}
+
+static inline aes_block4_t
+aes_block4_load(const unsigned char *a)
+{
+    aes_block4_t r;
+
+    memcpy(&r, a, sizeof r);
+    return r;
+}
+
+static inline void
+aes_block4_store(unsigned char *a, const aes_block4_t b)
+{
+    memcpy(a, &b, sizeof b);
+}
+
+static inline aes_block4_t
+aes_block4_xor(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+    size_t       i;
+
+    for (i = 0U; i < 8U; i++) {
+        r.w[i] = a.w[i] ^ b.w[i];
+    }
+    return r;
+}
+
+static inline aes_block4_t
+aes_block4_and(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+    size_t       i;
+
+    for (i = 0U; i < 8U; i++) {
+        r.w[i] = a.w[i] & b.w[i];
+    }
+    return r;
+}
+
+static inline aes_block4_t
+aes_block4_enc(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+
+    softaes_enc4((unsigned char *) (void *) &r, (const unsigned char *) (const void *) &a,
+                 (const unsigned char *) (const void *) &b);
+    return r;
+}
+
+#define D 2
+#define aes_block_t     aes_block2_t
+#define AES_BLOCK_LOAD  aes_block2_load
+#define AES_BLOCK_STORE aes_block2_store
+#define AES_BLOCK_XOR   aes_block2_xor
+#define AES_BLOCK_AND   aes_block2_and
+#define AES_ENC         aes_block2_enc
+#define FN(name)        aegis256x2_soft_##name
+#include "../aegis256x_common.h"
+#undef D
+#undef aes_block_t
+#undef AES_BLOCK_LOAD
+#undef AES_BLOCK_STORE
+#undef AES_BLOCK_XOR
+#undef AES_BLOCK_AND
+#undef AES_ENC
+#undef FN
+
+#define D 4
+#define aes_block_t     aes_block4_t
+#define AES_BLOCK_LOAD  aes_block4_load
+#define AES_BLOCK_STORE aes_block4_store
+#define AES_BLOCK_XOR   aes_block4_xor
+#define AES_BLOCK_AND   aes_block4_and
+#define AES_ENC         aes_block4_enc
+#define FN(name)        aegis256x4_soft_##name
+#include "../aegis256x_common.h"
+#undef D
+#undef aes_block_t
+#undef AES_BLOCK_LOAD
+#undef AES_BLOCK_STORE
+#undef AES_BLOCK_XOR
+#undef AES_BLOCK_AND
+#undef AES_ENC
+#undef FN
+
+struct crypto_aead_aegis256x_implementation crypto_aead_aegis256x2_soft_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis256x2_soft_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis256x2_soft_decrypt_detached
+};
+
+struct crypto_aead_aegis256x_implementation crypto_aead_aegis256x4_soft_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis256x4_soft_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis256x4_soft_decrypt_detached
+};
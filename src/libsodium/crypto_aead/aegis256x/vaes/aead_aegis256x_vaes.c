@@ -0,0 +1,143 @@
+/*
+ * AEGIS-256X using VAES: a 256-bit register holds the same state word of
+ * two AEGIS-256 lanes. AEGIS-256X4 uses pairs of registers.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "utils.h"
+
+#include "private/common.h"
+
+#if defined(HAVE_VAESINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("ssse3")
+#  pragma GCC target("aes")
+#  pragma GCC target("avx")
+#  pragma GCC target("avx2")
+#  pragma GCC target("vaes")
+# endif
+
+# include <immintrin.h>
+
+# include "aead_aegis256x_vaes.h"
+
+typedef __m256i aes_block2_t;
+
+typedef struct aes_block4_t {
+    __m256i b0, b1;
+} aes_block4_t;
+
+static inline aes_block2_t
+aes_block2_load(const unsigned char *a)
+{
+    return _mm256_loadu_si256((const __m256i *) (const void *) a);
+}
+
+static inline void
+aes_block2_store(unsigned char *a, const aes_block2_t b)
+{
+    _mm256_storeu_si256((__m256i *) (void *) a, b);
+}
+
+static inline aes_block4_t
+aes_block4_load(const unsigned char *a)
+{
+    aes_block4_t r;
+
+    r.b0 = _mm256_loadu_si256((const __m256i *) (const void *) a);
+    r.b1 = _mm256_loadu_si256((const __m256i *) (const void *) (a + 32));
+    return r;
+}
+
+static inline void
+aes_block4_store(unsigned char *a, const aes_block4_t b)
+{
+    _mm256_storeu_si256((__m256i *) (void *) a, b.b0);
+    _mm256_storeu_si256((__m256i *) (void *) (a + 32), b.b1);
+}
+
+static inline aes_block4_t
+aes_block4_xor(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+
+    r.b0 = _mm256_xor_si256(a.b0, b.b0);
+    r.b1 = _mm256_xor_si256(a.b1, b.b1);
+    return r;
+}
+
+static inline aes_block4_t
+aes_block4_and(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+
+    r.b0 = _mm256_and_si256(a.b0, b.b0);
+    r.b1 = _mm256_and_si256(a.b1, b.b1);
+    return r;
+}
+
+static inline aes_block4_t
+aes_block4_enc(const aes_block4_t a, const aes_block4_t b)
+{
+    aes_block4_t r;
+
+    r.b0 = _mm256_aesenc_epi128(a.b0, b.b0);
+    r.b1 = _mm256_aesenc_epi128(a.b1, b.b1);
+    return r;
+}
+
+# define D 2
+# define aes_block_t     aes_block2_t
+# define AES_BLOCK_LOAD  aes_block2_load
+# define AES_BLOCK_STORE aes_block2_store
+# define AES_BLOCK_XOR   _mm256_xor_si256
+# define AES_BLOCK_AND   _mm256_and_si256
+# define AES_ENC         _mm256_aesenc_epi128
+# define FN(name)        aegis256x2_vaes_##name
+# include "../aegis256x_common.h"
+# undef D
+# undef aes_block_t
+# undef AES_BLOCK_LOAD
+# undef AES_BLOCK_STORE
+# undef AES_BLOCK_XOR
+# undef AES_BLOCK_AND
+# undef AES_ENC
+# undef FN
+
+# define D 4
+# define aes_block_t     aes_block4_t
+# define AES_BLOCK_LOAD  aes_block4_load
+# define AES_BLOCK_STORE aes_block4_store
+# define AES_BLOCK_XOR   aes_block4_xor
+# define AES_BLOCK_AND   aes_block4_and
+# define AES_ENC         aes_block4_enc
+# define FN(name)        aegis256x4_vaes_##name
+# include "../aegis256x_common.h"
+# undef D
+# undef aes_block_t
+# undef AES_BLOCK_LOAD
+# undef AES_BLOCK_STORE
+# undef AES_BLOCK_XOR
+# undef AES_BLOCK_AND
+# undef AES_ENC
+# undef FN
+
+struct crypto_aead_aegis256x_implementation crypto_aead_aegis256x2_vaes_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis256x2_vaes_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis256x2_vaes_decrypt_detached
+};
+
+struct crypto_aead_aegis256x_implementation crypto_aead_aegis256x4_vaes_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis256x4_vaes_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis256x4_vaes_decrypt_detached
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef aead_aegis256x_vaes_H
+#define aead_aegis256x_vaes_H
+
+#include "../aegis256x.h"
+
+extern struct crypto_aead_aegis256x_implementation
+    crypto_aead_aegis256x2_vaes_implementation;
+extern struct crypto_aead_aegis256x_implementation
+    crypto_aead_aegis256x4_vaes_implementation;
+extern struct crypto_aead_aegis256x_implementation
+    crypto_aead_aegis256x4_vaes512_implementation;
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * AEGIS-256X4 using VAES on 512-bit registers: each register holds the same
+ * state word of the four AEGIS-256 lanes.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "utils.h"
+
+#include "private/common.h"
+
+#if defined(HAVE_VAESINTRIN_H) && defined(HAVE_AVX512FINTRIN_H) && \
+    defined(HAVE_AVX2INTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_WMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("ssse3")
+#  pragma GCC target("aes")
+#  pragma GCC target("avx")
+#  pragma GCC target("avx2")
+#  pragma GCC target("avx512f")
+#  pragma GCC target("vaes")
+# endif
+
+# include <immintrin.h>
+
+# include "aead_aegis256x_vaes.h"
+
+static inline __m512i
+aes_block4_load(const unsigned char *a)
+{
+    return _mm512_loadu_si512((const void *) a);
+}
+
+static inline void
+aes_block4_store(unsigned char *a, const __m512i b)
+{
+    _mm512_storeu_si512((void *) a, b);
+}
+
+# define D 4
+# define aes_block_t     __m512i
+# define AES_BLOCK_LOAD  aes_block4_load
+# define AES_BLOCK_STORE aes_block4_store
+# define AES_BLOCK_XOR   _mm512_xor_si512
+# define AES_BLOCK_AND   _mm512_and_si512
+# define AES_ENC         _mm512_aesenc_epi128
+# define FN(name)        aegis256x4_vaes512_##name
+# include "../aegis256x_common.h"
+# undef D
+# undef aes_block_t
+# undef AES_BLOCK_LOAD
+# undef AES_BLOCK_STORE
+# undef AES_BLOCK_XOR
+# undef AES_BLOCK_AND
+# undef AES_ENC
+# undef FN
+
+struct crypto_aead_aegis256x_implementation crypto_aead_aegis256x4_vaes512_implementation = {
+    SODIUM_C99(.encrypt_detached =) aegis256x4_vaes512_encrypt_detached,
+    SODIUM_C99(.decrypt_detached =) aegis256x4_vaes512_decrypt_detached
+};
+
+#endif
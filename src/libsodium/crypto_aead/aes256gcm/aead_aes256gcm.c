@@ -0,0 +1,380 @@
+/*
+ * AES256-GCM. The AES and GHASH code is in the aesni, armcrypto and soft
+ * implementations; the portable one is used when the CPU lacks AES or
+ * carry-less multiplication instructions.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aes256gcm.h"
+#include "private/common.h"
+#include "private/implementations.h"
+#include "private/offload.h"
+#include "private/stats.h"
+#include "randombytes.h"
+#include "runtime.h"
+#include "utils.h"
+
+#include "aes256gcm.h"
+#include "soft/aead_aes256gcm_soft.h"
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+# include "aesni/aead_aes256gcm_aesni.h"
+#endif
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+# include "armcrypto/aead_aes256gcm_armcrypto.h"
+#endif
+
+static const crypto_aead_aes256gcm_implementation *implementation =
+    &crypto_aead_aes256gcm_soft_implementation;
+
+size_t
+crypto_aead_aes256gcm_keybytes(void)
+{
+    return crypto_aead_aes256gcm_KEYBYTES;
+}
+
+size_t
+crypto_aead_aes256gcm_nsecbytes(void)
+{
+    return crypto_aead_aes256gcm_NSECBYTES;
+}
+
+size_t
+crypto_aead_aes256gcm_npubbytes(void)
+{
+    return crypto_aead_aes256gcm_NPUBBYTES;
+}
+
+size_t
+crypto_aead_aes256gcm_abytes(void)
+{
+    return crypto_aead_aes256gcm_ABYTES;
+}
+
+size_t
+crypto_aead_aes256gcm_statebytes(void)
+{
+    return (sizeof(crypto_aead_aes256gcm_state) + (size_t) 15U) & ~(size_t) 15U;
+}
+
+size_t
+crypto_aead_aes256gcm_compact_keybytes(void)
+{
+    return sizeof(crypto_aead_aes256gcm_compact_key);
+}
+
+size_t
+crypto_aead_aes256gcm_stream_statebytes(void)
+{
+    return sizeof(crypto_aead_aes256gcm_stream_state);
+}
+
+size_t
+crypto_aead_aes256gcm_messagebytes_max(void)
+{
+    return crypto_aead_aes256gcm_MESSAGEBYTES_MAX;
+}
+
+void
+crypto_aead_aes256gcm_keygen(unsigned char k[crypto_aead_aes256gcm_KEYBYTES])
+{
+    randombytes_buf(k, crypto_aead_aes256gcm_KEYBYTES);
+}
+
+int
+crypto_aead_aes256gcm_beforenm(crypto_aead_aes256gcm_state *ctx_, const unsigned char *k)
+{
+    return implementation->beforenm(ctx_, k);
+}
+
+int
+crypto_aead_aes256gcm_encrypt_detached_afternm(unsigned char *c, unsigned char *mac,
+                                               unsigned long long *maclen_p, const unsigned char *m,
+                                               unsigned long long mlen, const unsigned char *ad,
+                                               unsigned long long adlen, const unsigned char *nsec,
+                                               const unsigned char *              npub,
+                                               const crypto_aead_aes256gcm_state *ctx_)
+{
+    return implementation->encrypt_detached_afternm(c, mac, maclen_p, m, mlen, ad, adlen, nsec,
+                                                    npub, ctx_);
+}
+
+int
+crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *nsec,
+                                               const unsigned char *c, unsigned long long clen,
+                                               const unsigned char *mac, const unsigned char *ad,
+                                               unsigned long long adlen, const unsigned char *npub,
+                                               const crypto_aead_aes256gcm_state *ctx_)
+{
+    return implementation->decrypt_detached_afternm(m, nsec, c, clen, mac, ad, adlen, npub, ctx_);
+}
+
+int
+crypto_aead_aes256gcm_compact_beforenm(crypto_aead_aes256gcm_compact_key *ck_,
+                                       const unsigned char *k, size_t count)
+{
+    return implementation->compact_beforenm(ck_, k, count);
+}
+
+int
+crypto_aead_aes256gcm_compact_expand(crypto_aead_aes256gcm_state *ctx_,
+                                     const crypto_aead_aes256gcm_compact_key *ck)
+{
+    return implementation->compact_expand(ctx_, ck);
+}
+
+int
+crypto_aead_aes256gcm_encrypt_detached_compact(unsigned char *c, unsigned char *mac,
+                                               unsigned long long *maclen_p, const unsigned char *m,
+                                               unsigned long long mlen, const unsigned char *ad,
+                                               unsigned long long adlen, const unsigned char *nsec,
+                                               const unsigned char *npub,
+                                               const crypto_aead_aes256gcm_compact_key *ck)
+{
+    return implementation->encrypt_detached_compact(c, mac, maclen_p, m, mlen, ad, adlen, nsec,
+                                                    npub, ck);
+}
+
+int
+crypto_aead_aes256gcm_decrypt_detached_compact(unsigned char *m, unsigned char *nsec,
+                                               const unsigned char *c, unsigned long long clen,
+                                               const unsigned char *mac, const unsigned char *ad,
+                                               unsigned long long adlen, const unsigned char *npub,
+                                               const crypto_aead_aes256gcm_compact_key *ck)
+{
+    return implementation->decrypt_detached_compact(m, nsec, c, clen, mac, ad, adlen, npub, ck);
+}
+
+int
+crypto_aead_aes256gcm_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                                           unsigned char *mac, unsigned long long *maclen_p,
+                                           const crypto_aead_iovec *m, size_t m_count,
+                                           const crypto_aead_iovec *ad, size_t ad_count,
+                                           const unsigned char *nsec,
+                                           const unsigned char *npub, const unsigned char *k)
+{
+    return implementation->encrypt_detached_iov(c, c_count, mac, maclen_p, m, m_count, ad,
+                                                ad_count, nsec, npub, k);
+}
+
+int
+crypto_aead_aes256gcm_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                                           unsigned char *nsec,
+                                           const crypto_aead_iovec *c, size_t c_count,
+                                           const unsigned char *mac,
+                                           const crypto_aead_iovec *ad, size_t ad_count,
+                                           const unsigned char *npub, const unsigned char *k)
+{
+    return implementation->decrypt_detached_iov(m, m_count, nsec, c, c_count, mac, ad, ad_count,
+                                                npub, k);
+}
+
+int
+crypto_aead_aes256gcm_init(crypto_aead_aes256gcm_stream_state *state_,
+                           const unsigned char *npub,
+                           const crypto_aead_aes256gcm_state *ctx_)
+{
+    return implementation->init(state_, npub, ctx_);
+}
+
+int
+crypto_aead_aes256gcm_update_ad(crypto_aead_aes256gcm_stream_state *state_,
+                                const unsigned char *ad, unsigned long long adlen)
+{
+    return implementation->update_ad(state_, ad, adlen);
+}
+
+int
+crypto_aead_aes256gcm_encrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                                     unsigned char *c, const unsigned char *m,
+                                     unsigned long long mlen)
+{
+    return implementation->encrypt_update(state_, c, m, mlen);
+}
+
+int
+crypto_aead_aes256gcm_encrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                                    unsigned char *mac)
+{
+    return implementation->encrypt_final(state_, mac);
+}
+
+int
+crypto_aead_aes256gcm_decrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                                     unsigned char *m, const unsigned char *c,
+                                     unsigned long long clen)
+{
+    return implementation->decrypt_update(state_, m, c, clen);
+}
+
+int
+crypto_aead_aes256gcm_decrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                                    const unsigned char *mac)
+{
+    return implementation->decrypt_final(state_, mac);
+}
+
+int
+crypto_aead_aes256gcm_encrypt_afternm(unsigned char *c, unsigned long long *clen_p,
+                                      const unsigned char *m, unsigned long long mlen,
+                                      const unsigned char *ad, unsigned long long adlen,
+                                      const unsigned char *nsec, const unsigned char *npub,
+                                      const crypto_aead_aes256gcm_state *ctx_)
+{
+    int ret = crypto_aead_aes256gcm_encrypt_detached_afternm(c, c + mlen, NULL, m, mlen, ad, adlen,
+                                                             nsec, npub, ctx_);
+    if (clen_p != NULL) {
+        *clen_p = mlen + crypto_aead_aes256gcm_ABYTES;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcm_decrypt_afternm(unsigned char *m, unsigned long long *mlen_p,
+                                      unsigned char *nsec, const unsigned char *c,
+                                      unsigned long long clen, const unsigned char *ad,
+                                      unsigned long long adlen, const unsigned char *npub,
+                                      const crypto_aead_aes256gcm_state *ctx_)
+{
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+
+    if (clen >= crypto_aead_aes256gcm_ABYTES) {
+        ret = crypto_aead_aes256gcm_decrypt_detached_afternm(
+            m, nsec, c, clen - crypto_aead_aes256gcm_ABYTES,
+            c + clen - crypto_aead_aes256gcm_ABYTES, ad, adlen, npub, ctx_);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_aes256gcm_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcm_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                       unsigned long long *maclen_p, const unsigned char *m,
+                                       unsigned long long mlen, const unsigned char *ad,
+                                       unsigned long long adlen, const unsigned char *nsec,
+                                       const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    int                                          ret;
+    SODIUM_STATS_START(stats_start)
+
+    if (_sodium_offload_aead_encrypt(SODIUM_OFFLOAD_AEAD_AES256GCM, c, mac, m, mlen, ad, adlen,
+                                     npub, k) == 0) {
+        if (maclen_p != NULL) {
+            *maclen_p = crypto_aead_aes256gcm_ABYTES;
+        }
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+        return 0;
+    }
+    crypto_aead_aes256gcm_beforenm(&ctx, k);
+
+    ret = crypto_aead_aes256gcm_encrypt_detached_afternm(
+        c, mac, maclen_p, m, mlen, ad, adlen, nsec, npub,
+        (const crypto_aead_aes256gcm_state *) &ctx);
+    sodium_memzero(&ctx, sizeof ctx);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return ret;
+}
+
+int
+crypto_aead_aes256gcm_encrypt(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
+                              unsigned long long mlen, const unsigned char *ad,
+                              unsigned long long adlen, const unsigned char *nsec,
+                              const unsigned char *npub, const unsigned char *k)
+{
+    int ret = crypto_aead_aes256gcm_encrypt_detached(c, c + mlen, NULL, m, mlen, ad, adlen, nsec,
+                                                     npub, k);
+    if (clen_p != NULL) {
+        *clen_p = mlen + crypto_aead_aes256gcm_ABYTES;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcm_decrypt_detached(unsigned char *m, unsigned char *nsec,
+                                       const unsigned char *c, unsigned long long clen,
+                                       const unsigned char *mac, const unsigned char *ad,
+                                       unsigned long long adlen, const unsigned char *npub,
+                                       const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    int                                          ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = _sodium_offload_aead_decrypt(SODIUM_OFFLOAD_AEAD_AES256GCM, m, c, clen, mac, ad, adlen,
+                                       npub, k);
+    if (ret != SODIUM_OFFLOAD_DECLINED) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+        return ret;
+    }
+    crypto_aead_aes256gcm_beforenm(&ctx, k);
+
+    ret = crypto_aead_aes256gcm_decrypt_detached_afternm(
+        m, nsec, c, clen, mac, ad, adlen, npub, (const crypto_aead_aes256gcm_state *) &ctx);
+    sodium_memzero(&ctx, sizeof ctx);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+
+    return ret;
+}
+
+int
+crypto_aead_aes256gcm_decrypt(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
+                              const unsigned char *c, unsigned long long clen,
+                              const unsigned char *ad, unsigned long long adlen,
+                              const unsigned char *npub, const unsigned char *k)
+{
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+
+    if (clen >= crypto_aead_aes256gcm_ABYTES) {
+        ret = crypto_aead_aes256gcm_decrypt_detached(m, nsec, c, clen - crypto_aead_aes256gcm_ABYTES,
+                                                     c + clen - crypto_aead_aes256gcm_ABYTES, ad,
+                                                     adlen, npub, k);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_aes256gcm_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcm_is_available(void)
+{
+    return 1;
+}
+
+int
+_crypto_aead_aes256gcm_pick_best_implementation(void)
+{
+    implementation = &crypto_aead_aes256gcm_soft_implementation;
+    _sodium_implementation_selected("aes", "soft");
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+    if (sodium_runtime_has_aesni() && sodium_runtime_has_pclmul() &&
+        _sodium_implementation_allowed("aes", "aesni")) {
+        implementation = &crypto_aead_aes256gcm_aesni_implementation;
+        _sodium_implementation_selected("aes", "aesni");
+    }
+#endif
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_armcrypto() &&
+        _sodium_implementation_allowed("aes", "armcrypto")) {
+        implementation = &crypto_aead_aes256gcm_armcrypto_implementation;
+        _sodium_implementation_selected("aes", "armcrypto");
+    }
+#endif
+    return 0;
+}
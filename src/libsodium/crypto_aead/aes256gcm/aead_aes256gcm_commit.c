@@ -0,0 +1,105 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aes256gcm.h"
+#include "crypto_generichash_blake2b.h"
+#include "crypto_verify_32.h"
+#include "private/common.h"
+#include "utils.h"
+
+/*
+ * AES-GCM is not key-committing, and AES being a permutation, keystream
+ * blocks don't make a collision-resistant commitment. The commitment is
+ * BLAKE2b keyed with the AES key, over the nonce: a single compression
+ * after the key block, independent of the message length.
+ */
+static void
+_commitment(unsigned char commitment[crypto_aead_aes256gcm_COMMITBYTES],
+            const unsigned char *npub, const unsigned char *k)
+{
+    static const char personal[] = "aes256gcmcommit";
+
+    COMPILER_ASSERT(sizeof personal == crypto_generichash_blake2b_PERSONALBYTES);
+    crypto_generichash_blake2b_salt_personal(commitment,
+                                             crypto_aead_aes256gcm_COMMITBYTES,
+                                             npub, crypto_aead_aes256gcm_NPUBBYTES,
+                                             k, crypto_aead_aes256gcm_KEYBYTES,
+                                             NULL,
+                                             (const unsigned char *) personal);
+}
+
+int
+crypto_aead_aes256gcm_encrypt_commit(unsigned char *c,
+                                     unsigned long long *clen_p,
+                                     const unsigned char *m,
+                                     unsigned long long mlen,
+                                     const unsigned char *ad,
+                                     unsigned long long adlen,
+                                     const unsigned char *nsec,
+                                     const unsigned char *npub,
+                                     const unsigned char *k)
+{
+    unsigned long long clen = 0ULL;
+    int                ret;
+
+    if (mlen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX -
+                   crypto_aead_aes256gcm_COMMITBYTES) {
+        sodium_misuse();
+    }
+    ret = crypto_aead_aes256gcm_encrypt_detached(c, c + mlen, NULL, m, mlen,
+                                                 ad, adlen, nsec, npub, k);
+    if (ret == 0) {
+        _commitment(c + mlen + crypto_aead_aes256gcm_ABYTES, npub, k);
+        clen = mlen + crypto_aead_aes256gcm_ABYTES +
+               crypto_aead_aes256gcm_COMMITBYTES;
+    }
+    if (clen_p != NULL) {
+        *clen_p = clen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcm_decrypt_commit(unsigned char *m,
+                                     unsigned long long *mlen_p,
+                                     unsigned char *nsec,
+                                     const unsigned char *c,
+                                     unsigned long long clen,
+                                     const unsigned char *ad,
+                                     unsigned long long adlen,
+                                     const unsigned char *npub,
+                                     const unsigned char *k)
+{
+    unsigned char      commitment[crypto_aead_aes256gcm_COMMITBYTES];
+    unsigned long long mlen = 0ULL;
+    int                ret = -1;
+
+    if (clen >= crypto_aead_aes256gcm_ABYTES +
+                    crypto_aead_aes256gcm_COMMITBYTES) {
+        mlen = clen - crypto_aead_aes256gcm_ABYTES -
+               crypto_aead_aes256gcm_COMMITBYTES;
+        _commitment(commitment, npub, k);
+        if (crypto_verify_32(commitment,
+                             c + mlen + crypto_aead_aes256gcm_ABYTES) == 0) {
+            ret = crypto_aead_aes256gcm_decrypt_detached(m, nsec, c, mlen,
+                                                         c + mlen, ad, adlen,
+                                                         npub, k);
+        }
+        sodium_memzero(commitment, sizeof commitment);
+    }
+    if (mlen_p != NULL) {
+        if (ret != 0) {
+            mlen = 0ULL;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+size_t
+crypto_aead_aes256gcm_commitbytes(void)
+{
+    return crypto_aead_aes256gcm_COMMITBYTES;
+}
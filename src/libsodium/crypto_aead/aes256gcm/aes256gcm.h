@@ -0,0 +1,61 @@
+#ifndef aes256gcm_H
+#define aes256gcm_H
+
+#include "crypto_aead_aes256gcm.h"
+
+typedef struct crypto_aead_aes256gcm_implementation {
+    int (*beforenm)(crypto_aead_aes256gcm_state *ctx_, const unsigned char *k);
+    int (*encrypt_detached_afternm)(unsigned char *c, unsigned char *mac,
+                                    unsigned long long *maclen_p, const unsigned char *m,
+                                    unsigned long long mlen, const unsigned char *ad,
+                                    unsigned long long adlen, const unsigned char *nsec,
+                                    const unsigned char *npub,
+                                    const crypto_aead_aes256gcm_state *ctx_);
+    int (*decrypt_detached_afternm)(unsigned char *m, unsigned char *nsec,
+                                    const unsigned char *c, unsigned long long clen,
+                                    const unsigned char *mac, const unsigned char *ad,
+                                    unsigned long long adlen, const unsigned char *npub,
+                                    const crypto_aead_aes256gcm_state *ctx_);
+    int (*compact_beforenm)(crypto_aead_aes256gcm_compact_key *ck,
+                            const unsigned char *k, size_t count);
+    int (*compact_expand)(crypto_aead_aes256gcm_state *ctx_,
+                          const crypto_aead_aes256gcm_compact_key *ck);
+    int (*encrypt_detached_compact)(unsigned char *c, unsigned char *mac,
+                                    unsigned long long *maclen_p, const unsigned char *m,
+                                    unsigned long long mlen, const unsigned char *ad,
+                                    unsigned long long adlen, const unsigned char *nsec,
+                                    const unsigned char *npub,
+                                    const crypto_aead_aes256gcm_compact_key *ck);
+    int (*decrypt_detached_compact)(unsigned char *m, unsigned char *nsec,
+                                    const unsigned char *c, unsigned long long clen,
+                                    const unsigned char *mac, const unsigned char *ad,
+                                    unsigned long long adlen, const unsigned char *npub,
+                                    const crypto_aead_aes256gcm_compact_key *ck);
+    int (*encrypt_detached_iov)(const crypto_aead_iovec *c, size_t c_count,
+                                unsigned char *mac, unsigned long long *maclen_p,
+                                const crypto_aead_iovec *m, size_t m_count,
+                                const crypto_aead_iovec *ad, size_t ad_count,
+                                const unsigned char *nsec,
+                                const unsigned char *npub, const unsigned char *k);
+    int (*decrypt_detached_iov)(const crypto_aead_iovec *m, size_t m_count,
+                                unsigned char *nsec,
+                                const crypto_aead_iovec *c, size_t c_count,
+                                const unsigned char *mac,
+                                const crypto_aead_iovec *ad, size_t ad_count,
+                                const unsigned char *npub, const unsigned char *k);
+    int (*init)(crypto_aead_aes256gcm_stream_state *state_, const unsigned char *npub,
+                const crypto_aead_aes256gcm_state *ctx_);
+    int (*update_ad)(crypto_aead_aes256gcm_stream_state *state_,
+                     const unsigned char *ad, unsigned long long adlen);
+    int (*encrypt_update)(crypto_aead_aes256gcm_stream_state *state_,
+                          unsigned char *c, const unsigned char *m,
+                          unsigned long long mlen);
+    int (*encrypt_final)(crypto_aead_aes256gcm_stream_state *state_, unsigned char *mac);
+    int (*decrypt_update)(crypto_aead_aes256gcm_stream_state *state_,
+                          unsigned char *m, const unsigned char *c,
+                          unsigned long long clen);
+    int (*decrypt_final)(crypto_aead_aes256gcm_stream_state *state_,
+                         const unsigned char *mac);
+} crypto_aead_aes256gcm_implementation;
+
+#endif
@@ -12,13 +12,18 @@
 
 #include "core.h"
 #include "crypto_aead_aes256gcm.h"
+#include "crypto_verify_16.h"
 #include "export.h"
+#include "private/aead_iov.h"
 #include "private/common.h"
 #include "private/sse2_64_32.h"
+#include "private/stats.h"
 #include "randombytes.h"
 #include "runtime.h"
 #include "utils.h"
 
+#include "../vaes/aead_aes256gcm_vaes.h"
+
 #if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
 
 #ifdef __GNUC__
@@ -30,6 +35,8 @@
 #include <tmmintrin.h>
 #include <wmmintrin.h>
 
+#include "aead_aes256gcm_aesni.h"
+
 #if defined(__INTEL_COMPILER) || defined(_bswap64)
 #elif defined(_MSC_VER)
 #define _bswap64(a) _byteswap_uint64(a)
@@ -47,8 +54,9 @@ _bswap64(const uint64_t x)
 #endif
 
 typedef struct aes256gcm_state {
-    __m128i       rkeys[16];
+    __m128i       rkeys[15];
     unsigned char H[16];
+    __m128i       Hv[16]; /* byte-reverted H^16 ... H^1, for the VAES code */
 } aes256gcm_state;
 
 static inline void
@@ -578,36 +586,244 @@ mulv(__m128i A, __m128i B)
         MAKE8(STOREx);                                                                          \
     } while (0)
 
-int
-crypto_aead_aes256gcm_beforenm(crypto_aead_aes256gcm_state *ctx_, const unsigned char *k)
+/*
+ * Deeper aggregation: the products of 16 blocks with H^16 ... H^1 are
+ * accumulated unreduced, and reduced only once.
+ */
+
+/* (lo, mid, hi) += H * X, Karatsuba-style, without reduction */
+static inline void
+mulacc(__m128i *lo, __m128i *mid, __m128i *hi, const __m128i H, const __m128i X)
+{
+    const __m128i Hm = _mm_xor_si128(_mm_shuffle_epi32(H, 0x4e), H);
+    const __m128i Xm = _mm_xor_si128(_mm_shuffle_epi32(X, 0x4e), X);
+
+    *lo  = _mm_xor_si128(*lo, _mm_clmulepi64_si128(H, X, 0x00));
+    *hi  = _mm_xor_si128(*hi, _mm_clmulepi64_si128(H, X, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(Hm, Xm, 0x00));
+}
+
+/* same reduction as ADDMULREDUCE8, applied to accumulated products */
+static inline __m128i
+reduce(__m128i lo, __m128i mid, __m128i hi)
+{
+    __m128i tmp0, tmp0B, tmp1B, tmp2, tmp2B, tmp3, tmp3B, tmp8, tmp9;
+
+    tmp0  = _mm_xor_si128(mid, lo);
+    tmp0  = _mm_xor_si128(tmp0, hi);
+    tmp0B = _mm_slli_si128(tmp0, 8);
+    tmp0  = _mm_srli_si128(tmp0, 8);
+    lo    = _mm_xor_si128(tmp0B, lo);
+    hi    = _mm_xor_si128(tmp0, hi);
+    tmp3  = lo;
+    tmp2B = hi;
+    tmp3B = _mm_srli_epi32(tmp3, 31);
+    tmp8  = _mm_srli_epi32(tmp2B, 31);
+    tmp3  = _mm_slli_epi32(tmp3, 1);
+    tmp2B = _mm_slli_epi32(tmp2B, 1);
+    tmp9  = _mm_srli_si128(tmp3B, 12);
+    tmp8  = _mm_slli_si128(tmp8, 4);
+    tmp3B = _mm_slli_si128(tmp3B, 4);
+    tmp3  = _mm_or_si128(tmp3, tmp3B);
+    tmp2B = _mm_or_si128(tmp2B, tmp8);
+    tmp2B = _mm_or_si128(tmp2B, tmp9);
+    tmp3B = _mm_slli_epi32(tmp3, 31);
+    tmp8  = _mm_slli_epi32(tmp3, 30);
+    tmp9  = _mm_slli_epi32(tmp3, 25);
+    tmp3B = _mm_xor_si128(tmp3B, tmp8);
+    tmp3B = _mm_xor_si128(tmp3B, tmp9);
+    tmp8  = _mm_srli_si128(tmp3B, 4);
+    tmp3B = _mm_slli_si128(tmp3B, 12);
+    tmp3  = _mm_xor_si128(tmp3, tmp3B);
+    tmp2  = _mm_srli_epi32(tmp3, 1);
+    tmp0B = _mm_srli_epi32(tmp3, 2);
+    tmp1B = _mm_srli_epi32(tmp3, 7);
+    tmp2  = _mm_xor_si128(tmp2, tmp0B);
+    tmp2  = _mm_xor_si128(tmp2, tmp1B);
+    tmp2  = _mm_xor_si128(tmp2, tmp8);
+    tmp3  = _mm_xor_si128(tmp3, tmp2);
+    tmp2B = _mm_xor_si128(tmp2B, tmp3);
+
+    return tmp2B;
+}
+
+#define REVTEMPx(a) temp##a = _mm_shuffle_epi8(temp##a, rev)
+#define REVINx(a) in##a = _mm_shuffle_epi8(in##a, rev)
+#define MULACCTEMPx(a) mulacc(lo, mid, hi, Hs[a], temp##a)
+#define MULACCINx(a) mulacc(lo, mid, hi, Hs[a], in##a)
+
+/*
+ * Encrypt or decrypt 8 blocks, and accumulate the products of the
+ * ciphertext blocks with Hs[0] ... Hs[7]. x0 is added to the first
+ * byte-reverted block.
+ */
+static inline void
+aesni_encrypt8_mulacc(unsigned char *out, uint32_t *n, const __m128i *rkeys,
+                      const unsigned char *in, const __m128i *Hs, __m128i x0,
+                      __m128i *lo, __m128i *mid, __m128i *hi)
+{
+    const __m128i pt  = _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    MAKE8(NVDECLx);
+    MAKE8(TEMPDECLx);
+
+    MAKE8(NVx);
+    MAKE8(TEMPx);
+    MAKE8(AESENCx1);
+    MAKE8(AESENCx2);
+    MAKE8(AESENCx3);
+    MAKE8(AESENCx4);
+    MAKE8(AESENCx5);
+    MAKE8(AESENCx6);
+    MAKE8(AESENCx7);
+    MAKE8(AESENCx8);
+    MAKE8(AESENCx9);
+    MAKE8(AESENCx10);
+    MAKE8(AESENCx11);
+    MAKE8(AESENCx12);
+    MAKE8(AESENCx13);
+    MAKE8(AESENCLASTx);
+    MAKE8(XORx);
+    MAKE8(STOREx);
+    MAKE8(REVTEMPx);
+    temp0 = _mm_xor_si128(temp0, x0);
+    MAKE8(MULACCTEMPx);
+}
+
+/*
+ * The ciphertext is known before the keystream, so the products of the
+ * ciphertext blocks are interleaved with the AES rounds, one per round,
+ * to keep both the AES and the carry-less multiplication units busy.
+ */
+static inline void
+aesni_decrypt8_mulacc(unsigned char *out, uint32_t *n, const __m128i *rkeys,
+                      const unsigned char *in, const __m128i *Hs, __m128i x0,
+                      __m128i *lo, __m128i *mid, __m128i *hi)
+{
+    const __m128i pt  = _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    MAKE8(LOADx);
+    MAKE8(NVDECLx);
+    MAKE8(TEMPDECLx);
+
+    MAKE8(NVx);
+    MAKE8(TEMPx);
+    MAKE8(AESENCx1);
+    MAKE8(REVINx);
+    in0 = _mm_xor_si128(in0, x0);
+    MULACCINx(0);
+    MAKE8(AESENCx2);
+    MULACCINx(1);
+    MAKE8(AESENCx3);
+    MULACCINx(2);
+    MAKE8(AESENCx4);
+    MULACCINx(3);
+    MAKE8(AESENCx5);
+    MULACCINx(4);
+    MAKE8(AESENCx6);
+    MULACCINx(5);
+    MAKE8(AESENCx7);
+    MULACCINx(6);
+    MAKE8(AESENCx8);
+    MULACCINx(7);
+    MAKE8(AESENCx9);
+    MAKE8(AESENCx10);
+    MAKE8(AESENCx11);
+    MAKE8(AESENCx12);
+    MAKE8(AESENCx13);
+    MAKE8(AESENCLASTx);
+    MAKE8(XORx);
+    MAKE8(STOREx);
+}
+
+/*
+ * Full encrypt or decrypt & checksum of 16 blocks, with a single
+ * reduction. Hv holds the byte-reverted H^16 ... H^1.
+ */
+static void
+aesni_crypt16_ghash(unsigned char *out, uint32_t *n, const __m128i *rkeys,
+                    const unsigned char *in, unsigned char *accum, const __m128i *Hv,
+                    int encrypt)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i accv = _mm_loadu_si128((const __m128i *) accum);
+    __m128i       lo = zero, mid = zero, hi = zero;
+
+    if (encrypt) {
+        aesni_encrypt8_mulacc(out, n, rkeys, in, Hv, accv, &lo, &mid, &hi);
+        aesni_encrypt8_mulacc(out + 128, n, rkeys, in + 128, Hv + 8, zero, &lo, &mid, &hi);
+    } else {
+        aesni_decrypt8_mulacc(out, n, rkeys, in, Hv, accv, &lo, &mid, &hi);
+        aesni_decrypt8_mulacc(out + 128, n, rkeys, in + 128, Hv + 8, zero, &lo, &mid, &hi);
+    }
+    _mm_storeu_si128((__m128i *) accum, reduce(lo, mid, hi));
+}
+
+/*
+ * Checksum the last, possibly partial, nb <= 8 blocks of a message with a
+ * single reduction. Hv holds the byte-reverted H^16 ... H^1.
+ */
+static void
+aesni_ghash_tail(unsigned char *accum, const unsigned char *in, unsigned long long inlen,
+                 const __m128i *Hv)
+{
+    const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i *Hs;
+    CRYPTO_ALIGN(16) unsigned char padded[8 * 16];
+    __m128i        lo, mid, hi, x;
+    unsigned int   nb = (unsigned int) ((inlen + 15U) / 16U);
+    unsigned int   j;
+
+    memset(padded, 0, sizeof padded);
+    memcpy(padded, in, (size_t) inlen);
+    Hs = Hv + 16 - nb;
+    lo = mid = hi = _mm_setzero_si128();
+    x = _mm_shuffle_epi8(_mm_load_si128((const __m128i *) (const void *) padded), rev);
+    mulacc(&lo, &mid, &hi, Hs[0], _mm_xor_si128(x, _mm_loadu_si128((const __m128i *) accum)));
+    for (j = 1; j < nb; j++) {
+        x = _mm_shuffle_epi8(
+            _mm_load_si128((const __m128i *) (const void *) (padded + j * 16)), rev);
+        mulacc(&lo, &mid, &hi, Hs[j], x);
+    }
+    _mm_storeu_si128((__m128i *) accum, reduce(lo, mid, hi));
+}
+
+static int
+aes256gcm_aesni_beforenm(crypto_aead_aes256gcm_state *ctx_, const unsigned char *k)
 {
     aes256gcm_state *ctx   = (aes256gcm_state *) (void *) ctx_;
     unsigned char   *H     = ctx->H;
     __m128i         *rkeys = ctx->rkeys;
     const __m128i    zero  = _mm_setzero_si128();
+    const __m128i    rev   = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    int              i;
 
     COMPILER_ASSERT((sizeof *ctx_) >= (sizeof *ctx));
     aesni_key256_expand(k, rkeys);
     aesni_encrypt1(H, zero, rkeys);
 
+    ctx->Hv[15] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) H), rev);
+    for (i = 14; i >= 0; i--) {
+        ctx->Hv[i] = mulv(ctx->Hv[i + 1], ctx->Hv[15]);
+    }
     return 0;
 }
 
-int
-crypto_aead_aes256gcm_encrypt_detached_afternm(unsigned char *c, unsigned char *mac,
-                                               unsigned long long *maclen_p, const unsigned char *m,
-                                               unsigned long long mlen, const unsigned char *ad,
-                                               unsigned long long adlen, const unsigned char *nsec,
-                                               const unsigned char *              npub,
-                                               const crypto_aead_aes256gcm_state *ctx_)
+static int
+aes256gcm_aesni_encrypt_detached_afternm(unsigned char *c, unsigned char *mac,
+                                         unsigned long long *maclen_p, const unsigned char *m,
+                                         unsigned long long mlen, const unsigned char *ad,
+                                         unsigned long long adlen, const unsigned char *nsec,
+                                         const unsigned char *              npub,
+                                         const crypto_aead_aes256gcm_state *ctx_)
 {
-    const __m128i          rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
     const aes256gcm_state *ctx = (const aes256gcm_state *) (const void *) ctx_;
     const __m128i *        rkeys = ctx->rkeys;
     __m128i                Hv, H2v, H3v, H4v, H5v, H6v, H7v, H8v, accv;
     unsigned long long     i, j;
     unsigned long long     adlen_rnd64 = adlen & ~63ULL;
     unsigned long long     mlen_rnd128 = mlen & ~127ULL;
+    unsigned long long     mlen_rnd256 = mlen & ~255ULL;
     CRYPTO_ALIGN(16) uint32_t      n2[4];
     CRYPTO_ALIGN(16) unsigned char H[16];
     CRYPTO_ALIGN(16) unsigned char T[16];
@@ -615,10 +831,21 @@ crypto_aead_aes256gcm_encrypt_detached_afternm(unsigned char *c, unsigned char *
     CRYPTO_ALIGN(16) unsigned char fb[16];
 
     (void) nsec;
-    memcpy(H, ctx->H, sizeof H);
     if (mlen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
+#if defined(HAVE_VAESINTRIN_H) && defined(HAVE_AVX2INTRIN_H)
+    if (sodium_runtime_has_vaes() && sodium_runtime_has_vpclmulqdq()) {
+        crypto_aead_aes256gcm_vaes_encrypt_detached(
+            c, mac, m, mlen, ad, adlen, npub,
+            (const unsigned char *) (const void *) rkeys,
+            (const unsigned char *) (const void *) ctx->Hv);
+        if (maclen_p != NULL) {
+            *maclen_p = 16;
+        }
+        return 0;
+    }
+#endif
     memcpy(&n2[0], npub, 3 * 4);
     n2[3] = 0x01000000;
     aesni_encrypt1(T, _mm_load_si128((const __m128i *) n2), rkeys);
@@ -629,16 +856,16 @@ crypto_aead_aes256gcm_encrypt_detached_afternm(unsigned char *c, unsigned char *
         x = _bswap64((uint64_t)(8 * mlen));
         memcpy(&fb[8], &x, sizeof x);
     }
-    /* we store H (and it's power) byte-reverted once and for all */
-    Hv = _mm_shuffle_epi8(_mm_load_si128((const __m128i *) H), rev);
+    /* H and its powers are stored byte-reverted in the precomputed state */
+    Hv  = ctx->Hv[15];
+    H2v = ctx->Hv[14];
+    H3v = ctx->Hv[13];
+    H4v = ctx->Hv[12];
+    H5v = ctx->Hv[11];
+    H6v = ctx->Hv[10];
+    H7v = ctx->Hv[9];
+    H8v = ctx->Hv[8];
     _mm_store_si128((__m128i *) H, Hv);
-    H2v = mulv(Hv, Hv);
-    H3v = mulv(H2v, Hv);
-    H4v = mulv(H3v, Hv);
-    H5v = mulv(H4v, Hv);
-    H6v = mulv(H5v, Hv);
-    H7v = mulv(H6v, Hv);
-    H8v = mulv(H7v, Hv);
 
     accv = _mm_setzero_si128();
     for (i = 0; i < adlen_rnd64; i += 64) {
@@ -660,13 +887,16 @@ crypto_aead_aes256gcm_encrypt_detached_afternm(unsigned char *c, unsigned char *
         addmulreduce(accum, ad + i, blocklen, H);
     }
 
-    /* this only does 8 full blocks, so no fancy bounds checking is necessary*/
+    /* this only does 16 or 8 full blocks, so no fancy bounds checking is necessary*/
 #define LOOPRND128                                                                               \
     do {                                                                                         \
         const int iter = 8;                                                                      \
         const int lb   = iter * 16;                                                              \
                                                                                                  \
-        for (i = 0; i < mlen_rnd128; i += lb) {                                                  \
+        for (i = 0; i < mlen_rnd256; i += 2 * lb) {                                              \
+            aesni_crypt16_ghash(c + i, n2, rkeys, m + i, accum, ctx->Hv, 1);                     \
+        }                                                                                        \
+        for (; i < mlen_rnd128; i += lb) {                                                       \
             ENCRYPT8FULL(c + i, n2, rkeys, m + i, accum, Hv, H2v, H3v, H4v, H5v, H6v, H7v, H8v); \
         }                                                                                        \
     } while (0)
@@ -715,29 +945,13 @@ crypto_aead_aes256gcm_encrypt_detached_afternm(unsigned char *c, unsigned char *
     return 0;
 }
 
-int
-crypto_aead_aes256gcm_encrypt_afternm(unsigned char *c, unsigned long long *clen_p,
-                                      const unsigned char *m, unsigned long long mlen,
-                                      const unsigned char *ad, unsigned long long adlen,
-                                      const unsigned char *nsec, const unsigned char *npub,
-                                      const crypto_aead_aes256gcm_state *ctx_)
+static int
+aes256gcm_aesni_decrypt_detached_afternm(unsigned char *m, unsigned char *nsec,
+                                         const unsigned char *c, unsigned long long clen,
+                                         const unsigned char *mac, const unsigned char *ad,
+                                         unsigned long long adlen, const unsigned char *npub,
+                                         const crypto_aead_aes256gcm_state *ctx_)
 {
-    int ret = crypto_aead_aes256gcm_encrypt_detached_afternm(c, c + mlen, NULL, m, mlen, ad, adlen,
-                                                             nsec, npub, ctx_);
-    if (clen_p != NULL) {
-        *clen_p = mlen + crypto_aead_aes256gcm_ABYTES;
-    }
-    return ret;
-}
-
-int
-crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *nsec,
-                                               const unsigned char *c, unsigned long long clen,
-                                               const unsigned char *mac, const unsigned char *ad,
-                                               unsigned long long adlen, const unsigned char *npub,
-                                               const crypto_aead_aes256gcm_state *ctx_)
-{
-    const __m128i          rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
     const aes256gcm_state *ctx = (const aes256gcm_state *) (const void *) ctx_;
     const __m128i *        rkeys = ctx->rkeys;
     __m128i                Hv, H2v, H3v, H4v, H5v, H6v, H7v, H8v, accv;
@@ -745,6 +959,7 @@ crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *
     unsigned long long     adlen_rnd64 = adlen & ~63ULL;
     unsigned long long     mlen;
     unsigned long long     mlen_rnd128;
+    unsigned long long     mlen_rnd256;
     CRYPTO_ALIGN(16) uint32_t      n2[4];
     CRYPTO_ALIGN(16) unsigned char H[16];
     CRYPTO_ALIGN(16) unsigned char T[16];
@@ -755,6 +970,14 @@ crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *
     if (clen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
+#if defined(HAVE_VAESINTRIN_H) && defined(HAVE_AVX2INTRIN_H)
+    if (sodium_runtime_has_vaes() && sodium_runtime_has_vpclmulqdq()) {
+        return crypto_aead_aes256gcm_vaes_decrypt_detached(
+            m, c, clen, mac, ad, adlen, npub,
+            (const unsigned char *) (const void *) rkeys,
+            (const unsigned char *) (const void *) ctx->Hv);
+    }
+#endif
     mlen = clen;
 
     memcpy(&n2[0], npub, 3 * 4);
@@ -769,16 +992,15 @@ crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *
         memcpy(&fb[8], &x, sizeof x);
     }
 
-    memcpy(H, ctx->H, sizeof H);
-    Hv = _mm_shuffle_epi8(_mm_load_si128((const __m128i *) H), rev);
+    Hv   = ctx->Hv[15];
+    H2v  = ctx->Hv[14];
+    H3v  = ctx->Hv[13];
+    H4v  = ctx->Hv[12];
+    H5v  = ctx->Hv[11];
+    H6v  = ctx->Hv[10];
+    H7v  = ctx->Hv[9];
+    H8v  = ctx->Hv[8];
     _mm_store_si128((__m128i *) H, Hv);
-    H2v  = mulv(Hv, Hv);
-    H3v  = mulv(H2v, Hv);
-    H4v  = mulv(H3v, Hv);
-    H5v  = mulv(H4v, Hv);
-    H6v  = mulv(H5v, Hv);
-    H7v  = mulv(H6v, Hv);
-    H8v  = mulv(H7v, Hv);
     accv = _mm_setzero_si128();
 
     for (i = 0; i < adlen_rnd64; i += 64) {
@@ -800,39 +1022,32 @@ crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *
     }
 
     mlen_rnd128 = mlen & ~127ULL;
+    mlen_rnd256 = mlen & ~255ULL;
 
 #define LOOPDRND128                                                                              \
     do {                                                                                         \
         const int iter = 8;                                                                      \
         const int lb   = iter * 16;                                                              \
-        for (i = 0; i < mlen_rnd128; i += lb) {                                                  \
+        for (i = 0; i < mlen_rnd256; i += 2 * lb) {                                              \
+            aesni_crypt16_ghash(m + i, n2, rkeys, c + i, accum, ctx->Hv, 0);                     \
+        }                                                                                        \
+        for (; i < mlen_rnd128; i += lb) {                                                       \
             DECRYPT8FULL(m + i, n2, rkeys, c + i, accum, Hv, H2v, H3v, H4v, H5v, H6v, H7v, H8v); \
         }                                                                                        \
     } while (0)
 
-#define LOOPDRMD128                                       \
-    do {                                                  \
-        const int iter = 8;                               \
-        const int lb   = iter * 16;                       \
-        for (i = mlen_rnd128; i < mlen; i += lb) {        \
-            CRYPTO_ALIGN(16) unsigned char outni[8 * 16]; \
-            unsigned long long             mj = lb;       \
-                                                          \
-            if ((i + mj) >= mlen) {                       \
-                mj = mlen - i;                            \
-            }                                             \
-            for (j = 0; j < mj; j += 16) {                \
-                unsigned long long bl = 16;               \
-                if (j + bl >= mj) {                       \
-                    bl = mj - j;                          \
-                }                                         \
-                addmulreduce(accum, c + i + j, bl, H);    \
-            }                                             \
-            aesni_encrypt8(outni, n2, rkeys);             \
-            for (j = 0; j < mj; j++) {                    \
-                m[i + j] = c[i + j] ^ outni[j];           \
-            }                                             \
-        }                                                 \
+#define LOOPDRMD128                                            \
+    do {                                                       \
+        CRYPTO_ALIGN(16) unsigned char outni[8 * 16];          \
+                                                               \
+        i = mlen_rnd128;                                       \
+        if (i < mlen) {                                        \
+            aesni_ghash_tail(accum, c + i, mlen - i, ctx->Hv); \
+            aesni_encrypt8(outni, n2, rkeys);                  \
+            for (j = 0; i + j < mlen; j++) {                   \
+                m[i + j] = c[i + j] ^ outni[j];                \
+            }                                                  \
+        }                                                      \
     } while (0)
 
     n2[3] = 0U;
@@ -859,249 +1074,678 @@ crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *
     return 0;
 }
 
-int
-crypto_aead_aes256gcm_decrypt_afternm(unsigned char *m, unsigned long long *mlen_p,
-                                      unsigned char *nsec, const unsigned char *c,
-                                      unsigned long long clen, const unsigned char *ad,
-                                      unsigned long long adlen, const unsigned char *npub,
-                                      const crypto_aead_aes256gcm_state *ctx_)
-{
-    unsigned long long mlen = 0ULL;
-    int                ret  = -1;
+typedef struct aes256gcm_compact_key {
+    __m128i rkeys[15];
+    __m128i Hv; /* byte-reverted H */
+} aes256gcm_compact_key;
 
-    if (clen >= crypto_aead_aes256gcm_ABYTES) {
-        ret = crypto_aead_aes256gcm_decrypt_detached_afternm(
-            m, nsec, c, clen - crypto_aead_aes256gcm_ABYTES,
-            c + clen - crypto_aead_aes256gcm_ABYTES, ad, adlen, npub, ctx_);
+/* Messages whose AD and ciphertext both fit in 4 blocks only use H^4 .. H^1 */
+#define COMPACT_SHORT_BYTES 64U
+
+/*
+ * Expands 4 keys at once. AESKEYGENASSIST has a low throughput, so that
+ * SubWord is computed with AESENCLAST instead: when the 4 columns are the
+ * same, ShiftRows does nothing, and AESENCLAST is SubBytes and a XOR with
+ * the round constant. The 4 independent chains then run in parallel.
+ */
+static void
+aesni_key256_expand4(const unsigned char *key, __m128i rkeys[4][15])
+{
+    const __m128i rot_mask = _mm_set_epi8(12, 15, 14, 13, 12, 15, 14, 13,
+                                          12, 15, 14, 13, 12, 15, 14, 13);
+    const __m128i dup_mask = _mm_set_epi8(15, 14, 13, 12, 15, 14, 13, 12,
+                                          15, 14, 13, 12, 15, 14, 13, 12);
+    __m128i       X0[4], X1[4], X2[4];
+    __m128i       rcon = _mm_set1_epi32(1);
+    int           i;
+    int           j;
+
+    for (j = 0; j < 4; j++) {
+        X0[j] = _mm_loadu_si128((const __m128i *) (const void *) &key[32 * j]);
+        X2[j] = _mm_loadu_si128((const __m128i *) (const void *) &key[32 * j + 16]);
+        rkeys[j][0] = X0[j];
+        rkeys[j][1] = X2[j];
     }
-    if (mlen_p != NULL) {
-        if (ret == 0) {
-            mlen = clen - crypto_aead_aes256gcm_ABYTES;
+    for (i = 2; i < 15; i += 2) {
+        for (j = 0; j < 4; j++) {
+            X1[j] = _mm_aesenclast_si128(_mm_shuffle_epi8(X2[j], rot_mask), rcon);
+            X0[j] = _mm_xor_si128(X0[j], _mm_slli_si128(X0[j], 4));
+            X0[j] = _mm_xor_si128(X0[j], _mm_slli_si128(X0[j], 8));
+            X0[j] = _mm_xor_si128(X0[j], X1[j]);
+            rkeys[j][i] = X0[j];
         }
-        *mlen_p = mlen;
+        if (i == 14) {
+            break;
+        }
+        for (j = 0; j < 4; j++) {
+            X1[j] = _mm_aesenclast_si128(_mm_shuffle_epi8(X0[j], dup_mask),
+                                         _mm_setzero_si128());
+            X2[j] = _mm_xor_si128(X2[j], _mm_slli_si128(X2[j], 4));
+            X2[j] = _mm_xor_si128(X2[j], _mm_slli_si128(X2[j], 8));
+            X2[j] = _mm_xor_si128(X2[j], X1[j]);
+            rkeys[j][i + 1] = X2[j];
+        }
+        rcon = _mm_slli_epi32(rcon, 1);
     }
-    return ret;
 }
 
-int
-crypto_aead_aes256gcm_encrypt_detached(unsigned char *c, unsigned char *mac,
-                                       unsigned long long *maclen_p, const unsigned char *m,
-                                       unsigned long long mlen, const unsigned char *ad,
-                                       unsigned long long adlen, const unsigned char *nsec,
-                                       const unsigned char *npub, const unsigned char *k)
+static int
+aes256gcm_aesni_compact_beforenm(crypto_aead_aes256gcm_compact_key *ck_,
+                                 const unsigned char *k, size_t count)
 {
-    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
-
-    crypto_aead_aes256gcm_beforenm(&ctx, k);
+    aes256gcm_compact_key *ck = (aes256gcm_compact_key *) (void *) ck_;
+    const __m128i          rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    CRYPTO_ALIGN(16) unsigned char keys[4 * crypto_aead_aes256gcm_KEYBYTES];
+    CRYPTO_ALIGN(16) unsigned char H[16];
+    __m128i                rkeys[4][15];
+    __m128i                t[4];
+    size_t                 i;
+    int                    j;
+    int                    r;
+
+    COMPILER_ASSERT(sizeof *ck_ == sizeof *ck);
+    for (i = 0U; count - i >= 4U; i += 4U) {
+        memcpy(keys, k + i * crypto_aead_aes256gcm_KEYBYTES, sizeof keys);
+        aesni_key256_expand4(keys, rkeys);
+        for (j = 0; j < 4; j++) {
+            t[j] = rkeys[j][0];
+        }
+        for (r = 1; r < 14; r++) {
+            for (j = 0; j < 4; j++) {
+                t[j] = _mm_aesenc_si128(t[j], rkeys[j][r]);
+            }
+        }
+        for (j = 0; j < 4; j++) {
+            t[j] = _mm_aesenclast_si128(t[j], rkeys[j][14]);
+            memcpy(ck[i + (size_t) j].rkeys, rkeys[j], sizeof rkeys[j]);
+            ck[i + (size_t) j].Hv = _mm_shuffle_epi8(t[j], rev);
+        }
+    }
+    for (; i < count; i++) {
+        aesni_key256_expand(k + i * crypto_aead_aes256gcm_KEYBYTES, ck[i].rkeys);
+        aesni_encrypt1(H, _mm_setzero_si128(), ck[i].rkeys);
+        ck[i].Hv = _mm_shuffle_epi8(_mm_load_si128((const __m128i *) (const void *) H), rev);
+    }
+    sodium_memzero(keys, sizeof keys);
+    sodium_memzero(rkeys, sizeof rkeys);
 
-    return crypto_aead_aes256gcm_encrypt_detached_afternm(
-        c, mac, maclen_p, m, mlen, ad, adlen, nsec, npub,
-        (const crypto_aead_aes256gcm_state *) &ctx);
+    return 0;
 }
 
-int
-crypto_aead_aes256gcm_encrypt(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
-                              unsigned long long mlen, const unsigned char *ad,
-                              unsigned long long adlen, const unsigned char *nsec,
-                              const unsigned char *npub, const unsigned char *k)
+/* fills ctx with the round keys and the top `powers` powers of H */
+static void
+aesni_state_from_compact(aes256gcm_state *ctx, const aes256gcm_compact_key *ck, int powers)
 {
-    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
-    int                                          ret;
+    const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    int           i;
 
-    crypto_aead_aes256gcm_beforenm(&ctx, k);
+    memcpy(ctx->rkeys, ck->rkeys, sizeof ctx->rkeys);
+    _mm_storeu_si128((__m128i *) (void *) ctx->H, _mm_shuffle_epi8(ck->Hv, rev));
+    ctx->Hv[15] = ck->Hv;
+    for (i = 14; i >= 16 - powers; i--) {
+        ctx->Hv[i] = mulv(ctx->Hv[i + 1], ctx->Hv[15]);
+    }
+    for (; i >= 0; i--) {
+        ctx->Hv[i] = _mm_setzero_si128();
+    }
+}
 
-    ret = crypto_aead_aes256gcm_encrypt_afternm(c, clen_p, m, mlen, ad, adlen, nsec, npub,
-                                                (const crypto_aead_aes256gcm_state *) &ctx);
-    sodium_memzero(&ctx, sizeof ctx);
+static int
+aes256gcm_aesni_compact_expand(crypto_aead_aes256gcm_state *ctx_,
+                               const crypto_aead_aes256gcm_compact_key *ck)
+{
+    aesni_state_from_compact((aes256gcm_state *) (void *) ctx_,
+                             (const aes256gcm_compact_key *) (const void *) ck, 16);
 
-    return ret;
+    return 0;
 }
 
-int
-crypto_aead_aes256gcm_decrypt_detached(unsigned char *m, unsigned char *nsec,
-                                       const unsigned char *c, unsigned long long clen,
-                                       const unsigned char *mac, const unsigned char *ad,
-                                       unsigned long long adlen, const unsigned char *npub,
-                                       const unsigned char *k)
+static int
+aes256gcm_aesni_encrypt_detached_compact(unsigned char *c, unsigned char *mac,
+                                         unsigned long long *maclen_p, const unsigned char *m,
+                                         unsigned long long mlen, const unsigned char *ad,
+                                         unsigned long long adlen, const unsigned char *nsec,
+                                         const unsigned char *npub,
+                                         const crypto_aead_aes256gcm_compact_key *ck)
 {
     CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    int                                          ret;
 
-    crypto_aead_aes256gcm_beforenm(&ctx, k);
+    aesni_state_from_compact((aes256gcm_state *) (void *) &ctx,
+                             (const aes256gcm_compact_key *) (const void *) ck,
+                             mlen <= COMPACT_SHORT_BYTES && adlen <= COMPACT_SHORT_BYTES ?
+                             4 : 16);
+    ret = aes256gcm_aesni_encrypt_detached_afternm(c, mac, maclen_p, m, mlen, ad, adlen,
+                                                   nsec, npub, &ctx);
+    sodium_memzero(&ctx, sizeof ctx);
 
-    return crypto_aead_aes256gcm_decrypt_detached_afternm(
-        m, nsec, c, clen, mac, ad, adlen, npub, (const crypto_aead_aes256gcm_state *) &ctx);
+    return ret;
 }
 
-int
-crypto_aead_aes256gcm_decrypt(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
-                              const unsigned char *c, unsigned long long clen,
-                              const unsigned char *ad, unsigned long long adlen,
-                              const unsigned char *npub, const unsigned char *k)
+static int
+aes256gcm_aesni_decrypt_detached_compact(unsigned char *m, unsigned char *nsec,
+                                         const unsigned char *c, unsigned long long clen,
+                                         const unsigned char *mac, const unsigned char *ad,
+                                         unsigned long long adlen, const unsigned char *npub,
+                                         const crypto_aead_aes256gcm_compact_key *ck)
 {
     CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
     int                                          ret;
 
-    crypto_aead_aes256gcm_beforenm(&ctx, k);
-
-    ret = crypto_aead_aes256gcm_decrypt_afternm(m, mlen_p, nsec, c, clen, ad, adlen, npub,
-                                                (const crypto_aead_aes256gcm_state *) &ctx);
+    aesni_state_from_compact((aes256gcm_state *) (void *) &ctx,
+                             (const aes256gcm_compact_key *) (const void *) ck,
+                             clen <= COMPACT_SHORT_BYTES && adlen <= COMPACT_SHORT_BYTES ?
+                             4 : 16);
+    ret = aes256gcm_aesni_decrypt_detached_afternm(m, nsec, c, clen, mac, ad, adlen, npub,
+                                                   &ctx);
     sodium_memzero(&ctx, sizeof ctx);
 
     return ret;
 }
 
-int
-crypto_aead_aes256gcm_is_available(void)
+/* GHASH a scattered buffer into accum */
+static void
+aesni_ghash_iov(unsigned char *accum, const unsigned char *H, const __m128i *Hs,
+                const crypto_aead_iovec *iov, size_t count, unsigned long long len)
 {
-    return sodium_runtime_has_pclmul() & sodium_runtime_has_aesni();
+    aead_iov_cursor                cur;
+    const unsigned char           *in;
+    __m128i                        accv;
+    size_t                         run;
+    size_t                         i;
+    CRYPTO_ALIGN(16) unsigned char block[16];
+
+    aead_iov_cursor_init(&cur, iov, count);
+    while (len > 0) {
+        if ((run = aead_iov_cursor_run(NULL, &cur, 64U)) > 0U) {
+            in   = aead_iov_cursor_ptr(&cur);
+            accv = _mm_loadu_si128((const __m128i *) accum);
+            for (i = 0; i < run; i += 64) {
+                __m128i X4_ = _mm_loadu_si128((const __m128i *) (in + i + 0));
+                __m128i X3_ = _mm_loadu_si128((const __m128i *) (in + i + 16));
+                __m128i X2_ = _mm_loadu_si128((const __m128i *) (in + i + 32));
+                __m128i X1_ = _mm_loadu_si128((const __m128i *) (in + i + 48));
+                ADDMULREDUCE4(Hs[0], Hs[1], Hs[2], Hs[3], X1_, X2_, X3_, X4_, accv);
+            }
+            _mm_storeu_si128((__m128i *) accum, accv);
+            aead_iov_cursor_advance(&cur, run);
+        } else if ((run = aead_iov_cursor_run(NULL, &cur, 16U)) > 0U) {
+            in = aead_iov_cursor_ptr(&cur);
+            for (i = 0; i < run; i += 16) {
+                addmulreduce(accum, in + i, 16, H);
+            }
+            aead_iov_cursor_advance(&cur, run);
+        } else {
+            run = len < 16 ? (size_t) len : 16U;
+            aead_iov_cursor_gather(&cur, block, run);
+            addmulreduce(accum, block, (unsigned int) run, H);
+        }
+        len -= run;
+    }
 }
 
-#else
-
-#ifndef ENOSYS
-#define ENOSYS ENXIO
-#endif
-
-int
-crypto_aead_aes256gcm_encrypt_detached(unsigned char *c, unsigned char *mac,
-                                       unsigned long long *maclen_p, const unsigned char *m,
-                                       unsigned long long mlen, const unsigned char *ad,
-                                       unsigned long long adlen, const unsigned char *nsec,
-                                       const unsigned char *npub, const unsigned char *k)
+/*
+ * CTR-encrypt or decrypt a scattered buffer, and GHASH the ciphertext.
+ * Runs of 16 or 8 blocks that are contiguous in both the input and the output
+ * use the aggregated code paths; other blocks are processed one by one.
+ */
+static void
+aesni_ctr_ghash_iov(unsigned char *accum, const unsigned char *H, const __m128i *Hs,
+                    const __m128i *Hv, const __m128i *rkeys, uint32_t *n2,
+                    const crypto_aead_iovec *out_iov, size_t out_count,
+                    const crypto_aead_iovec *in_iov, size_t in_count,
+                    unsigned long long len, int encrypt)
 {
-    errno = ENOSYS;
-    return -1;
+    const __m128i                  pt = _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    aead_iov_cursor                out;
+    aead_iov_cursor                in;
+    unsigned char                 *out_p;
+    const unsigned char           *in_p;
+    size_t                         run;
+    size_t                         i;
+    CRYPTO_ALIGN(16) unsigned char src[16];
+    CRYPTO_ALIGN(16) unsigned char dst[16];
+    CRYPTO_ALIGN(16) unsigned char ks[16];
+
+    aead_iov_cursor_init(&out, out_iov, out_count);
+    aead_iov_cursor_init(&in, in_iov, in_count);
+    while (len > 0) {
+        if ((run = aead_iov_cursor_run(&out, &in, 128U)) > 0U) {
+            out_p = aead_iov_cursor_ptr(&out);
+            in_p  = aead_iov_cursor_ptr(&in);
+            for (i = 0; i + 256 <= run; i += 256) {
+                aesni_crypt16_ghash(out_p + i, n2, rkeys, in_p + i, accum, Hv, encrypt);
+            }
+            for (; i < run; i += 128) {
+                if (encrypt) {
+                    ENCRYPT8FULL(out_p + i, n2, rkeys, in_p + i, accum,
+                                 Hs[0], Hs[1], Hs[2], Hs[3], Hs[4], Hs[5], Hs[6], Hs[7]);
+                } else {
+                    DECRYPT8FULL(out_p + i, n2, rkeys, in_p + i, accum,
+                                 Hs[0], Hs[1], Hs[2], Hs[3], Hs[4], Hs[5], Hs[6], Hs[7]);
+                }
+            }
+            aead_iov_cursor_advance(&out, run);
+            aead_iov_cursor_advance(&in, run);
+        } else {
+            run = len < 16 ? (size_t) len : 16U;
+            aead_iov_cursor_gather(&in, src, run);
+            aesni_encrypt1(ks, _mm_shuffle_epi8(_mm_load_si128((const __m128i *) n2), pt), rkeys);
+            n2[3]++;
+            if (!encrypt) {
+                addmulreduce(accum, src, (unsigned int) run, H);
+            }
+            for (i = 0; i < run; i++) {
+                dst[i] = src[i] ^ ks[i];
+            }
+            if (encrypt) {
+                addmulreduce(accum, dst, (unsigned int) run, H);
+            }
+            aead_iov_cursor_scatter(&out, dst, run);
+        }
+        len -= run;
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+    sodium_memzero(ks, sizeof ks);
 }
 
-int
-crypto_aead_aes256gcm_encrypt(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
-                              unsigned long long mlen, const unsigned char *ad,
-                              unsigned long long adlen, const unsigned char *nsec,
-                              const unsigned char *npub, const unsigned char *k)
+/*
+ * Compute the tag over ad and the ciphertext, encrypting or decrypting the
+ * message on the way. With out_iov == NULL, in_iov is only authenticated.
+ */
+static void
+aesni_gcm_iov(unsigned char *tag, const aes256gcm_state *ctx,
+              const crypto_aead_iovec *out_iov, size_t out_count,
+              const crypto_aead_iovec *in_iov, size_t in_count, unsigned long long mlen,
+              const crypto_aead_iovec *ad_iov, size_t ad_count, unsigned long long adlen,
+              const unsigned char *npub, int encrypt)
 {
-    errno = ENOSYS;
-    return -1;
+    const __m128i                 *rkeys = ctx->rkeys;
+    __m128i                        Hs[8];
+    unsigned long long             i;
+    CRYPTO_ALIGN(16) uint32_t      n2[4];
+    CRYPTO_ALIGN(16) unsigned char H[16];
+    CRYPTO_ALIGN(16) unsigned char T[16];
+    CRYPTO_ALIGN(16) unsigned char accum[16];
+    CRYPTO_ALIGN(16) unsigned char fb[16];
+
+    memcpy(&n2[0], npub, 3 * 4);
+    n2[3] = 0x01000000;
+    aesni_encrypt1(T, _mm_load_si128((const __m128i *) n2), rkeys);
+    {
+        uint64_t x;
+        x = _bswap64((uint64_t)(8 * adlen));
+        memcpy(&fb[0], &x, sizeof x);
+        x = _bswap64((uint64_t)(8 * mlen));
+        memcpy(&fb[8], &x, sizeof x);
+    }
+    for (i = 0; i < 8; i++) {
+        Hs[i] = ctx->Hv[15 - i];
+    }
+    _mm_store_si128((__m128i *) H, Hs[0]);
+    memset(accum, 0, sizeof accum);
+    aesni_ghash_iov(accum, H, Hs, ad_iov, ad_count, adlen);
+
+    if (out_iov == NULL) {
+        aesni_ghash_iov(accum, H, Hs, in_iov, in_count, mlen);
+    } else {
+        n2[3] = 0U;
+        COUNTER_INC2(n2);
+        aesni_ctr_ghash_iov(accum, H, Hs, ctx->Hv, rkeys, n2, out_iov, out_count,
+                            in_iov, in_count, mlen, encrypt);
+    }
+    addmulreduce(accum, fb, 16, H);
+    for (i = 0; i < 16; ++i) {
+        tag[i] = T[i] ^ accum[15 - i];
+    }
+    sodium_memzero(T, sizeof T);
+    sodium_memzero(accum, sizeof accum);
 }
 
-int
-crypto_aead_aes256gcm_decrypt_detached(unsigned char *m, unsigned char *nsec,
-                                       const unsigned char *c, unsigned long long clen,
-                                       const unsigned char *mac, const unsigned char *ad,
-                                       unsigned long long adlen, const unsigned char *npub,
-                                       const unsigned char *k)
+static int
+aes256gcm_aesni_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                                     unsigned char *mac, unsigned long long *maclen_p,
+                                     const crypto_aead_iovec *m, size_t m_count,
+                                     const crypto_aead_iovec *ad, size_t ad_count,
+                                     const unsigned char *nsec,
+                                     const unsigned char *npub, const unsigned char *k)
 {
-    errno = ENOSYS;
-    return -1;
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    unsigned long long                           adlen;
+    unsigned long long                           mlen;
+    unsigned long long                           clen;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&mlen, m, m_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 || clen != mlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    aes256gcm_aesni_beforenm(&ctx, k);
+    aesni_gcm_iov(mac, (const aes256gcm_state *) (const void *) &ctx,
+                  c, c_count, m, m_count, mlen, ad, ad_count, adlen, npub, 1);
+    sodium_memzero(&ctx, sizeof ctx);
+    if (maclen_p != NULL) {
+        *maclen_p = 16;
+    }
+    return 0;
 }
 
-int
-crypto_aead_aes256gcm_decrypt(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
-                              const unsigned char *c, unsigned long long clen,
-                              const unsigned char *ad, unsigned long long adlen,
-                              const unsigned char *npub, const unsigned char *k)
+static int
+aes256gcm_aesni_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                                     unsigned char *nsec,
+                                     const crypto_aead_iovec *c, size_t c_count,
+                                     const unsigned char *mac,
+                                     const crypto_aead_iovec *ad, size_t ad_count,
+                                     const unsigned char *npub, const unsigned char *k)
 {
-    errno = ENOSYS;
-    return -1;
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    CRYPTO_ALIGN(16) unsigned char               computed_mac[16];
+    unsigned long long                           adlen;
+    unsigned long long                           mlen;
+    unsigned long long                           clen;
+    int                                          ret;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 ||
+        (m != NULL && (aead_iov_total(&mlen, m, m_count) != 0 ||
+                       mlen != clen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (clen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    aes256gcm_aesni_beforenm(&ctx, k);
+    aesni_gcm_iov(computed_mac, (const aes256gcm_state *) (const void *) &ctx,
+                  m, m_count, c, c_count, clen, ad, ad_count, adlen, npub, 0);
+    sodium_memzero(&ctx, sizeof ctx);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        aead_iov_memzero(m, m_count);
+        return -1;
+    }
+    return 0;
 }
 
-int
-crypto_aead_aes256gcm_beforenm(crypto_aead_aes256gcm_state *ctx_, const unsigned char *k)
+typedef struct aes256gcm_stream_state {
+    aes256gcm_state    ctx;
+    uint32_t           n2[4];
+    unsigned char      T[16];
+    unsigned char      accum[16];
+    unsigned char      ks[16];  /* keystream for the pending block */
+    unsigned char      buf[16]; /* pending additional data or ciphertext */
+    unsigned long long adlen;
+    unsigned long long mlen;
+    size_t             pos;
+    int                ad_done;
+} aes256gcm_stream_state;
+
+/* GHASH the pending partial block, zero-padded */
+static void
+aesni_stream_flush(aes256gcm_stream_state *const st)
 {
-    errno = ENOSYS;
-    return -1;
+    const unsigned char *H = (const unsigned char *) (const void *) &st->ctx.Hv[15];
+
+    if (st->pos > 0U) {
+        addmulreduce(st->accum, st->buf, (unsigned int) st->pos, H);
+        st->pos = 0U;
+    }
 }
 
-int
-crypto_aead_aes256gcm_encrypt_detached_afternm(unsigned char *c, unsigned char *mac,
-                                               unsigned long long *maclen_p, const unsigned char *m,
-                                               unsigned long long mlen, const unsigned char *ad,
-                                               unsigned long long adlen, const unsigned char *nsec,
-                                               const unsigned char *              npub,
-                                               const crypto_aead_aes256gcm_state *ctx_)
+/* CTR-encrypt or decrypt full blocks, and GHASH the ciphertext */
+static void
+aesni_stream_blocks(aes256gcm_stream_state *const st, unsigned char *dst,
+                    const unsigned char *src, unsigned long long len, int encrypt)
 {
-    errno = ENOSYS;
-    return -1;
+    const __m128i                  pt = _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    const __m128i                 *rkeys = st->ctx.rkeys;
+    const unsigned char           *H = (const unsigned char *) (const void *) &st->ctx.Hv[15];
+    __m128i                        Hs[8];
+    unsigned long long             i;
+    size_t                         j;
+    CRYPTO_ALIGN(16) unsigned char ks[16];
+
+    for (j = 0; j < 8; j++) {
+        Hs[j] = st->ctx.Hv[15 - j];
+    }
+    for (i = 0; i + 256 <= len; i += 256) {
+        aesni_crypt16_ghash(dst + i, st->n2, rkeys, src + i, st->accum, st->ctx.Hv, encrypt);
+    }
+    for (; i + 128 <= len; i += 128) {
+        if (encrypt) {
+            ENCRYPT8FULL(dst + i, st->n2, rkeys, src + i, st->accum,
+                         Hs[0], Hs[1], Hs[2], Hs[3], Hs[4], Hs[5], Hs[6], Hs[7]);
+        } else {
+            DECRYPT8FULL(dst + i, st->n2, rkeys, src + i, st->accum,
+                         Hs[0], Hs[1], Hs[2], Hs[3], Hs[4], Hs[5], Hs[6], Hs[7]);
+        }
+    }
+    for (; i + 16 <= len; i += 16) {
+        aesni_encrypt1(ks, _mm_shuffle_epi8(_mm_load_si128((const __m128i *) st->n2), pt), rkeys);
+        st->n2[3]++;
+        if (!encrypt) {
+            addmulreduce(st->accum, src + i, 16, H);
+        }
+        for (j = 0; j < 16; j++) {
+            dst[i + j] = src[i + j] ^ ks[j];
+        }
+        if (encrypt) {
+            addmulreduce(st->accum, dst + i, 16, H);
+        }
+    }
+    sodium_memzero(ks, sizeof ks);
 }
 
-int
-crypto_aead_aes256gcm_encrypt_afternm(unsigned char *c, unsigned long long *clen_p,
-                                      const unsigned char *m, unsigned long long mlen,
-                                      const unsigned char *ad, unsigned long long adlen,
-                                      const unsigned char *nsec, const unsigned char *npub,
-                                      const crypto_aead_aes256gcm_state *ctx_)
+/*
+ * Encrypt or decrypt up to the next block boundary, buffering the ciphertext
+ * until the block is complete. Returns the number of bytes processed.
+ */
+static size_t
+aesni_stream_partial(aes256gcm_stream_state *const st, unsigned char *out,
+                     const unsigned char *in, unsigned long long len, int encrypt)
 {
-    errno = ENOSYS;
-    return -1;
+    const __m128i  pt = _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    unsigned char  t;
+    size_t         i;
+
+    if (st->pos == 0U) {
+        aesni_encrypt1(st->ks, _mm_shuffle_epi8(_mm_load_si128((const __m128i *) st->n2), pt),
+                       st->ctx.rkeys);
+        st->n2[3]++;
+    }
+    for (i = 0U; i < len && st->pos < 16U; i++) {
+        t                = in[i];
+        out[i]           = t ^ st->ks[st->pos];
+        st->buf[st->pos] = encrypt ? out[i] : t;
+        st->pos++;
+    }
+    if (st->pos == 16U) {
+        aesni_stream_flush(st);
+    }
+    return i;
 }
 
-int
-crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m, unsigned char *nsec,
-                                               const unsigned char *c, unsigned long long clen,
-                                               const unsigned char *mac, const unsigned char *ad,
-                                               unsigned long long adlen, const unsigned char *npub,
-                                               const crypto_aead_aes256gcm_state *ctx_)
+static void
+aesni_stream_update(aes256gcm_stream_state *const st, unsigned char *out,
+                    const unsigned char *in, unsigned long long len, int encrypt)
 {
-    errno = ENOSYS;
-    return -1;
+    unsigned long long i = 0ULL;
+    unsigned long long full;
+
+    if (len > crypto_aead_aes256gcm_MESSAGEBYTES_MAX - st->mlen) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    if (st->ad_done == 0) {
+        aesni_stream_flush(st);
+        st->ad_done = 1;
+    }
+    st->mlen += len;
+    if (st->pos > 0U) {
+        i = aesni_stream_partial(st, out, in, len, encrypt);
+    }
+    full = (len - i) & ~15ULL;
+    aesni_stream_blocks(st, out + i, in + i, full, encrypt);
+    i += full;
+    if (i < len) {
+        aesni_stream_partial(st, out + i, in + i, len - i, encrypt);
+    }
 }
 
-int
-crypto_aead_aes256gcm_decrypt_afternm(unsigned char *m, unsigned long long *mlen_p,
-                                      unsigned char *nsec, const unsigned char *c,
-                                      unsigned long long clen, const unsigned char *ad,
-                                      unsigned long long adlen, const unsigned char *npub,
-                                      const crypto_aead_aes256gcm_state *ctx_)
+static void
+aesni_stream_final(aes256gcm_stream_state *const st, unsigned char *mac)
 {
-    errno = ENOSYS;
-    return -1;
+    const unsigned char           *H = (const unsigned char *) (const void *) &st->ctx.Hv[15];
+    CRYPTO_ALIGN(16) unsigned char fb[16];
+    int                            i;
+
+    aesni_stream_flush(st);
+    STORE64_BE(fb, (uint64_t) (8 * st->adlen));
+    STORE64_BE(fb + 8, (uint64_t) (8 * st->mlen));
+    addmulreduce(st->accum, fb, 16, H);
+    for (i = 0; i < 16; ++i) {
+        mac[i] = st->T[i] ^ st->accum[15 - i];
+    }
+    sodium_memzero(st, sizeof *st);
 }
 
-int
-crypto_aead_aes256gcm_is_available(void)
+static int
+aes256gcm_aesni_init(crypto_aead_aes256gcm_stream_state *state_,
+                     const unsigned char *npub,
+                     const crypto_aead_aes256gcm_state *ctx_)
 {
-    return 0;
-}
+    aes256gcm_stream_state *st = (aes256gcm_stream_state *) (void *) state_;
 
-#endif
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    memset(st, 0, sizeof *st);
+    memcpy(&st->ctx, ctx_, sizeof st->ctx);
+    memcpy(&st->n2[0], npub, 3 * 4);
+    st->n2[3] = 0x01000000;
+    aesni_encrypt1(st->T, _mm_load_si128((const __m128i *) st->n2), st->ctx.rkeys);
+    st->n2[3] = 0U;
+    COUNTER_INC2(st->n2);
 
-size_t
-crypto_aead_aes256gcm_keybytes(void)
-{
-    return crypto_aead_aes256gcm_KEYBYTES;
+    return 0;
 }
 
-size_t
-crypto_aead_aes256gcm_nsecbytes(void)
+static int
+aes256gcm_aesni_update_ad(crypto_aead_aes256gcm_stream_state *state_,
+                          const unsigned char *ad, unsigned long long adlen)
 {
-    return crypto_aead_aes256gcm_NSECBYTES;
+    aes256gcm_stream_state *st = (aes256gcm_stream_state *) (void *) state_;
+    const unsigned char    *H = (const unsigned char *) (const void *) &st->ctx.Hv[15];
+    unsigned long long      i = 0ULL;
+    size_t                  n;
+    __m128i                 accv;
+
+    if (st->ad_done != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    st->adlen += adlen;
+    if (st->pos > 0U) {
+        n = 16U - st->pos;
+        if (n > adlen) {
+            n = (size_t) adlen;
+        }
+        memcpy(st->buf + st->pos, ad, n);
+        st->pos += n;
+        i = n;
+        if (st->pos == 16U) {
+            aesni_stream_flush(st);
+        }
+    }
+    if (i + 64 <= adlen) {
+        accv = _mm_loadu_si128((const __m128i *) st->accum);
+        for (; i + 64 <= adlen; i += 64) {
+            __m128i X4_ = _mm_loadu_si128((const __m128i *) (ad + i + 0));
+            __m128i X3_ = _mm_loadu_si128((const __m128i *) (ad + i + 16));
+            __m128i X2_ = _mm_loadu_si128((const __m128i *) (ad + i + 32));
+            __m128i X1_ = _mm_loadu_si128((const __m128i *) (ad + i + 48));
+            ADDMULREDUCE4(st->ctx.Hv[15], st->ctx.Hv[14], st->ctx.Hv[13], st->ctx.Hv[12],
+                          X1_, X2_, X3_, X4_, accv);
+        }
+        _mm_storeu_si128((__m128i *) st->accum, accv);
+    }
+    for (; i + 16 <= adlen; i += 16) {
+        addmulreduce(st->accum, ad + i, 16, H);
+    }
+    if (i < adlen) {
+        st->pos = (size_t) (adlen - i);
+        memcpy(st->buf, ad + i, st->pos);
+    }
+    return 0;
 }
 
-size_t
-crypto_aead_aes256gcm_npubbytes(void)
+static int
+aes256gcm_aesni_encrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                               unsigned char *c, const unsigned char *m,
+                               unsigned long long mlen)
 {
-    return crypto_aead_aes256gcm_NPUBBYTES;
-}
+    aesni_stream_update((aes256gcm_stream_state *) (void *) state_, c, m, mlen, 1);
 
-size_t
-crypto_aead_aes256gcm_abytes(void)
-{
-    return crypto_aead_aes256gcm_ABYTES;
+    return 0;
 }
 
-size_t
-crypto_aead_aes256gcm_statebytes(void)
+static int
+aes256gcm_aesni_encrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                              unsigned char *mac)
 {
-    return (sizeof(crypto_aead_aes256gcm_state) + (size_t) 15U) & ~(size_t) 15U;
+    aesni_stream_final((aes256gcm_stream_state *) (void *) state_, mac);
+
+    return 0;
 }
 
-size_t
-crypto_aead_aes256gcm_messagebytes_max(void)
+static int
+aes256gcm_aesni_decrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                               unsigned char *m, const unsigned char *c,
+                               unsigned long long clen)
 {
-    return crypto_aead_aes256gcm_MESSAGEBYTES_MAX;
+    aesni_stream_update((aes256gcm_stream_state *) (void *) state_, m, c, clen, 0);
+
+    return 0;
 }
 
-void
-crypto_aead_aes256gcm_keygen(unsigned char k[crypto_aead_aes256gcm_KEYBYTES])
+static int
+aes256gcm_aesni_decrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                              const unsigned char *mac)
 {
-    randombytes_buf(k, crypto_aead_aes256gcm_KEYBYTES);
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    int                            ret;
+
+    aesni_stream_final((aes256gcm_stream_state *) (void *) state_, computed_mac);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+
+    return ret;
 }
+
+struct crypto_aead_aes256gcm_implementation crypto_aead_aes256gcm_aesni_implementation = {
+    SODIUM_C99(.beforenm =) aes256gcm_aesni_beforenm,
+    SODIUM_C99(.encrypt_detached_afternm =) aes256gcm_aesni_encrypt_detached_afternm,
+    SODIUM_C99(.decrypt_detached_afternm =) aes256gcm_aesni_decrypt_detached_afternm,
+    SODIUM_C99(.compact_beforenm =) aes256gcm_aesni_compact_beforenm,
+    SODIUM_C99(.compact_expand =) aes256gcm_aesni_compact_expand,
+    SODIUM_C99(.encrypt_detached_compact =) aes256gcm_aesni_encrypt_detached_compact,
+    SODIUM_C99(.decrypt_detached_compact =) aes256gcm_aesni_decrypt_detached_compact,
+    SODIUM_C99(.encrypt_detached_iov =) aes256gcm_aesni_encrypt_detached_iov,
+    SODIUM_C99(.decrypt_detached_iov =) aes256gcm_aesni_decrypt_detached_iov,
+    SODIUM_C99(.init =) aes256gcm_aesni_init,
+    SODIUM_C99(.update_ad =) aes256gcm_aesni_update_ad,
+    SODIUM_C99(.encrypt_update =) aes256gcm_aesni_encrypt_update,
+    SODIUM_C99(.encrypt_final =) aes256gcm_aesni_encrypt_final,
+    SODIUM_C99(.decrypt_update =) aes256gcm_aesni_decrypt_update,
+    SODIUM_C99(.decrypt_final =) aes256gcm_aesni_decrypt_final
+};
+
+#endif
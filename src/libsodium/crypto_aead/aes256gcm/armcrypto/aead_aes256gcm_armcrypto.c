@@ -0,0 +1,913 @@
+/*
+ * AES256-GCM, using the ARMv8 Crypto Extensions.
+ * AES is computed with AESE/AESMC, 8 blocks at a time, and GHASH with PMULL,
+ * aggregated over 8 blocks with a single reduction.
+ * Blocks are byte-reverted before being multiplied, as in the AES-NI code.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aes256gcm.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "private/aead_iov.h"
+#include "private/common.h"
+#include "private/stats.h"
+#include "randombytes.h"
+#include "runtime.h"
+#include "utils.h"
+
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <arm_neon.h>
+
+#include "aead_aes256gcm_armcrypto.h"
+
+# define ROUNDS    14
+# define PARBLOCKS 8
+
+typedef struct aes256gcm_state {
+    uint8x16_t rkeys[ROUNDS + 1];
+    uint64x2_t Hv[PARBLOCKS]; /* byte-reverted H^8 ... H^1 */
+} aes256gcm_state;
+
+# define MAKE8(X) \
+    X(0);         \
+    X(1);         \
+    X(2);         \
+    X(3);         \
+    X(4);         \
+    X(5);         \
+    X(6);         \
+    X(7)
+
+static inline uint32_t
+aes_subword(const uint32_t w)
+{
+    uint8x16_t v;
+
+    /* ShiftRows is a no-op when all the columns are identical */
+    v = vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(w)), vmovq_n_u8(0));
+
+    return vgetq_lane_u32(vreinterpretq_u32_u8(v), 0);
+}
+
+static void
+aes256_key_expand(uint8x16_t *const rkeys, const unsigned char *key)
+{
+    uint32_t w[4 * (ROUNDS + 1)];
+    uint32_t rcon = 0x01;
+    uint32_t t;
+    size_t   i;
+
+    for (i = 0; i < 8; i++) {
+        w[i] = LOAD32_LE(key + 4 * i);
+    }
+    for (i = 8; i < 4 * (ROUNDS + 1); i++) {
+        t = w[i - 1];
+        if ((i & 7) == 0) {
+            t = ROTR32(aes_subword(t), 8) ^ rcon;
+            rcon <<= 1;
+        } else if ((i & 7) == 4) {
+            t = aes_subword(t);
+        }
+        w[i] = w[i - 8] ^ t;
+    }
+    for (i = 0; i < ROUNDS + 1; i++) {
+        rkeys[i] = vld1q_u8((const uint8_t *) (const void *) &w[4 * i]);
+    }
+    sodium_memzero(w, sizeof w);
+}
+
+static inline uint8x16_t
+aes_encrypt1(uint8x16_t b, const uint8x16_t *const rkeys)
+{
+    int i;
+
+    for (i = 0; i < ROUNDS - 1; i++) {
+        b = vaesmcq_u8(vaeseq_u8(b, rkeys[i]));
+    }
+    return veorq_u8(vaeseq_u8(b, rkeys[ROUNDS - 1]), rkeys[ROUNDS]);
+}
+
+/*
+ * The counter is kept with bytes reverted within each 32-bit word, so that
+ * the last word can be incremented with a regular addition.
+ */
+static inline uint8x16_t
+ctr_next(uint32x4_t *const cv)
+{
+    const uint8x16_t b = vrev32q_u8(vreinterpretq_u8_u32(*cv));
+
+    *cv = vaddq_u32(*cv, vsetq_lane_u32(1, vdupq_n_u32(0), 3));
+
+    return b;
+}
+
+# define CTRx(a)   b##a = ctr_next(cv)
+# define ROUNDx(a) b##a = vaesmcq_u8(vaeseq_u8(b##a, rk))
+# define LASTx(a)  b[a] = veorq_u8(vaeseq_u8(b##a, rkeys[ROUNDS - 1]), rkeys[ROUNDS])
+
+static inline void
+aes_ctr8(uint8x16_t b[PARBLOCKS], uint32x4_t *const cv, const uint8x16_t *const rkeys)
+{
+    uint8x16_t b0, b1, b2, b3, b4, b5, b6, b7;
+    uint8x16_t rk;
+    int        i;
+
+    MAKE8(CTRx);
+    for (i = 0; i < ROUNDS - 1; i++) {
+        rk = rkeys[i];
+        MAKE8(ROUNDx);
+    }
+    MAKE8(LASTx);
+}
+
+/* all GF(2^128) functions work on byte-reverted blocks */
+
+static inline uint64x2_t
+rev128(const uint8x16_t x)
+{
+    const uint8x16_t r = vrev64q_u8(x);
+
+    return vreinterpretq_u64_u8(vextq_u8(r, r, 8));
+}
+
+static inline uint64x2_t
+clmul_lo(const uint64x2_t a, const uint64x2_t b)
+{
+    return vreinterpretq_u64_p128(vmull_p64((poly64_t) vgetq_lane_u64(a, 0),
+                                            (poly64_t) vgetq_lane_u64(b, 0)));
+}
+
+static inline uint64x2_t
+clmul_hi(const uint64x2_t a, const uint64x2_t b)
+{
+    return vreinterpretq_u64_p128(vmull_high_p64(vreinterpretq_p64_u64(a),
+                                                 vreinterpretq_p64_u64(b)));
+}
+
+/* reduction of the 256-bit product (hi:lo), after a shift by one bit */
+static inline uint64x2_t
+gf_reduce(uint64x2_t lo, uint64x2_t hi)
+{
+    const uint64x2_t zero = vdupq_n_u64(0);
+    const uint64x2_t poly = vdupq_n_u64(0xc200000000000000ULL);
+    const uint64x2_t clo  = vshrq_n_u64(lo, 63);
+    const uint64x2_t chi  = vshrq_n_u64(hi, 63);
+    uint64x2_t       t;
+
+    hi = vorrq_u64(vshlq_n_u64(hi, 1), vextq_u64(clo, chi, 1));
+    lo = vorrq_u64(vshlq_n_u64(lo, 1), vextq_u64(zero, clo, 1));
+
+    t  = clmul_lo(lo, poly);
+    lo = veorq_u64(vextq_u64(lo, lo, 1), t);
+    t  = clmul_lo(lo, poly);
+    lo = veorq_u64(vextq_u64(lo, lo, 1), t);
+
+    return veorq_u64(hi, lo);
+}
+
+# define MUL_ACC(H, X)                                          \
+    do {                                                        \
+        const uint64x2_t Xs_ = vextq_u64((X), (X), 1);          \
+        lo  = veorq_u64(lo, clmul_lo((H), (X)));                \
+        hi  = veorq_u64(hi, clmul_hi((H), (X)));                \
+        mid = veorq_u64(mid, clmul_lo((H), Xs_));               \
+        mid = veorq_u64(mid, clmul_hi((H), Xs_));               \
+    } while (0)
+
+/* pure multiplication, for pre-computing powers of H */
+static inline uint64x2_t
+gf_mul(const uint64x2_t a, const uint64x2_t b)
+{
+    const uint64x2_t zero = vdupq_n_u64(0);
+    uint64x2_t       lo = zero, hi = zero, mid = zero;
+
+    MUL_ACC(a, b);
+    lo = veorq_u64(lo, vextq_u64(zero, mid, 1));
+    hi = veorq_u64(hi, vextq_u64(mid, zero, 1));
+
+    return gf_reduce(lo, hi);
+}
+
+/*
+ * acc = (acc + X_0) * H^n + X_1 * H^(n-1) + ... + X_(n-1) * H,
+ * with 1 <= n <= PARBLOCKS, and X in memory order.
+ */
+static inline uint64x2_t
+ghash_blocks(const uint64x2_t acc, const uint8x16_t *x, const size_t n,
+             const uint64x2_t *const Hv)
+{
+    const uint64x2_t  zero = vdupq_n_u64(0);
+    const uint64x2_t *Hp   = Hv + PARBLOCKS - n;
+    uint64x2_t        lo = zero, hi = zero, mid = zero;
+    uint64x2_t        X;
+    size_t            j;
+
+    X = veorq_u64(rev128(x[0]), acc);
+    MUL_ACC(Hp[0], X);
+    for (j = 1; j < n; j++) {
+        X = rev128(x[j]);
+        MUL_ACC(Hp[j], X);
+    }
+    lo = veorq_u64(lo, vextq_u64(zero, mid, 1));
+    hi = veorq_u64(hi, vextq_u64(mid, zero, 1));
+
+    return gf_reduce(lo, hi);
+}
+
+/* GHASH an arbitrary long buffer, zero-padding the last block */
+static uint64x2_t
+ghash(uint64x2_t acc, const unsigned char *in, unsigned long long len,
+      const uint64x2_t *const Hv)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    uint8x16_t                     x[PARBLOCKS];
+    size_t                         k;
+
+    for (; len >= PARBLOCKS * 16; len -= PARBLOCKS * 16, in += PARBLOCKS * 16) {
+        for (k = 0; k < PARBLOCKS; k++) {
+            x[k] = vld1q_u8(in + 16 * k);
+        }
+        acc = ghash_blocks(acc, x, PARBLOCKS, Hv);
+    }
+    for (; len >= 16; len -= 16, in += 16) {
+        x[0] = vld1q_u8(in);
+        acc  = ghash_blocks(acc, x, 1, Hv);
+    }
+    if (len > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, in, (size_t) len);
+        x[0] = vld1q_u8(pad);
+        acc  = ghash_blocks(acc, x, 1, Hv);
+    }
+    return acc;
+}
+
+/*
+ * CTR-encrypt len bytes, and absorb the ciphertext into acc.
+ * GHASH of a chunk is computed along with the encryption of the next one.
+ */
+static uint64x2_t
+ctr_ghash_encrypt(uint64x2_t acc, unsigned char *out, const unsigned char *in,
+                  unsigned long long len, uint32x4_t *const cv,
+                  const aes256gcm_state *const st)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    uint8x16_t                     b[PARBLOCKS];
+    uint8x16_t                     prev[PARBLOCKS];
+    size_t                         k;
+    int                            pending = 0;
+
+    for (; len >= PARBLOCKS * 16; len -= PARBLOCKS * 16, in += PARBLOCKS * 16,
+                                   out += PARBLOCKS * 16) {
+        aes_ctr8(b, cv, st->rkeys);
+        if (pending) {
+            acc = ghash_blocks(acc, prev, PARBLOCKS, st->Hv);
+        }
+        for (k = 0; k < PARBLOCKS; k++) {
+            prev[k] = veorq_u8(b[k], vld1q_u8(in + 16 * k));
+            vst1q_u8(out + 16 * k, prev[k]);
+        }
+        pending = 1;
+    }
+    if (pending) {
+        acc = ghash_blocks(acc, prev, PARBLOCKS, st->Hv);
+    }
+    for (; len >= 16; len -= 16, in += 16, out += 16) {
+        b[0] = veorq_u8(aes_encrypt1(ctr_next(cv), st->rkeys), vld1q_u8(in));
+        vst1q_u8(out, b[0]);
+        acc = ghash_blocks(acc, b, 1, st->Hv);
+    }
+    if (len > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, in, (size_t) len);
+        b[0] = veorq_u8(aes_encrypt1(ctr_next(cv), st->rkeys), vld1q_u8(pad));
+        vst1q_u8(pad, b[0]);
+        memcpy(out, pad, (size_t) len);
+        memset(pad + len, 0, sizeof pad - (size_t) len);
+        b[0] = vld1q_u8(pad);
+        acc  = ghash_blocks(acc, b, 1, st->Hv);
+        sodium_memzero(pad, sizeof pad);
+    }
+    return acc;
+}
+
+/* absorb len bytes of ciphertext into acc, and CTR-decrypt them */
+static uint64x2_t
+ctr_ghash_decrypt(uint64x2_t acc, unsigned char *out, const unsigned char *in,
+                  unsigned long long len, uint32x4_t *const cv,
+                  const aes256gcm_state *const st)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    uint8x16_t                     b[PARBLOCKS];
+    uint8x16_t                     x[PARBLOCKS];
+    size_t                         k;
+
+    for (; len >= PARBLOCKS * 16; len -= PARBLOCKS * 16, in += PARBLOCKS * 16,
+                                   out += PARBLOCKS * 16) {
+        for (k = 0; k < PARBLOCKS; k++) {
+            x[k] = vld1q_u8(in + 16 * k);
+        }
+        aes_ctr8(b, cv, st->rkeys);
+        acc = ghash_blocks(acc, x, PARBLOCKS, st->Hv);
+        for (k = 0; k < PARBLOCKS; k++) {
+            vst1q_u8(out + 16 * k, veorq_u8(b[k], x[k]));
+        }
+    }
+    for (; len >= 16; len -= 16, in += 16, out += 16) {
+        x[0] = vld1q_u8(in);
+        acc  = ghash_blocks(acc, x, 1, st->Hv);
+        vst1q_u8(out, veorq_u8(aes_encrypt1(ctr_next(cv), st->rkeys), x[0]));
+    }
+    if (len > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, in, (size_t) len);
+        x[0] = vld1q_u8(pad);
+        acc  = ghash_blocks(acc, x, 1, st->Hv);
+        vst1q_u8(pad, veorq_u8(aes_encrypt1(ctr_next(cv), st->rkeys), x[0]));
+        memcpy(out, pad, (size_t) len);
+        sodium_memzero(pad, sizeof pad);
+    }
+    return acc;
+}
+
+/* returns E(J0), and sets the counter to J0 + 1 */
+static uint8x16_t
+gcm_setup(uint32x4_t *const cv, const unsigned char *npub, const aes256gcm_state *const st)
+{
+    CRYPTO_ALIGN(16) unsigned char j0[16];
+
+    memcpy(j0, npub, crypto_aead_aes256gcm_NPUBBYTES);
+    STORE32_BE(j0 + crypto_aead_aes256gcm_NPUBBYTES, 1U);
+    *cv = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(j0)));
+
+    return aes_encrypt1(ctr_next(cv), st->rkeys);
+}
+
+static void
+gcm_tag(unsigned char *tag, uint64x2_t acc, const uint8x16_t T, const unsigned long long adlen,
+        const unsigned long long mlen, const aes256gcm_state *const st)
+{
+    CRYPTO_ALIGN(16) unsigned char fb[16];
+    uint8x16_t                     x;
+
+    STORE64_BE(fb, (uint64_t) adlen * 8U);
+    STORE64_BE(fb + 8, (uint64_t) mlen * 8U);
+    x   = vld1q_u8(fb);
+    acc = ghash_blocks(acc, &x, 1, st->Hv);
+    vst1q_u8(tag, veorq_u8(T, vreinterpretq_u8_u64(rev128(vreinterpretq_u8_u64(acc)))));
+}
+
+static int
+aes256gcm_armcrypto_beforenm(crypto_aead_aes256gcm_state *ctx_, const unsigned char *k)
+{
+    aes256gcm_state *ctx = (aes256gcm_state *) (void *) ctx_;
+    int              i;
+
+    COMPILER_ASSERT((sizeof *ctx_) >= (sizeof *ctx));
+    aes256_key_expand(ctx->rkeys, k);
+    ctx->Hv[PARBLOCKS - 1] = rev128(aes_encrypt1(vmovq_n_u8(0), ctx->rkeys));
+    for (i = PARBLOCKS - 2; i >= 0; i--) {
+        ctx->Hv[i] = gf_mul(ctx->Hv[i + 1], ctx->Hv[PARBLOCKS - 1]);
+    }
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_encrypt_detached_afternm(unsigned char *c, unsigned char *mac,
+                                             unsigned long long *maclen_p, const unsigned char *m,
+                                             unsigned long long mlen, const unsigned char *ad,
+                                             unsigned long long adlen, const unsigned char *nsec,
+                                             const unsigned char *              npub,
+                                             const crypto_aead_aes256gcm_state *ctx_)
+{
+    const aes256gcm_state *ctx = (const aes256gcm_state *) (const void *) ctx_;
+    uint64x2_t             acc;
+    uint32x4_t             cv;
+    uint8x16_t             T;
+
+    (void) nsec;
+    if (mlen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    T   = gcm_setup(&cv, npub, ctx);
+    acc = ghash(vdupq_n_u64(0), ad, adlen, ctx->Hv);
+    acc = ctr_ghash_encrypt(acc, c, m, mlen, &cv, ctx);
+    gcm_tag(mac, acc, T, adlen, mlen, ctx);
+
+    if (maclen_p != NULL) {
+        *maclen_p = crypto_aead_aes256gcm_ABYTES;
+    }
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_decrypt_detached_afternm(unsigned char *m, unsigned char *nsec,
+                                             const unsigned char *c, unsigned long long clen,
+                                             const unsigned char *mac, const unsigned char *ad,
+                                             unsigned long long adlen, const unsigned char *npub,
+                                             const crypto_aead_aes256gcm_state *ctx_)
+{
+    const aes256gcm_state         *ctx = (const aes256gcm_state *) (const void *) ctx_;
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    uint64x2_t                     acc;
+    uint32x4_t                     cv;
+    uint8x16_t                     T;
+    int                            ret;
+
+    (void) nsec;
+    if (clen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    T   = gcm_setup(&cv, npub, ctx);
+    acc = ghash(vdupq_n_u64(0), ad, adlen, ctx->Hv);
+    if (m == NULL) {
+        acc = ghash(acc, c, clen, ctx->Hv);
+    } else {
+        acc = ctr_ghash_decrypt(acc, m, c, clen, &cv, ctx);
+    }
+    gcm_tag(computed_mac, acc, T, adlen, clen, ctx);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        memset(m, 0, clen);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct aes256gcm_compact_key {
+    uint8x16_t rkeys[ROUNDS + 1];
+    uint64x2_t Hv; /* byte-reverted H */
+} aes256gcm_compact_key;
+
+/* Messages whose AD and ciphertext are shorter than 8 blocks only use H */
+# define COMPACT_SHORT_BYTES 64U
+
+static int
+aes256gcm_armcrypto_compact_beforenm(crypto_aead_aes256gcm_compact_key *ck_,
+                                     const unsigned char *k, size_t count)
+{
+    aes256gcm_compact_key *ck = (aes256gcm_compact_key *) (void *) ck_;
+    size_t                 i;
+
+    COMPILER_ASSERT(sizeof *ck_ == sizeof *ck);
+    for (i = 0U; i < count; i++) {
+        aes256_key_expand(ck[i].rkeys, k + i * crypto_aead_aes256gcm_KEYBYTES);
+        ck[i].Hv = rev128(aes_encrypt1(vmovq_n_u8(0), ck[i].rkeys));
+    }
+    return 0;
+}
+
+/* fills ctx with the round keys and the top `powers` powers of H */
+static void
+state_from_compact(aes256gcm_state *ctx, const aes256gcm_compact_key *ck, int powers)
+{
+    int i;
+
+    memcpy(ctx->rkeys, ck->rkeys, sizeof ctx->rkeys);
+    ctx->Hv[PARBLOCKS - 1] = ck->Hv;
+    for (i = PARBLOCKS - 2; i >= PARBLOCKS - powers; i--) {
+        ctx->Hv[i] = gf_mul(ctx->Hv[i + 1], ctx->Hv[PARBLOCKS - 1]);
+    }
+    for (; i >= 0; i--) {
+        ctx->Hv[i] = vdupq_n_u64(0);
+    }
+}
+
+static int
+aes256gcm_armcrypto_compact_expand(crypto_aead_aes256gcm_state *ctx_,
+                                   const crypto_aead_aes256gcm_compact_key *ck)
+{
+    state_from_compact((aes256gcm_state *) (void *) ctx_,
+                       (const aes256gcm_compact_key *) (const void *) ck, PARBLOCKS);
+
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_encrypt_detached_compact(unsigned char *c, unsigned char *mac,
+                                             unsigned long long *maclen_p, const unsigned char *m,
+                                             unsigned long long mlen, const unsigned char *ad,
+                                             unsigned long long adlen, const unsigned char *nsec,
+                                             const unsigned char *npub,
+                                             const crypto_aead_aes256gcm_compact_key *ck)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    int                                          ret;
+
+    state_from_compact((aes256gcm_state *) (void *) &ctx,
+                       (const aes256gcm_compact_key *) (const void *) ck,
+                       mlen <= COMPACT_SHORT_BYTES && adlen <= COMPACT_SHORT_BYTES ?
+                       1 : PARBLOCKS);
+    ret = aes256gcm_armcrypto_encrypt_detached_afternm(c, mac, maclen_p, m, mlen, ad, adlen,
+                                                       nsec, npub, &ctx);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return ret;
+}
+
+static int
+aes256gcm_armcrypto_decrypt_detached_compact(unsigned char *m, unsigned char *nsec,
+                                             const unsigned char *c, unsigned long long clen,
+                                             const unsigned char *mac, const unsigned char *ad,
+                                             unsigned long long adlen, const unsigned char *npub,
+                                             const crypto_aead_aes256gcm_compact_key *ck)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    int                                          ret;
+
+    state_from_compact((aes256gcm_state *) (void *) &ctx,
+                       (const aes256gcm_compact_key *) (const void *) ck,
+                       clen <= COMPACT_SHORT_BYTES && adlen <= COMPACT_SHORT_BYTES ?
+                       1 : PARBLOCKS);
+    ret = aes256gcm_armcrypto_decrypt_detached_afternm(m, nsec, c, clen, mac, ad, adlen, npub,
+                                                       &ctx);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return ret;
+}
+
+/* GHASH a scattered buffer */
+static uint64x2_t
+ghash_iov(uint64x2_t acc, const crypto_aead_iovec *iov, size_t count,
+          unsigned long long len, const uint64x2_t *const Hv)
+{
+    aead_iov_cursor                cur;
+    size_t                         run;
+    CRYPTO_ALIGN(16) unsigned char block[16];
+
+    aead_iov_cursor_init(&cur, iov, count);
+    while (len > 0) {
+        if ((run = aead_iov_cursor_run(NULL, &cur, 16U)) > 0U) {
+            acc = ghash(acc, aead_iov_cursor_ptr(&cur), run, Hv);
+            aead_iov_cursor_advance(&cur, run);
+        } else {
+            run = len < 16 ? (size_t) len : 16U;
+            aead_iov_cursor_gather(&cur, block, run);
+            acc = ghash(acc, block, run, Hv);
+        }
+        len -= run;
+    }
+    return acc;
+}
+
+/*
+ * CTR-encrypt or decrypt a scattered buffer, and GHASH the ciphertext.
+ * Runs of blocks that are contiguous in both the input and the output are
+ * processed in place; other blocks go through a temporary buffer.
+ */
+static uint64x2_t
+ctr_ghash_iov(uint64x2_t acc, const crypto_aead_iovec *out_iov, size_t out_count,
+              const crypto_aead_iovec *in_iov, size_t in_count, unsigned long long len,
+              uint32x4_t *const cv, const aes256gcm_state *const st, int encrypt)
+{
+    aead_iov_cursor                out;
+    aead_iov_cursor                in;
+    size_t                         run;
+    CRYPTO_ALIGN(16) unsigned char block[16];
+
+    aead_iov_cursor_init(&out, out_iov, out_count);
+    aead_iov_cursor_init(&in, in_iov, in_count);
+    while (len > 0) {
+        if ((run = aead_iov_cursor_run(&out, &in, 16U)) > 0U) {
+            if (encrypt) {
+                acc = ctr_ghash_encrypt(acc, aead_iov_cursor_ptr(&out),
+                                        aead_iov_cursor_ptr(&in), run, cv, st);
+            } else {
+                acc = ctr_ghash_decrypt(acc, aead_iov_cursor_ptr(&out),
+                                        aead_iov_cursor_ptr(&in), run, cv, st);
+            }
+            aead_iov_cursor_advance(&out, run);
+            aead_iov_cursor_advance(&in, run);
+        } else {
+            run = len < 16 ? (size_t) len : 16U;
+            aead_iov_cursor_gather(&in, block, run);
+            if (encrypt) {
+                acc = ctr_ghash_encrypt(acc, block, block, run, cv, st);
+            } else {
+                acc = ctr_ghash_decrypt(acc, block, block, run, cv, st);
+            }
+            aead_iov_cursor_scatter(&out, block, run);
+        }
+        len -= run;
+    }
+    sodium_memzero(block, sizeof block);
+
+    return acc;
+}
+
+/*
+ * Compute the tag over ad and the ciphertext, encrypting or decrypting the
+ * message on the way. With out_iov == NULL, in_iov is only authenticated.
+ */
+static void
+gcm_iov(unsigned char *tag, const aes256gcm_state *ctx,
+        const crypto_aead_iovec *out_iov, size_t out_count,
+        const crypto_aead_iovec *in_iov, size_t in_count, unsigned long long mlen,
+        const crypto_aead_iovec *ad_iov, size_t ad_count, unsigned long long adlen,
+        const unsigned char *npub, int encrypt)
+{
+    uint64x2_t acc;
+    uint32x4_t cv;
+    uint8x16_t T;
+
+    T   = gcm_setup(&cv, npub, ctx);
+    acc = ghash_iov(vdupq_n_u64(0), ad_iov, ad_count, adlen, ctx->Hv);
+    if (out_iov == NULL) {
+        acc = ghash_iov(acc, in_iov, in_count, mlen, ctx->Hv);
+    } else {
+        acc = ctr_ghash_iov(acc, out_iov, out_count, in_iov, in_count, mlen, &cv, ctx, encrypt);
+    }
+    gcm_tag(tag, acc, T, adlen, mlen, ctx);
+}
+
+static int
+aes256gcm_armcrypto_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                                         unsigned char *mac, unsigned long long *maclen_p,
+                                         const crypto_aead_iovec *m, size_t m_count,
+                                         const crypto_aead_iovec *ad, size_t ad_count,
+                                         const unsigned char *nsec,
+                                         const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    unsigned long long                           adlen;
+    unsigned long long                           mlen;
+    unsigned long long                           clen;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&mlen, m, m_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 || clen != mlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    aes256gcm_armcrypto_beforenm(&ctx, k);
+    gcm_iov(mac, (const aes256gcm_state *) (const void *) &ctx,
+            c, c_count, m, m_count, mlen, ad, ad_count, adlen, npub, 1);
+    sodium_memzero(&ctx, sizeof ctx);
+    if (maclen_p != NULL) {
+        *maclen_p = crypto_aead_aes256gcm_ABYTES;
+    }
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                                         unsigned char *nsec,
+                                         const crypto_aead_iovec *c, size_t c_count,
+                                         const unsigned char *mac,
+                                         const crypto_aead_iovec *ad, size_t ad_count,
+                                         const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    CRYPTO_ALIGN(16) unsigned char               computed_mac[16];
+    unsigned long long                           adlen;
+    unsigned long long                           mlen;
+    unsigned long long                           clen;
+    int                                          ret;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 ||
+        (m != NULL && (aead_iov_total(&mlen, m, m_count) != 0 ||
+                       mlen != clen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (clen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    aes256gcm_armcrypto_beforenm(&ctx, k);
+    gcm_iov(computed_mac, (const aes256gcm_state *) (const void *) &ctx,
+            m, m_count, c, c_count, clen, ad, ad_count, adlen, npub, 0);
+    sodium_memzero(&ctx, sizeof ctx);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        aead_iov_memzero(m, m_count);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct aes256gcm_stream_state {
+    aes256gcm_state    ctx;
+    uint64x2_t         acc;
+    uint32x4_t         cv;
+    uint8x16_t         T;
+    unsigned char      ks[16];  /* keystream for the pending block */
+    unsigned char      buf[16]; /* pending additional data or ciphertext */
+    unsigned long long adlen;
+    unsigned long long mlen;
+    size_t             pos;
+    int                ad_done;
+} aes256gcm_stream_state;
+
+/* GHASH the pending partial block, zero-padded */
+static void
+stream_flush(aes256gcm_stream_state *const st)
+{
+    if (st->pos > 0U) {
+        st->acc = ghash(st->acc, st->buf, st->pos, st->ctx.Hv);
+        st->pos = 0U;
+    }
+}
+
+/*
+ * Encrypt or decrypt up to the next block boundary, buffering the ciphertext
+ * until the block is complete. Returns the number of bytes processed.
+ */
+static size_t
+stream_partial(aes256gcm_stream_state *const st, unsigned char *out,
+               const unsigned char *in, unsigned long long len, int encrypt)
+{
+    unsigned char t;
+    size_t        i;
+
+    if (st->pos == 0U) {
+        vst1q_u8(st->ks, aes_encrypt1(ctr_next(&st->cv), st->ctx.rkeys));
+    }
+    for (i = 0U; i < len && st->pos < 16U; i++) {
+        t                = in[i];
+        out[i]           = t ^ st->ks[st->pos];
+        st->buf[st->pos] = encrypt ? out[i] : t;
+        st->pos++;
+    }
+    if (st->pos == 16U) {
+        stream_flush(st);
+    }
+    return i;
+}
+
+static void
+stream_update(aes256gcm_stream_state *const st, unsigned char *out,
+              const unsigned char *in, unsigned long long len, int encrypt)
+{
+    unsigned long long i = 0ULL;
+    unsigned long long full;
+
+    if (len > crypto_aead_aes256gcm_MESSAGEBYTES_MAX - st->mlen) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    if (st->ad_done == 0) {
+        stream_flush(st);
+        st->ad_done = 1;
+    }
+    st->mlen += len;
+    if (st->pos > 0U) {
+        i = stream_partial(st, out, in, len, encrypt);
+    }
+    full = (len - i) & ~15ULL;
+    if (full > 0U) {
+        if (encrypt) {
+            st->acc = ctr_ghash_encrypt(st->acc, out + i, in + i, full, &st->cv, &st->ctx);
+        } else {
+            st->acc = ctr_ghash_decrypt(st->acc, out + i, in + i, full, &st->cv, &st->ctx);
+        }
+        i += full;
+    }
+    if (i < len) {
+        stream_partial(st, out + i, in + i, len - i, encrypt);
+    }
+}
+
+static void
+stream_final(aes256gcm_stream_state *const st, unsigned char *mac)
+{
+    stream_flush(st);
+    gcm_tag(mac, st->acc, st->T, st->adlen, st->mlen, &st->ctx);
+    sodium_memzero(st, sizeof *st);
+}
+
+static int
+aes256gcm_armcrypto_init(crypto_aead_aes256gcm_stream_state *state_,
+                         const unsigned char *npub,
+                         const crypto_aead_aes256gcm_state *ctx_)
+{
+    aes256gcm_stream_state *st = (aes256gcm_stream_state *) (void *) state_;
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    memset(st, 0, sizeof *st);
+    memcpy(&st->ctx, ctx_, sizeof st->ctx);
+    st->acc = vdupq_n_u64(0);
+    st->T   = gcm_setup(&st->cv, npub, &st->ctx);
+
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_update_ad(crypto_aead_aes256gcm_stream_state *state_,
+                              const unsigned char *ad, unsigned long long adlen)
+{
+    aes256gcm_stream_state *st = (aes256gcm_stream_state *) (void *) state_;
+    unsigned long long      i = 0ULL;
+    unsigned long long      full;
+    size_t                  n;
+
+    if (st->ad_done != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    st->adlen += adlen;
+    if (st->pos > 0U) {
+        n = 16U - st->pos;
+        if (n > adlen) {
+            n = (size_t) adlen;
+        }
+        memcpy(st->buf + st->pos, ad, n);
+        st->pos += n;
+        i = n;
+        if (st->pos == 16U) {
+            stream_flush(st);
+        }
+    }
+    full = (adlen - i) & ~15ULL;
+    if (full > 0U) {
+        st->acc = ghash(st->acc, ad + i, full, st->ctx.Hv);
+        i += full;
+    }
+    if (i < adlen) {
+        st->pos = (size_t) (adlen - i);
+        memcpy(st->buf, ad + i, st->pos);
+    }
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_encrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                                   unsigned char *c, const unsigned char *m,
+                                   unsigned long long mlen)
+{
+    stream_update((aes256gcm_stream_state *) (void *) state_, c, m, mlen, 1);
+
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_encrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                                  unsigned char *mac)
+{
+    stream_final((aes256gcm_stream_state *) (void *) state_, mac);
+
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_decrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                                   unsigned char *m, const unsigned char *c,
+                                   unsigned long long clen)
+{
+    stream_update((aes256gcm_stream_state *) (void *) state_, m, c, clen, 0);
+
+    return 0;
+}
+
+static int
+aes256gcm_armcrypto_decrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                                  const unsigned char *mac)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    int                            ret;
+
+    stream_final((aes256gcm_stream_state *) (void *) state_, computed_mac);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+
+    return ret;
+}
+
+struct crypto_aead_aes256gcm_implementation crypto_aead_aes256gcm_armcrypto_implementation = {
+    SODIUM_C99(.beforenm =) aes256gcm_armcrypto_beforenm,
+    SODIUM_C99(.encrypt_detached_afternm =) aes256gcm_armcrypto_encrypt_detached_afternm,
+    SODIUM_C99(.decrypt_detached_afternm =) aes256gcm_armcrypto_decrypt_detached_afternm,
+    SODIUM_C99(.compact_beforenm =) aes256gcm_armcrypto_compact_beforenm,
+    SODIUM_C99(.compact_expand =) aes256gcm_armcrypto_compact_expand,
+    SODIUM_C99(.encrypt_detached_compact =) aes256gcm_armcrypto_encrypt_detached_compact,
+    SODIUM_C99(.decrypt_detached_compact =) aes256gcm_armcrypto_decrypt_detached_compact,
+    SODIUM_C99(.encrypt_detached_iov =) aes256gcm_armcrypto_encrypt_detached_iov,
+    SODIUM_C99(.decrypt_detached_iov =) aes256gcm_armcrypto_decrypt_detached_iov,
+    SODIUM_C99(.init =) aes256gcm_armcrypto_init,
+    SODIUM_C99(.update_ad =) aes256gcm_armcrypto_update_ad,
+    SODIUM_C99(.encrypt_update =) aes256gcm_armcrypto_encrypt_update,
+    SODIUM_C99(.encrypt_final =) aes256gcm_armcrypto_encrypt_final,
+    SODIUM_C99(.decrypt_update =) aes256gcm_armcrypto_decrypt_update,
+    SODIUM_C99(.decrypt_final =) aes256gcm_armcrypto_decrypt_final
+};
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef aead_aes256gcm_armcrypto_H
+#define aead_aes256gcm_armcrypto_H
+
+#include "../aes256gcm.h"
+
+extern struct crypto_aead_aes256gcm_implementation
+    crypto_aead_aes256gcm_armcrypto_implementation;
+
+#endif
@@ -0,0 +1,667 @@
+/*
+ * AES256-GCM for CPUs without AES and carry-less multiplication instructions.
+ *
+ * AES uses the bitsliced, constant-time implementation from crypto_core/softaes,
+ * which encrypts 4 counter blocks at once. GHASH uses 64-bit integer
+ * multiplications with holes, as in BearSSL's ghash_ctmul64, and assumes that
+ * these multiplications run in constant time.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aes256gcm.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "private/aead_iov.h"
+#include "private/common.h"
+#include "private/softaes.h"
+#include "utils.h"
+
+#include "aead_aes256gcm_soft.h"
+
+/* The compact key has the same layout, and is used as a state as-is */
+typedef struct aes256gcm_state {
+    softaes256_key key;
+    unsigned char  H[16];
+} aes256gcm_state;
+
+typedef struct aes256gcm_stream_state {
+    aes256gcm_state    ctx;
+    unsigned char      npub[12];
+    uint32_t           ctr;     /* next counter */
+    unsigned char      T[16];
+    unsigned char      accum[16];
+    unsigned char      ks[64];  /* keystream, ks[ks_pos..63] are unused */
+    unsigned char      buf[16]; /* pending additional data or ciphertext */
+    unsigned long long adlen;
+    unsigned long long mlen;
+    size_t             ks_pos;
+    size_t             pos;
+    int                ad_done;
+} aes256gcm_stream_state;
+
+static inline uint64_t
+bmul64(uint64_t x, uint64_t y)
+{
+    uint64_t x0, x1, x2, x3;
+    uint64_t y0, y1, y2, y3;
+    uint64_t z0, z1, z2, z3;
+
+    x0 = x & (uint64_t) 0x1111111111111111;
+    x1 = x & (uint64_t) 0x2222222222222222;
+    x2 = x & (uint64_t) 0x4444444444444444;
+    x3 = x & (uint64_t) 0x8888888888888888;
+    y0 = y & (uint64_t) 0x1111111111111111;
+    y1 = y & (uint64_t) 0x2222222222222222;
+    y2 = y & (uint64_t) 0x4444444444444444;
+    y3 = y & (uint64_t) 0x8888888888888888;
+    z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    z0 &= (uint64_t) 0x1111111111111111;
+    z1 &= (uint64_t) 0x2222222222222222;
+    z2 &= (uint64_t) 0x4444444444444444;
+    z3 &= (uint64_t) 0x8888888888888888;
+
+    return z0 | z1 | z2 | z3;
+}
+
+static inline uint64_t
+rev64(uint64_t x)
+{
+#define RMS(m, s) x = ((x & (uint64_t) (m)) << (s)) | ((x >> (s)) & (uint64_t) (m))
+    RMS(0x5555555555555555, 1);
+    RMS(0x3333333333333333, 2);
+    RMS(0x0F0F0F0F0F0F0F0F, 4);
+    RMS(0x00FF00FF00FF00FF, 8);
+    RMS(0x0000FFFF0000FFFF, 16);
+#undef RMS
+    return (x << 32) | (x >> 32);
+}
+
+/* y = (y ^ block) * H for every block of in, the last one zero-padded */
+static void
+soft_ghash(unsigned char y[16], const unsigned char H[16], const unsigned char *in,
+           unsigned long long len)
+{
+    CRYPTO_ALIGN(16) unsigned char tmp[16];
+    const unsigned char           *src;
+    uint64_t                       y0, y1, y2, y0r, y1r, y2r;
+    uint64_t                       h0, h1, h2, h0r, h1r, h2r;
+    uint64_t                       z0, z1, z2, z0h, z1h, z2h;
+    uint64_t                       v0, v1, v2, v3;
+
+    y1  = LOAD64_BE(y);
+    y0  = LOAD64_BE(y + 8);
+    h1  = LOAD64_BE(H);
+    h0  = LOAD64_BE(H + 8);
+    h0r = rev64(h0);
+    h1r = rev64(h1);
+    h2  = h0 ^ h1;
+    h2r = h0r ^ h1r;
+    while (len > 0) {
+        if (len >= 16) {
+            src = in;
+            in += 16;
+            len -= 16;
+        } else {
+            memset(tmp, 0, sizeof tmp);
+            memcpy(tmp, in, (size_t) len);
+            src = tmp;
+            len = 0;
+        }
+        y1 ^= LOAD64_BE(src);
+        y0 ^= LOAD64_BE(src + 8);
+        y0r = rev64(y0);
+        y1r = rev64(y1);
+        y2  = y0 ^ y1;
+        y2r = y0r ^ y1r;
+
+        z0  = bmul64(y0, h0);
+        z1  = bmul64(y1, h1);
+        z2  = bmul64(y2, h2);
+        z0h = bmul64(y0r, h0r);
+        z1h = bmul64(y1r, h1r);
+        z2h = bmul64(y2r, h2r);
+        z2 ^= z0 ^ z1;
+        z2h ^= z0h ^ z1h;
+        z0h = rev64(z0h) >> 1;
+        z1h = rev64(z1h) >> 1;
+        z2h = rev64(z2h) >> 1;
+
+        v0 = z0;
+        v1 = z0h ^ z2;
+        v2 = z1 ^ z2h;
+        v3 = z1h;
+
+        v3 = (v3 << 1) | (v2 >> 63);
+        v2 = (v2 << 1) | (v1 >> 63);
+        v1 = (v1 << 1) | (v0 >> 63);
+        v0 = (v0 << 1);
+
+        v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+        v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+        v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+        v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+        y0 = v2;
+        y1 = v3;
+    }
+    STORE64_BE(y, y1);
+    STORE64_BE(y + 8, y0);
+}
+
+/* Encrypts the 4 counter blocks starting at ctr */
+static void
+soft_keystream4(unsigned char ks[64], const unsigned char npub[12], uint32_t ctr,
+                const softaes256_skey *skey)
+{
+    CRYPTO_ALIGN(16) unsigned char cb[64];
+    size_t                         i;
+
+    for (i = 0U; i < 4U; i++) {
+        memcpy(cb + 16U * i, npub, 12);
+        STORE32_BE(cb + 16U * i + 12U, ctr + (uint32_t) i);
+    }
+    softaes256_encrypt4(ks, cb, skey);
+}
+
+static void
+soft_stream_init(aes256gcm_stream_state *const st, const unsigned char *npub,
+                 const aes256gcm_state *ctx, const softaes256_skey *skey)
+{
+    memset(st, 0, sizeof *st);
+    memcpy(&st->ctx, ctx, sizeof st->ctx);
+    memcpy(st->npub, npub, sizeof st->npub);
+
+    /* T = E(J0), and the keystream for the first 3 blocks comes for free */
+    soft_keystream4(st->ks, st->npub, 1U, skey);
+    memcpy(st->T, st->ks, sizeof st->T);
+    st->ctr    = 5U;
+    st->ks_pos = 16U;
+}
+
+/* GHASH the pending partial block, zero-padded */
+static void
+soft_stream_flush(aes256gcm_stream_state *const st)
+{
+    if (st->pos > 0U) {
+        soft_ghash(st->accum, st->ctx.H, st->buf, st->pos);
+        st->pos = 0U;
+    }
+}
+
+static void
+soft_stream_update_ad(aes256gcm_stream_state *const st, const unsigned char *ad,
+                      unsigned long long adlen)
+{
+    unsigned long long i = 0ULL;
+    unsigned long long full;
+    size_t             n;
+
+    if (adlen == 0ULL) {
+        return;
+    }
+    st->adlen += adlen;
+    if (st->pos > 0U) {
+        n = 16U - st->pos;
+        if (n > adlen) {
+            n = (size_t) adlen;
+        }
+        memcpy(st->buf + st->pos, ad, n);
+        st->pos += n;
+        i = n;
+        if (st->pos == 16U) {
+            soft_stream_flush(st);
+        }
+    }
+    full = (adlen - i) & ~15ULL;
+    soft_ghash(st->accum, st->ctx.H, ad + i, full);
+    i += full;
+    if (i < adlen) {
+        st->pos = (size_t) (adlen - i);
+        memcpy(st->buf, ad + i, st->pos);
+    }
+}
+
+/*
+ * Encrypts or decrypts len bytes, and GHASHes the ciphertext.
+ * When decrypting, out can be NULL to only compute the tag.
+ *
+ * The keystream buffer is refilled 64 bytes at a time, and its position
+ * stays aligned with the GHASH buffer, so that once it is empty, whole
+ * 64-byte chunks can be processed directly.
+ */
+static void
+soft_stream_update(aes256gcm_stream_state *const st, const softaes256_skey *skey,
+                   unsigned char *out, const unsigned char *in,
+                   unsigned long long len, int encrypt)
+{
+    CRYPTO_ALIGN(16) unsigned char ks[64];
+    unsigned long long             i = 0ULL;
+    size_t                         j;
+    unsigned char                  t;
+
+    if (len > crypto_aead_aes256gcm_MESSAGEBYTES_MAX - st->mlen) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    if (st->ad_done == 0) {
+        soft_stream_flush(st);
+        st->ad_done = 1;
+    }
+    st->mlen += len;
+    while (i < len) {
+        if (st->ks_pos == 64U && len - i >= 64U) {
+            if (!encrypt) {
+                soft_ghash(st->accum, st->ctx.H, in + i, 64U);
+            }
+            if (out != NULL) {
+                soft_keystream4(ks, st->npub, st->ctr, skey);
+                for (j = 0U; j < 64U; j++) {
+                    out[i + j] = in[i + j] ^ ks[j];
+                }
+            }
+            st->ctr += 4U;
+            if (encrypt) {
+                soft_ghash(st->accum, st->ctx.H, out + i, 64U);
+            }
+            i += 64U;
+            continue;
+        }
+        if (st->ks_pos == 64U) {
+            soft_keystream4(st->ks, st->npub, st->ctr, skey);
+            st->ctr += 4U;
+            st->ks_pos = 0U;
+        }
+        t = in[i];
+        if (out != NULL) {
+            out[i] = t ^ st->ks[st->ks_pos];
+        }
+        st->buf[st->pos++] = encrypt ? (unsigned char) (t ^ st->ks[st->ks_pos]) : t;
+        st->ks_pos++;
+        if (st->pos == 16U) {
+            soft_stream_flush(st);
+        }
+        i++;
+    }
+    sodium_memzero(ks, sizeof ks);
+}
+
+static void
+soft_stream_final(aes256gcm_stream_state *const st, unsigned char *mac)
+{
+    CRYPTO_ALIGN(16) unsigned char fb[16];
+    int                            i;
+
+    soft_stream_flush(st);
+    STORE64_BE(fb, (uint64_t) (8 * st->adlen));
+    STORE64_BE(fb + 8, (uint64_t) (8 * st->mlen));
+    soft_ghash(st->accum, st->ctx.H, fb, sizeof fb);
+    for (i = 0; i < 16; ++i) {
+        mac[i] = st->T[i] ^ st->accum[i];
+    }
+    sodium_memzero(st, sizeof *st);
+}
+
+static void
+soft_gcm(unsigned char *mac, const aes256gcm_state *ctx, unsigned char *out,
+         const unsigned char *in, unsigned long long len, const unsigned char *ad,
+         unsigned long long adlen, const unsigned char *npub, int encrypt)
+{
+    aes256gcm_stream_state st;
+    softaes256_skey        skey;
+
+    softaes256_bitslice_key(&skey, &ctx->key);
+    soft_stream_init(&st, npub, ctx, &skey);
+    soft_stream_update_ad(&st, ad, adlen);
+    soft_stream_update(&st, &skey, out, in, len, encrypt);
+    soft_stream_final(&st, mac);
+    sodium_memzero(&skey, sizeof skey);
+}
+
+static int
+soft_gcm_decrypt(unsigned char *m, const aes256gcm_state *ctx, const unsigned char *c,
+                 unsigned long long clen, const unsigned char *mac,
+                 const unsigned char *ad, unsigned long long adlen,
+                 const unsigned char *npub)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    int                            ret;
+
+    if (clen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    soft_gcm(computed_mac, ctx, m, c, clen, ad, adlen, npub, 0);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        memset(m, 0, clen);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+aes256gcm_soft_beforenm(crypto_aead_aes256gcm_state *ctx_, const unsigned char *k)
+{
+    aes256gcm_state               *ctx = (aes256gcm_state *) (void *) ctx_;
+    softaes256_skey                skey;
+    CRYPTO_ALIGN(16) unsigned char zero[64];
+    CRYPTO_ALIGN(16) unsigned char t[64];
+
+    COMPILER_ASSERT((sizeof *ctx_) >= (sizeof *ctx));
+    softaes256_expand_key(&ctx->key, k);
+    softaes256_bitslice_key(&skey, &ctx->key);
+    memset(zero, 0, sizeof zero);
+    softaes256_encrypt4(t, zero, &skey);
+    memcpy(ctx->H, t, sizeof ctx->H);
+    sodium_memzero(&skey, sizeof skey);
+    sodium_memzero(t, sizeof t);
+
+    return 0;
+}
+
+static int
+aes256gcm_soft_encrypt_detached_afternm(unsigned char *c, unsigned char *mac,
+                                        unsigned long long *maclen_p, const unsigned char *m,
+                                        unsigned long long mlen, const unsigned char *ad,
+                                        unsigned long long adlen, const unsigned char *nsec,
+                                        const unsigned char *npub,
+                                        const crypto_aead_aes256gcm_state *ctx_)
+{
+    (void) nsec;
+    if (mlen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    soft_gcm(mac, (const aes256gcm_state *) (const void *) ctx_, c, m, mlen, ad, adlen,
+             npub, 1);
+    if (maclen_p != NULL) {
+        *maclen_p = 16;
+    }
+    return 0;
+}
+
+static int
+aes256gcm_soft_decrypt_detached_afternm(unsigned char *m, unsigned char *nsec,
+                                        const unsigned char *c, unsigned long long clen,
+                                        const unsigned char *mac, const unsigned char *ad,
+                                        unsigned long long adlen, const unsigned char *npub,
+                                        const crypto_aead_aes256gcm_state *ctx_)
+{
+    (void) nsec;
+
+    return soft_gcm_decrypt(m, (const aes256gcm_state *) (const void *) ctx_, c, clen,
+                            mac, ad, adlen, npub);
+}
+
+static int
+aes256gcm_soft_compact_beforenm(crypto_aead_aes256gcm_compact_key *ck,
+                                const unsigned char *k, size_t count)
+{
+    size_t i;
+
+    COMPILER_ASSERT(sizeof *ck == sizeof(aes256gcm_state));
+    for (i = 0U; i < count; i++) {
+        aes256gcm_soft_beforenm((crypto_aead_aes256gcm_state *) (void *) &ck[i],
+                                k + i * crypto_aead_aes256gcm_KEYBYTES);
+    }
+    return 0;
+}
+
+static int
+aes256gcm_soft_compact_expand(crypto_aead_aes256gcm_state *ctx_,
+                              const crypto_aead_aes256gcm_compact_key *ck)
+{
+    memcpy(ctx_, ck, sizeof(aes256gcm_state));
+
+    return 0;
+}
+
+static int
+aes256gcm_soft_encrypt_detached_compact(unsigned char *c, unsigned char *mac,
+                                        unsigned long long *maclen_p, const unsigned char *m,
+                                        unsigned long long mlen, const unsigned char *ad,
+                                        unsigned long long adlen, const unsigned char *nsec,
+                                        const unsigned char *npub,
+                                        const crypto_aead_aes256gcm_compact_key *ck)
+{
+    return aes256gcm_soft_encrypt_detached_afternm(
+        c, mac, maclen_p, m, mlen, ad, adlen, nsec, npub,
+        (const crypto_aead_aes256gcm_state *) (const void *) ck);
+}
+
+static int
+aes256gcm_soft_decrypt_detached_compact(unsigned char *m, unsigned char *nsec,
+                                        const unsigned char *c, unsigned long long clen,
+                                        const unsigned char *mac, const unsigned char *ad,
+                                        unsigned long long adlen, const unsigned char *npub,
+                                        const crypto_aead_aes256gcm_compact_key *ck)
+{
+    (void) nsec;
+
+    return soft_gcm_decrypt(m, (const aes256gcm_state *) (const void *) ck, c, clen,
+                            mac, ad, adlen, npub);
+}
+
+/* Same as soft_gcm(), with scattered buffers. out can be NULL when decrypting. */
+static void
+soft_gcm_iov(unsigned char *mac, const aes256gcm_state *ctx,
+             const crypto_aead_iovec *out, size_t out_count,
+             const crypto_aead_iovec *in, size_t in_count,
+             const crypto_aead_iovec *ad, size_t ad_count,
+             const unsigned char *npub, int encrypt)
+{
+    aes256gcm_stream_state st;
+    softaes256_skey        skey;
+    aead_iov_cursor        in_cur;
+    aead_iov_cursor        out_cur;
+    size_t                 i;
+    size_t                 run;
+
+    softaes256_bitslice_key(&skey, &ctx->key);
+    soft_stream_init(&st, npub, ctx, &skey);
+    for (i = 0U; i < ad_count; i++) {
+        soft_stream_update_ad(&st, (const unsigned char *) ad[i].ptr, ad[i].len);
+    }
+    aead_iov_cursor_init(&in_cur, in, in_count);
+    if (out != NULL) {
+        aead_iov_cursor_init(&out_cur, out, out_count);
+    }
+    while ((run = aead_iov_cursor_run(out != NULL ? &out_cur : NULL, &in_cur, 1U)) > 0U) {
+        soft_stream_update(&st, &skey, out != NULL ? aead_iov_cursor_ptr(&out_cur) : NULL,
+                           aead_iov_cursor_ptr(&in_cur), run, encrypt);
+        aead_iov_cursor_advance(&in_cur, run);
+        if (out != NULL) {
+            aead_iov_cursor_advance(&out_cur, run);
+        }
+    }
+    soft_stream_final(&st, mac);
+    sodium_memzero(&skey, sizeof skey);
+}
+
+static int
+aes256gcm_soft_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                                    unsigned char *mac, unsigned long long *maclen_p,
+                                    const crypto_aead_iovec *m, size_t m_count,
+                                    const crypto_aead_iovec *ad, size_t ad_count,
+                                    const unsigned char *nsec,
+                                    const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    unsigned long long                           adlen;
+    unsigned long long                           mlen;
+    unsigned long long                           clen;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&mlen, m, m_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 || clen != mlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    aes256gcm_soft_beforenm(&ctx, k);
+    soft_gcm_iov(mac, (const aes256gcm_state *) (const void *) &ctx,
+                 c, c_count, m, m_count, ad, ad_count, npub, 1);
+    sodium_memzero(&ctx, sizeof ctx);
+    if (maclen_p != NULL) {
+        *maclen_p = 16;
+    }
+    return 0;
+}
+
+static int
+aes256gcm_soft_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                                    unsigned char *nsec,
+                                    const crypto_aead_iovec *c, size_t c_count,
+                                    const unsigned char *mac,
+                                    const crypto_aead_iovec *ad, size_t ad_count,
+                                    const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) crypto_aead_aes256gcm_state ctx;
+    CRYPTO_ALIGN(16) unsigned char               computed_mac[16];
+    unsigned long long                           adlen;
+    unsigned long long                           mlen;
+    unsigned long long                           clen;
+    int                                          ret;
+
+    (void) nsec;
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 ||
+        (m != NULL && (aead_iov_total(&mlen, m, m_count) != 0 ||
+                       mlen != clen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (clen > crypto_aead_aes256gcm_MESSAGEBYTES_MAX) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    aes256gcm_soft_beforenm(&ctx, k);
+    soft_gcm_iov(computed_mac, (const aes256gcm_state *) (const void *) &ctx,
+                 m, m_count, c, c_count, ad, ad_count, npub, 0);
+    sodium_memzero(&ctx, sizeof ctx);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        aead_iov_memzero(m, m_count);
+        return -1;
+    }
+    return 0;
+}
+
+static int
+aes256gcm_soft_init(crypto_aead_aes256gcm_stream_state *state_,
+                    const unsigned char *npub,
+                    const crypto_aead_aes256gcm_state *ctx_)
+{
+    aes256gcm_stream_state *st  = (aes256gcm_stream_state *) (void *) state_;
+    const aes256gcm_state  *ctx = (const aes256gcm_state *) (const void *) ctx_;
+    softaes256_skey         skey;
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    softaes256_bitslice_key(&skey, &ctx->key);
+    soft_stream_init(st, npub, ctx, &skey);
+    sodium_memzero(&skey, sizeof skey);
+
+    return 0;
+}
+
+static int
+aes256gcm_soft_update_ad(crypto_aead_aes256gcm_stream_state *state_,
+                         const unsigned char *ad, unsigned long long adlen)
+{
+    aes256gcm_stream_state *st = (aes256gcm_stream_state *) (void *) state_;
+
+    if (st->ad_done != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    soft_stream_update_ad(st, ad, adlen);
+
+    return 0;
+}
+
+static void
+soft_stream_update_bitslice(aes256gcm_stream_state *const st, unsigned char *out,
+                            const unsigned char *in, unsigned long long len, int encrypt)
+{
+    softaes256_skey skey;
+
+    softaes256_bitslice_key(&skey, &st->ctx.key);
+    soft_stream_update(st, &skey, out, in, len, encrypt);
+    sodium_memzero(&skey, sizeof skey);
+}
+
+static int
+aes256gcm_soft_encrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                              unsigned char *c, const unsigned char *m,
+                              unsigned long long mlen)
+{
+    soft_stream_update_bitslice((aes256gcm_stream_state *) (void *) state_, c, m, mlen, 1);
+
+    return 0;
+}
+
+static int
+aes256gcm_soft_encrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                             unsigned char *mac)
+{
+    soft_stream_final((aes256gcm_stream_state *) (void *) state_, mac);
+
+    return 0;
+}
+
+static int
+aes256gcm_soft_decrypt_update(crypto_aead_aes256gcm_stream_state *state_,
+                              unsigned char *m, const unsigned char *c,
+                              unsigned long long clen)
+{
+    soft_stream_update_bitslice((aes256gcm_stream_state *) (void *) state_, m, c, clen, 0);
+
+    return 0;
+}
+
+static int
+aes256gcm_soft_decrypt_final(crypto_aead_aes256gcm_stream_state *state_,
+                             const unsigned char *mac)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[16];
+    int                            ret;
+
+    soft_stream_final((aes256gcm_stream_state *) (void *) state_, computed_mac);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+
+    return ret;
+}
+
+struct crypto_aead_aes256gcm_implementation crypto_aead_aes256gcm_soft_implementation = {
+    SODIUM_C99(.beforenm =) aes256gcm_soft_beforenm,
+    SODIUM_C99(.encrypt_detached_afternm =) aes256gcm_soft_encrypt_detached_afternm,
+    SODIUM_C99(.decrypt_detached_afternm =) aes256gcm_soft_decrypt_detached_afternm,
+    SODIUM_C99(.compact_beforenm =) aes256gcm_soft_compact_beforenm,
+    SODIUM_C99(.compact_expand =) aes256gcm_soft_compact_expand,
+    SODIUM_C99(.encrypt_detached_compact =) aes256gcm_soft_encrypt_detached_compact,
+    SODIUM_C99(.decrypt_detached_compact =) aes256gcm_soft_decrypt_detached_compact,
+    SODIUM_C99(.encrypt_detached_iov =) aes256gcm_soft_encrypt_detached_iov,
+    SODIUM_C99(.decrypt_detached_iov =) aes256gcm_soft_decrypt_detached_iov,
+    SODIUM_C99(.init =) aes256gcm_soft_init,
+    SODIUM_C99(.update_ad =) aes256gcm_soft_update_ad,
+    SODIUM_C99(.encrypt_update =) aes256gcm_soft_encrypt_update,
+    SODIUM_C99(.encrypt_final =) aes256gcm_soft_encrypt_final,
+    SODIUM_C99(.decrypt_update =) aes256gcm_soft_decrypt_update,
+    SODIUM_C99(.decrypt_final =) aes256gcm_soft_decrypt_final
+};
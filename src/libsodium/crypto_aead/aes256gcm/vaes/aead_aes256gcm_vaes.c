@@ -0,0 +1,410 @@
+/*
+ * AES256-GCM, using VAES and VPCLMULQDQ on 256-bit registers.
+ * Each instruction processes two AES blocks, and GHASH is computed over
+ * 16 blocks at a time, with a single reduction (Aggregated Reduction Method).
+ * The field representation is the same as in the AES-NI implementation.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_verify_16.h"
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_VAESINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("ssse3")
+#  pragma GCC target("aes")
+#  pragma GCC target("pclmul")
+#  pragma GCC target("avx")
+#  pragma GCC target("avx2")
+#  pragma GCC target("vaes")
+#  pragma GCC target("vpclmulqdq")
+# endif
+
+# include <immintrin.h>
+
+# include "aead_aes256gcm_vaes.h"
+
+# define ROUNDKEYS 15
+# define PARBLOCKS 16
+
+# if defined(__INTEL_COMPILER) || defined(_bswap64)
+# elif defined(_MSC_VER)
+#  define _bswap64(a) _byteswap_uint64(a)
+# else
+#  define _bswap64(a) __builtin_bswap64(a)
+# endif
+
+/* reduction of the 256-bit product (hi:lo), shifted by one bit */
+static inline __m128i
+gf_reduce(__m128i lo, __m128i hi)
+{
+    __m128i tmp0, tmp1, tmp2, tmp3, tmp4, tmp5;
+
+    tmp0 = _mm_srli_epi32(lo, 31);
+    tmp1 = _mm_srli_epi32(hi, 31);
+    lo   = _mm_slli_epi32(lo, 1);
+    hi   = _mm_slli_epi32(hi, 1);
+    tmp2 = _mm_srli_si128(tmp0, 12);
+    tmp1 = _mm_slli_si128(tmp1, 4);
+    tmp0 = _mm_slli_si128(tmp0, 4);
+    lo   = _mm_or_si128(lo, tmp0);
+    hi   = _mm_or_si128(hi, tmp1);
+    hi   = _mm_or_si128(hi, tmp2);
+    tmp0 = _mm_slli_epi32(lo, 31);
+    tmp1 = _mm_slli_epi32(lo, 30);
+    tmp2 = _mm_slli_epi32(lo, 25);
+    tmp0 = _mm_xor_si128(tmp0, tmp1);
+    tmp0 = _mm_xor_si128(tmp0, tmp2);
+    tmp1 = _mm_srli_si128(tmp0, 4);
+    tmp0 = _mm_slli_si128(tmp0, 12);
+    lo   = _mm_xor_si128(lo, tmp0);
+    tmp3 = _mm_srli_epi32(lo, 1);
+    tmp4 = _mm_srli_epi32(lo, 2);
+    tmp5 = _mm_srli_epi32(lo, 7);
+    tmp3 = _mm_xor_si128(tmp3, tmp4);
+    tmp3 = _mm_xor_si128(tmp3, tmp5);
+    tmp3 = _mm_xor_si128(tmp3, tmp1);
+    lo   = _mm_xor_si128(lo, tmp3);
+
+    return _mm_xor_si128(hi, lo);
+}
+
+/*
+ * acc = (acc + X_0) * H^n + X_1 * H^(n-1) + ... + X_(n-1) * H,
+ * with n <= PARBLOCKS, and X two blocks per register, in memory order.
+ */
+static inline __m128i
+ghash_regs(__m128i acc, const __m256i *x, size_t n, const __m128i *Hv)
+{
+    const __m256i  rev = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    const __m128i *Hp  = Hv + PARBLOCKS - n;
+    __m256i        lo  = _mm256_setzero_si256();
+    __m256i        hi  = _mm256_setzero_si256();
+    __m256i        mid = _mm256_setzero_si256();
+    __m256i        X, H;
+    __m128i        lo1, hi1, mid1, X1, H1;
+    size_t         j;
+
+    for (j = 0; j + 2 <= n; j += 2) {
+        X = _mm256_shuffle_epi8(x[j / 2], rev);
+        if (j == 0) {
+            X = _mm256_xor_si256(X, _mm256_inserti128_si256(_mm256_setzero_si256(), acc, 0));
+        }
+        H   = _mm256_loadu_si256((const __m256i *) (const void *) (Hp + j));
+        lo  = _mm256_xor_si256(lo, _mm256_clmulepi64_epi128(H, X, 0x00));
+        hi  = _mm256_xor_si256(hi, _mm256_clmulepi64_epi128(H, X, 0x11));
+        mid = _mm256_xor_si256(mid, _mm256_clmulepi64_epi128(H, X, 0x01));
+        mid = _mm256_xor_si256(mid, _mm256_clmulepi64_epi128(H, X, 0x10));
+    }
+    lo1  = _mm_xor_si128(_mm256_castsi256_si128(lo), _mm256_extracti128_si256(lo, 1));
+    hi1  = _mm_xor_si128(_mm256_castsi256_si128(hi), _mm256_extracti128_si256(hi, 1));
+    mid1 = _mm_xor_si128(_mm256_castsi256_si128(mid), _mm256_extracti128_si256(mid, 1));
+    if (j < n) {
+        X1 = _mm_shuffle_epi8(_mm256_castsi256_si128(x[j / 2]),
+                              _mm256_castsi256_si128(rev));
+        if (j == 0) {
+            X1 = _mm_xor_si128(X1, acc);
+        }
+        H1   = Hp[j];
+        lo1  = _mm_xor_si128(lo1, _mm_clmulepi64_si128(H1, X1, 0x00));
+        hi1  = _mm_xor_si128(hi1, _mm_clmulepi64_si128(H1, X1, 0x11));
+        mid1 = _mm_xor_si128(mid1, _mm_clmulepi64_si128(H1, X1, 0x01));
+        mid1 = _mm_xor_si128(mid1, _mm_clmulepi64_si128(H1, X1, 0x10));
+    }
+    lo1 = _mm_xor_si128(lo1, _mm_slli_si128(mid1, 8));
+    hi1 = _mm_xor_si128(hi1, _mm_srli_si128(mid1, 8));
+
+    return gf_reduce(lo1, hi1);
+}
+
+/* GHASH an arbitrary long buffer, zero-padding the last block */
+static __m128i
+ghash(__m128i acc, const unsigned char *in, unsigned long long len, const __m128i *Hv)
+{
+    CRYPTO_ALIGN(32) unsigned char buf[PARBLOCKS * 16];
+    __m256i                        x[PARBLOCKS / 2];
+    size_t                         n;
+    size_t                         k;
+
+    while (len >= PARBLOCKS * 16) {
+        for (k = 0; k < PARBLOCKS / 2; k++) {
+            x[k] = _mm256_loadu_si256((const __m256i *) (const void *) (in + 32 * k));
+        }
+        acc = ghash_regs(acc, x, PARBLOCKS, Hv);
+        in += PARBLOCKS * 16;
+        len -= PARBLOCKS * 16;
+    }
+    if (len > 0) {
+        n = (size_t) (len + 15) / 16;
+        memset(buf, 0, (n + 1) / 2 * 32);
+        memcpy(buf, in, (size_t) len);
+        for (k = 0; k < (n + 1) / 2; k++) {
+            x[k] = _mm256_load_si256((const __m256i *) (const void *) (buf + 32 * k));
+        }
+        acc = ghash_regs(acc, x, n, Hv);
+    }
+    return acc;
+}
+
+/* encrypt 2 * nv counter blocks, and advance the counters */
+static inline void
+aes_ctr(__m256i *b, size_t nv, __m256i *ctr, const __m256i *rk)
+{
+    const __m256i pt  = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    const __m256i two = _mm256_set_epi32(2, 0, 0, 0, 2, 0, 0, 0);
+    size_t        k;
+    int           r;
+
+    for (k = 0; k < nv; k++) {
+        b[k] = _mm256_xor_si256(_mm256_shuffle_epi8(*ctr, pt), rk[0]);
+        *ctr = _mm256_add_epi32(*ctr, two);
+    }
+    for (r = 1; r < ROUNDKEYS - 1; r++) {
+        for (k = 0; k < nv; k++) {
+            b[k] = _mm256_aesenc_epi128(b[k], rk[r]);
+        }
+    }
+    for (k = 0; k < nv; k++) {
+        b[k] = _mm256_aesenclast_epi128(b[k], rk[ROUNDKEYS - 1]);
+    }
+}
+
+# define MAKE8(X) \
+    X(0);        \
+    X(1);        \
+    X(2);        \
+    X(3);        \
+    X(4);        \
+    X(5);        \
+    X(6);        \
+    X(7)
+
+# define CTRx(a)                                                                   \
+    b[a] = _mm256_xor_si256(                                                      \
+        _mm256_shuffle_epi8(                                                      \
+            _mm256_add_epi32(*ctr, _mm256_set_epi32(2 * a, 0, 0, 0, 2 * a, 0, 0, 0)), \
+            pt),                                                                  \
+        rk[0])
+# define AESENCx(a) b[a] = _mm256_aesenc_epi128(b[a], rk[r])
+# define AESENCLASTx(a) b[a] = _mm256_aesenclast_epi128(b[a], rk[ROUNDKEYS - 1])
+
+/* encrypt PARBLOCKS counter blocks, and advance the counters */
+static inline void
+aes_ctr16(__m256i *b, __m256i *ctr, const __m256i *rk)
+{
+    const __m256i pt = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    int           r;
+
+    MAKE8(CTRx);
+    *ctr = _mm256_add_epi32(*ctr, _mm256_set_epi32(PARBLOCKS, 0, 0, 0, PARBLOCKS, 0, 0, 0));
+    for (r = 1; r < ROUNDKEYS - 1; r++) {
+        MAKE8(AESENCx);
+    }
+    MAKE8(AESENCLASTx);
+}
+
+/*
+ * Same as aes_ctr16(), while computing GHASH over PARBLOCKS other blocks,
+ * so that both run in parallel.
+ */
+static inline __m128i
+aes_ctr16_ghash(__m256i *b, __m256i *ctr, const __m256i *rk, __m128i acc,
+                const __m256i *x, const __m128i *Hv)
+{
+    const __m256i pt  = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(12, 13, 14, 15, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    const __m256i rev = _mm256_broadcastsi128_si256(
+        _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    __m256i       lo  = _mm256_setzero_si256();
+    __m256i       hi  = _mm256_setzero_si256();
+    __m256i       mid = _mm256_setzero_si256();
+    __m256i       X, H;
+    __m128i       lo1, hi1, mid1;
+    int           r;
+
+    MAKE8(CTRx);
+    *ctr = _mm256_add_epi32(*ctr, _mm256_set_epi32(PARBLOCKS, 0, 0, 0, PARBLOCKS, 0, 0, 0));
+    X = _mm256_xor_si256(_mm256_shuffle_epi8(x[0], rev),
+                         _mm256_inserti128_si256(_mm256_setzero_si256(), acc, 0));
+    for (r = 1; r < ROUNDKEYS - 1; r++) {
+        MAKE8(AESENCx);
+        if (r <= PARBLOCKS / 2) {
+            H   = _mm256_loadu_si256((const __m256i *) (const void *) (Hv + 2 * (r - 1)));
+            lo  = _mm256_xor_si256(lo, _mm256_clmulepi64_epi128(H, X, 0x00));
+            hi  = _mm256_xor_si256(hi, _mm256_clmulepi64_epi128(H, X, 0x11));
+            mid = _mm256_xor_si256(mid, _mm256_clmulepi64_epi128(H, X, 0x01));
+            mid = _mm256_xor_si256(mid, _mm256_clmulepi64_epi128(H, X, 0x10));
+            if (r < PARBLOCKS / 2) {
+                X = _mm256_shuffle_epi8(x[r], rev);
+            }
+        }
+    }
+    MAKE8(AESENCLASTx);
+    lo1  = _mm_xor_si128(_mm256_castsi256_si128(lo), _mm256_extracti128_si256(lo, 1));
+    hi1  = _mm_xor_si128(_mm256_castsi256_si128(hi), _mm256_extracti128_si256(hi, 1));
+    mid1 = _mm_xor_si128(_mm256_castsi256_si128(mid), _mm256_extracti128_si256(mid, 1));
+    lo1  = _mm_xor_si128(lo1, _mm_slli_si128(mid1, 8));
+    hi1  = _mm_xor_si128(hi1, _mm_srli_si128(mid1, 8));
+
+    return gf_reduce(lo1, hi1);
+}
+
+/* returns E(J0), and sets the counter for the first block of data */
+static __m128i
+gcm_setup(__m256i *rk, __m256i *ctr, const unsigned char *npub, const __m128i *rkeys)
+{
+    uint32_t n[3];
+    __m128i  t;
+    int      r;
+
+    for (r = 0; r < ROUNDKEYS; r++) {
+        rk[r] = _mm256_broadcastsi128_si256(_mm_loadu_si128(rkeys + r));
+    }
+    memcpy(n, npub, sizeof n);
+    t = _mm_set_epi32(0x01000000, (int) n[2], (int) n[1], (int) n[0]);
+    t = _mm_xor_si128(t, rkeys[0]);
+    for (r = 1; r < ROUNDKEYS - 1; r++) {
+        t = _mm_aesenc_si128(t, rkeys[r]);
+    }
+    *ctr = _mm256_set_epi32(3, (int) n[2], (int) n[1], (int) n[0],
+                            2, (int) n[2], (int) n[1], (int) n[0]);
+
+    return _mm_aesenclast_si128(t, rkeys[ROUNDKEYS - 1]);
+}
+
+static void
+gcm_tag(unsigned char *tag, __m128i acc, __m128i T, unsigned long long adlen,
+        unsigned long long mlen, const __m128i *Hv)
+{
+    const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m256i       fb;
+
+    fb  = _mm256_set_epi64x(0, 0, (long long) _bswap64((uint64_t) (8 * mlen)),
+                            (long long) _bswap64((uint64_t) (8 * adlen)));
+    acc = ghash_regs(acc, &fb, 1, Hv);
+    _mm_storeu_si128((__m128i *) (void *) tag,
+                     _mm_xor_si128(T, _mm_shuffle_epi8(acc, rev)));
+}
+
+void
+crypto_aead_aes256gcm_vaes_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                            const unsigned char *m, unsigned long long mlen,
+                                            const unsigned char *ad, unsigned long long adlen,
+                                            const unsigned char *npub,
+                                            const unsigned char *rkeys_,
+                                            const unsigned char *Hv_)
+{
+    const __m128i                 *rkeys = (const __m128i *) (const void *) rkeys_;
+    const __m128i                 *Hv    = (const __m128i *) (const void *) Hv_;
+    CRYPTO_ALIGN(32) unsigned char buf[PARBLOCKS * 16];
+    __m256i                        rk[ROUNDKEYS];
+    __m256i                        b[PARBLOCKS / 2];
+    __m256i                        prev[PARBLOCKS / 2];
+    __m256i                        ctr;
+    __m128i                        acc, T;
+    unsigned long long             i, j;
+    size_t                         k, nv;
+
+    T   = gcm_setup(rk, &ctr, npub, rkeys);
+    acc = ghash(_mm_setzero_si128(), ad, adlen, Hv);
+    i   = 0;
+    if (mlen >= PARBLOCKS * 16) {
+        aes_ctr16(b, &ctr, rk);
+        for (;;) {
+            for (k = 0; k < PARBLOCKS / 2; k++) {
+                prev[k] = _mm256_xor_si256(
+                    b[k], _mm256_loadu_si256((const __m256i *) (const void *) (m + i + 32 * k)));
+                _mm256_storeu_si256((__m256i *) (void *) (c + i + 32 * k), prev[k]);
+            }
+            i += PARBLOCKS * 16;
+            if (i + PARBLOCKS * 16 > mlen) {
+                break;
+            }
+            acc = aes_ctr16_ghash(b, &ctr, rk, acc, prev, Hv);
+        }
+        acc = ghash_regs(acc, prev, PARBLOCKS, Hv);
+    }
+    if (i < mlen) {
+        nv = (size_t) (mlen - i + 31) / 32;
+        aes_ctr(b, nv, &ctr, rk);
+        for (k = 0; k < nv; k++) {
+            _mm256_store_si256((__m256i *) (void *) (buf + 32 * k), b[k]);
+        }
+        for (j = 0; i + j < mlen; j++) {
+            c[i + j] = m[i + j] ^ buf[j];
+        }
+        acc = ghash(acc, c + i, mlen - i, Hv);
+    }
+    gcm_tag(mac, acc, T, adlen, mlen, Hv);
+}
+
+int
+crypto_aead_aes256gcm_vaes_decrypt_detached(unsigned char *m, const unsigned char *c,
+                                            unsigned long long clen, const unsigned char *mac,
+                                            const unsigned char *ad, unsigned long long adlen,
+                                            const unsigned char *npub,
+                                            const unsigned char *rkeys_,
+                                            const unsigned char *Hv_)
+{
+    const __m128i                 *rkeys = (const __m128i *) (const void *) rkeys_;
+    const __m128i                 *Hv    = (const __m128i *) (const void *) Hv_;
+    CRYPTO_ALIGN(32) unsigned char buf[PARBLOCKS * 16];
+    CRYPTO_ALIGN(16) unsigned char tag[16];
+    __m256i                        rk[ROUNDKEYS];
+    __m256i                        b[PARBLOCKS / 2];
+    __m256i                        x[PARBLOCKS / 2];
+    __m256i                        ctr;
+    __m128i                        acc, T;
+    unsigned long long             i, j;
+    size_t                         k, nv;
+
+    T   = gcm_setup(rk, &ctr, npub, rkeys);
+    acc = ghash(_mm_setzero_si128(), ad, adlen, Hv);
+    for (i = 0; i + PARBLOCKS * 16 <= clen; i += PARBLOCKS * 16) {
+        for (k = 0; k < PARBLOCKS / 2; k++) {
+            x[k] = _mm256_loadu_si256((const __m256i *) (const void *) (c + i + 32 * k));
+        }
+        if (m == NULL) {
+            acc = ghash_regs(acc, x, PARBLOCKS, Hv);
+        } else {
+            acc = aes_ctr16_ghash(b, &ctr, rk, acc, x, Hv);
+            for (k = 0; k < PARBLOCKS / 2; k++) {
+                _mm256_storeu_si256((__m256i *) (void *) (m + i + 32 * k),
+                                    _mm256_xor_si256(b[k], x[k]));
+            }
+        }
+    }
+    if (i < clen) {
+        acc = ghash(acc, c + i, clen - i, Hv);
+        if (m != NULL) {
+            nv = (size_t) (clen - i + 31) / 32;
+            aes_ctr(b, nv, &ctr, rk);
+            for (k = 0; k < nv; k++) {
+                _mm256_store_si256((__m256i *) (void *) (buf + 32 * k), b[k]);
+            }
+            for (j = 0; i + j < clen; j++) {
+                m[i + j] = c[i + j] ^ buf[j];
+            }
+        }
+    }
+    gcm_tag(tag, acc, T, adlen, clen, Hv);
+    if (crypto_verify_16(tag, mac) != 0) {
+        if (m != NULL) {
+            memset(m, 0, clen);
+        }
+        return -1;
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef aead_aes256gcm_vaes_H
+#define aead_aes256gcm_vaes_H
+
+/*
+ * rkeys are the 15 AES-256 round keys, Hv the byte-reverted powers of H,
+ * from H^16 down to H^1.
+ */
+
+void crypto_aead_aes256gcm_vaes_encrypt_detached(unsigned char *c,
+                                                 unsigned char *mac,
+                                                 const unsigned char *m,
+                                                 unsigned long long mlen,
+                                                 const unsigned char *ad,
+                                                 unsigned long long adlen,
+                                                 const unsigned char *npub,
+                                                 const unsigned char *rkeys,
+                                                 const unsigned char *Hv);
+
+int crypto_aead_aes256gcm_vaes_decrypt_detached(unsigned char *m,
+                                                const unsigned char *c,
+                                                unsigned long long clen,
+                                                const unsigned char *mac,
+                                                const unsigned char *ad,
+                                                unsigned long long adlen,
+                                                const unsigned char *npub,
+                                                const unsigned char *rkeys,
+                                                const unsigned char *Hv);
+
+#endif
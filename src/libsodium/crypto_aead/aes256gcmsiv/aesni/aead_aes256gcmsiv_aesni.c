@@ -0,0 +1,525 @@
+/*
+ * AES256-GCM-SIV (RFC 8452), using AES-NI and PCLMUL.
+ *
+ * POLYVAL works on little-endian blocks, so unlike GHASH, nothing has to be
+ * byte-reverted. Products are aggregated over 8 blocks and reduced once,
+ * using the Montgomery reduction from the AES-GCM-SIV reference code.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aes256gcmsiv.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+#include "private/stats.h"
+#include "randombytes.h"
+#include "runtime.h"
+#include "utils.h"
+
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+
+#ifdef __GNUC__
+#pragma GCC target("ssse3")
+#pragma GCC target("aes")
+#pragma GCC target("pclmul")
+#endif
+
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#define ROUNDS      14
+#define PARBLOCKS   8
+#define CHUNK_BYTES 4096U
+
+typedef struct aes256gcmsiv_keys {
+    __m128i rkeys[ROUNDS + 1];
+    __m128i Hs[PARBLOCKS]; /* H_1 ... H_8, with H_k = dot(H_(k-1), H) */
+} aes256gcmsiv_keys;
+
+static inline void
+aesni_key256_expand(const unsigned char *key, __m128i *const rkeys)
+{
+    __m128i X0, X1, X2, X3;
+    int     i = 0;
+
+    X0         = _mm_loadu_si128((const __m128i *) &key[0]);
+    rkeys[i++] = X0;
+
+    X2         = _mm_loadu_si128((const __m128i *) &key[16]);
+    rkeys[i++] = X2;
+
+#define EXPAND_KEY_1(S)                                                                          \
+    do {                                                                                         \
+        X1 = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(X2, (S)), 0xff);                        \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X0), 0x10)); \
+        X0 = _mm_xor_si128(X0, X3);                                                              \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X0), 0x8c)); \
+        X0 = _mm_xor_si128(_mm_xor_si128(X0, X3), X1);                                           \
+        rkeys[i++] = X0;                                                                         \
+    } while (0)
+
+#define EXPAND_KEY_2(S)                                                                          \
+    do {                                                                                         \
+        X1 = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(X0, (S)), 0xaa);                        \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X2), 0x10)); \
+        X2 = _mm_xor_si128(X2, X3);                                                              \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X2), 0x8c)); \
+        X2 = _mm_xor_si128(_mm_xor_si128(X2, X3), X1);                                           \
+        rkeys[i++] = X2;                                                                         \
+    } while (0)
+
+    X3 = _mm_setzero_si128();
+    EXPAND_KEY_1(0x01);
+    EXPAND_KEY_2(0x01);
+    EXPAND_KEY_1(0x02);
+    EXPAND_KEY_2(0x02);
+    EXPAND_KEY_1(0x04);
+    EXPAND_KEY_2(0x04);
+    EXPAND_KEY_1(0x08);
+    EXPAND_KEY_2(0x08);
+    EXPAND_KEY_1(0x10);
+    EXPAND_KEY_2(0x10);
+    EXPAND_KEY_1(0x20);
+    EXPAND_KEY_2(0x20);
+    EXPAND_KEY_1(0x40);
+
+#undef EXPAND_KEY_1
+#undef EXPAND_KEY_2
+}
+
+static inline __m128i
+aes_encrypt1(__m128i b, const __m128i *const rkeys)
+{
+    int i;
+
+    b = _mm_xor_si128(b, rkeys[0]);
+    for (i = 1; i < ROUNDS; i++) {
+        b = _mm_aesenc_si128(b, rkeys[i]);
+    }
+    return _mm_aesenclast_si128(b, rkeys[ROUNDS]);
+}
+
+/* encrypt n <= PARBLOCKS blocks in parallel, in place */
+static inline void
+aes_encrypt_n(__m128i *const b, const size_t n, const __m128i *const rkeys)
+{
+    size_t i, j;
+
+    for (j = 0; j < n; j++) {
+        b[j] = _mm_xor_si128(b[j], rkeys[0]);
+    }
+    for (i = 1; i < ROUNDS; i++) {
+        for (j = 0; j < n; j++) {
+            b[j] = _mm_aesenc_si128(b[j], rkeys[i]);
+        }
+    }
+    for (j = 0; j < n; j++) {
+        b[j] = _mm_aesenclast_si128(b[j], rkeys[ROUNDS]);
+    }
+}
+
+static inline void
+mulacc(__m128i *lo, __m128i *mid, __m128i *hi, const __m128i H, const __m128i X)
+{
+    *lo  = _mm_xor_si128(*lo, _mm_clmulepi64_si128(H, X, 0x00));
+    *hi  = _mm_xor_si128(*hi, _mm_clmulepi64_si128(H, X, 0x11));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(H, X, 0x01));
+    *mid = _mm_xor_si128(*mid, _mm_clmulepi64_si128(H, X, 0x10));
+}
+
+/* (hi:lo) * x^-128 mod x^128 + x^127 + x^126 + x^121 + 1 */
+static inline __m128i
+reduce(__m128i lo, __m128i mid, __m128i hi)
+{
+    const __m128i poly = _mm_set_epi64x((long long) 0xc200000000000000ULL, 1);
+    __m128i       t;
+
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    t  = _mm_clmulepi64_si128(lo, poly, 0x10);
+    lo = _mm_xor_si128(_mm_shuffle_epi32(lo, 0x4e), t);
+    t  = _mm_clmulepi64_si128(lo, poly, 0x10);
+    lo = _mm_xor_si128(_mm_shuffle_epi32(lo, 0x4e), t);
+
+    return _mm_xor_si128(hi, lo);
+}
+
+static inline __m128i
+dot(const __m128i a, const __m128i b)
+{
+    __m128i lo = _mm_setzero_si128(), mid = lo, hi = lo;
+
+    mulacc(&lo, &mid, &hi, a, b);
+
+    return reduce(lo, mid, hi);
+}
+
+/* absorb len bytes into acc, zero-padding the last block */
+static __m128i
+polyval_update(__m128i acc, const unsigned char *in, unsigned long long len,
+               const __m128i *const Hs)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    __m128i                        lo, mid, hi;
+    size_t                         j;
+
+    for (; len >= PARBLOCKS * 16; len -= PARBLOCKS * 16, in += PARBLOCKS * 16) {
+        lo = mid = hi = _mm_setzero_si128();
+        mulacc(&lo, &mid, &hi, Hs[PARBLOCKS - 1],
+               _mm_xor_si128(acc, _mm_loadu_si128((const __m128i *) (const void *) in)));
+        for (j = 1; j < PARBLOCKS; j++) {
+            mulacc(&lo, &mid, &hi, Hs[PARBLOCKS - 1 - j],
+                   _mm_loadu_si128((const __m128i *) (const void *) (in + 16 * j)));
+        }
+        acc = reduce(lo, mid, hi);
+    }
+    for (; len >= 16; len -= 16, in += 16) {
+        acc = dot(_mm_xor_si128(acc, _mm_loadu_si128((const __m128i *) (const void *) in)),
+                  Hs[0]);
+    }
+    if (len > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, in, (size_t) len);
+        acc = dot(_mm_xor_si128(acc, _mm_load_si128((const __m128i *) (const void *) pad)),
+                  Hs[0]);
+    }
+    return acc;
+}
+
+/* CTR mode with a 32-bit little-endian counter in the first word */
+static void
+aes_ctr(unsigned char *out, const unsigned char *in, unsigned long long len,
+        __m128i *const ctr, const __m128i *const rkeys)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    const __m128i                  one = _mm_set_epi32(0, 0, 0, 1);
+    __m128i                        b[PARBLOCKS];
+    size_t                         j;
+
+    for (; len >= PARBLOCKS * 16; len -= PARBLOCKS * 16, in += PARBLOCKS * 16,
+                                   out += PARBLOCKS * 16) {
+        for (j = 0; j < PARBLOCKS; j++) {
+            b[j] = *ctr;
+            *ctr = _mm_add_epi32(*ctr, one);
+        }
+        aes_encrypt_n(b, PARBLOCKS, rkeys);
+        for (j = 0; j < PARBLOCKS; j++) {
+            _mm_storeu_si128((__m128i *) (void *) (out + 16 * j),
+                             _mm_xor_si128(b[j], _mm_loadu_si128((const __m128i *) (const void *)
+                                                                     (in + 16 * j))));
+        }
+    }
+    for (; len >= 16; len -= 16, in += 16, out += 16) {
+        b[0] = aes_encrypt1(*ctr, rkeys);
+        *ctr = _mm_add_epi32(*ctr, one);
+        _mm_storeu_si128((__m128i *) (void *) out,
+                         _mm_xor_si128(b[0], _mm_loadu_si128((const __m128i *) (const void *) in)));
+    }
+    if (len > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, in, (size_t) len);
+        b[0] = aes_encrypt1(*ctr, rkeys);
+        *ctr = _mm_add_epi32(*ctr, one);
+        _mm_store_si128((__m128i *) (void *) pad,
+                        _mm_xor_si128(b[0], _mm_load_si128((const __m128i *) (const void *) pad)));
+        memcpy(out, pad, (size_t) len);
+    }
+}
+
+/* derive the per-nonce POLYVAL and encryption keys */
+static void
+derive_keys(aes256gcmsiv_keys *const keys, const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) unsigned char enc_key[32];
+    CRYPTO_ALIGN(16) unsigned char nonce_block[16];
+    __m128i                        b[6];
+    __m128i                        H;
+    size_t                         i;
+
+    aesni_key256_expand(k, keys->rkeys);
+    memset(nonce_block, 0, 4);
+    memcpy(nonce_block + 4, npub, crypto_aead_aes256gcmsiv_NPUBBYTES);
+    for (i = 0; i < 6; i++) {
+        nonce_block[0] = (unsigned char) i;
+        b[i] = _mm_load_si128((const __m128i *) (const void *) nonce_block);
+    }
+    aes_encrypt_n(b, 6, keys->rkeys);
+
+    H = _mm_unpacklo_epi64(b[0], b[1]);
+    _mm_store_si128((__m128i *) (void *) enc_key, _mm_unpacklo_epi64(b[2], b[3]));
+    _mm_store_si128((__m128i *) (void *) (enc_key + 16), _mm_unpacklo_epi64(b[4], b[5]));
+    aesni_key256_expand(enc_key, keys->rkeys);
+
+    keys->Hs[0] = H;
+    for (i = 1; i < PARBLOCKS; i++) {
+        keys->Hs[i] = dot(keys->Hs[i - 1], H);
+    }
+    sodium_memzero(enc_key, sizeof enc_key);
+    sodium_memzero(b, sizeof b);
+}
+
+static __m128i
+compute_tag(__m128i acc, const unsigned char *npub, unsigned long long adlen,
+            unsigned long long mlen, const aes256gcmsiv_keys *const keys)
+{
+    CRYPTO_ALIGN(16) unsigned char nonce_block[16];
+    const __m128i                  lengths =
+        _mm_set_epi64x((long long) (mlen * 8U), (long long) (adlen * 8U));
+
+    acc = dot(_mm_xor_si128(acc, lengths), keys->Hs[0]);
+
+    memcpy(nonce_block, npub, crypto_aead_aes256gcmsiv_NPUBBYTES);
+    memset(nonce_block + crypto_aead_aes256gcmsiv_NPUBBYTES, 0,
+           sizeof nonce_block - crypto_aead_aes256gcmsiv_NPUBBYTES);
+    acc = _mm_xor_si128(acc, _mm_load_si128((const __m128i *) (const void *) nonce_block));
+    acc = _mm_and_si128(acc, _mm_set_epi32(0x7fffffff, -1, -1, -1));
+
+    return aes_encrypt1(acc, keys->rkeys);
+}
+
+int
+crypto_aead_aes256gcmsiv_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                          unsigned long long *maclen_p, const unsigned char *m,
+                                          unsigned long long mlen, const unsigned char *ad,
+                                          unsigned long long adlen, const unsigned char *nsec,
+                                          const unsigned char *npub, const unsigned char *k)
+{
+    aes256gcmsiv_keys keys;
+    __m128i           acc;
+    __m128i           tag;
+    __m128i           ctr;
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (maclen_p != NULL) {
+        *maclen_p = 0;
+    }
+    if (mlen > crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    derive_keys(&keys, npub, k);
+
+    acc = polyval_update(_mm_setzero_si128(), ad, adlen, keys.Hs);
+    acc = polyval_update(acc, m, mlen, keys.Hs);
+    tag = compute_tag(acc, npub, adlen, mlen, &keys);
+    _mm_storeu_si128((__m128i *) (void *) mac, tag);
+
+    ctr = _mm_or_si128(tag, _mm_set_epi32((int) 0x80000000, 0, 0, 0));
+    aes_ctr(c, m, mlen, &ctr, keys.rkeys);
+
+    sodium_memzero(&keys, sizeof keys);
+    if (maclen_p != NULL) {
+        *maclen_p = crypto_aead_aes256gcmsiv_ABYTES;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return 0;
+}
+
+int
+crypto_aead_aes256gcmsiv_encrypt(unsigned char *c, unsigned long long *clen_p,
+                                 const unsigned char *m, unsigned long long mlen,
+                                 const unsigned char *ad, unsigned long long adlen,
+                                 const unsigned char *nsec, const unsigned char *npub,
+                                 const unsigned char *k)
+{
+    unsigned long long clen = 0ULL;
+    int                ret;
+
+    if (mlen > crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    ret = crypto_aead_aes256gcmsiv_encrypt_detached(c, c + mlen, NULL, m, mlen, ad, adlen, nsec,
+                                                    npub, k);
+    if (clen_p != NULL) {
+        if (ret == 0) {
+            clen = mlen + crypto_aead_aes256gcmsiv_ABYTES;
+        }
+        *clen_p = clen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcmsiv_decrypt_detached(unsigned char *m, unsigned char *nsec,
+                                          const unsigned char *c, unsigned long long clen,
+                                          const unsigned char *mac, const unsigned char *ad,
+                                          unsigned long long adlen, const unsigned char *npub,
+                                          const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[crypto_aead_aes256gcmsiv_ABYTES];
+    aes256gcmsiv_keys              keys;
+    __m128i                        acc;
+    __m128i                        ctr;
+    unsigned long long             i;
+    unsigned long long             n;
+    int                            ret;
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (clen > crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    if (m == NULL && clen > 0U) {
+        errno = EINVAL;
+        return -1;
+    }
+    derive_keys(&keys, npub, k);
+
+    ctr = _mm_or_si128(_mm_loadu_si128((const __m128i *) (const void *) mac),
+                       _mm_set_epi32((int) 0x80000000, 0, 0, 0));
+    acc = polyval_update(_mm_setzero_si128(), ad, adlen, keys.Hs);
+
+    /* the plaintext is authenticated while it is still in the cache */
+    for (i = 0U; i < clen; i += n) {
+        n = clen - i;
+        if (n > CHUNK_BYTES) {
+            n = CHUNK_BYTES;
+        }
+        aes_ctr(m + i, c + i, n, &ctr, keys.rkeys);
+        acc = polyval_update(acc, m + i, n, keys.Hs);
+    }
+    _mm_store_si128((__m128i *) (void *) computed_mac,
+                    compute_tag(acc, npub, adlen, clen, &keys));
+    sodium_memzero(&keys, sizeof keys);
+
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (ret != 0 && m != NULL) {
+        memset(m, 0, clen);
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+
+    return ret;
+}
+
+int
+crypto_aead_aes256gcmsiv_decrypt(unsigned char *m, unsigned long long *mlen_p,
+                                 unsigned char *nsec, const unsigned char *c,
+                                 unsigned long long clen, const unsigned char *ad,
+                                 unsigned long long adlen, const unsigned char *npub,
+                                 const unsigned char *k)
+{
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+
+    if (clen >= crypto_aead_aes256gcmsiv_ABYTES) {
+        ret = crypto_aead_aes256gcmsiv_decrypt_detached(
+            m, nsec, c, clen - crypto_aead_aes256gcmsiv_ABYTES,
+            c + clen - crypto_aead_aes256gcmsiv_ABYTES, ad, adlen, npub, k);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_aes256gcmsiv_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcmsiv_is_available(void)
+{
+    return sodium_runtime_has_pclmul() & sodium_runtime_has_aesni();
+}
+
+#elif !(defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN))
+
+#ifndef ENOSYS
+#define ENOSYS ENXIO
+#endif
+
+int
+crypto_aead_aes256gcmsiv_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                          unsigned long long *maclen_p, const unsigned char *m,
+                                          unsigned long long mlen, const unsigned char *ad,
+                                          unsigned long long adlen, const unsigned char *nsec,
+                                          const unsigned char *npub, const unsigned char *k)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int
+crypto_aead_aes256gcmsiv_encrypt(unsigned char *c, unsigned long long *clen_p,
+                                 const unsigned char *m, unsigned long long mlen,
+                                 const unsigned char *ad, unsigned long long adlen,
+                                 const unsigned char *nsec, const unsigned char *npub,
+                                 const unsigned char *k)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int
+crypto_aead_aes256gcmsiv_decrypt_detached(unsigned char *m, unsigned char *nsec,
+                                          const unsigned char *c, unsigned long long clen,
+                                          const unsigned char *mac, const unsigned char *ad,
+                                          unsigned long long adlen, const unsigned char *npub,
+                                          const unsigned char *k)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int
+crypto_aead_aes256gcmsiv_decrypt(unsigned char *m, unsigned long long *mlen_p,
+                                 unsigned char *nsec, const unsigned char *c,
+                                 unsigned long long clen, const unsigned char *ad,
+                                 unsigned long long adlen, const unsigned char *npub,
+                                 const unsigned char *k)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int
+crypto_aead_aes256gcmsiv_is_available(void)
+{
+    return 0;
+}
+
+#endif
+
+size_t
+crypto_aead_aes256gcmsiv_keybytes(void)
+{
+    return crypto_aead_aes256gcmsiv_KEYBYTES;
+}
+
+size_t
+crypto_aead_aes256gcmsiv_nsecbytes(void)
+{
+    return crypto_aead_aes256gcmsiv_NSECBYTES;
+}
+
+size_t
+crypto_aead_aes256gcmsiv_npubbytes(void)
+{
+    return crypto_aead_aes256gcmsiv_NPUBBYTES;
+}
+
+size_t
+crypto_aead_aes256gcmsiv_abytes(void)
+{
+    return crypto_aead_aes256gcmsiv_ABYTES;
+}
+
+size_t
+crypto_aead_aes256gcmsiv_messagebytes_max(void)
+{
+    return crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX;
+}
+
+void
+crypto_aead_aes256gcmsiv_keygen(unsigned char k[crypto_aead_aes256gcmsiv_KEYBYTES])
+{
+    randombytes_buf(k, crypto_aead_aes256gcmsiv_KEYBYTES);
+}
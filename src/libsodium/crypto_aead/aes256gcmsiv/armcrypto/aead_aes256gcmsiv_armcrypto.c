@@ -0,0 +1,425 @@
+/*
+ * AES256-GCM-SIV (RFC 8452), using the ARMv8 Crypto Extensions.
+ * POLYVAL is computed with PMULL over little-endian blocks, aggregated over
+ * 8 blocks with a single Montgomery reduction, as in the AES-NI code.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aes256gcmsiv.h"
+#include "crypto_verify_16.h"
+#include "export.h"
+#include "private/common.h"
+#include "private/stats.h"
+#include "randombytes.h"
+#include "runtime.h"
+#include "utils.h"
+
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <arm_neon.h>
+
+# define ROUNDS      14
+# define PARBLOCKS   8
+# define CHUNK_BYTES 4096U
+
+typedef struct aes256gcmsiv_keys {
+    uint8x16_t rkeys[ROUNDS + 1];
+    uint64x2_t Hs[PARBLOCKS]; /* H_1 ... H_8, with H_k = dot(H_(k-1), H) */
+} aes256gcmsiv_keys;
+
+static inline uint32_t
+aes_subword(const uint32_t w)
+{
+    uint8x16_t v;
+
+    /* ShiftRows is a no-op when all the columns are identical */
+    v = vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(w)), vmovq_n_u8(0));
+
+    return vgetq_lane_u32(vreinterpretq_u32_u8(v), 0);
+}
+
+static void
+aes256_key_expand(uint8x16_t *const rkeys, const unsigned char *key)
+{
+    uint32_t w[4 * (ROUNDS + 1)];
+    uint32_t rcon = 0x01;
+    uint32_t t;
+    size_t   i;
+
+    for (i = 0; i < 8; i++) {
+        w[i] = LOAD32_LE(key + 4 * i);
+    }
+    for (i = 8; i < 4 * (ROUNDS + 1); i++) {
+        t = w[i - 1];
+        if ((i & 7) == 0) {
+            t = ROTR32(aes_subword(t), 8) ^ rcon;
+            rcon <<= 1;
+        } else if ((i & 7) == 4) {
+            t = aes_subword(t);
+        }
+        w[i] = w[i - 8] ^ t;
+    }
+    for (i = 0; i < ROUNDS + 1; i++) {
+        rkeys[i] = vld1q_u8((const uint8_t *) (const void *) &w[4 * i]);
+    }
+    sodium_memzero(w, sizeof w);
+}
+
+static inline uint8x16_t
+aes_encrypt1(uint8x16_t b, const uint8x16_t *const rkeys)
+{
+    int i;
+
+    for (i = 0; i < ROUNDS - 1; i++) {
+        b = vaesmcq_u8(vaeseq_u8(b, rkeys[i]));
+    }
+    return veorq_u8(vaeseq_u8(b, rkeys[ROUNDS - 1]), rkeys[ROUNDS]);
+}
+
+static inline uint64x2_t
+clmul_lo(const uint64x2_t a, const uint64x2_t b)
+{
+    return vreinterpretq_u64_p128(vmull_p64((poly64_t) vgetq_lane_u64(a, 0),
+                                            (poly64_t) vgetq_lane_u64(b, 0)));
+}
+
+static inline uint64x2_t
+clmul_hi(const uint64x2_t a, const uint64x2_t b)
+{
+    return vreinterpretq_u64_p128(vmull_high_p64(vreinterpretq_p64_u64(a),
+                                                 vreinterpretq_p64_u64(b)));
+}
+
+# define MUL_ACC(H, X)                                          \
+    do {                                                        \
+        const uint64x2_t Xs_ = vextq_u64((X), (X), 1);          \
+        lo  = veorq_u64(lo, clmul_lo((H), (X)));                \
+        hi  = veorq_u64(hi, clmul_hi((H), (X)));                \
+        mid = veorq_u64(mid, clmul_lo((H), Xs_));               \
+        mid = veorq_u64(mid, clmul_hi((H), Xs_));               \
+    } while (0)
+
+/* (hi:lo) * x^-128 mod x^128 + x^127 + x^126 + x^121 + 1 */
+static inline uint64x2_t
+reduce(uint64x2_t lo, const uint64x2_t mid, uint64x2_t hi)
+{
+    const uint64x2_t zero = vdupq_n_u64(0);
+    const uint64x2_t poly = vdupq_n_u64(0xc200000000000000ULL);
+    uint64x2_t       t;
+
+    lo = veorq_u64(lo, vextq_u64(zero, mid, 1));
+    hi = veorq_u64(hi, vextq_u64(mid, zero, 1));
+
+    t  = clmul_lo(lo, poly);
+    lo = veorq_u64(vextq_u64(lo, lo, 1), t);
+    t  = clmul_lo(lo, poly);
+    lo = veorq_u64(vextq_u64(lo, lo, 1), t);
+
+    return veorq_u64(hi, lo);
+}
+
+static inline uint64x2_t
+dot(const uint64x2_t a, const uint64x2_t b)
+{
+    const uint64x2_t zero = vdupq_n_u64(0);
+    uint64x2_t       lo = zero, hi = zero, mid = zero;
+
+    MUL_ACC(a, b);
+
+    return reduce(lo, mid, hi);
+}
+
+static inline uint64x2_t
+load_block(const unsigned char *in)
+{
+    return vreinterpretq_u64_u8(vld1q_u8(in));
+}
+
+/* absorb len bytes into acc, zero-padding the last block */
+static uint64x2_t
+polyval_update(uint64x2_t acc, const unsigned char *in, unsigned long long len,
+               const uint64x2_t *const Hs)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    const uint64x2_t               zero = vdupq_n_u64(0);
+    uint64x2_t                     lo, mid, hi;
+    uint64x2_t                     X;
+    size_t                         j;
+
+    for (; len >= PARBLOCKS * 16; len -= PARBLOCKS * 16, in += PARBLOCKS * 16) {
+        lo = mid = hi = zero;
+        X = veorq_u64(acc, load_block(in));
+        MUL_ACC(Hs[PARBLOCKS - 1], X);
+        for (j = 1; j < PARBLOCKS; j++) {
+            X = load_block(in + 16 * j);
+            MUL_ACC(Hs[PARBLOCKS - 1 - j], X);
+        }
+        acc = reduce(lo, mid, hi);
+    }
+    for (; len >= 16; len -= 16, in += 16) {
+        acc = dot(veorq_u64(acc, load_block(in)), Hs[0]);
+    }
+    if (len > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, in, (size_t) len);
+        acc = dot(veorq_u64(acc, load_block(pad)), Hs[0]);
+    }
+    return acc;
+}
+
+# define ROUNDx(a) b##a = vaesmcq_u8(vaeseq_u8(b##a, rk))
+# define LASTx(a)  b##a = veorq_u8(vaeseq_u8(b##a, rkeys[ROUNDS - 1]), rkeys[ROUNDS])
+# define CTRx(a)                              \
+    b##a = vreinterpretq_u8_u32(*ctr);        \
+    *ctr = vaddq_u32(*ctr, one)
+# define XORx(a) vst1q_u8(out + 16 * a, veorq_u8(b##a, vld1q_u8(in + 16 * a)))
+
+# define MAKE8(X) \
+    X(0);         \
+    X(1);         \
+    X(2);         \
+    X(3);         \
+    X(4);         \
+    X(5);         \
+    X(6);         \
+    X(7)
+
+/* CTR mode with a 32-bit little-endian counter in the first word */
+static void
+aes_ctr(unsigned char *out, const unsigned char *in, unsigned long long len,
+        uint32x4_t *const ctr, const uint8x16_t *const rkeys)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    const uint32x4_t               one = vsetq_lane_u32(1, vdupq_n_u32(0), 0);
+    uint8x16_t                     b0, b1, b2, b3, b4, b5, b6, b7;
+    uint8x16_t                     rk;
+    int                            i;
+
+    for (; len >= PARBLOCKS * 16; len -= PARBLOCKS * 16, in += PARBLOCKS * 16,
+                                   out += PARBLOCKS * 16) {
+        MAKE8(CTRx);
+        for (i = 0; i < ROUNDS - 1; i++) {
+            rk = rkeys[i];
+            MAKE8(ROUNDx);
+        }
+        MAKE8(LASTx);
+        MAKE8(XORx);
+    }
+    for (; len >= 16; len -= 16, in += 16, out += 16) {
+        CTRx(0);
+        b0 = aes_encrypt1(b0, rkeys);
+        XORx(0);
+    }
+    if (len > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, in, (size_t) len);
+        CTRx(0);
+        b0 = aes_encrypt1(b0, rkeys);
+        vst1q_u8(pad, veorq_u8(b0, vld1q_u8(pad)));
+        memcpy(out, pad, (size_t) len);
+    }
+}
+
+/* derive the per-nonce POLYVAL and encryption keys */
+static void
+derive_keys(aes256gcmsiv_keys *const keys, const unsigned char *npub, const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) unsigned char nonce_block[16];
+    CRYPTO_ALIGN(16) unsigned char derived[48];
+    uint64x2_t                     H;
+    size_t                         i;
+
+    aes256_key_expand(keys->rkeys, k);
+    memset(nonce_block, 0, 4);
+    memcpy(nonce_block + 4, npub, crypto_aead_aes256gcmsiv_NPUBBYTES);
+    for (i = 0; i < 6; i++) {
+        nonce_block[0] = (unsigned char) i;
+        vst1_u8(derived + 8 * i,
+                vget_low_u8(aes_encrypt1(vld1q_u8(nonce_block), keys->rkeys)));
+    }
+    H = load_block(derived);
+    aes256_key_expand(keys->rkeys, derived + 16);
+
+    keys->Hs[0] = H;
+    for (i = 1; i < PARBLOCKS; i++) {
+        keys->Hs[i] = dot(keys->Hs[i - 1], H);
+    }
+    sodium_memzero(derived, sizeof derived);
+}
+
+static uint8x16_t
+compute_tag(uint64x2_t acc, const unsigned char *npub, unsigned long long adlen,
+            unsigned long long mlen, const aes256gcmsiv_keys *const keys)
+{
+    CRYPTO_ALIGN(16) unsigned char nonce_block[16];
+    const uint64x2_t               lengths =
+        vcombine_u64(vcreate_u64((uint64_t) adlen * 8U), vcreate_u64((uint64_t) mlen * 8U));
+    uint8x16_t                     S;
+
+    acc = dot(veorq_u64(acc, lengths), keys->Hs[0]);
+
+    memcpy(nonce_block, npub, crypto_aead_aes256gcmsiv_NPUBBYTES);
+    memset(nonce_block + crypto_aead_aes256gcmsiv_NPUBBYTES, 0,
+           sizeof nonce_block - crypto_aead_aes256gcmsiv_NPUBBYTES);
+    S = veorq_u8(vreinterpretq_u8_u64(acc), vld1q_u8(nonce_block));
+    S = vsetq_lane_u8(vgetq_lane_u8(S, 15) & 0x7f, S, 15);
+
+    return aes_encrypt1(S, keys->rkeys);
+}
+
+static inline uint32x4_t
+initial_counter(const uint8x16_t tag)
+{
+    return vreinterpretq_u32_u8(vsetq_lane_u8(vgetq_lane_u8(tag, 15) | 0x80, tag, 15));
+}
+
+int
+crypto_aead_aes256gcmsiv_encrypt_detached(unsigned char *c, unsigned char *mac,
+                                          unsigned long long *maclen_p, const unsigned char *m,
+                                          unsigned long long mlen, const unsigned char *ad,
+                                          unsigned long long adlen, const unsigned char *nsec,
+                                          const unsigned char *npub, const unsigned char *k)
+{
+    aes256gcmsiv_keys keys;
+    uint64x2_t        acc;
+    uint8x16_t        tag;
+    uint32x4_t        ctr;
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (maclen_p != NULL) {
+        *maclen_p = 0;
+    }
+    if (mlen > crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    derive_keys(&keys, npub, k);
+
+    acc = polyval_update(vdupq_n_u64(0), ad, adlen, keys.Hs);
+    acc = polyval_update(acc, m, mlen, keys.Hs);
+    tag = compute_tag(acc, npub, adlen, mlen, &keys);
+    vst1q_u8(mac, tag);
+
+    ctr = initial_counter(tag);
+    aes_ctr(c, m, mlen, &ctr, keys.rkeys);
+
+    sodium_memzero(&keys, sizeof keys);
+    if (maclen_p != NULL) {
+        *maclen_p = crypto_aead_aes256gcmsiv_ABYTES;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return 0;
+}
+
+int
+crypto_aead_aes256gcmsiv_encrypt(unsigned char *c, unsigned long long *clen_p,
+                                 const unsigned char *m, unsigned long long mlen,
+                                 const unsigned char *ad, unsigned long long adlen,
+                                 const unsigned char *nsec, const unsigned char *npub,
+                                 const unsigned char *k)
+{
+    unsigned long long clen = 0ULL;
+    int                ret;
+
+    if (mlen > crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    ret = crypto_aead_aes256gcmsiv_encrypt_detached(c, c + mlen, NULL, m, mlen, ad, adlen, nsec,
+                                                    npub, k);
+    if (clen_p != NULL) {
+        if (ret == 0) {
+            clen = mlen + crypto_aead_aes256gcmsiv_ABYTES;
+        }
+        *clen_p = clen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcmsiv_decrypt_detached(unsigned char *m, unsigned char *nsec,
+                                          const unsigned char *c, unsigned long long clen,
+                                          const unsigned char *mac, const unsigned char *ad,
+                                          unsigned long long adlen, const unsigned char *npub,
+                                          const unsigned char *k)
+{
+    CRYPTO_ALIGN(16) unsigned char computed_mac[crypto_aead_aes256gcmsiv_ABYTES];
+    aes256gcmsiv_keys              keys;
+    uint64x2_t                     acc;
+    uint32x4_t                     ctr;
+    unsigned long long             i;
+    unsigned long long             n;
+    int                            ret;
+    SODIUM_STATS_START(stats_start)
+
+    (void) nsec;
+    if (clen > crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    if (m == NULL && clen > 0U) {
+        errno = EINVAL;
+        return -1;
+    }
+    derive_keys(&keys, npub, k);
+
+    ctr = initial_counter(vld1q_u8(mac));
+    acc = polyval_update(vdupq_n_u64(0), ad, adlen, keys.Hs);
+
+    /* the plaintext is authenticated while it is still in the cache */
+    for (i = 0U; i < clen; i += n) {
+        n = clen - i;
+        if (n > CHUNK_BYTES) {
+            n = CHUNK_BYTES;
+        }
+        aes_ctr(m + i, c + i, n, &ctr, keys.rkeys);
+        acc = polyval_update(acc, m + i, n, keys.Hs);
+    }
+    vst1q_u8(computed_mac, compute_tag(acc, npub, adlen, clen, &keys));
+    sodium_memzero(&keys, sizeof keys);
+
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (ret != 0 && m != NULL) {
+        memset(m, 0, clen);
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+
+    return ret;
+}
+
+int
+crypto_aead_aes256gcmsiv_decrypt(unsigned char *m, unsigned long long *mlen_p,
+                                 unsigned char *nsec, const unsigned char *c,
+                                 unsigned long long clen, const unsigned char *ad,
+                                 unsigned long long adlen, const unsigned char *npub,
+                                 const unsigned char *k)
+{
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+
+    if (clen >= crypto_aead_aes256gcmsiv_ABYTES) {
+        ret = crypto_aead_aes256gcmsiv_decrypt_detached(
+            m, nsec, c, clen - crypto_aead_aes256gcmsiv_ABYTES,
+            c + clen - crypto_aead_aes256gcmsiv_ABYTES, ad, adlen, npub, k);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_aes256gcmsiv_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_aes256gcmsiv_is_available(void)
+{
+    return sodium_runtime_has_armcrypto();
+}
+
+#endif
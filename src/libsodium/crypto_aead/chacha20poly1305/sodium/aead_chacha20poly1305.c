@@ -1,4 +1,6 @@
 
+#include <errno.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -9,14 +11,89 @@
 #include "crypto_onetimeauth_poly1305.h"
 #include "crypto_stream_chacha20.h"
 #include "crypto_verify_16.h"
+#include "crypto_verify_32.h"
 #include "randombytes.h"
 #include "utils.h"
 
+#include "private/aead_iov.h"
+#include "private/aliases.h"
 #include "private/chacha20_ietf_ext.h"
+#include "private/chacha20poly1305_lanes.h"
 #include "private/common.h"
+#include "private/offload.h"
+#include "private/stats.h"
+
+SODIUM_ALIAS_PROTO(crypto_onetimeauth_poly1305_init);
+SODIUM_ALIAS_PROTO(crypto_onetimeauth_poly1305_update);
+SODIUM_ALIAS_PROTO(crypto_onetimeauth_poly1305_final);
+SODIUM_ALIAS_PROTO(crypto_stream_chacha20);
+SODIUM_ALIAS_PROTO(crypto_stream_chacha20_xor_ic);
+SODIUM_ALIAS_PROTO(crypto_stream_chacha20_ietf);
+SODIUM_ALIAS_PROTO(crypto_stream_chacha20_ietf_xor_ic);
+SODIUM_ALIAS_PROTO(crypto_verify_16);
+SODIUM_ALIAS_PROTO(crypto_verify_32);
+
+#define ENCRYPT_AND_MAC_CHUNK_BYTES 16384U
 
 static const unsigned char _pad0[16] = { 0 };
 
+/*
+ * Encrypt and authenticate in cache-sized chunks, so that Poly1305 reads
+ * each chunk of ciphertext while it is still in L1.
+ */
+
+static void
+_encrypt_and_mac(crypto_onetimeauth_poly1305_state *state,
+                 unsigned char *c, const unsigned char *m,
+                 unsigned long long mlen, const unsigned char *n,
+                 uint64_t ic, const unsigned char *k)
+{
+    unsigned long long chunk_len;
+
+    COMPILER_ASSERT(ENCRYPT_AND_MAC_CHUNK_BYTES % 64U == 0U);
+    while (mlen > 0U) {
+        chunk_len = mlen;
+        if (chunk_len > ENCRYPT_AND_MAC_CHUNK_BYTES) {
+            chunk_len = ENCRYPT_AND_MAC_CHUNK_BYTES;
+        }
+        crypto_stream_chacha20_xor_ic(c, m, chunk_len, n, ic, k);
+        crypto_onetimeauth_poly1305_update(state, c, chunk_len);
+        ic += (uint64_t) (ENCRYPT_AND_MAC_CHUNK_BYTES / 64U);
+        c += chunk_len;
+        m += chunk_len;
+        mlen -= chunk_len;
+    }
+}
+
+/*
+ * Messages that would need the 32-bit block counter to wrap are left to a
+ * single call, so that overflow is still detected there.
+ */
+
+static void
+_encrypt_and_mac_ietf(crypto_onetimeauth_poly1305_state *state,
+                      unsigned char *c, const unsigned char *m,
+                      unsigned long long mlen, const unsigned char *n,
+                      uint32_t ic, const unsigned char *k)
+{
+    unsigned long long chunk_len;
+
+    COMPILER_ASSERT(ENCRYPT_AND_MAC_CHUNK_BYTES % 64U == 0U);
+    while (mlen > 0U) {
+        chunk_len = mlen;
+        if (chunk_len > ENCRYPT_AND_MAC_CHUNK_BYTES &&
+            ic <= UINT32_MAX - ENCRYPT_AND_MAC_CHUNK_BYTES / 64U) {
+            chunk_len = ENCRYPT_AND_MAC_CHUNK_BYTES;
+        }
+        crypto_stream_chacha20_ietf_xor_ic(c, m, chunk_len, n, ic, k);
+        crypto_onetimeauth_poly1305_update(state, c, chunk_len);
+        ic += (uint32_t) (ENCRYPT_AND_MAC_CHUNK_BYTES / 64U);
+        c += chunk_len;
+        m += chunk_len;
+        mlen -= chunk_len;
+    }
+}
+
 int
 crypto_aead_chacha20poly1305_encrypt_detached(unsigned char *c,
                                               unsigned char *mac,
@@ -32,6 +109,7 @@ crypto_aead_chacha20poly1305_encrypt_detached(unsigned char *c,
     crypto_onetimeauth_poly1305_state state;
     unsigned char                     block0[64U];
     unsigned char                     slen[8U];
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
     crypto_stream_chacha20(block0, sizeof block0, npub, k);
@@ -42,9 +120,7 @@ crypto_aead_chacha20poly1305_encrypt_detached(unsigned char *c,
     STORE64_LE(slen, (uint64_t) adlen);
     crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
 
-    crypto_stream_chacha20_xor_ic(c, m, mlen, npub, 1U, k);
-
-    crypto_onetimeauth_poly1305_update(&state, c, mlen);
+    _encrypt_and_mac(&state, c, m, mlen, npub, 1U, k);
     STORE64_LE(slen, (uint64_t) mlen);
     crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
 
@@ -54,6 +130,8 @@ crypto_aead_chacha20poly1305_encrypt_detached(unsigned char *c,
     if (maclen_p != NULL) {
         *maclen_p = crypto_aead_chacha20poly1305_ABYTES;
     }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
     return 0;
 }
 
@@ -103,8 +181,17 @@ crypto_aead_chacha20poly1305_ietf_encrypt_detached(unsigned char *c,
     crypto_onetimeauth_poly1305_state state;
     unsigned char                     block0[64U];
     unsigned char                     slen[8U];
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
+    if (_sodium_offload_aead_encrypt(SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF,
+                                     c, mac, m, mlen, ad, adlen, npub, k) == 0) {
+        if (maclen_p != NULL) {
+            *maclen_p = crypto_aead_chacha20poly1305_ietf_ABYTES;
+        }
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+        return 0;
+    }
     crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
     crypto_onetimeauth_poly1305_init(&state, block0);
     sodium_memzero(block0, sizeof block0);
@@ -112,9 +199,7 @@ crypto_aead_chacha20poly1305_ietf_encrypt_detached(unsigned char *c,
     crypto_onetimeauth_poly1305_update(&state, ad, adlen);
     crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
 
-    crypto_stream_chacha20_ietf_xor_ic(c, m, mlen, npub, 1U, k);
-
-    crypto_onetimeauth_poly1305_update(&state, c, mlen);
+    _encrypt_and_mac_ietf(&state, c, m, mlen, npub, 1U, k);
     crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
 
     STORE64_LE(slen, (uint64_t) adlen);
@@ -129,6 +214,8 @@ crypto_aead_chacha20poly1305_ietf_encrypt_detached(unsigned char *c,
     if (maclen_p != NULL) {
         *maclen_p = crypto_aead_chacha20poly1305_ietf_ABYTES;
     }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
     return 0;
 }
 
@@ -180,6 +267,7 @@ crypto_aead_chacha20poly1305_decrypt_detached(unsigned char *m,
     unsigned char                     computed_mac[crypto_aead_chacha20poly1305_ABYTES];
     unsigned long long                mlen;
     int                               ret;
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
     crypto_stream_chacha20(block0, sizeof block0, npub, k);
@@ -202,13 +290,16 @@ crypto_aead_chacha20poly1305_decrypt_detached(unsigned char *m,
     ret = crypto_verify_16(computed_mac, mac);
     sodium_memzero(computed_mac, sizeof computed_mac);
     if (m == NULL) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
         return ret;
     }
     if (ret != 0) {
         memset(m, 0, mlen);
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
         return -1;
     }
     crypto_stream_chacha20_xor_ic(m, c, mlen, npub, 1U, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
 
     return 0;
 }
@@ -260,8 +351,15 @@ crypto_aead_chacha20poly1305_ietf_decrypt_detached(unsigned char *m,
     unsigned char                     computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
     unsigned long long                mlen;
     int                               ret;
+    SODIUM_STATS_START(stats_start)
 
     (void) nsec;
+    ret = _sodium_offload_aead_decrypt(SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF,
+                                       m, c, clen, mac, ad, adlen, npub, k);
+    if (ret != SODIUM_OFFLOAD_DECLINED) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+        return ret;
+    }
     crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
     crypto_onetimeauth_poly1305_init(&state, block0);
     sodium_memzero(block0, sizeof block0);
@@ -286,13 +384,16 @@ crypto_aead_chacha20poly1305_ietf_decrypt_detached(unsigned char *m,
     ret = crypto_verify_16(computed_mac, mac);
     sodium_memzero(computed_mac, sizeof computed_mac);
     if (m == NULL) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
         return ret;
     }
     if (ret != 0) {
         memset(m, 0, mlen);
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
         return -1;
     }
     crypto_stream_chacha20_ietf_xor_ic(m, c, mlen, npub, 1U, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
 
     return 0;
 }
@@ -327,6 +428,900 @@ crypto_aead_chacha20poly1305_ietf_decrypt(unsigned char *m,
     return ret;
 }
 
+/*
+ * Only the first half of the first keystream block is used as the Poly1305
+ * key. The second half commits to the key and nonce: a ciphertext that
+ * comes with it can only be decrypted with the key used to create it.
+ */
+static void
+_commitment_ietf(unsigned char commitment[crypto_aead_chacha20poly1305_ietf_COMMITBYTES],
+                 const unsigned char *npub, const unsigned char *k)
+{
+    unsigned char block0[64U];
+
+    COMPILER_ASSERT(crypto_aead_chacha20poly1305_ietf_COMMITBYTES <=
+                    sizeof block0 - crypto_onetimeauth_poly1305_KEYBYTES);
+    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    memcpy(commitment, block0 + crypto_onetimeauth_poly1305_KEYBYTES,
+           crypto_aead_chacha20poly1305_ietf_COMMITBYTES);
+    sodium_memzero(block0, sizeof block0);
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_encrypt_commit(unsigned char *c,
+                                                 unsigned long long *clen_p,
+                                                 const unsigned char *m,
+                                                 unsigned long long mlen,
+                                                 const unsigned char *ad,
+                                                 unsigned long long adlen,
+                                                 const unsigned char *nsec,
+                                                 const unsigned char *npub,
+                                                 const unsigned char *k)
+{
+    unsigned long long clen = 0ULL;
+    int                ret;
+
+    if (mlen > crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX -
+                   crypto_aead_chacha20poly1305_ietf_COMMITBYTES) {
+        sodium_misuse();
+    }
+    ret = crypto_aead_chacha20poly1305_ietf_encrypt_detached(c,
+                                                             c + mlen, NULL,
+                                                             m, mlen,
+                                                             ad, adlen,
+                                                             nsec, npub, k);
+    _commitment_ietf(c + mlen + crypto_aead_chacha20poly1305_ietf_ABYTES,
+                     npub, k);
+    if (clen_p != NULL) {
+        if (ret == 0) {
+            clen = mlen + crypto_aead_chacha20poly1305_ietf_ABYTES +
+                   crypto_aead_chacha20poly1305_ietf_COMMITBYTES;
+        }
+        *clen_p = clen;
+    }
+    return ret;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_decrypt_commit(unsigned char *m,
+                                                 unsigned long long *mlen_p,
+                                                 unsigned char *nsec,
+                                                 const unsigned char *c,
+                                                 unsigned long long clen,
+                                                 const unsigned char *ad,
+                                                 unsigned long long adlen,
+                                                 const unsigned char *npub,
+                                                 const unsigned char *k)
+{
+    unsigned char      commitment[crypto_aead_chacha20poly1305_ietf_COMMITBYTES];
+    unsigned long long mlen = 0ULL;
+    int                ret = -1;
+
+    if (clen >= crypto_aead_chacha20poly1305_ietf_ABYTES +
+                    crypto_aead_chacha20poly1305_ietf_COMMITBYTES) {
+        mlen = clen - crypto_aead_chacha20poly1305_ietf_ABYTES -
+               crypto_aead_chacha20poly1305_ietf_COMMITBYTES;
+        _commitment_ietf(commitment, npub, k);
+        if (crypto_verify_32(commitment, c + mlen +
+                             crypto_aead_chacha20poly1305_ietf_ABYTES) == 0) {
+            ret = crypto_aead_chacha20poly1305_ietf_decrypt_detached
+                (m, nsec, c, mlen, c + mlen, ad, adlen, npub, k);
+        }
+        sodium_memzero(commitment, sizeof commitment);
+    }
+    if (mlen_p != NULL) {
+        if (ret != 0) {
+            mlen = 0ULL;
+        }
+        *mlen_p = mlen;
+    }
+    return ret;
+}
+
+static void
+_xor_and_mac(crypto_onetimeauth_poly1305_state *state,
+             unsigned char *c, const unsigned char *m,
+             unsigned long long mlen, const unsigned char *n,
+             uint64_t ic, const unsigned char *k, int ietf)
+{
+    if (state != NULL) {
+        if (ietf) {
+            _encrypt_and_mac_ietf(state, c, m, mlen, n, (uint32_t) ic, k);
+        } else {
+            _encrypt_and_mac(state, c, m, mlen, n, ic, k);
+        }
+    } else if (ietf) {
+        crypto_stream_chacha20_ietf_xor_ic(c, m, mlen, n, (uint32_t) ic, k);
+    } else {
+        crypto_stream_chacha20_xor_ic(c, m, mlen, n, ic, k);
+    }
+}
+
+/*
+ * Encrypt (and authenticate, if state is not NULL) a scattered buffer.
+ * Runs of whole blocks that are contiguous in both the input and the
+ * output are processed in place; blocks straddling fragments go through
+ * a bounce buffer.
+ */
+
+static void
+_xor_iov(crypto_onetimeauth_poly1305_state *state,
+         const crypto_aead_iovec *out_iov, size_t out_count,
+         const crypto_aead_iovec *in_iov, size_t in_count,
+         unsigned long long len, const unsigned char *n,
+         uint64_t ic, const unsigned char *k, int ietf)
+{
+    aead_iov_cursor      out;
+    aead_iov_cursor      in;
+    unsigned char        src[64U];
+    unsigned char        dst[64U];
+    unsigned char       *out_p;
+    const unsigned char *in_p;
+    size_t               run;
+
+    aead_iov_cursor_init(&out, out_iov, out_count);
+    aead_iov_cursor_init(&in, in_iov, in_count);
+    while (len > 0U) {
+        run = aead_iov_cursor_run(&out, &in, 64U);
+        if (run > 0U) {
+            out_p = aead_iov_cursor_ptr(&out);
+            in_p  = aead_iov_cursor_ptr(&in);
+        } else {
+            run = len < 64U ? (size_t) len : 64U;
+            aead_iov_cursor_gather(&in, src, run);
+            out_p = dst;
+            in_p  = src;
+        }
+        _xor_and_mac(state, out_p, in_p, run, n, ic, k, ietf);
+        if (out_p == dst) {
+            aead_iov_cursor_scatter(&out, dst, run);
+        } else {
+            aead_iov_cursor_advance(&out, run);
+            aead_iov_cursor_advance(&in, run);
+        }
+        ic += (uint64_t) (run / 64U);
+        len -= run;
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
+
+static void
+_mac_iov(crypto_onetimeauth_poly1305_state *state,
+         const crypto_aead_iovec *iov, size_t count)
+{
+    size_t i;
+
+    for (i = 0U; i < count; i++) {
+        crypto_onetimeauth_poly1305_update(state, (const unsigned char *) iov[i].ptr,
+                                           (unsigned long long) iov[i].len);
+    }
+}
+
+static int
+_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                      unsigned char *mac,
+                      const crypto_aead_iovec *m, size_t m_count,
+                      const crypto_aead_iovec *ad, size_t ad_count,
+                      const unsigned char *npub,
+                      const unsigned char *k, int ietf)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     block0[64U];
+    unsigned char                     slen[8U];
+    unsigned long long                adlen;
+    unsigned long long                mlen;
+    unsigned long long                clen;
+
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&mlen, m, m_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 || clen != mlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((ietf && mlen > crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX) ||
+        (!ietf && mlen > crypto_aead_chacha20poly1305_MESSAGEBYTES_MAX)) {
+        sodium_misuse();
+    }
+    if (ietf) {
+        crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    } else {
+        crypto_stream_chacha20(block0, sizeof block0, npub, k);
+    }
+    crypto_onetimeauth_poly1305_init(&state, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    _mac_iov(&state, ad, ad_count);
+    if (ietf) {
+        crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+    } else {
+        STORE64_LE(slen, (uint64_t) adlen);
+        crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+    }
+
+    _xor_iov(&state, c, c_count, m, m_count, mlen, npub, 1U, k, ietf);
+
+    if (ietf) {
+        crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+        STORE64_LE(slen, (uint64_t) adlen);
+        crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+    }
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, mac);
+    sodium_memzero(&state, sizeof state);
+
+    return 0;
+}
+
+static int
+_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                      const crypto_aead_iovec *c, size_t c_count,
+                      const unsigned char *mac,
+                      const crypto_aead_iovec *ad, size_t ad_count,
+                      const unsigned char *npub,
+                      const unsigned char *k, int ietf)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     block0[64U];
+    unsigned char                     slen[8U];
+    unsigned char                     computed_mac[crypto_aead_chacha20poly1305_ABYTES];
+    unsigned long long                adlen;
+    unsigned long long                mlen;
+    unsigned long long                clen;
+    int                               ret;
+
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 ||
+        (m != NULL && (aead_iov_total(&mlen, m, m_count) != 0 ||
+                       mlen != clen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    mlen = clen;
+    if (ietf) {
+        crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    } else {
+        crypto_stream_chacha20(block0, sizeof block0, npub, k);
+    }
+    crypto_onetimeauth_poly1305_init(&state, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    _mac_iov(&state, ad, ad_count);
+    if (ietf) {
+        crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+    } else {
+        STORE64_LE(slen, (uint64_t) adlen);
+        crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+    }
+
+    _mac_iov(&state, c, c_count);
+
+    if (ietf) {
+        crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+        STORE64_LE(slen, (uint64_t) adlen);
+        crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+    }
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, computed_mac);
+    sodium_memzero(&state, sizeof state);
+
+    COMPILER_ASSERT(sizeof computed_mac == 16U);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        aead_iov_memzero(m, m_count);
+        return -1;
+    }
+    _xor_iov(NULL, m, m_count, c, c_count, mlen, npub, 1U, k, ietf);
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                                  size_t c_count,
+                                                  unsigned char *mac,
+                                                  unsigned long long *maclen_p,
+                                                  const crypto_aead_iovec *m,
+                                                  size_t m_count,
+                                                  const crypto_aead_iovec *ad,
+                                                  size_t ad_count,
+                                                  const unsigned char *nsec,
+                                                  const unsigned char *npub,
+                                                  const unsigned char *k)
+{
+    int ret;
+
+    (void) nsec;
+    ret = _encrypt_detached_iov(c, c_count, mac, m, m_count, ad, ad_count,
+                                npub, k, 0);
+    if (maclen_p != NULL) {
+        *maclen_p = ret == 0 ? crypto_aead_chacha20poly1305_ABYTES : 0ULL;
+    }
+    return ret;
+}
+
+int
+crypto_aead_chacha20poly1305_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                                  size_t m_count,
+                                                  unsigned char *nsec,
+                                                  const crypto_aead_iovec *c,
+                                                  size_t c_count,
+                                                  const unsigned char *mac,
+                                                  const crypto_aead_iovec *ad,
+                                                  size_t ad_count,
+                                                  const unsigned char *npub,
+                                                  const unsigned char *k)
+{
+    (void) nsec;
+    return _decrypt_detached_iov(m, m_count, c, c_count, mac, ad, ad_count,
+                                 npub, k, 0);
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                                       size_t c_count,
+                                                       unsigned char *mac,
+                                                       unsigned long long *maclen_p,
+                                                       const crypto_aead_iovec *m,
+                                                       size_t m_count,
+                                                       const crypto_aead_iovec *ad,
+                                                       size_t ad_count,
+                                                       const unsigned char *nsec,
+                                                       const unsigned char *npub,
+                                                       const unsigned char *k)
+{
+    int ret;
+
+    (void) nsec;
+    ret = _encrypt_detached_iov(c, c_count, mac, m, m_count, ad, ad_count,
+                                npub, k, 1);
+    if (maclen_p != NULL) {
+        *maclen_p = ret == 0 ? crypto_aead_chacha20poly1305_ietf_ABYTES : 0ULL;
+    }
+    return ret;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                                       size_t m_count,
+                                                       unsigned char *nsec,
+                                                       const crypto_aead_iovec *c,
+                                                       size_t c_count,
+                                                       const unsigned char *mac,
+                                                       const crypto_aead_iovec *ad,
+                                                       size_t ad_count,
+                                                       const unsigned char *npub,
+                                                       const unsigned char *k)
+{
+    (void) nsec;
+    return _decrypt_detached_iov(m, m_count, c, c_count, mac, ad, ad_count,
+                                 npub, k, 1);
+}
+
+/*
+ * Batches of short messages are encrypted with one message per SIMD lane:
+ * every call to the multi-state block function advances each message by
+ * one block. A lane is handed the next message as soon as its current
+ * message has been fully encrypted.
+ */
+
+#define BATCH_LANES 8U
+#define BATCH_MAC_BYTES 1024U
+
+typedef struct batch_lane_ {
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                    *c;
+    unsigned char                    *mac_c;
+    const unsigned char              *m;
+    const unsigned char              *ad;
+    const unsigned char              *npub;
+    const unsigned char              *k;
+    unsigned long long                mlen;
+    unsigned long long                remaining;
+    unsigned long long                adlen;
+    int                               active;
+} batch_lane;
+
+/* Poly1305 is computed over runs of ciphertext, not one block at a time */
+
+static void
+_batch_lane_mac(batch_lane *lane)
+{
+    crypto_onetimeauth_poly1305_update(&lane->state, lane->mac_c,
+                                       (unsigned long long) (lane->c - lane->mac_c));
+    lane->mac_c = lane->c;
+}
+
+static void
+_batch_lane_final(batch_lane *lane)
+{
+    unsigned char slen[8U];
+
+    _batch_lane_mac(lane);
+    crypto_onetimeauth_poly1305_update(&lane->state, _pad0,
+                                       (0x10 - lane->mlen) & 0xf);
+    STORE64_LE(slen, (uint64_t) lane->adlen);
+    crypto_onetimeauth_poly1305_update(&lane->state, slen, sizeof slen);
+    STORE64_LE(slen, (uint64_t) lane->mlen);
+    crypto_onetimeauth_poly1305_update(&lane->state, slen, sizeof slen);
+    crypto_onetimeauth_poly1305_final(&lane->state, lane->c);
+    lane->active = 0;
+}
+
+void
+crypto_aead_chacha20poly1305_ietf_encrypt_lanes(unsigned char * const *c,
+                                                const unsigned char * const *m,
+                                                const unsigned long long *mlen,
+                                                const unsigned char * const *ad,
+                                                const unsigned long long *adlen,
+                                                const unsigned char * const *npub,
+                                                size_t count, const unsigned char *k,
+                                                size_t k_stride)
+{
+    CRYPTO_ALIGN(32) uint32_t x[16][BATCH_LANES];
+    CRYPTO_ALIGN(32) unsigned char ks[64U * BATCH_LANES];
+    batch_lane          lanes[BATCH_LANES];
+    batch_lane         *lane;
+    unsigned long long  len;
+    size_t              next = 0U;
+    size_t              i;
+    size_t              j;
+    unsigned int        active;
+    unsigned int        drained;
+    uint32_t            ctr;
+
+    memset(x, 0, sizeof x);
+    for (j = 0U; j < BATCH_LANES; j++) {
+        x[0][j]  = 0x61707865;
+        x[1][j]  = 0x3320646e;
+        x[2][j]  = 0x79622d32;
+        x[3][j]  = 0x6b206574;
+        lanes[j].active = 0;
+    }
+    for (;;) {
+        active = 0U;
+        for (j = 0U; j < BATCH_LANES; j++) {
+            lane = &lanes[j];
+            if (lane->active == 0 && next < count) {
+                lane->c         = c[next];
+                lane->mac_c     = c[next];
+                lane->m         = m[next];
+                lane->npub      = npub[next];
+                lane->k         = k + next * k_stride;
+                lane->mlen      = lane->remaining = mlen[next];
+                lane->ad        = ad == NULL ? NULL : ad[next];
+                lane->adlen     = ad == NULL ? 0ULL : adlen[next];
+                lane->active    = 1;
+                for (i = 0U; i < 8U; i++) {
+                    x[4 + i][j] = LOAD32_LE(lane->k + 4U * i);
+                }
+                x[12][j] = 0U;
+                x[13][j] = LOAD32_LE(npub[next] + 0);
+                x[14][j] = LOAD32_LE(npub[next] + 4);
+                x[15][j] = LOAD32_LE(npub[next] + 8);
+                next++;
+            }
+            active += lane->active != 0;
+        }
+        if (active == 0U) {
+            break;
+        }
+        /*
+         * With the queue empty and most lanes idle, finishing the
+         * remaining messages one at a time is faster.
+         */
+        if (next >= count && active < BATCH_LANES / 2U) {
+            drained = 0U;
+            for (j = 0U; j < BATCH_LANES; j++) {
+                lane = &lanes[j];
+                if (lane->active != 2) {
+                    continue;
+                }
+                ctr = x[12][j];
+                _batch_lane_mac(lane);
+                _encrypt_and_mac_ietf(&lane->state, lane->c, lane->m,
+                                      lane->remaining, lane->npub, ctr, lane->k);
+                lane->c += lane->remaining;
+                lane->mac_c = lane->c;
+                lane->m += lane->remaining;
+                lane->remaining = 0U;
+                _batch_lane_final(lane);
+                drained++;
+            }
+            if (drained > 0U) {
+                continue;
+            }
+        }
+        crypto_stream_chacha20_blocks8(ks, (const uint32_t (*)[BATCH_LANES]) x);
+        for (j = 0U; j < BATCH_LANES; j++) {
+            lane = &lanes[j];
+            if (lane->active == 0) {
+                continue;
+            }
+            x[12][j]++;
+            if (lane->active == 1) {
+                crypto_onetimeauth_poly1305_init(&lane->state, &ks[64U * j]);
+                crypto_onetimeauth_poly1305_update(&lane->state, lane->ad,
+                                                   lane->adlen);
+                crypto_onetimeauth_poly1305_update(&lane->state, _pad0,
+                                                   (0x10 - lane->adlen) & 0xf);
+                lane->active = 2;
+            } else {
+                len = lane->remaining < 64U ? lane->remaining : 64U;
+                if (len == 64U) {
+                    for (i = 0U; i < 64U; i += 8U) {
+                        STORE64_LE(lane->c + i, LOAD64_LE(lane->m + i) ^
+                                   LOAD64_LE(&ks[64U * j + i]));
+                    }
+                } else {
+                    for (i = 0U; i < (size_t) len; i++) {
+                        lane->c[i] = lane->m[i] ^ ks[64U * j + i];
+                    }
+                }
+                lane->c += len;
+                lane->m += len;
+                lane->remaining -= len;
+                if ((size_t) (lane->c - lane->mac_c) >= BATCH_MAC_BYTES) {
+                    _batch_lane_mac(lane);
+                }
+            }
+            if (lane->active == 2 && lane->remaining == 0U) {
+                _batch_lane_final(lane);
+            }
+        }
+    }
+    sodium_memzero(x, sizeof x);
+    sodium_memzero(ks, sizeof ks);
+    sodium_memzero(lanes, sizeof lanes);
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_encrypt_batch(unsigned char * const *c,
+                                                const unsigned char * const *m,
+                                                const unsigned long long *mlen,
+                                                const unsigned char * const *ad,
+                                                const unsigned long long *adlen,
+                                                const unsigned char * const *npub,
+                                                size_t count,
+                                                const unsigned char *k)
+{
+    size_t i;
+
+    for (i = 0U; i < count; i++) {
+        if (mlen[i] > crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX) {
+            sodium_misuse();
+        }
+    }
+    if (count > 1U && crypto_stream_chacha20_has_blocks8()) {
+        crypto_aead_chacha20poly1305_ietf_encrypt_lanes(c, m, mlen, ad, adlen,
+                                                        npub, count, k, 0U);
+        return 0;
+    }
+    for (i = 0U; i < count; i++) {
+        (void) crypto_aead_chacha20poly1305_ietf_encrypt_detached
+            (c[i], c[i] + mlen[i], NULL, m[i], mlen[i],
+             ad == NULL ? NULL : ad[i], ad == NULL ? 0ULL : adlen[i],
+             NULL, npub[i], k);
+    }
+    return 0;
+}
+
+/*
+ * Incremental IETF construction. The keystream of a partial block is kept
+ * in ks, so that updates of any size produce the same output as a single
+ * call.
+ */
+
+typedef struct ietf_state_ {
+    crypto_onetimeauth_poly1305_state mac;
+    unsigned char                     k[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char                     npub[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char                     ks[64U];
+    unsigned long long                adlen;
+    unsigned long long                mlen;
+    size_t                            ks_pos;
+    uint32_t                          ic;
+    int                               ad_done;
+} ietf_state;
+
+static void
+_ietf_state_ad_pad(ietf_state *st)
+{
+    if (st->ad_done == 0) {
+        crypto_onetimeauth_poly1305_update(&st->mac, _pad0, (0x10 - st->adlen) & 0xf);
+        st->ad_done = 1;
+    }
+}
+
+static void
+_ietf_state_update(ietf_state *st, unsigned char *out, const unsigned char *in,
+                   unsigned long long inlen, int encrypt)
+{
+    unsigned long long i = 0ULL;
+    unsigned long long full;
+    size_t             n;
+
+    _ietf_state_ad_pad(st);
+    if (inlen > crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX - st->mlen) {
+        sodium_misuse();
+    }
+    st->mlen += inlen;
+    if (st->ks_pos < sizeof st->ks) {
+        n = sizeof st->ks - st->ks_pos;
+        if (n > inlen) {
+            n = (size_t) inlen;
+        }
+        if (encrypt == 0) {
+            crypto_onetimeauth_poly1305_update(&st->mac, in, n);
+        }
+        for (; i < n; i++) {
+            out[i] = in[i] ^ st->ks[st->ks_pos + i];
+        }
+        if (encrypt != 0) {
+            crypto_onetimeauth_poly1305_update(&st->mac, out, n);
+        }
+        st->ks_pos += n;
+    }
+    full = (inlen - i) & ~63ULL;
+    if (full > 0U) {
+        if (encrypt != 0) {
+            _encrypt_and_mac_ietf(&st->mac, out + i, in + i, full, st->npub, st->ic, st->k);
+        } else {
+            crypto_onetimeauth_poly1305_update(&st->mac, in + i, full);
+            crypto_stream_chacha20_ietf_xor_ic(out + i, in + i, full, st->npub, st->ic, st->k);
+        }
+        st->ic += (uint32_t) (full / 64U);
+        i += full;
+    }
+    if (i < inlen) {
+        n = (size_t) (inlen - i);
+        memset(st->ks, 0, sizeof st->ks);
+        crypto_stream_chacha20_ietf_xor_ic(st->ks, st->ks, sizeof st->ks, st->npub, st->ic,
+                                           st->k);
+        st->ic++;
+        if (encrypt == 0) {
+            crypto_onetimeauth_poly1305_update(&st->mac, in + i, n);
+        }
+        for (st->ks_pos = 0U; st->ks_pos < n; st->ks_pos++) {
+            out[i + st->ks_pos] = in[i + st->ks_pos] ^ st->ks[st->ks_pos];
+        }
+        if (encrypt != 0) {
+            crypto_onetimeauth_poly1305_update(&st->mac, out + i, n);
+        }
+    }
+}
+
+static void
+_ietf_state_final(ietf_state *st, unsigned char *mac)
+{
+    unsigned char slen[8U];
+
+    _ietf_state_ad_pad(st);
+    crypto_onetimeauth_poly1305_update(&st->mac, _pad0, (0x10 - st->mlen) & 0xf);
+    STORE64_LE(slen, (uint64_t) st->adlen);
+    crypto_onetimeauth_poly1305_update(&st->mac, slen, sizeof slen);
+    STORE64_LE(slen, (uint64_t) st->mlen);
+    crypto_onetimeauth_poly1305_update(&st->mac, slen, sizeof slen);
+    crypto_onetimeauth_poly1305_final(&st->mac, mac);
+    sodium_memzero(st, sizeof *st);
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_init(crypto_aead_chacha20poly1305_ietf_state *state_,
+                                       const unsigned char *npub,
+                                       const unsigned char *k)
+{
+    ietf_state   *st = (ietf_state *) (void *) state_;
+    unsigned char block0[64U];
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    memset(st, 0, sizeof *st);
+    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    crypto_onetimeauth_poly1305_init(&st->mac, block0);
+    sodium_memzero(block0, sizeof block0);
+    memcpy(st->k, k, sizeof st->k);
+    memcpy(st->npub, npub, sizeof st->npub);
+    st->ks_pos = sizeof st->ks;
+    st->ic     = 1U;
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_update_ad(crypto_aead_chacha20poly1305_ietf_state *state_,
+                                            const unsigned char *ad,
+                                            unsigned long long adlen)
+{
+    ietf_state *st = (ietf_state *) (void *) state_;
+
+    if (st->ad_done != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    crypto_onetimeauth_poly1305_update(&st->mac, ad, adlen);
+    st->adlen += adlen;
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_encrypt_update(crypto_aead_chacha20poly1305_ietf_state *state_,
+                                                 unsigned char *c,
+                                                 const unsigned char *m,
+                                                 unsigned long long mlen)
+{
+    _ietf_state_update((ietf_state *) (void *) state_, c, m, mlen, 1);
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_encrypt_final(crypto_aead_chacha20poly1305_ietf_state *state_,
+                                                unsigned char *mac)
+{
+    _ietf_state_final((ietf_state *) (void *) state_, mac);
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_decrypt_update(crypto_aead_chacha20poly1305_ietf_state *state_,
+                                                 unsigned char *m,
+                                                 const unsigned char *c,
+                                                 unsigned long long clen)
+{
+    _ietf_state_update((ietf_state *) (void *) state_, m, c, clen, 0);
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_decrypt_final(crypto_aead_chacha20poly1305_ietf_state *state_,
+                                                const unsigned char *mac)
+{
+    unsigned char computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    int           ret;
+
+    _ietf_state_final((ietf_state *) (void *) state_, computed_mac);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+
+    return ret;
+}
+
+/*
+ * Prepared IETF construction. ks holds whole keystream blocks starting at
+ * counter 1, so that the rest of a longer message continues at a block
+ * boundary.
+ */
+
+typedef struct ietf_prepared_ {
+    unsigned char k[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char npub[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char mac_key[crypto_onetimeauth_poly1305_KEYBYTES];
+    unsigned char ks[crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX];
+    size_t        ks_len;
+    int           ready;
+} ietf_prepared;
+
+int
+crypto_aead_chacha20poly1305_ietf_prepare(crypto_aead_chacha20poly1305_ietf_prepared *state_,
+                                          size_t kslen,
+                                          const unsigned char *npub,
+                                          const unsigned char *k)
+{
+    ietf_prepared *st = (ietf_prepared *) (void *) state_;
+    unsigned char  block0[64U];
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    COMPILER_ASSERT(crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX % 64U == 0U);
+    if (kslen > crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    crypto_stream_chacha20_ietf(block0, sizeof block0, npub, k);
+    memcpy(st->mac_key, block0, sizeof st->mac_key);
+    sodium_memzero(block0, sizeof block0);
+    memcpy(st->k, k, sizeof st->k);
+    memcpy(st->npub, npub, sizeof st->npub);
+    st->ks_len = (kslen + 63U) & ~(size_t) 63U;
+    memset(st->ks, 0, st->ks_len);
+    crypto_stream_chacha20_ietf_xor_ic(st->ks, st->ks, st->ks_len, npub, 1U, k);
+    st->ready = 1;
+
+    return 0;
+}
+
+int
+crypto_aead_chacha20poly1305_ietf_encrypt_prepared(unsigned char *c,
+                                                   unsigned long long *clen_p,
+                                                   const unsigned char *m,
+                                                   unsigned long long mlen,
+                                                   const unsigned char *ad,
+                                                   unsigned long long adlen,
+                                                   crypto_aead_chacha20poly1305_ietf_prepared *state_)
+{
+    ietf_prepared                    *st = (ietf_prepared *) (void *) state_;
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     slen[8U];
+    uint64_t                          w, ks;
+    size_t                            i, n;
+    SODIUM_STATS_START(stats_start)
+
+    if (clen_p != NULL) {
+        *clen_p = 0ULL;
+    }
+    if (st->ready != 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    crypto_onetimeauth_poly1305_init(&state, st->mac_key);
+    crypto_onetimeauth_poly1305_update(&state, ad, adlen);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+
+    n = st->ks_len;
+    if (mlen < (unsigned long long) n) {
+        n = (size_t) mlen;
+    }
+    for (i = 0U; i + 8U <= n; i += 8U) {
+        memcpy(&w, m + i, 8U);
+        memcpy(&ks, st->ks + i, 8U);
+        w ^= ks;
+        memcpy(c + i, &w, 8U);
+    }
+    for (; i < n; i++) {
+        c[i] = m[i] ^ st->ks[i];
+    }
+    crypto_onetimeauth_poly1305_update(&state, c, n);
+    if (mlen > n) {
+        _encrypt_and_mac_ietf(&state, c + n, m + n, mlen - n, st->npub,
+                              (uint32_t) (1U + n / 64U), st->k);
+    }
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, c + mlen);
+    sodium_memzero(&state, sizeof state);
+    sodium_memzero(st->ks, st->ks_len);
+    sodium_memzero(st, offsetof(ietf_prepared, ks));
+    st->ready = 0;
+
+    if (clen_p != NULL) {
+        *clen_p = mlen + crypto_aead_chacha20poly1305_ietf_ABYTES;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return 0;
+}
+
+size_t
+crypto_aead_chacha20poly1305_ietf_preparedbytes_max(void)
+{
+    return crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX;
+}
+
+size_t
+crypto_aead_chacha20poly1305_ietf_statebytes(void)
+{
+    return sizeof(crypto_aead_chacha20poly1305_ietf_state);
+}
+
 size_t
 crypto_aead_chacha20poly1305_ietf_keybytes(void)
 {
@@ -363,6 +1358,12 @@ crypto_aead_chacha20poly1305_ietf_keygen(unsigned char k[crypto_aead_chacha20pol
     randombytes_buf(k, crypto_aead_chacha20poly1305_ietf_KEYBYTES);
 }
 
+size_t
+crypto_aead_chacha20poly1305_ietf_commitbytes(void)
+{
+    return crypto_aead_chacha20poly1305_ietf_COMMITBYTES;
+}
+
 size_t
 crypto_aead_chacha20poly1305_keybytes(void)
 {
@@ -1,4 +1,6 @@
 
+#include <errno.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -14,11 +16,47 @@
 #include "randombytes.h"
 #include "utils.h"
 
+#include "private/aead_iov.h"
 #include "private/chacha20_ietf_ext.h"
+#include "private/chacha20poly1305_lanes.h"
 #include "private/common.h"
+#include "private/stats.h"
+
+#define ENCRYPT_AND_MAC_CHUNK_BYTES 16384U
 
 static const unsigned char _pad0[16] = { 0 };
 
+/*
+ * Encrypt and authenticate in cache-sized chunks, so that Poly1305 reads
+ * each chunk of ciphertext while it is still in L1.
+ * Messages that would need the 32-bit block counter to wrap are left to a
+ * single call, so that overflow is still carried into the nonce there.
+ */
+
+static void
+_encrypt_and_mac(crypto_onetimeauth_poly1305_state *state,
+                 unsigned char *c, const unsigned char *m,
+                 unsigned long long mlen, const unsigned char *n,
+                 uint32_t ic, const unsigned char *k)
+{
+    unsigned long long chunk_len;
+
+    COMPILER_ASSERT(ENCRYPT_AND_MAC_CHUNK_BYTES % 64U == 0U);
+    while (mlen > 0U) {
+        chunk_len = mlen;
+        if (chunk_len > ENCRYPT_AND_MAC_CHUNK_BYTES &&
+            ic <= UINT32_MAX - ENCRYPT_AND_MAC_CHUNK_BYTES / 64U) {
+            chunk_len = ENCRYPT_AND_MAC_CHUNK_BYTES;
+        }
+        crypto_stream_chacha20_ietf_ext_xor_ic(c, m, chunk_len, n, ic, k);
+        crypto_onetimeauth_poly1305_update(state, c, chunk_len);
+        ic += (uint32_t) (ENCRYPT_AND_MAC_CHUNK_BYTES / 64U);
+        c += chunk_len;
+        m += chunk_len;
+        mlen -= chunk_len;
+    }
+}
+
 static int
 _encrypt_detached(unsigned char *c,
                   unsigned char *mac,
@@ -43,9 +81,7 @@ _encrypt_detached(unsigned char *c,
     crypto_onetimeauth_poly1305_update(&state, ad, adlen);
     crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
 
-    crypto_stream_chacha20_ietf_ext_xor_ic(c, m, mlen, npub, 1U, k);
-
-    crypto_onetimeauth_poly1305_update(&state, c, mlen);
+    _encrypt_and_mac(&state, c, m, mlen, npub, 1U, k);
     crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
 
     STORE64_LE(slen, (uint64_t) adlen);
@@ -117,6 +153,182 @@ _decrypt_detached(unsigned char *m,
     return 0;
 }
 
+/*
+ * Encrypt (and authenticate, if state is not NULL) a scattered buffer.
+ * The block counter is tracked as 64 bits, and its high part is carried
+ * into the first word of the nonce, as crypto_stream_chacha20_ietf_ext()
+ * does within a single call.
+ */
+
+static void
+_xor_iov(crypto_onetimeauth_poly1305_state *state,
+         const crypto_aead_iovec *out_iov, size_t out_count,
+         const crypto_aead_iovec *in_iov, size_t in_count,
+         unsigned long long len, const unsigned char *npub,
+         const unsigned char *k)
+{
+    aead_iov_cursor      out;
+    aead_iov_cursor      in;
+    unsigned char        n[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char        src[64U];
+    unsigned char        dst[64U];
+    unsigned char       *out_p;
+    const unsigned char *in_p;
+    uint64_t             ctr = 1U;
+    size_t               run;
+
+    memcpy(n, npub, sizeof n);
+    ctr |= (uint64_t) LOAD32_LE(n) << 32;
+    aead_iov_cursor_init(&out, out_iov, out_count);
+    aead_iov_cursor_init(&in, in_iov, in_count);
+    while (len > 0U) {
+        run = aead_iov_cursor_run(&out, &in, 64U);
+        if (run > 0U) {
+            out_p = aead_iov_cursor_ptr(&out);
+            in_p  = aead_iov_cursor_ptr(&in);
+        } else {
+            run = len < 64U ? (size_t) len : 64U;
+            aead_iov_cursor_gather(&in, src, run);
+            out_p = dst;
+            in_p  = src;
+        }
+        STORE32_LE(n, (uint32_t) (ctr >> 32));
+        if (state != NULL) {
+            _encrypt_and_mac(state, out_p, in_p, run, n, (uint32_t) ctr, k);
+        } else {
+            crypto_stream_chacha20_ietf_ext_xor_ic(out_p, in_p, run, n,
+                                                   (uint32_t) ctr, k);
+        }
+        if (out_p == dst) {
+            aead_iov_cursor_scatter(&out, dst, run);
+        } else {
+            aead_iov_cursor_advance(&out, run);
+            aead_iov_cursor_advance(&in, run);
+        }
+        ctr += (uint64_t) (run / 64U);
+        len -= run;
+    }
+    sodium_memzero(src, sizeof src);
+    sodium_memzero(dst, sizeof dst);
+}
+
+static void
+_mac_iov(crypto_onetimeauth_poly1305_state *state,
+         const crypto_aead_iovec *iov, size_t count)
+{
+    size_t i;
+
+    for (i = 0U; i < count; i++) {
+        crypto_onetimeauth_poly1305_update(state, (const unsigned char *) iov[i].ptr,
+                                           (unsigned long long) iov[i].len);
+    }
+}
+
+static int
+_encrypt_detached_iov(const crypto_aead_iovec *c, size_t c_count,
+                      unsigned char *mac,
+                      const crypto_aead_iovec *m, size_t m_count,
+                      const crypto_aead_iovec *ad, size_t ad_count,
+                      const unsigned char *npub,
+                      const unsigned char *k)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     block0[64U];
+    unsigned char                     slen[8U];
+    unsigned long long                adlen;
+    unsigned long long                mlen;
+    unsigned long long                clen;
+
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&mlen, m, m_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 || clen != mlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_xchacha20poly1305_ietf_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    crypto_stream_chacha20_ietf_ext(block0, sizeof block0, npub, k);
+    crypto_onetimeauth_poly1305_init(&state, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    _mac_iov(&state, ad, ad_count);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+
+    _xor_iov(&state, c, c_count, m, m_count, mlen, npub, k);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, mac);
+    sodium_memzero(&state, sizeof state);
+
+    return 0;
+}
+
+static int
+_decrypt_detached_iov(const crypto_aead_iovec *m, size_t m_count,
+                      const crypto_aead_iovec *c, size_t c_count,
+                      const unsigned char *mac,
+                      const crypto_aead_iovec *ad, size_t ad_count,
+                      const unsigned char *npub,
+                      const unsigned char *k)
+{
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     block0[64U];
+    unsigned char                     slen[8U];
+    unsigned char                     computed_mac[crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned long long                adlen;
+    unsigned long long                mlen;
+    unsigned long long                clen;
+    int                               ret;
+
+    if (aead_iov_total(&adlen, ad, ad_count) != 0 ||
+        aead_iov_total(&clen, c, c_count) != 0 ||
+        (m != NULL && (aead_iov_total(&mlen, m, m_count) != 0 ||
+                       mlen != clen))) {
+        errno = EINVAL;
+        return -1;
+    }
+    mlen = clen;
+    crypto_stream_chacha20_ietf_ext(block0, sizeof block0, npub, k);
+    crypto_onetimeauth_poly1305_init(&state, block0);
+    sodium_memzero(block0, sizeof block0);
+
+    _mac_iov(&state, ad, ad_count);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+
+    _mac_iov(&state, c, c_count);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, computed_mac);
+    sodium_memzero(&state, sizeof state);
+
+    COMPILER_ASSERT(sizeof computed_mac == 16U);
+    ret = crypto_verify_16(computed_mac, mac);
+    sodium_memzero(computed_mac, sizeof computed_mac);
+    if (m == NULL) {
+        return ret;
+    }
+    if (ret != 0) {
+        aead_iov_memzero(m, m_count);
+        return -1;
+    }
+    _xor_iov(NULL, m, m_count, c, c_count, mlen, npub, k);
+
+    return 0;
+}
+
 int
 crypto_aead_xchacha20poly1305_ietf_encrypt_detached(unsigned char *c,
                                                     unsigned char *mac,
@@ -132,6 +344,7 @@ crypto_aead_xchacha20poly1305_ietf_encrypt_detached(unsigned char *c,
     unsigned char k2[crypto_core_hchacha20_OUTPUTBYTES];
     unsigned char npub2[crypto_aead_chacha20poly1305_ietf_NPUBBYTES] = { 0 };
     int           ret;
+    SODIUM_STATS_START(stats_start)
 
     crypto_core_hchacha20(k2, npub, k, NULL);
     memcpy(npub2 + 4, npub + crypto_core_hchacha20_INPUTBYTES,
@@ -139,6 +352,7 @@ crypto_aead_xchacha20poly1305_ietf_encrypt_detached(unsigned char *c,
     ret = _encrypt_detached(c, mac, maclen_p, m, mlen, ad, adlen,
                             nsec, npub2, k2);
     sodium_memzero(k2, crypto_core_hchacha20_OUTPUTBYTES);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
 
     return ret;
 }
@@ -185,16 +399,47 @@ crypto_aead_xchacha20poly1305_ietf_decrypt_detached(unsigned char *m,
     unsigned char k2[crypto_core_hchacha20_OUTPUTBYTES];
     unsigned char npub2[crypto_aead_chacha20poly1305_ietf_NPUBBYTES] = { 0 };
     int           ret;
+    SODIUM_STATS_START(stats_start)
 
     crypto_core_hchacha20(k2, npub, k, NULL);
     memcpy(npub2 + 4, npub + crypto_core_hchacha20_INPUTBYTES,
            crypto_aead_chacha20poly1305_ietf_NPUBBYTES - 4);
     ret = _decrypt_detached(m, nsec, c, clen, mac, ad, adlen, npub2, k2);
     sodium_memzero(k2, crypto_core_hchacha20_OUTPUTBYTES);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
 
     return ret;
 }
 
+int
+crypto_aead_xchacha20poly1305_ietf_verify_detached(const unsigned char *c,
+                                                   unsigned long long clen,
+                                                   const unsigned char *mac,
+                                                   const unsigned char *ad,
+                                                   unsigned long long adlen,
+                                                   const unsigned char *npub,
+                                                   const unsigned char *k)
+{
+    return crypto_aead_xchacha20poly1305_ietf_decrypt_detached
+        (NULL, NULL, c, clen, mac, ad, adlen, npub, k);
+}
+
+void
+crypto_aead_xchacha20poly1305_ietf_decrypt_unverified_in_place(unsigned char *buf,
+                                                               unsigned long long len,
+                                                               const unsigned char *npub,
+                                                               const unsigned char *k)
+{
+    unsigned char k2[crypto_core_hchacha20_OUTPUTBYTES];
+    unsigned char npub2[crypto_aead_chacha20poly1305_ietf_NPUBBYTES] = { 0 };
+
+    crypto_core_hchacha20(k2, npub, k, NULL);
+    memcpy(npub2 + 4, npub + crypto_core_hchacha20_INPUTBYTES,
+           crypto_aead_chacha20poly1305_ietf_NPUBBYTES - 4);
+    crypto_stream_chacha20_ietf_ext_xor_ic(buf, buf, len, npub2, 1U, k2);
+    sodium_memzero(k2, crypto_core_hchacha20_OUTPUTBYTES);
+}
+
 int
 crypto_aead_xchacha20poly1305_ietf_decrypt(unsigned char *m,
                                            unsigned long long *mlen_p,
@@ -225,6 +470,390 @@ crypto_aead_xchacha20poly1305_ietf_decrypt(unsigned char *m,
     return ret;
 }
 
+int
+crypto_aead_xchacha20poly1305_ietf_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                                        size_t c_count,
+                                                        unsigned char *mac,
+                                                        unsigned long long *maclen_p,
+                                                        const crypto_aead_iovec *m,
+                                                        size_t m_count,
+                                                        const crypto_aead_iovec *ad,
+                                                        size_t ad_count,
+                                                        const unsigned char *nsec,
+                                                        const unsigned char *npub,
+                                                        const unsigned char *k)
+{
+    unsigned char k2[crypto_core_hchacha20_OUTPUTBYTES];
+    unsigned char npub2[crypto_aead_chacha20poly1305_ietf_NPUBBYTES] = { 0 };
+    int           ret;
+
+    (void) nsec;
+    crypto_core_hchacha20(k2, npub, k, NULL);
+    memcpy(npub2 + 4, npub + crypto_core_hchacha20_INPUTBYTES,
+           crypto_aead_chacha20poly1305_ietf_NPUBBYTES - 4);
+    ret = _encrypt_detached_iov(c, c_count, mac, m, m_count, ad, ad_count,
+                                npub2, k2);
+    sodium_memzero(k2, crypto_core_hchacha20_OUTPUTBYTES);
+    if (maclen_p != NULL) {
+        *maclen_p = ret == 0 ? crypto_aead_xchacha20poly1305_ietf_ABYTES : 0ULL;
+    }
+    return ret;
+}
+
+int
+crypto_aead_xchacha20poly1305_ietf_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                                        size_t m_count,
+                                                        unsigned char *nsec,
+                                                        const crypto_aead_iovec *c,
+                                                        size_t c_count,
+                                                        const unsigned char *mac,
+                                                        const crypto_aead_iovec *ad,
+                                                        size_t ad_count,
+                                                        const unsigned char *npub,
+                                                        const unsigned char *k)
+{
+    unsigned char k2[crypto_core_hchacha20_OUTPUTBYTES];
+    unsigned char npub2[crypto_aead_chacha20poly1305_ietf_NPUBBYTES] = { 0 };
+    int           ret;
+
+    (void) nsec;
+    crypto_core_hchacha20(k2, npub, k, NULL);
+    memcpy(npub2 + 4, npub + crypto_core_hchacha20_INPUTBYTES,
+           crypto_aead_chacha20poly1305_ietf_NPUBBYTES - 4);
+    ret = _decrypt_detached_iov(m, m_count, c, c_count, mac, ad, ad_count,
+                                npub2, k2);
+    sodium_memzero(k2, crypto_core_hchacha20_OUTPUTBYTES);
+
+    return ret;
+}
+
+/*
+ * Batches derive the subkeys of 8 messages with a single call to the
+ * multi-state ChaCha20 block function: HChaCha20 is a ChaCha20 block
+ * without the final addition, which is subtracted back from words 0-3 and
+ * 12-15. The messages are then encrypted one per lane.
+ */
+
+#define XBATCH_CHUNK          64U
+#define XBATCH_LANE_BYTES_MAX 512U
+
+static void
+_hchacha20_lanes(unsigned char (*out)[crypto_core_hchacha20_OUTPUTBYTES],
+                 const unsigned char * const *in, size_t count,
+                 const unsigned char *k)
+{
+    static const unsigned int      words[8] = { 0, 1, 2, 3, 12, 13, 14, 15 };
+    CRYPTO_ALIGN(32) uint32_t      x[16][8];
+    CRYPTO_ALIGN(32) unsigned char ks[64U * 8U];
+    size_t                         i;
+    size_t                         j;
+    size_t                         l;
+
+    for (i = 0U; i < count; i += 8U) {
+        for (l = 0U; l < 8U; l++) {
+            const unsigned char *n = in[i + (i + l < count ? l : 0U)];
+
+            x[0][l] = 0x61707865;
+            x[1][l] = 0x3320646e;
+            x[2][l] = 0x79622d32;
+            x[3][l] = 0x6b206574;
+            for (j = 0U; j < 8U; j++) {
+                x[4 + j][l] = LOAD32_LE(k + 4U * j);
+            }
+            for (j = 0U; j < 4U; j++) {
+                x[12 + j][l] = LOAD32_LE(n + 4U * j);
+            }
+        }
+        crypto_stream_chacha20_blocks8(ks, (const uint32_t (*)[8]) x);
+        for (l = 0U; l < 8U && i + l < count; l++) {
+            for (j = 0U; j < 8U; j++) {
+                STORE32_LE(out[i + l] + 4U * j,
+                           LOAD32_LE(&ks[64U * l + 4U * words[j]]) -
+                           x[words[j]][l]);
+            }
+        }
+    }
+    sodium_memzero(x, sizeof x);
+    sodium_memzero(ks, sizeof ks);
+}
+
+int
+crypto_aead_xchacha20poly1305_ietf_encrypt_batch(unsigned char * const *c,
+                                                 const unsigned char * const *m,
+                                                 const unsigned long long *mlen,
+                                                 const unsigned char * const *ad,
+                                                 const unsigned long long *adlen,
+                                                 const unsigned char * const *npub,
+                                                 size_t count,
+                                                 const unsigned char *k)
+{
+    unsigned char        k2[XBATCH_CHUNK][crypto_core_hchacha20_OUTPUTBYTES];
+    unsigned char        k2_[XBATCH_CHUNK][crypto_core_hchacha20_OUTPUTBYTES];
+    unsigned char        npub2[XBATCH_CHUNK][crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char       *c_[XBATCH_CHUNK];
+    const unsigned char *m_[XBATCH_CHUNK];
+    const unsigned char *ad_[XBATCH_CHUNK];
+    const unsigned char *npub2_[XBATCH_CHUNK];
+    unsigned long long   mlen_[XBATCH_CHUNK];
+    unsigned long long   adlen_[XBATCH_CHUNK];
+    size_t               chunk;
+    size_t               i;
+    size_t               j;
+    size_t               n;
+
+    for (i = 0U; i < count; i++) {
+        if (mlen[i] > crypto_aead_xchacha20poly1305_ietf_MESSAGEBYTES_MAX) {
+            sodium_misuse();
+        }
+    }
+    if (count <= 1U || crypto_stream_chacha20_has_blocks8() == 0) {
+        for (i = 0U; i < count; i++) {
+            (void) crypto_aead_xchacha20poly1305_ietf_encrypt_detached
+                (c[i], c[i] + mlen[i], NULL, m[i], mlen[i],
+                 ad == NULL ? NULL : ad[i], ad == NULL ? 0ULL : adlen[i],
+                 NULL, npub[i], k);
+        }
+        return 0;
+    }
+    memset(npub2, 0, sizeof npub2);
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > XBATCH_CHUNK) {
+            chunk = XBATCH_CHUNK;
+        }
+        _hchacha20_lanes(k2, &npub[i], chunk, k);
+        n = 0U;
+        for (j = 0U; j < chunk; j++) {
+            memcpy(npub2[j] + 4, npub[i + j] + crypto_core_hchacha20_INPUTBYTES,
+                   crypto_aead_chacha20poly1305_ietf_NPUBBYTES - 4);
+            /* long messages are faster with the multi-block code */
+            if (mlen[i + j] > XBATCH_LANE_BYTES_MAX) {
+                (void) _encrypt_detached(c[i + j], c[i + j] + mlen[i + j], NULL,
+                                         m[i + j], mlen[i + j],
+                                         ad == NULL ? NULL : ad[i + j],
+                                         ad == NULL ? 0ULL : adlen[i + j],
+                                         NULL, npub2[j], k2[j]);
+                continue;
+            }
+            c_[n]     = c[i + j];
+            m_[n]     = m[i + j];
+            mlen_[n]  = mlen[i + j];
+            ad_[n]    = ad == NULL ? NULL : ad[i + j];
+            adlen_[n] = ad == NULL ? 0ULL : adlen[i + j];
+            npub2_[n] = npub2[j];
+            memcpy(k2_[n], k2[j], sizeof k2_[n]);
+            n++;
+        }
+        if (n > 0U) {
+            crypto_aead_chacha20poly1305_ietf_encrypt_lanes(c_, m_, mlen_, ad_, adlen_,
+                                                            npub2_, n, k2_[0],
+                                                            sizeof k2_[0]);
+        }
+    }
+    sodium_memzero(k2, sizeof k2);
+    sodium_memzero(k2_, sizeof k2_);
+
+    return 0;
+}
+
+int
+crypto_aead_xchacha20poly1305_ietf_beforenm(crypto_aead_xchacha20poly1305_ietf_precomputed *state,
+                                            const unsigned char *npub_prefix,
+                                            const unsigned char *k)
+{
+    COMPILER_ASSERT(crypto_aead_xchacha20poly1305_ietf_NPUBPREFIXBYTES ==
+                    crypto_core_hchacha20_INPUTBYTES);
+    COMPILER_ASSERT(sizeof state->opaque == crypto_core_hchacha20_OUTPUTBYTES);
+    crypto_core_hchacha20(state->opaque, npub_prefix, k, NULL);
+
+    return 0;
+}
+
+int
+crypto_aead_xchacha20poly1305_ietf_encrypt_afternm(unsigned char *c,
+                                                   unsigned long long *clen_p,
+                                                   const unsigned char *m,
+                                                   unsigned long long mlen,
+                                                   const unsigned char *ad,
+                                                   unsigned long long adlen,
+                                                   const unsigned char *npub_suffix,
+                                                   const crypto_aead_xchacha20poly1305_ietf_precomputed *state)
+{
+    unsigned char npub2[crypto_aead_chacha20poly1305_ietf_NPUBBYTES] = { 0 };
+    int           ret;
+    SODIUM_STATS_START(stats_start)
+
+    if (mlen > crypto_aead_xchacha20poly1305_ietf_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    memcpy(npub2 + 4, npub_suffix,
+           crypto_aead_xchacha20poly1305_ietf_NPUBSUFFIXBYTES);
+    ret = _encrypt_detached(c, c + mlen, NULL, m, mlen, ad, adlen,
+                            NULL, npub2, state->opaque);
+    if (clen_p != NULL) {
+        *clen_p = mlen + crypto_aead_xchacha20poly1305_ietf_ABYTES;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return ret;
+}
+
+int
+crypto_aead_xchacha20poly1305_ietf_decrypt_afternm(unsigned char *m,
+                                                   unsigned long long *mlen_p,
+                                                   const unsigned char *c,
+                                                   unsigned long long clen,
+                                                   const unsigned char *ad,
+                                                   unsigned long long adlen,
+                                                   const unsigned char *npub_suffix,
+                                                   const crypto_aead_xchacha20poly1305_ietf_precomputed *state)
+{
+    unsigned char      npub2[crypto_aead_chacha20poly1305_ietf_NPUBBYTES] = { 0 };
+    unsigned long long mlen = 0ULL;
+    int                ret  = -1;
+    SODIUM_STATS_START(stats_start)
+
+    memcpy(npub2 + 4, npub_suffix,
+           crypto_aead_xchacha20poly1305_ietf_NPUBSUFFIXBYTES);
+    if (clen >= crypto_aead_xchacha20poly1305_ietf_ABYTES) {
+        ret = _decrypt_detached(m, NULL, c,
+                                clen - crypto_aead_xchacha20poly1305_ietf_ABYTES,
+                                c + clen - crypto_aead_xchacha20poly1305_ietf_ABYTES,
+                                ad, adlen, npub2, state->opaque);
+    }
+    if (mlen_p != NULL) {
+        if (ret == 0) {
+            mlen = clen - crypto_aead_xchacha20poly1305_ietf_ABYTES;
+        }
+        *mlen_p = mlen;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, clen);
+
+    return ret;
+}
+
+/*
+ * Prepared construction. k and npub are the HChaCha20 subkey and the
+ * derived 96-bit nonce, and ks holds whole keystream blocks starting at
+ * counter 1.
+ */
+
+typedef struct xchacha_prepared_ {
+    unsigned char k[crypto_core_hchacha20_OUTPUTBYTES];
+    unsigned char npub[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char mac_key[crypto_onetimeauth_poly1305_KEYBYTES];
+    unsigned char ks[crypto_aead_xchacha20poly1305_ietf_PREPAREDBYTES_MAX];
+    size_t        ks_len;
+    int           ready;
+} xchacha_prepared;
+
+int
+crypto_aead_xchacha20poly1305_ietf_prepare(crypto_aead_xchacha20poly1305_ietf_prepared *state_,
+                                           size_t kslen,
+                                           const unsigned char *npub,
+                                           const unsigned char *k)
+{
+    xchacha_prepared *st = (xchacha_prepared *) (void *) state_;
+    unsigned char     block0[64U];
+
+    COMPILER_ASSERT((sizeof *state_) >= (sizeof *st));
+    COMPILER_ASSERT(crypto_aead_xchacha20poly1305_ietf_PREPAREDBYTES_MAX % 64U == 0U);
+    if (kslen > crypto_aead_xchacha20poly1305_ietf_PREPAREDBYTES_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    crypto_core_hchacha20(st->k, npub, k, NULL);
+    memset(st->npub, 0, 4U);
+    memcpy(st->npub + 4, npub + crypto_core_hchacha20_INPUTBYTES,
+           crypto_aead_chacha20poly1305_ietf_NPUBBYTES - 4);
+    crypto_stream_chacha20_ietf_ext(block0, sizeof block0, st->npub, st->k);
+    memcpy(st->mac_key, block0, sizeof st->mac_key);
+    sodium_memzero(block0, sizeof block0);
+    st->ks_len = (kslen + 63U) & ~(size_t) 63U;
+    memset(st->ks, 0, st->ks_len);
+    crypto_stream_chacha20_ietf_ext_xor_ic(st->ks, st->ks, st->ks_len,
+                                           st->npub, 1U, st->k);
+    st->ready = 1;
+
+    return 0;
+}
+
+int
+crypto_aead_xchacha20poly1305_ietf_encrypt_prepared(unsigned char *c,
+                                                    unsigned long long *clen_p,
+                                                    const unsigned char *m,
+                                                    unsigned long long mlen,
+                                                    const unsigned char *ad,
+                                                    unsigned long long adlen,
+                                                    crypto_aead_xchacha20poly1305_ietf_prepared *state_)
+{
+    xchacha_prepared                 *st = (xchacha_prepared *) (void *) state_;
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     slen[8U];
+    uint64_t                          w, ks;
+    size_t                            i, n;
+    SODIUM_STATS_START(stats_start)
+
+    if (clen_p != NULL) {
+        *clen_p = 0ULL;
+    }
+    if (st->ready != 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_xchacha20poly1305_ietf_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    crypto_onetimeauth_poly1305_init(&state, st->mac_key);
+    crypto_onetimeauth_poly1305_update(&state, ad, adlen);
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - adlen) & 0xf);
+
+    n = st->ks_len;
+    if (mlen < (unsigned long long) n) {
+        n = (size_t) mlen;
+    }
+    for (i = 0U; i + 8U <= n; i += 8U) {
+        memcpy(&w, m + i, 8U);
+        memcpy(&ks, st->ks + i, 8U);
+        w ^= ks;
+        memcpy(c + i, &w, 8U);
+    }
+    for (; i < n; i++) {
+        c[i] = m[i] ^ st->ks[i];
+    }
+    crypto_onetimeauth_poly1305_update(&state, c, n);
+    if (mlen > n) {
+        _encrypt_and_mac(&state, c + n, m + n, mlen - n, st->npub,
+                         (uint32_t) (1U + n / 64U), st->k);
+    }
+    crypto_onetimeauth_poly1305_update(&state, _pad0, (0x10 - mlen) & 0xf);
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    STORE64_LE(slen, (uint64_t) mlen);
+    crypto_onetimeauth_poly1305_update(&state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&state, c + mlen);
+    sodium_memzero(&state, sizeof state);
+    sodium_memzero(st->ks, st->ks_len);
+    sodium_memzero(st, offsetof(xchacha_prepared, ks));
+    st->ready = 0;
+
+    if (clen_p != NULL) {
+        *clen_p = mlen + crypto_aead_xchacha20poly1305_ietf_ABYTES;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_AEAD, mlen);
+
+    return 0;
+}
+
+size_t
+crypto_aead_xchacha20poly1305_ietf_preparedbytes_max(void)
+{
+    return crypto_aead_xchacha20poly1305_ietf_PREPAREDBYTES_MAX;
+}
+
 size_t
 crypto_aead_xchacha20poly1305_ietf_keybytes(void)
 {
@@ -6,6 +6,8 @@
 #include "crypto_auth_hmacsha256.h"
 #include "crypto_hash_sha256.h"
 #include "crypto_verify_32.h"
+#include "private/common.h"
+#include "private/sha256_multi.h"
 #include "randombytes.h"
 #include "utils.h"
 
@@ -116,3 +118,145 @@ crypto_auth_hmacsha256_verify(const unsigned char *h, const unsigned char *in,
     return crypto_verify_32(h, correct) | (-(h == correct)) |
            sodium_memcmp(correct, h, 32);
 }
+
+size_t
+crypto_auth_hmacsha256_key_statebytes(void)
+{
+    return sizeof(crypto_auth_hmacsha256_key_state);
+}
+
+int
+crypto_auth_hmacsha256_key_precompute(crypto_auth_hmacsha256_key_state *kstate,
+                                     const unsigned char *key, size_t keylen)
+{
+    return crypto_auth_hmacsha256_init(&kstate->keyed, key, keylen);
+}
+
+int
+crypto_auth_hmacsha256_init_precomputed(crypto_auth_hmacsha256_state *state,
+                                       const crypto_auth_hmacsha256_key_state *kstate)
+{
+    memcpy(state, &kstate->keyed, sizeof *state);
+
+    return 0;
+}
+
+int
+crypto_auth_hmacsha256_precomputed(unsigned char *out, const unsigned char *in,
+                                   unsigned long long inlen,
+                                   const crypto_auth_hmacsha256_key_state *kstate)
+{
+    crypto_auth_hmacsha256_state state;
+
+    crypto_auth_hmacsha256_init_precomputed(&state, kstate);
+    crypto_auth_hmacsha256_update(&state, in, inlen);
+    crypto_auth_hmacsha256_final(&state, out);
+
+    return 0;
+}
+
+int
+crypto_auth_hmacsha256_verify_precomputed(const unsigned char *h,
+                                          const unsigned char *in,
+                                          unsigned long long inlen,
+                                          const crypto_auth_hmacsha256_key_state *kstate)
+{
+    unsigned char correct[32];
+
+    crypto_auth_hmacsha256_precomputed(correct, in, inlen, kstate);
+
+    return crypto_verify_32(h, correct) | (-(h == correct)) |
+           sodium_memcmp(correct, h, 32);
+}
+
+#define HMACSHA256_BATCH 32U
+
+/* Absorbs the inner and outer key blocks of count keys, lane by lane */
+static void
+_hmacsha256_batch_keys(crypto_hash_sha256_state *ictx,
+                       crypto_hash_sha256_state *octx,
+                       const unsigned char * const *keys, size_t count)
+{
+    CRYPTO_ALIGN(64) sha256_multi_state M;
+    crypto_hash_sha256_state iv;
+    crypto_hash_sha256_state *ctx;
+    unsigned char            pad[64];
+    const size_t             lanes = _crypto_hash_sha256_multi_lanes();
+    size_t                   first;
+    size_t                   n;
+    size_t                   l;
+    size_t                   i;
+    int                      k;
+
+    crypto_hash_sha256_init(&iv);
+    memset(&M, 0, sizeof M);
+    for (first = 0U; first < count; first += n) {
+        n = count - first;
+        if (n > lanes) {
+            n = lanes;
+        }
+        for (k = 0; k < 2; k++) {
+            for (l = 0U; l < n; l++) {
+                memset(pad, k == 0 ? 0x36 : 0x5c, sizeof pad);
+                for (i = 0; i < crypto_auth_hmacsha256_KEYBYTES; i++) {
+                    pad[i] ^= keys[first + l][i];
+                }
+                for (i = 0; i < 8; i++) {
+                    M.h[i][l] = iv.state[i];
+                }
+                for (i = 0; i < 16; i++) {
+                    M.w[i][l] = LOAD32_BE(pad + 4 * i);
+                }
+            }
+            _crypto_hash_sha256_compress_lanes(&M, n);
+            for (l = 0U; l < n; l++) {
+                ctx = (k == 0 ? ictx : octx) + first + l;
+                for (i = 0; i < 8; i++) {
+                    ctx->state[i] = M.h[i][l];
+                }
+                ctx->count = (uint64_t) 64U << 3;
+            }
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(pad, sizeof pad);
+}
+
+int
+crypto_auth_hmacsha256_batch(unsigned char * const *macs,
+                             const unsigned char * const *msgs,
+                             const unsigned long long *lens,
+                             const unsigned char * const *keys, size_t n)
+{
+    crypto_hash_sha256_state  ictx[HMACSHA256_BATCH];
+    crypto_hash_sha256_state  octx[HMACSHA256_BATCH];
+    crypto_hash_sha256_state *ip[HMACSHA256_BATCH];
+    crypto_hash_sha256_state *op[HMACSHA256_BATCH];
+    unsigned char             ihash[HMACSHA256_BATCH][32];
+    unsigned char            *ih[HMACSHA256_BATCH];
+    const unsigned char      *ihc[HMACSHA256_BATCH];
+    unsigned long long        ihlen[HMACSHA256_BATCH];
+    size_t                    first;
+    size_t                    m;
+    size_t                    j;
+
+    for (first = 0U; first < n; first += m) {
+        m = n - first;
+        if (m > HMACSHA256_BATCH) {
+            m = HMACSHA256_BATCH;
+        }
+        _hmacsha256_batch_keys(ictx, octx, keys + first, m);
+        for (j = 0U; j < m; j++) {
+            ip[j]    = &ictx[j];
+            op[j]    = &octx[j];
+            ih[j]    = ihash[j];
+            ihc[j]   = ihash[j];
+            ihlen[j] = sizeof ihash[j];
+        }
+        _crypto_hash_sha256_final_multi(ip, ih, msgs + first, lens + first, m);
+        _crypto_hash_sha256_final_multi(op, macs + first, ihc, ihlen, m);
+    }
+    sodium_memzero(ihash, sizeof ihash);
+
+    return 0;
+}
@@ -6,6 +6,8 @@
 #include "crypto_auth_hmacsha512.h"
 #include "crypto_hash_sha512.h"
 #include "crypto_verify_64.h"
+#include "private/common.h"
+#include "private/sha512_multi.h"
 #include "randombytes.h"
 #include "utils.h"
 
@@ -116,3 +118,146 @@ crypto_auth_hmacsha512_verify(const unsigned char *h, const unsigned char *in,
     return crypto_verify_64(h, correct) | (-(h == correct)) |
            sodium_memcmp(correct, h, 64);
 }
+
+size_t
+crypto_auth_hmacsha512_key_statebytes(void)
+{
+    return sizeof(crypto_auth_hmacsha512_key_state);
+}
+
+int
+crypto_auth_hmacsha512_key_precompute(crypto_auth_hmacsha512_key_state *kstate,
+                                     const unsigned char *key, size_t keylen)
+{
+    return crypto_auth_hmacsha512_init(&kstate->keyed, key, keylen);
+}
+
+int
+crypto_auth_hmacsha512_init_precomputed(crypto_auth_hmacsha512_state *state,
+                                       const crypto_auth_hmacsha512_key_state *kstate)
+{
+    memcpy(state, &kstate->keyed, sizeof *state);
+
+    return 0;
+}
+
+int
+crypto_auth_hmacsha512_precomputed(unsigned char *out, const unsigned char *in,
+                                   unsigned long long inlen,
+                                   const crypto_auth_hmacsha512_key_state *kstate)
+{
+    crypto_auth_hmacsha512_state state;
+
+    crypto_auth_hmacsha512_init_precomputed(&state, kstate);
+    crypto_auth_hmacsha512_update(&state, in, inlen);
+    crypto_auth_hmacsha512_final(&state, out);
+
+    return 0;
+}
+
+int
+crypto_auth_hmacsha512_verify_precomputed(const unsigned char *h,
+                                          const unsigned char *in,
+                                          unsigned long long inlen,
+                                          const crypto_auth_hmacsha512_key_state *kstate)
+{
+    unsigned char correct[64];
+
+    crypto_auth_hmacsha512_precomputed(correct, in, inlen, kstate);
+
+    return crypto_verify_64(h, correct) | (-(h == correct)) |
+           sodium_memcmp(correct, h, 64);
+}
+
+#define HMACSHA512_BATCH 16U
+
+/* Absorbs the inner and outer key blocks of count keys, lane by lane */
+static void
+_hmacsha512_batch_keys(crypto_hash_sha512_state *ictx,
+                       crypto_hash_sha512_state *octx,
+                       const unsigned char * const *keys, size_t count)
+{
+    CRYPTO_ALIGN(64) sha512_multi_state M;
+    crypto_hash_sha512_state iv;
+    crypto_hash_sha512_state *ctx;
+    unsigned char            pad[128];
+    const size_t             lanes = _crypto_hash_sha512_multi_lanes();
+    size_t                   first;
+    size_t                   n;
+    size_t                   l;
+    size_t                   i;
+    int                      k;
+
+    crypto_hash_sha512_init(&iv);
+    memset(&M, 0, sizeof M);
+    for (first = 0U; first < count; first += n) {
+        n = count - first;
+        if (n > lanes) {
+            n = lanes;
+        }
+        for (k = 0; k < 2; k++) {
+            for (l = 0U; l < n; l++) {
+                memset(pad, k == 0 ? 0x36 : 0x5c, sizeof pad);
+                for (i = 0; i < crypto_auth_hmacsha512_KEYBYTES; i++) {
+                    pad[i] ^= keys[first + l][i];
+                }
+                for (i = 0; i < 8; i++) {
+                    M.h[i][l] = iv.state[i];
+                }
+                for (i = 0; i < 16; i++) {
+                    M.w[i][l] = LOAD64_BE(pad + 8 * i);
+                }
+            }
+            _crypto_hash_sha512_compress_lanes(&M, n);
+            for (l = 0U; l < n; l++) {
+                ctx = (k == 0 ? ictx : octx) + first + l;
+                for (i = 0; i < 8; i++) {
+                    ctx->state[i] = M.h[i][l];
+                }
+                ctx->count[0] = 0U;
+                ctx->count[1] = (uint64_t) 128U << 3;
+            }
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(pad, sizeof pad);
+}
+
+int
+crypto_auth_hmacsha512_batch(unsigned char * const *macs,
+                             const unsigned char * const *msgs,
+                             const unsigned long long *lens,
+                             const unsigned char * const *keys, size_t n)
+{
+    crypto_hash_sha512_state  ictx[HMACSHA512_BATCH];
+    crypto_hash_sha512_state  octx[HMACSHA512_BATCH];
+    crypto_hash_sha512_state *ip[HMACSHA512_BATCH];
+    crypto_hash_sha512_state *op[HMACSHA512_BATCH];
+    unsigned char             ihash[HMACSHA512_BATCH][64];
+    unsigned char            *ih[HMACSHA512_BATCH];
+    const unsigned char      *ihc[HMACSHA512_BATCH];
+    unsigned long long        ihlen[HMACSHA512_BATCH];
+    size_t                    first;
+    size_t                    m;
+    size_t                    j;
+
+    for (first = 0U; first < n; first += m) {
+        m = n - first;
+        if (m > HMACSHA512_BATCH) {
+            m = HMACSHA512_BATCH;
+        }
+        _hmacsha512_batch_keys(ictx, octx, keys + first, m);
+        for (j = 0U; j < m; j++) {
+            ip[j]    = &ictx[j];
+            op[j]    = &octx[j];
+            ih[j]    = ihash[j];
+            ihc[j]   = ihash[j];
+            ihlen[j] = sizeof ihash[j];
+        }
+        _crypto_hash_sha512_final_multi(ip, ih, msgs + first, lens + first, m);
+        _crypto_hash_sha512_final_multi(op, macs + first, ihc, ihlen, m);
+    }
+    sodium_memzero(ihash, sizeof ihash);
+
+    return 0;
+}
@@ -91,3 +91,52 @@ crypto_auth_hmacsha512256_verify(const unsigned char *h,
     return crypto_verify_32(h, correct) | (-(h == correct)) |
            sodium_memcmp(correct, h, 32);
 }
+
+size_t
+crypto_auth_hmacsha512256_key_statebytes(void)
+{
+    return sizeof(crypto_auth_hmacsha512256_key_state);
+}
+
+int
+crypto_auth_hmacsha512256_key_precompute(crypto_auth_hmacsha512256_key_state *kstate,
+                                        const unsigned char *key, size_t keylen)
+{
+    return crypto_auth_hmacsha512_key_precompute(kstate, key, keylen);
+}
+
+int
+crypto_auth_hmacsha512256_init_precomputed(crypto_auth_hmacsha512256_state *state,
+                                          const crypto_auth_hmacsha512256_key_state *kstate)
+{
+    return crypto_auth_hmacsha512_init_precomputed(state, kstate);
+}
+
+int
+crypto_auth_hmacsha512256_precomputed(unsigned char *out,
+                                      const unsigned char *in,
+                                      unsigned long long inlen,
+                                      const crypto_auth_hmacsha512256_key_state *kstate)
+{
+    crypto_auth_hmacsha512256_state state;
+
+    crypto_auth_hmacsha512256_init_precomputed(&state, kstate);
+    crypto_auth_hmacsha512256_update(&state, in, inlen);
+    crypto_auth_hmacsha512256_final(&state, out);
+
+    return 0;
+}
+
+int
+crypto_auth_hmacsha512256_verify_precomputed(const unsigned char *h,
+                                             const unsigned char *in,
+                                             unsigned long long   inlen,
+                                             const crypto_auth_hmacsha512256_key_state *kstate)
+{
+    unsigned char correct[32];
+
+    crypto_auth_hmacsha512256_precomputed(correct, in, inlen, kstate);
+
+    return crypto_verify_32(h, correct) | (-(h == correct)) |
+           sodium_memcmp(correct, h, 32);
+}
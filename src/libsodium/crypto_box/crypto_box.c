@@ -1,5 +1,6 @@
 
 #include "crypto_box.h"
+#include "private/aliases.h"
 
 size_t
 crypto_box_seedbytes(void)
@@ -73,6 +74,7 @@ crypto_box_keypair(unsigned char *pk, unsigned char *sk)
 {
     return crypto_box_curve25519xsalsa20poly1305_keypair(pk, sk);
 }
+SODIUM_ALIAS_DEF(crypto_box_keypair);
 
 int
 crypto_box_beforenm(unsigned char *k, const unsigned char *pk,
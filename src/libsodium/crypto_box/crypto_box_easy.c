@@ -6,6 +6,7 @@
 #include "core.h"
 #include "crypto_box.h"
 #include "crypto_secretbox.h"
+#include "private/aliases.h"
 #include "private/common.h"
 #include "utils.h"
 
@@ -59,6 +60,7 @@ crypto_box_easy(unsigned char *c, const unsigned char *m,
     return crypto_box_detached(c + crypto_box_MACBYTES, c, m, mlen, n,
                                pk, sk);
 }
+SODIUM_ALIAS_DEF(crypto_box_easy);
 
 int
 crypto_box_open_detached_afternm(unsigned char *m, const unsigned char *c,
@@ -113,3 +115,4 @@ crypto_box_open_easy(unsigned char *m, const unsigned char *c,
                                     clen - crypto_box_MACBYTES,
                                     n, pk, sk);
 }
+SODIUM_ALIAS_DEF(crypto_box_open_easy);
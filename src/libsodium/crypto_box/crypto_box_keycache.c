@@ -0,0 +1,222 @@
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "crypto_box.h"
+#include "crypto_generichash_blake2b.h"
+#include "private/common.h"
+#include "utils.h"
+
+#define KEYCACHE_NONE             SIZE_MAX
+#define KEYCACHE_IDBYTES          32U
+#define KEYCACHE_CAPACITY_MAX     (1U << 24)
+
+/*
+ * Entries are identified by BLAKE2b(key=sk, pk), found through a chained
+ * hash table, and kept in a doubly-linked list in least recently used
+ * order, so that the oldest entry can be evicted in constant time.
+ */
+
+typedef struct keycache_entry {
+    unsigned char id[KEYCACHE_IDBYTES];
+    unsigned char k[crypto_box_BEFORENMBYTES];
+    size_t        chain;
+    size_t        prev;
+    size_t        next;
+} keycache_entry;
+
+static size_t
+_keycache_bucket(const crypto_box_keycache *cache, const unsigned char *id)
+{
+    return (size_t) (LOAD64_LE(id) & (uint64_t) (cache->buckets_count - 1U));
+}
+
+static void
+_keycache_unlink(crypto_box_keycache *cache, size_t i)
+{
+    keycache_entry *entries = (keycache_entry *) cache->entries;
+
+    if (entries[i].prev != KEYCACHE_NONE) {
+        entries[entries[i].prev].next = entries[i].next;
+    } else {
+        cache->head = entries[i].next;
+    }
+    if (entries[i].next != KEYCACHE_NONE) {
+        entries[entries[i].next].prev = entries[i].prev;
+    } else {
+        cache->tail = entries[i].prev;
+    }
+}
+
+static void
+_keycache_push_front(crypto_box_keycache *cache, size_t i)
+{
+    keycache_entry *entries = (keycache_entry *) cache->entries;
+
+    entries[i].prev = KEYCACHE_NONE;
+    entries[i].next = cache->head;
+    if (cache->head != KEYCACHE_NONE) {
+        entries[cache->head].prev = i;
+    } else {
+        cache->tail = i;
+    }
+    cache->head = i;
+}
+
+static void
+_keycache_evict(crypto_box_keycache *cache, size_t i)
+{
+    keycache_entry *entries = (keycache_entry *) cache->entries;
+    size_t         *buckets = (size_t *) cache->buckets;
+    size_t         *p;
+
+    p = &buckets[_keycache_bucket(cache, entries[i].id)];
+    while (*p != i) {
+        p = &entries[*p].chain;
+    }
+    *p = entries[i].chain;
+    _keycache_unlink(cache, i);
+    sodium_memzero(&entries[i], sizeof entries[i]);
+}
+
+int
+crypto_box_keycache_init(crypto_box_keycache *cache, size_t capacity)
+{
+    size_t buckets_count;
+    size_t i;
+
+    memset(cache, 0, sizeof *cache);
+    if (capacity <= 0U || capacity > KEYCACHE_CAPACITY_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    buckets_count = 1U;
+    while (buckets_count < capacity) {
+        buckets_count <<= 1;
+    }
+    cache->entries = sodium_allocarray(capacity, sizeof(keycache_entry));
+    cache->buckets = sodium_allocarray(buckets_count, sizeof(size_t));
+    if (cache->entries == NULL || cache->buckets == NULL) {
+        crypto_box_keycache_free(cache);
+        errno = ENOMEM;
+        return -1;
+    }
+    for (i = 0U; i < buckets_count; i++) {
+        ((size_t *) cache->buckets)[i] = KEYCACHE_NONE;
+    }
+    cache->capacity      = capacity;
+    cache->buckets_count = buckets_count;
+    cache->count         = 0U;
+    cache->head          = KEYCACHE_NONE;
+    cache->tail          = KEYCACHE_NONE;
+
+    return 0;
+}
+
+void
+crypto_box_keycache_free(crypto_box_keycache *cache)
+{
+    sodium_free(cache->entries);
+    sodium_free(cache->buckets);
+    memset(cache, 0, sizeof *cache);
+}
+
+void
+crypto_box_keycache_clear(crypto_box_keycache *cache)
+{
+    size_t i;
+
+    for (i = 0U; i < cache->buckets_count; i++) {
+        ((size_t *) cache->buckets)[i] = KEYCACHE_NONE;
+    }
+    sodium_memzero(cache->entries, cache->capacity * sizeof(keycache_entry));
+    cache->count = 0U;
+    cache->head  = KEYCACHE_NONE;
+    cache->tail  = KEYCACHE_NONE;
+}
+
+int
+crypto_box_keycache_beforenm(crypto_box_keycache *cache, unsigned char *k,
+                             const unsigned char *pk, const unsigned char *sk)
+{
+    keycache_entry *entries = (keycache_entry *) cache->entries;
+    size_t         *buckets = (size_t *) cache->buckets;
+    unsigned char   id[KEYCACHE_IDBYTES];
+    size_t          bucket;
+    size_t          i;
+
+    if (entries == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+    COMPILER_ASSERT(crypto_box_SECRETKEYBYTES <= crypto_generichash_blake2b_KEYBYTES_MAX);
+    crypto_generichash_blake2b(id, sizeof id, pk, crypto_box_PUBLICKEYBYTES,
+                               sk, crypto_box_SECRETKEYBYTES);
+    bucket = _keycache_bucket(cache, id);
+    for (i = buckets[bucket]; i != KEYCACHE_NONE; i = entries[i].chain) {
+        if (sodium_memcmp(entries[i].id, id, sizeof id) == 0) {
+            if (cache->head != i) {
+                _keycache_unlink(cache, i);
+                _keycache_push_front(cache, i);
+            }
+            memcpy(k, entries[i].k, crypto_box_BEFORENMBYTES);
+            sodium_memzero(id, sizeof id);
+            return 0;
+        }
+    }
+    if (crypto_box_beforenm(k, pk, sk) != 0) {
+        sodium_memzero(id, sizeof id);
+        return -1;
+    }
+    if (cache->count < cache->capacity) {
+        i = cache->count++;
+    } else {
+        i = cache->tail;
+        _keycache_evict(cache, i);
+    }
+    memcpy(entries[i].id, id, sizeof id);
+    memcpy(entries[i].k, k, crypto_box_BEFORENMBYTES);
+    entries[i].chain = buckets[bucket];
+    buckets[bucket]  = i;
+    _keycache_push_front(cache, i);
+    sodium_memzero(id, sizeof id);
+
+    return 0;
+}
+
+int
+crypto_box_keycache_easy(crypto_box_keycache *cache,
+                         unsigned char *c, const unsigned char *m,
+                         unsigned long long mlen, const unsigned char *n,
+                         const unsigned char *pk, const unsigned char *sk)
+{
+    unsigned char k[crypto_box_BEFORENMBYTES];
+    int           ret;
+
+    if (crypto_box_keycache_beforenm(cache, k, pk, sk) != 0) {
+        return -1;
+    }
+    ret = crypto_box_easy_afternm(c, m, mlen, n, k);
+    sodium_memzero(k, sizeof k);
+
+    return ret;
+}
+
+int
+crypto_box_keycache_open_easy(crypto_box_keycache *cache,
+                              unsigned char *m, const unsigned char *c,
+                              unsigned long long clen, const unsigned char *n,
+                              const unsigned char *pk, const unsigned char *sk)
+{
+    unsigned char k[crypto_box_BEFORENMBYTES];
+    int           ret;
+
+    if (crypto_box_keycache_beforenm(cache, k, pk, sk) != 0) {
+        return -1;
+    }
+    ret = crypto_box_open_easy_afternm(m, c, clen, n, k);
+    sodium_memzero(k, sizeof k);
+
+    return ret;
+}
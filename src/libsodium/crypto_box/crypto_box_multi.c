@@ -0,0 +1,239 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_chacha20poly1305.h"
+#include "crypto_aead_xchacha20poly1305.h"
+#include "crypto_box.h"
+#include "crypto_core_hchacha20.h"
+#include "crypto_scalarmult_curve25519.h"
+#include "private/common.h"
+#include "randombytes.h"
+#include "utils.h"
+
+#define MULTI_BATCH_CHUNK 64U
+#define MULTI_IDBYTES     16U
+#define MULTI_KEYBYTES    crypto_aead_xchacha20poly1305_ietf_KEYBYTES
+
+/*
+ * A slot is: [identifier (16)][wrapped key (32)][mac (16)]
+ *
+ * The identifier and the wrapping key are derived from the X25519 shared
+ * secret with HChaCha20. The message key is wrapped with
+ * ChaCha20-Poly1305, using the ephemeral and the recipient public keys as
+ * additional data. The message is encrypted with the whole header as
+ * additional data. Both keys are only used once, so nonces are all zeros.
+ */
+
+static void
+_multi_slot_keys(unsigned char id[MULTI_IDBYTES],
+                 unsigned char wk[crypto_aead_chacha20poly1305_ietf_KEYBYTES],
+                 const unsigned char *s)
+{
+    unsigned char h[crypto_core_hchacha20_OUTPUTBYTES];
+
+    COMPILER_ASSERT(crypto_aead_chacha20poly1305_ietf_KEYBYTES ==
+                    crypto_core_hchacha20_OUTPUTBYTES);
+    crypto_core_hchacha20(h, (const unsigned char *) "box_multi_slotid", s, NULL);
+    memcpy(id, h, MULTI_IDBYTES);
+    crypto_core_hchacha20(wk, (const unsigned char *) "box_multi_wrapky", s, NULL);
+    sodium_memzero(h, sizeof h);
+}
+
+static int
+_multi_slot_cmp(const void *a, const void *b)
+{
+    return memcmp(a, b, MULTI_IDBYTES);
+}
+
+/*
+ * Identifiers are uniformly distributed, so the position of a slot is
+ * guessed from its identifier, and the sorted slots are scanned from there.
+ */
+static const unsigned char *
+_multi_slot_find(const unsigned char *slots, size_t count,
+                 const unsigned char id[MULTI_IDBYTES])
+{
+    size_t i;
+    int    d;
+
+    i = (size_t) (((LOAD64_BE(id) >> 32) * (uint64_t) count) >> 32);
+    d = memcmp(slots + i * crypto_box_MULTI_SLOTBYTES, id, MULTI_IDBYTES);
+    while (d < 0 && i + 1U < count) {
+        i++;
+        d = memcmp(slots + i * crypto_box_MULTI_SLOTBYTES, id, MULTI_IDBYTES);
+    }
+    while (d > 0 && i > 0U) {
+        i--;
+        d = memcmp(slots + i * crypto_box_MULTI_SLOTBYTES, id, MULTI_IDBYTES);
+    }
+    if (d != 0) {
+        return NULL;
+    }
+    return slots + i * crypto_box_MULTI_SLOTBYTES;
+}
+
+unsigned long long
+crypto_box_multi_bytes(size_t count, unsigned long long mlen)
+{
+    return (unsigned long long) crypto_box_MULTI_HEADERBYTES +
+        (unsigned long long) count * crypto_box_MULTI_SLOTBYTES +
+        mlen + crypto_box_MULTI_ABYTES;
+}
+
+int
+crypto_box_multi_seal(unsigned char *c, unsigned long long *clen_p,
+                      const unsigned char *m, unsigned long long mlen,
+                      const unsigned char * const *pk, size_t count)
+{
+    static const unsigned char zero[crypto_aead_xchacha20poly1305_ietf_NPUBBYTES] = { 0 };
+    unsigned char              ad[2 * crypto_box_PUBLICKEYBYTES];
+    unsigned char              wk[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char              k[MULTI_KEYBYTES];
+    unsigned char              esk[crypto_box_SECRETKEYBYTES];
+    unsigned char              s[MULTI_BATCH_CHUNK][crypto_scalarmult_curve25519_BYTES];
+    unsigned char             *s_p[MULTI_BATCH_CHUNK];
+    const unsigned char       *esk_p[MULTI_BATCH_CHUNK];
+    unsigned char             *slots = c + crypto_box_MULTI_HEADERBYTES;
+    unsigned char             *slot;
+    size_t                     headerlen;
+    size_t                     chunk;
+    size_t                     i;
+    size_t                     j;
+    int                        ret = 0;
+
+    if (clen_p != NULL) {
+        *clen_p = 0U;
+    }
+    if (count == 0U || count > crypto_box_MULTI_RECIPIENTS_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > crypto_aead_xchacha20poly1305_ietf_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    COMPILER_ASSERT(crypto_box_MULTI_SLOTBYTES == MULTI_IDBYTES + MULTI_KEYBYTES +
+                    crypto_aead_chacha20poly1305_ietf_ABYTES);
+    COMPILER_ASSERT(crypto_box_MULTI_ABYTES == crypto_aead_xchacha20poly1305_ietf_ABYTES);
+    headerlen = crypto_box_MULTI_HEADERBYTES + count * crypto_box_MULTI_SLOTBYTES;
+    for (j = 0U; j < MULTI_BATCH_CHUNK; j++) {
+        s_p[j]   = s[j];
+        esk_p[j] = esk;
+    }
+    crypto_aead_xchacha20poly1305_ietf_keygen(k);
+    randombytes_buf(esk, sizeof esk);
+    crypto_scalarmult_curve25519_base(c, esk);
+    STORE32_LE(c + crypto_box_PUBLICKEYBYTES, (uint32_t) count);
+    memcpy(ad, c, crypto_box_PUBLICKEYBYTES);
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > MULTI_BATCH_CHUNK) {
+            chunk = MULTI_BATCH_CHUNK;
+        }
+        if (crypto_scalarmult_curve25519_batch(s_p, esk_p, &pk[i], chunk) != 0) {
+            ret = -1;
+            break;
+        }
+        for (j = 0U; j < chunk; j++) {
+            slot = slots + (i + j) * crypto_box_MULTI_SLOTBYTES;
+            _multi_slot_keys(slot, wk, s[j]);
+            memcpy(ad + crypto_box_PUBLICKEYBYTES, pk[i + j], crypto_box_PUBLICKEYBYTES);
+            crypto_aead_chacha20poly1305_ietf_encrypt_detached
+                (slot + MULTI_IDBYTES, slot + MULTI_IDBYTES + MULTI_KEYBYTES, NULL,
+                 k, sizeof k, ad, sizeof ad, NULL, zero, wk);
+        }
+    }
+    if (ret == 0) {
+        qsort(slots, count, crypto_box_MULTI_SLOTBYTES, _multi_slot_cmp);
+        crypto_aead_xchacha20poly1305_ietf_encrypt(c + headerlen, NULL, m, mlen,
+                                                   c, headerlen, NULL, zero, k);
+        if (clen_p != NULL) {
+            *clen_p = crypto_box_multi_bytes(count, mlen);
+        }
+    } else {
+        memset(c, 0, headerlen);
+    }
+    sodium_memzero(esk, sizeof esk);
+    sodium_memzero(s, sizeof s);
+    sodium_memzero(wk, sizeof wk);
+    sodium_memzero(k, sizeof k);
+
+    return ret;
+}
+
+int
+crypto_box_multi_open(unsigned char *m, unsigned long long *mlen_p,
+                      const unsigned char *c, unsigned long long clen,
+                      const unsigned char *pk, const unsigned char *sk)
+{
+    static const unsigned char zero[crypto_aead_xchacha20poly1305_ietf_NPUBBYTES] = { 0 };
+    unsigned char              ad[2 * crypto_box_PUBLICKEYBYTES];
+    unsigned char              id[MULTI_IDBYTES];
+    unsigned char              wk[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char              k[MULTI_KEYBYTES];
+    unsigned char              s[crypto_scalarmult_curve25519_BYTES];
+    const unsigned char       *slot;
+    unsigned long long         headerlen;
+    size_t                     count;
+    int                        ret = -1;
+
+    if (mlen_p != NULL) {
+        *mlen_p = 0U;
+    }
+    if (clen < crypto_box_multi_bytes(1U, 0U)) {
+        return -1;
+    }
+    count = (size_t) LOAD32_LE(c + crypto_box_PUBLICKEYBYTES);
+    if (count == 0U || count > crypto_box_MULTI_RECIPIENTS_MAX ||
+        clen < crypto_box_multi_bytes(count, 0U)) {
+        return -1;
+    }
+    headerlen = crypto_box_MULTI_HEADERBYTES +
+        (unsigned long long) count * crypto_box_MULTI_SLOTBYTES;
+    if (crypto_scalarmult_curve25519(s, sk, c) != 0) {
+        return -1;
+    }
+    _multi_slot_keys(id, wk, s);
+    memcpy(ad, c, crypto_box_PUBLICKEYBYTES);
+    memcpy(ad + crypto_box_PUBLICKEYBYTES, pk, crypto_box_PUBLICKEYBYTES);
+    if ((slot = _multi_slot_find(c + crypto_box_MULTI_HEADERBYTES, count, id)) != NULL &&
+        crypto_aead_chacha20poly1305_ietf_decrypt_detached
+            (k, NULL, slot + MULTI_IDBYTES, MULTI_KEYBYTES,
+             slot + MULTI_IDBYTES + MULTI_KEYBYTES, ad, sizeof ad, zero, wk) == 0) {
+        ret = crypto_aead_xchacha20poly1305_ietf_decrypt(m, mlen_p, NULL, c + headerlen,
+                                                         clen - headerlen, c, headerlen,
+                                                         zero, k);
+    }
+    sodium_memzero(s, sizeof s);
+    sodium_memzero(wk, sizeof wk);
+    sodium_memzero(k, sizeof k);
+
+    return ret;
+}
+
+size_t
+crypto_box_multi_headerbytes(void)
+{
+    return crypto_box_MULTI_HEADERBYTES;
+}
+
+size_t
+crypto_box_multi_slotbytes(void)
+{
+    return crypto_box_MULTI_SLOTBYTES;
+}
+
+size_t
+crypto_box_multi_abytes(void)
+{
+    return crypto_box_MULTI_ABYTES;
+}
+
+size_t
+crypto_box_multi_recipients_max(void)
+{
+    return crypto_box_MULTI_RECIPIENTS_MAX;
+}
@@ -1,23 +1,38 @@
 
+#include <errno.h>
 #include <string.h>
+#include <time.h>
 
 #include "crypto_box.h"
+#include "crypto_core_hsalsa20.h"
 #include "crypto_generichash.h"
+#include "crypto_generichash_blake2b.h"
+#include "crypto_scalarmult_curve25519.h"
+#include "crypto_secretstream_xchacha20poly1305.h"
+#include "private/aliases.h"
 #include "private/common.h"
+#include "private/executor.h"
+#include "randombytes.h"
 #include "utils.h"
 
+SODIUM_ALIAS_PROTO(crypto_box_easy);
+SODIUM_ALIAS_PROTO(crypto_box_keypair);
+SODIUM_ALIAS_PROTO(crypto_box_open_easy);
+SODIUM_ALIAS_PROTO(crypto_generichash);
+
+#define SEAL_BATCH_CHUNK 64U
+
 static int
 _crypto_box_seal_nonce(unsigned char *nonce,
                        const unsigned char *pk1, const unsigned char *pk2)
 {
-    crypto_generichash_state st;
+    unsigned char pks[2 * crypto_box_PUBLICKEYBYTES];
 
-    crypto_generichash_init(&st, NULL, 0U, crypto_box_NONCEBYTES);
-    crypto_generichash_update(&st, pk1, crypto_box_PUBLICKEYBYTES);
-    crypto_generichash_update(&st, pk2, crypto_box_PUBLICKEYBYTES);
-    crypto_generichash_final(&st, nonce, crypto_box_NONCEBYTES);
+    memcpy(pks, pk1, crypto_box_PUBLICKEYBYTES);
+    memcpy(pks + crypto_box_PUBLICKEYBYTES, pk2, crypto_box_PUBLICKEYBYTES);
 
-    return 0;
+    return crypto_generichash(nonce, crypto_box_NONCEBYTES, pks, sizeof pks,
+                              NULL, 0U);
 }
 
 int
@@ -43,6 +58,232 @@ crypto_box_seal(unsigned char *c, const unsigned char *m,
     return ret;
 }
 
+int
+crypto_box_seal_batch(unsigned char * const *c,
+                      const unsigned char * const *m,
+                      const unsigned long long *mlen,
+                      const unsigned char * const *pk, size_t count)
+{
+    static const unsigned char zero[16] = { 0 };
+    unsigned char              nonce[crypto_box_NONCEBYTES];
+    unsigned char              k[crypto_box_BEFORENMBYTES];
+    unsigned char              esk[SEAL_BATCH_CHUNK][crypto_box_SECRETKEYBYTES];
+    unsigned char              s[SEAL_BATCH_CHUNK][crypto_scalarmult_curve25519_BYTES];
+    unsigned char             *s_p[SEAL_BATCH_CHUNK];
+    const unsigned char       *esk_p[SEAL_BATCH_CHUNK];
+    size_t                     chunk;
+    size_t                     i;
+    size_t                     j;
+    int                        ret = 0;
+
+    COMPILER_ASSERT(crypto_box_SECRETKEYBYTES ==
+                    crypto_scalarmult_curve25519_SCALARBYTES);
+    for (j = 0U; j < SEAL_BATCH_CHUNK; j++) {
+        s_p[j]   = s[j];
+        esk_p[j] = esk[j];
+    }
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > SEAL_BATCH_CHUNK) {
+            chunk = SEAL_BATCH_CHUNK;
+        }
+        randombytes_buf(esk, chunk * sizeof esk[0]);
+        for (j = 0U; j < chunk; j++) {
+            crypto_scalarmult_curve25519_base(c[i + j], esk[j]);
+        }
+        if (crypto_scalarmult_curve25519_batch(s_p, esk_p, &pk[i], chunk) != 0) {
+            ret = -1;
+        }
+        for (j = 0U; j < chunk; j++) {
+            if (sodium_is_zero(s[j], sizeof s[j])) {
+                continue;
+            }
+            crypto_core_hsalsa20(k, zero, s[j], NULL);
+            _crypto_box_seal_nonce(nonce, c[i + j], pk[i + j]);
+            if (crypto_box_easy_afternm(c[i + j] + crypto_box_PUBLICKEYBYTES,
+                                        m[i + j], mlen[i + j], nonce, k) != 0) {
+                ret = -1; /* LCOV_EXCL_LINE */
+            }
+        }
+    }
+    sodium_memzero(esk, sizeof esk);
+    sodium_memzero(s, sizeof s);
+    sodium_memzero(k, sizeof k);
+    sodium_memzero(nonce, sizeof nonce);
+
+    return ret;
+}
+
+/*
+ * Each pool holds the public keys of a batch, followed by their secret
+ * keys. The spare pool is always being refilled by a task, whose secret
+ * keys are drawn on the calling thread before it starts.
+ */
+typedef struct seal_ctx_state {
+    sodium_executor_task task;
+    unsigned char       *ready;
+    unsigned char       *spare;
+    size_t               ready_count;
+    size_t               batch;
+    unsigned char        epk[crypto_box_PUBLICKEYBYTES];
+    unsigned char        esk[crypto_box_SECRETKEYBYTES];
+    unsigned char        recipients[crypto_box_SEAL_CTX_REUSE_MAX]
+                                   [crypto_box_PUBLICKEYBYTES];
+    unsigned int         uses;
+    unsigned int         reuse_max;
+    unsigned int         reuse_seconds;
+    time_t               started;
+} seal_ctx_state;
+
+static void
+_seal_ctx_refill(void *st_)
+{
+    seal_ctx_state *st = (seal_ctx_state *) st_;
+
+    crypto_scalarmult_curve25519_base_batch
+        (st->spare, st->spare + st->batch * crypto_box_PUBLICKEYBYTES,
+         st->batch);
+}
+
+static void
+_seal_ctx_start_refill(seal_ctx_state *st)
+{
+    randombytes_buf(st->spare + st->batch * crypto_box_PUBLICKEYBYTES,
+                    st->batch * crypto_box_SECRETKEYBYTES);
+    _sodium_executor_start(&st->task, _seal_ctx_refill, st);
+}
+
+static void
+_seal_ctx_next_key(seal_ctx_state *st)
+{
+    unsigned char *pool;
+    unsigned char *epk;
+    unsigned char *esk;
+
+    if (st->ready_count == 0U) {
+        _sodium_executor_finish(&st->task);
+        pool            = st->ready;
+        st->ready       = st->spare;
+        st->spare       = pool;
+        st->ready_count = st->batch;
+        _seal_ctx_start_refill(st);
+    }
+    st->ready_count--;
+    epk = st->ready + st->ready_count * crypto_box_PUBLICKEYBYTES;
+    esk = st->ready + st->batch * crypto_box_PUBLICKEYBYTES +
+        st->ready_count * crypto_box_SECRETKEYBYTES;
+    memcpy(st->epk, epk, sizeof st->epk);
+    memcpy(st->esk, esk, sizeof st->esk);
+    sodium_memzero(esk, crypto_box_SECRETKEYBYTES);
+}
+
+static int
+_seal_ctx_can_reuse(const seal_ctx_state *st, const unsigned char *pk,
+                    time_t now)
+{
+    unsigned int i;
+
+    if (st->uses == 0U || st->uses >= st->reuse_max ||
+        now == (time_t) -1 || now < st->started ||
+        now - st->started >= (time_t) st->reuse_seconds) {
+        return 0;
+    }
+    for (i = 0U; i < st->uses; i++) {
+        if (memcmp(st->recipients[i], pk, crypto_box_PUBLICKEYBYTES) == 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int
+crypto_box_seal_ctx_init(crypto_box_seal_ctx *ctx, size_t batch,
+                         unsigned int reuse_max, unsigned int reuse_seconds)
+{
+    seal_ctx_state *st;
+
+    ctx->state = NULL;
+    if (batch == 0U) {
+        batch = SEAL_BATCH_CHUNK;
+    }
+    if (batch > crypto_box_SEAL_CTX_BATCH_MAX ||
+        reuse_max > crypto_box_SEAL_CTX_REUSE_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    COMPILER_ASSERT(crypto_box_PUBLICKEYBYTES ==
+                    crypto_scalarmult_curve25519_BYTES);
+    st = (seal_ctx_state *)
+        sodium_malloc(sizeof *st + 2U * batch *
+                      (crypto_box_PUBLICKEYBYTES + crypto_box_SECRETKEYBYTES));
+    if (st == NULL) {
+        return -1;
+    }
+    memset(st, 0, sizeof *st);
+    st->ready         = (unsigned char *) (void *) (st + 1);
+    st->spare         = st->ready +
+        batch * (crypto_box_PUBLICKEYBYTES + crypto_box_SECRETKEYBYTES);
+    st->batch         = batch;
+    st->reuse_max     = reuse_max;
+    st->reuse_seconds = reuse_seconds;
+    randombytes_buf(st->ready + batch * crypto_box_PUBLICKEYBYTES,
+                    batch * crypto_box_SECRETKEYBYTES);
+    crypto_scalarmult_curve25519_base_batch
+        (st->ready, st->ready + batch * crypto_box_PUBLICKEYBYTES, batch);
+    st->ready_count = batch;
+    _seal_ctx_start_refill(st);
+    ctx->state = st;
+
+    return 0;
+}
+
+void
+crypto_box_seal_ctx_free(crypto_box_seal_ctx *ctx)
+{
+    seal_ctx_state *st = (seal_ctx_state *) ctx->state;
+
+    if (st == NULL) {
+        return;
+    }
+    _sodium_executor_finish(&st->task);
+    sodium_free(st);
+    ctx->state = NULL;
+}
+
+int
+crypto_box_seal_ctx_seal(crypto_box_seal_ctx *ctx, unsigned char *c,
+                         const unsigned char *m, unsigned long long mlen,
+                         const unsigned char *pk)
+{
+    seal_ctx_state *st = (seal_ctx_state *) ctx->state;
+    unsigned char   nonce[crypto_box_NONCEBYTES];
+    time_t          now = (time_t) -1;
+    int             ret;
+
+    if (st->reuse_max > 1U) {
+        now = time(NULL);
+    }
+    if (_seal_ctx_can_reuse(st, pk, now) == 0) {
+        _seal_ctx_next_key(st);
+        st->uses    = 0U;
+        st->started = now;
+    }
+    if (st->reuse_max > 1U) {
+        memcpy(st->recipients[st->uses], pk, crypto_box_PUBLICKEYBYTES);
+    }
+    st->uses++;
+    _crypto_box_seal_nonce(nonce, st->epk, pk);
+    ret = crypto_box_easy(c + crypto_box_PUBLICKEYBYTES, m, mlen,
+                          nonce, pk, st->esk);
+    memcpy(c, st->epk, crypto_box_PUBLICKEYBYTES);
+    if (st->reuse_max <= 1U) {
+        sodium_memzero(st->esk, sizeof st->esk);
+    }
+    sodium_memzero(nonce, sizeof nonce);
+
+    return ret;
+}
+
 int
 crypto_box_seal_open(unsigned char *m, const unsigned char *c,
                      unsigned long long clen,
@@ -61,6 +302,82 @@ crypto_box_seal_open(unsigned char *m, const unsigned char *c,
                                 nonce, c, sk);
 }
 
+/*
+ * The secretstream key is BLAKE2b(s || epk || pk), s being the X25519
+ * shared secret, so that it is bound to both public keys.
+ */
+static int
+_crypto_box_seal_stream_key(unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES],
+                            const unsigned char *sk, const unsigned char *pk_peer,
+                            const unsigned char *epk, const unsigned char *pk)
+{
+    static const char                personal[] = "box_seal_stream";
+    crypto_generichash_blake2b_state st;
+    unsigned char                    s[crypto_scalarmult_curve25519_BYTES];
+
+    COMPILER_ASSERT(sizeof personal == crypto_generichash_blake2b_PERSONALBYTES);
+    if (crypto_scalarmult_curve25519(s, sk, pk_peer) != 0) {
+        return -1;
+    }
+    crypto_generichash_blake2b_init_salt_personal(&st, NULL, 0U,
+                                                  crypto_secretstream_xchacha20poly1305_KEYBYTES,
+                                                  NULL,
+                                                  (const unsigned char *) personal);
+    crypto_generichash_blake2b_update(&st, s, sizeof s);
+    crypto_generichash_blake2b_update(&st, epk, crypto_box_PUBLICKEYBYTES);
+    crypto_generichash_blake2b_update(&st, pk, crypto_box_PUBLICKEYBYTES);
+    crypto_generichash_blake2b_final(&st, k, crypto_secretstream_xchacha20poly1305_KEYBYTES);
+    sodium_memzero(s, sizeof s);
+    sodium_memzero(&st, sizeof st);
+
+    return 0;
+}
+
+int
+crypto_box_seal_stream_init_push(crypto_secretstream_xchacha20poly1305_state *state,
+                                 unsigned char header[crypto_box_SEAL_STREAM_HEADERBYTES],
+                                 const unsigned char *pk)
+{
+    unsigned char esk[crypto_box_SECRETKEYBYTES];
+    unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES];
+    int           ret = -1;
+
+    if (crypto_box_keypair(header, esk) != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (_crypto_box_seal_stream_key(k, esk, pk, header, pk) == 0) {
+        ret = crypto_secretstream_xchacha20poly1305_init_push
+            (state, header + crypto_box_PUBLICKEYBYTES, k);
+    }
+    sodium_memzero(esk, sizeof esk);
+    sodium_memzero(k, sizeof k);
+
+    return ret;
+}
+
+int
+crypto_box_seal_stream_init_pull(crypto_secretstream_xchacha20poly1305_state *state,
+                                 const unsigned char header[crypto_box_SEAL_STREAM_HEADERBYTES],
+                                 const unsigned char *pk, const unsigned char *sk)
+{
+    unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES];
+    int           ret = -1;
+
+    if (_crypto_box_seal_stream_key(k, sk, header, header, pk) == 0) {
+        ret = crypto_secretstream_xchacha20poly1305_init_pull
+            (state, header + crypto_box_PUBLICKEYBYTES, k);
+    }
+    sodium_memzero(k, sizeof k);
+
+    return ret;
+}
+
+size_t
+crypto_box_seal_stream_headerbytes(void)
+{
+    return crypto_box_SEAL_STREAM_HEADERBYTES;
+}
+
 size_t
 crypto_box_sealbytes(void)
 {
@@ -7,6 +7,7 @@
 #include "crypto_hash_sha512.h"
 #include "private/common.h"
 #include "private/ed25519_ref10.h"
+#include "private/sha512_multi.h"
 #include "randombytes.h"
 #include "utils.h"
 
@@ -25,6 +26,21 @@ crypto_core_ed25519_is_valid_point(const unsigned char *p)
     return 1;
 }
 
+int
+crypto_core_ed25519_is_valid_point_vartime(const unsigned char *p)
+{
+    ge25519_p3 p_p3;
+
+    if (ge25519_is_canonical(p) == 0 ||
+        ge25519_has_small_order(p) != 0 ||
+        ge25519_frombytes(&p_p3, p) != 0 ||
+        ge25519_is_on_curve(&p_p3) == 0 ||
+        ge25519_is_on_main_subgroup_vartime(&p_p3) == 0) {
+        return 0;
+    }
+    return 1;
+}
+
 int
 crypto_core_ed25519_add(unsigned char *r,
                         const unsigned char *p, const unsigned char *q)
@@ -155,6 +171,136 @@ crypto_core_ed25519_from_string_ro(unsigned char p[crypto_core_ed25519_BYTES],
     return crypto_core_ed25519_add(p, &px[0], &px[crypto_core_ed25519_BYTES]);
 }
 
+#define STRING_BATCH 8U
+
+static int
+_string_to_points_batch(unsigned char *p, size_t n, const char *ctx,
+                        const unsigned char * const *msgs,
+                        const size_t *msg_lens, size_t count)
+{
+    crypto_hash_sha512_state  st0;
+    crypto_hash_sha512_state  st[STRING_BATCH];
+    crypto_hash_sha512_state *st_p[STRING_BATCH];
+    const unsigned char      *in_p[STRING_BATCH];
+    unsigned char            *out_p[STRING_BATCH];
+    unsigned long long        inlen[STRING_BATCH];
+    const unsigned char       empty_block[HASH_BLOCKBYTES] = { 0 };
+    unsigned char             suffix[3U + 0xff + 1U];
+    unsigned char             u0[STRING_BATCH][HASH_BYTES];
+    unsigned char             u[STRING_BATCH][2 * HASH_BYTES];
+    unsigned char             h[2 * STRING_BATCH][HASH_BYTES];
+    unsigned char             uk[HASH_BYTES];
+    ge25519_p3                px[2 * STRING_BATCH];
+    ge25519_p3                r_p3[STRING_BATCH];
+    ge25519_p1p1              r_p1p1;
+    ge25519_cached            q_cached;
+    size_t                    ctx_len = ctx != NULL ? strlen(ctx) : 0U;
+    size_t                    chunk;
+    size_t                    i, j, k, l;
+
+    if (n > 2U) {
+        abort(); /* LCOV_EXCL_LINE */
+    }
+    if (ctx_len > (size_t) 0xff) {
+        /* oversized contexts are rare: hash one message at a time */
+        for (i = 0U; i < count; i++) {
+            if (n == 1U) {
+                (void) crypto_core_ed25519_from_string
+                    (&p[i * crypto_core_ed25519_BYTES], ctx, msgs[i],
+                     msg_lens[i]);
+            } else if (crypto_core_ed25519_from_string_ro
+                       (&p[i * crypto_core_ed25519_BYTES], ctx, msgs[i],
+                        msg_lens[i]) != 0) {
+                return -1; /* LCOV_EXCL_LINE */
+            }
+        }
+        return 0;
+    }
+    /* suffix = I2OSP(len_in_bytes, 2) || I2OSP(0, 1) || DST' */
+    suffix[0] = 0U;
+    suffix[1] = (unsigned char) (n * HASH_L);
+    suffix[2] = 0U;
+    memcpy(&suffix[3], ctx, ctx_len);
+    suffix[3 + ctx_len] = (unsigned char) ctx_len;
+
+    crypto_hash_sha512_init(&st0);
+    crypto_hash_sha512_update(&st0, empty_block, sizeof empty_block);
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > STRING_BATCH) {
+            chunk = STRING_BATCH;
+        }
+        for (j = 0U; j < chunk; j++) {
+            memcpy(&st[j], &st0, sizeof st0);
+            crypto_hash_sha512_update(&st[j], msgs[i + j], msg_lens[i + j]);
+            st_p[j]  = &st[j];
+            in_p[j]  = suffix;
+            inlen[j] = 3U + ctx_len + 1U;
+            out_p[j] = u0[j];
+        }
+        _crypto_hash_sha512_final_multi(st_p, out_p, in_p, inlen, chunk);
+
+        /* b_k = H((b_0 ^ b_(k-1)) || I2OSP(k, 1) || DST') */
+        for (k = 0U; k < n; k++) {
+            for (j = 0U; j < chunk; j++) {
+                memcpy(uk, u0[j], HASH_BYTES);
+                for (l = 0U; k > 0U && l < HASH_BYTES; l++) {
+                    uk[l] ^= u[j][(k - 1U) * HASH_BYTES + l];
+                }
+                crypto_hash_sha512_init(&st[j]);
+                crypto_hash_sha512_update(&st[j], uk, HASH_BYTES);
+                in_p[j]  = &suffix[2];
+                inlen[j] = 1U + ctx_len + 1U;
+                out_p[j] = &u[j][k * HASH_BYTES];
+            }
+            suffix[2] = (unsigned char) (k + 1U);
+            _crypto_hash_sha512_final_multi(st_p, out_p, in_p, inlen, chunk);
+        }
+        suffix[2] = 0U;
+
+        for (j = 0U; j < chunk * n; j++) {
+            memset(h[j], 0U, HASH_BYTES - HASH_L);
+            memcpy(h[j] + HASH_BYTES - HASH_L, &u[j / n][(j % n) * HASH_L],
+                   HASH_L);
+        }
+        ge25519_from_hash_batch(px, &h[0][0], chunk * n);
+        if (n == 1U) {
+            ge25519_p3_tobytes_batch(&p[i * crypto_core_ed25519_BYTES], px,
+                                     chunk);
+            continue;
+        }
+        for (j = 0U; j < chunk; j++) {
+            ge25519_p3_to_cached(&q_cached, &px[2 * j + 1]);
+            ge25519_add_cached(&r_p1p1, &px[2 * j], &q_cached);
+            ge25519_p1p1_to_p3(&r_p3[j], &r_p1p1);
+        }
+        ge25519_p3_tobytes_batch(&p[i * crypto_core_ed25519_BYTES], r_p3,
+                                 chunk);
+    }
+    sodium_memzero(u0, sizeof u0);
+    sodium_memzero(u, sizeof u);
+    sodium_memzero(h, sizeof h);
+
+    return 0;
+}
+
+int
+crypto_core_ed25519_from_string_batch(unsigned char *p, const char *ctx,
+                                      const unsigned char * const *msgs,
+                                      const size_t *msg_lens, size_t count)
+{
+    return _string_to_points_batch(p, 1, ctx, msgs, msg_lens, count);
+}
+
+int
+crypto_core_ed25519_from_string_ro_batch(unsigned char *p, const char *ctx,
+                                         const unsigned char * const *msgs,
+                                         const size_t *msg_lens, size_t count)
+{
+    return _string_to_points_batch(p, 2, ctx, msgs, msg_lens, count);
+}
+
 void
 crypto_core_ed25519_random(unsigned char *p)
 {
@@ -182,6 +328,76 @@ crypto_core_ed25519_scalar_invert(unsigned char *recip, const unsigned char *s)
     return - sodium_is_zero(s, crypto_core_ed25519_SCALARBYTES);
 }
 
+/*
+ * Montgomery's trick: a single inversion, and 3 multiplications per scalar.
+ * Scalars equal to 0 mod L don't spoil the batch: they are replaced with 1,
+ * and their result is set to 0 afterwards.
+ */
+int
+crypto_core_ed25519_scalar_invert_batch(unsigned char *recip,
+                                        const unsigned char *s, size_t count)
+{
+    unsigned char  t[crypto_core_ed25519_NONREDUCEDSCALARBYTES];
+    unsigned char  inv[crypto_core_ed25519_SCALARBYTES];
+    unsigned char *acc;
+    unsigned char *zero;
+    unsigned char *x;
+    size_t         i;
+    size_t         j;
+    unsigned char  mask;
+    unsigned char  any_zero = 0U;
+
+    if (count == 0U) {
+        return 0;
+    }
+    if (count > SIZE_MAX / (crypto_core_ed25519_SCALARBYTES + 1U) ||
+        (acc = (unsigned char *)
+         malloc(count * (crypto_core_ed25519_SCALARBYTES + 1U))) == NULL) {
+        return -1;
+    }
+    zero = acc + count * crypto_core_ed25519_SCALARBYTES;
+    for (i = 0U; i < count; i++) {
+        x = &recip[i * crypto_core_ed25519_SCALARBYTES];
+        memcpy(t, &s[i * crypto_core_ed25519_SCALARBYTES],
+               crypto_core_ed25519_SCALARBYTES);
+        memset(t + crypto_core_ed25519_SCALARBYTES, 0,
+               sizeof t - crypto_core_ed25519_SCALARBYTES);
+        sc25519_reduce(t);
+        zero[i] = (unsigned char)
+            sodium_is_zero(t, crypto_core_ed25519_SCALARBYTES);
+        any_zero |= zero[i];
+        t[0] |= zero[i];
+        memcpy(x, t, crypto_core_ed25519_SCALARBYTES);
+        if (i == 0U) {
+            memcpy(acc, x, crypto_core_ed25519_SCALARBYTES);
+        } else {
+            sc25519_mul(&acc[i * crypto_core_ed25519_SCALARBYTES],
+                        &acc[(i - 1U) * crypto_core_ed25519_SCALARBYTES], x);
+        }
+    }
+    sc25519_invert(inv, &acc[(count - 1U) * crypto_core_ed25519_SCALARBYTES]);
+    for (i = count - 1U; i > 0U; i--) {
+        x = &recip[i * crypto_core_ed25519_SCALARBYTES];
+        sc25519_mul(t, inv, &acc[(i - 1U) * crypto_core_ed25519_SCALARBYTES]);
+        sc25519_mul(inv, inv, x);
+        memcpy(x, t, crypto_core_ed25519_SCALARBYTES);
+    }
+    memcpy(recip, inv, crypto_core_ed25519_SCALARBYTES);
+    for (i = 0U; i < count; i++) {
+        x = &recip[i * crypto_core_ed25519_SCALARBYTES];
+        mask = (unsigned char) (zero[i] - 1U);
+        for (j = 0U; j < crypto_core_ed25519_SCALARBYTES; j++) {
+            x[j] &= mask;
+        }
+    }
+    sodium_memzero(acc, count * (crypto_core_ed25519_SCALARBYTES + 1U));
+    free(acc);
+    sodium_memzero(t, sizeof t);
+    sodium_memzero(inv, sizeof inv);
+
+    return - (int) any_zero;
+}
+
 /* 2^252+27742317777372353535851937790883648493 */
 static const unsigned char L[] = {
     0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7,
@@ -259,6 +475,19 @@ crypto_core_ed25519_scalar_mul(unsigned char *z, const unsigned char *x,
     sc25519_mul(z, x, y);
 }
 
+void
+crypto_core_ed25519_scalar_mul_many(unsigned char *z, const unsigned char *x,
+                                    const unsigned char *y, size_t count)
+{
+    size_t i;
+
+    for (i = 0U; i < count; i++) {
+        sc25519_mul(&z[i * crypto_core_ed25519_SCALARBYTES],
+                    &x[i * crypto_core_ed25519_SCALARBYTES],
+                    &y[i * crypto_core_ed25519_SCALARBYTES]);
+    }
+}
+
 void
 crypto_core_ed25519_scalar_reduce(unsigned char *r,
                                   const unsigned char *s)
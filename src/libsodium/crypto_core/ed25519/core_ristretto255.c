@@ -62,6 +62,134 @@ crypto_core_ristretto255_sub(unsigned char *r,
     return 0;
 }
 
+#define DOUBLE_BATCH 16U
+
+int
+crypto_core_ristretto255_double_batch(unsigned char *r, const unsigned char *p,
+                                      size_t count)
+{
+    ge25519_p3 p_p3[DOUBLE_BATCH];
+    size_t     chunk;
+    size_t     i;
+    size_t     j;
+    int        ret = 0;
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > DOUBLE_BATCH) {
+            chunk = DOUBLE_BATCH;
+        }
+        for (j = 0U; j < chunk; j++) {
+            ret |= ristretto255_frombytes(&p_p3[j],
+                                          &p[(i + j) *
+                                             crypto_core_ristretto255_BYTES]);
+        }
+        if (ret != 0) {
+            return -1;
+        }
+        ristretto255_p3_dbl_tobytes_batch(&r[i * crypto_core_ristretto255_BYTES],
+                                          p_p3, chunk);
+    }
+    return 0;
+}
+
+#define POINT(P) ((ge25519_p3 *) (void *) (P)->opaque)
+#define CONST_POINT(P) ((const ge25519_p3 *) (const void *) (P)->opaque)
+
+int
+crypto_core_ristretto255_point_frombytes(crypto_core_ristretto255_point *r,
+                                         const unsigned char *p)
+{
+    COMPILER_ASSERT(sizeof(ge25519_p3) <= sizeof r->opaque);
+    return ristretto255_frombytes(POINT(r), p);
+}
+
+void
+crypto_core_ristretto255_point_tobytes(unsigned char *r,
+                                       const crypto_core_ristretto255_point *p)
+{
+    ristretto255_p3_tobytes(r, CONST_POINT(p));
+}
+
+/*
+ * Points equivalent to the identity are the 4-torsion points, the only
+ * ones with x = 0 or y = 0.
+ */
+int
+crypto_core_ristretto255_point_is_identity(const crypto_core_ristretto255_point *p)
+{
+    const ge25519_p3 *P = CONST_POINT(p);
+
+    return fe25519_iszero(P->X) | fe25519_iszero(P->Y);
+}
+
+void
+crypto_core_ristretto255_point_add(crypto_core_ristretto255_point *r,
+                                   const crypto_core_ristretto255_point *p,
+                                   const crypto_core_ristretto255_point *q)
+{
+    ge25519_p1p1   r_p1p1;
+    ge25519_cached q_cached;
+
+    ge25519_p3_to_cached(&q_cached, CONST_POINT(q));
+    ge25519_add_cached(&r_p1p1, CONST_POINT(p), &q_cached);
+    ge25519_p1p1_to_p3(POINT(r), &r_p1p1);
+}
+
+void
+crypto_core_ristretto255_point_sub(crypto_core_ristretto255_point *r,
+                                   const crypto_core_ristretto255_point *p,
+                                   const crypto_core_ristretto255_point *q)
+{
+    ge25519_p1p1   r_p1p1;
+    ge25519_cached q_cached;
+
+    ge25519_p3_to_cached(&q_cached, CONST_POINT(q));
+    ge25519_sub_cached(&r_p1p1, CONST_POINT(p), &q_cached);
+    ge25519_p1p1_to_p3(POINT(r), &r_p1p1);
+}
+
+void
+crypto_core_ristretto255_point_dbl(crypto_core_ristretto255_point *r,
+                                   const crypto_core_ristretto255_point *p)
+{
+    ge25519_p1p1 r_p1p1;
+
+    ge25519_p3_dbl(&r_p1p1, CONST_POINT(p));
+    ge25519_p1p1_to_p3(POINT(r), &r_p1p1);
+}
+
+int
+crypto_core_ristretto255_point_scalarmult(crypto_core_ristretto255_point *r,
+                                          const unsigned char *n,
+                                          const crypto_core_ristretto255_point *p)
+{
+    unsigned char t[32];
+    ge25519_p3    Q;
+
+    memcpy(t, n, sizeof t);
+    t[31] &= 127;
+    ge25519_scalarmult(&Q, t, CONST_POINT(p));
+    sodium_memzero(t, sizeof t);
+    memcpy(POINT(r), &Q, sizeof Q);
+
+    return -crypto_core_ristretto255_point_is_identity(r);
+}
+
+int
+crypto_core_ristretto255_point_scalarmult_base(crypto_core_ristretto255_point *r,
+                                               const unsigned char *n)
+{
+    unsigned char t[32];
+
+    memcpy(t, n, sizeof t);
+    t[31] &= 127;
+    ge25519_scalarmult_base(POINT(r), t);
+    sodium_memzero(t, sizeof t);
+
+    return -crypto_core_ristretto255_point_is_identity(r);
+}
+
 int
 crypto_core_ristretto255_from_hash(unsigned char *p, const unsigned char *r)
 {
@@ -172,6 +300,14 @@ crypto_core_ristretto255_scalar_invert(unsigned char *recip,
     return crypto_core_ed25519_scalar_invert(recip, s);
 }
 
+int
+crypto_core_ristretto255_scalar_invert_batch(unsigned char *recip,
+                                             const unsigned char *s,
+                                             size_t count)
+{
+    return crypto_core_ed25519_scalar_invert_batch(recip, s, count);
+}
+
 void
 crypto_core_ristretto255_scalar_negate(unsigned char *neg,
                                        const unsigned char *s)
@@ -207,6 +343,14 @@ crypto_core_ristretto255_scalar_mul(unsigned char *z, const unsigned char *x,
     sc25519_mul(z, x, y);
 }
 
+void
+crypto_core_ristretto255_scalar_mul_many(unsigned char *z,
+                                         const unsigned char *x,
+                                         const unsigned char *y, size_t count)
+{
+    crypto_core_ed25519_scalar_mul_many(z, x, y, count);
+}
+
 void
 crypto_core_ristretto255_scalar_reduce(unsigned char *r,
                                        const unsigned char *s)
@@ -248,6 +392,12 @@ crypto_core_ristretto255_bytes(void)
     return crypto_core_ristretto255_BYTES;
 }
 
+size_t
+crypto_core_ristretto255_pointbytes(void)
+{
+    return sizeof(crypto_core_ristretto255_point);
+}
+
 size_t
 crypto_core_ristretto255_nonreducedscalarbytes(void)
 {
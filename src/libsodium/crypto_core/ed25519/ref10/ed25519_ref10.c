@@ -6,8 +6,17 @@
 #include "crypto_verify_32.h"
 #include "private/common.h"
 #include "private/ed25519_ref10.h"
+#include "private/implementations.h"
+#include "private/mutex.h"
+#include "runtime.h"
 #include "utils.h"
 
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    !defined(ED25519_SMALL_BASE_TABLE)
+# include "ed25519_ref10_avx512ifma.h"
+static int use_avx512ifma;
+#endif
+
 static inline uint64_t
 load_3(const unsigned char *in)
 {
@@ -62,58 +71,471 @@ fe25519_sqmul(fe25519 s, const int n, const fe25519 a)
 }
 
 /*
- * Inversion - returns 0 if z=0
+ * Constant-time inversion modulo an odd modulus, using the Bernstein-Yang
+ * "safegcd" algorithm in the variant used by libsecp256k1: 590 divsteps are
+ * enough for any input below 2^256.
+ *
+ * With 128-bit arithmetic, numbers are stored as 5 signed 62-bit limbs and
+ * divsteps are computed 59 at a time. Otherwise, 9 signed 30-bit limbs and
+ * batches of 30 divsteps are used.
  */
-void
-fe25519_invert(fe25519 out, const fe25519 z)
+
+#ifdef HAVE_TI_MODE
+
+typedef struct modinv_signed62_ {
+    int64_t v[5];
+} modinv_signed62;
+
+typedef struct modinv_modinfo_ {
+    modinv_signed62 modulus;
+    uint64_t        modulus_inv62; /* modulus^-1 mod 2^62 */
+} modinv_modinfo;
+
+typedef struct modinv_trans2x2_ {
+    int64_t u, v, q, r;
+} modinv_trans2x2;
+
+#define MODINV_M62 (UINT64_MAX >> 2)
+
+static const modinv_modinfo modinv_p = {
+    { { -19, 0, 0, 0, 128 } },
+    0x39435e50d79435e5ULL
+};
+
+static const modinv_modinfo modinv_l = {
+    { { 0x1812631a5cf5d3edLL, 0x137be77a8bde7359LL, 1, 0, 16 } },
+    0x2d4ae25cedab81e5ULL
+};
+
+/*
+ * 59 divsteps on the low bits of f and g, returning the new zeta and the
+ * transition matrix, scaled by 2^62.
+ */
+static int64_t
+modinv_divsteps_59(int64_t zeta, uint64_t f0, uint64_t g0,
+                   modinv_trans2x2 *t)
+{
+    uint64_t          u = 8, v = 0, q = 0, r = 8;
+    volatile uint64_t c1, c2;
+    uint64_t          mask1, mask2, f = f0, g = g0, x, y, z;
+    int               i;
+
+    for (i = 3; i < 62; ++i) {
+        c1 = (uint64_t) (zeta >> 63);
+        mask1 = c1;
+        c2 = g & 1;
+        mask2 = -c2;
+        x = (f ^ mask1) - mask1;
+        y = (u ^ mask1) - mask1;
+        z = (v ^ mask1) - mask1;
+        g += x & mask2;
+        q += y & mask2;
+        r += z & mask2;
+        mask1 &= mask2;
+        zeta = (int64_t) (((uint64_t) zeta ^ mask1) - 1U);
+        f += g & mask1;
+        u += q & mask1;
+        v += r & mask1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+    }
+    t->u = (int64_t) u;
+    t->v = (int64_t) v;
+    t->q = (int64_t) q;
+    t->r = (int64_t) r;
+
+    return zeta;
+}
+
+/*
+ * [d, e] = t * [d, e] / 2^62 mod modulus, keeping both in the range
+ * (-2*modulus, modulus).
+ */
+static void
+modinv_update_de_62(modinv_signed62 *d, modinv_signed62 *e,
+                    const modinv_trans2x2 *t, const modinv_modinfo *mi)
+{
+    const int64_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int64_t       md, me, sd, se;
+    int128_t      cd, ce;
+    int64_t       di, ei;
+    int           i;
+
+    sd = d->v[4] >> 63;
+    se = e->v[4] >> 63;
+    md = (u & sd) + (v & se);
+    me = (q & sd) + (r & se);
+    cd = (int128_t) u * d->v[0] + (int128_t) v * e->v[0];
+    ce = (int128_t) q * d->v[0] + (int128_t) r * e->v[0];
+    md -= (int64_t) ((mi->modulus_inv62 * (uint64_t) cd + (uint64_t) md) &
+                     MODINV_M62);
+    me -= (int64_t) ((mi->modulus_inv62 * (uint64_t) ce + (uint64_t) me) &
+                     MODINV_M62);
+    cd += (int128_t) mi->modulus.v[0] * md;
+    ce += (int128_t) mi->modulus.v[0] * me;
+    cd >>= 62;
+    ce >>= 62;
+    for (i = 1; i < 5; i++) {
+        di = d->v[i];
+        ei = e->v[i];
+        cd += (int128_t) u * di + (int128_t) v * ei;
+        ce += (int128_t) q * di + (int128_t) r * ei;
+        cd += (int128_t) mi->modulus.v[i] * md;
+        ce += (int128_t) mi->modulus.v[i] * me;
+        d->v[i - 1] = (int64_t) ((uint64_t) cd & MODINV_M62);
+        e->v[i - 1] = (int64_t) ((uint64_t) ce & MODINV_M62);
+        cd >>= 62;
+        ce >>= 62;
+    }
+    d->v[4] = (int64_t) cd;
+    e->v[4] = (int64_t) ce;
+}
+
+/* [f, g] = t * [f, g] / 2^62 */
+static void
+modinv_update_fg_62(modinv_signed62 *f, modinv_signed62 *g,
+                    const modinv_trans2x2 *t)
+{
+    const int64_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int128_t      cf, cg;
+    int64_t       fi, gi;
+    int           i;
+
+    cf = (int128_t) u * f->v[0] + (int128_t) v * g->v[0];
+    cg = (int128_t) q * f->v[0] + (int128_t) r * g->v[0];
+    cf >>= 62;
+    cg >>= 62;
+    for (i = 1; i < 5; i++) {
+        fi = f->v[i];
+        gi = g->v[i];
+        cf += (int128_t) u * fi + (int128_t) v * gi;
+        cg += (int128_t) q * fi + (int128_t) r * gi;
+        f->v[i - 1] = (int64_t) ((uint64_t) cf & MODINV_M62);
+        g->v[i - 1] = (int64_t) ((uint64_t) cg & MODINV_M62);
+        cf >>= 62;
+        cg >>= 62;
+    }
+    f->v[4] = (int64_t) cf;
+    g->v[4] = (int64_t) cg;
+}
+
+static void
+modinv_propagate_62(modinv_signed62 *r)
 {
-    fe25519 t0, t1, t2, t3;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        r->v[i + 1] += r->v[i] >> 62;
+        r->v[i] = (int64_t) ((uint64_t) r->v[i] & MODINV_M62);
+    }
+}
+
+/*
+ * Maps r, in (-2*modulus, modulus), to [0, modulus), negating it first if
+ * sign is negative.
+ */
+static void
+modinv_normalize_62(modinv_signed62 *r, int64_t sign,
+                    const modinv_modinfo *mi)
+{
+    int64_t cond_add, cond_negate;
     int     i;
 
-    fe25519_sq(t0, z);
-    fe25519_sq(t1, t0);
-    fe25519_sq(t1, t1);
-    fe25519_mul(t1, z, t1);
-    fe25519_mul(t0, t0, t1);
-    fe25519_sq(t2, t0);
-    fe25519_mul(t1, t1, t2);
-    fe25519_sq(t2, t1);
-    for (i = 1; i < 5; ++i) {
-        fe25519_sq(t2, t2);
+    cond_add = r->v[4] >> 63;
+    for (i = 0; i < 5; i++) {
+        r->v[i] += mi->modulus.v[i] & cond_add;
     }
-    fe25519_mul(t1, t2, t1);
-    fe25519_sq(t2, t1);
-    for (i = 1; i < 10; ++i) {
-        fe25519_sq(t2, t2);
+    cond_negate = sign >> 63;
+    for (i = 0; i < 5; i++) {
+        r->v[i] = (r->v[i] ^ cond_negate) - cond_negate;
     }
-    fe25519_mul(t2, t2, t1);
-    fe25519_sq(t3, t2);
-    for (i = 1; i < 20; ++i) {
-        fe25519_sq(t3, t3);
+    modinv_propagate_62(r);
+    cond_add = r->v[4] >> 63;
+    for (i = 0; i < 5; i++) {
+        r->v[i] += mi->modulus.v[i] & cond_add;
     }
-    fe25519_mul(t2, t3, t2);
-    for (i = 1; i < 11; ++i) {
-        fe25519_sq(t2, t2);
+    modinv_propagate_62(r);
+}
+
+/*
+ * Replaces the little-endian number s < 2^256 with its inverse modulo the
+ * modulus, or with 0 if s is a multiple of it.
+ */
+static void
+modinv_bytes(unsigned char s[32], const modinv_modinfo *mi)
+{
+    modinv_signed62 d = { { 0, 0, 0, 0, 0 } };
+    modinv_signed62 e = { { 1, 0, 0, 0, 0 } };
+    modinv_signed62 f = mi->modulus;
+    modinv_signed62 g;
+    modinv_trans2x2 t;
+    uint64_t        w0, w1, w2, w3;
+    int64_t         zeta = -1;
+    int             i;
+
+    w0 = LOAD64_LE(s);
+    w1 = LOAD64_LE(s + 8);
+    w2 = LOAD64_LE(s + 16);
+    w3 = LOAD64_LE(s + 24);
+    g.v[0] = (int64_t) (w0 & MODINV_M62);
+    g.v[1] = (int64_t) (((w0 >> 62) | (w1 << 2)) & MODINV_M62);
+    g.v[2] = (int64_t) (((w1 >> 60) | (w2 << 4)) & MODINV_M62);
+    g.v[3] = (int64_t) (((w2 >> 58) | (w3 << 6)) & MODINV_M62);
+    g.v[4] = (int64_t) (w3 >> 56);
+
+    for (i = 0; i < 10; i++) {
+        zeta = modinv_divsteps_59(zeta, (uint64_t) f.v[0], (uint64_t) g.v[0],
+                                  &t);
+        modinv_update_de_62(&d, &e, &t, mi);
+        modinv_update_fg_62(&f, &g, &t);
     }
-    fe25519_mul(t1, t2, t1);
-    fe25519_sq(t2, t1);
-    for (i = 1; i < 50; ++i) {
-        fe25519_sq(t2, t2);
+    modinv_normalize_62(&d, f.v[4], mi);
+
+    w0 = (uint64_t) d.v[0] | ((uint64_t) d.v[1] << 62);
+    w1 = ((uint64_t) d.v[1] >> 2) | ((uint64_t) d.v[2] << 60);
+    w2 = ((uint64_t) d.v[2] >> 4) | ((uint64_t) d.v[3] << 58);
+    w3 = ((uint64_t) d.v[3] >> 6) | ((uint64_t) d.v[4] << 56);
+    STORE64_LE(s, w0);
+    STORE64_LE(s + 8, w1);
+    STORE64_LE(s + 16, w2);
+    STORE64_LE(s + 24, w3);
+}
+
+#else
+
+typedef struct modinv_signed30_ {
+    int32_t v[9];
+} modinv_signed30;
+
+typedef struct modinv_modinfo_ {
+    modinv_signed30 modulus;
+    uint32_t        modulus_inv30; /* modulus^-1 mod 2^30 */
+} modinv_modinfo;
+
+typedef struct modinv_trans2x2_ {
+    int32_t u, v, q, r;
+} modinv_trans2x2;
+
+#define MODINV_M30 (UINT32_MAX >> 2)
+
+static const modinv_modinfo modinv_p = {
+    { { -19, 0, 0, 0, 0, 0, 0, 0, 32768 } },
+    0x179435e5U
+};
+
+static const modinv_modinfo modinv_l = {
+    { { 0x1cf5d3ed, 0x20498c69, 0x2f79cd65, 0x37be77a8, 0x14, 0, 0, 0,
+        0x1000 } },
+    0x2dab81e5U
+};
+
+/*
+ * 30 divsteps on the low bits of f and g, returning the new zeta and the
+ * transition matrix, scaled by 2^30.
+ */
+static int32_t
+modinv_divsteps_30(int32_t zeta, uint32_t f0, uint32_t g0,
+                   modinv_trans2x2 *t)
+{
+    uint32_t          u = 1, v = 0, q = 0, r = 1;
+    volatile uint32_t c1, c2;
+    uint32_t          mask1, mask2, f = f0, g = g0, x, y, z;
+    int               i;
+
+    for (i = 0; i < 30; ++i) {
+        c1 = (uint32_t) (zeta >> 31);
+        mask1 = c1;
+        c2 = g & 1;
+        mask2 = -c2;
+        x = (f ^ mask1) - mask1;
+        y = (u ^ mask1) - mask1;
+        z = (v ^ mask1) - mask1;
+        g += x & mask2;
+        q += y & mask2;
+        r += z & mask2;
+        mask1 &= mask2;
+        zeta = (int32_t) (((uint32_t) zeta ^ mask1) - 1U);
+        f += g & mask1;
+        u += q & mask1;
+        v += r & mask1;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
     }
-    fe25519_mul(t2, t2, t1);
-    fe25519_sq(t3, t2);
-    for (i = 1; i < 100; ++i) {
-        fe25519_sq(t3, t3);
+    t->u = (int32_t) u;
+    t->v = (int32_t) v;
+    t->q = (int32_t) q;
+    t->r = (int32_t) r;
+
+    return zeta;
+}
+
+/*
+ * [d, e] = t * [d, e] / 2^30 mod modulus, keeping both in the range
+ * (-2*modulus, modulus).
+ */
+static void
+modinv_update_de_30(modinv_signed30 *d, modinv_signed30 *e,
+                    const modinv_trans2x2 *t, const modinv_modinfo *mi)
+{
+    const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int32_t       md, me, sd, se;
+    int64_t       cd, ce;
+    int32_t       di, ei;
+    int           i;
+
+    sd = d->v[8] >> 31;
+    se = e->v[8] >> 31;
+    md = (u & sd) + (v & se);
+    me = (q & sd) + (r & se);
+    cd = (int64_t) u * d->v[0] + (int64_t) v * e->v[0];
+    ce = (int64_t) q * d->v[0] + (int64_t) r * e->v[0];
+    md -= (int32_t) ((mi->modulus_inv30 * (uint32_t) cd + (uint32_t) md) &
+                     MODINV_M30);
+    me -= (int32_t) ((mi->modulus_inv30 * (uint32_t) ce + (uint32_t) me) &
+                     MODINV_M30);
+    cd += (int64_t) mi->modulus.v[0] * md;
+    ce += (int64_t) mi->modulus.v[0] * me;
+    cd >>= 30;
+    ce >>= 30;
+    for (i = 1; i < 9; i++) {
+        di = d->v[i];
+        ei = e->v[i];
+        cd += (int64_t) u * di + (int64_t) v * ei;
+        ce += (int64_t) q * di + (int64_t) r * ei;
+        cd += (int64_t) mi->modulus.v[i] * md;
+        ce += (int64_t) mi->modulus.v[i] * me;
+        d->v[i - 1] = (int32_t) ((uint32_t) cd & MODINV_M30);
+        e->v[i - 1] = (int32_t) ((uint32_t) ce & MODINV_M30);
+        cd >>= 30;
+        ce >>= 30;
     }
-    fe25519_mul(t2, t3, t2);
-    for (i = 1; i < 51; ++i) {
-        fe25519_sq(t2, t2);
+    d->v[8] = (int32_t) cd;
+    e->v[8] = (int32_t) ce;
+}
+
+/* [f, g] = t * [f, g] / 2^30 */
+static void
+modinv_update_fg_30(modinv_signed30 *f, modinv_signed30 *g,
+                    const modinv_trans2x2 *t)
+{
+    const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+    int64_t       cf, cg;
+    int32_t       fi, gi;
+    int           i;
+
+    cf = (int64_t) u * f->v[0] + (int64_t) v * g->v[0];
+    cg = (int64_t) q * f->v[0] + (int64_t) r * g->v[0];
+    cf >>= 30;
+    cg >>= 30;
+    for (i = 1; i < 9; i++) {
+        fi = f->v[i];
+        gi = g->v[i];
+        cf += (int64_t) u * fi + (int64_t) v * gi;
+        cg += (int64_t) q * fi + (int64_t) r * gi;
+        f->v[i - 1] = (int32_t) ((uint32_t) cf & MODINV_M30);
+        g->v[i - 1] = (int32_t) ((uint32_t) cg & MODINV_M30);
+        cf >>= 30;
+        cg >>= 30;
     }
-    fe25519_mul(t1, t2, t1);
-    for (i = 1; i < 6; ++i) {
-        fe25519_sq(t1, t1);
+    f->v[8] = (int32_t) cf;
+    g->v[8] = (int32_t) cg;
+}
+
+static void
+modinv_propagate_30(modinv_signed30 *r)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        r->v[i + 1] += r->v[i] >> 30;
+        r->v[i] = (int32_t) ((uint32_t) r->v[i] & MODINV_M30);
+    }
+}
+
+static void
+modinv_normalize_30(modinv_signed30 *r, int32_t sign,
+                    const modinv_modinfo *mi)
+{
+    int32_t cond_add, cond_negate;
+    int     i;
+
+    cond_add = r->v[8] >> 31;
+    for (i = 0; i < 9; i++) {
+        r->v[i] += mi->modulus.v[i] & cond_add;
+    }
+    cond_negate = sign >> 31;
+    for (i = 0; i < 9; i++) {
+        r->v[i] = (r->v[i] ^ cond_negate) - cond_negate;
+    }
+    modinv_propagate_30(r);
+    cond_add = r->v[8] >> 31;
+    for (i = 0; i < 9; i++) {
+        r->v[i] += mi->modulus.v[i] & cond_add;
     }
-    fe25519_mul(out, t1, t0);
+    modinv_propagate_30(r);
+}
+
+static void
+modinv_bytes(unsigned char s[32], const modinv_modinfo *mi)
+{
+    modinv_signed30 d = { { 0, 0, 0, 0, 0, 0, 0, 0, 0 } };
+    modinv_signed30 e = { { 1, 0, 0, 0, 0, 0, 0, 0, 0 } };
+    modinv_signed30 f = mi->modulus;
+    modinv_signed30 g;
+    modinv_trans2x2 t;
+    uint64_t        acc = 0U;
+    int32_t         zeta = -1;
+    int             bits = 0;
+    int             i;
+    int             j = 0;
+
+    for (i = 0; i < 9; i++) {
+        while (bits < 30 && j < 32) {
+            acc |= (uint64_t) s[j++] << bits;
+            bits += 8;
+        }
+        g.v[i] = (int32_t) (acc & MODINV_M30);
+        acc >>= 30;
+        bits -= 30;
+    }
+
+    for (i = 0; i < 20; i++) {
+        zeta = modinv_divsteps_30(zeta, (uint32_t) f.v[0], (uint32_t) g.v[0],
+                                  &t);
+        modinv_update_de_30(&d, &e, &t, mi);
+        modinv_update_fg_30(&f, &g, &t);
+    }
+    modinv_normalize_30(&d, f.v[8], mi);
+
+    acc = 0U;
+    bits = 0;
+    j = 0;
+    for (i = 0; i < 9; i++) {
+        acc |= (uint64_t) d.v[i] << bits;
+        bits += 30;
+        while (bits >= 8 && j < 32) {
+            s[j++] = (unsigned char) acc;
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+}
+
+#endif
+
+/*
+ * Inversion - returns 0 if z=0
+ */
+void
+fe25519_invert(fe25519 out, const fe25519 z)
+{
+    unsigned char s[32];
+
+    fe25519_tobytes(s, z);
+    modinv_bytes(s, &modinv_p);
+    fe25519_frombytes(out, s);
 }
 
 /*
@@ -278,14 +700,20 @@ ge25519_add_cached(ge25519_p1p1 *r, const ge25519_p3 *p, const ge25519_cached *q
     fe25519_sub(r->T, t0, r->T);
 }
 
+/*
+ Sliding window recoding: r[i] is either 0 or an odd integer
+ in [-(2^w-1), 2^w-1].
+ */
+
 static void
-slide_vartime(signed char *r, const unsigned char *a)
+slide_vartime(signed char *r, const unsigned char *a, const int w)
 {
-    int i;
-    int b;
-    int k;
-    int ribs;
-    int cmp;
+    const int max = (1 << w) - 1;
+    int       i;
+    int       b;
+    int       k;
+    int       ribs;
+    int       cmp;
 
     for (i = 0; i < 256; ++i) {
         r[i] = 1 & (a[i >> 3] >> (i & 7));
@@ -294,18 +722,18 @@ slide_vartime(signed char *r, const unsigned char *a)
         if (! r[i]) {
             continue;
         }
-        for (b = 1; b <= 6 && i + b < 256; ++b) {
+        for (b = 1; b <= w + 2 && i + b < 256; ++b) {
             if (! r[i + b]) {
                 continue;
             }
             ribs = r[i + b] << b;
             cmp = r[i] + ribs;
-            if (cmp <= 15) {
+            if (cmp <= max) {
                 r[i] = cmp;
                 r[i + b] = 0;
             } else {
                 cmp = r[i] - ribs;
-                if (cmp < -15) {
+                if (cmp < -max) {
                     break;
                 }
                 r[i] = cmp;
@@ -538,14 +966,13 @@ ge25519_p3_to_cached(ge25519_cached *r, const ge25519_p3 *p)
 }
 
 static void
-ge25519_p3_to_precomp(ge25519_precomp *pi, const ge25519_p3 *p)
+ge25519_p3_to_precomp_recip(ge25519_precomp *pi, const ge25519_p3 *p,
+                            const fe25519 recip)
 {
-    fe25519 recip;
     fe25519 x;
     fe25519 y;
     fe25519 xy;
 
-    fe25519_invert(recip, p->Z);
     fe25519_mul(x, p->X, recip);
     fe25519_mul(y, p->Y, recip);
     fe25519_add(pi->yplusx, y, x);
@@ -554,6 +981,15 @@ ge25519_p3_to_precomp(ge25519_precomp *pi, const ge25519_p3 *p)
     fe25519_mul(pi->xy2d, xy, ed25519_d2);
 }
 
+static void
+ge25519_p3_to_precomp(ge25519_precomp *pi, const ge25519_p3 *p)
+{
+    fe25519 recip;
+
+    fe25519_invert(recip, p->Z);
+    ge25519_p3_to_precomp_recip(pi, p, recip);
+}
+
 /*
  r = p
  */
@@ -580,11 +1016,60 @@ ge25519_p3_tobytes(unsigned char *s, const ge25519_p3 *h)
     s[31] ^= fe25519_isnegative(x) << 7;
 }
 
+static void
+ge25519_p3_tobytes_recip(unsigned char *s, const ge25519_p3 *h,
+                         const fe25519 recip)
+{
+    fe25519 x;
+    fe25519 y;
+
+    fe25519_mul(x, h->X, recip);
+    fe25519_mul(y, h->Y, recip);
+    fe25519_tobytes(s, y);
+    s[31] ^= fe25519_isnegative(x) << 7;
+}
+
+/*
+ * Encodes count points into s, sharing one field inversion among up to
+ * GE25519_TOBYTES_BATCH points (Montgomery's trick). Constant time.
+ */
+
+#define GE25519_TOBYTES_BATCH 32U
+
+void
+ge25519_p3_tobytes_batch(unsigned char *s, const ge25519_p3 *h, size_t count)
+{
+    fe25519 acc[GE25519_TOBYTES_BATCH];
+    fe25519 recip;
+    fe25519 t;
+    size_t  chunk;
+    size_t  i;
+    size_t  j;
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > GE25519_TOBYTES_BATCH) {
+            chunk = GE25519_TOBYTES_BATCH;
+        }
+        fe25519_copy(acc[0], h[i].Z);
+        for (j = 1U; j < chunk; j++) {
+            fe25519_mul(acc[j], acc[j - 1U], h[i + j].Z);
+        }
+        fe25519_invert(recip, acc[chunk - 1U]);
+        for (j = chunk - 1U; j > 0U; j--) {
+            fe25519_mul(t, recip, acc[j - 1U]);
+            fe25519_mul(recip, recip, h[i + j].Z);
+            ge25519_p3_tobytes_recip(&s[(i + j) * 32U], &h[i + j], t);
+        }
+        ge25519_p3_tobytes_recip(&s[i * 32U], &h[i], recip);
+    }
+}
+
 /*
  r = 2 * p
  */
 
-static void
+void
 ge25519_p3_dbl(ge25519_p1p1 *r, const ge25519_p3 *p)
 {
     ge25519_p2 q;
@@ -664,35 +1149,71 @@ ge25519_cmov8(ge25519_precomp *t, const ge25519_precomp precomp[8], const signed
     ge25519_cmov(t, &minust, bnegative);
 }
 
-static void
-ge25519_cmov8_base(ge25519_precomp *t, const int pos, const signed char b)
-{
-    static const ge25519_precomp base[32][8] = { /* base[i][j] = (j+1)*256^i*B */
-#ifdef HAVE_TI_MODE
-# include "fe_51/base.h"
+/*
+ --enable-small-base-table only keeps one row out of four of the base point
+ table, 7.5 KB instead of 30 KB, for targets where flash and cache space
+ matter more than signing speed. The vectorized code paths are disabled.
+ */
+
+#ifdef ED25519_SMALL_BASE_TABLE
+static const ge25519_precomp base[8][8] = { /* base[i][j] = (j+1)*2^(32i)*B */
+# ifdef HAVE_TI_MODE
+#  include "fe_51/base_small.h"
+# else
+#  include "fe_25_5/base_small.h"
+# endif
+};
 #else
-# include "fe_25_5/base.h"
+static const ge25519_precomp base[32][8] = { /* base[i][j] = (j+1)*256^i*B */
+# ifdef HAVE_TI_MODE
+#  include "fe_51/base.h"
+# else
+#  include "fe_25_5/base.h"
+# endif
+};
 #endif
-    };
-    ge25519_cmov8(t, base[pos], b);
+
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    !defined(ED25519_SMALL_BASE_TABLE)
+static volatile int avx512ifma_ready;
+
+/* The vectorized tables are only built the first time they are needed */
+static int
+ge25519_avx512ifma_prepare(void)
+{
+    ge25519_p3   B;
+    ge25519_p1p1 r;
+
+    if (sodium_load_acquire(&avx512ifma_ready) != 0) {
+        return 0;
+    }
+    if (sodium_crit_enter() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (avx512ifma_ready == 0) {
+        ge25519_p3_0(&B);
+        ge25519_add_precomp(&r, &B, &base[0][0]);
+        ge25519_p1p1_to_p3(&B, &r);
+        ge25519_avx512ifma_init(&B, base);
+        sodium_store_release(&avx512ifma_ready, 1);
+    }
+    return sodium_crit_leave();
 }
+#endif
 
 static void
-ge25519_cmov8_cached(ge25519_cached *t, const ge25519_cached cached[8], const signed char b)
+ge25519_cmov16_cached(ge25519_cached *t, const ge25519_cached cached[16],
+                      const signed char b)
 {
     ge25519_cached      minust;
     const unsigned char bnegative = negative(b);
     const unsigned char babs      = b - (((-bnegative) & b) * ((signed char) 1 << 1));
+    int                 i;
 
     ge25519_cached_0(t);
-    ge25519_cmov_cached(t, &cached[0], equal(babs, 1));
-    ge25519_cmov_cached(t, &cached[1], equal(babs, 2));
-    ge25519_cmov_cached(t, &cached[2], equal(babs, 3));
-    ge25519_cmov_cached(t, &cached[3], equal(babs, 4));
-    ge25519_cmov_cached(t, &cached[4], equal(babs, 5));
-    ge25519_cmov_cached(t, &cached[5], equal(babs, 6));
-    ge25519_cmov_cached(t, &cached[6], equal(babs, 7));
-    ge25519_cmov_cached(t, &cached[7], equal(babs, 8));
+    for (i = 0; i < 16; i++) {
+        ge25519_cmov_cached(t, &cached[i], equal(babs, i + 1));
+    }
     fe25519_copy(minust.YplusX, t->YminusX);
     fe25519_copy(minust.YminusX, t->YplusX);
     fe25519_copy(minust.Z, t->Z);
@@ -736,6 +1257,32 @@ ge25519_tobytes(unsigned char *s, const ge25519_p2 *h)
     s[31] ^= fe25519_isnegative(x) << 7;
 }
 
+/*
+ B,3B,5B,...: odd multiples of the base point for the vartime double
+ scalar multiplications. --enable-large-base-table extends the table from
+ 15B to 127B, trading 7 KB of read-only data for fewer additions.
+ */
+
+#ifdef ED25519_LARGE_BASE_TABLE
+# define BASE2_WINDOW 7
+static const ge25519_precomp base2[64] = {
+# ifdef HAVE_TI_MODE
+#  include "fe_51/base2_large.h"
+# else
+#  include "fe_25_5/base2_large.h"
+# endif
+};
+#else
+# define BASE2_WINDOW 4
+static const ge25519_precomp base2[8] = {
+# ifdef HAVE_TI_MODE
+#  include "fe_51/base2.h"
+# else
+#  include "fe_25_5/base2.h"
+# endif
+};
+#endif
+
 /*
  r = a * A + b * B
  where a = a[0]+256*a[1]+...+256^31 a[31].
@@ -749,13 +1296,6 @@ void
 ge25519_double_scalarmult_vartime(ge25519_p2 *r, const unsigned char *a,
                                   const ge25519_p3 *A, const unsigned char *b)
 {
-    static const ge25519_precomp Bi[8] = {
-#ifdef HAVE_TI_MODE
-# include "fe_51/base2.h"
-#else
-# include "fe_25_5/base2.h"
-#endif
-    };
     signed char    aslide[256];
     signed char    bslide[256];
     ge25519_cached Ai[8]; /* A,3A,5A,7A,9A,11A,13A,15A */
@@ -764,8 +1304,18 @@ ge25519_double_scalarmult_vartime(ge25519_p2 *r, const unsigned char *a,
     ge25519_p3     A2;
     int            i;
 
-    slide_vartime(aslide, a);
-    slide_vartime(bslide, b);
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    !defined(ED25519_SMALL_BASE_TABLE)
+    if (use_avx512ifma && ge25519_avx512ifma_prepare() == 0) {
+        slide_vartime(aslide, a, 4);
+        slide_vartime(bslide, b, 6);
+        ge25519_double_scalarmult_slides_vartime_avx512ifma(r, aslide, A,
+                                                            bslide);
+        return;
+    }
+#endif
+    slide_vartime(aslide, a, 4);
+    slide_vartime(bslide, b, BASE2_WINDOW);
 
     ge25519_p3_to_cached(&Ai[0], A);
 
@@ -821,68 +1371,575 @@ ge25519_double_scalarmult_vartime(ge25519_p2 *r, const unsigned char *a,
 
         if (bslide[i] > 0) {
             ge25519_p1p1_to_p3(&u, &t);
-            ge25519_add_precomp(&t, &u, &Bi[bslide[i] / 2]);
+            ge25519_add_precomp(&t, &u, &base2[bslide[i] / 2]);
+        } else if (bslide[i] < 0) {
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_sub_precomp(&t, &u, &base2[(-bslide[i]) / 2]);
+        }
+
+        ge25519_p1p1_to_p2(r, &t);
+    }
+}
+
+/*
+ Ai = A,3A,5A,...,63A
+ */
+
+void
+ge25519_p3_to_cached_table_vartime(ge25519_cached Ai[32], const ge25519_p3 *A)
+{
+    ge25519_p1p1 t;
+    ge25519_p3   u;
+    ge25519_p3   A2;
+    int          i;
+
+    ge25519_p3_to_cached(&Ai[0], A);
+    ge25519_p3_dbl(&t, A);
+    ge25519_p1p1_to_p3(&A2, &t);
+    for (i = 1; i < 32; i++) {
+        ge25519_add_cached(&t, &A2, &Ai[i - 1]);
+        ge25519_p1p1_to_p3(&u, &t);
+        ge25519_p3_to_cached(&Ai[i], &u);
+    }
+}
+
+/*
+ r = a * A + b * B
+ where Ai is the table computed by ge25519_p3_to_cached_table_vartime(A).
+
+ Same as ge25519_double_scalarmult_vartime(), but with a wider window
+ for A, whose multiples have been precomputed.
+ */
+
+void
+ge25519_double_scalarmult_cached_vartime(ge25519_p2 *r, const unsigned char *a,
+                                         const ge25519_cached Ai[32],
+                                         const unsigned char *b)
+{
+    signed char  aslide[256];
+    signed char  bslide[256];
+    ge25519_p1p1 t;
+    ge25519_p3   u;
+    int          i;
+
+    slide_vartime(aslide, a, 6);
+    slide_vartime(bslide, b, BASE2_WINDOW);
+
+    ge25519_p2_0(r);
+
+    for (i = 255; i >= 0; --i) {
+        if (aslide[i] || bslide[i]) {
+            break;
+        }
+    }
+
+    for (; i >= 0; --i) {
+        ge25519_p2_dbl(&t, r);
+
+        if (aslide[i] > 0) {
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_add_cached(&t, &u, &Ai[aslide[i] / 2]);
+        } else if (aslide[i] < 0) {
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_sub_cached(&t, &u, &Ai[(-aslide[i]) / 2]);
+        }
+
+        if (bslide[i] > 0) {
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_add_precomp(&t, &u, &base2[bslide[i] / 2]);
         } else if (bslide[i] < 0) {
             ge25519_p1p1_to_p3(&u, &t);
-            ge25519_sub_precomp(&t, &u, &Bi[(-bslide[i]) / 2]);
+            ge25519_sub_precomp(&t, &u, &base2[(-bslide[i]) / 2]);
+        }
+
+        ge25519_p1p1_to_p2(r, &t);
+    }
+}
+
+/*
+ Interleaved (Straus) sliding-window evaluation: all the scalars share
+ the same sequence of doublings.
+ */
+
+static int
+ge25519_multi_scalarmult_straus_vartime(ge25519_p3 *r, const unsigned char *a,
+                                        const ge25519_p3 *P, size_t n)
+{
+    signed char    *slides;
+    ge25519_cached *Pi; /* P,3P,5P,7P,9P,11P,13P,15P for each point */
+    ge25519_p1p1    t;
+    ge25519_p3      u;
+    ge25519_p3      P2;
+    ge25519_p2      s;
+    size_t          j;
+    int             i;
+    int             k;
+
+    ge25519_p3_0(r);
+    if (n == 0U) {
+        return 0;
+    }
+    if (n > SIZE_MAX / (8U * sizeof *Pi) ||
+        (slides = (signed char *) malloc(n * 256U)) == NULL) {
+        return -1;
+    }
+    if ((Pi = (ge25519_cached *) malloc(n * 8U * sizeof *Pi)) == NULL) {
+        free(slides);
+        return -1;
+    }
+    for (j = 0U; j < n; j++) {
+        slide_vartime(&slides[j * 256U], &a[j * 32U], 4);
+        ge25519_p3_to_cached(&Pi[j * 8U], &P[j]);
+        ge25519_p3_dbl(&t, &P[j]);
+        ge25519_p1p1_to_p3(&P2, &t);
+        for (k = 1; k < 8; k++) {
+            ge25519_add_cached(&t, &P2, &Pi[j * 8U + k - 1]);
+            ge25519_p1p1_to_p3(&u, &t);
+            ge25519_p3_to_cached(&Pi[j * 8U + k], &u);
+        }
+    }
+    for (i = 255; i >= 0; --i) {
+        for (j = 0U; j < n; j++) {
+            if (slides[j * 256U + i] != 0) {
+                break;
+            }
+        }
+        if (j < n) {
+            break;
+        }
+    }
+    if (i >= 0) {
+        ge25519_p2_0(&s);
+        for (; i >= 0; --i) {
+            ge25519_p2_dbl(&t, &s);
+            for (j = 0U; j < n; j++) {
+                k = slides[j * 256U + i];
+                if (k > 0) {
+                    ge25519_p1p1_to_p3(&u, &t);
+                    ge25519_add_cached(&t, &u, &Pi[j * 8U + k / 2]);
+                } else if (k < 0) {
+                    ge25519_p1p1_to_p3(&u, &t);
+                    ge25519_sub_cached(&t, &u, &Pi[j * 8U + (-k) / 2]);
+                }
+            }
+            if (i == 0) {
+                ge25519_p1p1_to_p3(r, &t);
+            } else {
+                ge25519_p1p1_to_p2(&s, &t);
+            }
+        }
+    }
+    free(Pi);
+    free(slides);
+
+    return 0;
+}
+
+/*
+ Bucket (Pippenger) evaluation: the scalars are recoded into signed
+ digits in [-2^(w-1), 2^(w-1)), and for each digit position the points are
+ accumulated into 2^(w-1) buckets before being summed.
+ */
+
+static int
+ge25519_multi_scalarmult_pippenger_vartime(ge25519_p3 *r,
+                                           const unsigned char *a,
+                                           const ge25519_p3 *P, size_t n,
+                                           const int w)
+{
+    signed char    *digits;
+    ge25519_cached *Pc;
+    ge25519_p3     *buckets;
+    ge25519_cached  c;
+    ge25519_p1p1    t;
+    ge25519_p3      sum;
+    ge25519_p3      total;
+    ge25519_p2      s;
+    size_t          j;
+    const int       windows = 256 / w + 1;
+    const int       nbuckets = 1 << (w - 1);
+    int             carry;
+    int             bit;
+    int             d;
+    int             i;
+    int             k;
+
+    if (n > SIZE_MAX / (windows * sizeof *Pc) ||
+        (digits = (signed char *) malloc(n * windows)) == NULL) {
+        return -1;
+    }
+    if ((Pc = (ge25519_cached *) malloc(n * sizeof *Pc)) == NULL) {
+        free(digits);
+        return -1;
+    }
+    if ((buckets = (ge25519_p3 *) malloc(nbuckets * sizeof *buckets)) == NULL) {
+        free(Pc);
+        free(digits);
+        return -1;
+    }
+    for (j = 0U; j < n; j++) {
+        ge25519_p3_to_cached(&Pc[j], &P[j]);
+        carry = 0;
+        for (i = 0; i < windows; i++) {
+            d = carry;
+            for (k = 0; k < w; k++) {
+                bit = i * w + k;
+                if (bit < 256) {
+                    d += ((a[j * 32U + (bit >> 3)] >> (bit & 7)) & 1) << k;
+                }
+            }
+            carry = (d + nbuckets) >> w;
+            digits[j * windows + i] = (signed char) (d - (carry << w));
+        }
+    }
+    ge25519_p3_0(r);
+    for (i = windows - 1; i >= 0; i--) {
+        if (i != windows - 1) {
+            ge25519_p3_to_p2(&s, r);
+            for (k = 0; k < w; k++) {
+                ge25519_p2_dbl(&t, &s);
+                ge25519_p1p1_to_p2(&s, &t);
+            }
+            ge25519_p1p1_to_p3(r, &t);
+        }
+        for (k = 0; k < nbuckets; k++) {
+            ge25519_p3_0(&buckets[k]);
+        }
+        for (j = 0U; j < n; j++) {
+            d = digits[j * windows + i];
+            if (d > 0) {
+                ge25519_add_cached(&t, &buckets[d - 1], &Pc[j]);
+                ge25519_p1p1_to_p3(&buckets[d - 1], &t);
+            } else if (d < 0) {
+                ge25519_sub_cached(&t, &buckets[-d - 1], &Pc[j]);
+                ge25519_p1p1_to_p3(&buckets[-d - 1], &t);
+            }
+        }
+        sum = buckets[nbuckets - 1];
+        total = sum;
+        for (k = nbuckets - 2; k >= 0; k--) {
+            ge25519_p3_to_cached(&c, &buckets[k]);
+            ge25519_add_cached(&t, &sum, &c);
+            ge25519_p1p1_to_p3(&sum, &t);
+            ge25519_p3_to_cached(&c, &sum);
+            ge25519_add_cached(&t, &total, &c);
+            ge25519_p1p1_to_p3(&total, &t);
+        }
+        ge25519_p3_to_cached(&c, &total);
+        ge25519_add_cached(&t, r, &c);
+        ge25519_p1p1_to_p3(r, &t);
+    }
+    free(buckets);
+    free(Pc);
+    free(digits);
+
+    return 0;
+}
+
+/*
+ r = a[0] * P[0] + a[1] * P[1] + ... + a[n-1] * P[n-1]
+ where each a[i] is a 32-byte little-endian scalar, with a[i][31] <= 127.
+
+ Straus is used for small sets of points, Pippenger for large ones.
+
+ Variable time, only for public inputs.
+ Returns -1 if the temporary tables could not be allocated.
+ */
+
+int
+ge25519_multi_scalarmult_vartime(ge25519_p3 *r, const unsigned char *a,
+                                 const ge25519_p3 *P, size_t n)
+{
+    int w;
+
+    if (n < 190U) {
+        return ge25519_multi_scalarmult_straus_vartime(r, a, P, n);
+    }
+    if (n < 500U) {
+        w = 6;
+    } else if (n < 800U) {
+        w = 7;
+    } else {
+        w = 8;
+    }
+    return ge25519_multi_scalarmult_pippenger_vartime(r, a, P, n, w);
+}
+
+/*
+ Fixed-base multi-scalar multiplication, for points that are used many
+ times. For each point P[j], the table holds 2^(w*i)*P[j] for every window
+ i, in affine precomp form, so that the sum only needs one pass of bucket
+ accumulations, and no doublings.
+ */
+
+#define FIXED_WINDOW_MIN 4
+#define FIXED_WINDOW_MAX 12
+#define FIXED_WINDOWS_MAX (256 / FIXED_WINDOW_MIN + 1)
+
+int
+ge25519_multi_scalarmult_fixed_window(size_t n)
+{
+    size_t best_cost = SIZE_MAX;
+    size_t cost;
+    int    best_w = FIXED_WINDOW_MIN;
+    int    w;
+
+    if (n > (SIZE_MAX - ((size_t) 1U << FIXED_WINDOW_MAX)) / FIXED_WINDOWS_MAX) {
+        return FIXED_WINDOW_MAX;
+    }
+    for (w = FIXED_WINDOW_MIN; w <= FIXED_WINDOW_MAX; w++) {
+        cost = n * (size_t) ge25519_multi_scalarmult_fixed_windows(w) +
+               ((size_t) 1U << w);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_w    = w;
+        }
+    }
+    return best_w;
+}
+
+int
+ge25519_multi_scalarmult_fixed_windows(int w)
+{
+    return 256 / w + 1;
+}
+
+/*
+ table[j*windows+i] = 2^(w*i)*P[j]
+ */
+
+void
+ge25519_multi_scalarmult_fixed_init(ge25519_precomp *table,
+                                    const ge25519_p3 *P, size_t n, int w)
+{
+    ge25519_p3   row[FIXED_WINDOWS_MAX];
+    fe25519      acc[FIXED_WINDOWS_MAX];
+    ge25519_p1p1 t;
+    ge25519_p2   s;
+    fe25519      recip;
+    fe25519      u;
+    size_t       j;
+    const int    windows = ge25519_multi_scalarmult_fixed_windows(w);
+    int          i;
+    int          k;
+
+    for (j = 0U; j < n; j++) {
+        row[0] = P[j];
+        fe25519_copy(acc[0], row[0].Z);
+        for (i = 1; i < windows; i++) {
+            ge25519_p3_to_p2(&s, &row[i - 1]);
+            for (k = 0; k < w; k++) {
+                ge25519_p2_dbl(&t, &s);
+                ge25519_p1p1_to_p2(&s, &t);
+            }
+            ge25519_p1p1_to_p3(&row[i], &t);
+            fe25519_mul(acc[i], acc[i - 1], row[i].Z);
+        }
+        fe25519_invert(recip, acc[windows - 1]);
+        for (i = windows - 1; i > 0; i--) {
+            fe25519_mul(u, recip, acc[i - 1]);
+            fe25519_mul(recip, recip, row[i].Z);
+            ge25519_p3_to_precomp_recip(&table[j * windows + i], &row[i], u);
+        }
+        ge25519_p3_to_precomp_recip(&table[j * windows], &row[0], recip);
+    }
+}
+
+/*
+ r = a[0] * P[0] + a[1] * P[1] + ... + a[n-1] * P[n-1]
+ with a table built by ge25519_multi_scalarmult_fixed_init() for the same
+ window size. a[i][31] <= 127.
+
+ Variable time, only for public inputs.
+ Returns -1 if the buckets could not be allocated.
+ */
+
+int
+ge25519_multi_scalarmult_fixed_vartime(ge25519_p3 *r, const unsigned char *a,
+                                       const ge25519_precomp *table,
+                                       size_t n, int w)
+{
+    ge25519_p3     *buckets;
+    ge25519_cached  c;
+    ge25519_p1p1    t;
+    ge25519_p3      sum;
+    size_t          j;
+    const int       windows = ge25519_multi_scalarmult_fixed_windows(w);
+    const int       nbuckets = 1 << (w - 1);
+    int             carry;
+    int             bit;
+    int             d;
+    int             i;
+    int             k;
+
+    ge25519_p3_0(r);
+    if (n == 0U) {
+        return 0;
+    }
+    if ((buckets = (ge25519_p3 *) malloc(nbuckets * sizeof *buckets)) == NULL) {
+        return -1;
+    }
+    for (k = 0; k < nbuckets; k++) {
+        ge25519_p3_0(&buckets[k]);
+    }
+    for (j = 0U; j < n; j++) {
+        carry = 0;
+        for (i = 0; i < windows; i++) {
+            d = carry;
+            for (k = 0; k < w; k++) {
+                bit = i * w + k;
+                if (bit < 256) {
+                    d += ((a[j * 32U + (bit >> 3)] >> (bit & 7)) & 1) << k;
+                }
+            }
+            carry = (d + nbuckets) >> w;
+            d -= carry << w;
+            if (d > 0) {
+                ge25519_add_precomp(&t, &buckets[d - 1],
+                                    &table[j * windows + i]);
+                ge25519_p1p1_to_p3(&buckets[d - 1], &t);
+            } else if (d < 0) {
+                ge25519_sub_precomp(&t, &buckets[-d - 1],
+                                    &table[j * windows + i]);
+                ge25519_p1p1_to_p3(&buckets[-d - 1], &t);
+            }
+        }
+    }
+    sum = buckets[nbuckets - 1];
+    *r  = sum;
+    for (k = nbuckets - 2; k >= 0; k--) {
+        ge25519_p3_to_cached(&c, &buckets[k]);
+        ge25519_add_cached(&t, &sum, &c);
+        ge25519_p1p1_to_p3(&sum, &t);
+        ge25519_p3_to_cached(&c, &sum);
+        ge25519_add_cached(&t, r, &c);
+        ge25519_p1p1_to_p3(r, &t);
+    }
+    free(buckets);
+
+    return 0;
+}
+
+/*
+ h = a * p
+ where a = a[0]+256*a[1]+...+256^31 a[31]
+
+ Preconditions:
+ a[31] <= 127
+
+ p is public
+ */
+
+void
+ge25519_scalarmult(ge25519_p3 *h, const unsigned char *a, const ge25519_p3 *p)
+{
+    signed char     e[52];
+    signed char     carry;
+    ge25519_p1p1    r;
+    ge25519_p2      s;
+    ge25519_p3      pp[16];
+    ge25519_cached  pi[16];
+    ge25519_cached  t;
+    unsigned int    w;
+    int             i;
+
+    /* pi[i] = (i+1)*p, odd multiples by addition, even ones by doubling */
+    pp[0] = *p;
+    ge25519_p3_to_cached(&pi[0], p);
+    for (i = 1; i < 16; i++) {
+        if ((i & 1) != 0) {
+            ge25519_p3_dbl(&r, &pp[i / 2]);
+        } else {
+            ge25519_add_cached(&r, &pp[i - 1], &pi[0]);
+        }
+        ge25519_p1p1_to_p3(&pp[i], &r);
+        ge25519_p3_to_cached(&pi[i], &pp[i]);
+    }
+
+    for (i = 0; i < 51; ++i) {
+        w = a[(5 * i) >> 3];
+        if (((5 * i) >> 3) < 31) {
+            w |= (unsigned int) a[((5 * i) >> 3) + 1] << 8;
         }
+        e[i] = (signed char) ((w >> ((5 * i) & 7)) & 31);
+    }
+    e[51] = (signed char) (a[31] >> 7);
+    /* each e[i] is between 0 and 31 */
+    /* e[51] is between 0 and 1 */
+
+    carry = 0;
+    for (i = 0; i < 51; ++i) {
+        e[i] += carry;
+        carry = e[i] + 16;
+        carry >>= 5;
+        e[i] -= carry * ((signed char) 1 << 5);
+    }
+    e[51] += carry;
+    /* each e[i] is between -16 and 16 */
+
+    ge25519_p3_0(h);
+
+    for (i = 51; i != 0; i--) {
+        ge25519_cmov16_cached(&t, pi, e[i]);
+        ge25519_add_cached(&r, h, &t);
+
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
 
-        ge25519_p1p1_to_p2(r, &t);
+        ge25519_p1p1_to_p3(h, &r);  /* *32 */
     }
-}
-
-/*
- h = a * p
- where a = a[0]+256*a[1]+...+256^31 a[31]
-
- Preconditions:
- a[31] <= 127
+    ge25519_cmov16_cached(&t, pi, e[i]);
+    ge25519_add_cached(&r, h, &t);
 
- p is public
- */
+    ge25519_p1p1_to_p3(h, &r);
+}
 
-void
-ge25519_scalarmult(ge25519_p3 *h, const unsigned char *a, const ge25519_p3 *p)
+static void
+ge25519_scalarmult_table_digits(ge25519_p3 *h, const signed char e[64],
+                                const ge25519_precomp table[32][8])
 {
-    signed char     e[64];
-    signed char     carry;
     ge25519_p1p1    r;
     ge25519_p2      s;
-    ge25519_p1p1    t2, t3, t4, t5, t6, t7, t8;
-    ge25519_p3      p2, p3, p4, p5, p6, p7, p8;
-    ge25519_cached  pi[8];
-    ge25519_cached  t;
+    ge25519_precomp t;
     int             i;
 
-    ge25519_p3_to_cached(&pi[1 - 1], p);   /* p */
-
-    ge25519_p3_dbl(&t2, p);
-    ge25519_p1p1_to_p3(&p2, &t2);
-    ge25519_p3_to_cached(&pi[2 - 1], &p2); /* 2p = 2*p */
-
-    ge25519_add_cached(&t3, p, &pi[2 - 1]);
-    ge25519_p1p1_to_p3(&p3, &t3);
-    ge25519_p3_to_cached(&pi[3 - 1], &p3); /* 3p = 2p+p */
-
-    ge25519_p3_dbl(&t4, &p2);
-    ge25519_p1p1_to_p3(&p4, &t4);
-    ge25519_p3_to_cached(&pi[4 - 1], &p4); /* 4p = 2*2p */
+    ge25519_p3_0(h);
 
-    ge25519_add_cached(&t5, p, &pi[4 - 1]);
-    ge25519_p1p1_to_p3(&p5, &t5);
-    ge25519_p3_to_cached(&pi[5 - 1], &p5); /* 5p = 4p+p */
+    for (i = 1; i < 64; i += 2) {
+        ge25519_cmov8(&t, table[i / 2], e[i]);
+        ge25519_add_precomp(&r, h, &t);
+        ge25519_p1p1_to_p3(h, &r);
+    }
 
-    ge25519_p3_dbl(&t6, &p3);
-    ge25519_p1p1_to_p3(&p6, &t6);
-    ge25519_p3_to_cached(&pi[6 - 1], &p6); /* 6p = 2*3p */
+    ge25519_p3_dbl(&r, h);
+    ge25519_p1p1_to_p2(&s, &r);
+    ge25519_p2_dbl(&r, &s);
+    ge25519_p1p1_to_p2(&s, &r);
+    ge25519_p2_dbl(&r, &s);
+    ge25519_p1p1_to_p2(&s, &r);
+    ge25519_p2_dbl(&r, &s);
+    ge25519_p1p1_to_p3(h, &r);
 
-    ge25519_add_cached(&t7, p, &pi[6 - 1]);
-    ge25519_p1p1_to_p3(&p7, &t7);
-    ge25519_p3_to_cached(&pi[7 - 1], &p7); /* 7p = 6p+p */
+    for (i = 0; i < 64; i += 2) {
+        ge25519_cmov8(&t, table[i / 2], e[i]);
+        ge25519_add_precomp(&r, h, &t);
+        ge25519_p1p1_to_p3(h, &r);
+    }
+}
 
-    ge25519_p3_dbl(&t8, &p4);
-    ge25519_p1p1_to_p3(&p8, &t8);
-    ge25519_p3_to_cached(&pi[8 - 1], &p8); /* 8p = 2*4p */
+static void
+ge25519_scalar_digits16(signed char e[64], const unsigned char *a)
+{
+    signed char carry;
+    int         i;
 
     for (i = 0; i < 32; ++i) {
         e[2 * i + 0] = (a[i] >> 0) & 15;
@@ -900,29 +1957,44 @@ ge25519_scalarmult(ge25519_p3 *h, const unsigned char *a, const ge25519_p3 *p)
     }
     e[63] += carry;
     /* each e[i] is between -8 and 8 */
+}
 
-    ge25519_p3_0(h);
+#ifdef ED25519_SMALL_BASE_TABLE
+/*
+ h = sum(e[i]*16^i*B), with e[i] = e[8k+j] looked up in row k, and the
+ rows combined with the Horner rule over j
+ */
 
-    for (i = 63; i != 0; i--) {
-        ge25519_cmov8_cached(&t, pi, e[i]);
-        ge25519_add_cached(&r, h, &t);
+static void
+ge25519_scalarmult_base_digits_small(ge25519_p3 *h, const signed char e[64])
+{
+    ge25519_p1p1    r;
+    ge25519_p2      s;
+    ge25519_precomp t;
+    int             j;
+    int             k;
 
-        ge25519_p1p1_to_p2(&s, &r);
-        ge25519_p2_dbl(&r, &s);
-        ge25519_p1p1_to_p2(&s, &r);
-        ge25519_p2_dbl(&r, &s);
-        ge25519_p1p1_to_p2(&s, &r);
-        ge25519_p2_dbl(&r, &s);
-        ge25519_p1p1_to_p2(&s, &r);
-        ge25519_p2_dbl(&r, &s);
+    ge25519_p3_0(h);
 
-        ge25519_p1p1_to_p3(h, &r);  /* *16 */
+    for (j = 7; j >= 0; j--) {
+        if (j != 7) {
+            ge25519_p3_dbl(&r, h);
+            ge25519_p1p1_to_p2(&s, &r);
+            ge25519_p2_dbl(&r, &s);
+            ge25519_p1p1_to_p2(&s, &r);
+            ge25519_p2_dbl(&r, &s);
+            ge25519_p1p1_to_p2(&s, &r);
+            ge25519_p2_dbl(&r, &s);
+            ge25519_p1p1_to_p3(h, &r);
+        }
+        for (k = 0; k < 8; k++) {
+            ge25519_cmov8(&t, base[k], e[8 * k + j]);
+            ge25519_add_precomp(&r, h, &t);
+            ge25519_p1p1_to_p3(h, &r);
+        }
     }
-    ge25519_cmov8_cached(&t, pi, e[i]);
-    ge25519_add_cached(&r, h, &t);
-
-    ge25519_p1p1_to_p3(h, &r);
 }
+#endif
 
 /*
  h = a * B (with precomputation)
@@ -937,54 +2009,88 @@ ge25519_scalarmult(ge25519_p3 *h, const unsigned char *a, const ge25519_p3 *p)
 void
 ge25519_scalarmult_base(ge25519_p3 *h, const unsigned char *a)
 {
-    signed char     e[64];
-    signed char     carry;
-    ge25519_p1p1    r;
-    ge25519_p2      s;
-    ge25519_precomp t;
-    int             i;
+    signed char e[64];
 
-    for (i = 0; i < 32; ++i) {
-        e[2 * i + 0] = (a[i] >> 0) & 15;
-        e[2 * i + 1] = (a[i] >> 4) & 15;
-    }
-    /* each e[i] is between 0 and 15 */
-    /* e[63] is between 0 and 7 */
+    ge25519_scalar_digits16(e, a);
 
-    carry = 0;
-    for (i = 0; i < 63; ++i) {
-        e[i] += carry;
-        carry = e[i] + 8;
-        carry >>= 4;
-        e[i] -= carry * ((signed char) 1 << 4);
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    !defined(ED25519_SMALL_BASE_TABLE)
+    if (use_avx512ifma && ge25519_avx512ifma_prepare() == 0) {
+        ge25519_scalarmult_base_digits_avx512ifma(h, e);
+        return;
     }
-    e[63] += carry;
-    /* each e[i] is between -8 and 8 */
+#endif
+#ifdef ED25519_SMALL_BASE_TABLE
+    ge25519_scalarmult_base_digits_small(h, e);
+#else
+    ge25519_scalarmult_table_digits(h, e, base);
+#endif
+}
 
-    ge25519_p3_0(h);
+/*
+ table[i][j] = (j+1)*256^i*p, the same layout as the base point table
+ */
 
-    for (i = 1; i < 64; i += 2) {
-        ge25519_cmov8_base(&t, i / 2, e[i]);
-        ge25519_add_precomp(&r, h, &t);
-        ge25519_p1p1_to_p3(h, &r);
-    }
+void
+ge25519_scalarmult_table_init(ge25519_precomp table[32][8],
+                              const ge25519_p3 *p)
+{
+    ge25519_p3     row[8];
+    ge25519_cached c;
+    ge25519_p1p1   r;
+    ge25519_p2     s;
+    fe25519        acc[8];
+    fe25519        recip;
+    fe25519        t;
+    int            i;
+    int            j;
 
-    ge25519_p3_dbl(&r, h);
-    ge25519_p1p1_to_p2(&s, &r);
-    ge25519_p2_dbl(&r, &s);
-    ge25519_p1p1_to_p2(&s, &r);
-    ge25519_p2_dbl(&r, &s);
-    ge25519_p1p1_to_p2(&s, &r);
-    ge25519_p2_dbl(&r, &s);
-    ge25519_p1p1_to_p3(h, &r);
+    row[0] = *p;
+    for (i = 0; i < 32; i++) {
+        ge25519_p3_to_cached(&c, &row[0]);
+        fe25519_copy(acc[0], row[0].Z);
+        for (j = 1; j < 8; j++) {
+            ge25519_add_cached(&r, &row[j - 1], &c);
+            ge25519_p1p1_to_p3(&row[j], &r);
+            fe25519_mul(acc[j], acc[j - 1], row[j].Z);
+        }
+        fe25519_invert(recip, acc[7]);
+        for (j = 7; j > 0; j--) {
+            fe25519_mul(t, recip, acc[j - 1]);
+            fe25519_mul(recip, recip, row[j].Z);
+            ge25519_p3_to_precomp_recip(&table[i][j], &row[j], t);
+        }
+        ge25519_p3_to_precomp_recip(&table[i][0], &row[0], recip);
 
-    for (i = 0; i < 64; i += 2) {
-        ge25519_cmov8_base(&t, i / 2, e[i]);
-        ge25519_add_precomp(&r, h, &t);
-        ge25519_p1p1_to_p3(h, &r);
+        /* row[0] = 256*row[0] = 32*row[7] */
+        ge25519_p3_dbl(&r, &row[7]);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p2(&s, &r);
+        ge25519_p2_dbl(&r, &s);
+        ge25519_p1p1_to_p3(&row[0], &r);
     }
 }
 
+/*
+ h = a * p, with table built from p by ge25519_scalarmult_table_init()
+ a[31] <= 127
+ */
+
+void
+ge25519_scalarmult_table(ge25519_p3 *h, const unsigned char *a,
+                         const ge25519_precomp table[32][8])
+{
+    signed char e[64];
+
+    ge25519_scalar_digits16(e, a);
+    ge25519_scalarmult_table_digits(h, e, table);
+}
+
 /* r = 2p */
 static void
 ge25519_p3p3_dbl(ge25519_p3 *r, const ge25519_p3 *p)
@@ -1108,6 +2214,52 @@ ge25519_is_on_main_subgroup(const ge25519_p3 *p)
     return fe25519_iszero(pl.X);
 }
 
+/*
+ * Variable-time version of ge25519_is_on_main_subgroup(), for public points.
+ *
+ * The multiplication by l only checks that the x coordinate of the result
+ * is zero, so that points with a component of order 2 are also accepted:
+ * this is membership in 4E. E(F_p)/4E is cyclic of order 4, and is detected
+ * by the 4-Tate pairing with the rational 4-torsion point T = (1, s) of the
+ * Montgomery curve, s = sqrt(A + 2). With f = l^2 / u, l being the tangent
+ * at T, and (u, v) the Montgomery coordinates of p, p is in 4E iff
+ * f(p)^((p-1)/4) = 1. Since l(p) = u (sqrt(-A-2) / x - s), up to fourth
+ * powers, this is (-(A+2) (1+y)(1-y)^3 (1-sqrt(-1) x)^2 x^2)^((p-1)/4),
+ * which costs a single exponentiation.
+ */
+int
+ge25519_is_on_main_subgroup_vartime(const ge25519_p3 *p)
+{
+    fe25519 zpy, zmy, zmix;
+    fe25519 t, u;
+    fe25519 one;
+
+    if (fe25519_iszero(p->X)) {
+        return 1;
+    }
+    fe25519_add(zpy, p->Z, p->Y);
+    fe25519_sub(zmy, p->Z, p->Y);
+    fe25519_mul(zmix, p->X, fe25519_sqrtm1);
+    fe25519_sub(zmix, p->Z, zmix);
+
+    fe25519_sq(t, zmy);
+    fe25519_mul(t, t, zmy);
+    fe25519_mul(t, t, zpy);
+    fe25519_mul(u, zmix, p->X);
+    fe25519_sq(u, u);
+    fe25519_mul(t, t, u);
+    fe25519_sq(u, ed25519_sqrtam2);
+    fe25519_mul(t, t, u);
+
+    fe25519_pow22523(u, t);
+    fe25519_sq(u, u);
+    fe25519_mul(u, u, t); /* t^((p-1)/4) */
+    fe25519_1(one);
+    fe25519_sub(u, u, one);
+
+    return fe25519_iszero(u);
+}
+
 int
 ge25519_is_canonical(const unsigned char *s)
 {
@@ -1181,6 +2333,10 @@ ge25519_has_small_order(const unsigned char s[32])
     return (int) ((k >> 8) & 1);
 }
 
+#ifdef HAVE_TI_MODE
+# include "sc_64/sc.h"
+#else
+
 /*
  Input:
  a[0]+256*a[1]+...+256^31*a[31] = a
@@ -2140,95 +3296,23 @@ sc25519_muladd(unsigned char s[32], const unsigned char a[32],
     s[30] = s11 >> 9;
     s[31] = s11 >> 17;
 }
-
-/*
- Input:
- a[0]+256*a[1]+...+256^31*a[31] = a
- *
- Output:
- s[0]+256*s[1]+...+256^31*s[31] = a^2 mod l
- where l = 2^252 + 27742317777372353535851937790883648493.
- */
-
-static inline void
-sc25519_sq(unsigned char *s, const unsigned char *a)
-{
-    sc25519_mul(s, a, a);
-}
-
-/*
- Input:
- s[0]+256*a[1]+...+256^31*a[31] = a
- n
- *
- Output:
- s[0]+256*s[1]+...+256^31*s[31] = x * s^(s^n) mod l
- where l = 2^252 + 27742317777372353535851937790883648493.
- Overwrites s in place.
- */
-
-static inline void
-sc25519_sqmul(unsigned char s[32], const int n, const unsigned char a[32])
-{
-    int i;
-
-    for (i = 0; i < n; i++) {
-        sc25519_sq(s, s);
-    }
-    sc25519_mul(s, s, a);
-}
+#endif
 
 void
 sc25519_invert(unsigned char recip[32], const unsigned char s[32])
 {
-    unsigned char _10[32], _100[32], _1000[32], _10000[32], _100000[32],
-        _1000000[32], _10010011[32], _10010111[32], _100110[32], _1010[32],
-        _1010000[32], _1010011[32], _1011[32], _10110[32], _10111101[32],
-        _11[32], _1100011[32], _1100111[32], _11010011[32], _1101011[32],
-        _11100111[32], _11101011[32], _11110101[32];
-
-    sc25519_sq(_10, s);
-    sc25519_mul(_11, s, _10);
-    sc25519_mul(_100, s, _11);
-    sc25519_sq(_1000, _100);
-    sc25519_mul(_1010, _10, _1000);
-    sc25519_mul(_1011, s, _1010);
-    sc25519_sq(_10000, _1000);
-    sc25519_sq(_10110, _1011);
-    sc25519_mul(_100000, _1010, _10110);
-    sc25519_mul(_100110, _10000, _10110);
-    sc25519_sq(_1000000, _100000);
-    sc25519_mul(_1010000, _10000, _1000000);
-    sc25519_mul(_1010011, _11, _1010000);
-    sc25519_mul(_1100011, _10000, _1010011);
-    sc25519_mul(_1100111, _100, _1100011);
-    sc25519_mul(_1101011, _100, _1100111);
-    sc25519_mul(_10010011, _1000000, _1010011);
-    sc25519_mul(_10010111, _100, _10010011);
-    sc25519_mul(_10111101, _100110, _10010111);
-    sc25519_mul(_11010011, _10110, _10111101);
-    sc25519_mul(_11100111, _1010000, _10010111);
-    sc25519_mul(_11101011, _100, _11100111);
-    sc25519_mul(_11110101, _1010, _11101011);
-
-    sc25519_mul(recip, _1011, _11110101);
-    sc25519_sqmul(recip, 126, _1010011);
-    sc25519_sqmul(recip, 9, _10);
-    sc25519_mul(recip, recip, _11110101);
-    sc25519_sqmul(recip, 7, _1100111);
-    sc25519_sqmul(recip, 9, _11110101);
-    sc25519_sqmul(recip, 11, _10111101);
-    sc25519_sqmul(recip, 8, _11100111);
-    sc25519_sqmul(recip, 9, _1101011);
-    sc25519_sqmul(recip, 6, _1011);
-    sc25519_sqmul(recip, 14, _10010011);
-    sc25519_sqmul(recip, 10, _1100011);
-    sc25519_sqmul(recip, 9, _10010111);
-    sc25519_sqmul(recip, 10, _11110101);
-    sc25519_sqmul(recip, 8, _11010011);
-    sc25519_sqmul(recip, 8, _11101011);
+    unsigned char t[64];
+
+    memcpy(t, s, 32);
+    memset(t + 32, 0, 32);
+    sc25519_reduce(t);
+    modinv_bytes(t, &modinv_l);
+    memcpy(recip, t, 32);
+    sodium_memzero(t, sizeof t);
 }
 
+#ifndef HAVE_TI_MODE
+
 /*
  Input:
  s[0]+256*s[1]+...+256^63*s[63] = s
@@ -2562,6 +3646,7 @@ sc25519_reduce(unsigned char s[64])
     s[30] = s11 >> 9;
     s[31] = s11 >> 17;
 }
+#endif
 
 int
 sc25519_is_canonical(const unsigned char s[32])
@@ -2628,7 +3713,7 @@ ge25519_xmont_to_ymont(fe25519 y, const fe25519 x)
 }
 
 /* multiply by the cofactor */
-static void
+void
 ge25519_clear_cofactor(ge25519_p3 *p3)
 {
     ge25519_p1p1 p1;
@@ -2642,18 +3727,15 @@ ge25519_clear_cofactor(ge25519_p3 *p3)
     ge25519_p1p1_to_p3(p3, &p1);
 }
 
+/* rr2 = 1/(2*r^2+1) */
 static void
-ge25519_elligator2(fe25519 x, fe25519 y, const fe25519 r, int *notsquare_p)
+ge25519_elligator2_recip(fe25519 x, fe25519 y, const fe25519 rr2,
+                         int *notsquare_p)
 {
-    fe25519       e;
     fe25519       gx1;
-    fe25519       rr2;
     fe25519       x2, x3, negx;
     int           notsquare;
 
-    fe25519_sq2(rr2, r);
-    rr2[0]++;
-    fe25519_invert(rr2, rr2);
     fe25519_mul32(x, rr2, ed25519_A_32);
     fe25519_neg(x, x); /* x=x1 */
 
@@ -2680,6 +3762,17 @@ ge25519_elligator2(fe25519 x, fe25519 y, const fe25519 r, int *notsquare_p)
     *notsquare_p = notsquare;
 }
 
+static void
+ge25519_elligator2(fe25519 x, fe25519 y, const fe25519 r, int *notsquare_p)
+{
+    fe25519 rr2;
+
+    fe25519_sq2(rr2, r);
+    rr2[0]++;
+    fe25519_invert(rr2, rr2);
+    ge25519_elligator2_recip(x, y, rr2, notsquare_p);
+}
+
 void
 ge25519_from_uniform(unsigned char s[32], const unsigned char r[32])
 {
@@ -2753,6 +3846,94 @@ ge25519_from_hash(unsigned char s[32], const unsigned char h[64])
     ge25519_p3_tobytes(s, &p3);
 }
 
+/*
+ Same as ge25519_mont_to_ed(), but with projective coordinates, so that no
+ inversion is required.
+ */
+
+static void
+ge25519_mont_to_ed_p3(ge25519_p3 *p, const fe25519 x, const fe25519 y)
+{
+    fe25519 one;
+    fe25519 x_plus_one;
+    fe25519 x_minus_one;
+    fe25519 zero;
+    int     is_zero;
+
+    fe25519_1(one);
+    fe25519_0(zero);
+    fe25519_add(x_plus_one, x, one);
+    fe25519_sub(x_minus_one, x, one);
+
+    fe25519_mul(p->X, x, ed25519_sqrtam2);
+    fe25519_mul(p->T, p->X, x_minus_one); /* T = sqrt(-A-2)*x*(x-1) */
+    fe25519_mul(p->X, p->X, x_plus_one);  /* X = sqrt(-A-2)*x*(x+1) */
+    fe25519_mul(p->Y, x_minus_one, y);    /* Y = (x-1)*y */
+    fe25519_mul(p->Z, x_plus_one, y);     /* Z = (x+1)*y */
+
+    is_zero = fe25519_iszero(p->Z);
+    fe25519_cmov(p->X, zero, is_zero);
+    fe25519_cmov(p->Y, one, is_zero);
+    fe25519_cmov(p->Z, one, is_zero);
+    fe25519_cmov(p->T, zero, is_zero);
+}
+
+/*
+ Maps count 64-byte hashes to points, as ge25519_from_hash() does, without
+ encoding them. The inversions are shared among up to
+ GE25519_FROM_HASH_BATCH hashes, and the Edwards coordinates are kept
+ projective, leaving two exponentiations per point instead of four.
+ */
+
+#define GE25519_FROM_HASH_BATCH 16U
+
+void
+ge25519_from_hash_batch(ge25519_p3 *p, const unsigned char *h, size_t count)
+{
+    fe25519 den[GE25519_FROM_HASH_BATCH];
+    fe25519 acc[GE25519_FROM_HASH_BATCH];
+    fe25519 recip;
+    fe25519 rr2;
+    fe25519 x, y, negy;
+    size_t  chunk;
+    size_t  i;
+    size_t  j;
+    int     notsquare;
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > GE25519_FROM_HASH_BATCH) {
+            chunk = GE25519_FROM_HASH_BATCH;
+        }
+        for (j = 0U; j < chunk; j++) {
+            fe25519_reduce64(rr2, &h[(i + j) * 64U]);
+            fe25519_sq2(den[j], rr2);
+            den[j][0]++; /* den = 2*r^2+1, never 0 */
+            if (j == 0U) {
+                fe25519_copy(acc[0], den[0]);
+            } else {
+                fe25519_mul(acc[j], acc[j - 1U], den[j]);
+            }
+        }
+        fe25519_invert(recip, acc[chunk - 1U]);
+        for (j = chunk; j-- > 0U;) {
+            if (j > 0U) {
+                fe25519_mul(rr2, recip, acc[j - 1U]);
+                fe25519_mul(recip, recip, den[j]);
+            } else {
+                fe25519_copy(rr2, recip);
+            }
+            ge25519_elligator2_recip(x, y, rr2, &notsquare);
+
+            fe25519_neg(negy, y);
+            fe25519_cmov(y, negy, fe25519_isnegative(y) ^ notsquare);
+
+            ge25519_mont_to_ed_p3(&p[i + j], x, y);
+            ge25519_clear_cofactor(&p[i + j]);
+        }
+    }
+}
+
 /* Ristretto group */
 
 static int
@@ -2918,6 +4099,116 @@ ristretto255_p3_tobytes(unsigned char *s, const ge25519_p3 *h)
     fe25519_tobytes(s, s_);
 }
 
+/*
+ * Encodes 2*h[i] for count points into s. The encoding of a doubled point
+ * only needs an inversion instead of an inverse square root, so a single
+ * inversion is shared among up to RISTRETTO255_DBL_TOBYTES_BATCH points.
+ * Constant time.
+ */
+
+#define RISTRETTO255_DBL_TOBYTES_BATCH 16U
+
+void
+ristretto255_p3_dbl_tobytes_batch(unsigned char *s, const ge25519_p3 *h,
+                                  size_t count)
+{
+    struct {
+        fe25519 e, f, g, h;
+        fe25519 eg, fh;
+    } st[RISTRETTO255_DBL_TOBYTES_BATCH];
+    fe25519 acc[RISTRETTO255_DBL_TOBYTES_BATCH];
+    fe25519 e, g, h_;
+    fe25519 efgh;
+    fe25519 f_sqrtm1;
+    fe25519 inv, recip;
+    fe25519 magic;
+    fe25519 minus_e;
+    fe25519 one;
+    fe25519 s_;
+    fe25519 t;
+    fe25519 t_inv, z_inv;
+    fe25519 xx, yy, zz, dtt;
+    size_t  chunk;
+    size_t  i;
+    size_t  j;
+    int     iszero[RISTRETTO255_DBL_TOBYTES_BATCH];
+    int     rotate;
+
+    fe25519_1(one);
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > RISTRETTO255_DBL_TOBYTES_BATCH) {
+            chunk = RISTRETTO255_DBL_TOBYTES_BATCH;
+        }
+        for (j = 0U; j < chunk; j++) {
+            const ge25519_p3 *p = &h[i + j];
+
+            fe25519_sq(xx, p->X);
+            fe25519_sq(yy, p->Y);
+            fe25519_sq(zz, p->Z);
+            fe25519_sq(dtt, p->T);
+            fe25519_mul(dtt, dtt, ed25519_d);      /* dtt = d*T^2 */
+            fe25519_add(st[j].e, p->Y, p->Y);
+            fe25519_mul(st[j].e, st[j].e, p->X);   /* e = 2*X*Y */
+            fe25519_add(st[j].f, zz, dtt);         /* f = Z^2+d*T^2 */
+            fe25519_add(st[j].g, yy, xx);          /* g = Y^2+X^2 */
+            fe25519_sub(st[j].h, zz, dtt);         /* h = Z^2-d*T^2 */
+            fe25519_mul(st[j].eg, st[j].e, st[j].g);
+            fe25519_mul(st[j].fh, st[j].f, st[j].h);
+
+            /* e = 0 for points of order 1, 2 and 4, whose double is 0 */
+            fe25519_mul(efgh, st[j].eg, st[j].fh);
+            iszero[j] = fe25519_iszero(efgh);
+            fe25519_cmov(efgh, one, iszero[j]);
+            if (j == 0U) {
+                fe25519_copy(acc[0], efgh);
+            } else {
+                fe25519_mul(acc[j], acc[j - 1U], efgh);
+            }
+        }
+        fe25519_invert(recip, acc[chunk - 1U]);
+        for (j = chunk; j-- > 0U;) {
+            if (j > 0U) {
+                fe25519_mul(inv, recip, acc[j - 1U]);
+                fe25519_mul(efgh, st[j].eg, st[j].fh);
+                fe25519_cmov(efgh, one, iszero[j]);
+                fe25519_mul(recip, recip, efgh);
+            } else {
+                fe25519_copy(inv, recip);
+            }
+            fe25519_0(t);
+            fe25519_cmov(inv, t, iszero[j]);
+
+            fe25519_mul(z_inv, st[j].eg, inv);     /* z_inv = 1/(f*h) */
+            fe25519_mul(t_inv, st[j].fh, inv);     /* t_inv = 1/(e*g) */
+
+            fe25519_mul(t, st[j].eg, z_inv);
+            rotate = fe25519_isnegative(t);
+            fe25519_copy(e, st[j].e);
+            fe25519_copy(g, st[j].g);
+            fe25519_copy(h_, st[j].h);
+            fe25519_copy(magic, ed25519_invsqrtamd);
+            fe25519_neg(minus_e, e);
+            fe25519_mul(f_sqrtm1, st[j].f, fe25519_sqrtm1);
+            fe25519_cmov(e, st[j].g, rotate);
+            fe25519_cmov(g, minus_e, rotate);
+            fe25519_cmov(h_, f_sqrtm1, rotate);
+            fe25519_cmov(magic, fe25519_sqrtm1, rotate);
+
+            fe25519_mul(t, h_, e);
+            fe25519_mul(t, t, z_inv);
+            fe25519_cneg(g, g, fe25519_isnegative(t));
+
+            fe25519_sub(s_, h_, g);
+            fe25519_mul(t, g, t_inv);
+            fe25519_mul(t, t, magic);
+            fe25519_mul(s_, s_, t);
+            fe25519_abs(s_, s_);
+            fe25519_tobytes(&s[(i + j) * 32U], s_);
+        }
+    }
+}
+
 static void
 ristretto255_elligator(ge25519_p3 *p, const fe25519 t)
 {
@@ -2987,3 +4278,14 @@ ristretto255_from_hash(unsigned char s[32], const unsigned char h[64])
     ge25519_p1p1_to_p3(&p, &p_p1p1);
     ristretto255_p3_tobytes(s, &p);
 }
+
+int
+_crypto_core_ed25519_pick_best_implementation(void)
+{
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    !defined(ED25519_SMALL_BASE_TABLE)
+    use_avx512ifma = sodium_runtime_has_avx512ifma() &&
+        _sodium_runtime_use_512bit_vectors();
+#endif
+    return 0;
+}
@@ -0,0 +1,303 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "private/ed25519_ref10_decls.h"
+
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    !defined(ED25519_SMALL_BASE_TABLE)
+
+# ifdef __GNUC__
+#  pragma GCC target("avx2")
+#  pragma GCC target("avx512f")
+#  pragma GCC target("avx512vl")
+#  pragma GCC target("avx512ifma")
+# endif
+
+# include <immintrin.h>
+
+# include "ed25519_ref10_avx512ifma.h"
+# include "private/fe25519x4_avx512ifma.h"
+
+/*
+ A point in extended coordinates: lanes are (X, Y, Z, T) for
+ ge25519x4_p3, and (Y-X, Y+X, 2Z, 2dT) for ge25519x4_cached.
+ */
+
+typedef struct ge25519x4_p3_ {
+    fe25519x4 c;
+} ge25519x4_p3;
+
+typedef struct ge25519x4_cached_ {
+    fe25519x4 c;
+} ge25519x4_cached;
+
+static ge25519x4_cached Bi[32]; /* B,3B,5B,...,63B */
+static ge25519x4_cached Bi_neg[32];
+static ge25519x4_cached Bt[32][8]; /* Bt[i][j] = (j+1)*256^i*B */
+
+/*
+ r = p + q
+ */
+
+static void
+ge25519x4_add_cached(ge25519x4_p3 *r, const ge25519x4_p3 *p,
+                     const ge25519x4_cached *q)
+{
+    fe25519x4 t0, t1, t2;
+
+    /* (Y1-X1, Y1+X1, Z1, T1) */
+    fe25519x4_shuffle(&t0, &p->c, SHUFFLE(1, 0, 2, 3));
+    fe25519x4_sub(&t1, &t0, &p->c);
+    fe25519x4_add(&t2, &t0, &p->c);
+    fe25519x4_blend(&t0, &p->c, &t1, LANE_A);
+    fe25519x4_blend(&t0, &t0, &t2, LANE_B);
+    fe25519x4_carry(&t0, &t0);
+
+    /* (A, B, D, C) */
+    fe25519x4_mul(&t0, &t0, &q->c);
+
+    /* (E, H, G, F) = (B-A, B+A, D+C, D-C) */
+    fe25519x4_shuffle(&t1, &t0, SHUFFLE(1, 0, 3, 2));
+    fe25519x4_sub(&t2, &t1, &t0);
+    fe25519x4_add(&t1, &t1, &t0);
+    fe25519x4_blend(&t0, &t2, &t1, LANE_B | LANE_C);
+    fe25519x4_carry(&t0, &t0);
+
+    /* (EF, GH, FG, EH) */
+    fe25519x4_shuffle(&t1, &t0, SHUFFLE(0, 2, 3, 0));
+    fe25519x4_shuffle(&t2, &t0, SHUFFLE(3, 1, 2, 1));
+    fe25519x4_mul(&r->c, &t1, &t2);
+}
+
+/*
+ r = 2 * p
+ */
+
+static void
+ge25519x4_dbl(ge25519x4_p3 *r, const ge25519x4_p3 *p)
+{
+    fe25519x4 s1, s2, t0, t1, t2;
+
+    /* (X1, Y1, Z1, X1+Y1) */
+    fe25519x4_shuffle(&t0, &p->c, SHUFFLE(1, 0, 3, 2));
+    fe25519x4_add(&t0, &t0, &p->c);
+    fe25519x4_shuffle(&t0, &t0, SHUFFLE(0, 1, 2, 0));
+    fe25519x4_blend(&t0, &p->c, &t0, LANE_D);
+    fe25519x4_carry(&t0, &t0);
+
+    /* (S1, S2, S3, S4) = (X1^2, Y1^2, Z1^2, (X1+Y1)^2) */
+    fe25519x4_mul(&t0, &t0, &t0);
+
+    /* (S1+S2, S1-S2, S1-S2+2S3, S1+S2-S4) */
+    fe25519x4_shuffle(&s1, &t0, SHUFFLE(0, 0, 0, 0));
+    fe25519x4_shuffle(&s2, &t0, SHUFFLE(1, 1, 1, 1));
+    fe25519x4_0(&t1);
+    fe25519x4_sub(&t2, &t1, &s2);
+    fe25519x4_blend(&s2, &s2, &t2, LANE_B | LANE_C);
+    fe25519x4_sub(&t2, &t1, &t0);
+    fe25519x4_add(&t0, &t0, &t0);
+    fe25519x4_blend(&t1, &t1, &t0, LANE_C);
+    fe25519x4_blend(&t1, &t1, &t2, LANE_D);
+    fe25519x4_add(&t0, &s1, &s2);
+    fe25519x4_add(&t0, &t0, &t1);
+    fe25519x4_carry(&t0, &t0);
+
+    /* X3 = E'F', Y3 = G'H', Z3 = F'G', T3 = E'H' */
+    fe25519x4_shuffle(&t1, &t0, SHUFFLE(3, 1, 2, 3));
+    fe25519x4_shuffle(&t2, &t0, SHUFFLE(2, 0, 1, 0));
+    fe25519x4_mul(&r->c, &t1, &t2);
+}
+
+static void
+ge25519x4_p3_to_cached(ge25519x4_cached *r, ge25519x4_cached *r_neg,
+                       const ge25519x4_p3 *p)
+{
+    static const uint64_t k[5][4] = {
+        { 1, 1, 2, 1859910466990425ULL },
+        { 0, 0, 0, 932731440258426ULL },
+        { 0, 0, 0, 1072319116312658ULL },
+        { 0, 0, 0, 1815898335770999ULL },
+        { 0, 0, 0, 633789495995903ULL }
+    }; /* (1, 1, 2, 2d) */
+    fe25519x4 t0, t1, t2;
+    int       i;
+
+    fe25519x4_shuffle(&t0, &p->c, SHUFFLE(1, 0, 2, 3));
+    fe25519x4_sub(&t1, &t0, &p->c);
+    fe25519x4_add(&t2, &t0, &p->c);
+    fe25519x4_blend(&t0, &p->c, &t1, LANE_A);
+    fe25519x4_blend(&t0, &t0, &t2, LANE_B);
+    fe25519x4_carry(&t0, &t0);
+    for (i = 0; i < 5; i++) {
+        t1.v[i] = _mm256_loadu_si256((const __m256i *) (const void *) k[i]);
+    }
+    fe25519x4_mul(&r->c, &t0, &t1);
+
+    /* -p = (Y+X, Y-X, 2Z, -2dT) */
+    fe25519x4_shuffle(&t0, &r->c, SHUFFLE(1, 0, 2, 3));
+    fe25519x4_0(&t1);
+    fe25519x4_sub(&t1, &t1, &t0);
+    fe25519x4_blend(&t0, &t0, &t1, LANE_D);
+    fe25519x4_carry(&r_neg->c, &t0);
+}
+
+static void
+ge25519x4_from_p3(ge25519x4_p3 *r, const ge25519_p3 *p)
+{
+    fe25519x4_from_fe25519(&r->c, p->X, p->Y, p->Z, p->T);
+}
+
+static void
+ge25519x4_odd_multiples(ge25519x4_cached *Pi, ge25519x4_cached *Pi_neg,
+                        const ge25519x4_p3 *P, const int count)
+{
+    ge25519x4_p3 P2, u;
+    int          i;
+
+    ge25519x4_p3_to_cached(&Pi[0], &Pi_neg[0], P);
+    ge25519x4_dbl(&P2, P);
+    for (i = 1; i < count; i++) {
+        ge25519x4_add_cached(&u, &P2, &Pi[i - 1]);
+        ge25519x4_p3_to_cached(&Pi[i], &Pi_neg[i], &u);
+    }
+}
+
+/*
+ t = b * 256^pos * B, in constant time
+ */
+
+static void
+ge25519x4_cmov8_base(ge25519x4_cached *t, const int pos, const signed char b)
+{
+    const uint64_t bnegative = ((uint64_t) (int64_t) b) >> 63;
+    const uint64_t babs = (uint64_t) (b - (((-(int) bnegative) & b) * 2));
+    fe25519x4      minust, u;
+    __m256i        mask;
+    uint64_t       eq;
+    int            j;
+
+    /* (1, 1, 2, 0) */
+    fe25519x4_0(&t->c);
+    t->c.v[0] = _mm256_set_epi64x(0, 2, 1, 1);
+    for (j = 0; j < 8; j++) {
+        eq   = ((babs ^ (uint64_t) (j + 1)) - 1U) >> 63;
+        mask = _mm256_set1_epi64x(-(long long) eq);
+        fe25519x4_cmov(&t->c, &Bt[pos][j].c, mask);
+    }
+
+    /* -t = (Y+X, Y-X, 2Z, -2dT) */
+    fe25519x4_shuffle(&minust, &t->c, SHUFFLE(1, 0, 2, 3));
+    fe25519x4_0(&u);
+    fe25519x4_sub(&u, &u, &minust);
+    fe25519x4_carry(&u, &u);
+    fe25519x4_blend(&minust, &minust, &u, LANE_D);
+    mask = _mm256_set1_epi64x(-(long long) bnegative);
+    fe25519x4_cmov(&t->c, &minust, mask);
+}
+
+void
+ge25519_avx512ifma_init(const ge25519_p3 *B, const ge25519_precomp base[32][8])
+{
+    static const fe25519 two = { 2 };
+    ge25519x4_p3         t;
+    int                  i, j;
+
+    ge25519x4_from_p3(&t, B);
+    ge25519x4_odd_multiples(Bi, Bi_neg, &t, 32);
+
+    for (i = 0; i < 32; i++) {
+        for (j = 0; j < 8; j++) {
+            fe25519x4_from_fe25519(&Bt[i][j].c, base[i][j].yminusx,
+                                   base[i][j].yplusx, two, base[i][j].xy2d);
+        }
+    }
+}
+
+/*
+ h = a * B
+ where e is the signed radix-16 representation of a,
+ as computed by ge25519_scalarmult_base()
+ */
+
+void
+ge25519_scalarmult_base_digits_avx512ifma(ge25519_p3 *h, const signed char e[64])
+{
+    ge25519x4_cached t;
+    ge25519x4_p3     r;
+    int              i;
+
+    /* (0, 1, 1, 0) */
+    fe25519x4_0(&r.c);
+    r.c.v[0] = _mm256_set_epi64x(0, 1, 1, 0);
+
+    for (i = 1; i < 64; i += 2) {
+        ge25519x4_cmov8_base(&t, i / 2, e[i]);
+        ge25519x4_add_cached(&r, &r, &t);
+    }
+
+    ge25519x4_dbl(&r, &r);
+    ge25519x4_dbl(&r, &r);
+    ge25519x4_dbl(&r, &r);
+    ge25519x4_dbl(&r, &r);
+
+    for (i = 0; i < 64; i += 2) {
+        ge25519x4_cmov8_base(&t, i / 2, e[i]);
+        ge25519x4_add_cached(&r, &r, &t);
+    }
+    fe25519x4_to_fe25519(h->X, &r.c, 0);
+    fe25519x4_to_fe25519(h->Y, &r.c, 1);
+    fe25519x4_to_fe25519(h->Z, &r.c, 2);
+    fe25519x4_to_fe25519(h->T, &r.c, 3);
+}
+
+/*
+ r = a * A + b * B
+ where aslide and bslide are the signed sliding window representations
+ of a (width 4) and b (width 6).
+ */
+
+void
+ge25519_double_scalarmult_slides_vartime_avx512ifma(ge25519_p2 *r,
+                                                    const signed char *aslide,
+                                                    const ge25519_p3 *A,
+                                                    const signed char *bslide)
+{
+    ge25519x4_cached Ai[8], Ai_neg[8]; /* A,3A,5A,7A,9A,11A,13A,15A */
+    ge25519x4_p3     t;
+    int              i;
+
+    for (i = 255; i >= 0; --i) {
+        if (aslide[i] || bslide[i]) {
+            break;
+        }
+    }
+    ge25519x4_from_p3(&t, A);
+    ge25519x4_odd_multiples(Ai, Ai_neg, &t, 8);
+
+    /* (0, 1, 1, 0) */
+    fe25519x4_0(&t.c);
+    t.c.v[0] = _mm256_set_epi64x(0, 1, 1, 0);
+
+    for (; i >= 0; --i) {
+        ge25519x4_dbl(&t, &t);
+
+        if (aslide[i] > 0) {
+            ge25519x4_add_cached(&t, &t, &Ai[aslide[i] / 2]);
+        } else if (aslide[i] < 0) {
+            ge25519x4_add_cached(&t, &t, &Ai_neg[(-aslide[i]) / 2]);
+        }
+
+        if (bslide[i] > 0) {
+            ge25519x4_add_cached(&t, &t, &Bi[bslide[i] / 2]);
+        } else if (bslide[i] < 0) {
+            ge25519x4_add_cached(&t, &t, &Bi_neg[(-bslide[i]) / 2]);
+        }
+    }
+    fe25519x4_to_fe25519(r->X, &t.c, 0);
+    fe25519x4_to_fe25519(r->Y, &t.c, 1);
+    fe25519x4_to_fe25519(r->Z, &t.c, 2);
+}
+
+#endif
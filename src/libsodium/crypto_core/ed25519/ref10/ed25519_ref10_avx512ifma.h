@@ -0,0 +1,17 @@
+#ifndef ed25519_ref10_avx512ifma_H
+#define ed25519_ref10_avx512ifma_H
+
+#include "private/ed25519_ref10_decls.h"
+
+void ge25519_avx512ifma_init(const ge25519_p3 *B,
+                             const ge25519_precomp base[32][8]);
+
+void ge25519_scalarmult_base_digits_avx512ifma(ge25519_p3 *h,
+                                               const signed char e[64]);
+
+void ge25519_double_scalarmult_slides_vartime_avx512ifma(ge25519_p2 *r,
+                                                         const signed char *aslide,
+                                                         const ge25519_p3 *A,
+                                                         const signed char *bslide);
+
+#endif
@@ -0,0 +1,320 @@
+{
+  { 1288382639258501, 245678601348599, 269427782077623, 1462984067271730, 137412439391563 },
+  { 62697248952638, 204681361388450, 631292143396476, 338455783676468, 1213667448819585 },
+  { 301289933810280, 1259582250014073, 1422107436869536, 796239922652654, 1953934009299142 }
+},
+{
+  { 1601611775252272, 1720807796594148, 1132070835939856, 1260455018889551, 2147779492816911 },
+  { 316559037616741, 2177824224946892, 1459442586438991, 1461528397712656, 751590696113597 },
+  { 1850748884277385, 1200145853858453, 1068094770532492, 672251375690438, 1586055907191707 }
+},
+{
+  { 769950342298419, 132954430919746, 844085933195555, 974092374476333, 726076285546016 },
+  { 425251763115706, 608463272472562, 442562545713235, 837766094556764, 374555092627893 },
+  { 1086255230780037, 274979815921559, 1960002765731872, 929474102396301, 1190409889297339 }
+},
+{
+  { 665000864555967, 2065379846933859, 370231110385876, 350988370788628, 1233371373142985 },
+  { 2019367628972465, 676711900706637, 110710997811333, 1108646842542025, 517791959672113 },
+  { 965130719900578, 247011430587952, 526356006571389, 91986625355052, 2157223321444601 }
+},
+{
+  { 1802695059465007, 1664899123557221, 593559490740857, 2160434469266659, 927570450755031 },
+  { 1725674970513508, 1933645953859181, 1542344539275782, 1767788773573747, 1297447965928905 },
+  { 1381809363726107, 1430341051343062, 2061843536018959, 1551778050872521, 2036394857967624 }
+},
+{
+  { 1970894096313054, 528066325833207, 1619374932191227, 2207306624415883, 1169170329061080 },
+  { 2070390218572616, 1458919061857835, 624171843017421, 1055332792707765, 433987520732508 },
+  { 893653801273833, 1168026499324677, 1242553501121234, 1306366254304474, 1086752658510815 }
+},
+{
+  { 213454002618221, 939771523987438, 1159882208056014, 317388369627517, 621213314200687 },
+  { 1971678598905747, 338026507889165, 762398079972271, 655096486107477, 42299032696322 },
+  { 177130678690680, 1754759263300204, 1864311296286618, 1180675631479880, 1292726903152791 }
+},
+{
+  { 1913163449625248, 460779200291993, 2193883288642314, 1008900146920800, 1721983679009502 },
+  { 1070401523076875, 1272492007800961, 1910153608563310, 2075579521696771, 1191169788841221 },
+  { 692896803108118, 500174642072499, 2068223309439677, 1162190621851337, 1426986007309901 }
+},
+{
+  { 1819621230288257, 483900552507992, 1755134670739587, 828848385765943, 1921008182090629 },
+  { 992069868904071, 799011518185730, 1777586403832768, 1134820506145684, 1999461475558530 },
+  { 425204543703124, 2040469794090382, 1651690622153809, 1500530168597569, 1253908377065966 }
+},
+{
+  { 2105824306960939, 1387520302709358, 1381376766765768, 2211816663841754, 1629085891776489 },
+  { 1485201376284999, 1022406647424656, 504181009209019, 962621520820995, 590876713147230 },
+  { 265873406365287, 1192742653492898, 88553098803050, 525037770869640, 1266933811251234 }
+},
+{
+  { 1300516846141383, 1254279525791876, 1609927932077699, 1326854257994724, 1498881482384646 },
+  { 37186803519861, 1404297334376301, 578519728836650, 1740727951192592, 2095534282477028 },
+  { 833234263154399, 2023862470013762, 1854137933982069, 853924318090959, 1589812702805850 }
+},
+{
+  { 1427350744272515, 1319179453661746, 497496853611112, 413664473257103, 1208137952365561 },
+  { 1654513078530905, 907489875842908, 126098711296368, 1726320004173677, 28269495058173 },
+  { 114436686957443, 532739313025996, 115428841215897, 2191499400074366, 370280402676434 }
+},
+{
+  { 1111146849833272, 2016430049079759, 1860522747477948, 1285364924604946, 1885343011158937 },
+  { 429069864577128, 975327637149449, 237881983565075, 1654761232378630, 2122527599091807 },
+  { 2093793463548278, 754827233241879, 1420389751719629, 1829952782588138, 2011865756773717 }
+},
+{
+  { 676293365438898, 598496204201096, 1205350322490196, 511899578580421, 2133931188538143 },
+  { 48340340349120, 1299261101494832, 1137329686775218, 1534848106674340, 1351662218216799 },
+  { 1904520614137939, 1590301001714014, 215781420985270, 2043534301034629, 1970888949300424 }
+},
+{
+  { 113418148724481, 2061307169694065, 1887478590157603, 2169639621284316, 122011053791952 },
+  { 1020052624656948, 1260412094216707, 366721640607121, 585331442306596, 345876457758061 },
+  { 975390299880933, 1066555195234642, 12651997758352, 1184252205433068, 1058378155074223 }
+},
+{
+  { 1431537716602643, 2024827957433813, 1494634704715247, 1087794891033551, 2156817571680455 },
+  { 929288033346881, 255179964546973, 711057989588035, 208899572612840, 185348357387383 },
+  { 823689746424808, 47266130989546, 209403309368097, 1100966895202707, 710792075292719 }
+},
+{
+  { 59413304138533, 1044868727237071, 2004276520649824, 1861500579441125, 896229219674585 },
+  { 1563693677475261, 1843782073741194, 1950700654453170, 911540858113949, 2085151496302359 },
+  { 1427880892005482, 106216431121745, 42608394782284, 1217295886989793, 1514235272796882 }
+},
+{
+  { 1292535722061521, 116194677662209, 315461642817365, 1854058085060972, 11745749775828 },
+  { 787426011300053, 2105981035769060, 1130476291127206, 1748659348100075, 53470983013756 },
+  { 553548273865386, 5927805718390, 65184587381926, 633576679686953, 576048559439973 }
+},
+{
+  { 993787326657446, 1617007347924010, 1615796046728944, 262844478996705, 2059021068660908 },
+  { 251010270518880, 1681684095763484, 1521949356387564, 431593457045116, 1855308922422910 },
+  { 618490909691959, 1257497595618257, 202952467594088, 35577762721238, 1494883566841973 }
+},
+{
+  { 1673474571932281, 157984706085365, 384295502575240, 509312770916678, 1081913474464629 },
+  { 1600640202645197, 1019569075331823, 1041916487915822, 1680448171313267, 2126903137527901 },
+  { 894964745143659, 106116880092678, 1009869382959477, 317866368542032, 1986983122763912 }
+},
+{
+  { 1765281781276487, 611447373769936, 337275658753815, 1386435905543055, 2182338478845320 },
+  { 1144730936996693, 2213315231278180, 1489676672185125, 665039429138074, 1131283313040268 },
+  { 2004734176670602, 1738311085075235, 418866995976618, 1050782508034394, 577747313404652 }
+},
+{
+  { 2185209688340312, 1309276076461009, 262940224886030, 1743090090327752, 766299012545774 },
+  { 1405936970888515, 1754621155316654, 1211862168554999, 1813045702919083, 997853418197172 },
+  { 82037622045021, 1646398333621944, 613095452763466, 1312329542583705, 81014679202721 }
+},
+{
+  { 137488177592625, 403851022333258, 1597473361477193, 701551788823964, 2135174663049063 },
+  { 1826548187201150, 302299893734126, 1475477168615781, 842617616347376, 1438600873676130 },
+  { 663049852468609, 1649295727846569, 1048009692742781, 628866177992421, 1914360327429204 }
+},
+{
+  { 1795645928096646, 306878154408959, 673101505407146, 549461527969552, 1653782432983524 },
+  { 2077597317438627, 212642017882064, 674844477518888, 875487498687554, 2060550250171182 },
+  { 1420448018683809, 1032663994771382, 1341927003385267, 1340360916546159, 1988547473895228 }
+},
+{
+  { 1082660122598863, 293255891898541, 1637119865903760, 1670283344995812, 1151439321109370 },
+  { 90430593339788, 1838338032241275, 571293238480915, 1639938867416883, 257378872001111 },
+  { 1528535658865034, 1516636853043960, 787000569996728, 1464531394704506, 1684822625133795 }
+},
+{
+  { 811329918113934, 531663715322130, 1769095754634836, 719019808181618, 881037178164326 },
+  { 1784566501964517, 433890943689325, 1186055625589419, 1496077405487512, 1731807117886548 },
+  { 424909811816304, 1355993963741797, 409606483251841, 455665350637068, 1617009023642808 }
+},
+{
+  { 226928678392568, 528489234970254, 76887363788522, 1855541519896785, 1316147724308251 },
+  { 1617420574301156, 1741273341070467, 667135503486508, 2100436564640123, 1032223920000865 },
+  { 1753947659404033, 247279202390193, 1819288880178945, 737334285670249, 1037873664856104 }
+},
+{
+  { 1762568490530053, 673742465299012, 2054571050635888, 2040165159255111, 788323919642009 },
+  { 1627187989987422, 1686331580821752, 1309895873498183, 719718719104086, 300063199808722 },
+  { 238176707016164, 1440454788877048, 203336037573144, 1437789888677072, 101522256664211 }
+},
+{
+  { 1895216760098480, 1934324337975022, 1425550875287919, 284616151770929, 714678003308641 },
+  { 508185358728815, 1691320535341855, 2168887448239256, 1035124393070661, 1936603999698584 },
+  { 390562831571647, 1390223890708972, 1383183990676371, 435998174196410, 1882086414390730 }
+},
+{
+  { 1495821028927692, 2081794785291196, 1032794242577497, 2090090346797896, 329893165250561 },
+  { 244144781251265, 1290834426417077, 1888701171101942, 1233922456644870, 241117402207491 },
+  { 1266169390045455, 1148042013187970, 878921907853942, 1815738019658093, 908920199341621 }
+},
+{
+  { 269968693619889, 953557056811113, 2015863732865770, 1358382511861315, 583621834214744 },
+  { 2239837206240498, 330928973149665, 422268062913642, 1481280019493032, 619879520439841 },
+  { 1360166735366017, 1770556573948510, 1395061284191031, 1814003148068126, 522781147076884 }
+},
+{
+  { 359994988960438, 707234844948071, 1314059396506491, 667450528018686, 2161831667832786 },
+  { 934831784182383, 433734253968318, 1660867106725771, 1968393082772831, 873946300968490 },
+  { 26306827827554, 430884999378685, 1504310424376419, 1761358720837522, 542195685418530 }
+},
+{
+  { 1762131062631725, 872152820732287, 1368118577152290, 658191063662047, 1411594230004386 },
+  { 538272372224622, 1425714779586199, 588313661410172, 1497062084392578, 1602174047128512 },
+  { 907490361939255, 1963620338391363, 626927432296975, 1250748516081414, 959901171882527 }
+},
+{
+  { 1335066153744413, 636004847094409, 401274042268791, 513427167982175, 938831784476764 },
+  { 296699434737224, 2047543711075683, 2076451038937139, 227783599906901, 1602062110967627 },
+  { 1574834773194203, 1384279952062839, 393652417255803, 2166968242848859, 1552890441390820 }
+},
+{
+  { 1619646774410966, 1576090644023562, 783428577635717, 1735328519940544, 103524722251818 },
+  { 1024074573633446, 957088456885874, 1690425531356997, 2102187380180052, 1082544623222033 },
+  { 1871906170635853, 1719383891167200, 1584032250247862, 823764804192117, 2244048510084261 }
+},
+{
+  { 642147846489775, 1082505163460451, 305205716788148, 337376813044285, 2224680511484175 },
+  { 1734162377166545, 260713621840346, 157174591942595, 952544272517991, 222818702471733 },
+  { 1213115494182947, 286778704335711, 2130189536016490, 308349182281342, 1217623948685491 }
+},
+{
+  { 1108252453288387, 1843486583624092, 1561693837124349, 1084041964025479, 1866270922024009 },
+  { 460705465481210, 1968151453817859, 497005926994844, 625618055866751, 2176893440866887 },
+  { 1655800250476757, 2036588542300609, 666447448675243, 1615721995750683, 1508669225186765 }
+},
+{
+  { 2245948203759141, 1058306669699396, 1452898014240582, 1709224328277520, 1633235287338609 },
+  { 986647273684279, 1507266907811370, 1260572633649005, 2071672342077446, 695976026010857 },
+  { 1312356620823495, 1635278548098567, 901946076841033, 585120475533168, 1240667113237384 }
+},
+{
+  { 61924122094447, 1506054666773896, 996040223525031, 636592914999692, 1497801917020297 },
+  { 292042016419794, 1158932298133044, 2062611870323738, 1946058478962569, 1749165808126286 },
+  { 654683942212830, 1526897351349087, 2006818439922838, 2194919327350361, 1451960776874416 }
+},
+{
+  { 763241204123676, 700023328088562, 333065854568428, 256392219313316, 330337886356772 },
+  { 1628123495344283, 2072923641214546, 1647225812023982, 855655925244679, 1758126430071140 },
+  { 1615895096489599, 275295258643784, 937665541219916, 1313496726746346, 1186468946422626 }
+},
+{
+  { 1603070202850694, 2072127623773242, 1692648737212158, 241573590502604, 1248948672117106 },
+  { 11167836031898, 596565174397990, 2196351068723859, 314744641791907, 1102014997250781 },
+  { 1409047922401191, 69960384467966, 688103515547600, 1309746102488044, 150292892873778 }
+},
+{
+  { 1986083055103168, 691715819340300, 1361811659746933, 1207252216648186, 1063594696046062 },
+  { 1201987338414749, 2198784582460616, 1203335513981498, 489243077045066, 2205278143582433 },
+  { 2034744376624534, 2077387101466387, 148448542974969, 1502697574577258, 473186584705655 }
+},
+{
+  { 472016956315979, 720786972252993, 588833847504795, 898998939672580, 564763521813906 },
+  { 253464247569755, 168314237403057, 511780806170295, 1058862316549135, 1646858476817137 },
+  { 595092995922219, 1491311840717691, 291581784452778, 1569186646367854, 1031385061400544 }
+},
+{
+  { 1231337207887507, 1526955102024323, 526206829019210, 457549634924206, 1097420237736736 },
+  { 1246991699537710, 81367319519439, 530844036072196, 163656863755855, 1950742455979290 },
+  { 191532664076407, 539378506082089, 1021612562876554, 1026603384732632, 1773368780410653 }
+},
+{
+  { 1892820917702650, 590179521333343, 1782223504330860, 3945216650179, 447947038016003 },
+  { 2206599697359952, 553895797384417, 181689161933786, 1153123447919104, 778568064152659 },
+  { 1706307000059211, 1885601289314487, 889758608505788, 550131729999853, 1006862664714268 }
+},
+{
+  { 958397940599829, 2048500453422631, 1151510014202959, 927154428508964, 1948013985186771 },
+  { 992058915374933, 476120535358775, 1973648780784340, 2025282643598818, 2182318983793230 },
+  { 1343440812005821, 1316045839091795, 1884951299078063, 1765919609219175, 2197567554627988 }
+},
+{
+  { 877447965697570, 2163227155369027, 1900265885969644, 1528796215447059, 2172730393748688 },
+  { 1773355092297603, 64654329538271, 1332124041660957, 748492100858001, 895500006200535 },
+  { 2000840647851980, 546565968824914, 420633283457524, 195470736374507, 1958689297569520 }
+},
+{
+  { 743138980705465, 1159317690951919, 339590146005374, 128242252891955, 770468126429867 },
+  { 165947002229363, 115186103724967, 1068573292121517, 1842565776920938, 1969395681111987 },
+  { 553322266190633, 234265665613185, 484544650202821, 1238773526575826, 2017991917953668 }
+},
+{
+  { 330154817828803, 1245093644265358, 1285216860140126, 1834216551713858, 923978372152807 },
+  { 1855378315339552, 890045579230758, 1764718173975590, 197904186055854, 1718129022310327 },
+  { 1278162928734862, 1894118254109862, 987503995465517, 177406744098996, 781538103127693 }
+},
+{
+  { 1996603431230234, 1191888797552937, 1207440075928499, 514053635365889, 273515147658041 },
+  { 808903879370889, 990820108751280, 1084429472258867, 1078562781312589, 254514692695625 },
+  { 615855140068469, 586046731175395, 693470779212674, 1964537100203868, 1350330550265229 }
+},
+{
+  { 1092744558338460, 720386671449875, 229041547016862, 2036034126860287, 2015744690201389 },
+  { 1337446193390478, 1984110761311871, 746489405020285, 407347127604128, 1740475330360596 },
+  { 140840424783613, 1063284623568331, 1136446106453878, 372042229029799, 442607248430694 }
+},
+{
+  { 78981865435689, 376801425148231, 2032603686676107, 1488926293635130, 1317278311532959 },
+  { 1290116731380016, 2166899563471713, 831997001838078, 870954980505220, 2108537278055823 },
+  { 1912719171026343, 846194720551034, 2043988124740726, 993234269653961, 421229796383281 }
+},
+{
+  { 399384771307654, 523902743953716, 287986196094325, 324175066330058, 2122619079836733 },
+  { 1154054290132562, 931753998725577, 1647742001778052, 865765466488226, 1083816107290025 },
+  { 986341121095108, 1522330369638573, 1990880546211047, 501525962272123, 198539304862139 }
+},
+{
+  { 1496414019192706, 1739234622488703, 1128511845376949, 602947671673911, 1095158222957905 },
+  { 805612068303425, 1891790027761335, 1587008567571549, 722120737390201, 378156757163816 },
+  { 1588994517921951, 977362751042302, 1329302387067714, 2069348224564088, 1586007159625211 }
+},
+{
+  { 238739607866453, 1985699850375016, 79962503442924, 1893297580091431, 269249646505427 },
+  { 615817553313996, 2245962768078178, 482564324326173, 2101336843140780, 1240914880829407 },
+  { 1438242482238189, 874267817785463, 1620810389770625, 866155221338671, 1040426546798301 }
+},
+{
+  { 151283810425071, 296761596117728, 240899322850664, 106489705771292, 952164506677901 },
+  { 1913986535403097, 1977163223054199, 1972905914623196, 1650122133472502, 1905849310819035 },
+  { 858174816360838, 614595356564037, 1099584959044836, 636998087084906, 1070393269058348 }
+},
+{
+  { 1414896111145439, 1333840849052254, 121194714998989, 376766163603748, 1231012969784447 },
+  { 1994161359147952, 2198039369802658, 62790022842537, 1522306785848169, 951223194802833 },
+  { 852296621440717, 431889737774209, 370755457746189, 437604073958073, 627857326892757 }
+},
+{
+  { 1794955764684175, 335104476328364, 1322647643615888, 856117964085888, 400632964977905 },
+  { 933592377399646, 78031722952813, 926049890685253, 1471649501316246, 33789909190376 },
+  { 1479319468832059, 203906207621608, 659828362330083, 44358398435755, 1273573524210803 }
+},
+{
+  { 1592342143350832, 975419394562465, 93440538393518, 325950296247682, 681713027511996 },
+  { 2184946892642995, 1517382324576002, 1557940277419806, 2170635134813213, 747314658627002 },
+  { 1823193620577742, 1135817878516419, 1731253819308581, 1031652967267804, 2123506616999453 }
+},
+{
+  { 1346190246005824, 2052692552023851, 1718128041785940, 239757519293226, 1222571066703058 },
+  { 424776012994573, 281050757243423, 626466040846420, 990194703866532, 38571969885982 },
+  { 192408346595466, 1054889725292349, 584097975693004, 1447909807397749, 2134645004369136 }
+},
+{
+  { 918095974929815, 1251297929496199, 601598510029976, 1422812237223371, 2121009661378329 },
+  { 1603348391996783, 2066143816131699, 1789627290363958, 2145705961178118, 1985578641438222 },
+  { 352633958653380, 856927627345554, 793925083122702, 93551575767286, 1222010153634215 }
+},
+{
+  { 1756866499986349, 911731956999969, 455705729528827, 1755120521578539, 822501008147911 },
+  { 1094036422864347, 1897208881572508, 1503607738246960, 1901060196071406, 294068411105729 },
+  { 587776484399576, 1116861711228807, 343398777436088, 936544065763093, 1643746750211060 }
+},
+{
+  { 1225949872105181, 267997399528837, 701981108319156, 1000569110395660, 1535993073663134 },
+  { 2042368155872443, 41662387210459, 1676313264498480, 1333968523426810, 1765708383352310 },
+  { 1453394896690938, 1585795827439909, 1469309456804303, 1294645324464404, 2042954198665899 }
+},
+{
+  { 1810069207599900, 1358344669503239, 1989371257548167, 64470237435977, 767875637591260 },
+  { 1866114438287676, 1663420339568364, 1437691317033088, 538298302628038, 1212711449614363 },
+  { 1769235035677897, 1562012115317882, 31277513664750, 536198657928416, 1976134212537183 }
+}
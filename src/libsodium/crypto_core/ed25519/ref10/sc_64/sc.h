@@ -0,0 +1,286 @@
+#include "private/quirks.h"
+
+/*
+ Scalars modulo l = 2^252 + c, c = 27742317777372353535851937790883648493,
+ as 64-bit limbs.
+ Reductions use 2^252 = -c (mod l): x = x_lo + 2^252 x_hi is replaced with
+ x_lo + k l - x_hi c, where k l is a constant larger than x_hi c. Since c
+ only has two limbs, this is much cheaper than a generic reduction.
+ */
+
+#define SC25519_MASK60 0x0fffffffffffffffULL
+
+static const uint64_t sc25519_l[4] = {
+    0x5812631a5cf5d3edULL, 0x14def9dea2f79cd6ULL,
+    0x0000000000000000ULL, 0x1000000000000000ULL
+};
+
+/* 2^134 l */
+static const uint64_t sc25519_l_2_134[7] = {
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0498c6973d74fb40ULL,
+    0x37be77a8bde73596ULL, 0x0000000000000005ULL, 0x0000000000000000ULL,
+    0x0000000000000004ULL
+};
+
+/* 2^9 l */
+static const uint64_t sc25519_l_2_9[5] = {
+    0x24c634b9eba7da00ULL, 0xbdf3bd45ef39acb0ULL, 0x0000000000000029ULL,
+    0x0000000000000000ULL, 0x0000000000000020ULL
+};
+
+static inline void
+sc25519_load(uint64_t x[4], const unsigned char s[32])
+{
+    x[0] = LOAD64_LE(s);
+    x[1] = LOAD64_LE(s + 8);
+    x[2] = LOAD64_LE(s + 16);
+    x[3] = LOAD64_LE(s + 24);
+}
+
+static inline void
+sc25519_store(unsigned char s[32], const uint64_t x[4])
+{
+    STORE64_LE(s, x[0]);
+    STORE64_LE(s + 8, x[1]);
+    STORE64_LE(s + 16, x[2]);
+    STORE64_LE(s + 24, x[3]);
+}
+
+/* (c, r) = a + b + c */
+#define SC25519_ADC(R, A, B, C)                                    \
+    do {                                                           \
+        uint128_t t_ = (uint128_t) (A) + (B) + (C);                \
+        (R) = (uint64_t) t_;                                       \
+        (C) = (uint64_t) (t_ >> 64);                               \
+    } while (0)
+
+/* (b, r) = a - s - b */
+#define SC25519_SBB(R, A, S, B)                                    \
+    do {                                                           \
+        uint128_t t_ = (uint128_t) (A) - (S) - (B);                \
+        (R) = (uint64_t) t_;                                       \
+        (B) = (uint64_t) (t_ >> 64) & 1;                           \
+    } while (0)
+
+/* (hi, r) = a * c + (hi, lo) */
+#define SC25519_MULC(R, A, LO, HI)                                 \
+    do {                                                           \
+        uint128_t t0_ = (uint128_t) (A) * sc25519_l[0] + (LO);     \
+        uint128_t t1_ = (uint128_t) (A) * sc25519_l[1] +           \
+                        (uint64_t) (t0_ >> 64) + (HI);             \
+        (R)  = (uint64_t) t0_;                                     \
+        (LO) = (uint64_t) t1_;                                     \
+        (HI) = (uint64_t) (t1_ >> 64);                             \
+    } while (0)
+
+/*
+ Input:
+ x[0]+2^64*x[1]+...+2^448*x[7] = x
+ *
+ Output:
+ r[0]+2^64*r[1]+2^128*r[2]+2^192*r[3] = x mod l
+ */
+
+static void
+sc25519_reduce_limbs(uint64_t r[4], const uint64_t x[8])
+{
+    uint64_t h0, h1, h2, h3, h4;
+    uint64_t p0, p1, p2, p3, p4, p5, p6;
+    uint64_t y0, y1, y2, y3, y4, y5, y6;
+    uint64_t z0, z1, z2, z3, z4;
+    uint64_t t0, t1, t2, t3;
+    uint64_t lo, hi;
+    uint64_t carry, borrow;
+    uint64_t mask;
+
+    /* x < 2^512, x_hi c < 2^385 < 2^134 l, y < 2^387 */
+    h0 = (x[3] >> 60) | (x[4] << 4);
+    h1 = (x[4] >> 60) | (x[5] << 4);
+    h2 = (x[5] >> 60) | (x[6] << 4);
+    h3 = (x[6] >> 60) | (x[7] << 4);
+    h4 = x[7] >> 60;
+    lo = hi = 0;
+    SC25519_MULC(p0, h0, lo, hi);
+    SC25519_MULC(p1, h1, lo, hi);
+    SC25519_MULC(p2, h2, lo, hi);
+    SC25519_MULC(p3, h3, lo, hi);
+    SC25519_MULC(p4, h4, lo, hi);
+    p5 = lo;
+    p6 = hi;
+
+    carry = 0;
+    SC25519_ADC(y2, x[2], sc25519_l_2_134[2], carry);
+    SC25519_ADC(y3, x[3] & SC25519_MASK60, sc25519_l_2_134[3], carry);
+    y4 = sc25519_l_2_134[4] + carry;
+    borrow = 0;
+    SC25519_SBB(y0, x[0], p0, borrow);
+    SC25519_SBB(y1, x[1], p1, borrow);
+    SC25519_SBB(y2, y2, p2, borrow);
+    SC25519_SBB(y3, y3, p3, borrow);
+    SC25519_SBB(y4, y4, p4, borrow);
+    SC25519_SBB(y5, 0, p5, borrow);
+    SC25519_SBB(y6, sc25519_l_2_134[6], p6, borrow);
+
+    /* y_hi c < 2^260 < 2^9 l, z < 2^262 */
+    h0 = (y3 >> 60) | (y4 << 4);
+    h1 = (y4 >> 60) | (y5 << 4);
+    h2 = (y5 >> 60) | (y6 << 4);
+    lo = hi = 0;
+    SC25519_MULC(p0, h0, lo, hi);
+    SC25519_MULC(p1, h1, lo, hi);
+    SC25519_MULC(p2, h2, lo, hi);
+    p3 = lo;
+    p4 = hi;
+
+    carry = 0;
+    SC25519_ADC(z0, y0, sc25519_l_2_9[0], carry);
+    SC25519_ADC(z1, y1, sc25519_l_2_9[1], carry);
+    SC25519_ADC(z2, y2, sc25519_l_2_9[2], carry);
+    SC25519_ADC(z3, y3 & SC25519_MASK60, 0, carry);
+    z4 = sc25519_l_2_9[4] + carry;
+    borrow = 0;
+    SC25519_SBB(z0, z0, p0, borrow);
+    SC25519_SBB(z1, z1, p1, borrow);
+    SC25519_SBB(z2, z2, p2, borrow);
+    SC25519_SBB(z3, z3, p3, borrow);
+    SC25519_SBB(z4, z4, p4, borrow);
+
+    /* z_hi c < 2^135 < l, r < 2l */
+    h0 = (z3 >> 60) | (z4 << 4);
+    lo = hi = 0;
+    SC25519_MULC(p0, h0, lo, hi);
+    p1 = lo;
+    p2 = hi;
+
+    carry = 0;
+    SC25519_ADC(z0, z0, sc25519_l[0], carry);
+    SC25519_ADC(z1, z1, sc25519_l[1], carry);
+    SC25519_ADC(z2, z2, 0, carry);
+    z3 = (z3 & SC25519_MASK60) + sc25519_l[3] + carry;
+    borrow = 0;
+    SC25519_SBB(z0, z0, p0, borrow);
+    SC25519_SBB(z1, z1, p1, borrow);
+    SC25519_SBB(z2, z2, p2, borrow);
+    SC25519_SBB(z3, z3, 0, borrow);
+
+    borrow = 0;
+    SC25519_SBB(t0, z0, sc25519_l[0], borrow);
+    SC25519_SBB(t1, z1, sc25519_l[1], borrow);
+    SC25519_SBB(t2, z2, 0, borrow);
+    SC25519_SBB(t3, z3, sc25519_l[3], borrow);
+    mask = borrow - 1; /* all ones if z >= l */
+    r[0] = z0 ^ (mask & (z0 ^ t0));
+    r[1] = z1 ^ (mask & (z1 ^ t1));
+    r[2] = z2 ^ (mask & (z2 ^ t2));
+    r[3] = z3 ^ (mask & (z3 ^ t3));
+}
+
+/* x = a * b */
+static inline void
+sc25519_mul_limbs(uint64_t x[8], const uint64_t a[4], const uint64_t b[4])
+{
+    uint128_t t;
+    uint64_t  carry;
+    int       i;
+    int       j;
+
+    for (i = 0; i < 8; i++) {
+        x[i] = 0;
+    }
+    for (i = 0; i < 4; i++) {
+        carry = 0;
+        for (j = 0; j < 4; j++) {
+            t = (uint128_t) a[i] * b[j] + x[i + j] + carry;
+            x[i + j] = (uint64_t) t;
+            carry = (uint64_t) (t >> 64);
+        }
+        x[i + 4] = carry;
+    }
+}
+
+/*
+ Input:
+ a[0]+256*a[1]+...+256^31*a[31] = a
+ b[0]+256*b[1]+...+256^31*b[31] = b
+ *
+ Output:
+ s[0]+256*s[1]+...+256^31*s[31] = (ab) mod l
+ where l = 2^252 + 27742317777372353535851937790883648493.
+ */
+
+void
+sc25519_mul(unsigned char s[32], const unsigned char a[32], const unsigned char b[32])
+{
+    uint64_t al[4];
+    uint64_t bl[4];
+    uint64_t x[8];
+    uint64_t r[4];
+
+    sc25519_load(al, a);
+    sc25519_load(bl, b);
+    sc25519_mul_limbs(x, al, bl);
+    sc25519_reduce_limbs(r, x);
+    sc25519_store(s, r);
+}
+
+/*
+ Input:
+ a[0]+256*a[1]+...+256^31*a[31] = a
+ b[0]+256*b[1]+...+256^31*b[31] = b
+ c[0]+256*c[1]+...+256^31*c[31] = c
+ *
+ Output:
+ s[0]+256*s[1]+...+256^31*s[31] = (ab+c) mod l
+ where l = 2^252 + 27742317777372353535851937790883648493.
+ */
+
+void
+sc25519_muladd(unsigned char s[32], const unsigned char a[32],
+               const unsigned char b[32], const unsigned char c[32])
+{
+    uint64_t  al[4];
+    uint64_t  bl[4];
+    uint64_t  cl[4];
+    uint64_t  x[8];
+    uint64_t  r[4];
+    uint64_t  carry = 0;
+    uint128_t t;
+    int       i;
+
+    sc25519_load(al, a);
+    sc25519_load(bl, b);
+    sc25519_load(cl, c);
+    sc25519_mul_limbs(x, al, bl);
+    /* ab + c <= (2^256 - 1)^2 + 2^256 - 1 < 2^512 */
+    for (i = 0; i < 8; i++) {
+        t = (uint128_t) x[i] + (i < 4 ? cl[i] : 0) + carry;
+        x[i] = (uint64_t) t;
+        carry = (uint64_t) (t >> 64);
+    }
+    sc25519_reduce_limbs(r, x);
+    sc25519_store(s, r);
+}
+
+/*
+ Input:
+ s[0]+256*s[1]+...+256^63*s[63] = s
+ *
+ Output:
+ s[0]+256*s[1]+...+256^31*s[31] = s mod l
+ where l = 2^252 + 27742317777372353535851937790883648493.
+ Overwrites s in place.
+ */
+
+void
+sc25519_reduce(unsigned char s[64])
+{
+    uint64_t x[8];
+    uint64_t r[4];
+    int      i;
+
+    for (i = 0; i < 8; i++) {
+        x[i] = LOAD64_LE(s + 8 * i);
+    }
+    sc25519_reduce_limbs(r, x);
+    sc25519_store(s, r);
+}
@@ -0,0 +1,502 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aegis256.h"
+#include "crypto_aead_xchacha20poly1305.h"
+#include "crypto_file.h"
+#include "crypto_generichash.h"
+#include "crypto_kdf.h"
+#include "crypto_verify_32.h"
+#include "private/common.h"
+#include "private/executor.h"
+#include "randombytes.h"
+#include "utils.h"
+
+/*
+ * Header: version (1) || algorithm (1) || 0 (2) || chunk_bytes (4, LE)
+ *         || file nonce (16) || MAC (32)
+ *
+ * The MAC and the chunks use different subkeys of the file key. Chunk i
+ * is encrypted with the nonce file_nonce || LE64(i) (zero-padded to the
+ * nonce size of the AEAD), and MAC || final as additional data.
+ */
+
+#define FILE_VERSION               1U
+#define FILE_NONCEBYTES            16U
+#define FILE_MACBYTES              32U
+#define FILE_AUTHENTICATEDBYTES    (crypto_file_HEADERBYTES - FILE_MACBYTES)
+#define FILE_ADBYTES               (FILE_MACBYTES + 1U)
+#define FILE_PARALLEL_BYTES_MIN    (1U << 20)
+#define FILE_PARALLEL_THREADS_MAX  64U
+
+static const char FILE_KDF_CONTEXT[crypto_kdf_CONTEXTBYTES] = "filechnk";
+
+typedef struct file_state {
+    unsigned char k[crypto_file_KEYBYTES];
+    unsigned char mac[FILE_MACBYTES];
+    unsigned char nonce[FILE_NONCEBYTES];
+    uint32_t      chunk_bytes;
+    uint8_t       algorithm;
+} file_state;
+
+size_t
+crypto_file_keybytes(void)
+{
+    return crypto_file_KEYBYTES;
+}
+
+size_t
+crypto_file_headerbytes(void)
+{
+    return crypto_file_HEADERBYTES;
+}
+
+size_t
+crypto_file_abytes(void)
+{
+    return crypto_file_ABYTES;
+}
+
+size_t
+crypto_file_chunkbytes_min(void)
+{
+    return crypto_file_CHUNKBYTES_MIN;
+}
+
+size_t
+crypto_file_chunkbytes_max(void)
+{
+    return crypto_file_CHUNKBYTES_MAX;
+}
+
+size_t
+crypto_file_chunkbytes(void)
+{
+    return crypto_file_CHUNKBYTES;
+}
+
+size_t
+crypto_file_statebytes(void)
+{
+    return sizeof(crypto_file_state);
+}
+
+void
+crypto_file_keygen(unsigned char k[crypto_file_KEYBYTES])
+{
+    randombytes_buf(k, crypto_file_KEYBYTES);
+}
+
+static int
+file_init(file_state *st, const unsigned char header[crypto_file_HEADERBYTES],
+          const unsigned char k[crypto_file_KEYBYTES], unsigned char *mac)
+{
+    unsigned char mac_key[crypto_generichash_KEYBYTES];
+
+    COMPILER_ASSERT(sizeof(file_state) <= sizeof(crypto_file_state));
+    COMPILER_ASSERT(crypto_aead_xchacha20poly1305_ietf_ABYTES ==
+                    crypto_file_ABYTES);
+    COMPILER_ASSERT(crypto_aead_aegis256_ABYTES == crypto_file_ABYTES);
+
+    if (header[0] != FILE_VERSION || header[2] != 0U || header[3] != 0U ||
+        (header[1] != crypto_file_ALG_XCHACHA20POLY1305 &&
+         header[1] != crypto_file_ALG_AEGIS256)) {
+        return -1;
+    }
+    st->algorithm   = header[1];
+    st->chunk_bytes = LOAD32_LE(header + 4);
+    if (st->chunk_bytes < crypto_file_CHUNKBYTES_MIN ||
+        st->chunk_bytes > crypto_file_CHUNKBYTES_MAX) {
+        return -1;
+    }
+    memcpy(st->nonce, header + 8, FILE_NONCEBYTES);
+    crypto_kdf_derive_from_key(mac_key, sizeof mac_key, 0U, FILE_KDF_CONTEXT, k);
+    crypto_kdf_derive_from_key(st->k, sizeof st->k, 1U, FILE_KDF_CONTEXT, k);
+    crypto_generichash(mac, FILE_MACBYTES, header, FILE_AUTHENTICATEDBYTES,
+                       mac_key, sizeof mac_key);
+    memcpy(st->mac, mac, FILE_MACBYTES);
+    sodium_memzero(mac_key, sizeof mac_key);
+
+    return 0;
+}
+
+int
+crypto_file_init_push(crypto_file_state *state,
+                      unsigned char header[crypto_file_HEADERBYTES],
+                      const unsigned char k[crypto_file_KEYBYTES],
+                      unsigned int algorithm, size_t chunk_bytes)
+{
+    file_state *st = (file_state *) (void *) state;
+
+    if (chunk_bytes < crypto_file_CHUNKBYTES_MIN ||
+        chunk_bytes > crypto_file_CHUNKBYTES_MAX ||
+        (algorithm != crypto_file_ALG_XCHACHA20POLY1305 &&
+         algorithm != crypto_file_ALG_AEGIS256)) {
+        errno = EINVAL;
+        return -1;
+    }
+    memset(header, 0, crypto_file_HEADERBYTES);
+    header[0] = FILE_VERSION;
+    header[1] = (unsigned char) algorithm;
+    STORE32_LE(header + 4, (uint32_t) chunk_bytes);
+    randombytes_buf(header + 8, FILE_NONCEBYTES);
+    if (file_init(st, header, k, header + FILE_AUTHENTICATEDBYTES) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    return 0;
+}
+
+int
+crypto_file_init_pull(crypto_file_state *state,
+                      const unsigned char header[crypto_file_HEADERBYTES],
+                      const unsigned char k[crypto_file_KEYBYTES])
+{
+    file_state   *st = (file_state *) (void *) state;
+    unsigned char mac[FILE_MACBYTES];
+
+    if (file_init(st, header, k, mac) != 0 ||
+        crypto_verify_32(mac, header + FILE_AUTHENTICATEDBYTES) != 0) {
+        sodium_memzero(state, sizeof *state);
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+size_t
+crypto_file_state_chunkbytes(const crypto_file_state *state)
+{
+    const file_state *st = (const file_state *) (const void *) state;
+
+    return (size_t) st->chunk_bytes;
+}
+
+unsigned long long
+crypto_file_ciphertext_length(const crypto_file_state *state,
+                              unsigned long long mlen)
+{
+    const file_state  *st = (const file_state *) (const void *) state;
+    unsigned long long chunks;
+
+    chunks = mlen / st->chunk_bytes + (mlen % st->chunk_bytes != 0U);
+    if (chunks == 0U) {
+        chunks = 1U;
+    }
+    return mlen + chunks * crypto_file_ABYTES;
+}
+
+int
+crypto_file_plaintext_length(const crypto_file_state *state,
+                             unsigned long long *mlen_p,
+                             unsigned long long clen)
+{
+    const file_state        *st = (const file_state *) (const void *) state;
+    const unsigned long long chunk_clen =
+        (unsigned long long) st->chunk_bytes + crypto_file_ABYTES;
+    unsigned long long       chunks;
+
+    chunks = clen / chunk_clen + (clen % chunk_clen != 0U);
+    if (chunks == 0U || clen - (chunks - 1U) * chunk_clen < crypto_file_ABYTES) {
+        errno = EINVAL;
+        return -1;
+    }
+    *mlen_p = clen - chunks * crypto_file_ABYTES;
+
+    return 0;
+}
+
+static void
+file_chunk_nonce_ad(const file_state *st, unsigned char *npub,
+                    unsigned char *ad, uint64_t chunk_index, int final)
+{
+    memset(npub, 0, crypto_aead_aegis256_NPUBBYTES);
+    memcpy(npub, st->nonce, FILE_NONCEBYTES);
+    STORE64_LE(npub + FILE_NONCEBYTES, chunk_index);
+    memcpy(ad, st->mac, FILE_MACBYTES);
+    ad[FILE_MACBYTES] = (unsigned char) (final != 0);
+}
+
+int
+crypto_file_encrypt_chunk(const crypto_file_state *state, unsigned char *c,
+                          const unsigned char *m, size_t mlen,
+                          uint64_t chunk_index, int final)
+{
+    const file_state *st = (const file_state *) (const void *) state;
+    unsigned char     npub[crypto_aead_aegis256_NPUBBYTES];
+    unsigned char     ad[FILE_ADBYTES];
+
+    COMPILER_ASSERT(crypto_aead_aegis256_NPUBBYTES >=
+                    crypto_aead_xchacha20poly1305_ietf_NPUBBYTES);
+    if (mlen > st->chunk_bytes || (!final && mlen != st->chunk_bytes)) {
+        errno = EINVAL;
+        return -1;
+    }
+    file_chunk_nonce_ad(st, npub, ad, chunk_index, final);
+    if (st->algorithm == crypto_file_ALG_AEGIS256) {
+        crypto_aead_aegis256_encrypt(c, NULL, m, mlen, ad, sizeof ad, NULL,
+                                     npub, st->k);
+    } else {
+        crypto_aead_xchacha20poly1305_ietf_encrypt(c, NULL, m, mlen, ad,
+                                                   sizeof ad, NULL, npub,
+                                                   st->k);
+    }
+    return 0;
+}
+
+int
+crypto_file_decrypt_chunk(const crypto_file_state *state, unsigned char *m,
+                          const unsigned char *c, size_t clen,
+                          uint64_t chunk_index, int final)
+{
+    const file_state *st = (const file_state *) (const void *) state;
+    unsigned char     npub[crypto_aead_aegis256_NPUBBYTES];
+    unsigned char     ad[FILE_ADBYTES];
+
+    if (clen < crypto_file_ABYTES ||
+        clen - crypto_file_ABYTES > st->chunk_bytes ||
+        (!final && clen - crypto_file_ABYTES != st->chunk_bytes)) {
+        errno = EINVAL;
+        return -1;
+    }
+    file_chunk_nonce_ad(st, npub, ad, chunk_index, final);
+    if (st->algorithm == crypto_file_ALG_AEGIS256) {
+        return crypto_aead_aegis256_decrypt(m, NULL, NULL, c, clen, ad,
+                                            sizeof ad, npub, st->k);
+    }
+    return crypto_aead_xchacha20poly1305_ietf_decrypt(m, NULL, NULL, c, clen,
+                                                      ad, sizeof ad, npub,
+                                                      st->k);
+}
+
+/*
+ * A run of consecutive chunks, starting at chunk first. Only the last chunk
+ * of the file can be shorter than the chunk size.
+ */
+typedef struct file_job {
+    const crypto_file_state *state;
+    unsigned char           *c;
+    unsigned char           *m;
+    uint64_t                 first;
+    uint64_t                 count;
+    uint64_t                 final_index;
+    size_t                   final_len;
+    int                      decrypt;
+    int                      ret;
+} file_job;
+
+static void
+file_job_run(file_job *job)
+{
+    const size_t chunk_bytes = crypto_file_state_chunkbytes(job->state);
+    uint64_t     i;
+    uint64_t     idx;
+    size_t       len;
+    int          final;
+
+    job->ret = 0;
+    for (i = 0U; i < job->count; i++) {
+        idx   = job->first + i;
+        final = idx == job->final_index;
+        len   = final ? job->final_len : chunk_bytes;
+        if (job->decrypt) {
+            job->ret |= crypto_file_decrypt_chunk(
+                job->state, job->m + (size_t) i * chunk_bytes,
+                job->c + (size_t) i * (chunk_bytes + crypto_file_ABYTES),
+                len + crypto_file_ABYTES, idx, final);
+        } else {
+            job->ret |= crypto_file_encrypt_chunk(
+                job->state,
+                job->c + (size_t) i * (chunk_bytes + crypto_file_ABYTES),
+                job->m + (size_t) i * chunk_bytes, len, idx, final);
+        }
+    }
+}
+
+static void
+file_job_task(void *job)
+{
+    file_job_run((file_job *) job);
+}
+
+/*
+ * Splits a run of chunks into one run per thread, with at least
+ * FILE_PARALLEL_BYTES_MIN bytes each. If the executor cannot take a run,
+ * the calling thread processes it.
+ */
+static int
+file_run_parallel(const file_job *run, unsigned int threads)
+{
+    file_job             job[FILE_PARALLEL_THREADS_MAX];
+    sodium_executor_task task[FILE_PARALLEL_THREADS_MAX];
+    const size_t         chunk_bytes = crypto_file_state_chunkbytes(run->state);
+    uint64_t             per_thread;
+    uint64_t             done = 0U;
+    unsigned int         t;
+    int                  ret = 0;
+
+    if (run->count == 0U) {
+        return 0;
+    }
+    if (threads > FILE_PARALLEL_THREADS_MAX) {
+        threads = FILE_PARALLEL_THREADS_MAX;
+    }
+    if ((uint64_t) threads >
+        run->count * chunk_bytes / FILE_PARALLEL_BYTES_MIN) {
+        threads = (unsigned int) (run->count * chunk_bytes /
+                                  FILE_PARALLEL_BYTES_MIN);
+    }
+    threads = _sodium_executor_threads(threads);
+    if ((uint64_t) threads > run->count) {
+        threads = (unsigned int) run->count;
+    }
+    per_thread = (run->count + threads - 1U) / threads;
+    for (t = 0U; t < threads; t++) {
+        job[t]       = *run;
+        job[t].first = run->first + done;
+        job[t].count = run->count - done < per_thread ? run->count - done
+                                                      : per_thread;
+        job[t].c     = run->c + (size_t) done * (chunk_bytes + crypto_file_ABYTES);
+        job[t].m     = run->m + (size_t) done * chunk_bytes;
+        done += job[t].count;
+    }
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_start(&task[t], file_job_task, &job[t]);
+    }
+    file_job_run(&job[0]);
+    ret |= job[0].ret;
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_finish(&task[t]);
+        ret |= job[t].ret;
+    }
+    return ret;
+}
+
+int
+crypto_file_pwrite(const crypto_file_state *state, unsigned char *c,
+                   const unsigned char *m, unsigned long long mlen,
+                   unsigned long long offset, int final, unsigned int threads)
+{
+    const size_t chunk_bytes = crypto_file_state_chunkbytes(state);
+    file_job     run;
+
+    if (offset % chunk_bytes != 0U || (!final && mlen % chunk_bytes != 0U) ||
+        mlen > SIZE_MAX - offset ||
+        crypto_file_ciphertext_length(state, offset + mlen) > SIZE_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen > 0U && m == NULL) {
+        sodium_misuse();
+    }
+    memset(&run, 0, sizeof run);
+    run.state       = state;
+    run.first       = offset / chunk_bytes;
+    run.count       = mlen / chunk_bytes;
+    run.final_index = UINT64_MAX;
+    if (final) {
+        run.final_len = (size_t) (mlen % chunk_bytes);
+        if (run.final_len == 0U && mlen > 0U) {
+            run.final_len = chunk_bytes;
+        } else {
+            run.count++;
+        }
+        run.final_index = run.first + run.count - 1U;
+    }
+    run.c = c + (size_t) run.first * (chunk_bytes + crypto_file_ABYTES);
+    run.m = (unsigned char *) (uintptr_t) m;
+
+    return file_run_parallel(&run, threads);
+}
+
+int
+crypto_file_pread(const crypto_file_state *state, unsigned char *m,
+                  unsigned long long mlen, unsigned long long offset,
+                  const unsigned char *c, unsigned long long clen,
+                  unsigned int threads)
+{
+    const size_t       chunk_bytes = crypto_file_state_chunkbytes(state);
+    const size_t       chunk_clen  = chunk_bytes + crypto_file_ABYTES;
+    file_job           run;
+    unsigned char     *tmp = NULL;
+    unsigned long long total;
+    unsigned long long end;
+    uint64_t           chunks;
+    uint64_t           first;
+    uint64_t           last;
+    uint64_t           idx;
+    size_t             len;
+    size_t             skip;
+    size_t             take;
+    int                ret = 0;
+
+    if (crypto_file_plaintext_length(state, &total, clen) != 0 ||
+        clen > SIZE_MAX || offset > total || mlen > total - offset) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mlen == 0U) {
+        return 0;
+    }
+    end    = offset + mlen;
+    chunks = clen / chunk_clen + (clen % chunk_clen != 0U);
+    first  = offset / chunk_bytes;
+    last   = (end - 1U) / chunk_bytes;
+
+    memset(&run, 0, sizeof run);
+    run.state       = state;
+    run.decrypt     = 1;
+    run.final_index = chunks - 1U;
+    run.final_len   = (size_t) (total - (chunks - 1U) * chunk_bytes);
+
+    /* chunks that are only partially read are decrypted into a copy */
+    for (idx = first; idx <= last; idx++) {
+        len  = idx == run.final_index ? run.final_len : chunk_bytes;
+        skip = idx == first ? (size_t) (offset % chunk_bytes) : 0U;
+        take = len - skip;
+        if (idx == last) {
+            take = (size_t) (end - idx * chunk_bytes) - skip;
+        }
+        if (skip == 0U && take == len && idx != first && idx != last) {
+            continue;
+        }
+        if (skip == 0U && take == len) {
+            ret |= crypto_file_decrypt_chunk(
+                state, m + (size_t) (idx * chunk_bytes - offset),
+                c + (size_t) idx * chunk_clen, len + crypto_file_ABYTES, idx,
+                idx == run.final_index);
+            continue;
+        }
+        if (tmp == NULL && (tmp = (unsigned char *) malloc(chunk_bytes)) == NULL) {
+            sodium_memzero(m, (size_t) mlen); /* LCOV_EXCL_LINE */
+            errno = ENOMEM; /* LCOV_EXCL_LINE */
+            return -1; /* LCOV_EXCL_LINE */
+        }
+        ret |= crypto_file_decrypt_chunk(state, tmp,
+                                         c + (size_t) idx * chunk_clen,
+                                         len + crypto_file_ABYTES, idx,
+                                         idx == run.final_index);
+        memcpy(m + (size_t) (idx * chunk_bytes + skip - offset), tmp + skip,
+               take);
+    }
+    if (tmp != NULL) {
+        sodium_memzero(tmp, chunk_bytes);
+        free(tmp);
+    }
+    if (last > first + 1U) {
+        run.first = first + 1U;
+        run.count = last - first - 1U;
+        run.c     = (unsigned char *) (uintptr_t) (c + (size_t) run.first * chunk_clen);
+        run.m     = m + (size_t) (run.first * chunk_bytes - offset);
+        ret |= file_run_parallel(&run, threads);
+    }
+    if (ret != 0) {
+        sodium_memzero(m, (size_t) mlen);
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
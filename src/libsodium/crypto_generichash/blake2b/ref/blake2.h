@@ -59,6 +59,7 @@ typedef struct blake2b_state {
     uint8_t  buf[2 * 128];
     size_t   buflen;
     uint8_t  last_node;
+    uint8_t  key_compressed;
 } blake2b_state;
 
 #if defined(__IBMC__) || defined(__SUNPRO_C) || defined(__SUNPRO_CC)
@@ -93,11 +94,46 @@ typedef int (*blake2b_compress_fn)(blake2b_state *S,
 int blake2b_pick_best_implementation(void);
 int blake2b_compress_ref(blake2b_state *S,
                          const uint8_t  block[BLAKE2B_BLOCKBYTES]);
+int blake2b_compress_neon(blake2b_state *S,
+                          const uint8_t  block[BLAKE2B_BLOCKBYTES]);
+int blake2b_compress_simd128(blake2b_state *S,
+                             const uint8_t  block[BLAKE2B_BLOCKBYTES]);
+int blake2b_compress_vsx(blake2b_state *S,
+                         const uint8_t  block[BLAKE2B_BLOCKBYTES]);
 int blake2b_compress_ssse3(blake2b_state *S,
                            const uint8_t  block[BLAKE2B_BLOCKBYTES]);
 int blake2b_compress_sse41(blake2b_state *S,
                            const uint8_t  block[BLAKE2B_BLOCKBYTES]);
 int blake2b_compress_avx2(blake2b_state *S,
                           const uint8_t  block[BLAKE2B_BLOCKBYTES]);
+int blake2b_compress_avx512vl(blake2b_state *S,
+                              const uint8_t  block[BLAKE2B_BLOCKBYTES]);
+
+/* Multi-buffer API: one independent message per 64-bit lane */
+#define BLAKE2B_MULTI_LANES_MAX 8
+
+typedef struct blake2b_multi_state {
+    uint64_t h[8][BLAKE2B_MULTI_LANES_MAX];
+    uint64_t m[16][BLAKE2B_MULTI_LANES_MAX];
+    uint64_t t[2][BLAKE2B_MULTI_LANES_MAX];
+    uint64_t f[2][BLAKE2B_MULTI_LANES_MAX];
+} blake2b_multi_state;
+
+int blake2b_multi(uint8_t * const *out, const uint8_t outlen,
+                  const uint8_t * const *in, const unsigned long long *inlen,
+                  size_t count, const void *key, const uint8_t keylen);
+int blake2b_salt_personal_range(uint8_t *out, const uint8_t outlen,
+                                size_t count, const void *key,
+                                const uint8_t keylen, uint64_t first_salt,
+                                const void *personal);
+int blake2b_xof_blocks(uint8_t *out, const uint8_t root[BLAKE2B_OUTBYTES],
+                       const uint32_t xof_length, const uint32_t first_block,
+                       size_t count);
+
+typedef int (*blake2b_compress_multi_fn)(blake2b_multi_state *M);
+int blake2b_compress_lanes(blake2b_multi_state *M, size_t lanes);
+size_t blake2b_compress_lanes_count(void);
+int blake2b_compress_multi_avx2(blake2b_multi_state *M);
+int blake2b_compress_multi_avx512f(blake2b_multi_state *M);
 
 #endif
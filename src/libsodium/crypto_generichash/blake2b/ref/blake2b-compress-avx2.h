@@ -39,10 +39,13 @@ LOADU64(const void *p)
 #define AND(a, b) _mm256_and_si256(a, b)
 #define OR(a, b) _mm256_or_si256(a, b)
 
-#define ROT32(x) _mm256_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
-#define ROT24(x) _mm256_shuffle_epi8((x), ROTATE24)
-#define ROT16(x) _mm256_shuffle_epi8((x), ROTATE16)
-#define ROT63(x) _mm256_or_si256(_mm256_srli_epi64((x), 63), ADD((x), (x)))
+/* the includer can define native rotations instead */
+#ifndef ROT32
+# define ROT32(x) _mm256_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+# define ROT24(x) _mm256_shuffle_epi8((x), ROTATE24)
+# define ROT16(x) _mm256_shuffle_epi8((x), ROTATE16)
+# define ROT63(x) _mm256_or_si256(_mm256_srli_epi64((x), 63), ADD((x), (x)))
+#endif
 
 #define BLAKE2B_G1_V1(a, b, c, d, m) \
     do {                             \
@@ -0,0 +1,49 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# define VEC   __m256i
+
+# define LOADV(p)     _mm256_loadu_si256((const __m256i *) (const void *) (p))
+# define STOREV(p, r) _mm256_storeu_si256((__m256i *) (void *) (p), r)
+# define SET1(x)      _mm256_set1_epi64x((long long) (x))
+# define ADD(a, b)    _mm256_add_epi64(a, b)
+# define XOR(a, b)    _mm256_xor_si256(a, b)
+
+# undef ROTR32
+# define ROTR32(x) _mm256_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+# define ROTR24(x)                                                           \
+    _mm256_shuffle_epi8((x), _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, \
+                                              13, 14, 15, 8, 9, 10, 3, 4, 5, \
+                                              6, 7, 0, 1, 2, 11, 12, 13, 14, \
+                                              15, 8, 9, 10))
+# define ROTR16(x)                                                           \
+    _mm256_shuffle_epi8((x), _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, \
+                                              12, 13, 14, 15, 8, 9, 2, 3, 4, \
+                                              5, 6, 7, 0, 1, 10, 11, 12, 13, \
+                                              14, 15, 8, 9))
+# define ROTR63(x) _mm256_or_si256(_mm256_srli_epi64((x), 63), ADD((x), (x)))
+
+# define FN(name) blake2b_##name##_multi_avx2
+# include "blake2b-compress-multi.h"
+
+#endif
@@ -0,0 +1,43 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+#  pragma GCC target("avx512f")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# define VEC   __m512i
+
+# define LOADV(p)     _mm512_loadu_si512((const void *) (p))
+# define STOREV(p, r) _mm512_storeu_si512((void *) (p), r)
+# define SET1(x)      _mm512_set1_epi64((long long) (x))
+# define ADD(a, b)    _mm512_add_epi64(a, b)
+# define XOR(a, b)    _mm512_xor_si512(a, b)
+
+# undef ROTR32
+# define ROTR32(x) _mm512_ror_epi64((x), 32)
+# define ROTR24(x) _mm512_ror_epi64((x), 24)
+# define ROTR16(x) _mm512_ror_epi64((x), 16)
+# define ROTR63(x) _mm512_ror_epi64((x), 63)
+
+# define FN(name) blake2b_##name##_multi_avx512f
+# include "blake2b-compress-multi.h"
+
+#endif
@@ -0,0 +1,154 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "private/common.h"
+
+#if defined(HAVE_WASM_SIMD128)
+
+# include <wasm_simd128.h>
+
+/*
+ * Each row of the state is held in two 2x64-bit vectors, so that a round
+ * is two vectorized G steps on columns, then two on diagonals.
+ */
+
+static const uint8_t blake2b_sigma[12][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+static const uint64_t blake2b_IV[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+    0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+static inline v128_t
+XOR_ROTR32(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_i32x4_shuffle(x, x, 1, 0, 3, 2);
+}
+
+static inline v128_t
+XOR_ROTR24(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_i8x16_shuffle(x, x, 3, 4, 5, 6, 7, 0, 1, 2,
+                              11, 12, 13, 14, 15, 8, 9, 10);
+}
+
+static inline v128_t
+XOR_ROTR16(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_i8x16_shuffle(x, x, 2, 3, 4, 5, 6, 7, 0, 1,
+                              10, 11, 12, 13, 14, 15, 8, 9);
+}
+
+static inline v128_t
+XOR_ROTR63(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_v128_xor(wasm_i64x2_add(x, x), wasm_u64x2_shr(x, 63));
+}
+
+# define LOADM(R, I, J) \
+    wasm_u64x2_make(m[blake2b_sigma[R][I]], m[blake2b_sigma[R][J]])
+
+# define G(a, b, c, d, m0, m1)                         \
+    do {                                               \
+        a = wasm_i64x2_add(wasm_i64x2_add(a, b), m0); \
+        d = XOR_ROTR32(d, a);                         \
+        c = wasm_i64x2_add(c, d);                     \
+        b = XOR_ROTR24(b, c);                         \
+        a = wasm_i64x2_add(wasm_i64x2_add(a, b), m1); \
+        d = XOR_ROTR16(d, a);                         \
+        c = wasm_i64x2_add(c, d);                     \
+        b = XOR_ROTR63(b, c);                         \
+    } while (0)
+
+int
+blake2b_compress_simd128(blake2b_state *S,
+                         const uint8_t  block[BLAKE2B_BLOCKBYTES])
+{
+    uint64_t m[16];
+    v128_t   a0, a1, b0, b1, c0, c1, d0, d1;
+    v128_t   t0, t1;
+    int      i;
+    int      r;
+
+    for (i = 0; i < 16; i++) {
+        m[i] = LOAD64_LE(block + i * sizeof m[i]);
+    }
+    a0 = wasm_v128_load(&S->h[0]);
+    a1 = wasm_v128_load(&S->h[2]);
+    b0 = wasm_v128_load(&S->h[4]);
+    b1 = wasm_v128_load(&S->h[6]);
+    c0 = wasm_v128_load(&blake2b_IV[0]);
+    c1 = wasm_v128_load(&blake2b_IV[2]);
+    d0 = wasm_v128_xor(wasm_v128_load(&blake2b_IV[4]),
+                       wasm_v128_load(&S->t[0]));
+    d1 = wasm_v128_xor(wasm_v128_load(&blake2b_IV[6]),
+                       wasm_v128_load(&S->f[0]));
+
+    for (r = 0; r < 12; r++) {
+        G(a0, b0, c0, d0, LOADM(r, 0, 2), LOADM(r, 1, 3));
+        G(a1, b1, c1, d1, LOADM(r, 4, 6), LOADM(r, 5, 7));
+
+        t0 = wasm_i64x2_shuffle(b0, b1, 1, 2);
+        t1 = wasm_i64x2_shuffle(b1, b0, 1, 2);
+        b0 = t0;
+        b1 = t1;
+        t0 = c0;
+        c0 = c1;
+        c1 = t0;
+        t0 = wasm_i64x2_shuffle(d1, d0, 1, 2);
+        t1 = wasm_i64x2_shuffle(d0, d1, 1, 2);
+        d0 = t0;
+        d1 = t1;
+
+        G(a0, b0, c0, d0, LOADM(r, 8, 10), LOADM(r, 9, 11));
+        G(a1, b1, c1, d1, LOADM(r, 12, 14), LOADM(r, 13, 15));
+
+        t0 = wasm_i64x2_shuffle(b1, b0, 1, 2);
+        t1 = wasm_i64x2_shuffle(b0, b1, 1, 2);
+        b0 = t0;
+        b1 = t1;
+        t0 = c0;
+        c0 = c1;
+        c1 = t0;
+        t0 = wasm_i64x2_shuffle(d0, d1, 1, 2);
+        t1 = wasm_i64x2_shuffle(d1, d0, 1, 2);
+        d0 = t0;
+        d1 = t1;
+    }
+    wasm_v128_store(&S->h[0], wasm_v128_xor(wasm_v128_load(&S->h[0]),
+                                              wasm_v128_xor(a0, c0)));
+    wasm_v128_store(&S->h[2], wasm_v128_xor(wasm_v128_load(&S->h[2]),
+                                              wasm_v128_xor(a1, c1)));
+    wasm_v128_store(&S->h[4], wasm_v128_xor(wasm_v128_load(&S->h[4]),
+                                              wasm_v128_xor(b0, d0)));
+    wasm_v128_store(&S->h[6], wasm_v128_xor(wasm_v128_load(&S->h[6]),
+                                              wasm_v128_xor(b1, d1)));
+
+    return 0;
+}
+
+#endif
@@ -39,22 +39,22 @@ blake2b_compress_ssse3(blake2b_state *S,
         _mm_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
     const __m128i r24 =
         _mm_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
-    const uint64_t m0  = ((const uint64_t *) block)[0];
-    const uint64_t m1  = ((const uint64_t *) block)[1];
-    const uint64_t m2  = ((const uint64_t *) block)[2];
-    const uint64_t m3  = ((const uint64_t *) block)[3];
-    const uint64_t m4  = ((const uint64_t *) block)[4];
-    const uint64_t m5  = ((const uint64_t *) block)[5];
-    const uint64_t m6  = ((const uint64_t *) block)[6];
-    const uint64_t m7  = ((const uint64_t *) block)[7];
-    const uint64_t m8  = ((const uint64_t *) block)[8];
-    const uint64_t m9  = ((const uint64_t *) block)[9];
-    const uint64_t m10 = ((const uint64_t *) block)[10];
-    const uint64_t m11 = ((const uint64_t *) block)[11];
-    const uint64_t m12 = ((const uint64_t *) block)[12];
-    const uint64_t m13 = ((const uint64_t *) block)[13];
-    const uint64_t m14 = ((const uint64_t *) block)[14];
-    const uint64_t m15 = ((const uint64_t *) block)[15];
+    const uint64_t m0  = LOAD64_LE(block + 0);
+    const uint64_t m1  = LOAD64_LE(block + 8);
+    const uint64_t m2  = LOAD64_LE(block + 16);
+    const uint64_t m3  = LOAD64_LE(block + 24);
+    const uint64_t m4  = LOAD64_LE(block + 32);
+    const uint64_t m5  = LOAD64_LE(block + 40);
+    const uint64_t m6  = LOAD64_LE(block + 48);
+    const uint64_t m7  = LOAD64_LE(block + 56);
+    const uint64_t m8  = LOAD64_LE(block + 64);
+    const uint64_t m9  = LOAD64_LE(block + 72);
+    const uint64_t m10 = LOAD64_LE(block + 80);
+    const uint64_t m11 = LOAD64_LE(block + 88);
+    const uint64_t m12 = LOAD64_LE(block + 96);
+    const uint64_t m13 = LOAD64_LE(block + 104);
+    const uint64_t m14 = LOAD64_LE(block + 112);
+    const uint64_t m15 = LOAD64_LE(block + 120);
 
     row1l = LOADU(&S->h[0]);
     row1h = LOADU(&S->h[2]);
@@ -0,0 +1,123 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "private/common.h"
+
+#if defined(HAVE_VSX) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <altivec.h>
+
+/*
+ * Each row of the state is held in two 2x64-bit vectors, so that a round
+ * is two vectorized G steps on columns, then two on diagonals.
+ */
+
+typedef __vector unsigned long long vu64;
+
+static const uint8_t blake2b_sigma[12][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+static const uint64_t blake2b_IV[8] = {
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+    0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+    0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+# define LOADU64(P) vec_xl(0, (const unsigned long long *) (P))
+# define STOREU64(P, V) vec_xst((V), 0, (unsigned long long *) (P))
+
+# define XOR_ROTR(A, B, N) \
+    vec_rl(vec_xor((A), (B)), vec_splats((unsigned long long) (64 - (N))))
+
+/* { x[1], y[0] } */
+# define EXT1(X, Y) vec_mergeh(vec_mergel((X), (X)), (Y))
+
+# define LOADM(R, I, J) \
+    ((vu64) { m[blake2b_sigma[R][I]], m[blake2b_sigma[R][J]] })
+
+# define G(a, b, c, d, m0, m1)            \
+    do {                                  \
+        a = vec_add(vec_add(a, b), m0);   \
+        d = XOR_ROTR(d, a, 32);           \
+        c = vec_add(c, d);                \
+        b = XOR_ROTR(b, c, 24);           \
+        a = vec_add(vec_add(a, b), m1);   \
+        d = XOR_ROTR(d, a, 16);           \
+        c = vec_add(c, d);                \
+        b = XOR_ROTR(b, c, 63);           \
+    } while (0)
+
+int
+blake2b_compress_vsx(blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES])
+{
+    unsigned long long m[16];
+    vu64               a0, a1, b0, b1, c0, c1, d0, d1;
+    vu64               t0, t1;
+    int                i;
+    int                r;
+
+    for (i = 0; i < 16; i++) {
+        m[i] = LOAD64_LE(block + i * sizeof m[i]);
+    }
+    a0 = LOADU64(&S->h[0]);
+    a1 = LOADU64(&S->h[2]);
+    b0 = LOADU64(&S->h[4]);
+    b1 = LOADU64(&S->h[6]);
+    c0 = LOADU64(&blake2b_IV[0]);
+    c1 = LOADU64(&blake2b_IV[2]);
+    d0 = vec_xor(LOADU64(&blake2b_IV[4]), LOADU64(&S->t[0]));
+    d1 = vec_xor(LOADU64(&blake2b_IV[6]), LOADU64(&S->f[0]));
+
+    for (r = 0; r < 12; r++) {
+        G(a0, b0, c0, d0, LOADM(r, 0, 2), LOADM(r, 1, 3));
+        G(a1, b1, c1, d1, LOADM(r, 4, 6), LOADM(r, 5, 7));
+
+        t0 = EXT1(b0, b1);
+        t1 = EXT1(b1, b0);
+        b0 = t0;
+        b1 = t1;
+        t0 = c0;
+        c0 = c1;
+        c1 = t0;
+        t0 = EXT1(d1, d0);
+        t1 = EXT1(d0, d1);
+        d0 = t0;
+        d1 = t1;
+
+        G(a0, b0, c0, d0, LOADM(r, 8, 10), LOADM(r, 9, 11));
+        G(a1, b1, c1, d1, LOADM(r, 12, 14), LOADM(r, 13, 15));
+
+        t0 = EXT1(b1, b0);
+        t1 = EXT1(b0, b1);
+        b0 = t0;
+        b1 = t1;
+        t0 = c0;
+        c0 = c1;
+        c1 = t0;
+        t0 = EXT1(d0, d1);
+        t1 = EXT1(d1, d0);
+        d0 = t0;
+        d1 = t1;
+    }
+    STOREU64(&S->h[0], vec_xor(LOADU64(&S->h[0]), vec_xor(a0, c0)));
+    STOREU64(&S->h[2], vec_xor(LOADU64(&S->h[2]), vec_xor(a1, c1)));
+    STOREU64(&S->h[4], vec_xor(LOADU64(&S->h[4]), vec_xor(b0, d0)));
+    STOREU64(&S->h[6], vec_xor(LOADU64(&S->h[6]), vec_xor(b1, d1)));
+
+    return 0;
+}
+
+#endif
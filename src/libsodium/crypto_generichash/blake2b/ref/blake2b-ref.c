@@ -22,10 +22,30 @@
 #include "blake2.h"
 #include "core.h"
 #include "private/common.h"
+#include "private/implementations.h"
 #include "runtime.h"
 #include "utils.h"
 
+/* With --with-isa, the compression function for the baseline is called directly */
+#if defined(FIXED_ISA) && defined(__AVX512VL__) && \
+    defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# define blake2b_compress blake2b_compress_avx512vl
+# define FIXED_NAME "avx512vl"
+#elif defined(FIXED_ISA) && defined(__AVX2__) && \
+    defined(HAVE_AVX2INTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+# define blake2b_compress blake2b_compress_avx2
+# define FIXED_NAME "avx2"
+#elif defined(FIXED_ISA) && defined(__ARM_NEON) && \
+    defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+# define blake2b_compress blake2b_compress_neon
+# define FIXED_NAME "neon"
+#else
 static blake2b_compress_fn blake2b_compress = blake2b_compress_ref;
+#endif
+static blake2b_compress_multi_fn blake2b_compress_multi = NULL;
+static size_t blake2b_multi_lanes = 0U;
 
 static const uint64_t blake2b_IV[8] = {
     0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
@@ -97,9 +117,9 @@ blake2b_init0(blake2b_state *S)
     for (i  = 0; i < 8; i++) {
         S->h[i] = blake2b_IV[i];
     }
-    /* zero everything between .t and .last_node */
+    /* zero everything between .t and .key_compressed */
     memset((void *) &S->t, 0,
-           offsetof(blake2b_state, last_node) + sizeof(S->last_node)
+           offsetof(blake2b_state, key_compressed) + sizeof(S->key_compressed)
            - offsetof(blake2b_state, t));
     return 0;
 }
@@ -122,6 +142,39 @@ blake2b_init_param(blake2b_state *S, const blake2b_param *P)
     return 0;
 }
 
+/*
+ * The key block is compressed right away, so that a copy of a keyed state
+ * only has to compress the message. It is kept in the buffer along with the
+ * chaining value it was compressed from, in case it turns out to be the last
+ * block, i.e. if the message is empty.
+ */
+static void
+blake2b_absorb_key(blake2b_state *S, const void *key, const uint8_t keylen)
+{
+    uint8_t *const block = S->buf;
+    uint8_t *const h0    = S->buf + BLAKE2B_BLOCKBYTES;
+
+    COMPILER_ASSERT(sizeof S->h <= sizeof S->buf - BLAKE2B_BLOCKBYTES);
+    memset(block, 0, BLAKE2B_BLOCKBYTES);
+    memcpy(block, key, keylen); /* key and keylen cannot be 0 */
+    memcpy(h0, S->h, sizeof S->h);
+    blake2b_increment_counter(S, BLAKE2B_BLOCKBYTES);
+    blake2b_compress(S, block);
+    S->buflen         = BLAKE2B_BLOCKBYTES;
+    S->key_compressed = 1;
+}
+
+/* Undoes the key block compression, for an empty message */
+static void
+blake2b_unabsorb_key(blake2b_state *S)
+{
+    memcpy(S->h, S->buf + BLAKE2B_BLOCKBYTES, sizeof S->h);
+    memset(S->buf + BLAKE2B_BLOCKBYTES, 0, sizeof S->h);
+    S->t[0]           = 0U;
+    S->t[1]           = 0U;
+    S->key_compressed = 0;
+}
+
 int
 blake2b_init(blake2b_state *S, const uint8_t outlen)
 {
@@ -202,13 +255,8 @@ blake2b_init_key(blake2b_state *S, const uint8_t outlen, const void *key,
     if (blake2b_init_param(S, P) < 0) {
         sodium_misuse();
     }
-    {
-        uint8_t block[BLAKE2B_BLOCKBYTES];
-        memset(block, 0, BLAKE2B_BLOCKBYTES);
-        memcpy(block, key, keylen); /* key and keylen cannot be 0 */
-        blake2b_update(S, block, BLAKE2B_BLOCKBYTES);
-        sodium_memzero(block, BLAKE2B_BLOCKBYTES); /* Burn the key from stack */
-    }
+    blake2b_absorb_key(S, key, keylen);
+
     return 0;
 }
 
@@ -248,42 +296,59 @@ blake2b_init_key_salt_personal(blake2b_state *S, const uint8_t outlen,
     if (blake2b_init_param(S, P) < 0) {
         sodium_misuse();
     }
-    {
-        uint8_t block[BLAKE2B_BLOCKBYTES];
-        memset(block, 0, BLAKE2B_BLOCKBYTES);
-        memcpy(block, key, keylen); /* key and keylen cannot be 0 */
-        blake2b_update(S, block, BLAKE2B_BLOCKBYTES);
-        sodium_memzero(block, BLAKE2B_BLOCKBYTES); /* Burn the key from stack */
-    }
+    blake2b_absorb_key(S, key, keylen);
+
     return 0;
 }
 
-/* inlen now in bytes */
+/*
+ * inlen now in bytes
+ *
+ * Input is only buffered while it fits in the two buffered blocks, or to
+ * complete a partial block. Full blocks are then compressed straight from
+ * the input, except the last one, that could be the final block.
+ */
 int
 blake2b_update(blake2b_state *S, const uint8_t *in, uint64_t inlen)
 {
-    while (inlen > 0) {
-        size_t left = S->buflen;
-        size_t fill = 2 * BLAKE2B_BLOCKBYTES - left;
+    size_t left;
+    size_t fill;
 
-        if (inlen > fill) {
-            memcpy(S->buf + left, in, fill); /* Fill buffer */
-            S->buflen += fill;
+    if (S->key_compressed && inlen > 0) {
+        sodium_memzero(S->buf, sizeof S->buf);
+        S->buflen         = 0;
+        S->key_compressed = 0;
+    }
+    if (inlen == 0U) {
+        return 0;
+    }
+    left = S->buflen;
+    if (inlen <= 2 * BLAKE2B_BLOCKBYTES - left) {
+        memcpy(S->buf + left, in, (size_t) inlen);
+        S->buflen += (size_t) inlen; /* Be lazy, do not compress */
+        return 0;
+    }
+    if (left > 0) {
+        fill = (left <= BLAKE2B_BLOCKBYTES ? BLAKE2B_BLOCKBYTES :
+                2 * BLAKE2B_BLOCKBYTES) - left;
+        memcpy(S->buf + left, in, fill); /* Complete the buffered blocks */
+        in += fill;
+        inlen -= fill;
+        blake2b_increment_counter(S, BLAKE2B_BLOCKBYTES);
+        blake2b_compress(S, S->buf);
+        if (left + fill > BLAKE2B_BLOCKBYTES) {
             blake2b_increment_counter(S, BLAKE2B_BLOCKBYTES);
-            blake2b_compress(S, S->buf); /* Compress */
-            memcpy(S->buf, S->buf + BLAKE2B_BLOCKBYTES,
-                   BLAKE2B_BLOCKBYTES); /* Shift buffer left */
-            S->buflen -= BLAKE2B_BLOCKBYTES;
-            in += fill;
-            inlen -= fill;
-        } else /* inlen <= fill */
-        {
-            memcpy(S->buf + left, in, inlen);
-            S->buflen += inlen; /* Be lazy, do not compress */
-            in += inlen;
-            inlen -= inlen;
+            blake2b_compress(S, S->buf + BLAKE2B_BLOCKBYTES);
         }
     }
+    while (inlen > BLAKE2B_BLOCKBYTES) {
+        blake2b_increment_counter(S, BLAKE2B_BLOCKBYTES);
+        blake2b_compress(S, in); /* Compress from the input */
+        in += BLAKE2B_BLOCKBYTES;
+        inlen -= BLAKE2B_BLOCKBYTES;
+    }
+    memcpy(S->buf, in, (size_t) inlen);
+    S->buflen = (size_t) inlen;
 
     return 0;
 }
@@ -299,6 +364,9 @@ blake2b_final(blake2b_state *S, uint8_t *out, uint8_t outlen)
     if (blake2b_is_lastblock(S)) {
         return -1;
     }
+    if (S->key_compressed) {
+        blake2b_unabsorb_key(S);
+    }
     if (S->buflen > BLAKE2B_BLOCKBYTES) {
         blake2b_increment_counter(S, BLAKE2B_BLOCKBYTES);
         blake2b_compress(S, S->buf);
@@ -330,6 +398,60 @@ blake2b_final(blake2b_state *S, uint8_t *out, uint8_t outlen)
     return 0;
 }
 
+/*
+ * A message that fits in a block, or a key with an empty message, takes a
+ * single compression. The chaining value is computed from the parameters
+ * directly, and the block is padded on the stack, skipping the buffers of
+ * the incremental API.
+ */
+static int
+blake2b_one_block(uint8_t *out, const void *in, const void *key,
+                  const uint8_t outlen, const uint8_t inlen,
+                  const uint8_t keylen, const void *salt, const void *personal)
+{
+    CRYPTO_ALIGN(64) blake2b_state S[1];
+    CRYPTO_ALIGN(64) uint8_t       block[BLAKE2B_BLOCKBYTES];
+    unsigned char                  buffer[BLAKE2B_OUTBYTES];
+    int                            i;
+
+    for (i = 0; i < 8; i++) {
+        S->h[i] = blake2b_IV[i];
+    }
+    S->h[0] ^= 0x01010000ULL | ((uint64_t) keylen << 8) | (uint64_t) outlen;
+    if (salt != NULL) {
+        S->h[4] ^= LOAD64_LE((const uint8_t *) salt);
+        S->h[5] ^= LOAD64_LE((const uint8_t *) salt + 8);
+    }
+    if (personal != NULL) {
+        S->h[6] ^= LOAD64_LE((const uint8_t *) personal);
+        S->h[7] ^= LOAD64_LE((const uint8_t *) personal + 8);
+    }
+    memset(block, 0, sizeof block);
+    if (keylen > 0) {
+        memcpy(block, key, keylen);
+        S->t[0] = BLAKE2B_BLOCKBYTES;
+    } else {
+        if (inlen > 0) {
+            memcpy(block, in, inlen);
+        }
+        S->t[0] = inlen;
+    }
+    S->t[1] = 0U;
+    S->f[0] = (uint64_t) -1;
+    S->f[1] = 0U;
+    blake2b_compress(S, block);
+
+    for (i = 0; i < 8; i++) {
+        STORE64_LE(buffer + 8 * i, S->h[i]);
+    }
+    memcpy(out, buffer, outlen);
+    sodium_memzero(S->h, sizeof S->h);
+    sodium_memzero(block, sizeof block);
+    sodium_memzero(buffer, sizeof buffer);
+
+    return 0;
+}
+
 /* inlen, at least, should be uint64_t. Others can be size_t. */
 int
 blake2b(uint8_t *out, const void *in, const void *key, const uint8_t outlen,
@@ -353,6 +475,10 @@ blake2b(uint8_t *out, const void *in, const void *key, const uint8_t outlen,
     if (keylen > BLAKE2B_KEYBYTES) {
         sodium_misuse();
     }
+    if (inlen <= BLAKE2B_BLOCKBYTES && (keylen == 0 || inlen == 0)) {
+        return blake2b_one_block(out, in, key, outlen, (uint8_t) inlen,
+                                 keylen, NULL, NULL);
+    }
     if (keylen > 0) {
         if (blake2b_init_key(S, outlen, key, keylen) < 0) {
             sodium_misuse();
@@ -391,6 +517,10 @@ blake2b_salt_personal(uint8_t *out, const void *in, const void *key,
     if (keylen > BLAKE2B_KEYBYTES) {
         sodium_misuse();
     }
+    if (inlen <= BLAKE2B_BLOCKBYTES && (keylen == 0 || inlen == 0)) {
+        return blake2b_one_block(out, in, key, outlen, (uint8_t) inlen,
+                                 keylen, salt, personal);
+    }
     if (keylen > 0) {
         if (blake2b_init_key_salt_personal(S, outlen, key, keylen, salt,
                                            personal) < 0) {
@@ -407,32 +537,436 @@ blake2b_salt_personal(uint8_t *out, const void *in, const void *key,
     return 0;
 }
 
+#define BLAKE2B_MULTI_NONE SIZE_MAX
+
+size_t
+blake2b_compress_lanes_count(void)
+{
+    if (blake2b_compress_multi == NULL) {
+        return 1U;
+    }
+    return blake2b_multi_lanes;
+}
+
+int
+blake2b_compress_lanes(blake2b_multi_state *M, size_t lanes)
+{
+    CRYPTO_ALIGN(64) blake2b_state S;
+    size_t                         l;
+    int                            i;
+
+    assert(lanes <= BLAKE2B_MULTI_LANES_MAX);
+    if (blake2b_compress_multi != NULL && lanes > 1U &&
+        lanes <= blake2b_multi_lanes) {
+        return blake2b_compress_multi(M);
+    }
+    for (l = 0U; l < lanes; l++) {
+        for (i = 0; i < 8; i++) {
+            S.h[i] = M->h[i][l];
+        }
+        for (i = 0; i < 16; i++) {
+            STORE64_LE(S.buf + 8 * i, M->m[i][l]);
+        }
+        S.t[0] = M->t[0][l];
+        S.t[1] = M->t[1][l];
+        S.f[0] = M->f[0][l];
+        S.f[1] = M->f[1][l];
+        blake2b_compress(&S, S.buf);
+        for (i = 0; i < 8; i++) {
+            M->h[i][l] = S.h[i];
+        }
+    }
+    sodium_memzero(&S, sizeof S);
+
+    return 0;
+}
+
+static void
+blake2b_multi_lane_init(blake2b_multi_state *M, size_t lane, const uint64_t p0)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        M->h[i][lane] = blake2b_IV[i];
+    }
+    M->h[0][lane] ^= p0;
+}
+
+/*
+ * Lanes are refilled with the next message as soon as they are done, so
+ * that messages of different lengths can be mixed.
+ */
+int
+blake2b_multi(uint8_t * const *out, const uint8_t outlen,
+              const uint8_t * const *in, const unsigned long long *inlen,
+              size_t count, const void *key, const uint8_t keylen)
+{
+    CRYPTO_ALIGN(64) blake2b_multi_state M;
+    uint8_t        block[BLAKE2B_BLOCKBYTES];
+    uint8_t        buffer[BLAKE2B_OUTBYTES];
+    uint64_t       done[BLAKE2B_MULTI_LANES_MAX];
+    size_t         idx[BLAKE2B_MULTI_LANES_MAX];
+    int            key_pending[BLAKE2B_MULTI_LANES_MAX];
+    const uint8_t *src;
+    uint64_t       p0;
+    uint64_t       n;
+    size_t         active = 0U;
+    size_t         next   = 0U;
+    size_t         lanes  = blake2b_multi_lanes;
+    size_t         l;
+    int            i;
+
+    if (!outlen || outlen > BLAKE2B_OUTBYTES || keylen > BLAKE2B_KEYBYTES ||
+        (key == NULL && keylen > 0)) {
+        sodium_misuse();
+    }
+    if (blake2b_compress_multi == NULL || count < 2U) {
+        for (next = 0U; next < count; next++) {
+            blake2b(out[next], in[next], key, outlen, (uint64_t) inlen[next],
+                    keylen);
+        }
+        return 0;
+    }
+    p0 = 0x01010000ULL ^ ((uint64_t) keylen << 8) ^ (uint64_t) outlen;
+    memset(&M, 0, sizeof M);
+    for (l = 0U; l < lanes; l++) {
+        idx[l] = BLAKE2B_MULTI_NONE;
+        if (next < count) {
+            blake2b_multi_lane_init(&M, l, p0);
+            idx[l]         = next++;
+            done[l]        = 0U;
+            key_pending[l] = keylen > 0;
+            active++;
+        }
+    }
+    while (active > 0U) {
+        for (l = 0U; l < lanes; l++) {
+            if (idx[l] == BLAKE2B_MULTI_NONE) {
+                continue;
+            }
+            if (key_pending[l]) {
+                memset(block, 0, sizeof block);
+                memcpy(block, key, keylen);
+                src            = block;
+                key_pending[l] = 0;
+                M.t[0][l]      = BLAKE2B_BLOCKBYTES;
+                M.t[1][l]      = 0U;
+                M.f[0][l]      = inlen[idx[l]] == 0U ? (uint64_t) -1 : 0U;
+            } else {
+                n = inlen[idx[l]] - done[l];
+                if (n > BLAKE2B_BLOCKBYTES) {
+                    n = BLAKE2B_BLOCKBYTES;
+                }
+                src = in[idx[l]] + done[l];
+                if (n < BLAKE2B_BLOCKBYTES) {
+                    memset(block, 0, sizeof block);
+                    if (n > 0U) {
+                        memcpy(block, src, (size_t) n);
+                    }
+                    src = block;
+                }
+                done[l] += n;
+                M.t[0][l] = done[l] + (keylen > 0 ? BLAKE2B_BLOCKBYTES : 0U);
+                M.t[1][l] = M.t[0][l] < done[l];
+                M.f[0][l] = done[l] == inlen[idx[l]] ? (uint64_t) -1 : 0U;
+            }
+            for (i = 0; i < 16; i++) {
+                M.m[i][l] = LOAD64_LE(src + i * sizeof M.m[i][l]);
+            }
+        }
+        blake2b_compress_multi(&M);
+        for (l = 0U; l < lanes; l++) {
+            if (idx[l] == BLAKE2B_MULTI_NONE || M.f[0][l] == 0U) {
+                continue;
+            }
+            for (i = 0; i < 8; i++) {
+                STORE64_LE(buffer + 8 * i, M.h[i][l]);
+            }
+            memcpy(out[idx[l]], buffer, outlen);
+            if (next < count) {
+                blake2b_multi_lane_init(&M, l, p0);
+                idx[l]         = next++;
+                done[l]        = 0U;
+                key_pending[l] = keylen > 0;
+            } else {
+                idx[l] = BLAKE2B_MULTI_NONE;
+                active--;
+            }
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(block, sizeof block);
+    sodium_memzero(buffer, sizeof buffer);
+
+    return 0;
+}
+
+/*
+ * Keyed hashes of the empty message, for consecutive values of the first
+ * salt word: each one is a single compression of the key block, so that
+ * all lanes start and finish together.
+ */
+int
+blake2b_salt_personal_range(uint8_t *out, const uint8_t outlen, size_t count,
+                            const void *key, const uint8_t keylen,
+                            uint64_t first_salt, const void *personal)
+{
+    CRYPTO_ALIGN(64) blake2b_multi_state M;
+    uint8_t        block[BLAKE2B_BLOCKBYTES];
+    uint8_t        salt[BLAKE2B_SALTBYTES];
+    uint8_t        buffer[BLAKE2B_OUTBYTES];
+    uint64_t       p0, p6, p7;
+    size_t         lanes = blake2b_multi_lanes;
+    size_t         done;
+    size_t         n;
+    size_t         l;
+    int            i;
+
+    if (!outlen || outlen > BLAKE2B_OUTBYTES || key == NULL || !keylen ||
+        keylen > BLAKE2B_KEYBYTES) {
+        sodium_misuse();
+    }
+    if (blake2b_compress_multi == NULL || count < 2U) {
+        memset(salt, 0, sizeof salt);
+        for (done = 0U; done < count; done++) {
+            STORE64_LE(salt, first_salt + done);
+            blake2b_salt_personal(out + done * outlen, NULL, key, outlen, 0U,
+                                  keylen, salt, personal);
+        }
+        return 0;
+    }
+    p0 = 0x01010000ULL ^ ((uint64_t) keylen << 8) ^ (uint64_t) outlen;
+    p6 = LOAD64_LE((const uint8_t *) personal);
+    p7 = LOAD64_LE((const uint8_t *) personal + 8);
+    memset(block, 0, sizeof block);
+    memcpy(block, key, keylen);
+    memset(&M, 0, sizeof M);
+    for (l = 0U; l < lanes; l++) {
+        for (i = 0; i < 16; i++) {
+            M.m[i][l] = LOAD64_LE(block + i * sizeof M.m[i][l]);
+        }
+        M.t[0][l] = BLAKE2B_BLOCKBYTES;
+        M.f[0][l] = (uint64_t) -1;
+    }
+    for (done = 0U; done < count; done += n) {
+        n = count - done;
+        if (n > lanes) {
+            n = lanes;
+        }
+        for (l = 0U; l < lanes; l++) {
+            for (i = 0; i < 8; i++) {
+                M.h[i][l] = blake2b_IV[i];
+            }
+            M.h[0][l] ^= p0;
+            M.h[4][l] ^= first_salt + done + l;
+            M.h[6][l] ^= p6;
+            M.h[7][l] ^= p7;
+        }
+        blake2b_compress_multi(&M);
+        for (l = 0U; l < n; l++) {
+            for (i = 0; i < 8; i++) {
+                STORE64_LE(buffer + 8 * i, M.h[i][l]);
+            }
+            memcpy(out + (done + l) * outlen, buffer, outlen);
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(block, sizeof block);
+    sodium_memzero(buffer, sizeof buffer);
+
+    return 0;
+}
+
+static uint8_t
+blake2b_xof_block_length(const uint32_t xof_length, const uint64_t node)
+{
+    uint64_t remaining;
+
+    if (xof_length == UINT32_MAX) {
+        return BLAKE2B_OUTBYTES;
+    }
+    remaining = (uint64_t) xof_length - node * BLAKE2B_OUTBYTES;
+
+    return remaining < BLAKE2B_OUTBYTES ? (uint8_t) remaining : BLAKE2B_OUTBYTES;
+}
+
+/*
+ * BLAKE2X output blocks: unkeyed hashes of the root digest, for consecutive
+ * node offsets. Each one is a single compression, so that all lanes start
+ * and finish together. Only the last block of a known length can be short.
+ */
+int
+blake2b_xof_blocks(uint8_t *out, const uint8_t root[BLAKE2B_OUTBYTES],
+                   const uint32_t xof_length, const uint32_t first_block,
+                   size_t count)
+{
+    CRYPTO_ALIGN(64) blake2b_multi_state M;
+    CRYPTO_ALIGN(64) blake2b_state       S;
+    uint8_t        block[BLAKE2B_BLOCKBYTES];
+    uint8_t        buffer[BLAKE2B_OUTBYTES];
+    const uint64_t p1 = (uint64_t) xof_length << 32;
+    const uint64_t p2 = (uint64_t) BLAKE2B_OUTBYTES << 8;
+    uint64_t       node;
+    size_t         lanes = blake2b_multi_lanes;
+    size_t         done;
+    size_t         n;
+    size_t         l;
+    uint8_t        len;
+    int            i;
+
+    memset(block, 0, sizeof block);
+    memcpy(block, root, BLAKE2B_OUTBYTES);
+    if (blake2b_compress_multi == NULL || count < 2U) {
+        for (done = 0U; done < count; done++) {
+            node = (uint64_t) first_block + done;
+            len  = blake2b_xof_block_length(xof_length, node);
+            blake2b_init0(&S);
+            S.h[0] ^= (uint64_t) len | ((uint64_t) BLAKE2B_OUTBYTES << 32);
+            S.h[1] ^= p1 | (uint32_t) node;
+            S.h[2] ^= p2;
+            S.t[0] = BLAKE2B_OUTBYTES;
+            S.f[0] = (uint64_t) -1;
+            blake2b_compress(&S, block);
+            for (i = 0; i < 8; i++) {
+                STORE64_LE(buffer + 8 * i, S.h[i]);
+            }
+            memcpy(out + done * BLAKE2B_OUTBYTES, buffer, len);
+        }
+        sodium_memzero(&S, sizeof S);
+        sodium_memzero(block, sizeof block);
+        sodium_memzero(buffer, sizeof buffer);
+        return 0;
+    }
+    memset(&M, 0, sizeof M);
+    for (l = 0U; l < lanes; l++) {
+        for (i = 0; i < 16; i++) {
+            M.m[i][l] = LOAD64_LE(block + i * sizeof M.m[i][l]);
+        }
+        M.t[0][l] = BLAKE2B_OUTBYTES;
+        M.f[0][l] = (uint64_t) -1;
+    }
+    for (done = 0U; done < count; done += n) {
+        n = count - done;
+        if (n > lanes) {
+            n = lanes;
+        }
+        for (l = 0U; l < lanes; l++) {
+            node = (uint64_t) first_block + done + l;
+            for (i = 0; i < 8; i++) {
+                M.h[i][l] = blake2b_IV[i];
+            }
+            M.h[0][l] ^= (uint64_t) blake2b_xof_block_length(xof_length, node) |
+                         ((uint64_t) BLAKE2B_OUTBYTES << 32);
+            M.h[1][l] ^= p1 | (uint32_t) node;
+            M.h[2][l] ^= p2;
+        }
+        blake2b_compress_multi(&M);
+        for (l = 0U; l < n; l++) {
+            node = (uint64_t) first_block + done + l;
+            for (i = 0; i < 8; i++) {
+                STORE64_LE(buffer + 8 * i, M.h[i][l]);
+            }
+            memcpy(out + (done + l) * BLAKE2B_OUTBYTES, buffer,
+                   blake2b_xof_block_length(xof_length, node));
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(block, sizeof block);
+    sodium_memzero(buffer, sizeof buffer);
+
+    return 0;
+}
+
 int
 blake2b_pick_best_implementation(void)
 {
 /* LCOV_EXCL_START */
+    blake2b_compress_multi = NULL;
+    blake2b_multi_lanes    = 0U;
 #if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
     defined(HAVE_SMMINTRIN_H)
-    if (sodium_runtime_has_avx2()) {
+    if (sodium_runtime_has_avx2() &&
+        _sodium_implementation_allowed("blake2b", "avx2")) {
+        blake2b_compress_multi = blake2b_compress_multi_avx2;
+        blake2b_multi_lanes    = 4U;
+    }
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors() &&
+        _sodium_implementation_allowed("blake2b", "avx512vl")) {
+        blake2b_compress_multi = blake2b_compress_multi_avx512f;
+        blake2b_multi_lanes    = 8U;
+    }
+#endif
+#ifdef FIXED_NAME
+    _sodium_implementation_selected("blake2b", FIXED_NAME);
+
+    return 0;
+#else
+#if defined(HAVE_WASM_SIMD128)
+    /* The module would not load on a runtime without SIMD support */
+    if (_sodium_implementation_allowed("blake2b", "simd128")) {
+        blake2b_compress = blake2b_compress_simd128;
+        _sodium_implementation_selected("blake2b", "simd128");
+        return 0;
+    }
+#endif
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_neon() &&
+        _sodium_implementation_allowed("blake2b", "neon")) {
+        blake2b_compress = blake2b_compress_neon;
+        _sodium_implementation_selected("blake2b", "neon");
+        return 0;
+    }
+#endif
+#if defined(HAVE_VSX) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_vsx() &&
+        _sodium_implementation_allowed("blake2b", "vsx")) {
+        blake2b_compress = blake2b_compress_vsx;
+        _sodium_implementation_selected("blake2b", "vsx");
+        return 0;
+    }
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512vl() &&
+        _sodium_implementation_allowed("blake2b", "avx512vl")) {
+        blake2b_compress = blake2b_compress_avx512vl;
+        _sodium_implementation_selected("blake2b", "avx512vl");
+        return 0;
+    }
+#endif
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2() &&
+        _sodium_implementation_allowed("blake2b", "avx2")) {
         blake2b_compress = blake2b_compress_avx2;
+        _sodium_implementation_selected("blake2b", "avx2");
         return 0;
     }
 #endif
 #if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
     defined(HAVE_SMMINTRIN_H)
-    if (sodium_runtime_has_sse41()) {
+    if (sodium_runtime_has_sse41() &&
+        _sodium_implementation_allowed("blake2b", "sse41")) {
         blake2b_compress = blake2b_compress_sse41;
+        _sodium_implementation_selected("blake2b", "sse41");
         return 0;
     }
 #endif
 #if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H)
-    if (sodium_runtime_has_ssse3()) {
+    if (sodium_runtime_has_ssse3() &&
+        _sodium_implementation_allowed("blake2b", "ssse3")) {
         blake2b_compress = blake2b_compress_ssse3;
+        _sodium_implementation_selected("blake2b", "ssse3");
         return 0;
     }
 #endif
     blake2b_compress = blake2b_compress_ref;
+    _sodium_implementation_selected("blake2b", "ref");
 
     return 0;
+#endif
     /* LCOV_EXCL_STOP */
 }
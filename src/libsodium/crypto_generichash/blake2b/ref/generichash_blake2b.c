@@ -2,26 +2,36 @@
 #include <assert.h>
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "blake2.h"
 #include "crypto_generichash_blake2b.h"
+#include "private/blake2b_range.h"
 #include "private/common.h"
 #include "private/implementations.h"
+#include "private/stats.h"
 
 int
 crypto_generichash_blake2b(unsigned char *out, size_t outlen,
                            const unsigned char *in, unsigned long long inlen,
                            const unsigned char *key, size_t keylen)
 {
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
     if (outlen <= 0U || outlen > BLAKE2B_OUTBYTES ||
         keylen > BLAKE2B_KEYBYTES || inlen > UINT64_MAX) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, 0U);
         return -1;
     }
     assert(outlen <= UINT8_MAX);
     assert(keylen <= UINT8_MAX);
 
-    return blake2b((uint8_t *) out, in, key, (uint8_t) outlen, (uint64_t) inlen,
-                   (uint8_t) keylen);
+    ret = blake2b((uint8_t *) out, in, key, (uint8_t) outlen, (uint64_t) inlen,
+                  (uint8_t) keylen);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, inlen);
+
+    return ret;
 }
 
 int
@@ -42,6 +52,51 @@ crypto_generichash_blake2b_salt_personal(
                                  personal);
 }
 
+int
+_crypto_generichash_blake2b_salt_personal_range(
+    unsigned char *out, size_t outlen, size_t count, const unsigned char *key,
+    size_t keylen, uint64_t first_salt, const unsigned char *personal)
+{
+    if (outlen <= 0U || outlen > BLAKE2B_OUTBYTES ||
+        keylen <= 0U || keylen > BLAKE2B_KEYBYTES) {
+        return -1;
+    }
+    assert(outlen <= UINT8_MAX);
+    assert(keylen <= UINT8_MAX);
+
+    return blake2b_salt_personal_range((uint8_t *) out, (uint8_t) outlen,
+                                       count, key, (uint8_t) keylen,
+                                       first_salt, personal);
+}
+
+int
+crypto_generichash_blake2b_multi(unsigned char * const *out, size_t outlen,
+                                 const unsigned char * const *in,
+                                 const unsigned long long *inlen, size_t count,
+                                 const unsigned char *key, size_t keylen)
+{
+    size_t i;
+
+    if (outlen <= 0U || outlen > BLAKE2B_OUTBYTES ||
+        keylen > BLAKE2B_KEYBYTES) {
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        if (inlen[i] > UINT64_MAX) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+    }
+    if (key == NULL) {
+        keylen = 0U;
+    }
+    assert(outlen <= UINT8_MAX);
+    assert(keylen <= UINT8_MAX);
+
+    return blake2b_multi((uint8_t * const *) out, (uint8_t) outlen,
+                         (const uint8_t * const *) in, inlen, count, key,
+                         (uint8_t) keylen);
+}
+
 int
 crypto_generichash_blake2b_init(crypto_generichash_blake2b_state *state,
                                 const unsigned char *key, const size_t keylen,
@@ -96,8 +151,14 @@ crypto_generichash_blake2b_update(crypto_generichash_blake2b_state *state,
                                   const unsigned char *in,
                                   unsigned long long inlen)
 {
-    return blake2b_update((blake2b_state *) (void *) state,
-                          (const uint8_t *) in, (uint64_t) inlen);
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = blake2b_update((blake2b_state *) (void *) state,
+                         (const uint8_t *) in, (uint64_t) inlen);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, inlen);
+
+    return ret;
 }
 
 int
@@ -109,6 +170,15 @@ crypto_generichash_blake2b_final(crypto_generichash_blake2b_state *state,
                          (uint8_t *) out, (uint8_t) outlen);
 }
 
+void
+crypto_generichash_blake2b_state_clone(crypto_generichash_blake2b_state *dst,
+                                       const crypto_generichash_blake2b_state *src)
+{
+    if (dst != src) {
+        memcpy(dst, src, sizeof(blake2b_state));
+    }
+}
+
 int
 _crypto_generichash_blake2b_pick_best_implementation(void)
 {
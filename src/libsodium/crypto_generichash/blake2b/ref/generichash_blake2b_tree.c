@@ -0,0 +1,375 @@
+
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "core.h"
+#include "crypto_generichash_blake2b_tree.h"
+#include "private/common.h"
+#include "utils.h"
+
+/*
+ * Serialized layout, all integers in little-endian order:
+ *
+ *   inlen (8) || leaf_length (4) || outlen (1) || keylen (1) || 0 (2)
+ *   || level 0 (leaves) || level 1 || ... || root
+ *
+ * Every node occupies BLAKE2B_OUTBYTES bytes. The input of a node at level
+ * k > 0 is the concatenation of the (one or two) hashes of its children at
+ * level k - 1. The last node of every level has the last_node flag set.
+ */
+
+#define BLAKE2B_TREE_HEADERBYTES 16U
+#define BLAKE2B_TREE_DEPTH_MAX   64
+
+typedef struct blake2b_tree_params {
+    uint64_t inlen;
+    uint32_t leaf_length;
+    uint8_t  outlen;
+    uint8_t  keylen;
+    uint64_t counts[BLAKE2B_TREE_DEPTH_MAX];
+    size_t   offsets[BLAKE2B_TREE_DEPTH_MAX];
+    int      height;
+} blake2b_tree_params;
+
+size_t
+crypto_generichash_blake2b_tree_bytes_min(void)
+{
+    return crypto_generichash_blake2b_tree_BYTES_MIN;
+}
+
+size_t
+crypto_generichash_blake2b_tree_bytes_max(void)
+{
+    return crypto_generichash_blake2b_tree_BYTES_MAX;
+}
+
+size_t
+crypto_generichash_blake2b_tree_keybytes_min(void)
+{
+    return crypto_generichash_blake2b_tree_KEYBYTES_MIN;
+}
+
+size_t
+crypto_generichash_blake2b_tree_keybytes_max(void)
+{
+    return crypto_generichash_blake2b_tree_KEYBYTES_MAX;
+}
+
+size_t
+crypto_generichash_blake2b_tree_leafbytes_min(void)
+{
+    return crypto_generichash_blake2b_tree_LEAFBYTES_MIN;
+}
+
+size_t
+crypto_generichash_blake2b_tree_leafbytes_max(void)
+{
+    return crypto_generichash_blake2b_tree_LEAFBYTES_MAX;
+}
+
+/* Computes the shape of the tree, and returns its serialized size or 0 */
+static size_t
+blake2b_tree_shape(blake2b_tree_params *T, const uint64_t inlen,
+                   const uint64_t leaf_length)
+{
+    size_t   size = BLAKE2B_TREE_HEADERBYTES;
+    uint64_t count;
+    int      k;
+
+    if (leaf_length < crypto_generichash_blake2b_tree_LEAFBYTES_MIN ||
+        leaf_length > crypto_generichash_blake2b_tree_LEAFBYTES_MAX) {
+        return 0U;
+    }
+    T->inlen       = inlen;
+    T->leaf_length = (uint32_t) leaf_length;
+    count          = inlen / leaf_length + (inlen % leaf_length != 0U);
+    if (count == 0U) {
+        count = 1U;
+    }
+    for (k = 0; k < BLAKE2B_TREE_DEPTH_MAX; k++) {
+        if (count > (SIZE_MAX - size) / BLAKE2B_OUTBYTES) {
+            return 0U;
+        }
+        T->counts[k]  = count;
+        T->offsets[k] = size;
+        size += (size_t) count * BLAKE2B_OUTBYTES;
+        if (count == 1U) {
+            break;
+        }
+        count = (count + 1U) / 2U;
+    }
+    if (k == BLAKE2B_TREE_DEPTH_MAX) {
+        return 0U; /* LCOV_EXCL_LINE */
+    }
+    T->height = k;
+
+    return size;
+}
+
+static int
+blake2b_tree_load(blake2b_tree_params *T, const unsigned char *tree,
+                  const size_t tree_len)
+{
+    if (tree_len < BLAKE2B_TREE_HEADERBYTES ||
+        tree[14] != 0U || tree[15] != 0U ||
+        blake2b_tree_shape(T, LOAD64_LE(tree), LOAD32_LE(tree + 8)) !=
+            tree_len) {
+        return -1;
+    }
+    T->outlen = tree[12];
+    T->keylen = tree[13];
+    if (T->outlen < crypto_generichash_blake2b_tree_BYTES_MIN ||
+        T->outlen > crypto_generichash_blake2b_tree_BYTES_MAX ||
+        T->keylen > crypto_generichash_blake2b_tree_KEYBYTES_MAX) {
+        return -1;
+    }
+    return 0;
+}
+
+/*
+ * Hashes nodes first .. first + count - 1 of level depth. Their inputs are
+ * consecutive slices of node_length bytes of in, which starts with the input
+ * of node first and ends at offset level_length of the whole level.
+ * Nodes are processed in parallel, one per lane of the multi-buffer code.
+ */
+static void
+blake2b_tree_hash_nodes(unsigned char *out, const blake2b_tree_params *T,
+                        const uint8_t *key, const int depth,
+                        const unsigned char *in, const uint64_t level_length,
+                        const uint64_t node_length, const uint64_t first,
+                        const uint64_t count)
+{
+    CRYPTO_ALIGN(64) blake2b_multi_state M;
+    CRYPTO_ALIGN(64) blake2b_state       S;
+    blake2b_param                        P;
+    uint8_t                              block[BLAKE2B_BLOCKBYTES];
+    const unsigned char                 *src[BLAKE2B_MULTI_LANES_MAX];
+    uint64_t                             len[BLAKE2B_MULTI_LANES_MAX];
+    uint64_t                             blocks[BLAKE2B_MULTI_LANES_MAX];
+    const uint8_t                        keyblocks = T->keylen > 0U;
+    const size_t                         lanes = blake2b_compress_lanes_count();
+    uint8_t                              digest_length;
+    uint64_t                             j;
+    uint64_t                             r;
+    uint64_t                             rounds;
+    uint64_t                             idx;
+    uint64_t                             off;
+    size_t                               n;
+    size_t                               l;
+    size_t                               blen;
+    int                                  i;
+
+    digest_length = BLAKE2B_OUTBYTES;
+    if (T->counts[depth] == 1U) {
+        digest_length = T->outlen; /* root */
+    }
+    memset(&M, 0, sizeof M);
+    memset(&P, 0, sizeof P);
+    P.digest_length = digest_length;
+    P.key_length    = T->keylen;
+    P.fanout        = 2;
+    P.depth         = 255;
+    STORE32_LE(P.leaf_length, T->leaf_length);
+    P.node_depth    = (uint8_t) depth;
+    P.inner_length  = BLAKE2B_OUTBYTES;
+
+    for (j = 0U; j < count; j += n) {
+        n = lanes;
+        if (count - j < n) {
+            n = (size_t) (count - j);
+        }
+        rounds = 0U;
+        for (l = 0U; l < n; l++) {
+            idx = first + j + l;
+            STORE64_LE(P.node_offset, idx);
+            blake2b_init_param(&S, &P);
+            for (i = 0; i < 8; i++) {
+                M.h[i][l] = S.h[i];
+            }
+            M.t[0][l] = M.t[1][l] = 0U;
+            off    = idx * node_length;
+            len[l] = level_length - off;
+            if (len[l] > node_length) {
+                len[l] = node_length;
+            }
+            src[l]    = in + (size_t) ((j + l) * node_length);
+            blocks[l] = keyblocks + (len[l] + BLAKE2B_BLOCKBYTES - 1U) /
+                                        BLAKE2B_BLOCKBYTES;
+            if (blocks[l] == 0U) {
+                blocks[l] = 1U;
+            }
+            if (blocks[l] > rounds) {
+                rounds = blocks[l];
+            }
+        }
+        for (r = 0U; r < rounds; r++) {
+            for (l = 0U; l < n; l++) {
+                if (r >= blocks[l]) {
+                    continue;
+                }
+                if (r < keyblocks) {
+                    memset(block, 0, sizeof block);
+                    memcpy(block, key, T->keylen);
+                    blen = BLAKE2B_BLOCKBYTES;
+                } else {
+                    off  = (r - keyblocks) * BLAKE2B_BLOCKBYTES;
+                    blen = BLAKE2B_BLOCKBYTES;
+                    if (len[l] - off < blen) {
+                        blen = (size_t) (len[l] - off);
+                        memset(block, 0, sizeof block);
+                    }
+                    if (blen > 0U) {
+                        memcpy(block, src[l] + off, blen);
+                    }
+                }
+                for (i = 0; i < 16; i++) {
+                    M.m[i][l] = LOAD64_LE(block + 8 * i);
+                }
+                M.t[0][l] += blen;
+                M.t[1][l] += (M.t[0][l] < blen);
+                M.f[0][l] = M.f[1][l] = 0U;
+                if (r + 1U == blocks[l]) {
+                    M.f[0][l] = (uint64_t) -1;
+                    if (first + j + l + 1U == T->counts[depth]) {
+                        M.f[1][l] = (uint64_t) -1;
+                    }
+                }
+            }
+            blake2b_compress_lanes(&M, n);
+            for (l = 0U; l < n; l++) {
+                if (r + 1U != blocks[l]) {
+                    continue;
+                }
+                for (i = 0; i < 8; i++) {
+                    STORE64_LE(block + 8 * i, M.h[i][l]);
+                }
+                memset(out + (size_t) (j + l) * BLAKE2B_OUTBYTES, 0,
+                       BLAKE2B_OUTBYTES);
+                memcpy(out + (size_t) (j + l) * BLAKE2B_OUTBYTES, block,
+                       digest_length);
+            }
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(&S, sizeof S);
+    sodium_memzero(block, sizeof block);
+}
+
+static void
+blake2b_tree_hash_parents(unsigned char *tree, const blake2b_tree_params *T,
+                          const uint8_t *key, const int depth,
+                          const uint64_t first, const uint64_t count)
+{
+    const unsigned char *children = tree + T->offsets[depth - 1];
+
+    blake2b_tree_hash_nodes(tree + T->offsets[depth] +
+                                (size_t) first * BLAKE2B_OUTBYTES,
+                            T, key, depth,
+                            children + (size_t) first * 2U * BLAKE2B_OUTBYTES,
+                            T->counts[depth - 1] * BLAKE2B_OUTBYTES,
+                            2U * BLAKE2B_OUTBYTES, first, count);
+}
+
+size_t
+crypto_generichash_blake2b_tree_treebytes(unsigned long long inlen,
+                                          size_t leaf_length)
+{
+    blake2b_tree_params T;
+
+    return blake2b_tree_shape(&T, (uint64_t) inlen, (uint64_t) leaf_length);
+}
+
+int
+crypto_generichash_blake2b_tree_init(unsigned char *tree, size_t tree_len,
+                                     const unsigned char *in,
+                                     unsigned long long inlen,
+                                     size_t leaf_length,
+                                     const unsigned char *key, size_t keylen,
+                                     size_t outlen)
+{
+    blake2b_tree_params T;
+    int                 k;
+
+    if (outlen < crypto_generichash_blake2b_tree_BYTES_MIN ||
+        outlen > crypto_generichash_blake2b_tree_BYTES_MAX ||
+        keylen > crypto_generichash_blake2b_tree_KEYBYTES_MAX ||
+        (key == NULL && keylen > 0U) ||
+        blake2b_tree_shape(&T, (uint64_t) inlen, (uint64_t) leaf_length) !=
+            tree_len || tree_len == 0U) {
+        errno = EINVAL;
+        return -1;
+    }
+    T.outlen = (uint8_t) outlen;
+    T.keylen = (uint8_t) keylen;
+    memset(tree, 0, BLAKE2B_TREE_HEADERBYTES);
+    STORE64_LE(tree, (uint64_t) inlen);
+    STORE32_LE(tree + 8, (uint32_t) leaf_length);
+    tree[12] = T.outlen;
+    tree[13] = T.keylen;
+
+    blake2b_tree_hash_nodes(tree + T.offsets[0], &T, key, 0, in,
+                            (uint64_t) inlen, (uint64_t) leaf_length, 0U,
+                            T.counts[0]);
+    for (k = 1; k <= T.height; k++) {
+        blake2b_tree_hash_parents(tree, &T, key, k, 0U, T.counts[k]);
+    }
+    return 0;
+}
+
+int
+crypto_generichash_blake2b_tree_update_leaf(unsigned char *tree,
+                                            size_t tree_len,
+                                            unsigned long long leaf_index,
+                                            const unsigned char *leaf,
+                                            size_t leaf_len,
+                                            const unsigned char *key,
+                                            size_t keylen)
+{
+    blake2b_tree_params T;
+    uint64_t            expected_len;
+    uint64_t            idx = (uint64_t) leaf_index;
+    int                 k;
+
+    if (blake2b_tree_load(&T, tree, tree_len) != 0 ||
+        idx >= T.counts[0] || keylen != T.keylen ||
+        (key == NULL && keylen > 0U)) {
+        errno = EINVAL;
+        return -1;
+    }
+    expected_len = T.inlen - idx * T.leaf_length;
+    if (expected_len > T.leaf_length) {
+        expected_len = T.leaf_length;
+    }
+    if ((uint64_t) leaf_len != expected_len ||
+        (leaf == NULL && leaf_len > 0U)) {
+        errno = EINVAL;
+        return -1;
+    }
+    blake2b_tree_hash_nodes(tree + T.offsets[0] +
+                                (size_t) idx * BLAKE2B_OUTBYTES,
+                            &T, key, 0, leaf, T.inlen, T.leaf_length, idx, 1U);
+    for (k = 1; k <= T.height; k++) {
+        idx /= 2U;
+        blake2b_tree_hash_parents(tree, &T, key, k, idx, 1U);
+    }
+    return 0;
+}
+
+int
+crypto_generichash_blake2b_tree_root(unsigned char *out, size_t outlen,
+                                     const unsigned char *tree,
+                                     size_t tree_len)
+{
+    blake2b_tree_params T;
+
+    if (blake2b_tree_load(&T, tree, tree_len) != 0 || outlen != T.outlen) {
+        errno = EINVAL;
+        return -1;
+    }
+    memcpy(out, tree + T.offsets[T.height], outlen);
+
+    return 0;
+}
@@ -0,0 +1,337 @@
+
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "core.h"
+#include "crypto_generichash_blake2bp.h"
+#include "private/common.h"
+#include "utils.h"
+
+#define BLAKE2BP_LEAVES      4U
+#define BLAKE2BP_STRIPEBYTES (BLAKE2BP_LEAVES * BLAKE2B_BLOCKBYTES)
+
+/*
+ * The leaves are the first lanes of a multi-buffer state. An input stripe
+ * is only compressed once the buffer holds more than two of them, so that
+ * the last block of every leaf is still available when finalizing.
+ */
+
+typedef struct blake2bp_state {
+    blake2b_multi_state M;
+    uint8_t             buf[2 * BLAKE2BP_STRIPEBYTES];
+    size_t              buflen;
+    uint8_t             outlen;
+    uint8_t             keylen;
+    uint8_t             key_pending;
+} blake2bp_state;
+
+static void
+blake2bp_param(blake2b_param *P, const uint8_t outlen, const uint8_t keylen,
+               const uint64_t node_offset, const uint8_t node_depth)
+{
+    memset(P, 0, sizeof *P);
+    P->digest_length = outlen;
+    P->key_length    = keylen;
+    P->fanout        = BLAKE2BP_LEAVES;
+    P->depth         = 2;
+    STORE32_LE(P->leaf_length, 0);
+    STORE64_LE(P->node_offset, node_offset);
+    P->node_depth   = node_depth;
+    P->inner_length = BLAKE2B_OUTBYTES;
+}
+
+static void
+blake2bp_load_block(blake2bp_state *S, size_t l, const uint8_t *block)
+{
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        S->M.m[i][l] = LOAD64_LE(block + 8 * i);
+    }
+}
+
+static void
+blake2bp_increment_counter(blake2bp_state *S, size_t l, const uint64_t inc)
+{
+    S->M.t[0][l] += inc;
+    S->M.t[1][l] += (S->M.t[0][l] < inc);
+}
+
+static void
+blake2bp_compress_stripe(blake2bp_state *S, const uint8_t *stripe)
+{
+    size_t l;
+
+    if (S->key_pending) {
+        for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+            blake2bp_increment_counter(S, l, BLAKE2B_BLOCKBYTES);
+        }
+        blake2b_compress_lanes(&S->M, BLAKE2BP_LEAVES);
+        S->key_pending = 0;
+    }
+    for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+        blake2bp_load_block(S, l, stripe + l * BLAKE2B_BLOCKBYTES);
+        blake2bp_increment_counter(S, l, BLAKE2B_BLOCKBYTES);
+    }
+    blake2b_compress_lanes(&S->M, BLAKE2BP_LEAVES);
+}
+
+static int
+blake2bp_init(blake2bp_state *S, const uint8_t outlen, const void *key,
+              const uint8_t keylen)
+{
+    CRYPTO_ALIGN(64) blake2b_state leaf;
+    blake2b_param                  P;
+    uint8_t                        block[BLAKE2B_BLOCKBYTES];
+    size_t                         l;
+    int                            i;
+
+    if (!outlen || outlen > BLAKE2B_OUTBYTES || keylen > BLAKE2B_KEYBYTES ||
+        (key == NULL && keylen > 0)) {
+        return -1;
+    }
+    memset(S, 0, sizeof *S);
+    S->outlen = outlen;
+    S->keylen = keylen;
+    for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+        blake2bp_param(&P, outlen, keylen, (uint64_t) l, 0);
+        blake2b_init_param(&leaf, &P);
+        for (i = 0; i < 8; i++) {
+            S->M.h[i][l] = leaf.h[i];
+        }
+    }
+    if (keylen > 0) {
+        memset(block, 0, sizeof block);
+        memcpy(block, key, keylen);
+        for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+            blake2bp_load_block(S, l, block);
+        }
+        sodium_memzero(block, sizeof block);
+        S->key_pending = 1;
+    }
+    sodium_memzero(&leaf, sizeof leaf);
+
+    return 0;
+}
+
+static int
+blake2bp_update(blake2bp_state *S, const uint8_t *in, uint64_t inlen)
+{
+    size_t left;
+    size_t fill;
+
+    while (inlen > 0) {
+        left = S->buflen;
+        if (left == 0U) {
+            while (inlen > 2 * BLAKE2BP_STRIPEBYTES) {
+                blake2bp_compress_stripe(S, in);
+                in += BLAKE2BP_STRIPEBYTES;
+                inlen -= BLAKE2BP_STRIPEBYTES;
+            }
+        }
+        fill = sizeof S->buf - left;
+        if (inlen > fill) {
+            memcpy(S->buf + left, in, fill);
+            blake2bp_compress_stripe(S, S->buf);
+            memcpy(S->buf, S->buf + BLAKE2BP_STRIPEBYTES, BLAKE2BP_STRIPEBYTES);
+            S->buflen = BLAKE2BP_STRIPEBYTES;
+            in += fill;
+            inlen -= fill;
+        } else {
+            memcpy(S->buf + left, in, (size_t) inlen);
+            S->buflen += (size_t) inlen;
+            inlen = 0;
+        }
+    }
+    return 0;
+}
+
+static int
+blake2bp_final(blake2bp_state *S, uint8_t *out, const uint8_t outlen)
+{
+    CRYPTO_ALIGN(64) blake2b_state R;
+    blake2b_param                  P;
+    uint8_t                        block[BLAKE2B_BLOCKBYTES];
+    uint8_t                        hash[BLAKE2BP_LEAVES][BLAKE2B_OUTBYTES];
+    uint64_t                       h[8][BLAKE2BP_LEAVES];
+    const uint8_t                 *blocks[BLAKE2BP_LEAVES][3];
+    size_t                         blocklens[BLAKE2BP_LEAVES][3];
+    size_t                         nblocks[BLAKE2BP_LEAVES];
+    size_t                         rounds = 0U;
+    size_t                         r;
+    size_t                         l;
+    size_t                         off;
+    size_t                         len;
+    int                            i;
+
+    if (!outlen || outlen > BLAKE2B_OUTBYTES) {
+        sodium_misuse();
+    }
+    /* the remaining blocks of each leaf: key, then up to two data blocks */
+    for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+        nblocks[l] = 0U;
+        if (S->key_pending) {
+            blocks[l][nblocks[l]]      = NULL;
+            blocklens[l][nblocks[l]++] = BLAKE2B_BLOCKBYTES;
+        }
+        for (off = l * BLAKE2B_BLOCKBYTES; off < S->buflen;
+             off += BLAKE2BP_STRIPEBYTES) {
+            len = S->buflen - off;
+            if (len > BLAKE2B_BLOCKBYTES) {
+                len = BLAKE2B_BLOCKBYTES;
+            }
+            blocks[l][nblocks[l]]      = S->buf + off;
+            blocklens[l][nblocks[l]++] = len;
+        }
+        if (nblocks[l] == 0U) {
+            blocks[l][nblocks[l]]      = S->buf + S->buflen;
+            blocklens[l][nblocks[l]++] = 0U;
+        }
+        if (nblocks[l] > rounds) {
+            rounds = nblocks[l];
+        }
+    }
+    for (r = 0U; r < rounds; r++) {
+        for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+            for (i = 0; i < 8; i++) {
+                h[i][l] = S->M.h[i][l];
+            }
+            if (r >= nblocks[l] || blocks[l][r] == NULL) {
+                continue; /* done, or key block already loaded */
+            }
+            memset(block, 0, sizeof block);
+            memcpy(block, blocks[l][r], blocklens[l][r]);
+            blake2bp_load_block(S, l, block);
+        }
+        for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+            if (r < nblocks[l]) {
+                blake2bp_increment_counter(S, l, blocklens[l][r]);
+                S->M.f[0][l] = r + 1U == nblocks[l] ? (uint64_t) -1 : 0U;
+                S->M.f[1][l] = (r + 1U == nblocks[l] &&
+                                l + 1U == BLAKE2BP_LEAVES) ? (uint64_t) -1 : 0U;
+            }
+        }
+        blake2b_compress_lanes(&S->M, BLAKE2BP_LEAVES);
+        for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+            if (r >= nblocks[l]) {
+                for (i = 0; i < 8; i++) {
+                    S->M.h[i][l] = h[i][l];
+                }
+            }
+        }
+    }
+    for (l = 0U; l < BLAKE2BP_LEAVES; l++) {
+        for (i = 0; i < 8; i++) {
+            STORE64_LE(hash[l] + 8 * i, S->M.h[i][l]);
+        }
+    }
+    blake2bp_param(&P, S->outlen, S->keylen, 0U, 1);
+    blake2b_init_param(&R, &P);
+    R.last_node = 1;
+    blake2b_update(&R, &hash[0][0], sizeof hash);
+    blake2b_final(&R, out, outlen);
+
+    sodium_memzero(S, sizeof *S);
+    sodium_memzero(&R, sizeof R);
+    sodium_memzero(block, sizeof block);
+    sodium_memzero(hash, sizeof hash);
+    sodium_memzero(h, sizeof h);
+
+    return 0;
+}
+
+int
+crypto_generichash_blake2bp(unsigned char *out, size_t outlen,
+                            const unsigned char *in, unsigned long long inlen,
+                            const unsigned char *key, size_t keylen)
+{
+    crypto_generichash_blake2bp_state state;
+
+    if (crypto_generichash_blake2bp_init(&state, key, keylen, outlen) != 0) {
+        return -1;
+    }
+    crypto_generichash_blake2bp_update(&state, in, inlen);
+
+    return crypto_generichash_blake2bp_final(&state, out, outlen);
+}
+
+int
+crypto_generichash_blake2bp_init(crypto_generichash_blake2bp_state *state,
+                                 const unsigned char *key,
+                                 const size_t keylen, const size_t outlen)
+{
+    COMPILER_ASSERT(sizeof(blake2bp_state) <= sizeof *state);
+    if (outlen <= 0U || outlen > BLAKE2B_OUTBYTES ||
+        keylen > BLAKE2B_KEYBYTES) {
+        return -1;
+    }
+    if (key == NULL) {
+        return blake2bp_init((blake2bp_state *) (void *) state,
+                             (uint8_t) outlen, NULL, 0U);
+    }
+    return blake2bp_init((blake2bp_state *) (void *) state, (uint8_t) outlen,
+                         key, (uint8_t) keylen);
+}
+
+int
+crypto_generichash_blake2bp_update(crypto_generichash_blake2bp_state *state,
+                                   const unsigned char *in,
+                                   unsigned long long inlen)
+{
+    return blake2bp_update((blake2bp_state *) (void *) state,
+                           (const uint8_t *) in, (uint64_t) inlen);
+}
+
+int
+crypto_generichash_blake2bp_final(crypto_generichash_blake2bp_state *state,
+                                  unsigned char *out, const size_t outlen)
+{
+    assert(outlen <= UINT8_MAX);
+    return blake2bp_final((blake2bp_state *) (void *) state,
+                          (uint8_t *) out, (uint8_t) outlen);
+}
+
+size_t
+crypto_generichash_blake2bp_bytes_min(void)
+{
+    return crypto_generichash_blake2bp_BYTES_MIN;
+}
+
+size_t
+crypto_generichash_blake2bp_bytes_max(void)
+{
+    return crypto_generichash_blake2bp_BYTES_MAX;
+}
+
+size_t
+crypto_generichash_blake2bp_bytes(void)
+{
+    return crypto_generichash_blake2bp_BYTES;
+}
+
+size_t
+crypto_generichash_blake2bp_keybytes_min(void)
+{
+    return crypto_generichash_blake2bp_KEYBYTES_MIN;
+}
+
+size_t
+crypto_generichash_blake2bp_keybytes_max(void)
+{
+    return crypto_generichash_blake2bp_KEYBYTES_MAX;
+}
+
+size_t
+crypto_generichash_blake2bp_keybytes(void)
+{
+    return crypto_generichash_blake2bp_KEYBYTES;
+}
+
+size_t
+crypto_generichash_blake2bp_statebytes(void)
+{
+    return (sizeof(crypto_generichash_blake2bp_state) + (size_t) 63U) & ~(size_t) 63U;
+}
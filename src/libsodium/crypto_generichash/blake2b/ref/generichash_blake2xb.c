@@ -0,0 +1,208 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake2.h"
+#include "core.h"
+#include "crypto_generichash_blake2xb.h"
+#include "private/common.h"
+#include "utils.h"
+
+/* Output blocks are computed in batches of this size by the multi-buffer code */
+#define BLAKE2XB_BATCH_BLOCKS 64U
+
+typedef struct blake2xb_state {
+    blake2b_state S;
+    uint8_t       root[BLAKE2B_OUTBYTES];
+    uint64_t      position;
+    uint32_t      xof_length;
+    uint8_t       squeezing;
+} blake2xb_state;
+
+static uint64_t
+blake2xb_limit(const blake2xb_state *st)
+{
+    if (st->xof_length == crypto_generichash_blake2xb_BYTES_UNKNOWN) {
+        return (uint64_t) BLAKE2B_OUTBYTES << 32;
+    }
+    return (uint64_t) st->xof_length;
+}
+
+static int
+blake2xb_init(blake2xb_state *st, const uint8_t *key, const uint8_t keylen,
+              const uint32_t xof_length)
+{
+    blake2b_param P;
+    uint8_t       block[BLAKE2B_BLOCKBYTES];
+
+    memset(&P, 0, sizeof P);
+    P.digest_length = BLAKE2B_OUTBYTES;
+    P.key_length    = keylen;
+    P.fanout        = 1;
+    P.depth         = 1;
+    STORE64_LE(P.node_offset, (uint64_t) xof_length << 32);
+    blake2b_init_param(&st->S, &P);
+    if (keylen > 0U) {
+        memset(block, 0, sizeof block);
+        memcpy(block, key, keylen);
+        blake2b_update(&st->S, block, BLAKE2B_BLOCKBYTES);
+        sodium_memzero(block, sizeof block);
+    }
+    st->position   = 0U;
+    st->xof_length = xof_length;
+    st->squeezing  = 0U;
+
+    return 0;
+}
+
+static int
+blake2xb_squeeze(blake2xb_state *st, uint8_t *out, size_t outlen)
+{
+    uint8_t  block[BLAKE2B_OUTBYTES];
+    uint64_t remaining;
+    uint64_t node;
+    size_t   offset;
+    size_t   count;
+    size_t   len;
+
+    remaining = blake2xb_limit(st) - st->position;
+    if ((uint64_t) outlen > remaining) {
+        return -1;
+    }
+    if (st->squeezing == 0U) {
+        blake2b_final(&st->S, st->root, BLAKE2B_OUTBYTES);
+        st->squeezing = 1U;
+    }
+    while (outlen > 0U) {
+        node   = st->position / BLAKE2B_OUTBYTES;
+        offset = (size_t) (st->position % BLAKE2B_OUTBYTES);
+        count  = outlen / BLAKE2B_OUTBYTES;
+        if ((uint64_t) outlen == remaining) {
+            count = (outlen + BLAKE2B_OUTBYTES - 1U) / BLAKE2B_OUTBYTES;
+        }
+        if (count > BLAKE2XB_BATCH_BLOCKS) {
+            count = BLAKE2XB_BATCH_BLOCKS;
+        }
+        if (offset == 0U && count > 0U) {
+            /* whole blocks, written directly to the output */
+            blake2b_xof_blocks(out, st->root, st->xof_length, (uint32_t) node,
+                               count);
+            len = count * BLAKE2B_OUTBYTES;
+            if ((uint64_t) len > remaining) {
+                len = (size_t) remaining;
+            }
+        } else {
+            blake2b_xof_blocks(block, st->root, st->xof_length, (uint32_t) node,
+                               1U);
+            len = BLAKE2B_OUTBYTES - offset;
+            if (len > outlen) {
+                len = outlen;
+            }
+            memcpy(out, block + offset, len);
+        }
+        st->position += len;
+        remaining -= len;
+        out += len;
+        outlen -= len;
+    }
+    sodium_memzero(block, sizeof block);
+
+    return 0;
+}
+
+int
+crypto_generichash_blake2xb(unsigned char *out, size_t outlen,
+                            const unsigned char *in, unsigned long long inlen,
+                            const unsigned char *key, size_t keylen)
+{
+    crypto_generichash_blake2xb_state state;
+    int                               ret;
+
+    if (outlen > crypto_generichash_blake2xb_BYTES_MAX ||
+        crypto_generichash_blake2xb_init(&state, key, keylen, outlen) != 0) {
+        return -1;
+    }
+    crypto_generichash_blake2xb_update(&state, in, inlen);
+    ret = crypto_generichash_blake2xb_squeeze(&state, out, outlen);
+    sodium_memzero(&state, sizeof state);
+
+    return ret;
+}
+
+int
+crypto_generichash_blake2xb_init(crypto_generichash_blake2xb_state *state,
+                                 const unsigned char *key,
+                                 const size_t keylen, const size_t outlen)
+{
+    COMPILER_ASSERT(sizeof(blake2xb_state) <= sizeof *state);
+    if (outlen < crypto_generichash_blake2xb_BYTES_MIN ||
+        outlen > crypto_generichash_blake2xb_BYTES_UNKNOWN ||
+        keylen > BLAKE2B_KEYBYTES || (key == NULL && keylen > 0U)) {
+        return -1;
+    }
+    return blake2xb_init((blake2xb_state *) (void *) state, key,
+                         (uint8_t) keylen, (uint32_t) outlen);
+}
+
+int
+crypto_generichash_blake2xb_update(crypto_generichash_blake2xb_state *state,
+                                   const unsigned char *in,
+                                   unsigned long long inlen)
+{
+    blake2xb_state *st = (blake2xb_state *) (void *) state;
+
+    if (st->squeezing != 0U) {
+        return -1;
+    }
+    return blake2b_update(&st->S, (const uint8_t *) in, (uint64_t) inlen);
+}
+
+int
+crypto_generichash_blake2xb_squeeze(crypto_generichash_blake2xb_state *state,
+                                    unsigned char *out, size_t outlen)
+{
+    return blake2xb_squeeze((blake2xb_state *) (void *) state,
+                            (uint8_t *) out, outlen);
+}
+
+size_t
+crypto_generichash_blake2xb_bytes_min(void)
+{
+    return crypto_generichash_blake2xb_BYTES_MIN;
+}
+
+size_t
+crypto_generichash_blake2xb_bytes_max(void)
+{
+    return crypto_generichash_blake2xb_BYTES_MAX;
+}
+
+size_t
+crypto_generichash_blake2xb_bytes_unknown(void)
+{
+    return crypto_generichash_blake2xb_BYTES_UNKNOWN;
+}
+
+size_t
+crypto_generichash_blake2xb_keybytes_min(void)
+{
+    return crypto_generichash_blake2xb_KEYBYTES_MIN;
+}
+
+size_t
+crypto_generichash_blake2xb_keybytes_max(void)
+{
+    return crypto_generichash_blake2xb_KEYBYTES_MAX;
+}
+
+size_t
+crypto_generichash_blake2xb_keybytes(void)
+{
+    return crypto_generichash_blake2xb_KEYBYTES;
+}
+
+size_t
+crypto_generichash_blake2xb_statebytes(void)
+{
+    return (sizeof(crypto_generichash_blake2xb_state) + (size_t) 63U) & ~(size_t) 63U;
+}
@@ -0,0 +1,52 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake3.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+#include "utils.h"
+
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# include "blake3-load-avx2.h"
+
+# define LANES 8
+# define VEC   __m256i
+
+# define LOADV(p)     _mm256_load_si256((const __m256i *) (const void *) (p))
+# define STOREV(p, r) _mm256_store_si256((__m256i *) (void *) (p), r)
+# define SET1(x)      _mm256_set1_epi32((int) (x))
+# define ADD(a, b)    _mm256_add_epi32(a, b)
+# define XOR(a, b)    _mm256_xor_si256(a, b)
+
+# define ROTR16(x)                                                                 \
+    _mm256_shuffle_epi8((x), _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, \
+                                              14, 15, 12, 13, 2, 3, 0, 1, 6, 7, 4, \
+                                              5, 10, 11, 8, 9, 14, 15, 12, 13))
+# define ROTR12(x) _mm256_or_si256(_mm256_srli_epi32((x), 12), _mm256_slli_epi32((x), 20))
+# define ROTR8(x)                                                                  \
+    _mm256_shuffle_epi8((x), _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, \
+                                              13, 14, 15, 12, 1, 2, 3, 0, 5, 6, 7, \
+                                              4, 9, 10, 11, 8, 13, 14, 15, 12))
+# define ROTR7(x) _mm256_or_si256(_mm256_srli_epi32((x), 7), _mm256_slli_epi32((x), 25))
+
+# define LOAD_MSG(m, inputs, offset) blake3_load_msg_avx2((m), (inputs), (offset))
+
+# define FN(name) blake3_##name##8_avx2
+# include "blake3-hash-many.h"
+
+#endif
@@ -0,0 +1,62 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake3.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+#include "utils.h"
+
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+#  pragma GCC target("avx512f")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# include "blake3-load-avx2.h"
+
+# define LANES 16
+# define VEC   __m512i
+
+# define LOADV(p)     _mm512_load_si512((const void *) (p))
+# define STOREV(p, r) _mm512_store_si512((void *) (p), r)
+# define SET1(x)      _mm512_set1_epi32((int) (x))
+# define ADD(a, b)    _mm512_add_epi32(a, b)
+# define XOR(a, b)    _mm512_xor_si512(a, b)
+
+# define ROTR16(x) _mm512_ror_epi32((x), 16)
+# define ROTR12(x) _mm512_ror_epi32((x), 12)
+# define ROTR8(x)  _mm512_ror_epi32((x), 8)
+# define ROTR7(x)  _mm512_ror_epi32((x), 7)
+
+/* two 8-input transposes, one for each half of the vectors */
+static inline void
+blake3_load_msg_avx512f(__m512i m[16], const uint8_t *const *inputs, const size_t offset)
+{
+    __m256i lo[16], hi[16];
+    size_t  i;
+
+    blake3_load_msg_avx2(lo, inputs, offset);
+    blake3_load_msg_avx2(hi, inputs + 8, offset);
+    for (i = 0; i < 16; i++) {
+        m[i] = _mm512_inserti64x4(_mm512_castsi256_si512(lo[i]), hi[i], 1);
+    }
+}
+
+# define LOAD_MSG(m, inputs, offset) blake3_load_msg_avx512f((m), (inputs), (offset))
+
+# define FN(name) blake3_##name##16_avx512f
+# include "blake3-hash-many.h"
+
+#endif
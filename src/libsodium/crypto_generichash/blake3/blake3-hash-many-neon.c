@@ -0,0 +1,54 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake3.h"
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <arm_neon.h>
+
+# define LANES 4
+# define VEC   uint32x4_t
+
+# define LOADV(p)     vld1q_u32(p)
+# define STOREV(p, r) vst1q_u32((p), r)
+# define SET1(x)      vdupq_n_u32((uint32_t) (x))
+# define ADD(a, b)    vaddq_u32(a, b)
+# define XOR(a, b)    veorq_u32(a, b)
+
+# define ROTR16(x) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(x)))
+# define ROTR12(x) vsriq_n_u32(vshlq_n_u32((x), 20), (x), 12)
+# define ROTR8(x)  vsriq_n_u32(vshlq_n_u32((x), 24), (x), 8)
+# define ROTR7(x)  vsriq_n_u32(vshlq_n_u32((x), 25), (x), 7)
+
+/* load one block of each input, and transpose it with 4x4 word shuffles */
+static inline void
+blake3_load_msg_neon(uint32x4_t m[16], const uint8_t *const *inputs, const size_t offset)
+{
+    uint32x4_t   r0, r1, r2, r3;
+    uint32x4x2_t t01, t23;
+    size_t       g;
+
+    for (g = 0; g < 4; g++) {
+        r0  = vreinterpretq_u32_u8(vld1q_u8(inputs[0] + offset + 16 * g));
+        r1  = vreinterpretq_u32_u8(vld1q_u8(inputs[1] + offset + 16 * g));
+        r2  = vreinterpretq_u32_u8(vld1q_u8(inputs[2] + offset + 16 * g));
+        r3  = vreinterpretq_u32_u8(vld1q_u8(inputs[3] + offset + 16 * g));
+        t01 = vtrnq_u32(r0, r1);
+        t23 = vtrnq_u32(r2, r3);
+        m[4 * g + 0] = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+        m[4 * g + 1] = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+        m[4 * g + 2] = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+        m[4 * g + 3] = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+    }
+}
+
+# define LOAD_MSG(m, inputs, offset) blake3_load_msg_neon((m), (inputs), (offset))
+
+# define FN(name) blake3_##name##4_neon
+# include "blake3-hash-many.h"
+
+#endif
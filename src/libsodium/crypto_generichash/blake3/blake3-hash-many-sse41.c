@@ -0,0 +1,66 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake3.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+#include "utils.h"
+
+#if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+# endif
+
+# include <emmintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# define LANES 4
+# define VEC   __m128i
+
+# define LOADV(p)     _mm_load_si128((const __m128i *) (const void *) (p))
+# define STOREV(p, r) _mm_store_si128((__m128i *) (void *) (p), r)
+# define SET1(x)      _mm_set1_epi32((int) (x))
+# define ADD(a, b)    _mm_add_epi32(a, b)
+# define XOR(a, b)    _mm_xor_si128(a, b)
+
+# define ROTR16(x) \
+    _mm_shuffle_epi8((x), _mm_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13))
+# define ROTR12(x) _mm_or_si128(_mm_srli_epi32((x), 12), _mm_slli_epi32((x), 20))
+# define ROTR8(x) \
+    _mm_shuffle_epi8((x), _mm_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12))
+# define ROTR7(x) _mm_or_si128(_mm_srli_epi32((x), 7), _mm_slli_epi32((x), 25))
+
+/* load one block of each input, and transpose it with 4x4 word shuffles */
+static inline void
+blake3_load_msg_sse41(__m128i m[16], const uint8_t *const *inputs, const size_t offset)
+{
+    __m128i r0, r1, r2, r3, t0, t1, t2, t3;
+    size_t  g;
+
+    for (g = 0; g < 4; g++) {
+        r0 = _mm_loadu_si128((const __m128i *) (const void *) (inputs[0] + offset + 16 * g));
+        r1 = _mm_loadu_si128((const __m128i *) (const void *) (inputs[1] + offset + 16 * g));
+        r2 = _mm_loadu_si128((const __m128i *) (const void *) (inputs[2] + offset + 16 * g));
+        r3 = _mm_loadu_si128((const __m128i *) (const void *) (inputs[3] + offset + 16 * g));
+        t0 = _mm_unpacklo_epi32(r0, r1);
+        t1 = _mm_unpacklo_epi32(r2, r3);
+        t2 = _mm_unpackhi_epi32(r0, r1);
+        t3 = _mm_unpackhi_epi32(r2, r3);
+        m[4 * g + 0] = _mm_unpacklo_epi64(t0, t1);
+        m[4 * g + 1] = _mm_unpackhi_epi64(t0, t1);
+        m[4 * g + 2] = _mm_unpacklo_epi64(t2, t3);
+        m[4 * g + 3] = _mm_unpackhi_epi64(t2, t3);
+    }
+}
+
+# define LOAD_MSG(m, inputs, offset) blake3_load_msg_sse41((m), (inputs), (offset))
+
+# define FN(name) blake3_##name##4_sse41
+# include "blake3-hash-many.h"
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Multi-input BLAKE3 compression: every vector holds the same state word of
+ * LANES independent inputs, so that a single pass over the round function
+ * hashes LANES chunks (or parent nodes) at once.
+ *
+ * The includer defines LANES, the vector type VEC, the SET1, ADD, XOR,
+ * LOADV, STOREV and ROTR* operations, LOAD_MSG(m, inputs, offset), which
+ * loads word i of the 64-byte block at `offset` of every input into m[i],
+ * and FN().
+ */
+
+static const uint32_t FN(IV)[8] = { 0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+                                    0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL };
+
+static const uint8_t FN(schedule)[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 }
+};
+
+void
+FN(hash)(const uint8_t *const *inputs, size_t blocks, const uint32_t key[8],
+         uint64_t counter, int increment_counter, uint8_t flags,
+         uint8_t flags_start, uint8_t flags_end, uint8_t *out)
+{
+    CRYPTO_ALIGN(64) uint32_t words[8][LANES];
+    CRYPTO_ALIGN(64) uint32_t counter_lo[LANES];
+    CRYPTO_ALIGN(64) uint32_t counter_hi[LANES];
+    VEC                       h[8];
+    VEC                       m[16];
+    VEC                       v[16];
+    VEC                       ctr_lo, ctr_hi;
+    uint64_t                  c;
+    size_t                    b;
+    size_t                    i;
+    int                       r;
+    uint8_t                   block_flags;
+
+    for (i = 0; i < LANES; i++) {
+        c             = counter + (increment_counter ? (uint64_t) i : 0U);
+        counter_lo[i] = (uint32_t) c;
+        counter_hi[i] = (uint32_t) (c >> 32);
+    }
+    ctr_lo = LOADV(counter_lo);
+    ctr_hi = LOADV(counter_hi);
+    for (i = 0; i < 8; i++) {
+        h[i] = SET1(key[i]);
+    }
+#define G(r, i, a, b, c, d)                                    \
+    do {                                                       \
+        a = ADD(ADD(a, b), m[FN(schedule)[r][2 * i + 0]]);     \
+        d = ROTR16(XOR(d, a));                                 \
+        c = ADD(c, d);                                         \
+        b = ROTR12(XOR(b, c));                                 \
+        a = ADD(ADD(a, b), m[FN(schedule)[r][2 * i + 1]]);     \
+        d = ROTR8(XOR(d, a));                                  \
+        c = ADD(c, d);                                         \
+        b = ROTR7(XOR(b, c));                                  \
+    } while (0)
+    block_flags = (uint8_t) (flags | flags_start);
+    for (b = 0; b < blocks; b++) {
+        if (b + 1 == blocks) {
+            block_flags |= flags_end;
+        }
+        LOAD_MSG(m, inputs, b * 64U);
+        for (i = 0; i < 8; i++) {
+            v[i] = h[i];
+        }
+        v[8]  = SET1(FN(IV)[0]);
+        v[9]  = SET1(FN(IV)[1]);
+        v[10] = SET1(FN(IV)[2]);
+        v[11] = SET1(FN(IV)[3]);
+        v[12] = ctr_lo;
+        v[13] = ctr_hi;
+        v[14] = SET1(64U);
+        v[15] = SET1(block_flags);
+        for (r = 0; r < 7; r++) {
+            G(r, 0, v[0], v[4], v[8], v[12]);
+            G(r, 1, v[1], v[5], v[9], v[13]);
+            G(r, 2, v[2], v[6], v[10], v[14]);
+            G(r, 3, v[3], v[7], v[11], v[15]);
+            G(r, 4, v[0], v[5], v[10], v[15]);
+            G(r, 5, v[1], v[6], v[11], v[12]);
+            G(r, 6, v[2], v[7], v[8], v[13]);
+            G(r, 7, v[3], v[4], v[9], v[14]);
+        }
+        for (i = 0; i < 8; i++) {
+            h[i] = XOR(v[i], v[i + 8]);
+        }
+        block_flags = flags;
+    }
+#undef G
+    for (i = 0; i < 8; i++) {
+        STOREV(words[i], h[i]);
+    }
+    for (b = 0; b < LANES; b++) {
+        for (i = 0; i < 8; i++) {
+            STORE32_LE(out + 32U * b + 4U * i, words[i][b]);
+        }
+    }
+    sodium_memzero(words, sizeof words);
+}
@@ -0,0 +1,50 @@
+#ifndef blake3_load_avx2_H
+#define blake3_load_avx2_H
+
+/*
+ * Load one block of 8 inputs, and transpose it so that m[i] holds word i of
+ * every input. Each half of the block is an 8x8 transpose of 32-bit words.
+ */
+static inline void
+blake3_load_msg_avx2(__m256i m[16], const uint8_t *const *inputs, const size_t offset)
+{
+    __m256i r[8];
+    __m256i ab_0145, ab_2367, cd_0145, cd_2367, ef_0145, ef_2367, gh_0145, gh_2367;
+    __m256i abcd_04, abcd_15, abcd_26, abcd_37, efgh_04, efgh_15, efgh_26, efgh_37;
+    size_t  g, l;
+
+    for (g = 0; g < 2; g++) {
+        for (l = 0; l < 8; l++) {
+            r[l] = _mm256_loadu_si256((const __m256i *) (const void *)
+                                      (inputs[l] + offset + 32 * g));
+        }
+        ab_0145 = _mm256_unpacklo_epi32(r[0], r[1]);
+        ab_2367 = _mm256_unpackhi_epi32(r[0], r[1]);
+        cd_0145 = _mm256_unpacklo_epi32(r[2], r[3]);
+        cd_2367 = _mm256_unpackhi_epi32(r[2], r[3]);
+        ef_0145 = _mm256_unpacklo_epi32(r[4], r[5]);
+        ef_2367 = _mm256_unpackhi_epi32(r[4], r[5]);
+        gh_0145 = _mm256_unpacklo_epi32(r[6], r[7]);
+        gh_2367 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+        abcd_04 = _mm256_unpacklo_epi64(ab_0145, cd_0145);
+        abcd_15 = _mm256_unpackhi_epi64(ab_0145, cd_0145);
+        abcd_26 = _mm256_unpacklo_epi64(ab_2367, cd_2367);
+        abcd_37 = _mm256_unpackhi_epi64(ab_2367, cd_2367);
+        efgh_04 = _mm256_unpacklo_epi64(ef_0145, gh_0145);
+        efgh_15 = _mm256_unpackhi_epi64(ef_0145, gh_0145);
+        efgh_26 = _mm256_unpacklo_epi64(ef_2367, gh_2367);
+        efgh_37 = _mm256_unpackhi_epi64(ef_2367, gh_2367);
+
+        m[8 * g + 0] = _mm256_permute2x128_si256(abcd_04, efgh_04, 0x20);
+        m[8 * g + 1] = _mm256_permute2x128_si256(abcd_15, efgh_15, 0x20);
+        m[8 * g + 2] = _mm256_permute2x128_si256(abcd_26, efgh_26, 0x20);
+        m[8 * g + 3] = _mm256_permute2x128_si256(abcd_37, efgh_37, 0x20);
+        m[8 * g + 4] = _mm256_permute2x128_si256(abcd_04, efgh_04, 0x31);
+        m[8 * g + 5] = _mm256_permute2x128_si256(abcd_15, efgh_15, 0x31);
+        m[8 * g + 6] = _mm256_permute2x128_si256(abcd_26, efgh_26, 0x31);
+        m[8 * g + 7] = _mm256_permute2x128_si256(abcd_37, efgh_37, 0x31);
+    }
+}
+
+#endif
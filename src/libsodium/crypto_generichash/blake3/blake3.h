@@ -0,0 +1,49 @@
+#ifndef blake3_H
+#define blake3_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "private/quirks.h"
+
+#define BLAKE3_KEY_LEN         32U
+#define BLAKE3_OUT_LEN         32U
+#define BLAKE3_BLOCK_LEN       64U
+#define BLAKE3_CHUNK_LEN       1024U
+#define BLAKE3_MAX_DEPTH       54U
+#define BLAKE3_MAX_SIMD_DEGREE 16U
+
+#define BLAKE3_CHUNK_START         ((uint8_t) (1U << 0))
+#define BLAKE3_CHUNK_END           ((uint8_t) (1U << 1))
+#define BLAKE3_PARENT              ((uint8_t) (1U << 2))
+#define BLAKE3_ROOT                ((uint8_t) (1U << 3))
+#define BLAKE3_KEYED_HASH          ((uint8_t) (1U << 4))
+#define BLAKE3_DERIVE_KEY_CONTEXT  ((uint8_t) (1U << 5))
+#define BLAKE3_DERIVE_KEY_MATERIAL ((uint8_t) (1U << 6))
+
+/*
+ * Hashes a fixed number of inputs (the lane count of the implementation),
+ * each made of `blocks` 64-byte blocks, and stores their chaining values
+ * contiguously in `out`. The counter of input i is `counter + i` if
+ * `increment_counter` is set, and `counter` otherwise.
+ */
+typedef void (*blake3_hash_lanes_fn)(const uint8_t *const *inputs, size_t blocks,
+                                     const uint32_t key[8], uint64_t counter,
+                                     int increment_counter, uint8_t flags,
+                                     uint8_t flags_start, uint8_t flags_end,
+                                     uint8_t *out);
+
+void blake3_hash4_sse41(const uint8_t *const *inputs, size_t blocks, const uint32_t key[8],
+                        uint64_t counter, int increment_counter, uint8_t flags,
+                        uint8_t flags_start, uint8_t flags_end, uint8_t *out);
+void blake3_hash8_avx2(const uint8_t *const *inputs, size_t blocks, const uint32_t key[8],
+                       uint64_t counter, int increment_counter, uint8_t flags,
+                       uint8_t flags_start, uint8_t flags_end, uint8_t *out);
+void blake3_hash16_avx512f(const uint8_t *const *inputs, size_t blocks, const uint32_t key[8],
+                           uint64_t counter, int increment_counter, uint8_t flags,
+                           uint8_t flags_start, uint8_t flags_end, uint8_t *out);
+void blake3_hash4_neon(const uint8_t *const *inputs, size_t blocks, const uint32_t key[8],
+                       uint64_t counter, int increment_counter, uint8_t flags,
+                       uint8_t flags_start, uint8_t flags_end, uint8_t *out);
+
+#endif
@@ -0,0 +1,902 @@
+/*
+ * BLAKE3, following the structure of the reference C implementation.
+ *
+ * Inputs are split into 1 KiB chunks, which are the leaves of a binary
+ * tree. Large updates hash whole subtrees at once: the SIMD implementations
+ * compress up to 16 chunks (or parent nodes) in parallel, and subtrees can
+ * additionally be spread across threads.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "blake3.h"
+#include "core.h"
+#include "crypto_generichash_blake3.h"
+#include "private/common.h"
+#include "private/executor.h"
+#include "private/implementations.h"
+#include "private/stats.h"
+#include "randombytes.h"
+#include "runtime.h"
+#include "utils.h"
+
+/* Subtrees smaller than this are not worth a thread */
+#define BLAKE3_PARALLEL_MIN_BYTES (128U * 1024U)
+#define BLAKE3_THREADS_MAX        64U
+
+typedef struct blake3_chunk_state {
+    uint32_t cv[8];
+    uint64_t chunk_counter;
+    uint8_t  buf[BLAKE3_BLOCK_LEN];
+    uint8_t  buf_len;
+    uint8_t  blocks_compressed;
+    uint8_t  flags;
+} blake3_chunk_state;
+
+typedef struct blake3_hasher {
+    uint32_t           key[8];
+    blake3_chunk_state chunk;
+    uint8_t            cv_stack_len;
+    /* one more entry than the maximum depth, for the lazy merge */
+    uint8_t            cv_stack[(BLAKE3_MAX_DEPTH + 1) * BLAKE3_OUT_LEN];
+} blake3_hasher;
+
+typedef struct blake3_output {
+    uint32_t input_cv[8];
+    uint64_t counter;
+    uint8_t  block[BLAKE3_BLOCK_LEN];
+    uint8_t  block_len;
+    uint8_t  flags;
+} blake3_output;
+
+static const uint32_t blake3_IV[8] = { 0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL,
+                                       0xA54FF53AUL, 0x510E527FUL, 0x9B05688CUL,
+                                       0x1F83D9ABUL, 0x5BE0CD19UL };
+
+static const uint8_t blake3_schedule[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 }
+};
+
+static blake3_hash_lanes_fn blake3_hash16 = NULL;
+static blake3_hash_lanes_fn blake3_hash8  = NULL;
+static blake3_hash_lanes_fn blake3_hash4  = NULL;
+static size_t               blake3_simd_degree = 1U;
+
+#define G(a, b, c, d, x, y)              \
+    do {                                 \
+        a = a + b + (x);                 \
+        d = ROTR32(d ^ a, 16);           \
+        c = c + d;                       \
+        b = ROTR32(b ^ c, 12);           \
+        a = a + b + (y);                 \
+        d = ROTR32(d ^ a, 8);            \
+        c = c + d;                       \
+        b = ROTR32(b ^ c, 7);            \
+    } while (0)
+
+static void
+blake3_compress_pre(uint32_t v[16], const uint32_t cv[8], const uint8_t block[BLAKE3_BLOCK_LEN],
+                    const uint8_t block_len, const uint64_t counter, const uint8_t flags)
+{
+    uint32_t       m[16];
+    const uint8_t *s;
+    int            i;
+
+    for (i = 0; i < 16; i++) {
+        m[i] = LOAD32_LE(block + 4 * i);
+    }
+    memcpy(v, cv, 8 * sizeof v[0]);
+    v[8]  = blake3_IV[0];
+    v[9]  = blake3_IV[1];
+    v[10] = blake3_IV[2];
+    v[11] = blake3_IV[3];
+    v[12] = (uint32_t) counter;
+    v[13] = (uint32_t) (counter >> 32);
+    v[14] = (uint32_t) block_len;
+    v[15] = (uint32_t) flags;
+    for (i = 0; i < 7; i++) {
+        s = blake3_schedule[i];
+        G(v[0], v[4], v[8], v[12], m[s[0]], m[s[1]]);
+        G(v[1], v[5], v[9], v[13], m[s[2]], m[s[3]]);
+        G(v[2], v[6], v[10], v[14], m[s[4]], m[s[5]]);
+        G(v[3], v[7], v[11], v[15], m[s[6]], m[s[7]]);
+        G(v[0], v[5], v[10], v[15], m[s[8]], m[s[9]]);
+        G(v[1], v[6], v[11], v[12], m[s[10]], m[s[11]]);
+        G(v[2], v[7], v[8], v[13], m[s[12]], m[s[13]]);
+        G(v[3], v[4], v[9], v[14], m[s[14]], m[s[15]]);
+    }
+}
+
+#undef G
+
+static void
+blake3_compress_in_place(uint32_t cv[8], const uint8_t block[BLAKE3_BLOCK_LEN],
+                         const uint8_t block_len, const uint64_t counter, const uint8_t flags)
+{
+    uint32_t v[16];
+    int      i;
+
+    blake3_compress_pre(v, cv, block, block_len, counter, flags);
+    for (i = 0; i < 8; i++) {
+        cv[i] = v[i] ^ v[i + 8];
+    }
+}
+
+static void
+blake3_compress_xof(const uint32_t cv[8], const uint8_t block[BLAKE3_BLOCK_LEN],
+                    const uint8_t block_len, const uint64_t counter, const uint8_t flags,
+                    uint8_t out[64])
+{
+    uint32_t v[16];
+    int      i;
+
+    blake3_compress_pre(v, cv, block, block_len, counter, flags);
+    for (i = 0; i < 8; i++) {
+        STORE32_LE(out + 4 * i, v[i] ^ v[i + 8]);
+        STORE32_LE(out + 32 + 4 * i, v[i + 8] ^ cv[i]);
+    }
+}
+
+static void
+blake3_load_key_words(uint32_t key_words[8], const uint8_t key[BLAKE3_KEY_LEN])
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        key_words[i] = LOAD32_LE(key + 4 * i);
+    }
+}
+
+static void
+blake3_store_cv_words(uint8_t out[BLAKE3_OUT_LEN], const uint32_t cv[8])
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        STORE32_LE(out + 4 * i, cv[i]);
+    }
+}
+
+static void
+blake3_hash_one(const uint8_t *input, size_t blocks, const uint32_t key[8], uint64_t counter,
+                uint8_t flags, uint8_t flags_start, uint8_t flags_end,
+                uint8_t out[BLAKE3_OUT_LEN])
+{
+    uint32_t cv[8];
+    uint8_t  block_flags = (uint8_t) (flags | flags_start);
+
+    memcpy(cv, key, sizeof cv);
+    while (blocks > 0) {
+        if (blocks == 1) {
+            block_flags |= flags_end;
+        }
+        blake3_compress_in_place(cv, input, BLAKE3_BLOCK_LEN, counter, block_flags);
+        input += BLAKE3_BLOCK_LEN;
+        blocks--;
+        block_flags = flags;
+    }
+    blake3_store_cv_words(out, cv);
+}
+
+static void
+blake3_hash_many(const uint8_t *const *inputs, size_t num_inputs, size_t blocks,
+                 const uint32_t key[8], uint64_t counter, int increment_counter,
+                 uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out)
+{
+    const blake3_hash_lanes_fn kernels[3] = { blake3_hash16, blake3_hash8, blake3_hash4 };
+    size_t                     lanes = 16U;
+    size_t                     k;
+
+    for (k = 0; k < sizeof kernels / sizeof kernels[0]; k++, lanes /= 2U) {
+        if (kernels[k] == NULL) {
+            continue;
+        }
+        while (num_inputs >= lanes) {
+            kernels[k](inputs, blocks, key, counter, increment_counter, flags, flags_start,
+                       flags_end, out);
+            if (increment_counter) {
+                counter += lanes;
+            }
+            inputs += lanes;
+            num_inputs -= lanes;
+            out += lanes * BLAKE3_OUT_LEN;
+        }
+    }
+    while (num_inputs > 0) {
+        blake3_hash_one(inputs[0], blocks, key, counter, flags, flags_start, flags_end, out);
+        if (increment_counter) {
+            counter++;
+        }
+        inputs++;
+        num_inputs--;
+        out += BLAKE3_OUT_LEN;
+    }
+}
+
+static void
+blake3_chunk_state_init(blake3_chunk_state *self, const uint32_t key[8], uint8_t flags)
+{
+    memcpy(self->cv, key, sizeof self->cv);
+    self->chunk_counter = 0;
+    memset(self->buf, 0, sizeof self->buf);
+    self->buf_len           = 0;
+    self->blocks_compressed = 0;
+    self->flags             = flags;
+}
+
+static void
+blake3_chunk_state_reset(blake3_chunk_state *self, const uint32_t key[8],
+                         uint64_t chunk_counter)
+{
+    memcpy(self->cv, key, sizeof self->cv);
+    self->chunk_counter = chunk_counter;
+    self->blocks_compressed = 0;
+    memset(self->buf, 0, sizeof self->buf);
+    self->buf_len = 0;
+}
+
+static size_t
+blake3_chunk_state_len(const blake3_chunk_state *self)
+{
+    return BLAKE3_BLOCK_LEN * (size_t) self->blocks_compressed + (size_t) self->buf_len;
+}
+
+static uint8_t
+blake3_chunk_state_start_flag(const blake3_chunk_state *self)
+{
+    return self->blocks_compressed == 0 ? BLAKE3_CHUNK_START : 0;
+}
+
+static size_t
+blake3_chunk_state_fill_buf(blake3_chunk_state *self, const uint8_t *input, size_t input_len)
+{
+    size_t take = BLAKE3_BLOCK_LEN - (size_t) self->buf_len;
+
+    if (take > input_len) {
+        take = input_len;
+    }
+    memcpy(&self->buf[self->buf_len], input, take);
+    self->buf_len += (uint8_t) take;
+
+    return take;
+}
+
+static void
+blake3_chunk_state_update(blake3_chunk_state *self, const uint8_t *input, size_t input_len)
+{
+    size_t take;
+
+    if (self->buf_len > 0) {
+        take = blake3_chunk_state_fill_buf(self, input, input_len);
+        input += take;
+        input_len -= take;
+        if (input_len > 0) {
+            blake3_compress_in_place(self->cv, self->buf, BLAKE3_BLOCK_LEN,
+                                     self->chunk_counter,
+                                     self->flags | blake3_chunk_state_start_flag(self));
+            self->blocks_compressed++;
+            self->buf_len = 0;
+            memset(self->buf, 0, sizeof self->buf);
+        }
+    }
+    while (input_len > BLAKE3_BLOCK_LEN) {
+        blake3_compress_in_place(self->cv, input, BLAKE3_BLOCK_LEN, self->chunk_counter,
+                                 self->flags | blake3_chunk_state_start_flag(self));
+        self->blocks_compressed++;
+        input += BLAKE3_BLOCK_LEN;
+        input_len -= BLAKE3_BLOCK_LEN;
+    }
+    blake3_chunk_state_fill_buf(self, input, input_len);
+}
+
+static blake3_output
+blake3_make_output(const uint32_t input_cv[8], const uint8_t block[BLAKE3_BLOCK_LEN],
+                   uint8_t block_len, uint64_t counter, uint8_t flags)
+{
+    blake3_output ret;
+
+    memcpy(ret.input_cv, input_cv, sizeof ret.input_cv);
+    memcpy(ret.block, block, BLAKE3_BLOCK_LEN);
+    ret.block_len = block_len;
+    ret.counter   = counter;
+    ret.flags     = flags;
+
+    return ret;
+}
+
+static blake3_output
+blake3_chunk_state_output(const blake3_chunk_state *self)
+{
+    const uint8_t block_flags =
+        (uint8_t) (self->flags | blake3_chunk_state_start_flag(self) | BLAKE3_CHUNK_END);
+
+    return blake3_make_output(self->cv, self->buf, self->buf_len, self->chunk_counter,
+                              block_flags);
+}
+
+static blake3_output
+blake3_parent_output(const uint8_t block[BLAKE3_BLOCK_LEN], const uint32_t key[8],
+                     uint8_t flags)
+{
+    return blake3_make_output(key, block, BLAKE3_BLOCK_LEN, 0, flags | BLAKE3_PARENT);
+}
+
+static void
+blake3_output_chaining_value(const blake3_output *self, uint8_t cv[BLAKE3_OUT_LEN])
+{
+    uint32_t cv_words[8];
+
+    memcpy(cv_words, self->input_cv, sizeof cv_words);
+    blake3_compress_in_place(cv_words, self->block, self->block_len, self->counter,
+                             self->flags);
+    blake3_store_cv_words(cv, cv_words);
+}
+
+static void
+blake3_output_root_bytes(const blake3_output *self, uint64_t seek, uint8_t *out,
+                         size_t out_len)
+{
+    uint8_t  wide_buf[64];
+    uint64_t output_block_counter = seek / 64;
+    size_t   offset_within_block  = (size_t) (seek % 64);
+    size_t   available;
+
+    while (out_len > 0) {
+        blake3_compress_xof(self->input_cv, self->block, self->block_len,
+                            output_block_counter, self->flags | BLAKE3_ROOT, wide_buf);
+        available = 64 - offset_within_block;
+        if (available > out_len) {
+            available = out_len;
+        }
+        memcpy(out, wide_buf + offset_within_block, available);
+        out += available;
+        out_len -= available;
+        output_block_counter++;
+        offset_within_block = 0;
+    }
+    sodium_memzero(wide_buf, sizeof wide_buf);
+}
+
+/* Hashes up to simd_degree chunks at once, plus a partial chunk */
+static size_t
+blake3_compress_chunks_parallel(const uint8_t *input, size_t input_len, const uint32_t key[8],
+                                uint64_t chunk_counter, uint8_t flags, uint8_t *out)
+{
+    const uint8_t     *chunks_array[BLAKE3_MAX_SIMD_DEGREE];
+    blake3_chunk_state chunk_state;
+    blake3_output      output;
+    size_t             input_position   = 0;
+    size_t             chunks_array_len = 0;
+
+    while (input_len - input_position >= BLAKE3_CHUNK_LEN) {
+        chunks_array[chunks_array_len++] = &input[input_position];
+        input_position += BLAKE3_CHUNK_LEN;
+    }
+    blake3_hash_many(chunks_array, chunks_array_len, BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN, key,
+                     chunk_counter, 1, flags, BLAKE3_CHUNK_START, BLAKE3_CHUNK_END, out);
+    if (input_len > input_position) {
+        blake3_chunk_state_init(&chunk_state, key, flags);
+        chunk_state.chunk_counter = chunk_counter + (uint64_t) chunks_array_len;
+        blake3_chunk_state_update(&chunk_state, &input[input_position],
+                                  input_len - input_position);
+        output = blake3_chunk_state_output(&chunk_state);
+        blake3_output_chaining_value(&output, &out[chunks_array_len * BLAKE3_OUT_LEN]);
+        return chunks_array_len + 1;
+    }
+    return chunks_array_len;
+}
+
+/* Hashes pairs of chaining values into parents; an odd one is passed through */
+static size_t
+blake3_compress_parents_parallel(const uint8_t *child_chaining_values,
+                                 size_t num_chaining_values, const uint32_t key[8],
+                                 uint8_t flags, uint8_t *out)
+{
+    const uint8_t *parents_array[BLAKE3_MAX_SIMD_DEGREE];
+    size_t         parents_array_len = 0;
+
+    while (num_chaining_values - (2 * parents_array_len) >= 2) {
+        parents_array[parents_array_len] =
+            &child_chaining_values[2 * parents_array_len * BLAKE3_OUT_LEN];
+        parents_array_len++;
+    }
+    blake3_hash_many(parents_array, parents_array_len, 1, key, 0, 0, flags | BLAKE3_PARENT,
+                     0, 0, out);
+    if (num_chaining_values > 2 * parents_array_len) {
+        memcpy(&out[parents_array_len * BLAKE3_OUT_LEN],
+               &child_chaining_values[2 * parents_array_len * BLAKE3_OUT_LEN],
+               BLAKE3_OUT_LEN);
+        return parents_array_len + 1;
+    }
+    return parents_array_len;
+}
+
+static unsigned int
+blake3_popcount64(uint64_t x)
+{
+    unsigned int count = 0;
+
+    while (x != 0) {
+        x &= x - 1;
+        count++;
+    }
+    return count;
+}
+
+static size_t
+blake3_round_down_to_power_of_2(size_t x)
+{
+    size_t p = 1;
+
+    while (p <= x / 2) {
+        p *= 2;
+    }
+    return p;
+}
+
+/* Number of bytes in the left subtree: the largest power-of-2 number of chunks */
+static size_t
+blake3_left_len(size_t content_len)
+{
+    const size_t full_chunks = (content_len - 1) / BLAKE3_CHUNK_LEN;
+
+    return blake3_round_down_to_power_of_2(full_chunks) * BLAKE3_CHUNK_LEN;
+}
+
+static size_t blake3_compress_subtree_wide(const uint8_t *input, size_t input_len,
+                                           const uint32_t key[8], uint64_t chunk_counter,
+                                           uint8_t flags, uint8_t *out, unsigned int threads);
+
+typedef struct blake3_subtree_job {
+    const uint8_t  *input;
+    size_t          input_len;
+    const uint32_t *key;
+    uint64_t        chunk_counter;
+    uint8_t        *out;
+    size_t          num_chaining_values;
+    unsigned int    threads;
+    uint8_t         flags;
+} blake3_subtree_job;
+
+static void
+blake3_subtree_task(void *job_)
+{
+    blake3_subtree_job *job = (blake3_subtree_job *) job_;
+
+    job->num_chaining_values =
+        blake3_compress_subtree_wide(job->input, job->input_len, job->key, job->chunk_counter,
+                                     job->flags, job->out, job->threads);
+}
+
+/*
+ * Hashes a subtree whose number of chunks is a power of 2 (except possibly
+ * for the rightmost one), writing between 2 and simd_degree chaining values
+ * to out, so that the SIMD parents compression stays busy. With more than
+ * one thread, the right half is handed to the executor.
+ */
+static size_t
+blake3_compress_subtree_wide(const uint8_t *input, size_t input_len, const uint32_t key[8],
+                             uint64_t chunk_counter, uint8_t flags, uint8_t *out,
+                             unsigned int threads)
+{
+    uint8_t  cv_array[2 * BLAKE3_MAX_SIMD_DEGREE * BLAKE3_OUT_LEN];
+    uint8_t *right_cvs;
+    size_t   degree;
+    size_t   left_input_len, right_input_len;
+    size_t   left_n, right_n;
+    uint64_t right_chunk_counter;
+
+    if (input_len <= blake3_simd_degree * BLAKE3_CHUNK_LEN) {
+        return blake3_compress_chunks_parallel(input, input_len, key, chunk_counter, flags,
+                                               out);
+    }
+    left_input_len      = blake3_left_len(input_len);
+    right_input_len     = input_len - left_input_len;
+    right_chunk_counter = chunk_counter + (uint64_t) (left_input_len / BLAKE3_CHUNK_LEN);
+
+    /* with a single lane, keep at least 2 chaining values on the left */
+    degree = blake3_simd_degree;
+    if (left_input_len > BLAKE3_CHUNK_LEN && degree == 1) {
+        degree = 2;
+    }
+    right_cvs = &cv_array[degree * BLAKE3_OUT_LEN];
+
+    if (threads > 1U && right_input_len >= BLAKE3_PARALLEL_MIN_BYTES) {
+        blake3_subtree_job   job;
+        sodium_executor_task task;
+
+        job.input         = input + left_input_len;
+        job.input_len     = right_input_len;
+        job.key           = key;
+        job.chunk_counter = right_chunk_counter;
+        job.out           = right_cvs;
+        job.threads       = threads / 2U;
+        job.flags         = flags;
+        _sodium_executor_start(&task, blake3_subtree_task, &job);
+        left_n = blake3_compress_subtree_wide(input, left_input_len, key, chunk_counter, flags,
+                                              cv_array, threads - threads / 2U);
+        _sodium_executor_finish(&task);
+        right_n = job.num_chaining_values;
+    } else {
+        left_n  = blake3_compress_subtree_wide(input, left_input_len, key, chunk_counter,
+                                               flags, cv_array, 1U);
+        right_n = blake3_compress_subtree_wide(input + left_input_len, right_input_len, key,
+                                               right_chunk_counter, flags, right_cvs, 1U);
+    }
+    if (left_n == 1) {
+        memcpy(out, cv_array, 2 * BLAKE3_OUT_LEN);
+        return 2;
+    }
+    return blake3_compress_parents_parallel(cv_array, left_n + right_n, key, flags, out);
+}
+
+/* Reduces a subtree of more than one chunk to the two children of its root */
+static void
+blake3_compress_subtree_to_parent_node(const uint8_t *input, size_t input_len,
+                                       const uint32_t key[8], uint64_t chunk_counter,
+                                       uint8_t flags, uint8_t out[2 * BLAKE3_OUT_LEN],
+                                       unsigned int threads)
+{
+    uint8_t cv_array[BLAKE3_MAX_SIMD_DEGREE * BLAKE3_OUT_LEN];
+    uint8_t out_array[BLAKE3_MAX_SIMD_DEGREE * BLAKE3_OUT_LEN / 2];
+    size_t  num_cvs;
+
+    num_cvs = blake3_compress_subtree_wide(input, input_len, key, chunk_counter, flags,
+                                           cv_array, threads);
+    while (num_cvs > 2) {
+        num_cvs = blake3_compress_parents_parallel(cv_array, num_cvs, key, flags, out_array);
+        memcpy(cv_array, out_array, num_cvs * BLAKE3_OUT_LEN);
+    }
+    memcpy(out, cv_array, 2 * BLAKE3_OUT_LEN);
+}
+
+static void
+blake3_hasher_init_base(blake3_hasher *self, const uint32_t key[8], uint8_t flags)
+{
+    memcpy(self->key, key, sizeof self->key);
+    blake3_chunk_state_init(&self->chunk, key, flags);
+    self->cv_stack_len = 0;
+}
+
+/*
+ * Merges completed subtrees, so that the stack holds one chaining value per
+ * 1 bit in total_len (in chunks). The merge is lazy: the last chaining value
+ * is kept until more input arrives, since it might be the root.
+ */
+static void
+blake3_hasher_merge_cv_stack(blake3_hasher *self, uint64_t total_len)
+{
+    const size_t  post_merge_stack_len = (size_t) blake3_popcount64(total_len);
+    uint8_t      *parent_node;
+    blake3_output output;
+
+    while (self->cv_stack_len > post_merge_stack_len) {
+        parent_node = &self->cv_stack[(self->cv_stack_len - 2) * BLAKE3_OUT_LEN];
+        output      = blake3_parent_output(parent_node, self->key, self->chunk.flags);
+        blake3_output_chaining_value(&output, parent_node);
+        self->cv_stack_len--;
+    }
+}
+
+static void
+blake3_hasher_push_cv(blake3_hasher *self, const uint8_t new_cv[BLAKE3_OUT_LEN],
+                      uint64_t chunk_counter)
+{
+    blake3_hasher_merge_cv_stack(self, chunk_counter);
+    memcpy(&self->cv_stack[self->cv_stack_len * BLAKE3_OUT_LEN], new_cv, BLAKE3_OUT_LEN);
+    self->cv_stack_len++;
+}
+
+static void
+blake3_hasher_update(blake3_hasher *self, const uint8_t *input, size_t input_len,
+                     unsigned int threads)
+{
+    blake3_chunk_state chunk_state;
+    blake3_output      output;
+    uint8_t            chunk_cv[BLAKE3_OUT_LEN];
+    uint8_t            cv_pair[2 * BLAKE3_OUT_LEN];
+    uint64_t           count_so_far;
+    size_t             subtree_len;
+    size_t             take;
+    uint64_t           subtree_chunks;
+
+    if (input_len == 0) {
+        return;
+    }
+    /* finish the current chunk */
+    if (blake3_chunk_state_len(&self->chunk) > 0) {
+        take = BLAKE3_CHUNK_LEN - blake3_chunk_state_len(&self->chunk);
+        if (take > input_len) {
+            take = input_len;
+        }
+        blake3_chunk_state_update(&self->chunk, input, take);
+        input += take;
+        input_len -= take;
+        if (input_len == 0) {
+            return;
+        }
+        output = blake3_chunk_state_output(&self->chunk);
+        blake3_output_chaining_value(&output, chunk_cv);
+        blake3_hasher_push_cv(self, chunk_cv, self->chunk.chunk_counter);
+        blake3_chunk_state_reset(&self->chunk, self->key, self->chunk.chunk_counter + 1);
+    }
+    /* hash the largest complete subtrees that the tree structure allows */
+    while (input_len > BLAKE3_CHUNK_LEN) {
+        subtree_len  = blake3_round_down_to_power_of_2(input_len);
+        count_so_far = self->chunk.chunk_counter * BLAKE3_CHUNK_LEN;
+        while ((((uint64_t) (subtree_len - 1)) & count_so_far) != 0) {
+            subtree_len /= 2;
+        }
+        subtree_chunks = (uint64_t) (subtree_len / BLAKE3_CHUNK_LEN);
+        if (subtree_len <= BLAKE3_CHUNK_LEN) {
+            blake3_chunk_state_init(&chunk_state, self->key, self->chunk.flags);
+            chunk_state.chunk_counter = self->chunk.chunk_counter;
+            blake3_chunk_state_update(&chunk_state, input, subtree_len);
+            output = blake3_chunk_state_output(&chunk_state);
+            blake3_output_chaining_value(&output, chunk_cv);
+            blake3_hasher_push_cv(self, chunk_cv, chunk_state.chunk_counter);
+        } else {
+            blake3_compress_subtree_to_parent_node(input, subtree_len, self->key,
+                                                   self->chunk.chunk_counter,
+                                                   self->chunk.flags, cv_pair, threads);
+            blake3_hasher_push_cv(self, cv_pair, self->chunk.chunk_counter);
+            blake3_hasher_push_cv(self, &cv_pair[BLAKE3_OUT_LEN],
+                                  self->chunk.chunk_counter + (subtree_chunks / 2));
+        }
+        self->chunk.chunk_counter += subtree_chunks;
+        input += subtree_len;
+        input_len -= subtree_len;
+    }
+    /* keep the remainder (at most one chunk) in the chunk state */
+    if (input_len > 0) {
+        blake3_chunk_state_update(&self->chunk, input, input_len);
+        blake3_hasher_merge_cv_stack(self, self->chunk.chunk_counter);
+    }
+}
+
+static void
+blake3_hasher_finalize_seek(const blake3_hasher *self, uint64_t seek, uint8_t *out,
+                            size_t out_len)
+{
+    uint8_t       parent_block[BLAKE3_BLOCK_LEN];
+    blake3_output output;
+    size_t        cvs_remaining;
+
+    if (out_len == 0) {
+        return;
+    }
+    if (self->cv_stack_len == 0) {
+        output = blake3_chunk_state_output(&self->chunk);
+        blake3_output_root_bytes(&output, seek, out, out_len);
+        return;
+    }
+    if (blake3_chunk_state_len(&self->chunk) > 0) {
+        cvs_remaining = self->cv_stack_len;
+        output        = blake3_chunk_state_output(&self->chunk);
+    } else {
+        /* there are at least 2 entries: the last chunk was merged lazily */
+        cvs_remaining = (size_t) self->cv_stack_len - 2;
+        output = blake3_parent_output(&self->cv_stack[cvs_remaining * BLAKE3_OUT_LEN],
+                                      self->key, self->chunk.flags);
+    }
+    while (cvs_remaining > 0) {
+        cvs_remaining--;
+        memcpy(parent_block, &self->cv_stack[cvs_remaining * BLAKE3_OUT_LEN], BLAKE3_OUT_LEN);
+        blake3_output_chaining_value(&output, &parent_block[BLAKE3_OUT_LEN]);
+        output = blake3_parent_output(parent_block, self->key, self->chunk.flags);
+    }
+    blake3_output_root_bytes(&output, seek, out, out_len);
+    sodium_memzero(&output, sizeof output);
+}
+
+static int
+blake3_update_threads(crypto_generichash_blake3_state *state, const unsigned char *in,
+                      unsigned long long inlen, unsigned int threads)
+{
+    blake3_hasher *self = (blake3_hasher *) (void *) state;
+    size_t         n;
+
+    if (threads > BLAKE3_THREADS_MAX) {
+        threads = BLAKE3_THREADS_MAX;
+    }
+    threads = _sodium_executor_threads(threads);
+    while (inlen > 0U) {
+        n = inlen > (unsigned long long) SIZE_MAX ? SIZE_MAX : (size_t) inlen;
+        blake3_hasher_update(self, in, n, threads);
+        in += n;
+        inlen -= n;
+    }
+    return 0;
+}
+
+int
+crypto_generichash_blake3_init(crypto_generichash_blake3_state *state,
+                               const unsigned char *key, size_t keylen)
+{
+    blake3_hasher *self = (blake3_hasher *) (void *) state;
+    uint32_t       key_words[8];
+
+    COMPILER_ASSERT(sizeof(crypto_generichash_blake3_state) >= sizeof(blake3_hasher));
+    if (keylen == 0U) {
+        blake3_hasher_init_base(self, blake3_IV, 0);
+        return 0;
+    }
+    if (key == NULL || keylen != crypto_generichash_blake3_KEYBYTES) {
+        return -1;
+    }
+    blake3_load_key_words(key_words, key);
+    blake3_hasher_init_base(self, key_words, BLAKE3_KEYED_HASH);
+    sodium_memzero(key_words, sizeof key_words);
+
+    return 0;
+}
+
+int
+crypto_generichash_blake3_init_derive_key(crypto_generichash_blake3_state *state,
+                                          const char *context)
+{
+    blake3_hasher *self = (blake3_hasher *) (void *) state;
+    uint8_t        context_key[BLAKE3_KEY_LEN];
+    uint32_t       context_key_words[8];
+
+    blake3_hasher_init_base(self, blake3_IV, BLAKE3_DERIVE_KEY_CONTEXT);
+    blake3_hasher_update(self, (const uint8_t *) context, strlen(context), 1U);
+    blake3_hasher_finalize_seek(self, 0, context_key, sizeof context_key);
+    blake3_load_key_words(context_key_words, context_key);
+    blake3_hasher_init_base(self, context_key_words, BLAKE3_DERIVE_KEY_MATERIAL);
+    sodium_memzero(context_key, sizeof context_key);
+    sodium_memzero(context_key_words, sizeof context_key_words);
+
+    return 0;
+}
+
+int
+crypto_generichash_blake3_update(crypto_generichash_blake3_state *state,
+                                 const unsigned char *in, unsigned long long inlen)
+{
+    return blake3_update_threads(state, in, inlen, 1U);
+}
+
+int
+crypto_generichash_blake3_update_parallel(crypto_generichash_blake3_state *state,
+                                          const unsigned char *in, unsigned long long inlen,
+                                          unsigned int threads)
+{
+    return blake3_update_threads(state, in, inlen, threads);
+}
+
+int
+crypto_generichash_blake3_final_seek(crypto_generichash_blake3_state *state, uint64_t offset,
+                                     unsigned char *out, size_t outlen)
+{
+    blake3_hasher_finalize_seek((const blake3_hasher *) (const void *) state, offset, out,
+                                outlen);
+    return 0;
+}
+
+int
+crypto_generichash_blake3_final(crypto_generichash_blake3_state *state, unsigned char *out,
+                                size_t outlen)
+{
+    return crypto_generichash_blake3_final_seek(state, 0U, out, outlen);
+}
+
+int
+crypto_generichash_blake3(unsigned char *out, size_t outlen, const unsigned char *in,
+                          unsigned long long inlen, const unsigned char *key, size_t keylen)
+{
+    crypto_generichash_blake3_state state;
+    SODIUM_STATS_START(stats_start)
+
+    if (crypto_generichash_blake3_init(&state, key, keylen) != 0) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, 0U);
+        return -1;
+    }
+    crypto_generichash_blake3_update(&state, in, inlen);
+    crypto_generichash_blake3_final(&state, out, outlen);
+    sodium_memzero(&state, sizeof state);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, inlen);
+
+    return 0;
+}
+
+int
+crypto_generichash_blake3_derive_key(unsigned char *out, size_t outlen, const char *context,
+                                     const unsigned char *ikm, size_t ikmlen)
+{
+    crypto_generichash_blake3_state state;
+
+    crypto_generichash_blake3_init_derive_key(&state, context);
+    crypto_generichash_blake3_update(&state, ikm, (unsigned long long) ikmlen);
+    crypto_generichash_blake3_final(&state, out, outlen);
+    sodium_memzero(&state, sizeof state);
+
+    return 0;
+}
+
+size_t
+crypto_generichash_blake3_bytes(void)
+{
+    return crypto_generichash_blake3_BYTES;
+}
+
+size_t
+crypto_generichash_blake3_keybytes(void)
+{
+    return crypto_generichash_blake3_KEYBYTES;
+}
+
+size_t
+crypto_generichash_blake3_statebytes(void)
+{
+    return sizeof(crypto_generichash_blake3_state);
+}
+
+void
+crypto_generichash_blake3_keygen(unsigned char k[crypto_generichash_blake3_KEYBYTES])
+{
+    randombytes_buf(k, crypto_generichash_blake3_KEYBYTES);
+}
+
+int
+_crypto_generichash_blake3_pick_best_implementation(void)
+{
+    const char *name = "ref";
+
+    blake3_hash16      = NULL;
+    blake3_hash8       = NULL;
+    blake3_hash4       = NULL;
+    blake3_simd_degree = 1U;
+/* LCOV_EXCL_START */
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_neon() && _sodium_implementation_allowed("blake3", "neon")) {
+        blake3_hash4       = blake3_hash4_neon;
+        blake3_simd_degree = 4U;
+        name               = "neon";
+    }
+#endif
+#if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_sse41() && _sodium_implementation_allowed("blake3", "sse41")) {
+        blake3_hash4       = blake3_hash4_sse41;
+        blake3_simd_degree = 4U;
+        name               = "sse41";
+    }
+#endif
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2() && _sodium_implementation_allowed("blake3", "avx2")) {
+        if (sodium_runtime_has_sse41()) {
+            blake3_hash4 = blake3_hash4_sse41;
+        }
+        blake3_hash8       = blake3_hash8_avx2;
+        blake3_simd_degree = 8U;
+        name               = "avx2";
+    }
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors() &&
+        _sodium_implementation_allowed("blake3", "avx512f")) {
+        blake3_hash4       = blake3_hash4_sse41;
+        blake3_hash8       = blake3_hash8_avx2;
+        blake3_hash16      = blake3_hash16_avx512f;
+        blake3_simd_degree = 16U;
+        name               = "avx512f";
+    }
+#endif
+/* LCOV_EXCL_STOP */
+    if (blake3_simd_degree == 1U && !_sodium_implementation_allowed("blake3", "ref")) {
+        name = NULL;
+    }
+    _sodium_implementation_selected("blake3", name);
+
+    return 0;
+}
@@ -2,6 +2,8 @@
 #include "crypto_generichash.h"
 #include "randombytes.h"
 
+#include "private/aliases.h"
+
 size_t
 crypto_generichash_bytes_min(void)
 {
@@ -57,6 +59,7 @@ crypto_generichash(unsigned char *out, size_t outlen, const unsigned char *in,
 {
     return crypto_generichash_blake2b(out, outlen, in, inlen, key, keylen);
 }
+SODIUM_ALIAS_DEF(crypto_generichash);
 
 int
 crypto_generichash_init(crypto_generichash_state *state,
@@ -84,6 +87,13 @@ crypto_generichash_final(crypto_generichash_state *state,
         ((crypto_generichash_blake2b_state *) state, out, outlen);
 }
 
+void
+crypto_generichash_state_clone(crypto_generichash_state *dst,
+                               const crypto_generichash_state *src)
+{
+    crypto_generichash_blake2b_state_clone(dst, src);
+}
+
 void
 crypto_generichash_keygen(unsigned char k[crypto_generichash_KEYBYTES])
 {
@@ -0,0 +1,89 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "private/common.h"
+
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <arm_neon.h>
+
+# include "hash_sha256_armcrypto.h"
+
+static const uint32_t Krnd[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* Four rounds using message words W, then the schedule for W + 16. */
+# define RNDS4(W, i)                                            \
+    do {                                                        \
+        wk   = vaddq_u32((W), vld1q_u32(&Krnd[i]));             \
+        save = abcd;                                            \
+        abcd = vsha256hq_u32(abcd, efgh, wk);                   \
+        efgh = vsha256h2q_u32(efgh, save, wk);                  \
+    } while (0)
+
+# define SCHED(W0, W1, W2, W3)                                  \
+    do {                                                        \
+        W0 = vsha256su1q_u32(vsha256su0q_u32(W0, W1), W2, W3);  \
+    } while (0)
+
+static inline uint32x4_t
+load_be32x4(const unsigned char *in)
+{
+    return vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in)));
+}
+
+void
+_crypto_hash_sha256_armcrypto_transform(uint32_t state[8],
+                                        const unsigned char *in, size_t blocks)
+{
+    uint32x4_t abcd, efgh, save, abcd0, efgh0, wk;
+    uint32x4_t w0, w1, w2, w3;
+    int        i;
+
+    abcd = vld1q_u32(&state[0]);
+    efgh = vld1q_u32(&state[4]);
+
+    while (blocks-- > 0U) {
+        abcd0 = abcd;
+        efgh0 = efgh;
+        w0    = load_be32x4(in + 0);
+        w1    = load_be32x4(in + 16);
+        w2    = load_be32x4(in + 32);
+        w3    = load_be32x4(in + 48);
+
+        for (i = 0; i < 48; i += 16) {
+            RNDS4(w0, i);
+            SCHED(w0, w1, w2, w3);
+            RNDS4(w1, i + 4);
+            SCHED(w1, w2, w3, w0);
+            RNDS4(w2, i + 8);
+            SCHED(w2, w3, w0, w1);
+            RNDS4(w3, i + 12);
+            SCHED(w3, w0, w1, w2);
+        }
+        RNDS4(w0, 48);
+        RNDS4(w1, 52);
+        RNDS4(w2, 56);
+        RNDS4(w3, 60);
+
+        abcd = vaddq_u32(abcd, abcd0);
+        efgh = vaddq_u32(efgh, efgh0);
+        in += 64;
+    }
+    vst1q_u32(&state[0], abcd);
+    vst1q_u32(&state[4], efgh);
+}
+
+#endif
@@ -0,0 +1,191 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx")
+#  pragma GCC target("avx2")
+#  pragma GCC target("bmi2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# include "hash_sha256_avx2.h"
+
+static const uint32_t Krnd[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+ * The message schedules of two consecutive blocks are computed together,
+ * one block in each 128-bit lane, four words at a time. The rounds are
+ * serial and stay scalar; with BMI2, rotations compile to RORX.
+ */
+
+# define Ch(x, y, z) ((x & (y ^ z)) ^ z)
+# define Maj(x, y, z) ((x & (y | z)) | (y & z))
+# define S0(x) (ROTR32(x, 2) ^ ROTR32(x, 13) ^ ROTR32(x, 22))
+# define S1(x) (ROTR32(x, 6) ^ ROTR32(x, 11) ^ ROTR32(x, 25))
+
+# define RND(a, b, c, d, e, f, g, h, wk) \
+    h += S1(e) + Ch(e, f, g) + (wk);     \
+    d += h;                              \
+    h += S0(a) + Maj(a, b, c);
+
+# define RNDr(S, WK, i, ii)                                                 \
+    RND(S[(64 - i) % 8], S[(65 - i) % 8], S[(66 - i) % 8], S[(67 - i) % 8], \
+        S[(68 - i) % 8], S[(69 - i) % 8], S[(70 - i) % 8], S[(71 - i) % 8], \
+        WK[i + ii])
+
+# define ROTR32V(x, n)                            \
+    _mm256_or_si256(_mm256_srli_epi32((x), (n)), \
+                    _mm256_slli_epi32((x), 32 - (n)))
+# define s0V(x)                                                           \
+    _mm256_xor_si256(_mm256_xor_si256(ROTR32V((x), 7), ROTR32V((x), 18)), \
+                     _mm256_srli_epi32((x), 3))
+# define s1V(x)                                                            \
+    _mm256_xor_si256(_mm256_xor_si256(ROTR32V((x), 17), ROTR32V((x), 19)), \
+                     _mm256_srli_epi32((x), 10))
+
+/* W[t..t+3] from W[t-16..t-13] (X0), ... W[t-4..t-1] (X3), in each lane */
+static inline __m256i
+sched4(const __m256i X0, const __m256i X1, const __m256i X2, const __m256i X3)
+{
+    const __m256i w15 = _mm256_alignr_epi8(X1, X0, 4);
+    const __m256i w7  = _mm256_alignr_epi8(X3, X2, 4);
+    __m256i       t, lo, hi;
+
+    t  = _mm256_add_epi32(_mm256_add_epi32(X0, w7), s0V(w15));
+    /* W[t] and W[t+1] depend on W[t-2] and W[t-1] */
+    lo = _mm256_add_epi32(t, s1V(_mm256_shuffle_epi32(X3, 0xee)));
+    /* W[t+2] and W[t+3] depend on the words that were just computed */
+    hi = _mm256_add_epi32(t, s1V(_mm256_shuffle_epi32(lo, 0x44)));
+
+    return _mm256_blend_epi32(lo, hi, 0xcc);
+}
+
+# define STOREWK(X, i)                                             \
+    do {                                                           \
+        const __m256i wk_ = _mm256_add_epi32(                      \
+            (X), _mm256_broadcastsi128_si256(_mm_loadu_si128(      \
+                     (const __m128i *) (const void *) &Krnd[i]))); \
+        _mm_store_si128((__m128i *) (void *) &WKA[i],              \
+                        _mm256_castsi256_si128(wk_));              \
+        _mm_store_si128((__m128i *) (void *) &WKB[i],              \
+                        _mm256_extracti128_si256(wk_, 1));         \
+    } while (0)
+
+# define LOADW(X, i)                                                   \
+    do {                                                               \
+        X = _mm256_shuffle_epi8(                                       \
+            _mm256_inserti128_si256(                                   \
+                _mm256_castsi128_si256(_mm_loadu_si128(                \
+                    (const __m128i *) (const void *) (in + (i) * 4))), \
+                _mm_loadu_si128(                                       \
+                    (const __m128i *) (const void *) (in2 + (i) * 4)), \
+                1),                                                    \
+            bswap);                                                    \
+        STOREWK(X, i);                                                 \
+    } while (0)
+
+# define SCHED(X0, X1, X2, X3, i)    \
+    do {                             \
+        X0 = sched4(X0, X1, X2, X3); \
+        STOREWK(X0, i);              \
+    } while (0)
+
+# define RNDS16(WK, i)      \
+    do {                    \
+        RNDr(S, WK, 0, i);  \
+        RNDr(S, WK, 1, i);  \
+        RNDr(S, WK, 2, i);  \
+        RNDr(S, WK, 3, i);  \
+        RNDr(S, WK, 4, i);  \
+        RNDr(S, WK, 5, i);  \
+        RNDr(S, WK, 6, i);  \
+        RNDr(S, WK, 7, i);  \
+        RNDr(S, WK, 8, i);  \
+        RNDr(S, WK, 9, i);  \
+        RNDr(S, WK, 10, i); \
+        RNDr(S, WK, 11, i); \
+        RNDr(S, WK, 12, i); \
+        RNDr(S, WK, 13, i); \
+        RNDr(S, WK, 14, i); \
+        RNDr(S, WK, 15, i); \
+    } while (0)
+
+void
+_crypto_hash_sha256_avx2_transform(uint32_t state[8], const unsigned char *in,
+                                   size_t blocks)
+{
+    CRYPTO_ALIGN(16) uint32_t WKA[64];
+    CRYPTO_ALIGN(16) uint32_t WKB[64];
+    uint32_t                  S[8];
+    const __m256i             bswap =
+        _mm256_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL,
+                          0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    const unsigned char      *in2;
+    __m256i                   x0, x1, x2, x3;
+    int                       i;
+
+    while (blocks > 0U) {
+        /* With an odd number of blocks, the last schedule is computed twice */
+        in2 = (blocks > 1U) ? in + 64 : in;
+        LOADW(x0, 0);
+        LOADW(x1, 4);
+        LOADW(x2, 8);
+        LOADW(x3, 12);
+        memcpy(S, state, sizeof S);
+        for (i = 0; i < 48; i += 16) {
+            SCHED(x0, x1, x2, x3, i + 16);
+            SCHED(x1, x2, x3, x0, i + 20);
+            SCHED(x2, x3, x0, x1, i + 24);
+            SCHED(x3, x0, x1, x2, i + 28);
+            RNDS16(WKA, i);
+        }
+        RNDS16(WKA, 48);
+        for (i = 0; i < 8; i++) {
+            state[i] += S[i];
+        }
+        if (blocks == 1U) {
+            break;
+        }
+        memcpy(S, state, sizeof S);
+        for (i = 0; i < 64; i += 16) {
+            RNDS16(WKB, i);
+        }
+        for (i = 0; i < 8; i++) {
+            state[i] += S[i];
+        }
+        in += 128;
+        blocks -= 2U;
+    }
+    sodium_memzero(WKA, sizeof WKA);
+    sodium_memzero(WKB, sizeof WKB);
+    sodium_memzero(S, sizeof S);
+}
+
+#endif
@@ -35,8 +35,23 @@
 
 #include "crypto_hash_sha256.h"
 #include "private/common.h"
+#include "private/implementations.h"
+#include "private/sha256_multi.h"
+#include "private/stats.h"
+#include "runtime.h"
 #include "utils.h"
 
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# include "../avx2/hash_sha256_avx2.h"
+#endif
+#if defined(HAVE_SHAINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# include "../shani/hash_sha256_shani.h"
+#endif
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+# include "../armcrypto/hash_sha256_armcrypto.h"
+#endif
+
 static void
 be32enc_vect(unsigned char *dst, const uint32_t *src, size_t len)
 {
@@ -144,6 +159,25 @@ SHA256_Transform(uint32_t state[8], const uint8_t block[64], uint32_t W[64],
     }
 }
 
+static void
+SHA256_Transform_cp(uint32_t state[8], const unsigned char *in, size_t blocks)
+{
+    uint32_t tmp32[64 + 8];
+
+    while (blocks-- > 0U) {
+        SHA256_Transform(state, in, &tmp32[0], &tmp32[64]);
+        in += 64;
+    }
+    sodium_memzero((void *) tmp32, sizeof tmp32);
+}
+
+static void (*transform)(uint32_t state[8], const unsigned char *in,
+                         size_t blocks) = SHA256_Transform_cp;
+
+static void (*transform_multi)(sha256_multi_state *M) = NULL;
+static size_t transform_multi_lanes = 0U;
+static size_t transform_multi_min = 2U;
+
 static const uint8_t PAD[64] = { 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
                                  0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
                                  0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -151,7 +185,7 @@ static const uint8_t PAD[64] = { 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
                                  0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
 static void
-SHA256_Pad(crypto_hash_sha256_state *state, uint32_t tmp32[64 + 8])
+SHA256_Pad(crypto_hash_sha256_state *state)
 {
     unsigned int r;
     unsigned int i;
@@ -165,11 +199,11 @@ SHA256_Pad(crypto_hash_sha256_state *state, uint32_t tmp32[64 + 8])
         for (i = 0; i < 64 - r; i++) {
             state->buf[r + i] = PAD[i];
         }
-        SHA256_Transform(state->state, state->buf, &tmp32[0], &tmp32[64]);
+        transform(state->state, state->buf, 1U);
         memset(&state->buf[0], 0, 56);
     }
     STORE64_BE(&state->buf[56], state->count);
-    SHA256_Transform(state->state, state->buf, &tmp32[0], &tmp32[64]);
+    transform(state->state, state->buf, 1U);
 }
 
 int
@@ -186,11 +220,10 @@ crypto_hash_sha256_init(crypto_hash_sha256_state *state)
     return 0;
 }
 
-int
-crypto_hash_sha256_update(crypto_hash_sha256_state *state,
-                          const unsigned char *in, unsigned long long inlen)
+static int
+_hash_sha256_update(crypto_hash_sha256_state *state,
+                   const unsigned char *in, unsigned long long inlen)
 {
-    uint32_t           tmp32[64 + 8];
     unsigned long long i;
     unsigned long long r;
 
@@ -209,32 +242,40 @@ crypto_hash_sha256_update(crypto_hash_sha256_state *state,
     for (i = 0; i < 64 - r; i++) {
         state->buf[r + i] = in[i];
     }
-    SHA256_Transform(state->state, state->buf, &tmp32[0], &tmp32[64]);
+    transform(state->state, state->buf, 1U);
     in += 64 - r;
     inlen -= 64 - r;
 
-    while (inlen >= 64) {
-        SHA256_Transform(state->state, in, &tmp32[0], &tmp32[64]);
-        in += 64;
-        inlen -= 64;
+    if (inlen >= 64) {
+        transform(state->state, in, (size_t) (inlen / 64));
+        in += inlen & ~(unsigned long long) 63;
     }
     inlen &= 63;
     for (i = 0; i < inlen; i++) {
         state->buf[i] = in[i];
     }
-    sodium_memzero((void *) tmp32, sizeof tmp32);
 
     return 0;
 }
 
 int
-crypto_hash_sha256_final(crypto_hash_sha256_state *state, unsigned char *out)
+crypto_hash_sha256_update(crypto_hash_sha256_state *state,
+                          const unsigned char *in, unsigned long long inlen)
 {
-    uint32_t tmp32[64 + 8];
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = _hash_sha256_update(state, in, inlen);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, inlen);
 
-    SHA256_Pad(state, tmp32);
+    return ret;
+}
+
+int
+crypto_hash_sha256_final(crypto_hash_sha256_state *state, unsigned char *out)
+{
+    SHA256_Pad(state);
     be32enc_vect(out, state->state, 32);
-    sodium_memzero((void *) tmp32, sizeof tmp32);
     sodium_memzero((void *) state, sizeof *state);
 
     return 0;
@@ -245,10 +286,246 @@ crypto_hash_sha256(unsigned char *out, const unsigned char *in,
                    unsigned long long inlen)
 {
     crypto_hash_sha256_state state;
+    SODIUM_STATS_START(stats_start)
 
     crypto_hash_sha256_init(&state);
     crypto_hash_sha256_update(&state, in, inlen);
     crypto_hash_sha256_final(&state, out);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, inlen);
+
+    return 0;
+}
+
+#define SHA256_MULTI_NONE ((size_t) -1)
+
+typedef struct sha256_multi_lane {
+    size_t             idx;
+    unsigned long long off;
+    unsigned long long end;
+    unsigned long long total;
+    unsigned char      len[8];
+} sha256_multi_lane;
 
+static void
+_sha256_multi_lane_init(sha256_multi_state *M, sha256_multi_lane *lane,
+                        size_t l, size_t idx,
+                        const crypto_hash_sha256_state *state,
+                        unsigned long long inlen)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        M->h[i][l] = state->state[i];
+    }
+    STORE64_BE(lane->len, state->count + (((uint64_t) inlen) << 3));
+    lane->idx   = idx;
+    lane->off   = 0U;
+    lane->end   = ((state->count >> 3) & 0x3f) + inlen;
+    lane->total = (lane->end + 8U + 64U) & ~(unsigned long long) 63U;
+}
+
+/*
+ * A lane reads buf || in || padding, where buf is what the state has
+ * buffered so far. Blocks entirely within in are used in place.
+ */
+static const unsigned char *
+_sha256_multi_lane_block(unsigned char block[64],
+                         const sha256_multi_lane *lane,
+                         const crypto_hash_sha256_state *state,
+                         const unsigned char *in)
+{
+    const size_t       r = (size_t) ((state->count >> 3) & 0x3f);
+    unsigned long long n;
+    size_t             i = 0U;
+
+    if (lane->off >= r && lane->off + 64U <= lane->end) {
+        return in + (lane->off - r);
+    }
+    memset(block, 0, 64U);
+    if (lane->off < r) {
+        i = r - (size_t) lane->off;
+        memcpy(block, state->buf + lane->off, i);
+    }
+    if (lane->off + i < lane->end) {
+        n = lane->end - (lane->off + i);
+        if (n > 64U - i) {
+            n = 64U - i;
+        }
+        memcpy(block + i, in + (lane->off + i - r), (size_t) n);
+    }
+    if (lane->end >= lane->off && lane->end < lane->off + 64U) {
+        block[lane->end - lane->off] = 0x80;
+    }
+    if (lane->off + 64U == lane->total) {
+        memcpy(block + 56, lane->len, 8U);
+    }
+    return block;
+}
+
+/*
+ * Lanes are refilled with the next message as soon as they are done, so
+ * that messages of different lengths can be mixed.
+ */
+void
+_crypto_hash_sha256_final_multi(crypto_hash_sha256_state * const *states,
+                                unsigned char * const *out,
+                                const unsigned char * const *in,
+                                const unsigned long long *inlen,
+                                size_t count)
+{
+    CRYPTO_ALIGN(64) sha256_multi_state M;
+    sha256_multi_lane    lanes_[SHA256_MULTI_LANES_MAX];
+    unsigned char        block[64];
+    const unsigned char *src;
+    size_t               active = 0U;
+    size_t               next   = 0U;
+    size_t               lanes  = transform_multi_lanes;
+    size_t               idx;
+    size_t               l;
+    int                  i;
+
+    if (transform_multi == NULL || count < transform_multi_min) {
+        for (next = 0U; next < count; next++) {
+            _hash_sha256_update(states[next], in[next], inlen[next]);
+            crypto_hash_sha256_final(states[next], out[next]);
+        }
+        return;
+    }
+    memset(&M, 0, sizeof M);
+    for (l = 0U; l < lanes; l++) {
+        lanes_[l].idx = SHA256_MULTI_NONE;
+        if (next < count) {
+            _sha256_multi_lane_init(&M, &lanes_[l], l, next, states[next],
+                                    inlen[next]);
+            next++;
+            active++;
+        }
+    }
+    while (active > 0U) {
+        for (l = 0U; l < lanes; l++) {
+            if ((idx = lanes_[l].idx) == SHA256_MULTI_NONE) {
+                continue;
+            }
+            src = _sha256_multi_lane_block(block, &lanes_[l], states[idx],
+                                           in[idx]);
+            for (i = 0; i < 16; i++) {
+                M.w[i][l] = LOAD32_BE(src + i * 4);
+            }
+            lanes_[l].off += 64U;
+        }
+        transform_multi(&M);
+        for (l = 0U; l < lanes; l++) {
+            if ((idx = lanes_[l].idx) == SHA256_MULTI_NONE ||
+                lanes_[l].off != lanes_[l].total) {
+                continue;
+            }
+            for (i = 0; i < 8; i++) {
+                STORE32_BE(out[idx] + 4 * i, M.h[i][l]);
+            }
+            sodium_memzero((void *) states[idx], sizeof *states[idx]);
+            if (next < count) {
+                _sha256_multi_lane_init(&M, &lanes_[l], l, next, states[next],
+                                        inlen[next]);
+                next++;
+            } else {
+                lanes_[l].idx = SHA256_MULTI_NONE;
+                active--;
+            }
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(block, sizeof block);
+}
+
+size_t
+_crypto_hash_sha256_multi_lanes(void)
+{
+    if (transform_multi == NULL) {
+        return 1U;
+    }
+    return transform_multi_lanes;
+}
+
+void
+_crypto_hash_sha256_compress_lanes(sha256_multi_state *M, size_t count)
+{
+    uint32_t      state[8];
+    unsigned char block[64];
+    size_t        l;
+    int           i;
+
+    if (transform_multi != NULL && count >= transform_multi_min) {
+        transform_multi(M);
+        return;
+    }
+    for (l = 0U; l < count; l++) {
+        for (i = 0; i < 8; i++) {
+            state[i] = M->h[i][l];
+        }
+        for (i = 0; i < 16; i++) {
+            STORE32_BE(block + 4 * i, M->w[i][l]);
+        }
+        transform(state, block, 1U);
+        for (i = 0; i < 8; i++) {
+            M->h[i][l] = state[i];
+        }
+    }
+    sodium_memzero(state, sizeof state);
+    sodium_memzero(block, sizeof block);
+}
+
+int
+_crypto_hash_sha256_pick_best_implementation(void)
+{
+    transform = SHA256_Transform_cp;
+    transform_multi = NULL;
+    transform_multi_lanes = 0U;
+    transform_multi_min = 2U;
+    _sodium_implementation_selected("sha256", "cp");
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2()) {
+        transform_multi = _crypto_hash_sha256_transform_multi_avx2;
+        transform_multi_lanes = 8U;
+    }
+    if (sodium_runtime_has_avx2() && sodium_runtime_has_bmi2() &&
+        _sodium_implementation_allowed("sha256", "avx2")) {
+        transform = _crypto_hash_sha256_avx2_transform;
+        _sodium_implementation_selected("sha256", "avx2");
+    }
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors()) {
+        transform_multi = _crypto_hash_sha256_transform_multi_avx512f;
+        transform_multi_lanes = 16U;
+    }
+#endif
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_armsha2() &&
+        _sodium_implementation_allowed("sha256", "armcrypto")) {
+        transform = _crypto_hash_sha256_armcrypto_transform;
+        _sodium_implementation_selected("sha256", "armcrypto");
+        return 0;
+    }
+#endif
+#if defined(HAVE_SHAINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_shani() &&
+        _sodium_implementation_allowed("sha256", "shani")) {
+        transform = _crypto_hash_sha256_shani_transform;
+        _sodium_implementation_selected("sha256", "shani");
+        /*
+         * SHA-NI is faster than 8 AVX2 lanes, and only slower than 16
+         * AVX-512 lanes when they are all used.
+         */
+        if (transform_multi_lanes < 16U) {
+            transform_multi = NULL;
+            transform_multi_lanes = 0U;
+        }
+        transform_multi_min = transform_multi_lanes;
+        return 0;
+    }
+#endif
     return 0;
 }
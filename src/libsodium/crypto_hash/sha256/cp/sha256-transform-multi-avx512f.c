@@ -0,0 +1,41 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "private/sha256_multi.h"
+
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+#  pragma GCC target("avx512f")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# define VEC   __m512i
+
+# define LOADV(p)     _mm512_loadu_si512((const void *) (p))
+# define STOREV(p, r) _mm512_storeu_si512((void *) (p), r)
+# define SET1(x)      _mm512_set1_epi32((int) (x))
+# define ADD(a, b)    _mm512_add_epi32(a, b)
+# define XOR(a, b)    _mm512_xor_si512(a, b)
+# define SHR(x, n)    _mm512_srli_epi32(x, n)
+# define ROTR(x, n)   _mm512_ror_epi32(x, n)
+
+# define CH(x, y, z)  _mm512_ternarylogic_epi32(x, y, z, 0xca)
+# define MAJ(x, y, z) _mm512_ternarylogic_epi32(x, y, z, 0xe8)
+
+# define FN(name) _crypto_hash_sha256_##name##_multi_avx512f
+# include "sha256-transform-multi.h"
+
+#endif
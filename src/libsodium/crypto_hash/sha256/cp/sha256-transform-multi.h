@@ -0,0 +1,76 @@
+/*
+ * Multi-buffer SHA-256 block function: independent states and message
+ * blocks are stored word-wise, so that each vector operation processes
+ * the same word of every message. The includer defines the vector type
+ * VEC, the LOADV, STOREV, SET1, ADD, XOR, SHR and ROTR operations, as
+ * well as FN(). CH and MAJ can be overridden.
+ */
+
+#ifndef CH
+# define CH(x, y, z)  XOR(AND(XOR(y, z), x), z)
+#endif
+#ifndef MAJ
+# define MAJ(x, y, z) OR(AND(x, y), AND(z, OR(x, y)))
+#endif
+
+#define S0(x) XOR(XOR(ROTR(x, 2), ROTR(x, 13)), ROTR(x, 22))
+#define S1(x) XOR(XOR(ROTR(x, 6), ROTR(x, 11)), ROTR(x, 25))
+#define s0(x) XOR(XOR(ROTR(x, 7), ROTR(x, 18)), SHR(x, 3))
+#define s1(x) XOR(XOR(ROTR(x, 17), ROTR(x, 19)), SHR(x, 10))
+
+static const uint32_t FN(Krnd)[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+void
+FN(transform)(sha256_multi_state *M)
+{
+    VEC w[16];
+    VEC s[8];
+    VEC t0, t1;
+    int i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = LOADV(M->w[i]);
+    }
+    for (i = 0; i < 8; i++) {
+        s[i] = LOADV(M->h[i]);
+    }
+    for (i = 0; i < 64; i++) {
+        if (i >= 16) {
+            w[i & 15] = ADD(ADD(w[i & 15], s1(w[(i - 2) & 15])),
+                            ADD(w[(i - 7) & 15], s0(w[(i - 15) & 15])));
+        }
+        t0 = ADD(ADD(s[7], S1(s[4])), ADD(CH(s[4], s[5], s[6]),
+                                          ADD(w[i & 15], SET1(FN(Krnd)[i]))));
+        t1 = ADD(S0(s[0]), MAJ(s[0], s[1], s[2]));
+        s[7] = s[6];
+        s[6] = s[5];
+        s[5] = s[4];
+        s[4] = ADD(s[3], t0);
+        s[3] = s[2];
+        s[2] = s[1];
+        s[1] = s[0];
+        s[0] = ADD(t0, t1);
+    }
+    for (i = 0; i < 8; i++) {
+        STOREV(M->h[i], ADD(LOADV(M->h[i]), s[i]));
+    }
+}
+
+#undef CH
+#undef MAJ
+#undef S0
+#undef S1
+#undef s0
+#undef s1
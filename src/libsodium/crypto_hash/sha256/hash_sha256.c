@@ -1,4 +1,14 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "crypto_hash_sha256.h"
+#include "private/common.h"
+#include "private/sha256_multi.h"
+
+/* Messages whose states are set up at once, for the multi-buffer code */
+#define SHA256_MULTI_BATCH 64U
 
 size_t
 crypto_hash_sha256_bytes(void)
@@ -11,3 +21,108 @@ crypto_hash_sha256_statebytes(void)
 {
     return sizeof(crypto_hash_sha256_state);
 }
+
+int
+crypto_hash_sha256_multi(unsigned char * const *out,
+                         const unsigned char * const *in,
+                         const unsigned long long *inlen, size_t count)
+{
+    crypto_hash_sha256_state  states[SHA256_MULTI_BATCH];
+    crypto_hash_sha256_state *states_p[SHA256_MULTI_BATCH];
+    size_t                    done;
+    size_t                    n;
+    size_t                    i;
+
+    for (done = 0U; done < count; done += n) {
+        n = count - done;
+        if (n > SHA256_MULTI_BATCH) {
+            n = SHA256_MULTI_BATCH;
+        }
+        for (i = 0U; i < n; i++) {
+            crypto_hash_sha256_init(&states[i]);
+            states_p[i] = &states[i];
+        }
+        _crypto_hash_sha256_final_multi(states_p, out + done, in + done,
+                                        inlen + done, n);
+    }
+    return 0;
+}
+
+/*
+ * Hashes prefix || in[i * stride .. i * stride + len) for i < count into
+ * out[32 * i]. out can overlap with in, as long as out <= in and
+ * stride >= 32.
+ */
+static void
+sha256_merkle_level(unsigned char *out, const unsigned char *in,
+                    size_t stride, unsigned long long len, size_t count,
+                    unsigned char prefix)
+{
+    crypto_hash_sha256_state  states[SHA256_MULTI_BATCH];
+    crypto_hash_sha256_state *states_p[SHA256_MULTI_BATCH];
+    unsigned char             hashes[SHA256_MULTI_BATCH][crypto_hash_sha256_BYTES];
+    unsigned char            *out_p[SHA256_MULTI_BATCH];
+    const unsigned char      *in_p[SHA256_MULTI_BATCH];
+    unsigned long long        inlen[SHA256_MULTI_BATCH];
+    size_t                    done;
+    size_t                    n;
+    size_t                    i;
+
+    for (done = 0U; done < count; done += n) {
+        n = count - done;
+        if (n > SHA256_MULTI_BATCH) {
+            n = SHA256_MULTI_BATCH;
+        }
+        for (i = 0U; i < n; i++) {
+            crypto_hash_sha256_init(&states[i]);
+            crypto_hash_sha256_update(&states[i], &prefix, 1U);
+            states_p[i] = &states[i];
+            out_p[i]    = hashes[i];
+            in_p[i]     = in + (done + i) * stride;
+            inlen[i]    = len;
+        }
+        _crypto_hash_sha256_final_multi(states_p, out_p, in_p, inlen, n);
+        memcpy(out + done * crypto_hash_sha256_BYTES, hashes,
+               n * crypto_hash_sha256_BYTES);
+    }
+}
+
+int
+crypto_hash_sha256_merkle_root(unsigned char *out, const unsigned char *leaves,
+                               size_t n, size_t leaf_size)
+{
+    unsigned char *level;
+    size_t         count;
+    size_t         pairs;
+
+    if (n == 0U) {
+        return crypto_hash_sha256(out, NULL, 0U);
+    }
+    if (n == 1U) {
+        sha256_merkle_level(out, leaves, leaf_size, leaf_size, 1U, 0x00);
+        return 0;
+    }
+    if (n > SIZE_MAX / crypto_hash_sha256_BYTES) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if ((level = (unsigned char *) malloc(n * crypto_hash_sha256_BYTES)) == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    sha256_merkle_level(level, leaves, leaf_size, leaf_size, n, 0x00);
+    for (count = n; count > 1U; count = pairs + (count & 1U)) {
+        pairs = count / 2U;
+        sha256_merkle_level(level, level, 2U * crypto_hash_sha256_BYTES,
+                            2U * crypto_hash_sha256_BYTES, pairs, 0x01);
+        if ((count & 1U) != 0U) {
+            memmove(level + pairs * crypto_hash_sha256_BYTES,
+                    level + (count - 1U) * crypto_hash_sha256_BYTES,
+                    crypto_hash_sha256_BYTES);
+        }
+    }
+    memcpy(out, level, crypto_hash_sha256_BYTES);
+    free(level);
+
+    return 0;
+}
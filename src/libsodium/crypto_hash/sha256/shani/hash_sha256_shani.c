@@ -0,0 +1,115 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "private/common.h"
+
+#if defined(HAVE_SHAINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("sha")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# include "hash_sha256_shani.h"
+
+static const uint32_t Krnd[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+ * Four rounds using message words W. The schedule for the next group of
+ * four words is derived from the previous ones with SHA256MSG1/MSG2.
+ */
+# define RNDS4(W, i)                                                        \
+    do {                                                                    \
+        msg   = _mm_add_epi32((W), _mm_loadu_si128((const __m128i *)       \
+                                                   (const void *) &Krnd[i])); \
+        s1    = _mm_sha256rnds2_epu32(s1, s0, msg);                         \
+        msg   = _mm_shuffle_epi32(msg, 0x0e);                               \
+        s0    = _mm_sha256rnds2_epu32(s0, s1, msg);                         \
+    } while (0)
+
+# define SCHED(W0, W1, W2, W3)                                              \
+    do {                                                                    \
+        W0 = _mm_sha256msg1_epu32(W0, W1);                                  \
+        W0 = _mm_add_epi32(W0, _mm_alignr_epi8(W3, W2, 4));                 \
+        W0 = _mm_sha256msg2_epu32(W0, W3);                                  \
+    } while (0)
+
+void
+_crypto_hash_sha256_shani_transform(uint32_t state[8], const unsigned char *in,
+                                    size_t blocks)
+{
+    const __m128i bswap =
+        _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i       s0, s1, save0, save1, tmp, msg;
+    __m128i       w0, w1, w2, w3;
+    int           i;
+
+    /* ABEF and CDGH, as expected by SHA256RNDS2 */
+    tmp = _mm_loadu_si128((const __m128i *) (const void *) &state[0]);
+    s1  = _mm_loadu_si128((const __m128i *) (const void *) &state[4]);
+    tmp = _mm_shuffle_epi32(tmp, 0xb1);
+    s1  = _mm_shuffle_epi32(s1, 0x1b);
+    s0  = _mm_alignr_epi8(tmp, s1, 8);
+    s1  = _mm_blend_epi16(s1, tmp, 0xf0);
+
+    while (blocks-- > 0U) {
+        save0 = s0;
+        save1 = s1;
+        w0 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *) (const void *) (in + 0)), bswap);
+        w1 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *) (const void *) (in + 16)), bswap);
+        w2 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *) (const void *) (in + 32)), bswap);
+        w3 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *) (const void *) (in + 48)), bswap);
+
+        for (i = 0; i < 48; i += 16) {
+            RNDS4(w0, i);
+            SCHED(w0, w1, w2, w3);
+            RNDS4(w1, i + 4);
+            SCHED(w1, w2, w3, w0);
+            RNDS4(w2, i + 8);
+            SCHED(w2, w3, w0, w1);
+            RNDS4(w3, i + 12);
+            SCHED(w3, w0, w1, w2);
+        }
+        RNDS4(w0, 48);
+        RNDS4(w1, 52);
+        RNDS4(w2, 56);
+        RNDS4(w3, 60);
+
+        s0 = _mm_add_epi32(s0, save0);
+        s1 = _mm_add_epi32(s1, save1);
+        in += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(s0, 0x1b);
+    s1  = _mm_shuffle_epi32(s1, 0xb1);
+    s0  = _mm_blend_epi16(tmp, s1, 0xf0);
+    s1  = _mm_alignr_epi8(s1, tmp, 8);
+    _mm_storeu_si128((__m128i *) (void *) &state[0], s0);
+    _mm_storeu_si128((__m128i *) (void *) &state[4], s1);
+}
+
+#endif
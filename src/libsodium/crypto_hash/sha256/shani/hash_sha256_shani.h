@@ -0,0 +1,11 @@
+#ifndef hash_sha256_shani_H
+#define hash_sha256_shani_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+void _crypto_hash_sha256_shani_transform(uint32_t state[8],
+                                         const unsigned char *in,
+                                         size_t blocks);
+
+#endif /* hash_sha256_shani_H */
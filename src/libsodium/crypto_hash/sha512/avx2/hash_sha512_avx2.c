@@ -0,0 +1,183 @@
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx")
+#  pragma GCC target("avx2")
+#  pragma GCC target("bmi2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# include "hash_sha512_avx2.h"
+
+static const uint64_t Krnd[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+    0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+    0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+    0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+    0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+    0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+    0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+    0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+    0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+    0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+    0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+    0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+    0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+    0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+    0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+    0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+    0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+    0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+    0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+    0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+    0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+/*
+ * The message schedule is computed four words at a time in AVX2
+ * registers, one group of 16 words ahead of the rounds that consume it.
+ * The rounds themselves are serial and stay scalar; with BMI2, rotations
+ * compile to RORX, which doesn't clobber the flags and takes an
+ * independent destination register.
+ */
+
+# define Ch(x, y, z) ((x & (y ^ z)) ^ z)
+# define Maj(x, y, z) ((x & (y | z)) | (y & z))
+# define S0(x) (ROTR64(x, 28) ^ ROTR64(x, 34) ^ ROTR64(x, 39))
+# define S1(x) (ROTR64(x, 14) ^ ROTR64(x, 18) ^ ROTR64(x, 41))
+
+# define RND(a, b, c, d, e, f, g, h, wk) \
+    h += S1(e) + Ch(e, f, g) + (wk);     \
+    d += h;                              \
+    h += S0(a) + Maj(a, b, c);
+
+# define RNDr(S, WK, i, ii)                                                 \
+    RND(S[(80 - i) % 8], S[(81 - i) % 8], S[(82 - i) % 8], S[(83 - i) % 8], \
+        S[(84 - i) % 8], S[(85 - i) % 8], S[(86 - i) % 8], S[(87 - i) % 8], \
+        WK[i + ii])
+
+# define ROTR64V(x, n)                            \
+    _mm256_or_si256(_mm256_srli_epi64((x), (n)), \
+                    _mm256_slli_epi64((x), 64 - (n)))
+# define s0V(x)                                                          \
+    _mm256_xor_si256(_mm256_xor_si256(ROTR64V((x), 1), ROTR64V((x), 8)), \
+                     _mm256_srli_epi64((x), 7))
+# define s1V(x)                                                            \
+    _mm256_xor_si256(_mm256_xor_si256(ROTR64V((x), 19), ROTR64V((x), 61)), \
+                     _mm256_srli_epi64((x), 6))
+
+/* W[t..t+3] from W[t-16..t-13] (X0), ... W[t-4..t-1] (X3) */
+static inline __m256i
+sched4(const __m256i X0, const __m256i X1, const __m256i X2, const __m256i X3)
+{
+    const __m256i w15 =
+        _mm256_alignr_epi8(_mm256_permute2x128_si256(X0, X1, 0x21), X0, 8);
+    const __m256i w7 =
+        _mm256_alignr_epi8(_mm256_permute2x128_si256(X2, X3, 0x21), X2, 8);
+    __m256i       t, lo, hi;
+
+    t  = _mm256_add_epi64(_mm256_add_epi64(X0, w7), s0V(w15));
+    /* W[t] and W[t+1] depend on W[t-2] and W[t-1] */
+    lo = _mm256_add_epi64(t, s1V(_mm256_permute4x64_epi64(X3, 0xee)));
+    /* W[t+2] and W[t+3] depend on the words that were just computed */
+    hi = _mm256_add_epi64(t, s1V(_mm256_permute4x64_epi64(lo, 0x44)));
+
+    return _mm256_blend_epi32(lo, hi, 0xf0);
+}
+
+# define LOADW(X, i)                                                         \
+    do {                                                                     \
+        X = _mm256_shuffle_epi8(                                             \
+            _mm256_loadu_si256((const __m256i *) (const void *)              \
+                               (in + (i) * 8)), bswap);                      \
+        _mm256_store_si256((__m256i *) (void *) &WK[i],                      \
+                           _mm256_add_epi64(X, _mm256_loadu_si256(           \
+                               (const __m256i *) (const void *) &Krnd[i]))); \
+    } while (0)
+
+# define SCHED(X0, X1, X2, X3, i)                                            \
+    do {                                                                     \
+        X0 = sched4(X0, X1, X2, X3);                                         \
+        _mm256_store_si256((__m256i *) (void *) &WK[i],                      \
+                           _mm256_add_epi64(X0, _mm256_loadu_si256(          \
+                               (const __m256i *) (const void *) &Krnd[i]))); \
+    } while (0)
+
+# define RNDS16(i)          \
+    do {                    \
+        RNDr(S, WK, 0, i);  \
+        RNDr(S, WK, 1, i);  \
+        RNDr(S, WK, 2, i);  \
+        RNDr(S, WK, 3, i);  \
+        RNDr(S, WK, 4, i);  \
+        RNDr(S, WK, 5, i);  \
+        RNDr(S, WK, 6, i);  \
+        RNDr(S, WK, 7, i);  \
+        RNDr(S, WK, 8, i);  \
+        RNDr(S, WK, 9, i);  \
+        RNDr(S, WK, 10, i); \
+        RNDr(S, WK, 11, i); \
+        RNDr(S, WK, 12, i); \
+        RNDr(S, WK, 13, i); \
+        RNDr(S, WK, 14, i); \
+        RNDr(S, WK, 15, i); \
+    } while (0)
+
+void
+_crypto_hash_sha512_avx2_transform(uint64_t state[8], const unsigned char *in,
+                                   size_t blocks)
+{
+    CRYPTO_ALIGN(32) uint64_t WK[80];
+    uint64_t                  S[8];
+    const __m256i             bswap =
+        _mm256_set_epi64x(0x08090a0b0c0d0e0fLL, 0x0001020304050607LL,
+                          0x08090a0b0c0d0e0fLL, 0x0001020304050607LL);
+    __m256i                   x0, x1, x2, x3;
+    int                       i;
+
+    while (blocks-- > 0U) {
+        LOADW(x0, 0);
+        LOADW(x1, 4);
+        LOADW(x2, 8);
+        LOADW(x3, 12);
+        memcpy(S, state, sizeof S);
+        for (i = 0; i < 64; i += 16) {
+            SCHED(x0, x1, x2, x3, i + 16);
+            SCHED(x1, x2, x3, x0, i + 20);
+            SCHED(x2, x3, x0, x1, i + 24);
+            SCHED(x3, x0, x1, x2, i + 28);
+            RNDS16(i);
+        }
+        RNDS16(64);
+        for (i = 0; i < 8; i++) {
+            state[i] += S[i];
+        }
+        in += 128;
+    }
+    sodium_memzero(WK, sizeof WK);
+    sodium_memzero(S, sizeof S);
+}
+
+#endif
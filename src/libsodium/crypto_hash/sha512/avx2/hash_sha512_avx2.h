@@ -0,0 +1,11 @@
+#ifndef hash_sha512_avx2_H
+#define hash_sha512_avx2_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+void _crypto_hash_sha512_avx2_transform(uint64_t state[8],
+                                        const unsigned char *in,
+                                        size_t blocks);
+
+#endif /* hash_sha512_avx2_H */
@@ -34,9 +34,22 @@
 #include <sys/types.h>
 
 #include "crypto_hash_sha512.h"
+#include "private/aliases.h"
 #include "private/common.h"
+#include "private/implementations.h"
+#include "private/sha512_multi.h"
+#include "private/stats.h"
+#include "runtime.h"
 #include "utils.h"
 
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# include "../avx2/hash_sha512_avx2.h"
+#endif
+#if defined(HAVE_ARMSHA512) && defined(NATIVE_LITTLE_ENDIAN)
+# include "../armsha512/hash_sha512_armsha512.h"
+#endif
+
 static void
 be64enc_vect(unsigned char *dst, const uint64_t *src, size_t len)
 {
@@ -170,7 +183,25 @@ static const uint8_t PAD[128] = {
 };
 
 static void
-SHA512_Pad(crypto_hash_sha512_state *state, uint64_t tmp64[80 + 8])
+SHA512_Transform_cp(uint64_t state[8], const unsigned char *in, size_t blocks)
+{
+    uint64_t tmp64[80 + 8];
+
+    while (blocks-- > 0U) {
+        SHA512_Transform(state, in, &tmp64[0], &tmp64[80]);
+        in += 128;
+    }
+    sodium_memzero((void *) tmp64, sizeof tmp64);
+}
+
+static void (*transform)(uint64_t state[8], const unsigned char *in,
+                         size_t blocks) = SHA512_Transform_cp;
+
+static void (*transform_multi)(sha512_multi_state *M) = NULL;
+static size_t transform_multi_lanes = 0U;
+
+static void
+SHA512_Pad(crypto_hash_sha512_state *state)
 {
     unsigned int r;
     unsigned int i;
@@ -184,11 +215,11 @@ SHA512_Pad(crypto_hash_sha512_state *state, uint64_t tmp64[80 + 8])
         for (i = 0; i < 128 - r; i++) {
             state->buf[r + i] = PAD[i];
         }
-        SHA512_Transform(state->state, state->buf, &tmp64[0], &tmp64[80]);
+        transform(state->state, state->buf, 1U);
         memset(&state->buf[0], 0, 112);
     }
     be64enc_vect(&state->buf[112], state->count, 16);
-    SHA512_Transform(state->state, state->buf, &tmp64[0], &tmp64[80]);
+    transform(state->state, state->buf, 1U);
 }
 
 int
@@ -205,12 +236,12 @@ crypto_hash_sha512_init(crypto_hash_sha512_state *state)
 
     return 0;
 }
+SODIUM_ALIAS_DEF(crypto_hash_sha512_init);
 
-int
-crypto_hash_sha512_update(crypto_hash_sha512_state *state,
-                          const unsigned char *in, unsigned long long inlen)
+static int
+_hash_sha512_update(crypto_hash_sha512_state *state,
+                   const unsigned char *in, unsigned long long inlen)
 {
-    uint64_t           tmp64[80 + 8];
     uint64_t           bitlen[2];
     unsigned long long i;
     unsigned long long r;
@@ -237,46 +268,281 @@ crypto_hash_sha512_update(crypto_hash_sha512_state *state,
     for (i = 0; i < 128 - r; i++) {
         state->buf[r + i] = in[i];
     }
-    SHA512_Transform(state->state, state->buf, &tmp64[0], &tmp64[80]);
+    transform(state->state, state->buf, 1U);
     in += 128 - r;
     inlen -= 128 - r;
 
-    while (inlen >= 128) {
-        SHA512_Transform(state->state, in, &tmp64[0], &tmp64[80]);
-        in += 128;
-        inlen -= 128;
+    if (inlen >= 128) {
+        transform(state->state, in, (size_t) (inlen / 128));
+        in += inlen & ~(unsigned long long) 127;
     }
     inlen &= 127;
     for (i = 0; i < inlen; i++) {
         state->buf[i] = in[i];
     }
-    sodium_memzero((void *) tmp64, sizeof tmp64);
 
     return 0;
 }
 
 int
-crypto_hash_sha512_final(crypto_hash_sha512_state *state, unsigned char *out)
+crypto_hash_sha512_update(crypto_hash_sha512_state *state,
+                          const unsigned char *in, unsigned long long inlen)
 {
-    uint64_t tmp64[80 + 8];
+    int ret;
+    SODIUM_STATS_START(stats_start)
 
-    SHA512_Pad(state, tmp64);
+    ret = _hash_sha512_update(state, in, inlen);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, inlen);
+
+    return ret;
+}
+SODIUM_ALIAS_DEF(crypto_hash_sha512_update);
+
+int
+crypto_hash_sha512_final(crypto_hash_sha512_state *state, unsigned char *out)
+{
+    SHA512_Pad(state);
     be64enc_vect(out, state->state, 64);
-    sodium_memzero((void *) tmp64, sizeof tmp64);
     sodium_memzero((void *) state, sizeof *state);
 
     return 0;
 }
+SODIUM_ALIAS_DEF(crypto_hash_sha512_final);
 
 int
 crypto_hash_sha512(unsigned char *out, const unsigned char *in,
                    unsigned long long inlen)
 {
     crypto_hash_sha512_state state;
+    SODIUM_STATS_START(stats_start)
 
     crypto_hash_sha512_init(&state);
     crypto_hash_sha512_update(&state, in, inlen);
     crypto_hash_sha512_final(&state, out);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_HASH, inlen);
+
+    return 0;
+}
+SODIUM_ALIAS_DEF(crypto_hash_sha512);
+
+#define SHA512_MULTI_NONE ((size_t) -1)
+
+typedef struct sha512_multi_lane {
+    size_t             idx;
+    unsigned long long off;
+    unsigned long long end;
+    unsigned long long total;
+    unsigned char      len[16];
+} sha512_multi_lane;
+
+static void
+_sha512_multi_lane_init(sha512_multi_state *M, sha512_multi_lane *lane,
+                        size_t l, size_t idx,
+                        const crypto_hash_sha512_state *state,
+                        unsigned long long inlen)
+{
+    uint64_t count[2];
+    int      i;
+
+    for (i = 0; i < 8; i++) {
+        M->h[i][l] = state->state[i];
+    }
+    count[0] = state->count[0] + (((uint64_t) inlen) >> 61);
+    count[1] = state->count[1] + (((uint64_t) inlen) << 3);
+    if (count[1] < state->count[1]) {
+        count[0]++; /* LCOV_EXCL_LINE */
+    }
+    be64enc_vect(lane->len, count, 16);
+    lane->idx   = idx;
+    lane->off   = 0U;
+    lane->end   = ((state->count[1] >> 3) & 0x7f) + inlen;
+    lane->total = (lane->end + 16U + 128U) & ~(unsigned long long) 127U;
+}
 
+/*
+ * A lane reads buf || in || padding, where buf is what the state has
+ * buffered so far. Blocks entirely within in are used in place.
+ */
+static const unsigned char *
+_sha512_multi_lane_block(unsigned char block[128],
+                         const sha512_multi_lane *lane,
+                         const crypto_hash_sha512_state *state,
+                         const unsigned char *in)
+{
+    const size_t       r = (size_t) ((state->count[1] >> 3) & 0x7f);
+    unsigned long long n;
+    size_t             i = 0U;
+
+    if (lane->off >= r && lane->off + 128U <= lane->end) {
+        return in + (lane->off - r);
+    }
+    memset(block, 0, 128U);
+    if (lane->off < r) {
+        i = r - (size_t) lane->off;
+        memcpy(block, state->buf + lane->off, i);
+    }
+    if (lane->off + i < lane->end) {
+        n = lane->end - (lane->off + i);
+        if (n > 128U - i) {
+            n = 128U - i;
+        }
+        memcpy(block + i, in + (lane->off + i - r), (size_t) n);
+    }
+    if (lane->end >= lane->off && lane->end < lane->off + 128U) {
+        block[lane->end - lane->off] = 0x80;
+    }
+    if (lane->off + 128U == lane->total) {
+        memcpy(block + 112, lane->len, 16U);
+    }
+    return block;
+}
+
+/*
+ * Lanes are refilled with the next message as soon as they are done, so
+ * that messages of different lengths can be mixed.
+ */
+void
+_crypto_hash_sha512_final_multi(crypto_hash_sha512_state * const *states,
+                                unsigned char * const *out,
+                                const unsigned char * const *in,
+                                const unsigned long long *inlen,
+                                size_t count)
+{
+    CRYPTO_ALIGN(64) sha512_multi_state M;
+    sha512_multi_lane    lanes_[SHA512_MULTI_LANES_MAX];
+    unsigned char        block[128];
+    const unsigned char *src;
+    size_t               active = 0U;
+    size_t               next   = 0U;
+    size_t               lanes  = transform_multi_lanes;
+    size_t               idx;
+    size_t               l;
+    int                  i;
+
+    if (transform_multi == NULL || count < 2U) {
+        for (next = 0U; next < count; next++) {
+            crypto_hash_sha512_update(states[next], in[next], inlen[next]);
+            crypto_hash_sha512_final(states[next], out[next]);
+        }
+        return;
+    }
+    memset(&M, 0, sizeof M);
+    for (l = 0U; l < lanes; l++) {
+        lanes_[l].idx = SHA512_MULTI_NONE;
+        if (next < count) {
+            _sha512_multi_lane_init(&M, &lanes_[l], l, next, states[next],
+                                    inlen[next]);
+            next++;
+            active++;
+        }
+    }
+    while (active > 0U) {
+        for (l = 0U; l < lanes; l++) {
+            if ((idx = lanes_[l].idx) == SHA512_MULTI_NONE) {
+                continue;
+            }
+            src = _sha512_multi_lane_block(block, &lanes_[l], states[idx],
+                                           in[idx]);
+            for (i = 0; i < 16; i++) {
+                M.w[i][l] = LOAD64_BE(src + i * 8);
+            }
+            lanes_[l].off += 128U;
+        }
+        transform_multi(&M);
+        for (l = 0U; l < lanes; l++) {
+            if ((idx = lanes_[l].idx) == SHA512_MULTI_NONE ||
+                lanes_[l].off != lanes_[l].total) {
+                continue;
+            }
+            for (i = 0; i < 8; i++) {
+                STORE64_BE(out[idx] + 8 * i, M.h[i][l]);
+            }
+            sodium_memzero((void *) states[idx], sizeof *states[idx]);
+            if (next < count) {
+                _sha512_multi_lane_init(&M, &lanes_[l], l, next, states[next],
+                                        inlen[next]);
+                next++;
+            } else {
+                lanes_[l].idx = SHA512_MULTI_NONE;
+                active--;
+            }
+        }
+    }
+    sodium_memzero(&M, sizeof M);
+    sodium_memzero(block, sizeof block);
+}
+
+size_t
+_crypto_hash_sha512_multi_lanes(void)
+{
+    if (transform_multi == NULL) {
+        return 1U;
+    }
+    return transform_multi_lanes;
+}
+
+void
+_crypto_hash_sha512_compress_lanes(sha512_multi_state *M, size_t count)
+{
+    uint64_t      state[8];
+    unsigned char block[128];
+    size_t        l;
+    int           i;
+
+    if (transform_multi != NULL && count >= 2U) {
+        transform_multi(M);
+        return;
+    }
+    for (l = 0U; l < count; l++) {
+        for (i = 0; i < 8; i++) {
+            state[i] = M->h[i][l];
+        }
+        for (i = 0; i < 16; i++) {
+            STORE64_BE(block + 8 * i, M->w[i][l]);
+        }
+        transform(state, block, 1U);
+        for (i = 0; i < 8; i++) {
+            M->h[i][l] = state[i];
+        }
+    }
+    sodium_memzero(state, sizeof state);
+    sodium_memzero(block, sizeof block);
+}
+
+int
+_crypto_hash_sha512_pick_best_implementation(void)
+{
+    transform = SHA512_Transform_cp;
+    transform_multi = NULL;
+    transform_multi_lanes = 0U;
+    _sodium_implementation_selected("sha512", "cp");
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2()) {
+        transform_multi = _crypto_hash_sha512_transform_multi_avx2;
+        transform_multi_lanes = 4U;
+    }
+    if (sodium_runtime_has_avx2() && sodium_runtime_has_bmi2() &&
+        _sodium_implementation_allowed("sha512", "avx2")) {
+        transform = _crypto_hash_sha512_avx2_transform;
+        _sodium_implementation_selected("sha512", "avx2");
+    }
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors()) {
+        transform_multi = _crypto_hash_sha512_transform_multi_avx512f;
+        transform_multi_lanes = 8U;
+    }
+#endif
+#if defined(HAVE_ARMSHA512) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_armsha512() &&
+        _sodium_implementation_allowed("sha512", "armsha512")) {
+        transform = _crypto_hash_sha512_armsha512_transform;
+        _sodium_implementation_selected("sha512", "armsha512");
+        return 0;
+    }
+#endif
     return 0;
 }
@@ -0,0 +1,39 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "private/sha512_multi.h"
+
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# define VEC   __m256i
+
+# define LOADV(p)     _mm256_loadu_si256((const __m256i *) (const void *) (p))
+# define STOREV(p, r) _mm256_storeu_si256((__m256i *) (void *) (p), r)
+# define SET1(x)      _mm256_set1_epi64x((long long) (x))
+# define ADD(a, b)    _mm256_add_epi64(a, b)
+# define XOR(a, b)    _mm256_xor_si256(a, b)
+# define AND(a, b)    _mm256_and_si256(a, b)
+# define OR(a, b)     _mm256_or_si256(a, b)
+# define SHR(x, n)    _mm256_srli_epi64(x, n)
+# define ROTR(x, n) \
+    _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+
+# define FN(name) _crypto_hash_sha512_##name##_multi_avx2
+# include "sha512-transform-multi.h"
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "crypto_kdf_blake2b.h"
 #include "crypto_generichash_blake2b.h"
+#include "private/blake2b_range.h"
 #include "private/common.h"
 
 size_t
@@ -50,3 +51,25 @@ int crypto_kdf_blake2b_derive_from_key(unsigned char *subkey, size_t subkey_len,
                                                     key, crypto_kdf_blake2b_KEYBYTES,
                                                     salt, ctx_padded);
 }
+
+int crypto_kdf_blake2b_derive_from_key_range(unsigned char *out, size_t subkey_len,
+                                             uint64_t first_id, size_t count,
+                                             const char ctx[crypto_kdf_blake2b_CONTEXTBYTES],
+                                             const unsigned char key[crypto_kdf_blake2b_KEYBYTES])
+{
+    unsigned char ctx_padded[crypto_generichash_blake2b_PERSONALBYTES];
+
+    if (subkey_len < crypto_kdf_blake2b_BYTES_MIN ||
+        subkey_len > crypto_kdf_blake2b_BYTES_MAX ||
+        count > SIZE_MAX / subkey_len ||
+        (count > 0U && first_id + (uint64_t) (count - 1U) < first_id)) {
+        errno = EINVAL;
+        return -1;
+    }
+    memcpy(ctx_padded, ctx, crypto_kdf_blake2b_CONTEXTBYTES);
+    memset(ctx_padded + crypto_kdf_blake2b_CONTEXTBYTES, 0, sizeof ctx_padded - crypto_kdf_blake2b_CONTEXTBYTES);
+
+    return _crypto_generichash_blake2b_salt_personal_range(out, subkey_len, count,
+                                                           key, crypto_kdf_blake2b_KEYBYTES,
+                                                           first_id, ctx_padded);
+}
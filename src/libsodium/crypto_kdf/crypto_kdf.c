@@ -42,6 +42,16 @@ crypto_kdf_derive_from_key(unsigned char *subkey, size_t subkey_len,
                                               subkey_id, ctx, key);
 }
 
+int
+crypto_kdf_derive_from_key_range(unsigned char *out, size_t subkey_len,
+                                 uint64_t first_id, size_t count,
+                                 const char ctx[crypto_kdf_CONTEXTBYTES],
+                                 const unsigned char key[crypto_kdf_KEYBYTES])
+{
+    return crypto_kdf_blake2b_derive_from_key_range(out, subkey_len, first_id,
+                                                    count, ctx, key);
+}
+
 void
 crypto_kdf_keygen(unsigned char k[crypto_kdf_KEYBYTES])
 {
@@ -30,9 +30,17 @@ crypto_kdf_hkdf_sha512_keygen(unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES]
 }
 
 int
-crypto_kdf_hkdf_sha512_expand(unsigned char *out, size_t out_len,
-                              const char *ctx, size_t ctx_len,
-                              const unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES])
+crypto_kdf_hkdf_sha512_precompute(crypto_kdf_hkdf_sha512_state *state,
+                                  const unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES])
+{
+    return crypto_auth_hmacsha512_key_precompute(&state->kst, prk,
+                                                 crypto_kdf_hkdf_sha512_KEYBYTES);
+}
+
+int
+crypto_kdf_hkdf_sha512_expand_precomputed(unsigned char *out, size_t out_len,
+                                          const char *ctx, size_t ctx_len,
+                                          const crypto_kdf_hkdf_sha512_state *state)
 {
     crypto_auth_hmacsha512_state st;
     unsigned char                tmp[crypto_auth_hmacsha512_BYTES];
@@ -46,7 +54,7 @@ crypto_kdf_hkdf_sha512_expand(unsigned char *out, size_t out_len,
     }
     for (i = (size_t) 0U; i + crypto_auth_hmacsha512_BYTES <= out_len;
          i += crypto_auth_hmacsha512_BYTES) {
-        crypto_auth_hmacsha512_init(&st, prk, crypto_kdf_hkdf_sha512_KEYBYTES);
+        crypto_auth_hmacsha512_init_precomputed(&st, &state->kst);
         if (i != (size_t) 0U) {
             crypto_auth_hmacsha512_update(&st,
                                           &out[i - crypto_auth_hmacsha512_BYTES],
@@ -59,7 +67,7 @@ crypto_kdf_hkdf_sha512_expand(unsigned char *out, size_t out_len,
         counter++;
     }
     if ((left = out_len & (crypto_auth_hmacsha512_BYTES - 1U)) != (size_t) 0U) {
-        crypto_auth_hmacsha512_init(&st, prk, crypto_kdf_hkdf_sha512_KEYBYTES);
+        crypto_auth_hmacsha512_init_precomputed(&st, &state->kst);
         if (i != (size_t) 0U) {
             crypto_auth_hmacsha512_update(&st,
                                           &out[i - crypto_auth_hmacsha512_BYTES],
@@ -77,6 +85,32 @@ crypto_kdf_hkdf_sha512_expand(unsigned char *out, size_t out_len,
     return 0;
 }
 
+int
+crypto_kdf_hkdf_sha512_expand(unsigned char *out, size_t out_len,
+                              const char *ctx, size_t ctx_len,
+                              const unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES])
+{
+    crypto_kdf_hkdf_sha512_state state;
+    int                          ret;
+
+    if (out_len > crypto_kdf_hkdf_sha512_BYTES_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    crypto_kdf_hkdf_sha512_precompute(&state, prk);
+    ret = crypto_kdf_hkdf_sha512_expand_precomputed(out, out_len,
+                                                    ctx, ctx_len, &state);
+    sodium_memzero(&state, sizeof state);
+
+    return ret;
+}
+
+size_t
+crypto_kdf_hkdf_sha512_statebytes(void)
+{
+    return sizeof(crypto_kdf_hkdf_sha512_state);
+}
+
 size_t
 crypto_kdf_hkdf_sha512_keybytes(void)
 {
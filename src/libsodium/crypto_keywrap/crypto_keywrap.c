@@ -0,0 +1,309 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_generichash_blake2b.h"
+#include "crypto_keywrap.h"
+#include "crypto_stream_chacha20.h"
+#include "crypto_verify_16.h"
+#include "private/chacha20_ietf_ext.h"
+#include "private/common.h"
+#include "randombytes.h"
+#include "utils.h"
+
+/*
+ * wrapped = SIV || ChaCha20(K_enc, ic = LE32(SIV[0..4]), n = SIV[4..16]) ^ in
+ * with SIV = BLAKE2b-128(K_mac, in || ad), and K_mac || K_enc derived from
+ * the key-encryption key with a single keyed BLAKE2b call.
+ */
+
+#define KEYWRAP_SIVBYTES          16U
+#define KEYWRAP_BLAKE2B_BLOCKBYTES 128U
+#define KEYWRAP_BATCH_CHUNK       64U
+#define KEYWRAP_BATCH_ADBYTES_MAX (KEYWRAP_BLAKE2B_BLOCKBYTES - crypto_keywrap_INPUTBYTES)
+
+static const unsigned char KEYWRAP_PERSONAL[crypto_generichash_blake2b_PERSONALBYTES] =
+    "sodium_keywrap__";
+
+size_t
+crypto_keywrap_keybytes(void)
+{
+    return crypto_keywrap_KEYBYTES;
+}
+
+size_t
+crypto_keywrap_inputbytes(void)
+{
+    return crypto_keywrap_INPUTBYTES;
+}
+
+size_t
+crypto_keywrap_wrappedbytes(void)
+{
+    return crypto_keywrap_WRAPPEDBYTES;
+}
+
+const char *
+crypto_keywrap_primitive(void)
+{
+    return crypto_keywrap_PRIMITIVE;
+}
+
+void
+crypto_keywrap_keygen(unsigned char kek[crypto_keywrap_KEYBYTES])
+{
+    randombytes_buf(kek, crypto_keywrap_KEYBYTES);
+}
+
+static void
+keywrap_subkeys(unsigned char subkeys[2 * crypto_keywrap_KEYBYTES],
+                const unsigned char kek[crypto_keywrap_KEYBYTES])
+{
+    COMPILER_ASSERT(2 * crypto_keywrap_KEYBYTES <=
+                    crypto_generichash_blake2b_BYTES_MAX);
+    crypto_generichash_blake2b_salt_personal(subkeys, 2 * crypto_keywrap_KEYBYTES,
+                                             NULL, 0U, kek,
+                                             crypto_keywrap_KEYBYTES, NULL,
+                                             KEYWRAP_PERSONAL);
+}
+
+static void
+keywrap_siv(unsigned char siv[KEYWRAP_SIVBYTES],
+            const unsigned char in[crypto_keywrap_INPUTBYTES],
+            const unsigned char *ad, unsigned long long adlen,
+            const unsigned char *mac_key)
+{
+    crypto_generichash_blake2b_state st;
+
+    crypto_generichash_blake2b_init(&st, mac_key, crypto_keywrap_KEYBYTES,
+                                    KEYWRAP_SIVBYTES);
+    crypto_generichash_blake2b_update(&st, in, crypto_keywrap_INPUTBYTES);
+    if (adlen > 0U) {
+        crypto_generichash_blake2b_update(&st, ad, adlen);
+    }
+    crypto_generichash_blake2b_final(&st, siv, KEYWRAP_SIVBYTES);
+}
+
+static void
+keywrap_xor(unsigned char *out, const unsigned char *in,
+            const unsigned char siv[KEYWRAP_SIVBYTES],
+            const unsigned char *enc_key)
+{
+    crypto_stream_chacha20_ietf_xor_ic(out, in, crypto_keywrap_INPUTBYTES,
+                                       siv + 4, LOAD32_LE(siv), enc_key);
+}
+
+int
+crypto_keywrap(unsigned char wrapped[crypto_keywrap_WRAPPEDBYTES],
+               const unsigned char in[crypto_keywrap_INPUTBYTES],
+               const unsigned char *ad, unsigned long long adlen,
+               const unsigned char kek[crypto_keywrap_KEYBYTES])
+{
+    unsigned char subkeys[2 * crypto_keywrap_KEYBYTES];
+    unsigned char siv[KEYWRAP_SIVBYTES];
+
+    keywrap_subkeys(subkeys, kek);
+    keywrap_siv(siv, in, ad, adlen, subkeys);
+    keywrap_xor(wrapped + KEYWRAP_SIVBYTES, in, siv,
+                subkeys + crypto_keywrap_KEYBYTES);
+    memcpy(wrapped, siv, KEYWRAP_SIVBYTES);
+    sodium_memzero(subkeys, sizeof subkeys);
+
+    return 0;
+}
+
+int
+crypto_keywrap_open(unsigned char out[crypto_keywrap_INPUTBYTES],
+                    const unsigned char wrapped[crypto_keywrap_WRAPPEDBYTES],
+                    const unsigned char *ad, unsigned long long adlen,
+                    const unsigned char kek[crypto_keywrap_KEYBYTES])
+{
+    unsigned char subkeys[2 * crypto_keywrap_KEYBYTES];
+    unsigned char siv[KEYWRAP_SIVBYTES];
+    unsigned char computed_siv[KEYWRAP_SIVBYTES];
+    int           ret;
+
+    COMPILER_ASSERT(crypto_keywrap_WRAPPEDBYTES ==
+                    KEYWRAP_SIVBYTES + crypto_keywrap_INPUTBYTES);
+    keywrap_subkeys(subkeys, kek);
+    memcpy(siv, wrapped, KEYWRAP_SIVBYTES);
+    keywrap_xor(out, wrapped + KEYWRAP_SIVBYTES, siv,
+                subkeys + crypto_keywrap_KEYBYTES);
+    keywrap_siv(computed_siv, out, ad, adlen, subkeys);
+    sodium_memzero(subkeys, sizeof subkeys);
+    ret = crypto_verify_16(computed_siv, siv);
+    if (ret != 0) {
+        sodium_memzero(out, crypto_keywrap_INPUTBYTES);
+    }
+    return ret;
+}
+
+/*
+ * SIVs of count <= KEYWRAP_BATCH_CHUNK keys. Keys whose additional data
+ * fits in the same BLAKE2b block are hashed together.
+ */
+static void
+keywrap_siv_lanes(unsigned char (*siv)[KEYWRAP_SIVBYTES],
+                  const unsigned char * const *in,
+                  const unsigned char * const *ad,
+                  const unsigned long long *adlen, size_t count,
+                  const unsigned char *mac_key)
+{
+    unsigned char        buf[KEYWRAP_BATCH_CHUNK][KEYWRAP_BLAKE2B_BLOCKBYTES];
+    unsigned char       *out_[KEYWRAP_BATCH_CHUNK];
+    const unsigned char *in_[KEYWRAP_BATCH_CHUNK];
+    unsigned long long   inlen_[KEYWRAP_BATCH_CHUNK];
+    unsigned long long   l;
+    size_t               i;
+    size_t               n = 0U;
+
+    for (i = 0U; i < count; i++) {
+        l = ad == NULL ? 0U : adlen[i];
+        if (l > KEYWRAP_BATCH_ADBYTES_MAX) {
+            keywrap_siv(siv[i], in[i], ad[i], l, mac_key);
+            continue;
+        }
+        out_[n]   = siv[i];
+        in_[n]    = in[i];
+        inlen_[n] = crypto_keywrap_INPUTBYTES;
+        if (l > 0U) {
+            memcpy(buf[n], in[i], crypto_keywrap_INPUTBYTES);
+            memcpy(buf[n] + crypto_keywrap_INPUTBYTES, ad[i], (size_t) l);
+            in_[n] = buf[n];
+            inlen_[n] += l;
+        }
+        n++;
+    }
+    if (n > 0U) {
+        (void) crypto_generichash_blake2b_multi(out_, KEYWRAP_SIVBYTES, in_,
+                                                inlen_, n, mac_key,
+                                                crypto_keywrap_KEYBYTES);
+    }
+    sodium_memzero(buf, sizeof buf);
+}
+
+/* Encrypts or decrypts count keys, 8 ChaCha20 blocks at a time if possible */
+static void
+keywrap_xor_lanes(unsigned char * const *out, const unsigned char * const *in,
+                  const unsigned char (*siv)[KEYWRAP_SIVBYTES], size_t count,
+                  const unsigned char *enc_key)
+{
+    CRYPTO_ALIGN(32) uint32_t      x[16][8];
+    CRYPTO_ALIGN(32) unsigned char ks[64U * 8U];
+    size_t                         i;
+    size_t                         j;
+    size_t                         l;
+    size_t                         s;
+
+    if (count <= 1U || crypto_stream_chacha20_has_blocks8() == 0) {
+        for (i = 0U; i < count; i++) {
+            keywrap_xor(out[i], in[i], siv[i], enc_key);
+        }
+        return;
+    }
+    for (l = 0U; l < 8U; l++) {
+        x[0][l] = 0x61707865;
+        x[1][l] = 0x3320646e;
+        x[2][l] = 0x79622d32;
+        x[3][l] = 0x6b206574;
+        for (j = 0U; j < 8U; j++) {
+            x[4 + j][l] = LOAD32_LE(enc_key + 4U * j);
+        }
+    }
+    for (i = 0U; i < count; i += 8U) {
+        for (l = 0U; l < 8U; l++) {
+            s = i + (i + l < count ? l : 0U);
+            for (j = 0U; j < 4U; j++) {
+                x[12 + j][l] = LOAD32_LE(siv[s] + 4U * j);
+            }
+        }
+        crypto_stream_chacha20_blocks8(ks, (const uint32_t (*)[8]) x);
+        for (l = 0U; l < 8U && i + l < count; l++) {
+            for (j = 0U; j < crypto_keywrap_INPUTBYTES; j++) {
+                out[i + l][j] = in[i + l][j] ^ ks[64U * l + j];
+            }
+        }
+    }
+    sodium_memzero(x, sizeof x);
+    sodium_memzero(ks, sizeof ks);
+}
+
+int
+crypto_keywrap_batch(unsigned char * const *wrapped,
+                     const unsigned char * const *in,
+                     const unsigned char * const *ad,
+                     const unsigned long long *adlen, size_t count,
+                     const unsigned char kek[crypto_keywrap_KEYBYTES])
+{
+    unsigned char  subkeys[2 * crypto_keywrap_KEYBYTES];
+    unsigned char  siv[KEYWRAP_BATCH_CHUNK][KEYWRAP_SIVBYTES];
+    unsigned char *c_[KEYWRAP_BATCH_CHUNK];
+    size_t         chunk;
+    size_t         i;
+    size_t         j;
+
+    keywrap_subkeys(subkeys, kek);
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > KEYWRAP_BATCH_CHUNK) {
+            chunk = KEYWRAP_BATCH_CHUNK;
+        }
+        keywrap_siv_lanes(siv, &in[i], ad == NULL ? NULL : &ad[i],
+                          ad == NULL ? NULL : &adlen[i], chunk, subkeys);
+        for (j = 0U; j < chunk; j++) {
+            c_[j] = wrapped[i + j] + KEYWRAP_SIVBYTES;
+        }
+        keywrap_xor_lanes(c_, &in[i], (const unsigned char (*)[KEYWRAP_SIVBYTES]) siv,
+                          chunk, subkeys + crypto_keywrap_KEYBYTES);
+        for (j = 0U; j < chunk; j++) {
+            memcpy(wrapped[i + j], siv[j], KEYWRAP_SIVBYTES);
+        }
+    }
+    sodium_memzero(subkeys, sizeof subkeys);
+
+    return 0;
+}
+
+int
+crypto_keywrap_open_batch(unsigned char * const *out,
+                          const unsigned char * const *wrapped,
+                          const unsigned char * const *ad,
+                          const unsigned long long *adlen, size_t count,
+                          const unsigned char kek[crypto_keywrap_KEYBYTES])
+{
+    unsigned char        subkeys[2 * crypto_keywrap_KEYBYTES];
+    unsigned char        siv[KEYWRAP_BATCH_CHUNK][KEYWRAP_SIVBYTES];
+    unsigned char        computed_siv[KEYWRAP_BATCH_CHUNK][KEYWRAP_SIVBYTES];
+    const unsigned char *c_[KEYWRAP_BATCH_CHUNK];
+    size_t               chunk;
+    size_t               i;
+    size_t               j;
+    int                  ret = 0;
+
+    keywrap_subkeys(subkeys, kek);
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > KEYWRAP_BATCH_CHUNK) {
+            chunk = KEYWRAP_BATCH_CHUNK;
+        }
+        for (j = 0U; j < chunk; j++) {
+            memcpy(siv[j], wrapped[i + j], KEYWRAP_SIVBYTES);
+            c_[j] = wrapped[i + j] + KEYWRAP_SIVBYTES;
+        }
+        keywrap_xor_lanes(&out[i], c_, (const unsigned char (*)[KEYWRAP_SIVBYTES]) siv,
+                          chunk, subkeys + crypto_keywrap_KEYBYTES);
+        keywrap_siv_lanes(computed_siv, (const unsigned char * const *) &out[i],
+                          ad == NULL ? NULL : &ad[i],
+                          ad == NULL ? NULL : &adlen[i], chunk, subkeys);
+        for (j = 0U; j < chunk; j++) {
+            if (crypto_verify_16(computed_siv[j], siv[j]) != 0) {
+                sodium_memzero(out[i + j], crypto_keywrap_INPUTBYTES);
+                ret = -1;
+            }
+        }
+    }
+    sodium_memzero(subkeys, sizeof subkeys);
+
+    return ret;
+}
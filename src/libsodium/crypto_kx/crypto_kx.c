@@ -1,14 +1,18 @@
 
 #include <stddef.h>
+#include <string.h>
 
 #include "core.h"
 #include "crypto_generichash.h"
 #include "crypto_kx.h"
 #include "crypto_scalarmult.h"
+#include "crypto_scalarmult_curve25519.h"
 #include "private/common.h"
 #include "randombytes.h"
 #include "utils.h"
 
+#define KX_BATCH_CHUNK 64U
+
 int
 crypto_kx_seed_keypair(unsigned char pk[crypto_kx_PUBLICKEYBYTES],
                        unsigned char sk[crypto_kx_SECRETKEYBYTES],
@@ -37,10 +41,9 @@ crypto_kx_client_session_keys(unsigned char rx[crypto_kx_SESSIONKEYBYTES],
                               const unsigned char client_sk[crypto_kx_SECRETKEYBYTES],
                               const unsigned char server_pk[crypto_kx_PUBLICKEYBYTES])
 {
-    crypto_generichash_state h;
-    unsigned char            q[crypto_scalarmult_BYTES];
-    unsigned char            keys[2 * crypto_kx_SESSIONKEYBYTES];
-    int                      i;
+    unsigned char qpks[crypto_scalarmult_BYTES + 2 * crypto_kx_PUBLICKEYBYTES];
+    unsigned char keys[2 * crypto_kx_SESSIONKEYBYTES];
+    int           i;
 
     if (rx == NULL) {
         rx = tx;
@@ -51,17 +54,15 @@ crypto_kx_client_session_keys(unsigned char rx[crypto_kx_SESSIONKEYBYTES],
     if (rx == NULL) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
-    if (crypto_scalarmult(q, client_sk, server_pk) != 0) {
+    if (crypto_scalarmult(qpks, client_sk, server_pk) != 0) {
         return -1;
     }
     COMPILER_ASSERT(sizeof keys <= crypto_generichash_BYTES_MAX);
-    crypto_generichash_init(&h, NULL, 0U, sizeof keys);
-    crypto_generichash_update(&h, q, crypto_scalarmult_BYTES);
-    sodium_memzero(q, sizeof q);
-    crypto_generichash_update(&h, client_pk, crypto_kx_PUBLICKEYBYTES);
-    crypto_generichash_update(&h, server_pk, crypto_kx_PUBLICKEYBYTES);
-    crypto_generichash_final(&h, keys, sizeof keys);
-    sodium_memzero(&h, sizeof h);
+    memcpy(qpks + crypto_scalarmult_BYTES, client_pk, crypto_kx_PUBLICKEYBYTES);
+    memcpy(qpks + crypto_scalarmult_BYTES + crypto_kx_PUBLICKEYBYTES, server_pk,
+           crypto_kx_PUBLICKEYBYTES);
+    crypto_generichash(keys, sizeof keys, qpks, sizeof qpks, NULL, 0U);
+    sodium_memzero(qpks, sizeof qpks);
     for (i = 0; i < crypto_kx_SESSIONKEYBYTES; i++) {
         rx[i] = keys[i]; /* rx cannot be NULL */
         tx[i] = keys[i + crypto_kx_SESSIONKEYBYTES]; /* tx cannot be NULL */
@@ -78,10 +79,9 @@ crypto_kx_server_session_keys(unsigned char rx[crypto_kx_SESSIONKEYBYTES],
                               const unsigned char server_sk[crypto_kx_SECRETKEYBYTES],
                               const unsigned char client_pk[crypto_kx_PUBLICKEYBYTES])
 {
-    crypto_generichash_state h;
-    unsigned char            q[crypto_scalarmult_BYTES];
-    unsigned char            keys[2 * crypto_kx_SESSIONKEYBYTES];
-    int                      i;
+    unsigned char qpks[crypto_scalarmult_BYTES + 2 * crypto_kx_PUBLICKEYBYTES];
+    unsigned char keys[2 * crypto_kx_SESSIONKEYBYTES];
+    int           i;
 
     if (rx == NULL) {
         rx = tx;
@@ -92,17 +92,15 @@ crypto_kx_server_session_keys(unsigned char rx[crypto_kx_SESSIONKEYBYTES],
     if (rx == NULL) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
-    if (crypto_scalarmult(q, server_sk, client_pk) != 0) {
+    if (crypto_scalarmult(qpks, server_sk, client_pk) != 0) {
         return -1;
     }
     COMPILER_ASSERT(sizeof keys <= crypto_generichash_BYTES_MAX);
-    crypto_generichash_init(&h, NULL, 0U, sizeof keys);
-    crypto_generichash_update(&h, q, crypto_scalarmult_BYTES);
-    sodium_memzero(q, sizeof q);
-    crypto_generichash_update(&h, client_pk, crypto_kx_PUBLICKEYBYTES);
-    crypto_generichash_update(&h, server_pk, crypto_kx_PUBLICKEYBYTES);
-    crypto_generichash_final(&h, keys, sizeof keys);
-    sodium_memzero(&h, sizeof h);
+    memcpy(qpks + crypto_scalarmult_BYTES, client_pk, crypto_kx_PUBLICKEYBYTES);
+    memcpy(qpks + crypto_scalarmult_BYTES + crypto_kx_PUBLICKEYBYTES, server_pk,
+           crypto_kx_PUBLICKEYBYTES);
+    crypto_generichash(keys, sizeof keys, qpks, sizeof qpks, NULL, 0U);
+    sodium_memzero(qpks, sizeof qpks);
     for (i = 0; i < crypto_kx_SESSIONKEYBYTES; i++) {
         tx[i] = keys[i];
         rx[i] = keys[i + crypto_kx_SESSIONKEYBYTES];
@@ -112,6 +110,65 @@ crypto_kx_server_session_keys(unsigned char rx[crypto_kx_SESSIONKEYBYTES],
     return 0;
 }
 
+int
+crypto_kx_server_session_keys_batch(unsigned char * const *rx,
+                                    unsigned char * const *tx,
+                                    const unsigned char server_pk[crypto_kx_PUBLICKEYBYTES],
+                                    const unsigned char server_sk[crypto_kx_SECRETKEYBYTES],
+                                    const unsigned char * const *client_pk,
+                                    size_t count)
+{
+    unsigned char            qpks[crypto_scalarmult_BYTES +
+                                  2 * crypto_kx_PUBLICKEYBYTES];
+    unsigned char            q[KX_BATCH_CHUNK][crypto_scalarmult_BYTES];
+    unsigned char           *q_p[KX_BATCH_CHUNK];
+    const unsigned char     *sk_p[KX_BATCH_CHUNK];
+    unsigned char            keys[2 * crypto_kx_SESSIONKEYBYTES];
+    size_t                   chunk;
+    size_t                   i;
+    size_t                   j;
+    int                      ret = 0;
+
+    COMPILER_ASSERT(crypto_kx_SECRETKEYBYTES ==
+                    crypto_scalarmult_curve25519_SCALARBYTES);
+    COMPILER_ASSERT(sizeof keys <= crypto_generichash_BYTES_MAX);
+    for (j = 0U; j < KX_BATCH_CHUNK; j++) {
+        q_p[j]  = q[j];
+        sk_p[j] = server_sk;
+    }
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > KX_BATCH_CHUNK) {
+            chunk = KX_BATCH_CHUNK;
+        }
+        if (crypto_scalarmult_curve25519_batch(q_p, sk_p, &client_pk[i],
+                                               chunk) != 0) {
+            ret = -1;
+        }
+        for (j = 0U; j < chunk; j++) {
+            if (sodium_is_zero(q[j], sizeof q[j])) {
+                sodium_memzero(rx[i + j], crypto_kx_SESSIONKEYBYTES);
+                sodium_memzero(tx[i + j], crypto_kx_SESSIONKEYBYTES);
+                continue;
+            }
+            memcpy(qpks, q[j], crypto_scalarmult_BYTES);
+            memcpy(qpks + crypto_scalarmult_BYTES, client_pk[i + j],
+                   crypto_kx_PUBLICKEYBYTES);
+            memcpy(qpks + crypto_scalarmult_BYTES + crypto_kx_PUBLICKEYBYTES,
+                   server_pk, crypto_kx_PUBLICKEYBYTES);
+            crypto_generichash(keys, sizeof keys, qpks, sizeof qpks, NULL, 0U);
+            memcpy(tx[i + j], keys, crypto_kx_SESSIONKEYBYTES);
+            memcpy(rx[i + j], keys + crypto_kx_SESSIONKEYBYTES,
+                   crypto_kx_SESSIONKEYBYTES);
+        }
+    }
+    sodium_memzero(qpks, sizeof qpks);
+    sodium_memzero(q, sizeof q);
+    sodium_memzero(keys, sizeof keys);
+
+    return ret;
+}
+
 size_t
 crypto_kx_publickeybytes(void)
 {
@@ -0,0 +1,1396 @@
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../donna/poly1305_donna.h"
+#include "../onetimeauth_poly1305.h"
+#include "crypto_verify_16.h"
+#include "poly1305_avx2.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+#include "utils.h"
+
+#if defined(HAVE_TI_MODE) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("avx2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+
+typedef __m128i xmmi;
+typedef __m256i ymmi;
+
+# if defined(_MSC_VER)
+#  define POLY1305_NOINLINE __declspec(noinline)
+# elif defined(__clang__) || defined(__GNUC__)
+#  define POLY1305_NOINLINE __attribute__((noinline))
+# else
+#  define POLY1305_NOINLINE
+# endif
+
+# define poly1305_block_size 32
+
+/* below this, the 2-lane SSE2 code is faster than setting up 4 lanes */
+# define poly1305_avx2_min_bytes 512
+
+/* below this, one-shot MACs are computed faster by the scalar code */
+# define poly1305_vector_min_bytes 160
+
+enum poly1305_state_flags_t {
+    poly1305_started       = 1,
+    poly1305_final_shift8  = 4,
+    poly1305_final_shift16 = 8,
+    poly1305_final_r2_r    = 16, /* use [r^2,r] for the final block */
+    poly1305_final_r_1     = 32  /* use [r,1] for the final block */
+};
+
+typedef struct poly1305_state_internal_t {
+    union {
+        uint64_t h[3];
+        uint32_t hh[10];
+    } H;                                            /*  40 bytes */
+    uint32_t           R[5];                        /*  20 bytes */
+    uint32_t           R2[5];                       /*  20 bytes */
+    uint32_t           R3[5];                       /*  20 bytes */
+    uint32_t           R4[5];                       /*  20 bytes */
+    uint32_t           R8[5];                       /*  20 bytes */
+    uint64_t           pad[2];                      /*  16 bytes */
+    uint64_t           flags;                       /*   8 bytes */
+    unsigned long long leftover;                    /*   8 bytes */
+    unsigned char      buffer[poly1305_block_size]; /*  32 bytes */
+} poly1305_state_internal_t;                        /* 204 bytes total */
+
+/*
+ * _mm_loadl_epi64() is turned into a simple MOVQ. So, unaligned accesses are
+ * totally fine, even though this intrinsic requires a __m128i* input.
+ * This confuses dynamic analysis, so force alignment, only in debug mode.
+ */
+# ifdef DEBUG
+static xmmi
+_fakealign_mm_loadl_epi64(const void *m)
+{
+    xmmi tmp;
+    memcpy(&tmp, m, 8);
+
+    return _mm_loadl_epi64(&tmp);
+}
+# define _mm_loadl_epi64(X) _fakealign_mm_loadl_epi64(X)
+#endif
+
+/* copy 0-31 bytes */
+static inline void
+poly1305_block_copy31(unsigned char *dst, const unsigned char *src,
+                      unsigned long long bytes)
+{
+    if (bytes & 16) {
+        _mm_store_si128((xmmi *) (void *) dst,
+                        _mm_loadu_si128((const xmmi *) (const void *) src));
+        src += 16;
+        dst += 16;
+    }
+    if (bytes & 8) {
+        memcpy(dst, src, 8);
+        src += 8;
+        dst += 8;
+    }
+    if (bytes & 4) {
+        memcpy(dst, src, 4);
+        src += 4;
+        dst += 4;
+    }
+    if (bytes & 2) {
+        memcpy(dst, src, 2);
+        src += 2;
+        dst += 2;
+    }
+    if (bytes & 1) {
+        *dst = *src;
+    }
+}
+
+/* r = a * b, radix 2^44 */
+static void
+poly1305_mul44(uint64_t r[3], const uint64_t a[3], const uint64_t b[3])
+{
+    uint128_t d[3];
+    uint64_t  s1, s2, c;
+
+    s1 = b[1] * (5 << 2);
+    s2 = b[2] * (5 << 2);
+
+    d[0] = ((uint128_t) a[0] * b[0]) + ((uint128_t) a[1] * s2) +
+           ((uint128_t) a[2] * s1);
+    d[1] = ((uint128_t) a[0] * b[1]) + ((uint128_t) a[1] * b[0]) +
+           ((uint128_t) a[2] * s2);
+    d[2] = ((uint128_t) a[0] * b[2]) + ((uint128_t) a[1] * b[1]) +
+           ((uint128_t) a[2] * b[0]);
+
+    r[0] = (uint64_t) d[0] & 0xfffffffffff;
+    c    = (uint64_t)(d[0] >> 44);
+    d[1] += c;
+
+    r[1] = (uint64_t) d[1] & 0xfffffffffff;
+    c    = (uint64_t)(d[1] >> 44);
+    d[2] += c;
+
+    r[2] = (uint64_t) d[2] & 0x3ffffffffff;
+    c    = (uint64_t)(d[2] >> 42);
+    r[0] += c * 5;
+    c    = (r[0] >> 44);
+    r[0] = r[0] & 0xfffffffffff;
+    r[1] += c;
+    c    = (r[1] >> 44);
+    r[1] = r[1] & 0xfffffffffff;
+    r[2] += c; /* even if r[2] overflows, it will still fit in rp4 safely,
+                  and is safe to multiply with */
+}
+
+static void
+poly1305_store26(uint32_t R[5], const uint64_t rt[3])
+{
+    R[0] = (uint32_t)(rt[0]) &0x3ffffff;
+    R[1] = (uint32_t)((rt[0] >> 26) | (rt[1] << 18)) & 0x3ffffff;
+    R[2] = (uint32_t)((rt[1] >> 8)) & 0x3ffffff;
+    R[3] = (uint32_t)((rt[1] >> 34) | (rt[2] << 10)) & 0x3ffffff;
+    R[4] = (uint32_t)((rt[2] >> 16));
+}
+
+static POLY1305_NOINLINE void
+poly1305_init_ext(poly1305_state_internal_t *st, const unsigned char key[32],
+                  unsigned long long bytes)
+{
+    uint64_t r[3], r2[3], r3[3], r4[3], r8[3];
+    uint64_t t0, t1;
+
+    if (!bytes) {
+        bytes = ~(unsigned long long) 0;
+    }
+    /* H = 0 */
+    _mm_storeu_si128((xmmi *) (void *) &st->H.hh[0], _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) &st->H.hh[4], _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) &st->H.hh[8], _mm_setzero_si128());
+
+    /* clamp key */
+    memcpy(&t0, key, 8);
+    memcpy(&t1, key + 8, 8);
+    r[0] = t0 & 0xffc0fffffff;
+    t0 >>= 44;
+    t0 |= t1 << 20;
+    r[1] = t0 & 0xfffffc0ffff;
+    t1 >>= 24;
+    r[2] = t1 & 0x00ffffffc0f;
+
+    /* r^1 */
+    poly1305_store26(st->R, r);
+
+    /* save pad */
+    memcpy(&st->pad[0], key + 16, 8);
+    memcpy(&st->pad[1], key + 24, 8);
+
+    /* r^2, r^3, r^4, r^8 */
+    if (bytes > 16) {
+        poly1305_mul44(r2, r, r);
+        poly1305_store26(st->R2, r2);
+        if (bytes >= 96) {
+            poly1305_mul44(r4, r2, r2);
+            poly1305_store26(st->R4, r4);
+        }
+        if (bytes >= poly1305_avx2_min_bytes) {
+            poly1305_mul44(r3, r2, r);
+            poly1305_mul44(r8, r4, r4);
+            poly1305_store26(st->R3, r3);
+            poly1305_store26(st->R8, r8);
+        }
+    }
+    st->flags    = 0;
+    st->leftover = 0U;
+}
+
+static inline void
+poly1305_load_r_avx2(ymmi r[5], ymmi s[5], const uint32_t R[5])
+{
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        r[i] = _mm256_set1_epi64x(R[i]);
+        s[i] = _mm256_add_epi64(r[i], _mm256_slli_epi64(r[i], 2));
+    }
+}
+
+/* T += H * R */
+# define POLY1305_MUL_AVX2(T, H, R, S)                               \
+    do {                                                             \
+        T[0] = _mm256_add_epi64(T[0], _mm256_mul_epu32(H[0], R[0])); \
+        T[1] = _mm256_add_epi64(T[1], _mm256_mul_epu32(H[0], R[1])); \
+        T[2] = _mm256_add_epi64(T[2], _mm256_mul_epu32(H[0], R[2])); \
+        T[3] = _mm256_add_epi64(T[3], _mm256_mul_epu32(H[0], R[3])); \
+        T[4] = _mm256_add_epi64(T[4], _mm256_mul_epu32(H[0], R[4])); \
+        T[0] = _mm256_add_epi64(T[0], _mm256_mul_epu32(H[1], S[4])); \
+        T[1] = _mm256_add_epi64(T[1], _mm256_mul_epu32(H[1], R[0])); \
+        T[2] = _mm256_add_epi64(T[2], _mm256_mul_epu32(H[1], R[1])); \
+        T[3] = _mm256_add_epi64(T[3], _mm256_mul_epu32(H[1], R[2])); \
+        T[4] = _mm256_add_epi64(T[4], _mm256_mul_epu32(H[1], R[3])); \
+        T[0] = _mm256_add_epi64(T[0], _mm256_mul_epu32(H[2], S[3])); \
+        T[1] = _mm256_add_epi64(T[1], _mm256_mul_epu32(H[2], S[4])); \
+        T[2] = _mm256_add_epi64(T[2], _mm256_mul_epu32(H[2], R[0])); \
+        T[3] = _mm256_add_epi64(T[3], _mm256_mul_epu32(H[2], R[1])); \
+        T[4] = _mm256_add_epi64(T[4], _mm256_mul_epu32(H[2], R[2])); \
+        T[0] = _mm256_add_epi64(T[0], _mm256_mul_epu32(H[3], S[2])); \
+        T[1] = _mm256_add_epi64(T[1], _mm256_mul_epu32(H[3], S[3])); \
+        T[2] = _mm256_add_epi64(T[2], _mm256_mul_epu32(H[3], S[4])); \
+        T[3] = _mm256_add_epi64(T[3], _mm256_mul_epu32(H[3], R[0])); \
+        T[4] = _mm256_add_epi64(T[4], _mm256_mul_epu32(H[3], R[1])); \
+        T[0] = _mm256_add_epi64(T[0], _mm256_mul_epu32(H[4], S[1])); \
+        T[1] = _mm256_add_epi64(T[1], _mm256_mul_epu32(H[4], S[2])); \
+        T[2] = _mm256_add_epi64(T[2], _mm256_mul_epu32(H[4], S[3])); \
+        T[3] = _mm256_add_epi64(T[3], _mm256_mul_epu32(H[4], S[4])); \
+        T[4] = _mm256_add_epi64(T[4], _mm256_mul_epu32(H[4], R[0])); \
+    } while (0)
+
+/* split 4 consecutive blocks into 26-bit limbs, one block per lane */
+static inline void
+poly1305_load_m_avx2(ymmi mm[5], const unsigned char *m)
+{
+    const ymmi MMASK = _mm256_set1_epi64x((1 << 26) - 1);
+    const ymmi HIBIT = _mm256_set1_epi64x(1 << 24);
+    ymmi       T5, T6, lo, hi;
+
+    T5 = _mm256_loadu_si256((const ymmi *) (const void *) (m + 0));
+    T6 = _mm256_loadu_si256((const ymmi *) (const void *) (m + 32));
+    lo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(T5, T6), 0xd8);
+    hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(T5, T6), 0xd8);
+
+    mm[0] = _mm256_and_si256(MMASK, lo);
+    mm[1] = _mm256_and_si256(MMASK, _mm256_srli_epi64(lo, 26));
+    mm[2] = _mm256_and_si256(MMASK, _mm256_or_si256(_mm256_srli_epi64(lo, 52),
+                                                    _mm256_slli_epi64(hi, 12)));
+    mm[3] = _mm256_and_si256(MMASK, _mm256_srli_epi64(hi, 14));
+    mm[4] = _mm256_or_si256(_mm256_srli_epi64(hi, 40), HIBIT);
+}
+
+static inline void
+poly1305_reduce_avx2(ymmi t[5])
+{
+    const ymmi MMASK = _mm256_set1_epi64x((1 << 26) - 1);
+    ymmi       C;
+
+    C    = _mm256_srli_epi64(t[0], 26);
+    t[0] = _mm256_and_si256(t[0], MMASK);
+    t[1] = _mm256_add_epi64(t[1], C);
+    C    = _mm256_srli_epi64(t[3], 26);
+    t[3] = _mm256_and_si256(t[3], MMASK);
+    t[4] = _mm256_add_epi64(t[4], C);
+    C    = _mm256_srli_epi64(t[1], 26);
+    t[1] = _mm256_and_si256(t[1], MMASK);
+    t[2] = _mm256_add_epi64(t[2], C);
+    C    = _mm256_srli_epi64(t[4], 26);
+    t[4] = _mm256_and_si256(t[4], MMASK);
+    t[0] = _mm256_add_epi64(t[0], _mm256_add_epi64(C, _mm256_slli_epi64(C, 2)));
+    C    = _mm256_srli_epi64(t[2], 26);
+    t[2] = _mm256_and_si256(t[2], MMASK);
+    t[3] = _mm256_add_epi64(t[3], C);
+    C    = _mm256_srli_epi64(t[0], 26);
+    t[0] = _mm256_and_si256(t[0], MMASK);
+    t[1] = _mm256_add_epi64(t[1], C);
+    C    = _mm256_srli_epi64(t[3], 26);
+    t[3] = _mm256_and_si256(t[3], MMASK);
+    t[4] = _mm256_add_epi64(t[4], C);
+}
+
+/*
+ * Process 4 blocks per lane step with one block per 64-bit lane:
+ * H = H * [r^4,r^4,r^4,r^4] + [M0,M1,M2,M3], two steps at a time
+ * (H * r^8 + M * r^4 + M') so that the two products are independent.
+ *
+ * The 2-lane state [Hx,Hy] used by the SSE2 code is equivalent to
+ * [0,0,Hx,Hy] with 4 lanes, and 4 lanes are folded back into [0,W]
+ * with W = H0*r^3 + H1*r^2 + H2*r + H3.
+ */
+static POLY1305_NOINLINE unsigned long long
+poly1305_blocks_avx2(poly1305_state_internal_t *st, const unsigned char *m,
+                     unsigned long long bytes)
+{
+    CRYPTO_ALIGN(32) uint64_t t64[5][4];
+    ymmi                      h[5], t[5], mm[5];
+    ymmi                      r4[5], s4[5], r8[5], s8[5];
+    uint64_t                  w[5];
+    uint64_t                  c;
+    int                       i;
+
+    for (i = 0; i < 5; i++) {
+        if (st->flags & poly1305_started) {
+            h[i] = _mm256_set_epi64x(st->H.hh[2 * i + 1], st->H.hh[2 * i],
+                                     0, 0);
+        } else {
+            h[i] = _mm256_setzero_si256();
+        }
+    }
+    poly1305_load_r_avx2(r4, s4, st->R4);
+    if (bytes >= 128) {
+        poly1305_load_r_avx2(r8, s8, st->R8);
+        do {
+            poly1305_load_m_avx2(mm, m);
+            for (i = 0; i < 5; i++) {
+                t[i] = _mm256_setzero_si256();
+            }
+            POLY1305_MUL_AVX2(t, h, r8, s8);
+            POLY1305_MUL_AVX2(t, mm, r4, s4);
+            poly1305_load_m_avx2(mm, m + 64);
+            for (i = 0; i < 5; i++) {
+                h[i] = _mm256_add_epi64(t[i], mm[i]);
+            }
+            poly1305_reduce_avx2(h);
+            m += 128;
+            bytes -= 128;
+        } while (bytes >= 128);
+    }
+    if (bytes >= 64) {
+        poly1305_load_m_avx2(mm, m);
+        for (i = 0; i < 5; i++) {
+            t[i] = _mm256_setzero_si256();
+        }
+        POLY1305_MUL_AVX2(t, h, r4, s4);
+        for (i = 0; i < 5; i++) {
+            h[i] = _mm256_add_epi64(t[i], mm[i]);
+        }
+        poly1305_reduce_avx2(h);
+        m += 64;
+        bytes -= 64;
+    }
+
+    /* H *= [r^3,r^2,r,1] */
+    for (i = 0; i < 5; i++) {
+        r4[i] = _mm256_set_epi64x(i == 0, st->R[i], st->R2[i], st->R3[i]);
+        s4[i] = _mm256_add_epi64(r4[i], _mm256_slli_epi64(r4[i], 2));
+        t[i]  = _mm256_setzero_si256();
+    }
+    POLY1305_MUL_AVX2(t, h, r4, s4);
+
+    /* W = sum of the lanes */
+    for (i = 0; i < 5; i++) {
+        _mm256_store_si256((ymmi *) (void *) t64[i], t[i]);
+        w[i] = t64[i][0] + t64[i][1] + t64[i][2] + t64[i][3];
+    }
+    c = w[0] >> 26;
+    w[0] &= 0x3ffffff;
+    w[1] += c;
+    c = w[1] >> 26;
+    w[1] &= 0x3ffffff;
+    w[2] += c;
+    c = w[2] >> 26;
+    w[2] &= 0x3ffffff;
+    w[3] += c;
+    c = w[3] >> 26;
+    w[3] &= 0x3ffffff;
+    w[4] += c;
+    c = w[4] >> 26;
+    w[4] &= 0x3ffffff;
+    w[0] += c * 5;
+    c = w[0] >> 26;
+    w[0] &= 0x3ffffff;
+    w[1] += c;
+
+    /* H = [0,W] */
+    for (i = 0; i < 5; i++) {
+        st->H.hh[2 * i]     = 0;
+        st->H.hh[2 * i + 1] = (uint32_t) w[i];
+    }
+    st->flags |= poly1305_started;
+
+    return bytes;
+}
+
+static POLY1305_NOINLINE void
+poly1305_blocks(poly1305_state_internal_t *st, const unsigned char *m,
+                unsigned long long bytes)
+{
+    CRYPTO_ALIGN(64)
+    xmmi HIBIT =
+        _mm_shuffle_epi32(_mm_cvtsi32_si128(1 << 24), _MM_SHUFFLE(1, 0, 1, 0));
+    const xmmi MMASK = _mm_shuffle_epi32(_mm_cvtsi32_si128((1 << 26) - 1),
+                                         _MM_SHUFFLE(1, 0, 1, 0));
+    const xmmi FIVE =
+        _mm_shuffle_epi32(_mm_cvtsi32_si128(5), _MM_SHUFFLE(1, 0, 1, 0));
+    xmmi H0, H1, H2, H3, H4;
+    xmmi T0, T1, T2, T3, T4, T5, T6, T7, T8;
+    xmmi M0, M1, M2, M3, M4;
+    xmmi M5, M6, M7, M8;
+    xmmi C1, C2;
+    xmmi R20, R21, R22, R23, R24, S21, S22, S23, S24;
+    xmmi R40, R41, R42, R43, R44, S41, S42, S43, S44;
+
+    if (m != NULL && bytes >= poly1305_avx2_min_bytes &&
+        !(st->flags & (poly1305_final_shift8 | poly1305_final_shift16))) {
+        unsigned long long left = poly1305_blocks_avx2(st, m, bytes);
+
+        m += bytes - left;
+        bytes = left;
+        if (bytes == 0) {
+            return;
+        }
+    }
+    if (st->flags & poly1305_final_shift8) {
+        HIBIT = _mm_srli_si128(HIBIT, 8);
+    }
+    if (st->flags & poly1305_final_shift16) {
+        HIBIT = _mm_setzero_si128();
+    }
+    if (!(st->flags & poly1305_started)) {
+        /* H = [Mx,My] */
+        T5 = _mm_unpacklo_epi64(
+            _mm_loadl_epi64((const xmmi *) (const void *) (m + 0)),
+            _mm_loadl_epi64((const xmmi *) (const void *) (m + 16)));
+        T6 = _mm_unpacklo_epi64(
+            _mm_loadl_epi64((const xmmi *) (const void *) (m + 8)),
+            _mm_loadl_epi64((const xmmi *) (const void *) (m + 24)));
+        H0 = _mm_and_si128(MMASK, T5);
+        H1 = _mm_and_si128(MMASK, _mm_srli_epi64(T5, 26));
+        T5 = _mm_or_si128(_mm_srli_epi64(T5, 52), _mm_slli_epi64(T6, 12));
+        H2 = _mm_and_si128(MMASK, T5);
+        H3 = _mm_and_si128(MMASK, _mm_srli_epi64(T5, 26));
+        H4 = _mm_srli_epi64(T6, 40);
+        H4 = _mm_or_si128(H4, HIBIT);
+        m += 32;
+        bytes -= 32;
+        st->flags |= poly1305_started;
+    } else {
+        T0 = _mm_loadu_si128((const xmmi *) (const void *) &st->H.hh[0]);
+        T1 = _mm_loadu_si128((const xmmi *) (const void *) &st->H.hh[4]);
+        T2 = _mm_loadu_si128((const xmmi *) (const void *) &st->H.hh[8]);
+        H0 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(1, 1, 0, 0));
+        H1 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(3, 3, 2, 2));
+        H2 = _mm_shuffle_epi32(T1, _MM_SHUFFLE(1, 1, 0, 0));
+        H3 = _mm_shuffle_epi32(T1, _MM_SHUFFLE(3, 3, 2, 2));
+        H4 = _mm_shuffle_epi32(T2, _MM_SHUFFLE(1, 1, 0, 0));
+    }
+    if (st->flags & (poly1305_final_r2_r | poly1305_final_r_1)) {
+        if (st->flags & poly1305_final_r2_r) {
+            /* use [r^2, r] */
+            T2  = _mm_loadu_si128((const xmmi *) (const void *) &st->R[0]);
+            T3  = _mm_cvtsi32_si128(st->R[4]);
+            T0  = _mm_loadu_si128((const xmmi *) (const void *) &st->R2[0]);
+            T1  = _mm_cvtsi32_si128(st->R2[4]);
+            T4  = _mm_unpacklo_epi32(T0, T2);
+            T5  = _mm_unpackhi_epi32(T0, T2);
+            R24 = _mm_unpacklo_epi64(T1, T3);
+        } else {
+            /* use [r^1, 1] */
+            T0  = _mm_loadu_si128((const xmmi *) (const void *) &st->R[0]);
+            T1  = _mm_cvtsi32_si128(st->R[4]);
+            T2  = _mm_cvtsi32_si128(1);
+            T4  = _mm_unpacklo_epi32(T0, T2);
+            T5  = _mm_unpackhi_epi32(T0, T2);
+            R24 = T1;
+        }
+        R20 = _mm_shuffle_epi32(T4, _MM_SHUFFLE(1, 1, 0, 0));
+        R21 = _mm_shuffle_epi32(T4, _MM_SHUFFLE(3, 3, 2, 2));
+        R22 = _mm_shuffle_epi32(T5, _MM_SHUFFLE(1, 1, 0, 0));
+        R23 = _mm_shuffle_epi32(T5, _MM_SHUFFLE(3, 3, 2, 2));
+    } else {
+        /* use [r^2, r^2] */
+        T0  = _mm_loadu_si128((const xmmi *) (const void *) &st->R2[0]);
+        T1  = _mm_cvtsi32_si128(st->R2[4]);
+        R20 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(0, 0, 0, 0));
+        R21 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(1, 1, 1, 1));
+        R22 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(2, 2, 2, 2));
+        R23 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(3, 3, 3, 3));
+        R24 = _mm_shuffle_epi32(T1, _MM_SHUFFLE(0, 0, 0, 0));
+    }
+    S21 = _mm_mul_epu32(R21, FIVE);
+    S22 = _mm_mul_epu32(R22, FIVE);
+    S23 = _mm_mul_epu32(R23, FIVE);
+    S24 = _mm_mul_epu32(R24, FIVE);
+
+    if (bytes >= 64) {
+        T0  = _mm_loadu_si128((const xmmi *) (const void *) &st->R4[0]);
+        T1  = _mm_cvtsi32_si128(st->R4[4]);
+        R40 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(0, 0, 0, 0));
+        R41 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(1, 1, 1, 1));
+        R42 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(2, 2, 2, 2));
+        R43 = _mm_shuffle_epi32(T0, _MM_SHUFFLE(3, 3, 3, 3));
+        R44 = _mm_shuffle_epi32(T1, _MM_SHUFFLE(0, 0, 0, 0));
+        S41 = _mm_mul_epu32(R41, FIVE);
+        S42 = _mm_mul_epu32(R42, FIVE);
+        S43 = _mm_mul_epu32(R43, FIVE);
+        S44 = _mm_mul_epu32(R44, FIVE);
+
+        while (bytes >= 64) {
+            xmmi v00, v01, v02, v03, v04;
+            xmmi v10, v11, v12, v13, v14;
+            xmmi v20, v21, v22, v23, v24;
+            xmmi v30, v31, v32, v33, v34;
+            xmmi v40, v41, v42, v43, v44;
+            xmmi T14, T15;
+
+            /* H *= [r^4,r^4], preload [Mx,My] */
+            T15 = S42;
+            T0  = H4;
+            T0  = _mm_mul_epu32(T0, S41);
+            v01 = H3;
+            v01 = _mm_mul_epu32(v01, T15);
+            T14 = S43;
+            T1  = H4;
+            T1  = _mm_mul_epu32(T1, T15);
+            v11 = H3;
+            v11 = _mm_mul_epu32(v11, T14);
+            T2  = H4;
+            T2  = _mm_mul_epu32(T2, T14);
+            T0  = _mm_add_epi64(T0, v01);
+            T15 = S44;
+            v02 = H2;
+            v02 = _mm_mul_epu32(v02, T14);
+            T3  = H4;
+            T3  = _mm_mul_epu32(T3, T15);
+            T1  = _mm_add_epi64(T1, v11);
+            v03 = H1;
+            v03 = _mm_mul_epu32(v03, T15);
+            v12 = H2;
+            v12 = _mm_mul_epu32(v12, T15);
+            T0  = _mm_add_epi64(T0, v02);
+            T14 = R40;
+            v21 = H3;
+            v21 = _mm_mul_epu32(v21, T15);
+            v31 = H3;
+            v31 = _mm_mul_epu32(v31, T14);
+            T0  = _mm_add_epi64(T0, v03);
+            T4  = H4;
+            T4  = _mm_mul_epu32(T4, T14);
+            T1  = _mm_add_epi64(T1, v12);
+            v04 = H0;
+            v04 = _mm_mul_epu32(v04, T14);
+            T2  = _mm_add_epi64(T2, v21);
+            v13 = H1;
+            v13 = _mm_mul_epu32(v13, T14);
+            T3  = _mm_add_epi64(T3, v31);
+            T15 = R41;
+            v22 = H2;
+            v22 = _mm_mul_epu32(v22, T14);
+            v32 = H2;
+            v32 = _mm_mul_epu32(v32, T15);
+            T0  = _mm_add_epi64(T0, v04);
+            v41 = H3;
+            v41 = _mm_mul_epu32(v41, T15);
+            T1  = _mm_add_epi64(T1, v13);
+            v14 = H0;
+            v14 = _mm_mul_epu32(v14, T15);
+            T2  = _mm_add_epi64(T2, v22);
+            T14 = R42;
+            T5  = _mm_unpacklo_epi64(
+                _mm_loadl_epi64((const xmmi *) (const void *) (m + 0)),
+                _mm_loadl_epi64((const xmmi *) (const void *) (m + 16)));
+            v23 = H1;
+            v23 = _mm_mul_epu32(v23, T15);
+            T3  = _mm_add_epi64(T3, v32);
+            v33 = H1;
+            v33 = _mm_mul_epu32(v33, T14);
+            T4  = _mm_add_epi64(T4, v41);
+            v42 = H2;
+            v42 = _mm_mul_epu32(v42, T14);
+            T1  = _mm_add_epi64(T1, v14);
+            T15 = R43;
+            T6  = _mm_unpacklo_epi64(
+                _mm_loadl_epi64((const xmmi *) (const void *) (m + 8)),
+                _mm_loadl_epi64((const xmmi *) (const void *) (m + 24)));
+            v24 = H0;
+            v24 = _mm_mul_epu32(v24, T14);
+            T2  = _mm_add_epi64(T2, v23);
+            v34 = H0;
+            v34 = _mm_mul_epu32(v34, T15);
+            T3  = _mm_add_epi64(T3, v33);
+            M0  = _mm_and_si128(MMASK, T5);
+            v43 = H1;
+            v43 = _mm_mul_epu32(v43, T15);
+            T4  = _mm_add_epi64(T4, v42);
+            M1  = _mm_and_si128(MMASK, _mm_srli_epi64(T5, 26));
+            v44 = H0;
+            v44 = _mm_mul_epu32(v44, R44);
+            T2  = _mm_add_epi64(T2, v24);
+            T5  = _mm_or_si128(_mm_srli_epi64(T5, 52), _mm_slli_epi64(T6, 12));
+            T3  = _mm_add_epi64(T3, v34);
+            M3  = _mm_and_si128(MMASK, _mm_srli_epi64(T6, 14));
+            T4  = _mm_add_epi64(T4, v43);
+            M2  = _mm_and_si128(MMASK, T5);
+            T4  = _mm_add_epi64(T4, v44);
+            M4  = _mm_or_si128(_mm_srli_epi64(T6, 40), HIBIT);
+
+            /* H += [Mx',My'] */
+            T5 = _mm_loadu_si128((const xmmi *) (const void *) (m + 32));
+            T6 = _mm_loadu_si128((const xmmi *) (const void *) (m + 48));
+            T7 = _mm_unpacklo_epi32(T5, T6);
+            T8 = _mm_unpackhi_epi32(T5, T6);
+            M5 = _mm_unpacklo_epi32(T7, _mm_setzero_si128());
+            M6 = _mm_unpackhi_epi32(T7, _mm_setzero_si128());
+            M7 = _mm_unpacklo_epi32(T8, _mm_setzero_si128());
+            M8 = _mm_unpackhi_epi32(T8, _mm_setzero_si128());
+            M6 = _mm_slli_epi64(M6, 6);
+            M7 = _mm_slli_epi64(M7, 12);
+            M8 = _mm_slli_epi64(M8, 18);
+            T0 = _mm_add_epi64(T0, M5);
+            T1 = _mm_add_epi64(T1, M6);
+            T2 = _mm_add_epi64(T2, M7);
+            T3 = _mm_add_epi64(T3, M8);
+            T4 = _mm_add_epi64(T4, HIBIT);
+
+            /* H += [Mx,My]*[r^2,r^2] */
+            T15 = S22;
+            v00 = M4;
+            v00 = _mm_mul_epu32(v00, S21);
+            v01 = M3;
+            v01 = _mm_mul_epu32(v01, T15);
+            T14 = S23;
+            v10 = M4;
+            v10 = _mm_mul_epu32(v10, T15);
+            v11 = M3;
+            v11 = _mm_mul_epu32(v11, T14);
+            T0  = _mm_add_epi64(T0, v00);
+            v20 = M4;
+            v20 = _mm_mul_epu32(v20, T14);
+            T0  = _mm_add_epi64(T0, v01);
+            T15 = S24;
+            v02 = M2;
+            v02 = _mm_mul_epu32(v02, T14);
+            T1  = _mm_add_epi64(T1, v10);
+            v30 = M4;
+            v30 = _mm_mul_epu32(v30, T15);
+            T1  = _mm_add_epi64(T1, v11);
+            v03 = M1;
+            v03 = _mm_mul_epu32(v03, T15);
+            T2  = _mm_add_epi64(T2, v20);
+            v12 = M2;
+            v12 = _mm_mul_epu32(v12, T15);
+            T0  = _mm_add_epi64(T0, v02);
+            T14 = R20;
+            v21 = M3;
+            v21 = _mm_mul_epu32(v21, T15);
+            T3  = _mm_add_epi64(T3, v30);
+            v31 = M3;
+            v31 = _mm_mul_epu32(v31, T14);
+            T0  = _mm_add_epi64(T0, v03);
+            v40 = M4;
+            v40 = _mm_mul_epu32(v40, T14);
+            T1  = _mm_add_epi64(T1, v12);
+            v04 = M0;
+            v04 = _mm_mul_epu32(v04, T14);
+            T2  = _mm_add_epi64(T2, v21);
+            v13 = M1;
+            v13 = _mm_mul_epu32(v13, T14);
+            T3  = _mm_add_epi64(T3, v31);
+            T15 = R21;
+            v22 = M2;
+            v22 = _mm_mul_epu32(v22, T14);
+            T4  = _mm_add_epi64(T4, v40);
+            v32 = M2;
+            v32 = _mm_mul_epu32(v32, T15);
+            T0  = _mm_add_epi64(T0, v04);
+            v41 = M3;
+            v41 = _mm_mul_epu32(v41, T15);
+            T1  = _mm_add_epi64(T1, v13);
+            v14 = M0;
+            v14 = _mm_mul_epu32(v14, T15);
+            T2  = _mm_add_epi64(T2, v22);
+            T14 = R22;
+            v23 = M1;
+            v23 = _mm_mul_epu32(v23, T15);
+            T3  = _mm_add_epi64(T3, v32);
+            v33 = M1;
+            v33 = _mm_mul_epu32(v33, T14);
+            T4  = _mm_add_epi64(T4, v41);
+            v42 = M2;
+            v42 = _mm_mul_epu32(v42, T14);
+            T1  = _mm_add_epi64(T1, v14);
+            T15 = R23;
+            v24 = M0;
+            v24 = _mm_mul_epu32(v24, T14);
+            T2  = _mm_add_epi64(T2, v23);
+            v34 = M0;
+            v34 = _mm_mul_epu32(v34, T15);
+            T3  = _mm_add_epi64(T3, v33);
+            v43 = M1;
+            v43 = _mm_mul_epu32(v43, T15);
+            T4  = _mm_add_epi64(T4, v42);
+            v44 = M0;
+            v44 = _mm_mul_epu32(v44, R24);
+            T2  = _mm_add_epi64(T2, v24);
+            T3  = _mm_add_epi64(T3, v34);
+            T4  = _mm_add_epi64(T4, v43);
+            T4  = _mm_add_epi64(T4, v44);
+
+            /* reduce */
+            C1 = _mm_srli_epi64(T0, 26);
+            C2 = _mm_srli_epi64(T3, 26);
+            T0 = _mm_and_si128(T0, MMASK);
+            T3 = _mm_and_si128(T3, MMASK);
+            T1 = _mm_add_epi64(T1, C1);
+            T4 = _mm_add_epi64(T4, C2);
+            C1 = _mm_srli_epi64(T1, 26);
+            C2 = _mm_srli_epi64(T4, 26);
+            T1 = _mm_and_si128(T1, MMASK);
+            T4 = _mm_and_si128(T4, MMASK);
+            T2 = _mm_add_epi64(T2, C1);
+            T0 = _mm_add_epi64(T0, _mm_mul_epu32(C2, FIVE));
+            C1 = _mm_srli_epi64(T2, 26);
+            C2 = _mm_srli_epi64(T0, 26);
+            T2 = _mm_and_si128(T2, MMASK);
+            T0 = _mm_and_si128(T0, MMASK);
+            T3 = _mm_add_epi64(T3, C1);
+            T1 = _mm_add_epi64(T1, C2);
+            C1 = _mm_srli_epi64(T3, 26);
+            T3 = _mm_and_si128(T3, MMASK);
+            T4 = _mm_add_epi64(T4, C1);
+
+            /* Final: H = (H*[r^4,r^4] + [Mx,My]*[r^2,r^2] + [Mx',My']) */
+            H0 = T0;
+            H1 = T1;
+            H2 = T2;
+            H3 = T3;
+            H4 = T4;
+
+            m += 64;
+            bytes -= 64;
+        }
+    }
+
+    if (bytes >= 32) {
+        xmmi v01, v02, v03, v04;
+        xmmi v11, v12, v13, v14;
+        xmmi v21, v22, v23, v24;
+        xmmi v31, v32, v33, v34;
+        xmmi v41, v42, v43, v44;
+        xmmi T14, T15;
+
+        /* H *= [r^2,r^2] */
+        T15 = S22;
+        T0  = H4;
+        T0  = _mm_mul_epu32(T0, S21);
+        v01 = H3;
+        v01 = _mm_mul_epu32(v01, T15);
+        T14 = S23;
+        T1  = H4;
+        T1  = _mm_mul_epu32(T1, T15);
+        v11 = H3;
+        v11 = _mm_mul_epu32(v11, T14);
+        T2  = H4;
+        T2  = _mm_mul_epu32(T2, T14);
+        T0  = _mm_add_epi64(T0, v01);
+        T15 = S24;
+        v02 = H2;
+        v02 = _mm_mul_epu32(v02, T14);
+        T3  = H4;
+        T3  = _mm_mul_epu32(T3, T15);
+        T1  = _mm_add_epi64(T1, v11);
+        v03 = H1;
+        v03 = _mm_mul_epu32(v03, T15);
+        v12 = H2;
+        v12 = _mm_mul_epu32(v12, T15);
+        T0  = _mm_add_epi64(T0, v02);
+        T14 = R20;
+        v21 = H3;
+        v21 = _mm_mul_epu32(v21, T15);
+        v31 = H3;
+        v31 = _mm_mul_epu32(v31, T14);
+        T0  = _mm_add_epi64(T0, v03);
+        T4  = H4;
+        T4  = _mm_mul_epu32(T4, T14);
+        T1  = _mm_add_epi64(T1, v12);
+        v04 = H0;
+        v04 = _mm_mul_epu32(v04, T14);
+        T2  = _mm_add_epi64(T2, v21);
+        v13 = H1;
+        v13 = _mm_mul_epu32(v13, T14);
+        T3  = _mm_add_epi64(T3, v31);
+        T15 = R21;
+        v22 = H2;
+        v22 = _mm_mul_epu32(v22, T14);
+        v32 = H2;
+        v32 = _mm_mul_epu32(v32, T15);
+        T0  = _mm_add_epi64(T0, v04);
+        v41 = H3;
+        v41 = _mm_mul_epu32(v41, T15);
+        T1  = _mm_add_epi64(T1, v13);
+        v14 = H0;
+        v14 = _mm_mul_epu32(v14, T15);
+        T2  = _mm_add_epi64(T2, v22);
+        T14 = R22;
+        v23 = H1;
+        v23 = _mm_mul_epu32(v23, T15);
+        T3  = _mm_add_epi64(T3, v32);
+        v33 = H1;
+        v33 = _mm_mul_epu32(v33, T14);
+        T4  = _mm_add_epi64(T4, v41);
+        v42 = H2;
+        v42 = _mm_mul_epu32(v42, T14);
+        T1  = _mm_add_epi64(T1, v14);
+        T15 = R23;
+        v24 = H0;
+        v24 = _mm_mul_epu32(v24, T14);
+        T2  = _mm_add_epi64(T2, v23);
+        v34 = H0;
+        v34 = _mm_mul_epu32(v34, T15);
+        T3  = _mm_add_epi64(T3, v33);
+        v43 = H1;
+        v43 = _mm_mul_epu32(v43, T15);
+        T4  = _mm_add_epi64(T4, v42);
+        v44 = H0;
+        v44 = _mm_mul_epu32(v44, R24);
+        T2  = _mm_add_epi64(T2, v24);
+        T3  = _mm_add_epi64(T3, v34);
+        T4  = _mm_add_epi64(T4, v43);
+        T4  = _mm_add_epi64(T4, v44);
+
+        /* H += [Mx,My] */
+        if (m) {
+            T5 = _mm_loadu_si128((const xmmi *) (const void *) (m + 0));
+            T6 = _mm_loadu_si128((const xmmi *) (const void *) (m + 16));
+            T7 = _mm_unpacklo_epi32(T5, T6);
+            T8 = _mm_unpackhi_epi32(T5, T6);
+            M0 = _mm_unpacklo_epi32(T7, _mm_setzero_si128());
+            M1 = _mm_unpackhi_epi32(T7, _mm_setzero_si128());
+            M2 = _mm_unpacklo_epi32(T8, _mm_setzero_si128());
+            M3 = _mm_unpackhi_epi32(T8, _mm_setzero_si128());
+            M1 = _mm_slli_epi64(M1, 6);
+            M2 = _mm_slli_epi64(M2, 12);
+            M3 = _mm_slli_epi64(M3, 18);
+            T0 = _mm_add_epi64(T0, M0);
+            T1 = _mm_add_epi64(T1, M1);
+            T2 = _mm_add_epi64(T2, M2);
+            T3 = _mm_add_epi64(T3, M3);
+            T4 = _mm_add_epi64(T4, HIBIT);
+        }
+
+        /* reduce */
+        C1 = _mm_srli_epi64(T0, 26);
+        C2 = _mm_srli_epi64(T3, 26);
+        T0 = _mm_and_si128(T0, MMASK);
+        T3 = _mm_and_si128(T3, MMASK);
+        T1 = _mm_add_epi64(T1, C1);
+        T4 = _mm_add_epi64(T4, C2);
+        C1 = _mm_srli_epi64(T1, 26);
+        C2 = _mm_srli_epi64(T4, 26);
+        T1 = _mm_and_si128(T1, MMASK);
+        T4 = _mm_and_si128(T4, MMASK);
+        T2 = _mm_add_epi64(T2, C1);
+        T0 = _mm_add_epi64(T0, _mm_mul_epu32(C2, FIVE));
+        C1 = _mm_srli_epi64(T2, 26);
+        C2 = _mm_srli_epi64(T0, 26);
+        T2 = _mm_and_si128(T2, MMASK);
+        T0 = _mm_and_si128(T0, MMASK);
+        T3 = _mm_add_epi64(T3, C1);
+        T1 = _mm_add_epi64(T1, C2);
+        C1 = _mm_srli_epi64(T3, 26);
+        T3 = _mm_and_si128(T3, MMASK);
+        T4 = _mm_add_epi64(T4, C1);
+
+        /* H = (H*[r^2,r^2] + [Mx,My]) */
+        H0 = T0;
+        H1 = T1;
+        H2 = T2;
+        H3 = T3;
+        H4 = T4;
+    }
+
+    if (m) {
+        T0 = _mm_shuffle_epi32(H0, _MM_SHUFFLE(0, 0, 2, 0));
+        T1 = _mm_shuffle_epi32(H1, _MM_SHUFFLE(0, 0, 2, 0));
+        T2 = _mm_shuffle_epi32(H2, _MM_SHUFFLE(0, 0, 2, 0));
+        T3 = _mm_shuffle_epi32(H3, _MM_SHUFFLE(0, 0, 2, 0));
+        T4 = _mm_shuffle_epi32(H4, _MM_SHUFFLE(0, 0, 2, 0));
+        T0 = _mm_unpacklo_epi64(T0, T1);
+        T1 = _mm_unpacklo_epi64(T2, T3);
+        _mm_storeu_si128((xmmi *) (void *) &st->H.hh[0], T0);
+        _mm_storeu_si128((xmmi *) (void *) &st->H.hh[4], T1);
+        _mm_storel_epi64((xmmi *) (void *) &st->H.hh[8], T4);
+    } else {
+        uint32_t t0, t1, t2, t3, t4, b;
+        uint64_t h0, h1, h2, g0, g1, g2, c, nc;
+
+        /* H = H[0]+H[1] */
+        T0 = H0;
+        T1 = H1;
+        T2 = H2;
+        T3 = H3;
+        T4 = H4;
+
+        T0 = _mm_add_epi64(T0, _mm_srli_si128(T0, 8));
+        T1 = _mm_add_epi64(T1, _mm_srli_si128(T1, 8));
+        T2 = _mm_add_epi64(T2, _mm_srli_si128(T2, 8));
+        T3 = _mm_add_epi64(T3, _mm_srli_si128(T3, 8));
+        T4 = _mm_add_epi64(T4, _mm_srli_si128(T4, 8));
+
+        t0 = _mm_cvtsi128_si32(T0);
+        b  = (t0 >> 26);
+        t0 &= 0x3ffffff;
+        t1 = _mm_cvtsi128_si32(T1) + b;
+        b  = (t1 >> 26);
+        t1 &= 0x3ffffff;
+        t2 = _mm_cvtsi128_si32(T2) + b;
+        b  = (t2 >> 26);
+        t2 &= 0x3ffffff;
+        t3 = _mm_cvtsi128_si32(T3) + b;
+        b  = (t3 >> 26);
+        t3 &= 0x3ffffff;
+        t4 = _mm_cvtsi128_si32(T4) + b;
+
+        /* everything except t4 is in range, so this is all safe */
+        h0 = (((uint64_t) t0) | ((uint64_t) t1 << 26)) & 0xfffffffffffull;
+        h1 = (((uint64_t) t1 >> 18) | ((uint64_t) t2 << 8) |
+              ((uint64_t) t3 << 34)) &
+             0xfffffffffffull;
+        h2 = (((uint64_t) t3 >> 10) | ((uint64_t) t4 << 16));
+
+        c = (h2 >> 42);
+        h2 &= 0x3ffffffffff;
+        h0 += c * 5;
+        c = (h0 >> 44);
+        h0 &= 0xfffffffffff;
+        h1 += c;
+        c = (h1 >> 44);
+        h1 &= 0xfffffffffff;
+        h2 += c;
+        c = (h2 >> 42);
+        h2 &= 0x3ffffffffff;
+        h0 += c * 5;
+        c = (h0 >> 44);
+        h0 &= 0xfffffffffff;
+        h1 += c;
+
+        g0 = h0 + 5;
+        c  = (g0 >> 44);
+        g0 &= 0xfffffffffff;
+        g1 = h1 + c;
+        c  = (g1 >> 44);
+        g1 &= 0xfffffffffff;
+        g2 = h2 + c - ((uint64_t) 1 << 42);
+
+        c  = (g2 >> 63) - 1;
+        nc = ~c;
+        h0 = (h0 & nc) | (g0 & c);
+        h1 = (h1 & nc) | (g1 & c);
+        h2 = (h2 & nc) | (g2 & c);
+
+        st->H.h[0] = h0;
+        st->H.h[1] = h1;
+        st->H.h[2] = h2;
+    }
+}
+
+static void
+poly1305_update(poly1305_state_internal_t *st, const unsigned char *m,
+                unsigned long long bytes)
+{
+    unsigned long long i;
+
+    /* handle leftover */
+    if (st->leftover) {
+        unsigned long long want = (poly1305_block_size - st->leftover);
+
+        if (want > bytes) {
+            want = bytes;
+        }
+        for (i = 0; i < want; i++) {
+            st->buffer[st->leftover + i] = m[i];
+        }
+        bytes -= want;
+        m += want;
+        st->leftover += want;
+        if (st->leftover < poly1305_block_size) {
+            return;
+        }
+        poly1305_blocks(st, st->buffer, poly1305_block_size);
+        st->leftover = 0;
+    }
+
+    /* process full blocks */
+    if (bytes >= poly1305_block_size) {
+        unsigned long long want = (bytes & ~(poly1305_block_size - 1));
+
+        poly1305_blocks(st, m, want);
+        m += want;
+        bytes -= want;
+    }
+
+    /* store leftover */
+    if (bytes) {
+        for (i = 0; i < bytes; i++) {
+            st->buffer[st->leftover + i] = m[i];
+        }
+        st->leftover += bytes;
+    }
+}
+
+static POLY1305_NOINLINE void
+poly1305_finish_ext(poly1305_state_internal_t *st, const unsigned char *m,
+                    unsigned long long leftover, unsigned char mac[16])
+{
+    uint64_t h0, h1, h2;
+
+    if (leftover) {
+        CRYPTO_ALIGN(16) unsigned char final[32] = { 0 };
+
+        poly1305_block_copy31(final, m, leftover);
+        if (leftover != 16) {
+            final[leftover] = 1;
+        }
+        st->flags |=
+            (leftover >= 16) ? poly1305_final_shift8 : poly1305_final_shift16;
+        poly1305_blocks(st, final, 32);
+    }
+
+    if (st->flags & poly1305_started) {
+        /* finalize, H *= [r^2,r], or H *= [r,1] */
+        if (!leftover || (leftover > 16)) {
+            st->flags |= poly1305_final_r2_r;
+        } else {
+            st->flags |= poly1305_final_r_1;
+        }
+        poly1305_blocks(st, NULL, 32);
+    }
+
+    h0 = st->H.h[0];
+    h1 = st->H.h[1];
+    h2 = st->H.h[2];
+
+    /* pad */
+    h0 = ((h0) | (h1 << 44));
+    h1 = ((h1 >> 20) | (h2 << 24));
+#ifdef HAVE_AMD64_ASM
+    __asm__ __volatile__(
+        "addq %2, %0 ;\n"
+        "adcq %3, %1 ;\n"
+        : "+r"(h0), "+r"(h1)
+        : "r"(st->pad[0]), "r"(st->pad[1])
+        : "flags", "cc");
+#else
+    {
+        uint128_t h;
+
+        memcpy(&h, &st->pad[0], 16);
+        h += ((uint128_t) h1 << 64) | h0;
+        h0 = (uint64_t) h;
+        h1 = (uint64_t)(h >> 64);
+    }
+#endif
+    _mm_storeu_si128((xmmi *) (void *) st + 0, _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) st + 1, _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) st + 2, _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) st + 3, _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) st + 4, _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) st + 5, _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) st + 6, _mm_setzero_si128());
+    _mm_storeu_si128((xmmi *) (void *) st + 7, _mm_setzero_si128());
+
+    memcpy(&mac[0], &h0, 8);
+    memcpy(&mac[8], &h1, 8);
+
+    sodium_memzero((void *) st, sizeof *st);
+}
+
+static void
+poly1305_finish(poly1305_state_internal_t *st, unsigned char mac[16])
+{
+    poly1305_finish_ext(st, st->buffer, st->leftover, mac);
+}
+
+static int
+crypto_onetimeauth_poly1305_avx2_init(crypto_onetimeauth_poly1305_state *state,
+                                      const unsigned char *key)
+{
+    COMPILER_ASSERT(sizeof(crypto_onetimeauth_poly1305_state) >=
+                    sizeof(poly1305_state_internal_t));
+    poly1305_init_ext((poly1305_state_internal_t *) (void *) state, key, 0U);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_avx2_update(
+    crypto_onetimeauth_poly1305_state *state, const unsigned char *in,
+    unsigned long long inlen)
+{
+    poly1305_update((poly1305_state_internal_t *) (void *) state, in, inlen);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_avx2_final(crypto_onetimeauth_poly1305_state *state,
+                                       unsigned char *out)
+{
+    poly1305_finish((poly1305_state_internal_t *) (void *) state, out);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_avx2(unsigned char *out, const unsigned char *m,
+                                 unsigned long long   inlen,
+                                 const unsigned char *key)
+{
+    CRYPTO_ALIGN(64) poly1305_state_internal_t st;
+    unsigned long long                         blocks;
+
+    if (inlen < poly1305_vector_min_bytes) {
+        return crypto_onetimeauth_poly1305_donna_implementation.onetimeauth
+            (out, m, inlen, key);
+    }
+    poly1305_init_ext(&st, key, inlen);
+    blocks = inlen & ~31;
+    if (blocks > 0) {
+        poly1305_blocks(&st, m, blocks);
+        m += blocks;
+        inlen -= blocks;
+    }
+    poly1305_finish_ext(&st, m, inlen, out);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_avx2_verify(const unsigned char *h,
+                                        const unsigned char *in,
+                                        unsigned long long   inlen,
+                                        const unsigned char *k)
+{
+    unsigned char correct[16];
+
+    crypto_onetimeauth_poly1305_avx2(correct, in, inlen, k);
+
+    return crypto_verify_16(h, correct);
+}
+
+/*
+ * Independent messages, one per lane, each with its own key. Lanes that
+ * have consumed all their blocks multiply by 1 until the longest one is
+ * done. Lanes above count duplicate the first message.
+ */
+
+typedef struct poly1305_lane_t {
+    const unsigned char *m;
+    unsigned long long   full_blocks;
+    unsigned long long   blocks;
+    unsigned char        last[16];
+} poly1305_lane_t;
+
+static inline void
+poly1305_load_lanes_avx2(ymmi mm[5], const unsigned char *const p[4],
+                         const ymmi hibit)
+{
+    const ymmi MMASK = _mm256_set1_epi64x((1 << 26) - 1);
+    ymmi       lo, hi;
+
+    lo = _mm256_set_epi64x((long long) LOAD64_LE(p[3]),
+                           (long long) LOAD64_LE(p[2]),
+                           (long long) LOAD64_LE(p[1]),
+                           (long long) LOAD64_LE(p[0]));
+    hi = _mm256_set_epi64x((long long) LOAD64_LE(p[3] + 8),
+                           (long long) LOAD64_LE(p[2] + 8),
+                           (long long) LOAD64_LE(p[1] + 8),
+                           (long long) LOAD64_LE(p[0] + 8));
+    mm[0] = _mm256_and_si256(MMASK, lo);
+    mm[1] = _mm256_and_si256(MMASK, _mm256_srli_epi64(lo, 26));
+    mm[2] = _mm256_and_si256(MMASK, _mm256_or_si256(_mm256_srli_epi64(lo, 52),
+                                                    _mm256_slli_epi64(hi, 12)));
+    mm[3] = _mm256_and_si256(MMASK, _mm256_srli_epi64(hi, 14));
+    mm[4] = _mm256_or_si256(_mm256_srli_epi64(hi, 40), hibit);
+}
+
+static void
+poly1305_finish_lane(unsigned char mac[16], const uint64_t h_[5],
+                     const unsigned char key[32])
+{
+    const uint32_t mask26 = (1UL << 26) - 1;
+    uint32_t       h0, h1, h2, h3, h4;
+    uint32_t       g0, g1, g2, g3, g4;
+    uint32_t       c, mask;
+    uint64_t       f;
+
+    h0 = (uint32_t) h_[0];
+    h1 = (uint32_t) h_[1];
+    h2 = (uint32_t) h_[2];
+    h3 = (uint32_t) h_[3];
+    h4 = (uint32_t) h_[4];
+
+    c = h1 >> 26; h1 &= mask26;
+    h2 += c; c = h2 >> 26; h2 &= mask26;
+    h3 += c; c = h3 >> 26; h3 &= mask26;
+    h4 += c; c = h4 >> 26; h4 &= mask26;
+    h0 += c * 5; c = h0 >> 26; h0 &= mask26;
+    h1 += c;
+
+    g0 = h0 + 5; c = g0 >> 26; g0 &= mask26;
+    g1 = h1 + c; c = g1 >> 26; g1 &= mask26;
+    g2 = h2 + c; c = g2 >> 26; g2 &= mask26;
+    g3 = h3 + c; c = g3 >> 26; g3 &= mask26;
+    g4 = h4 + c - (1UL << 26);
+
+    mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+
+    f = (uint64_t) h0 + LOAD32_LE(key + 16);
+    STORE32_LE(mac + 0, (uint32_t) f);
+    f = (uint64_t) h1 + LOAD32_LE(key + 20) + (f >> 32);
+    STORE32_LE(mac + 4, (uint32_t) f);
+    f = (uint64_t) h2 + LOAD32_LE(key + 24) + (f >> 32);
+    STORE32_LE(mac + 8, (uint32_t) f);
+    f = (uint64_t) h3 + LOAD32_LE(key + 28) + (f >> 32);
+    STORE32_LE(mac + 12, (uint32_t) f);
+}
+
+static POLY1305_NOINLINE void
+poly1305_batch4_avx2(unsigned char *const *macs,
+                     const unsigned char *const *ms,
+                     const unsigned long long *mlens,
+                     const unsigned char *const *keys, size_t count)
+{
+    static const unsigned char zero[16] = { 0 };
+    const ymmi                 HIBIT = _mm256_set1_epi64x(1 << 24);
+    const ymmi                 ONE = _mm256_set1_epi64x(1);
+    poly1305_lane_t            lane[4];
+    const unsigned char       *p[4];
+    const unsigned char       *key;
+    CRYPTO_ALIGN(32) uint64_t  hl[5][4];
+    uint32_t                   R[5][4];
+    long long                  live[4], hib[4];
+    ymmi                       r[5], s[5], r_eff[5], s_eff[5];
+    ymmi                       h[5], mm[5], live_mask;
+    unsigned long long         min_full_blocks, max_blocks, j;
+    unsigned long long         left;
+    size_t                     i, k, src;
+
+    min_full_blocks = ~0ULL;
+    max_blocks = 0U;
+    for (i = 0; i < 4; i++) {
+        src = i < count ? i : 0;
+        key = keys[src];
+        R[0][i] = (LOAD32_LE(key + 0)) & 0x3ffffff;
+        R[1][i] = (LOAD32_LE(key + 3) >> 2) & 0x3ffff03;
+        R[2][i] = (LOAD32_LE(key + 6) >> 4) & 0x3ffc0ff;
+        R[3][i] = (LOAD32_LE(key + 9) >> 6) & 0x3f03fff;
+        R[4][i] = (LOAD32_LE(key + 12) >> 8) & 0x00fffff;
+        lane[i].m = ms[src];
+        lane[i].full_blocks = mlens[src] / 16U;
+        lane[i].blocks = (mlens[src] + 15U) / 16U;
+        memset(lane[i].last, 0, sizeof lane[i].last);
+        left = mlens[src] % 16U;
+        if (left != 0U) {
+            memcpy(lane[i].last, lane[i].m + mlens[src] - left, left);
+            lane[i].last[left] = 1;
+        }
+        if (lane[i].full_blocks < min_full_blocks) {
+            min_full_blocks = lane[i].full_blocks;
+        }
+        if (lane[i].blocks > max_blocks) {
+            max_blocks = lane[i].blocks;
+        }
+    }
+    for (k = 0; k < 5; k++) {
+        r[k] = _mm256_set_epi64x(R[k][3], R[k][2], R[k][1], R[k][0]);
+        s[k] = _mm256_add_epi64(r[k], _mm256_slli_epi64(r[k], 2));
+        h[k] = _mm256_setzero_si256();
+    }
+    for (j = 0; j < min_full_blocks; j++) {
+        for (i = 0; i < 4; i++) {
+            p[i] = lane[i].m + 16U * j;
+        }
+        poly1305_load_lanes_avx2(mm, p, HIBIT);
+        for (k = 0; k < 5; k++) {
+            h[k] = _mm256_add_epi64(h[k], mm[k]);
+            mm[k] = h[k];
+            h[k] = _mm256_setzero_si256();
+        }
+        POLY1305_MUL_AVX2(h, mm, r, s);
+        poly1305_reduce_avx2(h);
+    }
+    for (; j < max_blocks; j++) {
+        for (i = 0; i < 4; i++) {
+            live[i] = -1;
+            hib[i] = 1 << 24;
+            if (j < lane[i].full_blocks) {
+                p[i] = lane[i].m + 16U * j;
+            } else {
+                hib[i] = 0;
+                if (j < lane[i].blocks) {
+                    p[i] = lane[i].last;
+                } else {
+                    p[i] = zero;
+                    live[i] = 0;
+                }
+            }
+        }
+        poly1305_load_lanes_avx2(mm, p,
+                                 _mm256_set_epi64x(hib[3], hib[2], hib[1],
+                                                   hib[0]));
+        live_mask = _mm256_set_epi64x(live[3], live[2], live[1], live[0]);
+        r_eff[0] = _mm256_blendv_epi8(ONE, r[0], live_mask);
+        s_eff[0] = s[0];
+        for (k = 1; k < 5; k++) {
+            r_eff[k] = _mm256_and_si256(r[k], live_mask);
+            s_eff[k] = _mm256_and_si256(s[k], live_mask);
+        }
+        for (k = 0; k < 5; k++) {
+            h[k] = _mm256_add_epi64(h[k], mm[k]);
+            mm[k] = h[k];
+            h[k] = _mm256_setzero_si256();
+        }
+        POLY1305_MUL_AVX2(h, mm, r_eff, s_eff);
+        poly1305_reduce_avx2(h);
+    }
+    for (k = 0; k < 5; k++) {
+        _mm256_store_si256((ymmi *) (void *) hl[k], h[k]);
+    }
+    for (i = 0; i < count; i++) {
+        uint64_t hi[5];
+
+        for (k = 0; k < 5; k++) {
+            hi[k] = hl[k][i];
+        }
+        poly1305_finish_lane(macs[i], hi, keys[i]);
+    }
+    sodium_memzero(hl, sizeof hl);
+    sodium_memzero(R, sizeof R);
+    sodium_memzero(lane, sizeof lane);
+}
+
+static int
+crypto_onetimeauth_poly1305_avx2_batch(unsigned char *const *macs,
+                                       const unsigned char *const *ms,
+                                       const unsigned long long *mlens,
+                                       const unsigned char *const *keys,
+                                       size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i += 4) {
+        poly1305_batch4_avx2(macs + i, ms + i, mlens + i, keys + i,
+                             count - i < 4 ? count - i : 4);
+    }
+    return 0;
+}
+
+struct crypto_onetimeauth_poly1305_implementation
+    crypto_onetimeauth_poly1305_avx2_implementation = {
+        SODIUM_C99(.onetimeauth =) crypto_onetimeauth_poly1305_avx2,
+        SODIUM_C99(.onetimeauth_verify =)
+            crypto_onetimeauth_poly1305_avx2_verify,
+        SODIUM_C99(.onetimeauth_init =) crypto_onetimeauth_poly1305_avx2_init,
+        SODIUM_C99(.onetimeauth_update =)
+            crypto_onetimeauth_poly1305_avx2_update,
+        SODIUM_C99(.onetimeauth_final =) crypto_onetimeauth_poly1305_avx2_final,
+        SODIUM_C99(.onetimeauth_batch =) crypto_onetimeauth_poly1305_avx2_batch
+    };
+
+#endif
@@ -1,7 +1,11 @@
 
+#include <string.h>
+
 #include "poly1305_donna.h"
 #include "crypto_verify_16.h"
 #include "private/common.h"
+#include "private/executor.h"
+#include "private/poly1305_parallel.h"
 #include "utils.h"
 
 #ifdef HAVE_TI_MODE
@@ -55,6 +59,180 @@ poly1305_update(poly1305_state_internal_t *st, const unsigned char *m,
     }
 }
 
+#define POLY1305_PARALLEL_THREADS_MAX 16U
+#define POLY1305_PARALLEL_BLOCKS_MIN  (16384U / poly1305_block_size)
+
+/* a <- a * b, with the field elements held in the h and r limbs */
+static void
+poly1305_mul(poly1305_state_internal_t *a, const poly1305_state_internal_t *b)
+{
+    static const unsigned char zero[poly1305_block_size];
+    poly1305_state_internal_t  t;
+
+    memcpy(t.h, a->h, sizeof t.h);
+    memcpy(t.r, b->h, sizeof t.r);
+    t.final = 1;
+    poly1305_blocks(&t, zero, sizeof zero);
+    memcpy(a->h, t.h, sizeof a->h);
+    sodium_memzero(&t, sizeof t);
+}
+
+/* pw->h <- r^e, for e > 0 */
+static void
+poly1305_pow(poly1305_state_internal_t *pw, const poly1305_state_internal_t *st,
+             unsigned long long e)
+{
+    poly1305_state_internal_t r;
+    int                       i;
+
+    memset(&r, 0, sizeof r);
+    memcpy(r.h, st->r, sizeof r.h);
+    *pw = r;
+    i = 63;
+    while ((e >> i) == 0U) {
+        i--;
+    }
+    while (--i >= 0) {
+        poly1305_mul(pw, pw);
+        if ((e >> i) & 1U) {
+            poly1305_mul(pw, &r);
+        }
+    }
+    sodium_memzero(&r, sizeof r);
+}
+
+static void
+poly1305_add(poly1305_state_internal_t *a, const poly1305_state_internal_t *b)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof a->h / sizeof a->h[0]; i++) {
+        a->h[i] += b->h[i];
+    }
+}
+
+typedef struct poly1305_parallel_job {
+    poly1305_state_internal_t state;
+    const unsigned char      *m;
+    unsigned long long        bytes;
+} poly1305_parallel_job;
+
+static void
+poly1305_parallel_run(poly1305_parallel_job *job)
+{
+    poly1305_blocks(&job->state, job->m, job->bytes);
+}
+
+static void
+poly1305_parallel_task(void *job)
+{
+    poly1305_parallel_run((poly1305_parallel_job *) job);
+}
+
+/*
+ * Full blocks are split into runs, one per thread, each evaluated from
+ * h = 0. For runs of n blocks, the state is then combined as
+ * h = (...(h * r^n0 + h0) * r^n1 + h1...), which is what a single pass
+ * over all the blocks would have computed.
+ */
+static void
+poly1305_update_parallel(poly1305_state_internal_t *st, const unsigned char *m,
+                         unsigned long long bytes, unsigned int threads)
+{
+    CRYPTO_ALIGN(64) poly1305_parallel_job job[POLY1305_PARALLEL_THREADS_MAX];
+    poly1305_state_internal_t pw;
+    sodium_executor_task      task[POLY1305_PARALLEL_THREADS_MAX];
+    unsigned long long        blocks;
+    unsigned long long        run_blocks;
+    unsigned long long        last_blocks;
+    unsigned long long        want;
+    unsigned int              t;
+
+    if (st->leftover) {
+        want = poly1305_block_size - st->leftover;
+        if (want > bytes) {
+            want = bytes;
+        }
+        poly1305_update(st, m, want);
+        m += want;
+        bytes -= want;
+    }
+    blocks = bytes / poly1305_block_size;
+    if (threads > POLY1305_PARALLEL_THREADS_MAX) {
+        threads = POLY1305_PARALLEL_THREADS_MAX;
+    }
+    if ((unsigned long long) threads > blocks / POLY1305_PARALLEL_BLOCKS_MIN) {
+        threads = (unsigned int) (blocks / POLY1305_PARALLEL_BLOCKS_MIN);
+    }
+    if (threads > 1U) {
+        threads = _sodium_executor_threads(threads);
+    }
+    if (threads <= 1U) {
+        poly1305_update(st, m, bytes);
+        return;
+    }
+    run_blocks  = (blocks + threads - 1U) / threads;
+    last_blocks = blocks - run_blocks * (threads - 1U);
+    for (t = 0U; t < threads; t++) {
+        job[t].state = *st;
+        memset(job[t].state.h, 0, sizeof job[t].state.h);
+        job[t].m     = m + run_blocks * poly1305_block_size * t;
+        job[t].bytes = (t == threads - 1U ? last_blocks : run_blocks) *
+                       poly1305_block_size;
+    }
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_start(&task[t], poly1305_parallel_task, &job[t]);
+    }
+    poly1305_parallel_run(&job[0]);
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_finish(&task[t]);
+    }
+    poly1305_pow(&pw, st, run_blocks);
+    for (t = 0U; t < threads - 1U; t++) {
+        poly1305_mul(st, &pw);
+        poly1305_add(st, &job[t].state);
+    }
+    poly1305_pow(&pw, st, last_blocks);
+    poly1305_mul(st, &pw);
+    poly1305_add(st, &job[threads - 1U].state);
+    sodium_memzero(&pw, sizeof pw);
+    sodium_memzero(job, sizeof job);
+
+    bytes -= blocks * poly1305_block_size;
+    poly1305_update(st, m + blocks * poly1305_block_size, bytes);
+}
+
+int
+crypto_onetimeauth_poly1305_parallel_init(
+    crypto_onetimeauth_poly1305_state *state, const unsigned char *key)
+{
+    COMPILER_ASSERT(sizeof(crypto_onetimeauth_poly1305_state) >=
+        sizeof(poly1305_state_internal_t));
+    poly1305_init((poly1305_state_internal_t *) (void *) state, key);
+
+    return 0;
+}
+
+int
+crypto_onetimeauth_poly1305_parallel_update(
+    crypto_onetimeauth_poly1305_state *state, const unsigned char *in,
+    unsigned long long inlen, unsigned int threads)
+{
+    poly1305_update_parallel((poly1305_state_internal_t *) (void *) state, in,
+                             inlen, threads);
+
+    return 0;
+}
+
+int
+crypto_onetimeauth_poly1305_parallel_final(
+    crypto_onetimeauth_poly1305_state *state, unsigned char *out)
+{
+    poly1305_finish((poly1305_state_internal_t *) (void *) state, out);
+
+    return 0;
+}
+
 static int
 crypto_onetimeauth_poly1305_donna(unsigned char *out, const unsigned char *m,
                                   unsigned long long   inlen,
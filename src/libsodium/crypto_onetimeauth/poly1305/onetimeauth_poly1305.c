@@ -1,18 +1,156 @@
 
 #include "onetimeauth_poly1305.h"
 #include "crypto_onetimeauth_poly1305.h"
+#include "private/aliases.h"
 #include "private/common.h"
 #include "private/implementations.h"
 #include "randombytes.h"
 #include "runtime.h"
 
 #include "donna/poly1305_donna.h"
+#if defined(HAVE_ARMNEON) && defined(HAVE_TI_MODE) && \
+    defined(NATIVE_LITTLE_ENDIAN)
+# include "neon/poly1305_neon.h"
+#endif
+#if defined(HAVE_WASM_SIMD128) && defined(HAVE_TI_MODE)
+# include "simd128/poly1305_simd128.h"
+#endif
 #if defined(HAVE_TI_MODE) && defined(HAVE_EMMINTRIN_H)
 # include "sse2/poly1305_sse2.h"
 #endif
+#if defined(HAVE_TI_MODE) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H)
+# include "avx2/poly1305_avx2.h"
+#endif
+
+#if defined(HAVE_IFUNC) && (defined(__x86_64__) || defined(__i386__))
+# define POLY1305_IFUNC
+#endif
+
+/* Used when the implementation doesn't interleave independent messages */
+static int
+crypto_onetimeauth_poly1305_batch_serial(unsigned char *const *macs,
+                                         const unsigned char *const *ms,
+                                         const unsigned long long *mlens,
+                                         const unsigned char *const *keys,
+                                         size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        crypto_onetimeauth_poly1305(macs[i], ms[i], mlens[i], keys[i]);
+    }
+    return 0;
+}
+
+#ifdef POLY1305_IFUNC
+
+/*
+ * The public functions are bound to the implementation by the dynamic
+ * linker, before sodium_init() runs, so calls don't go through a function
+ * pointer. The choice only depends on the CPU and cannot be overridden.
+ */
+static const crypto_onetimeauth_poly1305_implementation *
+_poly1305_ifunc_implementation(const char **name)
+{
+    __builtin_cpu_init();
+# if defined(HAVE_TI_MODE) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H)
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return &crypto_onetimeauth_poly1305_avx2_implementation;
+    }
+# endif
+# if defined(HAVE_TI_MODE) && defined(HAVE_EMMINTRIN_H)
+    if (__builtin_cpu_supports("sse2")) {
+        *name = "sse2";
+        return &crypto_onetimeauth_poly1305_sse2_implementation;
+    }
+# endif
+    *name = "donna";
+    return &crypto_onetimeauth_poly1305_donna_implementation;
+}
+
+# define POLY1305_RESOLVER(FN)                                         \
+    static __typeof__(crypto_onetimeauth_poly1305##FN) *               \
+    crypto_onetimeauth_poly1305##FN##_resolve(void)                   \
+    {                                                                  \
+        const char *name;                                              \
+                                                                       \
+        return _poly1305_ifunc_implementation(&name)->onetimeauth##FN; \
+    }
+
+POLY1305_RESOLVER()
+POLY1305_RESOLVER(_verify)
+POLY1305_RESOLVER(_init)
+POLY1305_RESOLVER(_update)
+POLY1305_RESOLVER(_final)
+
+static __typeof__(crypto_onetimeauth_poly1305_batch) *
+crypto_onetimeauth_poly1305_batch_resolve(void)
+{
+    const char *name;
+    const crypto_onetimeauth_poly1305_implementation *impl =
+        _poly1305_ifunc_implementation(&name);
+
+    if (impl->onetimeauth_batch == NULL) {
+        return crypto_onetimeauth_poly1305_batch_serial;
+    }
+    return impl->onetimeauth_batch;
+}
+
+int crypto_onetimeauth_poly1305(unsigned char *out, const unsigned char *in,
+                                unsigned long long inlen,
+                                const unsigned char *k)
+    __attribute__ ((ifunc("crypto_onetimeauth_poly1305_resolve")));
+
+int crypto_onetimeauth_poly1305_verify(const unsigned char *h,
+                                       const unsigned char *in,
+                                       unsigned long long   inlen,
+                                       const unsigned char *k)
+    __attribute__ ((ifunc("crypto_onetimeauth_poly1305_verify_resolve")));
+
+int crypto_onetimeauth_poly1305_init(crypto_onetimeauth_poly1305_state *state,
+                                     const unsigned char *key)
+    __attribute__ ((ifunc("crypto_onetimeauth_poly1305_init_resolve")));
+
+int crypto_onetimeauth_poly1305_update(crypto_onetimeauth_poly1305_state *state,
+                                       const unsigned char *in,
+                                       unsigned long long inlen)
+    __attribute__ ((ifunc("crypto_onetimeauth_poly1305_update_resolve")));
+
+int crypto_onetimeauth_poly1305_final(crypto_onetimeauth_poly1305_state *state,
+                                      unsigned char *out)
+    __attribute__ ((ifunc("crypto_onetimeauth_poly1305_final_resolve")));
 
+int crypto_onetimeauth_poly1305_batch(unsigned char * const *macs,
+                                      const unsigned char * const *ms,
+                                      const unsigned long long *mlens,
+                                      const unsigned char * const *keys,
+                                      size_t count)
+    __attribute__ ((ifunc("crypto_onetimeauth_poly1305_batch_resolve")));
+
+#else
+
+/* With --with-isa, the implementation for the baseline is fixed */
+# if defined(FIXED_ISA) && defined(__AVX2__) && defined(HAVE_TI_MODE) && \
+    defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H)
+#  define FIXED_IMPLEMENTATION crypto_onetimeauth_poly1305_avx2_implementation
+#  define FIXED_NAME "avx2"
+# elif defined(FIXED_ISA) && defined(__ARM_NEON) && \
+    defined(HAVE_ARMNEON) && defined(HAVE_TI_MODE) && \
+    defined(NATIVE_LITTLE_ENDIAN)
+#  define FIXED_IMPLEMENTATION crypto_onetimeauth_poly1305_neon_implementation
+#  define FIXED_NAME "neon"
+# endif
+
+# ifdef FIXED_NAME
+static const crypto_onetimeauth_poly1305_implementation *const implementation =
+    &FIXED_IMPLEMENTATION;
+# else
 static const crypto_onetimeauth_poly1305_implementation *implementation =
     &crypto_onetimeauth_poly1305_donna_implementation;
+# endif
 
 int
 crypto_onetimeauth_poly1305(unsigned char *out, const unsigned char *in,
@@ -36,6 +174,7 @@ crypto_onetimeauth_poly1305_init(crypto_onetimeauth_poly1305_state *state,
 {
     return implementation->onetimeauth_init(state, key);
 }
+SODIUM_ALIAS_DEF(crypto_onetimeauth_poly1305_init);
 
 int
 crypto_onetimeauth_poly1305_update(crypto_onetimeauth_poly1305_state *state,
@@ -44,6 +183,7 @@ crypto_onetimeauth_poly1305_update(crypto_onetimeauth_poly1305_state *state,
 {
     return implementation->onetimeauth_update(state, in, inlen);
 }
+SODIUM_ALIAS_DEF(crypto_onetimeauth_poly1305_update);
 
 int
 crypto_onetimeauth_poly1305_final(crypto_onetimeauth_poly1305_state *state,
@@ -51,6 +191,23 @@ crypto_onetimeauth_poly1305_final(crypto_onetimeauth_poly1305_state *state,
 {
     return implementation->onetimeauth_final(state, out);
 }
+SODIUM_ALIAS_DEF(crypto_onetimeauth_poly1305_final);
+
+int
+crypto_onetimeauth_poly1305_batch(unsigned char * const *macs,
+                                  const unsigned char * const *ms,
+                                  const unsigned long long *mlens,
+                                  const unsigned char * const *keys,
+                                  size_t count)
+{
+    if (implementation->onetimeauth_batch == NULL) {
+        return crypto_onetimeauth_poly1305_batch_serial(macs, ms, mlens, keys,
+                                                        count);
+    }
+    return implementation->onetimeauth_batch(macs, ms, mlens, keys, count);
+}
+
+#endif
 
 size_t
 crypto_onetimeauth_poly1305_bytes(void)
@@ -80,11 +237,45 @@ crypto_onetimeauth_poly1305_keygen(
 int
 _crypto_onetimeauth_poly1305_pick_best_implementation(void)
 {
+#ifdef POLY1305_IFUNC
+    const char *name;
+
+    (void) _poly1305_ifunc_implementation(&name);
+    _sodium_implementation_selected("poly1305", name);
+#elif defined(FIXED_NAME)
+    _sodium_implementation_selected("poly1305", FIXED_NAME);
+#else
     implementation = &crypto_onetimeauth_poly1305_donna_implementation;
+    _sodium_implementation_selected("poly1305", "donna");
 #if defined(HAVE_TI_MODE) && defined(HAVE_EMMINTRIN_H)
-    if (sodium_runtime_has_sse2()) {
+    if (sodium_runtime_has_sse2() &&
+        _sodium_implementation_allowed("poly1305", "sse2")) {
         implementation = &crypto_onetimeauth_poly1305_sse2_implementation;
+        _sodium_implementation_selected("poly1305", "sse2");
+    }
+#endif
+#if defined(HAVE_TI_MODE) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H)
+    if (sodium_runtime_has_avx2() &&
+        _sodium_implementation_allowed("poly1305", "avx2")) {
+        implementation = &crypto_onetimeauth_poly1305_avx2_implementation;
+        _sodium_implementation_selected("poly1305", "avx2");
+    }
+#endif
+#if defined(HAVE_ARMNEON) && defined(HAVE_TI_MODE) && \
+    defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_neon() &&
+        _sodium_implementation_allowed("poly1305", "neon")) {
+        implementation = &crypto_onetimeauth_poly1305_neon_implementation;
+        _sodium_implementation_selected("poly1305", "neon");
     }
+#endif
+#if defined(HAVE_WASM_SIMD128) && defined(HAVE_TI_MODE)
+    if (_sodium_implementation_allowed("poly1305", "simd128")) {
+        implementation = &crypto_onetimeauth_poly1305_simd128_implementation;
+        _sodium_implementation_selected("poly1305", "simd128");
+    }
+#endif
 #endif
     return 0;
 }
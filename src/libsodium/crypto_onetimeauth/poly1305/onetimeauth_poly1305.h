@@ -16,6 +16,10 @@ typedef struct crypto_onetimeauth_poly1305_implementation {
                               unsigned long long                 inlen);
     int (*onetimeauth_final)(crypto_onetimeauth_poly1305_state *state,
                              unsigned char *                    out);
+    int (*onetimeauth_batch)(unsigned char *const *macs,
+                             const unsigned char *const *ms,
+                             const unsigned long long *mlens,
+                             const unsigned char *const *keys, size_t count);
 } crypto_onetimeauth_poly1305_implementation;
 
 #endif
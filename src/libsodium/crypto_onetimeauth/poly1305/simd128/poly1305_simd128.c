@@ -0,0 +1,466 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "../onetimeauth_poly1305.h"
+#include "crypto_verify_16.h"
+#include "poly1305_simd128.h"
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_WASM_SIMD128) && defined(HAVE_TI_MODE)
+
+# include <wasm_simd128.h>
+
+# include "../donna/poly1305_donna64.h"
+
+/* below this, the scalar code is faster than setting up 2 lanes */
+# define poly1305_simd128_min_bytes 256
+
+typedef struct poly1305_simd128_state_internal_t {
+    poly1305_state_internal_t donna;
+    uint32_t                  R[5];
+    uint32_t                  R2[5];
+    uint32_t                  R4[5];
+    uint32_t                  powers;
+} poly1305_simd128_state_internal_t;
+
+/* r = a * b, radix 2^44 */
+static void
+poly1305_mul44(unsigned long long r[3], const unsigned long long a[3],
+               const unsigned long long b[3])
+{
+    const unsigned long long s1 = b[1] * (5 << 2);
+    const unsigned long long s2 = b[2] * (5 << 2);
+    uint128_t                d0, d1, d2;
+    unsigned long long       c;
+
+    d0 = ((uint128_t) a[0] * b[0]) + ((uint128_t) a[1] * s2) +
+         ((uint128_t) a[2] * s1);
+    d1 = ((uint128_t) a[0] * b[1]) + ((uint128_t) a[1] * b[0]) +
+         ((uint128_t) a[2] * s2);
+    d2 = ((uint128_t) a[0] * b[2]) + ((uint128_t) a[1] * b[1]) +
+         ((uint128_t) a[2] * b[0]);
+
+    c    = SHR(d0, 44);
+    r[0] = LO(d0) & 0xfffffffffff;
+    d1 += c;
+    c    = SHR(d1, 44);
+    r[1] = LO(d1) & 0xfffffffffff;
+    d2 += c;
+    c    = SHR(d2, 42);
+    r[2] = LO(d2) & 0x3ffffffffff;
+    r[0] += c * 5;
+    c    = (r[0] >> 44);
+    r[0] &= 0xfffffffffff;
+    r[1] += c;
+}
+
+/* radix 2^44 -> radix 2^26; the input must be carried */
+static void
+poly1305_store26(uint32_t R[5], const unsigned long long rt[3])
+{
+    R[0] = (uint32_t) (rt[0]) & 0x3ffffff;
+    R[1] = (uint32_t) ((rt[0] >> 26) | (rt[1] << 18)) & 0x3ffffff;
+    R[2] = (uint32_t) ((rt[1] >> 8)) & 0x3ffffff;
+    R[3] = (uint32_t) ((rt[1] >> 34) | (rt[2] << 10)) & 0x3ffffff;
+    R[4] = (uint32_t) ((rt[2] >> 16));
+}
+
+static void
+poly1305_powers(poly1305_simd128_state_internal_t *st)
+{
+    unsigned long long r2[3], r4[3];
+
+    poly1305_mul44(r2, st->donna.r, st->donna.r);
+    poly1305_mul44(r4, r2, r2);
+    poly1305_store26(st->R, st->donna.r);
+    poly1305_store26(st->R2, r2);
+    poly1305_store26(st->R4, r4);
+    st->powers = 1;
+}
+
+/* T = H * R, on the low 32 bits of the first two 32-bit lanes */
+# define VMUL(A, B) wasm_u64x2_extmul_low_u32x4((A), (B))
+# define VMULADD(T, A, B) wasm_i64x2_add((T), VMUL((A), (B)))
+# define VNARROW(T) wasm_i32x4_shuffle((T), (T), 0, 2, 0, 2)
+
+# define POLY1305_MUL_SIMD128(T, H, R, S)     \
+    do {                                      \
+        T[0] = VMUL(H[0], R[0]);              \
+        T[1] = VMUL(H[0], R[1]);              \
+        T[2] = VMUL(H[0], R[2]);              \
+        T[3] = VMUL(H[0], R[3]);              \
+        T[4] = VMUL(H[0], R[4]);              \
+        T[0] = VMULADD(T[0], H[1], S[4]);     \
+        T[1] = VMULADD(T[1], H[1], R[0]);     \
+        T[2] = VMULADD(T[2], H[1], R[1]);     \
+        T[3] = VMULADD(T[3], H[1], R[2]);     \
+        T[4] = VMULADD(T[4], H[1], R[3]);     \
+        T[0] = VMULADD(T[0], H[2], S[3]);     \
+        T[1] = VMULADD(T[1], H[2], S[4]);     \
+        T[2] = VMULADD(T[2], H[2], R[0]);     \
+        T[3] = VMULADD(T[3], H[2], R[1]);     \
+        T[4] = VMULADD(T[4], H[2], R[2]);     \
+        T[0] = VMULADD(T[0], H[3], S[2]);     \
+        T[1] = VMULADD(T[1], H[3], S[3]);     \
+        T[2] = VMULADD(T[2], H[3], S[4]);     \
+        T[3] = VMULADD(T[3], H[3], R[0]);     \
+        T[4] = VMULADD(T[4], H[3], R[1]);     \
+        T[0] = VMULADD(T[0], H[4], S[1]);     \
+        T[1] = VMULADD(T[1], H[4], S[2]);     \
+        T[2] = VMULADD(T[2], H[4], S[3]);     \
+        T[3] = VMULADD(T[3], H[4], S[4]);     \
+        T[4] = VMULADD(T[4], H[4], R[0]);     \
+    } while (0)
+
+/* T += H * R */
+# define POLY1305_MULADD_SIMD128(T, H, R, S)  \
+    do {                                      \
+        T[0] = VMULADD(T[0], H[0], R[0]);     \
+        T[1] = VMULADD(T[1], H[0], R[1]);     \
+        T[2] = VMULADD(T[2], H[0], R[2]);     \
+        T[3] = VMULADD(T[3], H[0], R[3]);     \
+        T[4] = VMULADD(T[4], H[0], R[4]);     \
+        T[0] = VMULADD(T[0], H[1], S[4]);     \
+        T[1] = VMULADD(T[1], H[1], R[0]);     \
+        T[2] = VMULADD(T[2], H[1], R[1]);     \
+        T[3] = VMULADD(T[3], H[1], R[2]);     \
+        T[4] = VMULADD(T[4], H[1], R[3]);     \
+        T[0] = VMULADD(T[0], H[2], S[3]);     \
+        T[1] = VMULADD(T[1], H[2], S[4]);     \
+        T[2] = VMULADD(T[2], H[2], R[0]);     \
+        T[3] = VMULADD(T[3], H[2], R[1]);     \
+        T[4] = VMULADD(T[4], H[2], R[2]);     \
+        T[0] = VMULADD(T[0], H[3], S[2]);     \
+        T[1] = VMULADD(T[1], H[3], S[3]);     \
+        T[2] = VMULADD(T[2], H[3], S[4]);     \
+        T[3] = VMULADD(T[3], H[3], R[0]);     \
+        T[4] = VMULADD(T[4], H[3], R[1]);     \
+        T[0] = VMULADD(T[0], H[4], S[1]);     \
+        T[1] = VMULADD(T[1], H[4], S[2]);     \
+        T[2] = VMULADD(T[2], H[4], S[3]);     \
+        T[3] = VMULADD(T[3], H[4], S[4]);     \
+        T[4] = VMULADD(T[4], H[4], R[0]);     \
+    } while (0)
+
+static inline void
+poly1305_load_r_simd128(v128_t r[5], v128_t s[5], const uint32_t Ra[5],
+                        const uint32_t Rb[5])
+{
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        r[i] = wasm_i32x4_make(Ra[i], Rb[i], 0, 0);
+        s[i] = wasm_i32x4_add(r[i], wasm_i32x4_shl(r[i], 2));
+    }
+}
+
+/* split 2 consecutive blocks into 26-bit limbs, one block per lane */
+static inline void
+poly1305_load_m_simd128(v128_t mm[5], const unsigned char *m)
+{
+    const v128_t MMASK = wasm_i64x2_splat((1 << 26) - 1);
+    const v128_t HIBIT = wasm_i64x2_splat(1 << 24);
+    const v128_t a     = wasm_v128_load(m + 0);
+    const v128_t b     = wasm_v128_load(m + 16);
+    const v128_t lo    = wasm_i64x2_shuffle(a, b, 0, 2);
+    const v128_t hi    = wasm_i64x2_shuffle(a, b, 1, 3);
+
+    mm[0] = wasm_v128_and(MMASK, lo);
+    mm[1] = wasm_v128_and(MMASK, wasm_u64x2_shr(lo, 26));
+    mm[2] = wasm_v128_and(MMASK, wasm_v128_or(wasm_u64x2_shr(lo, 52),
+                                              wasm_i64x2_shl(hi, 12)));
+    mm[3] = wasm_v128_and(MMASK, wasm_u64x2_shr(hi, 14));
+    mm[4] = wasm_v128_or(wasm_u64x2_shr(hi, 40), HIBIT);
+}
+
+static inline void
+poly1305_reduce_simd128(v128_t h[5], v128_t t[5])
+{
+    const v128_t MMASK = wasm_i64x2_splat((1 << 26) - 1);
+    v128_t       c;
+
+    c    = wasm_u64x2_shr(t[0], 26);
+    t[0] = wasm_v128_and(t[0], MMASK);
+    t[1] = wasm_i64x2_add(t[1], c);
+    c    = wasm_u64x2_shr(t[3], 26);
+    t[3] = wasm_v128_and(t[3], MMASK);
+    t[4] = wasm_i64x2_add(t[4], c);
+    c    = wasm_u64x2_shr(t[1], 26);
+    t[1] = wasm_v128_and(t[1], MMASK);
+    t[2] = wasm_i64x2_add(t[2], c);
+    c    = wasm_u64x2_shr(t[4], 26);
+    t[4] = wasm_v128_and(t[4], MMASK);
+    t[0] = wasm_i64x2_add(t[0], wasm_i64x2_add(c, wasm_i64x2_shl(c, 2)));
+    c    = wasm_u64x2_shr(t[2], 26);
+    t[2] = wasm_v128_and(t[2], MMASK);
+    t[3] = wasm_i64x2_add(t[3], c);
+    c    = wasm_u64x2_shr(t[0], 26);
+    t[0] = wasm_v128_and(t[0], MMASK);
+    t[1] = wasm_i64x2_add(t[1], c);
+    c    = wasm_u64x2_shr(t[3], 26);
+    t[3] = wasm_v128_and(t[3], MMASK);
+    t[4] = wasm_i64x2_add(t[4], c);
+
+    h[0] = VNARROW(t[0]);
+    h[1] = VNARROW(t[1]);
+    h[2] = VNARROW(t[2]);
+    h[3] = VNARROW(t[3]);
+    h[4] = VNARROW(t[4]);
+}
+
+/*
+ * Process 2 blocks per lane step with one block per 64-bit lane:
+ * H = H * [r^2,r^2] + [M0,M1], two steps at a time
+ * (H * r^4 + M * r^2 + M') so that the two products are independent.
+ *
+ * The scalar accumulator is folded into the first block of the first
+ * lane, and the lanes are folded back with H0*r^2 + H1*r.
+ */
+static POLY1305_NOINLINE unsigned long long
+poly1305_blocks_simd128(poly1305_simd128_state_internal_t *st,
+                     const unsigned char *m, unsigned long long bytes)
+{
+    v128_t             t[5], mm[5];
+    v128_t             h[5], mh[5];
+    v128_t             r2[5], s2[5], r4[5], s4[5];
+    uint32_t           hs[5];
+    unsigned long long h0, h1, h2, c;
+    uint64_t           w[5];
+    uint32_t           b;
+    int                i;
+
+    if (!st->powers) {
+        poly1305_powers(st);
+    }
+
+    /* H = [M0 + h, M1] */
+    h0 = st->donna.h[0];
+    h1 = st->donna.h[1];
+    h2 = st->donna.h[2];
+    c  = h1 >> 44;
+    h1 &= 0xfffffffffff;
+    h2 += c;
+    {
+        const unsigned long long hh[3] = { h0, h1, h2 };
+
+        poly1305_store26(hs, hh);
+    }
+    poly1305_load_m_simd128(mm, m);
+    for (i = 0; i < 5; i++) {
+        const v128_t hv = wasm_i64x2_make(hs[i], 0);
+
+        h[i] = VNARROW(wasm_i64x2_add(mm[i], hv));
+    }
+    m += 32;
+    bytes -= 32;
+
+    poly1305_load_r_simd128(r2, s2, st->R2, st->R2);
+    poly1305_load_r_simd128(r4, s4, st->R4, st->R4);
+    while (bytes >= 64) {
+        poly1305_load_m_simd128(mm, m);
+        for (i = 0; i < 5; i++) {
+            mh[i] = VNARROW(mm[i]);
+        }
+        POLY1305_MUL_SIMD128(t, h, r4, s4);
+        POLY1305_MULADD_SIMD128(t, mh, r2, s2);
+        poly1305_load_m_simd128(mm, m + 32);
+        for (i = 0; i < 5; i++) {
+            t[i] = wasm_i64x2_add(t[i], mm[i]);
+        }
+        poly1305_reduce_simd128(h, t);
+        m += 64;
+        bytes -= 64;
+    }
+    if (bytes >= 32) {
+        poly1305_load_m_simd128(mm, m);
+        POLY1305_MUL_SIMD128(t, h, r2, s2);
+        for (i = 0; i < 5; i++) {
+            t[i] = wasm_i64x2_add(t[i], mm[i]);
+        }
+        poly1305_reduce_simd128(h, t);
+        m += 32;
+        bytes -= 32;
+    }
+
+    /* h = H0 * r^2 + H1 * r */
+    poly1305_load_r_simd128(r2, s2, st->R2, st->R);
+    POLY1305_MUL_SIMD128(t, h, r2, s2);
+    for (i = 0; i < 5; i++) {
+        w[i] = wasm_u64x2_extract_lane(t[i], 0) +
+               wasm_u64x2_extract_lane(t[i], 1);
+    }
+    c = w[0] >> 26;
+    w[0] &= 0x3ffffff;
+    w[1] += c;
+    c = w[1] >> 26;
+    w[1] &= 0x3ffffff;
+    w[2] += c;
+    c = w[2] >> 26;
+    w[2] &= 0x3ffffff;
+    w[3] += c;
+    c = w[3] >> 26;
+    w[3] &= 0x3ffffff;
+    w[4] += c;
+    c = w[4] >> 26;
+    w[4] &= 0x3ffffff;
+    w[0] += c * 5;
+    for (i = 0; i < 4; i++) {
+        b = (uint32_t) (w[i] >> 26);
+        w[i] &= 0x3ffffff;
+        w[i + 1] += b;
+    }
+    st->donna.h[0] = (w[0] | (w[1] << 26)) & 0xfffffffffff;
+    st->donna.h[1] = ((w[1] >> 18) | (w[2] << 8) | (w[3] << 34)) &
+                     0xfffffffffff;
+    st->donna.h[2] = (w[3] >> 10) | (w[4] << 16);
+
+    return bytes;
+}
+
+static void
+poly1305_blocks_any(poly1305_simd128_state_internal_t *st, const unsigned char *m,
+                    unsigned long long bytes)
+{
+    if (bytes >= poly1305_simd128_min_bytes) {
+        unsigned long long left = poly1305_blocks_simd128(st, m, bytes);
+
+        m += bytes - left;
+        bytes = left;
+    }
+    if (bytes > 0) {
+        poly1305_blocks(&st->donna, m, bytes);
+    }
+}
+
+static void
+poly1305_simd128_update(poly1305_simd128_state_internal_t *st, const unsigned char *m,
+                     unsigned long long bytes)
+{
+    poly1305_state_internal_t * const ds = &st->donna;
+    unsigned long long                i;
+
+    /* handle leftover */
+    if (ds->leftover) {
+        unsigned long long want = (poly1305_block_size - ds->leftover);
+
+        if (want > bytes) {
+            want = bytes;
+        }
+        for (i = 0; i < want; i++) {
+            ds->buffer[ds->leftover + i] = m[i];
+        }
+        bytes -= want;
+        m += want;
+        ds->leftover += want;
+        if (ds->leftover < poly1305_block_size) {
+            return;
+        }
+        poly1305_blocks(ds, ds->buffer, poly1305_block_size);
+        ds->leftover = 0;
+    }
+
+    /* process full blocks */
+    if (bytes >= poly1305_block_size) {
+        unsigned long long want = (bytes & ~(poly1305_block_size - 1));
+
+        poly1305_blocks_any(st, m, want);
+        m += want;
+        bytes -= want;
+    }
+
+    /* store leftover */
+    if (bytes) {
+        for (i = 0; i < bytes; i++) {
+            ds->buffer[ds->leftover + i] = m[i];
+        }
+        ds->leftover += bytes;
+    }
+}
+
+static void
+poly1305_simd128_init(poly1305_simd128_state_internal_t *st,
+                   const unsigned char key[32])
+{
+    poly1305_init(&st->donna, key);
+    st->powers = 0;
+}
+
+static void
+poly1305_simd128_finish(poly1305_simd128_state_internal_t *st, unsigned char mac[16])
+{
+    poly1305_finish(&st->donna, mac);
+    sodium_memzero((void *) st, sizeof *st);
+}
+
+static int
+crypto_onetimeauth_poly1305_simd128(unsigned char *out, const unsigned char *m,
+                                 unsigned long long   inlen,
+                                 const unsigned char *key)
+{
+    CRYPTO_ALIGN(64) poly1305_simd128_state_internal_t state;
+
+    poly1305_simd128_init(&state, key);
+    poly1305_simd128_update(&state, m, inlen);
+    poly1305_simd128_finish(&state, out);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_simd128_init(crypto_onetimeauth_poly1305_state *state,
+                                      const unsigned char *key)
+{
+    COMPILER_ASSERT(sizeof(crypto_onetimeauth_poly1305_state) >=
+                    sizeof(poly1305_simd128_state_internal_t));
+    poly1305_simd128_init((poly1305_simd128_state_internal_t *) (void *) state, key);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_simd128_update(
+    crypto_onetimeauth_poly1305_state *state, const unsigned char *in,
+    unsigned long long inlen)
+{
+    poly1305_simd128_update((poly1305_simd128_state_internal_t *) (void *) state, in,
+                         inlen);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_simd128_final(crypto_onetimeauth_poly1305_state *state,
+                                       unsigned char *out)
+{
+    poly1305_simd128_finish((poly1305_simd128_state_internal_t *) (void *) state,
+                         out);
+
+    return 0;
+}
+
+static int
+crypto_onetimeauth_poly1305_simd128_verify(const unsigned char *h,
+                                        const unsigned char *in,
+                                        unsigned long long   inlen,
+                                        const unsigned char *k)
+{
+    unsigned char correct[16];
+
+    crypto_onetimeauth_poly1305_simd128(correct, in, inlen, k);
+
+    return crypto_verify_16(h, correct);
+}
+
+struct crypto_onetimeauth_poly1305_implementation
+    crypto_onetimeauth_poly1305_simd128_implementation = {
+        SODIUM_C99(.onetimeauth =) crypto_onetimeauth_poly1305_simd128,
+        SODIUM_C99(.onetimeauth_verify =)
+            crypto_onetimeauth_poly1305_simd128_verify,
+        SODIUM_C99(.onetimeauth_init =) crypto_onetimeauth_poly1305_simd128_init,
+        SODIUM_C99(.onetimeauth_update =)
+            crypto_onetimeauth_poly1305_simd128_update,
+        SODIUM_C99(.onetimeauth_final =) crypto_onetimeauth_poly1305_simd128_final
+    };
+
+#endif
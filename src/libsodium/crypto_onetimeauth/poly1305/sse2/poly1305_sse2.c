@@ -2,6 +2,7 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "../donna/poly1305_donna.h"
 #include "../onetimeauth_poly1305.h"
 #include "crypto_verify_16.h"
 #include "poly1305_sse2.h"
@@ -29,6 +30,9 @@ typedef __m128i xmmi;
 
 # define poly1305_block_size 32
 
+/* below this, one-shot MACs are computed faster by the scalar code */
+# define poly1305_vector_min_bytes 160
+
 enum poly1305_state_flags_t {
     poly1305_started       = 1,
     poly1305_final_shift8  = 4,
@@ -910,6 +914,10 @@ crypto_onetimeauth_poly1305_sse2(unsigned char *out, const unsigned char *m,
     CRYPTO_ALIGN(64) poly1305_state_internal_t st;
     unsigned long long                         blocks;
 
+    if (inlen < poly1305_vector_min_bytes) {
+        return crypto_onetimeauth_poly1305_donna_implementation.onetimeauth
+            (out, m, inlen, key);
+    }
     poly1305_init_ext(&st, key, inlen);
     blocks = inlen & ~31;
     if (blocks > 0) {
@@ -23,8 +23,11 @@
 #endif
 
 #include "crypto_generichash_blake2b.h"
+#include "private/allocator.h"
 #include "private/common.h"
+#include "private/executor.h"
 #include "private/implementations.h"
+#include "private/pwhash_region.h"
 #include "runtime.h"
 #include "utils.h"
 
@@ -45,7 +48,8 @@
 # define MAP_POPULATE 0
 #endif
 
-static fill_segment_fn fill_segment = argon2_fill_segment_ref;
+static fill_segment_fn      fill_segment      = argon2_fill_segment_ref;
+static fill_segment_many_fn fill_segment_many = NULL;
 
 static void
 load_block(block *dst, const void *input)
@@ -66,68 +70,141 @@ store_block(void *output, const block *src)
 }
 
 /***************Memory allocators*****************/
+int
+argon2_region_alloc(block_region *region, size_t memory_size, int populate)
+{
+    void * base;
+    block *memory;
+
+    region->base = region->memory = NULL;
+    region->size = 0;
+    if (memory_size == 0) {
+        return ARGON2_MEMORY_ALLOCATION_ERROR; /* LCOV_EXCL_LINE */
+    }
+
+#if defined(MAP_ANON) && defined(HAVE_MMAP)
+    base = _crypto_pwhash_region_map(&memory_size, populate);
+    memcpy(&memory, &base, sizeof memory);
+#else
+    (void) populate;
+    if (_sodium_allocator_is_set(SODIUM_ALLOC_SCRATCH)) {
+        base = _sodium_allocator_alloc(SODIUM_ALLOC_SCRATCH, memory_size);
+        memcpy(&memory, &base, sizeof memory);
+    } else {
+# if defined(HAVE_POSIX_MEMALIGN)
+        if ((errno = posix_memalign((void **) &base, 64, memory_size)) != 0) {
+            base = NULL;
+        }
+        memcpy(&memory, &base, sizeof memory);
+# else
+        memory = NULL;
+        if (memory_size + 63 < memory_size) {
+            base  = NULL;
+            errno = ENOMEM;
+        } else if ((base = malloc(memory_size + 63)) != NULL) {
+            uint8_t *aligned = ((uint8_t *) base) + 63;
+            aligned -= (uintptr_t) aligned & 63;
+            memcpy(&memory, &aligned, sizeof memory);
+        }
+# endif
+    }
+#endif
+    if (base == NULL) {
+        return ARGON2_MEMORY_ALLOCATION_ERROR; /* LCOV_EXCL_LINE */
+    }
+    region->base   = base;
+    region->memory = memory;
+    region->size   = memory_size;
+
+    return ARGON2_OK;
+}
+
+int
+argon2_region_release(block_region *region)
+{
+    if (region->base != NULL) {
+#if defined(MAP_ANON) && defined(HAVE_MMAP)
+        if (_crypto_pwhash_region_unmap(region->base, region->size)) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+#else
+        sodium_memzero_bulk(region->memory, region->size);
+        if (_sodium_allocator_is_set(SODIUM_ALLOC_SCRATCH)) {
+            _sodium_allocator_free(SODIUM_ALLOC_SCRATCH, region->base,
+                                   region->size);
+        } else {
+            free(region->base);
+        }
+#endif
+    }
+    region->base = region->memory = NULL;
+    region->size = 0;
+
+    return 0;
+}
+
 /* Allocates memory to the given pointer
- * @param memory pointer to the pointer to the memory
+ * @param region the region to initialize
  * @param m_cost number of blocks to allocate in the memory
+ * @param scratch_size additional bytes to allocate after the blocks if
+ * possible, left out if they don't fit in the borrowed memory or budget
+ * @param preallocated memory to use if it is large enough, or NULL
+ * @param populate 0 to leave the pages of a new region untouched
  * @return ARGON2_OK if @memory is a valid pointer and memory is allocated
  */
-static int allocate_memory(block_region **region, uint32_t m_cost);
+static int allocate_memory(block_region *region, uint32_t m_cost,
+                           size_t scratch_size, void *preallocated,
+                           size_t preallocated_size, int populate);
 
 static int
-allocate_memory(block_region **region, uint32_t m_cost)
+allocate_memory(block_region *region, uint32_t m_cost, size_t scratch_size,
+                void *preallocated, size_t preallocated_size, int populate)
 {
-    void * base;
-    block *memory;
     size_t memory_size;
 
     if (region == NULL) {
         return ARGON2_MEMORY_ALLOCATION_ERROR; /* LCOV_EXCL_LINE */
     }
     memory_size = sizeof(block) * m_cost;
-    if (m_cost == 0 || memory_size / m_cost != sizeof(block)) {
+    if (m_cost == 0 || memory_size / m_cost != sizeof(block) ||
+        memory_size + scratch_size < memory_size) {
         return ARGON2_MEMORY_ALLOCATION_ERROR; /* LCOV_EXCL_LINE */
     }
-    *region = (block_region *) malloc(sizeof(block_region));
-    if (*region == NULL) {
-        return ARGON2_MEMORY_ALLOCATION_ERROR; /* LCOV_EXCL_LINE */
+    /* borrowed memory has no base, so that it is wiped instead of unmapped */
+    if (preallocated != NULL && preallocated_size >= memory_size) {
+        region->base = NULL;
+        memcpy(&region->memory, &preallocated, sizeof region->memory);
+        region->size = memory_size;
+        if (preallocated_size - memory_size >= scratch_size) {
+            region->size += scratch_size;
+        }
+        return ARGON2_OK;
     }
-    (*region)->base = (*region)->memory = NULL;
-
-#if defined(MAP_ANON) && defined(HAVE_MMAP)
-    if ((base = mmap(NULL, memory_size, PROT_READ | PROT_WRITE,
-                     MAP_ANON | MAP_PRIVATE | MAP_NOCORE | MAP_POPULATE,
-                     -1, 0)) == MAP_FAILED) {
-        base = NULL; /* LCOV_EXCL_LINE */
-    }                /* LCOV_EXCL_LINE */
-    memcpy(&memory, &base, sizeof memory);
-#elif defined(HAVE_POSIX_MEMALIGN)
-    if ((errno = posix_memalign((void **) &base, 64, memory_size)) != 0) {
-        base = NULL;
+    /* the scratch space alone may push the region over the memory budget */
+    if (argon2_region_alloc(region, memory_size + scratch_size, populate) ==
+        ARGON2_OK) {
+        return ARGON2_OK;
     }
-    memcpy(&memory, &base, sizeof memory);
-#else
-    memory = NULL;
-    if (memory_size + 63 < memory_size) {
-        base  = NULL;
-        errno = ENOMEM;
-    } else if ((base = malloc(memory_size + 63)) != NULL) {
-        uint8_t *aligned = ((uint8_t *) base) + 63;
-        aligned -= (uintptr_t) aligned & 63;
-        memcpy(&memory, &aligned, sizeof memory);
+    return argon2_region_alloc(region, memory_size, populate);
+}
+
+/* Returns the scratch space of @cache, grown to @count values if needed */
+static uint64_t *
+cache_scratch(argon2_address_cache *cache, size_t count)
+{
+    uint64_t *scratch;
+
+    if (cache->scratch_count >= count) {
+        return cache->scratch;
     }
-#endif
-    if (base == NULL) {
-        /* LCOV_EXCL_START */
-        free(*region);
-        *region = NULL;
-        return ARGON2_MEMORY_ALLOCATION_ERROR;
-        /* LCOV_EXCL_STOP */
+    if ((scratch = (uint64_t *) malloc(sizeof(uint64_t) * count)) == NULL) {
+        return NULL; /* LCOV_EXCL_LINE */
     }
-    (*region)->base   = base;
-    (*region)->memory = memory;
-    (*region)->size   = memory_size;
+    free(cache->scratch);
+    cache->scratch       = scratch;
+    cache->scratch_count = count;
 
-    return ARGON2_OK;
+    return scratch;
 }
 
 /*********Memory functions*/
@@ -140,24 +217,82 @@ static void free_memory(block_region *region);
 static void
 free_memory(block_region *region)
 {
-    if (region != NULL && region->base != NULL) {
-#if defined(MAP_ANON) && defined(HAVE_MMAP)
-        if (munmap(region->base, region->size)) {
-            return; /* LCOV_EXCL_LINE */
+    if (region == NULL) {
+        return;
+    }
+    if (region->base == NULL && region->memory != NULL) {
+        sodium_memzero_bulk(region->memory, region->size);
+    } else {
+        (void) argon2_region_release(region);
+    }
+}
+
+void
+argon2_address_cache_free(argon2_address_cache *cache)
+{
+    free(cache->addresses);
+    free(cache->scratch);
+    memset(cache, 0, sizeof *cache);
+}
+
+/* Returns the cached addresses for @instance, computing them if needed */
+static uint64_t *
+cached_addresses(argon2_address_cache *cache, const argon2_instance_t *instance)
+{
+    argon2_position_t position;
+    uint64_t         *addresses;
+    uint32_t          passes, slices;
+
+    if (cache == NULL) {
+        return NULL;
+    }
+    if (cache->addresses != NULL && cache->passes == instance->passes &&
+        cache->memory_blocks == instance->memory_blocks &&
+        cache->lanes == instance->lanes && cache->type == instance->type) {
+        return cache->addresses;
+    }
+    passes = instance->type == Argon2_id ? 1U : instance->passes;
+    slices = instance->type == Argon2_id ?
+        ARGON2_SYNC_POINTS / 2 : ARGON2_SYNC_POINTS;
+    if (passes > ARGON2_ADDRESS_CACHE_PASSES_MAX) {
+        return NULL;
+    }
+    free(cache->addresses);
+    cache->addresses = NULL;
+    if ((addresses = (uint64_t *)
+         malloc(sizeof(uint64_t) * passes * slices * instance->lanes *
+                instance->segment_length)) == NULL) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    cache->addresses = addresses;
+    position.index   = 0;
+    for (position.pass = 0; position.pass < passes; position.pass++) {
+        for (position.slice = 0; position.slice < slices; position.slice++) {
+            for (position.lane = 0; position.lane < instance->lanes;
+                 position.lane++) {
+                argon2_generate_addresses_ref(instance, &position,
+                                              addresses);
+                addresses += instance->segment_length;
+            }
         }
-#else
-        free(region->base);
-#endif
     }
-    free(region);
+    cache->passes        = instance->passes;
+    cache->memory_blocks = instance->memory_blocks;
+    cache->lanes         = instance->lanes;
+    cache->type          = instance->type;
+
+    return cache->addresses;
 }
 
-static void
+void
 argon2_free_instance(argon2_instance_t *instance, int flags)
 {
     /* Deallocate the memory */
-    free(instance->pseudo_rands);
-    instance->pseudo_rands = NULL;
+    if (instance->pseudo_rands_owned) {
+        free(instance->pseudo_rands);
+    }
+    instance->pseudo_rands       = NULL;
+    instance->pseudo_rands_owned = 0;
     free_memory(instance->region);
     instance->region = NULL;
 }
@@ -196,24 +331,162 @@ argon2_finalize(const argon2_context *context, argon2_instance_t *instance)
     }
 }
 
-void
+static void
+fill_lanes(const argon2_thread_data *data)
+{
+    argon2_position_t position = data->pos;
+    uint32_t          l;
+
+    for (l = data->pos.lane; l < data->instance_ptr->lanes;
+         l += data->lane_step) {
+        position.lane  = l;
+        position.index = 0;
+        fill_segment(data->instance_ptr, position);
+    }
+}
+
+static void
+fill_lanes_task(void *data)
+{
+    fill_lanes((const argon2_thread_data *) data);
+}
+
+static void
+touch_lanes(const argon2_thread_data *data)
+{
+    const argon2_instance_t *instance = data->instance_ptr;
+    volatile uint8_t        *lane;
+    size_t                   lane_bytes;
+    size_t                   i;
+    uint32_t                 l;
+
+    lane_bytes = (size_t) instance->lane_length * sizeof(block);
+    for (l = data->pos.lane; l < instance->lanes; l += data->lane_step) {
+        lane = (volatile uint8_t *) (void *)
+            (instance->region->memory + (size_t) l * instance->lane_length);
+        for (i = 0; i < lane_bytes; i += ARGON2_TOUCH_STRIDE) {
+            lane[i] = 0;
+        }
+    }
+}
+
+static void
+touch_lanes_task(void *data)
+{
+    touch_lanes((const argon2_thread_data *) data);
+}
+
+/*
+ * Faults in the pages of every lane from the thread that is going to fill
+ * it, so that on NUMA systems, they are allocated on the node that thread
+ * runs on, instead of all on the node of the calling thread.
+ */
+static void
+argon2_touch_lanes(argon2_instance_t *instance)
+{
+    argon2_thread_data   data[ARGON2_FILL_THREADS_MAX];
+    sodium_executor_task task[ARGON2_FILL_THREADS_MAX];
+    uint32_t             threads = instance->threads;
+    uint32_t             t;
+
+    for (t = 0; t < threads; ++t) {
+        memset(&data[t], 0, sizeof data[t]);
+        data[t].instance_ptr = instance;
+        data[t].pos.lane     = t;
+        data[t].lane_step    = threads;
+    }
+    for (t = 1; t < threads; ++t) {
+        _sodium_executor_start(&task[t], touch_lanes_task, &data[t]);
+    }
+    touch_lanes(&data[0]);
+    for (t = 1; t < threads; ++t) {
+        _sodium_executor_finish(&task[t]);
+    }
+}
+
+/*
+ * Segments of the same slice are independent, so the lanes of a slice are
+ * split among instance->threads threads, which are all joined before the
+ * next slice starts. Lane l is always filled by thread l % threads. If the executor cannot
+ * take a task, its lanes are filled by the calling thread.
+ * The progress callback is only called from the calling thread, once all
+ * the segments of a slice have been filled.
+ */
+int
 argon2_fill_memory_blocks(argon2_instance_t *instance, uint32_t pass)
 {
-    argon2_position_t position;
-    uint32_t l;
-    uint32_t s;
+    argon2_thread_data   data[ARGON2_FILL_THREADS_MAX];
+    sodium_executor_task task[ARGON2_FILL_THREADS_MAX];
+    uint32_t             threads;
+    uint32_t             s;
+    uint32_t             t;
 
     if (instance == NULL || instance->lanes == 0) {
-        return; /* LCOV_EXCL_LINE */
+        return ARGON2_INCORRECT_PARAMETER; /* LCOV_EXCL_LINE */
+    }
+    threads = instance->threads;
+    for (s = 0; s < ARGON2_SYNC_POINTS; ++s) {
+        for (t = 0; t < threads; ++t) {
+            data[t].instance_ptr = instance;
+            data[t].pos.pass     = pass;
+            data[t].pos.slice    = (uint8_t) s;
+            data[t].pos.lane     = t;
+            data[t].pos.index    = 0;
+            data[t].lane_step    = threads;
+        }
+        for (t = 1; t < threads; ++t) {
+            _sodium_executor_start(&task[t], fill_lanes_task, &data[t]);
+        }
+        fill_lanes(&data[0]);
+        for (t = 1; t < threads; ++t) {
+            _sodium_executor_finish(&task[t]);
+        }
+        if (instance->progress != NULL &&
+            instance->progress(instance->progress_opaque,
+                               (unsigned long long) pass * ARGON2_SYNC_POINTS +
+                                   s + 1U,
+                               (unsigned long long) instance->passes *
+                                   ARGON2_SYNC_POINTS) != 0) {
+            return ARGON2_CANCELED;
+        }
     }
+    return ARGON2_OK;
+}
+
+/*
+ * A block can only be computed once the previous one is, so that when its
+ * reference block isn't cached, a single instance stalls. With
+ * fill_segment_many(), instances take turns filling one block, and the
+ * reference block of the next one is prefetched while the other instances
+ * compute theirs. Implementations without it fill the segments one after
+ * the other.
+ */
+void
+argon2_fill_memory_blocks_many(argon2_instance_t * const *instances,
+                               size_t count, uint32_t pass)
+{
+    argon2_position_t position;
+    size_t            k;
+    uint32_t          s;
+    int               data_independent_addressing;
 
-    position.pass = pass;
+    position.pass  = pass;
+    position.index = 0;
     for (s = 0; s < ARGON2_SYNC_POINTS; ++s) {
         position.slice = (uint8_t) s;
-        for (l = 0; l < instance->lanes; ++l) {
-            position.lane  = l;
-            position.index = 0;
-            fill_segment(instance, position);
+        data_independent_addressing = instances[0]->type == Argon2_i ||
+            (pass == 0 && s < ARGON2_SYNC_POINTS / 2);
+        for (position.lane = 0; position.lane < instances[0]->lanes;
+             position.lane++) {
+            if (fill_segment_many != NULL && count > 1U &&
+                (!data_independent_addressing ||
+                 instances[0]->addresses != NULL)) {
+                fill_segment_many(instances, count, position);
+                continue;
+            }
+            for (k = 0; k < count; ++k) {
+                fill_segment(instances[k], position);
+            }
         }
     }
 }
@@ -346,25 +619,44 @@ argon2_validate_inputs(const argon2_context *context)
 static void
 argon2_fill_first_blocks(uint8_t *blockhash, const argon2_instance_t *instance)
 {
-    uint32_t l;
     /* Make the first and second block in each lane as G(H0||i||0) or
-       G(H0||i||1) */
-    uint8_t blockhash_bytes[ARGON2_BLOCK_SIZE];
-    for (l = 0; l < instance->lanes; ++l) {
-        STORE32_LE(blockhash + ARGON2_PREHASH_DIGEST_LENGTH, 0);
-        STORE32_LE(blockhash + ARGON2_PREHASH_DIGEST_LENGTH + 4, l);
-        blake2b_long(blockhash_bytes, ARGON2_BLOCK_SIZE, blockhash,
-                     ARGON2_PREHASH_SEED_LENGTH);
-        load_block(&instance->region->memory[l * instance->lane_length + 0],
-                   blockhash_bytes);
-
-        STORE32_LE(blockhash + ARGON2_PREHASH_DIGEST_LENGTH, 1);
-        blake2b_long(blockhash_bytes, ARGON2_BLOCK_SIZE, blockhash,
-                     ARGON2_PREHASH_SEED_LENGTH);
-        load_block(&instance->region->memory[l * instance->lane_length + 1],
-                   blockhash_bytes);
-    }
-    sodium_memzero(blockhash_bytes, ARGON2_BLOCK_SIZE);
+       G(H0||i||1); the 2 * lanes hashes are independent, and are computed
+       BLAKE2B_LONG_MULTI_MAX at a time */
+    uint8_t     seeds[BLAKE2B_LONG_MULTI_MAX][ARGON2_PREHASH_SEED_LENGTH];
+    uint8_t     blockhash_bytes[BLAKE2B_LONG_MULTI_MAX][ARGON2_BLOCK_SIZE];
+    void       *out[BLAKE2B_LONG_MULTI_MAX];
+    const void *in[BLAKE2B_LONG_MULTI_MAX];
+    uint32_t    count = 2U * instance->lanes;
+    uint32_t    b;
+    uint32_t    i;
+    uint32_t    n;
+
+    for (i = 0; i < BLAKE2B_LONG_MULTI_MAX; ++i) {
+        memcpy(seeds[i], blockhash, ARGON2_PREHASH_DIGEST_LENGTH);
+        out[i] = blockhash_bytes[i];
+        in[i]  = seeds[i];
+    }
+    for (b = 0; b < count; b += n) {
+        n = count - b;
+        if (n > BLAKE2B_LONG_MULTI_MAX) {
+            n = BLAKE2B_LONG_MULTI_MAX;
+        }
+        for (i = 0; i < n; ++i) {
+            STORE32_LE(seeds[i] + ARGON2_PREHASH_DIGEST_LENGTH, (b + i) & 1U);
+            STORE32_LE(seeds[i] + ARGON2_PREHASH_DIGEST_LENGTH + 4,
+                       (b + i) >> 1);
+        }
+        blake2b_long_multi(out, ARGON2_BLOCK_SIZE, in,
+                           ARGON2_PREHASH_SEED_LENGTH, n);
+        for (i = 0; i < n; ++i) {
+            load_block(&instance->region->memory[((b + i) >> 1) *
+                                                 instance->lane_length +
+                                                 ((b + i) & 1U)],
+                       blockhash_bytes[i]);
+        }
+    }
+    sodium_memzero(seeds, sizeof seeds);
+    sodium_memzero(blockhash_bytes, sizeof blockhash_bytes);
 }
 
 static void
@@ -455,24 +747,65 @@ int
 argon2_initialize(argon2_instance_t *instance, argon2_context *context)
 {
     uint8_t blockhash[ARGON2_PREHASH_SEED_LENGTH];
+    size_t  memory_size;
+    size_t  scratch_count;
     int     result = ARGON2_OK;
 
     if (instance == NULL || context == NULL) {
         return ARGON2_INCORRECT_PARAMETER;
     }
+    instance->region             = NULL;
+    instance->pseudo_rands       = NULL;
+    instance->pseudo_rands_owned = 0;
 
     /* 1. Memory allocation */
 
-    if ((instance->pseudo_rands = (uint64_t *)
-         malloc(sizeof(uint64_t) * instance->segment_length)) == NULL) {
-        return ARGON2_MEMORY_ALLOCATION_ERROR;
+    /* each thread filling lanes needs its own pseudo-random values */
+    if (instance->threads > instance->lanes) {
+        instance->threads = instance->lanes;
+    }
+    if (instance->threads > ARGON2_FILL_THREADS_MAX) {
+        instance->threads = ARGON2_FILL_THREADS_MAX;
     }
+    instance->threads = _sodium_executor_threads(instance->threads);
 
-    result = allocate_memory(&(instance->region), instance->memory_blocks);
+    /*
+     * The pseudo-random values go after the blocks, or in the scratch space
+     * of the address cache if the memory was borrowed, so that hashing
+     * doesn't need any other allocation.
+     */
+    scratch_count = (size_t) instance->segment_length * instance->threads;
+    result = allocate_memory(&instance->region_storage,
+                             instance->memory_blocks,
+                             sizeof(uint64_t) * scratch_count,
+                             context->memory, context->memory_size,
+                             instance->threads <= 1);
     if (ARGON2_OK != result) {
-        argon2_free_instance(instance, context->flags);
         return result;
     }
+    instance->region = &instance->region_storage;
+    memory_size = sizeof(block) * instance->memory_blocks;
+    if (instance->region->size - memory_size >=
+        sizeof(uint64_t) * scratch_count) {
+        instance->pseudo_rands =
+            (uint64_t *) (void *) (instance->region->memory +
+                                   instance->memory_blocks);
+    } else if (context->address_cache != NULL) {
+        instance->pseudo_rands =
+            cache_scratch(context->address_cache, scratch_count);
+    } else {
+        instance->pseudo_rands = (uint64_t *)
+            malloc(sizeof(uint64_t) * scratch_count);
+        instance->pseudo_rands_owned = 1;
+    }
+    if (instance->pseudo_rands == NULL) {
+        argon2_free_instance(instance, context->flags); /* LCOV_EXCL_LINE */
+        return ARGON2_MEMORY_ALLOCATION_ERROR;          /* LCOV_EXCL_LINE */
+    }
+    if (instance->threads > 1 && instance->region->base != NULL) {
+        argon2_touch_lanes(instance);
+    }
+    instance->addresses = cached_addresses(context->address_cache, instance);
 
     /* 2. Initial hashing */
     /* H_0 + 8 extra bytes to produce the first blocks */
@@ -498,25 +831,54 @@ argon2_pick_best_implementation(void)
 /* LCOV_EXCL_START */
 #if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
     defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
-    if (sodium_runtime_has_avx512f()) {
-        fill_segment = argon2_fill_segment_avx512f;
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors() &&
+        _sodium_implementation_allowed("argon2", "avx512f")) {
+        fill_segment      = argon2_fill_segment_avx512f;
+        fill_segment_many = argon2_fill_segment_many_avx512f;
+        _sodium_implementation_selected("argon2", "avx512f");
         return 0;
     }
 #endif
 #if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
     defined(HAVE_SMMINTRIN_H)
-    if (sodium_runtime_has_avx2()) {
-        fill_segment = argon2_fill_segment_avx2;
+    if (sodium_runtime_has_avx2() &&
+        _sodium_implementation_allowed("argon2", "avx2")) {
+        fill_segment      = argon2_fill_segment_avx2;
+        fill_segment_many = argon2_fill_segment_many_avx2;
+        _sodium_implementation_selected("argon2", "avx2");
         return 0;
     }
 #endif
 #if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H)
-    if (sodium_runtime_has_ssse3()) {
-        fill_segment = argon2_fill_segment_ssse3;
+    if (sodium_runtime_has_ssse3() &&
+        _sodium_implementation_allowed("argon2", "ssse3")) {
+        fill_segment      = argon2_fill_segment_ssse3;
+        fill_segment_many = NULL;
+        _sodium_implementation_selected("argon2", "ssse3");
+        return 0;
+    }
+#endif
+#if defined(HAVE_WASM_SIMD128)
+    /* The module would not load on a runtime without SIMD support */
+    if (_sodium_implementation_allowed("argon2", "simd128")) {
+        fill_segment      = argon2_fill_segment_simd128;
+        fill_segment_many = NULL;
+        _sodium_implementation_selected("argon2", "simd128");
+        return 0;
+    }
+#endif
+#if defined(HAVE_ARMNEON)
+    if (sodium_runtime_has_neon() &&
+        _sodium_implementation_allowed("argon2", "neon")) {
+        fill_segment      = argon2_fill_segment_neon;
+        fill_segment_many = NULL;
+        _sodium_implementation_selected("argon2", "neon");
         return 0;
     }
 #endif
-    fill_segment = argon2_fill_segment_ref;
+    fill_segment      = argon2_fill_segment_ref;
+    fill_segment_many = NULL;
+    _sodium_implementation_selected("argon2", "ref");
 
     return 0;
     /* LCOV_EXCL_STOP */
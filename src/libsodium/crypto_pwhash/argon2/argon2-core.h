@@ -61,6 +61,16 @@ typedef struct block_region_ {
     size_t size;
 } block_region;
 
+/*
+ * Maps a region of at least @memory_size bytes, aligned for blocks.
+ * Pages are faulted in right away, unless @populate is 0.
+ */
+int argon2_region_alloc(block_region *region, size_t memory_size,
+                        int populate);
+
+/* Unmaps a region returned by argon2_region_alloc() */
+int argon2_region_release(block_region *region);
+
 /*****************Functions that work with the block******************/
 
 /* Initialize each byte of the block with @in */
@@ -95,16 +105,21 @@ xor_block(block *dst, const block *src)
  */
 typedef struct Argon2_instance_t {
     block_region *region;        /* Memory region pointer */
+    block_region  region_storage;
     uint64_t     *pseudo_rands;
+    int           pseudo_rands_owned; /* pseudo_rands were malloc()ed */
+    uint64_t     *addresses;     /* cached data-independent addresses, or NULL */
     uint32_t      passes;        /* Number of passes */
     uint32_t      current_pass;
     uint32_t      memory_blocks; /* Number of blocks in memory */
     uint32_t      segment_length;
     uint32_t      lane_length;
     uint32_t      lanes;
-    uint32_t      threads;
+    uint32_t      threads;       /* Number of threads filling lanes */
     argon2_type   type;
     int           print_internals; /* whether to print the memory blocks */
+    argon2_progress_callback progress;
+    void                    *progress_opaque;
 } argon2_instance_t;
 
 /*
@@ -118,10 +133,56 @@ typedef struct Argon2_position_t {
     uint32_t index;
 } argon2_position_t;
 
-/*Struct that holds the inputs for thread handling FillSegment*/
+/* Maximum number of instances filled in lockstep by argon2_ctx_many() */
+#define ARGON2_MANY_MAX 2U
+
+/* Maximum number of threads filling the lanes of a slice concurrently */
+#define ARGON2_FILL_THREADS_MAX 16U
+
+/* Distance between the bytes written to fault in the pages of a lane */
+#define ARGON2_TOUCH_STRIDE 4096U
+
+/*
+ * The pseudo-random values of data-independent segments only depend on the
+ * parameters, so that they can be computed once and reused by consecutive
+ * computations. Argon2i caches are limited to 16 passes, i.e. 1/8 of the
+ * memory size.
+ */
+#define ARGON2_ADDRESS_CACHE_PASSES_MAX 16U
+
+typedef struct Argon2_AddressCache {
+    uint64_t   *addresses;
+    uint64_t   *scratch;       /* reused as pseudo_rands */
+    size_t      scratch_count;
+    uint32_t    passes;
+    uint32_t    memory_blocks;
+    uint32_t    lanes;
+    argon2_type type;
+} argon2_address_cache;
+
+void argon2_address_cache_free(argon2_address_cache *cache);
+
+/* Cached pseudo-random values of a data-independent segment */
+static inline uint64_t *
+argon2_cached_addresses(const argon2_instance_t *instance,
+                        const argon2_position_t *position)
+{
+    const size_t slices = instance->type == Argon2_id ?
+        ARGON2_SYNC_POINTS / 2 : ARGON2_SYNC_POINTS;
+
+    return instance->addresses +
+        (((size_t) position->pass * slices + position->slice) *
+         instance->lanes + position->lane) * instance->segment_length;
+}
+
+/*
+ * Struct that holds the inputs for thread handling FillSegment: lanes
+ * pos.lane, pos.lane + lane_step, ... of the slice are filled.
+ */
 typedef struct Argon2_thread_data {
     argon2_instance_t *instance_ptr;
     argon2_position_t  pos;
+    uint32_t           lane_step;
 } argon2_thread_data;
 
 /*************************Argon2 core
@@ -208,6 +269,61 @@ static uint32_t index_alpha(const argon2_instance_t *instance,
     return absolute_position;
 }
 
+/*
+ * In data-independent segments, reference blocks are known in advance: the
+ * one needed ARGON2_PREFETCH_DISTANCE blocks ahead can be prefetched, for
+ * hosts where the memory latency of large instances is not already hidden
+ * by out-of-order execution. 0 (the default) disables prefetching.
+ */
+#ifndef ARGON2_PREFETCH_DISTANCE
+# define ARGON2_PREFETCH_DISTANCE 0U
+#endif
+
+/* Returns the reference block of @position.index for @pseudo_rand */
+static inline block *
+argon2_ref_block(const argon2_instance_t *instance,
+                 const argon2_position_t *position, uint64_t pseudo_rand)
+{
+    uint32_t ref_lane;
+
+    ref_lane = (uint32_t) ((pseudo_rand >> 32) % instance->lanes);
+    if (position->pass == 0 && position->slice == 0) {
+        ref_lane = position->lane;
+    }
+    return instance->region->memory + (size_t) instance->lane_length * ref_lane +
+        index_alpha(instance, position, (uint32_t) pseudo_rand,
+                    ref_lane == position->lane);
+}
+
+static inline void
+argon2_prefetch_block(const block *b)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    const unsigned char *ptr = (const unsigned char *) b->v;
+    size_t               j;
+
+    for (j = 0U; j < ARGON2_BLOCK_SIZE; j += 64U) {
+        __builtin_prefetch(ptr + j);
+    }
+#else
+    (void) b;
+#endif
+}
+
+static inline void
+argon2_prefetch_ref_block(const argon2_instance_t *instance,
+                          argon2_position_t position,
+                          const uint64_t *pseudo_rands, uint32_t i)
+{
+    i += ARGON2_PREFETCH_DISTANCE;
+    if (ARGON2_PREFETCH_DISTANCE == 0U || i >= instance->segment_length) {
+        return;
+    }
+    position.index = i;
+    argon2_prefetch_block(argon2_ref_block(instance, &position,
+                                           pseudo_rands[i]));
+}
+
 /*
  * Function that validates all inputs against predefined restrictions and return
  * an error code
@@ -243,6 +359,12 @@ int argon2_initialize(argon2_instance_t *instance, argon2_context *context);
 void argon2_finalize(const argon2_context *context,
                      argon2_instance_t *instance);
 
+/*
+ * Releases the memory of an instance, without computing the tag
+ * @param instance Pointer to current instance of Argon2
+ */
+void argon2_free_instance(argon2_instance_t *instance, int flags);
+
 /*
  * Function that fills the segment using previous segments also from other
  * threads
@@ -258,15 +380,44 @@ void argon2_fill_segment_avx2(const argon2_instance_t *instance,
                               argon2_position_t        position);
 void argon2_fill_segment_ssse3(const argon2_instance_t *instance,
                                argon2_position_t        position);
+void argon2_fill_segment_neon(const argon2_instance_t *instance,
+                              argon2_position_t        position);
+void argon2_fill_segment_simd128(const argon2_instance_t *instance,
+                                 argon2_position_t        position);
+void argon2_generate_addresses_ref(const argon2_instance_t *instance,
+                                   const argon2_position_t *position,
+                                   uint64_t *pseudo_rands);
 void argon2_fill_segment_ref(const argon2_instance_t *instance,
                              argon2_position_t        position);
 
 /*
- * Function that fills the entire memory t_cost times based on the first two
+ * Fills the same segment of @count instances with the same parameters,
+ * one block of each instance at a time. Data-independent segments must use
+ * cached addresses, shared by all the instances.
+ */
+typedef void (*fill_segment_many_fn)(argon2_instance_t * const *instances,
+                                     size_t count, argon2_position_t position);
+void argon2_fill_segment_many_avx512f(argon2_instance_t * const *instances,
+                                      size_t count,
+                                      argon2_position_t position);
+void argon2_fill_segment_many_avx2(argon2_instance_t * const *instances,
+                                   size_t count, argon2_position_t position);
+
+/*
+ * Function that fills the entire memory for one pass, based on the first two
  * blocks in each lane
  * @param instance Pointer to the current instance
- * @return Zero if successful, -1 if memory failed to allocate
+ * @return ARGON2_OK, or ARGON2_CANCELED if the progress callback asked to stop
+ */
+int argon2_fill_memory_blocks(argon2_instance_t *instance, uint32_t pass);
+
+/*
+ * Fills the memory of @count instances with the same parameters for one
+ * pass, from the calling thread, one block of each instance at a time
+ * @param instances Array of pointers to the instances
+ * @param count Number of instances, at most ARGON2_MANY_MAX
  */
-void argon2_fill_memory_blocks(argon2_instance_t *instance, uint32_t pass);
+void argon2_fill_memory_blocks_many(argon2_instance_t * const *instances,
+                                    size_t count, uint32_t pass);
 
 #endif
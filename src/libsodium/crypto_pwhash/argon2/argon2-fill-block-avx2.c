@@ -163,10 +163,15 @@ argon2_fill_segment_avx2(const argon2_instance_t *instance,
         data_independent_addressing = 0;
     }
 
-    pseudo_rands = instance->pseudo_rands;
+    pseudo_rands = instance->pseudo_rands +
+        (size_t) (position.lane % instance->threads) * instance->segment_length;
 
     if (data_independent_addressing) {
-        generate_addresses(instance, &position, pseudo_rands);
+        if (instance->addresses != NULL) {
+            pseudo_rands = argon2_cached_addresses(instance, &position);
+        } else {
+            generate_addresses(instance, &position, pseudo_rands);
+        }
     }
 
     starting_index = 0;
@@ -204,6 +209,7 @@ argon2_fill_segment_avx2(const argon2_instance_t *instance,
 #pragma warning(disable : 6385)
             pseudo_rand = pseudo_rands[i];
 #pragma warning(pop)
+            argon2_prefetch_ref_block(instance, position, pseudo_rands, i);
         } else {
             pseudo_rand = instance->region->memory[prev_offset].v[0];
         }
@@ -236,4 +242,76 @@ argon2_fill_segment_avx2(const argon2_instance_t *instance,
         }
     }
 }
+
+void
+argon2_fill_segment_many_avx2(argon2_instance_t * const *instances,
+                              size_t count, argon2_position_t position)
+{
+    const argon2_instance_t *instance = instances[0];
+    const uint64_t          *pseudo_rands = NULL;
+    block                   *ref_blocks[ARGON2_MANY_MAX];
+    block                   *curr_block;
+    uint64_t                 pseudo_rand;
+    uint32_t                 prev_offset, curr_offset;
+    uint32_t                 starting_index, i;
+    __m256i                  state[ARGON2_MANY_MAX][ARGON2_HWORDS_IN_BLOCK];
+    size_t                   k;
+    int                      data_independent_addressing = 1;
+
+    if (instance->type == Argon2_id &&
+        (position.pass != 0 || position.slice >= ARGON2_SYNC_POINTS / 2)) {
+        data_independent_addressing = 0;
+    }
+    if (data_independent_addressing) {
+        pseudo_rands = argon2_cached_addresses(instance, &position);
+    }
+
+    starting_index = 0;
+
+    if ((0 == position.pass) && (0 == position.slice)) {
+        starting_index = 2; /* we have already generated the first two blocks */
+    }
+
+    curr_offset = position.lane * instance->lane_length +
+                  position.slice * instance->segment_length + starting_index;
+
+    if (0 == curr_offset % instance->lane_length) {
+        prev_offset = curr_offset + instance->lane_length - 1;
+    } else {
+        prev_offset = curr_offset - 1;
+    }
+
+    position.index = starting_index;
+    for (k = 0; k < count; ++k) {
+        memcpy(state[k], ((instances[k]->region->memory + prev_offset)->v),
+               ARGON2_BLOCK_SIZE);
+        pseudo_rand = data_independent_addressing ?
+            pseudo_rands[starting_index] :
+            instances[k]->region->memory[prev_offset].v[0];
+        ref_blocks[k] = argon2_ref_block(instances[k], &position, pseudo_rand);
+    }
+
+    for (i = starting_index; i < instance->segment_length;
+         ++i, ++curr_offset) {
+        for (k = 0; k < count; ++k) {
+            curr_block = instances[k]->region->memory + curr_offset;
+            if (position.pass != 0) {
+                fill_block_with_xor(state[k], (uint8_t *) ref_blocks[k]->v,
+                                    (uint8_t *) curr_block->v);
+            } else {
+                fill_block(state[k], (uint8_t *) ref_blocks[k]->v,
+                           (uint8_t *) curr_block->v);
+            }
+            if (i + 1 < instance->segment_length) {
+                /* the next reference block is loaded during the other fills */
+                position.index = i + 1;
+                pseudo_rand = data_independent_addressing ?
+                    pseudo_rands[i + 1] : curr_block->v[0];
+                ref_blocks[k] =
+                    argon2_ref_block(instances[k], &position, pseudo_rand);
+                argon2_prefetch_block(ref_blocks[k]);
+            }
+        }
+    }
+}
 #endif
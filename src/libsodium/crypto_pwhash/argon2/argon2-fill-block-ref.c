@@ -140,6 +140,14 @@ generate_addresses(const argon2_instance_t *instance,
     }
 }
 
+void
+argon2_generate_addresses_ref(const argon2_instance_t *instance,
+                              const argon2_position_t *position,
+                              uint64_t *pseudo_rands)
+{
+    generate_addresses(instance, position, pseudo_rands);
+}
+
 void
 argon2_fill_segment_ref(const argon2_instance_t *instance,
                         argon2_position_t position)
@@ -162,10 +170,15 @@ argon2_fill_segment_ref(const argon2_instance_t *instance,
         data_independent_addressing = 0;
     }
 
-    pseudo_rands = instance->pseudo_rands;
+    pseudo_rands = instance->pseudo_rands +
+        (size_t) (position.lane % instance->threads) * instance->segment_length;
 
     if (data_independent_addressing) {
-        generate_addresses(instance, &position, pseudo_rands);
+        if (instance->addresses != NULL) {
+            pseudo_rands = argon2_cached_addresses(instance, &position);
+        } else {
+            generate_addresses(instance, &position, pseudo_rands);
+        }
     }
 
     starting_index = 0;
@@ -200,6 +213,7 @@ argon2_fill_segment_ref(const argon2_instance_t *instance,
 #pragma warning(disable : 6385)
             pseudo_rand = pseudo_rands[i];
 #pragma warning(pop)
+            argon2_prefetch_ref_block(instance, position, pseudo_rands, i);
         } else {
             pseudo_rand = instance->region->memory[prev_offset].v[0];
         }
@@ -162,10 +162,15 @@ argon2_fill_segment_ssse3(const argon2_instance_t *instance,
         data_independent_addressing = 0;
     }
 
-    pseudo_rands = instance->pseudo_rands;
+    pseudo_rands = instance->pseudo_rands +
+        (size_t) (position.lane % instance->threads) * instance->segment_length;
 
     if (data_independent_addressing) {
-        generate_addresses(instance, &position, pseudo_rands);
+        if (instance->addresses != NULL) {
+            pseudo_rands = argon2_cached_addresses(instance, &position);
+        } else {
+            generate_addresses(instance, &position, pseudo_rands);
+        }
     }
 
     starting_index = 0;
@@ -203,6 +208,7 @@ argon2_fill_segment_ssse3(const argon2_instance_t *instance,
 #pragma warning(disable : 6385)
             pseudo_rand = pseudo_rands[i];
 #pragma warning(pop)
+            argon2_prefetch_ref_block(instance, position, pseudo_rands, i);
         } else {
             pseudo_rand = instance->region->memory[prev_offset].v[0];
         }
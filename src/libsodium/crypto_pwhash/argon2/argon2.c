@@ -22,15 +22,30 @@
 #include "argon2-core.h"
 #include "argon2-encoding.h"
 #include "argon2.h"
+#include "private/probes.h"
+#include "private/stats.h"
 
-int
-argon2_ctx(argon2_context *context, argon2_type type)
+/*
+ * Outputs, salts and hashes to verify that fit in this are kept on the
+ * stack; it is larger than anything crypto_pwhash_*_str() produces.
+ */
+#define ARGON2_STACK_BUFFER_BYTES 128U
+
+static void
+_argon2_buffer_free(uint8_t *buf, const uint8_t *stack_buf)
+{
+    if (buf != stack_buf) {
+        free(buf);
+    }
+}
+
+static int
+_argon2_instance_setup(argon2_instance_t *instance,
+                       const argon2_context *context, argon2_type type)
 {
     /* 1. Validate all inputs */
-    int               result = argon2_validate_inputs(context);
-    uint32_t          memory_blocks, segment_length;
-    uint32_t          pass;
-    argon2_instance_t instance;
+    int      result = argon2_validate_inputs(context);
+    uint32_t memory_blocks, segment_length;
 
     if (ARGON2_OK != result) {
         return result;
@@ -52,15 +67,33 @@ argon2_ctx(argon2_context *context, argon2_type type)
     /* Ensure that all segments have equal length */
     memory_blocks = segment_length * (context->lanes * ARGON2_SYNC_POINTS);
 
-    instance.region         = NULL;
-    instance.passes         = context->t_cost;
-    instance.current_pass   = ~ 0U;
-    instance.memory_blocks  = memory_blocks;
-    instance.segment_length = segment_length;
-    instance.lane_length    = segment_length * ARGON2_SYNC_POINTS;
-    instance.lanes          = context->lanes;
-    instance.threads        = context->threads;
-    instance.type           = type;
+    instance->region         = NULL;
+    instance->addresses      = NULL;
+    instance->passes         = context->t_cost;
+    instance->current_pass   = ~ 0U;
+    instance->memory_blocks  = memory_blocks;
+    instance->segment_length = segment_length;
+    instance->lane_length    = segment_length * ARGON2_SYNC_POINTS;
+    instance->lanes          = context->lanes;
+    instance->threads        = context->threads;
+    instance->type           = type;
+    instance->progress        = context->progress;
+    instance->progress_opaque = context->progress_opaque;
+
+    return ARGON2_OK;
+}
+
+static int
+_argon2_ctx(argon2_context *context, argon2_type type)
+{
+    int               result;
+    uint32_t          pass;
+    argon2_instance_t instance;
+
+    if ((result = _argon2_instance_setup(&instance, context, type)) !=
+        ARGON2_OK) {
+        return result;
+    }
 
     /* 3. Initialization: Hashing inputs, allocating memory, filling first
      * blocks
@@ -73,7 +106,11 @@ argon2_ctx(argon2_context *context, argon2_type type)
 
     /* 4. Filling memory */
     for (pass = 0; pass < instance.passes; pass++) {
-        argon2_fill_memory_blocks(&instance, pass);
+        if ((result = argon2_fill_memory_blocks(&instance, pass)) !=
+            ARGON2_OK) {
+            argon2_free_instance(&instance, context->flags);
+            return result;
+        }
     }
 
     /* 5. Finalization */
@@ -83,15 +120,126 @@ argon2_ctx(argon2_context *context, argon2_type type)
 }
 
 int
-argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
-            const uint32_t parallelism, const void *pwd, const size_t pwdlen,
-            const void *salt, const size_t saltlen, void *hash,
-            const size_t hashlen, char *encoded, const size_t encodedlen,
-            argon2_type type)
+argon2_ctx(argon2_context *context, argon2_type type)
+{
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    SODIUM_PROBE4(pwhash_argon2__entry, (int) type, context->t_cost,
+                  (uint64_t) context->m_cost * ARGON2_BLOCK_SIZE,
+                  context->lanes);
+    ret = _argon2_ctx(context, type);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_PWHASH,
+                      (uint64_t) context->m_cost * ARGON2_BLOCK_SIZE);
+    SODIUM_PROBE1(pwhash_argon2__return, ret);
+
+    return ret;
+}
+
+int
+argon2_ctx_many(argon2_context *contexts, size_t count, argon2_type type)
+{
+    argon2_instance_t  instances[ARGON2_MANY_MAX];
+    argon2_instance_t *instances_p[ARGON2_MANY_MAX];
+    size_t             k;
+    uint32_t           pass;
+    int                result;
+
+    if (count == 0U || count > ARGON2_MANY_MAX) {
+        return ARGON2_INCORRECT_PARAMETER;
+    }
+    for (k = 0U; k < count; k++) {
+        if ((result = _argon2_instance_setup(&instances[k], &contexts[k],
+                                             type)) != ARGON2_OK) {
+            return result;
+        }
+        if (contexts[k].t_cost != contexts[0].t_cost ||
+            contexts[k].m_cost != contexts[0].m_cost ||
+            contexts[k].lanes != contexts[0].lanes) {
+            return ARGON2_INCORRECT_PARAMETER;
+        }
+        instances[k].threads = 1;
+        instances_p[k]       = &instances[k];
+    }
+    for (k = 0U; k < count; k++) {
+        if ((result = argon2_initialize(&instances[k], &contexts[k])) !=
+            ARGON2_OK) {
+            while (k-- > 0U) {
+                argon2_free_instance(&instances[k], contexts[k].flags);
+            }
+            return result;
+        }
+    }
+    for (pass = 0; pass < instances[0].passes; pass++) {
+        argon2_fill_memory_blocks_many(instances_p, count, pass);
+    }
+    for (k = 0U; k < count; k++) {
+        argon2_finalize(&contexts[k], &instances[k]);
+    }
+    return ARGON2_OK;
+}
+
+int
+argon2_hash_many(const uint32_t t_cost, const uint32_t m_cost,
+                 const void * const *pwds, const size_t *pwdlens,
+                 const void * const *salts, const size_t saltlen,
+                 void * const *hashes, const size_t hashlen, size_t count,
+                 argon2_type type, struct Argon2_AddressCache *address_cache)
+{
+    argon2_context contexts[ARGON2_MANY_MAX];
+    size_t         k;
+    int            result;
+
+    if (count == 0U || count > ARGON2_MANY_MAX) {
+        return ARGON2_INCORRECT_PARAMETER;
+    }
+    if (hashlen > ARGON2_MAX_OUTLEN) {
+        return ARGON2_OUTPUT_TOO_LONG;
+    }
+    if (saltlen > ARGON2_MAX_SALT_LENGTH) {
+        return ARGON2_SALT_TOO_LONG;
+    }
+    memset(contexts, 0, sizeof contexts);
+    for (k = 0U; k < count; k++) {
+        if (pwdlens[k] > ARGON2_MAX_PWD_LENGTH) {
+            return ARGON2_PWD_TOO_LONG;
+        }
+        contexts[k].out           = (uint8_t *) hashes[k];
+        contexts[k].outlen        = (uint32_t) hashlen;
+        contexts[k].pwd           = (uint8_t *) pwds[k];
+        contexts[k].pwdlen        = (uint32_t) pwdlens[k];
+        contexts[k].salt          = (uint8_t *) salts[k];
+        contexts[k].saltlen       = (uint32_t) saltlen;
+        contexts[k].t_cost        = t_cost;
+        contexts[k].m_cost        = m_cost;
+        contexts[k].lanes         = 1;
+        contexts[k].threads       = 1;
+        contexts[k].flags         = ARGON2_DEFAULT_FLAGS;
+        contexts[k].address_cache = address_cache;
+    }
+    if ((result = argon2_ctx_many(contexts, count, type)) != ARGON2_OK) {
+        for (k = 0U; k < count; k++) {
+            sodium_memzero(hashes[k], hashlen);
+        }
+    }
+    return result;
+}
+
+int
+argon2_hash_with_memory(const uint32_t t_cost, const uint32_t m_cost,
+                        const uint32_t parallelism, const void *pwd,
+                        const size_t pwdlen, const void *salt,
+                        const size_t saltlen, void *hash, const size_t hashlen,
+                        char *encoded, const size_t encodedlen,
+                        argon2_type type, void *memory, size_t memory_size,
+                        struct Argon2_AddressCache *address_cache,
+                        argon2_progress_callback progress,
+                        void *progress_opaque)
 {
     argon2_context context;
     int            result;
     uint8_t       *out;
+    uint8_t        out_buf[ARGON2_STACK_BUFFER_BYTES];
 
     if (pwdlen > ARGON2_MAX_PWD_LENGTH) {
         return ARGON2_PWD_TOO_LONG;
@@ -105,8 +253,9 @@ argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
         return ARGON2_SALT_TOO_LONG;
     }
 
-    out = (uint8_t *) malloc(hashlen);
-    if (!out) {
+    out = out_buf;
+    if (hashlen > sizeof out_buf &&
+        (out = (uint8_t *) malloc(hashlen)) == NULL) {
         return ARGON2_MEMORY_ALLOCATION_ERROR;
     }
 
@@ -126,11 +275,18 @@ argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
     context.threads   = parallelism;
     context.flags     = ARGON2_DEFAULT_FLAGS;
 
+    context.memory        = memory;
+    context.memory_size   = memory_size;
+    context.address_cache = address_cache;
+
+    context.progress        = progress;
+    context.progress_opaque = progress_opaque;
+
     result = argon2_ctx(&context, type);
 
     if (result != ARGON2_OK) {
         sodium_memzero(out, hashlen);
-        free(out);
+        _argon2_buffer_free(out, out_buf);
         return result;
     }
 
@@ -140,7 +296,7 @@ argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
                                  &context, type) != ARGON2_OK) {
             sodium_memzero(out, hashlen);
             sodium_memzero(encoded, encodedlen);
-            free(out);
+            _argon2_buffer_free(out, out_buf);
             return ARGON2_ENCODING_FAIL;
         }
     }
@@ -151,11 +307,24 @@ argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
     }
 
     sodium_memzero(out, hashlen);
-    free(out);
+    _argon2_buffer_free(out, out_buf);
 
     return ARGON2_OK;
 }
 
+int
+argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
+            const uint32_t parallelism, const void *pwd, const size_t pwdlen,
+            const void *salt, const size_t saltlen, void *hash,
+            const size_t hashlen, char *encoded, const size_t encodedlen,
+            argon2_type type)
+{
+    return argon2_hash_with_memory(t_cost, m_cost, parallelism, pwd, pwdlen,
+                                   salt, saltlen, hash, hashlen, encoded,
+                                   encodedlen, type, NULL, 0, NULL, NULL,
+                                   NULL);
+}
+
 int
 argon2i_hash_encoded(const uint32_t t_cost, const uint32_t m_cost,
                      const uint32_t parallelism, const void *pwd,
@@ -199,11 +368,16 @@ argon2id_hash_raw(const uint32_t t_cost, const uint32_t m_cost,
 }
 
 int
-argon2_verify(const char *encoded, const void *pwd, const size_t pwdlen,
-              argon2_type type)
+argon2_verify_with_memory(const char *encoded, const void *pwd,
+                          const size_t pwdlen, argon2_type type,
+                          void *memory, size_t memory_size,
+                          struct Argon2_AddressCache *address_cache)
 {
     argon2_context ctx;
     uint8_t       *out;
+    uint8_t        salt_buf[ARGON2_STACK_BUFFER_BYTES];
+    uint8_t        expected_buf[ARGON2_STACK_BUFFER_BYTES];
+    uint8_t        out_buf[ARGON2_STACK_BUFFER_BYTES];
     int            decode_result;
     int            ret;
     size_t         encoded_len;
@@ -214,57 +388,64 @@ argon2_verify(const char *encoded, const void *pwd, const size_t pwdlen,
     ctx.pwdlen    = 0;
     ctx.secret    = NULL;
     ctx.secretlen = 0;
+    ctx.ad        = NULL;
+    ctx.adlen     = 0;
 
     /* max values, to be updated in argon2_decode_string */
     encoded_len = strlen(encoded);
     if (encoded_len > UINT32_MAX) {
         return ARGON2_DECODING_LENGTH_FAIL;
     }
-    ctx.adlen   = (uint32_t) encoded_len;
     ctx.saltlen = (uint32_t) encoded_len;
     ctx.outlen  = (uint32_t) encoded_len;
 
-    ctx.ad   = (uint8_t *) malloc(ctx.adlen);
-    ctx.salt = (uint8_t *) malloc(ctx.saltlen);
-    ctx.out  = (uint8_t *) malloc(ctx.outlen);
-    if (!ctx.out || !ctx.salt || !ctx.ad) {
-        free(ctx.ad);
-        free(ctx.salt);
-        free(ctx.out);
-        return ARGON2_MEMORY_ALLOCATION_ERROR;
-    }
-    out = (uint8_t *) malloc(ctx.outlen);
-    if (!out) {
-        free(ctx.ad);
-        free(ctx.salt);
-        free(ctx.out);
-        return ARGON2_MEMORY_ALLOCATION_ERROR;
+    /* decoded values are shorter than the string they are encoded in */
+    if (encoded_len <= ARGON2_STACK_BUFFER_BYTES) {
+        ctx.salt = salt_buf;
+        ctx.out  = expected_buf;
+        out      = out_buf;
+    } else {
+        ctx.salt = (uint8_t *) malloc(ctx.saltlen);
+        ctx.out  = (uint8_t *) malloc(ctx.outlen);
+        out      = (uint8_t *) malloc(ctx.outlen);
+        if (!ctx.salt || !ctx.out || !out) {
+            free(ctx.salt);
+            free(ctx.out);
+            free(out);
+            return ARGON2_MEMORY_ALLOCATION_ERROR;
+        }
     }
 
     decode_result = argon2_decode_string(&ctx, encoded, type);
     if (decode_result != ARGON2_OK) {
-        free(ctx.ad);
-        free(ctx.salt);
-        free(ctx.out);
-        free(out);
-        return decode_result;
-    }
-
-    ret = argon2_hash(ctx.t_cost, ctx.m_cost, ctx.threads, pwd, pwdlen,
-                      ctx.salt, ctx.saltlen, out, ctx.outlen, NULL, 0, type);
-
-    free(ctx.ad);
-    free(ctx.salt);
-
-    if (ret != ARGON2_OK || sodium_memcmp(out, ctx.out, ctx.outlen) != 0) {
-        ret = ARGON2_VERIFY_MISMATCH;
+        ret = decode_result;
+    } else {
+        ret = argon2_hash_with_memory(ctx.t_cost, ctx.m_cost, ctx.threads, pwd,
+                                      pwdlen, ctx.salt, ctx.saltlen, out,
+                                      ctx.outlen, NULL, 0, type,
+                                      memory, memory_size, address_cache,
+                                      NULL, NULL);
+        if (ret != ARGON2_OK ||
+            sodium_memcmp(out, ctx.out, ctx.outlen) != 0) {
+            ret = ARGON2_VERIFY_MISMATCH;
+        }
+        sodium_memzero(out, ctx.outlen);
     }
-    free(out);
-    free(ctx.out);
+    _argon2_buffer_free(ctx.salt, salt_buf);
+    _argon2_buffer_free(ctx.out, expected_buf);
+    _argon2_buffer_free(out, out_buf);
 
     return ret;
 }
 
+int
+argon2_verify(const char *encoded, const void *pwd, const size_t pwdlen,
+              argon2_type type)
+{
+    return argon2_verify_with_memory(encoded, pwd, pwdlen, type, NULL, 0,
+                                     NULL);
+}
+
 int
 argon2i_verify(const char *encoded, const void *pwd, const size_t pwdlen)
 {
@@ -130,11 +130,20 @@ typedef enum Argon2_ErrorCodes {
 
     ARGON2_DECODING_LENGTH_FAIL = -34,
 
-    ARGON2_VERIFY_MISMATCH = -35
+    ARGON2_VERIFY_MISMATCH = -35,
+
+    ARGON2_CANCELED = -36
 } argon2_error_codes;
 
 /* Argon2 external data structures */
 
+/*
+ * Progress callback: done out of total slices have been filled.
+ * Returning non-zero aborts the computation.
+ */
+typedef int (*argon2_progress_callback)(void *opaque, unsigned long long done,
+                                        unsigned long long total);
+
 /*
  * Context: structure to hold Argon2 inputs:
  * output array and its length,
@@ -183,6 +192,14 @@ typedef struct Argon2_Context {
     uint32_t threads; /* maximum number of threads */
 
     uint32_t flags; /* array of bool options */
+
+    void  *memory;      /* preallocated memory, or NULL */
+    size_t memory_size; /* size of the preallocated memory */
+
+    struct Argon2_AddressCache *address_cache; /* reusable addresses, or NULL */
+
+    argon2_progress_callback progress; /* called after every slice, or NULL */
+    void                    *progress_opaque;
 } argon2_context;
 
 /* Argon2 primitive type */
@@ -195,6 +212,14 @@ typedef enum Argon2_type { Argon2_i = 1, Argon2_id = 2 } argon2_type;
  */
 int argon2_ctx(argon2_context *context, argon2_type type);
 
+/*
+ * Computes @count hashes with the same parameters, interleaving them in
+ * the calling thread
+ * @param contexts Array of @count contexts, with the same costs and lanes
+ * @param count Number of contexts, at most ARGON2_MANY_MAX
+ */
+int argon2_ctx_many(argon2_context *contexts, size_t count, argon2_type type);
+
 /**
  * Hashes a password with Argon2i, producing an encoded hash
  * @param t_cost Number of iterations
@@ -282,6 +307,34 @@ int argon2_hash(const uint32_t t_cost, const uint32_t m_cost,
                 void *hash, const size_t hashlen, char *encoded,
                 const size_t encodedlen, argon2_type type);
 
+/*
+ * same as argon2_hash(), using preallocated memory if it is large enough,
+ * and the data-independent addresses of a cache, if not NULL.
+ * If progress is not NULL, it is called after every slice, and the
+ * computation stops with ARGON2_CANCELED if it returns non-zero.
+ */
+int argon2_hash_with_memory(const uint32_t t_cost, const uint32_t m_cost,
+                            const uint32_t parallelism, const void *pwd,
+                            const size_t pwdlen, const void *salt,
+                            const size_t saltlen, void *hash,
+                            const size_t hashlen, char *encoded,
+                            const size_t encodedlen, argon2_type type,
+                            void *memory, size_t memory_size,
+                            struct Argon2_AddressCache *address_cache,
+                            argon2_progress_callback progress,
+                            void *progress_opaque);
+
+/*
+ * Hashes @count passwords with a single lane and the same parameters
+ * into the raw hashes @hashes, using argon2_ctx_many()
+ */
+int argon2_hash_many(const uint32_t t_cost, const uint32_t m_cost,
+                     const void * const *pwds, const size_t *pwdlens,
+                     const void * const *salts, const size_t saltlen,
+                     void * const *hashes, const size_t hashlen,
+                     size_t count, argon2_type type,
+                     struct Argon2_AddressCache *address_cache);
+
 /**
  * Verifies a password against an encoded string
  * Encoded string is restricted as in argon2_validate_inputs()
@@ -303,4 +356,9 @@ int argon2id_verify(const char *encoded, const void *pwd, const size_t pwdlen);
 /* generic function underlying the above ones */
 int argon2_verify(const char *encoded, const void *pwd, const size_t pwdlen,
                   argon2_type type);
+
+int argon2_verify_with_memory(const char *encoded, const void *pwd,
+                              const size_t pwdlen, argon2_type type,
+                              void *memory, size_t memory_size,
+                              struct Argon2_AddressCache *address_cache);
 #endif
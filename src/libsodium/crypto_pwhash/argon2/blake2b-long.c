@@ -9,6 +9,8 @@
 
 #include "blake2b-long.h"
 
+#define BLAKE2B_LONG_MULTI_MIN 3U
+
 int
 blake2b_long(void *pout, size_t outlen, const void *in, size_t inlen)
 {
@@ -77,3 +79,97 @@ fail:
     return ret;
 #undef TRY
 }
+
+/*
+ * Same as blake2b_long() for count inputs of inlen bytes. Every step of
+ * the chains is computed for up to BLAKE2B_LONG_MULTI_MAX inputs at once
+ * by the multi-buffer BLAKE2b implementation; the chain itself is serial.
+ * With fewer than BLAKE2B_LONG_MULTI_MIN inputs, separate calls are faster.
+ */
+int
+blake2b_long_multi(void * const *pout, size_t outlen,
+                   const void * const *in, size_t inlen, size_t count)
+{
+    uint8_t             prefixed[BLAKE2B_LONG_MULTI_MAX]
+                                [4U + BLAKE2B_LONG_MULTI_INBYTES_MAX];
+    uint8_t             v[2][BLAKE2B_LONG_MULTI_MAX]
+                         [crypto_generichash_blake2b_BYTES_MAX];
+    unsigned char      *dst[BLAKE2B_LONG_MULTI_MAX];
+    const unsigned char *src[BLAKE2B_LONG_MULTI_MAX];
+    unsigned long long  lens[BLAKE2B_LONG_MULTI_MAX];
+    size_t              i;
+    size_t              j;
+    size_t              n;
+    size_t              pos;
+    uint32_t            toproduce;
+    int                 cur;
+    int                 ret = 0;
+
+    if (count < BLAKE2B_LONG_MULTI_MIN ||
+        outlen <= crypto_generichash_blake2b_BYTES_MAX || outlen > UINT32_MAX ||
+        inlen > BLAKE2B_LONG_MULTI_INBYTES_MAX) {
+        for (i = 0U; i < count; i++) {
+            if ((ret = blake2b_long(pout[i], outlen, in[i], inlen)) != 0) {
+                return ret; /* LCOV_EXCL_LINE */
+            }
+        }
+        return 0;
+    }
+    for (i = 0U; i < count; i += n) {
+        n = count - i;
+        if (n > BLAKE2B_LONG_MULTI_MAX) {
+            n = BLAKE2B_LONG_MULTI_MAX;
+        }
+        for (j = 0U; j < n; j++) {
+            STORE32_LE(prefixed[j], (uint32_t) outlen);
+            memcpy(prefixed[j] + 4U, in[i + j], inlen);
+            src[j]  = prefixed[j];
+            dst[j]  = v[0][j];
+            lens[j] = 4U + inlen;
+        }
+        if ((ret = crypto_generichash_blake2b_multi
+             (dst, crypto_generichash_blake2b_BYTES_MAX, src, lens, n, NULL, 0U)) != 0) {
+            break; /* LCOV_EXCL_LINE */
+        }
+        for (j = 0U; j < n; j++) {
+            memcpy(pout[i + j], v[0][j], crypto_generichash_blake2b_BYTES_MAX / 2);
+            lens[j] = crypto_generichash_blake2b_BYTES_MAX;
+        }
+        pos       = crypto_generichash_blake2b_BYTES_MAX / 2;
+        toproduce = (uint32_t) outlen - crypto_generichash_blake2b_BYTES_MAX / 2;
+        cur       = 0;
+        for (;;) {
+            for (j = 0U; j < n; j++) {
+                src[j] = v[cur][j];
+                dst[j] = v[cur ^ 1][j];
+            }
+            cur ^= 1;
+            if (toproduce <= crypto_generichash_blake2b_BYTES_MAX) {
+                break;
+            }
+            if ((ret = crypto_generichash_blake2b_multi
+                 (dst, crypto_generichash_blake2b_BYTES_MAX, src, lens, n,
+                  NULL, 0U)) != 0) {
+                break; /* LCOV_EXCL_LINE */
+            }
+            for (j = 0U; j < n; j++) {
+                memcpy((uint8_t *) pout[i + j] + pos, v[cur][j],
+                       crypto_generichash_blake2b_BYTES_MAX / 2);
+            }
+            pos += crypto_generichash_blake2b_BYTES_MAX / 2;
+            toproduce -= crypto_generichash_blake2b_BYTES_MAX / 2;
+        }
+        if (ret != 0 ||
+            (ret = crypto_generichash_blake2b_multi(dst, toproduce, src, lens, n,
+                                                    NULL, 0U)) != 0) {
+            break; /* LCOV_EXCL_LINE */
+        }
+        for (j = 0U; j < n; j++) {
+            memcpy((uint8_t *) pout[i + j] + pos, v[cur][j], toproduce);
+        }
+    }
+    sodium_memzero(prefixed, sizeof prefixed);
+    sodium_memzero(v, sizeof v);
+
+    return ret;
+}
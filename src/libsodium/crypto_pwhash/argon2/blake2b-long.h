@@ -4,6 +4,12 @@
 #include <stddef.h>
 #include "private/quirks.h"
 
+#define BLAKE2B_LONG_MULTI_MAX         8U
+#define BLAKE2B_LONG_MULTI_INBYTES_MAX 128U
+
 int blake2b_long(void *pout, size_t outlen, const void *in, size_t inlen);
 
+int blake2b_long_multi(void * const *pout, size_t outlen,
+                       const void * const *in, size_t inlen, size_t count);
+
 #endif
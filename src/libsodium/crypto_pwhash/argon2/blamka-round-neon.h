@@ -0,0 +1,129 @@
+#ifndef blamka_round_neon_H
+#define blamka_round_neon_H
+
+#include "private/common.h"
+
+#define VROTR64_8(X, N)                                             \
+    vreinterpret_u64_u8(vext_u8(vreinterpret_u8_u64(X),               \
+                                vreinterpret_u8_u64(X), (N)))
+#define VROTR64_BYTES(X, N)                                         \
+    vcombine_u64(VROTR64_8(vget_low_u64(X), N), VROTR64_8(vget_high_u64(X), N))
+
+#ifdef __ARM_FEATURE_SHA3
+# define XOR_ROTR32(A, B) vxarq_u64((A), (B), 32)
+# define XOR_ROTR24(A, B) vxarq_u64((A), (B), 24)
+# define XOR_ROTR16(A, B) vxarq_u64((A), (B), 16)
+# define XOR_ROTR63(A, B) vxarq_u64((A), (B), 63)
+#else
+static inline uint64x2_t
+XOR_ROTR32(const uint64x2_t a, const uint64x2_t b)
+{
+    return vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(veorq_u64(a, b))));
+}
+
+static inline uint64x2_t
+XOR_ROTR24(const uint64x2_t a, const uint64x2_t b)
+{
+    return VROTR64_BYTES(veorq_u64(a, b), 3);
+}
+
+static inline uint64x2_t
+XOR_ROTR16(const uint64x2_t a, const uint64x2_t b)
+{
+    return VROTR64_BYTES(veorq_u64(a, b), 2);
+}
+
+static inline uint64x2_t
+XOR_ROTR63(const uint64x2_t a, const uint64x2_t b)
+{
+    const uint64x2_t x = veorq_u64(a, b);
+
+    return veorq_u64(vaddq_u64(x, x), vshrq_n_u64(x, 63));
+}
+#endif
+
+static inline uint64x2_t
+fBlaMka(uint64x2_t x, uint64x2_t y)
+{
+    const uint64x2_t z = vmull_u32(vmovn_u64(x), vmovn_u64(y));
+    return vaddq_u64(vaddq_u64(x, y), vaddq_u64(z, z));
+}
+
+#define G1(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do {                                   \
+        A0 = fBlaMka(A0, B0);              \
+        A1 = fBlaMka(A1, B1);              \
+                                           \
+        D0 = XOR_ROTR32(D0, A0);           \
+        D1 = XOR_ROTR32(D1, A1);           \
+                                           \
+        C0 = fBlaMka(C0, D0);              \
+        C1 = fBlaMka(C1, D1);              \
+                                           \
+        B0 = XOR_ROTR24(B0, C0);           \
+        B1 = XOR_ROTR24(B1, C1);           \
+    } while ((void) 0, 0)
+
+#define G2(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do {                                   \
+        A0 = fBlaMka(A0, B0);              \
+        A1 = fBlaMka(A1, B1);              \
+                                           \
+        D0 = XOR_ROTR16(D0, A0);           \
+        D1 = XOR_ROTR16(D1, A1);           \
+                                           \
+        C0 = fBlaMka(C0, D0);              \
+        C1 = fBlaMka(C1, D1);              \
+                                           \
+        B0 = XOR_ROTR63(B0, C0);           \
+        B1 = XOR_ROTR63(B1, C1);           \
+    } while ((void) 0, 0)
+
+#define DIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do {                                            \
+        uint64x2_t t0 = vextq_u64(B0, B1, 1);       \
+        uint64x2_t t1 = vextq_u64(B1, B0, 1);       \
+        B0            = t0;                         \
+        B1            = t1;                         \
+                                                    \
+        t0 = C0;                                    \
+        C0 = C1;                                    \
+        C1 = t0;                                    \
+                                                    \
+        t0 = vextq_u64(D0, D1, 1);                  \
+        t1 = vextq_u64(D1, D0, 1);                  \
+        D0 = t1;                                    \
+        D1 = t0;                                    \
+    } while ((void) 0, 0)
+
+#define UNDIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do {                                              \
+        uint64x2_t t0 = vextq_u64(B1, B0, 1);         \
+        uint64x2_t t1 = vextq_u64(B0, B1, 1);         \
+        B0            = t0;                           \
+        B1            = t1;                           \
+                                                      \
+        t0 = C0;                                      \
+        C0 = C1;                                      \
+        C1 = t0;                                      \
+                                                      \
+        t0 = vextq_u64(D1, D0, 1);                    \
+        t1 = vextq_u64(D0, D1, 1);                    \
+        D0 = t1;                                      \
+        D1 = t0;                                      \
+    } while ((void) 0, 0)
+
+#define BLAKE2_ROUND(A0, A1, B0, B1, C0, C1, D0, D1)   \
+    do {                                               \
+        G1(A0, B0, C0, D0, A1, B1, C1, D1);            \
+        G2(A0, B0, C0, D0, A1, B1, C1, D1);            \
+                                                       \
+        DIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1);   \
+                                                       \
+        G1(A0, B0, C0, D0, A1, B1, C1, D1);            \
+        G2(A0, B0, C0, D0, A1, B1, C1, D1);            \
+                                                       \
+        UNDIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1); \
+    } while ((void) 0, 0)
+
+#endif
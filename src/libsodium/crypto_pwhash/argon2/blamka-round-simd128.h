@@ -0,0 +1,126 @@
+#ifndef blamka_round_simd128_H
+#define blamka_round_simd128_H
+
+#include "private/common.h"
+
+static inline v128_t
+XOR_ROTR32(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_i32x4_shuffle(x, x, 1, 0, 3, 2);
+}
+
+static inline v128_t
+XOR_ROTR24(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_i8x16_shuffle(x, x, 3, 4, 5, 6, 7, 0, 1, 2,
+                              11, 12, 13, 14, 15, 8, 9, 10);
+}
+
+static inline v128_t
+XOR_ROTR16(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_i8x16_shuffle(x, x, 2, 3, 4, 5, 6, 7, 0, 1,
+                              10, 11, 12, 13, 14, 15, 8, 9);
+}
+
+static inline v128_t
+XOR_ROTR63(const v128_t a, const v128_t b)
+{
+    const v128_t x = wasm_v128_xor(a, b);
+
+    return wasm_v128_xor(wasm_i64x2_add(x, x), wasm_u64x2_shr(x, 63));
+}
+
+static inline v128_t
+fBlaMka(v128_t x, v128_t y)
+{
+    const v128_t z = wasm_u64x2_extmul_low_u32x4(
+        wasm_i32x4_shuffle(x, x, 0, 2, 0, 2), wasm_i32x4_shuffle(y, y, 0, 2, 0, 2));
+
+    return wasm_i64x2_add(wasm_i64x2_add(x, y), wasm_i64x2_add(z, z));
+}
+
+#define G1(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do {                                   \
+        A0 = fBlaMka(A0, B0);              \
+        A1 = fBlaMka(A1, B1);              \
+                                           \
+        D0 = XOR_ROTR32(D0, A0);           \
+        D1 = XOR_ROTR32(D1, A1);           \
+                                           \
+        C0 = fBlaMka(C0, D0);              \
+        C1 = fBlaMka(C1, D1);              \
+                                           \
+        B0 = XOR_ROTR24(B0, C0);           \
+        B1 = XOR_ROTR24(B1, C1);           \
+    } while ((void) 0, 0)
+
+#define G2(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do {                                   \
+        A0 = fBlaMka(A0, B0);              \
+        A1 = fBlaMka(A1, B1);              \
+                                           \
+        D0 = XOR_ROTR16(D0, A0);           \
+        D1 = XOR_ROTR16(D1, A1);           \
+                                           \
+        C0 = fBlaMka(C0, D0);              \
+        C1 = fBlaMka(C1, D1);              \
+                                           \
+        B0 = XOR_ROTR63(B0, C0);           \
+        B1 = XOR_ROTR63(B1, C1);           \
+    } while ((void) 0, 0)
+
+#define DIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1)   \
+    do {                                              \
+        v128_t t0 = wasm_i64x2_shuffle(B0, B1, 1, 2); \
+        v128_t t1 = wasm_i64x2_shuffle(B1, B0, 1, 2); \
+        B0 = t0;                                      \
+        B1 = t1;                                      \
+                                                      \
+        t0 = C0;                                      \
+        C0 = C1;                                      \
+        C1 = t0;                                      \
+                                                      \
+        t0 = wasm_i64x2_shuffle(D0, D1, 1, 2);        \
+        t1 = wasm_i64x2_shuffle(D1, D0, 1, 2);        \
+        D0 = t1;                                      \
+        D1 = t0;                                      \
+    } while ((void) 0, 0)
+
+#define UNDIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1) \
+    do {                                              \
+        v128_t t0 = wasm_i64x2_shuffle(B1, B0, 1, 2); \
+        v128_t t1 = wasm_i64x2_shuffle(B0, B1, 1, 2); \
+        B0 = t0;                                      \
+        B1 = t1;                                      \
+                                                      \
+        t0 = C0;                                      \
+        C0 = C1;                                      \
+        C1 = t0;                                      \
+                                                      \
+        t0 = wasm_i64x2_shuffle(D1, D0, 1, 2);        \
+        t1 = wasm_i64x2_shuffle(D0, D1, 1, 2);        \
+        D0 = t1;                                      \
+        D1 = t0;                                      \
+    } while ((void) 0, 0)
+
+#define BLAKE2_ROUND(A0, A1, B0, B1, C0, C1, D0, D1)   \
+    do {                                               \
+        G1(A0, B0, C0, D0, A1, B1, C1, D1);            \
+        G2(A0, B0, C0, D0, A1, B1, C1, D1);            \
+                                                       \
+        DIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1);   \
+                                                       \
+        G1(A0, B0, C0, D0, A1, B1, C1, D1);            \
+        G2(A0, B0, C0, D0, A1, B1, C1, D1);            \
+                                                       \
+        UNDIAGONALIZE(A0, B0, C0, D0, A1, B1, C1, D1); \
+    } while ((void) 0, 0)
+
+#endif
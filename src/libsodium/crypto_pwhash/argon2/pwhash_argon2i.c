@@ -18,6 +18,10 @@
 
 #define STR_HASHBYTES 32U
 
+#ifndef ECANCELED
+# define ECANCELED EINTR
+#endif
+
 int
 crypto_pwhash_argon2i_alg_argon2i13(void)
 {
@@ -136,12 +140,16 @@ crypto_pwhash_argon2i_memlimit_sensitive(void)
     return crypto_pwhash_argon2i_MEMLIMIT_SENSITIVE;
 }
 
-int
-crypto_pwhash_argon2i(unsigned char *const out, unsigned long long outlen,
-                      const char *const passwd, unsigned long long passwdlen,
-                      const unsigned char *const salt,
-                      unsigned long long opslimit, size_t memlimit, int alg)
+static int
+_crypto_pwhash_argon2i(unsigned char *const out, unsigned long long outlen,
+                       const char *const passwd, unsigned long long passwdlen,
+                       const unsigned char *const salt,
+                       unsigned long long opslimit, size_t memlimit, int alg,
+                       argon2_progress_callback progress,
+                       void *progress_opaque)
 {
+    int ret;
+
     memset(out, 0, outlen);
     if (outlen > crypto_pwhash_argon2i_BYTES_MAX) {
         errno = EFBIG;
@@ -169,10 +177,18 @@ crypto_pwhash_argon2i(unsigned char *const out, unsigned long long outlen,
     }
     switch (alg) {
     case crypto_pwhash_argon2i_ALG_ARGON2I13:
-        if (argon2i_hash_raw((uint32_t) opslimit, (uint32_t) (memlimit / 1024U),
-                             (uint32_t) 1U, passwd, (size_t) passwdlen, salt,
-                             (size_t) crypto_pwhash_argon2i_SALTBYTES, out,
-                             (size_t) outlen) != ARGON2_OK) {
+        ret = argon2_hash_with_memory((uint32_t) opslimit,
+                                      (uint32_t) (memlimit / 1024U),
+                                      (uint32_t) 1U, passwd, (size_t) passwdlen,
+                                      salt,
+                                      (size_t) crypto_pwhash_argon2i_SALTBYTES,
+                                      out, (size_t) outlen, NULL, 0, Argon2_i,
+                                      NULL, 0, NULL, progress, progress_opaque);
+        if (ret == ARGON2_CANCELED) {
+            errno = ECANCELED;
+            return -1;
+        }
+        if (ret != ARGON2_OK) {
             return -1; /* LCOV_EXCL_LINE */
         }
         return 0;
@@ -182,6 +198,33 @@ crypto_pwhash_argon2i(unsigned char *const out, unsigned long long outlen,
     }
 }
 
+int
+crypto_pwhash_argon2i(unsigned char *const out, unsigned long long outlen,
+                      const char *const passwd, unsigned long long passwdlen,
+                      const unsigned char *const salt,
+                      unsigned long long opslimit, size_t memlimit, int alg)
+{
+    return _crypto_pwhash_argon2i(out, outlen, passwd, passwdlen, salt,
+                                  opslimit, memlimit, alg, NULL, NULL);
+}
+
+int
+crypto_pwhash_argon2i_progress(unsigned char *const out,
+                               unsigned long long outlen,
+                               const char *const passwd,
+                               unsigned long long passwdlen,
+                               const unsigned char *const salt,
+                               unsigned long long opslimit, size_t memlimit,
+                               int alg,
+                               int (*progress)(void *opaque,
+                                               unsigned long long done,
+                                               unsigned long long total),
+                               void *opaque)
+{
+    return _crypto_pwhash_argon2i(out, outlen, passwd, passwdlen, salt,
+                                  opslimit, memlimit, alg, progress, opaque);
+}
+
 int
 crypto_pwhash_argon2i_str(char out[crypto_pwhash_argon2i_STRBYTES],
                           const char *const passwd,
@@ -3,17 +3,27 @@
 #include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "argon2-core.h"
+#include "argon2-encoding.h"
 #include "argon2.h"
+#include "crypto_pwhash_argon2i.h"
 #include "crypto_pwhash_argon2id.h"
 #include "private/common.h"
+#include "private/executor.h"
 #include "randombytes.h"
 #include "utils.h"
 
 #define STR_HASHBYTES 32U
 
+#define VERIFY_MANY_THREADS_MAX 64U
+
+#ifndef ECANCELED
+# define ECANCELED EINTR
+#endif
+
 int
 crypto_pwhash_argon2id_alg_argon2id13(void)
 {
@@ -132,12 +142,126 @@ crypto_pwhash_argon2id_memlimit_sensitive(void)
     return crypto_pwhash_argon2id_MEMLIMIT_SENSITIVE;
 }
 
+size_t
+crypto_pwhash_argon2id_parallelism_min(void)
+{
+    COMPILER_ASSERT(crypto_pwhash_argon2id_PARALLELISM_MIN >= ARGON2_MIN_LANES);
+    return crypto_pwhash_argon2id_PARALLELISM_MIN;
+}
+
+size_t
+crypto_pwhash_argon2id_parallelism_max(void)
+{
+    COMPILER_ASSERT(crypto_pwhash_argon2id_PARALLELISM_MAX <= ARGON2_MAX_LANES);
+    return crypto_pwhash_argon2id_PARALLELISM_MAX;
+}
+
+static int
+_parallelism_check(size_t parallelism, size_t memlimit)
+{
+    if (parallelism < crypto_pwhash_argon2id_PARALLELISM_MIN ||
+        parallelism > crypto_pwhash_argon2id_PARALLELISM_MAX ||
+        memlimit / 1024U < 2U * ARGON2_SYNC_POINTS * parallelism) {
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
 int
-crypto_pwhash_argon2id(unsigned char *const out, unsigned long long outlen,
-                       const char *const passwd, unsigned long long passwdlen,
-                       const unsigned char *const salt,
-                       unsigned long long opslimit, size_t memlimit, int alg)
+crypto_pwhash_argon2_arena_init(crypto_pwhash_argon2_arena *arena,
+                                size_t memlimit, int lock)
+{
+    block_region region;
+
+    memset(arena, 0, sizeof *arena);
+    if (memlimit > crypto_pwhash_argon2id_MEMLIMIT_MAX) {
+        errno = EFBIG;
+        return -1;
+    }
+    if (memlimit < crypto_pwhash_argon2id_MEMLIMIT_MIN) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (argon2_region_alloc(&region, (memlimit / 1024U) * sizeof(block), 1) !=
+        ARGON2_OK) {
+        errno = ENOMEM; /* LCOV_EXCL_LINE */
+        return -1;      /* LCOV_EXCL_LINE */
+    }
+    if (lock != 0 && sodium_mlock(region.memory, region.size) != 0) {
+        argon2_region_release(&region);
+        return -1;
+    }
+    if ((arena->address_cache =
+         calloc((size_t) 1U, sizeof(argon2_address_cache))) == NULL) {
+        /* LCOV_EXCL_START */
+        if (lock != 0) {
+            sodium_munlock(region.memory, region.size);
+        }
+        argon2_region_release(&region);
+        errno = ENOMEM;
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    arena->base   = region.base;
+    arena->memory = region.memory;
+    arena->size   = region.size;
+    arena->locked = lock != 0;
+
+    return 0;
+}
+
+void
+crypto_pwhash_argon2_arena_free(crypto_pwhash_argon2_arena *arena)
+{
+    block_region region;
+
+    if (arena->memory != NULL) {
+        if (arena->locked) {
+            sodium_munlock(arena->memory, arena->size);
+        }
+        region.base   = arena->base;
+        region.memory = (block *) arena->memory;
+        region.size   = arena->size;
+        argon2_region_release(&region);
+    }
+    if (arena->address_cache != NULL) {
+        argon2_address_cache_free((argon2_address_cache *) arena->address_cache);
+        free(arena->address_cache);
+    }
+    memset(arena, 0, sizeof *arena);
+}
+
+static void *
+_arena_memory(const crypto_pwhash_argon2_arena *arena)
+{
+    return arena == NULL ? NULL : arena->memory;
+}
+
+static size_t
+_arena_size(const crypto_pwhash_argon2_arena *arena)
+{
+    return arena == NULL ? 0U : arena->size;
+}
+
+static argon2_address_cache *
+_arena_address_cache(const crypto_pwhash_argon2_arena *arena)
 {
+    return arena == NULL ? NULL : (argon2_address_cache *) arena->address_cache;
+}
+
+static int
+_crypto_pwhash_argon2id(crypto_pwhash_argon2_arena *arena,
+                        unsigned char *const out, unsigned long long outlen,
+                        const char *const passwd, unsigned long long passwdlen,
+                        const unsigned char *const salt,
+                        unsigned long long opslimit, size_t memlimit,
+                        size_t parallelism, int alg,
+                        argon2_progress_callback progress,
+                        void *progress_opaque)
+{
+    int ret;
+
     memset(out, 0, outlen);
     if (outlen > crypto_pwhash_argon2id_BYTES_MAX) {
         errno = EFBIG;
@@ -159,16 +283,30 @@ crypto_pwhash_argon2id(unsigned char *const out, unsigned long long outlen,
         errno = EINVAL;
         return -1;
     }
+    if (_parallelism_check(parallelism, memlimit) != 0) {
+        return -1;
+    }
     if ((const void *) out == (const void *) passwd) {
         errno = EINVAL;
         return -1;
     }
     switch (alg) {
     case crypto_pwhash_argon2id_ALG_ARGON2ID13:
-        if (argon2id_hash_raw((uint32_t) opslimit, (uint32_t) (memlimit / 1024U),
-                              (uint32_t) 1U, passwd, (size_t) passwdlen, salt,
-                              (size_t) crypto_pwhash_argon2id_SALTBYTES, out,
-                              (size_t) outlen) != ARGON2_OK) {
+        ret = argon2_hash_with_memory((uint32_t) opslimit,
+                                      (uint32_t) (memlimit / 1024U),
+                                      (uint32_t) parallelism, passwd,
+                                      (size_t) passwdlen, salt,
+                                      (size_t) crypto_pwhash_argon2id_SALTBYTES,
+                                      out, (size_t) outlen, NULL, 0, Argon2_id,
+                                      _arena_memory(arena),
+                                      _arena_size(arena),
+                                      _arena_address_cache(arena),
+                                      progress, progress_opaque);
+        if (ret == ARGON2_CANCELED) {
+            errno = ECANCELED;
+            return -1;
+        }
+        if (ret != ARGON2_OK) {
             return -1; /* LCOV_EXCL_LINE */
         }
         return 0;
@@ -179,12 +317,152 @@ crypto_pwhash_argon2id(unsigned char *const out, unsigned long long outlen,
 }
 
 int
-crypto_pwhash_argon2id_str(char out[crypto_pwhash_argon2id_STRBYTES],
-                           const char *const passwd,
-                           unsigned long long passwdlen,
-                           unsigned long long opslimit, size_t memlimit)
+crypto_pwhash_argon2id_parallel(unsigned char *const out,
+                                unsigned long long outlen,
+                                const char *const passwd,
+                                unsigned long long passwdlen,
+                                const unsigned char *const salt,
+                                unsigned long long opslimit, size_t memlimit,
+                                size_t parallelism, int alg)
+{
+    return _crypto_pwhash_argon2id(NULL, out, outlen, passwd, passwdlen, salt,
+                                   opslimit, memlimit, parallelism, alg,
+                                   NULL, NULL);
+}
+
+int
+crypto_pwhash_argon2id_arena(crypto_pwhash_argon2_arena *arena,
+                             unsigned char *const out,
+                             unsigned long long outlen,
+                             const char *const passwd,
+                             unsigned long long passwdlen,
+                             const unsigned char *const salt,
+                             unsigned long long opslimit, size_t memlimit,
+                             size_t parallelism, int alg)
+{
+    return _crypto_pwhash_argon2id(arena, out, outlen, passwd, passwdlen, salt,
+                                   opslimit, memlimit, parallelism, alg,
+                                   NULL, NULL);
+}
+
+/*
+ * Passwords are hashed ARGON2_MANY_MAX at a time, sharing the addresses of
+ * the data-independent segments.
+ */
+int
+crypto_pwhash_argon2id_many(unsigned char * const *outs,
+                            unsigned long long outlen,
+                            const char * const *passwds,
+                            const unsigned long long *passwdlens,
+                            const unsigned char * const *salts, size_t count,
+                            unsigned long long opslimit, size_t memlimit,
+                            int alg)
+{
+    argon2_address_cache cache;
+    size_t               pwdlens[ARGON2_MANY_MAX];
+    size_t               i;
+    size_t               j;
+    size_t               n;
+    int                  ret = 0;
+
+    for (i = 0U; i < count; i++) {
+        memset(outs[i], 0, outlen);
+    }
+    if (outlen > crypto_pwhash_argon2id_BYTES_MAX ||
+        opslimit > crypto_pwhash_argon2id_OPSLIMIT_MAX ||
+        memlimit > crypto_pwhash_argon2id_MEMLIMIT_MAX) {
+        errno = EFBIG;
+        return -1;
+    }
+    if (outlen < crypto_pwhash_argon2id_BYTES_MIN ||
+        opslimit < crypto_pwhash_argon2id_OPSLIMIT_MIN ||
+        memlimit < crypto_pwhash_argon2id_MEMLIMIT_MIN ||
+        alg != crypto_pwhash_argon2id_ALG_ARGON2ID13) {
+        errno = EINVAL;
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        if (passwdlens[i] > crypto_pwhash_argon2id_PASSWD_MAX) {
+            errno = EFBIG;
+            return -1;
+        }
+        if ((const void *) outs[i] == (const void *) passwds[i]) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    memset(&cache, 0, sizeof cache);
+    for (i = 0U; i < count; i += n) {
+        n = count - i;
+        if (n > ARGON2_MANY_MAX) {
+            n = ARGON2_MANY_MAX;
+        }
+        for (j = 0U; j < n; j++) {
+            pwdlens[j] = (size_t) passwdlens[i + j];
+        }
+        if (argon2_hash_many((uint32_t) opslimit,
+                             (uint32_t) (memlimit / 1024U),
+                             (const void * const *) &passwds[i], pwdlens,
+                             (const void * const *) &salts[i],
+                             (size_t) crypto_pwhash_argon2id_SALTBYTES,
+                             (void * const *) &outs[i], (size_t) outlen, n,
+                             Argon2_id, &cache) != ARGON2_OK) {
+            ret = -1; /* LCOV_EXCL_LINE */
+            break;    /* LCOV_EXCL_LINE */
+        }
+    }
+    argon2_address_cache_free(&cache);
+    if (ret != 0) {
+        /* LCOV_EXCL_START */
+        for (i = 0U; i < count; i++) {
+            sodium_memzero(outs[i], outlen);
+        }
+        errno = ENOMEM;
+        /* LCOV_EXCL_STOP */
+    }
+    return ret;
+}
+
+int
+crypto_pwhash_argon2id(unsigned char *const out, unsigned long long outlen,
+                       const char *const passwd, unsigned long long passwdlen,
+                       const unsigned char *const salt,
+                       unsigned long long opslimit, size_t memlimit, int alg)
+{
+    return crypto_pwhash_argon2id_parallel(out, outlen, passwd, passwdlen,
+                                           salt, opslimit, memlimit, 1U, alg);
+}
+
+int
+crypto_pwhash_argon2id_progress(unsigned char *const out,
+                                unsigned long long outlen,
+                                const char *const passwd,
+                                unsigned long long passwdlen,
+                                const unsigned char *const salt,
+                                unsigned long long opslimit, size_t memlimit,
+                                int alg,
+                                int (*progress)(void *opaque,
+                                                unsigned long long done,
+                                                unsigned long long total),
+                                void *opaque)
+{
+    return _crypto_pwhash_argon2id(NULL, out, outlen, passwd, passwdlen, salt,
+                                   opslimit, memlimit, 1U, alg, progress,
+                                   opaque);
+}
+
+static int
+_crypto_pwhash_argon2id_str(crypto_pwhash_argon2_arena *arena,
+                            char out[crypto_pwhash_argon2id_STRBYTES],
+                            const char *const passwd,
+                            unsigned long long passwdlen,
+                            unsigned long long opslimit, size_t memlimit,
+                            size_t parallelism,
+                            argon2_progress_callback progress,
+                            void *progress_opaque)
 {
     unsigned char salt[crypto_pwhash_argon2id_SALTBYTES];
+    int           ret;
 
     memset(out, 0, crypto_pwhash_argon2id_STRBYTES);
     if (passwdlen > crypto_pwhash_argon2id_PASSWD_MAX ||
@@ -199,20 +477,86 @@ crypto_pwhash_argon2id_str(char out[crypto_pwhash_argon2id_STRBYTES],
         errno = EINVAL;
         return -1;
     }
+    if (_parallelism_check(parallelism, memlimit) != 0) {
+        return -1;
+    }
     randombytes_buf(salt, sizeof salt);
-    if (argon2id_hash_encoded((uint32_t) opslimit, (uint32_t) (memlimit / 1024U),
-                              (uint32_t) 1U, passwd, (size_t) passwdlen, salt,
-                              sizeof salt, STR_HASHBYTES, out,
-                              crypto_pwhash_argon2id_STRBYTES) != ARGON2_OK) {
+    ret = argon2_hash_with_memory((uint32_t) opslimit,
+                                  (uint32_t) (memlimit / 1024U),
+                                  (uint32_t) parallelism, passwd,
+                                  (size_t) passwdlen, salt, sizeof salt, NULL,
+                                  STR_HASHBYTES, out,
+                                  crypto_pwhash_argon2id_STRBYTES, Argon2_id,
+                                  _arena_memory(arena),
+                                  _arena_size(arena),
+                                  _arena_address_cache(arena),
+                                  progress, progress_opaque);
+    if (ret == ARGON2_CANCELED) {
+        errno = ECANCELED;
+        return -1;
+    }
+    if (ret != ARGON2_OK) {
         return -1; /* LCOV_EXCL_LINE */
     }
     return 0;
 }
 
 int
-crypto_pwhash_argon2id_str_verify(const char str[crypto_pwhash_argon2id_STRBYTES],
-                                  const char *const  passwd,
-                                  unsigned long long passwdlen)
+crypto_pwhash_argon2id_str_parallel(char out[crypto_pwhash_argon2id_STRBYTES],
+                                    const char *const passwd,
+                                    unsigned long long passwdlen,
+                                    unsigned long long opslimit,
+                                    size_t memlimit, size_t parallelism)
+{
+    return _crypto_pwhash_argon2id_str(NULL, out, passwd, passwdlen,
+                                       opslimit, memlimit, parallelism,
+                                       NULL, NULL);
+}
+
+int
+crypto_pwhash_argon2id_str_arena(crypto_pwhash_argon2_arena *arena,
+                                 char out[crypto_pwhash_argon2id_STRBYTES],
+                                 const char *const passwd,
+                                 unsigned long long passwdlen,
+                                 unsigned long long opslimit,
+                                 size_t memlimit, size_t parallelism)
+{
+    return _crypto_pwhash_argon2id_str(arena, out, passwd, passwdlen,
+                                       opslimit, memlimit, parallelism,
+                                       NULL, NULL);
+}
+
+int
+crypto_pwhash_argon2id_str(char out[crypto_pwhash_argon2id_STRBYTES],
+                           const char *const passwd,
+                           unsigned long long passwdlen,
+                           unsigned long long opslimit, size_t memlimit)
+{
+    return crypto_pwhash_argon2id_str_parallel(out, passwd, passwdlen,
+                                               opslimit, memlimit, 1U);
+}
+
+int
+crypto_pwhash_argon2id_str_progress(char out[crypto_pwhash_argon2id_STRBYTES],
+                                    const char *const passwd,
+                                    unsigned long long passwdlen,
+                                    unsigned long long opslimit,
+                                    size_t memlimit,
+                                    int (*progress)(void *opaque,
+                                                    unsigned long long done,
+                                                    unsigned long long total),
+                                    void *opaque)
+{
+    return _crypto_pwhash_argon2id_str(NULL, out, passwd, passwdlen,
+                                       opslimit, memlimit, 1U, progress,
+                                       opaque);
+}
+
+static int
+_crypto_pwhash_argon2id_str_verify(crypto_pwhash_argon2_arena *arena,
+                                   const char *const  str,
+                                   const char *const  passwd,
+                                   unsigned long long passwdlen)
 {
     int verify_ret;
 
@@ -227,7 +571,10 @@ crypto_pwhash_argon2id_str_verify(const char str[crypto_pwhash_argon2id_STRBYTES
     }
     /* LCOV_EXCL_STOP */
 
-    verify_ret = argon2id_verify(str, passwd, (size_t) passwdlen);
+    verify_ret = argon2_verify_with_memory(str, passwd, (size_t) passwdlen,
+                                           Argon2_id, _arena_memory(arena),
+                                           _arena_size(arena),
+                                           _arena_address_cache(arena));
     if (verify_ret == ARGON2_OK) {
         return 0;
     }
@@ -236,3 +583,210 @@ crypto_pwhash_argon2id_str_verify(const char str[crypto_pwhash_argon2id_STRBYTES
     }
     return -1;
 }
+
+int
+crypto_pwhash_argon2id_str_verify(const char str[crypto_pwhash_argon2id_STRBYTES],
+                                  const char *const  passwd,
+                                  unsigned long long passwdlen)
+{
+    return _crypto_pwhash_argon2id_str_verify(NULL, str, passwd, passwdlen);
+}
+
+int
+crypto_pwhash_argon2id_str_verify_arena(crypto_pwhash_argon2_arena *arena,
+                                        const char str[crypto_pwhash_argon2id_STRBYTES],
+                                        const char *const  passwd,
+                                        unsigned long long passwdlen)
+{
+    return _crypto_pwhash_argon2id_str_verify(arena, str, passwd, passwdlen);
+}
+
+typedef struct verify_many_job {
+    size_t      index;
+    argon2_type type;
+    uint32_t    m_cost;
+    uint32_t    t_cost;
+    uint32_t    lanes;
+} verify_many_job;
+
+typedef struct verify_many_data {
+    int                      *results;
+    const char *const        *strs;
+    const char *const        *passwds;
+    const unsigned long long *passwdlens;
+    const verify_many_job    *jobs;
+    size_t                    jobs_count;
+} verify_many_data;
+
+static int
+_str_params(const char *str, verify_many_job *job)
+{
+    unsigned char  *fodder;
+    argon2_context  ctx;
+    size_t          fodder_len;
+    int             ret;
+
+    if (strncmp(str, crypto_pwhash_argon2id_STRPREFIX,
+                sizeof crypto_pwhash_argon2id_STRPREFIX - 1) == 0) {
+        job->type = Argon2_id;
+    } else if (strncmp(str, crypto_pwhash_argon2i_STRPREFIX,
+                       sizeof crypto_pwhash_argon2i_STRPREFIX - 1) == 0) {
+        job->type = Argon2_i;
+    } else {
+        return -1;
+    }
+    fodder_len = strlen(str);
+    if (fodder_len >= crypto_pwhash_argon2id_STRBYTES) {
+        return -1;
+    }
+    memset(&ctx, 0, sizeof ctx);
+    if ((fodder = (unsigned char *) calloc(fodder_len, 1U)) == NULL) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    ctx.out    = ctx.pwd    = ctx.salt    = fodder;
+    ctx.outlen = ctx.pwdlen = ctx.saltlen = (uint32_t) fodder_len;
+    ret = argon2_decode_string(&ctx, str, job->type) == ARGON2_OK ? 0 : -1;
+    free(fodder);
+    job->m_cost = ctx.m_cost;
+    job->t_cost = ctx.t_cost;
+    job->lanes  = ctx.lanes;
+
+    return ret;
+}
+
+static int
+_job_cmp(const void *a_, const void *b_)
+{
+    const verify_many_job *a = (const verify_many_job *) a_;
+    const verify_many_job *b = (const verify_many_job *) b_;
+
+    if (a->type != b->type) {
+        return a->type < b->type ? -1 : 1;
+    }
+    if (a->m_cost != b->m_cost) {
+        return a->m_cost < b->m_cost ? -1 : 1;
+    }
+    if (a->t_cost != b->t_cost) {
+        return a->t_cost < b->t_cost ? -1 : 1;
+    }
+    if (a->lanes != b->lanes) {
+        return a->lanes < b->lanes ? -1 : 1;
+    }
+    return a->index < b->index ? -1 : (a->index > b->index);
+}
+
+static void
+verify_many_jobs(const verify_many_data *data)
+{
+    crypto_pwhash_argon2_arena  arena;
+    crypto_pwhash_argon2_arena *arena_p = NULL;
+    const verify_many_job      *job;
+    size_t                      i;
+    uint32_t                    m_cost = 0U;
+
+    for (i = 0U; i < data->jobs_count; i++) {
+        if (data->jobs[i].m_cost > m_cost) {
+            m_cost = data->jobs[i].m_cost;
+        }
+    }
+    if (data->jobs_count > 0U &&
+        crypto_pwhash_argon2_arena_init(&arena, (size_t) m_cost * 1024U,
+                                        0) == 0) {
+        arena_p = &arena;
+    }
+    for (i = 0U; i < data->jobs_count; i++) {
+        job = &data->jobs[i];
+        if (data->passwdlens[job->index] > crypto_pwhash_argon2id_PASSWD_MAX) {
+            continue;
+        }
+        if (argon2_verify_with_memory(data->strs[job->index],
+                                      data->passwds[job->index],
+                                      (size_t) data->passwdlens[job->index],
+                                      job->type, _arena_memory(arena_p),
+                                      _arena_size(arena_p),
+                                      _arena_address_cache(arena_p)) ==
+            ARGON2_OK) {
+            data->results[job->index] = 0;
+        }
+    }
+    if (arena_p != NULL) {
+        crypto_pwhash_argon2_arena_free(arena_p);
+    }
+}
+
+static void
+verify_many_task(void *data)
+{
+    verify_many_jobs((const verify_many_data *) data);
+}
+
+/*
+ * Strings are sorted by parameters, so that consecutive verifications
+ * reuse the same arena and cached addresses, and split into contiguous
+ * ranges, one per thread.
+ */
+int
+crypto_pwhash_argon2_str_verify_many(int *results,
+                                     const char * const *strs,
+                                     const char * const *passwds,
+                                     const unsigned long long *passwdlens,
+                                     size_t count, unsigned int threads)
+{
+    verify_many_data     data[VERIFY_MANY_THREADS_MAX];
+    sodium_executor_task task[VERIFY_MANY_THREADS_MAX];
+    verify_many_job     *jobs;
+    size_t               jobs_count = 0U;
+    size_t               next;
+    size_t               i;
+    unsigned int         t;
+
+    if (threads < 1U) {
+        errno = EINVAL;
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        results[i] = -1;
+    }
+    if (count == 0U) {
+        return 0;
+    }
+    if (count > SIZE_MAX / sizeof(verify_many_job) ||
+        (jobs = (verify_many_job *)
+         malloc(count * sizeof(verify_many_job))) == NULL) {
+        errno = ENOMEM; /* LCOV_EXCL_LINE */
+        return -1;      /* LCOV_EXCL_LINE */
+    }
+    for (i = 0U; i < count; i++) {
+        jobs[jobs_count].index = i;
+        if (_str_params(strs[i], &jobs[jobs_count]) == 0) {
+            jobs_count++;
+        }
+    }
+    qsort(jobs, jobs_count, sizeof jobs[0], _job_cmp);
+    if (threads > VERIFY_MANY_THREADS_MAX) {
+        threads = VERIFY_MANY_THREADS_MAX;
+    }
+    if (threads > jobs_count) {
+        threads = jobs_count == 0U ? 1U : (unsigned int) jobs_count;
+    }
+    threads = _sodium_executor_threads(threads);
+    for (next = 0U, t = 0U; t < threads; t++) {
+        data[t].results    = results;
+        data[t].strs       = strs;
+        data[t].passwds    = passwds;
+        data[t].passwdlens = passwdlens;
+        data[t].jobs       = &jobs[next];
+        data[t].jobs_count = jobs_count / threads + (t < jobs_count % threads);
+        next += data[t].jobs_count;
+    }
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_start(&task[t], verify_many_task, &data[t]);
+    }
+    verify_many_jobs(&data[0]);
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_finish(&task[t]);
+    }
+    free(jobs);
+
+    return 0;
+}
@@ -1,9 +1,294 @@
 
 #include <errno.h>
+#include <stdint.h>
 #include <string.h>
 
+#include <time.h>
+#include <sys/types.h>
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
+#ifdef _WIN32
+# include <sys/timeb.h>
+# ifdef __BORLANDC__
+#  define _ftime ftime
+#  define _timeb timeb
+# endif
+#else
+# include <sys/time.h>
+#endif
+
+#if defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+# include <pthread.h>
+#endif
+
 #include "core.h"
 #include "crypto_pwhash.h"
+#include "private/allocator.h"
+#include "private/mutex.h"
+#include "private/pwhash_region.h"
+#include "utils.h"
+
+#if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
+# define MAP_ANON MAP_ANONYMOUS
+#endif
+#ifndef MAP_NOCORE
+# ifdef MAP_CONCEAL
+#  define MAP_NOCORE MAP_CONCEAL
+# else
+#  define MAP_NOCORE 0
+# endif
+#endif
+#ifndef MAP_POPULATE
+# define MAP_POPULATE 0
+#endif
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+# define MAP_HUGE_2MB_PAGES (MAP_HUGETLB | (21 << MAP_HUGE_SHIFT))
+#elif defined(MAP_HUGETLB)
+# define MAP_HUGE_2MB_PAGES MAP_HUGETLB
+#endif
+#if defined(MAP_ANON) && defined(HAVE_MMAP) && \
+    (defined(MAP_HUGE_2MB_PAGES) || \
+     (defined(MADV_HUGEPAGE) && defined(HAVE_MADVISE)))
+# define HAVE_HUGE_PAGES
+#endif
+
+#define HUGE_PAGE_SIZE ((size_t) 2U * 1024U * 1024U)
+
+#ifdef HAVE_HUGE_PAGES
+static int huge_pages_enabled;
+#endif
+
+#if defined(MAP_ANON) && defined(HAVE_MMAP)
+/*
+ * Memory currently mapped for password hashing, and the limit set by
+ * crypto_pwhash_set_memory_budget(), 0 meaning no limit. Computations that
+ * would exceed it wait for others to complete if threads are available,
+ * and fail otherwise.
+ */
+static size_t memory_budget;
+static size_t memory_in_use;
+
+# if defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+static pthread_mutex_t budget_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  budget_cond = PTHREAD_COND_INITIALIZER;
+
+static int
+_budget_lock(void)
+{
+    return pthread_mutex_lock(&budget_lock) == 0 ? 0 : -1;
+}
+
+static void
+_budget_unlock(void)
+{
+    (void) pthread_cond_broadcast(&budget_cond);
+    (void) pthread_mutex_unlock(&budget_lock);
+}
+
+static int
+_budget_wait(void)
+{
+    return pthread_cond_wait(&budget_cond, &budget_lock) == 0 ? 0 : -1;
+}
+# else
+static int
+_budget_lock(void)
+{
+    return sodium_crit_enter();
+}
+
+static void
+_budget_unlock(void)
+{
+    (void) sodium_crit_leave();
+}
+
+static int
+_budget_wait(void)
+{
+    return -1;
+}
+# endif
+
+static int
+_budget_acquire(size_t size)
+{
+    if (_budget_lock() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    while (memory_budget != 0U &&
+           (size > memory_budget || memory_in_use > memory_budget - size)) {
+        if (size > memory_budget || _budget_wait() != 0) {
+            _budget_unlock();
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    memory_in_use += size;
+    _budget_unlock();
+
+    return 0;
+}
+
+static void
+_budget_release(size_t size)
+{
+    if (_budget_lock() != 0) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    memory_in_use -= size;
+    _budget_unlock();
+}
+#endif
+
+int
+crypto_pwhash_set_memory_budget(size_t bytes)
+{
+#if defined(MAP_ANON) && defined(HAVE_MMAP)
+    if (_budget_lock() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    memory_budget = bytes;
+    _budget_unlock();
+
+    return 0;
+#else
+    if (bytes != 0U) {
+        errno = ENOSYS;
+        return -1;
+    }
+    return 0;
+#endif
+}
+
+int
+crypto_pwhash_set_huge_pages(int enable)
+{
+#ifdef HAVE_HUGE_PAGES
+    huge_pages_enabled = enable != 0;
+#else
+    if (enable != 0) {
+        errno = ENOSYS;
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+#if defined(MAP_ANON) && defined(HAVE_MMAP)
+
+# if defined(MADV_HUGEPAGE) && defined(HAVE_MADVISE)
+/* transparent huge pages require the region to be aligned to their size */
+static void *
+_region_map_thp(size_t size, int populate)
+{
+    uint8_t *base;
+    uint8_t *aligned;
+    void    *p;
+    size_t   map_size = size + HUGE_PAGE_SIZE;
+
+    if ((p = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                  MAP_ANON | MAP_PRIVATE | MAP_NOCORE, -1, 0)) == MAP_FAILED) {
+        return NULL;
+    }
+    base    = (uint8_t *) p;
+    aligned = base + ((HUGE_PAGE_SIZE -
+                       ((uintptr_t) base & (HUGE_PAGE_SIZE - 1U))) &
+                      (HUGE_PAGE_SIZE - 1U));
+    if (aligned != base) {
+        (void) munmap(base, (size_t) (aligned - base));
+    }
+    if (aligned + size != base + map_size) {
+        (void) munmap(aligned + size, (size_t) (base + map_size - aligned - size));
+    }
+    (void) madvise(aligned, size, MADV_HUGEPAGE);
+#  ifdef MADV_POPULATE_WRITE
+    if (populate != 0) {
+        (void) madvise(aligned, size, MADV_POPULATE_WRITE);
+    }
+#  endif
+    (void) populate;
+    return aligned;
+}
+# endif
+
+void *
+_crypto_pwhash_region_map(size_t *size_p, int populate)
+{
+    void  *base;
+    size_t size = *size_p;
+    int    huge = 0;
+    int    flags = MAP_ANON | MAP_PRIVATE | MAP_NOCORE;
+
+    if (populate != 0) {
+        flags |= MAP_POPULATE;
+    }
+    if (_sodium_allocator_is_set(SODIUM_ALLOC_SCRATCH)) {
+        if (_budget_acquire(size) != 0) {
+            return NULL;
+        }
+        if ((base = _sodium_allocator_alloc(SODIUM_ALLOC_SCRATCH, size)) ==
+            NULL) {
+            _budget_release(size);
+        }
+        return base;
+    }
+
+# ifdef HAVE_HUGE_PAGES
+    if (huge_pages_enabled != 0 && size >= HUGE_PAGE_SIZE &&
+        size <= SIZE_MAX - 2U * HUGE_PAGE_SIZE) {
+        size = (size + HUGE_PAGE_SIZE - 1U) & ~(HUGE_PAGE_SIZE - 1U);
+        huge = 1;
+    }
+# endif
+    if (_budget_acquire(size) != 0) {
+        return NULL;
+    }
+    *size_p = size;
+# ifdef HAVE_HUGE_PAGES
+    if (huge != 0) {
+#  ifdef MAP_HUGE_2MB_PAGES
+        if ((base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                         flags | MAP_HUGE_2MB_PAGES, -1, 0)) != MAP_FAILED) {
+            return base;
+        }
+#  endif
+#  if defined(MADV_HUGEPAGE) && defined(HAVE_MADVISE)
+        if ((base = _region_map_thp(size, populate)) != NULL) {
+            return base;
+        }
+#  endif
+    }
+# endif
+    (void) huge;
+    if ((base = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, -1, 0)) ==
+        MAP_FAILED) {
+        /* LCOV_EXCL_START */
+        _budget_release(size);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    return base;
+}
+
+int
+_crypto_pwhash_region_unmap(void *base, size_t size)
+{
+    if (_sodium_allocator_is_set(SODIUM_ALLOC_SCRATCH)) {
+        sodium_memzero_bulk(base, size);
+        _sodium_allocator_free(SODIUM_ALLOC_SCRATCH, base, size);
+    } else if (munmap(base, size) != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    _budget_release(size);
+
+    return 0;
+}
+
+#endif
 
 int
 crypto_pwhash_alg_argon2i13(void)
@@ -144,6 +429,30 @@ crypto_pwhash(unsigned char * const out, unsigned long long outlen,
     }
 }
 
+int
+crypto_pwhash_progress(unsigned char * const out, unsigned long long outlen,
+                       const char * const passwd, unsigned long long passwdlen,
+                       const unsigned char * const salt,
+                       unsigned long long opslimit, size_t memlimit, int alg,
+                       int (*progress)(void *opaque, unsigned long long done,
+                                       unsigned long long total),
+                       void *opaque)
+{
+    switch (alg) {
+    case crypto_pwhash_ALG_ARGON2I13:
+        return crypto_pwhash_argon2i_progress(out, outlen, passwd, passwdlen,
+                                              salt, opslimit, memlimit, alg,
+                                              progress, opaque);
+    case crypto_pwhash_ALG_ARGON2ID13:
+        return crypto_pwhash_argon2id_progress(out, outlen, passwd, passwdlen,
+                                               salt, opslimit, memlimit, alg,
+                                               progress, opaque);
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+}
+
 int
 crypto_pwhash_str(char out[crypto_pwhash_STRBYTES],
                   const char * const passwd, unsigned long long passwdlen,
@@ -153,6 +462,21 @@ crypto_pwhash_str(char out[crypto_pwhash_STRBYTES],
                                       opslimit, memlimit);
 }
 
+int
+crypto_pwhash_str_progress(char out[crypto_pwhash_STRBYTES],
+                           const char * const passwd,
+                           unsigned long long passwdlen,
+                           unsigned long long opslimit, size_t memlimit,
+                           int (*progress)(void *opaque,
+                                           unsigned long long done,
+                                           unsigned long long total),
+                           void *opaque)
+{
+    return crypto_pwhash_argon2id_str_progress(out, passwd, passwdlen,
+                                               opslimit, memlimit,
+                                               progress, opaque);
+}
+
 int
 crypto_pwhash_str_alg(char out[crypto_pwhash_STRBYTES],
                       const char * const passwd, unsigned long long passwdlen,
@@ -189,6 +513,16 @@ crypto_pwhash_str_verify(const char str[crypto_pwhash_STRBYTES],
     return -1;
 }
 
+int
+crypto_pwhash_str_verify_many(int *results, const char * const *strs,
+                              const char * const *passwds,
+                              const unsigned long long *passwdlens,
+                              size_t count, unsigned int threads)
+{
+    return crypto_pwhash_argon2_str_verify_many(results, strs, passwds,
+                                                passwdlens, count, threads);
+}
+
 int
 crypto_pwhash_str_needs_rehash(const char str[crypto_pwhash_STRBYTES],
                                unsigned long long opslimit, size_t memlimit)
@@ -206,6 +540,139 @@ crypto_pwhash_str_needs_rehash(const char str[crypto_pwhash_STRBYTES],
     return -1;
 }
 
+/*
+ * Get a high-resolution timestamp, in microseconds
+ */
+
+#ifdef _WIN32
+static uint64_t
+_pwhash_hrtime(void)
+{
+    struct _timeb tb;
+# pragma warning(push)
+# pragma warning(disable: 4996)
+    _ftime(&tb);
+# pragma warning(pop)
+    return ((uint64_t) tb.time) * 1000000U + ((uint64_t) tb.millitm) * 1000U;
+}
+#else
+static uint64_t
+_pwhash_hrtime(void)
+{
+    struct timeval tv;
+# ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0) {
+        return ((uint64_t) ts.tv_sec) * 1000000U +
+               (uint64_t) ts.tv_nsec / 1000U;
+    }
+# endif
+    if (gettimeofday(&tv, NULL) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    return ((uint64_t) tv.tv_sec) * 1000000U + (uint64_t) tv.tv_usec;
+}
+#endif
+
+#define CALIBRATE_PROBE_MEMLIMIT (16U * 1024U * 1024U)
+
+static int
+_calibrate_probe(unsigned long long opslimit, size_t memlimit, uint64_t *us_p)
+{
+    unsigned char out[crypto_pwhash_argon2id_BYTES_MIN];
+    unsigned char salt[crypto_pwhash_argon2id_SALTBYTES];
+    uint64_t      t0;
+
+    memset(salt, 0, sizeof salt);
+    t0 = _pwhash_hrtime();
+    if (crypto_pwhash_argon2id(out, sizeof out, "calibrate", 9U, salt,
+                               opslimit, memlimit,
+                               crypto_pwhash_argon2id_ALG_ARGON2ID13) != 0) {
+        return -1;
+    }
+    *us_p = _pwhash_hrtime() - t0;
+    if (*us_p == 0U) {
+        *us_p = 1U;
+    }
+    return 0;
+}
+
+/*
+ * The cost of Argon2id is roughly proportional to opslimit * memlimit.
+ * The throughput is measured with two short probes, used to pick the
+ * largest memlimit allowed and the matching number of passes, and the
+ * estimate is then corrected with a run using these parameters.
+ */
+int
+crypto_pwhash_calibrate(unsigned int target_ms, size_t max_mem,
+                        unsigned long long *opslimit, size_t *memlimit)
+{
+    uint64_t           target_us;
+    uint64_t           probe_us;
+    uint64_t           us;
+    uint64_t           budget_kib;
+    size_t             probe_kib;
+    size_t             max_kib;
+    size_t             mem_kib;
+    unsigned long long ops;
+
+    *opslimit = 0U;
+    *memlimit = 0U;
+    if (target_ms == 0U || max_mem < crypto_pwhash_argon2id_MEMLIMIT_MIN) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (max_mem > crypto_pwhash_argon2id_MEMLIMIT_MAX) {
+        max_mem = crypto_pwhash_argon2id_MEMLIMIT_MAX;
+    }
+    target_us = (uint64_t) target_ms * 1000U;
+    max_kib   = max_mem / 1024U;
+    probe_kib = max_kib < CALIBRATE_PROBE_MEMLIMIT / 1024U ?
+        max_kib : CALIBRATE_PROBE_MEMLIMIT / 1024U;
+    if (_calibrate_probe(1U, probe_kib * 1024U, &probe_us) != 0 ||
+        _calibrate_probe(1U, probe_kib * 1024U, &us) != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (us < probe_us) {
+        probe_us = us;
+    }
+    budget_kib = (uint64_t) probe_kib * target_us / probe_us;
+    if (budget_kib >= max_kib) {
+        mem_kib = max_kib;
+        ops     = (unsigned long long) (budget_kib / max_kib);
+        if (ops > crypto_pwhash_argon2id_OPSLIMIT_MAX) {
+            ops = crypto_pwhash_argon2id_OPSLIMIT_MAX;
+        }
+    } else {
+        mem_kib = (size_t) budget_kib;
+        if (mem_kib < crypto_pwhash_argon2id_MEMLIMIT_MIN / 1024U) {
+            mem_kib = crypto_pwhash_argon2id_MEMLIMIT_MIN / 1024U;
+        }
+        ops = crypto_pwhash_argon2id_OPSLIMIT_MIN;
+    }
+    if (mem_kib > probe_kib || ops > 1U) {
+        if (_calibrate_probe(ops, mem_kib * 1024U, &us) != 0) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+        if (us > target_us && ops > crypto_pwhash_argon2id_OPSLIMIT_MIN) {
+            ops = (unsigned long long) (ops * target_us / us);
+            if (ops < crypto_pwhash_argon2id_OPSLIMIT_MIN) {
+                ops = crypto_pwhash_argon2id_OPSLIMIT_MIN;
+            }
+        } else if (us > target_us) {
+            mem_kib = (size_t) (mem_kib * target_us / us);
+            if (mem_kib < crypto_pwhash_argon2id_MEMLIMIT_MIN / 1024U) {
+                mem_kib = crypto_pwhash_argon2id_MEMLIMIT_MIN / 1024U;
+            }
+        }
+    }
+    *opslimit = ops;
+    *memlimit = mem_kib * 1024U;
+
+    return 0;
+}
+
 const char *
 crypto_pwhash_primitive(void) {
     return crypto_pwhash_PRIMITIVE;
@@ -0,0 +1,194 @@
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "crypto_auth_hmacsha512.h"
+#include "crypto_pwhash_pbkdf2_sha512.h"
+#include "private/common.h"
+#include "private/sha512_multi.h"
+#include "utils.h"
+
+/*
+ * Every lane computes one output block T = U_1 ^ ... ^ U_c. The inner and
+ * outer HMAC pads are absorbed once, so that U_j = HMAC(P, U_{j-1}) only
+ * costs two compressions, and U_j never leaves the word-wise lane state.
+ */
+
+typedef struct pbkdf2_sha512_lanes {
+    sha512_multi_state M;
+    uint64_t           ih[8][SHA512_MULTI_LANES_MAX];
+    uint64_t           oh[8][SHA512_MULTI_LANES_MAX];
+    uint64_t           t[8][SHA512_MULTI_LANES_MAX];
+} pbkdf2_sha512_lanes;
+
+size_t
+crypto_pwhash_pbkdf2_sha512_bytes_min(void)
+{
+    return crypto_pwhash_pbkdf2_sha512_BYTES_MIN;
+}
+
+size_t
+crypto_pwhash_pbkdf2_sha512_bytes_max(void)
+{
+    return crypto_pwhash_pbkdf2_sha512_BYTES_MAX;
+}
+
+size_t
+crypto_pwhash_pbkdf2_sha512_iterations_min(void)
+{
+    return crypto_pwhash_pbkdf2_sha512_ITERATIONS_MIN;
+}
+
+static void
+pbkdf2_sha512_lane_init(pbkdf2_sha512_lanes *L, size_t l,
+                        const crypto_auth_hmacsha512_state *keyed,
+                        const crypto_auth_hmacsha512_state *salted,
+                        uint32_t block)
+{
+    crypto_auth_hmacsha512_state st;
+    unsigned char                ivec[4];
+    unsigned char                u[64];
+    int                          i;
+
+    memcpy(&st, salted, sizeof st);
+    STORE32_BE(ivec, block);
+    crypto_auth_hmacsha512_update(&st, ivec, sizeof ivec);
+    crypto_auth_hmacsha512_final(&st, u);
+    for (i = 0; i < 8; i++) {
+        L->ih[i][l] = keyed->ictx.state[i];
+        L->oh[i][l] = keyed->octx.state[i];
+        L->t[i][l] = L->M.w[i][l] = LOAD64_BE(u + 8 * i);
+    }
+    sodium_memzero(&st, sizeof st);
+    sodium_memzero(u, sizeof u);
+}
+
+static void
+pbkdf2_sha512_lanes_iterate(pbkdf2_sha512_lanes *L, size_t count,
+                            unsigned long long iterations)
+{
+    unsigned long long j;
+    size_t             l;
+    int                i;
+
+    for (l = 0U; l < count; l++) {
+        L->M.w[8][l] = 0x8000000000000000ULL;
+        for (i = 9; i < 15; i++) {
+            L->M.w[i][l] = 0U;
+        }
+        L->M.w[15][l] = (128U + 64U) * 8U;
+    }
+    for (j = 1U; j < iterations; j++) {
+        for (i = 0; i < 8; i++) {
+            for (l = 0U; l < count; l++) {
+                L->M.h[i][l] = L->ih[i][l];
+            }
+        }
+        _crypto_hash_sha512_compress_lanes(&L->M, count);
+        for (i = 0; i < 8; i++) {
+            for (l = 0U; l < count; l++) {
+                L->M.w[i][l] = L->M.h[i][l];
+                L->M.h[i][l] = L->oh[i][l];
+            }
+        }
+        _crypto_hash_sha512_compress_lanes(&L->M, count);
+        for (i = 0; i < 8; i++) {
+            for (l = 0U; l < count; l++) {
+                L->M.w[i][l] = L->M.h[i][l];
+                L->t[i][l] ^= L->M.h[i][l];
+            }
+        }
+    }
+}
+
+static void
+pbkdf2_sha512_lane_store(unsigned char *out, size_t outlen,
+                         const pbkdf2_sha512_lanes *L, size_t l)
+{
+    unsigned char t[64];
+    int           i;
+
+    for (i = 0; i < 8; i++) {
+        STORE64_BE(t + 8 * i, L->t[i][l]);
+    }
+    memcpy(out, t, outlen);
+    sodium_memzero(t, sizeof t);
+}
+
+int
+crypto_pwhash_pbkdf2_sha512_multi(unsigned char * const *out, size_t outlen,
+                                  const char * const *passwds,
+                                  const size_t *passwdlens,
+                                  const unsigned char * const *salts,
+                                  const size_t *saltlens,
+                                  unsigned long long iterations, size_t count)
+{
+    CRYPTO_ALIGN(64) pbkdf2_sha512_lanes L;
+    crypto_auth_hmacsha512_state keyed;
+    crypto_auth_hmacsha512_state salted;
+    unsigned char               *dst[SHA512_MULTI_LANES_MAX];
+    size_t                       dstlen[SHA512_MULTI_LANES_MAX];
+    const size_t                 lanes = _crypto_hash_sha512_multi_lanes();
+    size_t                       blocks;
+    size_t                       b = 0U;
+    size_t                       p = 0U;
+    size_t                       n;
+    size_t                       l;
+
+    if (outlen < crypto_pwhash_pbkdf2_sha512_BYTES_MIN ||
+        iterations < crypto_pwhash_pbkdf2_sha512_ITERATIONS_MIN) {
+        errno = EINVAL;
+        return -1;
+    }
+#if SIZE_MAX > 0x3fffffffc0ULL
+    if (outlen > crypto_pwhash_pbkdf2_sha512_BYTES_MAX) {
+        errno = EFBIG;
+        return -1;
+    }
+#endif
+    blocks = (outlen + 63U) / 64U;
+    memset(&L, 0, sizeof L);
+    while (p < count) {
+        for (n = 0U; n < lanes && p < count; n++) {
+            if (b == 0U) {
+                crypto_auth_hmacsha512_init(&keyed,
+                                            (const unsigned char *) passwds[p],
+                                            passwdlens[p]);
+                memcpy(&salted, &keyed, sizeof salted);
+                crypto_auth_hmacsha512_update(&salted, salts[p], saltlens[p]);
+            }
+            pbkdf2_sha512_lane_init(&L, n, &keyed, &salted,
+                                    (uint32_t) (b + 1U));
+            dst[n]    = out[p] + b * 64U;
+            dstlen[n] = outlen - b * 64U;
+            if (dstlen[n] > 64U) {
+                dstlen[n] = 64U;
+            }
+            if (++b == blocks) {
+                b = 0U;
+                p++;
+            }
+        }
+        pbkdf2_sha512_lanes_iterate(&L, n, iterations);
+        for (l = 0U; l < n; l++) {
+            pbkdf2_sha512_lane_store(dst[l], dstlen[l], &L, l);
+        }
+    }
+    sodium_memzero(&L, sizeof L);
+    sodium_memzero(&keyed, sizeof keyed);
+    sodium_memzero(&salted, sizeof salted);
+
+    return 0;
+}
+
+int
+crypto_pwhash_pbkdf2_sha512(unsigned char *out, size_t outlen,
+                            const char *passwd, size_t passwdlen,
+                            const unsigned char *salt, size_t saltlen,
+                            unsigned long long iterations)
+{
+    return crypto_pwhash_pbkdf2_sha512_multi(&out, outlen, &passwd, &passwdlen,
+                                             &salt, &saltlen, iterations, 1U);
+}
@@ -18,15 +18,24 @@
  * SUCH DAMAGE.
  */
 
+#include <errno.h>
 #include <stdint.h>
 #include <string.h>
 
 #include "crypto_pwhash_scryptsalsa208sha256.h"
 #include "crypto_scrypt.h"
 #include "private/common.h"
+#include "private/executor.h"
+#include "private/implementations.h"
+#include "private/probes.h"
+#include "private/stats.h"
 #include "runtime.h"
 #include "utils.h"
 
+#ifndef ECANCELED
+# define ECANCELED EINTR
+#endif
+
 static const char *const itoa64 =
     "./0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
 
@@ -133,6 +142,157 @@ escrypt_parse_setting(const uint8_t *setting,
     return src;
 }
 
+typedef struct escrypt_smix_data {
+    escrypt_smix_t      smix;
+    uint8_t            *B;
+    uint8_t            *V;
+    size_t              r;
+    uint64_t            N;
+    size_t              B_size;
+    size_t              V_size;
+    uint32_t            first;
+    uint32_t            p;
+    uint32_t            step;
+    escrypt_progress_t *progress;
+} escrypt_smix_data;
+
+int
+escrypt_progress(escrypt_progress_t *progress, uint64_t steps)
+{
+    progress->done += steps;
+
+    return progress->callback(progress->opaque, progress->done,
+                              progress->total) != 0 ? -1 : 0;
+}
+
+static int
+smix_blocks(const escrypt_smix_data *data)
+{
+    unsigned long long done;
+    uint32_t           i;
+
+    for (i = data->first; i < data->p; i += data->step) {
+        done = data->progress != NULL ? data->progress->done : 0U;
+        if (data->smix(&data->B[data->B_size * i], data->r, data->N, data->V,
+                       data->V + data->V_size, data->progress) != 0) {
+            return -1;
+        }
+        /* smix() reports up to 2N steps, in ESCRYPT_PROGRESS_INTERVAL units */
+        done += 2U * data->N;
+        if (data->progress != NULL && data->progress->done < done &&
+            escrypt_progress(data->progress,
+                             done - data->progress->done) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void
+smix_blocks_task(void *data)
+{
+    (void) smix_blocks((const escrypt_smix_data *) data);
+}
+
+uint32_t
+escrypt_threads(uint32_t threads, uint32_t p)
+{
+    if (threads > p) {
+        threads = p;
+    }
+    if (threads > ESCRYPT_THREADS_MAX) {
+        threads = ESCRYPT_THREADS_MAX;
+    }
+    return _sodium_executor_threads(threads);
+}
+
+/*
+ * The p SMix calls are independent. Each call of smix() processes `blocks`
+ * consecutive 128r-byte blocks of B, so there are p such units of work.
+ * Thread t gets its own V and XY at VXY + t * (V_size + XY_size) and
+ * processes units t, t + threads, ...
+ * If the executor cannot take a task, its units are processed by the
+ * calling thread.
+ * If `progress` is not NULL, everything runs in the calling thread, and -1
+ * is returned with errno set to ECANCELED as soon as the callback asks for
+ * the computation to stop.
+ */
+int
+escrypt_smix_all(escrypt_smix_t smix, uint8_t *B, size_t r, uint64_t N,
+                 uint32_t p, uint32_t blocks, uint8_t *VXY, size_t V_size,
+                 size_t XY_size, uint32_t threads, escrypt_progress_t *progress)
+{
+    escrypt_smix_data    data[ESCRYPT_THREADS_MAX];
+    sodium_executor_task task[ESCRYPT_THREADS_MAX];
+    uint32_t             t;
+    int                  ret;
+
+    threads = escrypt_threads(threads, p);
+    if (progress != NULL) {
+        threads = 1U;
+    }
+    for (t = 0; t < threads; t++) {
+        data[t].smix     = smix;
+        data[t].B        = B;
+        data[t].V        = VXY + (size_t) t * (V_size + XY_size);
+        data[t].r        = r;
+        data[t].N        = N;
+        data[t].B_size   = (size_t) 128 * r * blocks;
+        data[t].V_size   = V_size;
+        data[t].first    = t;
+        data[t].p        = p;
+        data[t].step     = threads;
+        data[t].progress = progress;
+    }
+    for (t = 1; t < threads; t++) {
+        _sodium_executor_start(&task[t], smix_blocks_task, &data[t]);
+    }
+    ret = smix_blocks(&data[0]);
+    for (t = 1; t < threads; t++) {
+        _sodium_executor_finish(&task[t]);
+    }
+    if (ret != 0) {
+        errno = ECANCELED;
+    }
+    return ret;
+}
+
+static escrypt_kdf_t escrypt_kdf_single = escrypt_kdf_nosse;
+static escrypt_kdf_t escrypt_kdf_pairs;
+
+/*
+ * Implementations processing two SMix instances at once need two V arrays,
+ * so they are only used when the caller asked for several threads.
+ */
+static escrypt_kdf_t
+escrypt_kdf_for(uint32_t p, uint32_t threads)
+{
+    if (escrypt_kdf_pairs != NULL && p > 1U && threads > 1U) {
+        return escrypt_kdf_pairs;
+    }
+    return escrypt_kdf_single;
+}
+
+static int
+escrypt_kdf_run(escrypt_kdf_t escrypt_kdf, escrypt_local_t *local,
+                const uint8_t *passwd, size_t passwdlen, const uint8_t *salt,
+                size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
+                uint32_t threads, escrypt_progress_t *progress, uint8_t *buf,
+                size_t buflen)
+{
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    SODIUM_PROBE4(pwhash_scrypt__entry, N, r, p, threads);
+    ret = escrypt_kdf(local, passwd, passwdlen, salt, saltlen, N, r, p,
+                      threads, progress, buf, buflen);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_PWHASH,
+                      (uint64_t) 128U * r * N);
+    SODIUM_PROBE1(pwhash_scrypt__return, ret);
+
+    return ret;
+}
+
 uint8_t *
 escrypt_r(escrypt_local_t *local, const uint8_t *passwd, size_t passwdlen,
           const uint8_t *setting, uint8_t *buf, size_t buflen)
@@ -169,14 +329,9 @@ escrypt_r(escrypt_local_t *local, const uint8_t *passwd, size_t passwdlen,
     if (need > buflen || need < saltlen) {
         return NULL;
     }
-#ifdef HAVE_EMMINTRIN_H
-    escrypt_kdf =
-        sodium_runtime_has_sse2() ? escrypt_kdf_sse : escrypt_kdf_nosse;
-#else
-    escrypt_kdf = escrypt_kdf_nosse;
-#endif
-    if (escrypt_kdf(local, passwd, passwdlen, salt, saltlen, N, r, p, hash,
-                    sizeof(hash))) {
+    escrypt_kdf = escrypt_kdf_for(p, 1U);
+    if (escrypt_kdf_run(escrypt_kdf, local, passwd, passwdlen, salt, saltlen,
+                        N, r, p, 1U, NULL, hash, sizeof(hash))) {
         return NULL;
     }
     dst = buf;
@@ -235,29 +390,103 @@ escrypt_gensalt_r(uint32_t N_log2, uint32_t r, uint32_t p, const uint8_t *src,
     return buf;
 }
 
+int
+crypto_pwhash_scryptsalsa208sha256_ll_threads(const uint8_t *passwd,
+                                              size_t passwdlen,
+                                              const uint8_t *salt,
+                                              size_t saltlen, uint64_t N,
+                                              uint32_t r, uint32_t p,
+                                              unsigned int threads,
+                                              uint8_t *buf, size_t buflen)
+{
+    escrypt_kdf_t   escrypt_kdf;
+    escrypt_local_t local;
+    int             retval;
+
+    if (threads < 1U) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (escrypt_init_local(&local)) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    escrypt_kdf = escrypt_kdf_for(p, (uint32_t) threads);
+    retval = escrypt_kdf_run(escrypt_kdf, &local, passwd, passwdlen, salt,
+                             saltlen, N, r, p, (uint32_t) threads, NULL, buf,
+                             buflen);
+    if (escrypt_free_local(&local)) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    return retval;
+}
+
 int
 crypto_pwhash_scryptsalsa208sha256_ll(const uint8_t *passwd, size_t passwdlen,
                                       const uint8_t *salt, size_t saltlen,
                                       uint64_t N, uint32_t r, uint32_t p,
                                       uint8_t *buf, size_t buflen)
 {
-    escrypt_kdf_t   escrypt_kdf;
-    escrypt_local_t local;
-    int             retval;
+    return crypto_pwhash_scryptsalsa208sha256_ll_threads(passwd, passwdlen,
+                                                         salt, saltlen, N, r,
+                                                         p, 1U, buf, buflen);
+}
 
+int
+crypto_pwhash_scryptsalsa208sha256_ll_progress(const uint8_t *passwd,
+                                               size_t passwdlen,
+                                               const uint8_t *salt,
+                                               size_t saltlen, uint64_t N,
+                                               uint32_t r, uint32_t p,
+                                               uint8_t *buf, size_t buflen,
+                                               int (*progress)(void *opaque,
+                                                               unsigned long long done,
+                                                               unsigned long long total),
+                                               void *opaque)
+{
+    escrypt_progress_t progress_state;
+    escrypt_local_t    local;
+    int                retval;
+
+    progress_state.callback = progress;
+    progress_state.opaque   = opaque;
+    progress_state.done     = 0U;
+    progress_state.total    = 2ULL * (unsigned long long) N * p;
     if (escrypt_init_local(&local)) {
         return -1; /* LCOV_EXCL_LINE */
     }
-#if defined(HAVE_EMMINTRIN_H)
-    escrypt_kdf =
-        sodium_runtime_has_sse2() ? escrypt_kdf_sse : escrypt_kdf_nosse;
-#else
-    escrypt_kdf = escrypt_kdf_nosse;
-#endif
-    retval = escrypt_kdf(&local, passwd, passwdlen, salt, saltlen, N, r, p, buf,
-                         buflen);
+    retval = escrypt_kdf_run(escrypt_kdf_single, &local, passwd, passwdlen,
+                             salt, saltlen, N, r, p, 1U, &progress_state, buf,
+                             buflen);
     if (escrypt_free_local(&local)) {
         return -1; /* LCOV_EXCL_LINE */
     }
     return retval;
 }
+
+int
+_crypto_pwhash_scryptsalsa208sha256_pick_best_implementation(void)
+{
+    escrypt_kdf_single = escrypt_kdf_nosse;
+    escrypt_kdf_pairs  = NULL;
+/* LCOV_EXCL_START */
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2()) {
+        escrypt_kdf_pairs = escrypt_kdf_avx2;
+    }
+#endif
+#if defined(HAVE_EMMINTRIN_H)
+    if (sodium_runtime_has_sse2()) {
+        escrypt_kdf_single = escrypt_kdf_sse;
+        return 0;
+    }
+#endif
+#if defined(HAVE_ARMNEON)
+    if (sodium_runtime_has_neon()) {
+        escrypt_kdf_single = escrypt_kdf_neon;
+        return 0;
+    }
+#endif
+/* LCOV_EXCL_STOP */
+    return 0;
+}
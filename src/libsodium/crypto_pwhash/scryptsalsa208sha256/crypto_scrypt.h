@@ -65,20 +65,71 @@ int escrypt_free_local(escrypt_local_t *__local);
 void *escrypt_alloc_region(escrypt_region_t *region, size_t size);
 int escrypt_free_region(escrypt_region_t *region);
 
+#define ESCRYPT_THREADS_MAX 32U
+
+typedef struct {
+    int (*callback)(void *opaque, unsigned long long done,
+                    unsigned long long total);
+    void              *opaque;
+    unsigned long long done;
+    unsigned long long total;
+} escrypt_progress_t;
+
+/* Must be a power of 2. */
+#define ESCRYPT_PROGRESS_INTERVAL 4096U
+
+#define ESCRYPT_PROGRESS_DUE(progress, i)              \
+    ((progress) != NULL &&                             \
+     ((i) & (ESCRYPT_PROGRESS_INTERVAL - 1U)) == 0U && \
+     escrypt_progress((progress), ESCRYPT_PROGRESS_INTERVAL) != 0)
+
+int escrypt_progress(escrypt_progress_t *__progress, uint64_t __steps);
+
 typedef int (*escrypt_kdf_t)(escrypt_local_t *__local, const uint8_t *__passwd,
                              size_t __passwdlen, const uint8_t *__salt,
                              size_t __saltlen, uint64_t __N, uint32_t __r,
-                             uint32_t __p, uint8_t *__buf, size_t __buflen);
+                             uint32_t __p, uint32_t __threads,
+                             escrypt_progress_t *__progress,
+                             uint8_t *__buf, size_t __buflen);
 
 int escrypt_kdf_nosse(escrypt_local_t *__local, const uint8_t *__passwd,
                       size_t __passwdlen, const uint8_t *__salt,
                       size_t __saltlen, uint64_t __N, uint32_t __r,
-                      uint32_t __p, uint8_t *__buf, size_t __buflen);
+                      uint32_t __p, uint32_t __threads,
+                      escrypt_progress_t *__progress,
+                      uint8_t *__buf, size_t __buflen);
 
 int escrypt_kdf_sse(escrypt_local_t *__local, const uint8_t *__passwd,
                     size_t __passwdlen, const uint8_t *__salt,
                     size_t __saltlen, uint64_t __N, uint32_t __r,
-                    uint32_t __p, uint8_t *__buf, size_t __buflen);
+                    uint32_t __p, uint32_t __threads,
+                    escrypt_progress_t *__progress,
+                    uint8_t *__buf, size_t __buflen);
+
+int escrypt_kdf_avx2(escrypt_local_t *__local, const uint8_t *__passwd,
+                     size_t __passwdlen, const uint8_t *__salt,
+                     size_t __saltlen, uint64_t __N, uint32_t __r,
+                     uint32_t __p, uint32_t __threads,
+                     escrypt_progress_t *__progress,
+                     uint8_t *__buf, size_t __buflen);
+
+int escrypt_kdf_neon(escrypt_local_t *__local, const uint8_t *__passwd,
+                     size_t __passwdlen, const uint8_t *__salt,
+                     size_t __saltlen, uint64_t __N, uint32_t __r,
+                     uint32_t __p, uint32_t __threads,
+                     escrypt_progress_t *__progress,
+                     uint8_t *__buf, size_t __buflen);
+
+typedef int (*escrypt_smix_t)(uint8_t *__B, size_t __r, uint64_t __N,
+                              void *__V, void *__XY,
+                              escrypt_progress_t *__progress);
+
+uint32_t escrypt_threads(uint32_t __threads, uint32_t __p);
+
+int escrypt_smix_all(escrypt_smix_t __smix, uint8_t *__B, size_t __r,
+                     uint64_t __N, uint32_t __p, uint32_t __blocks,
+                     uint8_t *__VXY, size_t __V_size, size_t __XY_size,
+                     uint32_t __threads, escrypt_progress_t *__progress);
 
 uint8_t *escrypt_r(escrypt_local_t *__local, const uint8_t *__passwd,
                    size_t __passwdlen, const uint8_t *__setting,
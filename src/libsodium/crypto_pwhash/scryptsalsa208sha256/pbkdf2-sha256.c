@@ -32,8 +32,7 @@
 #include <sys/types.h>
 
 #include "core.h"
-#include "crypto_auth_hmacsha256.h"
-#include "crypto_pwhash_scryptsalsa208sha256.h"
+#include "crypto_pwhash_pbkdf2_sha256.h"
 #include "pbkdf2-sha256.h"
 #include "private/common.h"
 #include "utils.h"
@@ -48,49 +47,12 @@ escrypt_PBKDF2_SHA256(const uint8_t *passwd, size_t passwdlen,
                       const uint8_t *salt, size_t saltlen, uint64_t c,
                       uint8_t *buf, size_t dkLen)
 {
-    crypto_auth_hmacsha256_state PShctx, hctx;
-    size_t                       i;
-    uint8_t                      ivec[4];
-    uint8_t                      U[32];
-    uint8_t                      T[32];
-    uint64_t                     j;
-    int                          k;
-    size_t                       clen;
-
-#if SIZE_MAX > 0x1fffffffe0ULL
-    COMPILER_ASSERT(crypto_pwhash_scryptsalsa208sha256_BYTES_MAX
-                    <= 0x1fffffffe0ULL);
-    if (dkLen > 0x1fffffffe0ULL) {
-        sodium_misuse(); /* LCOV_EXCL_LINE */
+    if (dkLen == 0U) {
+        return;
     }
-#endif
-    crypto_auth_hmacsha256_init(&PShctx, passwd, passwdlen);
-    crypto_auth_hmacsha256_update(&PShctx, salt, saltlen);
-
-    for (i = 0; i * 32 < dkLen; i++) {
-        STORE32_BE(ivec, (uint32_t)(i + 1));
-        memcpy(&hctx, &PShctx, sizeof(crypto_auth_hmacsha256_state));
-        crypto_auth_hmacsha256_update(&hctx, ivec, 4);
-        crypto_auth_hmacsha256_final(&hctx, U);
-
-        memcpy(T, U, 32);
-        /* LCOV_EXCL_START */
-        for (j = 2; j <= c; j++) {
-            crypto_auth_hmacsha256_init(&hctx, passwd, passwdlen);
-            crypto_auth_hmacsha256_update(&hctx, U, 32);
-            crypto_auth_hmacsha256_final(&hctx, U);
-
-            for (k = 0; k < 32; k++) {
-                T[k] ^= U[k];
-            }
-        }
-        /* LCOV_EXCL_STOP */
-
-        clen = dkLen - i * 32;
-        if (clen > 32) {
-            clen = 32;
-        }
-        memcpy(&buf[i * 32], T, clen);
+    if (crypto_pwhash_pbkdf2_sha256(buf, dkLen, (const char *) passwd,
+                                    passwdlen, salt, saltlen,
+                                    (unsigned long long) c) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
     }
-    sodium_memzero((void *) &PShctx, sizeof PShctx);
 }
@@ -25,7 +25,10 @@
 #include <stdlib.h>
 
 #include "crypto_scrypt.h"
+#include "private/allocator.h"
+#include "private/pwhash_region.h"
 #include "runtime.h"
+#include "utils.h"
 
 #if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
 # define MAP_ANON MAP_ANONYMOUS
@@ -46,24 +49,28 @@ escrypt_alloc_region(escrypt_region_t *region, size_t size)
 {
     uint8_t *base, *aligned;
 #if defined(MAP_ANON) && defined(HAVE_MMAP)
-    if ((base = (uint8_t *) mmap(NULL, size, PROT_READ | PROT_WRITE,
-                                 MAP_ANON | MAP_PRIVATE | MAP_NOCORE | MAP_POPULATE,
-                                 -1, 0)) == MAP_FAILED) {
-        base = NULL; /* LCOV_EXCL_LINE */
-    }                /* LCOV_EXCL_LINE */
-    aligned  = base;
-#elif defined(HAVE_POSIX_MEMALIGN)
-    if ((errno = posix_memalign((void **) &base, 64, size)) != 0) {
-        base = NULL;
-    }
+    base    = (uint8_t *) _crypto_pwhash_region_map(&size, 1);
     aligned = base;
 #else
-    base = aligned = NULL;
-    if (size + 63 < size) {
-        errno = ENOMEM;
-    } else if ((base = (uint8_t *) malloc(size + 63)) != NULL) {
-        aligned = base + 63;
-        aligned -= (uintptr_t) aligned & 63;
+    if (_sodium_allocator_is_set(SODIUM_ALLOC_SCRATCH)) {
+        base    = (uint8_t *)
+            _sodium_allocator_alloc(SODIUM_ALLOC_SCRATCH, size);
+        aligned = base;
+    } else {
+# if defined(HAVE_POSIX_MEMALIGN)
+        if ((errno = posix_memalign((void **) &base, 64, size)) != 0) {
+            base = NULL;
+        }
+        aligned = base;
+# else
+        base = aligned = NULL;
+        if (size + 63 < size) {
+            errno = ENOMEM;
+        } else if ((base = (uint8_t *) malloc(size + 63)) != NULL) {
+            aligned = base + 63;
+            aligned -= (uintptr_t) aligned & 63;
+        }
+# endif
     }
 #endif
     region->base    = base;
@@ -85,11 +92,17 @@ escrypt_free_region(escrypt_region_t *region)
 {
     if (region->base) {
 #if defined(MAP_ANON) && defined(HAVE_MMAP)
-        if (munmap(region->base, region->size)) {
+        if (_crypto_pwhash_region_unmap(region->base, region->size)) {
             return -1; /* LCOV_EXCL_LINE */
         }
 #else
-        free(region->base);
+        sodium_memzero_bulk(region->aligned, region->size);
+        if (_sodium_allocator_is_set(SODIUM_ALLOC_SCRATCH)) {
+            _sodium_allocator_free(SODIUM_ALLOC_SCRATCH, region->base,
+                                   region->size);
+        } else {
+            free(region->base);
+        }
 #endif
     }
     init_region(region);
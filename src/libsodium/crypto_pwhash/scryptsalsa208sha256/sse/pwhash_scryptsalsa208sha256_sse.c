@@ -225,8 +225,9 @@ integerify(const void *B, size_t r)
  * power of 2 greater than 1.  The arrays B, V, and XY must be aligned to a
  * multiple of 64 bytes.
  */
-static void
-smix(uint8_t *B, size_t r, uint64_t N, void *V, void *XY)
+static int
+smix(uint8_t *B, size_t r, uint64_t N, void *V, void *XY,
+     escrypt_progress_t *progress)
 {
     size_t    s   = 128 * r;
     __m128i  *X   = (__m128i *) V, *Y;
@@ -253,6 +254,9 @@ smix(uint8_t *B, size_t r, uint64_t N, void *V, void *XY)
         /* 3: V_i <-- X */
         X = (__m128i *) ((uintptr_t)(V) + (i + 1) * s);
         blockmix_salsa8(Y, X, r);
+        if (ESCRYPT_PROGRESS_DUE(progress, i + 1)) {
+            return -1;
+        }
     }
 
     /* 4: X <-- H(X) */
@@ -283,6 +287,9 @@ smix(uint8_t *B, size_t r, uint64_t N, void *V, void *XY)
         /* 8: X <-- H(X \xor V_j) */
         /* 7: j <-- Integerify(X) mod N */
         j = blockmix_salsa8_xor(Y, V_j, X, r) & (N - 1);
+        if (ESCRYPT_PROGRESS_DUE(progress, i + 2)) {
+            return -1;
+        }
     }
 
     /* 10: B' <-- X */
@@ -291,28 +298,32 @@ smix(uint8_t *B, size_t r, uint64_t N, void *V, void *XY)
             STORE32_LE(&B[(k * 16 + (i * 5 % 16)) * 4], X32[k * 16 + i]);
         }
     }
+    return 0;
 }
 
 /*
  * escrypt_kdf(local, passwd, passwdlen, salt, saltlen,
- *     N, r, p, buf, buflen):
+ *     N, r, p, threads, progress, buf, buflen):
  * Compute scrypt(passwd[0 .. passwdlen - 1], salt[0 .. saltlen - 1], N, r,
  * p, buflen) and write the result into buf.  The parameters r, p, and buflen
  * must satisfy r * p < 2^30 and buflen <= (2^32 - 1) * 32.  The parameter N
- * must be a power of 2 greater than 1.
+ * must be a power of 2 greater than 1.  Up to min(threads, p) SMix calls run
+ * concurrently, each with its own V and XY.  If progress is not NULL, its
+ * callback is invoked regularly, and the computation is aborted if it
+ * returns a non-zero value.
  *
  * Return 0 on success; or -1 on error.
  */
 int
 escrypt_kdf_sse(escrypt_local_t *local, const uint8_t *passwd, size_t passwdlen,
                 const uint8_t *salt, size_t saltlen, uint64_t N, uint32_t _r,
-                uint32_t _p, uint8_t *buf, size_t buflen)
+                uint32_t _p, uint32_t threads, escrypt_progress_t *progress,
+                uint8_t *buf, size_t buflen)
 {
     size_t    B_size, V_size, XY_size, need;
     uint8_t * B;
-    uint32_t *V, *XY;
+    uint8_t * V;
     size_t    r = _r, p = _p;
-    uint32_t  i;
 
 /* Sanity-check parameters. */
 # if SIZE_MAX > UINT32_MAX
@@ -368,6 +379,14 @@ escrypt_kdf_sse(escrypt_local_t *local, const uint8_t *passwd, size_t passwdlen,
         return -1;
     }
 /* LCOV_EXCL_END */
+    threads = escrypt_threads(threads, _p);
+/* LCOV_EXCL_START */
+    if ((size_t) (threads - 1U) > (SIZE_MAX - need) / (V_size + XY_size)) {
+        errno = ENOMEM;
+        return -1;
+    }
+/* LCOV_EXCL_END */
+    need += (size_t) (threads - 1U) * (V_size + XY_size);
     if (local->size < need) {
         if (escrypt_free_region(local)) {
             return -1; /* LCOV_EXCL_LINE */
@@ -377,16 +396,16 @@ escrypt_kdf_sse(escrypt_local_t *local, const uint8_t *passwd, size_t passwdlen,
         }
     }
     B  = (uint8_t *) local->aligned;
-    V  = (uint32_t *) ((uint8_t *) B + B_size);
-    XY = (uint32_t *) ((uint8_t *) V + V_size);
+    V  = B + B_size;
 
     /* 1: (B_0 ... B_{p-1}) <-- PBKDF2(P, S, 1, p * MFLen) */
     escrypt_PBKDF2_SHA256(passwd, passwdlen, salt, saltlen, 1, B, B_size);
 
     /* 2: for i = 0 to p - 1 do */
-    for (i = 0; i < p; i++) {
-        /* 3: B_i <-- MF(B_i, N) */
-        smix(&B[(size_t) 128 * i * r], r, N, V, XY);
+    /* 3: B_i <-- MF(B_i, N) */
+    if (escrypt_smix_all(smix, B, r, N, _p, 1U, V, V_size, XY_size, threads,
+                         progress) != 0) {
+        return -1;
     }
 
     /* 5: DK <-- PBKDF2(P, B, 1, dkLen) */
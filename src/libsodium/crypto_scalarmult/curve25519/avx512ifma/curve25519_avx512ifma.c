@@ -0,0 +1,168 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "private/ed25519_ref10.h"
+#include "utils.h"
+
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("avx2")
+#  pragma GCC target("avx512f")
+#  pragma GCC target("avx512vl")
+#  pragma GCC target("avx512ifma")
+# endif
+
+# include <immintrin.h>
+
+# include "curve25519_avx512ifma.h"
+# include "private/fe25519x4_avx512ifma.h"
+
+# define X25519_BATCH_CHUNK 64U
+
+/*
+ Four independent Montgomery ladders, one per lane.
+ Returns the projective coordinates (X:Z) of each result.
+ */
+
+static void
+ladder4(fe25519 *x, fe25519 *z, unsigned char t[4][32],
+        const unsigned char *p[4])
+{
+    fe25519x4    x1, x2, z2, x3, z3;
+    fe25519x4    a, b, aa, bb, e, da, cb;
+    __m256i      swap, mask;
+    int          pos;
+    unsigned int bit[4];
+    unsigned int i;
+
+    fe25519x4_frombytes(&x1, p[0], p[1], p[2], p[3]);
+    fe25519x4_0(&x2);
+    x2.v[0] = _mm256_set1_epi64x(1);
+    fe25519x4_0(&z2);
+    x3 = x1;
+    z3 = x2;
+
+    swap = _mm256_setzero_si256();
+    for (pos = 254; pos >= 0; --pos) {
+        for (i = 0; i < 4; i++) {
+            bit[i] = (t[i][pos / 8] >> (pos & 7)) & 1;
+        }
+        mask = _mm256_set_epi64x(-(long long) bit[3], -(long long) bit[2],
+                                 -(long long) bit[1], -(long long) bit[0]);
+        swap = _mm256_xor_si256(swap, mask);
+        fe25519x4_cswap(&x2, &x3, swap);
+        fe25519x4_cswap(&z2, &z3, swap);
+        swap = mask;
+
+        fe25519x4_add(&a, &x2, &z2);
+        fe25519x4_carry(&a, &a);
+        fe25519x4_sub(&b, &x2, &z2);
+        fe25519x4_carry(&b, &b);
+        fe25519x4_mul(&aa, &a, &a);
+        fe25519x4_mul(&bb, &b, &b);
+        fe25519x4_mul(&x2, &aa, &bb);
+        fe25519x4_sub(&e, &aa, &bb);
+        fe25519x4_carry(&e, &e);
+        fe25519x4_sub(&da, &x3, &z3);
+        fe25519x4_carry(&da, &da);
+        fe25519x4_mul(&da, &da, &a);
+        fe25519x4_add(&cb, &x3, &z3);
+        fe25519x4_carry(&cb, &cb);
+        fe25519x4_mul(&cb, &cb, &b);
+        fe25519x4_add(&x3, &da, &cb);
+        fe25519x4_carry(&x3, &x3);
+        fe25519x4_mul(&x3, &x3, &x3);
+        fe25519x4_sub(&z3, &da, &cb);
+        fe25519x4_carry(&z3, &z3);
+        fe25519x4_mul(&z3, &z3, &z3);
+        fe25519x4_mul(&z3, &z3, &x1);
+        fe25519x4_mul32(&z2, &e, 121666);
+        fe25519x4_add(&z2, &z2, &bb);
+        fe25519x4_carry(&z2, &z2);
+        fe25519x4_mul(&z2, &z2, &e);
+    }
+    fe25519x4_cswap(&x2, &x3, swap);
+    fe25519x4_cswap(&z2, &z3, swap);
+
+    for (i = 0; i < 4; i++) {
+        fe25519x4_to_fe25519(x[i], &x2, (int) i);
+        fe25519x4_to_fe25519(z[i], &z2, (int) i);
+    }
+}
+
+/*
+ q[i] = n[i] * p[i] for count <= X25519_BATCH_CHUNK, sharing a single
+ inversion across the whole chunk (Montgomery's trick).
+ */
+
+static void
+batch_chunk(unsigned char * const *q, const unsigned char * const *n,
+            const unsigned char * const *p, size_t count)
+{
+    unsigned char        t[4][32];
+    const unsigned char *pl[4];
+    fe25519              x[X25519_BATCH_CHUNK + 3];
+    fe25519              z[X25519_BATCH_CHUNK + 3];
+    fe25519              acc[X25519_BATCH_CHUNK];
+    fe25519              inv, zinv, zero, one;
+    size_t               i, j, k;
+    unsigned int         iszero;
+
+    for (i = 0; i < count; i += 4) {
+        for (j = 0; j < 4; j++) {
+            k = i + j < count ? i + j : count - 1;
+            memcpy(t[j], n[k], 32);
+            t[j][0] &= 248;
+            t[j][31] &= 127;
+            t[j][31] |= 64;
+            pl[j] = p[k];
+        }
+        ladder4(x + i, z + i, t, pl);
+    }
+    sodium_memzero(t, sizeof t);
+
+    fe25519_0(zero);
+    fe25519_1(one);
+    for (i = 0; i < count; i++) {
+        iszero = (unsigned int) fe25519_iszero(z[i]);
+        fe25519_cmov(x[i], zero, iszero);
+        fe25519_cmov(z[i], one, iszero);
+        if (i == 0) {
+            fe25519_copy(acc[0], z[0]);
+        } else {
+            fe25519_mul(acc[i], acc[i - 1], z[i]);
+        }
+    }
+    fe25519_invert(inv, acc[count - 1]);
+    for (i = count - 1; i > 0; i--) {
+        fe25519_mul(zinv, inv, acc[i - 1]);
+        fe25519_mul(inv, inv, z[i]);
+        fe25519_mul(x[i], x[i], zinv);
+        fe25519_tobytes(q[i], x[i]);
+    }
+    fe25519_mul(x[0], x[0], inv);
+    fe25519_tobytes(q[0], x[0]);
+}
+
+void
+crypto_scalarmult_curve25519_avx512ifma_batch(unsigned char * const *q,
+                                              const unsigned char * const *n,
+                                              const unsigned char * const *p,
+                                              size_t count)
+{
+    size_t i;
+    size_t chunk;
+
+    for (i = 0; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > X25519_BATCH_CHUNK) {
+            chunk = X25519_BATCH_CHUNK;
+        }
+        batch_chunk(&q[i], &n[i], &p[i], chunk);
+    }
+}
+
+#endif
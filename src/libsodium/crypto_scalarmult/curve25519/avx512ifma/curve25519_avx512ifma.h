@@ -0,0 +1,11 @@
+#ifndef curve25519_avx512ifma_H
+#define curve25519_avx512ifma_H
+
+#include <stddef.h>
+
+void crypto_scalarmult_curve25519_avx512ifma_batch(unsigned char * const *q,
+                                                   const unsigned char * const *n,
+                                                   const unsigned char * const *p,
+                                                   size_t count);
+
+#endif
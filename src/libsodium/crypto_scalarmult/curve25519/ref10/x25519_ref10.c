@@ -1,6 +1,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "../scalarmult_curve25519.h"
 #include "export.h"
@@ -168,6 +169,65 @@ crypto_scalarmult_curve25519_ref10_base(unsigned char *q,
     return 0;
 }
 
+#define X25519_BASE_BATCH 16U
+
+/*
+ * The conversions to the Montgomery form share a single inversion per
+ * chunk.
+ */
+void
+crypto_scalarmult_curve25519_ref10_base_batch(unsigned char *q,
+                                              const unsigned char *n,
+                                              size_t count)
+{
+    unsigned char t[32];
+    ge25519_p3    A[X25519_BASE_BATCH];
+    fe25519       num[X25519_BASE_BATCH];
+    fe25519       den[X25519_BASE_BATCH];
+    fe25519       acc[X25519_BASE_BATCH];
+    fe25519       recip;
+    fe25519       u;
+    size_t        chunk;
+    size_t        i;
+    size_t        j;
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > X25519_BASE_BATCH) {
+            chunk = X25519_BASE_BATCH;
+        }
+        for (j = 0U; j < chunk; j++) {
+            memcpy(t, &n[(i + j) * 32U], 32U);
+            t[0] &= 248;
+            t[31] &= 127;
+            t[31] |= 64;
+            ge25519_scalarmult_base(&A[j], t);
+            fe25519_add(num[j], A[j].Z, A[j].Y);
+            fe25519_sub(den[j], A[j].Z, A[j].Y);
+        }
+        fe25519_copy(acc[0], den[0]);
+        for (j = 1U; j < chunk; j++) {
+            fe25519_mul(acc[j], acc[j - 1U], den[j]);
+        }
+        fe25519_invert(recip, acc[chunk - 1U]);
+        for (j = chunk - 1U; j > 0U; j--) {
+            fe25519_mul(u, recip, acc[j - 1U]);
+            fe25519_mul(recip, recip, den[j]);
+            fe25519_mul(u, num[j], u);
+            fe25519_tobytes(&q[(i + j) * 32U], u);
+        }
+        fe25519_mul(u, num[0], recip);
+        fe25519_tobytes(&q[i * 32U], u);
+    }
+    sodium_memzero(t, sizeof t);
+    sodium_memzero(A, sizeof A);
+    sodium_memzero(num, sizeof num);
+    sodium_memzero(den, sizeof den);
+    sodium_memzero(acc, sizeof acc);
+    sodium_memzero(recip, sizeof recip);
+    sodium_memzero(u, sizeof u);
+}
+
 struct crypto_scalarmult_curve25519_implementation
     crypto_scalarmult_curve25519_ref10_implementation = {
         SODIUM_C99(.mult =) crypto_scalarmult_curve25519_ref10,
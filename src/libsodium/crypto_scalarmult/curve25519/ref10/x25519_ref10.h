@@ -7,4 +7,8 @@
 extern struct crypto_scalarmult_curve25519_implementation
     crypto_scalarmult_curve25519_ref10_implementation;
 
+void crypto_scalarmult_curve25519_ref10_base_batch(unsigned char *q,
+                                                   const unsigned char *n,
+                                                   size_t count);
+
 #endif
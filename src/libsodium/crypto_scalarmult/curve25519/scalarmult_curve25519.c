@@ -1,12 +1,18 @@
 
 #include "crypto_scalarmult_curve25519.h"
 #include "private/implementations.h"
+#include "private/probes.h"
+#include "private/stats.h"
 #include "scalarmult_curve25519.h"
 #include "runtime.h"
 
 #ifdef HAVE_AVX_ASM
 # include "sandy2x/curve25519_sandy2x.h"
 #endif
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H)
+# include "avx512ifma/curve25519_avx512ifma.h"
+static int use_avx512ifma_batch;
+#endif
 #include "ref10/x25519_ref10.h"
 static const crypto_scalarmult_curve25519_implementation *implementation =
     &crypto_scalarmult_curve25519_ref10_implementation;
@@ -17,21 +23,82 @@ crypto_scalarmult_curve25519(unsigned char *q, const unsigned char *n,
 {
     size_t                 i;
     volatile unsigned char d = 0;
+    int                    ret;
+    SODIUM_STATS_START(stats_start)
 
+    SODIUM_PROBE(scalarmult__entry);
     if (implementation->mult(q, n, p) != 0) {
+        SODIUM_STATS_STOP(stats_start, SODIUM_STATS_SCALARMULT, 0U);
+        SODIUM_PROBE1(scalarmult__return, -1);
         return -1; /* LCOV_EXCL_LINE */
     }
     for (i = 0; i < crypto_scalarmult_curve25519_BYTES; i++) {
         d |= q[i];
     }
-    return -(1 & ((d - 1) >> 8));
+    ret = -(1 & ((d - 1) >> 8));
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_SCALARMULT,
+                      crypto_scalarmult_curve25519_BYTES);
+    SODIUM_PROBE1(scalarmult__return, ret);
+
+    return ret;
+}
+
+int
+crypto_scalarmult_curve25519_batch(unsigned char * const *q,
+                                   const unsigned char * const *n,
+                                   const unsigned char * const *p,
+                                   size_t count)
+{
+    size_t i;
+    int    ret = 0;
+
+    SODIUM_PROBE1(scalarmult_batch__entry, count);
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H)
+    if (use_avx512ifma_batch) {
+        volatile unsigned char d;
+        size_t                 j;
+
+        crypto_scalarmult_curve25519_avx512ifma_batch(q, n, p, count);
+        for (i = 0; i < count; i++) {
+            d = 0;
+            for (j = 0; j < crypto_scalarmult_curve25519_BYTES; j++) {
+                d |= q[i][j];
+            }
+            ret |= -(1 & ((d - 1) >> 8));
+        }
+        SODIUM_PROBE1(scalarmult_batch__return, ret);
+        return ret;
+    }
+#endif
+    for (i = 0; i < count; i++) {
+        ret |= crypto_scalarmult_curve25519(q[i], n[i], p[i]);
+    }
+    SODIUM_PROBE1(scalarmult_batch__return, ret);
+    return ret;
 }
 
 int
 crypto_scalarmult_curve25519_base(unsigned char *q, const unsigned char *n)
 {
-    return crypto_scalarmult_curve25519_ref10_implementation
-        .mult_base(q, n);
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = crypto_scalarmult_curve25519_ref10_implementation.mult_base(q, n);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_SCALARMULT,
+                      crypto_scalarmult_curve25519_BYTES);
+
+    return ret;
+}
+
+void
+crypto_scalarmult_curve25519_base_batch(unsigned char *q,
+                                        const unsigned char *n, size_t count)
+{
+    SODIUM_STATS_START(stats_start)
+
+    crypto_scalarmult_curve25519_ref10_base_batch(q, n, count);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_SCALARMULT,
+                      count * crypto_scalarmult_curve25519_BYTES);
 }
 
 size_t
@@ -50,11 +117,20 @@ int
 _crypto_scalarmult_curve25519_pick_best_implementation(void)
 {
     implementation = &crypto_scalarmult_curve25519_ref10_implementation;
+    _sodium_implementation_selected("curve25519", "ref10");
 
 #ifdef HAVE_AVX_ASM
-    if (sodium_runtime_has_avx()) {
+    if (sodium_runtime_has_avx() &&
+        _sodium_implementation_allowed("curve25519", "sandy2x")) {
         implementation = &crypto_scalarmult_curve25519_sandy2x_implementation;
+        _sodium_implementation_selected("curve25519", "sandy2x");
     }
+#endif
+#if defined(HAVE_AVX512IFMAINTRIN_H) && defined(HAVE_AVX2INTRIN_H)
+    /* The batch code is only used without an override */
+    use_avx512ifma_batch = sodium_runtime_has_avx512ifma() &&
+        _sodium_runtime_use_512bit_vectors() &&
+        _sodium_implementation_allowed("curve25519", NULL);
 #endif
     return 0;
 }
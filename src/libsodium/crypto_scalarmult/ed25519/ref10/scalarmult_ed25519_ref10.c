@@ -1,4 +1,6 @@
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "crypto_scalarmult_ed25519.h"
@@ -70,6 +72,53 @@ crypto_scalarmult_ed25519_noclamp(unsigned char *q, const unsigned char *n,
     return _crypto_scalarmult_ed25519(q, n, p, 0);
 }
 
+/* Variable-time: for public scalars only */
+int
+crypto_scalarmult_ed25519_multi_noclamp(unsigned char *q,
+                                        const unsigned char *ns,
+                                        const unsigned char *ps,
+                                        size_t count)
+{
+    unsigned char *t;
+    ge25519_p3    *P;
+    ge25519_p3     Q;
+    size_t         i;
+    int            ret = -1;
+
+    if (count == 0U || count > SIZE_MAX / sizeof *P) {
+        return -1;
+    }
+    if ((t = (unsigned char *) malloc(count * 32U)) == NULL) {
+        return -1;
+    }
+    if ((P = (ge25519_p3 *) malloc(count * sizeof *P)) == NULL) {
+        free(t);
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        if (ge25519_is_canonical(&ps[i * 32U]) == 0 ||
+            ge25519_has_small_order(&ps[i * 32U]) != 0 ||
+            ge25519_frombytes(&P[i], &ps[i * 32U]) != 0 ||
+            ge25519_is_on_main_subgroup(&P[i]) == 0) {
+            goto done;
+        }
+        memcpy(&t[i * 32U], &ns[i * 32U], 32U);
+        t[i * 32U + 31U] &= 127;
+    }
+    if (ge25519_multi_scalarmult_vartime(&Q, t, P, count) != 0) {
+        goto done;
+    }
+    ge25519_p3_tobytes(q, &Q);
+    if (_crypto_scalarmult_ed25519_is_inf(q) == 0) {
+        ret = 0;
+    }
+done:
+    free(P);
+    free(t);
+
+    return ret;
+}
+
 static int
 _crypto_scalarmult_ed25519_base(unsigned char *q,
                                 const unsigned char *n, const int clamp)
@@ -1,8 +1,11 @@
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "crypto_scalarmult_ed25519.h"
 #include "crypto_scalarmult_ristretto255.h"
+#include "private/common.h"
 #include "private/ed25519_ref10.h"
 #include "utils.h"
 
@@ -30,6 +33,50 @@ crypto_scalarmult_ristretto255(unsigned char *q, const unsigned char *n,
     return 0;
 }
 
+/* Variable-time: for public scalars only */
+int
+crypto_scalarmult_ristretto255_multi(unsigned char *q,
+                                     const unsigned char *ns,
+                                     const unsigned char *ps,
+                                     size_t count)
+{
+    unsigned char *t;
+    ge25519_p3    *P;
+    ge25519_p3     Q;
+    size_t         i;
+    int            ret = -1;
+
+    if (count == 0U || count > SIZE_MAX / sizeof *P) {
+        return -1;
+    }
+    if ((t = (unsigned char *) malloc(count * 32U)) == NULL) {
+        return -1;
+    }
+    if ((P = (ge25519_p3 *) malloc(count * sizeof *P)) == NULL) {
+        free(t);
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        if (ristretto255_frombytes(&P[i], &ps[i * 32U]) != 0) {
+            goto done;
+        }
+        memcpy(&t[i * 32U], &ns[i * 32U], 32U);
+        t[i * 32U + 31U] &= 127;
+    }
+    if (ge25519_multi_scalarmult_vartime(&Q, t, P, count) != 0) {
+        goto done;
+    }
+    ristretto255_p3_tobytes(q, &Q);
+    if (sodium_is_zero(q, 32) == 0) {
+        ret = 0;
+    }
+done:
+    free(P);
+    free(t);
+
+    return ret;
+}
+
 int
 crypto_scalarmult_ristretto255_base(unsigned char *q,
                                     const unsigned char *n)
@@ -50,6 +97,147 @@ crypto_scalarmult_ristretto255_base(unsigned char *q,
     return 0;
 }
 
+typedef struct ristretto255_table_ {
+    ge25519_precomp precomp[32][8];
+} ristretto255_table;
+
+int
+crypto_scalarmult_ristretto255_table_create(crypto_scalarmult_ristretto255_table *table,
+                                            const unsigned char *p)
+{
+    ristretto255_table *tb = (ristretto255_table *) (void *) table;
+    ge25519_p3          P;
+
+    COMPILER_ASSERT(sizeof *tb <= sizeof *table);
+    if (ristretto255_frombytes(&P, p) != 0) {
+        return -1;
+    }
+    ge25519_scalarmult_table_init(tb->precomp, &P);
+
+    return 0;
+}
+
+int
+crypto_scalarmult_ristretto255_table_mul(unsigned char *q,
+                                         const unsigned char *n,
+                                         const crypto_scalarmult_ristretto255_table *table)
+{
+    const ristretto255_table *tb =
+        (const ristretto255_table *) (const void *) table;
+    unsigned char            *t = q;
+    ge25519_p3                Q;
+    unsigned int              i;
+
+    for (i = 0; i < 32; ++i) {
+        t[i] = n[i];
+    }
+    t[31] &= 127;
+    ge25519_scalarmult_table(&Q, t, tb->precomp);
+    ristretto255_p3_tobytes(q, &Q);
+    if (sodium_is_zero(q, 32)) {
+        return -1;
+    }
+    return 0;
+}
+
+struct crypto_scalarmult_ristretto255_msm_table {
+    ge25519_precomp *precomp;
+    size_t           count;
+    int              w;
+};
+
+crypto_scalarmult_ristretto255_msm_table *
+crypto_scalarmult_ristretto255_msm_precompute(const unsigned char *ps,
+                                              size_t count)
+{
+    crypto_scalarmult_ristretto255_msm_table *table;
+    ge25519_p3                               *P;
+    size_t                                    i;
+    int                                       w;
+    int                                       windows;
+
+    if (count == 0U || count > SIZE_MAX / sizeof *P) {
+        return NULL;
+    }
+    w       = ge25519_multi_scalarmult_fixed_window(count);
+    windows = ge25519_multi_scalarmult_fixed_windows(w);
+    if (count > SIZE_MAX / ((size_t) windows * sizeof(ge25519_precomp))) {
+        return NULL;
+    }
+    if ((table = (crypto_scalarmult_ristretto255_msm_table *)
+         malloc(sizeof *table)) == NULL) {
+        return NULL;
+    }
+    if ((table->precomp = (ge25519_precomp *)
+         malloc(count * (size_t) windows * sizeof *table->precomp)) == NULL) {
+        free(table);
+        return NULL;
+    }
+    if ((P = (ge25519_p3 *) malloc(count * sizeof *P)) == NULL) {
+        free(table->precomp);
+        free(table);
+        return NULL;
+    }
+    for (i = 0U; i < count; i++) {
+        if (ristretto255_frombytes(&P[i], &ps[i * 32U]) != 0) {
+            free(P);
+            free(table->precomp);
+            free(table);
+            return NULL;
+        }
+    }
+    ge25519_multi_scalarmult_fixed_init(table->precomp, P, count, w);
+    table->count = count;
+    table->w     = w;
+    free(P);
+
+    return table;
+}
+
+void
+crypto_scalarmult_ristretto255_msm_free(crypto_scalarmult_ristretto255_msm_table *table)
+{
+    if (table == NULL) {
+        return;
+    }
+    free(table->precomp);
+    free(table);
+}
+
+int
+crypto_scalarmult_ristretto255_msm_fixed(unsigned char *q,
+                                         const unsigned char *ns, size_t count,
+                                         const crypto_scalarmult_ristretto255_msm_table *table)
+{
+    unsigned char *t;
+    ge25519_p3     Q;
+    size_t         i;
+    int            ret = -1;
+
+    if (count == 0U || count > table->count) {
+        return -1;
+    }
+    if ((t = (unsigned char *) malloc(count * 32U)) == NULL) {
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        memcpy(&t[i * 32U], &ns[i * 32U], 32U);
+        t[i * 32U + 31U] &= 127;
+    }
+    if (ge25519_multi_scalarmult_fixed_vartime(&Q, t, table->precomp, count,
+                                               table->w) != 0) {
+        goto done;
+    }
+    ristretto255_p3_tobytes(q, &Q);
+    if (sodium_is_zero(q, 32) == 0) {
+        ret = 0;
+    }
+done:
+    free(t);
+
+    return ret;
+}
+
 size_t
 crypto_scalarmult_ristretto255_bytes(void)
 {
@@ -61,3 +249,9 @@ crypto_scalarmult_ristretto255_scalarbytes(void)
 {
     return crypto_scalarmult_ristretto255_SCALARBYTES;
 }
+
+size_t
+crypto_scalarmult_ristretto255_tablebytes(void)
+{
+    return sizeof(crypto_scalarmult_ristretto255_table);
+}
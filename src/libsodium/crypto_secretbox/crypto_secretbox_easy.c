@@ -10,9 +10,46 @@
 #include "crypto_onetimeauth_poly1305.h"
 #include "crypto_secretbox.h"
 #include "crypto_stream_salsa20.h"
+#include "crypto_verify_16.h"
 #include "private/common.h"
 #include "utils.h"
 
+/*
+ * The message is encrypted and authenticated in chunks of this size, so that
+ * the ciphertext is still in the cache when Poly1305 reads it. Must be a
+ * multiple of the Salsa20 block size.
+ */
+#define SECRETBOX_CHUNK_BYTES 8192U
+
+static void
+secretbox_xor_mac(unsigned char *out, const unsigned char *in,
+                  unsigned long long len, const unsigned char *n,
+                  const unsigned char *subkey,
+                  crypto_onetimeauth_poly1305_state *state, const int encrypt)
+{
+    unsigned long long chunk_len;
+    uint64_t           ic = 1U;
+
+    COMPILER_ASSERT(SECRETBOX_CHUNK_BYTES % 64U == 0U);
+    while (len > 0U) {
+        chunk_len = len;
+        if (chunk_len > SECRETBOX_CHUNK_BYTES) {
+            chunk_len = SECRETBOX_CHUNK_BYTES;
+        }
+        if (encrypt == 0) {
+            crypto_onetimeauth_poly1305_update(state, in, chunk_len);
+        }
+        crypto_stream_salsa20_xor_ic(out, in, chunk_len, n, ic, subkey);
+        if (encrypt != 0) {
+            crypto_onetimeauth_poly1305_update(state, out, chunk_len);
+        }
+        ic += chunk_len / 64U;
+        out += chunk_len;
+        in += chunk_len;
+        len -= chunk_len;
+    }
+}
+
 int
 crypto_secretbox_detached(unsigned char *c, unsigned char *mac,
                           const unsigned char *m,
@@ -60,13 +97,11 @@ crypto_secretbox_detached(unsigned char *c, unsigned char *mac,
         c[i] = block0[crypto_secretbox_ZEROBYTES + i];
     }
     sodium_memzero(block0, sizeof block0);
-    if (mlen > mlen0) {
-        crypto_stream_salsa20_xor_ic(c + mlen0, m + mlen0, mlen - mlen0,
-                                     n + 16, 1U, subkey);
-    }
+    crypto_onetimeauth_poly1305_update(&state, c, mlen0);
+    secretbox_xor_mac(c + mlen0, m + mlen0, mlen - mlen0, n + 16, subkey,
+                      &state, 1);
     sodium_memzero(subkey, sizeof subkey);
 
-    crypto_onetimeauth_poly1305_update(&state, c, mlen);
     crypto_onetimeauth_poly1305_final(&state, mac);
     sodium_memzero(&state, sizeof state);
 
@@ -92,10 +127,13 @@ crypto_secretbox_open_detached(unsigned char *m, const unsigned char *c,
                                const unsigned char *n,
                                const unsigned char *k)
 {
-    unsigned char      block0[64U];
-    unsigned char      subkey[crypto_stream_salsa20_KEYBYTES];
-    unsigned long long i;
-    unsigned long long mlen0;
+    crypto_onetimeauth_poly1305_state state;
+    unsigned char                     computed_mac[crypto_secretbox_MACBYTES];
+    unsigned char                     block0[64U];
+    unsigned char                     subkey[crypto_stream_salsa20_KEYBYTES];
+    unsigned long long                i;
+    unsigned long long                mlen0;
+    int                               ret;
 
     crypto_core_hsalsa20(subkey, n, k, NULL);
 
@@ -108,6 +146,37 @@ crypto_secretbox_open_detached(unsigned char *m, const unsigned char *c,
         block0[crypto_secretbox_ZEROBYTES + i] = c[i];
     }
     crypto_stream_salsa20_xor(block0, block0, 64, n + 16, subkey);
+
+    /*
+     * If the output overlaps neither the ciphertext nor the MAC, the
+     * ciphertext is authenticated and decrypted in a single pass, and the
+     * output is cleared if verification fails. Otherwise, clearing it would
+     * destroy the caller's input, so it is verified before decryption.
+     */
+    if (m != NULL &&
+        ((uintptr_t) m >= (uintptr_t) c + clen ||
+         (uintptr_t) c >= (uintptr_t) m + clen) &&
+        ((uintptr_t) m >= (uintptr_t) mac + crypto_secretbox_MACBYTES ||
+         (uintptr_t) mac >= (uintptr_t) m + clen)) {
+        crypto_onetimeauth_poly1305_init(&state, block0);
+        crypto_onetimeauth_poly1305_update(&state, c, mlen0);
+        for (i = 0U; i < mlen0; i++) {
+            m[i] = block0[crypto_secretbox_ZEROBYTES + i];
+        }
+        sodium_memzero(block0, sizeof block0);
+        secretbox_xor_mac(m + mlen0, c + mlen0, clen - mlen0, n + 16, subkey,
+                          &state, 0);
+        sodium_memzero(subkey, sizeof subkey);
+        crypto_onetimeauth_poly1305_final(&state, computed_mac);
+        sodium_memzero(&state, sizeof state);
+        ret = crypto_verify_16(computed_mac, mac);
+        sodium_memzero(computed_mac, sizeof computed_mac);
+        if (ret != 0) {
+            sodium_memzero(m, clen);
+            return -1;
+        }
+        return 0;
+    }
     if (crypto_onetimeauth_poly1305_verify(mac, c, clen, block0) != 0) {
         sodium_memzero(subkey, sizeof subkey);
         return -1;
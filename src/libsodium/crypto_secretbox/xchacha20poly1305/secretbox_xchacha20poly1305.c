@@ -15,22 +15,16 @@
 
 #define crypto_secretbox_xchacha20poly1305_ZEROBYTES 32U
 
-int
-crypto_secretbox_xchacha20poly1305_detached(unsigned char *c,
-                                            unsigned char *mac,
-                                            const unsigned char *m,
-                                            unsigned long long mlen,
-                                            const unsigned char *n,
-                                            const unsigned char *k)
+static void
+_detached(unsigned char *c, unsigned char *mac, const unsigned char *m,
+          unsigned long long mlen, const unsigned char *n8,
+          const unsigned char *subkey)
 {
     crypto_onetimeauth_poly1305_state state;
     unsigned char                     block0[64U];
-    unsigned char                     subkey[crypto_stream_chacha20_KEYBYTES];
     unsigned long long                i;
     unsigned long long                mlen0;
 
-    crypto_core_hchacha20(subkey, n, k, NULL);
-
     /*
      * Allow the m and and c buffer to partially overlap, by calling
      * memmove() if necessary.
@@ -57,7 +51,7 @@ crypto_secretbox_xchacha20poly1305_detached(unsigned char *c,
     }
     crypto_stream_chacha20_xor(block0, block0,
                                mlen0 + crypto_secretbox_xchacha20poly1305_ZEROBYTES,
-                               n + 16, subkey);
+                               n8, subkey);
     COMPILER_ASSERT(crypto_secretbox_xchacha20poly1305_ZEROBYTES >=
                     crypto_onetimeauth_poly1305_KEYBYTES);
     crypto_onetimeauth_poly1305_init(&state, block0);
@@ -68,13 +62,26 @@ crypto_secretbox_xchacha20poly1305_detached(unsigned char *c,
     sodium_memzero(block0, sizeof block0);
     if (mlen > mlen0) {
         crypto_stream_chacha20_xor_ic(c + mlen0, m + mlen0, mlen - mlen0,
-                                      n + 16, 1U, subkey);
+                                      n8, 1U, subkey);
     }
-    sodium_memzero(subkey, sizeof subkey);
-
     crypto_onetimeauth_poly1305_update(&state, c, mlen);
     crypto_onetimeauth_poly1305_final(&state, mac);
     sodium_memzero(&state, sizeof state);
+}
+
+int
+crypto_secretbox_xchacha20poly1305_detached(unsigned char *c,
+                                            unsigned char *mac,
+                                            const unsigned char *m,
+                                            unsigned long long mlen,
+                                            const unsigned char *n,
+                                            const unsigned char *k)
+{
+    unsigned char subkey[crypto_stream_chacha20_KEYBYTES];
+
+    crypto_core_hchacha20(subkey, n, k, NULL);
+    _detached(c, mac, m, mlen, n + 16, subkey);
+    sodium_memzero(subkey, sizeof subkey);
 
     return 0;
 }
@@ -93,21 +100,15 @@ crypto_secretbox_xchacha20poly1305_easy(unsigned char *c,
         (c + crypto_secretbox_xchacha20poly1305_MACBYTES, c, m, mlen, n, k);
 }
 
-int
-crypto_secretbox_xchacha20poly1305_open_detached(unsigned char *m,
-                                                 const unsigned char *c,
-                                                 const unsigned char *mac,
-                                                 unsigned long long clen,
-                                                 const unsigned char *n,
-                                                 const unsigned char *k)
+static int
+_open_detached(unsigned char *m, const unsigned char *c,
+               const unsigned char *mac, unsigned long long clen,
+               const unsigned char *n8, const unsigned char *subkey)
 {
     unsigned char      block0[64U];
-    unsigned char      subkey[crypto_stream_chacha20_KEYBYTES];
     unsigned long long i;
     unsigned long long mlen0;
 
-    crypto_core_hchacha20(subkey, n, k, NULL);
-
     memset(block0, 0, crypto_secretbox_xchacha20poly1305_ZEROBYTES);
     mlen0 = clen;
     if (mlen0 > 64U - crypto_secretbox_xchacha20poly1305_ZEROBYTES) {
@@ -116,12 +117,13 @@ crypto_secretbox_xchacha20poly1305_open_detached(unsigned char *m,
     for (i = 0U; i < mlen0; i++) {
         block0[crypto_secretbox_xchacha20poly1305_ZEROBYTES + i] = c[i];
     }
-    crypto_stream_chacha20_xor(block0, block0, 64, n + 16, subkey);
+    crypto_stream_chacha20_xor(block0, block0, 64, n8, subkey);
     if (crypto_onetimeauth_poly1305_verify(mac, c, clen, block0) != 0) {
-        sodium_memzero(subkey, sizeof subkey);
+        sodium_memzero(block0, sizeof block0);
         return -1;
     }
     if (m == NULL) {
+        sodium_memzero(block0, sizeof block0);
         return 0;
     }
 
@@ -143,13 +145,30 @@ crypto_secretbox_xchacha20poly1305_open_detached(unsigned char *m,
     for (i = 0U; i < mlen0; i++) {
         m[i] = block0[crypto_secretbox_xchacha20poly1305_ZEROBYTES + i];
     }
+    sodium_memzero(block0, sizeof block0);
     if (clen > mlen0) {
         crypto_stream_chacha20_xor_ic(m + mlen0, c + mlen0, clen - mlen0,
-                                      n + 16, 1U, subkey);
+                                      n8, 1U, subkey);
     }
+    return 0;
+}
+
+int
+crypto_secretbox_xchacha20poly1305_open_detached(unsigned char *m,
+                                                 const unsigned char *c,
+                                                 const unsigned char *mac,
+                                                 unsigned long long clen,
+                                                 const unsigned char *n,
+                                                 const unsigned char *k)
+{
+    unsigned char subkey[crypto_stream_chacha20_KEYBYTES];
+    int           ret;
+
+    crypto_core_hchacha20(subkey, n, k, NULL);
+    ret = _open_detached(m, c, mac, clen, n + 16, subkey);
     sodium_memzero(subkey, sizeof subkey);
 
-    return 0;
+    return ret;
 }
 
 int
@@ -167,6 +186,50 @@ crypto_secretbox_xchacha20poly1305_open_easy(unsigned char *m,
          clen - crypto_secretbox_xchacha20poly1305_MACBYTES, n, k);
 }
 
+int
+crypto_secretbox_xchacha20poly1305_beforenm(crypto_secretbox_xchacha20poly1305_precomputed *state,
+                                            const unsigned char *n_prefix,
+                                            const unsigned char *k)
+{
+    COMPILER_ASSERT(crypto_secretbox_xchacha20poly1305_NONCEPREFIXBYTES ==
+                    crypto_core_hchacha20_INPUTBYTES);
+    COMPILER_ASSERT(sizeof state->opaque == crypto_core_hchacha20_OUTPUTBYTES);
+    crypto_core_hchacha20(state->opaque, n_prefix, k, NULL);
+
+    return 0;
+}
+
+int
+crypto_secretbox_xchacha20poly1305_easy_afternm(unsigned char *c,
+                                                const unsigned char *m,
+                                                unsigned long long mlen,
+                                                const unsigned char *n_suffix,
+                                                const crypto_secretbox_xchacha20poly1305_precomputed *state)
+{
+    if (mlen > crypto_secretbox_xchacha20poly1305_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    _detached(c + crypto_secretbox_xchacha20poly1305_MACBYTES, c, m, mlen,
+              n_suffix, state->opaque);
+
+    return 0;
+}
+
+int
+crypto_secretbox_xchacha20poly1305_open_easy_afternm(unsigned char *m,
+                                                     const unsigned char *c,
+                                                     unsigned long long clen,
+                                                     const unsigned char *n_suffix,
+                                                     const crypto_secretbox_xchacha20poly1305_precomputed *state)
+{
+    if (clen < crypto_secretbox_xchacha20poly1305_MACBYTES) {
+        return -1;
+    }
+    return _open_detached(m, c + crypto_secretbox_xchacha20poly1305_MACBYTES, c,
+                          clen - crypto_secretbox_xchacha20poly1305_MACBYTES,
+                          n_suffix, state->opaque);
+}
+
 size_t
 crypto_secretbox_xchacha20poly1305_keybytes(void)
 {
@@ -0,0 +1,271 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_aead_aegis256.h"
+#include "crypto_secretstream_aegis256.h"
+#include "randombytes.h"
+#include "utils.h"
+
+#include "private/common.h"
+
+#define crypto_secretstream_aegis256_COUNTERBYTES  8U
+#define crypto_secretstream_aegis256_INONCEBYTES   24U
+
+#define STATE_COUNTER(STATE) ((STATE)->nonce)
+#define STATE_INONCE(STATE)  ((STATE)->nonce + \
+                              crypto_secretstream_aegis256_COUNTERBYTES)
+
+/*
+ * Each chunk is AEGIS-256(tag || m, ad) under the current key and nonce.
+ * The nonce is a 64-bit little-endian counter followed by an inner nonce,
+ * into which every tag is absorbed, as in the XChaCha20-Poly1305 stream.
+ * The subkey is derived from the header using AEGIS-256-MAC.
+ */
+
+static inline void
+_crypto_secretstream_aegis256_counter_reset
+    (crypto_secretstream_aegis256_state *state)
+{
+    memset(STATE_COUNTER(state), 0,
+           crypto_secretstream_aegis256_COUNTERBYTES);
+    STATE_COUNTER(state)[0] = 1;
+}
+
+static int
+_crypto_secretstream_aegis256_init
+    (crypto_secretstream_aegis256_state *state,
+     const unsigned char header[crypto_secretstream_aegis256_HEADERBYTES],
+     const unsigned char k[crypto_secretstream_aegis256_KEYBYTES])
+{
+    COMPILER_ASSERT(crypto_secretstream_aegis256_KEYBYTES ==
+                    crypto_aead_aegis256_MACBYTES_MAX);
+    COMPILER_ASSERT(sizeof state->nonce ==
+                    crypto_secretstream_aegis256_COUNTERBYTES +
+                    crypto_secretstream_aegis256_INONCEBYTES);
+
+    if (crypto_aead_aegis256_mac(state->k, sizeof state->k, NULL, 0U,
+                                 header, k) != 0) {
+        sodium_memzero(state, sizeof *state);
+        return -1;
+    }
+    _crypto_secretstream_aegis256_counter_reset(state);
+    memcpy(STATE_INONCE(state),
+           header + crypto_secretstream_aegis256_COUNTERBYTES,
+           crypto_secretstream_aegis256_INONCEBYTES);
+
+    return 0;
+}
+
+static inline void
+_crypto_secretstream_aegis256_ratchet
+    (crypto_secretstream_aegis256_state *state,
+     const unsigned char mac[crypto_aead_aegis256_ABYTES], unsigned char tag)
+{
+    COMPILER_ASSERT(crypto_aead_aegis256_ABYTES <=
+                    crypto_secretstream_aegis256_INONCEBYTES);
+    XOR_BUF(STATE_INONCE(state), mac, crypto_aead_aegis256_ABYTES);
+    sodium_increment(STATE_COUNTER(state),
+                     crypto_secretstream_aegis256_COUNTERBYTES);
+    if ((tag & crypto_secretstream_aegis256_TAG_REKEY) != 0 ||
+        sodium_is_zero(STATE_COUNTER(state),
+                       crypto_secretstream_aegis256_COUNTERBYTES)) {
+        crypto_secretstream_aegis256_rekey(state);
+    }
+}
+
+int
+crypto_secretstream_aegis256_is_available(void)
+{
+    return crypto_aead_aegis256_is_available();
+}
+
+void
+crypto_secretstream_aegis256_keygen
+   (unsigned char k[crypto_secretstream_aegis256_KEYBYTES])
+{
+    randombytes_buf(k, crypto_secretstream_aegis256_KEYBYTES);
+}
+
+int
+crypto_secretstream_aegis256_init_push
+   (crypto_secretstream_aegis256_state *state,
+    unsigned char out[crypto_secretstream_aegis256_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_aegis256_KEYBYTES])
+{
+    randombytes_buf(out, crypto_secretstream_aegis256_HEADERBYTES);
+
+    return _crypto_secretstream_aegis256_init(state, out, k);
+}
+
+int
+crypto_secretstream_aegis256_init_pull
+   (crypto_secretstream_aegis256_state *state,
+    const unsigned char in[crypto_secretstream_aegis256_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_aegis256_KEYBYTES])
+{
+    return _crypto_secretstream_aegis256_init(state, in, k);
+}
+
+void
+crypto_secretstream_aegis256_rekey
+    (crypto_secretstream_aegis256_state *state)
+{
+    unsigned char new_key_and_inonce[crypto_aead_aegis256_KEYBYTES +
+                                     crypto_secretstream_aegis256_INONCEBYTES];
+    unsigned char mac[crypto_aead_aegis256_ABYTES];
+
+    memcpy(new_key_and_inonce, state->k, crypto_aead_aegis256_KEYBYTES);
+    memcpy(new_key_and_inonce + crypto_aead_aegis256_KEYBYTES,
+           STATE_INONCE(state), crypto_secretstream_aegis256_INONCEBYTES);
+    crypto_aead_aegis256_encrypt_detached(new_key_and_inonce, mac, NULL,
+                                          new_key_and_inonce,
+                                          sizeof new_key_and_inonce,
+                                          NULL, 0U, NULL,
+                                          state->nonce, state->k);
+    memcpy(state->k, new_key_and_inonce, crypto_aead_aegis256_KEYBYTES);
+    memcpy(STATE_INONCE(state),
+           new_key_and_inonce + crypto_aead_aegis256_KEYBYTES,
+           crypto_secretstream_aegis256_INONCEBYTES);
+    sodium_memzero(new_key_and_inonce, sizeof new_key_and_inonce);
+    sodium_memzero(mac, sizeof mac);
+    _crypto_secretstream_aegis256_counter_reset(state);
+}
+
+int
+crypto_secretstream_aegis256_push
+   (crypto_secretstream_aegis256_state *state,
+    unsigned char *out, unsigned long long *outlen_p,
+    const unsigned char *m, unsigned long long mlen,
+    const unsigned char *ad, unsigned long long adlen, unsigned char tag)
+{
+    crypto_aead_aegis256_state aegis_state;
+    unsigned char             *mac;
+
+    if (outlen_p != NULL) {
+        *outlen_p = 0U;
+    }
+    if (mlen > crypto_secretstream_aegis256_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    if (crypto_aead_aegis256_init(&aegis_state, state->nonce, state->k) != 0) {
+        return -1;
+    }
+    crypto_aead_aegis256_update_ad(&aegis_state, ad, adlen);
+    crypto_aead_aegis256_encrypt_update(&aegis_state, out, &tag, 1U);
+    crypto_aead_aegis256_encrypt_update(&aegis_state, out + 1U, m, mlen);
+    mac = out + 1U + mlen;
+    crypto_aead_aegis256_encrypt_final(&aegis_state, mac);
+
+    _crypto_secretstream_aegis256_ratchet(state, mac, tag);
+    if (outlen_p != NULL) {
+        *outlen_p = crypto_secretstream_aegis256_ABYTES + mlen;
+    }
+    return 0;
+}
+
+int
+crypto_secretstream_aegis256_pull
+   (crypto_secretstream_aegis256_state *state,
+    unsigned char *m, unsigned long long *mlen_p, unsigned char *tag_p,
+    const unsigned char *in, unsigned long long inlen,
+    const unsigned char *ad, unsigned long long adlen)
+{
+    crypto_aead_aegis256_state aegis_state;
+    unsigned char              mac[crypto_aead_aegis256_ABYTES];
+    unsigned long long         mlen;
+    unsigned char              tag;
+
+    if (mlen_p != NULL) {
+        *mlen_p = 0U;
+    }
+    if (tag_p != NULL) {
+        *tag_p = 0xff;
+    }
+    if (inlen < crypto_secretstream_aegis256_ABYTES) {
+        return -1;
+    }
+    mlen = inlen - crypto_secretstream_aegis256_ABYTES;
+    if (mlen > crypto_secretstream_aegis256_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    if (crypto_aead_aegis256_init(&aegis_state, state->nonce, state->k) != 0) {
+        return -1;
+    }
+    /* the tag may be overwritten if decrypting in place */
+    memcpy(mac, in + 1U + mlen, sizeof mac);
+    crypto_aead_aegis256_update_ad(&aegis_state, ad, adlen);
+    crypto_aead_aegis256_decrypt_update(&aegis_state, &tag, in, 1U);
+    crypto_aead_aegis256_decrypt_update(&aegis_state, m, in + 1U, mlen);
+    if (crypto_aead_aegis256_decrypt_final(&aegis_state, mac) != 0) {
+        if (m != NULL) {
+            memset(m, 0, mlen);
+        }
+        sodium_memzero(&tag, sizeof tag);
+        return -1;
+    }
+    _crypto_secretstream_aegis256_ratchet(state, mac, tag);
+    if (mlen_p != NULL) {
+        *mlen_p = mlen;
+    }
+    if (tag_p != NULL) {
+        *tag_p = tag;
+    }
+    return 0;
+}
+
+size_t
+crypto_secretstream_aegis256_statebytes(void)
+{
+    return sizeof(crypto_secretstream_aegis256_state);
+}
+
+size_t
+crypto_secretstream_aegis256_abytes(void)
+{
+    return crypto_secretstream_aegis256_ABYTES;
+}
+
+size_t
+crypto_secretstream_aegis256_headerbytes(void)
+{
+    return crypto_secretstream_aegis256_HEADERBYTES;
+}
+
+size_t
+crypto_secretstream_aegis256_keybytes(void)
+{
+    return crypto_secretstream_aegis256_KEYBYTES;
+}
+
+size_t
+crypto_secretstream_aegis256_messagebytes_max(void)
+{
+    return crypto_secretstream_aegis256_MESSAGEBYTES_MAX;
+}
+
+unsigned char
+crypto_secretstream_aegis256_tag_message(void)
+{
+    return crypto_secretstream_aegis256_TAG_MESSAGE;
+}
+
+unsigned char
+crypto_secretstream_aegis256_tag_push(void)
+{
+    return crypto_secretstream_aegis256_TAG_PUSH;
+}
+
+unsigned char
+crypto_secretstream_aegis256_tag_rekey(void)
+{
+    return crypto_secretstream_aegis256_TAG_REKEY;
+}
+
+unsigned char
+crypto_secretstream_aegis256_tag_final(void)
+{
+    return crypto_secretstream_aegis256_TAG_FINAL;
+}
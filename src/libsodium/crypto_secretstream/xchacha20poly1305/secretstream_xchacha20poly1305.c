@@ -1,3 +1,4 @@
+#include <errno.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -21,8 +22,80 @@
 #define STATE_INONCE(STATE)  ((STATE)->nonce + \
                               crypto_secretstream_xchacha20poly1305_COUNTERBYTES)
 
+#define ENCRYPT_AND_MAC_CHUNK_BYTES 16384U
+#define SEAL_FUSED_MAX_BYTES        512U
+
 static const unsigned char _pad0[16] = { 0 };
 
+/* HChaCha20 constant for seekable streams, to keep their subkeys separate */
+static const unsigned char _seekable_c[16] = {
+    's', 'e', 'e', 'k', 'a', 'b', 'l', 'e', ' ', 's', 't', 'r', 'e', 'a', 'm', ' '
+};
+
+/*
+ * Encrypt and authenticate in cache-sized chunks, so that Poly1305 reads
+ * each chunk of ciphertext while it is still in L1.
+ * Messages that would need the 32-bit block counter to wrap are left to a
+ * single call, so that overflow is still detected there.
+ */
+
+static void
+_encrypt_and_mac(crypto_onetimeauth_poly1305_state *state,
+                 unsigned char *c, const unsigned char *m,
+                 unsigned long long mlen, const unsigned char *n,
+                 uint32_t ic, const unsigned char *k)
+{
+    unsigned long long chunk_len;
+
+    COMPILER_ASSERT(ENCRYPT_AND_MAC_CHUNK_BYTES % 64U == 0U);
+    while (mlen > 0U) {
+        chunk_len = mlen;
+        if (chunk_len > ENCRYPT_AND_MAC_CHUNK_BYTES &&
+            ic <= UINT32_MAX - ENCRYPT_AND_MAC_CHUNK_BYTES / 64U) {
+            chunk_len = ENCRYPT_AND_MAC_CHUNK_BYTES;
+        }
+        crypto_stream_chacha20_ietf_xor_ic(c, m, chunk_len, n, ic, k);
+        crypto_onetimeauth_poly1305_update(state, c, chunk_len);
+        ic += (uint32_t) (ENCRYPT_AND_MAC_CHUNK_BYTES / 64U);
+        c += chunk_len;
+        m += chunk_len;
+        mlen -= chunk_len;
+    }
+}
+
+/*
+ * For short messages, the Poly1305 key, the tag block and the message are
+ * encrypted with a single keystream call, so that the blocks can be
+ * computed in parallel instead of one or two at a time.
+ */
+
+static void
+_seal_fused(crypto_onetimeauth_poly1305_state *state,
+            unsigned char *c, unsigned char *enc_tag,
+            const unsigned char *m, unsigned long long mlen,
+            const unsigned char *ad, unsigned long long adlen,
+            unsigned char tag, const unsigned char *nonce,
+            const unsigned char *k)
+{
+    unsigned char buf[128U + SEAL_FUSED_MAX_BYTES];
+
+    memset(buf, 0, 128U);
+    buf[64U] = tag;
+    if (mlen > 0U) {
+        memcpy(buf + 128U, m, (size_t) mlen);
+    }
+    crypto_stream_chacha20_ietf_xor_ic(buf, buf, 128U + mlen, nonce, 0U, k);
+    crypto_onetimeauth_poly1305_init(state, buf);
+    crypto_onetimeauth_poly1305_update(state, ad, adlen);
+    crypto_onetimeauth_poly1305_update(state, _pad0, (0x10 - adlen) & 0xf);
+    crypto_onetimeauth_poly1305_update(state, buf + 64U, 64U + mlen);
+    *enc_tag = buf[64U];
+    if (mlen > 0U) {
+        memcpy(c, buf + 128U, (size_t) mlen);
+    }
+    sodium_memzero(buf, 64U);
+}
+
 static inline void
 _crypto_secretstream_xchacha20poly1305_counter_reset
     (crypto_secretstream_xchacha20poly1305_state *state)
@@ -107,44 +180,80 @@ crypto_secretstream_xchacha20poly1305_rekey
     _crypto_secretstream_xchacha20poly1305_counter_reset(state);
 }
 
-int
-crypto_secretstream_xchacha20poly1305_push
-   (crypto_secretstream_xchacha20poly1305_state *state,
-    unsigned char *out, unsigned long long *outlen_p,
-    const unsigned char *m, unsigned long long mlen,
-    const unsigned char *ad, unsigned long long adlen, unsigned char tag)
+static void
+_crypto_secretstream_xchacha20poly1305_seal
+    (unsigned char *c, unsigned char *enc_tag, unsigned char *mac,
+     const unsigned char *m, unsigned long long mlen,
+     const unsigned char *ad, unsigned long long adlen, unsigned char tag,
+     const unsigned char *nonce, const unsigned char *k)
 {
     crypto_onetimeauth_poly1305_state poly1305_state;
     unsigned char                     block[64U];
     unsigned char                     slen[8U];
-    unsigned char                    *c;
-    unsigned char                    *mac;
 
-    if (outlen_p != NULL) {
-        *outlen_p = 0U;
-    }
-    COMPILER_ASSERT(crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX
-                    <= crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX);
-    if (mlen > crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX) {
-        sodium_misuse();
+    if (mlen <= SEAL_FUSED_MAX_BYTES) {
+        _seal_fused(&poly1305_state, c, enc_tag, m, mlen, ad, adlen, tag,
+                    nonce, k);
+    } else {
+        crypto_stream_chacha20_ietf(block, sizeof block, nonce, k);
+        crypto_onetimeauth_poly1305_init(&poly1305_state, block);
+        sodium_memzero(block, sizeof block);
+
+        crypto_onetimeauth_poly1305_update(&poly1305_state, ad, adlen);
+        crypto_onetimeauth_poly1305_update(&poly1305_state, _pad0,
+                                           (0x10 - adlen) & 0xf);
+        memset(block, 0, sizeof block);
+        block[0] = tag;
+
+        crypto_stream_chacha20_ietf_xor_ic(block, block, sizeof block,
+                                           nonce, 1U, k);
+        crypto_onetimeauth_poly1305_update(&poly1305_state, block,
+                                           sizeof block);
+        *enc_tag = block[0];
+
+        _encrypt_and_mac(&poly1305_state, c, m, mlen, nonce, 2U, k);
     }
-    crypto_stream_chacha20_ietf(block, sizeof block, state->nonce, state->k);
+    crypto_onetimeauth_poly1305_update
+        (&poly1305_state, _pad0, (0x10 - (sizeof block) + mlen) & 0xf);
+    /* should have been (0x10 - (sizeof block + mlen)) & 0xf to keep input blocks aligned */
+
+    STORE64_LE(slen, (uint64_t) adlen);
+    crypto_onetimeauth_poly1305_update(&poly1305_state, slen, sizeof slen);
+    STORE64_LE(slen, (sizeof block) + mlen);
+    crypto_onetimeauth_poly1305_update(&poly1305_state, slen, sizeof slen);
+
+    crypto_onetimeauth_poly1305_final(&poly1305_state, mac);
+    sodium_memzero(&poly1305_state, sizeof poly1305_state);
+}
+
+static int
+_crypto_secretstream_xchacha20poly1305_open
+    (unsigned char *m, unsigned char *tag_p,
+     unsigned char mac[crypto_onetimeauth_poly1305_BYTES],
+     const unsigned char *c, unsigned long long mlen,
+     const unsigned char *enc_tag, const unsigned char *stored_mac,
+     const unsigned char *ad, unsigned long long adlen,
+     const unsigned char *nonce, const unsigned char *k)
+{
+    crypto_onetimeauth_poly1305_state poly1305_state;
+    unsigned char                     block[64U];
+    unsigned char                     slen[8U];
+
+    crypto_stream_chacha20_ietf(block, sizeof block, nonce, k);
     crypto_onetimeauth_poly1305_init(&poly1305_state, block);
     sodium_memzero(block, sizeof block);
 
     crypto_onetimeauth_poly1305_update(&poly1305_state, ad, adlen);
     crypto_onetimeauth_poly1305_update(&poly1305_state, _pad0,
                                        (0x10 - adlen) & 0xf);
-    memset(block, 0, sizeof block);
-    block[0] = tag;
 
-    crypto_stream_chacha20_ietf_xor_ic(block, block, sizeof block,
-                                       state->nonce, 1U, state->k);
+    memset(block, 0, sizeof block);
+    block[0] = *enc_tag;
+    crypto_stream_chacha20_ietf_xor_ic(block, block, sizeof block, nonce, 1U, k);
+    *tag_p = block[0];
+    block[0] = *enc_tag;
     crypto_onetimeauth_poly1305_update(&poly1305_state, block, sizeof block);
-    out[0] = block[0];
 
-    c = out + (sizeof tag);
-    crypto_stream_chacha20_ietf_xor_ic(c, m, mlen, state->nonce, 2U, state->k);
     crypto_onetimeauth_poly1305_update(&poly1305_state, c, mlen);
     crypto_onetimeauth_poly1305_update
         (&poly1305_state, _pad0, (0x10 - (sizeof block) + mlen) & 0xf);
@@ -155,10 +264,35 @@ crypto_secretstream_xchacha20poly1305_push
     STORE64_LE(slen, (sizeof block) + mlen);
     crypto_onetimeauth_poly1305_update(&poly1305_state, slen, sizeof slen);
 
-    mac = c + mlen;
     crypto_onetimeauth_poly1305_final(&poly1305_state, mac);
     sodium_memzero(&poly1305_state, sizeof poly1305_state);
 
+    if (sodium_memcmp(mac, stored_mac, crypto_onetimeauth_poly1305_BYTES) != 0) {
+        sodium_memzero(mac, crypto_onetimeauth_poly1305_BYTES);
+        return -1;
+    }
+
+    crypto_stream_chacha20_ietf_xor_ic(m, c, mlen, nonce, 2U, k);
+
+    return 0;
+}
+
+int
+crypto_secretstream_xchacha20poly1305_push_detached
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *c, unsigned char *enc_tag, unsigned char *mac,
+    const unsigned char *m, unsigned long long mlen,
+    const unsigned char *ad, unsigned long long adlen, unsigned char tag)
+{
+    COMPILER_ASSERT(crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX
+                    <= crypto_aead_chacha20poly1305_ietf_MESSAGEBYTES_MAX);
+    if (mlen > crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    _crypto_secretstream_xchacha20poly1305_seal(c, enc_tag, mac, m, mlen,
+                                                ad, adlen, tag,
+                                                state->nonce, state->k);
+
     COMPILER_ASSERT(crypto_onetimeauth_poly1305_BYTES >=
                     crypto_secretstream_xchacha20poly1305_INONCEBYTES);
     XOR_BUF(STATE_INONCE(state), mac,
@@ -170,12 +304,92 @@ crypto_secretstream_xchacha20poly1305_push
                        crypto_secretstream_xchacha20poly1305_COUNTERBYTES)) {
         crypto_secretstream_xchacha20poly1305_rekey(state);
     }
+    return 0;
+}
+
+int
+crypto_secretstream_xchacha20poly1305_push
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *out, unsigned long long *outlen_p,
+    const unsigned char *m, unsigned long long mlen,
+    const unsigned char *ad, unsigned long long adlen, unsigned char tag)
+{
+    if (outlen_p != NULL) {
+        *outlen_p = 0U;
+    }
+    crypto_secretstream_xchacha20poly1305_push_detached
+        (state, out + (sizeof tag), out, out + (sizeof tag) + mlen,
+         m, mlen, ad, adlen, tag);
     if (outlen_p != NULL) {
         *outlen_p = crypto_secretstream_xchacha20poly1305_ABYTES + mlen;
     }
     return 0;
 }
 
+int
+crypto_secretstream_xchacha20poly1305_push_many
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *out, unsigned long long *outlen_p,
+    const unsigned char * const *m, const unsigned long long *mlen,
+    const unsigned char *tags, size_t n)
+{
+    unsigned long long outlen = 0U;
+    size_t             i;
+
+    if (outlen_p != NULL) {
+        *outlen_p = 0U;
+    }
+    for (i = 0U; i < n; i++) {
+        crypto_secretstream_xchacha20poly1305_push_detached
+            (state, out + 1U, out, out + 1U + mlen[i], m[i], mlen[i],
+             NULL, 0U, tags[i]);
+        out += crypto_secretstream_xchacha20poly1305_ABYTES + mlen[i];
+        outlen += crypto_secretstream_xchacha20poly1305_ABYTES + mlen[i];
+    }
+    if (outlen_p != NULL) {
+        *outlen_p = outlen;
+    }
+    return 0;
+}
+
+int
+crypto_secretstream_xchacha20poly1305_pull_detached
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *m, unsigned char *tag_p,
+    const unsigned char *c, unsigned long long clen,
+    const unsigned char *enc_tag, const unsigned char *mac,
+    const unsigned char *ad, unsigned long long adlen)
+{
+    unsigned char computed_mac[crypto_onetimeauth_poly1305_BYTES];
+    unsigned char tag;
+
+    if (tag_p != NULL) {
+        *tag_p = 0xff;
+    }
+    if (clen > crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    if (_crypto_secretstream_xchacha20poly1305_open(m, &tag, computed_mac,
+                                                    c, clen, enc_tag, mac,
+                                                    ad, adlen, state->nonce,
+                                                    state->k) != 0) {
+        return -1;
+    }
+    XOR_BUF(STATE_INONCE(state), computed_mac,
+            crypto_secretstream_xchacha20poly1305_INONCEBYTES);
+    sodium_increment(STATE_COUNTER(state),
+                     crypto_secretstream_xchacha20poly1305_COUNTERBYTES);
+    if ((tag & crypto_secretstream_xchacha20poly1305_TAG_REKEY) != 0 ||
+        sodium_is_zero(STATE_COUNTER(state),
+                       crypto_secretstream_xchacha20poly1305_COUNTERBYTES)) {
+        crypto_secretstream_xchacha20poly1305_rekey(state);
+    }
+    if (tag_p != NULL) {
+        *tag_p = tag;
+    }
+    return 0;
+}
+
 int
 crypto_secretstream_xchacha20poly1305_pull
    (crypto_secretstream_xchacha20poly1305_state *state,
@@ -183,14 +397,7 @@ crypto_secretstream_xchacha20poly1305_pull
     const unsigned char *in, unsigned long long inlen,
     const unsigned char *ad, unsigned long long adlen)
 {
-    crypto_onetimeauth_poly1305_state poly1305_state;
-    unsigned char                     block[64U];
-    unsigned char                     slen[8U];
-    unsigned char                     mac[crypto_onetimeauth_poly1305_BYTES];
-    const unsigned char              *c;
-    const unsigned char              *stored_mac;
-    unsigned long long                mlen;
-    unsigned char                     tag;
+    unsigned long long mlen;
 
     if (mlen_p != NULL) {
         *mlen_p = 0U;
@@ -202,54 +409,121 @@ crypto_secretstream_xchacha20poly1305_pull
         return -1;
     }
     mlen = inlen - crypto_secretstream_xchacha20poly1305_ABYTES;
-    if (mlen > crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX) {
-        sodium_misuse();
+    if (crypto_secretstream_xchacha20poly1305_pull_detached
+        (state, m, tag_p, in + 1U, mlen, in, in + 1U + mlen, ad, adlen) != 0) {
+        return -1;
     }
-    crypto_stream_chacha20_ietf(block, sizeof block, state->nonce, state->k);
-    crypto_onetimeauth_poly1305_init(&poly1305_state, block);
-    sodium_memzero(block, sizeof block);
+    if (mlen_p != NULL) {
+        *mlen_p = mlen;
+    }
+    return 0;
+}
 
-    crypto_onetimeauth_poly1305_update(&poly1305_state, ad, adlen);
-    crypto_onetimeauth_poly1305_update(&poly1305_state, _pad0,
-                                       (0x10 - adlen) & 0xf);
+static void
+_crypto_secretstream_xchacha20poly1305_init_seekable
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    const unsigned char in[crypto_secretstream_xchacha20poly1305_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES])
+{
+    crypto_core_hchacha20(state->k, in, k, _seekable_c);
+    memset(STATE_COUNTER(state), 0,
+           crypto_secretstream_xchacha20poly1305_COUNTERBYTES);
+    memcpy(STATE_INONCE(state), in + crypto_core_hchacha20_INPUTBYTES,
+           crypto_secretstream_xchacha20poly1305_INONCEBYTES);
+    memset(state->_pad, 0, sizeof state->_pad);
+}
 
-    memset(block, 0, sizeof block);
-    block[0] = in[0];
-    crypto_stream_chacha20_ietf_xor_ic(block, block, sizeof block,
-                                       state->nonce, 1U, state->k);
-    tag = block[0];
-    block[0] = in[0];
-    crypto_onetimeauth_poly1305_update(&poly1305_state, block, sizeof block);
+int
+crypto_secretstream_xchacha20poly1305_init_push_seekable
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char out[crypto_secretstream_xchacha20poly1305_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES])
+{
+    randombytes_buf(out, crypto_secretstream_xchacha20poly1305_HEADERBYTES);
+    _crypto_secretstream_xchacha20poly1305_init_seekable(state, out, k);
 
-    c = in + (sizeof tag);
-    crypto_onetimeauth_poly1305_update(&poly1305_state, c, mlen);
-    crypto_onetimeauth_poly1305_update
-        (&poly1305_state, _pad0, (0x10 - (sizeof block) + mlen) & 0xf);
-    /* should have been (0x10 - (sizeof block + mlen)) & 0xf to keep input blocks aligned */
+    return 0;
+}
 
-    STORE64_LE(slen, (uint64_t) adlen);
-    crypto_onetimeauth_poly1305_update(&poly1305_state, slen, sizeof slen);
-    STORE64_LE(slen, (sizeof block) + mlen);
-    crypto_onetimeauth_poly1305_update(&poly1305_state, slen, sizeof slen);
+int
+crypto_secretstream_xchacha20poly1305_init_pull_seekable
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    const unsigned char in[crypto_secretstream_xchacha20poly1305_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES])
+{
+    _crypto_secretstream_xchacha20poly1305_init_seekable(state, in, k);
 
-    crypto_onetimeauth_poly1305_final(&poly1305_state, mac);
-    sodium_memzero(&poly1305_state, sizeof poly1305_state);
+    return 0;
+}
+
+int
+crypto_secretstream_xchacha20poly1305_push_at
+   (const crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *out, unsigned long long *outlen_p,
+    const unsigned char *m, unsigned long long mlen,
+    const unsigned char *ad, unsigned long long adlen,
+    uint64_t index, unsigned char tag)
+{
+    unsigned char nonce[crypto_stream_chacha20_ietf_NONCEBYTES];
 
-    stored_mac = c + mlen;
-    if (sodium_memcmp(mac, stored_mac, sizeof mac) != 0) {
-        sodium_memzero(mac, sizeof mac);
+    if (outlen_p != NULL) {
+        *outlen_p = 0U;
+    }
+    if (index > crypto_secretstream_xchacha20poly1305_INDEX_MAX) {
+        errno = EINVAL;
         return -1;
     }
+    if (mlen > crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    COMPILER_ASSERT(crypto_secretstream_xchacha20poly1305_COUNTERBYTES == 4U);
+    memcpy(nonce, state->nonce, sizeof nonce);
+    STORE32_LE(nonce, (uint32_t) index);
+    _crypto_secretstream_xchacha20poly1305_seal(out + 1U, out, out + 1U + mlen,
+                                                m, mlen, ad, adlen, tag,
+                                                nonce, state->k);
+    if (outlen_p != NULL) {
+        *outlen_p = crypto_secretstream_xchacha20poly1305_ABYTES + mlen;
+    }
+    return 0;
+}
 
-    crypto_stream_chacha20_ietf_xor_ic(m, c, mlen, state->nonce, 2U, state->k);
-    XOR_BUF(STATE_INONCE(state), mac,
-            crypto_secretstream_xchacha20poly1305_INONCEBYTES);
-    sodium_increment(STATE_COUNTER(state),
-                     crypto_secretstream_xchacha20poly1305_COUNTERBYTES);
-    if ((tag & crypto_secretstream_xchacha20poly1305_TAG_REKEY) != 0 ||
-        sodium_is_zero(STATE_COUNTER(state),
-                       crypto_secretstream_xchacha20poly1305_COUNTERBYTES)) {
-        crypto_secretstream_xchacha20poly1305_rekey(state);
+int
+crypto_secretstream_xchacha20poly1305_pull_at
+   (const crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *m, unsigned long long *mlen_p, unsigned char *tag_p,
+    const unsigned char *in, unsigned long long inlen,
+    const unsigned char *ad, unsigned long long adlen, uint64_t index)
+{
+    unsigned char      nonce[crypto_stream_chacha20_ietf_NONCEBYTES];
+    unsigned char      mac[crypto_onetimeauth_poly1305_BYTES];
+    unsigned long long mlen;
+    unsigned char      tag;
+
+    if (mlen_p != NULL) {
+        *mlen_p = 0U;
+    }
+    if (tag_p != NULL) {
+        *tag_p = 0xff;
+    }
+    if (index > crypto_secretstream_xchacha20poly1305_INDEX_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (inlen < crypto_secretstream_xchacha20poly1305_ABYTES) {
+        return -1;
+    }
+    mlen = inlen - crypto_secretstream_xchacha20poly1305_ABYTES;
+    if (mlen > crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    memcpy(nonce, state->nonce, sizeof nonce);
+    STORE32_LE(nonce, (uint32_t) index);
+    if (_crypto_secretstream_xchacha20poly1305_open(m, &tag, mac, in + 1U, mlen,
+                                                    in, in + 1U + mlen,
+                                                    ad, adlen, nonce,
+                                                    state->k) != 0) {
+        return -1;
     }
     if (mlen_p != NULL) {
         *mlen_p = mlen;
@@ -284,6 +558,12 @@ crypto_secretstream_xchacha20poly1305_keybytes(void)
     return crypto_secretstream_xchacha20poly1305_KEYBYTES;
 }
 
+size_t
+crypto_secretstream_xchacha20poly1305_macbytes(void)
+{
+    return crypto_secretstream_xchacha20poly1305_MACBYTES;
+}
+
 size_t
 crypto_secretstream_xchacha20poly1305_messagebytes_max(void)
 {
@@ -313,3 +593,9 @@ crypto_secretstream_xchacha20poly1305_tag_final(void)
 {
     return crypto_secretstream_xchacha20poly1305_TAG_FINAL;
 }
+
+uint64_t
+crypto_secretstream_xchacha20poly1305_index_max(void)
+{
+    return crypto_secretstream_xchacha20poly1305_INDEX_MAX;
+}
@@ -0,0 +1,66 @@
+#include "crypto_shorthash_siphash24.h"
+#include "private/common.h"
+#include "shorthash_siphash_ref.h"
+
+uint32_t
+crypto_shorthash_halfsiphash24_value(const unsigned char *in,
+                                     unsigned long long inlen,
+                                     const unsigned char *k)
+{
+    uint32_t       v0 = 0U;
+    uint32_t       v1 = 0U;
+    uint32_t       v2 = 0x6c796765U;
+    uint32_t       v3 = 0x74656462U;
+    uint32_t       b;
+    uint32_t       k0 = LOAD32_LE(k);
+    uint32_t       k1 = LOAD32_LE(k + 4);
+    uint32_t       m;
+    const uint8_t *end  = in + inlen - (inlen % sizeof(uint32_t));
+    const int      left = inlen & 3;
+
+    b = ((uint32_t) inlen) << 24;
+    v3 ^= k1;
+    v2 ^= k0;
+    v1 ^= k1;
+    v0 ^= k0;
+    for (; in != end; in += 4) {
+        m = LOAD32_LE(in);
+        v3 ^= m;
+        HALFSIPROUND;
+        HALFSIPROUND;
+        v0 ^= m;
+    }
+    switch (left) {
+    case 3:
+        b |= ((uint32_t) in[2]) << 16;
+        /* FALLTHRU */
+    case 2:
+        b |= ((uint32_t) in[1]) << 8;
+        /* FALLTHRU */
+    case 1:
+        b |= ((uint32_t) in[0]);
+        break;
+    case 0:
+        break;
+    }
+    v3 ^= b;
+    HALFSIPROUND;
+    HALFSIPROUND;
+    v0 ^= b;
+    v2 ^= 0xff;
+    HALFSIPROUND;
+    HALFSIPROUND;
+    HALFSIPROUND;
+    HALFSIPROUND;
+
+    return v1 ^ v3;
+}
+
+int
+crypto_shorthash_halfsiphash24(unsigned char *out, const unsigned char *in,
+                               unsigned long long inlen, const unsigned char *k)
+{
+    STORE32_LE(out, crypto_shorthash_halfsiphash24_value(in, inlen, k));
+
+    return 0;
+}
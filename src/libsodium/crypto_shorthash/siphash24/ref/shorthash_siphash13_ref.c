@@ -0,0 +1,140 @@
+#include "crypto_shorthash_siphash24.h"
+#include "private/common.h"
+#include "private/implementations.h"
+#include "runtime.h"
+#include "shorthash_siphash_ref.h"
+
+static siphash24_multi_fn siphash13_multi = NULL;
+static size_t             siphash13_multi_lanes = 0U;
+
+uint64_t
+crypto_shorthash_siphash13_value(const unsigned char *in,
+                                 unsigned long long inlen,
+                                 const unsigned char *k)
+{
+    /* "somepseudorandomlygeneratedbytes" */
+    uint64_t       v0 = 0x736f6d6570736575ULL;
+    uint64_t       v1 = 0x646f72616e646f6dULL;
+    uint64_t       v2 = 0x6c7967656e657261ULL;
+    uint64_t       v3 = 0x7465646279746573ULL;
+    uint64_t       b;
+    uint64_t       k0 = LOAD64_LE(k);
+    uint64_t       k1 = LOAD64_LE(k + 8);
+    uint64_t       m;
+    const uint8_t *end  = in + inlen - (inlen % sizeof(uint64_t));
+    const int      left = inlen & 7;
+
+    b = ((uint64_t) inlen) << 56;
+    v3 ^= k1;
+    v2 ^= k0;
+    v1 ^= k1;
+    v0 ^= k0;
+    for (; in != end; in += 8) {
+        m = LOAD64_LE(in);
+        v3 ^= m;
+        SIPROUND;
+        v0 ^= m;
+    }
+    switch (left) {
+    case 7:
+        b |= ((uint64_t) in[6]) << 48;
+        /* FALLTHRU */
+    case 6:
+        b |= ((uint64_t) in[5]) << 40;
+        /* FALLTHRU */
+    case 5:
+        b |= ((uint64_t) in[4]) << 32;
+        /* FALLTHRU */
+    case 4:
+        b |= ((uint64_t) in[3]) << 24;
+        /* FALLTHRU */
+    case 3:
+        b |= ((uint64_t) in[2]) << 16;
+        /* FALLTHRU */
+    case 2:
+        b |= ((uint64_t) in[1]) << 8;
+        /* FALLTHRU */
+    case 1:
+        b |= ((uint64_t) in[0]);
+        break;
+    case 0:
+        break;
+    }
+    v3 ^= b;
+    SIPROUND;
+    v0 ^= b;
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+int
+crypto_shorthash_siphash13(unsigned char *out, const unsigned char *in,
+                           unsigned long long inlen, const unsigned char *k)
+{
+    STORE64_LE(out, crypto_shorthash_siphash13_value(in, inlen, k));
+
+    return 0;
+}
+
+int
+crypto_shorthash_siphash13_multi(unsigned char *out,
+                                 const unsigned char * const *in,
+                                 const unsigned long long *inlen, size_t count,
+                                 const unsigned char *k)
+{
+    size_t i;
+    size_t n;
+
+    if (siphash13_multi == NULL || count < 2U) {
+        for (i = 0U; i < count; i++) {
+            crypto_shorthash_siphash13(out + i * crypto_shorthash_siphash13_BYTES,
+                                       in[i], inlen[i], k);
+        }
+        return 0;
+    }
+    for (i = 0U; i < count; i += n) {
+        n = count - i;
+        if (n > siphash13_multi_lanes) {
+            n = siphash13_multi_lanes;
+        }
+        siphash13_multi(out + i * crypto_shorthash_siphash13_BYTES,
+                        in + i, inlen + i, n, k);
+    }
+    return 0;
+}
+
+int
+_crypto_shorthash_siphash13_pick_best_implementation(void)
+{
+    siphash13_multi       = NULL;
+    siphash13_multi_lanes = 0U;
+#if defined(HAVE_ARMNEON)
+    if (sodium_runtime_has_neon()) {
+        siphash13_multi       = _crypto_shorthash_siphash13_multi_neon;
+        siphash13_multi_lanes = 4U;
+        return 0;
+    }
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors()) {
+        siphash13_multi       = _crypto_shorthash_siphash13_multi_avx512f;
+        siphash13_multi_lanes = 8U;
+        return 0;
+    }
+#endif
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2()) {
+        siphash13_multi       = _crypto_shorthash_siphash13_multi_avx2;
+        siphash13_multi_lanes = 4U;
+        return 0;
+    }
+#endif
+    return 0;
+}
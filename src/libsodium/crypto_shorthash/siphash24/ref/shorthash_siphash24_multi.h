@@ -0,0 +1,138 @@
+/*
+ * Multi-buffer SipHash-2-4: LANES messages are hashed under the same key,
+ * one per 64-bit lane. Lanes whose message is fully absorbed keep their
+ * state unchanged until the longest one is done, then all lanes are
+ * finalized together. The includer defines LANES, the vector type VEC,
+ * the LOADV, STOREV, SET1, ADD, XOR, ROTL, SWAP32 and SELECT operations,
+ * as well as FN(). CROUNDS and DROUNDS default to SipHash-2-4.
+ */
+
+#ifndef CROUNDS
+# define CROUNDS 2
+#endif
+#ifndef DROUNDS
+# define DROUNDS 4
+#endif
+
+#define SIPROUND_V                 \
+    do {                           \
+        v0 = ADD(v0, v1);          \
+        v1 = ROTL(v1, 13);         \
+        v1 = XOR(v1, v0);          \
+        v0 = SWAP32(v0);           \
+        v2 = ADD(v2, v3);          \
+        v3 = ROTL(v3, 16);         \
+        v3 = XOR(v3, v2);          \
+        v0 = ADD(v0, v3);          \
+        v3 = ROTL(v3, 21);         \
+        v3 = XOR(v3, v0);          \
+        v2 = ADD(v2, v1);          \
+        v1 = ROTL(v1, 17);         \
+        v1 = XOR(v1, v2);          \
+        v2 = SWAP32(v2);           \
+    } while (0)
+
+int
+FN(multi)(unsigned char *out, const unsigned char * const *in,
+          const unsigned long long *inlen, size_t n, const unsigned char *k)
+{
+    CRYPTO_ALIGN(64) uint64_t m[LANES];
+    CRYPTO_ALIGN(64) uint64_t active[LANES];
+    CRYPTO_ALIGN(64) uint64_t h[LANES];
+    uint64_t                  b[LANES];
+    unsigned long long        blocks[LANES];
+    unsigned long long        min_blocks = (unsigned long long) -1;
+    unsigned long long        max_blocks = 0U;
+    unsigned long long        j;
+    const unsigned char      *p[LANES];
+    VEC                       v0, v1, v2, v3;
+    VEC                       o0, o1, o2, o3;
+    VEC                       vm, va;
+    uint64_t                  k0 = LOAD64_LE(k);
+    uint64_t                  k1 = LOAD64_LE(k + 8);
+    size_t                    l;
+    int                       left;
+    int                       i;
+    int                       r;
+
+    for (l = 0U; l < LANES; l++) {
+        if (l < n) {
+            p[l]      = in[l];
+            blocks[l] = inlen[l] / 8U;
+            left      = (int) (inlen[l] & 7U);
+            b[l]      = ((uint64_t) inlen[l]) << 56;
+        } else {
+            p[l]      = NULL;
+            blocks[l] = 0U;
+            left      = 0;
+            b[l]      = 0U;
+        }
+        for (i = 0; i < left; i++) {
+            b[l] |= ((uint64_t) p[l][blocks[l] * 8U + i]) << (8 * i);
+        }
+        if (blocks[l] < min_blocks) {
+            min_blocks = blocks[l];
+        }
+        if (blocks[l] > max_blocks) {
+            max_blocks = blocks[l];
+        }
+    }
+    /* "somepseudorandomlygeneratedbytes" */
+    v0 = SET1(0x736f6d6570736575ULL ^ k0);
+    v1 = SET1(0x646f72616e646f6dULL ^ k1);
+    v2 = SET1(0x6c7967656e657261ULL ^ k0);
+    v3 = SET1(0x7465646279746573ULL ^ k1);
+    for (j = 0U; j < min_blocks; j++) {
+        for (l = 0U; l < LANES; l++) {
+            m[l] = LOAD64_LE(p[l] + j * 8U);
+        }
+        vm = LOADV(m);
+        v3 = XOR(v3, vm);
+        for (r = 0; r < CROUNDS; r++) {
+            SIPROUND_V;
+        }
+        v0 = XOR(v0, vm);
+    }
+    for (; j <= max_blocks; j++) {
+        for (l = 0U; l < LANES; l++) {
+            if (j < blocks[l]) {
+                m[l]      = LOAD64_LE(p[l] + j * 8U);
+                active[l] = (uint64_t) -1;
+            } else if (j == blocks[l]) {
+                m[l]      = b[l];
+                active[l] = (uint64_t) -1;
+            } else {
+                m[l]      = 0U;
+                active[l] = 0U;
+            }
+        }
+        vm = LOADV(m);
+        va = LOADV(active);
+        o0 = v0;
+        o1 = v1;
+        o2 = v2;
+        o3 = v3;
+        v3 = XOR(v3, vm);
+        for (r = 0; r < CROUNDS; r++) {
+            SIPROUND_V;
+        }
+        v0 = XOR(v0, vm);
+        v0 = SELECT(va, v0, o0);
+        v1 = SELECT(va, v1, o1);
+        v2 = SELECT(va, v2, o2);
+        v3 = SELECT(va, v3, o3);
+    }
+    v2 = XOR(v2, SET1(0xff));
+    for (r = 0; r < DROUNDS; r++) {
+        SIPROUND_V;
+    }
+    STOREV(h, XOR(XOR(v0, v1), XOR(v2, v3)));
+    for (l = 0U; l < n; l++) {
+        STORE64_LE(out + l * 8U, h[l]);
+    }
+    return 0;
+}
+
+#undef SIPROUND_V
+#undef CROUNDS
+#undef DROUNDS
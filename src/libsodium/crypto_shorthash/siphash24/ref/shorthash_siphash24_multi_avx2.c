@@ -0,0 +1,44 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "shorthash_siphash_ref.h"
+
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# define LANES 4U
+# define VEC   __m256i
+
+# define LOADV(p)     _mm256_load_si256((const __m256i *) (const void *) (p))
+# define STOREV(p, r) _mm256_store_si256((__m256i *) (void *) (p), r)
+# define SET1(x)      _mm256_set1_epi64x((long long) (x))
+# define ADD(a, b)    _mm256_add_epi64(a, b)
+# define XOR(a, b)    _mm256_xor_si256(a, b)
+# define ROTL(x, b) \
+    _mm256_or_si256(_mm256_slli_epi64((x), (b)), _mm256_srli_epi64((x), 64 - (b)))
+# define SWAP32(x) _mm256_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+# define SELECT(mask, a, b) _mm256_blendv_epi8((b), (a), (mask))
+
+# define FN(name) _crypto_shorthash_siphash24_##name##_avx2
+# include "shorthash_siphash24_multi.h"
+# undef FN
+
+# define CROUNDS 1
+# define DROUNDS 3
+# define FN(name) _crypto_shorthash_siphash13_##name##_avx2
+# include "shorthash_siphash24_multi.h"
+
+#endif
@@ -0,0 +1,46 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "shorthash_siphash_ref.h"
+
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+#  pragma GCC target("avx512f")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# define LANES 8U
+# define VEC   __m512i
+
+# define LOADV(p)     _mm512_load_si512((const void *) (p))
+# define STOREV(p, r) _mm512_store_si512((void *) (p), r)
+# define SET1(x)      _mm512_set1_epi64((long long) (x))
+# define ADD(a, b)    _mm512_add_epi64(a, b)
+# define XOR(a, b)    _mm512_xor_si512(a, b)
+# define ROTL(x, b)   _mm512_rol_epi64((x), (b))
+# define SWAP32(x)    _mm512_rol_epi64((x), 32)
+# define SELECT(mask, a, b) \
+    _mm512_mask_blend_epi64(_mm512_test_epi64_mask((mask), (mask)), (b), (a))
+
+# define FN(name) _crypto_shorthash_siphash24_##name##_avx512f
+# include "shorthash_siphash24_multi.h"
+# undef FN
+
+# define CROUNDS 1
+# define DROUNDS 3
+# define FN(name) _crypto_shorthash_siphash13_##name##_avx512f
+# include "shorthash_siphash24_multi.h"
+
+#endif
@@ -0,0 +1,120 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "shorthash_siphash_ref.h"
+
+#if defined(HAVE_ARMNEON)
+
+# include <arm_neon.h>
+
+/* Four lanes, in two 2x64-bit vectors, to keep both pipelines busy */
+
+typedef struct siphash_vec2_t {
+    uint64x2_t a, b;
+} siphash_vec2_t;
+
+static inline siphash_vec2_t
+siphash_vec2_load(const uint64_t *p)
+{
+    siphash_vec2_t r;
+
+    r.a = vld1q_u64(p);
+    r.b = vld1q_u64(p + 2);
+    return r;
+}
+
+static inline void
+siphash_vec2_store(uint64_t *p, const siphash_vec2_t x)
+{
+    vst1q_u64(p, x.a);
+    vst1q_u64(p + 2, x.b);
+}
+
+static inline siphash_vec2_t
+siphash_vec2_set1(const uint64_t x)
+{
+    siphash_vec2_t r;
+
+    r.a = vdupq_n_u64(x);
+    r.b = r.a;
+    return r;
+}
+
+static inline siphash_vec2_t
+siphash_vec2_add(const siphash_vec2_t x, const siphash_vec2_t y)
+{
+    siphash_vec2_t r;
+
+    r.a = vaddq_u64(x.a, y.a);
+    r.b = vaddq_u64(x.b, y.b);
+    return r;
+}
+
+static inline siphash_vec2_t
+siphash_vec2_xor(const siphash_vec2_t x, const siphash_vec2_t y)
+{
+    siphash_vec2_t r;
+
+    r.a = veorq_u64(x.a, y.a);
+    r.b = veorq_u64(x.b, y.b);
+    return r;
+}
+
+static inline siphash_vec2_t
+siphash_vec2_swap32(const siphash_vec2_t x)
+{
+    siphash_vec2_t r;
+
+    r.a = vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(x.a)));
+    r.b = vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(x.b)));
+    return r;
+}
+
+static inline siphash_vec2_t
+siphash_vec2_select(const siphash_vec2_t mask, const siphash_vec2_t x,
+                    const siphash_vec2_t y)
+{
+    siphash_vec2_t r;
+
+    r.a = vbslq_u64(mask.a, x.a, y.a);
+    r.b = vbslq_u64(mask.b, x.b, y.b);
+    return r;
+}
+
+# define SIPHASH_VEC2_ROTL(X, B)                                             \
+    siphash_vec2_rotl_(vsriq_n_u64(vshlq_n_u64((X).a, (B)), (X).a, 64 - (B)), \
+                       vsriq_n_u64(vshlq_n_u64((X).b, (B)), (X).b, 64 - (B)))
+
+static inline siphash_vec2_t
+siphash_vec2_rotl_(const uint64x2_t a, const uint64x2_t b)
+{
+    siphash_vec2_t r;
+
+    r.a = a;
+    r.b = b;
+    return r;
+}
+
+# define LANES 4U
+# define VEC   siphash_vec2_t
+
+# define LOADV(p)           siphash_vec2_load(p)
+# define STOREV(p, r)       siphash_vec2_store((p), (r))
+# define SET1(x)            siphash_vec2_set1((uint64_t) (x))
+# define ADD(a, b)          siphash_vec2_add((a), (b))
+# define XOR(a, b)          siphash_vec2_xor((a), (b))
+# define ROTL(x, b)         SIPHASH_VEC2_ROTL((x), b)
+# define SWAP32(x)          siphash_vec2_swap32(x)
+# define SELECT(mask, a, b) siphash_vec2_select((mask), (a), (b))
+
+# define FN(name) _crypto_shorthash_siphash24_##name##_neon
+# include "shorthash_siphash24_multi.h"
+# undef FN
+
+# define CROUNDS 1
+# define DROUNDS 3
+# define FN(name) _crypto_shorthash_siphash13_##name##_neon
+# include "shorthash_siphash24_multi.h"
+
+#endif
@@ -1,10 +1,62 @@
 #include "crypto_shorthash_siphash24.h"
 #include "private/common.h"
+#include "private/implementations.h"
+#include "runtime.h"
 #include "shorthash_siphash_ref.h"
 
-int
-crypto_shorthash_siphash24(unsigned char *out, const unsigned char *in,
-                           unsigned long long inlen, const unsigned char *k)
+static siphash24_multi_fn siphash24_multi = NULL;
+static size_t             siphash24_multi_lanes = 0U;
+
+static inline uint64_t
+siphash24_final(uint64_t v0, uint64_t v1, uint64_t v2, uint64_t v3,
+                const uint64_t b)
+{
+    v3 ^= b;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= b;
+    v2 ^= 0xff;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/* Fixed number of 64-bit words, so that the loop can be fully unrolled */
+static inline uint64_t
+siphash24_words(const unsigned char *in, const size_t words,
+                const unsigned char *k)
+{
+    /* "somepseudorandomlygeneratedbytes" */
+    uint64_t v0 = 0x736f6d6570736575ULL;
+    uint64_t v1 = 0x646f72616e646f6dULL;
+    uint64_t v2 = 0x6c7967656e657261ULL;
+    uint64_t v3 = 0x7465646279746573ULL;
+    uint64_t k0 = LOAD64_LE(k);
+    uint64_t k1 = LOAD64_LE(k + 8);
+    uint64_t m;
+    size_t   i;
+
+    v3 ^= k1;
+    v2 ^= k0;
+    v1 ^= k1;
+    v0 ^= k0;
+    for (i = 0U; i < words; i++) {
+        m = LOAD64_LE(in + i * 8U);
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+    return siphash24_final(v0, v1, v2, v3, ((uint64_t) (words * 8U)) << 56);
+}
+
+uint64_t
+crypto_shorthash_siphash24_value(const unsigned char *in,
+                                 unsigned long long inlen,
+                                 const unsigned char *k)
 {
     /* "somepseudorandomlygeneratedbytes" */
     uint64_t       v0 = 0x736f6d6570736575ULL;
@@ -55,17 +107,97 @@ crypto_shorthash_siphash24(unsigned char *out, const unsigned char *in,
     case 0:
         break;
     }
-    v3 ^= b;
-    SIPROUND;
-    SIPROUND;
-    v0 ^= b;
-    v2 ^= 0xff;
-    SIPROUND;
-    SIPROUND;
-    SIPROUND;
-    SIPROUND;
-    b = v0 ^ v1 ^ v2 ^ v3;
-    STORE64_LE(out, b);
+    return siphash24_final(v0, v1, v2, v3, b);
+}
+
+int
+crypto_shorthash_siphash24(unsigned char *out, const unsigned char *in,
+                           unsigned long long inlen, const unsigned char *k)
+{
+    STORE64_LE(out, crypto_shorthash_siphash24_value(in, inlen, k));
+
+    return 0;
+}
+
+uint64_t
+crypto_shorthash_siphash24_u64(const uint64_t x, const unsigned char *k)
+{
+    unsigned char in[8];
+
+    STORE64_LE(in, x);
+
+    return siphash24_words(in, 1U, k);
+}
+
+uint64_t
+crypto_shorthash_siphash24_16(const unsigned char in[16],
+                              const unsigned char *k)
+{
+    return siphash24_words(in, 2U, k);
+}
+
+uint64_t
+crypto_shorthash_siphash24_32(const unsigned char in[32],
+                              const unsigned char *k)
+{
+    return siphash24_words(in, 4U, k);
+}
+
+int
+crypto_shorthash_siphash24_multi(unsigned char *out,
+                                 const unsigned char * const *in,
+                                 const unsigned long long *inlen, size_t count,
+                                 const unsigned char *k)
+{
+    size_t i;
+    size_t n;
+
+    if (siphash24_multi == NULL || count < 2U) {
+        for (i = 0U; i < count; i++) {
+            crypto_shorthash_siphash24(out + i * crypto_shorthash_siphash24_BYTES,
+                                       in[i], inlen[i], k);
+        }
+        return 0;
+    }
+    for (i = 0U; i < count; i += n) {
+        n = count - i;
+        if (n > siphash24_multi_lanes) {
+            n = siphash24_multi_lanes;
+        }
+        siphash24_multi(out + i * crypto_shorthash_siphash24_BYTES,
+                        in + i, inlen + i, n, k);
+    }
+    return 0;
+}
 
+int
+_crypto_shorthash_siphash24_pick_best_implementation(void)
+{
+    siphash24_multi       = NULL;
+    siphash24_multi_lanes = 0U;
+#if defined(HAVE_ARMNEON)
+    if (sodium_runtime_has_neon()) {
+        siphash24_multi       = _crypto_shorthash_siphash24_multi_neon;
+        siphash24_multi_lanes = 4U;
+        return 0;
+    }
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors()) {
+        siphash24_multi       = _crypto_shorthash_siphash24_multi_avx512f;
+        siphash24_multi_lanes = 8U;
+        return 0;
+    }
+#endif
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2()) {
+        siphash24_multi       = _crypto_shorthash_siphash24_multi_avx2;
+        siphash24_multi_lanes = 4U;
+        return 0;
+    }
+#endif
     return 0;
 }
@@ -21,4 +21,55 @@
         v2 = ROTL64(v2, 32); \
     } while (0)
 
+#define HALFSIPROUND         \
+    do {                     \
+        v0 += v1;            \
+        v1 = ROTL32(v1, 5);  \
+        v1 ^= v0;            \
+        v0 = ROTL32(v0, 16); \
+        v2 += v3;            \
+        v3 = ROTL32(v3, 8);  \
+        v3 ^= v2;            \
+        v0 += v3;            \
+        v3 = ROTL32(v3, 7);  \
+        v3 ^= v0;            \
+        v2 += v1;            \
+        v1 = ROTL32(v1, 13); \
+        v1 ^= v2;            \
+        v2 = ROTL32(v2, 16); \
+    } while (0)
+
+#define SIPHASH24_MULTI_LANES_MAX 8
+
+typedef int (*siphash24_multi_fn)(unsigned char *out,
+                                  const unsigned char * const *in,
+                                  const unsigned long long *inlen, size_t n,
+                                  const unsigned char *k);
+
+int _crypto_shorthash_siphash24_multi_avx2(unsigned char *out,
+                                           const unsigned char * const *in,
+                                           const unsigned long long *inlen,
+                                           size_t n, const unsigned char *k);
+int _crypto_shorthash_siphash24_multi_avx512f(unsigned char *out,
+                                              const unsigned char * const *in,
+                                              const unsigned long long *inlen,
+                                              size_t n, const unsigned char *k);
+int _crypto_shorthash_siphash24_multi_neon(unsigned char *out,
+                                           const unsigned char * const *in,
+                                           const unsigned long long *inlen,
+                                           size_t n, const unsigned char *k);
+
+int _crypto_shorthash_siphash13_multi_avx2(unsigned char *out,
+                                           const unsigned char * const *in,
+                                           const unsigned long long *inlen,
+                                           size_t n, const unsigned char *k);
+int _crypto_shorthash_siphash13_multi_avx512f(unsigned char *out,
+                                              const unsigned char * const *in,
+                                              const unsigned long long *inlen,
+                                              size_t n, const unsigned char *k);
+int _crypto_shorthash_siphash13_multi_neon(unsigned char *out,
+                                           const unsigned char * const *in,
+                                           const unsigned long long *inlen,
+                                           size_t n, const unsigned char *k);
+
 #endif
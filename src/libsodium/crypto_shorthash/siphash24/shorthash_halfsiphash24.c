@@ -0,0 +1,11 @@
+#include "crypto_shorthash_siphash24.h"
+
+size_t
+crypto_shorthash_halfsiphash24_bytes(void) {
+    return crypto_shorthash_halfsiphash24_BYTES;
+}
+
+size_t
+crypto_shorthash_halfsiphash24_keybytes(void) {
+    return crypto_shorthash_halfsiphash24_KEYBYTES;
+}
@@ -5,10 +5,15 @@
 #include "crypto_scalarmult_curve25519.h"
 #include "crypto_sign_ed25519.h"
 #include "sign_ed25519_ref10.h"
+#include "private/aliases.h"
 #include "private/ed25519_ref10.h"
+#include "private/sha512_multi.h"
 #include "randombytes.h"
 #include "utils.h"
 
+SODIUM_ALIAS_PROTO(crypto_hash_sha512);
+SODIUM_ALIAS_PROTO(crypto_hash_sha512_init);
+
 int
 crypto_sign_ed25519_seed_keypair(unsigned char *pk, unsigned char *sk,
                                  const unsigned char *seed)
@@ -29,6 +34,54 @@ crypto_sign_ed25519_seed_keypair(unsigned char *pk, unsigned char *sk,
     return 0;
 }
 
+#define ED25519_KEYPAIR_BATCH 16U
+
+int
+crypto_sign_ed25519_seed_keypair_batch(unsigned char *pks, unsigned char *sks,
+                                       const unsigned char *seeds,
+                                       size_t count)
+{
+    crypto_hash_sha512_state  hs[ED25519_KEYPAIR_BATCH];
+    crypto_hash_sha512_state *hs_p[ED25519_KEYPAIR_BATCH];
+    const unsigned char      *in_p[ED25519_KEYPAIR_BATCH];
+    unsigned char            *h_p[ED25519_KEYPAIR_BATCH];
+    unsigned long long        inlen[ED25519_KEYPAIR_BATCH];
+    unsigned char             h[ED25519_KEYPAIR_BATCH][64];
+    ge25519_p3                A[ED25519_KEYPAIR_BATCH];
+    size_t                    chunk;
+    size_t                    i;
+    size_t                    j;
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > ED25519_KEYPAIR_BATCH) {
+            chunk = ED25519_KEYPAIR_BATCH;
+        }
+        for (j = 0U; j < chunk; j++) {
+            crypto_hash_sha512_init(&hs[j]);
+            hs_p[j]  = &hs[j];
+            in_p[j]  = &seeds[(i + j) * 32U];
+            inlen[j] = 32U;
+            h_p[j]   = h[j];
+        }
+        _crypto_hash_sha512_final_multi(hs_p, h_p, in_p, inlen, chunk);
+        for (j = 0U; j < chunk; j++) {
+            h[j][0] &= 248;
+            h[j][31] &= 127;
+            h[j][31] |= 64;
+            ge25519_scalarmult_base(&A[j], h[j]);
+        }
+        ge25519_p3_tobytes_batch(&pks[i * 32U], A, chunk);
+        for (j = 0U; j < chunk; j++) {
+            memmove(&sks[(i + j) * 64U], &seeds[(i + j) * 32U], 32);
+            memmove(&sks[(i + j) * 64U + 32U], &pks[(i + j) * 32U], 32);
+        }
+    }
+    sodium_memzero(h, sizeof h);
+
+    return 0;
+}
+
 int
 crypto_sign_ed25519_keypair(unsigned char *pk, unsigned char *sk)
 {
@@ -66,6 +119,66 @@ crypto_sign_ed25519_pk_to_curve25519(unsigned char *curve25519_pk,
     return 0;
 }
 
+#define ED25519_PK_TO_CURVE25519_BATCH 32U
+
+int
+crypto_sign_ed25519_pk_to_curve25519_batch(unsigned char *curve25519_pks,
+                                           const unsigned char *ed25519_pks,
+                                           size_t count)
+{
+    ge25519_p3 A;
+    fe25519    x[ED25519_PK_TO_CURVE25519_BATCH];
+    fe25519    one_minus_y[ED25519_PK_TO_CURVE25519_BATCH];
+    fe25519    acc[ED25519_PK_TO_CURVE25519_BATCH];
+    fe25519    recip;
+    fe25519    t;
+    size_t     chunk;
+    size_t     i;
+    size_t     j;
+    int        ret = 0;
+    int        valid[ED25519_PK_TO_CURVE25519_BATCH];
+
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > ED25519_PK_TO_CURVE25519_BATCH) {
+            chunk = ED25519_PK_TO_CURVE25519_BATCH;
+        }
+        for (j = 0U; j < chunk; j++) {
+            const unsigned char *ed25519_pk = &ed25519_pks[(i + j) * 32U];
+
+            valid[j] = ge25519_has_small_order(ed25519_pk) == 0 &&
+                ge25519_frombytes_negate_vartime(&A, ed25519_pk) == 0 &&
+                ge25519_is_on_main_subgroup(&A) != 0;
+            if (valid[j] == 0) {
+                ret = -1;
+                fe25519_0(x[j]);
+                fe25519_1(one_minus_y[j]);
+            } else {
+                fe25519_1(one_minus_y[j]);
+                fe25519_sub(one_minus_y[j], one_minus_y[j], A.Y);
+                fe25519_1(x[j]);
+                fe25519_add(x[j], x[j], A.Y);
+            }
+            if (j == 0U) {
+                fe25519_copy(acc[0], one_minus_y[0]);
+            } else {
+                fe25519_mul(acc[j], acc[j - 1U], one_minus_y[j]);
+            }
+        }
+        fe25519_invert(recip, acc[chunk - 1U]);
+        for (j = chunk - 1U; j > 0U; j--) {
+            fe25519_mul(t, recip, acc[j - 1U]);
+            fe25519_mul(recip, recip, one_minus_y[j]);
+            fe25519_mul(x[j], x[j], t);
+        }
+        fe25519_mul(x[0], x[0], recip);
+        for (j = 0U; j < chunk; j++) {
+            fe25519_tobytes(&curve25519_pks[(i + j) * 32U], x[j]);
+        }
+    }
+    return ret;
+}
+
 int
 crypto_sign_ed25519_sk_to_curve25519(unsigned char *curve25519_sk,
                                      const unsigned char *ed25519_sk)
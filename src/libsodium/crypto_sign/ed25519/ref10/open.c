@@ -1,28 +1,42 @@
 
 #include <limits.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "crypto_hash_sha512.h"
 #include "crypto_sign_ed25519.h"
 #include "crypto_verify_32.h"
+#include "randombytes.h"
 #include "sign_ed25519_ref10.h"
+#include "private/aliases.h"
+#include "private/common.h"
 #include "private/ed25519_ref10.h"
+#include "private/probes.h"
+#include "private/sha512_multi.h"
+#include "private/stats.h"
 #include "utils.h"
 
-int
-_crypto_sign_ed25519_verify_detached(const unsigned char *sig,
-                                     const unsigned char *m,
-                                     unsigned long long   mlen,
-                                     const unsigned char *pk,
-                                     int prehashed)
-{
+SODIUM_ALIAS_PROTO(crypto_hash_sha512_update);
+SODIUM_ALIAS_PROTO(crypto_hash_sha512_final);
+SODIUM_ALIAS_PROTO(crypto_verify_32);
+
+#define ED25519_BATCH_CHUNK 64U
+
+typedef struct ed25519_pk_state_ {
+    ge25519_cached Ai[32]; /* -A,-3A,...,-63A */
+    unsigned char  pk[32];
+} ed25519_pk_state;
+
+typedef struct ed25519_batch_hash_ {
     crypto_hash_sha512_state hs;
     unsigned char            h[64];
-    unsigned char            rcheck[32];
-    ge25519_p3               A;
-    ge25519_p2               R;
+} ed25519_batch_hash;
 
+static int
+_crypto_sign_ed25519_verify_check(const unsigned char *sig,
+                                  const unsigned char *pk)
+{
 #ifdef ED25519_COMPAT
     if (sig[63] & 224) {
         return -1;
@@ -40,17 +54,139 @@ _crypto_sign_ed25519_verify_detached(const unsigned char *sig,
         return -1;
     }
 #endif
-    if (ge25519_frombytes_negate_vartime(&A, pk) != 0) {
+    return 0;
+}
+
+/* h = H(R || A || M), A is the negated public key */
+static int
+_crypto_sign_ed25519_verify_equation(unsigned char h[64],
+                                     const unsigned char *sig,
+                                     const ge25519_p3 *A)
+{
+    unsigned char rcheck[32];
+    ge25519_p2    R;
+
+    sc25519_reduce(h);
+    ge25519_double_scalarmult_vartime(&R, h, A, sig + 32);
+    ge25519_tobytes(rcheck, &R);
+
+    return crypto_verify_32(rcheck, sig) | (-(rcheck == sig)) |
+           sodium_memcmp(sig, rcheck, 32);
+}
+
+/* hs must have absorbed R || A || M */
+static int
+_crypto_sign_ed25519_verify_final(crypto_hash_sha512_state *hs,
+                                  const unsigned char *sig,
+                                  const unsigned char *pk)
+{
+    unsigned char h[64];
+    ge25519_p3    A;
+
+    if (_crypto_sign_ed25519_verify_check(sig, pk) != 0 ||
+        ge25519_frombytes_negate_vartime(&A, pk) != 0) {
+        return -1;
+    }
+    crypto_hash_sha512_final(hs, h);
+
+    return _crypto_sign_ed25519_verify_equation(h, sig, &A);
+}
+
+int
+_crypto_sign_ed25519_verify_detached(const unsigned char *sig,
+                                     const unsigned char *m,
+                                     unsigned long long   mlen,
+                                     const unsigned char *pk,
+                                     int prehashed)
+{
+    crypto_hash_sha512_state hs;
+
+    if (_crypto_sign_ed25519_verify_check(sig, pk) != 0) {
         return -1;
     }
     _crypto_sign_ed25519_ref10_hinit(&hs, prehashed);
     crypto_hash_sha512_update(&hs, sig, 32);
     crypto_hash_sha512_update(&hs, pk, 32);
     crypto_hash_sha512_update(&hs, m, mlen);
+
+    return _crypto_sign_ed25519_verify_final(&hs, sig, pk);
+}
+
+int
+crypto_sign_ed25519_verify_init(crypto_sign_ed25519_verify_state *state,
+                                const unsigned char *sig,
+                                const unsigned char *pk)
+{
+    memcpy(state->sig, sig, sizeof state->sig);
+    memcpy(state->pk, pk, sizeof state->pk);
+    _crypto_sign_ed25519_ref10_hinit(&state->hs, 0);
+    crypto_hash_sha512_update(&state->hs, sig, 32);
+    crypto_hash_sha512_update(&state->hs, pk, 32);
+
+    return _crypto_sign_ed25519_verify_check(sig, pk);
+}
+
+int
+crypto_sign_ed25519_verify_update(crypto_sign_ed25519_verify_state *state,
+                                  const unsigned char *m,
+                                  unsigned long long mlen)
+{
+    return crypto_hash_sha512_update(&state->hs, m, mlen);
+}
+
+int
+crypto_sign_ed25519_verify_final(crypto_sign_ed25519_verify_state *state)
+{
+    return _crypto_sign_ed25519_verify_final(&state->hs, state->sig,
+                                             state->pk);
+}
+
+int
+crypto_sign_ed25519_pk_precompute(crypto_sign_ed25519_pk_state *state,
+                                  const unsigned char *pk)
+{
+    ed25519_pk_state *st = (ed25519_pk_state *) (void *) state;
+    ge25519_p3        A;
+
+    COMPILER_ASSERT(sizeof *st <= sizeof *state);
+#ifndef ED25519_COMPAT
+    if (ge25519_is_canonical(pk) == 0 ||
+        ge25519_has_small_order(pk) != 0) {
+        return -1;
+    }
+#endif
+    if (ge25519_frombytes_negate_vartime(&A, pk) != 0) {
+        return -1;
+    }
+    ge25519_p3_to_cached_table_vartime(st->Ai, &A);
+    memcpy(st->pk, pk, 32);
+
+    return 0;
+}
+
+int
+crypto_sign_ed25519_verify_detached_precomputed(const unsigned char *sig,
+                                                const unsigned char *m,
+                                                unsigned long long   mlen,
+                                                const crypto_sign_ed25519_pk_state *state)
+{
+    const ed25519_pk_state  *st = (const ed25519_pk_state *) (const void *) state;
+    crypto_hash_sha512_state hs;
+    unsigned char            h[64];
+    unsigned char            rcheck[32];
+    ge25519_p2               R;
+
+    if (_crypto_sign_ed25519_verify_check(sig, st->pk) != 0) {
+        return -1;
+    }
+    _crypto_sign_ed25519_ref10_hinit(&hs, 0);
+    crypto_hash_sha512_update(&hs, sig, 32);
+    crypto_hash_sha512_update(&hs, st->pk, 32);
+    crypto_hash_sha512_update(&hs, m, mlen);
     crypto_hash_sha512_final(&hs, h);
     sc25519_reduce(h);
 
-    ge25519_double_scalarmult_vartime(&R, h, &A, sig + 32);
+    ge25519_double_scalarmult_cached_vartime(&R, h, st->Ai, sig + 32);
     ge25519_tobytes(rcheck, &R);
 
     return crypto_verify_32(rcheck, sig) | (-(rcheck == sig)) |
@@ -63,7 +199,350 @@ crypto_sign_ed25519_verify_detached(const unsigned char *sig,
                                     unsigned long long   mlen,
                                     const unsigned char *pk)
 {
-    return _crypto_sign_ed25519_verify_detached(sig, m, mlen, pk, 0);
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    SODIUM_PROBE1(sign_verify__entry, mlen);
+    ret = _crypto_sign_ed25519_verify_detached(sig, m, mlen, pk, 0);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_SIGN, mlen);
+    SODIUM_PROBE1(sign_verify__return, ret);
+
+    return ret;
+}
+
+/*
+ * crypto_sign_ed25519_verify_detached() checks the cofactorless equation,
+ * and a randomized combination of several equations cannot give the same
+ * results: components of order 2 of R_i and A_i cancel out with probability
+ * at least 1/2, and clearing the cofactor ignores them altogether, so that
+ * a signature rejected on its own could pass. Each equation is therefore
+ * checked separately, and only the challenge hashes of a chunk are computed
+ * together, using the multi-buffer SHA-512.
+ */
+
+static int
+_crypto_sign_ed25519_verify_batch_chunk(const unsigned char * const *sigs,
+                                        const unsigned char * const *ms,
+                                        const unsigned long long *mlens,
+                                        const unsigned char * const *pks,
+                                        size_t count, int *results,
+                                        ge25519_p3 *points,
+                                        ed25519_batch_hash *hashes)
+{
+    crypto_hash_sha512_state *hs_p[ED25519_BATCH_CHUNK];
+    unsigned char            *h_p[ED25519_BATCH_CHUNK];
+    const unsigned char      *m_p[ED25519_BATCH_CHUNK];
+    unsigned long long        mlen_p[ED25519_BATCH_CHUNK];
+    size_t                    idx[ED25519_BATCH_CHUNK];
+    size_t                    i;
+    size_t                    k;
+    size_t                    valid = 0U;
+    int                       ret = 0;
+
+    for (i = 0U; i < count; i++) {
+        if (_crypto_sign_ed25519_verify_check(sigs[i], pks[i]) != 0 ||
+            ge25519_frombytes_negate_vartime(&points[valid], pks[i]) != 0) {
+            results[i] = -1;
+            ret = -1;
+            continue;
+        }
+        _crypto_sign_ed25519_ref10_hinit(&hashes[valid].hs, 0);
+        crypto_hash_sha512_update(&hashes[valid].hs, sigs[i], 32);
+        crypto_hash_sha512_update(&hashes[valid].hs, pks[i], 32);
+        hs_p[valid]   = &hashes[valid].hs;
+        h_p[valid]    = hashes[valid].h;
+        m_p[valid]    = ms[i];
+        mlen_p[valid] = mlens[i];
+        idx[valid]    = i;
+        valid++;
+    }
+    _crypto_hash_sha512_final_multi(hs_p, h_p, m_p, mlen_p, valid);
+
+    for (k = 0U; k < valid; k++) {
+        i = idx[k];
+        results[i] = _crypto_sign_ed25519_verify_equation(hashes[k].h,
+                                                          sigs[i], &points[k]);
+        ret |= results[i];
+    }
+    return ret;
+}
+
+int
+crypto_sign_ed25519_verify_batch(const unsigned char * const *sigs,
+                                 const unsigned char * const *ms,
+                                 const unsigned long long *mlens,
+                                 const unsigned char * const *pks,
+                                 size_t count, int *results)
+{
+    int                 chunk_results[ED25519_BATCH_CHUNK];
+    ge25519_p3         *points;
+    ed25519_batch_hash *hashes;
+    size_t              chunk;
+    size_t              i;
+    size_t              j;
+    int                 ret = 0;
+
+    points = (ge25519_p3 *) malloc(ED25519_BATCH_CHUNK * sizeof *points);
+    hashes = (ed25519_batch_hash *)
+        malloc(ED25519_BATCH_CHUNK * sizeof *hashes);
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > ED25519_BATCH_CHUNK) {
+            chunk = ED25519_BATCH_CHUNK;
+        }
+        if (points != NULL && hashes != NULL) {
+            ret |= _crypto_sign_ed25519_verify_batch_chunk
+                (&sigs[i], &ms[i], &mlens[i], &pks[i], chunk, chunk_results,
+                 points, hashes);
+        } else {
+            for (j = 0U; j < chunk; j++) {
+                chunk_results[j] = crypto_sign_ed25519_verify_detached
+                    (sigs[i + j], ms[i + j], mlens[i + j], pks[i + j]);
+                ret |= chunk_results[j];
+            }
+        }
+        if (results != NULL) {
+            memcpy(&results[i], chunk_results, chunk * sizeof chunk_results[0]);
+        }
+    }
+    free(hashes);
+    free(points);
+
+    return ret;
+}
+
+/*
+ * Half-aggregation: the aggregate of n signatures (R_i, S_i) is
+ * R_1 || ... || R_n || S, with S = sum(z_i * S_i). The z_i are 128-bit
+ * coefficients derived from a hash of every (R_i, A_i, H(R_i || A_i || M_i)),
+ * so that they cannot be chosen by the signers. Verification checks that
+ * S * B - sum(z_i * R_i) - sum(z_i * H(R_i || A_i || M_i) * A_i),
+ * multiplied by the cofactor, is the identity, with a single multi-scalar
+ * multiplication.
+ * Clearing the cofactor would ignore small-order components of R_i and A_i,
+ * so points that are not canonical or not in 4E are rejected. Components of
+ * order 2 cannot be detected without a full scalar multiplication per point,
+ * and remain accepted.
+ */
+
+static int
+_crypto_sign_ed25519_aggregate_check_point(const ge25519_p3 *p,
+                                           const unsigned char *s)
+{
+#ifndef ED25519_COMPAT
+    if (ge25519_is_canonical(s) == 0 ||
+        ge25519_is_on_main_subgroup_vartime(p) == 0) {
+        return -1;
+    }
+#else
+    (void) p;
+    (void) s;
+#endif
+    return 0;
+}
+
+/* ks[i] = H(R_i || A_i || M_i) (mod q), zs[i] = z_i */
+static int
+_crypto_sign_ed25519_aggregate_scalars(unsigned char *ks, unsigned char *zs,
+                                       const unsigned char *Rs,
+                                       const unsigned char * const *ms,
+                                       const unsigned long long *mlens,
+                                       const unsigned char * const *pks,
+                                       size_t count)
+{
+    static const unsigned char DOMAIN[24] = {
+        'E', 'd', '2', '5', '5', '1', '9', ' ', 'h', 'a', 'l', 'f', '-',
+        'a', 'g', 'g', 'r', 'e', 'g', 'a', 't', 'i', 'o', 'n'
+    };
+    crypto_hash_sha512_state  hs;
+    crypto_hash_sha512_state  hs_i;
+    crypto_hash_sha512_state *hs_p[ED25519_BATCH_CHUNK];
+    unsigned char            *h_p[ED25519_BATCH_CHUNK];
+    ed25519_batch_hash       *hashes;
+    unsigned char             h[64];
+    unsigned char             ibytes[8];
+    size_t                    chunk;
+    size_t                    i;
+    size_t                    j;
+
+    hashes = (ed25519_batch_hash *)
+        malloc(ED25519_BATCH_CHUNK * sizeof *hashes);
+    if (hashes == NULL) {
+        return -1;
+    }
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > ED25519_BATCH_CHUNK) {
+            chunk = ED25519_BATCH_CHUNK;
+        }
+        for (j = 0U; j < chunk; j++) {
+            _crypto_sign_ed25519_ref10_hinit(&hashes[j].hs, 0);
+            crypto_hash_sha512_update(&hashes[j].hs, &Rs[(i + j) * 32U], 32);
+            crypto_hash_sha512_update(&hashes[j].hs, pks[i + j], 32);
+            hs_p[j] = &hashes[j].hs;
+            h_p[j]  = hashes[j].h;
+        }
+        _crypto_hash_sha512_final_multi(hs_p, h_p, &ms[i], &mlens[i], chunk);
+        for (j = 0U; j < chunk; j++) {
+            sc25519_reduce(hashes[j].h);
+            memcpy(&ks[(i + j) * 32U], hashes[j].h, 32);
+        }
+    }
+    free(hashes);
+
+    crypto_hash_sha512_init(&hs);
+    crypto_hash_sha512_update(&hs, DOMAIN, sizeof DOMAIN);
+    for (i = 0U; i < count; i++) {
+        crypto_hash_sha512_update(&hs, &Rs[i * 32U], 32);
+        crypto_hash_sha512_update(&hs, pks[i], 32);
+        crypto_hash_sha512_update(&hs, &ks[i * 32U], 32);
+    }
+    for (i = 0U; i < count; i++) {
+        hs_i = hs;
+        STORE64_LE(ibytes, (uint64_t) i);
+        crypto_hash_sha512_update(&hs_i, ibytes, sizeof ibytes);
+        crypto_hash_sha512_final(&hs_i, h);
+        memset(&zs[i * 32U], 0, 32U);
+        memcpy(&zs[i * 32U], h, 16U);
+    }
+    return 0;
+}
+
+int
+crypto_sign_ed25519_aggregate(unsigned char *agg,
+                              unsigned long long *agglen_p,
+                              const unsigned char * const *sigs,
+                              const unsigned char * const *ms,
+                              const unsigned long long *mlens,
+                              const unsigned char * const *pks,
+                              size_t count)
+{
+    unsigned char *ks;
+    unsigned char *zs;
+    unsigned char  s[32];
+    ge25519_p3     P;
+    size_t         i;
+
+    if (agglen_p != NULL) {
+        *agglen_p = 0U;
+    }
+    if (count == 0U || count > SIZE_MAX / 64U - 1U) {
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        if (_crypto_sign_ed25519_verify_check(sigs[i], pks[i]) != 0 ||
+            ge25519_frombytes(&P, sigs[i]) != 0 ||
+            _crypto_sign_ed25519_aggregate_check_point(&P, sigs[i]) != 0 ||
+            ge25519_frombytes(&P, pks[i]) != 0 ||
+            _crypto_sign_ed25519_aggregate_check_point(&P, pks[i]) != 0) {
+            return -1;
+        }
+    }
+    if ((ks = (unsigned char *) malloc(count * 64U)) == NULL) {
+        return -1;
+    }
+    zs = ks + count * 32U;
+    for (i = 0U; i < count; i++) {
+        memmove(&agg[i * 32U], sigs[i], 32);
+    }
+    if (_crypto_sign_ed25519_aggregate_scalars(ks, zs, agg, ms, mlens, pks,
+                                               count) != 0) {
+        free(ks);
+        return -1;
+    }
+    memset(s, 0, sizeof s);
+    for (i = 0U; i < count; i++) {
+        sc25519_muladd(s, &zs[i * 32U], sigs[i] + 32, s);
+    }
+    memcpy(&agg[count * 32U], s, 32);
+    free(ks);
+    if (agglen_p != NULL) {
+        *agglen_p = (unsigned long long) count * 32U + 32U;
+    }
+    return 0;
+}
+
+int
+crypto_sign_ed25519_verify_aggregate(const unsigned char *agg,
+                                     const unsigned char * const *ms,
+                                     const unsigned long long *mlens,
+                                     const unsigned char * const *pks,
+                                     size_t count)
+{
+    static const unsigned char one[32] = { 1 };
+    const unsigned char       *s;
+    unsigned char             *ks;
+    unsigned char             *zs;
+    unsigned char             *scalars;
+    unsigned char              rcheck[32];
+    ge25519_p3                *points;
+    ge25519_p3                 check;
+    size_t                     i;
+    int                        ret = -1;
+
+    if (count == 0U || count > SIZE_MAX / 64U - 1U ||
+        count > (SIZE_MAX / sizeof *points - 1U) / 2U) {
+        return -1;
+    }
+    s = &agg[count * 32U];
+#ifdef ED25519_COMPAT
+    if (s[31] & 224) {
+        return -1;
+    }
+#else
+    if ((s[31] & 240) != 0 && sc25519_is_canonical(s) == 0) {
+        return -1;
+    }
+    for (i = 0U; i < count; i++) {
+        if (ge25519_has_small_order(&agg[i * 32U]) != 0 ||
+            ge25519_is_canonical(pks[i]) == 0 ||
+            ge25519_has_small_order(pks[i]) != 0) {
+            return -1;
+        }
+    }
+#endif
+    ks      = (unsigned char *) malloc(count * 64U);
+    scalars = (unsigned char *) malloc((2U * count + 1U) * 32U);
+    points  = (ge25519_p3 *) malloc((2U * count + 1U) * sizeof *points);
+    if (ks == NULL || scalars == NULL || points == NULL) {
+        goto done;
+    }
+    zs = ks + count * 32U;
+    for (i = 0U; i < count; i++) {
+        if (ge25519_frombytes_negate_vartime(&points[2U * i],
+                                             &agg[i * 32U]) != 0 ||
+            ge25519_frombytes_negate_vartime(&points[2U * i + 1U],
+                                             pks[i]) != 0 ||
+            _crypto_sign_ed25519_aggregate_check_point(&points[2U * i],
+                                                       &agg[i * 32U]) != 0 ||
+            _crypto_sign_ed25519_aggregate_check_point(&points[2U * i + 1U],
+                                                       pks[i]) != 0) {
+            goto done;
+        }
+    }
+    if (_crypto_sign_ed25519_aggregate_scalars(ks, zs, agg, ms, mlens, pks,
+                                               count) != 0) {
+        goto done;
+    }
+    for (i = 0U; i < count; i++) {
+        memcpy(&scalars[2U * i * 32U], &zs[i * 32U], 32U);
+        sc25519_mul(&scalars[(2U * i + 1U) * 32U], &zs[i * 32U],
+                    &ks[i * 32U]);
+    }
+    ge25519_scalarmult_base(&points[2U * count], one);
+    memcpy(&scalars[2U * count * 32U], s, 32U);
+    if (ge25519_multi_scalarmult_vartime(&check, scalars, points,
+                                         2U * count + 1U) == 0) {
+        ge25519_clear_cofactor(&check);
+        ge25519_p3_tobytes(rcheck, &check);
+        ret = sodium_memcmp(rcheck, one, 32U);
+    }
+done:
+    free(points);
+    free(scalars);
+    free(ks);
+
+    return ret;
 }
 
 int
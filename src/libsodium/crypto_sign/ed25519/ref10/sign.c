@@ -1,13 +1,23 @@
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "crypto_hash_sha512.h"
 #include "crypto_sign_ed25519.h"
 #include "sign_ed25519_ref10.h"
+#include "private/aliases.h"
+#include "private/common.h"
 #include "private/ed25519_ref10.h"
+#include "private/sha512_multi.h"
+#include "private/stats.h"
 #include "randombytes.h"
 #include "utils.h"
 
+SODIUM_ALIAS_PROTO(crypto_hash_sha512);
+SODIUM_ALIAS_PROTO(crypto_hash_sha512_init);
+SODIUM_ALIAS_PROTO(crypto_hash_sha512_update);
+SODIUM_ALIAS_PROTO(crypto_hash_sha512_final);
+
 void
 _crypto_sign_ed25519_ref10_hinit(crypto_hash_sha512_state *hs, int prehashed)
 {
@@ -32,7 +42,6 @@ _crypto_sign_ed25519_clamp(unsigned char k[32])
     k[31] |= 64;
 }
 
-#ifdef ED25519_NONDETERMINISTIC
 /* r = hash(B || empty_labelset || Z || pad1 || k || pad2 || empty_labelset || K || extra || M) (mod q) */
 static void
 _crypto_sign_ed25519_synthetic_r_hv(crypto_hash_sha512_state *hs,
@@ -59,22 +68,27 @@ _crypto_sign_ed25519_synthetic_r_hv(crypto_hash_sha512_state *hs,
     crypto_hash_sha512_update(hs, sk + 32, 32);
     /* empty extra */
 }
-#endif
 
-int
-_crypto_sign_ed25519_detached(unsigned char *sig, unsigned long long *siglen_p,
-                              const unsigned char *m, unsigned long long mlen,
-                              const unsigned char *sk, int prehashed)
+typedef struct ed25519_sk_state_ {
+    unsigned char az[64]; /* SHA-512(seed), before clamping */
+    unsigned char pk[32];
+} ed25519_sk_state;
+
+static void
+_crypto_sign_ed25519_detached_az(unsigned char *sig,
+                                 const unsigned char *m,
+                                 unsigned long long mlen,
+                                 const unsigned char az[64],
+                                 const unsigned char pk[32], int prehashed)
 {
     crypto_hash_sha512_state hs;
-    unsigned char            az[64];
+    unsigned char            a[32];
     unsigned char            nonce[64];
     unsigned char            hram[64];
     ge25519_p3               R;
 
     _crypto_sign_ed25519_ref10_hinit(&hs, prehashed);
 
-    crypto_hash_sha512(az, sk, 32);
 #ifdef ED25519_NONDETERMINISTIC
     _crypto_sign_ed25519_synthetic_r_hv(&hs, nonce /* Z */, az);
 #else
@@ -84,7 +98,7 @@ _crypto_sign_ed25519_detached(unsigned char *sig, unsigned long long *siglen_p,
     crypto_hash_sha512_update(&hs, m, mlen);
     crypto_hash_sha512_final(&hs, nonce);
 
-    memmove(sig + 32, sk + 32, 32);
+    memmove(sig + 32, pk, 32);
 
     sc25519_reduce(nonce);
     ge25519_scalarmult_base(&R, nonce);
@@ -96,11 +110,24 @@ _crypto_sign_ed25519_detached(unsigned char *sig, unsigned long long *siglen_p,
     crypto_hash_sha512_final(&hs, hram);
 
     sc25519_reduce(hram);
-    _crypto_sign_ed25519_clamp(az);
-    sc25519_muladd(sig + 32, hram, az, nonce);
+    memcpy(a, az, 32);
+    _crypto_sign_ed25519_clamp(a);
+    sc25519_muladd(sig + 32, hram, a, nonce);
 
-    sodium_memzero(az, sizeof az);
+    sodium_memzero(a, sizeof a);
     sodium_memzero(nonce, sizeof nonce);
+}
+
+int
+_crypto_sign_ed25519_detached(unsigned char *sig, unsigned long long *siglen_p,
+                              const unsigned char *m, unsigned long long mlen,
+                              const unsigned char *sk, int prehashed)
+{
+    unsigned char az[64];
+
+    crypto_hash_sha512(az, sk, 32);
+    _crypto_sign_ed25519_detached_az(sig, m, mlen, az, sk + 32, prehashed);
+    sodium_memzero(az, sizeof az);
 
     if (siglen_p != NULL) {
         *siglen_p = 64U;
@@ -113,7 +140,218 @@ crypto_sign_ed25519_detached(unsigned char *sig, unsigned long long *siglen_p,
                              const unsigned char *m, unsigned long long mlen,
                              const unsigned char *sk)
 {
-    return _crypto_sign_ed25519_detached(sig, siglen_p, m, mlen, sk, 0);
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = _crypto_sign_ed25519_detached(sig, siglen_p, m, mlen, sk, 0);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_SIGN, mlen);
+
+    return ret;
+}
+
+int
+crypto_sign_ed25519_sk_expand(crypto_sign_ed25519_sk_state *state,
+                              const unsigned char *sk)
+{
+    ed25519_sk_state *st = (ed25519_sk_state *) (void *) state;
+
+    COMPILER_ASSERT(sizeof *st <= sizeof *state);
+    crypto_hash_sha512(st->az, sk, 32);
+    memcpy(st->pk, sk + 32, 32);
+
+    return 0;
+}
+
+int
+crypto_sign_ed25519_detached_expanded(unsigned char *sig,
+                                      unsigned long long *siglen_p,
+                                      const unsigned char *m,
+                                      unsigned long long mlen,
+                                      const crypto_sign_ed25519_sk_state *state)
+{
+    const ed25519_sk_state *st =
+        (const ed25519_sk_state *) (const void *) state;
+    SODIUM_STATS_START(stats_start)
+
+    _crypto_sign_ed25519_detached_az(sig, m, mlen, st->az, st->pk, 0);
+    if (siglen_p != NULL) {
+        *siglen_p = 64U;
+    }
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_SIGN, mlen);
+
+    return 0;
+}
+
+typedef struct ed25519_sign_state_ {
+    unsigned char R[32];
+    unsigned char nonce[32];
+    unsigned char a[32];
+} ed25519_sign_state;
+
+int
+crypto_sign_ed25519_sign_init(crypto_sign_ed25519_sign_state *state,
+                              const unsigned char *sk)
+{
+    ed25519_sign_state *st = (ed25519_sign_state *) (void *) state->opaque;
+    unsigned char       az[64];
+    unsigned char       nonce[64];
+    ge25519_p3          R;
+
+    COMPILER_ASSERT(sizeof *st <= sizeof state->opaque);
+    crypto_hash_sha512(az, sk, 32);
+
+    /* hedged nonce: the message is not known yet, so it can't be hashed */
+    crypto_hash_sha512_init(&state->hs);
+    _crypto_sign_ed25519_synthetic_r_hv(&state->hs, nonce /* Z */, az);
+    crypto_hash_sha512_final(&state->hs, nonce);
+    sc25519_reduce(nonce);
+    memcpy(st->nonce, nonce, 32);
+    ge25519_scalarmult_base(&R, nonce);
+    ge25519_p3_tobytes(st->R, &R);
+
+    memcpy(st->a, az, 32);
+    _crypto_sign_ed25519_clamp(st->a);
+
+    _crypto_sign_ed25519_ref10_hinit(&state->hs, 0);
+    crypto_hash_sha512_update(&state->hs, st->R, 32);
+    crypto_hash_sha512_update(&state->hs, sk + 32, 32);
+
+    sodium_memzero(az, sizeof az);
+    sodium_memzero(nonce, sizeof nonce);
+
+    return 0;
+}
+
+int
+crypto_sign_ed25519_sign_update(crypto_sign_ed25519_sign_state *state,
+                                const unsigned char *m,
+                                unsigned long long mlen)
+{
+    return crypto_hash_sha512_update(&state->hs, m, mlen);
+}
+
+int
+crypto_sign_ed25519_sign_final(crypto_sign_ed25519_sign_state *state,
+                               unsigned char *sig,
+                               unsigned long long *siglen_p)
+{
+    ed25519_sign_state *st = (ed25519_sign_state *) (void *) state->opaque;
+    unsigned char       hram[64];
+
+    crypto_hash_sha512_final(&state->hs, hram);
+    sc25519_reduce(hram);
+    memcpy(sig, st->R, 32);
+    sc25519_muladd(sig + 32, hram, st->a, st->nonce);
+
+    sodium_memzero(state, sizeof *state);
+    if (siglen_p != NULL) {
+        *siglen_p = 64U;
+    }
+    return 0;
+}
+
+#define ED25519_SIGN_BATCH_CHUNK 64U
+
+typedef struct ed25519_sign_batch_ {
+    crypto_hash_sha512_state hs[ED25519_SIGN_BATCH_CHUNK];
+    unsigned char            nonce[ED25519_SIGN_BATCH_CHUNK][64];
+    unsigned char            hram[ED25519_SIGN_BATCH_CHUNK][64];
+    unsigned char            r[ED25519_SIGN_BATCH_CHUNK * 32U];
+    ge25519_p3               R[ED25519_SIGN_BATCH_CHUNK];
+} ed25519_sign_batch;
+
+/*
+ * Same as _crypto_sign_ed25519_detached_az() for every message of a chunk,
+ * with the nonce and challenge hashes computed with the multi-buffer
+ * SHA-512, and a single field inversion for all the R encodings.
+ */
+static void
+_crypto_sign_ed25519_detached_batch_chunk(unsigned char * const *sigs,
+                                          const unsigned char * const *ms,
+                                          const unsigned long long *mlens,
+                                          size_t count,
+                                          const unsigned char az[64],
+                                          const unsigned char pk[32],
+                                          ed25519_sign_batch *b)
+{
+    crypto_hash_sha512_state *hs_p[ED25519_SIGN_BATCH_CHUNK];
+    unsigned char            *h_p[ED25519_SIGN_BATCH_CHUNK];
+    unsigned char             a[32];
+    size_t                    i;
+
+    for (i = 0U; i < count; i++) {
+        _crypto_sign_ed25519_ref10_hinit(&b->hs[i], 0);
+#ifdef ED25519_NONDETERMINISTIC
+        _crypto_sign_ed25519_synthetic_r_hv(&b->hs[i], b->nonce[i] /* Z */,
+                                            az);
+#else
+        crypto_hash_sha512_update(&b->hs[i], az + 32, 32);
+#endif
+        hs_p[i] = &b->hs[i];
+        h_p[i]  = b->nonce[i];
+    }
+    _crypto_hash_sha512_final_multi(hs_p, h_p, ms, mlens, count);
+
+    for (i = 0U; i < count; i++) {
+        sc25519_reduce(b->nonce[i]);
+        ge25519_scalarmult_base(&b->R[i], b->nonce[i]);
+    }
+    ge25519_p3_tobytes_batch(b->r, b->R, count);
+
+    for (i = 0U; i < count; i++) {
+        memcpy(sigs[i], &b->r[i * 32U], 32);
+        memmove(sigs[i] + 32, pk, 32);
+        _crypto_sign_ed25519_ref10_hinit(&b->hs[i], 0);
+        crypto_hash_sha512_update(&b->hs[i], sigs[i], 64);
+        h_p[i] = b->hram[i];
+    }
+    _crypto_hash_sha512_final_multi(hs_p, h_p, ms, mlens, count);
+
+    memcpy(a, az, 32);
+    _crypto_sign_ed25519_clamp(a);
+    for (i = 0U; i < count; i++) {
+        sc25519_reduce(b->hram[i]);
+        sc25519_muladd(sigs[i] + 32, b->hram[i], a, b->nonce[i]);
+    }
+    sodium_memzero(a, sizeof a);
+}
+
+int
+crypto_sign_ed25519_detached_batch(unsigned char * const *sigs,
+                                   const unsigned char * const *ms,
+                                   const unsigned long long *mlens,
+                                   size_t count, const unsigned char *sk)
+{
+    ed25519_sign_batch *b;
+    unsigned char       az[64];
+    size_t              chunk;
+    size_t              i;
+    size_t              j;
+
+    crypto_hash_sha512(az, sk, 32);
+    b = (ed25519_sign_batch *) malloc(sizeof *b);
+    for (i = 0U; i < count; i += chunk) {
+        chunk = count - i;
+        if (chunk > ED25519_SIGN_BATCH_CHUNK) {
+            chunk = ED25519_SIGN_BATCH_CHUNK;
+        }
+        if (b != NULL) {
+            _crypto_sign_ed25519_detached_batch_chunk
+                (&sigs[i], &ms[i], &mlens[i], chunk, az, sk + 32, b);
+        } else {
+            for (j = 0U; j < chunk; j++) {
+                _crypto_sign_ed25519_detached_az(sigs[i + j], ms[i + j],
+                                                 mlens[i + j], az, sk + 32, 0);
+            }
+        }
+    }
+    if (b != NULL) {
+        sodium_memzero(b, sizeof *b);
+        free(b);
+    }
+    sodium_memzero(az, sizeof az);
+
+    return 0;
 }
 
 int
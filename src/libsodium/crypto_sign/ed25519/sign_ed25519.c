@@ -11,6 +11,30 @@ crypto_sign_ed25519ph_statebytes(void)
     return sizeof(crypto_sign_ed25519ph_state);
 }
 
+size_t
+crypto_sign_ed25519_verify_statebytes(void)
+{
+    return sizeof(crypto_sign_ed25519_verify_state);
+}
+
+size_t
+crypto_sign_ed25519_sign_statebytes(void)
+{
+    return sizeof(crypto_sign_ed25519_sign_state);
+}
+
+size_t
+crypto_sign_ed25519_pk_statebytes(void)
+{
+    return sizeof(crypto_sign_ed25519_pk_state);
+}
+
+size_t
+crypto_sign_ed25519_sk_statebytes(void)
+{
+    return sizeof(crypto_sign_ed25519_sk_state);
+}
+
 size_t
 crypto_sign_ed25519_bytes(void)
 {
@@ -0,0 +1,250 @@
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+# include <pthread.h>
+# define VERIFYCACHE_HAVE_THREADS
+#endif
+
+#include "core.h"
+#include "crypto_shorthash_siphash24.h"
+#include "crypto_sign_ed25519.h"
+#include "private/common.h"
+#include "randombytes.h"
+#include "utils.h"
+
+#define VERIFYCACHE_WAYS         4U
+#define VERIFYCACHE_CAPACITY_MAX (1U << 24)
+#define VERIFYCACHE_MLEN_MAX     (1U << 16)
+
+/*
+ * Entries are stored in sets of VERIFYCACHE_WAYS, selected by a SipHash of
+ * the (public key, signature, message) triple computed with a random key,
+ * so that the set of an entry cannot be predicted. A tag match is only a
+ * hint: the whole triple is compared before reporting a hit. Only valid
+ * signatures are cached. Once a set is full, its entries are replaced in
+ * round-robin order.
+ *
+ * Each entry is: [verifycache_entry][message (mlen_max)]
+ */
+
+typedef struct verifycache_entry {
+    uint64_t      tag;
+    size_t        mlen;
+    unsigned char pk[crypto_sign_ed25519_PUBLICKEYBYTES];
+    unsigned char sig[crypto_sign_ed25519_BYTES];
+    unsigned char used;
+} verifycache_entry;
+
+struct crypto_sign_ed25519_verifycache {
+#ifdef VERIFYCACHE_HAVE_THREADS
+    pthread_mutex_t mutex;
+#endif
+    unsigned char  *entries;
+    unsigned char  *cursors;
+    size_t          sets_count;
+    size_t          entry_size;
+    size_t          mlen_max;
+    unsigned char   key[crypto_shorthash_siphash24_KEYBYTES];
+};
+
+static void
+_verifycache_lock(crypto_sign_ed25519_verifycache *cache)
+{
+#ifdef VERIFYCACHE_HAVE_THREADS
+    if (pthread_mutex_lock(&cache->mutex) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+#else
+    (void) cache;
+#endif
+}
+
+static void
+_verifycache_unlock(crypto_sign_ed25519_verifycache *cache)
+{
+#ifdef VERIFYCACHE_HAVE_THREADS
+    if (pthread_mutex_unlock(&cache->mutex) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+#else
+    (void) cache;
+#endif
+}
+
+static uint64_t
+_verifycache_tag(const crypto_sign_ed25519_verifycache *cache,
+                 const unsigned char *sig, const unsigned char *m,
+                 unsigned long long mlen, const unsigned char *pk)
+{
+    unsigned char in[crypto_sign_ed25519_PUBLICKEYBYTES +
+                     crypto_sign_ed25519_BYTES +
+                     crypto_shorthash_siphash24_BYTES];
+    unsigned char tag[crypto_shorthash_siphash24_BYTES];
+
+    crypto_shorthash_siphash24(in + crypto_sign_ed25519_PUBLICKEYBYTES +
+                               crypto_sign_ed25519_BYTES, m, mlen, cache->key);
+    memcpy(in, pk, crypto_sign_ed25519_PUBLICKEYBYTES);
+    memcpy(in + crypto_sign_ed25519_PUBLICKEYBYTES, sig,
+           crypto_sign_ed25519_BYTES);
+    crypto_shorthash_siphash24(tag, in, sizeof in, cache->key);
+
+    return LOAD64_LE(tag);
+}
+
+static verifycache_entry *
+_verifycache_entry(const crypto_sign_ed25519_verifycache *cache, size_t set,
+                   size_t way)
+{
+    return (verifycache_entry *) (void *)
+        (cache->entries + (set * VERIFYCACHE_WAYS + way) * cache->entry_size);
+}
+
+static int
+_verifycache_match(const verifycache_entry *entry, uint64_t tag,
+                   const unsigned char *sig, const unsigned char *m,
+                   unsigned long long mlen, const unsigned char *pk)
+{
+    return entry->used && entry->tag == tag && entry->mlen == mlen &&
+        memcmp(entry->pk, pk, sizeof entry->pk) == 0 &&
+        memcmp(entry->sig, sig, sizeof entry->sig) == 0 &&
+        (mlen == 0U ||
+         memcmp((const unsigned char *) (entry + 1), m, (size_t) mlen) == 0);
+}
+
+static int
+_verifycache_find(const crypto_sign_ed25519_verifycache *cache, size_t set,
+                  uint64_t tag, const unsigned char *sig,
+                  const unsigned char *m, unsigned long long mlen,
+                  const unsigned char *pk)
+{
+    size_t way;
+
+    for (way = 0U; way < VERIFYCACHE_WAYS; way++) {
+        if (_verifycache_match(_verifycache_entry(cache, set, way), tag,
+                               sig, m, mlen, pk)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+crypto_sign_ed25519_verifycache *
+crypto_sign_ed25519_verifycache_create(size_t capacity, size_t mlen_max)
+{
+    crypto_sign_ed25519_verifycache *cache;
+    size_t                           sets_count;
+
+    if (capacity <= 0U || capacity > VERIFYCACHE_CAPACITY_MAX ||
+        mlen_max > VERIFYCACHE_MLEN_MAX) {
+        errno = EINVAL;
+        return NULL;
+    }
+    sets_count = 1U;
+    while (sets_count * VERIFYCACHE_WAYS < capacity) {
+        sets_count <<= 1;
+    }
+    if ((cache = (crypto_sign_ed25519_verifycache *)
+         calloc(1U, sizeof *cache)) == NULL) {
+        return NULL;
+    }
+    cache->entry_size = (sizeof(verifycache_entry) + mlen_max + 7U) &
+        ~(size_t) 7U;
+    cache->sets_count = sets_count;
+    cache->mlen_max   = mlen_max;
+    if ((cache->entries = (unsigned char *)
+         calloc(sets_count * VERIFYCACHE_WAYS, cache->entry_size)) == NULL ||
+        (cache->cursors = (unsigned char *) calloc(sets_count, 1U)) == NULL) {
+        free(cache->entries);
+        free(cache);
+        errno = ENOMEM;
+        return NULL;
+    }
+#ifdef VERIFYCACHE_HAVE_THREADS
+    if (pthread_mutex_init(&cache->mutex, NULL) != 0) {
+        free(cache->cursors); /* LCOV_EXCL_LINE */
+        free(cache->entries); /* LCOV_EXCL_LINE */
+        free(cache); /* LCOV_EXCL_LINE */
+        errno = ENOMEM; /* LCOV_EXCL_LINE */
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+#endif
+    randombytes_buf(cache->key, sizeof cache->key);
+
+    return cache;
+}
+
+void
+crypto_sign_ed25519_verifycache_destroy(crypto_sign_ed25519_verifycache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+#ifdef VERIFYCACHE_HAVE_THREADS
+    (void) pthread_mutex_destroy(&cache->mutex);
+#endif
+    free(cache->cursors);
+    free(cache->entries);
+    sodium_memzero(cache, sizeof *cache);
+    free(cache);
+}
+
+int
+crypto_sign_ed25519_verify_detached_cached(crypto_sign_ed25519_verifycache *cache,
+                                           const unsigned char *sig,
+                                           const unsigned char *m,
+                                           unsigned long long mlen,
+                                           const unsigned char *pk)
+{
+    verifycache_entry *entry;
+    uint64_t           tag;
+    size_t             set;
+    size_t             way;
+    int                found;
+
+    if (cache == NULL || mlen > cache->mlen_max) {
+        return crypto_sign_ed25519_verify_detached(sig, m, mlen, pk);
+    }
+    tag = _verifycache_tag(cache, sig, m, mlen, pk);
+    set = (size_t) (tag & (uint64_t) (cache->sets_count - 1U));
+
+    _verifycache_lock(cache);
+    found = _verifycache_find(cache, set, tag, sig, m, mlen, pk);
+    _verifycache_unlock(cache);
+    if (found) {
+        return 0;
+    }
+    if (crypto_sign_ed25519_verify_detached(sig, m, mlen, pk) != 0) {
+        return -1;
+    }
+
+    _verifycache_lock(cache);
+    if (_verifycache_find(cache, set, tag, sig, m, mlen, pk) == 0) {
+        for (way = 0U; way < VERIFYCACHE_WAYS; way++) {
+            if (!_verifycache_entry(cache, set, way)->used) {
+                break;
+            }
+        }
+        if (way == VERIFYCACHE_WAYS) {
+            way = cache->cursors[set];
+            cache->cursors[set] =
+                (unsigned char) ((way + 1U) % VERIFYCACHE_WAYS);
+        }
+        entry = _verifycache_entry(cache, set, way);
+        entry->tag  = tag;
+        entry->mlen = (size_t) mlen;
+        memcpy(entry->pk, pk, sizeof entry->pk);
+        memcpy(entry->sig, sig, sizeof entry->sig);
+        if (mlen > 0U) {
+            memcpy((unsigned char *) (entry + 1), m, (size_t) mlen);
+        }
+        entry->used = 1;
+    }
+    _verifycache_unlock(cache);
+
+    return 0;
+}
@@ -0,0 +1,326 @@
+/*
+ * AES256-CTR using AES-NI.
+ * 8 counter blocks are encrypted in parallel, so that the latency of AESENC
+ * is hidden. The 128-bit big-endian counter is kept as two native words.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_stream_aes256ctr.h"
+#include "export.h"
+#include "private/common.h"
+#include "private/sse2_64_32.h"
+#include "randombytes.h"
+#include "runtime.h"
+#include "utils.h"
+
+#if defined(HAVE_TMMINTRIN_H) && defined(HAVE_WMMINTRIN_H)
+
+#ifdef __GNUC__
+#pragma GCC target("ssse3")
+#pragma GCC target("aes")
+#endif
+
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+
+#define ROUNDS    14
+#define PARBLOCKS 8
+
+typedef struct aes256ctr_state {
+    __m128i rkeys[ROUNDS + 1];
+} aes256ctr_state;
+
+static inline void
+aesni_key256_expand(const unsigned char *key, __m128i *const rkeys)
+{
+    __m128i X0, X1, X2, X3;
+    int     i = 0;
+
+    X0         = _mm_loadu_si128((const __m128i *) &key[0]);
+    rkeys[i++] = X0;
+
+    X2         = _mm_loadu_si128((const __m128i *) &key[16]);
+    rkeys[i++] = X2;
+
+#define EXPAND_KEY_1(S)                                                                          \
+    do {                                                                                         \
+        X1 = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(X2, (S)), 0xff);                        \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X0), 0x10)); \
+        X0 = _mm_xor_si128(X0, X3);                                                              \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X0), 0x8c)); \
+        X0 = _mm_xor_si128(_mm_xor_si128(X0, X3), X1);                                           \
+        rkeys[i++] = X0;                                                                         \
+    } while (0)
+
+#define EXPAND_KEY_2(S)                                                                          \
+    do {                                                                                         \
+        X1 = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(X0, (S)), 0xaa);                        \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X2), 0x10)); \
+        X2 = _mm_xor_si128(X2, X3);                                                              \
+        X3 = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(X3), _mm_castsi128_ps(X2), 0x8c)); \
+        X2 = _mm_xor_si128(_mm_xor_si128(X2, X3), X1);                                           \
+        rkeys[i++] = X2;                                                                         \
+    } while (0)
+
+    X3 = _mm_setzero_si128();
+    EXPAND_KEY_1(0x01);
+    EXPAND_KEY_2(0x01);
+    EXPAND_KEY_1(0x02);
+    EXPAND_KEY_2(0x02);
+    EXPAND_KEY_1(0x04);
+    EXPAND_KEY_2(0x04);
+    EXPAND_KEY_1(0x08);
+    EXPAND_KEY_2(0x08);
+    EXPAND_KEY_1(0x10);
+    EXPAND_KEY_2(0x10);
+    EXPAND_KEY_1(0x20);
+    EXPAND_KEY_2(0x20);
+    EXPAND_KEY_1(0x40);
+
+#undef EXPAND_KEY_1
+#undef EXPAND_KEY_2
+}
+
+static inline __m128i
+aesni_encrypt1(__m128i b, const __m128i *const rkeys)
+{
+    int i;
+
+    b = _mm_xor_si128(b, rkeys[0]);
+    for (i = 1; i < ROUNDS; i++) {
+        b = _mm_aesenc_si128(b, rkeys[i]);
+    }
+    return _mm_aesenclast_si128(b, rkeys[ROUNDS]);
+}
+
+/* counter block for (hi:lo), in big-endian byte order */
+static inline __m128i
+ctr_block(const uint64_t hi, const uint64_t lo)
+{
+    const __m128i rev = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    return _mm_shuffle_epi8(_mm_set_epi64x((long long) hi, (long long) lo), rev);
+}
+
+static inline void
+aesni_encrypt8(__m128i b[PARBLOCKS], uint64_t *const hi, uint64_t *const lo,
+               const __m128i *const rkeys)
+{
+    __m128i rk;
+    size_t  i, j;
+
+    rk = rkeys[0];
+    for (j = 0; j < PARBLOCKS; j++) {
+        b[j] = _mm_xor_si128(ctr_block(*hi, *lo), rk);
+        *hi += (uint64_t) (++*lo == 0U);
+    }
+    for (i = 1; i < ROUNDS; i++) {
+        rk = rkeys[i];
+        for (j = 0; j < PARBLOCKS; j++) {
+            b[j] = _mm_aesenc_si128(b[j], rk);
+        }
+    }
+    rk = rkeys[ROUNDS];
+    for (j = 0; j < PARBLOCKS; j++) {
+        b[j] = _mm_aesenclast_si128(b[j], rk);
+    }
+}
+
+static void
+aes256ctr_xor(unsigned char *c, const unsigned char *m, unsigned long long mlen,
+              const unsigned char *n, uint64_t ic, const __m128i *const rkeys)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    __m128i                        b[PARBLOCKS];
+    uint64_t                       hi = LOAD64_BE(n);
+    uint64_t                       lo = LOAD64_BE(n + 8);
+    size_t                         j;
+
+    lo += ic;
+    hi += (uint64_t) (lo < ic);
+
+    for (; mlen >= PARBLOCKS * 16; mlen -= PARBLOCKS * 16, m += PARBLOCKS * 16,
+                                   c += PARBLOCKS * 16) {
+        aesni_encrypt8(b, &hi, &lo, rkeys);
+        for (j = 0; j < PARBLOCKS; j++) {
+            _mm_storeu_si128((__m128i *) (void *) (c + 16 * j),
+                             _mm_xor_si128(b[j], _mm_loadu_si128((const __m128i *) (const void *)
+                                                                     (m + 16 * j))));
+        }
+    }
+    for (; mlen >= 16; mlen -= 16, m += 16, c += 16) {
+        b[0] = aesni_encrypt1(ctr_block(hi, lo), rkeys);
+        hi += (uint64_t) (++lo == 0U);
+        _mm_storeu_si128((__m128i *) (void *) c,
+                         _mm_xor_si128(b[0], _mm_loadu_si128((const __m128i *) (const void *) m)));
+    }
+    if (mlen > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, m, (size_t) mlen);
+        b[0] = aesni_encrypt1(ctr_block(hi, lo), rkeys);
+        _mm_store_si128((__m128i *) (void *) pad,
+                        _mm_xor_si128(b[0], _mm_load_si128((const __m128i *) (const void *) pad)));
+        memcpy(c, pad, (size_t) mlen);
+        sodium_memzero(pad, sizeof pad);
+    }
+    sodium_memzero(b, sizeof b);
+}
+
+int
+crypto_stream_aes256ctr_beforenm(crypto_stream_aes256ctr_state *st_, const unsigned char *k)
+{
+    aes256ctr_state *st = (aes256ctr_state *) (void *) st_;
+
+    COMPILER_ASSERT(sizeof *st_ >= sizeof *st);
+    aesni_key256_expand(k, st->rkeys);
+
+    return 0;
+}
+
+int
+crypto_stream_aes256ctr_xor_ic_afternm(unsigned char *c, const unsigned char *m,
+                                       unsigned long long mlen, const unsigned char *n,
+                                       uint64_t ic, const crypto_stream_aes256ctr_state *st_)
+{
+    const aes256ctr_state *st = (const aes256ctr_state *) (const void *) st_;
+
+    if (mlen > crypto_stream_aes256ctr_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    aes256ctr_xor(c, m, mlen, n, ic, st->rkeys);
+
+    return 0;
+}
+
+int
+crypto_stream_aes256ctr_block_afternm(unsigned char *out, const unsigned char *in,
+                                      const crypto_stream_aes256ctr_state *st_)
+{
+    const aes256ctr_state *st = (const aes256ctr_state *) (const void *) st_;
+
+    _mm_storeu_si128((__m128i *) (void *) out,
+                     aesni_encrypt1(_mm_loadu_si128((const __m128i *) (const void *) in),
+                                    st->rkeys));
+    return 0;
+}
+
+int
+crypto_stream_aes256ctr_is_available(void)
+{
+    return sodium_runtime_has_aesni();
+}
+
+#elif !(defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN))
+
+#ifndef ENOSYS
+#define ENOSYS ENXIO
+#endif
+
+int
+crypto_stream_aes256ctr_beforenm(crypto_stream_aes256ctr_state *st_, const unsigned char *k)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int
+crypto_stream_aes256ctr_xor_ic_afternm(unsigned char *c, const unsigned char *m,
+                                       unsigned long long mlen, const unsigned char *n,
+                                       uint64_t ic, const crypto_stream_aes256ctr_state *st_)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int
+crypto_stream_aes256ctr_block_afternm(unsigned char *out, const unsigned char *in,
+                                      const crypto_stream_aes256ctr_state *st_)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+int
+crypto_stream_aes256ctr_is_available(void)
+{
+    return 0;
+}
+
+#endif
+
+int
+crypto_stream_aes256ctr_xor_ic(unsigned char *c, const unsigned char *m,
+                               unsigned long long mlen, const unsigned char *n, uint64_t ic,
+                               const unsigned char *k)
+{
+    crypto_stream_aes256ctr_state st;
+    int                           ret;
+
+    if ((ret = crypto_stream_aes256ctr_beforenm(&st, k)) == 0) {
+        ret = crypto_stream_aes256ctr_xor_ic_afternm(c, m, mlen, n, ic, &st);
+    }
+    sodium_memzero(&st, sizeof st);
+
+    return ret;
+}
+
+int
+crypto_stream_aes256ctr_xor(unsigned char *c, const unsigned char *m,
+                            unsigned long long mlen, const unsigned char *n,
+                            const unsigned char *k)
+{
+    return crypto_stream_aes256ctr_xor_ic(c, m, mlen, n, 0U, k);
+}
+
+int
+crypto_stream_aes256ctr(unsigned char *c, unsigned long long clen,
+                        const unsigned char *n, const unsigned char *k)
+{
+    if (clen > crypto_stream_aes256ctr_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    memset(c, 0, (size_t) clen);
+
+    return crypto_stream_aes256ctr_xor_ic(c, c, clen, n, 0U, k);
+}
+
+size_t
+crypto_stream_aes256ctr_keybytes(void)
+{
+    return crypto_stream_aes256ctr_KEYBYTES;
+}
+
+size_t
+crypto_stream_aes256ctr_noncebytes(void)
+{
+    return crypto_stream_aes256ctr_NONCEBYTES;
+}
+
+size_t
+crypto_stream_aes256ctr_blockbytes(void)
+{
+    return crypto_stream_aes256ctr_BLOCKBYTES;
+}
+
+size_t
+crypto_stream_aes256ctr_messagebytes_max(void)
+{
+    return crypto_stream_aes256ctr_MESSAGEBYTES_MAX;
+}
+
+size_t
+crypto_stream_aes256ctr_statebytes(void)
+{
+    return sizeof(crypto_stream_aes256ctr_state);
+}
+
+void
+crypto_stream_aes256ctr_keygen(unsigned char k[crypto_stream_aes256ctr_KEYBYTES])
+{
+    randombytes_buf(k, crypto_stream_aes256ctr_KEYBYTES);
+}
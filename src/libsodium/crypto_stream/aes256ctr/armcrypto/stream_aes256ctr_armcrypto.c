@@ -0,0 +1,181 @@
+/*
+ * AES256-CTR using the ARMv8 Crypto Extensions, 8 blocks at a time.
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_stream_aes256ctr.h"
+#include "export.h"
+#include "private/common.h"
+#include "runtime.h"
+#include "utils.h"
+
+#if defined(HAVE_ARMCRYPTO) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <arm_neon.h>
+
+# define ROUNDS 14
+
+typedef struct aes256ctr_state {
+    uint8x16_t rkeys[ROUNDS + 1];
+} aes256ctr_state;
+
+# define MAKE8(X) \
+    X(0);         \
+    X(1);         \
+    X(2);         \
+    X(3);         \
+    X(4);         \
+    X(5);         \
+    X(6);         \
+    X(7)
+
+static inline uint32_t
+aes_subword(const uint32_t w)
+{
+    uint8x16_t v;
+
+    /* ShiftRows is a no-op when all the columns are identical */
+    v = vaeseq_u8(vreinterpretq_u8_u32(vdupq_n_u32(w)), vmovq_n_u8(0));
+
+    return vgetq_lane_u32(vreinterpretq_u32_u8(v), 0);
+}
+
+static void
+aes256_key_expand(uint8x16_t *const rkeys, const unsigned char *key)
+{
+    uint32_t w[4 * (ROUNDS + 1)];
+    uint32_t rcon = 0x01;
+    uint32_t t;
+    size_t   i;
+
+    for (i = 0; i < 8; i++) {
+        w[i] = LOAD32_LE(key + 4 * i);
+    }
+    for (i = 8; i < 4 * (ROUNDS + 1); i++) {
+        t = w[i - 1];
+        if ((i & 7) == 0) {
+            t = ROTR32(aes_subword(t), 8) ^ rcon;
+            rcon <<= 1;
+        } else if ((i & 7) == 4) {
+            t = aes_subword(t);
+        }
+        w[i] = w[i - 8] ^ t;
+    }
+    for (i = 0; i < ROUNDS + 1; i++) {
+        rkeys[i] = vld1q_u8((const uint8_t *) (const void *) &w[4 * i]);
+    }
+    sodium_memzero(w, sizeof w);
+}
+
+static inline uint8x16_t
+aes_encrypt1(uint8x16_t b, const uint8x16_t *const rkeys)
+{
+    int i;
+
+    for (i = 0; i < ROUNDS - 1; i++) {
+        b = vaesmcq_u8(vaeseq_u8(b, rkeys[i]));
+    }
+    return veorq_u8(vaeseq_u8(b, rkeys[ROUNDS - 1]), rkeys[ROUNDS]);
+}
+
+/* counter block for (hi:lo), in big-endian byte order */
+static inline uint8x16_t
+ctr_block(const uint64_t hi, const uint64_t lo)
+{
+    return vrev64q_u8(vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(hi), vcreate_u64(lo))));
+}
+
+# define CTRx(a)                       \
+    b##a = ctr_block(hi, lo);          \
+    hi += (uint64_t) (++lo == 0U)
+# define ROUNDx(a) b##a = vaesmcq_u8(vaeseq_u8(b##a, rk))
+# define LASTx(a)  b##a = veorq_u8(vaeseq_u8(b##a, rkeys[ROUNDS - 1]), rkeys[ROUNDS])
+# define XORx(a)   vst1q_u8(c + 16 * a, veorq_u8(b##a, vld1q_u8(m + 16 * a)))
+
+static void
+aes256ctr_xor(unsigned char *c, const unsigned char *m, unsigned long long mlen,
+              const unsigned char *n, uint64_t ic, const uint8x16_t *const rkeys)
+{
+    CRYPTO_ALIGN(16) unsigned char pad[16];
+    uint8x16_t                     b0, b1, b2, b3, b4, b5, b6, b7;
+    uint8x16_t                     rk;
+    uint64_t                       hi = LOAD64_BE(n);
+    uint64_t                       lo = LOAD64_BE(n + 8);
+    int                            i;
+
+    lo += ic;
+    hi += (uint64_t) (lo < ic);
+
+    for (; mlen >= 8 * 16; mlen -= 8 * 16, m += 8 * 16, c += 8 * 16) {
+        MAKE8(CTRx);
+        for (i = 0; i < ROUNDS - 1; i++) {
+            rk = rkeys[i];
+            MAKE8(ROUNDx);
+        }
+        MAKE8(LASTx);
+        MAKE8(XORx);
+    }
+    for (; mlen >= 16; mlen -= 16, m += 16, c += 16) {
+        CTRx(0);
+        b0 = aes_encrypt1(b0, rkeys);
+        XORx(0);
+    }
+    if (mlen > 0) {
+        memset(pad, 0, sizeof pad);
+        memcpy(pad, m, (size_t) mlen);
+        b0 = aes_encrypt1(ctr_block(hi, lo), rkeys);
+        vst1q_u8(pad, veorq_u8(b0, vld1q_u8(pad)));
+        memcpy(c, pad, (size_t) mlen);
+        sodium_memzero(pad, sizeof pad);
+    }
+}
+
+int
+crypto_stream_aes256ctr_beforenm(crypto_stream_aes256ctr_state *st_, const unsigned char *k)
+{
+    aes256ctr_state *st = (aes256ctr_state *) (void *) st_;
+
+    COMPILER_ASSERT(sizeof *st_ >= sizeof *st);
+    aes256_key_expand(st->rkeys, k);
+
+    return 0;
+}
+
+int
+crypto_stream_aes256ctr_xor_ic_afternm(unsigned char *c, const unsigned char *m,
+                                       unsigned long long mlen, const unsigned char *n,
+                                       uint64_t ic, const crypto_stream_aes256ctr_state *st_)
+{
+    const aes256ctr_state *st = (const aes256ctr_state *) (const void *) st_;
+
+    if (mlen > crypto_stream_aes256ctr_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    aes256ctr_xor(c, m, mlen, n, ic, st->rkeys);
+
+    return 0;
+}
+
+int
+crypto_stream_aes256ctr_block_afternm(unsigned char *out, const unsigned char *in,
+                                      const crypto_stream_aes256ctr_state *st_)
+{
+    const aes256ctr_state *st = (const aes256ctr_state *) (const void *) st_;
+
+    vst1q_u8(out, aes_encrypt1(vld1q_u8(in), st->rkeys));
+
+    return 0;
+}
+
+int
+crypto_stream_aes256ctr_is_available(void)
+{
+    return sodium_runtime_has_armcrypto();
+}
+
+#endif
@@ -70,7 +70,7 @@ chacha_ietf_ivsetup(chacha_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
 
 static void
 chacha20_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
-                       unsigned long long bytes)
+                       unsigned long long bytes, const int rounds)
 {
     uint32_t * const x = &ctx->input[0];
 
@@ -79,6 +79,7 @@ chacha20_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
     }
 # include "u8.h"
 # include "u4.h"
+# include "u2.h"
 # include "u1.h"
 # include "u0.h"
 }
@@ -96,7 +97,7 @@ stream_ref(unsigned char *c, unsigned long long clen, const unsigned char *n,
     chacha_keysetup(&ctx, k);
     chacha_ivsetup(&ctx, n, NULL);
     memset(c, 0, clen);
-    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -115,7 +116,7 @@ stream_ietf_ext_ref(unsigned char *c, unsigned long long clen,
     chacha_keysetup(&ctx, k);
     chacha_ietf_ivsetup(&ctx, n, NULL);
     memset(c, 0, clen);
-    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -140,7 +141,7 @@ stream_ref_xor_ic(unsigned char *c, const unsigned char *m,
     STORE32_LE(&ic_bytes[4], ic_high);
     chacha_keysetup(&ctx, k);
     chacha_ivsetup(&ctx, n, ic_bytes);
-    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -160,7 +161,113 @@ stream_ietf_ext_ref_xor_ic(unsigned char *c, const unsigned char *m,
     STORE32_LE(ic_bytes, ic);
     chacha_keysetup(&ctx, k);
     chacha_ietf_ivsetup(&ctx, n, ic_bytes);
-    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, 20);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+/*
+ * One block for each of 8 independent states, given word-sliced
+ * (x[word][lane]). The block of lane i is stored at ks + 64 * i.
+ */
+void
+crypto_stream_chacha20_dolbeau_avx2_blocks8(unsigned char  *ks,
+                                            const uint32_t  x[16][8])
+{
+    const __m256i rot16 =
+        _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8 =
+        _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+    __m256i       v[16];
+    __m256i       t0, t1, t2, t3;
+    int           i;
+
+    for (i = 0; i < 16; i++) {
+        v[i] = _mm256_loadu_si256((const __m256i *) (const void *) x[i]);
+    }
+
+# define M8_ROT(A, IMM) \
+    _mm256_or_si256(_mm256_slli_epi32(A, IMM), _mm256_srli_epi32(A, (32 - IMM)))
+# define M8_QUARTERROUND(A, B, C, D)                                   \
+    v[A] = _mm256_add_epi32(v[A], v[B]);                              \
+    v[D] = _mm256_shuffle_epi8(_mm256_xor_si256(v[D], v[A]), rot16); \
+    v[C] = _mm256_add_epi32(v[C], v[D]);                              \
+    v[B] = M8_ROT(_mm256_xor_si256(v[B], v[C]), 12);                  \
+    v[A] = _mm256_add_epi32(v[A], v[B]);                              \
+    v[D] = _mm256_shuffle_epi8(_mm256_xor_si256(v[D], v[A]), rot8);  \
+    v[C] = _mm256_add_epi32(v[C], v[D]);                              \
+    v[B] = M8_ROT(_mm256_xor_si256(v[B], v[C]), 7)
+
+    for (i = 0; i < ROUNDS; i += 2) {
+        M8_QUARTERROUND(0, 4, 8, 12);
+        M8_QUARTERROUND(1, 5, 9, 13);
+        M8_QUARTERROUND(2, 6, 10, 14);
+        M8_QUARTERROUND(3, 7, 11, 15);
+        M8_QUARTERROUND(0, 5, 10, 15);
+        M8_QUARTERROUND(1, 6, 11, 12);
+        M8_QUARTERROUND(2, 7, 8, 13);
+        M8_QUARTERROUND(3, 4, 9, 14);
+    }
+    for (i = 0; i < 16; i++) {
+        v[i] = _mm256_add_epi32(
+            v[i], _mm256_loadu_si256((const __m256i *) (const void *) x[i]));
+    }
+
+    /* after this, v[A + j] holds words A..A+3 of lanes j and j + 4 */
+# define M8_TRANSPOSE(A)                                       \
+    t0       = _mm256_unpacklo_epi32(v[A], v[A + 1]);          \
+    t1       = _mm256_unpacklo_epi32(v[A + 2], v[A + 3]);      \
+    t2       = _mm256_unpackhi_epi32(v[A], v[A + 1]);          \
+    t3       = _mm256_unpackhi_epi32(v[A + 2], v[A + 3]);      \
+    v[A]     = _mm256_unpacklo_epi64(t0, t1);                  \
+    v[A + 1] = _mm256_unpackhi_epi64(t0, t1);                  \
+    v[A + 2] = _mm256_unpacklo_epi64(t2, t3);                  \
+    v[A + 3] = _mm256_unpackhi_epi64(t2, t3)
+
+    M8_TRANSPOSE(0);
+    M8_TRANSPOSE(4);
+    M8_TRANSPOSE(8);
+    M8_TRANSPOSE(12);
+
+    for (i = 0; i < 4; i++) {
+        _mm256_storeu_si256((__m256i *) (void *) (ks + 64 * i),
+                            _mm256_permute2x128_si256(v[i], v[4 + i], 0x20));
+        _mm256_storeu_si256((__m256i *) (void *) (ks + 64 * i + 32),
+                            _mm256_permute2x128_si256(v[8 + i], v[12 + i], 0x20));
+        _mm256_storeu_si256((__m256i *) (void *) (ks + 64 * (i + 4)),
+                            _mm256_permute2x128_si256(v[i], v[4 + i], 0x31));
+        _mm256_storeu_si256((__m256i *) (void *) (ks + 64 * (i + 4) + 32),
+                            _mm256_permute2x128_si256(v[8 + i], v[12 + i], 0x31));
+    }
+
+# undef M8_ROT
+# undef M8_QUARTERROUND
+# undef M8_TRANSPOSE
+}
+
+static int
+stream_ref_rounds_xor_ic(unsigned char *c, const unsigned char *m,
+                         unsigned long long mlen, const unsigned char *n,
+                         uint64_t ic, const unsigned char *k, int rounds)
+{
+    struct chacha_ctx ctx;
+    uint8_t           ic_bytes[8];
+    uint32_t          ic_high;
+    uint32_t          ic_low;
+
+    if (!mlen) {
+        return 0;
+    }
+    ic_high = (uint32_t) (ic >> 32);
+    ic_low  = (uint32_t) ic;
+    STORE32_LE(&ic_bytes[0], ic_low);
+    STORE32_LE(&ic_bytes[4], ic_high);
+    chacha_keysetup(&ctx, k);
+    chacha_ivsetup(&ctx, n, ic_bytes);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, rounds);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -171,7 +278,9 @@ struct crypto_stream_chacha20_implementation
         SODIUM_C99(.stream =) stream_ref,
         SODIUM_C99(.stream_ietf_ext =) stream_ietf_ext_ref,
         SODIUM_C99(.stream_xor_ic =) stream_ref_xor_ic,
-        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic
+        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic,
+        SODIUM_C99(.blocks8 =) crypto_stream_chacha20_dolbeau_avx2_blocks8,
+        SODIUM_C99(.stream_rounds_xor_ic =) stream_ref_rounds_xor_ic
     };
 
 #endif
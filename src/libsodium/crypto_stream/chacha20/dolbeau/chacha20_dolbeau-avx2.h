@@ -6,3 +6,6 @@
 
 extern struct crypto_stream_chacha20_implementation
     crypto_stream_chacha20_dolbeau_avx2_implementation;
+
+void crypto_stream_chacha20_dolbeau_avx2_blocks8(unsigned char  *ks,
+                                                 const uint32_t  x[16][8]);
@@ -22,7 +22,6 @@
 # include "../stream_chacha20.h"
 # include "chacha20_dolbeau-ssse3.h"
 
-# define ROUNDS 20
 
 typedef struct chacha_ctx {
     uint32_t input[16];
@@ -65,7 +64,7 @@ chacha_ietf_ivsetup(chacha_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
 
 static void
 chacha20_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
-                       unsigned long long bytes)
+                       unsigned long long bytes, const int rounds)
 {
     uint32_t * const x = &ctx->input[0];
 
@@ -90,7 +89,7 @@ stream_ref(unsigned char *c, unsigned long long clen, const unsigned char *n,
     chacha_keysetup(&ctx, k);
     chacha_ivsetup(&ctx, n, NULL);
     memset(c, 0, clen);
-    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -109,7 +108,7 @@ stream_ietf_ext_ref(unsigned char *c, unsigned long long clen,
     chacha_keysetup(&ctx, k);
     chacha_ietf_ivsetup(&ctx, n, NULL);
     memset(c, 0, clen);
-    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -134,7 +133,7 @@ stream_ref_xor_ic(unsigned char *c, const unsigned char *m,
     STORE32_LE(&ic_bytes[4], ic_high);
     chacha_keysetup(&ctx, k);
     chacha_ivsetup(&ctx, n, ic_bytes);
-    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -154,7 +153,32 @@ stream_ietf_ext_ref_xor_ic(unsigned char *c, const unsigned char *m,
     STORE32_LE(ic_bytes, ic);
     chacha_keysetup(&ctx, k);
     chacha_ietf_ivsetup(&ctx, n, ic_bytes);
-    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, 20);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ref_rounds_xor_ic(unsigned char *c, const unsigned char *m,
+                         unsigned long long mlen, const unsigned char *n,
+                         uint64_t ic, const unsigned char *k, int rounds)
+{
+    struct chacha_ctx ctx;
+    uint8_t           ic_bytes[8];
+    uint32_t          ic_high;
+    uint32_t          ic_low;
+
+    if (!mlen) {
+        return 0;
+    }
+    ic_high = (uint32_t) (ic >> 32);
+    ic_low  = (uint32_t) ic;
+    STORE32_LE(&ic_bytes[0], ic_low);
+    STORE32_LE(&ic_bytes[4], ic_high);
+    chacha_keysetup(&ctx, k);
+    chacha_ivsetup(&ctx, n, ic_bytes);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, rounds);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -165,7 +189,9 @@ struct crypto_stream_chacha20_implementation
         SODIUM_C99(.stream =) stream_ref,
         SODIUM_C99(.stream_ietf_ext =) stream_ietf_ext_ref,
         SODIUM_C99(.stream_xor_ic =) stream_ref_xor_ic,
-        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic
+        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic,
+        SODIUM_C99(.blocks8 =) NULL,
+        SODIUM_C99(.stream_rounds_xor_ic =) stream_ref_rounds_xor_ic
     };
 
 #endif
@@ -7,14 +7,14 @@ if (bytes > 0) {
         _mm_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
     uint8_t partialblock[64];
 
-    unsigned int i;
+    int i;
 
     x_0 = _mm_loadu_si128((const __m128i*) (x + 0));
     x_1 = _mm_loadu_si128((const __m128i*) (x + 4));
     x_2 = _mm_loadu_si128((const __m128i*) (x + 8));
     x_3 = _mm_loadu_si128((const __m128i*) (x + 12));
 
-    for (i = 0; i < ROUNDS; i += 2) {
+    for (i = 0; i < rounds; i += 2) {
         x_0 = _mm_add_epi32(x_0, x_1);
         x_3 = _mm_xor_si128(x_3, x_0);
         x_3 = _mm_shuffle_epi8(x_3, rot16);
@@ -15,7 +15,7 @@ while (bytes >= 64) {
     x_2 = _mm_loadu_si128((const __m128i*) (x + 8));
     x_3 = _mm_loadu_si128((const __m128i*) (x + 12));
 
-    for (i = 0; i < ROUNDS; i += 2) {
+    for (i = 0; i < rounds; i += 2) {
         x_0 = _mm_add_epi32(x_0, x_1);
         x_3 = _mm_xor_si128(x_3, x_0);
         x_3 = _mm_shuffle_epi8(x_3, rot16);
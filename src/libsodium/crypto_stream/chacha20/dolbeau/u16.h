@@ -0,0 +1,194 @@
+#define VEC16_ROT(A, IMM) _mm512_rol_epi32(A, IMM)
+
+#define VEC16_LINE1(A, B, C, D)             \
+    x_##A = _mm512_add_epi32(x_##A, x_##B); \
+    x_##D = VEC16_ROT(_mm512_xor_si512(x_##D, x_##A), 16)
+#define VEC16_LINE2(A, B, C, D)             \
+    x_##C = _mm512_add_epi32(x_##C, x_##D); \
+    x_##B = VEC16_ROT(_mm512_xor_si512(x_##B, x_##C), 12)
+#define VEC16_LINE3(A, B, C, D)             \
+    x_##A = _mm512_add_epi32(x_##A, x_##B); \
+    x_##D = VEC16_ROT(_mm512_xor_si512(x_##D, x_##A), 8)
+#define VEC16_LINE4(A, B, C, D)             \
+    x_##C = _mm512_add_epi32(x_##C, x_##D); \
+    x_##B = VEC16_ROT(_mm512_xor_si512(x_##B, x_##C), 7)
+
+#define VEC16_ROUND(A1, B1, C1, D1, A2, B2, C2, D2, A3, B3, C3, D3, A4, B4, \
+                    C4, D4)                                                 \
+    VEC16_LINE1(A1, B1, C1, D1);                                            \
+    VEC16_LINE1(A2, B2, C2, D2);                                            \
+    VEC16_LINE1(A3, B3, C3, D3);                                            \
+    VEC16_LINE1(A4, B4, C4, D4);                                            \
+    VEC16_LINE2(A1, B1, C1, D1);                                            \
+    VEC16_LINE2(A2, B2, C2, D2);                                            \
+    VEC16_LINE2(A3, B3, C3, D3);                                            \
+    VEC16_LINE2(A4, B4, C4, D4);                                            \
+    VEC16_LINE3(A1, B1, C1, D1);                                            \
+    VEC16_LINE3(A2, B2, C2, D2);                                            \
+    VEC16_LINE3(A3, B3, C3, D3);                                            \
+    VEC16_LINE3(A4, B4, C4, D4);                                            \
+    VEC16_LINE4(A1, B1, C1, D1);                                            \
+    VEC16_LINE4(A2, B2, C2, D2);                                            \
+    VEC16_LINE4(A3, B3, C3, D3);                                            \
+    VEC16_LINE4(A4, B4, C4, D4)
+
+if (bytes >= 1024) {
+    __m512i x_0  = _mm512_set1_epi32(x[0]);
+    __m512i x_1  = _mm512_set1_epi32(x[1]);
+    __m512i x_2  = _mm512_set1_epi32(x[2]);
+    __m512i x_3  = _mm512_set1_epi32(x[3]);
+    __m512i x_4  = _mm512_set1_epi32(x[4]);
+    __m512i x_5  = _mm512_set1_epi32(x[5]);
+    __m512i x_6  = _mm512_set1_epi32(x[6]);
+    __m512i x_7  = _mm512_set1_epi32(x[7]);
+    __m512i x_8  = _mm512_set1_epi32(x[8]);
+    __m512i x_9  = _mm512_set1_epi32(x[9]);
+    __m512i x_10 = _mm512_set1_epi32(x[10]);
+    __m512i x_11 = _mm512_set1_epi32(x[11]);
+    __m512i x_12;
+    __m512i x_13;
+    __m512i x_14 = _mm512_set1_epi32(x[14]);
+    __m512i x_15 = _mm512_set1_epi32(x[15]);
+
+    __m512i orig0  = x_0;
+    __m512i orig1  = x_1;
+    __m512i orig2  = x_2;
+    __m512i orig3  = x_3;
+    __m512i orig4  = x_4;
+    __m512i orig5  = x_5;
+    __m512i orig6  = x_6;
+    __m512i orig7  = x_7;
+    __m512i orig8  = x_8;
+    __m512i orig9  = x_9;
+    __m512i orig10 = x_10;
+    __m512i orig11 = x_11;
+    __m512i orig12;
+    __m512i orig13;
+    __m512i orig14 = x_14;
+    __m512i orig15 = x_15;
+    __m512i t_0, t_1, t_2, t_3, t_4, t_5, t_6, t_7, t_8, t_9, t_10, t_11, t_12,
+        t_13, t_14, t_15;
+
+    while (bytes >= 1024) {
+        const __m512i addv12 = _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+        const __m512i addv13 = _mm512_set_epi64(15, 14, 13, 12, 11, 10, 9, 8);
+        const __m512i evens  = _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16,
+                                                14, 12, 10, 8, 6, 4, 2, 0);
+        const __m512i odds   = _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17,
+                                                15, 13, 11, 9, 7, 5, 3, 1);
+        __m512i       t12, t13;
+
+        uint64_t in1213;
+        int      i;
+
+        x_0  = orig0;
+        x_1  = orig1;
+        x_2  = orig2;
+        x_3  = orig3;
+        x_4  = orig4;
+        x_5  = orig5;
+        x_6  = orig6;
+        x_7  = orig7;
+        x_8  = orig8;
+        x_9  = orig9;
+        x_10 = orig10;
+        x_11 = orig11;
+        x_14 = orig14;
+        x_15 = orig15;
+
+        in1213 = ((uint64_t) x[12]) | (((uint64_t) x[13]) << 32);
+
+        t12 = _mm512_add_epi64(addv12, _mm512_set1_epi64((long long) in1213));
+        t13 = _mm512_add_epi64(addv13, _mm512_set1_epi64((long long) in1213));
+
+        /* low words go to x_12, high words to x_13, in block order */
+        x_12 = _mm512_permutex2var_epi32(t12, evens, t13);
+        x_13 = _mm512_permutex2var_epi32(t12, odds, t13);
+
+        orig12 = x_12;
+        orig13 = x_13;
+
+        in1213 += 16;
+
+        x[12] = in1213 & 0xFFFFFFFF;
+        x[13] = (in1213 >> 32) & 0xFFFFFFFF;
+
+        for (i = 0; i < rounds; i += 2) {
+            VEC16_ROUND(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+            VEC16_ROUND(0, 5, 10, 15, 1, 6, 11, 12, 2, 7, 8, 13, 3, 4, 9, 14);
+        }
+
+#define ONEQUAD_UNPCK(A, B, C, D)                    \
+    {                                                \
+        x_##A = _mm512_add_epi32(x_##A, orig##A);    \
+        x_##B = _mm512_add_epi32(x_##B, orig##B);    \
+        x_##C = _mm512_add_epi32(x_##C, orig##C);    \
+        x_##D = _mm512_add_epi32(x_##D, orig##D);    \
+        t_##A = _mm512_unpacklo_epi32(x_##A, x_##B); \
+        t_##B = _mm512_unpacklo_epi32(x_##C, x_##D); \
+        t_##C = _mm512_unpackhi_epi32(x_##A, x_##B); \
+        t_##D = _mm512_unpackhi_epi32(x_##C, x_##D); \
+        x_##A = _mm512_unpacklo_epi64(t_##A, t_##B); \
+        x_##B = _mm512_unpackhi_epi64(t_##A, t_##B); \
+        x_##C = _mm512_unpacklo_epi64(t_##C, t_##D); \
+        x_##D = _mm512_unpackhi_epi64(t_##C, t_##D); \
+    }
+
+/* 128-bit lane k of x_A, x_B, x_C, x_D now holds 4 words of blocks 4k+0..3;
+ * gather the 4 quarters of each block and process 4 blocks at once */
+#define ONEBLOCK4(A, B, C, D)                                              \
+    {                                                                      \
+        t_##A = _mm512_shuffle_i32x4(x_##A, x_##B, 0x44);                  \
+        t_##B = _mm512_shuffle_i32x4(x_##A, x_##B, 0xee);                  \
+        t_##C = _mm512_shuffle_i32x4(x_##C, x_##D, 0x44);                  \
+        t_##D = _mm512_shuffle_i32x4(x_##C, x_##D, 0xee);                  \
+        x_##A = _mm512_shuffle_i32x4(t_##A, t_##C, 0x88);                  \
+        x_##B = _mm512_shuffle_i32x4(t_##A, t_##C, 0xdd);                  \
+        x_##C = _mm512_shuffle_i32x4(t_##B, t_##D, 0x88);                  \
+        x_##D = _mm512_shuffle_i32x4(t_##B, t_##D, 0xdd);                  \
+        x_##A = _mm512_xor_si512(                                          \
+            x_##A, _mm512_loadu_si512((const void *) (m + 0)));            \
+        x_##B = _mm512_xor_si512(                                          \
+            x_##B, _mm512_loadu_si512((const void *) (m + 256)));          \
+        x_##C = _mm512_xor_si512(                                          \
+            x_##C, _mm512_loadu_si512((const void *) (m + 512)));          \
+        x_##D = _mm512_xor_si512(                                          \
+            x_##D, _mm512_loadu_si512((const void *) (m + 768)));          \
+        _mm512_storeu_si512((void *) (c + 0), x_##A);                      \
+        _mm512_storeu_si512((void *) (c + 256), x_##B);                    \
+        _mm512_storeu_si512((void *) (c + 512), x_##C);                    \
+        _mm512_storeu_si512((void *) (c + 768), x_##D);                    \
+    }
+
+        ONEQUAD_UNPCK(0, 1, 2, 3);
+        ONEQUAD_UNPCK(4, 5, 6, 7);
+        ONEQUAD_UNPCK(8, 9, 10, 11);
+        ONEQUAD_UNPCK(12, 13, 14, 15);
+
+        ONEBLOCK4(0, 4, 8, 12);
+        m += 64;
+        c += 64;
+        ONEBLOCK4(1, 5, 9, 13);
+        m += 64;
+        c += 64;
+        ONEBLOCK4(2, 6, 10, 14);
+        m += 64;
+        c += 64;
+        ONEBLOCK4(3, 7, 11, 15);
+        m -= 192;
+        c -= 192;
+
+#undef ONEQUAD_UNPCK
+#undef ONEBLOCK4
+
+        bytes -= 1024;
+        c += 1024;
+        m += 1024;
+    }
+}
+#undef VEC16_ROT
+#undef VEC16_LINE1
+#undef VEC16_LINE2
+#undef VEC16_LINE3
+#undef VEC16_LINE4
+#undef VEC16_ROUND
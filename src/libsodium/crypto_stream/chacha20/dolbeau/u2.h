@@ -0,0 +1,129 @@
+/*
+ * Two blocks per pass for inputs shorter than 256 bytes: the low and high
+ * lanes of every 256-bit register hold the same row of two consecutive
+ * blocks, so the 128-bit row shuffles of u1.h apply unchanged.
+ */
+while (bytes > 64) {
+    __m256i       x_0, x_1, x_2, x_3;
+    __m256i       orig0, orig1, orig2, orig3;
+    __m256i       t_1;
+    const __m256i rot16 =
+        _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                        13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8 =
+        _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                        14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+    uint8_t       partialblock[64];
+    uint64_t      in1213;
+    unsigned int  j;
+    int           i;
+
+    in1213 = ((uint64_t) x[12]) | (((uint64_t) x[13]) << 32);
+    orig0  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) (x + 0)));
+    orig1  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) (x + 4)));
+    orig2  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) (x + 8)));
+    orig3  = _mm256_set_epi32((int) x[15], (int) x[14],
+                              (int) (uint32_t) ((in1213 + 1) >> 32),
+                              (int) (uint32_t) (in1213 + 1),
+                              (int) x[15], (int) x[14], (int) x[13], (int) x[12]);
+    x_0 = orig0;
+    x_1 = orig1;
+    x_2 = orig2;
+    x_3 = orig3;
+
+    for (i = 0; i < rounds; i += 2) {
+        x_0 = _mm256_add_epi32(x_0, x_1);
+        x_3 = _mm256_xor_si256(x_3, x_0);
+        x_3 = _mm256_shuffle_epi8(x_3, rot16);
+
+        x_2 = _mm256_add_epi32(x_2, x_3);
+        x_1 = _mm256_xor_si256(x_1, x_2);
+
+        t_1 = x_1;
+        x_1 = _mm256_slli_epi32(x_1, 12);
+        t_1 = _mm256_srli_epi32(t_1, 20);
+        x_1 = _mm256_xor_si256(x_1, t_1);
+
+        x_0 = _mm256_add_epi32(x_0, x_1);
+        x_3 = _mm256_xor_si256(x_3, x_0);
+        x_0 = _mm256_shuffle_epi32(x_0, 0x93);
+        x_3 = _mm256_shuffle_epi8(x_3, rot8);
+
+        x_2 = _mm256_add_epi32(x_2, x_3);
+        x_3 = _mm256_shuffle_epi32(x_3, 0x4e);
+        x_1 = _mm256_xor_si256(x_1, x_2);
+        x_2 = _mm256_shuffle_epi32(x_2, 0x39);
+
+        t_1 = x_1;
+        x_1 = _mm256_slli_epi32(x_1, 7);
+        t_1 = _mm256_srli_epi32(t_1, 25);
+        x_1 = _mm256_xor_si256(x_1, t_1);
+
+        x_0 = _mm256_add_epi32(x_0, x_1);
+        x_3 = _mm256_xor_si256(x_3, x_0);
+        x_3 = _mm256_shuffle_epi8(x_3, rot16);
+
+        x_2 = _mm256_add_epi32(x_2, x_3);
+        x_1 = _mm256_xor_si256(x_1, x_2);
+
+        t_1 = x_1;
+        x_1 = _mm256_slli_epi32(x_1, 12);
+        t_1 = _mm256_srli_epi32(t_1, 20);
+        x_1 = _mm256_xor_si256(x_1, t_1);
+
+        x_0 = _mm256_add_epi32(x_0, x_1);
+        x_3 = _mm256_xor_si256(x_3, x_0);
+        x_0 = _mm256_shuffle_epi32(x_0, 0x39);
+        x_3 = _mm256_shuffle_epi8(x_3, rot8);
+
+        x_2 = _mm256_add_epi32(x_2, x_3);
+        x_3 = _mm256_shuffle_epi32(x_3, 0x4e);
+        x_1 = _mm256_xor_si256(x_1, x_2);
+        x_2 = _mm256_shuffle_epi32(x_2, 0x93);
+
+        t_1 = x_1;
+        x_1 = _mm256_slli_epi32(x_1, 7);
+        t_1 = _mm256_srli_epi32(t_1, 25);
+        x_1 = _mm256_xor_si256(x_1, t_1);
+    }
+    x_0 = _mm256_add_epi32(x_0, orig0);
+    x_1 = _mm256_add_epi32(x_1, orig1);
+    x_2 = _mm256_add_epi32(x_2, orig2);
+    x_3 = _mm256_add_epi32(x_3, orig3);
+
+    /* regroup the rows of each block */
+    orig0 = _mm256_permute2x128_si256(x_0, x_1, 0x20);
+    orig1 = _mm256_permute2x128_si256(x_2, x_3, 0x20);
+    orig2 = _mm256_permute2x128_si256(x_0, x_1, 0x31);
+    orig3 = _mm256_permute2x128_si256(x_2, x_3, 0x31);
+
+    orig0 = _mm256_xor_si256(orig0, _mm256_loadu_si256((const __m256i*) (m + 0)));
+    orig1 = _mm256_xor_si256(orig1, _mm256_loadu_si256((const __m256i*) (m + 32)));
+    _mm256_storeu_si256((__m256i*) (c + 0), orig0);
+    _mm256_storeu_si256((__m256i*) (c + 32), orig1);
+    if (bytes >= 128) {
+        orig2 = _mm256_xor_si256(orig2, _mm256_loadu_si256((const __m256i*) (m + 64)));
+        orig3 = _mm256_xor_si256(orig3, _mm256_loadu_si256((const __m256i*) (m + 96)));
+        _mm256_storeu_si256((__m256i*) (c + 64), orig2);
+        _mm256_storeu_si256((__m256i*) (c + 96), orig3);
+    } else {
+        _mm256_storeu_si256((__m256i*) (partialblock + 0), orig2);
+        _mm256_storeu_si256((__m256i*) (partialblock + 32), orig3);
+        for (j = 0; j < (unsigned int) bytes - 64; j++) {
+            c[64 + j] = m[64 + j] ^ partialblock[j];
+        }
+        sodium_memzero(partialblock, sizeof partialblock);
+    }
+
+    in1213 += 2;
+    x[12] = (uint32_t) in1213;
+    x[13] = (uint32_t) (in1213 >> 32);
+
+    if (bytes < 128) {
+        bytes = 0;
+        break;
+    }
+    bytes -= 128;
+    c += 128;
+    m += 128;
+}
@@ -192,7 +192,7 @@ if (bytes >= 512) {
         x[12] = in1213 & 0xFFFFFFFF;
         x[13] = (in1213 >> 32) & 0xFFFFFFFF;
 
-        for (i = 0; i < ROUNDS; i += 2) {
+        for (i = 0; i < rounds; i += 2) {
             VEC8_ROUND(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
             VEC8_ROUND(0, 5, 10, 15, 1, 6, 11, 12, 2, 7, 8, 13, 3, 4, 9, 14);
         }
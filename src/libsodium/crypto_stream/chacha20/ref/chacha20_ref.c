@@ -79,7 +79,7 @@ chacha_ietf_ivsetup(chacha_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
 
 static void
 chacha20_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
-                       unsigned long long bytes)
+                       unsigned long long bytes, const int rounds)
 {
     uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14,
         x15;
@@ -135,7 +135,7 @@ chacha20_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
         x13 = j13;
         x14 = j14;
         x15 = j15;
-        for (i = 20; i > 0; i -= 2) {
+        for (i = (unsigned int) rounds; i > 0; i -= 2) {
             QUARTERROUND(x0, x4, x8, x12)
             QUARTERROUND(x1, x5, x9, x13)
             QUARTERROUND(x2, x6, x10, x14)
@@ -233,7 +233,7 @@ stream_ref(unsigned char *c, unsigned long long clen, const unsigned char *n,
     chacha_keysetup(&ctx, k);
     chacha_ivsetup(&ctx, n, NULL);
     memset(c, 0, clen);
-    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -252,7 +252,7 @@ stream_ietf_ext_ref(unsigned char *c, unsigned long long clen,
     chacha_keysetup(&ctx, k);
     chacha_ietf_ivsetup(&ctx, n, NULL);
     memset(c, 0, clen);
-    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -277,7 +277,7 @@ stream_ref_xor_ic(unsigned char *c, const unsigned char *m,
     STORE32_LE(&ic_bytes[4], ic_high);
     chacha_keysetup(&ctx, k);
     chacha_ivsetup(&ctx, n, ic_bytes);
-    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, 20);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -297,7 +297,32 @@ stream_ietf_ext_ref_xor_ic(unsigned char *c, const unsigned char *m,
     STORE32_LE(ic_bytes, ic);
     chacha_keysetup(&ctx, k);
     chacha_ietf_ivsetup(&ctx, n, ic_bytes);
-    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, 20);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ref_rounds_xor_ic(unsigned char *c, const unsigned char *m,
+                         unsigned long long mlen, const unsigned char *n,
+                         uint64_t ic, const unsigned char *k, int rounds)
+{
+    struct chacha_ctx ctx;
+    uint8_t           ic_bytes[8];
+    uint32_t          ic_high;
+    uint32_t          ic_low;
+
+    if (!mlen) {
+        return 0;
+    }
+    ic_high = U32V(ic >> 32);
+    ic_low  = U32V(ic);
+    STORE32_LE(&ic_bytes[0], ic_low);
+    STORE32_LE(&ic_bytes[4], ic_high);
+    chacha_keysetup(&ctx, k);
+    chacha_ivsetup(&ctx, n, ic_bytes);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen, rounds);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
@@ -308,5 +333,7 @@ struct crypto_stream_chacha20_implementation
         SODIUM_C99(.stream =) stream_ref,
         SODIUM_C99(.stream_ietf_ext =) stream_ietf_ext_ref,
         SODIUM_C99(.stream_xor_ic =) stream_ref_xor_ic,
-        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic
+        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic,
+        SODIUM_C99(.blocks8 =) NULL,
+        SODIUM_C99(.stream_rounds_xor_ic =) stream_ref_rounds_xor_ic
     };
@@ -0,0 +1,260 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_stream_chacha20.h"
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_RVV) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <riscv_vector.h>
+
+# include "../stream_chacha20.h"
+# include "chacha20_rvv.h"
+
+# define ROUNDS 20
+
+/* the number of blocks per pass is capped to bound the keystream buffer */
+# define MAX_BLOCKS 16
+
+# define VEC_ROT(A, IMM)                                            \
+    __riscv_vor_vv_u32m1(__riscv_vsll_vx_u32m1((A), (IMM), vl),     \
+                         __riscv_vsrl_vx_u32m1((A), 32 - (IMM), vl), vl)
+
+# define VEC_QUARTERROUND(A, B, C, D)                                     \
+    do {                                                                  \
+        v[A] = __riscv_vadd_vv_u32m1(v[A], v[B], vl);                     \
+        v[D] = VEC_ROT(__riscv_vxor_vv_u32m1(v[D], v[A], vl), 16);        \
+        v[C] = __riscv_vadd_vv_u32m1(v[C], v[D], vl);                     \
+        v[B] = VEC_ROT(__riscv_vxor_vv_u32m1(v[B], v[C], vl), 12);        \
+        v[A] = __riscv_vadd_vv_u32m1(v[A], v[B], vl);                     \
+        v[D] = VEC_ROT(__riscv_vxor_vv_u32m1(v[D], v[A], vl), 8);         \
+        v[C] = __riscv_vadd_vv_u32m1(v[C], v[D], vl);                     \
+        v[B] = VEC_ROT(__riscv_vxor_vv_u32m1(v[B], v[C], vl), 7);         \
+    } while (0)
+
+typedef struct chacha_ctx {
+    uint32_t input[16];
+} chacha_ctx;
+
+static void
+chacha_keysetup(chacha_ctx *ctx, const uint8_t *k)
+{
+    ctx->input[0]  = 0x61707865;
+    ctx->input[1]  = 0x3320646e;
+    ctx->input[2]  = 0x79622d32;
+    ctx->input[3]  = 0x6b206574;
+    ctx->input[4]  = LOAD32_LE(k + 0);
+    ctx->input[5]  = LOAD32_LE(k + 4);
+    ctx->input[6]  = LOAD32_LE(k + 8);
+    ctx->input[7]  = LOAD32_LE(k + 12);
+    ctx->input[8]  = LOAD32_LE(k + 16);
+    ctx->input[9]  = LOAD32_LE(k + 20);
+    ctx->input[10] = LOAD32_LE(k + 24);
+    ctx->input[11] = LOAD32_LE(k + 28);
+}
+
+static void
+chacha_ivsetup(chacha_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
+{
+    ctx->input[12] = counter == NULL ? 0 : LOAD32_LE(counter + 0);
+    ctx->input[13] = counter == NULL ? 0 : LOAD32_LE(counter + 4);
+    ctx->input[14] = LOAD32_LE(iv + 0);
+    ctx->input[15] = LOAD32_LE(iv + 4);
+}
+
+static void
+chacha_ietf_ivsetup(chacha_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
+{
+    ctx->input[12] = counter == NULL ? 0 : LOAD32_LE(counter);
+    ctx->input[13] = LOAD32_LE(iv + 0);
+    ctx->input[14] = LOAD32_LE(iv + 4);
+    ctx->input[15] = LOAD32_LE(iv + 8);
+}
+
+/*
+ * Computes vl consecutive blocks, one state word of every block per
+ * vector, and stores them with a 64-byte stride, so that the keystream
+ * is laid out as in the reference implementation.
+ */
+static void
+chacha20_blocks(uint32_t x[16], uint32_t ks[16 * MAX_BLOCKS], size_t vl)
+{
+    vuint32m1_t v[16];
+    vuint32m1_t in12;
+    vuint32m1_t in13;
+    int         i;
+
+    for (i = 0; i < 16; i++) {
+        v[i] = __riscv_vmv_v_x_u32m1(x[i], vl);
+    }
+    in12 = __riscv_vadd_vx_u32m1(__riscv_vid_v_u32m1(vl), x[12], vl);
+    in13 = __riscv_vmerge_vxm_u32m1
+        (v[13], x[13] + 1U, __riscv_vmsltu_vx_u32m1_b32(in12, x[12], vl), vl);
+    v[12] = in12;
+    v[13] = in13;
+    for (i = 0; i < ROUNDS; i += 2) {
+        VEC_QUARTERROUND(0, 4, 8, 12);
+        VEC_QUARTERROUND(1, 5, 9, 13);
+        VEC_QUARTERROUND(2, 6, 10, 14);
+        VEC_QUARTERROUND(3, 7, 11, 15);
+        VEC_QUARTERROUND(0, 5, 10, 15);
+        VEC_QUARTERROUND(1, 6, 11, 12);
+        VEC_QUARTERROUND(2, 7, 8, 13);
+        VEC_QUARTERROUND(3, 4, 9, 14);
+    }
+    for (i = 0; i < 16; i++) {
+        if (i != 12 && i != 13) {
+            v[i] = __riscv_vadd_vx_u32m1(v[i], x[i], vl);
+        }
+    }
+    v[12] = __riscv_vadd_vv_u32m1(v[12], in12, vl);
+    v[13] = __riscv_vadd_vv_u32m1(v[13], in13, vl);
+    for (i = 0; i < 16; i++) {
+        __riscv_vsse32_v_u32m1(&ks[i], 64, v[i], vl);
+    }
+}
+
+static void
+chacha20_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
+                       unsigned long long bytes)
+{
+    uint32_t * const x = &ctx->input[0];
+    uint32_t         ks[16 * MAX_BLOCKS];
+    const uint8_t   *ks8 = (const uint8_t *) (const void *) ks;
+    uint64_t         in1213;
+    size_t           blocks;
+    size_t           len;
+    size_t           i;
+    size_t           vl;
+    size_t           vl8;
+
+    if (!bytes) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    while (bytes > 0) {
+        blocks = (size_t) ((bytes + 63) / 64);
+        if (blocks > MAX_BLOCKS) {
+            blocks = MAX_BLOCKS;
+        }
+        vl = __riscv_vsetvl_e32m1(blocks);
+        chacha20_blocks(x, ks, vl);
+        in1213 = ((uint64_t) x[12]) | (((uint64_t) x[13]) << 32);
+        in1213 += vl;
+        x[12] = in1213 & 0xFFFFFFFF;
+        x[13] = (in1213 >> 32) & 0xFFFFFFFF;
+
+        len = vl * 64;
+        if ((unsigned long long) len > bytes) {
+            len = (size_t) bytes;
+        }
+        for (i = 0; i < len; i += vl8) {
+            vl8 = __riscv_vsetvl_e8m8(len - i);
+            __riscv_vse8_v_u8m8
+                (c + i, __riscv_vxor_vv_u8m8
+                 (__riscv_vle8_v_u8m8(m + i, vl8),
+                  __riscv_vle8_v_u8m8(ks8 + i, vl8),
+                  vl8), vl8);
+        }
+        bytes -= len;
+        c += len;
+        m += len;
+    }
+    sodium_memzero(ks, sizeof ks);
+}
+
+static int
+stream_ref(unsigned char *c, unsigned long long clen, const unsigned char *n,
+           const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+
+    if (!clen) {
+        return 0;
+    }
+    COMPILER_ASSERT(crypto_stream_chacha20_KEYBYTES == 256 / 8);
+    chacha_keysetup(&ctx, k);
+    chacha_ivsetup(&ctx, n, NULL);
+    memset(c, 0, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ietf_ext_ref(unsigned char *c, unsigned long long clen,
+                    const unsigned char *n, const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+
+    if (!clen) {
+        return 0;
+    }
+    COMPILER_ASSERT(crypto_stream_chacha20_KEYBYTES == 256 / 8);
+    chacha_keysetup(&ctx, k);
+    chacha_ietf_ivsetup(&ctx, n, NULL);
+    memset(c, 0, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ref_xor_ic(unsigned char *c, const unsigned char *m,
+                  unsigned long long mlen, const unsigned char *n, uint64_t ic,
+                  const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+    uint8_t           ic_bytes[8];
+    uint32_t          ic_high;
+    uint32_t          ic_low;
+
+    if (!mlen) {
+        return 0;
+    }
+    ic_high = (uint32_t) (ic >> 32);
+    ic_low  = (uint32_t) ic;
+    STORE32_LE(&ic_bytes[0], ic_low);
+    STORE32_LE(&ic_bytes[4], ic_high);
+    chacha_keysetup(&ctx, k);
+    chacha_ivsetup(&ctx, n, ic_bytes);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ietf_ext_ref_xor_ic(unsigned char *c, const unsigned char *m,
+                           unsigned long long mlen, const unsigned char *n,
+                           uint32_t ic, const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+    uint8_t           ic_bytes[4];
+
+    if (!mlen) {
+        return 0;
+    }
+    STORE32_LE(ic_bytes, ic);
+    chacha_keysetup(&ctx, k);
+    chacha_ietf_ivsetup(&ctx, n, ic_bytes);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+struct crypto_stream_chacha20_implementation
+    crypto_stream_chacha20_rvv_implementation = {
+        SODIUM_C99(.stream =) stream_ref,
+        SODIUM_C99(.stream_ietf_ext =) stream_ietf_ext_ref,
+        SODIUM_C99(.stream_xor_ic =) stream_ref_xor_ic,
+        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic,
+        SODIUM_C99(.blocks8 =) NULL
+    };
+
+#endif
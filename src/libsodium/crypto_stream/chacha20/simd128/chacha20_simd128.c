@@ -0,0 +1,263 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "crypto_stream_chacha20.h"
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_WASM_SIMD128)
+
+# include <wasm_simd128.h>
+
+# include "../stream_chacha20.h"
+# include "chacha20_simd128.h"
+
+# define ROUNDS 20
+
+# define VEC4_ROT(A, IMM) \
+    wasm_v128_or(wasm_i32x4_shl((A), (IMM)), wasm_u32x4_shr((A), 32 - (IMM)))
+# define VEC4_ROT16(A) \
+    wasm_i8x16_shuffle((A), (A), 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13)
+# define VEC4_ROT8(A) \
+    wasm_i8x16_shuffle((A), (A), 3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14)
+
+# define VEC4_QUARTERROUND(A, B, C, D)                   \
+    do {                                                 \
+        v[A] = wasm_i32x4_add(v[A], v[B]);               \
+        v[D] = VEC4_ROT16(wasm_v128_xor(v[D], v[A]));    \
+        v[C] = wasm_i32x4_add(v[C], v[D]);               \
+        v[B] = VEC4_ROT(wasm_v128_xor(v[B], v[C]), 12);  \
+        v[A] = wasm_i32x4_add(v[A], v[B]);               \
+        v[D] = VEC4_ROT8(wasm_v128_xor(v[D], v[A]));     \
+        v[C] = wasm_i32x4_add(v[C], v[D]);               \
+        v[B] = VEC4_ROT(wasm_v128_xor(v[B], v[C]), 7);   \
+    } while (0)
+
+typedef struct chacha_ctx {
+    uint32_t input[16];
+} chacha_ctx;
+
+static void
+chacha_keysetup(chacha_ctx *ctx, const uint8_t *k)
+{
+    ctx->input[0]  = 0x61707865;
+    ctx->input[1]  = 0x3320646e;
+    ctx->input[2]  = 0x79622d32;
+    ctx->input[3]  = 0x6b206574;
+    ctx->input[4]  = LOAD32_LE(k + 0);
+    ctx->input[5]  = LOAD32_LE(k + 4);
+    ctx->input[6]  = LOAD32_LE(k + 8);
+    ctx->input[7]  = LOAD32_LE(k + 12);
+    ctx->input[8]  = LOAD32_LE(k + 16);
+    ctx->input[9]  = LOAD32_LE(k + 20);
+    ctx->input[10] = LOAD32_LE(k + 24);
+    ctx->input[11] = LOAD32_LE(k + 28);
+}
+
+static void
+chacha_ivsetup(chacha_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
+{
+    ctx->input[12] = counter == NULL ? 0 : LOAD32_LE(counter + 0);
+    ctx->input[13] = counter == NULL ? 0 : LOAD32_LE(counter + 4);
+    ctx->input[14] = LOAD32_LE(iv + 0);
+    ctx->input[15] = LOAD32_LE(iv + 4);
+}
+
+static void
+chacha_ietf_ivsetup(chacha_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
+{
+    ctx->input[12] = counter == NULL ? 0 : LOAD32_LE(counter);
+    ctx->input[13] = LOAD32_LE(iv + 0);
+    ctx->input[14] = LOAD32_LE(iv + 4);
+    ctx->input[15] = LOAD32_LE(iv + 8);
+}
+
+/* transpose 4 words of 4 blocks and xor them with the matching input
+ * words; c and m point to the first block */
+static inline void
+xor_quad(uint8_t *c, const uint8_t *m, const v128_t a, const v128_t b,
+         const v128_t cc, const v128_t d)
+{
+    const v128_t t0 = wasm_i32x4_shuffle(a, b, 0, 4, 1, 5);
+    const v128_t t1 = wasm_i32x4_shuffle(cc, d, 0, 4, 1, 5);
+    const v128_t t2 = wasm_i32x4_shuffle(a, b, 2, 6, 3, 7);
+    const v128_t t3 = wasm_i32x4_shuffle(cc, d, 2, 6, 3, 7);
+    v128_t       r0, r1, r2, r3;
+
+    r0 = wasm_i64x2_shuffle(t0, t1, 0, 2);
+    r1 = wasm_i64x2_shuffle(t0, t1, 1, 3);
+    r2 = wasm_i64x2_shuffle(t2, t3, 0, 2);
+    r3 = wasm_i64x2_shuffle(t2, t3, 1, 3);
+    wasm_v128_store(c + 0, wasm_v128_xor(r0, wasm_v128_load(m + 0)));
+    wasm_v128_store(c + 64, wasm_v128_xor(r1, wasm_v128_load(m + 64)));
+    wasm_v128_store(c + 128, wasm_v128_xor(r2, wasm_v128_load(m + 128)));
+    wasm_v128_store(c + 192, wasm_v128_xor(r3, wasm_v128_load(m + 192)));
+}
+
+/* 4 consecutive blocks, one state word of every block per vector */
+static void
+chacha20_blocks4(uint32_t x[16], const uint8_t *m, uint8_t *c)
+{
+    v128_t   v[16];
+    v128_t   orig[16];
+    uint32_t in12[4];
+    uint32_t in13[4];
+    uint64_t in1213;
+    int      i;
+
+    in1213 = ((uint64_t) x[12]) | (((uint64_t) x[13]) << 32);
+    for (i = 0; i < 4; i++) {
+        in12[i] = (uint32_t) (in1213 + (uint64_t) i);
+        in13[i] = (uint32_t) ((in1213 + (uint64_t) i) >> 32);
+    }
+    in1213 += 4;
+    x[12] = in1213 & 0xFFFFFFFF;
+    x[13] = (in1213 >> 32) & 0xFFFFFFFF;
+
+    for (i = 0; i < 16; i++) {
+        orig[i] = wasm_i32x4_splat(x[i]);
+    }
+    orig[12] = wasm_v128_load(in12);
+    orig[13] = wasm_v128_load(in13);
+    for (i = 0; i < 16; i++) {
+        v[i] = orig[i];
+    }
+    for (i = 0; i < ROUNDS; i += 2) {
+        VEC4_QUARTERROUND(0, 4, 8, 12);
+        VEC4_QUARTERROUND(1, 5, 9, 13);
+        VEC4_QUARTERROUND(2, 6, 10, 14);
+        VEC4_QUARTERROUND(3, 7, 11, 15);
+        VEC4_QUARTERROUND(0, 5, 10, 15);
+        VEC4_QUARTERROUND(1, 6, 11, 12);
+        VEC4_QUARTERROUND(2, 7, 8, 13);
+        VEC4_QUARTERROUND(3, 4, 9, 14);
+    }
+    for (i = 0; i < 16; i++) {
+        v[i] = wasm_i32x4_add(v[i], orig[i]);
+    }
+    xor_quad(c + 0, m + 0, v[0], v[1], v[2], v[3]);
+    xor_quad(c + 16, m + 16, v[4], v[5], v[6], v[7]);
+    xor_quad(c + 32, m + 32, v[8], v[9], v[10], v[11]);
+    xor_quad(c + 48, m + 48, v[12], v[13], v[14], v[15]);
+}
+
+static void
+chacha20_encrypt_bytes(chacha_ctx *ctx, const uint8_t *m, uint8_t *c,
+                       unsigned long long bytes)
+{
+    uint32_t * const x = &ctx->input[0];
+    uint8_t          partial[256];
+
+    if (!bytes) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    while (bytes >= 256) {
+        chacha20_blocks4(x, m, c);
+        bytes -= 256;
+        c += 256;
+        m += 256;
+    }
+    if (bytes > 0) {
+        memset(partial, 0, sizeof partial);
+        memcpy(partial, m, (size_t) bytes);
+        chacha20_blocks4(x, partial, partial);
+        memcpy(c, partial, (size_t) bytes);
+        sodium_memzero(partial, sizeof partial);
+    }
+}
+
+static int
+stream_ref(unsigned char *c, unsigned long long clen, const unsigned char *n,
+           const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+
+    if (!clen) {
+        return 0;
+    }
+    COMPILER_ASSERT(crypto_stream_chacha20_KEYBYTES == 256 / 8);
+    chacha_keysetup(&ctx, k);
+    chacha_ivsetup(&ctx, n, NULL);
+    memset(c, 0, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ietf_ext_ref(unsigned char *c, unsigned long long clen,
+                    const unsigned char *n, const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+
+    if (!clen) {
+        return 0;
+    }
+    COMPILER_ASSERT(crypto_stream_chacha20_KEYBYTES == 256 / 8);
+    chacha_keysetup(&ctx, k);
+    chacha_ietf_ivsetup(&ctx, n, NULL);
+    memset(c, 0, clen);
+    chacha20_encrypt_bytes(&ctx, c, c, clen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ref_xor_ic(unsigned char *c, const unsigned char *m,
+                  unsigned long long mlen, const unsigned char *n, uint64_t ic,
+                  const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+    uint8_t           ic_bytes[8];
+    uint32_t          ic_high;
+    uint32_t          ic_low;
+
+    if (!mlen) {
+        return 0;
+    }
+    ic_high = (uint32_t) (ic >> 32);
+    ic_low  = (uint32_t) ic;
+    STORE32_LE(&ic_bytes[0], ic_low);
+    STORE32_LE(&ic_bytes[4], ic_high);
+    chacha_keysetup(&ctx, k);
+    chacha_ivsetup(&ctx, n, ic_bytes);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_ietf_ext_ref_xor_ic(unsigned char *c, const unsigned char *m,
+                           unsigned long long mlen, const unsigned char *n,
+                           uint32_t ic, const unsigned char *k)
+{
+    struct chacha_ctx ctx;
+    uint8_t           ic_bytes[4];
+
+    if (!mlen) {
+        return 0;
+    }
+    STORE32_LE(ic_bytes, ic);
+    chacha_keysetup(&ctx, k);
+    chacha_ietf_ivsetup(&ctx, n, ic_bytes);
+    chacha20_encrypt_bytes(&ctx, m, c, mlen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+struct crypto_stream_chacha20_implementation
+    crypto_stream_chacha20_simd128_implementation = {
+        SODIUM_C99(.stream =) stream_ref,
+        SODIUM_C99(.stream_ietf_ext =) stream_ietf_ext_ref,
+        SODIUM_C99(.stream_xor_ic =) stream_ref_xor_ic,
+        SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_ref_xor_ic,
+        SODIUM_C99(.blocks8 =) NULL
+    };
+
+#endif
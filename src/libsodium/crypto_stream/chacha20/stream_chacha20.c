@@ -1,13 +1,37 @@
+#include <string.h>
+
+#include "crypto_stream_chacha12.h"
 #include "crypto_stream_chacha20.h"
+#include "crypto_stream_chacha8.h"
 #include "core.h"
+#include "private/aliases.h"
 #include "private/chacha20_ietf_ext.h"
 #include "private/common.h"
+#include "private/executor.h"
 #include "private/implementations.h"
+#include "private/stats.h"
 #include "randombytes.h"
 #include "runtime.h"
 #include "stream_chacha20.h"
 
 #include "ref/chacha20_ref.h"
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+# include "neon/chacha20_neon.h"
+#endif
+#if defined(HAVE_VSX) && defined(NATIVE_LITTLE_ENDIAN)
+# include "vsx/chacha20_vsx.h"
+#endif
+#if defined(HAVE_RVV) && defined(NATIVE_LITTLE_ENDIAN)
+# include "rvv/chacha20_rvv.h"
+#endif
+#if defined(HAVE_WASM_SIMD128)
+# include "simd128/chacha20_simd128.h"
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+# include "dolbeau/chacha20_dolbeau-avx512f.h"
+#endif
 #if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
     defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
 # include "dolbeau/chacha20_dolbeau-avx2.h"
@@ -16,8 +40,34 @@
 # include "dolbeau/chacha20_dolbeau-ssse3.h"
 #endif
 
+/* With --with-isa, the implementation for the baseline is fixed */
+#if defined(FIXED_ISA) && defined(__AVX512F__) && \
+    defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+# define FIXED_IMPLEMENTATION crypto_stream_chacha20_dolbeau_avx512f_implementation
+# define FIXED_NAME "avx512f"
+#elif defined(FIXED_ISA) && defined(__AVX2__) && \
+    defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# define FIXED_IMPLEMENTATION crypto_stream_chacha20_dolbeau_avx2_implementation
+# define FIXED_NAME "avx2"
+#elif defined(FIXED_ISA) && defined(__ARM_NEON) && \
+    defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+# define FIXED_IMPLEMENTATION crypto_stream_chacha20_neon_implementation
+# define FIXED_NAME "neon"
+#endif
+
+#define CHACHA20_PARALLEL_THREADS_MAX 16U
+#define CHACHA20_PARALLEL_BYTES_MIN   (256U * 1024U)
+
+#ifdef FIXED_NAME
+static const crypto_stream_chacha20_implementation *const implementation =
+    &FIXED_IMPLEMENTATION;
+#else
 static const crypto_stream_chacha20_implementation *implementation =
     &crypto_stream_chacha20_ref_implementation;
+#endif
 
 size_t
 crypto_stream_chacha20_keybytes(void) {
@@ -55,11 +105,18 @@ int
 crypto_stream_chacha20(unsigned char *c, unsigned long long clen,
                        const unsigned char *n, const unsigned char *k)
 {
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
     if (clen > crypto_stream_chacha20_MESSAGEBYTES_MAX) {
         sodium_misuse();
     }
-    return implementation->stream(c, clen, n, k);
+    ret = implementation->stream(c, clen, n, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, clen);
+
+    return ret;
 }
+SODIUM_ALIAS_DEF(crypto_stream_chacha20);
 
 int
 crypto_stream_chacha20_xor_ic(unsigned char *c, const unsigned char *m,
@@ -67,31 +124,50 @@ crypto_stream_chacha20_xor_ic(unsigned char *c, const unsigned char *m,
                               const unsigned char *n, uint64_t ic,
                               const unsigned char *k)
 {
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
     if (mlen > crypto_stream_chacha20_MESSAGEBYTES_MAX) {
         sodium_misuse();
     }
-    return implementation->stream_xor_ic(c, m, mlen, n, ic, k);
+    ret = implementation->stream_xor_ic(c, m, mlen, n, ic, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
 }
+SODIUM_ALIAS_DEF(crypto_stream_chacha20_xor_ic);
 
 int
 crypto_stream_chacha20_xor(unsigned char *c, const unsigned char *m,
                            unsigned long long mlen, const unsigned char *n,
                            const unsigned char *k)
 {
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
     if (mlen > crypto_stream_chacha20_MESSAGEBYTES_MAX) {
         sodium_misuse();
     }
-    return implementation->stream_xor_ic(c, m, mlen, n, 0U, k);
+    ret = implementation->stream_xor_ic(c, m, mlen, n, 0U, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
 }
 
 int
 crypto_stream_chacha20_ietf_ext(unsigned char *c, unsigned long long clen,
                                 const unsigned char *n, const unsigned char *k)
 {
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
     if (clen > crypto_stream_chacha20_MESSAGEBYTES_MAX) {
         sodium_misuse();
     }
-    return implementation->stream_ietf_ext(c, clen, n, k);
+    ret = implementation->stream_ietf_ext(c, clen, n, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, clen);
+
+    return ret;
 }
 
 int
@@ -100,10 +176,16 @@ crypto_stream_chacha20_ietf_ext_xor_ic(unsigned char *c, const unsigned char *m,
                                        const unsigned char *n, uint32_t ic,
                                        const unsigned char *k)
 {
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
     if (mlen > crypto_stream_chacha20_MESSAGEBYTES_MAX) {
         sodium_misuse();
     }
-    return implementation->stream_ietf_ext_xor_ic(c, m, mlen, n, ic, k);
+    ret = implementation->stream_ietf_ext_xor_ic(c, m, mlen, n, ic, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
 }
 
 static int
@@ -111,10 +193,33 @@ crypto_stream_chacha20_ietf_ext_xor(unsigned char *c, const unsigned char *m,
                                     unsigned long long mlen, const unsigned char *n,
                                     const unsigned char *k)
 {
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
     if (mlen > crypto_stream_chacha20_MESSAGEBYTES_MAX) {
         sodium_misuse();
     }
-    return implementation->stream_ietf_ext_xor_ic(c, m, mlen, n, 0U, k);
+    ret = implementation->stream_ietf_ext_xor_ic(c, m, mlen, n, 0U, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
+}
+
+int
+crypto_stream_chacha20_blocks8(unsigned char *ks, const uint32_t x[16][8])
+{
+    if (implementation->blocks8 == NULL) {
+        return -1;
+    }
+    implementation->blocks8(ks, x);
+
+    return 0;
+}
+
+int
+crypto_stream_chacha20_has_blocks8(void)
+{
+    return implementation->blocks8 != NULL;
 }
 
 int
@@ -126,6 +231,7 @@ crypto_stream_chacha20_ietf(unsigned char *c, unsigned long long clen,
     }
     return crypto_stream_chacha20_ietf_ext(c, clen, n, k);
 }
+SODIUM_ALIAS_DEF(crypto_stream_chacha20_ietf);
 
 int
 crypto_stream_chacha20_ietf_xor_ic(unsigned char *c, const unsigned char *m,
@@ -139,6 +245,121 @@ crypto_stream_chacha20_ietf_xor_ic(unsigned char *c, const unsigned char *m,
     }
     return crypto_stream_chacha20_ietf_ext_xor_ic(c, m, mlen, n, ic, k);
 }
+SODIUM_ALIAS_DEF(crypto_stream_chacha20_ietf_xor_ic);
+
+typedef struct chacha20_parallel_job {
+    unsigned char       *c;
+    const unsigned char *m;
+    unsigned long long   mlen;
+    const unsigned char *n;
+    const unsigned char *k;
+    uint64_t             ic;
+    int                  ietf;
+} chacha20_parallel_job;
+
+static void
+chacha20_parallel_run(const chacha20_parallel_job *job)
+{
+    if (job->ietf) {
+        implementation->stream_ietf_ext_xor_ic(job->c, job->m, job->mlen,
+                                               job->n, (uint32_t) job->ic,
+                                               job->k);
+    } else {
+        implementation->stream_xor_ic(job->c, job->m, job->mlen, job->n,
+                                      job->ic, job->k);
+    }
+}
+
+static void
+chacha20_parallel_task(void *job)
+{
+    chacha20_parallel_run((const chacha20_parallel_job *) job);
+}
+
+/*
+ * The keystream is seekable, so the message is split into runs of whole
+ * blocks, one per thread, each starting at its own counter. Every thread
+ * gets at least CHACHA20_PARALLEL_BYTES_MIN bytes. If the executor cannot
+ * take a run, the calling thread processes it.
+ */
+static void
+chacha20_xor_ic_parallel(unsigned char *c, const unsigned char *m,
+                         unsigned long long mlen, const unsigned char *n,
+                         uint64_t ic, const unsigned char *k,
+                         unsigned int threads, int ietf)
+{
+    chacha20_parallel_job job[CHACHA20_PARALLEL_THREADS_MAX];
+    sodium_executor_task  task[CHACHA20_PARALLEL_THREADS_MAX];
+    unsigned long long    run_blocks;
+    unsigned long long    offset;
+    unsigned int          t;
+
+    if (threads > CHACHA20_PARALLEL_THREADS_MAX) {
+        threads = CHACHA20_PARALLEL_THREADS_MAX;
+    }
+    if ((unsigned long long) threads > mlen / CHACHA20_PARALLEL_BYTES_MIN) {
+        threads = (unsigned int) (mlen / CHACHA20_PARALLEL_BYTES_MIN);
+    }
+    threads = _sodium_executor_threads(threads);
+    run_blocks = ((mlen + 63U) / 64U + threads - 1U) / threads;
+    for (t = 0U; t < threads; t++) {
+        offset = run_blocks * 64U * t;
+        job[t].c    = c + offset;
+        job[t].m    = m + offset;
+        job[t].mlen = mlen - offset < run_blocks * 64U ?
+                          mlen - offset : run_blocks * 64U;
+        job[t].n    = n;
+        job[t].k    = k;
+        job[t].ic   = ic + run_blocks * t;
+        job[t].ietf = ietf;
+    }
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_start(&task[t], chacha20_parallel_task, &job[t]);
+    }
+    chacha20_parallel_run(&job[0]);
+    for (t = 1U; t < threads; t++) {
+        _sodium_executor_finish(&task[t]);
+    }
+}
+
+int
+crypto_stream_chacha20_xor_ic_parallel(unsigned char *c, const unsigned char *m,
+                                       unsigned long long mlen,
+                                       const unsigned char *n, uint64_t ic,
+                                       const unsigned char *k,
+                                       unsigned int threads)
+{
+    SODIUM_STATS_START(stats_start)
+
+    if (mlen > crypto_stream_chacha20_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    chacha20_xor_ic_parallel(c, m, mlen, n, ic, k, threads, 0);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return 0;
+}
+
+int
+crypto_stream_chacha20_ietf_xor_ic_parallel(unsigned char *c,
+                                            const unsigned char *m,
+                                            unsigned long long mlen,
+                                            const unsigned char *n,
+                                            uint32_t ic,
+                                            const unsigned char *k,
+                                            unsigned int threads)
+{
+    SODIUM_STATS_START(stats_start)
+
+    if ((unsigned long long) ic >
+        (64ULL * (1ULL << 32)) / 64ULL - (mlen + 63ULL) / 64ULL) {
+        sodium_misuse();
+    }
+    chacha20_xor_ic_parallel(c, m, mlen, n, ic, k, threads, 1);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return 0;
+}
 
 int
 crypto_stream_chacha20_ietf_xor(unsigned char *c, const unsigned char *m,
@@ -163,22 +384,207 @@ crypto_stream_chacha20_keygen(unsigned char k[crypto_stream_chacha20_KEYBYTES])
     randombytes_buf(k, crypto_stream_chacha20_KEYBYTES);
 }
 
+/*
+ * The reduced-round variants share the ChaCha20 kernels. Implementations
+ * without a round count parameter fall back to the portable code.
+ */
+static int
+chacha_rounds_xor_ic(unsigned char *c, const unsigned char *m,
+                     unsigned long long mlen, const unsigned char *n,
+                     uint64_t ic, const unsigned char *k, int rounds)
+{
+    const crypto_stream_chacha20_implementation *impl = implementation;
+    int                                          ret;
+    SODIUM_STATS_START(stats_start)
+
+    if (impl->stream_rounds_xor_ic == NULL) {
+        impl = &crypto_stream_chacha20_ref_implementation;
+    }
+    ret = impl->stream_rounds_xor_ic(c, m, mlen, n, ic, k, rounds);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
+}
+
+size_t
+crypto_stream_chacha12_keybytes(void)
+{
+    return crypto_stream_chacha12_KEYBYTES;
+}
+
+size_t
+crypto_stream_chacha12_noncebytes(void)
+{
+    return crypto_stream_chacha12_NONCEBYTES;
+}
+
+size_t
+crypto_stream_chacha12_messagebytes_max(void)
+{
+    return crypto_stream_chacha12_MESSAGEBYTES_MAX;
+}
+
+int
+crypto_stream_chacha12(unsigned char *c, unsigned long long clen,
+                       const unsigned char *n, const unsigned char *k)
+{
+    if (clen > crypto_stream_chacha12_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    memset(c, 0, clen);
+
+    return chacha_rounds_xor_ic(c, c, clen, n, 0U, k, 12);
+}
+
+int
+crypto_stream_chacha12_xor_ic(unsigned char *c, const unsigned char *m,
+                              unsigned long long mlen,
+                              const unsigned char *n, uint64_t ic,
+                              const unsigned char *k)
+{
+    if (mlen > crypto_stream_chacha12_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    return chacha_rounds_xor_ic(c, m, mlen, n, ic, k, 12);
+}
+
+int
+crypto_stream_chacha12_xor(unsigned char *c, const unsigned char *m,
+                           unsigned long long mlen, const unsigned char *n,
+                           const unsigned char *k)
+{
+    return crypto_stream_chacha12_xor_ic(c, m, mlen, n, 0U, k);
+}
+
+void
+crypto_stream_chacha12_keygen(unsigned char k[crypto_stream_chacha12_KEYBYTES])
+{
+    randombytes_buf(k, crypto_stream_chacha12_KEYBYTES);
+}
+
+size_t
+crypto_stream_chacha8_keybytes(void)
+{
+    return crypto_stream_chacha8_KEYBYTES;
+}
+
+size_t
+crypto_stream_chacha8_noncebytes(void)
+{
+    return crypto_stream_chacha8_NONCEBYTES;
+}
+
+size_t
+crypto_stream_chacha8_messagebytes_max(void)
+{
+    return crypto_stream_chacha8_MESSAGEBYTES_MAX;
+}
+
+int
+crypto_stream_chacha8(unsigned char *c, unsigned long long clen,
+                      const unsigned char *n, const unsigned char *k)
+{
+    if (clen > crypto_stream_chacha8_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    memset(c, 0, clen);
+
+    return chacha_rounds_xor_ic(c, c, clen, n, 0U, k, 8);
+}
+
+int
+crypto_stream_chacha8_xor_ic(unsigned char *c, const unsigned char *m,
+                             unsigned long long mlen,
+                             const unsigned char *n, uint64_t ic,
+                             const unsigned char *k)
+{
+    if (mlen > crypto_stream_chacha8_MESSAGEBYTES_MAX) {
+        sodium_misuse();
+    }
+    return chacha_rounds_xor_ic(c, m, mlen, n, ic, k, 8);
+}
+
+int
+crypto_stream_chacha8_xor(unsigned char *c, const unsigned char *m,
+                          unsigned long long mlen, const unsigned char *n,
+                          const unsigned char *k)
+{
+    return crypto_stream_chacha8_xor_ic(c, m, mlen, n, 0U, k);
+}
+
+void
+crypto_stream_chacha8_keygen(unsigned char k[crypto_stream_chacha8_KEYBYTES])
+{
+    randombytes_buf(k, crypto_stream_chacha8_KEYBYTES);
+}
+
 int
 _crypto_stream_chacha20_pick_best_implementation(void)
 {
+#ifdef FIXED_NAME
+    _sodium_implementation_selected("chacha20", FIXED_NAME);
+#else
     implementation = &crypto_stream_chacha20_ref_implementation;
+    _sodium_implementation_selected("chacha20", "ref");
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors() &&
+        _sodium_implementation_allowed("chacha20", "avx512f")) {
+        implementation = &crypto_stream_chacha20_dolbeau_avx512f_implementation;
+        _sodium_implementation_selected("chacha20", "avx512f");
+        return 0;
+    }
+#endif
 #if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
     defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
-    if (sodium_runtime_has_avx2()) {
+    if (sodium_runtime_has_avx2() &&
+        _sodium_implementation_allowed("chacha20", "avx2")) {
         implementation = &crypto_stream_chacha20_dolbeau_avx2_implementation;
+        _sodium_implementation_selected("chacha20", "avx2");
         return 0;
     }
 #endif
 #if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H)
-    if (sodium_runtime_has_ssse3()) {
+    if (sodium_runtime_has_ssse3() &&
+        _sodium_implementation_allowed("chacha20", "ssse3")) {
         implementation = &crypto_stream_chacha20_dolbeau_ssse3_implementation;
+        _sodium_implementation_selected("chacha20", "ssse3");
+        return 0;
+    }
+#endif
+#if defined(HAVE_WASM_SIMD128)
+    /* The module would not load on a runtime without SIMD support */
+    if (_sodium_implementation_allowed("chacha20", "simd128")) {
+        implementation = &crypto_stream_chacha20_simd128_implementation;
+        _sodium_implementation_selected("chacha20", "simd128");
         return 0;
     }
+#endif
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_neon() &&
+        _sodium_implementation_allowed("chacha20", "neon")) {
+        implementation = &crypto_stream_chacha20_neon_implementation;
+        _sodium_implementation_selected("chacha20", "neon");
+        return 0;
+    }
+#endif
+#if defined(HAVE_VSX) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_vsx() &&
+        _sodium_implementation_allowed("chacha20", "vsx")) {
+        implementation = &crypto_stream_chacha20_vsx_implementation;
+        _sodium_implementation_selected("chacha20", "vsx");
+        return 0;
+    }
+#endif
+#if defined(HAVE_RVV) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_rvv() &&
+        _sodium_implementation_allowed("chacha20", "rvv")) {
+        implementation = &crypto_stream_chacha20_rvv_implementation;
+        _sodium_implementation_selected("chacha20", "rvv");
+        return 0;
+    }
+#endif
 #endif
     return 0;
 }
@@ -17,6 +17,11 @@ typedef struct crypto_stream_chacha20_implementation {
                                   unsigned long long mlen,
                                   const unsigned char *n, uint32_t ic,
                                   const unsigned char *k);
+    void (*blocks8)(unsigned char *ks, const uint32_t x[16][8]);
+    int (*stream_rounds_xor_ic)(unsigned char *c, const unsigned char *m,
+                                unsigned long long mlen,
+                                const unsigned char *n, uint64_t ic,
+                                const unsigned char *k, int rounds);
 } crypto_stream_chacha20_implementation;
 
 #endif
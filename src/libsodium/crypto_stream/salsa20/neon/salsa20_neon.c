@@ -0,0 +1,200 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crypto_stream_salsa20.h"
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+
+# include <arm_neon.h>
+
+# include "../stream_salsa20.h"
+# include "salsa20_neon.h"
+
+# define ROUNDS 20
+
+# define VEC4_ROT(A, IMM) vsriq_n_u32(vshlq_n_u32((A), (IMM)), (A), 32 - (IMM))
+
+# define VEC4_QUARTERROUND(A, B, C, D)                              \
+    do {                                                            \
+        v[B] = veorq_u32(v[B], VEC4_ROT(vaddq_u32(v[A], v[D]), 7));  \
+        v[C] = veorq_u32(v[C], VEC4_ROT(vaddq_u32(v[B], v[A]), 9));  \
+        v[D] = veorq_u32(v[D], VEC4_ROT(vaddq_u32(v[C], v[B]), 13)); \
+        v[A] = veorq_u32(v[A], VEC4_ROT(vaddq_u32(v[D], v[C]), 18)); \
+    } while (0)
+
+typedef struct salsa_ctx {
+    uint32_t input[16];
+} salsa_ctx;
+
+static void
+salsa_keysetup(salsa_ctx *ctx, const uint8_t *k)
+{
+    ctx->input[1]  = LOAD32_LE(k + 0);
+    ctx->input[2]  = LOAD32_LE(k + 4);
+    ctx->input[3]  = LOAD32_LE(k + 8);
+    ctx->input[4]  = LOAD32_LE(k + 12);
+    ctx->input[11] = LOAD32_LE(k + 16);
+    ctx->input[12] = LOAD32_LE(k + 20);
+    ctx->input[13] = LOAD32_LE(k + 24);
+    ctx->input[14] = LOAD32_LE(k + 28);
+    ctx->input[0]  = 0x61707865;
+    ctx->input[5]  = 0x3320646e;
+    ctx->input[10] = 0x79622d32;
+    ctx->input[15] = 0x6b206574;
+}
+
+static void
+salsa_ivsetup(salsa_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
+{
+    ctx->input[6] = LOAD32_LE(iv + 0);
+    ctx->input[7] = LOAD32_LE(iv + 4);
+    ctx->input[8] = counter == NULL ? 0 : LOAD32_LE(counter + 0);
+    ctx->input[9] = counter == NULL ? 0 : LOAD32_LE(counter + 4);
+}
+
+/* transpose 4 words of 4 blocks and xor them with the matching input
+ * words; c and m point to the first block */
+static inline void
+xor_quad(uint8_t *c, const uint8_t *m, const uint32x4_t a, const uint32x4_t b,
+         const uint32x4_t cc, const uint32x4_t d)
+{
+    const uint32x4x2_t t01 = vtrnq_u32(a, b);
+    const uint32x4x2_t t23 = vtrnq_u32(cc, d);
+    uint32x4_t         r0, r1, r2, r3;
+
+    r0 = vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]));
+    r1 = vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]));
+    r2 = vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]));
+    r3 = vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]));
+    vst1q_u8(c + 0, veorq_u8(vreinterpretq_u8_u32(r0), vld1q_u8(m + 0)));
+    vst1q_u8(c + 64, veorq_u8(vreinterpretq_u8_u32(r1), vld1q_u8(m + 64)));
+    vst1q_u8(c + 128, veorq_u8(vreinterpretq_u8_u32(r2), vld1q_u8(m + 128)));
+    vst1q_u8(c + 192, veorq_u8(vreinterpretq_u8_u32(r3), vld1q_u8(m + 192)));
+}
+
+/* 4 consecutive blocks, one state word of every block per vector */
+static void
+salsa20_blocks4(uint32_t x[16], const uint8_t *m, uint8_t *c)
+{
+    uint32x4_t v[16];
+    uint32x4_t orig[16];
+    uint32_t   in8[4];
+    uint32_t   in9[4];
+    uint64_t   in89;
+    int        i;
+
+    in89 = ((uint64_t) x[8]) | (((uint64_t) x[9]) << 32);
+    for (i = 0; i < 4; i++) {
+        in8[i] = (uint32_t) (in89 + (uint64_t) i);
+        in9[i] = (uint32_t) ((in89 + (uint64_t) i) >> 32);
+    }
+    in89 += 4;
+    x[8] = in89 & 0xFFFFFFFF;
+    x[9] = (in89 >> 32) & 0xFFFFFFFF;
+
+    for (i = 0; i < 16; i++) {
+        orig[i] = vdupq_n_u32(x[i]);
+    }
+    orig[8] = vld1q_u32(in8);
+    orig[9] = vld1q_u32(in9);
+    for (i = 0; i < 16; i++) {
+        v[i] = orig[i];
+    }
+    for (i = 0; i < ROUNDS; i += 2) {
+        VEC4_QUARTERROUND(0, 4, 8, 12);
+        VEC4_QUARTERROUND(5, 9, 13, 1);
+        VEC4_QUARTERROUND(10, 14, 2, 6);
+        VEC4_QUARTERROUND(15, 3, 7, 11);
+        VEC4_QUARTERROUND(0, 1, 2, 3);
+        VEC4_QUARTERROUND(5, 6, 7, 4);
+        VEC4_QUARTERROUND(10, 11, 8, 9);
+        VEC4_QUARTERROUND(15, 12, 13, 14);
+    }
+    for (i = 0; i < 16; i++) {
+        v[i] = vaddq_u32(v[i], orig[i]);
+    }
+    xor_quad(c + 0, m + 0, v[0], v[1], v[2], v[3]);
+    xor_quad(c + 16, m + 16, v[4], v[5], v[6], v[7]);
+    xor_quad(c + 32, m + 32, v[8], v[9], v[10], v[11]);
+    xor_quad(c + 48, m + 48, v[12], v[13], v[14], v[15]);
+}
+
+static void
+salsa20_encrypt_bytes(salsa_ctx *ctx, const uint8_t *m, uint8_t *c,
+                      unsigned long long bytes)
+{
+    uint32_t * const x = &ctx->input[0];
+    uint8_t          partial[256];
+
+    if (!bytes) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    while (bytes >= 256) {
+        salsa20_blocks4(x, m, c);
+        bytes -= 256;
+        c += 256;
+        m += 256;
+    }
+    if (bytes > 0) {
+        memset(partial, 0, sizeof partial);
+        memcpy(partial, m, (size_t) bytes);
+        salsa20_blocks4(x, partial, partial);
+        memcpy(c, partial, (size_t) bytes);
+        sodium_memzero(partial, sizeof partial);
+    }
+}
+
+static int
+stream_neon(unsigned char *c, unsigned long long clen, const unsigned char *n,
+            const unsigned char *k)
+{
+    struct salsa_ctx ctx;
+
+    if (!clen) {
+        return 0;
+    }
+    COMPILER_ASSERT(crypto_stream_salsa20_KEYBYTES == 256 / 8);
+    salsa_keysetup(&ctx, k);
+    salsa_ivsetup(&ctx, n, NULL);
+    memset(c, 0, clen);
+    salsa20_encrypt_bytes(&ctx, c, c, clen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+static int
+stream_neon_xor_ic(unsigned char *c, const unsigned char *m,
+                   unsigned long long mlen, const unsigned char *n, uint64_t ic,
+                   const unsigned char *k)
+{
+    struct salsa_ctx ctx;
+    uint8_t          ic_bytes[8];
+    uint32_t         ic_high;
+    uint32_t         ic_low;
+
+    if (!mlen) {
+        return 0;
+    }
+    ic_high = (uint32_t) (ic >> 32);
+    ic_low  = (uint32_t) (ic);
+    STORE32_LE(&ic_bytes[0], ic_low);
+    STORE32_LE(&ic_bytes[4], ic_high);
+    salsa_keysetup(&ctx, k);
+    salsa_ivsetup(&ctx, n, ic_bytes);
+    salsa20_encrypt_bytes(&ctx, m, c, mlen);
+    sodium_memzero(&ctx, sizeof ctx);
+
+    return 0;
+}
+
+struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa20_neon_implementation = {
+        SODIUM_C99(.stream =) stream_neon,
+        SODIUM_C99(.stream_xor_ic =) stream_neon_xor_ic
+    };
+
+#endif
@@ -1,6 +1,7 @@
 #include "crypto_stream_salsa20.h"
 #include "private/common.h"
 #include "private/implementations.h"
+#include "private/stats.h"
 #include "randombytes.h"
 #include "runtime.h"
 #include "stream_salsa20.h"
@@ -13,12 +14,41 @@
 #if !defined(HAVE_AMD64_ASM) && defined(HAVE_EMMINTRIN_H)
 # include "xmm6int/salsa20_xmm6int-sse2.h"
 #endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+# include "xmm6int/salsa20_xmm6int-avx512f.h"
+#endif
 #if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
     defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
 # include "xmm6int/salsa20_xmm6int-avx2.h"
 #endif
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+# include "neon/salsa20_neon.h"
+#endif
+
+/* With --with-isa, the implementation for the baseline is fixed */
+#if defined(FIXED_ISA) && defined(__AVX512F__) && \
+    defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+# define FIXED_IMPLEMENTATION crypto_stream_salsa20_xmm6int_avx512f_implementation
+# define FIXED_NAME "avx512f"
+#elif defined(FIXED_ISA) && defined(__AVX2__) && \
+    defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# define FIXED_IMPLEMENTATION crypto_stream_salsa20_xmm6int_avx2_implementation
+# define FIXED_NAME "avx2"
+#elif defined(FIXED_ISA) && defined(__ARM_NEON) && \
+    defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+# define FIXED_IMPLEMENTATION crypto_stream_salsa20_neon_implementation
+# define FIXED_NAME "neon"
+#endif
 
-#if HAVE_AMD64_ASM
+#ifdef FIXED_NAME
+static const crypto_stream_salsa20_implementation *const implementation =
+    &FIXED_IMPLEMENTATION;
+#elif HAVE_AMD64_ASM
 static const crypto_stream_salsa20_implementation *implementation =
     &crypto_stream_salsa20_xmm6_implementation;
 #else
@@ -48,7 +78,13 @@ int
 crypto_stream_salsa20(unsigned char *c, unsigned long long clen,
                       const unsigned char *n, const unsigned char *k)
 {
-    return implementation->stream(c, clen, n, k);
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = implementation->stream(c, clen, n, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, clen);
+
+    return ret;
 }
 
 int
@@ -57,7 +93,13 @@ crypto_stream_salsa20_xor_ic(unsigned char *c, const unsigned char *m,
                              const unsigned char *n, uint64_t ic,
                              const unsigned char *k)
 {
-    return implementation->stream_xor_ic(c, m, mlen, n, ic, k);
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = implementation->stream_xor_ic(c, m, mlen, n, ic, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
 }
 
 int
@@ -65,7 +107,13 @@ crypto_stream_salsa20_xor(unsigned char *c, const unsigned char *m,
                           unsigned long long mlen, const unsigned char *n,
                           const unsigned char *k)
 {
-    return implementation->stream_xor_ic(c, m, mlen, n, 0U, k);
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = implementation->stream_xor_ic(c, m, mlen, n, 0U, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
 }
 
 void
@@ -77,24 +125,54 @@ crypto_stream_salsa20_keygen(unsigned char k[crypto_stream_salsa20_KEYBYTES])
 int
 _crypto_stream_salsa20_pick_best_implementation(void)
 {
+#ifdef FIXED_NAME
+    _sodium_implementation_selected("salsa20", FIXED_NAME);
+
+    return 0;
+#else
 #ifdef HAVE_AMD64_ASM
     implementation = &crypto_stream_salsa20_xmm6_implementation;
+    _sodium_implementation_selected("salsa20", "xmm6");
 #else
     implementation = &crypto_stream_salsa20_ref_implementation;
+    _sodium_implementation_selected("salsa20", "ref");
 #endif
 
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors() &&
+        _sodium_implementation_allowed("salsa20", "avx512f")) {
+        implementation = &crypto_stream_salsa20_xmm6int_avx512f_implementation;
+        _sodium_implementation_selected("salsa20", "avx512f");
+        return 0;
+    }
+#endif
 #if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
     defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
-    if (sodium_runtime_has_avx2()) {
+    if (sodium_runtime_has_avx2() &&
+        _sodium_implementation_allowed("salsa20", "avx2")) {
         implementation = &crypto_stream_salsa20_xmm6int_avx2_implementation;
+        _sodium_implementation_selected("salsa20", "avx2");
         return 0;
     }
 #endif
 #if !defined(HAVE_AMD64_ASM) && defined(HAVE_EMMINTRIN_H)
-    if (sodium_runtime_has_sse2()) {
+    if (sodium_runtime_has_sse2() &&
+        _sodium_implementation_allowed("salsa20", "sse2")) {
         implementation = &crypto_stream_salsa20_xmm6int_sse2_implementation;
+        _sodium_implementation_selected("salsa20", "sse2");
+        return 0;
+    }
+#endif
+#if defined(HAVE_ARMNEON) && defined(NATIVE_LITTLE_ENDIAN)
+    if (sodium_runtime_has_neon() &&
+        _sodium_implementation_allowed("salsa20", "neon")) {
+        implementation = &crypto_stream_salsa20_neon_implementation;
+        _sodium_implementation_selected("salsa20", "neon");
         return 0;
     }
 #endif
     return 0; /* LCOV_EXCL_LINE */
+#endif
 }
@@ -0,0 +1,12 @@
+
+#include <stdint.h>
+
+#include "../stream_salsa20.h"
+#include "crypto_stream_salsa20.h"
+
+extern struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa20_xmm6int_avx512f_implementation;
+extern struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa2012_xmm6int_avx512f_implementation;
+extern struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa208_xmm6int_avx512f_implementation;
@@ -18,8 +18,6 @@
 # include "../stream_salsa20.h"
 # include "salsa20_xmm6int-sse2.h"
 
-# define ROUNDS 20
-
 typedef struct salsa_ctx {
     uint32_t input[16];
 } salsa_ctx;
@@ -56,7 +54,7 @@ salsa_ivsetup(salsa_ctx *ctx, const uint8_t *iv, const uint8_t *counter)
 
 static void
 salsa20_encrypt_bytes(salsa_ctx *ctx, const uint8_t *m, uint8_t *c,
-                      unsigned long long bytes)
+                      unsigned long long bytes, const int rounds)
 {
     uint32_t * const x = &ctx->input[0];
 
@@ -70,8 +68,9 @@ salsa20_encrypt_bytes(salsa_ctx *ctx, const uint8_t *m, uint8_t *c,
 }
 
 static int
-stream_sse2(unsigned char *c, unsigned long long clen, const unsigned char *n,
-            const unsigned char *k)
+stream_sse2_rounds(unsigned char *c, unsigned long long clen,
+                   const unsigned char *n, const unsigned char *k,
+                   const int rounds)
 {
     struct salsa_ctx ctx;
 
@@ -82,16 +81,17 @@ stream_sse2(unsigned char *c, unsigned long long clen, const unsigned char *n,
     salsa_keysetup(&ctx, k);
     salsa_ivsetup(&ctx, n, NULL);
     memset(c, 0, clen);
-    salsa20_encrypt_bytes(&ctx, c, c, clen);
+    salsa20_encrypt_bytes(&ctx, c, c, clen, rounds);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
 }
 
 static int
-stream_sse2_xor_ic(unsigned char *c, const unsigned char *m,
-                   unsigned long long mlen, const unsigned char *n, uint64_t ic,
-                   const unsigned char *k)
+stream_sse2_xor_ic_rounds(unsigned char *c, const unsigned char *m,
+                          unsigned long long mlen, const unsigned char *n,
+                          uint64_t ic, const unsigned char *k,
+                          const int rounds)
 {
     struct salsa_ctx ctx;
     uint8_t          ic_bytes[8];
@@ -107,16 +107,75 @@ stream_sse2_xor_ic(unsigned char *c, const unsigned char *m,
     STORE32_LE(&ic_bytes[4], ic_high);
     salsa_keysetup(&ctx, k);
     salsa_ivsetup(&ctx, n, ic_bytes);
-    salsa20_encrypt_bytes(&ctx, m, c, mlen);
+    salsa20_encrypt_bytes(&ctx, m, c, mlen, rounds);
     sodium_memzero(&ctx, sizeof ctx);
 
     return 0;
 }
 
+static int
+stream_sse2(unsigned char *c, unsigned long long clen, const unsigned char *n,
+            const unsigned char *k)
+{
+    return stream_sse2_rounds(c, clen, n, k, 20);
+}
+
+static int
+stream_sse2_xor_ic(unsigned char *c, const unsigned char *m,
+                   unsigned long long mlen, const unsigned char *n, uint64_t ic,
+                   const unsigned char *k)
+{
+    return stream_sse2_xor_ic_rounds(c, m, mlen, n, ic, k, 20);
+}
+
+static int
+stream_salsa2012_sse2(unsigned char *c, unsigned long long clen,
+                      const unsigned char *n, const unsigned char *k)
+{
+    return stream_sse2_rounds(c, clen, n, k, 12);
+}
+
+static int
+stream_salsa2012_sse2_xor_ic(unsigned char *c, const unsigned char *m,
+                             unsigned long long mlen,
+                             const unsigned char *n, uint64_t ic,
+                             const unsigned char *k)
+{
+    return stream_sse2_xor_ic_rounds(c, m, mlen, n, ic, k, 12);
+}
+
+static int
+stream_salsa208_sse2(unsigned char *c, unsigned long long clen,
+                     const unsigned char *n, const unsigned char *k)
+{
+    return stream_sse2_rounds(c, clen, n, k, 8);
+}
+
+static int
+stream_salsa208_sse2_xor_ic(unsigned char *c, const unsigned char *m,
+                            unsigned long long mlen,
+                            const unsigned char *n, uint64_t ic,
+                            const unsigned char *k)
+{
+    return stream_sse2_xor_ic_rounds(c, m, mlen, n, ic, k, 8);
+}
+
 struct crypto_stream_salsa20_implementation
     crypto_stream_salsa20_xmm6int_sse2_implementation = {
         SODIUM_C99(.stream =) stream_sse2,
         SODIUM_C99(.stream_xor_ic =) stream_sse2_xor_ic
     };
 
+struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa2012_xmm6int_sse2_implementation = {
+        SODIUM_C99(.stream =) stream_salsa2012_sse2,
+        SODIUM_C99(.stream_xor_ic =) stream_salsa2012_sse2_xor_ic
+    };
+
+struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa208_xmm6int_sse2_implementation = {
+        SODIUM_C99(.stream =) stream_salsa208_sse2,
+        SODIUM_C99(.stream_xor_ic =) stream_salsa208_sse2_xor_ic
+    };
+
 #endif
@@ -6,3 +6,7 @@
 
 extern struct crypto_stream_salsa20_implementation
     crypto_stream_salsa20_xmm6int_sse2_implementation;
+extern struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa2012_xmm6int_sse2_implementation;
+extern struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa208_xmm6int_sse2_implementation;
@@ -7,10 +7,10 @@ if (bytes > 0) {
     __m128i b0, b1, b2, b3, b4, b5, b6, b7;
     uint8_t partialblock[64];
 
-    unsigned int i;
+    int i;
 
     a0 = diag1;
-    for (i = 0; i < ROUNDS; i += 4) {
+    for (i = 0; i < rounds; i += 4) {
         a0    = _mm_add_epi32(a0, diag0);
         a1    = diag0;
         b0    = a0;
@@ -11,7 +11,7 @@ while (bytes >= 64) {
     int      i;
 
     a0 = diag1;
-    for (i = 0; i < ROUNDS; i += 4) {
+    for (i = 0; i < rounds; i += 4) {
         a0    = _mm_add_epi32(a0, diag0);
         a1    = diag0;
         b0    = a0;
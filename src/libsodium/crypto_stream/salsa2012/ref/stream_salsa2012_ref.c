@@ -10,9 +10,12 @@ Public domain.
 #include "crypto_stream_salsa2012.h"
 #include "utils.h"
 
-int
-crypto_stream_salsa2012(unsigned char *c, unsigned long long clen,
-                        const unsigned char *n, const unsigned char *k)
+#include "../../salsa20/stream_salsa20.h"
+#include "stream_salsa2012_ref.h"
+
+static int
+stream_ref(unsigned char *c, unsigned long long clen, const unsigned char *n,
+           const unsigned char *k)
 {
     unsigned char in[16];
     unsigned char block[64];
@@ -55,10 +58,10 @@ crypto_stream_salsa2012(unsigned char *c, unsigned long long clen,
     return 0;
 }
 
-int
-crypto_stream_salsa2012_xor(unsigned char *c, const unsigned char *m,
-                            unsigned long long mlen, const unsigned char *n,
-                            const unsigned char *k)
+static int
+stream_ref_xor_ic(unsigned char *c, const unsigned char *m,
+                  unsigned long long mlen, const unsigned char *n, uint64_t ic,
+                  const unsigned char *k)
 {
     unsigned char in[16];
     unsigned char block[64];
@@ -76,7 +79,8 @@ crypto_stream_salsa2012_xor(unsigned char *c, const unsigned char *m,
         in[i] = n[i];
     }
     for (i = 8; i < 16; ++i) {
-        in[i] = 0;
+        in[i] = (unsigned char) (ic & 0xff);
+        ic >>= 8;
     }
     while (mlen >= 64) {
         crypto_core_salsa2012(block, in, kcopy, NULL);
@@ -104,3 +108,9 @@ crypto_stream_salsa2012_xor(unsigned char *c, const unsigned char *m,
 
     return 0;
 }
+
+struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa2012_ref_implementation = {
+        SODIUM_C99(.stream =) stream_ref,
+        SODIUM_C99(.stream_xor_ic =) stream_ref_xor_ic
+    };
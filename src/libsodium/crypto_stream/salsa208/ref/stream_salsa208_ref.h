@@ -0,0 +1,8 @@
+
+#include <stdint.h>
+
+#include "../../salsa20/stream_salsa20.h"
+#include "crypto_stream_salsa208.h"
+
+extern struct crypto_stream_salsa20_implementation
+    crypto_stream_salsa208_ref_implementation;
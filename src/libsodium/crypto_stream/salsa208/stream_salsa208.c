@@ -1,5 +1,46 @@
 #include "crypto_stream_salsa208.h"
+#include "private/common.h"
+#include "private/implementations.h"
+#include "private/stats.h"
 #include "randombytes.h"
+#include "runtime.h"
+
+#include "../salsa20/stream_salsa20.h"
+#include "ref/stream_salsa208_ref.h"
+#if defined(HAVE_EMMINTRIN_H)
+# include "../salsa20/xmm6int/salsa20_xmm6int-sse2.h"
+#endif
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+# include "../salsa20/xmm6int/salsa20_xmm6int-avx512f.h"
+#endif
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# include "../salsa20/xmm6int/salsa20_xmm6int-avx2.h"
+#endif
+
+/* With --with-isa, the implementation for the baseline is fixed */
+#if defined(FIXED_ISA) && defined(__AVX512F__) && \
+    defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+# define FIXED_IMPLEMENTATION crypto_stream_salsa208_xmm6int_avx512f_implementation
+# define FIXED_NAME "avx512f"
+#elif defined(FIXED_ISA) && defined(__AVX2__) && \
+    defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+# define FIXED_IMPLEMENTATION crypto_stream_salsa208_xmm6int_avx2_implementation
+# define FIXED_NAME "avx2"
+#endif
+
+#ifdef FIXED_NAME
+static const crypto_stream_salsa20_implementation *const implementation =
+    &FIXED_IMPLEMENTATION;
+#else
+static const crypto_stream_salsa20_implementation *implementation =
+    &crypto_stream_salsa208_ref_implementation;
+#endif
 
 size_t
 crypto_stream_salsa208_keybytes(void)
@@ -19,8 +60,77 @@ crypto_stream_salsa208_messagebytes_max(void)
     return crypto_stream_salsa208_MESSAGEBYTES_MAX;
 }
 
+int
+crypto_stream_salsa208(unsigned char *c, unsigned long long clen,
+                       const unsigned char *n, const unsigned char *k)
+{
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = implementation->stream(c, clen, n, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, clen);
+
+    return ret;
+}
+
+int
+crypto_stream_salsa208_xor(unsigned char *c, const unsigned char *m,
+                           unsigned long long mlen, const unsigned char *n,
+                           const unsigned char *k)
+{
+    int ret;
+    SODIUM_STATS_START(stats_start)
+
+    ret = implementation->stream_xor_ic(c, m, mlen, n, 0U, k);
+    SODIUM_STATS_STOP(stats_start, SODIUM_STATS_STREAM, mlen);
+
+    return ret;
+}
+
 void
 crypto_stream_salsa208_keygen(unsigned char k[crypto_stream_salsa208_KEYBYTES])
 {
     randombytes_buf(k, crypto_stream_salsa208_KEYBYTES);
 }
+
+int
+_crypto_stream_salsa208_pick_best_implementation(void)
+{
+#ifdef FIXED_NAME
+    _sodium_implementation_selected("salsa208", FIXED_NAME);
+
+    return 0;
+#else
+    implementation = &crypto_stream_salsa208_ref_implementation;
+    _sodium_implementation_selected("salsa208", "ref");
+
+#if defined(HAVE_AVX512FINTRIN_H) && defined(HAVE_AVX2INTRIN_H) && \
+    defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H) && \
+    defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx512f() && _sodium_runtime_use_512bit_vectors() &&
+        _sodium_implementation_allowed("salsa208", "avx512f")) {
+        implementation = &crypto_stream_salsa208_xmm6int_avx512f_implementation;
+        _sodium_implementation_selected("salsa208", "avx512f");
+        return 0;
+    }
+#endif
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2() &&
+        _sodium_implementation_allowed("salsa208", "avx2")) {
+        implementation = &crypto_stream_salsa208_xmm6int_avx2_implementation;
+        _sodium_implementation_selected("salsa208", "avx2");
+        return 0;
+    }
+#endif
+#if defined(HAVE_EMMINTRIN_H)
+    if (sodium_runtime_has_sse2() &&
+        _sodium_implementation_allowed("salsa208", "sse2")) {
+        implementation = &crypto_stream_salsa208_xmm6int_sse2_implementation;
+        _sodium_implementation_selected("salsa208", "sse2");
+        return 0;
+    }
+#endif
+    return 0; /* LCOV_EXCL_LINE */
+#endif
+}
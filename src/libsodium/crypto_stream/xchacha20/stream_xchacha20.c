@@ -53,6 +53,21 @@ crypto_stream_xchacha20_xor_ic(unsigned char *c, const unsigned char *m,
         c, m, mlen, n + crypto_core_hchacha20_INPUTBYTES, ic, k2);
 }
 
+int
+crypto_stream_xchacha20_xor_ic_parallel(unsigned char *c,
+                                        const unsigned char *m,
+                                        unsigned long long mlen,
+                                        const unsigned char *n, uint64_t ic,
+                                        const unsigned char *k,
+                                        unsigned int threads)
+{
+    unsigned char k2[crypto_core_hchacha20_OUTPUTBYTES];
+
+    crypto_core_hchacha20(k2, n, k, NULL);
+    return crypto_stream_chacha20_xor_ic_parallel(
+        c, m, mlen, n + crypto_core_hchacha20_INPUTBYTES, ic, k2, threads);
+}
+
 int
 crypto_stream_xchacha20_xor(unsigned char *c, const unsigned char *m,
                             unsigned long long mlen, const unsigned char *n,
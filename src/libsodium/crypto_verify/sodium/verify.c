@@ -1,10 +1,12 @@
-
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
+#include "crypto_verify.h"
 #include "crypto_verify_16.h"
 #include "crypto_verify_32.h"
 #include "crypto_verify_64.h"
+#include "private/aliases.h"
 #include "private/common.h"
 
 size_t
@@ -25,75 +27,132 @@ crypto_verify_64_bytes(void)
     return crypto_verify_64_BYTES;
 }
 
-#if defined(HAVE_EMMINTRIN_H) && defined(__SSE2__)
+/*
+ * 256-bit loads are only used when the whole library targets AVX2: for
+ * 32 and 64 bytes, dispatching at runtime would cost more than it saves.
+ */
+#if defined(HAVE_AVX2INTRIN_H) && defined(__AVX2__)
+# ifdef __GNUC__
+#  pragma GCC target("avx2")
+# endif
+# include <immintrin.h>
+# define VERIFY_AVX2
+#endif
 
+#if defined(HAVE_EMMINTRIN_H) && defined(__SSE2__)
 # ifdef __GNUC__
 #  pragma GCC target("sse2")
 # endif
 # include <emmintrin.h>
+# define VERIFY_SSE2
+#elif defined(HAVE_ARMNEON)
+# include <arm_neon.h>
+# define VERIFY_NEON
+#endif
 
-static inline int
-crypto_verify_n(const unsigned char *x_, const unsigned char *y_,
-                const int n)
+/*
+ * Returns the OR of the 64-bit words of x ^ y. Full vectors are compared
+ * first, then words, then the remaining bytes; only the length decides
+ * which loads are made.
+ */
+static inline uint64_t
+verify_diff(const unsigned char *x, const unsigned char *y, const size_t len)
 {
-    const    __m128i zero = _mm_setzero_si128();
-    volatile __m128i v1, v2, z;
-    volatile int     m;
-    int              i;
-
-    const volatile __m128i *volatile x =
-        (const volatile __m128i *volatile) (const void *) x_;
-    const volatile __m128i *volatile y =
-        (const volatile __m128i *volatile) (const void *) y_;
-    v1 = _mm_loadu_si128((const __m128i *) &x[0]);
-    v2 = _mm_loadu_si128((const __m128i *) &y[0]);
-    z = _mm_xor_si128(v1, v2);
-    for (i = 1; i < n / 16; i++) {
-        v1 = _mm_loadu_si128((const __m128i *) &x[i]);
-        v2 = _mm_loadu_si128((const __m128i *) &y[i]);
-        z = _mm_or_si128(z, _mm_xor_si128(v1, v2));
+    uint64_t d = 0U;
+    uint64_t w1, w2;
+    size_t   i = 0U;
+
+#ifdef VERIFY_AVX2
+    if (len >= 32U) {
+        __m256i  z = _mm256_setzero_si256();
+        uint64_t t[4];
+
+        for (; len - i >= 32U; i += 32U) {
+            z = _mm256_or_si256
+                (z, _mm256_xor_si256
+                 (_mm256_loadu_si256((const __m256i *) (const void *) (x + i)),
+                  _mm256_loadu_si256((const __m256i *) (const void *) (y + i))));
+        }
+        _mm256_storeu_si256((__m256i *) (void *) t, z);
+        d = t[0] | t[1] | t[2] | t[3];
     }
-    m = _mm_movemask_epi8(_mm_cmpeq_epi32(z, zero));
-    v1 = zero; v2 = zero; z = zero;
-
-    return (int) (((uint32_t) m + 1U) >> 16) - 1;
+#endif
+#if defined(VERIFY_SSE2)
+    if (len - i >= 16U) {
+        __m128i  z = _mm_setzero_si128();
+        uint64_t t[2];
+
+        for (; len - i >= 16U; i += 16U) {
+            z = _mm_or_si128
+                (z, _mm_xor_si128
+                 (_mm_loadu_si128((const __m128i *) (const void *) (x + i)),
+                  _mm_loadu_si128((const __m128i *) (const void *) (y + i))));
+        }
+        _mm_storeu_si128((__m128i *) (void *) t, z);
+        d |= t[0] | t[1];
+    }
+#elif defined(VERIFY_NEON)
+    if (len - i >= 16U) {
+        uint8x16_t  z = vdupq_n_u8(0);
+        uint64x2_t  z64;
+
+        for (; len - i >= 16U; i += 16U) {
+            z = vorrq_u8(z, veorq_u8(vld1q_u8(x + i), vld1q_u8(y + i)));
+        }
+        z64 = vreinterpretq_u64_u8(z);
+        d |= vgetq_lane_u64(z64, 0) | vgetq_lane_u64(z64, 1);
+    }
+#endif
+    for (; len - i >= 8U; i += 8U) {
+        memcpy(&w1, x + i, 8U);
+        memcpy(&w2, y + i, 8U);
+        d |= w1 ^ w2;
+    }
+    for (; i < len; i++) {
+        d |= (uint64_t) (x[i] ^ y[i]);
+    }
+    return d;
 }
 
-#else
-
 static inline int
-crypto_verify_n(const unsigned char *x_, const unsigned char *y_,
-                const int n)
+verify_result(uint64_t d)
 {
-    const volatile unsigned char *volatile x =
-        (const volatile unsigned char *volatile) x_;
-    const volatile unsigned char *volatile y =
-        (const volatile unsigned char *volatile) y_;
-    volatile uint_fast16_t d = 0U;
-    int i;
-
-    for (i = 0; i < n; i++) {
-        d |= x[i] ^ y[i];
-    }
-    return (1 & ((d - 1) >> 8)) - 1;
-}
+    volatile uint_fast16_t b;
 
+#ifdef HAVE_INLINE_ASM
+    __asm__ __volatile__("" : "+r"(d));
 #endif
+    d |= d >> 32;
+    d |= d >> 16;
+    d |= d >> 8;
+    b = (uint_fast16_t) (d & 0xff);
+
+    return (1 & ((b - 1) >> 8)) - 1;
+}
+
+int
+crypto_verify_n(const unsigned char *x, const unsigned char *y,
+                const size_t len)
+{
+    return verify_result(verify_diff(x, y, len));
+}
 
 int
 crypto_verify_16(const unsigned char *x, const unsigned char *y)
 {
-    return crypto_verify_n(x, y, crypto_verify_16_BYTES);
+    return verify_result(verify_diff(x, y, crypto_verify_16_BYTES));
 }
+SODIUM_ALIAS_DEF(crypto_verify_16);
 
 int
 crypto_verify_32(const unsigned char *x, const unsigned char *y)
 {
-    return crypto_verify_n(x, y, crypto_verify_32_BYTES);
+    return verify_result(verify_diff(x, y, crypto_verify_32_BYTES));
 }
+SODIUM_ALIAS_DEF(crypto_verify_32);
 
 int
 crypto_verify_64(const unsigned char *x, const unsigned char *y)
 {
-    return crypto_verify_n(x, y, crypto_verify_64_BYTES);
+    return verify_result(verify_diff(x, y, crypto_verify_64_BYTES));
 }
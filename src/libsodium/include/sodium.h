@@ -6,9 +6,13 @@
 
 #include "sodium/core.h"
 #include "sodium/crypto_aead_aes256gcm.h"
+#include "sodium/crypto_aead_aes256gcmsiv.h"
 #include "sodium/crypto_aead_aegis128l.h"
+#include "sodium/crypto_aead_aegis128x.h"
 #include "sodium/crypto_aead_aegis256.h"
+#include "sodium/crypto_aead_aegis256x.h"
 #include "sodium/crypto_aead_chacha20poly1305.h"
+#include "sodium/crypto_aead_iovec.h"
 #include "sodium/crypto_aead_xchacha20poly1305.h"
 #include "sodium/crypto_auth.h"
 #include "sodium/crypto_auth_hmacsha256.h"
@@ -21,13 +25,19 @@
 #include "sodium/crypto_core_salsa20.h"
 #include "sodium/crypto_core_salsa2012.h"
 #include "sodium/crypto_core_salsa208.h"
+#include "sodium/crypto_file.h"
 #include "sodium/crypto_generichash.h"
 #include "sodium/crypto_generichash_blake2b.h"
+#include "sodium/crypto_generichash_blake2bp.h"
+#include "sodium/crypto_generichash_blake2xb.h"
+#include "sodium/crypto_generichash_blake2b_tree.h"
+#include "sodium/crypto_generichash_blake3.h"
 #include "sodium/crypto_hash.h"
 #include "sodium/crypto_hash_sha256.h"
 #include "sodium/crypto_hash_sha512.h"
 #include "sodium/crypto_kdf.h"
 #include "sodium/crypto_kdf_blake2b.h"
+#include "sodium/crypto_keywrap.h"
 #include "sodium/crypto_kx.h"
 #include "sodium/crypto_onetimeauth.h"
 #include "sodium/crypto_onetimeauth_poly1305.h"
@@ -37,22 +47,29 @@
 #include "sodium/crypto_scalarmult_curve25519.h"
 #include "sodium/crypto_secretbox.h"
 #include "sodium/crypto_secretbox_xsalsa20poly1305.h"
+#include "sodium/crypto_secretstream_aegis256.h"
 #include "sodium/crypto_secretstream_xchacha20poly1305.h"
 #include "sodium/crypto_shorthash.h"
 #include "sodium/crypto_shorthash_siphash24.h"
 #include "sodium/crypto_sign.h"
 #include "sodium/crypto_sign_ed25519.h"
 #include "sodium/crypto_stream.h"
+#include "sodium/crypto_stream_aes256ctr.h"
+#include "sodium/crypto_stream_chacha12.h"
 #include "sodium/crypto_stream_chacha20.h"
+#include "sodium/crypto_stream_chacha8.h"
 #include "sodium/crypto_stream_salsa20.h"
 #include "sodium/crypto_stream_xsalsa20.h"
+#include "sodium/crypto_verify.h"
 #include "sodium/crypto_verify_16.h"
 #include "sodium/crypto_verify_32.h"
 #include "sodium/crypto_verify_64.h"
+#include "sodium/jobs.h"
 #include "sodium/randombytes.h"
 #include "sodium/randombytes_internal_random.h"
 #include "sodium/randombytes_sysrandom.h"
 #include "sodium/runtime.h"
+#include "sodium/stats.h"
 #include "sodium/utils.h"
 
 #ifndef SODIUM_LIBRARY_MINIMAL
@@ -64,6 +81,8 @@
 # include "sodium/crypto_scalarmult_ed25519.h"
 # include "sodium/crypto_scalarmult_ristretto255.h"
 # include "sodium/crypto_secretbox_xchacha20poly1305.h"
+# include "sodium/crypto_pwhash_pbkdf2_sha256.h"
+# include "sodium/crypto_pwhash_pbkdf2_sha512.h"
 # include "sodium/crypto_pwhash_scryptsalsa208sha256.h"
 # include "sodium/crypto_stream_salsa2012.h"
 # include "sodium/crypto_stream_salsa208.h"
@@ -2,6 +2,8 @@
 #ifndef sodium_core_H
 #define sodium_core_H
 
+#include <stddef.h>
+
 #include "export.h"
 
 #ifdef __cplusplus
@@ -12,8 +14,157 @@ SODIUM_EXPORT
 int sodium_init(void)
             __attribute__ ((warn_unused_result));
 
+/*
+ * sodium_implementation_name() returns the name of the implementation
+ * selected for a primitive ("aes", "argon2", "blake2b", "blake3",
+ * "chacha20", "curve25519", "poly1305", "salsa20", "salsa2012", "salsa208",
+ * "sha256" or "sha512"), or NULL before sodium_init().
+ * "aes" covers AES-GCM and AEGIS; "soft" is the constant-time fallback for
+ * CPUs without AES instructions.
+ *
+ * sodium_set_implementation() forces the implementation sodium_init() will
+ * select for a primitive, or restores the default if name is NULL. It fails
+ * once the library has been initialized, and if name doesn't exactly match
+ * one of the implementations of the primitive. On x86_64 with assembly
+ * code, the baseline "salsa20" implementation is "xmm6", and "ref" and
+ * "sse2" are rejected. If the CPU doesn't support the requested
+ * implementation, the baseline one is used instead.
+ * With --enable-ifunc, "poly1305" is chosen at load time and cannot be
+ * forced: sodium_set_implementation() sets errno to ENOSYS.
+ * Libraries configured --with-isa cannot force any implementation either.
+ */
+SODIUM_EXPORT
+const char *sodium_implementation_name(const char *primitive)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int sodium_set_implementation(const char *primitive, const char *name)
+            __attribute__ ((nonnull(1)));
+
+/*
+ * sodium_tune_implementations() makes sodium_init() time every
+ * implementation the CPU supports for each primitive, and select the
+ * fastest ones instead of relying on CPUID alone. This takes a few
+ * milliseconds. Primitives forced with sodium_set_implementation() are left
+ * alone. It must be called before sodium_init().
+ *
+ * sodium_implementation_profile() saves the selection as a short string.
+ * Given back to sodium_tune_implementations(), it is applied without any
+ * benchmark, unless the CPU model doesn't match the one it was saved on.
+ * profile can be NULL to always benchmark.
+ */
+#define sodium_IMPLEMENTATION_PROFILEBYTES 256U
+
+SODIUM_EXPORT
+int sodium_tune_implementations(const char *profile);
+
+SODIUM_EXPORT
+int sodium_implementation_profile(char *profile, size_t profile_maxlen)
+            __attribute__ ((nonnull));
+
 /* ---- */
 
+/*
+ * Functions that can use several threads hand their tasks to an executor.
+ * The default one creates a thread per task when threads are available.
+ *
+ * submit() must arrange for fn(arg) to be called, and return a non-NULL
+ * handle, or return NULL to have the calling thread run the task itself.
+ * wait() must return once that call has completed; it is called exactly
+ * once per handle, from the thread that submitted the task, which is
+ * blocked until then, so tasks must not depend on it to be run. As tasks
+ * can submit tasks of their own, an executor with a fixed number of
+ * workers should return NULL rather than queue a task none of them can
+ * start.
+ *
+ * max_parallelism caps the number of threads used by a single call, the
+ * calling thread included; 1 runs everything on the calling thread, and 0
+ * sets no limit. Passing NULL functions restores the default executor.
+ * This has to be done while no other thread uses the library.
+ */
+typedef void (*sodium_executor_fn)(void *arg);
+typedef void *(*sodium_executor_submit_fn)(void *ctx, sodium_executor_fn fn,
+                                           void *arg);
+typedef void (*sodium_executor_wait_fn)(void *ctx, void *handle);
+
+SODIUM_EXPORT
+int sodium_set_executor(sodium_executor_submit_fn submit,
+                        sodium_executor_wait_fn wait, void *ctx,
+                        unsigned int max_parallelism);
+
+/*
+ * Memory the library allocates for itself can come from the application.
+ * SODIUM_ALLOC_SCRATCH is used for the working areas of the password
+ * hashing functions, that can be large but don't outlive a call, and
+ * SODIUM_ALLOC_SECRET for sodium_malloc().
+ *
+ * alloc() must return at least size bytes aligned to 64 bytes, or NULL;
+ * free() gets the same pointer and size back. Secret storage from an
+ * application allocator has no guard pages and is not locked by the
+ * library: sodium_mprotect_*() fail with ENOSYS. It is still wiped before
+ * it is freed, and checked for underflows.
+ *
+ * Passing NULL functions restores the default allocator of that kind.
+ * This has to be done while no other thread uses the library, and while
+ * nothing of that kind is allocated.
+ */
+#define SODIUM_ALLOC_SCRATCH 0
+#define SODIUM_ALLOC_SECRET  1
+
+typedef void *(*sodium_alloc_fn)(void *ctx, size_t size);
+typedef void (*sodium_free_fn)(void *ctx, void *ptr, size_t size);
+
+SODIUM_EXPORT
+int sodium_set_allocator(int kind, sodium_alloc_fn alloc,
+                         sodium_free_fn free_fn, void *ctx);
+
+/*
+ * Large messages given to the crypto_aead_aes256gcm and
+ * crypto_aead_chacha20poly1305_ietf functions that take a key can be
+ * handed to a hardware offload engine.
+ *
+ * capabilities() returns the SODIUM_OFFLOAD_* operations the engine
+ * supports; it is called once, by sodium_set_offload_provider(). Messages
+ * of at least min_bytes bytes for these operations are then given to
+ * aead_encrypt() or aead_decrypt(), with the same parameters as the
+ * detached functions, and must produce the same output. They return 0 on
+ * success, -1 if decryption fails the verification, and a positive value
+ * if the engine cannot take the message, which is then processed on the
+ * CPU. Asynchronous operation is available through the job queues.
+ *
+ * The provider is copied. Passing NULL removes it. It can be replaced or
+ * removed while other threads use the library: each operation uses either
+ * the previous provider or the new one. Operations that already started
+ * may still call the previous provider after this function returns, so
+ * its ctx has to remain valid. A small record is kept for every distinct
+ * provider and min_bytes pair until the process exits.
+ */
+#define SODIUM_OFFLOAD_AEAD_AES256GCM             0x01U
+#define SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF 0x02U
+
+typedef struct sodium_offload_provider {
+    unsigned int (*capabilities)(void *ctx);
+    int (*aead_encrypt)(void *ctx, unsigned int op,
+                        unsigned char *c, unsigned char *mac,
+                        const unsigned char *m, unsigned long long mlen,
+                        const unsigned char *ad, unsigned long long adlen,
+                        const unsigned char *npub, const unsigned char *k);
+    int (*aead_decrypt)(void *ctx, unsigned int op,
+                        unsigned char *m, const unsigned char *c,
+                        unsigned long long clen, const unsigned char *mac,
+                        const unsigned char *ad, unsigned long long adlen,
+                        const unsigned char *npub, const unsigned char *k);
+    void *ctx;
+} sodium_offload_provider;
+
+SODIUM_EXPORT
+int sodium_set_offload_provider(const sodium_offload_provider *provider,
+                                size_t min_bytes);
+
+/* The operations currently offloaded, 0 if there is no provider */
+SODIUM_EXPORT
+unsigned int sodium_offload_capabilities(void);
+
 SODIUM_EXPORT
 int sodium_set_misuse_handler(void (*handler)(void));
 
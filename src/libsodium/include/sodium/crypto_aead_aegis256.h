@@ -2,6 +2,7 @@
 #define crypto_aead_aegis256_H
 
 #include <stddef.h>
+#include "crypto_aead_iovec.h"
 #include "export.h"
 
 #ifdef __cplusplus
@@ -85,6 +86,130 @@ int crypto_aead_aegis256_decrypt_detached(unsigned char *m,
                                           const unsigned char *k)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
 
+SODIUM_EXPORT
+int crypto_aead_aegis256_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                              size_t c_count,
+                                              unsigned char *mac,
+                                              unsigned long long *maclen_p,
+                                              const crypto_aead_iovec *m,
+                                              size_t m_count,
+                                              const crypto_aead_iovec *ad,
+                                              size_t ad_count,
+                                              const unsigned char *nsec,
+                                              const unsigned char *npub,
+                                              const unsigned char *k)
+            __attribute__ ((nonnull(3, 10, 11)));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                              size_t m_count,
+                                              unsigned char *nsec,
+                                              const crypto_aead_iovec *c,
+                                              size_t c_count,
+                                              const unsigned char *mac,
+                                              const crypto_aead_iovec *ad,
+                                              size_t ad_count,
+                                              const unsigned char *npub,
+                                              const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(6, 9, 10)));
+
+/*
+ * Incremental API: _init(), then _update_ad() any number of times, then
+ * _encrypt_update() or _decrypt_update() any number of times, and finally
+ * the matching _final() function.
+ * Decrypted data must not be used before _decrypt_final() returns 0.
+ */
+
+typedef struct CRYPTO_ALIGN(16) crypto_aead_aegis256_state_ {
+    unsigned char opaque[256];
+} crypto_aead_aegis256_state;
+
+SODIUM_EXPORT
+size_t crypto_aead_aegis256_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_init(crypto_aead_aegis256_state *state,
+                              const unsigned char *npub,
+                              const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_update_ad(crypto_aead_aegis256_state *state,
+                                   const unsigned char *ad,
+                                   unsigned long long adlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_encrypt_update(crypto_aead_aegis256_state *state,
+                                        unsigned char *c,
+                                        const unsigned char *m,
+                                        unsigned long long mlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_encrypt_final(crypto_aead_aegis256_state *state,
+                                       unsigned char *mac)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_decrypt_update(crypto_aead_aegis256_state *state,
+                                        unsigned char *m,
+                                        const unsigned char *c,
+                                        unsigned long long clen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_decrypt_final(crypto_aead_aegis256_state *state,
+                                       const unsigned char *mac)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * AEGIS-MAC: computes a 128 or 256 bit authentication tag over any amount of
+ * data, using the AEGIS permutation with the data absorbed as additional data.
+ * npub can be NULL (all zeros), but a key used for AEGIS-MAC must not also be
+ * used for encryption.
+ */
+
+#define crypto_aead_aegis256_MACBYTES_MIN 16U
+SODIUM_EXPORT
+size_t crypto_aead_aegis256_macbytes_min(void);
+
+#define crypto_aead_aegis256_MACBYTES_MAX 32U
+SODIUM_EXPORT
+size_t crypto_aead_aegis256_macbytes_max(void);
+
+#define crypto_aead_aegis256_MACBYTES 32U
+SODIUM_EXPORT
+size_t crypto_aead_aegis256_macbytes(void);
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_mac(unsigned char *out, size_t outlen,
+                             const unsigned char *in, unsigned long long inlen,
+                             const unsigned char *npub, const unsigned char *k)
+            __attribute__ ((nonnull(1, 6)));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_mac_init(crypto_aead_aegis256_state *state,
+                                  const unsigned char *npub,
+                                  const unsigned char *k)
+            __attribute__ ((nonnull(1, 3)));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_mac_update(crypto_aead_aegis256_state *state,
+                                    const unsigned char *in,
+                                    unsigned long long inlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_mac_final(crypto_aead_aegis256_state *state,
+                                   unsigned char *out, size_t outlen)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_aegis256_mac_final_verify(crypto_aead_aegis256_state *state,
+                                          const unsigned char *mac, size_t maclen)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void crypto_aead_aegis256_keygen(unsigned char k[crypto_aead_aegis256_KEYBYTES])
             __attribute__ ((nonnull));
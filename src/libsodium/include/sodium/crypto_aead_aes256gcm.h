@@ -22,6 +22,7 @@
  */
 
 #include <stddef.h>
+#include "crypto_aead_iovec.h"
 #include "export.h"
 
 #ifdef __cplusplus
@@ -168,6 +169,171 @@ int crypto_aead_aes256gcm_decrypt_detached_afternm(unsigned char *m,
                                                    const crypto_aead_aes256gcm_state *ctx_)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
 
+/*
+ * Compact precomputed keys: the round keys and H only, in 256 bytes aligned
+ * to a cache line, for applications that keep many keys around.
+ * A compact key can be copied and stored like any other secret, but is only
+ * valid for the implementation that computed it.
+ *
+ * _compact_beforenm() expands `count` keys stored one after the other in k.
+ * Encryption and decryption with a compact key only compute the powers of H
+ * that the message needs, which makes them cheapest for short messages.
+ * _compact_expand() turns a compact key into a full precomputed state.
+ */
+typedef struct CRYPTO_ALIGN(64) crypto_aead_aes256gcm_compact_key_ {
+    unsigned char opaque[256];
+} crypto_aead_aes256gcm_compact_key;
+
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcm_compact_keybytes(void);
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_compact_beforenm(crypto_aead_aes256gcm_compact_key *ck,
+                                           const unsigned char *k, size_t count)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_compact_expand(crypto_aead_aes256gcm_state *ctx_,
+                                         const crypto_aead_aes256gcm_compact_key *ck)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_encrypt_detached_compact(unsigned char *c,
+                                                   unsigned char *mac,
+                                                   unsigned long long *maclen_p,
+                                                   const unsigned char *m,
+                                                   unsigned long long mlen,
+                                                   const unsigned char *ad,
+                                                   unsigned long long adlen,
+                                                   const unsigned char *nsec,
+                                                   const unsigned char *npub,
+                                                   const crypto_aead_aes256gcm_compact_key *ck)
+            __attribute__ ((nonnull(1, 2, 9, 10)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_decrypt_detached_compact(unsigned char *m,
+                                                   unsigned char *nsec,
+                                                   const unsigned char *c,
+                                                   unsigned long long clen,
+                                                   const unsigned char *mac,
+                                                   const unsigned char *ad,
+                                                   unsigned long long adlen,
+                                                   const unsigned char *npub,
+                                                   const crypto_aead_aes256gcm_compact_key *ck)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                               size_t c_count,
+                                               unsigned char *mac,
+                                               unsigned long long *maclen_p,
+                                               const crypto_aead_iovec *m,
+                                               size_t m_count,
+                                               const crypto_aead_iovec *ad,
+                                               size_t ad_count,
+                                               const unsigned char *nsec,
+                                               const unsigned char *npub,
+                                               const unsigned char *k)
+            __attribute__ ((nonnull(3, 10, 11)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                               size_t m_count,
+                                               unsigned char *nsec,
+                                               const crypto_aead_iovec *c,
+                                               size_t c_count,
+                                               const unsigned char *mac,
+                                               const crypto_aead_iovec *ad,
+                                               size_t ad_count,
+                                               const unsigned char *npub,
+                                               const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(6, 9, 10)));
+
+/*
+ * Incremental API, using a precomputed key state:
+ * _init(), then _update_ad() any number of times, then _encrypt_update() or
+ * _decrypt_update() any number of times, and finally the matching _final()
+ * function.
+ * Decrypted data must not be used before _decrypt_final() returns 0.
+ */
+
+typedef struct CRYPTO_ALIGN(16) crypto_aead_aes256gcm_stream_state_ {
+    unsigned char opaque[768];
+} crypto_aead_aes256gcm_stream_state;
+
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcm_stream_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_init(crypto_aead_aes256gcm_stream_state *state,
+                               const unsigned char *npub,
+                               const crypto_aead_aes256gcm_state *ctx_)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_update_ad(crypto_aead_aes256gcm_stream_state *state,
+                                    const unsigned char *ad,
+                                    unsigned long long adlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_encrypt_update(crypto_aead_aes256gcm_stream_state *state,
+                                         unsigned char *c,
+                                         const unsigned char *m,
+                                         unsigned long long mlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_encrypt_final(crypto_aead_aes256gcm_stream_state *state,
+                                        unsigned char *mac)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_decrypt_update(crypto_aead_aes256gcm_stream_state *state,
+                                         unsigned char *m,
+                                         const unsigned char *c,
+                                         unsigned long long clen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_decrypt_final(crypto_aead_aes256gcm_stream_state *state,
+                                        const unsigned char *mac)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Key-committing variant: the ciphertext is followed by the MAC and a
+ * commitment to the key and nonce, so that it can only be decrypted with
+ * the key that was used to encrypt it. c must have room for mlen +
+ * crypto_aead_aes256gcm_ABYTES + crypto_aead_aes256gcm_COMMITBYTES bytes.
+ */
+#define crypto_aead_aes256gcm_COMMITBYTES 32U
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcm_commitbytes(void);
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_encrypt_commit(unsigned char *c,
+                                         unsigned long long *clen_p,
+                                         const unsigned char *m,
+                                         unsigned long long mlen,
+                                         const unsigned char *ad,
+                                         unsigned long long adlen,
+                                         const unsigned char *nsec,
+                                         const unsigned char *npub,
+                                         const unsigned char *k)
+            __attribute__ ((nonnull(1, 8, 9)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcm_decrypt_commit(unsigned char *m,
+                                         unsigned long long *mlen_p,
+                                         unsigned char *nsec,
+                                         const unsigned char *c,
+                                         unsigned long long clen,
+                                         const unsigned char *ad,
+                                         unsigned long long adlen,
+                                         const unsigned char *npub,
+                                         const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(4, 8, 9)));
+
 SODIUM_EXPORT
 void crypto_aead_aes256gcm_keygen(unsigned char k[crypto_aead_aes256gcm_KEYBYTES])
             __attribute__ ((nonnull));
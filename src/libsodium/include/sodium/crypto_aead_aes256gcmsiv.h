@@ -0,0 +1,107 @@
+#ifndef crypto_aead_aes256gcmsiv_H
+#define crypto_aead_aes256gcmsiv_H
+
+/*
+ * AES-256-GCM-SIV (RFC 8452).
+ *
+ * A repeated nonce only reveals whether the same message was encrypted
+ * twice with the same additional data. This makes random nonces safe to
+ * use in a distributed environment, up to about 2^48 messages per key.
+ *
+ * Encryption needs two passes over the message, so it is slower than
+ * AES-GCM. Hardware AES and carry-less multiplication are required: check
+ * crypto_aead_aes256gcmsiv_is_available() before using these functions.
+ */
+
+#include <stddef.h>
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcmsiv_is_available(void);
+
+#define crypto_aead_aes256gcmsiv_KEYBYTES  32U
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcmsiv_keybytes(void);
+
+#define crypto_aead_aes256gcmsiv_NSECBYTES 0U
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcmsiv_nsecbytes(void);
+
+#define crypto_aead_aes256gcmsiv_NPUBBYTES 12U
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcmsiv_npubbytes(void);
+
+#define crypto_aead_aes256gcmsiv_ABYTES    16U
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcmsiv_abytes(void);
+
+#define crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX \
+    SODIUM_MIN(SODIUM_SIZE_MAX - crypto_aead_aes256gcmsiv_ABYTES, (1ULL << 36))
+SODIUM_EXPORT
+size_t crypto_aead_aes256gcmsiv_messagebytes_max(void);
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcmsiv_encrypt(unsigned char *c,
+                                     unsigned long long *clen_p,
+                                     const unsigned char *m,
+                                     unsigned long long mlen,
+                                     const unsigned char *ad,
+                                     unsigned long long adlen,
+                                     const unsigned char *nsec,
+                                     const unsigned char *npub,
+                                     const unsigned char *k)
+            __attribute__ ((nonnull(1, 8, 9)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcmsiv_decrypt(unsigned char *m,
+                                     unsigned long long *mlen_p,
+                                     unsigned char *nsec,
+                                     const unsigned char *c,
+                                     unsigned long long clen,
+                                     const unsigned char *ad,
+                                     unsigned long long adlen,
+                                     const unsigned char *npub,
+                                     const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(4, 8, 9)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcmsiv_encrypt_detached(unsigned char *c,
+                                              unsigned char *mac,
+                                              unsigned long long *maclen_p,
+                                              const unsigned char *m,
+                                              unsigned long long mlen,
+                                              const unsigned char *ad,
+                                              unsigned long long adlen,
+                                              const unsigned char *nsec,
+                                              const unsigned char *npub,
+                                              const unsigned char *k)
+            __attribute__ ((nonnull(1, 2, 9, 10)));
+
+SODIUM_EXPORT
+int crypto_aead_aes256gcmsiv_decrypt_detached(unsigned char *m,
+                                              unsigned char *nsec,
+                                              const unsigned char *c,
+                                              unsigned long long clen,
+                                              const unsigned char *mac,
+                                              const unsigned char *ad,
+                                              unsigned long long adlen,
+                                              const unsigned char *npub,
+                                              const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
+
+SODIUM_EXPORT
+void crypto_aead_aes256gcmsiv_keygen(unsigned char k[crypto_aead_aes256gcmsiv_KEYBYTES])
+            __attribute__ ((nonnull));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,6 +2,7 @@
 #define crypto_aead_chacha20poly1305_H
 
 #include <stddef.h>
+#include "crypto_aead_iovec.h"
 #include "export.h"
 
 #ifdef __cplusplus
@@ -85,6 +86,172 @@ int crypto_aead_chacha20poly1305_ietf_decrypt_detached(unsigned char *m,
                                                        const unsigned char *k)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
 
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                                           size_t c_count,
+                                                           unsigned char *mac,
+                                                           unsigned long long *maclen_p,
+                                                           const crypto_aead_iovec *m,
+                                                           size_t m_count,
+                                                           const crypto_aead_iovec *ad,
+                                                           size_t ad_count,
+                                                           const unsigned char *nsec,
+                                                           const unsigned char *npub,
+                                                           const unsigned char *k)
+            __attribute__ ((nonnull(3, 10, 11)));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                                           size_t m_count,
+                                                           unsigned char *nsec,
+                                                           const crypto_aead_iovec *c,
+                                                           size_t c_count,
+                                                           const unsigned char *mac,
+                                                           const crypto_aead_iovec *ad,
+                                                           size_t ad_count,
+                                                           const unsigned char *npub,
+                                                           const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(6, 9, 10)));
+
+/*
+ * Encrypt count independent messages with the same key. c[i] must have room
+ * for mlen[i] + crypto_aead_chacha20poly1305_ietf_ABYTES bytes.
+ * ad and adlen can be NULL if none of the messages have additional data.
+ */
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_encrypt_batch(unsigned char * const *c,
+                                                    const unsigned char * const *m,
+                                                    const unsigned long long *mlen,
+                                                    const unsigned char * const *ad,
+                                                    const unsigned long long *adlen,
+                                                    const unsigned char * const *npub,
+                                                    size_t count,
+                                                    const unsigned char *k)
+            __attribute__ ((nonnull(8)));
+
+/*
+ * Key-committing variant: the ciphertext is followed by the MAC and a
+ * commitment to the key and nonce, taken from the otherwise unused half of
+ * the first keystream block. A ciphertext can then only be decrypted with
+ * the key that was used to encrypt it. c must have room for mlen +
+ * crypto_aead_chacha20poly1305_ietf_ABYTES +
+ * crypto_aead_chacha20poly1305_ietf_COMMITBYTES bytes.
+ */
+#define crypto_aead_chacha20poly1305_ietf_COMMITBYTES 32U
+SODIUM_EXPORT
+size_t crypto_aead_chacha20poly1305_ietf_commitbytes(void);
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_encrypt_commit(unsigned char *c,
+                                                     unsigned long long *clen_p,
+                                                     const unsigned char *m,
+                                                     unsigned long long mlen,
+                                                     const unsigned char *ad,
+                                                     unsigned long long adlen,
+                                                     const unsigned char *nsec,
+                                                     const unsigned char *npub,
+                                                     const unsigned char *k)
+            __attribute__ ((nonnull(1, 8, 9)));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_decrypt_commit(unsigned char *m,
+                                                     unsigned long long *mlen_p,
+                                                     unsigned char *nsec,
+                                                     const unsigned char *c,
+                                                     unsigned long long clen,
+                                                     const unsigned char *ad,
+                                                     unsigned long long adlen,
+                                                     const unsigned char *npub,
+                                                     const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(4, 8, 9)));
+
+/*
+ * Incremental API: _init(), then _update_ad() any number of times, then
+ * _encrypt_update() or _decrypt_update() any number of times, and finally
+ * the matching _final() function. The output is the same as with the
+ * detached functions.
+ * Decrypted data must not be used before _decrypt_final() returns 0.
+ */
+
+typedef struct CRYPTO_ALIGN(16) crypto_aead_chacha20poly1305_ietf_state_ {
+    unsigned char opaque[448];
+} crypto_aead_chacha20poly1305_ietf_state;
+
+SODIUM_EXPORT
+size_t crypto_aead_chacha20poly1305_ietf_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_init(crypto_aead_chacha20poly1305_ietf_state *state,
+                                           const unsigned char *npub,
+                                           const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_update_ad(crypto_aead_chacha20poly1305_ietf_state *state,
+                                                const unsigned char *ad,
+                                                unsigned long long adlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_encrypt_update(crypto_aead_chacha20poly1305_ietf_state *state,
+                                                     unsigned char *c,
+                                                     const unsigned char *m,
+                                                     unsigned long long mlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_encrypt_final(crypto_aead_chacha20poly1305_ietf_state *state,
+                                                    unsigned char *mac)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_decrypt_update(crypto_aead_chacha20poly1305_ietf_state *state,
+                                                     unsigned char *m,
+                                                     const unsigned char *c,
+                                                     unsigned long long clen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_decrypt_final(crypto_aead_chacha20poly1305_ietf_state *state,
+                                                    const unsigned char *mac)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Prepared encryption: when the nonce of the next message is known in
+ * advance, _prepare() computes the Poly1305 key and the first kslen bytes
+ * of keystream ahead of time. _encrypt_prepared() then only has to XOR and
+ * authenticate messages up to kslen bytes long; the keystream of longer
+ * messages is completed at call time. The output is the same as with
+ * crypto_aead_chacha20poly1305_ietf_encrypt().
+ * A prepared state can be used only once; it is erased after use, and
+ * using it again returns -1.
+ */
+
+#define crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX 1024U
+SODIUM_EXPORT
+size_t crypto_aead_chacha20poly1305_ietf_preparedbytes_max(void);
+
+typedef struct CRYPTO_ALIGN(16) crypto_aead_chacha20poly1305_ietf_prepared_ {
+    unsigned char opaque[1120];
+} crypto_aead_chacha20poly1305_ietf_prepared;
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_prepare(crypto_aead_chacha20poly1305_ietf_prepared *state,
+                                              size_t kslen,
+                                              const unsigned char *npub,
+                                              const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_ietf_encrypt_prepared(unsigned char *c,
+                                                       unsigned long long *clen_p,
+                                                       const unsigned char *m,
+                                                       unsigned long long mlen,
+                                                       const unsigned char *ad,
+                                                       unsigned long long adlen,
+                                                       crypto_aead_chacha20poly1305_ietf_prepared *state)
+            __attribute__ ((nonnull(1, 7)));
+
 SODIUM_EXPORT
 void crypto_aead_chacha20poly1305_ietf_keygen(unsigned char k[crypto_aead_chacha20poly1305_ietf_KEYBYTES])
             __attribute__ ((nonnull));
@@ -161,6 +328,33 @@ int crypto_aead_chacha20poly1305_decrypt_detached(unsigned char *m,
                                                   const unsigned char *k)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
 
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                                      size_t c_count,
+                                                      unsigned char *mac,
+                                                      unsigned long long *maclen_p,
+                                                      const crypto_aead_iovec *m,
+                                                      size_t m_count,
+                                                      const crypto_aead_iovec *ad,
+                                                      size_t ad_count,
+                                                      const unsigned char *nsec,
+                                                      const unsigned char *npub,
+                                                      const unsigned char *k)
+            __attribute__ ((nonnull(3, 10, 11)));
+
+SODIUM_EXPORT
+int crypto_aead_chacha20poly1305_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                                      size_t m_count,
+                                                      unsigned char *nsec,
+                                                      const crypto_aead_iovec *c,
+                                                      size_t c_count,
+                                                      const unsigned char *mac,
+                                                      const crypto_aead_iovec *ad,
+                                                      size_t ad_count,
+                                                      const unsigned char *npub,
+                                                      const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(6, 9, 10)));
+
 SODIUM_EXPORT
 void crypto_aead_chacha20poly1305_keygen(unsigned char k[crypto_aead_chacha20poly1305_KEYBYTES])
             __attribute__ ((nonnull));
@@ -0,0 +1,24 @@
+#ifndef crypto_aead_iovec_H
+#define crypto_aead_iovec_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A fragment of a scattered buffer, for the *_detached_iov() AEAD functions.
+ * The layout matches POSIX struct iovec.
+ */
+
+typedef struct crypto_aead_iovec {
+    void   *ptr;
+    size_t  len;
+} crypto_aead_iovec;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
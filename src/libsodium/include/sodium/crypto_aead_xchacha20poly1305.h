@@ -2,6 +2,7 @@
 #define crypto_aead_xchacha20poly1305_H
 
 #include <stddef.h>
+#include "crypto_aead_iovec.h"
 #include "export.h"
 
 #ifdef __cplusplus
@@ -81,6 +82,150 @@ int crypto_aead_xchacha20poly1305_ietf_decrypt_detached(unsigned char *m,
                                                         const unsigned char *k)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 8, 9)));
 
+/*
+ * Two-phase decryption, for ciphertexts that are not in writable memory.
+ *
+ * _verify_detached() only checks the tag, and can read the ciphertext
+ * straight from a read-only mapping. After it succeeded, the ciphertext
+ * can be copied to its destination and decrypted there with
+ * _decrypt_unverified_in_place(). The ciphertext must not change between
+ * both steps; if it can, verify the copy instead.
+ */
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_verify_detached(const unsigned char *c,
+                                                       unsigned long long clen,
+                                                       const unsigned char *mac,
+                                                       const unsigned char *ad,
+                                                       unsigned long long adlen,
+                                                       const unsigned char *npub,
+                                                       const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 6, 7)));
+
+SODIUM_EXPORT
+void crypto_aead_xchacha20poly1305_ietf_decrypt_unverified_in_place(unsigned char *buf,
+                                                                    unsigned long long len,
+                                                                    const unsigned char *npub,
+                                                                    const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_encrypt_detached_iov(const crypto_aead_iovec *c,
+                                                            size_t c_count,
+                                                            unsigned char *mac,
+                                                            unsigned long long *maclen_p,
+                                                            const crypto_aead_iovec *m,
+                                                            size_t m_count,
+                                                            const crypto_aead_iovec *ad,
+                                                            size_t ad_count,
+                                                            const unsigned char *nsec,
+                                                            const unsigned char *npub,
+                                                            const unsigned char *k)
+            __attribute__ ((nonnull(3, 10, 11)));
+
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_decrypt_detached_iov(const crypto_aead_iovec *m,
+                                                            size_t m_count,
+                                                            unsigned char *nsec,
+                                                            const crypto_aead_iovec *c,
+                                                            size_t c_count,
+                                                            const unsigned char *mac,
+                                                            const crypto_aead_iovec *ad,
+                                                            size_t ad_count,
+                                                            const unsigned char *npub,
+                                                            const unsigned char *k)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(6, 9, 10)));
+
+/*
+ * Encrypt count independent messages with the same key. c[i] must have room
+ * for mlen[i] + crypto_aead_xchacha20poly1305_ietf_ABYTES bytes.
+ * ad and adlen can be NULL if none of the messages have additional data.
+ */
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_encrypt_batch(unsigned char * const *c,
+                                                     const unsigned char * const *m,
+                                                     const unsigned long long *mlen,
+                                                     const unsigned char * const *ad,
+                                                     const unsigned long long *adlen,
+                                                     const unsigned char * const *npub,
+                                                     size_t count,
+                                                     const unsigned char *k)
+            __attribute__ ((nonnull(8)));
+
+/*
+ * Precomputed subkey for nonces that share their first
+ * crypto_aead_xchacha20poly1305_ietf_NPUBPREFIXBYTES bytes, such as a
+ * per-session prefix followed by a message counter. _beforenm() computes
+ * HChaCha20 once, and the _afternm() functions only take the last
+ * crypto_aead_xchacha20poly1305_ietf_NPUBSUFFIXBYTES bytes of the nonce.
+ * The output is the same as with the full nonce.
+ */
+
+#define crypto_aead_xchacha20poly1305_ietf_NPUBPREFIXBYTES 16U
+#define crypto_aead_xchacha20poly1305_ietf_NPUBSUFFIXBYTES 8U
+
+typedef struct CRYPTO_ALIGN(16) crypto_aead_xchacha20poly1305_ietf_precomputed_ {
+    unsigned char opaque[32];
+} crypto_aead_xchacha20poly1305_ietf_precomputed;
+
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_beforenm(crypto_aead_xchacha20poly1305_ietf_precomputed *state,
+                                                const unsigned char *npub_prefix,
+                                                const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_encrypt_afternm(unsigned char *c,
+                                                       unsigned long long *clen_p,
+                                                       const unsigned char *m,
+                                                       unsigned long long mlen,
+                                                       const unsigned char *ad,
+                                                       unsigned long long adlen,
+                                                       const unsigned char *npub_suffix,
+                                                       const crypto_aead_xchacha20poly1305_ietf_precomputed *state)
+            __attribute__ ((nonnull(1, 7, 8)));
+
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_decrypt_afternm(unsigned char *m,
+                                                       unsigned long long *mlen_p,
+                                                       const unsigned char *c,
+                                                       unsigned long long clen,
+                                                       const unsigned char *ad,
+                                                       unsigned long long adlen,
+                                                       const unsigned char *npub_suffix,
+                                                       const crypto_aead_xchacha20poly1305_ietf_precomputed *state)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 7, 8)));
+
+/*
+ * Prepared encryption, see crypto_aead_chacha20poly1305_ietf_prepare().
+ * _prepare() also derives the subkey, so that _encrypt_prepared() doesn't
+ * have to compute HChaCha20 either.
+ */
+
+#define crypto_aead_xchacha20poly1305_ietf_PREPAREDBYTES_MAX 1024U
+SODIUM_EXPORT
+size_t crypto_aead_xchacha20poly1305_ietf_preparedbytes_max(void);
+
+typedef struct CRYPTO_ALIGN(16) crypto_aead_xchacha20poly1305_ietf_prepared_ {
+    unsigned char opaque[1120];
+} crypto_aead_xchacha20poly1305_ietf_prepared;
+
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_prepare(crypto_aead_xchacha20poly1305_ietf_prepared *state,
+                                               size_t kslen,
+                                               const unsigned char *npub,
+                                               const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_aead_xchacha20poly1305_ietf_encrypt_prepared(unsigned char *c,
+                                                        unsigned long long *clen_p,
+                                                        const unsigned char *m,
+                                                        unsigned long long mlen,
+                                                        const unsigned char *ad,
+                                                        unsigned long long adlen,
+                                                        crypto_aead_xchacha20poly1305_ietf_prepared *state)
+            __attribute__ ((nonnull(1, 7)));
+
 SODIUM_EXPORT
 void crypto_aead_xchacha20poly1305_ietf_keygen(unsigned char k[crypto_aead_xchacha20poly1305_ietf_KEYBYTES])
             __attribute__ ((nonnull));
@@ -58,6 +58,50 @@ SODIUM_EXPORT
 int crypto_auth_hmacsha256_final(crypto_auth_hmacsha256_state *state,
                                  unsigned char *out) __attribute__ ((nonnull));
 
+/* Keyed state, computed once and reused for any number of messages */
+
+typedef struct crypto_auth_hmacsha256_key_state {
+    crypto_auth_hmacsha256_state keyed;
+} crypto_auth_hmacsha256_key_state;
+
+SODIUM_EXPORT
+size_t crypto_auth_hmacsha256_key_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha256_key_precompute(crypto_auth_hmacsha256_key_state *kstate,
+                                         const unsigned char *key,
+                                         size_t keylen) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha256_init_precomputed(crypto_auth_hmacsha256_state *state,
+                                           const crypto_auth_hmacsha256_key_state *kstate)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha256_precomputed(unsigned char *out,
+                                       const unsigned char *in,
+                                       unsigned long long inlen,
+                                       const crypto_auth_hmacsha256_key_state *kstate)
+            __attribute__ ((nonnull(1, 4)));
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha256_verify_precomputed(const unsigned char *h,
+                                              const unsigned char *in,
+                                              unsigned long long inlen,
+                                              const crypto_auth_hmacsha256_key_state *kstate)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 4)));
+
+/*
+ * Computes n independent MACs over n messages with n keys of
+ * crypto_auth_hmacsha256_KEYBYTES bytes: macs[i] = HMAC(keys[i], msgs[i]).
+ * Inner and outer hashes are computed in parallel, one per SIMD lane,
+ * when the CPU supports it.
+ */
+SODIUM_EXPORT
+int crypto_auth_hmacsha256_batch(unsigned char * const *macs,
+                                const unsigned char * const *msgs,
+                                const unsigned long long *lens,
+                                const unsigned char * const *keys, size_t n);
 
 SODIUM_EXPORT
 void crypto_auth_hmacsha256_keygen(unsigned char k[crypto_auth_hmacsha256_KEYBYTES])
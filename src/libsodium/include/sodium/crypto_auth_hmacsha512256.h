@@ -54,6 +54,37 @@ SODIUM_EXPORT
 int crypto_auth_hmacsha512256_final(crypto_auth_hmacsha512256_state *state,
                                     unsigned char *out) __attribute__ ((nonnull));
 
+/* Keyed state, computed once and reused for any number of messages */
+
+typedef crypto_auth_hmacsha512_key_state crypto_auth_hmacsha512256_key_state;
+
+SODIUM_EXPORT
+size_t crypto_auth_hmacsha512256_key_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha512256_key_precompute(crypto_auth_hmacsha512256_key_state *kstate,
+                                            const unsigned char *key,
+                                            size_t keylen) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha512256_init_precomputed(crypto_auth_hmacsha512256_state *state,
+                                              const crypto_auth_hmacsha512256_key_state *kstate)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha512256_precomputed(unsigned char *out,
+                                          const unsigned char *in,
+                                          unsigned long long inlen,
+                                          const crypto_auth_hmacsha512256_key_state *kstate)
+            __attribute__ ((nonnull(1, 4)));
+
+SODIUM_EXPORT
+int crypto_auth_hmacsha512256_verify_precomputed(const unsigned char *h,
+                                                 const unsigned char *in,
+                                                 unsigned long long inlen,
+                                                 const crypto_auth_hmacsha512256_key_state *kstate)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 4)));
+
 SODIUM_EXPORT
 void crypto_auth_hmacsha512256_keygen(unsigned char k[crypto_auth_hmacsha512256_KEYBYTES])
             __attribute__ ((nonnull));
@@ -11,6 +11,7 @@
 #include <stddef.h>
 
 #include "crypto_box_curve25519xsalsa20poly1305.h"
+#include "crypto_secretstream_xchacha20poly1305.h"
 #include "export.h"
 
 #ifdef __cplusplus
@@ -120,6 +121,57 @@ int crypto_box_open_detached_afternm(unsigned char *m, const unsigned char *c,
                                      const unsigned char *k)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(2, 3, 5, 6)));
 
+/* -- Shared key cache -- */
+
+/*
+ * A bounded cache of precomputed keys, indexed by (sk, pk) and evicted in
+ * least recently used order. Keys are stored in guarded memory, and wiped
+ * on eviction and by _free(). Not thread-safe: use one cache per thread,
+ * or a lock.
+ */
+
+typedef struct crypto_box_keycache {
+    void  *entries;
+    void  *buckets;
+    size_t capacity;
+    size_t buckets_count;
+    size_t count;
+    size_t head;
+    size_t tail;
+} crypto_box_keycache;
+
+SODIUM_EXPORT
+int crypto_box_keycache_init(crypto_box_keycache *cache, size_t capacity)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_box_keycache_free(crypto_box_keycache *cache)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_box_keycache_clear(crypto_box_keycache *cache)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_box_keycache_beforenm(crypto_box_keycache *cache, unsigned char *k,
+                                 const unsigned char *pk,
+                                 const unsigned char *sk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_box_keycache_easy(crypto_box_keycache *cache,
+                             unsigned char *c, const unsigned char *m,
+                             unsigned long long mlen, const unsigned char *n,
+                             const unsigned char *pk, const unsigned char *sk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 2, 5, 6, 7)));
+
+SODIUM_EXPORT
+int crypto_box_keycache_open_easy(crypto_box_keycache *cache,
+                                  unsigned char *m, const unsigned char *c,
+                                  unsigned long long clen, const unsigned char *n,
+                                  const unsigned char *pk, const unsigned char *sk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 5, 6, 7)));
+
 /* -- Ephemeral SK interface -- */
 
 #define crypto_box_SEALBYTES (crypto_box_PUBLICKEYBYTES + crypto_box_MACBYTES)
@@ -131,12 +183,148 @@ int crypto_box_seal(unsigned char *c, const unsigned char *m,
                     unsigned long long mlen, const unsigned char *pk)
             __attribute__ ((nonnull(1, 4)));
 
+/*
+ * Seals count messages, each to its own recipient. m can hold the same
+ * message several times, to send it to many recipients. The X25519
+ * multiplications are computed in batches. Returns -1 if any public key
+ * is invalid; messages to the other recipients are still sealed.
+ */
+SODIUM_EXPORT
+int crypto_box_seal_batch(unsigned char * const *c,
+                          const unsigned char * const *m,
+                          const unsigned long long *mlen,
+                          const unsigned char * const *pk, size_t count)
+            __attribute__ ((warn_unused_result));
+
+/*
+ * A pool of ephemeral keypairs for crypto_box_seal_ctx_seal(), computed
+ * batch at a time (0 for the default size). The next batch is computed
+ * on the executor while the current one is used. Messages are opened by
+ * crypto_box_seal_open().
+ *
+ * With reuse_max > 1, an ephemeral key can seal messages to up to
+ * reuse_max distinct recipients over reuse_seconds, saving a fixed-base
+ * multiplication per message. It is never reused for the same recipient,
+ * as that would repeat the nonce, so the shared secret is still computed
+ * for every message. The cost: recipients sharing an ephemeral key learn
+ * that their messages come from the same sender, and the ephemeral secret
+ * key stays in memory, where a compromise reveals all the messages it
+ * sealed, until it is replaced. Without reuse, ephemeral secret keys are
+ * wiped right after use.
+ *
+ * Not thread-safe: use one context per thread, or a lock.
+ */
+
+#define crypto_box_SEAL_CTX_BATCH_MAX 4096U
+#define crypto_box_SEAL_CTX_REUSE_MAX 64U
+
+typedef struct crypto_box_seal_ctx {
+    void *state;
+} crypto_box_seal_ctx;
+
+SODIUM_EXPORT
+int crypto_box_seal_ctx_init(crypto_box_seal_ctx *ctx, size_t batch,
+                             unsigned int reuse_max,
+                             unsigned int reuse_seconds)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_box_seal_ctx_free(crypto_box_seal_ctx *ctx)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_box_seal_ctx_seal(crypto_box_seal_ctx *ctx, unsigned char *c,
+                             const unsigned char *m, unsigned long long mlen,
+                             const unsigned char *pk)
+            __attribute__ ((nonnull(1, 2, 5)));
+
 SODIUM_EXPORT
 int crypto_box_seal_open(unsigned char *m, const unsigned char *c,
                          unsigned long long clen,
                          const unsigned char *pk, const unsigned char *sk)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(2, 4, 5)));
 
+/*
+ * Sealed boxes for messages that don't fit in memory. The header is an
+ * ephemeral public key followed by a secretstream header. The X25519 shared
+ * secret and both public keys are hashed into a
+ * crypto_secretstream_xchacha20poly1305 key, and the message is then pushed
+ * and pulled as a regular secretstream, in as many chunks as needed.
+ * The last chunk must be tagged crypto_secretstream_xchacha20poly1305_TAG_FINAL
+ * so that truncation can be detected.
+ */
+
+#define crypto_box_SEAL_STREAM_HEADERBYTES \
+    (crypto_box_PUBLICKEYBYTES + crypto_secretstream_xchacha20poly1305_HEADERBYTES)
+SODIUM_EXPORT
+size_t crypto_box_seal_stream_headerbytes(void);
+
+SODIUM_EXPORT
+int crypto_box_seal_stream_init_push
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char header[crypto_box_SEAL_STREAM_HEADERBYTES],
+    const unsigned char *pk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_box_seal_stream_init_pull
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    const unsigned char header[crypto_box_SEAL_STREAM_HEADERBYTES],
+    const unsigned char *pk, const unsigned char *sk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/* -- Multi-recipient interface -- */
+
+/*
+ * The message is encrypted once, with XChaCha20-Poly1305 and a random key.
+ * That key is then wrapped, for each recipient, using a single ephemeral
+ * X25519 key. A ciphertext is:
+ *
+ *   [ephemeral pk][recipient count, 32-bit LE][slots][encrypted message]
+ *
+ * Recipient slots hold a pseudorandom identifier and the wrapped key, and are
+ * sorted by identifier, so that crypto_box_multi_open() usually finds its
+ * slot at the first position it looks at.
+ * c must have room for crypto_box_multi_bytes(count, mlen) bytes.
+ * Recipients learn how many other recipients there are, but not who they
+ * are.
+ */
+
+#define crypto_box_MULTI_HEADERBYTES (crypto_box_PUBLICKEYBYTES + 4U)
+SODIUM_EXPORT
+size_t crypto_box_multi_headerbytes(void);
+
+#define crypto_box_MULTI_SLOTBYTES 64U
+SODIUM_EXPORT
+size_t crypto_box_multi_slotbytes(void);
+
+#define crypto_box_MULTI_ABYTES 16U
+SODIUM_EXPORT
+size_t crypto_box_multi_abytes(void);
+
+#define crypto_box_MULTI_RECIPIENTS_MAX 1048576U
+SODIUM_EXPORT
+size_t crypto_box_multi_recipients_max(void);
+
+SODIUM_EXPORT
+unsigned long long crypto_box_multi_bytes(size_t count, unsigned long long mlen);
+
+SODIUM_EXPORT
+int crypto_box_multi_seal(unsigned char *c, unsigned long long *clen_p,
+                          const unsigned char *m, unsigned long long mlen,
+                          const unsigned char * const *pk, size_t count)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 5)));
+
+/*
+ * m must have room for clen - crypto_box_multi_bytes(1, 0) bytes; the
+ * actual message length is stored into mlen_p if it is not NULL.
+ */
+SODIUM_EXPORT
+int crypto_box_multi_open(unsigned char *m, unsigned long long *mlen_p,
+                          const unsigned char *c, unsigned long long clen,
+                          const unsigned char *pk, const unsigned char *sk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(3, 5, 6)));
+
 /* -- NaCl compatibility interface ; Requires padding -- */
 
 #define crypto_box_ZEROBYTES crypto_box_curve25519xsalsa20poly1305_ZEROBYTES
@@ -32,6 +32,14 @@ SODIUM_EXPORT
 int crypto_core_ed25519_is_valid_point(const unsigned char *p)
             __attribute__ ((nonnull));
 
+/*
+ * Same result as crypto_core_ed25519_is_valid_point(), but faster and
+ * running in variable time. Only use it on points that are public.
+ */
+SODIUM_EXPORT
+int crypto_core_ed25519_is_valid_point_vartime(const unsigned char *p)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int crypto_core_ed25519_add(unsigned char *r,
                             const unsigned char *p, const unsigned char *q)
@@ -58,6 +66,23 @@ int crypto_core_ed25519_from_string_ro(unsigned char p[crypto_core_ed25519_BYTES
                                        size_t msg_len)
             __attribute__ ((nonnull(1)));
 
+/*
+ * Same as crypto_core_ed25519_from_string() and _from_string_ro(), for
+ * count messages at once: p receives count points.
+ */
+SODIUM_EXPORT
+int crypto_core_ed25519_from_string_batch(unsigned char *p, const char *ctx,
+                                          const unsigned char * const *msgs,
+                                          const size_t *msg_lens, size_t count)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_core_ed25519_from_string_ro_batch(unsigned char *p, const char *ctx,
+                                             const unsigned char * const *msgs,
+                                             const size_t *msg_lens,
+                                             size_t count)
+            __attribute__ ((nonnull(1)));
+
 SODIUM_EXPORT
 void crypto_core_ed25519_random(unsigned char *p)
             __attribute__ ((nonnull));
@@ -70,6 +95,17 @@ SODIUM_EXPORT
 int crypto_core_ed25519_scalar_invert(unsigned char *recip, const unsigned char *s)
             __attribute__ ((nonnull));
 
+/*
+ * recip[i] = 1/s[i] for count scalars, with a single inversion. Returns -1
+ * if any of the scalars is 0 mod L, its inverse being set to 0, or if
+ * memory could not be allocated. recip and s can be the same buffer.
+ */
+SODIUM_EXPORT
+int crypto_core_ed25519_scalar_invert_batch(unsigned char *recip,
+                                            const unsigned char *s,
+                                            size_t count)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void crypto_core_ed25519_scalar_negate(unsigned char *neg, const unsigned char *s)
             __attribute__ ((nonnull));
@@ -93,6 +129,14 @@ void crypto_core_ed25519_scalar_mul(unsigned char *z, const unsigned char *x,
                                     const unsigned char *y)
             __attribute__ ((nonnull));
 
+/* z[i] = x[i] * y[i] for count scalars */
+SODIUM_EXPORT
+void crypto_core_ed25519_scalar_mul_many(unsigned char *z,
+                                         const unsigned char *x,
+                                         const unsigned char *y,
+                                         size_t count)
+            __attribute__ ((nonnull));
+
 /*
  * The interval `s` is sampled from should be at least 317 bits to ensure almost
  * uniformity of `r` over `L`.
@@ -8,6 +8,14 @@
 extern "C" {
 #endif
 
+/*
+ * A decoded group element. Chains of operations on points should use this
+ * type, so that points are only encoded and decoded at the boundaries.
+ */
+typedef struct CRYPTO_ALIGN(16) crypto_core_ristretto255_point {
+    unsigned char opaque[160];
+} crypto_core_ristretto255_point;
+
 #define crypto_core_ristretto255_BYTES 32
 SODIUM_EXPORT
 size_t crypto_core_ristretto255_bytes(void);
@@ -38,6 +46,66 @@ int crypto_core_ristretto255_sub(unsigned char *r,
                                  const unsigned char *p, const unsigned char *q)
             __attribute__ ((nonnull));
 
+/*
+ * r[i] = 2 * p[i] for count points, sharing the encoding work between
+ * points. Returns -1 if any of the points is not valid, in which case r is
+ * only partially written.
+ */
+SODIUM_EXPORT
+int crypto_core_ristretto255_double_batch(unsigned char *r,
+                                          const unsigned char *p, size_t count)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+size_t crypto_core_ristretto255_pointbytes(void);
+
+/* Returns -1 if p is not the encoding of a valid point */
+SODIUM_EXPORT
+int crypto_core_ristretto255_point_frombytes(crypto_core_ristretto255_point *r,
+                                             const unsigned char *p)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_core_ristretto255_point_tobytes(unsigned char *r,
+                                            const crypto_core_ristretto255_point *p)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_core_ristretto255_point_is_identity(const crypto_core_ristretto255_point *p)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_core_ristretto255_point_add(crypto_core_ristretto255_point *r,
+                                        const crypto_core_ristretto255_point *p,
+                                        const crypto_core_ristretto255_point *q)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_core_ristretto255_point_sub(crypto_core_ristretto255_point *r,
+                                        const crypto_core_ristretto255_point *p,
+                                        const crypto_core_ristretto255_point *q)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_core_ristretto255_point_dbl(crypto_core_ristretto255_point *r,
+                                        const crypto_core_ristretto255_point *p)
+            __attribute__ ((nonnull));
+
+/*
+ * Same scalar handling as crypto_scalarmult_ristretto255(): returns -1 if
+ * the result is the identity element, which r is then set to.
+ */
+SODIUM_EXPORT
+int crypto_core_ristretto255_point_scalarmult(crypto_core_ristretto255_point *r,
+                                              const unsigned char *n,
+                                              const crypto_core_ristretto255_point *p)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_core_ristretto255_point_scalarmult_base(crypto_core_ristretto255_point *r,
+                                                   const unsigned char *n)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int crypto_core_ristretto255_from_hash(unsigned char *p,
                                        const unsigned char *r)
@@ -70,6 +138,17 @@ int crypto_core_ristretto255_scalar_invert(unsigned char *recip,
                                            const unsigned char *s)
             __attribute__ ((nonnull));
 
+/*
+ * recip[i] = 1/s[i] for count scalars, with a single inversion. Returns -1
+ * if any of the scalars is 0 mod L, its inverse being set to 0, or if
+ * memory could not be allocated. recip and s can be the same buffer.
+ */
+SODIUM_EXPORT
+int crypto_core_ristretto255_scalar_invert_batch(unsigned char *recip,
+                                                 const unsigned char *s,
+                                                 size_t count)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void crypto_core_ristretto255_scalar_negate(unsigned char *neg,
                                             const unsigned char *s)
@@ -98,6 +177,14 @@ void crypto_core_ristretto255_scalar_mul(unsigned char *z,
                                          const unsigned char *y)
             __attribute__ ((nonnull));
 
+/* z[i] = x[i] * y[i] for count scalars */
+SODIUM_EXPORT
+void crypto_core_ristretto255_scalar_mul_many(unsigned char *z,
+                                              const unsigned char *x,
+                                              const unsigned char *y,
+                                              size_t count)
+            __attribute__ ((nonnull));
+
 /*
  * The interval `s` is sampled from should be at least 317 bits to ensure almost
  * uniformity of `r` over `L`.
@@ -0,0 +1,150 @@
+#ifndef crypto_file_H
+#define crypto_file_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * Encrypted files with random access.
+ *
+ * The plaintext is split into chunks of a fixed size, and every chunk is
+ * encrypted independently, using a nonce derived from a random file
+ * nonce and its index. A chunk is crypto_file_ABYTES longer than its
+ * plaintext. The last chunk is marked as such, so that truncating the
+ * file is detected; it can be shorter than the others, or empty.
+ *
+ * The header stores the parameters and the file nonce, and is
+ * authenticated with crypto_generichash(). Every chunk is bound to it.
+ *
+ * A chunk must never be encrypted twice with the same header: to modify
+ * an existing file, write a new header and encrypt it again.
+ */
+
+#define crypto_file_ALG_XCHACHA20POLY1305 1U
+#define crypto_file_ALG_AEGIS256          2U
+
+#define crypto_file_KEYBYTES 32U
+SODIUM_EXPORT
+size_t crypto_file_keybytes(void);
+
+#define crypto_file_HEADERBYTES 56U
+SODIUM_EXPORT
+size_t crypto_file_headerbytes(void);
+
+#define crypto_file_ABYTES 16U
+SODIUM_EXPORT
+size_t crypto_file_abytes(void);
+
+#define crypto_file_CHUNKBYTES_MIN 64U
+SODIUM_EXPORT
+size_t crypto_file_chunkbytes_min(void);
+
+#define crypto_file_CHUNKBYTES_MAX 0x40000000U
+SODIUM_EXPORT
+size_t crypto_file_chunkbytes_max(void);
+
+#define crypto_file_CHUNKBYTES 65536U
+SODIUM_EXPORT
+size_t crypto_file_chunkbytes(void);
+
+typedef struct CRYPTO_ALIGN(16) crypto_file_state {
+    unsigned char opaque[96];
+} crypto_file_state;
+
+SODIUM_EXPORT
+size_t crypto_file_statebytes(void);
+
+SODIUM_EXPORT
+void crypto_file_keygen(unsigned char k[crypto_file_KEYBYTES])
+            __attribute__ ((nonnull));
+
+/* Creates a new header, with a random file nonce */
+SODIUM_EXPORT
+int crypto_file_init_push(crypto_file_state *state,
+                          unsigned char header[crypto_file_HEADERBYTES],
+                          const unsigned char k[crypto_file_KEYBYTES],
+                          unsigned int algorithm, size_t chunk_bytes)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/* Returns -1 if the header was not created with that key */
+SODIUM_EXPORT
+int crypto_file_init_pull(crypto_file_state *state,
+                          const unsigned char header[crypto_file_HEADERBYTES],
+                          const unsigned char k[crypto_file_KEYBYTES])
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+size_t crypto_file_state_chunkbytes(const crypto_file_state *state)
+            __attribute__ ((nonnull));
+
+/* Length of the encrypted chunks of a plaintext of mlen bytes, header excluded */
+SODIUM_EXPORT
+unsigned long long crypto_file_ciphertext_length(const crypto_file_state *state,
+                                                 unsigned long long mlen)
+            __attribute__ ((nonnull));
+
+/* Returns -1 if clen cannot be the length of a sequence of chunks */
+SODIUM_EXPORT
+int crypto_file_plaintext_length(const crypto_file_state *state,
+                                 unsigned long long *mlen_p,
+                                 unsigned long long clen)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Single chunks. mlen must be the chunk size, except for the last chunk,
+ * which has final set and can be shorter.
+ */
+SODIUM_EXPORT
+int crypto_file_encrypt_chunk(const crypto_file_state *state,
+                              unsigned char *c, const unsigned char *m,
+                              size_t mlen, uint64_t chunk_index, int final)
+            __attribute__ ((nonnull(1, 2)));
+
+SODIUM_EXPORT
+int crypto_file_decrypt_chunk(const crypto_file_state *state,
+                              unsigned char *m, const unsigned char *c,
+                              size_t clen, uint64_t chunk_index, int final)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3)));
+
+/*
+ * Encrypts mlen bytes of plaintext, starting at plaintext offset offset,
+ * into the chunks that start at c, the beginning of the encrypted data.
+ * offset must be a multiple of the chunk size, and so must mlen, unless
+ * final is set to write the end of the file.
+ *
+ * Chunks are encrypted by up to threads threads.
+ */
+SODIUM_EXPORT
+int crypto_file_pwrite(const crypto_file_state *state, unsigned char *c,
+                       const unsigned char *m, unsigned long long mlen,
+                       unsigned long long offset, int final,
+                       unsigned int threads)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 2)));
+
+/*
+ * Decrypts mlen bytes of plaintext, starting at any plaintext offset,
+ * from the clen bytes of encrypted data at c. Only the chunks covering
+ * that range are decrypted, by up to threads threads. Returns -1 if one of
+ * them is not valid, or if the range goes past the end of the file.
+ */
+SODIUM_EXPORT
+int crypto_file_pread(const crypto_file_state *state, unsigned char *m,
+                      unsigned long long mlen, unsigned long long offset,
+                      const unsigned char *c, unsigned long long clen,
+                      unsigned int threads)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 5)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
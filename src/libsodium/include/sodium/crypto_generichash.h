@@ -73,6 +73,11 @@ int crypto_generichash_final(crypto_generichash_state *state,
                              unsigned char *out, const size_t outlen)
             __attribute__ ((nonnull));
 
+SODIUM_EXPORT
+void crypto_generichash_state_clone(crypto_generichash_state *dst,
+                                    const crypto_generichash_state *src)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void crypto_generichash_keygen(unsigned char k[crypto_generichash_KEYBYTES])
             __attribute__ ((nonnull));
@@ -82,6 +82,17 @@ int crypto_generichash_blake2b_salt_personal(unsigned char *out, size_t outlen,
                                              const unsigned char *personal)
             __attribute__ ((nonnull(1)));
 
+/*
+ * Hashes count independent messages with the same key and output length,
+ * several of them at a time when SIMD instructions are available.
+ */
+SODIUM_EXPORT
+int crypto_generichash_blake2b_multi(unsigned char * const *out, size_t outlen,
+                                     const unsigned char * const *in,
+                                     const unsigned long long *inlen,
+                                     size_t count,
+                                     const unsigned char *key, size_t keylen);
+
 SODIUM_EXPORT
 int crypto_generichash_blake2b_init(crypto_generichash_blake2b_state *state,
                                     const unsigned char *key,
@@ -107,6 +118,16 @@ int crypto_generichash_blake2b_final(crypto_generichash_blake2b_state *state,
                                      unsigned char *out,
                                      const size_t outlen) __attribute__ ((nonnull));
 
+/*
+ * Copies a state, e.g. after keying it or absorbing a common prefix, so that
+ * several messages can be hashed from that point without redoing the work.
+ * The key block is compressed by _init(), not by the first _update().
+ */
+SODIUM_EXPORT
+void crypto_generichash_blake2b_state_clone(crypto_generichash_blake2b_state *dst,
+                                            const crypto_generichash_blake2b_state *src)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void crypto_generichash_blake2b_keygen(unsigned char k[crypto_generichash_blake2b_KEYBYTES])
             __attribute__ ((nonnull));
@@ -0,0 +1,93 @@
+#ifndef crypto_generichash_blake2b_tree_H
+#define crypto_generichash_blake2b_tree_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * A binary BLAKE2b hash tree over fixed-size leaves, using the tree
+ * hashing parameters of BLAKE2b (fanout 2, leaf_length, node_offset,
+ * node_depth).
+ *
+ * Every node hash is kept in a caller-provided buffer, which is also the
+ * serialized form of the tree and can be stored next to the object.
+ * After a leaf changes, only the nodes on its path to the root are
+ * recomputed.
+ */
+
+#define crypto_generichash_blake2b_tree_BYTES_MIN     16U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2b_tree_bytes_min(void);
+
+#define crypto_generichash_blake2b_tree_BYTES_MAX     64U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2b_tree_bytes_max(void);
+
+#define crypto_generichash_blake2b_tree_KEYBYTES_MIN  16U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2b_tree_keybytes_min(void);
+
+#define crypto_generichash_blake2b_tree_KEYBYTES_MAX  64U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2b_tree_keybytes_max(void);
+
+#define crypto_generichash_blake2b_tree_LEAFBYTES_MIN 128U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2b_tree_leafbytes_min(void);
+
+#define crypto_generichash_blake2b_tree_LEAFBYTES_MAX 0xffffffffU
+SODIUM_EXPORT
+size_t crypto_generichash_blake2b_tree_leafbytes_max(void);
+
+/*
+ * Size of the buffer required for an object of inlen bytes split into
+ * leaves of leaf_length bytes, or 0 if these parameters are not supported.
+ */
+SODIUM_EXPORT
+size_t crypto_generichash_blake2b_tree_treebytes(unsigned long long inlen,
+                                                 size_t leaf_length);
+
+SODIUM_EXPORT
+int crypto_generichash_blake2b_tree_init(unsigned char *tree, size_t tree_len,
+                                         const unsigned char *in,
+                                         unsigned long long inlen,
+                                         size_t leaf_length,
+                                         const unsigned char *key,
+                                         size_t keylen, size_t outlen)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1)));
+
+/*
+ * Replaces leaf leaf_index, whose length cannot change, and updates the
+ * root. The key must be the one given to _init().
+ */
+SODIUM_EXPORT
+int crypto_generichash_blake2b_tree_update_leaf(unsigned char *tree,
+                                                size_t tree_len,
+                                                unsigned long long leaf_index,
+                                                const unsigned char *leaf,
+                                                size_t leaf_len,
+                                                const unsigned char *key,
+                                                size_t keylen)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake2b_tree_root(unsigned char *out, size_t outlen,
+                                         const unsigned char *tree,
+                                         size_t tree_len)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef crypto_generichash_blake2bp_H
+#define crypto_generichash_blake2bp_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * BLAKE2bp: 4 BLAKE2b leaves, each hashing every fourth 128-byte block,
+ * and a root node hashing the leaf digests. It produces different
+ * outputs than BLAKE2b, but large inputs are hashed several times faster
+ * using SIMD instructions.
+ */
+
+#if defined(__IBMC__) || defined(__SUNPRO_C) || defined(__SUNPRO_CC)
+# pragma pack(1)
+#else
+# pragma pack(push, 1)
+#endif
+
+typedef struct CRYPTO_ALIGN(64) crypto_generichash_blake2bp_state {
+    unsigned char opaque[2880];
+} crypto_generichash_blake2bp_state;
+
+#if defined(__IBMC__) || defined(__SUNPRO_C) || defined(__SUNPRO_CC)
+# pragma pack()
+#else
+# pragma pack(pop)
+#endif
+
+#define crypto_generichash_blake2bp_BYTES_MIN     16U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2bp_bytes_min(void);
+
+#define crypto_generichash_blake2bp_BYTES_MAX     64U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2bp_bytes_max(void);
+
+#define crypto_generichash_blake2bp_BYTES         32U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2bp_bytes(void);
+
+#define crypto_generichash_blake2bp_KEYBYTES_MIN  16U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2bp_keybytes_min(void);
+
+#define crypto_generichash_blake2bp_KEYBYTES_MAX  64U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2bp_keybytes_max(void);
+
+#define crypto_generichash_blake2bp_KEYBYTES      32U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2bp_keybytes(void);
+
+SODIUM_EXPORT
+size_t crypto_generichash_blake2bp_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_generichash_blake2bp(unsigned char *out, size_t outlen,
+                                const unsigned char *in,
+                                unsigned long long inlen,
+                                const unsigned char *key, size_t keylen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake2bp_init(crypto_generichash_blake2bp_state *state,
+                                     const unsigned char *key,
+                                     const size_t keylen, const size_t outlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake2bp_update(crypto_generichash_blake2bp_state *state,
+                                       const unsigned char *in,
+                                       unsigned long long inlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake2bp_final(crypto_generichash_blake2bp_state *state,
+                                      unsigned char *out,
+                                      const size_t outlen) __attribute__ ((nonnull));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
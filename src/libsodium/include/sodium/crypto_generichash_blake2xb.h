@@ -0,0 +1,104 @@
+#ifndef crypto_generichash_blake2xb_H
+#define crypto_generichash_blake2xb_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * BLAKE2Xb: an extendable-output function built on BLAKE2b. The input is
+ * hashed once, and every 64-byte output block is an independent hash of
+ * that digest, so that long outputs are computed using SIMD instructions.
+ *
+ * The output length is part of the parameters: outputs of different
+ * lengths are unrelated, unless the length is given as
+ * crypto_generichash_blake2xb_BYTES_UNKNOWN.
+ */
+
+#if defined(__IBMC__) || defined(__SUNPRO_C) || defined(__SUNPRO_CC)
+# pragma pack(1)
+#else
+# pragma pack(push, 1)
+#endif
+
+typedef struct CRYPTO_ALIGN(64) crypto_generichash_blake2xb_state {
+    unsigned char opaque[512];
+} crypto_generichash_blake2xb_state;
+
+#if defined(__IBMC__) || defined(__SUNPRO_C) || defined(__SUNPRO_CC)
+# pragma pack()
+#else
+# pragma pack(pop)
+#endif
+
+#define crypto_generichash_blake2xb_BYTES_MIN     1U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2xb_bytes_min(void);
+
+#define crypto_generichash_blake2xb_BYTES_MAX     0xfffffffeU
+SODIUM_EXPORT
+size_t crypto_generichash_blake2xb_bytes_max(void);
+
+/* Up to 2^32 blocks of 64 bytes can then be squeezed */
+#define crypto_generichash_blake2xb_BYTES_UNKNOWN 0xffffffffU
+SODIUM_EXPORT
+size_t crypto_generichash_blake2xb_bytes_unknown(void);
+
+#define crypto_generichash_blake2xb_KEYBYTES_MIN  16U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2xb_keybytes_min(void);
+
+#define crypto_generichash_blake2xb_KEYBYTES_MAX  64U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2xb_keybytes_max(void);
+
+#define crypto_generichash_blake2xb_KEYBYTES      32U
+SODIUM_EXPORT
+size_t crypto_generichash_blake2xb_keybytes(void);
+
+SODIUM_EXPORT
+size_t crypto_generichash_blake2xb_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_generichash_blake2xb(unsigned char *out, size_t outlen,
+                                const unsigned char *in,
+                                unsigned long long inlen,
+                                const unsigned char *key, size_t keylen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake2xb_init(crypto_generichash_blake2xb_state *state,
+                                     const unsigned char *key,
+                                     const size_t keylen, const size_t outlen)
+            __attribute__ ((nonnull(1)));
+
+/* Returns -1 once output has been squeezed */
+SODIUM_EXPORT
+int crypto_generichash_blake2xb_update(crypto_generichash_blake2xb_state *state,
+                                       const unsigned char *in,
+                                       unsigned long long inlen)
+            __attribute__ ((nonnull(1)));
+
+/*
+ * Returns the next outlen bytes of output. It can be called repeatedly, and
+ * returns -1 if that would exceed the length given to _init().
+ */
+SODIUM_EXPORT
+int crypto_generichash_blake2xb_squeeze(crypto_generichash_blake2xb_state *state,
+                                        unsigned char *out, size_t outlen)
+            __attribute__ ((nonnull(1)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
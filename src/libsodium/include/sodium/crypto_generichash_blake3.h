@@ -0,0 +1,112 @@
+#ifndef crypto_generichash_blake3_H
+#define crypto_generichash_blake3_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * BLAKE3: a tree hash over 1 KiB chunks, with keyed hashing, key
+ * derivation, and an extendable output. Large inputs are hashed using
+ * SIMD instructions across chunks, and optionally using multiple threads.
+ */
+
+#if defined(__IBMC__) || defined(__SUNPRO_C) || defined(__SUNPRO_CC)
+# pragma pack(1)
+#else
+# pragma pack(push, 1)
+#endif
+
+typedef struct CRYPTO_ALIGN(16) crypto_generichash_blake3_state {
+    unsigned char opaque[1920];
+} crypto_generichash_blake3_state;
+
+#if defined(__IBMC__) || defined(__SUNPRO_C) || defined(__SUNPRO_CC)
+# pragma pack()
+#else
+# pragma pack(pop)
+#endif
+
+#define crypto_generichash_blake3_BYTES    32U
+SODIUM_EXPORT
+size_t crypto_generichash_blake3_bytes(void);
+
+#define crypto_generichash_blake3_KEYBYTES 32U
+SODIUM_EXPORT
+size_t crypto_generichash_blake3_keybytes(void);
+
+SODIUM_EXPORT
+size_t crypto_generichash_blake3_statebytes(void);
+
+/* The key is optional, but must be exactly KEYBYTES long if present.
+ * outlen can be any length: shorter outputs are prefixes of longer ones. */
+SODIUM_EXPORT
+int crypto_generichash_blake3(unsigned char *out, size_t outlen,
+                              const unsigned char *in,
+                              unsigned long long inlen,
+                              const unsigned char *key, size_t keylen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake3_derive_key(unsigned char *out, size_t outlen,
+                                         const char *context,
+                                         const unsigned char *ikm,
+                                         size_t ikmlen)
+            __attribute__ ((nonnull(1, 3)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake3_init(crypto_generichash_blake3_state *state,
+                                   const unsigned char *key,
+                                   size_t keylen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_generichash_blake3_init_derive_key(crypto_generichash_blake3_state *state,
+                                              const char *context)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_generichash_blake3_update(crypto_generichash_blake3_state *state,
+                                     const unsigned char *in,
+                                     unsigned long long inlen)
+            __attribute__ ((nonnull(1)));
+
+/* Same as _update(), hashing large inputs using up to `threads` threads */
+SODIUM_EXPORT
+int crypto_generichash_blake3_update_parallel(crypto_generichash_blake3_state *state,
+                                              const unsigned char *in,
+                                              unsigned long long inlen,
+                                              unsigned int threads)
+            __attribute__ ((nonnull(1)));
+
+/* The state is left unchanged, so more data can still be added */
+SODIUM_EXPORT
+int crypto_generichash_blake3_final(crypto_generichash_blake3_state *state,
+                                    unsigned char *out, size_t outlen)
+            __attribute__ ((nonnull(1)));
+
+/* Returns outlen bytes of the extended output, starting at `offset` */
+SODIUM_EXPORT
+int crypto_generichash_blake3_final_seek(crypto_generichash_blake3_state *state,
+                                         uint64_t offset,
+                                         unsigned char *out, size_t outlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+void crypto_generichash_blake3_keygen(unsigned char k[crypto_generichash_blake3_KEYBYTES])
+            __attribute__ ((nonnull));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
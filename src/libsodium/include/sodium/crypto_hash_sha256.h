@@ -38,6 +38,28 @@ SODIUM_EXPORT
 int crypto_hash_sha256(unsigned char *out, const unsigned char *in,
                        unsigned long long inlen) __attribute__ ((nonnull(1)));
 
+/*
+ * Hashes count independent messages, several of them at a time when SIMD
+ * instructions are available.
+ */
+SODIUM_EXPORT
+int crypto_hash_sha256_multi(unsigned char * const *out,
+                             const unsigned char * const *in,
+                             const unsigned long long *inlen, size_t count);
+
+/*
+ * Merkle tree root of n consecutive leaves of leaf_size bytes each, as
+ * defined in RFC 6962: leaves are hashed as SHA-256(0x00 || leaf), and
+ * inner nodes as SHA-256(0x01 || left || right). Each level of the tree
+ * is hashed using crypto_hash_sha256_multi(). Returns -1 with errno set to
+ * ENOMEM if temporary storage cannot be allocated.
+ */
+SODIUM_EXPORT
+int crypto_hash_sha256_merkle_root(unsigned char *out,
+                                   const unsigned char *leaves,
+                                   size_t n, size_t leaf_size)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1)));
+
 SODIUM_EXPORT
 int crypto_hash_sha256_init(crypto_hash_sha256_state *state)
             __attribute__ ((nonnull));
@@ -42,6 +42,13 @@ int crypto_kdf_derive_from_key(unsigned char *subkey, size_t subkey_len,
                                const unsigned char key[crypto_kdf_KEYBYTES])
             __attribute__ ((nonnull));
 
+SODIUM_EXPORT
+int crypto_kdf_derive_from_key_range(unsigned char *out, size_t subkey_len,
+                                     uint64_t first_id, size_t count,
+                                     const char ctx[crypto_kdf_CONTEXTBYTES],
+                                     const unsigned char key[crypto_kdf_KEYBYTES])
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void crypto_kdf_keygen(unsigned char k[crypto_kdf_KEYBYTES])
             __attribute__ ((nonnull));
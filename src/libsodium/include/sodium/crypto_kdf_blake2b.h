@@ -37,6 +37,14 @@ int crypto_kdf_blake2b_derive_from_key(unsigned char *subkey, size_t subkey_len,
                                        const unsigned char key[crypto_kdf_blake2b_KEYBYTES])
             __attribute__ ((nonnull));
 
+/* Derives subkeys first_id...first_id+count-1 into out, subkey_len bytes each */
+SODIUM_EXPORT
+int crypto_kdf_blake2b_derive_from_key_range(unsigned char *out, size_t subkey_len,
+                                             uint64_t first_id, size_t count,
+                                             const char ctx[crypto_kdf_blake2b_CONTEXTBYTES],
+                                             const unsigned char key[crypto_kdf_blake2b_KEYBYTES])
+            __attribute__ ((nonnull));
+
 #ifdef __cplusplus
 }
 #endif
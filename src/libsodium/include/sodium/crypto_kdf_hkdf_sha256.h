@@ -41,6 +41,24 @@ int crypto_kdf_hkdf_sha256_expand(unsigned char *out, size_t out_len,
                                   const char *ctx, size_t ctx_len,
                                   const unsigned char prk[crypto_kdf_hkdf_sha256_KEYBYTES]);
 
+/* Expansion state, computed once from the PRK and reused for any number of contexts */
+
+typedef struct crypto_kdf_hkdf_sha256_state {
+    crypto_auth_hmacsha256_key_state kst;
+} crypto_kdf_hkdf_sha256_state;
+
+SODIUM_EXPORT
+size_t crypto_kdf_hkdf_sha256_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_kdf_hkdf_sha256_precompute(crypto_kdf_hkdf_sha256_state *state,
+                                      const unsigned char prk[crypto_kdf_hkdf_sha256_KEYBYTES]);
+
+SODIUM_EXPORT
+int crypto_kdf_hkdf_sha256_expand_precomputed(unsigned char *out, size_t out_len,
+                                              const char *ctx, size_t ctx_len,
+                                              const crypto_kdf_hkdf_sha256_state *state);
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,26 @@ int crypto_kdf_hkdf_sha512_expand(unsigned char *out, size_t out_len,
                                   const unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES])
             __attribute__ ((nonnull(1)));
 
+/* Expansion state, computed once from the PRK and reused for any number of contexts */
+
+typedef struct crypto_kdf_hkdf_sha512_state {
+    crypto_auth_hmacsha512_key_state kst;
+} crypto_kdf_hkdf_sha512_state;
+
+SODIUM_EXPORT
+size_t crypto_kdf_hkdf_sha512_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_kdf_hkdf_sha512_precompute(crypto_kdf_hkdf_sha512_state *state,
+                                      const unsigned char prk[crypto_kdf_hkdf_sha512_KEYBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_kdf_hkdf_sha512_expand_precomputed(unsigned char *out, size_t out_len,
+                                              const char *ctx, size_t ctx_len,
+                                              const crypto_kdf_hkdf_sha512_state *state)
+            __attribute__ ((nonnull(1, 5)));
+
 #ifdef __cplusplus
 }
 #endif
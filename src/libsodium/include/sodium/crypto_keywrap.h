@@ -0,0 +1,87 @@
+#ifndef crypto_keywrap_H
+#define crypto_keywrap_H
+
+#include <stddef.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * Deterministic encryption of 32-byte keys with a key-encryption key.
+ *
+ * The synthetic IV is a keyed BLAKE2b hash of the key and of the
+ * additional data, and is used as the ChaCha20 counter and nonce. Wrapping
+ * the same key twice with the same additional data gives the same output,
+ * which reveals that the two are equal, but nothing else.
+ */
+
+#define crypto_keywrap_KEYBYTES 32U
+SODIUM_EXPORT
+size_t crypto_keywrap_keybytes(void);
+
+#define crypto_keywrap_INPUTBYTES 32U
+SODIUM_EXPORT
+size_t crypto_keywrap_inputbytes(void);
+
+#define crypto_keywrap_WRAPPEDBYTES 48U
+SODIUM_EXPORT
+size_t crypto_keywrap_wrappedbytes(void);
+
+#define crypto_keywrap_PRIMITIVE "chacha20blake2bsiv"
+SODIUM_EXPORT
+const char *crypto_keywrap_primitive(void);
+
+SODIUM_EXPORT
+void crypto_keywrap_keygen(unsigned char kek[crypto_keywrap_KEYBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_keywrap(unsigned char wrapped[crypto_keywrap_WRAPPEDBYTES],
+                   const unsigned char in[crypto_keywrap_INPUTBYTES],
+                   const unsigned char *ad, unsigned long long adlen,
+                   const unsigned char kek[crypto_keywrap_KEYBYTES])
+            __attribute__ ((nonnull(1, 2, 5)));
+
+SODIUM_EXPORT
+int crypto_keywrap_open(unsigned char out[crypto_keywrap_INPUTBYTES],
+                        const unsigned char wrapped[crypto_keywrap_WRAPPEDBYTES],
+                        const unsigned char *ad, unsigned long long adlen,
+                        const unsigned char kek[crypto_keywrap_KEYBYTES])
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 2, 5)));
+
+/*
+ * Wraps count keys with the same key-encryption key, several of them at a
+ * time when SIMD instructions are available.
+ * ad and adlen can be NULL if none of the keys have additional data.
+ */
+SODIUM_EXPORT
+int crypto_keywrap_batch(unsigned char * const *wrapped,
+                         const unsigned char * const *in,
+                         const unsigned char * const *ad,
+                         const unsigned long long *adlen, size_t count,
+                         const unsigned char kek[crypto_keywrap_KEYBYTES])
+            __attribute__ ((nonnull(6)));
+
+/*
+ * Returns -1 if any of the wrapped keys doesn't verify; these are cleared,
+ * the other ones are still unwrapped.
+ */
+SODIUM_EXPORT
+int crypto_keywrap_open_batch(unsigned char * const *out,
+                              const unsigned char * const *wrapped,
+                              const unsigned char * const *ad,
+                              const unsigned long long *adlen, size_t count,
+                              const unsigned char kek[crypto_keywrap_KEYBYTES])
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(6)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
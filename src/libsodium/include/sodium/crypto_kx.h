@@ -59,6 +59,20 @@ int crypto_kx_server_session_keys(unsigned char rx[crypto_kx_SESSIONKEYBYTES],
                                   const unsigned char client_pk[crypto_kx_PUBLICKEYBYTES])
             __attribute__ ((warn_unused_result))  __attribute__ ((nonnull(3, 4, 5)));
 
+/*
+ * Computes the server session keys for count clients at once.
+ * Returns -1 if any of the client public keys is unacceptable; the keys
+ * for these clients are cleared, the other ones are still computed.
+ */
+SODIUM_EXPORT
+int crypto_kx_server_session_keys_batch(unsigned char * const *rx,
+                                        unsigned char * const *tx,
+                                        const unsigned char server_pk[crypto_kx_PUBLICKEYBYTES],
+                                        const unsigned char server_sk[crypto_kx_SECRETKEYBYTES],
+                                        const unsigned char * const *client_pk,
+                                        size_t count)
+            __attribute__ ((warn_unused_result))  __attribute__ ((nonnull(3, 4)));
+
 #ifdef __cplusplus
 }
 #endif
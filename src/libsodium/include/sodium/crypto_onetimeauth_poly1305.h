@@ -61,6 +61,18 @@ int crypto_onetimeauth_poly1305_final(crypto_onetimeauth_poly1305_state *state,
                                       unsigned char *out)
             __attribute__ ((nonnull));
 
+/*
+ * Computes count independent MACs: macs[i] is the authenticator of the
+ * mlens[i] bytes at ms[i] with the one-time key keys[i]. Short messages
+ * are processed several at a time, one per vector lane.
+ */
+SODIUM_EXPORT
+int crypto_onetimeauth_poly1305_batch(unsigned char * const *macs,
+                                      const unsigned char * const *ms,
+                                      const unsigned long long *mlens,
+                                      const unsigned char * const *keys,
+                                      size_t count);
+
 SODIUM_EXPORT
 void crypto_onetimeauth_poly1305_keygen(unsigned char k[crypto_onetimeauth_poly1305_KEYBYTES])
             __attribute__ ((nonnull));
@@ -124,6 +124,34 @@ int crypto_pwhash_str_alg(char out[crypto_pwhash_STRBYTES],
                           unsigned long long opslimit, size_t memlimit, int alg)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/*
+ * Same as crypto_pwhash() and crypto_pwhash_str(), periodically calling
+ * `progress` with the amount of work done so far, and the total.
+ * If it returns a non-zero value, the computation is aborted, and -1 is
+ * returned with errno set to ECANCELED.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_progress(unsigned char * const out, unsigned long long outlen,
+                           const char * const passwd, unsigned long long passwdlen,
+                           const unsigned char * const salt,
+                           unsigned long long opslimit, size_t memlimit, int alg,
+                           int (*progress)(void *opaque,
+                                           unsigned long long done,
+                                           unsigned long long total),
+                           void *opaque)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 5, 9)));
+
+SODIUM_EXPORT
+int crypto_pwhash_str_progress(char out[crypto_pwhash_STRBYTES],
+                               const char * const passwd,
+                               unsigned long long passwdlen,
+                               unsigned long long opslimit, size_t memlimit,
+                               int (*progress)(void *opaque,
+                                               unsigned long long done,
+                                               unsigned long long total),
+                               void *opaque)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 2, 6)));
+
 SODIUM_EXPORT
 int crypto_pwhash_str_verify(const char str[crypto_pwhash_STRBYTES],
                              const char * const passwd,
@@ -135,6 +163,48 @@ int crypto_pwhash_str_needs_rehash(const char str[crypto_pwhash_STRBYTES],
                                    unsigned long long opslimit, size_t memlimit)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/*
+ * Verifies many (string, password) pairs at once, for example to audit
+ * stored hashes. See crypto_pwhash_argon2_str_verify_many().
+ */
+SODIUM_EXPORT
+int crypto_pwhash_str_verify_many(int *results,
+                                  const char * const *strs,
+                                  const char * const *passwds,
+                                  const unsigned long long *passwdlens,
+                                  size_t count, unsigned int threads)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Backs the memory of subsequent Argon2 and scrypt computations with huge
+ * pages when possible (or stops doing so), reducing TLB misses with large
+ * memlimits. Returns -1 with errno = ENOSYS if the platform doesn't
+ * support them. This setting is global and not thread-safe.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_set_huge_pages(int enable);
+
+/*
+ * Limits the total memory used by concurrent Argon2 and scrypt
+ * computations to `bytes` (0 for no limit, the default). Computations
+ * that would exceed it wait for others to complete when threads are
+ * available, and fail with errno = ENOMEM otherwise, or if they need more
+ * than the whole budget. Argon2 arenas count for their entire size.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_set_memory_budget(size_t bytes);
+
+/*
+ * Measures the Argon2id throughput of this machine, and returns the
+ * opslimit and memlimit (at most max_mem) for crypto_pwhash() and
+ * crypto_pwhash_str() to take about target_ms milliseconds. This takes
+ * about target_ms, plus a few short probes.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_calibrate(unsigned int target_ms, size_t max_mem,
+                            unsigned long long *opslimit, size_t *memlimit)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
 #define crypto_pwhash_PRIMITIVE "argon2i"
 SODIUM_EXPORT
 const char *crypto_pwhash_primitive(void)
@@ -97,6 +97,24 @@ int crypto_pwhash_argon2i(unsigned char * const out,
                           int alg)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/*
+ * Same as above, calling `progress` after every slice of each pass.
+ * A non-zero return value aborts the computation with errno set to ECANCELED.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_argon2i_progress(unsigned char * const out,
+                                   unsigned long long outlen,
+                                   const char * const passwd,
+                                   unsigned long long passwdlen,
+                                   const unsigned char * const salt,
+                                   unsigned long long opslimit, size_t memlimit,
+                                   int alg,
+                                   int (*progress)(void *opaque,
+                                                   unsigned long long done,
+                                                   unsigned long long total),
+                                   void *opaque)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 5, 9)));
+
 SODIUM_EXPORT
 int crypto_pwhash_argon2i_str(char out[crypto_pwhash_argon2i_STRBYTES],
                               const char * const passwd,
@@ -63,6 +63,14 @@ size_t crypto_pwhash_argon2id_memlimit_min(void);
 SODIUM_EXPORT
 size_t crypto_pwhash_argon2id_memlimit_max(void);
 
+#define crypto_pwhash_argon2id_PARALLELISM_MIN 1U
+SODIUM_EXPORT
+size_t crypto_pwhash_argon2id_parallelism_min(void);
+
+#define crypto_pwhash_argon2id_PARALLELISM_MAX 16777215U
+SODIUM_EXPORT
+size_t crypto_pwhash_argon2id_parallelism_max(void);
+
 #define crypto_pwhash_argon2id_OPSLIMIT_INTERACTIVE 2U
 SODIUM_EXPORT
 unsigned long long crypto_pwhash_argon2id_opslimit_interactive(void);
@@ -104,6 +112,60 @@ int crypto_pwhash_argon2id_str(char out[crypto_pwhash_argon2id_STRBYTES],
                                unsigned long long opslimit, size_t memlimit)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/*
+ * Same as above, with `parallelism` lanes, filled by up to 16 threads
+ * when threads are available. memlimit must be at least
+ * 8192 * parallelism bytes.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_parallel(unsigned char * const out,
+                                    unsigned long long outlen,
+                                    const char * const passwd,
+                                    unsigned long long passwdlen,
+                                    const unsigned char * const salt,
+                                    unsigned long long opslimit, size_t memlimit,
+                                    size_t parallelism, int alg)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_str_parallel(char out[crypto_pwhash_argon2id_STRBYTES],
+                                        const char * const passwd,
+                                        unsigned long long passwdlen,
+                                        unsigned long long opslimit,
+                                        size_t memlimit, size_t parallelism)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Same as crypto_pwhash_argon2id() and crypto_pwhash_argon2id_str(), calling
+ * `progress` after every slice of each pass. If it returns a non-zero value,
+ * the computation is aborted, and -1 is returned with errno set to ECANCELED.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_progress(unsigned char * const out,
+                                    unsigned long long outlen,
+                                    const char * const passwd,
+                                    unsigned long long passwdlen,
+                                    const unsigned char * const salt,
+                                    unsigned long long opslimit, size_t memlimit,
+                                    int alg,
+                                    int (*progress)(void *opaque,
+                                                    unsigned long long done,
+                                                    unsigned long long total),
+                                    void *opaque)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 5, 9)));
+
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_str_progress(char out[crypto_pwhash_argon2id_STRBYTES],
+                                        const char * const passwd,
+                                        unsigned long long passwdlen,
+                                        unsigned long long opslimit,
+                                        size_t memlimit,
+                                        int (*progress)(void *opaque,
+                                                        unsigned long long done,
+                                                        unsigned long long total),
+                                        void *opaque)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 2, 6)));
+
 SODIUM_EXPORT
 int crypto_pwhash_argon2id_str_verify(const char str[crypto_pwhash_argon2id_STRBYTES],
                                       const char * const passwd,
@@ -115,6 +177,91 @@ int crypto_pwhash_argon2id_str_needs_rehash(const char str[crypto_pwhash_argon2i
                                             unsigned long long opslimit, size_t memlimit)
             __attribute__ ((warn_unused_result))  __attribute__ ((nonnull));
 
+/*
+ * Memory reused by consecutive computations, instead of mapping and
+ * unmapping a new region every time. Computations whose memlimit fits
+ * in the arena use it and wipe it before returning; larger ones fall back
+ * to a regular allocation. An arena must not be used by concurrent calls.
+ * If `lock` is set, the arena is also locked in memory.
+ * The data-independent addresses of the last parameters used are cached,
+ * as they don't depend on the password.
+ */
+typedef struct crypto_pwhash_argon2_arena {
+    void  *base;
+    void  *memory;
+    size_t size;
+    int    locked;
+    void  *address_cache;
+} crypto_pwhash_argon2_arena;
+
+SODIUM_EXPORT
+int crypto_pwhash_argon2_arena_init(crypto_pwhash_argon2_arena *arena,
+                                    size_t memlimit, int lock)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_pwhash_argon2_arena_free(crypto_pwhash_argon2_arena *arena)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_arena(crypto_pwhash_argon2_arena *arena,
+                                 unsigned char * const out,
+                                 unsigned long long outlen,
+                                 const char * const passwd,
+                                 unsigned long long passwdlen,
+                                 const unsigned char * const salt,
+                                 unsigned long long opslimit, size_t memlimit,
+                                 size_t parallelism, int alg)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_str_arena(crypto_pwhash_argon2_arena *arena,
+                                     char out[crypto_pwhash_argon2id_STRBYTES],
+                                     const char * const passwd,
+                                     unsigned long long passwdlen,
+                                     unsigned long long opslimit,
+                                     size_t memlimit, size_t parallelism)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_str_verify_arena(crypto_pwhash_argon2_arena *arena,
+                                            const char str[crypto_pwhash_argon2id_STRBYTES],
+                                            const char * const passwd,
+                                            unsigned long long passwdlen)
+            __attribute__ ((warn_unused_result))  __attribute__ ((nonnull));
+
+/*
+ * Verifies `count` pairs of Argon2i or Argon2id strings and passwords.
+ * results[i] is set to 0 if passwds[i] matches strs[i], and to -1 if it
+ * doesn't or if strs[i] is invalid. Up to `threads` threads are used,
+ * each with its own arena. Returns -1 only if the batch couldn't be
+ * processed at all.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_argon2_str_verify_many(int *results,
+                                         const char * const *strs,
+                                         const char * const *passwds,
+                                         const unsigned long long *passwdlens,
+                                         size_t count, unsigned int threads)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Computes `count` crypto_pwhash_argon2id() hashes with the same
+ * parameters, from a single thread: outs[i] is derived from passwds[i]
+ * and salts[i]. Hashes are computed two at a time, interleaved block by
+ * block, so that the memory latency of one is covered by the computation
+ * of the other. This requires up to twice memlimit bytes.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_argon2id_many(unsigned char * const *outs,
+                                unsigned long long outlen,
+                                const char * const *passwds,
+                                const unsigned long long *passwdlens,
+                                const unsigned char * const *salts,
+                                size_t count, unsigned long long opslimit,
+                                size_t memlimit, int alg)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
 #ifdef __cplusplus
 }
 #endif
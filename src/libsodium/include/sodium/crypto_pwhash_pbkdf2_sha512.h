@@ -0,0 +1,63 @@
+#ifndef crypto_pwhash_pbkdf2_sha512_H
+#define crypto_pwhash_pbkdf2_sha512_H
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * PBKDF2 (RFC 8018) with HMAC-SHA-512 as the PRF.
+ * This is only meant to verify and migrate existing hashes: new
+ * applications should use crypto_pwhash() instead.
+ */
+
+#define crypto_pwhash_pbkdf2_sha512_BYTES_MIN 1U
+SODIUM_EXPORT
+size_t crypto_pwhash_pbkdf2_sha512_bytes_min(void);
+
+#define crypto_pwhash_pbkdf2_sha512_BYTES_MAX \
+    SODIUM_MIN(SODIUM_SIZE_MAX, 0x3fffffffc0ULL)
+SODIUM_EXPORT
+size_t crypto_pwhash_pbkdf2_sha512_bytes_max(void);
+
+#define crypto_pwhash_pbkdf2_sha512_ITERATIONS_MIN 1U
+SODIUM_EXPORT
+size_t crypto_pwhash_pbkdf2_sha512_iterations_min(void);
+
+SODIUM_EXPORT
+int crypto_pwhash_pbkdf2_sha512(unsigned char *out, size_t outlen,
+                                const char *passwd, size_t passwdlen,
+                                const unsigned char *salt, size_t saltlen,
+                                unsigned long long iterations)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1)));
+
+/*
+ * Derives count keys at once, sharing the same output length and
+ * iteration count: out[i] = PBKDF2(passwds[i], salts[i]).
+ * Independent passwords and output blocks are computed in parallel,
+ * one per SIMD lane, when the CPU supports it.
+ */
+SODIUM_EXPORT
+int crypto_pwhash_pbkdf2_sha512_multi(unsigned char * const *out, size_t outlen,
+                                      const char * const *passwds,
+                                      const size_t *passwdlens,
+                                      const unsigned char * const *salts,
+                                      const size_t *saltlens,
+                                      unsigned long long iterations,
+                                      size_t count)
+            __attribute__ ((warn_unused_result));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -107,6 +107,32 @@ int crypto_pwhash_scryptsalsa208sha256_ll(const uint8_t * passwd, size_t passwdl
                                           uint8_t * buf, size_t buflen)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/* Same output as crypto_pwhash_scryptsalsa208sha256_ll(), with up to
+ * `threads` of the p SMix calls running concurrently. Each one needs its
+ * own 128*r*N bytes of memory. */
+SODIUM_EXPORT
+int crypto_pwhash_scryptsalsa208sha256_ll_threads(const uint8_t * passwd, size_t passwdlen,
+                                                  const uint8_t * salt, size_t saltlen,
+                                                  uint64_t N, uint32_t r, uint32_t p,
+                                                  unsigned int threads,
+                                                  uint8_t * buf, size_t buflen)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/* Same as crypto_pwhash_scryptsalsa208sha256_ll(), calling `progress`
+ * regularly with the number of steps done so far, out of 2*N*p.
+ * If it returns a non-zero value, the computation is aborted, and -1 is
+ * returned with errno set to ECANCELED. */
+SODIUM_EXPORT
+int crypto_pwhash_scryptsalsa208sha256_ll_progress(const uint8_t * passwd, size_t passwdlen,
+                                                   const uint8_t * salt, size_t saltlen,
+                                                   uint64_t N, uint32_t r, uint32_t p,
+                                                   uint8_t * buf, size_t buflen,
+                                                   int (*progress)(void *opaque,
+                                                                   unsigned long long done,
+                                                                   unsigned long long total),
+                                                   void *opaque)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 8, 10)));
+
 SODIUM_EXPORT
 int crypto_pwhash_scryptsalsa208sha256_str_needs_rehash(const char str[crypto_pwhash_scryptsalsa208sha256_STRBYTES],
                                                         unsigned long long opslimit,
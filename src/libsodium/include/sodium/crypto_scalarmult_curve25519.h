@@ -30,11 +30,27 @@ int crypto_scalarmult_curve25519(unsigned char *q, const unsigned char *n,
                                  const unsigned char *p)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+SODIUM_EXPORT
+int crypto_scalarmult_curve25519_batch(unsigned char * const *q,
+                                       const unsigned char * const *n,
+                                       const unsigned char * const *p,
+                                       size_t count)
+            __attribute__ ((warn_unused_result));
+
 SODIUM_EXPORT
 int crypto_scalarmult_curve25519_base(unsigned char *q,
                                       const unsigned char *n)
             __attribute__ ((nonnull));
 
+/*
+ * Computes count public keys at once: q and n hold count consecutive
+ * 32-byte values. Faster than separate calls.
+ */
+SODIUM_EXPORT
+void crypto_scalarmult_curve25519_base_batch(unsigned char *q,
+                                             const unsigned char *n,
+                                             size_t count);
+
 #ifdef __cplusplus
 }
 #endif
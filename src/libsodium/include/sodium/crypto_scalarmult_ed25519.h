@@ -36,6 +36,20 @@ int crypto_scalarmult_ed25519_noclamp(unsigned char *q, const unsigned char *n,
                                       const unsigned char *p)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/*
+ * Computes ns[0]*ps[0] + ... + ns[count-1]*ps[count-1], without clamping.
+ * WARNING: unlike the other functions of this API, this is NOT
+ * constant-time. The computation time depends on the scalars, so that it
+ * must only be used with public scalars, for example to verify proofs.
+ * Never pass secret scalars.
+ */
+SODIUM_EXPORT
+int crypto_scalarmult_ed25519_multi_noclamp(unsigned char *q,
+                                            const unsigned char *ns,
+                                            const unsigned char *ps,
+                                            size_t count)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int crypto_scalarmult_ed25519_base(unsigned char *q, const unsigned char *n)
             __attribute__ ((nonnull));
@@ -10,6 +10,10 @@
 extern "C" {
 #endif
 
+typedef struct CRYPTO_ALIGN(16) crypto_scalarmult_ristretto255_table {
+    unsigned char opaque[30720];
+} crypto_scalarmult_ristretto255_table;
+
 #define crypto_scalarmult_ristretto255_BYTES 32U
 SODIUM_EXPORT
 size_t crypto_scalarmult_ristretto255_bytes(void);
@@ -31,11 +35,72 @@ int crypto_scalarmult_ristretto255(unsigned char *q, const unsigned char *n,
                                    const unsigned char *p)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/*
+ * Computes ns[0]*ps[0] + ... + ns[count-1]*ps[count-1].
+ * WARNING: unlike the other functions of this API, this is NOT
+ * constant-time. The computation time depends on the scalars, so that it
+ * must only be used with public scalars, for example to verify proofs.
+ * Never pass secret scalars.
+ */
+SODIUM_EXPORT
+int crypto_scalarmult_ristretto255_multi(unsigned char *q,
+                                         const unsigned char *ns,
+                                         const unsigned char *ps,
+                                         size_t count)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int crypto_scalarmult_ristretto255_base(unsigned char *q,
                                         const unsigned char *n)
             __attribute__ ((nonnull));
 
+SODIUM_EXPORT
+size_t crypto_scalarmult_ristretto255_tablebytes(void);
+
+/*
+ * Precomputes multiples of p, so that crypto_scalarmult_ristretto255_table_mul()
+ * can compute n*p about as fast as crypto_scalarmult_ristretto255_base().
+ */
+SODIUM_EXPORT
+int crypto_scalarmult_ristretto255_table_create(crypto_scalarmult_ristretto255_table *table,
+                                                const unsigned char *p)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_scalarmult_ristretto255_table_mul(unsigned char *q,
+                                             const unsigned char *n,
+                                             const crypto_scalarmult_ristretto255_table *table)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Precomputes multiples of a fixed vector of points (for example, the
+ * generators of a range proof), so that linear combinations of them can be
+ * computed repeatedly without doublings. The table takes 2.5 to 4.5 KB
+ * per point, less for longer vectors.
+ * crypto_scalarmult_ristretto255_msm_fixed() computes
+ * ns[0]*ps[0] + ... + ns[count-1]*ps[count-1], for any count not larger
+ * than the number of precomputed points. This is variable-time, and only
+ * suitable for public scalars.
+ */
+typedef struct crypto_scalarmult_ristretto255_msm_table
+    crypto_scalarmult_ristretto255_msm_table;
+
+SODIUM_EXPORT
+crypto_scalarmult_ristretto255_msm_table *
+crypto_scalarmult_ristretto255_msm_precompute(const unsigned char *ps,
+                                              size_t count)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_scalarmult_ristretto255_msm_free(crypto_scalarmult_ristretto255_msm_table *table);
+
+SODIUM_EXPORT
+int crypto_scalarmult_ristretto255_msm_fixed(unsigned char *q,
+                                             const unsigned char *ns,
+                                             size_t count,
+                                             const crypto_scalarmult_ristretto255_msm_table *table)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
 #ifdef __cplusplus
 }
 #endif
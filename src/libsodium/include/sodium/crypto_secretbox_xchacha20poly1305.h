@@ -63,6 +63,43 @@ int crypto_secretbox_xchacha20poly1305_open_detached(unsigned char *m,
                                                      const unsigned char *k)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(2, 3, 5, 6)));
 
+/*
+ * Precomputed subkey for nonces that share their first
+ * crypto_secretbox_xchacha20poly1305_NONCEPREFIXBYTES bytes.
+ * The _afternm() functions only take the remaining
+ * crypto_secretbox_xchacha20poly1305_NONCESUFFIXBYTES bytes, and produce
+ * the same output as the functions taking the full nonce.
+ */
+
+#define crypto_secretbox_xchacha20poly1305_NONCEPREFIXBYTES 16U
+#define crypto_secretbox_xchacha20poly1305_NONCESUFFIXBYTES 8U
+
+typedef struct CRYPTO_ALIGN(16) crypto_secretbox_xchacha20poly1305_precomputed_ {
+    unsigned char opaque[32];
+} crypto_secretbox_xchacha20poly1305_precomputed;
+
+SODIUM_EXPORT
+int crypto_secretbox_xchacha20poly1305_beforenm(crypto_secretbox_xchacha20poly1305_precomputed *state,
+                                                const unsigned char *n_prefix,
+                                                const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_secretbox_xchacha20poly1305_easy_afternm(unsigned char *c,
+                                                    const unsigned char *m,
+                                                    unsigned long long mlen,
+                                                    const unsigned char *n_suffix,
+                                                    const crypto_secretbox_xchacha20poly1305_precomputed *state)
+            __attribute__ ((nonnull(1, 4, 5)));
+
+SODIUM_EXPORT
+int crypto_secretbox_xchacha20poly1305_open_easy_afternm(unsigned char *m,
+                                                         const unsigned char *c,
+                                                         unsigned long long clen,
+                                                         const unsigned char *n_suffix,
+                                                         const crypto_secretbox_xchacha20poly1305_precomputed *state)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(2, 4, 5)));
+
 #ifdef __cplusplus
 }
 #endif
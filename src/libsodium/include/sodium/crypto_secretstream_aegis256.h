@@ -0,0 +1,116 @@
+#ifndef crypto_secretstream_aegis256_H
+#define crypto_secretstream_aegis256_H
+
+#include <stddef.h>
+
+#include "crypto_aead_aegis256.h"
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * Same construction as crypto_secretstream_xchacha20poly1305, with every
+ * chunk encrypted using AEGIS-256. Requires AES instructions: check
+ * crypto_secretstream_aegis256_is_available() before using it.
+ * Unlike the XChaCha20-Poly1305 stream, a failed _pull() clears m.
+ */
+
+SODIUM_EXPORT
+int crypto_secretstream_aegis256_is_available(void);
+
+#define crypto_secretstream_aegis256_ABYTES \
+    (1U + crypto_aead_aegis256_ABYTES)
+SODIUM_EXPORT
+size_t crypto_secretstream_aegis256_abytes(void);
+
+#define crypto_secretstream_aegis256_HEADERBYTES \
+    crypto_aead_aegis256_NPUBBYTES
+SODIUM_EXPORT
+size_t crypto_secretstream_aegis256_headerbytes(void);
+
+#define crypto_secretstream_aegis256_KEYBYTES \
+    crypto_aead_aegis256_KEYBYTES
+SODIUM_EXPORT
+size_t crypto_secretstream_aegis256_keybytes(void);
+
+#define crypto_secretstream_aegis256_MESSAGEBYTES_MAX \
+    SODIUM_MIN(SODIUM_SIZE_MAX - crypto_secretstream_aegis256_ABYTES, \
+               crypto_aead_aegis256_MESSAGEBYTES_MAX - 1U)
+SODIUM_EXPORT
+size_t crypto_secretstream_aegis256_messagebytes_max(void);
+
+#define crypto_secretstream_aegis256_TAG_MESSAGE 0x00
+SODIUM_EXPORT
+unsigned char crypto_secretstream_aegis256_tag_message(void);
+
+#define crypto_secretstream_aegis256_TAG_PUSH    0x01
+SODIUM_EXPORT
+unsigned char crypto_secretstream_aegis256_tag_push(void);
+
+#define crypto_secretstream_aegis256_TAG_REKEY   0x02
+SODIUM_EXPORT
+unsigned char crypto_secretstream_aegis256_tag_rekey(void);
+
+#define crypto_secretstream_aegis256_TAG_FINAL \
+    (crypto_secretstream_aegis256_TAG_PUSH | \
+     crypto_secretstream_aegis256_TAG_REKEY)
+SODIUM_EXPORT
+unsigned char crypto_secretstream_aegis256_tag_final(void);
+
+typedef struct crypto_secretstream_aegis256_state {
+    unsigned char k[crypto_aead_aegis256_KEYBYTES];
+    unsigned char nonce[crypto_aead_aegis256_NPUBBYTES];
+} crypto_secretstream_aegis256_state;
+
+SODIUM_EXPORT
+size_t crypto_secretstream_aegis256_statebytes(void);
+
+SODIUM_EXPORT
+void crypto_secretstream_aegis256_keygen
+   (unsigned char k[crypto_secretstream_aegis256_KEYBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_secretstream_aegis256_init_push
+   (crypto_secretstream_aegis256_state *state,
+    unsigned char header[crypto_secretstream_aegis256_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_aegis256_KEYBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_secretstream_aegis256_push
+   (crypto_secretstream_aegis256_state *state,
+    unsigned char *c, unsigned long long *clen_p,
+    const unsigned char *m, unsigned long long mlen,
+    const unsigned char *ad, unsigned long long adlen, unsigned char tag)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_secretstream_aegis256_init_pull
+   (crypto_secretstream_aegis256_state *state,
+    const unsigned char header[crypto_secretstream_aegis256_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_aegis256_KEYBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_secretstream_aegis256_pull
+   (crypto_secretstream_aegis256_state *state,
+    unsigned char *m, unsigned long long *mlen_p, unsigned char *tag_p,
+    const unsigned char *c, unsigned long long clen,
+    const unsigned char *ad, unsigned long long adlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+void crypto_secretstream_aegis256_rekey
+    (crypto_secretstream_aegis256_state *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -2,6 +2,7 @@
 #define crypto_secretstream_xchacha20poly1305_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "crypto_aead_xchacha20poly1305.h"
 #include "crypto_stream_chacha20.h"
@@ -74,6 +75,12 @@ int crypto_secretstream_xchacha20poly1305_init_push
     const unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES])
             __attribute__ ((nonnull));
 
+/*
+ * Chunks of a regular stream cannot be computed in parallel: the nonce of
+ * a chunk depends on the authentication tag of the previous one. Use a
+ * seekable stream (see below) to encrypt or decrypt chunks concurrently.
+ */
+
 SODIUM_EXPORT
 int crypto_secretstream_xchacha20poly1305_push
    (crypto_secretstream_xchacha20poly1305_state *state,
@@ -82,6 +89,19 @@ int crypto_secretstream_xchacha20poly1305_push
     const unsigned char *ad, unsigned long long adlen, unsigned char tag)
             __attribute__ ((nonnull(1)));
 
+/*
+ * Pushes n chunks without additional data, m[i] of mlen[i] bytes with the
+ * tag tags[i], as n calls to _push() would. The chunks are stored one after
+ * the other in out, each taking mlen[i] + ABYTES bytes.
+ */
+SODIUM_EXPORT
+int crypto_secretstream_xchacha20poly1305_push_many
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *out, unsigned long long *outlen_p,
+    const unsigned char * const *m, const unsigned long long *mlen,
+    const unsigned char *tags, size_t n)
+            __attribute__ ((nonnull(1)));
+
 SODIUM_EXPORT
 int crypto_secretstream_xchacha20poly1305_init_pull
    (crypto_secretstream_xchacha20poly1305_state *state,
@@ -97,10 +117,85 @@ int crypto_secretstream_xchacha20poly1305_pull
     const unsigned char *ad, unsigned long long adlen)
             __attribute__ ((nonnull(1)));
 
+/*
+ * Detached variants: the ciphertext has the same length as the message, and
+ * the encrypted tag (1 byte) and the authenticator
+ * (crypto_secretstream_xchacha20poly1305_MACBYTES bytes) are stored
+ * separately. Concatenated, enc_tag || c || mac is a regular chunk.
+ * c can be equal to m, to encrypt and decrypt in place.
+ */
+
+#define crypto_secretstream_xchacha20poly1305_MACBYTES \
+    (crypto_secretstream_xchacha20poly1305_ABYTES - 1U)
+SODIUM_EXPORT
+size_t crypto_secretstream_xchacha20poly1305_macbytes(void);
+
+SODIUM_EXPORT
+int crypto_secretstream_xchacha20poly1305_push_detached
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *c, unsigned char *enc_tag, unsigned char *mac,
+    const unsigned char *m, unsigned long long mlen,
+    const unsigned char *ad, unsigned long long adlen, unsigned char tag)
+            __attribute__ ((nonnull(1, 3, 4)));
+
+SODIUM_EXPORT
+int crypto_secretstream_xchacha20poly1305_pull_detached
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *m, unsigned char *tag_p,
+    const unsigned char *c, unsigned long long clen,
+    const unsigned char *enc_tag, const unsigned char *mac,
+    const unsigned char *ad, unsigned long long adlen)
+            __attribute__ ((nonnull(1, 6, 7)));
+
 SODIUM_EXPORT
 void crypto_secretstream_xchacha20poly1305_rekey
     (crypto_secretstream_xchacha20poly1305_state *state);
 
+/*
+ * Seekable streams: each chunk is encrypted on its own, with a nonce derived
+ * from its index, so that chunks can be pushed and pulled in any order, and
+ * from multiple threads, since _push_at() and _pull_at() don't modify the
+ * state. The same header and key never produce the same chunks as a regular
+ * stream. Rekeying is not available: the REKEY bit of a tag is ignored.
+ * Truncation is detected by pushing the last chunk with TAG_FINAL, and by
+ * checking that the chunk at the expected last index has that tag.
+ */
+
+#define crypto_secretstream_xchacha20poly1305_INDEX_MAX 0xffffffffULL
+SODIUM_EXPORT
+uint64_t crypto_secretstream_xchacha20poly1305_index_max(void);
+
+SODIUM_EXPORT
+int crypto_secretstream_xchacha20poly1305_init_push_seekable
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char header[crypto_secretstream_xchacha20poly1305_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_secretstream_xchacha20poly1305_init_pull_seekable
+   (crypto_secretstream_xchacha20poly1305_state *state,
+    const unsigned char header[crypto_secretstream_xchacha20poly1305_HEADERBYTES],
+    const unsigned char k[crypto_secretstream_xchacha20poly1305_KEYBYTES])
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_secretstream_xchacha20poly1305_push_at
+   (const crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *c, unsigned long long *clen_p,
+    const unsigned char *m, unsigned long long mlen,
+    const unsigned char *ad, unsigned long long adlen,
+    uint64_t index, unsigned char tag)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_secretstream_xchacha20poly1305_pull_at
+   (const crypto_secretstream_xchacha20poly1305_state *state,
+    unsigned char *m, unsigned long long *mlen_p, unsigned char *tag_p,
+    const unsigned char *c, unsigned long long clen,
+    const unsigned char *ad, unsigned long long adlen, uint64_t index)
+            __attribute__ ((nonnull(1)));
+
 #ifdef __cplusplus
 }
 #endif
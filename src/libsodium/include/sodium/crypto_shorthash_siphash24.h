@@ -2,6 +2,7 @@
 #define crypto_shorthash_siphash24_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include "export.h"
 
 #ifdef __cplusplus
@@ -26,6 +27,40 @@ int crypto_shorthash_siphash24(unsigned char *out, const unsigned char *in,
                                unsigned long long inlen, const unsigned char *k)
             __attribute__ ((nonnull(1, 4)));
 
+/*
+ * Same hash, returned as a 64-bit integer (the little-endian load of the
+ * output), for the full range of input lengths or for fixed-size inputs.
+ * crypto_shorthash_siphash24_u64() hashes the little-endian encoding of x.
+ */
+
+SODIUM_EXPORT
+uint64_t crypto_shorthash_siphash24_value(const unsigned char *in,
+                                          unsigned long long inlen,
+                                          const unsigned char *k)
+            __attribute__ ((nonnull(3)));
+
+SODIUM_EXPORT
+uint64_t crypto_shorthash_siphash24_u64(uint64_t x, const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+uint64_t crypto_shorthash_siphash24_16(const unsigned char in[16],
+                                       const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+uint64_t crypto_shorthash_siphash24_32(const unsigned char in[32],
+                                       const unsigned char *k)
+            __attribute__ ((nonnull));
+
+/* Hashes count messages under the same key, into out[8 * i] for in[i] */
+SODIUM_EXPORT
+int crypto_shorthash_siphash24_multi(unsigned char *out,
+                                     const unsigned char * const *in,
+                                     const unsigned long long *inlen,
+                                     size_t count, const unsigned char *k)
+            __attribute__ ((nonnull(5)));
+
 #ifndef SODIUM_LIBRARY_MINIMAL
 /* -- 128-bit output -- */
 
@@ -41,6 +76,56 @@ SODIUM_EXPORT
 int crypto_shorthash_siphashx24(unsigned char *out, const unsigned char *in,
                                 unsigned long long inlen, const unsigned char *k)
             __attribute__ ((nonnull(1, 4)));
+
+/* -- SipHash-1-3, 64-bit output -- */
+
+#define crypto_shorthash_siphash13_BYTES 8U
+SODIUM_EXPORT
+size_t crypto_shorthash_siphash13_bytes(void);
+
+#define crypto_shorthash_siphash13_KEYBYTES 16U
+SODIUM_EXPORT
+size_t crypto_shorthash_siphash13_keybytes(void);
+
+SODIUM_EXPORT
+int crypto_shorthash_siphash13(unsigned char *out, const unsigned char *in,
+                               unsigned long long inlen, const unsigned char *k)
+            __attribute__ ((nonnull(1, 4)));
+
+SODIUM_EXPORT
+uint64_t crypto_shorthash_siphash13_value(const unsigned char *in,
+                                          unsigned long long inlen,
+                                          const unsigned char *k)
+            __attribute__ ((nonnull(3)));
+
+SODIUM_EXPORT
+int crypto_shorthash_siphash13_multi(unsigned char *out,
+                                     const unsigned char * const *in,
+                                     const unsigned long long *inlen,
+                                     size_t count, const unsigned char *k)
+            __attribute__ ((nonnull(5)));
+
+/* -- HalfSipHash-2-4, 32-bit output, for 32-bit platforms -- */
+
+#define crypto_shorthash_halfsiphash24_BYTES 4U
+SODIUM_EXPORT
+size_t crypto_shorthash_halfsiphash24_bytes(void);
+
+#define crypto_shorthash_halfsiphash24_KEYBYTES 8U
+SODIUM_EXPORT
+size_t crypto_shorthash_halfsiphash24_keybytes(void);
+
+SODIUM_EXPORT
+int crypto_shorthash_halfsiphash24(unsigned char *out, const unsigned char *in,
+                                   unsigned long long inlen,
+                                   const unsigned char *k)
+            __attribute__ ((nonnull(1, 4)));
+
+SODIUM_EXPORT
+uint32_t crypto_shorthash_halfsiphash24_value(const unsigned char *in,
+                                              unsigned long long inlen,
+                                              const unsigned char *k)
+            __attribute__ ((nonnull(3)));
 #endif
 
 #ifdef __cplusplus
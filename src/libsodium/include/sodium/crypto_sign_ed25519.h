@@ -19,6 +19,37 @@ typedef struct crypto_sign_ed25519ph_state {
 SODIUM_EXPORT
 size_t crypto_sign_ed25519ph_statebytes(void);
 
+typedef struct crypto_sign_ed25519_verify_state {
+    crypto_hash_sha512_state hs;
+    unsigned char            sig[64];
+    unsigned char            pk[32];
+} crypto_sign_ed25519_verify_state;
+
+SODIUM_EXPORT
+size_t crypto_sign_ed25519_verify_statebytes(void);
+
+typedef struct crypto_sign_ed25519_sign_state {
+    crypto_hash_sha512_state hs;
+    unsigned char            opaque[96];
+} crypto_sign_ed25519_sign_state;
+
+SODIUM_EXPORT
+size_t crypto_sign_ed25519_sign_statebytes(void);
+
+typedef struct CRYPTO_ALIGN(16) crypto_sign_ed25519_pk_state {
+    unsigned char opaque[5152];
+} crypto_sign_ed25519_pk_state;
+
+SODIUM_EXPORT
+size_t crypto_sign_ed25519_pk_statebytes(void);
+
+typedef struct CRYPTO_ALIGN(16) crypto_sign_ed25519_sk_state {
+    unsigned char opaque[96];
+} crypto_sign_ed25519_sk_state;
+
+SODIUM_EXPORT
+size_t crypto_sign_ed25519_sk_statebytes(void);
+
 #define crypto_sign_ed25519_BYTES 64U
 SODIUM_EXPORT
 size_t crypto_sign_ed25519_bytes(void);
@@ -66,6 +97,173 @@ int crypto_sign_ed25519_verify_detached(const unsigned char *sig,
                                         const unsigned char *pk)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 4)));
 
+/*
+ * Incremental verification of a regular (not prehashed) Ed25519 signature.
+ * The signature and the public key are absorbed first, so that the message
+ * can then be streamed. Only the return value of
+ * crypto_sign_ed25519_verify_final() tells whether the signature is valid;
+ * crypto_sign_ed25519_verify_init() returning -1 only allows rejecting
+ * malformed inputs early.
+ */
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_init(crypto_sign_ed25519_verify_state *state,
+                                    const unsigned char *sig,
+                                    const unsigned char *pk)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_update(crypto_sign_ed25519_verify_state *state,
+                                      const unsigned char *m,
+                                      unsigned long long mlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_final(crypto_sign_ed25519_verify_state *state)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Single-pass signing of a regular (not prehashed) Ed25519 signature.
+ * The nonce is hedged: it is derived from fresh randomness and from the
+ * secret key, but not from the message, so that the commitment R can be
+ * computed before the message is streamed. Signatures are not
+ * deterministic, and are verified by crypto_sign_ed25519_verify_detached().
+ * This requires a working randombytes() implementation: a repeated nonce
+ * for two different messages reveals the secret key.
+ * The state holds secret material; crypto_sign_ed25519_sign_final() erases
+ * it.
+ */
+SODIUM_EXPORT
+int crypto_sign_ed25519_sign_init(crypto_sign_ed25519_sign_state *state,
+                                  const unsigned char *sk)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_sign_update(crypto_sign_ed25519_sign_state *state,
+                                    const unsigned char *m,
+                                    unsigned long long mlen)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_sign_final(crypto_sign_ed25519_sign_state *state,
+                                   unsigned char *sig,
+                                   unsigned long long *siglen_p)
+            __attribute__ ((nonnull(1, 2)));
+
+/*
+ * Verifies count signatures. If results is not NULL, results[i] receives
+ * what crypto_sign_ed25519_verify_detached() returns for the i-th one.
+ * Returns 0 if all of them are valid, -1 otherwise.
+ */
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_batch(const unsigned char * const *sigs,
+                                     const unsigned char * const *ms,
+                                     const unsigned long long *mlens,
+                                     const unsigned char * const *pks,
+                                     size_t count, int *results)
+            __attribute__ ((warn_unused_result));
+
+/*
+ * Half-aggregation of count signatures of different messages, possibly by
+ * different signers. The aggregate keeps the R part of every signature and
+ * combines the S parts into one scalar, so that it is
+ * crypto_sign_ed25519_AGGREGATEBYTES(count) bytes long instead of
+ * 64 * count. It can only be verified as a whole, with
+ * crypto_sign_ed25519_verify_aggregate() and the same messages and public
+ * keys, in the same order.
+ * R parts and public keys that are not canonical or that have a component
+ * of order 4 or 8 are rejected. Verification is cofactored, though, so
+ * that a signature whose R part only differs from a valid one by the point
+ * of order 2 still verifies once aggregated, while
+ * crypto_sign_ed25519_verify_detached() rejects it. An aggregate proves
+ * that each message was signed by its key, not that every signature would
+ * pass crypto_sign_ed25519_verify_detached().
+ */
+#define crypto_sign_ed25519_AGGREGATEBYTES(count) (32U * (count) + 32U)
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_aggregate(unsigned char *agg,
+                                  unsigned long long *agglen_p,
+                                  const unsigned char * const *sigs,
+                                  const unsigned char * const *ms,
+                                  const unsigned long long *mlens,
+                                  const unsigned char * const *pks,
+                                  size_t count)
+            __attribute__ ((nonnull(1, 3, 5, 6)));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_aggregate(const unsigned char *agg,
+                                         const unsigned char * const *ms,
+                                         const unsigned long long *mlens,
+                                         const unsigned char * const *pks,
+                                         size_t count)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 3, 4)));
+
+/*
+ * Signs count messages with the same secret key: sigs[i] receives the
+ * signature of ms[i], as crypto_sign_ed25519_detached() would compute it.
+ */
+SODIUM_EXPORT
+int crypto_sign_ed25519_detached_batch(unsigned char * const *sigs,
+                                       const unsigned char * const *ms,
+                                       const unsigned long long *mlens,
+                                       size_t count, const unsigned char *sk)
+            __attribute__ ((nonnull(5)));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_pk_precompute(crypto_sign_ed25519_pk_state *state,
+                                      const unsigned char *pk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_detached_precomputed(const unsigned char *sig,
+                                                    const unsigned char *m,
+                                                    unsigned long long mlen,
+                                                    const crypto_sign_ed25519_pk_state *state)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(1, 4)));
+
+/*
+ * A bounded cache of successful verifications, that can be shared by
+ * threads. Verifying a (signature, message, public key) triple that is
+ * already in the cache only costs a SipHash and a comparison. Messages
+ * longer than mlen_max bytes skip the cache. A NULL cache is allowed, and
+ * makes crypto_sign_ed25519_verify_detached_cached() equivalent to
+ * crypto_sign_ed25519_verify_detached().
+ */
+typedef struct crypto_sign_ed25519_verifycache crypto_sign_ed25519_verifycache;
+
+SODIUM_EXPORT
+crypto_sign_ed25519_verifycache *
+crypto_sign_ed25519_verifycache_create(size_t capacity, size_t mlen_max)
+            __attribute__ ((warn_unused_result));
+
+SODIUM_EXPORT
+void crypto_sign_ed25519_verifycache_destroy(crypto_sign_ed25519_verifycache *cache);
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_verify_detached_cached(crypto_sign_ed25519_verifycache *cache,
+                                               const unsigned char *sig,
+                                               const unsigned char *m,
+                                               unsigned long long mlen,
+                                               const unsigned char *pk)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull(2, 5)));
+
+/*
+ * The expanded state holds the signing key: it should be allocated with
+ * sodium_malloc() and erased with sodium_memzero() after use.
+ */
+SODIUM_EXPORT
+int crypto_sign_ed25519_sk_expand(crypto_sign_ed25519_sk_state *state,
+                                  const unsigned char *sk)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_sign_ed25519_detached_expanded(unsigned char *sig,
+                                          unsigned long long *siglen_p,
+                                          const unsigned char *m,
+                                          unsigned long long mlen,
+                                          const crypto_sign_ed25519_sk_state *state)
+            __attribute__ ((nonnull(1, 5)));
+
 SODIUM_EXPORT
 int crypto_sign_ed25519_keypair(unsigned char *pk, unsigned char *sk)
             __attribute__ ((nonnull));
@@ -75,11 +273,32 @@ int crypto_sign_ed25519_seed_keypair(unsigned char *pk, unsigned char *sk,
                                      const unsigned char *seed)
             __attribute__ ((nonnull));
 
+/*
+ * Same as crypto_sign_ed25519_seed_keypair() for count concatenated seeds.
+ */
+SODIUM_EXPORT
+int crypto_sign_ed25519_seed_keypair_batch(unsigned char *pks,
+                                           unsigned char *sks,
+                                           const unsigned char *seeds,
+                                           size_t count)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int crypto_sign_ed25519_pk_to_curve25519(unsigned char *curve25519_pk,
                                          const unsigned char *ed25519_pk)
             __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
 
+/*
+ * Converts count concatenated public keys. Returns -1 if any of them is
+ * invalid; the corresponding outputs are then set to zero, and the other
+ * ones are still converted.
+ */
+SODIUM_EXPORT
+int crypto_sign_ed25519_pk_to_curve25519_batch(unsigned char *curve25519_pks,
+                                               const unsigned char *ed25519_pks,
+                                               size_t count)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int crypto_sign_ed25519_sk_to_curve25519(unsigned char *curve25519_sk,
                                          const unsigned char *ed25519_sk)
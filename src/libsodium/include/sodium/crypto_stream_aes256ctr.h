@@ -0,0 +1,106 @@
+#ifndef crypto_stream_aes256ctr_H
+#define crypto_stream_aes256ctr_H
+
+/*
+ *  WARNING: This is just a stream cipher. It is NOT authenticated encryption.
+ *  While it provides some protection against eavesdropping, it does NOT
+ *  provide any security against active attacks.
+ *  Unless you know what you're doing, what you are looking for is probably
+ *  the crypto_box functions.
+ */
+
+/*
+ *  AES-256 in counter mode, as in NIST SP 800-38A: the nonce is the initial
+ *  counter block, incremented as a 128-bit big-endian integer. The output is
+ *  compatible with other AES-256-CTR implementations.
+ *
+ *  Hardware AES support is required: check
+ *  crypto_stream_aes256ctr_is_available() before using these functions.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+SODIUM_EXPORT
+int crypto_stream_aes256ctr_is_available(void);
+
+#define crypto_stream_aes256ctr_KEYBYTES 32U
+SODIUM_EXPORT
+size_t crypto_stream_aes256ctr_keybytes(void);
+
+#define crypto_stream_aes256ctr_NONCEBYTES 16U
+SODIUM_EXPORT
+size_t crypto_stream_aes256ctr_noncebytes(void);
+
+#define crypto_stream_aes256ctr_BLOCKBYTES 16U
+SODIUM_EXPORT
+size_t crypto_stream_aes256ctr_blockbytes(void);
+
+#define crypto_stream_aes256ctr_MESSAGEBYTES_MAX SODIUM_SIZE_MAX
+SODIUM_EXPORT
+size_t crypto_stream_aes256ctr_messagebytes_max(void);
+
+typedef struct CRYPTO_ALIGN(16) crypto_stream_aes256ctr_state_ {
+    unsigned char opaque[240];
+} crypto_stream_aes256ctr_state;
+
+SODIUM_EXPORT
+size_t crypto_stream_aes256ctr_statebytes(void);
+
+SODIUM_EXPORT
+int crypto_stream_aes256ctr(unsigned char *c, unsigned long long clen,
+                            const unsigned char *n, const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_stream_aes256ctr_xor(unsigned char *c, const unsigned char *m,
+                                unsigned long long mlen, const unsigned char *n,
+                                const unsigned char *k)
+            __attribute__ ((nonnull));
+
+/* ic is a block counter, added to the initial counter block */
+SODIUM_EXPORT
+int crypto_stream_aes256ctr_xor_ic(unsigned char *c, const unsigned char *m,
+                                   unsigned long long mlen,
+                                   const unsigned char *n, uint64_t ic,
+                                   const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void crypto_stream_aes256ctr_keygen(unsigned char k[crypto_stream_aes256ctr_KEYBYTES])
+            __attribute__ ((nonnull));
+
+/* -- Precomputation interface -- */
+
+SODIUM_EXPORT
+int crypto_stream_aes256ctr_beforenm(crypto_stream_aes256ctr_state *st,
+                                     const unsigned char *k)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int crypto_stream_aes256ctr_xor_ic_afternm(unsigned char *c, const unsigned char *m,
+                                           unsigned long long mlen,
+                                           const unsigned char *n, uint64_t ic,
+                                           const crypto_stream_aes256ctr_state *st)
+            __attribute__ ((nonnull));
+
+/* raw AES-256 encryption of a single block */
+SODIUM_EXPORT
+int crypto_stream_aes256ctr_block_afternm(unsigned char out[crypto_stream_aes256ctr_BLOCKBYTES],
+                                          const unsigned char in[crypto_stream_aes256ctr_BLOCKBYTES],
+                                          const crypto_stream_aes256ctr_state *st)
+            __attribute__ ((nonnull));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
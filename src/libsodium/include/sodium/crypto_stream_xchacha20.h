@@ -50,6 +50,17 @@ int crypto_stream_xchacha20_xor_ic(unsigned char *c, const unsigned char *m,
                                    const unsigned char *k)
             __attribute__ ((nonnull));
 
+/* Same output as crypto_stream_xchacha20_xor_ic(), using threads */
+SODIUM_EXPORT
+int crypto_stream_xchacha20_xor_ic_parallel(unsigned char *c,
+                                            const unsigned char *m,
+                                            unsigned long long mlen,
+                                            const unsigned char *n,
+                                            uint64_t ic,
+                                            const unsigned char *k,
+                                            unsigned int threads)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void crypto_stream_xchacha20_keygen(unsigned char k[crypto_stream_xchacha20_KEYBYTES])
             __attribute__ ((nonnull));
@@ -0,0 +1,23 @@
+#ifndef crypto_verify_H
+#define crypto_verify_H
+
+#include <stddef.h>
+#include "export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Compares len bytes in constant time, that only depends on len.
+ * Returns 0 if x and y are equal, -1 otherwise.
+ */
+SODIUM_EXPORT
+int crypto_verify_n(const unsigned char *x, const unsigned char *y, size_t len)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef sodium_jobs_H
+#define sodium_jobs_H
+
+#include <stddef.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+# ifdef __GNUC__
+#  pragma GCC diagnostic ignored "-Wlong-long"
+# endif
+extern "C" {
+#endif
+
+/*
+ * Queues of jobs run away from the thread submitting them.
+ *
+ * Queued jobs of the same kind are run together, using the batch version
+ * of the operation when there is one, so that the more jobs are waiting,
+ * the cheaper each of them gets. A batch holds at most max_batch jobs.
+ *
+ * A queue created with workers > 0 runs its jobs on that many threads of
+ * its own. With workers == 0, they are only run by sodium_job_queue_run(),
+ * which can be called from any threads, for example those of an existing
+ * pool. sodium_job_queue_create() returns NULL with errno set to ENOSYS if
+ * workers are requested but threads are not available.
+ *
+ * Every job and the buffers it points to belong to the application until
+ * its completion function is called. That function is called from the
+ * thread that ran the job, once job->result has been set to the value the
+ * operation returned, and can submit new jobs.
+ *
+ * sodium_job_queue_destroy() waits for all the jobs still queued to be
+ * run, running them itself if the queue has no workers.
+ *
+ * AES256-GCM and ChaCha20-Poly1305-IETF jobs are run one at a time; large
+ * messages go to the offload provider, if one was registered with
+ * sodium_set_offload_provider(), so that the submitting thread doesn't
+ * wait for the engine.
+ */
+
+#define SODIUM_JOB_SIGN_ED25519_VERIFY                  1
+#define SODIUM_JOB_SCALARMULT_CURVE25519                2
+#define SODIUM_JOB_PWHASH_STR_VERIFY                    3
+#define SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT  4
+#define SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_DECRYPT  5
+#define SODIUM_JOB_AEAD_AES256GCM_ENCRYPT               6
+#define SODIUM_JOB_AEAD_AES256GCM_DECRYPT               7
+#define SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_ENCRYPT   8
+#define SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_DECRYPT   9
+
+#define SODIUM_JOB_BATCH_MAX 64U
+
+typedef struct sodium_job sodium_job;
+
+typedef void (*sodium_job_completion_fn)(sodium_job *job);
+
+struct sodium_job {
+    int                      op;
+    int                      result;
+    sodium_job_completion_fn completion;
+    void                    *opaque;
+    union {
+        /* crypto_sign_ed25519_verify_detached(sig, m, mlen, pk) */
+        struct {
+            const unsigned char *sig;
+            const unsigned char *m;
+            unsigned long long   mlen;
+            const unsigned char *pk;
+        } sign_verify;
+        /* crypto_scalarmult_curve25519(q, n, p) */
+        struct {
+            unsigned char       *q;
+            const unsigned char *n;
+            const unsigned char *p;
+        } scalarmult;
+        /* crypto_pwhash_str_verify(str, passwd, passwdlen) */
+        struct {
+            const char         *str;
+            const char         *passwd;
+            unsigned long long  passwdlen;
+        } pwhash_str_verify;
+        /*
+         * Combined mode: out receives inlen + ABYTES bytes when encrypting,
+         * inlen - ABYTES bytes when decrypting.
+         */
+        struct {
+            unsigned char       *out;
+            const unsigned char *in;
+            unsigned long long   inlen;
+            const unsigned char *ad;
+            unsigned long long   adlen;
+            const unsigned char *npub;
+            const unsigned char *k;
+        } aead;
+    } args;
+    sodium_job              *next_; /* reserved for the queue */
+};
+
+typedef struct sodium_job_queue sodium_job_queue;
+
+SODIUM_EXPORT
+sodium_job_queue *sodium_job_queue_create(unsigned int workers,
+                                          size_t max_batch);
+
+SODIUM_EXPORT
+void sodium_job_queue_destroy(sodium_job_queue *queue);
+
+/* Returns -1 with errno set to EINVAL if the operation is not known */
+SODIUM_EXPORT
+int sodium_job_submit(sodium_job_queue *queue, sodium_job *job)
+            __attribute__ ((warn_unused_result)) __attribute__ ((nonnull));
+
+/*
+ * Runs queued jobs on the calling thread until the queue is empty, and
+ * returns how many were run.
+ */
+SODIUM_EXPORT
+size_t sodium_job_queue_run(sodium_job_queue *queue)
+            __attribute__ ((nonnull));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef aead_iov_H
+#define aead_iov_H
+
+#include <limits.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "crypto_aead_iovec.h"
+
+/*
+ * Sequential access to a list of buffer fragments.
+ * Empty fragments are skipped, so that a cursor either points to at least
+ * one byte, or is at the end of the list.
+ */
+
+typedef struct aead_iov_cursor {
+    const crypto_aead_iovec *iov;
+    size_t                   count;
+    size_t                   i;
+    size_t                   off;
+} aead_iov_cursor;
+
+static inline int
+aead_iov_total(unsigned long long *total_p, const crypto_aead_iovec *iov,
+               size_t count)
+{
+    unsigned long long total = 0ULL;
+    size_t             i;
+
+    for (i = 0U; i < count; i++) {
+        if ((unsigned long long) iov[i].len > ULLONG_MAX - total) {
+            return -1;
+        }
+        total += (unsigned long long) iov[i].len;
+    }
+    *total_p = total;
+
+    return 0;
+}
+
+static inline void
+aead_iov_memzero(const crypto_aead_iovec *iov, size_t count)
+{
+    size_t i;
+
+    for (i = 0U; i < count; i++) {
+        memset(iov[i].ptr, 0, iov[i].len);
+    }
+}
+
+static inline void
+aead_iov_cursor_skip_empty(aead_iov_cursor *cur)
+{
+    while (cur->i < cur->count && cur->off >= cur->iov[cur->i].len) {
+        cur->i++;
+        cur->off = 0U;
+    }
+}
+
+static inline void
+aead_iov_cursor_init(aead_iov_cursor *cur, const crypto_aead_iovec *iov,
+                     size_t count)
+{
+    cur->iov   = iov;
+    cur->count = count;
+    cur->i     = 0U;
+    cur->off   = 0U;
+    aead_iov_cursor_skip_empty(cur);
+}
+
+static inline size_t
+aead_iov_cursor_avail(const aead_iov_cursor *cur)
+{
+    if (cur->i >= cur->count) {
+        return 0U;
+    }
+    return cur->iov[cur->i].len - cur->off;
+}
+
+static inline unsigned char *
+aead_iov_cursor_ptr(const aead_iov_cursor *cur)
+{
+    return (unsigned char *) cur->iov[cur->i].ptr + cur->off;
+}
+
+/* n must not exceed aead_iov_cursor_avail() */
+static inline void
+aead_iov_cursor_advance(aead_iov_cursor *cur, size_t n)
+{
+    cur->off += n;
+    aead_iov_cursor_skip_empty(cur);
+}
+
+/*
+ * Number of bytes, as a multiple of blocksize (a power of 2), that are
+ * contiguous both at the input and at the output cursor.
+ */
+static inline size_t
+aead_iov_cursor_run(const aead_iov_cursor *out, const aead_iov_cursor *in,
+                    size_t blocksize)
+{
+    size_t run = aead_iov_cursor_avail(in);
+
+    if (out != NULL && aead_iov_cursor_avail(out) < run) {
+        run = aead_iov_cursor_avail(out);
+    }
+    return run & ~(blocksize - 1U);
+}
+
+static inline void
+aead_iov_cursor_gather(aead_iov_cursor *cur, unsigned char *buf, size_t n)
+{
+    size_t len;
+
+    while (n > 0U) {
+        len = aead_iov_cursor_avail(cur);
+        if (len > n) {
+            len = n;
+        }
+        memcpy(buf, aead_iov_cursor_ptr(cur), len);
+        aead_iov_cursor_advance(cur, len);
+        buf += len;
+        n -= len;
+    }
+}
+
+static inline void
+aead_iov_cursor_scatter(aead_iov_cursor *cur, const unsigned char *buf, size_t n)
+{
+    size_t len;
+
+    while (n > 0U) {
+        len = aead_iov_cursor_avail(cur);
+        if (len > n) {
+            len = n;
+        }
+        memcpy(aead_iov_cursor_ptr(cur), buf, len);
+        aead_iov_cursor_advance(cur, len);
+        buf += len;
+        n -= len;
+    }
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef aliases_H
+#define aliases_H 1
+
+/*
+ * Hidden aliases for exported functions that are also called from within
+ * the library.
+ *
+ * In a shared library, a call to an exported function goes through the PLT,
+ * because the symbol can be interposed at load time. The defining file adds
+ * SODIUM_ALIAS_DEF(name) after the definition, which creates a hidden
+ * _sodium_hidden_<name> alias. The calling file adds SODIUM_ALIAS_PROTO(name)
+ * after the public headers, which makes calls to name() go to the alias
+ * instead. Call sites do not change, and the exported symbols are the same.
+ *
+ * Without ELF alias support, both macros expand to nothing useful and calls
+ * go through the public symbol as before.
+ */
+#ifdef HAVE_HIDDEN_ALIASES
+
+# define SODIUM_ALIAS_DEF(NAME) \
+    extern __typeof__(NAME) _sodium_hidden_##NAME \
+        __attribute__((alias(#NAME), visibility("hidden")))
+
+# define SODIUM_ALIAS_PROTO(NAME) \
+    extern __typeof__(NAME) NAME __asm__("_sodium_hidden_" #NAME)
+
+#else
+
+# define SODIUM_ALIAS_DEF(NAME)   struct sodium_alias_unused_def_##NAME
+# define SODIUM_ALIAS_PROTO(NAME) struct sodium_alias_unused_proto_##NAME
+
+#endif
+
+#endif
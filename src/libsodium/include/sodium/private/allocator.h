@@ -0,0 +1,20 @@
+#ifndef allocator_H
+#define allocator_H
+
+#include <stddef.h>
+
+#include "core.h"
+
+/*
+ * Memory handed out by the allocators set with sodium_set_allocator().
+ * _sodium_allocator_alloc() and _sodium_allocator_free() can only be
+ * called if _sodium_allocator_is_set() returned 1 for that kind.
+ */
+
+int _sodium_allocator_is_set(int kind);
+
+void *_sodium_allocator_alloc(int kind, size_t size);
+
+void _sodium_allocator_free(int kind, void *ptr, size_t size);
+
+#endif
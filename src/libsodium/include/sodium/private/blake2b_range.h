@@ -0,0 +1,21 @@
+#ifndef blake2b_range_H
+#define blake2b_range_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Computes count keyed BLAKE2b hashes of the empty message into out, one
+ * after the other. The salt of the i-th hash is LE64(first_salt + i)
+ * followed by zeros. Up to 8 hashes are computed in parallel when the CPU
+ * supports it.
+ */
+
+int _crypto_generichash_blake2b_salt_personal_range(unsigned char *out,
+                                                   size_t outlen, size_t count,
+                                                   const unsigned char *key,
+                                                   size_t keylen,
+                                                   uint64_t first_salt,
+                                                   const unsigned char *personal);
+
+#endif
@@ -14,5 +14,15 @@ int crypto_stream_chacha20_ietf_ext_xor_ic(unsigned char *c, const unsigned char
                                            unsigned long long mlen,
                                            const unsigned char *n, uint32_t ic,
                                            const unsigned char *k);
+
+/*
+ * Compute one block for each of 8 independent ChaCha20 states, stored
+ * word-sliced: x[word][lane]. Returns -1 if the current implementation
+ * doesn't process multiple states in parallel.
+ */
+
+int crypto_stream_chacha20_blocks8(unsigned char *ks, const uint32_t x[16][8]);
+
+int crypto_stream_chacha20_has_blocks8(void);
 #endif
 
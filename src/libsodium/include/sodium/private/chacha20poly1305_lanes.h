@@ -0,0 +1,22 @@
+#ifndef chacha20poly1305_lanes_H
+#define chacha20poly1305_lanes_H
+
+#include <stddef.h>
+
+/*
+ * ChaCha20-Poly1305 (IETF) encryption of count messages, one per SIMD lane.
+ * Message i is encrypted with the key at k + i * k_stride, so that a stride
+ * of 0 uses the same key for all of them. The MAC is appended to c[i].
+ * Requires crypto_stream_chacha20_has_blocks8().
+ */
+
+void crypto_aead_chacha20poly1305_ietf_encrypt_lanes(unsigned char * const *c,
+                                                     const unsigned char * const *m,
+                                                     const unsigned long long *mlen,
+                                                     const unsigned char * const *ad,
+                                                     const unsigned long long *adlen,
+                                                     const unsigned char * const *npub,
+                                                     size_t count, const unsigned char *k,
+                                                     size_t k_stride);
+
+#endif
@@ -4,6 +4,12 @@
 #include "private/quirks.h"
 #include "utils.h"
 
+#ifdef HAVE_ARMV7_ASM
+void _sodium_fe25519_mul_armv7(fe25519 h, const fe25519 f, const fe25519 g);
+void _sodium_fe25519_sq_armv7(fe25519 h, const fe25519 f);
+void _sodium_fe25519_sq2_armv7(fe25519 h, const fe25519 f);
+#endif
+
 /*
  h = 0
  */
@@ -358,6 +364,13 @@ fe25519_iszero(const fe25519 f)
  With tighter constraints on inputs can squeeze carries into int32.
  */
 
+#ifdef HAVE_ARMV7_ASM
+static inline void
+fe25519_mul(fe25519 h, const fe25519 f, const fe25519 g)
+{
+    _sodium_fe25519_mul_armv7(h, f, g);
+}
+#else
 static void
 fe25519_mul(fe25519 h, const fe25519 f, const fe25519 g)
 {
@@ -616,6 +629,7 @@ fe25519_mul(fe25519 h, const fe25519 f, const fe25519 g)
     h[8] = (int32_t) h8;
     h[9] = (int32_t) h9;
 }
+#endif
 
 /*
  h = f * f
@@ -628,6 +642,13 @@ fe25519_mul(fe25519 h, const fe25519 f, const fe25519 g)
  |h| bounded by 1.01*2^25,1.01*2^24,1.01*2^25,1.01*2^24,etc.
  */
 
+#ifdef HAVE_ARMV7_ASM
+static inline void
+fe25519_sq(fe25519 h, const fe25519 f)
+{
+    _sodium_fe25519_sq_armv7(h, f);
+}
+#else
 static void
 fe25519_sq(fe25519 h, const fe25519 f)
 {
@@ -788,6 +809,7 @@ fe25519_sq(fe25519 h, const fe25519 f)
     h[8] = (int32_t) h8;
     h[9] = (int32_t) h9;
 }
+#endif
 
 /*
  h = 2 * f * f
@@ -800,6 +822,13 @@ fe25519_sq(fe25519 h, const fe25519 f)
  |h| bounded by 1.01*2^25,1.01*2^24,1.01*2^25,1.01*2^24,etc.
  */
 
+#ifdef HAVE_ARMV7_ASM
+static inline void
+fe25519_sq2(fe25519 h, const fe25519 f)
+{
+    _sodium_fe25519_sq2_armv7(h, f);
+}
+#else
 static void
 fe25519_sq2(fe25519 h, const fe25519 f)
 {
@@ -971,6 +1000,7 @@ fe25519_sq2(fe25519 h, const fe25519 f)
     h[8] = (int32_t) h8;
     h[9] = (int32_t) h9;
 }
+#endif
 
 static inline void
 fe25519_mul32(fe25519 h, const fe25519 f, uint32_t n)
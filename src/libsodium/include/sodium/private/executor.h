@@ -0,0 +1,30 @@
+#ifndef executor_H
+#define executor_H
+
+#include "core.h"
+#include "private/quirks.h"
+
+/*
+ * Tasks of the parallel code paths. _sodium_executor_threads() caps the
+ * number of threads a caller wants to use, the calling thread included.
+ * _sodium_executor_start() hands fn(arg) to the executor; if it cannot,
+ * _sodium_executor_finish() runs it on the calling thread instead.
+ * Otherwise, _sodium_executor_finish() waits for it to complete.
+ */
+
+typedef struct sodium_executor_task {
+    sodium_executor_fn      fn;
+    void                   *arg;
+    void                   *handle;
+    sodium_executor_wait_fn wait;
+    void                   *ctx;
+} sodium_executor_task;
+
+unsigned int _sodium_executor_threads(unsigned int threads);
+
+void _sodium_executor_start(sodium_executor_task *task, sodium_executor_fn fn,
+                            void *arg);
+
+void _sodium_executor_finish(sodium_executor_task *task);
+
+#endif
@@ -0,0 +1,386 @@
+#ifndef fe25519x4_avx512ifma_H
+#define fe25519x4_avx512ifma_H
+
+/*
+ Requires AVX2, AVX512VL and AVX512IFMA to be enabled
+ in the including translation unit.
+ */
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include "private/common.h"
+#include "private/ed25519_ref10_decls.h"
+
+/*
+ Four field elements, processed in parallel.
+
+ Each element is stored in radix 2^51, and v[i] holds the i-th limb
+ of all four elements, one per 64-bit lane. vpmadd52luq/vpmadd52huq only
+ read the low 52 bits of their operands, so limbs must be smaller than
+ 2^52 before a multiplication; one round of lane-parallel carries is
+ enough to guarantee that after an addition or a subtraction.
+ */
+
+typedef struct fe25519x4_ {
+    __m256i v[5];
+} fe25519x4;
+
+#define LANE_A 0x03
+#define LANE_B 0x0c
+#define LANE_C 0x30
+#define LANE_D 0xc0
+
+#define SHUFFLE(A, B, C, D) ((D) << 6 | (C) << 4 | (B) << 2 | (A))
+
+#define fe25519x4_shuffle(H, F, IMM)                             \
+    do {                                                          \
+        (H)->v[0] = _mm256_permute4x64_epi64((F)->v[0], (IMM));   \
+        (H)->v[1] = _mm256_permute4x64_epi64((F)->v[1], (IMM));   \
+        (H)->v[2] = _mm256_permute4x64_epi64((F)->v[2], (IMM));   \
+        (H)->v[3] = _mm256_permute4x64_epi64((F)->v[3], (IMM));   \
+        (H)->v[4] = _mm256_permute4x64_epi64((F)->v[4], (IMM));   \
+    } while (0)
+
+#define fe25519x4_blend(H, F, G, MASK)                           \
+    do {                                                          \
+        (H)->v[0] = _mm256_blend_epi32((F)->v[0], (G)->v[0], (MASK)); \
+        (H)->v[1] = _mm256_blend_epi32((F)->v[1], (G)->v[1], (MASK)); \
+        (H)->v[2] = _mm256_blend_epi32((F)->v[2], (G)->v[2], (MASK)); \
+        (H)->v[3] = _mm256_blend_epi32((F)->v[3], (G)->v[3], (MASK)); \
+        (H)->v[4] = _mm256_blend_epi32((F)->v[4], (G)->v[4], (MASK)); \
+    } while (0)
+
+static inline void
+fe25519x4_0(fe25519x4 *h)
+{
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        h->v[i] = _mm256_setzero_si256();
+    }
+}
+
+/*
+ h = f + g, without carrying
+ */
+
+static inline void
+fe25519x4_add(fe25519x4 *h, const fe25519x4 *f, const fe25519x4 *g)
+{
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        h->v[i] = _mm256_add_epi64(f->v[i], g->v[i]);
+    }
+}
+
+/*
+ h = f - g, without carrying
+ g's limbs must be smaller than 2^53 - 76
+ */
+
+static inline void
+fe25519x4_sub(fe25519x4 *h, const fe25519x4 *f, const fe25519x4 *g)
+{
+    const __m256i p4_0 = _mm256_set1_epi64x(0x1fffffffffffb4LL);
+    const __m256i p4_i = _mm256_set1_epi64x(0x1ffffffffffffcLL);
+
+    h->v[0] = _mm256_sub_epi64(_mm256_add_epi64(f->v[0], p4_0), g->v[0]);
+    h->v[1] = _mm256_sub_epi64(_mm256_add_epi64(f->v[1], p4_i), g->v[1]);
+    h->v[2] = _mm256_sub_epi64(_mm256_add_epi64(f->v[2], p4_i), g->v[2]);
+    h->v[3] = _mm256_sub_epi64(_mm256_add_epi64(f->v[3], p4_i), g->v[3]);
+    h->v[4] = _mm256_sub_epi64(_mm256_add_epi64(f->v[4], p4_i), g->v[4]);
+}
+
+/*
+ One round of carries, in parallel.
+ Limbs smaller than 2^63 become smaller than 2^51 + 2^17.
+ */
+
+static inline void
+fe25519x4_carry(fe25519x4 *h, const fe25519x4 *f)
+{
+    const __m256i mask = _mm256_set1_epi64x(0x7ffffffffffffLL);
+    const __m256i n19  = _mm256_set1_epi64x(19);
+    __m256i       c0, c1, c2, c3, c4;
+
+    c0 = _mm256_srli_epi64(f->v[0], 51);
+    c1 = _mm256_srli_epi64(f->v[1], 51);
+    c2 = _mm256_srli_epi64(f->v[2], 51);
+    c3 = _mm256_srli_epi64(f->v[3], 51);
+    c4 = _mm256_srli_epi64(f->v[4], 51);
+
+    h->v[0] = _mm256_add_epi64(_mm256_and_si256(f->v[0], mask),
+                               _mm256_mul_epu32(c4, n19));
+    h->v[1] = _mm256_add_epi64(_mm256_and_si256(f->v[1], mask), c0);
+    h->v[2] = _mm256_add_epi64(_mm256_and_si256(f->v[2], mask), c1);
+    h->v[3] = _mm256_add_epi64(_mm256_and_si256(f->v[3], mask), c2);
+    h->v[4] = _mm256_add_epi64(_mm256_and_si256(f->v[4], mask), c3);
+}
+
+static inline __m256i
+mul19(__m256i x)
+{
+    return _mm256_add_epi64(_mm256_add_epi64(x, _mm256_slli_epi64(x, 1)),
+                            _mm256_slli_epi64(x, 4));
+}
+
+/*
+ h = f * g, lane by lane
+ Limbs of f and g must be smaller than 2^52.
+
+ The low halves of the 104-bit products are accumulated at weight 2^(51k),
+ and their high halves, at weight 2^(51k+52), have to be doubled.
+ */
+
+static inline void
+fe25519x4_mul(fe25519x4 *h, const fe25519x4 *f, const fe25519x4 *g)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i f0 = f->v[0], f1 = f->v[1], f2 = f->v[2], f3 = f->v[3],
+                  f4 = f->v[4];
+    const __m256i g0 = g->v[0], g1 = g->v[1], g2 = g->v[2], g3 = g->v[3],
+                  g4 = g->v[4];
+    __m256i       l0, l1, l2, l3, l4, l5, l6, l7, l8;
+    __m256i       h1, h2, h3, h4, h5, h6, h7, h8, h9;
+    fe25519x4     t;
+
+    l0 = _mm256_madd52lo_epu64(zero, f0, g0);
+    l1 = _mm256_madd52lo_epu64(zero, f0, g1);
+    l1 = _mm256_madd52lo_epu64(l1, f1, g0);
+    l2 = _mm256_madd52lo_epu64(zero, f0, g2);
+    l2 = _mm256_madd52lo_epu64(l2, f1, g1);
+    l2 = _mm256_madd52lo_epu64(l2, f2, g0);
+    l3 = _mm256_madd52lo_epu64(zero, f0, g3);
+    l3 = _mm256_madd52lo_epu64(l3, f1, g2);
+    l3 = _mm256_madd52lo_epu64(l3, f2, g1);
+    l3 = _mm256_madd52lo_epu64(l3, f3, g0);
+    l4 = _mm256_madd52lo_epu64(zero, f0, g4);
+    l4 = _mm256_madd52lo_epu64(l4, f1, g3);
+    l4 = _mm256_madd52lo_epu64(l4, f2, g2);
+    l4 = _mm256_madd52lo_epu64(l4, f3, g1);
+    l4 = _mm256_madd52lo_epu64(l4, f4, g0);
+    l5 = _mm256_madd52lo_epu64(zero, f1, g4);
+    l5 = _mm256_madd52lo_epu64(l5, f2, g3);
+    l5 = _mm256_madd52lo_epu64(l5, f3, g2);
+    l5 = _mm256_madd52lo_epu64(l5, f4, g1);
+    l6 = _mm256_madd52lo_epu64(zero, f2, g4);
+    l6 = _mm256_madd52lo_epu64(l6, f3, g3);
+    l6 = _mm256_madd52lo_epu64(l6, f4, g2);
+    l7 = _mm256_madd52lo_epu64(zero, f3, g4);
+    l7 = _mm256_madd52lo_epu64(l7, f4, g3);
+    l8 = _mm256_madd52lo_epu64(zero, f4, g4);
+    h1 = _mm256_madd52hi_epu64(zero, f0, g0);
+    h2 = _mm256_madd52hi_epu64(zero, f0, g1);
+    h2 = _mm256_madd52hi_epu64(h2, f1, g0);
+    h3 = _mm256_madd52hi_epu64(zero, f0, g2);
+    h3 = _mm256_madd52hi_epu64(h3, f1, g1);
+    h3 = _mm256_madd52hi_epu64(h3, f2, g0);
+    h4 = _mm256_madd52hi_epu64(zero, f0, g3);
+    h4 = _mm256_madd52hi_epu64(h4, f1, g2);
+    h4 = _mm256_madd52hi_epu64(h4, f2, g1);
+    h4 = _mm256_madd52hi_epu64(h4, f3, g0);
+    h5 = _mm256_madd52hi_epu64(zero, f0, g4);
+    h5 = _mm256_madd52hi_epu64(h5, f1, g3);
+    h5 = _mm256_madd52hi_epu64(h5, f2, g2);
+    h5 = _mm256_madd52hi_epu64(h5, f3, g1);
+    h5 = _mm256_madd52hi_epu64(h5, f4, g0);
+    h6 = _mm256_madd52hi_epu64(zero, f1, g4);
+    h6 = _mm256_madd52hi_epu64(h6, f2, g3);
+    h6 = _mm256_madd52hi_epu64(h6, f3, g2);
+    h6 = _mm256_madd52hi_epu64(h6, f4, g1);
+    h7 = _mm256_madd52hi_epu64(zero, f2, g4);
+    h7 = _mm256_madd52hi_epu64(h7, f3, g3);
+    h7 = _mm256_madd52hi_epu64(h7, f4, g2);
+    h8 = _mm256_madd52hi_epu64(zero, f3, g4);
+    h8 = _mm256_madd52hi_epu64(h8, f4, g3);
+    h9 = _mm256_madd52hi_epu64(zero, f4, g4);
+
+    /* z_k = l_k + 2 h_k < 2^56, and 2^255 = 19 */
+    l5    = _mm256_add_epi64(l5, _mm256_add_epi64(h5, h5));
+    l6    = _mm256_add_epi64(l6, _mm256_add_epi64(h6, h6));
+    l7    = _mm256_add_epi64(l7, _mm256_add_epi64(h7, h7));
+    l8    = _mm256_add_epi64(l8, _mm256_add_epi64(h8, h8));
+    h9    = _mm256_add_epi64(h9, h9);
+    t.v[0] = _mm256_add_epi64(l0, mul19(l5));
+    t.v[1] = _mm256_add_epi64(_mm256_add_epi64(l1, _mm256_add_epi64(h1, h1)),
+                              mul19(l6));
+    t.v[2] = _mm256_add_epi64(_mm256_add_epi64(l2, _mm256_add_epi64(h2, h2)),
+                              mul19(l7));
+    t.v[3] = _mm256_add_epi64(_mm256_add_epi64(l3, _mm256_add_epi64(h3, h3)),
+                              mul19(l8));
+    t.v[4] = _mm256_add_epi64(_mm256_add_epi64(l4, _mm256_add_epi64(h4, h4)),
+                              mul19(h9));
+    fe25519x4_carry(h, &t);
+}
+
+/*
+ h = f * n, lane by lane, with n < 2^32
+ */
+
+static inline void
+fe25519x4_mul32(fe25519x4 *h, const fe25519x4 *f, uint32_t n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i vn   = _mm256_set1_epi64x((long long) n);
+    __m256i       h0, h1, h2, h3, h4;
+    fe25519x4     t;
+
+    h0 = _mm256_madd52hi_epu64(zero, f->v[0], vn);
+    h1 = _mm256_madd52hi_epu64(zero, f->v[1], vn);
+    h2 = _mm256_madd52hi_epu64(zero, f->v[2], vn);
+    h3 = _mm256_madd52hi_epu64(zero, f->v[3], vn);
+    h4 = _mm256_madd52hi_epu64(zero, f->v[4], vn);
+    t.v[0] = _mm256_madd52lo_epu64(mul19(_mm256_add_epi64(h4, h4)),
+                                   f->v[0], vn);
+    t.v[1] = _mm256_madd52lo_epu64(_mm256_add_epi64(h0, h0), f->v[1], vn);
+    t.v[2] = _mm256_madd52lo_epu64(_mm256_add_epi64(h1, h1), f->v[2], vn);
+    t.v[3] = _mm256_madd52lo_epu64(_mm256_add_epi64(h2, h2), f->v[3], vn);
+    t.v[4] = _mm256_madd52lo_epu64(_mm256_add_epi64(h3, h3), f->v[4], vn);
+    fe25519x4_carry(h, &t);
+}
+
+/*
+ Replaces the lanes of f whose mask is all ones with the lanes of g.
+ */
+
+static inline void
+fe25519x4_cmov(fe25519x4 *f, const fe25519x4 *g, const __m256i mask)
+{
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        f->v[i] = _mm256_xor_si256(
+            f->v[i], _mm256_and_si256(_mm256_xor_si256(f->v[i], g->v[i]), mask));
+    }
+}
+
+/*
+ Swaps the lanes of f and g whose mask is all ones.
+ */
+
+static inline void
+fe25519x4_cswap(fe25519x4 *f, fe25519x4 *g, const __m256i mask)
+{
+    __m256i x;
+    int     i;
+
+    for (i = 0; i < 5; i++) {
+        x = _mm256_and_si256(_mm256_xor_si256(f->v[i], g->v[i]), mask);
+        f->v[i] = _mm256_xor_si256(f->v[i], x);
+        g->v[i] = _mm256_xor_si256(g->v[i], x);
+    }
+}
+
+/*
+ Loads four field elements. Ignores the top bit of each of them.
+ */
+
+static inline void
+fe25519x4_frombytes(fe25519x4 *h, const unsigned char *a,
+                    const unsigned char *b, const unsigned char *c,
+                    const unsigned char *d)
+{
+    const uint64_t       mask = 0x7ffffffffffffULL;
+    const unsigned char *s[4];
+    uint64_t             l[4][5];
+    int                  i;
+
+    s[0] = a;
+    s[1] = b;
+    s[2] = c;
+    s[3] = d;
+    for (i = 0; i < 4; i++) {
+        l[i][0] = (LOAD64_LE(s[i]     )      ) & mask;
+        l[i][1] = (LOAD64_LE(s[i] +  6) >>  3) & mask;
+        l[i][2] = (LOAD64_LE(s[i] + 12) >>  6) & mask;
+        l[i][3] = (LOAD64_LE(s[i] + 19) >>  1) & mask;
+        l[i][4] = (LOAD64_LE(s[i] + 24) >> 12) & mask;
+    }
+    for (i = 0; i < 5; i++) {
+        h->v[i] = _mm256_set_epi64x((long long) l[3][i], (long long) l[2][i],
+                                    (long long) l[1][i], (long long) l[0][i]);
+    }
+}
+
+static inline void
+fe25519x4_from_fe25519(fe25519x4 *h, const fe25519 a, const fe25519 b,
+                       const fe25519 c, const fe25519 d)
+{
+    unsigned char s[4][32];
+
+    fe25519_tobytes(s[0], a);
+    fe25519_tobytes(s[1], b);
+    fe25519_tobytes(s[2], c);
+    fe25519_tobytes(s[3], d);
+    fe25519x4_frombytes(h, s[0], s[1], s[2], s[3]);
+}
+
+/*
+ Fully reduces the element stored in the given lane, and returns it as
+ a ref10 field element.
+ */
+
+static inline void
+fe25519x4_to_fe25519(fe25519 out, const fe25519x4 *f, const int lane)
+{
+    const uint64_t mask = 0x7ffffffffffffULL;
+    uint64_t       lanes[4];
+    uint64_t       t[5];
+    unsigned char  s[32];
+    int            i;
+
+    for (i = 0; i < 5; i++) {
+        _mm256_storeu_si256((__m256i *) (void *) lanes, f->v[i]);
+        t[i] = lanes[lane];
+    }
+    for (i = 0; i < 2; i++) {
+        t[1] += t[0] >> 51;
+        t[0] &= mask;
+        t[2] += t[1] >> 51;
+        t[1] &= mask;
+        t[3] += t[2] >> 51;
+        t[2] &= mask;
+        t[4] += t[3] >> 51;
+        t[3] &= mask;
+        t[0] += 19 * (t[4] >> 51);
+        t[4] &= mask;
+    }
+    t[0] += 19ULL;
+    t[1] += t[0] >> 51;
+    t[0] &= mask;
+    t[2] += t[1] >> 51;
+    t[1] &= mask;
+    t[3] += t[2] >> 51;
+    t[2] &= mask;
+    t[4] += t[3] >> 51;
+    t[3] &= mask;
+    t[0] += 19ULL * (t[4] >> 51);
+    t[4] &= mask;
+
+    t[0] += 0x8000000000000ULL - 19ULL;
+    t[1] += 0x8000000000000ULL - 1ULL;
+    t[2] += 0x8000000000000ULL - 1ULL;
+    t[3] += 0x8000000000000ULL - 1ULL;
+    t[4] += 0x8000000000000ULL - 1ULL;
+
+    t[1] += t[0] >> 51;
+    t[0] &= mask;
+    t[2] += t[1] >> 51;
+    t[1] &= mask;
+    t[3] += t[2] >> 51;
+    t[2] &= mask;
+    t[4] += t[3] >> 51;
+    t[3] &= mask;
+    t[4] &= mask;
+
+    STORE64_LE(s,      t[0] | (t[1] << 51));
+    STORE64_LE(s + 8,  (t[1] >> 13) | (t[2] << 38));
+    STORE64_LE(s + 16, (t[2] >> 26) | (t[3] << 25));
+    STORE64_LE(s + 24, (t[3] >> 39) | (t[4] << 12));
+
+    fe25519_frombytes(out, s);
+}
+
+#endif
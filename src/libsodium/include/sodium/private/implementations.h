@@ -3,11 +3,30 @@
 
 #include "private/quirks.h"
 
+int _crypto_aead_aegis128l_pick_best_implementation(void);
+int _crypto_aead_aegis128x_pick_best_implementation(void);
+int _crypto_aead_aegis256_pick_best_implementation(void);
+int _crypto_aead_aegis256x_pick_best_implementation(void);
+int _crypto_aead_aes256gcm_pick_best_implementation(void);
+int _crypto_core_ed25519_pick_best_implementation(void);
 int _crypto_generichash_blake2b_pick_best_implementation(void);
+int _crypto_generichash_blake3_pick_best_implementation(void);
+int _crypto_hash_sha256_pick_best_implementation(void);
+int _crypto_hash_sha512_pick_best_implementation(void);
 int _crypto_onetimeauth_poly1305_pick_best_implementation(void);
 int _crypto_pwhash_argon2_pick_best_implementation(void);
+int _crypto_pwhash_scryptsalsa208sha256_pick_best_implementation(void);
 int _crypto_scalarmult_curve25519_pick_best_implementation(void);
+int _crypto_shorthash_siphash13_pick_best_implementation(void);
+int _crypto_shorthash_siphash24_pick_best_implementation(void);
 int _crypto_stream_chacha20_pick_best_implementation(void);
 int _crypto_stream_salsa20_pick_best_implementation(void);
+int _crypto_stream_salsa2012_pick_best_implementation(void);
+int _crypto_stream_salsa208_pick_best_implementation(void);
+int _sodium_codecs_pick_best_implementation(void);
+
+/* A NULL name is only allowed if there is no override */
+int  _sodium_implementation_allowed(const char *primitive, const char *name);
+void _sodium_implementation_selected(const char *primitive, const char *name);
 
 #endif
@@ -6,4 +6,56 @@
 extern int sodium_crit_enter(void);
 extern int sodium_crit_leave(void);
 
+/*
+ * Acquire loads and release stores of an int or a pointer, for flags and
+ * records checked outside of the critical section. Without
+ * HAVE_LOAD_ACQUIRE, these must only be read with the lock held.
+ */
+#if defined(__ATOMIC_ACQUIRE) && defined(__ATOMIC_RELEASE)
+# define HAVE_LOAD_ACQUIRE 1
+# define sodium_load_acquire(P)     __atomic_load_n((P), __ATOMIC_ACQUIRE)
+# define sodium_store_release(P, V) __atomic_store_n((P), (V), __ATOMIC_RELEASE)
+# define sodium_load_acquire_ptr(P)     __atomic_load_n((P), __ATOMIC_ACQUIRE)
+# define sodium_store_release_ptr(P, V) __atomic_store_n((P), (V), __ATOMIC_RELEASE)
+#elif defined(_MSC_VER) && \
+    (defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86))
+# include <intrin.h>
+# define HAVE_LOAD_ACQUIRE 1
+static __inline int
+sodium_load_acquire(volatile int *p)
+{
+    const int v = *p;
+
+    _ReadWriteBarrier();
+
+    return v;
+}
+static __inline void
+sodium_store_release(volatile int *p, const int v)
+{
+    _ReadWriteBarrier();
+    *p = v;
+}
+static __inline void *
+sodium_load_acquire_ptr(void *volatile *p)
+{
+    void *const v = *p;
+
+    _ReadWriteBarrier();
+
+    return v;
+}
+static __inline void
+sodium_store_release_ptr(void *volatile *p, void *const v)
+{
+    _ReadWriteBarrier();
+    *p = v;
+}
+#else
+# define sodium_load_acquire(P)         (*(P))
+# define sodium_store_release(P, V)     (*(P) = (V))
+# define sodium_load_acquire_ptr(P)     (*(P))
+# define sodium_store_release_ptr(P, V) (*(P) = (V))
+#endif
+
 #endif
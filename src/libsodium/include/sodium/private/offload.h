@@ -0,0 +1,33 @@
+#ifndef offload_H
+#define offload_H
+
+#include "core.h"
+#include "private/quirks.h"
+
+/*
+ * Hand an AEAD operation to the offload provider, if there is one that
+ * supports op for messages of that size. Returns 0 or -1 if the provider
+ * processed the message, and SODIUM_OFFLOAD_DECLINED if the caller has to
+ * process it itself.
+ */
+
+#define SODIUM_OFFLOAD_DECLINED 1
+
+int _sodium_offload_aead_encrypt(unsigned int op, unsigned char *c,
+                                 unsigned char *mac, const unsigned char *m,
+                                 unsigned long long mlen,
+                                 const unsigned char *ad,
+                                 unsigned long long adlen,
+                                 const unsigned char *npub,
+                                 const unsigned char *k);
+
+int _sodium_offload_aead_decrypt(unsigned int op, unsigned char *m,
+                                 const unsigned char *c,
+                                 unsigned long long clen,
+                                 const unsigned char *mac,
+                                 const unsigned char *ad,
+                                 unsigned long long adlen,
+                                 const unsigned char *npub,
+                                 const unsigned char *k);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef poly1305_parallel_H
+#define poly1305_parallel_H
+
+#include "crypto_onetimeauth_poly1305.h"
+#include "private/quirks.h"
+
+/*
+ * Poly1305 with updates split across up to `threads` threads, using powers
+ * of r to combine the partial results. A state initialized here must only
+ * be used with these functions, not with crypto_onetimeauth_poly1305_*().
+ */
+
+int crypto_onetimeauth_poly1305_parallel_init(
+    crypto_onetimeauth_poly1305_state *state, const unsigned char *key);
+
+int crypto_onetimeauth_poly1305_parallel_update(
+    crypto_onetimeauth_poly1305_state *state, const unsigned char *in,
+    unsigned long long inlen, unsigned int threads);
+
+int crypto_onetimeauth_poly1305_parallel_final(
+    crypto_onetimeauth_poly1305_state *state, unsigned char *out);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef probes_H
+#define probes_H 1
+
+/*
+ * USDT probes of the "libsodium" provider, only compiled in with
+ * --enable-usdt. An unattached probe is a single nop, but its arguments
+ * are still computed, so they should be cheap and have no side effects.
+ */
+#if defined(ENABLE_USDT) && defined(HAVE_SYS_SDT_H)
+
+# include <sys/sdt.h>
+
+# define SODIUM_PROBE(NAME)                DTRACE_PROBE(libsodium, NAME)
+# define SODIUM_PROBE1(NAME, A)            DTRACE_PROBE1(libsodium, NAME, A)
+# define SODIUM_PROBE2(NAME, A, B)         DTRACE_PROBE2(libsodium, NAME, A, B)
+# define SODIUM_PROBE3(NAME, A, B, C)      DTRACE_PROBE3(libsodium, NAME, A, B, C)
+# define SODIUM_PROBE4(NAME, A, B, C, D)   DTRACE_PROBE4(libsodium, NAME, A, B, C, D)
+
+#else
+
+# define SODIUM_PROBE(NAME)                ((void) 0)
+# define SODIUM_PROBE1(NAME, A)            ((void) 0)
+# define SODIUM_PROBE2(NAME, A, B)         ((void) 0)
+# define SODIUM_PROBE3(NAME, A, B, C)      ((void) 0)
+# define SODIUM_PROBE4(NAME, A, B, C, D)   ((void) 0)
+
+#endif
+
+#endif
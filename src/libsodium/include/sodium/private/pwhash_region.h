@@ -0,0 +1,23 @@
+#ifndef pwhash_region_H
+#define pwhash_region_H
+
+#include <stddef.h>
+
+/*
+ * Maps at least *size_p bytes of anonymous memory for a password hashing
+ * function, backed by huge pages if crypto_pwhash_set_huge_pages() enabled
+ * them. *size_p is updated with the size of the mapping, that has to be
+ * given to _crypto_pwhash_region_unmap(). The mapping counts against the
+ * budget set by crypto_pwhash_set_memory_budget(), and may wait for it.
+ * It comes from the SODIUM_ALLOC_SCRATCH allocator if one was set.
+ * If populate is 0, pages are not faulted in by the mapping, and end up on
+ * the NUMA node of the thread that first writes to them.
+ * Returns NULL on failure.
+ * Only available if HAVE_MMAP is defined.
+ */
+
+void *_crypto_pwhash_region_map(size_t *size_p, int populate);
+
+int _crypto_pwhash_region_unmap(void *base, size_t size);
+
+#endif
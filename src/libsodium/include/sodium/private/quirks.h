@@ -34,6 +34,7 @@
 #define blake2b_init_param _sodium_blake2b_init_param
 #define blake2b_init_salt_personal _sodium_blake2b_init_salt_personal
 #define blake2b_long _sodium_blake2b_long
+#define blake2b_long_multi _sodium_blake2b_long_multi
 #define blake2b_pick_best_implementation _sodium_blake2b_pick_best_implementation
 #define blake2b_salt_personal _sodium_blake2b_salt_personal
 #define blake2b_update _sodium_blake2b_update
@@ -51,6 +52,8 @@
 #define fe25519_invert _sodium_fe25519_invert
 #define fe25519_tobytes _sodium_fe25519_tobytes
 #define ge25519_add_cached _sodium_ge25519_add_cached
+#define ge25519_avx512ifma_init _sodium_ge25519_avx512ifma_init
+#define ge25519_double_scalarmult_slides_vartime_avx512ifma _sodium_ge25519_double_scalarmult_slides_vartime_avx512ifma
 #define ge25519_double_scalarmult_vartime _sodium_ge25519_double_scalarmult_vartime
 #define ge25519_from_hash _sodium_ge25519_from_hash
 #define ge25519_from_uniform _sodium_ge25519_from_uniform
@@ -60,12 +63,14 @@
 #define ge25519_is_canonical _sodium_ge25519_is_canonical
 #define ge25519_is_on_curve _sodium_ge25519_is_on_curve
 #define ge25519_is_on_main_subgroup _sodium_ge25519_is_on_main_subgroup
+#define ge25519_is_on_main_subgroup_vartime _sodium_ge25519_is_on_main_subgroup_vartime
 #define ge25519_p1p1_to_p2 _sodium_ge25519_p1p1_to_p2
 #define ge25519_p1p1_to_p3 _sodium_ge25519_p1p1_to_p3
 #define ge25519_p3_to_cached _sodium_ge25519_p3_to_cached
 #define ge25519_p3_tobytes _sodium_ge25519_p3_tobytes
 #define ge25519_scalarmult _sodium_ge25519_scalarmult
 #define ge25519_scalarmult_base _sodium_ge25519_scalarmult_base
+#define ge25519_scalarmult_base_digits_avx512ifma _sodium_ge25519_scalarmult_base_digits_avx512ifma
 #define ge25519_sub_cached _sodium_ge25519_sub_cached
 #define ge25519_tobytes _sodium_ge25519_tobytes
 #define ristretto255_from_hash _sodium_ristretto255_from_hash
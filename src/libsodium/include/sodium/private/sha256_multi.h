@@ -0,0 +1,42 @@
+#ifndef sha256_multi_H
+#define sha256_multi_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto_hash_sha256.h"
+
+/*
+ * Completes count independent SHA-256 computations: states[i] absorbs
+ * in[i] and is finalized into out[i], as update() followed by final()
+ * would. Up to SHA256_MULTI_LANES_MAX hashes are computed in parallel,
+ * one per 32-bit SIMD lane, when the CPU supports it.
+ */
+
+void _crypto_hash_sha256_final_multi(crypto_hash_sha256_state * const *states,
+                                     unsigned char * const *out,
+                                     const unsigned char * const *in,
+                                     const unsigned long long *inlen,
+                                     size_t count);
+
+#define SHA256_MULTI_LANES_MAX 16
+
+typedef struct sha256_multi_state {
+    uint32_t h[8][SHA256_MULTI_LANES_MAX];
+    uint32_t w[16][SHA256_MULTI_LANES_MAX];
+} sha256_multi_state;
+
+/*
+ * Compresses one block into each of the first count lanes of M, with
+ * M->w as the message words. Lanes beyond count are left undefined.
+ * _crypto_hash_sha256_multi_lanes() returns how many lanes are worth
+ * filling, which is 1 when there is no multi-lane implementation.
+ */
+
+size_t _crypto_hash_sha256_multi_lanes(void);
+void   _crypto_hash_sha256_compress_lanes(sha256_multi_state *M, size_t count);
+
+void _crypto_hash_sha256_transform_multi_avx2(sha256_multi_state *M);
+void _crypto_hash_sha256_transform_multi_avx512f(sha256_multi_state *M);
+
+#endif
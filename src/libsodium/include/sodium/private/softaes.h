@@ -0,0 +1,44 @@
+#ifndef softaes_H
+#define softaes_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Constant-time AES for CPUs without AES instructions.
+ *
+ * The S-box is computed with a boolean circuit over bitsliced state, so
+ * that there are no table lookups. Four independent blocks are processed
+ * at once, and callers should batch blocks whenever they can: a single
+ * block costs as much as four.
+ */
+
+#define SOFTAES_PARALLEL 4U
+
+/* AES-256 round keys, in byte form */
+typedef struct softaes256_key {
+    unsigned char rk[15 * 16];
+} softaes256_key;
+
+/* AES-256 round keys, bitsliced for softaes256_encrypt4() */
+typedef struct softaes256_skey {
+    uint64_t sk[15 * 8];
+} softaes256_skey;
+
+/*
+ * out[i] = SubBytes/ShiftRows/MixColumns(in[i]) ^ rk[i] for 4 blocks,
+ * the equivalent of _mm_aesenc_si128() and of AESE+AESMC followed by
+ * a XOR.
+ */
+void softaes_enc4(unsigned char out[64], const unsigned char in[64],
+                  const unsigned char rk[64]);
+
+void softaes256_expand_key(softaes256_key *key, const unsigned char k[32]);
+
+void softaes256_bitslice_key(softaes256_skey *skey, const softaes256_key *key);
+
+/* Encrypts 4 blocks with AES-256 */
+void softaes256_encrypt4(unsigned char out[64], const unsigned char in[64],
+                         const softaes256_skey *skey);
+
+#endif
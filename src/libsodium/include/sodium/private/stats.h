@@ -0,0 +1,30 @@
+#ifndef stats_H
+#define stats_H 1
+
+#include <stdint.h>
+
+#include "../stats.h"
+
+/*
+ * SODIUM_STATS_START(v) declares v and must be the last declaration of the
+ * block; every return path must then go through SODIUM_STATS_STOP(). Both
+ * compile to nothing without ENABLE_STATS.
+ */
+#ifdef ENABLE_STATS
+
+uint64_t _sodium_stats_begin(void);
+void     _sodium_stats_end(const uint64_t start, const int category,
+                           const uint64_t bytes);
+
+# define SODIUM_STATS_START(V) const uint64_t V = _sodium_stats_begin();
+# define SODIUM_STATS_STOP(V, CATEGORY, BYTES) \
+    _sodium_stats_end((V), (CATEGORY), (uint64_t) (BYTES))
+
+#else
+
+# define SODIUM_STATS_START(V)
+# define SODIUM_STATS_STOP(V, CATEGORY, BYTES) ((void) 0)
+
+#endif
+
+#endif
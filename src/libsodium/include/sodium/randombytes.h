@@ -40,12 +40,35 @@ void randombytes_buf_deterministic(void * const buf, const size_t size,
                                    const unsigned char seed[randombytes_SEEDBYTES])
             __attribute__ ((nonnull));
 
+/*
+ * Same as calling randombytes_buf_deterministic(outs[i], size, seeds[i])
+ * for each of the n seeds, but several seeds are expanded in parallel.
+ */
+SODIUM_EXPORT
+void randombytes_buf_deterministic_many(unsigned char * const *outs, const size_t size,
+                                        const unsigned char * const *seeds, const size_t n);
+
 SODIUM_EXPORT
 uint32_t randombytes_random(void);
 
 SODIUM_EXPORT
 uint32_t randombytes_uniform(const uint32_t upper_bound);
 
+/*
+ * Fill `out` with `n` independent values uniformly distributed in
+ * [0, upper_bound). Much faster than calling randombytes_uniform()
+ * repeatedly, but the values are not the same.
+ */
+SODIUM_EXPORT
+void randombytes_uniform_many(uint32_t * const out, const size_t n,
+                              const uint32_t upper_bound)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void randombytes_uniform64_many(uint64_t * const out, const size_t n,
+                                const uint64_t upper_bound)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 void randombytes_stir(void);
 
@@ -12,6 +12,50 @@ extern "C" {
 SODIUM_EXPORT
 extern struct randombytes_implementation randombytes_internal_implementation;
 
+/*
+ * Same construction as randombytes_internal_implementation, with ChaCha12
+ * instead of ChaCha20 as the keystream generator.
+ */
+SODIUM_EXPORT
+extern struct randombytes_implementation randombytes_chacha12_implementation;
+
+/*
+ * Same as randombytes_internal_implementation, with a generator per CPU
+ * instead of per thread on Linux, for processes with many more threads
+ * than CPUs: memory and seeding system calls don't grow with the number
+ * of threads. Elsewhere, generators are still per thread.
+ */
+SODIUM_EXPORT
+extern struct randombytes_implementation randombytes_percpu_implementation;
+
+/*
+ * These implementations seed each generator from the OS, and then
+ * only rekey it from its own output. randombytes_internal_set_reseed()
+ * makes them rekey it every `interval` refills of their 2 KB pool:
+ *
+ * - RANDOMBYTES_INTERNAL_RESEED_OS gets a new key from the OS, at the cost
+ *   of a system call. interval = 0, the default, disables reseeding.
+ * - RANDOMBYTES_INTERNAL_RESEED_HWRAND mixes 32 bytes from RDSEED, RDRAND
+ *   or ARMv8.5 RNDR into the key, without system calls. The OS is still
+ *   used if the CPU doesn't deliver. Returns -1 with errno set to ENOSYS
+ *   if the CPU has none of these instructions.
+ *
+ * randombytes_internal_reseed() makes every thread's generator reseed that
+ * way before it refills its pool again, and the calling thread's and the
+ * per-CPU generators right away, dropping buffered output. Call it after
+ * a VM snapshot is restored or cloned.
+ */
+
+#define RANDOMBYTES_INTERNAL_RESEED_OS     0
+#define RANDOMBYTES_INTERNAL_RESEED_HWRAND 1
+
+SODIUM_EXPORT
+int randombytes_internal_set_reseed(int mode, unsigned int interval)
+            __attribute__ ((warn_unused_result));
+
+SODIUM_EXPORT
+int randombytes_internal_reseed(void);
+
 /* Backwards compatibility with libsodium < 1.0.18 */
 #define randombytes_salsa20_implementation randombytes_internal_implementation
 
@@ -14,6 +14,12 @@ int sodium_runtime_has_neon(void);
 SODIUM_EXPORT_WEAK
 int sodium_runtime_has_armcrypto(void);
 
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_armsha2(void);
+
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_armsha512(void);
+
 SODIUM_EXPORT_WEAK
 int sodium_runtime_has_sse2(void);
 
@@ -32,9 +38,27 @@ int sodium_runtime_has_avx(void);
 SODIUM_EXPORT_WEAK
 int sodium_runtime_has_avx2(void);
 
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_bmi2(void);
+
 SODIUM_EXPORT_WEAK
 int sodium_runtime_has_avx512f(void);
 
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_avx512vl(void);
+
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_avx512ifma(void);
+
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_vaes(void);
+
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_vpclmulqdq(void);
+
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_shani(void);
+
 SODIUM_EXPORT_WEAK
 int sodium_runtime_has_pclmul(void);
 
@@ -44,10 +68,46 @@ int sodium_runtime_has_aesni(void);
 SODIUM_EXPORT_WEAK
 int sodium_runtime_has_rdrand(void);
 
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_rdseed(void);
+
+/* ARMv8.5 RNDR */
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_rndr(void);
+
+/* POWER8 (ISA 2.07) VSX */
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_vsx(void);
+
+/* RISC-V Vector extension 1.0 */
+SODIUM_EXPORT_WEAK
+int sodium_runtime_has_rvv(void);
+
+/*
+ * Whether 512-bit vector code is used when the CPU supports it.
+ * AUTO avoids it on CPUs whose frequency drops while running it,
+ * PREFER_256 never uses it, and PREFER_512 always does.
+ * sodium_runtime_set_vector_policy() has to be called before sodium_init().
+ */
+#define SODIUM_RUNTIME_VECTOR_POLICY_AUTO       0
+#define SODIUM_RUNTIME_VECTOR_POLICY_PREFER_256 1
+#define SODIUM_RUNTIME_VECTOR_POLICY_PREFER_512 2
+
+SODIUM_EXPORT
+int sodium_runtime_set_vector_policy(const int policy);
+
+SODIUM_EXPORT
+int sodium_runtime_vector_policy(void);
+
 /* ------------------------------------------------------------------------- */
 
 int _sodium_runtime_get_cpu_features(void);
 
+int _sodium_runtime_use_512bit_vectors(void);
+
+/* Family, model and stepping on x86, 0 elsewhere */
+unsigned int _sodium_runtime_cpu_signature(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,52 @@
+
+#ifndef sodium_stats_H
+#define sodium_stats_H
+
+#include <stdint.h>
+
+#include "export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SODIUM_STATS_AEAD       0
+#define SODIUM_STATS_STREAM     1
+#define SODIUM_STATS_HASH       2
+#define SODIUM_STATS_SIGN       3
+#define SODIUM_STATS_SCALARMULT 4
+#define SODIUM_STATS_PWHASH     5
+#define SODIUM_STATS_COUNT      6
+
+typedef struct sodium_stats_counter {
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t cycles;
+} sodium_stats_counter;
+
+typedef struct sodium_stats {
+    sodium_stats_counter counters[SODIUM_STATS_COUNT];
+} sodium_stats;
+
+/*
+ * Totals of all threads, including the ones that have exited, since the
+ * library was loaded. Counters are only maintained if libsodium was
+ * configured with --enable-stats, and cycles with --enable-stats=cycles;
+ * otherwise, sodium_stats_get() returns -1 and sets errno to ENOSYS.
+ *
+ * A primitive called by another counted primitive is only accounted to the
+ * outer one: the stream cipher used by an AEAD counts as AEAD.
+ * Bytes are the message length, or the memory size for password hashing.
+ */
+SODIUM_EXPORT
+int sodium_stats_get(sodium_stats *stats)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+const char *sodium_stats_name(int category);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,6 +3,7 @@
 #define sodium_utils_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "export.h"
 
@@ -24,6 +25,14 @@ void sodium_memzero(void * const pnt, const size_t len);
 SODIUM_EXPORT
 void sodium_stackzero(const size_t len);
 
+/*
+ * sodium_memzero() for large buffers about to be released. Large sizes
+ * are wiped with non-temporal stores when available, so that the wipe
+ * doesn't flush the cache.
+ */
+SODIUM_EXPORT
+void sodium_memzero_bulk(void * const pnt, const size_t len);
+
 /*
  * WARNING: sodium_memcmp() must be used to verify if two secret keys
  * are equal, in constant time.
@@ -50,6 +59,10 @@ int sodium_is_zero(const unsigned char *n, const size_t nlen);
 SODIUM_EXPORT
 void sodium_increment(unsigned char *n, const size_t nlen);
 
+SODIUM_EXPORT
+void sodium_increment_by(unsigned char *n, const size_t nlen,
+                         const uint64_t delta);
+
 SODIUM_EXPORT
 void sodium_add(unsigned char *a, const unsigned char *b, const size_t len);
 
@@ -97,6 +110,62 @@ int sodium_base642bin(unsigned char * const bin, const size_t bin_maxlen,
                       const char ** const b64_end, const int variant)
             __attribute__ ((nonnull(1)));
 
+/*
+ * Incremental base64. Updates only emit complete quanta and keep the rest
+ * in the state; the output is not NUL-terminated. Each encoder update
+ * writes at most (BIN_LEN + 2) / 3 * 4 characters, each decoder update at
+ * most B64_LEN * 3 / 4 + 1 bytes.
+ */
+typedef struct sodium_base64_encode_state {
+    int           variant;
+    unsigned char buf[3];
+    unsigned char buf_len;
+} sodium_base64_encode_state;
+
+typedef struct sodium_base64_decode_state {
+    int          variant;
+    unsigned int acc;
+    unsigned int acc_len;
+    unsigned int padding_len;
+    unsigned int in_padding;
+} sodium_base64_decode_state;
+
+SODIUM_EXPORT
+int sodium_base64_encode_init(sodium_base64_encode_state *state,
+                              const int variant)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int sodium_base64_encode_update(sodium_base64_encode_state *state,
+                                char * const b64, const size_t b64_maxlen,
+                                size_t * const b64_len,
+                                const unsigned char *bin, size_t bin_len)
+            __attribute__ ((nonnull(1, 4)));
+
+SODIUM_EXPORT
+int sodium_base64_encode_final(sodium_base64_encode_state *state,
+                               char * const b64, const size_t b64_maxlen,
+                               size_t * const b64_len)
+            __attribute__ ((nonnull(1, 4)));
+
+SODIUM_EXPORT
+int sodium_base64_decode_init(sodium_base64_decode_state *state,
+                              const int variant)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int sodium_base64_decode_update(sodium_base64_decode_state *state,
+                                unsigned char * const bin,
+                                const size_t bin_maxlen,
+                                size_t * const bin_len,
+                                const char * const b64, const size_t b64_len,
+                                const char * const ignore)
+            __attribute__ ((nonnull(1, 4)));
+
+SODIUM_EXPORT
+int sodium_base64_decode_final(sodium_base64_decode_state *state)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int sodium_mlock(void * const addr, const size_t len)
             __attribute__ ((nonnull));
@@ -149,6 +218,29 @@ void *sodium_allocarray(size_t count, size_t size)
 SODIUM_EXPORT
 void sodium_free(void *ptr);
 
+/*
+ * Memory held by sodium_malloc() and secure pools, each pool counting as a
+ * single allocation of all its slots. Mapped bytes include guard pages and
+ * padding; locked bytes only include regions that could be locked.
+ * Allocations from a SODIUM_ALLOC_SECRET allocator are counted as mapped,
+ * but not locked. Nothing is counted on platforms without page-aligned
+ * allocations. The _max fields are high-water marks.
+ */
+typedef struct sodium_secure_memory_stats {
+    size_t allocations;
+    size_t requested_bytes;
+    size_t mapped_bytes;
+    size_t locked_bytes;
+    size_t allocations_max;
+    size_t requested_bytes_max;
+    size_t mapped_bytes_max;
+    size_t locked_bytes_max;
+} sodium_secure_memory_stats;
+
+SODIUM_EXPORT
+int sodium_secure_memory_stats_get(sodium_secure_memory_stats *stats)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int sodium_mprotect_noaccess(void *ptr) __attribute__ ((nonnull));
 
@@ -158,11 +250,91 @@ int sodium_mprotect_readonly(void *ptr) __attribute__ ((nonnull));
 SODIUM_EXPORT
 int sodium_mprotect_readwrite(void *ptr) __attribute__ ((nonnull));
 
+/*
+ * A pool of `count` fixed-size slots for small secrets, carved out of a
+ * single region that is locked once and surrounded by guard pages.
+ * Each slot is surrounded by canaries checked by sodium_secure_pool_free(),
+ * which also wipes it. Slots whose size plus 32 bytes is a multiple of the
+ * page size can be individually protected; the mprotect functions fail with
+ * EINVAL for other sizes.
+ * A pool must not be used by several threads concurrently.
+ */
+typedef struct sodium_secure_pool sodium_secure_pool;
+
+SODIUM_EXPORT
+sodium_secure_pool *sodium_secure_pool_create(const size_t slot_size,
+                                              const size_t count);
+
+SODIUM_EXPORT
+void sodium_secure_pool_destroy(sodium_secure_pool *pool);
+
+SODIUM_EXPORT
+void *sodium_secure_pool_alloc(sodium_secure_pool *pool)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void sodium_secure_pool_free(sodium_secure_pool *pool, void *ptr)
+            __attribute__ ((nonnull(1)));
+
+SODIUM_EXPORT
+int sodium_secure_pool_mprotect_noaccess(sodium_secure_pool *pool, void *ptr)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int sodium_secure_pool_mprotect_readonly(sodium_secure_pool *pool, void *ptr)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+int sodium_secure_pool_mprotect_readwrite(sodium_secure_pool *pool, void *ptr)
+            __attribute__ ((nonnull));
+
+/*
+ * A secret arena is an allocator for sodium_set_allocator() that makes
+ * sodium_malloc() and sodium_free() avoid system calls most of the time:
+ *
+ * sodium_set_allocator(SODIUM_ALLOC_SECRET, sodium_secret_arena_alloc,
+ *                      sodium_secret_arena_free, arena);
+ *
+ * Allocations are carved out of slabs of slab_size bytes (0 for a default
+ * size), each surrounded by guard pages. On Linux, slabs are backed by
+ * memfd_secret() when the kernel allows it, so that they are removed from
+ * the kernel direct map and never swapped. Otherwise, they are locked once.
+ * Allocations larger than 16 KB get a slab of their own.
+ * Returns NULL with errno set to ENOSYS if slabs cannot be mapped.
+ * An arena can be used by several threads, and can only be destroyed once
+ * nothing it allocated is in use.
+ */
+typedef struct sodium_secret_arena sodium_secret_arena;
+
+SODIUM_EXPORT
+sodium_secret_arena *sodium_secret_arena_create(size_t slab_size);
+
+SODIUM_EXPORT
+void sodium_secret_arena_destroy(sodium_secret_arena *arena);
+
+SODIUM_EXPORT
+void *sodium_secret_arena_alloc(void *arena, size_t size)
+            __attribute__ ((nonnull));
+
+SODIUM_EXPORT
+void sodium_secret_arena_free(void *arena, void *ptr, size_t size)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int sodium_pad(size_t *padded_buflen_p, unsigned char *buf,
                size_t unpadded_buflen, size_t blocksize, size_t max_buflen)
             __attribute__ ((nonnull(2)));
 
+/*
+ * Same padding as sodium_pad(), for a buffer already sized to its padded
+ * length: padded_buflen must be a multiple of blocksize, and the message
+ * must end in its last block.
+ */
+SODIUM_EXPORT
+int sodium_pad_inplace(unsigned char *buf, size_t unpadded_buflen,
+                       size_t padded_buflen, size_t blocksize)
+            __attribute__ ((nonnull));
+
 SODIUM_EXPORT
 int sodium_unpad(size_t *unpadded_buflen_p, const unsigned char *buf,
                  size_t padded_buflen, size_t blocksize)
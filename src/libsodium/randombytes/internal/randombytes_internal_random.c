@@ -48,11 +48,20 @@
 # pragma GCC target("rdrnd")
 # include <immintrin.h>
 #endif
+#ifdef HAVE_RDSEED
+# pragma GCC target("rdseed")
+# include <immintrin.h>
+#endif
+#if defined(__aarch64__) && defined(HAVE_INLINE_ASM)
+# define HAVE_RNDR
+#endif
 
 #include "core.h"
 #include "crypto_core_hchacha20.h"
+#include "crypto_stream_chacha12.h"
 #include "crypto_stream_chacha20.h"
 #include "private/common.h"
+#include "private/mutex.h"
 #include "randombytes.h"
 #include "randombytes_internal_random.h"
 #include "runtime.h"
@@ -73,7 +82,10 @@ BOOLEAN NTAPI RtlGenRandom(PVOID RandomBuffer, ULONG RandomBufferLength);
 # endif
 #endif
 
-#define INTERNAL_RANDOM_BLOCK_SIZE crypto_core_hchacha20_OUTPUTBYTES
+#define INTERNAL_RANDOM_BLOCK_SIZE     crypto_core_hchacha20_OUTPUTBYTES
+#define INTERNAL_RANDOM_POOL_SIZE      (64U * INTERNAL_RANDOM_BLOCK_SIZE)
+#define INTERNAL_RANDOM_BUF_POOLED_MAX 256U
+#define INTERNAL_RANDOM_HWRAND_RETRIES 100U
 
 #if defined(__OpenBSD__) || defined(__CloudABI__) || defined(__wasi__)
 # define HAVE_SAFE_ARC4RANDOM 1
@@ -93,20 +105,63 @@ BOOLEAN NTAPI RtlGenRandom(PVOID RandomBuffer, ULONG RandomBufferLength);
 # endif
 #endif
 
+/*
+ * The generator state is always per-thread: thread-local storage if the
+ * compiler has it, or a pthread key otherwise. Threads never share a state.
+ */
 #ifndef TLS
 # ifdef _WIN32
 #  define TLS __declspec(thread)
+# elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+    !defined(__STDC_NO_THREADS__)
+#  define TLS _Thread_local
+# elif defined(HAVE_PTHREAD)
+#  include <pthread.h>
+#  define INTERNAL_RANDOM_THREAD_KEY
 # else
 #  define TLS
 # endif
 #endif
 
+/*
+ * A child process must not reuse the state of its parent. When fork() runs
+ * pthread_atfork() handlers, the one registered here wipes the state of the
+ * only thread left in the child, so that it is reseeded on its next use.
+ *
+ * Processes created without running these handlers, such as with a raw
+ * clone() system call, are caught by a page advised with MADV_WIPEONFORK:
+ * the kernel zeroes it in every child that doesn't share the address space,
+ * and the generator is wiped and reseeded when it is found cleared. Where
+ * that is not available, the pid at the time of seeding is compared with
+ * the current one, and a mismatch aborts.
+ */
+#if !defined(_WIN32) && defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+# include <pthread.h>
+# define INTERNAL_RANDOM_ATFORK
+#endif
+#if defined(__linux__) && defined(HAVE_MMAP) && defined(HAVE_MADVISE) && \
+    defined(HAVE_GETPID)
+# include <sys/mman.h>
+# ifdef MADV_WIPEONFORK
+#  define INTERNAL_RANDOM_WIPEONFORK
+# endif
+#endif
+
 typedef struct InternalRandomGlobal_ {
     int           initialized;
     int           random_data_source_fd;
     int           getentropy_available;
     int           getrandom_available;
     int           rdrand_available;
+    int           rdseed_available;
+    int           rndr_available;
+    int           reseed_mode;
+    int           reseed_interval;
+    int           reseed_generation;
+#ifdef INTERNAL_RANDOM_ATFORK
+    int           atfork_registered;
+#endif
 #ifdef HAVE_GETPID
     pid_t         pid;
 #endif
@@ -114,22 +169,239 @@ typedef struct InternalRandomGlobal_ {
 
 typedef struct InternalRandom_ {
     int           initialized;
+    int           reseed_generation;
+    int           refills;
     size_t        rnd32_outleft;
     unsigned char key[crypto_stream_chacha20_KEYBYTES];
-    unsigned char rnd32[16U * INTERNAL_RANDOM_BLOCK_SIZE];
+    unsigned char rnd32[INTERNAL_RANDOM_POOL_SIZE];
     uint64_t      nonce;
 } InternalRandom;
 
+typedef struct InternalRandomCipher_ {
+    int (*keystream)(unsigned char *c, unsigned long long clen,
+                     const unsigned char *n, const unsigned char *k);
+    int (*keystream_xor)(unsigned char *c, const unsigned char *m,
+                         unsigned long long mlen, const unsigned char *n,
+                         const unsigned char *k);
+} InternalRandomCipher;
+
+static const InternalRandomCipher cipher_chacha20 = {
+    SODIUM_C99(.keystream =) crypto_stream_chacha20,
+    SODIUM_C99(.keystream_xor =) crypto_stream_chacha20_xor
+};
+
+static const InternalRandomCipher cipher_chacha12 = {
+    SODIUM_C99(.keystream =) crypto_stream_chacha12,
+    SODIUM_C99(.keystream_xor =) crypto_stream_chacha12_xor
+};
+
 static InternalRandomGlobal global = {
     SODIUM_C99(.initialized =) 0,
     SODIUM_C99(.random_data_source_fd =) -1
 };
 
+#ifdef INTERNAL_RANDOM_THREAD_KEY
+static pthread_key_t  stream_key;
+static pthread_once_t stream_key_once = PTHREAD_ONCE_INIT;
+
+static void
+randombytes_internal_random_stream_free(void *stream_)
+{
+    sodium_memzero(stream_, sizeof(InternalRandom));
+    free(stream_);
+}
+
+static void
+randombytes_internal_random_stream_key_create(void)
+{
+    if (pthread_key_create(&stream_key,
+                           randombytes_internal_random_stream_free) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+}
+
+static InternalRandom *
+randombytes_internal_random_stream(void)
+{
+    InternalRandom *stream_;
+
+    if (pthread_once(&stream_key_once,
+                     randombytes_internal_random_stream_key_create) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    if ((stream_ = (InternalRandom *) pthread_getspecific(stream_key)) == NULL) {
+        if ((stream_ = (InternalRandom *) calloc(1U, sizeof *stream_)) == NULL ||
+            pthread_setspecific(stream_key, stream_) != 0) {
+            sodium_misuse(); /* LCOV_EXCL_LINE */
+        }
+    }
+    return stream_;
+}
+
+# define stream (*randombytes_internal_random_stream())
+#else
 static TLS InternalRandom stream = {
     SODIUM_C99(.initialized =) 0,
     SODIUM_C99(.rnd32_outleft =) (size_t) 0U
 };
+#endif
+
+/*
+ * randombytes_percpu_implementation keeps a generator per CPU instead of
+ * per thread, on Linux. A thread uses the one of the CPU it is running on,
+ * from sched_getcpu(), which glibc reads from the rseq area without a
+ * system call. Each generator has a spinlock, only contended if the
+ * thread is preempted or migrated while it holds it; other generators are
+ * then tried. Elsewhere, it is the same as randombytes_internal.
+ */
+#if defined(__linux__) && defined(HAVE_SCHED_GETCPU) && \
+    defined(INTERNAL_RANDOM_ATFORK) && defined(__ATOMIC_ACQUIRE)
+# include <sched.h>
+# define INTERNAL_RANDOM_PERCPU
+#endif
+
+#define INTERNAL_RANDOM_PERCPU_SLOTS_MAX 4096L
+
+#ifdef INTERNAL_RANDOM_PERCPU
+typedef struct InternalRandomSlot_ {
+    InternalRandom state;
+    int            locked;
+    unsigned char  pad[64U - sizeof(int)]; /* not on a line of the next state */
+} InternalRandomSlot;
+
+static InternalRandomSlot *percpu_slots;
+static size_t              percpu_slots_count;
+static pthread_once_t      percpu_slots_once = PTHREAD_ONCE_INIT;
+
+static void
+randombytes_percpu_slots_create(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_CONF);
+
+    if (count < 1L) {
+        count = 1L; /* LCOV_EXCL_LINE */
+    } else if (count > INTERNAL_RANDOM_PERCPU_SLOTS_MAX) {
+        count = INTERNAL_RANDOM_PERCPU_SLOTS_MAX; /* LCOV_EXCL_LINE */
+    }
+    if ((percpu_slots = (InternalRandomSlot *)
+         calloc((size_t) count, sizeof *percpu_slots)) == NULL) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    percpu_slots_count = (size_t) count;
+}
+
+static InternalRandomSlot *
+randombytes_percpu_acquire(void)
+{
+    InternalRandomSlot *slot;
+    size_t              i;
+    size_t              tries;
+    int                 cpu;
+
+    if (pthread_once(&percpu_slots_once,
+                     randombytes_percpu_slots_create) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    if ((cpu = sched_getcpu()) < 0) {
+        cpu = 0; /* LCOV_EXCL_LINE */
+    }
+    i = (size_t) cpu;
+    if (i >= percpu_slots_count) {
+        i %= percpu_slots_count; /* LCOV_EXCL_LINE */
+    }
+    for (tries = 1U;; tries++) {
+        slot = &percpu_slots[i];
+        if (__atomic_load_n(&slot->locked, __ATOMIC_RELAXED) == 0 &&
+            __atomic_exchange_n(&slot->locked, 1, __ATOMIC_ACQUIRE) == 0) {
+            return slot;
+        }
+        /* LCOV_EXCL_START */
+        if (++i == percpu_slots_count) {
+            i = 0U;
+        }
+        if (tries % percpu_slots_count == 0U) {
+            (void) sched_yield();
+        }
+        /* LCOV_EXCL_STOP */
+    }
+}
+
+static void
+randombytes_percpu_lock(InternalRandomSlot *slot)
+{
+    while (__atomic_exchange_n(&slot->locked, 1, __ATOMIC_ACQUIRE) != 0) {
+        (void) sched_yield(); /* LCOV_EXCL_LINE */
+    }
+}
+
+static void
+randombytes_percpu_release(InternalRandomSlot *slot)
+{
+    __atomic_store_n(&slot->locked, 0, __ATOMIC_RELEASE);
+}
+#endif
+
+#ifdef INTERNAL_RANDOM_WIPEONFORK
+/*
+ * Set to 1 once the generator has been seeded, cleared by the kernel in a
+ * child process. Points to fork_sentinel_unsupported, which is never set,
+ * if the page couldn't be allocated or the kernel doesn't support
+ * MADV_WIPEONFORK.
+ */
+static volatile unsigned char  fork_sentinel_unsupported;
+static volatile unsigned char *fork_sentinel;
+
+static void
+randombytes_internal_random_fork_sentinel_init(void)
+{
+    void *page;
+    long  page_size;
+
+    fork_sentinel = &fork_sentinel_unsupported;
+    if ((page_size = sysconf(_SC_PAGESIZE)) <= 0L) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    page = mmap(NULL, (size_t) page_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    if (madvise(page, (size_t) page_size, MADV_WIPEONFORK) != 0) {
+        (void) munmap(page, (size_t) page_size); /* LCOV_EXCL_LINE */
+        return; /* LCOV_EXCL_LINE */
+    }
+    fork_sentinel = (volatile unsigned char *) page;
+    *fork_sentinel = 1U;
+}
+#endif
+
+#ifdef INTERNAL_RANDOM_ATFORK
+static void
+randombytes_internal_random_atfork_child(void)
+{
+# ifdef INTERNAL_RANDOM_THREAD_KEY
+    void *stream_;
 
+    if ((stream_ = pthread_getspecific(stream_key)) != NULL) {
+        sodium_memzero(stream_, sizeof(InternalRandom));
+    }
+# else
+    sodium_memzero(&stream, sizeof stream);
+# endif
+# ifdef INTERNAL_RANDOM_PERCPU
+    /* the locks of generators used by other threads are released too */
+    if (percpu_slots != NULL) {
+        sodium_memzero(percpu_slots,
+                       percpu_slots_count * sizeof *percpu_slots);
+    }
+# endif
+# ifdef INTERNAL_RANDOM_WIPEONFORK
+    if (fork_sentinel != &fork_sentinel_unsupported) {
+        *fork_sentinel = 1U;
+    }
+# endif
+}
+#endif
 
 /*
  * Get a high-resolution timestamp, as a uint64_t value
@@ -171,6 +443,8 @@ static void
 randombytes_internal_random_init(void)
 {
     global.rdrand_available = sodium_runtime_has_rdrand();
+    global.rdseed_available = sodium_runtime_has_rdseed();
+    global.rndr_available = sodium_runtime_has_rndr();
 }
 
 #else /* _WIN32 */
@@ -351,6 +625,8 @@ randombytes_internal_random_init(void)
     const int errno_save = errno;
 
     global.rdrand_available = sodium_runtime_has_rdrand();
+    global.rdseed_available = sodium_runtime_has_rdseed();
+    global.rndr_available = sodium_runtime_has_rndr();
     global.getentropy_available = 0;
     global.getrandom_available = 0;
 
@@ -398,40 +674,58 @@ randombytes_internal_random_init(void)
  */
 
 static void
-randombytes_internal_random_stir(void)
+randombytes_internal_random_stir_stream(InternalRandom *st)
 {
-    stream.nonce = sodium_hrtime();
-    assert(stream.nonce != (uint64_t) 0U);
-    memset(stream.rnd32, 0, sizeof stream.rnd32);
-    stream.rnd32_outleft = (size_t) 0U;
+    st->nonce = sodium_hrtime();
+    assert(st->nonce != (uint64_t) 0U);
+    memset(st->rnd32, 0, sizeof st->rnd32);
+    st->rnd32_outleft = (size_t) 0U;
     if (global.initialized == 0) {
         randombytes_internal_random_init();
         global.initialized = 1;
     }
-#ifdef HAVE_GETPID
+#ifdef INTERNAL_RANDOM_WIPEONFORK
+    if (fork_sentinel == NULL) {
+        randombytes_internal_random_fork_sentinel_init();
+    }
+    if (fork_sentinel == &fork_sentinel_unsupported) {
+        global.pid = getpid();
+    }
+#elif defined(HAVE_GETPID)
     global.pid = getpid();
 #endif
+#ifdef INTERNAL_RANDOM_ATFORK
+    if (global.atfork_registered == 0) {
+        if (pthread_atfork(NULL, NULL,
+                           randombytes_internal_random_atfork_child) != 0) {
+            sodium_misuse(); /* LCOV_EXCL_LINE */
+        }
+        global.atfork_registered = 1;
+    }
+#endif
+    st->reseed_generation = sodium_load_acquire(&global.reseed_generation);
+    st->refills = 0;
 
 #ifndef _WIN32
 
 # ifdef HAVE_GETENTROPY
      if (global.getentropy_available != 0) {
-         if (randombytes_getentropy(stream.key, sizeof stream.key) != 0) {
+         if (randombytes_getentropy(st->key, sizeof st->key) != 0) {
              sodium_misuse(); /* LCOV_EXCL_LINE */
          }
      }
 # elif defined(HAVE_LINUX_COMPATIBLE_GETRANDOM)
      if (global.getrandom_available != 0) {
-         if (randombytes_linux_getrandom(stream.key, sizeof stream.key) != 0) {
+         if (randombytes_linux_getrandom(st->key, sizeof st->key) != 0) {
              sodium_misuse(); /* LCOV_EXCL_LINE */
          }
      }
 # elif defined(NONEXISTENT_DEV_RANDOM) && defined(HAVE_SAFE_ARC4RANDOM)
-    arc4random_buf(stream.key, sizeof stream.key);
+    arc4random_buf(st->key, sizeof st->key);
 # elif !defined(NONEXISTENT_DEV_RANDOM)
     if (global.random_data_source_fd == -1 ||
-        safe_read(global.random_data_source_fd, stream.key,
-                  sizeof stream.key) != (ssize_t) sizeof stream.key) {
+        safe_read(global.random_data_source_fd, st->key,
+                  sizeof st->key) != (ssize_t) sizeof st->key) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
 # else
@@ -439,30 +733,62 @@ randombytes_internal_random_stir(void)
 # endif
 
 #else /* _WIN32 */
-    if (! RtlGenRandom((PVOID) stream.key, (ULONG) sizeof stream.key)) {
+    if (! RtlGenRandom((PVOID) st->key, (ULONG) sizeof st->key)) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
 #endif
 
-    stream.initialized = 1;
+    st->initialized = 1;
+}
+
+static void
+randombytes_internal_random_stir(void)
+{
+    randombytes_internal_random_stir_stream(&stream);
 }
 
 /*
  * Reseed the generator if it hasn't been initialized yet
  */
 
+#ifdef INTERNAL_RANDOM_WIPEONFORK
 static void
-randombytes_internal_random_stir_if_needed(void)
+randombytes_internal_random_forked(InternalRandom *st)
 {
-#ifdef HAVE_GETPID
-    if (stream.initialized == 0) {
-        randombytes_internal_random_stir();
+    if (fork_sentinel == &fork_sentinel_unsupported) {
+        if (global.pid != getpid()) {
+            sodium_misuse(); /* LCOV_EXCL_LINE */
+        }
+        return;
+    }
+# ifdef INTERNAL_RANDOM_ATFORK
+    randombytes_internal_random_atfork_child();
+# else
+    *fork_sentinel = 1U;
+# endif
+    sodium_memzero(st, sizeof *st);
+    randombytes_internal_random_stir_stream(st);
+}
+#endif
+
+static void
+randombytes_internal_random_stir_if_needed(InternalRandom *st)
+{
+#ifdef INTERNAL_RANDOM_WIPEONFORK
+    if (st->initialized == 0) {
+        randombytes_internal_random_stir_stream(st);
+    } else if (*fork_sentinel == 0U) {
+        randombytes_internal_random_forked(st);
+    }
+#elif defined(HAVE_GETPID)
+    if (st->initialized == 0) {
+        randombytes_internal_random_stir_stream(st);
     } else if (global.pid != getpid()) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
 #else
-    if (stream.initialized == 0) {
-        randombytes_internal_random_stir();
+    if (st->initialized == 0) {
+        randombytes_internal_random_stir_stream(st);
     }
 #endif
 }
@@ -524,7 +850,7 @@ randombytes_internal_random_close(void)
  */
 
 static void
-randombytes_internal_random_xorhwrand(void)
+randombytes_internal_random_xorhwrand(InternalRandom *st)
 {
 /* LCOV_EXCL_START */
 #ifdef HAVE_RDRAND
@@ -535,7 +861,7 @@ randombytes_internal_random_xorhwrand(void)
     }
     (void) _rdrand32_step(&r);
     * (uint32_t *) (void *)
-        &stream.key[crypto_stream_chacha20_KEYBYTES - 4] ^= (uint32_t) r;
+        &st->key[crypto_stream_chacha20_KEYBYTES - 4] ^= (uint32_t) r;
 #endif
 /* LCOV_EXCL_STOP */
 }
@@ -545,44 +871,221 @@ randombytes_internal_random_xorhwrand(void)
  */
 
 static inline void
-randombytes_internal_random_xorkey(const unsigned char * const mix)
+randombytes_internal_random_xorkey(InternalRandom *st,
+                                  const unsigned char * const mix)
 {
-    unsigned char *key = stream.key;
+    unsigned char *key = st->key;
     size_t         i;
 
-    for (i = (size_t) 0U; i < sizeof stream.key; i++) {
+    for (i = (size_t) 0U; i < sizeof st->key; i++) {
         key[i] ^= mix[i];
     }
 }
 
+/*
+ * Bulk entropy from RDSEED, RDRAND or RNDR, in that order of preference
+ */
+
+#ifdef HAVE_RNDR
+static int
+_rndr64_step(uint64_t *r)
+{
+    uint64_t     v;
+    unsigned int ok;
+
+    __asm__ __volatile__("mrs %0, s3_3_c2_c4_0\n\t"
+                         "cset %w1, ne"
+                         : "=r"(v), "=r"(ok) : : "cc");
+    *r = v;
+
+    return (int) ok;
+}
+#endif
+
+/* LCOV_EXCL_START */
+static int
+randombytes_internal_random_hwrand_step(uint32_t *r)
+{
+#ifdef HAVE_RDSEED
+    unsigned int v32;
+
+    if (global.rdseed_available != 0 && _rdseed32_step(&v32) != 0) {
+        *r = (uint32_t) v32;
+        return 1;
+    }
+#endif
+#ifdef HAVE_RDRAND
+    {
+        unsigned int v;
+
+        if (global.rdrand_available != 0 && _rdrand32_step(&v) != 0) {
+            *r = (uint32_t) v;
+            return 1;
+        }
+    }
+#endif
+#ifdef HAVE_RNDR
+    {
+        uint64_t v64;
+
+        if (global.rndr_available != 0 && _rndr64_step(&v64) != 0) {
+            *r = (uint32_t) v64;
+            return 1;
+        }
+    }
+#endif
+    (void) r;
+
+    return 0;
+}
+/* LCOV_EXCL_STOP */
+
+static int
+randombytes_internal_random_hwrand_buf(unsigned char *buf, size_t size)
+{
+    uint32_t     r = 0U;
+    size_t       i;
+    unsigned int tries;
+
+    for (i = (size_t) 0U; i < size; i += sizeof r) {
+        tries = 0U;
+        while (randombytes_internal_random_hwrand_step(&r) == 0) {
+            if (++tries >= INTERNAL_RANDOM_HWRAND_RETRIES) {
+                return -1;
+            }
+        }
+        memcpy(&buf[i], &r, size - i < sizeof r ? size - i : sizeof r);
+    }
+    sodium_memzero(&r, sizeof r);
+
+    return 0;
+}
+
+/*
+ * Rekey the generator and discard the pool, with hardware entropy mixed
+ * into the key when that mode is set, or a new key from the OS otherwise
+ * and if the hardware doesn't deliver.
+ */
+
+static void
+randombytes_internal_random_reseed(InternalRandom *st)
+{
+    unsigned char mix[crypto_stream_chacha20_KEYBYTES];
+
+    if (sodium_load_acquire(&global.reseed_mode) !=
+        RANDOMBYTES_INTERNAL_RESEED_HWRAND ||
+        randombytes_internal_random_hwrand_buf(mix, sizeof mix) != 0) {
+        randombytes_internal_random_stir_stream(st);
+        return;
+    }
+    randombytes_internal_random_xorkey(st, mix);
+    sodium_memzero(mix, sizeof mix);
+    sodium_memzero(st->rnd32, sizeof st->rnd32);
+    st->rnd32_outleft = (size_t) 0U;
+    st->reseed_generation = sodium_load_acquire(&global.reseed_generation);
+    st->refills = 0;
+}
+
+static void
+randombytes_internal_random_reseed_if_needed(InternalRandom *st)
+{
+    const int interval = sodium_load_acquire(&global.reseed_interval);
+
+    if (st->reseed_generation !=
+        sodium_load_acquire(&global.reseed_generation) ||
+        (interval > 0 && ++st->refills >= interval)) {
+        randombytes_internal_random_reseed(st);
+    }
+}
+
+/*
+ * Refill the random pool, and overwrite the key with its last bytes
+ */
+
+static void
+randombytes_internal_random_refill(InternalRandom *st,
+                                   const InternalRandomCipher *cipher)
+{
+    int ret;
+
+    COMPILER_ASSERT(sizeof st->rnd32 >= (sizeof st->key) + sizeof(uint32_t));
+    COMPILER_ASSERT(((sizeof st->rnd32) - (sizeof st->key))
+                    % sizeof(uint32_t) == (size_t) 0U);
+    randombytes_internal_random_stir_if_needed(st);
+    randombytes_internal_random_reseed_if_needed(st);
+    COMPILER_ASSERT(sizeof st->nonce == crypto_stream_chacha20_NONCEBYTES);
+    COMPILER_ASSERT(sizeof st->nonce == crypto_stream_chacha12_NONCEBYTES);
+    COMPILER_ASSERT(sizeof st->key == crypto_stream_chacha12_KEYBYTES);
+    ret = cipher->keystream((unsigned char *) st->rnd32,
+                            (unsigned long long) sizeof st->rnd32,
+                            (unsigned char *) &st->nonce, st->key);
+    assert(ret == 0);
+    st->rnd32_outleft = (sizeof st->rnd32) - (sizeof st->key);
+    randombytes_internal_random_xorhwrand(st);
+    randombytes_internal_random_xorkey(st, &st->rnd32[st->rnd32_outleft]);
+    memset(&st->rnd32[st->rnd32_outleft], 0, sizeof st->key);
+    st->nonce++;
+}
+
 /*
  * Put `size` random bytes into `buf` and overwrite the key
+ *
+ * Small requests, such as keys and nonces, are served from the random pool,
+ * and the bytes they consumed are erased from it.
  */
 
 static void
-randombytes_internal_random_buf(void * const buf, const size_t size)
+randombytes_internal_random_buf_with(InternalRandom *st,
+                                     const InternalRandomCipher *cipher,
+                                     void * const buf, const size_t size)
 {
     size_t i;
     int    ret;
 
-    randombytes_internal_random_stir_if_needed();
-    COMPILER_ASSERT(sizeof stream.nonce == crypto_stream_chacha20_NONCEBYTES);
+    randombytes_internal_random_stir_if_needed(st);
+    COMPILER_ASSERT(INTERNAL_RANDOM_BUF_POOLED_MAX <=
+                    INTERNAL_RANDOM_POOL_SIZE - crypto_stream_chacha20_KEYBYTES);
+    if (size <= INTERNAL_RANDOM_BUF_POOLED_MAX) {
+        if (st->rnd32_outleft < size) {
+            randombytes_internal_random_refill(st, cipher);
+        }
+        st->rnd32_outleft -= size;
+        memcpy(buf, &st->rnd32[st->rnd32_outleft], size);
+        sodium_memzero(&st->rnd32[st->rnd32_outleft], size);
+        return;
+    }
+    randombytes_internal_random_reseed_if_needed(st);
+    COMPILER_ASSERT(sizeof st->nonce == crypto_stream_chacha20_NONCEBYTES);
 #if defined(ULLONG_MAX) && defined(SIZE_MAX)
 # if SIZE_MAX > ULLONG_MAX
     /* coverity[result_independent_of_operands] */
     assert(size <= ULLONG_MAX);
 # endif
 #endif
-    ret = crypto_stream_chacha20((unsigned char *) buf, (unsigned long long) size,
-                                 (unsigned char *) &stream.nonce, stream.key);
+    ret = cipher->keystream((unsigned char *) buf, (unsigned long long) size,
+                            (unsigned char *) &st->nonce, st->key);
     assert(ret == 0);
     for (i = 0U; i < sizeof size; i++) {
-        stream.key[i] ^= ((const unsigned char *) (const void *) &size)[i];
+        st->key[i] ^= ((const unsigned char *) (const void *) &size)[i];
     }
-    randombytes_internal_random_xorhwrand();
-    stream.nonce++;
-    crypto_stream_chacha20_xor(stream.key, stream.key, sizeof stream.key,
-                               (unsigned char *) &stream.nonce, stream.key);
+    randombytes_internal_random_xorhwrand(st);
+    st->nonce++;
+    cipher->keystream_xor(st->key, st->key, sizeof st->key,
+                          (unsigned char *) &st->nonce, st->key);
+}
+
+static void
+randombytes_internal_random_buf(void * const buf, const size_t size)
+{
+    randombytes_internal_random_buf_with(&stream, &cipher_chacha20, buf,
+                                         size);
+}
+
+static void
+randombytes_chacha12_random_buf(void * const buf, const size_t size)
+{
+    randombytes_internal_random_buf_with(&stream, &cipher_chacha12, buf,
+                                         size);
 }
 
 /*
@@ -592,33 +1095,143 @@ randombytes_internal_random_buf(void * const buf, const size_t size)
  */
 
 static uint32_t
-randombytes_internal_random(void)
+randombytes_internal_random_with(InternalRandom *st,
+                                 const InternalRandomCipher *cipher)
 {
     uint32_t val;
-    int      ret;
-
-    COMPILER_ASSERT(sizeof stream.rnd32 >= (sizeof stream.key) + (sizeof val));
-    COMPILER_ASSERT(((sizeof stream.rnd32) - (sizeof stream.key))
-                    % sizeof val == (size_t) 0U);
-    if (stream.rnd32_outleft <= (size_t) 0U) {
-        randombytes_internal_random_stir_if_needed();
-        COMPILER_ASSERT(sizeof stream.nonce == crypto_stream_chacha20_NONCEBYTES);
-        ret = crypto_stream_chacha20((unsigned char *) stream.rnd32,
-                                     (unsigned long long) sizeof stream.rnd32,
-                                     (unsigned char *) &stream.nonce,
-                                     stream.key);
-        assert(ret == 0);
-        stream.rnd32_outleft = (sizeof stream.rnd32) - (sizeof stream.key);
-        randombytes_internal_random_xorhwrand();
-        randombytes_internal_random_xorkey(&stream.rnd32[stream.rnd32_outleft]);
-        memset(&stream.rnd32[stream.rnd32_outleft], 0, sizeof stream.key);
-        stream.nonce++;
-    }
-    stream.rnd32_outleft -= sizeof val;
-    memcpy(&val, &stream.rnd32[stream.rnd32_outleft], sizeof val);
-    memset(&stream.rnd32[stream.rnd32_outleft], 0, sizeof val);
+
+    if (st->rnd32_outleft < sizeof val) {
+        randombytes_internal_random_refill(st, cipher);
+    }
+    st->rnd32_outleft -= sizeof val;
+    memcpy(&val, &st->rnd32[st->rnd32_outleft], sizeof val);
+    memset(&st->rnd32[st->rnd32_outleft], 0, sizeof val);
+
+    return val;
+}
+
+static uint32_t
+randombytes_internal_random(void)
+{
+    return randombytes_internal_random_with(&stream, &cipher_chacha20);
+}
+
+static uint32_t
+randombytes_chacha12_random(void)
+{
+    return randombytes_internal_random_with(&stream, &cipher_chacha12);
+}
+
+static uint32_t
+randombytes_percpu_random(void)
+{
+#ifdef INTERNAL_RANDOM_PERCPU
+    InternalRandomSlot *slot = randombytes_percpu_acquire();
+    uint32_t            val;
+
+    val = randombytes_internal_random_with(&slot->state, &cipher_chacha20);
+    randombytes_percpu_release(slot);
 
     return val;
+#else
+    return randombytes_internal_random();
+#endif
+}
+
+static void
+randombytes_percpu_random_buf(void * const buf, const size_t size)
+{
+#ifdef INTERNAL_RANDOM_PERCPU
+    InternalRandomSlot *slot = randombytes_percpu_acquire();
+
+    randombytes_internal_random_buf_with(&slot->state, &cipher_chacha20, buf,
+                                         size);
+    randombytes_percpu_release(slot);
+#else
+    randombytes_internal_random_buf(buf, size);
+#endif
+}
+
+static void
+randombytes_percpu_random_stir(void)
+{
+#ifdef INTERNAL_RANDOM_PERCPU
+    InternalRandomSlot *slot = randombytes_percpu_acquire();
+
+    randombytes_internal_random_stir_stream(&slot->state);
+    randombytes_percpu_release(slot);
+#else
+    randombytes_internal_random_stir();
+#endif
+}
+
+static int
+randombytes_percpu_random_close(void)
+{
+#ifdef INTERNAL_RANDOM_PERCPU
+    InternalRandomSlot *slot;
+    size_t              i;
+
+    for (i = 0U; percpu_slots != NULL && i < percpu_slots_count; i++) {
+        slot = &percpu_slots[i];
+        randombytes_percpu_lock(slot);
+        sodium_memzero(&slot->state, sizeof slot->state);
+        randombytes_percpu_release(slot);
+    }
+#endif
+    return randombytes_internal_random_close();
+}
+
+int
+randombytes_internal_set_reseed(int mode, unsigned int interval)
+{
+    if ((mode != RANDOMBYTES_INTERNAL_RESEED_OS &&
+         mode != RANDOMBYTES_INTERNAL_RESEED_HWRAND) || interval > INT_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (mode == RANDOMBYTES_INTERNAL_RESEED_HWRAND &&
+        sodium_runtime_has_rdseed() == 0 && sodium_runtime_has_rdrand() == 0 &&
+        sodium_runtime_has_rndr() == 0) {
+        errno = ENOSYS;
+        return -1;
+    }
+    sodium_store_release(&global.reseed_mode, mode);
+    sodium_store_release(&global.reseed_interval, (int) interval);
+
+    return 0;
+}
+
+int
+randombytes_internal_reseed(void)
+{
+    if (sodium_crit_enter() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    sodium_store_release(&global.reseed_generation,
+                         sodium_load_acquire(&global.reseed_generation) + 1);
+    if (sodium_crit_leave() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (stream.initialized != 0) {
+        randombytes_internal_random_reseed(&stream);
+    }
+#ifdef INTERNAL_RANDOM_PERCPU
+    {
+        InternalRandomSlot *slot;
+        size_t              i;
+
+        for (i = 0U; percpu_slots != NULL && i < percpu_slots_count; i++) {
+            slot = &percpu_slots[i];
+            randombytes_percpu_lock(slot);
+            if (slot->state.initialized != 0) {
+                randombytes_internal_random_reseed(&slot->state);
+            }
+            randombytes_percpu_release(slot);
+        }
+    }
+#endif
+    return 0;
 }
 
 static const char *
@@ -627,6 +1240,18 @@ randombytes_internal_implementation_name(void)
     return "internal";
 }
 
+static const char *
+randombytes_chacha12_implementation_name(void)
+{
+    return "chacha12";
+}
+
+static const char *
+randombytes_percpu_implementation_name(void)
+{
+    return "percpu";
+}
+
 struct randombytes_implementation randombytes_internal_implementation = {
     SODIUM_C99(.implementation_name =) randombytes_internal_implementation_name,
     SODIUM_C99(.random =) randombytes_internal_random,
@@ -635,3 +1260,21 @@ struct randombytes_implementation randombytes_internal_implementation = {
     SODIUM_C99(.buf =) randombytes_internal_random_buf,
     SODIUM_C99(.close =) randombytes_internal_random_close
 };
+
+struct randombytes_implementation randombytes_chacha12_implementation = {
+    SODIUM_C99(.implementation_name =) randombytes_chacha12_implementation_name,
+    SODIUM_C99(.random =) randombytes_chacha12_random,
+    SODIUM_C99(.stir =) randombytes_internal_random_stir,
+    SODIUM_C99(.uniform =) NULL,
+    SODIUM_C99(.buf =) randombytes_chacha12_random_buf,
+    SODIUM_C99(.close =) randombytes_internal_random_close
+};
+
+struct randombytes_implementation randombytes_percpu_implementation = {
+    SODIUM_C99(.implementation_name =) randombytes_percpu_implementation_name,
+    SODIUM_C99(.random =) randombytes_percpu_random,
+    SODIUM_C99(.stir =) randombytes_percpu_random_stir,
+    SODIUM_C99(.uniform =) NULL,
+    SODIUM_C99(.buf =) randombytes_percpu_random_buf,
+    SODIUM_C99(.close =) randombytes_percpu_random_close
+};
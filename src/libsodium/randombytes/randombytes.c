@@ -3,6 +3,7 @@
 #include <limits.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sys/types.h>
 
@@ -19,8 +20,12 @@
 # endif
 # include "randombytes_sysrandom.h"
 #endif
+#include "utils.h"
+#include "private/chacha20_ietf_ext.h"
 #include "private/common.h"
 
+#define UNIFORM_MANY_BATCH 256U
+
 /* C++Builder defines a "random" macro */
 #undef random
 
@@ -164,6 +169,94 @@ randombytes_uniform(const uint32_t upper_bound)
     return r % upper_bound;
 }
 
+/*
+ * Lemire's nearly divisionless method: the high half of r * upper_bound is
+ * uniform in [0, upper_bound) once the products whose low half is below
+ * 2**bits mod upper_bound are rejected. Random values are read in batches.
+ */
+
+void
+randombytes_uniform_many(uint32_t * const out, const size_t n,
+                         const uint32_t upper_bound)
+{
+    uint32_t pool[UNIFORM_MANY_BATCH];
+    uint64_t m;
+    uint32_t threshold;
+    size_t   available = 0U;
+    size_t   i = 0U;
+    size_t   j = 0U;
+
+    randombytes_init_if_needed();
+    if (implementation->uniform != NULL) {
+        for (i = 0U; i < n; i++) {
+            out[i] = implementation->uniform(upper_bound);
+        }
+        return;
+    }
+    if (upper_bound < 2U) {
+        memset(out, 0, n * sizeof out[0]);
+        return;
+    }
+    threshold = (1U + ~upper_bound) % upper_bound; /* = 2**32 mod upper_bound */
+    while (i < n) {
+        if (j >= available) {
+            available = n - i < UNIFORM_MANY_BATCH ? n - i : UNIFORM_MANY_BATCH;
+            implementation->buf(pool, available * sizeof pool[0]);
+            j = 0U;
+        }
+        m = (uint64_t) pool[j++] * upper_bound;
+        if ((uint32_t) m >= threshold) {
+            out[i++] = (uint32_t) (m >> 32);
+        }
+    }
+    sodium_memzero(pool, sizeof pool);
+}
+
+static inline uint64_t
+mul64_hilo(const uint64_t a, const uint64_t b, uint64_t * const lo)
+{
+    const uint64_t a_lo = a & 0xffffffffU, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xffffffffU, b_hi = b >> 32;
+    const uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi;
+    const uint64_t hl = a_hi * b_lo, hh = a_hi * b_hi;
+    const uint64_t mid = (ll >> 32) + (lh & 0xffffffffU) + (hl & 0xffffffffU);
+
+    *lo = (mid << 32) | (ll & 0xffffffffU);
+
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+void
+randombytes_uniform64_many(uint64_t * const out, const size_t n,
+                           const uint64_t upper_bound)
+{
+    uint64_t pool[UNIFORM_MANY_BATCH];
+    uint64_t hi, lo;
+    uint64_t threshold;
+    size_t   available = 0U;
+    size_t   i = 0U;
+    size_t   j = 0U;
+
+    randombytes_init_if_needed();
+    if (upper_bound < 2U) {
+        memset(out, 0, n * sizeof out[0]);
+        return;
+    }
+    threshold = (1U + ~upper_bound) % upper_bound; /* = 2**64 mod upper_bound */
+    while (i < n) {
+        if (j >= available) {
+            available = n - i < UNIFORM_MANY_BATCH ? n - i : UNIFORM_MANY_BATCH;
+            implementation->buf(pool, available * sizeof pool[0]);
+            j = 0U;
+        }
+        hi = mul64_hilo(pool[j++], upper_bound, &lo);
+        if (lo >= threshold) {
+            out[i++] = hi;
+        }
+    }
+    sodium_memzero(pool, sizeof pool);
+}
+
 void
 randombytes_buf(void * const buf, const size_t size)
 {
@@ -173,14 +266,14 @@ randombytes_buf(void * const buf, const size_t size)
     }
 }
 
+static const unsigned char deterministic_nonce[crypto_stream_chacha20_ietf_NONCEBYTES] = {
+    'L', 'i', 'b', 's', 'o', 'd', 'i', 'u', 'm', 'D', 'R', 'G'
+};
+
 void
 randombytes_buf_deterministic(void * const buf, const size_t size,
                               const unsigned char seed[randombytes_SEEDBYTES])
 {
-    static const unsigned char nonce[crypto_stream_chacha20_ietf_NONCEBYTES] = {
-        'L', 'i', 'b', 's', 'o', 'd', 'i', 'u', 'm', 'D', 'R', 'G'
-    };
-
     COMPILER_ASSERT(randombytes_SEEDBYTES == crypto_stream_chacha20_ietf_KEYBYTES);
 #if SIZE_MAX > 0x4000000000ULL
     COMPILER_ASSERT(randombytes_BYTES_MAX <= 0x4000000000ULL);
@@ -189,7 +282,69 @@ randombytes_buf_deterministic(void * const buf, const size_t size,
     }
 #endif
     crypto_stream_chacha20_ietf((unsigned char *) buf, (unsigned long long) size,
-                                nonce, seed);
+                                deterministic_nonce, seed);
+}
+
+/*
+ * Up to 8 seeds are expanded together, one per lane of the multi-state
+ * ChaCha20 kernel. Lanes without a seed of their own repeat the first one.
+ */
+void
+randombytes_buf_deterministic_many(unsigned char * const *outs, const size_t size,
+                                   const unsigned char * const *seeds, const size_t n)
+{
+    CRYPTO_ALIGN(32) uint32_t      x[16][8];
+    CRYPTO_ALIGN(32) unsigned char ks[64U * 8U];
+    size_t                         i;
+    size_t                         j;
+    size_t                         l;
+    size_t                         s;
+    size_t                         off;
+    size_t                         len;
+
+#if SIZE_MAX > 0x4000000000ULL
+    if (size > 0x4000000000ULL) {
+        sodium_misuse();
+    }
+#endif
+    if (n <= 1U || crypto_stream_chacha20_has_blocks8() == 0) {
+        for (i = 0U; i < n; i++) {
+            randombytes_buf_deterministic(outs[i], size, seeds[i]);
+        }
+        return;
+    }
+    for (l = 0U; l < 8U; l++) {
+        x[0][l] = 0x61707865;
+        x[1][l] = 0x3320646e;
+        x[2][l] = 0x79622d32;
+        x[3][l] = 0x6b206574;
+        for (j = 0U; j < 3U; j++) {
+            x[13 + j][l] = LOAD32_LE(deterministic_nonce + 4U * j);
+        }
+    }
+    for (i = 0U; i < n; i += 8U) {
+        for (l = 0U; l < 8U; l++) {
+            s = i + (i + l < n ? l : 0U);
+            for (j = 0U; j < 8U; j++) {
+                x[4 + j][l] = LOAD32_LE(seeds[s] + 4U * j);
+            }
+        }
+        for (off = 0U; off < size; off += 64U) {
+            for (l = 0U; l < 8U; l++) {
+                x[12][l] = (uint32_t) (off / 64U);
+            }
+            crypto_stream_chacha20_blocks8(ks, (const uint32_t (*)[8]) x);
+            len = size - off;
+            if (len > 64U) {
+                len = 64U;
+            }
+            for (l = 0U; l < 8U && i + l < n; l++) {
+                memcpy(outs[i + l] + off, &ks[64U * l], len);
+            }
+        }
+    }
+    sodium_memzero(x, sizeof x);
+    sodium_memzero(ks, sizeof ks);
 }
 
 size_t
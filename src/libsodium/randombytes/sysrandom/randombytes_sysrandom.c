@@ -43,6 +43,16 @@
 #ifdef BLOCK_ON_DEV_RANDOM
 # include <poll.h>
 #endif
+#if defined(__linux__) && defined(HAVE_LINUX_COMPATIBLE_GETRANDOM) && \
+    defined(HAVE_SYS_AUXV_H) && defined(HAVE_SYS_MMAN_H) && \
+    defined(HAVE_PTHREAD) && !defined(__EMSCRIPTEN__)
+# include <elf.h>
+# include <link.h>
+# include <pthread.h>
+# include <sys/auxv.h>
+# include <sys/mman.h>
+# define HAVE_VDSO_GETRANDOM
+#endif
 
 #include "core.h"
 #include "private/common.h"
@@ -222,6 +232,169 @@ randombytes_sysrandom_random_dev_open(void)
 /* LCOV_EXCL_STOP */
 }
 
+#  ifdef HAVE_VDSO_GETRANDOM
+/*
+ * Linux 6.11+ exports getrandom() in the vDSO. It needs an opaque state per
+ * thread, allocated with the protection and flags returned by the vDSO
+ * itself. The kernel wipes these mappings on fork and invalidates them after
+ * a VM snapshot is restored, so that they are then transparently reseeded.
+ */
+
+typedef ssize_t (*vgetrandom_t)(void *buf, size_t size, unsigned int flags,
+                                void *opaque_state, size_t opaque_len);
+
+struct vgetrandom_opaque_params {
+    uint32_t size_of_opaque_state;
+    uint32_t mmap_prot;
+    uint32_t mmap_flags;
+    uint32_t reserved[13];
+};
+
+static struct {
+    vgetrandom_t  fn;
+    size_t        state_size;
+    size_t        alloc_size;
+    int           mmap_prot;
+    int           mmap_flags;
+    pthread_key_t state_key;
+} vdso;
+
+static pthread_once_t vdso_once = PTHREAD_ONCE_INIT;
+
+static void *
+randombytes_vdso_lookup(const char * const name)
+{
+    const ElfW(Ehdr) *ehdr;
+    const ElfW(Phdr) *phdr;
+    const ElfW(Dyn)  *dyn = NULL;
+    const ElfW(Sym)  *symtab = NULL;
+    const ElfW(Word) *hash = NULL;
+    const char       *strtab = NULL;
+    uintptr_t         base;
+    uintptr_t         load_offset = 0U;
+    int               have_load = 0;
+    size_t            i;
+
+    if ((base = (uintptr_t) getauxval(AT_SYSINFO_EHDR)) == 0U) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    ehdr = (const ElfW(Ehdr) *) base;
+    phdr = (const ElfW(Phdr) *) (base + ehdr->e_phoff);
+    for (i = 0U; i < (size_t) ehdr->e_phnum; i++) {
+        if (phdr[i].p_type == PT_LOAD && have_load == 0) {
+            load_offset = base + phdr[i].p_offset - phdr[i].p_vaddr;
+            have_load = 1;
+        } else if (phdr[i].p_type == PT_DYNAMIC) {
+            dyn = (const ElfW(Dyn) *) (base + phdr[i].p_offset);
+        }
+    }
+    if (have_load == 0 || dyn == NULL) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    for (; dyn->d_tag != DT_NULL; dyn++) {
+        switch (dyn->d_tag) {
+        case DT_SYMTAB:
+            symtab = (const ElfW(Sym) *) (load_offset + dyn->d_un.d_ptr);
+            break;
+        case DT_STRTAB:
+            strtab = (const char *) (load_offset + dyn->d_un.d_ptr);
+            break;
+        case DT_HASH:
+            hash = (const ElfW(Word) *) (load_offset + dyn->d_un.d_ptr);
+            break;
+        }
+    }
+    if (symtab == NULL || strtab == NULL || hash == NULL) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    /* the number of symbols is the number of entries in the hash chain */
+    for (i = 0U; i < (size_t) hash[1]; i++) {
+        if ((symtab[i].st_info & 0xf) != STT_FUNC ||
+            symtab[i].st_shndx == SHN_UNDEF) {
+            continue;
+        }
+        if (strcmp(strtab + symtab[i].st_name, name) == 0) {
+            return (void *) (load_offset + symtab[i].st_value);
+        }
+    }
+    return NULL;
+}
+
+static void
+randombytes_vdso_state_free(void *state)
+{
+    (void) munmap(state, vdso.alloc_size);
+}
+
+static void
+randombytes_vdso_init(void)
+{
+    struct vgetrandom_opaque_params params;
+    long                            page_size;
+    vgetrandom_t                    fn;
+
+    if ((fn = (vgetrandom_t) randombytes_vdso_lookup("__vdso_getrandom")) == NULL &&
+        (fn = (vgetrandom_t) randombytes_vdso_lookup("__kernel_getrandom")) == NULL) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    memset(&params, 0, sizeof params);
+    if (fn(NULL, 0U, 0U, &params, ~(size_t) 0U) != 0 ||
+        params.size_of_opaque_state == 0U ||
+        (page_size = sysconf(_SC_PAGESIZE)) <= 0L) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    vdso.state_size = (size_t) params.size_of_opaque_state;
+    vdso.alloc_size = (vdso.state_size + (size_t) page_size - 1U) &
+        ~((size_t) page_size - 1U);
+    vdso.mmap_prot  = (int) params.mmap_prot;
+    vdso.mmap_flags = (int) params.mmap_flags;
+    if (pthread_key_create(&vdso.state_key, randombytes_vdso_state_free) != 0) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    vdso.fn = fn;
+}
+
+/*
+ * Return 0 if `size` bytes were written using the vDSO, or -1 if the
+ * system call has to be used instead.
+ */
+static int
+randombytes_vdso_getrandom(void * const buf_, size_t size)
+{
+    unsigned char *buf = (unsigned char *) buf_;
+    void          *state;
+    ssize_t        readnb;
+
+    if (pthread_once(&vdso_once, randombytes_vdso_init) != 0 ||
+        vdso.fn == NULL) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if ((state = pthread_getspecific(vdso.state_key)) == NULL) {
+        state = mmap(NULL, vdso.alloc_size, vdso.mmap_prot, vdso.mmap_flags,
+                     -1, 0);
+        if (state == MAP_FAILED) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+        if (pthread_setspecific(vdso.state_key, state) != 0) {
+            (void) munmap(state, vdso.alloc_size); /* LCOV_EXCL_LINE */
+            return -1; /* LCOV_EXCL_LINE */
+        }
+    }
+    while (size > (size_t) 0U) {
+        readnb = vdso.fn(buf, size, 0U, state, vdso.state_size);
+        if (readnb < (ssize_t) 0) {
+            if (readnb == -EINTR || readnb == -EAGAIN) {
+                continue; /* LCOV_EXCL_LINE */
+            }
+            return -1; /* LCOV_EXCL_LINE */
+        }
+        size -= (size_t) readnb;
+        buf += readnb;
+    }
+    return 0;
+}
+#  endif /* HAVE_VDSO_GETRANDOM */
+
 #  ifdef HAVE_LINUX_COMPATIBLE_GETRANDOM
 static int
 _randombytes_linux_getrandom(void * const buf, const size_t size)
@@ -242,6 +415,11 @@ randombytes_linux_getrandom(void * const buf_, size_t size)
     unsigned char *buf = (unsigned char *) buf_;
     size_t         chunk_size = 256U;
 
+#   ifdef HAVE_VDSO_GETRANDOM
+    if (randombytes_vdso_getrandom(buf_, size) == 0) {
+        return 0;
+    }
+#   endif
     do {
         if (size < chunk_size) {
             chunk_size = size;
@@ -0,0 +1,57 @@
+#include <errno.h>
+#include <stdlib.h>
+
+#include "core.h"
+#include "private/allocator.h"
+#include "private/common.h"
+#include "private/mutex.h"
+
+static struct {
+    sodium_alloc_fn alloc;
+    sodium_free_fn  free;
+    void           *ctx;
+} allocators[2];
+
+int
+sodium_set_allocator(int kind, sodium_alloc_fn alloc, sodium_free_fn free_fn,
+                     void *ctx)
+{
+    if ((kind != SODIUM_ALLOC_SCRATCH && kind != SODIUM_ALLOC_SECRET) ||
+        (alloc == NULL) != (free_fn == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (sodium_crit_enter() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    allocators[kind].alloc = alloc;
+    allocators[kind].free  = free_fn;
+    allocators[kind].ctx   = alloc == NULL ? NULL : ctx;
+    if (sodium_crit_leave() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    return 0;
+}
+
+int
+_sodium_allocator_is_set(int kind)
+{
+    return allocators[kind].alloc != NULL;
+}
+
+void *
+_sodium_allocator_alloc(int kind, size_t size)
+{
+    void *ptr;
+
+    if ((ptr = allocators[kind].alloc(allocators[kind].ctx, size)) == NULL) {
+        errno = ENOMEM;
+    }
+    return ptr;
+}
+
+void
+_sodium_allocator_free(int kind, void *ptr, size_t size)
+{
+    allocators[kind].free(allocators[kind].ctx, ptr, size);
+}
@@ -6,9 +6,15 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "codecs.h"
 #include "core.h"
+#include "private/common.h"
+#include "private/implementations.h"
+#include "runtime.h"
 #include "utils.h"
 
+static const sodium_codecs_implementation *implementation;
+
 /* Derived from original code by CodesInChaos */
 char *
 sodium_bin2hex(char *const hex, const size_t hex_maxlen,
@@ -22,6 +28,9 @@ sodium_bin2hex(char *const hex, const size_t hex_maxlen,
     if (bin_len >= SIZE_MAX / 2 || hex_maxlen <= bin_len * 2U) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
+    if (implementation != NULL) {
+        i = implementation->bin2hex(hex, bin, bin_len);
+    }
     while (i < bin_len) {
         c = bin[i] & 0xf;
         b = bin[i] >> 4;
@@ -45,6 +54,8 @@ sodium_hex2bin(unsigned char *const bin, const size_t bin_maxlen,
 {
     size_t        bin_pos = (size_t) 0U;
     size_t        hex_pos = (size_t) 0U;
+    size_t        vec_pos = (size_t) 0U;
+    size_t        consumed;
     int           ret     = 0;
     unsigned char c;
     unsigned char c_acc = 0U;
@@ -54,6 +65,15 @@ sodium_hex2bin(unsigned char *const bin, const size_t bin_maxlen,
     unsigned char state = 0U;
 
     while (hex_pos < hex_len) {
+        if (state == 0U && implementation != NULL && hex_pos >= vec_pos &&
+            hex_len - hex_pos >= CODECS_HEX_BLOCK) {
+            consumed = implementation->hex2bin(bin + bin_pos, bin_maxlen - bin_pos,
+                                               hex + hex_pos, hex_len - hex_pos);
+            hex_pos += consumed;
+            bin_pos += consumed / 2U;
+            vec_pos = hex_pos + CODECS_HEX_BLOCK;
+            continue;
+        }
         c        = (unsigned char) hex[hex_pos];
         c_num    = c ^ 48U;
         c_num0   = (c_num - 10U) >> 8;
@@ -175,32 +195,21 @@ sodium_base64_encoded_len(const size_t bin_len, const int variant)
     return sodium_base64_ENCODED_LEN(bin_len, variant);
 }
 
-char *
-sodium_bin2base64(char * const b64, const size_t b64_maxlen,
-                  const unsigned char * const bin, const size_t bin_len,
-                  const int variant)
+/* Encodes BIN without padding, returns the number of characters written */
+static size_t
+_sodium_base64_encode(char * const b64, const unsigned char * const bin,
+                      const size_t bin_len, const int variant)
 {
     size_t       acc_len = (size_t) 0;
-    size_t       b64_len;
     size_t       b64_pos = (size_t) 0;
     size_t       bin_pos = (size_t) 0;
-    size_t       nibbles;
-    size_t       remainder;
     unsigned int acc = 0U;
 
-    sodium_base64_check_variant(variant);
-    nibbles = bin_len / 3;
-    remainder = bin_len - 3 * nibbles;
-    b64_len = nibbles * 4;
-    if (remainder != 0) {
-        if ((((unsigned int) variant) & VARIANT_NO_PADDING_MASK) == 0U) {
-            b64_len += 4;
-        } else {
-            b64_len += 2 + (remainder >> 1);
-        }
-    }
-    if (b64_maxlen <= b64_len) {
-        sodium_misuse();
+    if (implementation != NULL) {
+        bin_pos = implementation->bin2base64
+            (b64, bin, bin_len,
+             (((unsigned int) variant) & VARIANT_URLSAFE_MASK) != 0U);
+        b64_pos = bin_pos / 3U * 4U;
     }
     if ((((unsigned int) variant) & VARIANT_URLSAFE_MASK) != 0U) {
         while (bin_pos < bin_len) {
@@ -227,6 +236,34 @@ sodium_bin2base64(char * const b64, const size_t b64_maxlen,
             b64[b64_pos++] = (char) b64_byte_to_char((acc << (6 - acc_len)) & 0x3F);
         }
     }
+    return b64_pos;
+}
+
+char *
+sodium_bin2base64(char * const b64, const size_t b64_maxlen,
+                  const unsigned char * const bin, const size_t bin_len,
+                  const int variant)
+{
+    size_t b64_len;
+    size_t b64_pos;
+    size_t nibbles;
+    size_t remainder;
+
+    sodium_base64_check_variant(variant);
+    nibbles = bin_len / 3;
+    remainder = bin_len - 3 * nibbles;
+    b64_len = nibbles * 4;
+    if (remainder != 0) {
+        if ((((unsigned int) variant) & VARIANT_NO_PADDING_MASK) == 0U) {
+            b64_len += 4;
+        } else {
+            b64_len += 2 + (remainder >> 1);
+        }
+    }
+    if (b64_maxlen <= b64_len) {
+        sodium_misuse();
+    }
+    b64_pos = _sodium_base64_encode(b64, bin, bin_len, variant);
     assert(b64_pos <= b64_len);
     while (b64_pos < b64_len) {
         b64[b64_pos++] = '=';
@@ -238,6 +275,83 @@ sodium_bin2base64(char * const b64, const size_t b64_maxlen,
     return b64;
 }
 
+int
+sodium_base64_encode_init(sodium_base64_encode_state *state, const int variant)
+{
+    sodium_base64_check_variant(variant);
+    memset(state, 0, sizeof *state);
+    state->variant = variant;
+
+    return 0;
+}
+
+int
+sodium_base64_encode_update(sodium_base64_encode_state *state,
+                            char * const b64, const size_t b64_maxlen,
+                            size_t * const b64_len,
+                            const unsigned char *bin, size_t bin_len)
+{
+    size_t b64_pos = (size_t) 0U;
+    size_t whole;
+
+    *b64_len = (size_t) 0U;
+    if (bin_len > SIZE_MAX - 2U ||
+        b64_maxlen / 4U < (state->buf_len + bin_len) / 3U) {
+        errno = ERANGE;
+        return -1;
+    }
+    if (state->buf_len > 0U) {
+        while (state->buf_len < sizeof state->buf && bin_len > 0U) {
+            state->buf[state->buf_len++] = *bin++;
+            bin_len--;
+        }
+        if (state->buf_len < sizeof state->buf) {
+            return 0;
+        }
+        b64_pos = _sodium_base64_encode(b64, state->buf, sizeof state->buf,
+                                        state->variant);
+        state->buf_len = 0U;
+    }
+    whole = bin_len / 3U * 3U;
+    b64_pos += _sodium_base64_encode(b64 + b64_pos, bin, whole, state->variant);
+    memcpy(state->buf, bin + whole, bin_len - whole);
+    state->buf_len = (unsigned char) (bin_len - whole);
+    *b64_len = b64_pos;
+
+    return 0;
+}
+
+int
+sodium_base64_encode_final(sodium_base64_encode_state *state,
+                           char * const b64, const size_t b64_maxlen,
+                           size_t * const b64_len)
+{
+    size_t b64_pos;
+    size_t needed = (size_t) 0U;
+
+    *b64_len = (size_t) 0U;
+    if (state->buf_len > 0U) {
+        if ((((unsigned int) state->variant) & VARIANT_NO_PADDING_MASK) == 0U) {
+            needed = 4U;
+        } else {
+            needed = state->buf_len + 1U;
+        }
+    }
+    if (b64_maxlen < needed) {
+        errno = ERANGE;
+        return -1;
+    }
+    b64_pos = _sodium_base64_encode(b64, state->buf, state->buf_len,
+                                    state->variant);
+    while (b64_pos < needed) {
+        b64[b64_pos++] = '=';
+    }
+    *b64_len = b64_pos;
+    sodium_memzero(state, sizeof *state);
+
+    return 0;
+}
+
 static int
 _sodium_base642bin_skip_padding(const char * const b64, const size_t b64_len,
                                 size_t * const b64_pos_p,
@@ -271,6 +385,8 @@ sodium_base642bin(unsigned char * const bin, const size_t bin_maxlen,
     size_t       acc_len = (size_t) 0;
     size_t       b64_pos = (size_t) 0;
     size_t       bin_pos = (size_t) 0;
+    size_t       vec_pos = (size_t) 0;
+    size_t       consumed;
     int          is_urlsafe;
     int          ret = 0;
     unsigned int acc = 0U;
@@ -280,6 +396,18 @@ sodium_base642bin(unsigned char * const bin, const size_t bin_maxlen,
     sodium_base64_check_variant(variant);
     is_urlsafe = ((unsigned int) variant) & VARIANT_URLSAFE_MASK;
     while (b64_pos < b64_len) {
+        if (acc_len == 0U && implementation != NULL && b64_pos >= vec_pos &&
+            b64_len - b64_pos >= CODECS_BASE64_BLOCK) {
+            consumed = implementation->base642bin(bin + bin_pos,
+                                                  bin_maxlen - bin_pos,
+                                                  b64 + b64_pos,
+                                                  b64_len - b64_pos,
+                                                  is_urlsafe);
+            b64_pos += consumed;
+            bin_pos += consumed / 4U * 3U;
+            vec_pos = b64_pos + CODECS_BASE64_BLOCK;
+            continue;
+        }
         c = b64[b64_pos];
         if (is_urlsafe) {
             d = b64_urlsafe_char_to_byte(c);
@@ -331,3 +459,141 @@ sodium_base642bin(unsigned char * const bin, const size_t bin_maxlen,
     }
     return ret;
 }
+
+int
+sodium_base64_decode_init(sodium_base64_decode_state *state, const int variant)
+{
+    sodium_base64_check_variant(variant);
+    memset(state, 0, sizeof *state);
+    state->variant = variant;
+
+    return 0;
+}
+
+int
+sodium_base64_decode_update(sodium_base64_decode_state *state,
+                            unsigned char * const bin, const size_t bin_maxlen,
+                            size_t * const bin_len,
+                            const char * const b64, const size_t b64_len,
+                            const char * const ignore)
+{
+    size_t       b64_pos = (size_t) 0U;
+    size_t       bin_pos = (size_t) 0U;
+    size_t       vec_pos = (size_t) 0U;
+    size_t       consumed;
+    int          is_urlsafe;
+    unsigned int d;
+    char         c;
+
+    *bin_len = (size_t) 0U;
+    if (b64_len > (SIZE_MAX - 6U) / 6U ||
+        bin_maxlen < (state->acc_len + 6U * b64_len) / 8U) {
+        errno = ERANGE;
+        return -1;
+    }
+    is_urlsafe = ((unsigned int) state->variant) & VARIANT_URLSAFE_MASK;
+    while (b64_pos < b64_len) {
+        if (state->acc_len == 0U && state->in_padding == 0U &&
+            implementation != NULL && b64_pos >= vec_pos &&
+            b64_len - b64_pos >= CODECS_BASE64_BLOCK) {
+            consumed = implementation->base642bin(bin + bin_pos,
+                                                  bin_maxlen - bin_pos,
+                                                  b64 + b64_pos,
+                                                  b64_len - b64_pos,
+                                                  is_urlsafe);
+            b64_pos += consumed;
+            bin_pos += consumed / 4U * 3U;
+            vec_pos = b64_pos + CODECS_BASE64_BLOCK;
+            continue;
+        }
+        c = b64[b64_pos++];
+        if (state->in_padding == 0U) {
+            if (is_urlsafe) {
+                d = b64_urlsafe_char_to_byte(c);
+            } else {
+                d = b64_char_to_byte(c);
+            }
+            if (d != 0xFF) {
+                state->acc = (state->acc << 6) + d;
+                state->acc_len += 6;
+                if (state->acc_len >= 8) {
+                    state->acc_len -= 8;
+                    bin[bin_pos++] = (state->acc >> state->acc_len) & 0xFF;
+                }
+                continue;
+            }
+        }
+        if (c == '=' &&
+            (((unsigned int) state->variant) & VARIANT_NO_PADDING_MASK) == 0U) {
+            if (state->in_padding == 0U) {
+                if (state->acc_len < 2U || state->acc_len > 4U ||
+                    (state->acc & ((1U << state->acc_len) - 1U)) != 0U) {
+                    goto invalid;
+                }
+                state->in_padding = 1U;
+                state->padding_len = state->acc_len / 2U;
+            }
+            if (state->padding_len == 0U) {
+                goto invalid;
+            }
+            state->padding_len--;
+            continue;
+        }
+        if (ignore != NULL && strchr(ignore, c) != NULL) {
+            continue;
+        }
+    invalid:
+        sodium_memzero(state, sizeof *state);
+        errno = EINVAL;
+        return -1;
+    }
+    *bin_len = bin_pos;
+
+    return 0;
+}
+
+int
+sodium_base64_decode_final(sodium_base64_decode_state *state)
+{
+    int ret = 0;
+
+    if (state->acc_len > 4U ||
+        (state->acc & ((1U << state->acc_len) - 1U)) != 0U) {
+        ret = -1;
+    } else if ((((unsigned int) state->variant) & VARIANT_NO_PADDING_MASK) == 0U &&
+               state->acc_len != 0U &&
+               (state->in_padding == 0U || state->padding_len != 0U)) {
+        ret = -1;
+    }
+    sodium_memzero(state, sizeof *state);
+    if (ret != 0) {
+        errno = EINVAL;
+    }
+    return ret;
+}
+
+int
+_sodium_codecs_pick_best_implementation(void)
+{
+    implementation = NULL;
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+    defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+    if (sodium_runtime_has_avx2()) {
+        implementation = &sodium_codecs_avx2_implementation;
+        return 0;
+    }
+#endif
+#if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H)
+    if (sodium_runtime_has_ssse3()) {
+        implementation = &sodium_codecs_ssse3_implementation;
+        return 0;
+    }
+#endif
+#if defined(HAVE_ARMNEON)
+    if (sodium_runtime_has_neon()) {
+        implementation = &sodium_codecs_neon_implementation;
+        return 0;
+    }
+#endif
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef codecs_H
+#define codecs_H
+
+#include <stddef.h>
+
+/*
+ * Vectorized block codecs. They only process whole blocks of valid input,
+ * stop at the first block that contains an invalid character, and return
+ * the number of input bytes they consumed. Anything else, including
+ * ignored characters, padding and errors, is left to the generic code.
+ */
+
+/* Smallest input, in characters, that a decoder can make progress with */
+#define CODECS_HEX_BLOCK    32U
+#define CODECS_BASE64_BLOCK 16U
+
+typedef struct sodium_codecs_implementation {
+    size_t (*bin2hex)(char *hex, const unsigned char *bin, size_t bin_len);
+    size_t (*hex2bin)(unsigned char *bin, size_t bin_maxlen,
+                      const char *hex, size_t hex_len);
+    size_t (*bin2base64)(char *b64, const unsigned char *bin, size_t bin_len,
+                         int urlsafe);
+    size_t (*base642bin)(unsigned char *bin, size_t bin_maxlen,
+                         const char *b64, size_t b64_len, int urlsafe);
+} sodium_codecs_implementation;
+
+extern struct sodium_codecs_implementation sodium_codecs_ssse3_implementation;
+extern struct sodium_codecs_implementation sodium_codecs_avx2_implementation;
+extern struct sodium_codecs_implementation sodium_codecs_neon_implementation;
+
+#endif
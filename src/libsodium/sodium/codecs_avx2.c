@@ -0,0 +1,239 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_AVX2INTRIN_H) && defined(HAVE_EMMINTRIN_H) && \
+        defined(HAVE_TMMINTRIN_H) && defined(HAVE_SMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+#  pragma GCC target("sse4.1")
+#  pragma GCC target("avx2")
+# endif
+
+# include <emmintrin.h>
+# include <immintrin.h>
+# include <smmintrin.h>
+# include <tmmintrin.h>
+
+# include "codecs.h"
+# include "codecs_sse.h"
+
+/*
+ * Same algorithms as the 16-byte versions, on both 128-bit lanes at once.
+ * Encoders feed each lane separately, and decoders store each lane's
+ * output separately, since shuffles don't cross lanes.
+ */
+
+static inline __m256i
+codecs_le_epu8_256(const __m256i x, const unsigned char n)
+{
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8((char) n)), x);
+}
+
+static inline void
+codecs_hex_encode32(char *hex, const unsigned char *bin)
+{
+    const __m256i digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                            '0', '1', '2', '3', '4', '5', '6', '7',
+                                            '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i mask   = _mm256_set1_epi8(0x0f);
+    const __m256i x  = _mm256_loadu_si256((const __m256i *) (const void *) bin);
+    const __m256i hc = _mm256_shuffle_epi8(digits,
+                                           _mm256_and_si256(_mm256_srli_epi16(x, 4),
+                                                            mask));
+    const __m256i lc = _mm256_shuffle_epi8(digits, _mm256_and_si256(x, mask));
+    const __m256i lo = _mm256_unpacklo_epi8(hc, lc);
+    const __m256i hi = _mm256_unpackhi_epi8(hc, lc);
+
+    _mm256_storeu_si256((__m256i *) (void *) hex,
+                        _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i *) (void *) (hex + 32),
+                        _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+static inline __m256i
+codecs_hex_decode_chars256(const __m256i c, __m256i *valid)
+{
+    const __m256i d  = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i a  = _mm256_sub_epi8(_mm256_and_si256(c, _mm256_set1_epi8((char) 0xdf)),
+                                       _mm256_set1_epi8('A'));
+    const __m256i dm = codecs_le_epu8_256(d, 9U);
+    const __m256i am = codecs_le_epu8_256(a, 5U);
+
+    *valid = _mm256_or_si256(dm, am);
+
+    return _mm256_or_si256(_mm256_and_si256(dm, d),
+                           _mm256_and_si256(am, _mm256_add_epi8(a, _mm256_set1_epi8(10))));
+}
+
+static inline int
+codecs_hex_decode64(unsigned char *bin, const char *hex)
+{
+    const __m256i pair = _mm256_set1_epi16(0x0110);
+    __m256i       v0, v1, ok0, ok1;
+
+    v0 = codecs_hex_decode_chars256
+        (_mm256_loadu_si256((const __m256i *) (const void *) hex), &ok0);
+    v1 = codecs_hex_decode_chars256
+        (_mm256_loadu_si256((const __m256i *) (const void *) (hex + 32)), &ok1);
+    if (_mm256_movemask_epi8(_mm256_and_si256(ok0, ok1)) != -1) {
+        return -1;
+    }
+    _mm256_storeu_si256((__m256i *) (void *) bin,
+                        _mm256_permute4x64_epi64
+                        (_mm256_packus_epi16(_mm256_maddubs_epi16(v0, pair),
+                                             _mm256_maddubs_epi16(v1, pair)),
+                         0xd8));
+    return 0;
+}
+
+static inline __m256i
+codecs_b64_encode_sextets256(const __m256i s, const int urlsafe)
+{
+    __m256i off = _mm256_set1_epi8('A');
+
+    off = _mm256_add_epi8(off, _mm256_and_si256(_mm256_cmpgt_epi8(s, _mm256_set1_epi8(25)),
+                                                _mm256_set1_epi8(6)));
+    off = _mm256_add_epi8(off, _mm256_and_si256(_mm256_cmpgt_epi8(s, _mm256_set1_epi8(51)),
+                                                _mm256_set1_epi8(-75)));
+    off = _mm256_add_epi8(off, _mm256_and_si256(_mm256_cmpgt_epi8(s, _mm256_set1_epi8(61)),
+                                                _mm256_set1_epi8(urlsafe ? -13 : -15)));
+    off = _mm256_add_epi8(off, _mm256_and_si256(_mm256_cmpgt_epi8(s, _mm256_set1_epi8(62)),
+                                                _mm256_set1_epi8(urlsafe ? 49 : 3)));
+
+    return _mm256_add_epi8(s, off);
+}
+
+/* Reads 28 bytes, encodes the first 24 */
+static inline void
+codecs_b64_encode24(char *b64, const unsigned char *bin, const int urlsafe)
+{
+    const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                            7, 6, 8, 7, 10, 9, 11, 10,
+                                            1, 0, 2, 1, 4, 3, 5, 4,
+                                            7, 6, 8, 7, 10, 9, 11, 10);
+    __m256i x, t0, t1;
+
+    x = _mm256_inserti128_si256
+        (_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *) (const void *) bin)),
+         _mm_loadu_si128((const __m128i *) (const void *) (bin + 12)), 1);
+    x  = _mm256_shuffle_epi8(x, spread);
+    t0 = _mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0fc0fc00)),
+                            _mm256_set1_epi32(0x04000040));
+    t1 = _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003f03f0)),
+                            _mm256_set1_epi32(0x01000010));
+    _mm256_storeu_si256((__m256i *) (void *) b64,
+                        codecs_b64_encode_sextets256(_mm256_or_si256(t0, t1),
+                                                     urlsafe));
+}
+
+static inline __m256i
+codecs_b64_decode_chars256(const __m256i c, const int urlsafe, __m256i *valid)
+{
+    const __m256i u   = _mm256_sub_epi8(c, _mm256_set1_epi8('A'));
+    const __m256i l   = _mm256_sub_epi8(c, _mm256_set1_epi8('a'));
+    const __m256i d   = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+    const __m256i um  = codecs_le_epu8_256(u, 25U);
+    const __m256i lm  = codecs_le_epu8_256(l, 25U);
+    const __m256i dm  = codecs_le_epu8_256(d, 9U);
+    const __m256i m62 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(urlsafe ? '-' : '+'));
+    const __m256i m63 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(urlsafe ? '_' : '/'));
+
+    *valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(um, lm), dm),
+                             _mm256_or_si256(m62, m63));
+
+    return _mm256_or_si256(
+        _mm256_or_si256(_mm256_and_si256(um, u),
+                        _mm256_and_si256(lm, _mm256_add_epi8(l, _mm256_set1_epi8(26)))),
+        _mm256_or_si256(_mm256_and_si256(dm, _mm256_add_epi8(d, _mm256_set1_epi8(52))),
+                        _mm256_or_si256(_mm256_and_si256(m62, _mm256_set1_epi8(62)),
+                                        _mm256_and_si256(m63, _mm256_set1_epi8(63)))));
+}
+
+/* Decodes 32 characters into 24 bytes */
+static inline int
+codecs_b64_decode32(unsigned char *bin, const char *b64, const int urlsafe)
+{
+    const __m256i join = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                          8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9,
+                                          8, 14, 13, 12, -1, -1, -1, -1);
+    __m256i v, ok;
+
+    v = codecs_b64_decode_chars256
+        (_mm256_loadu_si256((const __m256i *) (const void *) b64), urlsafe, &ok);
+    if (_mm256_movemask_epi8(ok) != -1) {
+        return -1;
+    }
+    v = _mm256_madd_epi16(_mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140)),
+                          _mm256_set1_epi32(0x00011000));
+    v = _mm256_shuffle_epi8(v, join);
+    codecs_b64_store12(bin, _mm256_castsi256_si128(v));
+    codecs_b64_store12(bin + 12, _mm256_extracti128_si256(v, 1));
+
+    return 0;
+}
+
+static size_t
+codecs_bin2hex(char *hex, const unsigned char *bin, size_t bin_len)
+{
+    size_t i = 0U;
+
+    for (; bin_len - i >= 32U; i += 32U) {
+        codecs_hex_encode32(hex + 2U * i, bin + i);
+    }
+    return codecs_bin2hex_sse(hex, bin, bin_len, i);
+}
+
+static size_t
+codecs_hex2bin(unsigned char *bin, size_t bin_maxlen, const char *hex,
+               size_t hex_len)
+{
+    size_t i = 0U;
+
+    while (hex_len - i >= 64U && bin_maxlen - i / 2U >= 32U &&
+           codecs_hex_decode64(bin + i / 2U, hex + i) == 0) {
+        i += 64U;
+    }
+    return codecs_hex2bin_sse(bin, bin_maxlen, hex, hex_len, i);
+}
+
+static size_t
+codecs_bin2base64(char *b64, const unsigned char *bin, size_t bin_len,
+                  int urlsafe)
+{
+    size_t i = 0U;
+
+    for (; bin_len - i >= 28U; i += 24U) {
+        codecs_b64_encode24(b64 + i / 3U * 4U, bin + i, urlsafe);
+    }
+    return codecs_bin2base64_sse(b64, bin, bin_len, urlsafe, i);
+}
+
+static size_t
+codecs_base642bin(unsigned char *bin, size_t bin_maxlen, const char *b64,
+                  size_t b64_len, int urlsafe)
+{
+    size_t i = 0U;
+
+    while (b64_len - i >= 32U && bin_maxlen - i / 4U * 3U >= 24U &&
+           codecs_b64_decode32(bin + i / 4U * 3U, b64 + i, urlsafe) == 0) {
+        i += 32U;
+    }
+    return codecs_base642bin_sse(bin, bin_maxlen, b64, b64_len, urlsafe, i);
+}
+
+struct sodium_codecs_implementation sodium_codecs_avx2_implementation = {
+    SODIUM_C99(.bin2hex =) codecs_bin2hex,
+    SODIUM_C99(.hex2bin =) codecs_hex2bin,
+    SODIUM_C99(.bin2base64 =) codecs_bin2base64,
+    SODIUM_C99(.base642bin =) codecs_base642bin
+};
+
+#endif
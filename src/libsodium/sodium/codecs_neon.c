@@ -0,0 +1,167 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_ARMNEON)
+
+# include <arm_neon.h>
+
+# include "codecs.h"
+
+/*
+ * Interleaving loads and stores split the input into one vector per byte
+ * position, so that no shuffles are required.
+ */
+
+static inline uint8x16_t
+codecs_hex_decode_chars(const uint8x16_t c, uint8x16_t *valid)
+{
+    const uint8x16_t d  = vsubq_u8(c, vdupq_n_u8('0'));
+    const uint8x16_t a  = vsubq_u8(vandq_u8(c, vdupq_n_u8(0xdf)), vdupq_n_u8('A'));
+    const uint8x16_t dm = vcleq_u8(d, vdupq_n_u8(9));
+    const uint8x16_t am = vcleq_u8(a, vdupq_n_u8(5));
+
+    *valid = vorrq_u8(dm, am);
+
+    return vorrq_u8(vandq_u8(dm, d), vandq_u8(am, vaddq_u8(a, vdupq_n_u8(10))));
+}
+
+static inline uint8x16_t
+codecs_b64_encode_sextets(const uint8x16_t s, const int urlsafe)
+{
+    uint8x16_t off = vdupq_n_u8('A');
+
+    off = vaddq_u8(off, vandq_u8(vcgtq_u8(s, vdupq_n_u8(25)), vdupq_n_u8(6)));
+    off = vaddq_u8(off, vandq_u8(vcgtq_u8(s, vdupq_n_u8(51)),
+                                 vdupq_n_u8((uint8_t) -75)));
+    off = vaddq_u8(off, vandq_u8(vcgtq_u8(s, vdupq_n_u8(61)),
+                                 vdupq_n_u8((uint8_t) (urlsafe ? -13 : -15))));
+    off = vaddq_u8(off, vandq_u8(vcgtq_u8(s, vdupq_n_u8(62)),
+                                 vdupq_n_u8(urlsafe ? 49 : 3)));
+
+    return vaddq_u8(s, off);
+}
+
+static inline uint8x16_t
+codecs_b64_decode_chars(const uint8x16_t c, const int urlsafe, uint8x16_t *valid)
+{
+    const uint8x16_t u   = vsubq_u8(c, vdupq_n_u8('A'));
+    const uint8x16_t l   = vsubq_u8(c, vdupq_n_u8('a'));
+    const uint8x16_t d   = vsubq_u8(c, vdupq_n_u8('0'));
+    const uint8x16_t um  = vcleq_u8(u, vdupq_n_u8(25));
+    const uint8x16_t lm  = vcleq_u8(l, vdupq_n_u8(25));
+    const uint8x16_t dm  = vcleq_u8(d, vdupq_n_u8(9));
+    const uint8x16_t m62 = vceqq_u8(c, vdupq_n_u8(urlsafe ? '-' : '+'));
+    const uint8x16_t m63 = vceqq_u8(c, vdupq_n_u8(urlsafe ? '_' : '/'));
+
+    *valid = vorrq_u8(vorrq_u8(vorrq_u8(um, lm), dm), vorrq_u8(m62, m63));
+
+    return vorrq_u8(vorrq_u8(vandq_u8(um, u),
+                             vandq_u8(lm, vaddq_u8(l, vdupq_n_u8(26)))),
+                    vorrq_u8(vandq_u8(dm, vaddq_u8(d, vdupq_n_u8(52))),
+                             vorrq_u8(vandq_u8(m62, vdupq_n_u8(62)),
+                                      vandq_u8(m63, vdupq_n_u8(63)))));
+}
+
+static size_t
+codecs_bin2hex(char *hex, const unsigned char *bin, size_t bin_len)
+{
+    static const uint8_t digits_[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+    const uint8x16_t digits = vld1q_u8(digits_);
+    uint8x16x2_t     out;
+    uint8x16_t       x;
+    size_t           i = 0U;
+
+    for (; bin_len - i >= 16U; i += 16U) {
+        x          = vld1q_u8(bin + i);
+        out.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(x, 4));
+        out.val[1] = vqtbl1q_u8(digits, vandq_u8(x, vdupq_n_u8(0x0f)));
+        vst2q_u8((uint8_t *) (void *) (hex + 2U * i), out);
+    }
+    return i;
+}
+
+static size_t
+codecs_hex2bin(unsigned char *bin, size_t bin_maxlen, const char *hex,
+               size_t hex_len)
+{
+    uint8x16x2_t in;
+    uint8x16_t   hi, lo, ok_hi, ok_lo;
+    size_t       i = 0U;
+
+    while (hex_len - i >= 32U && bin_maxlen - i / 2U >= 16U) {
+        in = vld2q_u8((const uint8_t *) (const void *) (hex + i));
+        hi = codecs_hex_decode_chars(in.val[0], &ok_hi);
+        lo = codecs_hex_decode_chars(in.val[1], &ok_lo);
+        if (vminvq_u8(vandq_u8(ok_hi, ok_lo)) != 0xff) {
+            break;
+        }
+        vst1q_u8(bin + i / 2U, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+        i += 32U;
+    }
+    return i;
+}
+
+static size_t
+codecs_bin2base64(char *b64, const unsigned char *bin, size_t bin_len,
+                  int urlsafe)
+{
+    uint8x16x3_t in;
+    uint8x16x4_t out;
+    size_t       i = 0U;
+
+    for (; bin_len - i >= 48U; i += 48U) {
+        in = vld3q_u8(bin + i);
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[0], vdupq_n_u8(0x03)), 4),
+                              vshrq_n_u8(in.val[1], 4));
+        out.val[2] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[1], vdupq_n_u8(0x0f)), 2),
+                              vshrq_n_u8(in.val[2], 6));
+        out.val[3] = vandq_u8(in.val[2], vdupq_n_u8(0x3f));
+        out.val[0] = codecs_b64_encode_sextets(out.val[0], urlsafe);
+        out.val[1] = codecs_b64_encode_sextets(out.val[1], urlsafe);
+        out.val[2] = codecs_b64_encode_sextets(out.val[2], urlsafe);
+        out.val[3] = codecs_b64_encode_sextets(out.val[3], urlsafe);
+        vst4q_u8((uint8_t *) (void *) (b64 + i / 3U * 4U), out);
+    }
+    return i;
+}
+
+static size_t
+codecs_base642bin(unsigned char *bin, size_t bin_maxlen, const char *b64,
+                  size_t b64_len, int urlsafe)
+{
+    uint8x16x4_t in;
+    uint8x16x3_t out;
+    uint8x16_t   ok0, ok1, ok2, ok3;
+    size_t       i = 0U;
+
+    while (b64_len - i >= 64U && bin_maxlen - i / 4U * 3U >= 48U) {
+        in = vld4q_u8((const uint8_t *) (const void *) (b64 + i));
+        in.val[0] = codecs_b64_decode_chars(in.val[0], urlsafe, &ok0);
+        in.val[1] = codecs_b64_decode_chars(in.val[1], urlsafe, &ok1);
+        in.val[2] = codecs_b64_decode_chars(in.val[2], urlsafe, &ok2);
+        in.val[3] = codecs_b64_decode_chars(in.val[3], urlsafe, &ok3);
+        if (vminvq_u8(vandq_u8(vandq_u8(ok0, ok1), vandq_u8(ok2, ok3))) != 0xff) {
+            break;
+        }
+        out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+        vst3q_u8(bin + i / 4U * 3U, out);
+        i += 64U;
+    }
+    return i;
+}
+
+struct sodium_codecs_implementation sodium_codecs_neon_implementation = {
+    SODIUM_C99(.bin2hex =) codecs_bin2hex,
+    SODIUM_C99(.hex2bin =) codecs_hex2bin,
+    SODIUM_C99(.bin2base64 =) codecs_bin2base64,
+    SODIUM_C99(.base642bin =) codecs_base642bin
+};
+
+#endif
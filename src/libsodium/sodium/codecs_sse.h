@@ -0,0 +1,209 @@
+/*
+ * 16-byte block codecs, shared by the SSSE3 and AVX2 implementations.
+ * Encoders may read past the block they encode, but never past the input;
+ * decoders never write more than they decode.
+ */
+
+/* 0xff in every lane where x <= n, as unsigned bytes */
+static inline __m128i
+codecs_le_epu8(const __m128i x, const unsigned char n)
+{
+    return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8((char) n)), x);
+}
+
+static inline void
+codecs_hex_encode16(char *hex, const unsigned char *bin)
+{
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i mask   = _mm_set1_epi8(0x0f);
+    const __m128i x  = _mm_loadu_si128((const __m128i *) (const void *) bin);
+    const __m128i hc = _mm_shuffle_epi8(digits,
+                                        _mm_and_si128(_mm_srli_epi16(x, 4), mask));
+    const __m128i lc = _mm_shuffle_epi8(digits, _mm_and_si128(x, mask));
+
+    _mm_storeu_si128((__m128i *) (void *) hex, _mm_unpacklo_epi8(hc, lc));
+    _mm_storeu_si128((__m128i *) (void *) (hex + 16), _mm_unpackhi_epi8(hc, lc));
+}
+
+static inline __m128i
+codecs_hex_decode_chars(const __m128i c, __m128i *valid)
+{
+    const __m128i d  = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i a  = _mm_sub_epi8(_mm_and_si128(c, _mm_set1_epi8((char) 0xdf)),
+                                    _mm_set1_epi8('A'));
+    const __m128i dm = codecs_le_epu8(d, 9U);
+    const __m128i am = codecs_le_epu8(a, 5U);
+
+    *valid = _mm_or_si128(dm, am);
+
+    return _mm_or_si128(_mm_and_si128(dm, d),
+                        _mm_and_si128(am, _mm_add_epi8(a, _mm_set1_epi8(10))));
+}
+
+static inline int
+codecs_hex_decode32(unsigned char *bin, const char *hex)
+{
+    const __m128i pair = _mm_set1_epi16(0x0110);
+    __m128i       v0, v1, ok0, ok1;
+
+    v0 = codecs_hex_decode_chars
+        (_mm_loadu_si128((const __m128i *) (const void *) hex), &ok0);
+    v1 = codecs_hex_decode_chars
+        (_mm_loadu_si128((const __m128i *) (const void *) (hex + 16)), &ok1);
+    if (_mm_movemask_epi8(_mm_and_si128(ok0, ok1)) != 0xffff) {
+        return -1;
+    }
+    _mm_storeu_si128((__m128i *) (void *) bin,
+                     _mm_packus_epi16(_mm_maddubs_epi16(v0, pair),
+                                      _mm_maddubs_epi16(v1, pair)));
+    return 0;
+}
+
+/* Maps 6-bit values to characters by adding a range-dependent offset */
+static inline __m128i
+codecs_b64_encode_sextets(const __m128i s, const int urlsafe)
+{
+    __m128i off = _mm_set1_epi8('A');
+
+    off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(25)),
+                                          _mm_set1_epi8(6)));
+    off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(51)),
+                                          _mm_set1_epi8(-75)));
+    off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(61)),
+                                          _mm_set1_epi8(urlsafe ? -13 : -15)));
+    off = _mm_add_epi8(off, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(62)),
+                                          _mm_set1_epi8(urlsafe ? 49 : 3)));
+
+    return _mm_add_epi8(s, off);
+}
+
+/*
+ * Each 32-bit lane holds (b1, b0, b2, b1), so that the four sextets can be
+ * moved to their own byte with a single multiplication per 16-bit word.
+ */
+static inline __m128i
+codecs_b64_split(__m128i x)
+{
+    const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(x, _mm_set1_epi32(0x0fc0fc00)),
+                                       _mm_set1_epi32(0x04000040));
+    const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(x, _mm_set1_epi32(0x003f03f0)),
+                                       _mm_set1_epi32(0x01000010));
+
+    return _mm_or_si128(t0, t1);
+}
+
+/* Reads 16 bytes, encodes the first 12 */
+static inline void
+codecs_b64_encode12(char *b64, const unsigned char *bin, const int urlsafe)
+{
+    const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                         7, 6, 8, 7, 10, 9, 11, 10);
+    __m128i x = _mm_loadu_si128((const __m128i *) (const void *) bin);
+
+    x = codecs_b64_split(_mm_shuffle_epi8(x, spread));
+    _mm_storeu_si128((__m128i *) (void *) b64,
+                     codecs_b64_encode_sextets(x, urlsafe));
+}
+
+static inline __m128i
+codecs_b64_decode_chars(const __m128i c, const int urlsafe, __m128i *valid)
+{
+    const __m128i u   = _mm_sub_epi8(c, _mm_set1_epi8('A'));
+    const __m128i l   = _mm_sub_epi8(c, _mm_set1_epi8('a'));
+    const __m128i d   = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    const __m128i um  = codecs_le_epu8(u, 25U);
+    const __m128i lm  = codecs_le_epu8(l, 25U);
+    const __m128i dm  = codecs_le_epu8(d, 9U);
+    const __m128i m62 = _mm_cmpeq_epi8(c, _mm_set1_epi8(urlsafe ? '-' : '+'));
+    const __m128i m63 = _mm_cmpeq_epi8(c, _mm_set1_epi8(urlsafe ? '_' : '/'));
+
+    *valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(um, lm), dm),
+                          _mm_or_si128(m62, m63));
+
+    return _mm_or_si128(
+        _mm_or_si128(_mm_and_si128(um, u),
+                     _mm_and_si128(lm, _mm_add_epi8(l, _mm_set1_epi8(26)))),
+        _mm_or_si128(_mm_and_si128(dm, _mm_add_epi8(d, _mm_set1_epi8(52))),
+                     _mm_or_si128(_mm_and_si128(m62, _mm_set1_epi8(62)),
+                                  _mm_and_si128(m63, _mm_set1_epi8(63)))));
+}
+
+/* Packs four sextets per 32-bit lane into 24 bits, most significant first */
+static inline __m128i
+codecs_b64_join(const __m128i v)
+{
+    const __m128i t = _mm_madd_epi16(_mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140)),
+                                     _mm_set1_epi32(0x00011000));
+
+    return _mm_shuffle_epi8(t, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                             8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+/* Stores the 12 bytes produced from 16 characters, and nothing else */
+static inline void
+codecs_b64_store12(unsigned char *bin, const __m128i v)
+{
+    uint32_t t = (uint32_t) _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+
+    _mm_storel_epi64((__m128i *) (void *) bin, v);
+    memcpy(bin + 8, &t, sizeof t);
+}
+
+static inline int
+codecs_b64_decode16(unsigned char *bin, const char *b64, const int urlsafe)
+{
+    __m128i v, ok;
+
+    v = codecs_b64_decode_chars
+        (_mm_loadu_si128((const __m128i *) (const void *) b64), urlsafe, &ok);
+    if (_mm_movemask_epi8(ok) != 0xffff) {
+        return -1;
+    }
+    codecs_b64_store12(bin, codecs_b64_join(v));
+
+    return 0;
+}
+
+static size_t
+codecs_bin2hex_sse(char *hex, const unsigned char *bin, const size_t bin_len,
+                   size_t i)
+{
+    for (; bin_len - i >= 16U; i += 16U) {
+        codecs_hex_encode16(hex + 2U * i, bin + i);
+    }
+    return i;
+}
+
+static size_t
+codecs_hex2bin_sse(unsigned char *bin, const size_t bin_maxlen,
+                   const char *hex, const size_t hex_len, size_t i)
+{
+    while (hex_len - i >= 32U && bin_maxlen - i / 2U >= 16U &&
+           codecs_hex_decode32(bin + i / 2U, hex + i) == 0) {
+        i += 32U;
+    }
+    return i;
+}
+
+static size_t
+codecs_bin2base64_sse(char *b64, const unsigned char *bin,
+                      const size_t bin_len, const int urlsafe, size_t i)
+{
+    for (; bin_len - i >= 16U; i += 12U) {
+        codecs_b64_encode12(b64 + i / 3U * 4U, bin + i, urlsafe);
+    }
+    return i;
+}
+
+static size_t
+codecs_base642bin_sse(unsigned char *bin, const size_t bin_maxlen,
+                      const char *b64, const size_t b64_len, const int urlsafe,
+                      size_t i)
+{
+    while (b64_len - i >= 16U && bin_maxlen - i / 4U * 3U >= 12U &&
+           codecs_b64_decode16(bin + i / 4U * 3U, b64 + i, urlsafe) == 0) {
+        i += 16U;
+    }
+    return i;
+}
@@ -0,0 +1,55 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "private/common.h"
+#include "utils.h"
+
+#if defined(HAVE_EMMINTRIN_H) && defined(HAVE_TMMINTRIN_H)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+#  pragma GCC target("ssse3")
+# endif
+
+# include <emmintrin.h>
+# include <tmmintrin.h>
+
+# include "codecs.h"
+# include "codecs_sse.h"
+
+static size_t
+codecs_bin2hex(char *hex, const unsigned char *bin, size_t bin_len)
+{
+    return codecs_bin2hex_sse(hex, bin, bin_len, 0U);
+}
+
+static size_t
+codecs_hex2bin(unsigned char *bin, size_t bin_maxlen, const char *hex,
+               size_t hex_len)
+{
+    return codecs_hex2bin_sse(bin, bin_maxlen, hex, hex_len, 0U);
+}
+
+static size_t
+codecs_bin2base64(char *b64, const unsigned char *bin, size_t bin_len,
+                  int urlsafe)
+{
+    return codecs_bin2base64_sse(b64, bin, bin_len, urlsafe, 0U);
+}
+
+static size_t
+codecs_base642bin(unsigned char *bin, size_t bin_maxlen, const char *b64,
+                  size_t b64_len, int urlsafe)
+{
+    return codecs_base642bin_sse(bin, bin_maxlen, b64, b64_len, urlsafe, 0U);
+}
+
+struct sodium_codecs_implementation sodium_codecs_ssse3_implementation = {
+    SODIUM_C99(.bin2hex =) codecs_bin2hex,
+    SODIUM_C99(.hex2bin =) codecs_hex2bin,
+    SODIUM_C99(.bin2base64 =) codecs_bin2base64,
+    SODIUM_C99(.base642bin =) codecs_base642bin
+};
+
+#endif
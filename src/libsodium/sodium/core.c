@@ -1,5 +1,7 @@
 
 #include <assert.h>
+#include <errno.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -11,10 +13,14 @@
 
 #include "core.h"
 #include "crypto_generichash.h"
+#include "crypto_generichash_blake3.h"
 #include "crypto_onetimeauth.h"
+#include "crypto_pwhash_argon2id.h"
 #include "crypto_scalarmult.h"
 #include "crypto_stream_chacha20.h"
 #include "crypto_stream_salsa20.h"
+#include "crypto_stream_salsa2012.h"
+#include "crypto_stream_salsa208.h"
 #include "randombytes.h"
 #include "runtime.h"
 #include "utils.h"
@@ -24,12 +30,70 @@
 static volatile int initialized;
 static volatile int locked;
 
+#define IMPLEMENTATION_NAMES_MAX 8
+
+/* Implementations each primitive can be forced to, and the current choice */
+static struct {
+    const char *primitive;
+    const char *names[IMPLEMENTATION_NAMES_MAX];
+    const char *forced;
+    const char *selected;
+} implementations[] = {
+    { "aes", { "soft", "aesni", "armcrypto" }, NULL, NULL },
+    { "argon2", { "ref", "ssse3", "avx2", "avx512f", "neon", "simd128" },
+      NULL, NULL },
+    { "blake2b",
+      { "ref", "ssse3", "sse41", "avx2", "avx512vl", "neon", "simd128",
+        "vsx" },
+      NULL, NULL },
+    { "blake3", { "ref", "sse41", "avx2", "avx512f", "neon" }, NULL, NULL },
+    { "chacha20",
+      { "ref", "ssse3", "avx2", "avx512f", "neon", "simd128", "vsx", "rvv" },
+      NULL, NULL },
+    { "curve25519", { "ref10", "sandy2x" }, NULL, NULL },
+    { "poly1305", { "donna", "sse2", "avx2", "neon", "simd128" }, NULL, NULL },
+#ifdef HAVE_AMD64_ASM
+    { "salsa20", { "xmm6", "avx2", "avx512f" }, NULL, NULL },
+#else
+    { "salsa20", { "ref", "sse2", "avx2", "avx512f", "neon" }, NULL, NULL },
+#endif
+    { "salsa2012", { "ref", "sse2", "avx2", "avx512f" }, NULL, NULL },
+    { "salsa208", { "ref", "sse2", "avx2", "avx512f" }, NULL, NULL },
+    { "sha256", { "cp", "avx2", "shani", "armcrypto" }, NULL, NULL },
+    { "sha512", { "cp", "avx2", "armsha512" }, NULL, NULL }
+};
+
+#define IMPLEMENTATIONS_COUNT (sizeof implementations / sizeof implementations[0])
+
+/* Set by sodium_tune_implementations() */
+static int          tune_requested;
+static int          profile_valid;
+static unsigned int profile_signature;
+static const char  *profiled[IMPLEMENTATIONS_COUNT];
+
+/* Set while sodium_init() times implementations outside the lock */
+static int          tuning;
+
+static void _sodium_implementations_tune(const char *chosen[IMPLEMENTATIONS_COUNT]);
+static void _sodium_implementations_publish(const char *chosen[IMPLEMENTATIONS_COUNT]);
+static int  _sodium_tune_wait(void);
+
 int
 sodium_init(void)
 {
+    const char *chosen[IMPLEMENTATIONS_COUNT];
+
+#ifdef HAVE_LOAD_ACQUIRE
+    if (sodium_load_acquire(&initialized) != 0) {
+        return 1;
+    }
+#endif
     if (sodium_crit_enter() != 0) {
         return -1; /* LCOV_EXCL_LINE */
     }
+    if (tuning != 0 && _sodium_tune_wait() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
     if (initialized != 0) {
         if (sodium_crit_leave() != 0) {
             return -1; /* LCOV_EXCL_LINE */
@@ -40,12 +104,51 @@ sodium_init(void)
     randombytes_stir();
     _sodium_alloc_init();
     _crypto_pwhash_argon2_pick_best_implementation();
+#ifndef MINIMAL
+    _crypto_pwhash_scryptsalsa208sha256_pick_best_implementation();
+#endif
+    _crypto_aead_aegis128l_pick_best_implementation();
+    _crypto_aead_aegis128x_pick_best_implementation();
+    _crypto_aead_aegis256_pick_best_implementation();
+    _crypto_aead_aegis256x_pick_best_implementation();
+    _crypto_aead_aes256gcm_pick_best_implementation();
+    _crypto_core_ed25519_pick_best_implementation();
     _crypto_generichash_blake2b_pick_best_implementation();
+    _crypto_generichash_blake3_pick_best_implementation();
+    _crypto_hash_sha256_pick_best_implementation();
+    _crypto_hash_sha512_pick_best_implementation();
     _crypto_onetimeauth_poly1305_pick_best_implementation();
     _crypto_scalarmult_curve25519_pick_best_implementation();
+    _crypto_shorthash_siphash24_pick_best_implementation();
+#ifndef MINIMAL
+    _crypto_shorthash_siphash13_pick_best_implementation();
+#endif
     _crypto_stream_chacha20_pick_best_implementation();
     _crypto_stream_salsa20_pick_best_implementation();
-    initialized = 1;
+#ifndef MINIMAL
+    _crypto_stream_salsa2012_pick_best_implementation();
+    _crypto_stream_salsa208_pick_best_implementation();
+#endif
+    _sodium_codecs_pick_best_implementation();
+    if (tune_requested != 0) {
+        /*
+         * Timing runs Argon2 and other primitives that may take the lock
+         * themselves, so it is done with the lock released. Other callers
+         * of sodium_init() wait for the result to be published.
+         */
+        memset(chosen, 0, sizeof chosen);
+        tuning = 1;
+        if (sodium_crit_leave() != 0) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+        _sodium_implementations_tune(chosen);
+        if (sodium_crit_enter() != 0) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+        _sodium_implementations_publish(chosen);
+        tuning = 0;
+    }
+    sodium_store_release(&initialized, 1);
     if (sodium_crit_leave() != 0) {
         return -1; /* LCOV_EXCL_LINE */
     }
@@ -106,7 +209,8 @@ sodium_crit_leave(void)
     return 0;
 }
 
-#elif defined(HAVE_PTHREAD) && !defined(__EMSCRIPTEN__)
+#elif defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
 
 static pthread_mutex_t _sodium_lock = PTHREAD_MUTEX_INITIALIZER;
 
@@ -183,6 +287,550 @@ sodium_crit_leave(void)
 
 #endif
 
+static int
+_sodium_implementation_index(const char *primitive)
+{
+    size_t i;
+
+    for (i = 0U; i < IMPLEMENTATIONS_COUNT; i++) {
+        if (strcmp(implementations[i].primitive, primitive) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+int
+_sodium_implementation_allowed(const char *primitive, const char *name)
+{
+    const int i = _sodium_implementation_index(primitive);
+
+    assert(i >= 0);
+
+    return implementations[i].forced == NULL ||
+        (name != NULL && strcmp(implementations[i].forced, name) == 0);
+}
+
+void
+_sodium_implementation_selected(const char *primitive, const char *name)
+{
+    const int i = _sodium_implementation_index(primitive);
+
+    assert(i >= 0);
+    implementations[i].selected = name;
+}
+
+const char *
+sodium_implementation_name(const char *primitive)
+{
+    const int i = _sodium_implementation_index(primitive);
+
+    if (i < 0 || initialized == 0) {
+        return NULL;
+    }
+    return implementations[i].selected;
+}
+
+int
+sodium_set_implementation(const char *primitive, const char *name)
+{
+    const char *forced = NULL;
+    const int   i = _sodium_implementation_index(primitive);
+    size_t      j;
+
+    if (i < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+#ifdef FIXED_ISA
+    /* Implementations are selected at compile time */
+    errno = ENOSYS;
+    return -1;
+#endif
+#if defined(HAVE_IFUNC) && (defined(__x86_64__) || defined(__i386__))
+    /* Bound by the dynamic linker, see onetimeauth_poly1305.c */
+    if (strcmp(primitive, "poly1305") == 0) {
+        errno = ENOSYS;
+        return -1;
+    }
+#endif
+    if (name != NULL) {
+        for (j = 0U; j < IMPLEMENTATION_NAMES_MAX &&
+                     implementations[i].names[j] != NULL; j++) {
+            if (strcmp(implementations[i].names[j], name) == 0) {
+                forced = implementations[i].names[j];
+                break;
+            }
+        }
+        if (forced == NULL) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    if (sodium_crit_enter() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (initialized != 0 || tuning != 0) {
+        (void) sodium_crit_leave();
+        errno = EINVAL;
+        return -1;
+    }
+    implementations[i].forced = forced;
+    if (sodium_crit_leave() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    return 0;
+}
+
+/*
+ * Tuning times each implementation the CPU supports on a few kilobytes,
+ * keeping the best of a handful of rounds. An implementation replaces the
+ * CPUID choice only if it is at least 1/16th faster.
+ */
+
+#define TUNE_BUFBYTES 4096U
+#define TUNE_ROUNDS   5U
+
+static const unsigned char tune_zero[32];
+static unsigned char       tune_buf[TUNE_BUFBYTES];
+
+static int
+_tune_argon2(void)
+{
+    unsigned char out[crypto_pwhash_argon2id_BYTES_MIN];
+
+    return crypto_pwhash_argon2id(out, sizeof out, "tune", 4U, tune_zero,
+                                  1U, 64U * 1024U,
+                                  crypto_pwhash_argon2id_ALG_ARGON2ID13);
+}
+
+static int
+_tune_blake2b(void)
+{
+    unsigned char out[crypto_generichash_blake2b_BYTES];
+
+    return crypto_generichash_blake2b(out, sizeof out, tune_buf,
+                                      sizeof tune_buf, NULL, 0U);
+}
+
+static int
+_tune_blake3(void)
+{
+    unsigned char out[crypto_generichash_blake3_BYTES];
+
+    return crypto_generichash_blake3(out, sizeof out, tune_buf,
+                                     sizeof tune_buf, NULL, 0U);
+}
+
+static int
+_tune_chacha20(void)
+{
+    return crypto_stream_chacha20_xor(tune_buf, tune_buf, sizeof tune_buf,
+                                      tune_zero, tune_zero);
+}
+
+static int
+_tune_curve25519(void)
+{
+    static const unsigned char basepoint[crypto_scalarmult_curve25519_BYTES] = { 9 };
+    unsigned char              q[crypto_scalarmult_curve25519_BYTES];
+
+    return crypto_scalarmult_curve25519(q, tune_buf, basepoint);
+}
+
+static int
+_tune_poly1305(void)
+{
+    unsigned char mac[crypto_onetimeauth_poly1305_BYTES];
+
+    return crypto_onetimeauth_poly1305(mac, tune_buf, sizeof tune_buf,
+                                       tune_zero);
+}
+
+static int
+_tune_salsa20(void)
+{
+    return crypto_stream_salsa20_xor(tune_buf, tune_buf, sizeof tune_buf,
+                                     tune_zero, tune_zero);
+}
+
+#ifndef MINIMAL
+static int
+_tune_salsa2012(void)
+{
+    return crypto_stream_salsa2012_xor(tune_buf, tune_buf, sizeof tune_buf,
+                                       tune_zero, tune_zero);
+}
+
+# ifdef __GNUC__
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+# endif
+static int
+_tune_salsa208(void)
+{
+    return crypto_stream_salsa208_xor(tune_buf, tune_buf, sizeof tune_buf,
+                                      tune_zero, tune_zero);
+}
+# ifdef __GNUC__
+#  pragma GCC diagnostic pop
+# endif
+#endif
+
+static const struct {
+    const char  *primitive;
+    int        (*pick)(void);
+    int        (*run)(void);
+    unsigned int iterations;
+} tunables[] = {
+    { "argon2", _crypto_pwhash_argon2_pick_best_implementation,
+      _tune_argon2, 1U },
+    { "blake2b", _crypto_generichash_blake2b_pick_best_implementation,
+      _tune_blake2b, 4U },
+    { "blake3", _crypto_generichash_blake3_pick_best_implementation,
+      _tune_blake3, 4U },
+    { "chacha20", _crypto_stream_chacha20_pick_best_implementation,
+      _tune_chacha20, 4U },
+    { "curve25519", _crypto_scalarmult_curve25519_pick_best_implementation,
+      _tune_curve25519, 1U },
+    { "poly1305", _crypto_onetimeauth_poly1305_pick_best_implementation,
+      _tune_poly1305, 8U },
+    { "salsa20", _crypto_stream_salsa20_pick_best_implementation,
+      _tune_salsa20, 4U },
+#ifndef MINIMAL
+    { "salsa2012", _crypto_stream_salsa2012_pick_best_implementation,
+      _tune_salsa2012, 4U },
+    { "salsa208", _crypto_stream_salsa208_pick_best_implementation,
+      _tune_salsa208, 4U },
+#endif
+};
+
+/* Nanoseconds, or 0 without a monotonic clock */
+static uint64_t
+_tune_hrtime(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count;
+    LARGE_INTEGER freq;
+
+    if (QueryPerformanceFrequency(&freq) == 0 || freq.QuadPart <= 0 ||
+        QueryPerformanceCounter(&count) == 0) {
+        return 0U; /* LCOV_EXCL_LINE */
+    }
+    return (uint64_t) (count.QuadPart / freq.QuadPart) * 1000000000U +
+           (uint64_t) (count.QuadPart % freq.QuadPart) * 1000000000U /
+           (uint64_t) freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0U; /* LCOV_EXCL_LINE */
+    }
+    return (uint64_t) ts.tv_sec * 1000000000U + (uint64_t) ts.tv_nsec;
+#else
+    return 0U;
+#endif
+}
+
+static uint64_t
+_tune_time(const size_t t)
+{
+    uint64_t     best = UINT64_MAX;
+    uint64_t     t0;
+    uint64_t     d;
+    unsigned int i;
+    unsigned int j;
+
+    (void) tunables[t].run();
+    for (i = 0U; i < TUNE_ROUNDS; i++) {
+        t0 = _tune_hrtime();
+        for (j = 0U; j < tunables[t].iterations; j++) {
+            (void) tunables[t].run();
+        }
+        if ((d = _tune_hrtime() - t0) < best) {
+            best = d;
+        }
+    }
+    return best;
+}
+
+/* Selects name if the CPU supports it, returns 0 on success */
+static int
+_tune_select(const size_t t, const int i, const char *name)
+{
+    implementations[i].forced = name;
+    (void) tunables[t].pick();
+    if (implementations[i].selected != NULL &&
+        strcmp(implementations[i].selected, name) == 0) {
+        return 0;
+    }
+    implementations[i].forced = NULL;
+    (void) tunables[t].pick();
+
+    return -1;
+}
+
+/* Returns the fastest implementation; the last one timed stays selected */
+static const char *
+_tune_primitive(const size_t t, const int i)
+{
+    const char *best_name = implementations[i].selected;
+    const char *name;
+    uint64_t    best;
+    uint64_t    d;
+    size_t      j;
+
+    if (best_name == NULL) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    best = _tune_time(t);
+    for (j = 0U; j < IMPLEMENTATION_NAMES_MAX &&
+                 (name = implementations[i].names[j]) != NULL; j++) {
+        if (strcmp(name, best_name) == 0 || _tune_select(t, i, name) != 0) {
+            continue;
+        }
+        if ((d = _tune_time(t)) < best - best / 16U) {
+            best      = d;
+            best_name = name;
+        }
+    }
+    return best_name;
+}
+
+/* Called without the lock; the choices are applied by the publish step */
+static void
+_sodium_implementations_tune(const char *chosen[IMPLEMENTATIONS_COUNT])
+{
+    const int use_profile = profile_valid != 0 &&
+        profile_signature == _sodium_runtime_cpu_signature();
+    size_t    t;
+    int       i;
+
+    if (use_profile == 0 && _tune_hrtime() == 0U) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    for (t = 0U; t < sizeof tunables / sizeof tunables[0]; t++) {
+        i = _sodium_implementation_index(tunables[t].primitive);
+        assert(i >= 0);
+        if (implementations[i].forced != NULL) {
+            continue;
+        }
+        if (use_profile != 0) {
+            chosen[i] = profiled[i];
+        } else {
+            chosen[i] = _tune_primitive(t, i);
+        }
+    }
+    sodium_memzero(tune_buf, sizeof tune_buf);
+}
+
+/* Called with the lock held */
+static void
+_sodium_implementations_publish(const char *chosen[IMPLEMENTATIONS_COUNT])
+{
+    size_t t;
+    int    i;
+
+    for (t = 0U; t < sizeof tunables / sizeof tunables[0]; t++) {
+        i = _sodium_implementation_index(tunables[t].primitive);
+        assert(i >= 0);
+        if (chosen[i] != NULL) {
+            (void) _tune_select(t, i, chosen[i]);
+        }
+    }
+}
+
+/*
+ * Called with the lock held while another thread is tuning. Returns with
+ * the lock held once that thread has published its choices.
+ */
+static int
+_sodium_tune_wait(void)
+{
+#ifdef HAVE_NANOSLEEP
+    struct timespec q;
+
+    memset(&q, 0, sizeof q);
+    q.tv_nsec = 1000000L;
+#endif
+    do {
+        if (sodium_crit_leave() != 0) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+#ifdef _WIN32
+        Sleep(1);
+#elif defined(HAVE_NANOSLEEP)
+        (void) nanosleep(&q, NULL);
+#endif
+        if (sodium_crit_enter() != 0) {
+            return -1; /* LCOV_EXCL_LINE */
+        }
+    } while (tuning != 0);
+
+    return 0;
+}
+
+static const char *
+_profile_name(const int i, const char *name, const size_t name_len)
+{
+    size_t j;
+
+    for (j = 0U; j < IMPLEMENTATION_NAMES_MAX &&
+                 implementations[i].names[j] != NULL; j++) {
+        if (strlen(implementations[i].names[j]) == name_len &&
+            memcmp(implementations[i].names[j], name, name_len) == 0) {
+            return implementations[i].names[j];
+        }
+    }
+    return NULL;
+}
+
+/*
+ * A profile is "cpu=<8 hex digits>" followed by "<primitive>=<name>" words.
+ * Unknown primitives and implementations are ignored, so that profiles
+ * survive library upgrades.
+ */
+static int
+_profile_parse(const char *profile, unsigned int *signature_p,
+               const char *names[IMPLEMENTATIONS_COUNT])
+{
+    char         primitive[16];
+    const char  *word;
+    const char  *eq;
+    size_t       len;
+    unsigned int signature = 0U;
+    int          c;
+    int          i;
+    int          j;
+
+    if (strncmp(profile, "cpu=", 4U) != 0) {
+        return -1;
+    }
+    for (j = 0; j < 8; j++) {
+        c = (unsigned char) profile[4 + j];
+        if (c >= '0' && c <= '9') {
+            c -= '0';
+        } else if (c >= 'a' && c <= 'f') {
+            c -= 'a' - 10;
+        } else {
+            return -1;
+        }
+        signature = (signature << 4) | (unsigned int) c;
+    }
+    word = profile + 12;
+    while (*word == ' ') {
+        while (*word == ' ') {
+            word++;
+        }
+        if (*word == 0) {
+            break;
+        }
+        for (len = 0U; word[len] != 0 && word[len] != ' '; len++) {
+        }
+        if ((eq = (const char *) memchr(word, '=', len)) == NULL ||
+            eq == word) {
+            return -1;
+        }
+        if ((size_t) (eq - word) < sizeof primitive) {
+            memcpy(primitive, word, (size_t) (eq - word));
+            primitive[eq - word] = 0;
+            if ((i = _sodium_implementation_index(primitive)) >= 0) {
+                names[i] = _profile_name(i, eq + 1,
+                                         len - (size_t) (eq - word) - 1U);
+            }
+        }
+        word += len;
+    }
+    if (*word != 0) {
+        return -1;
+    }
+    *signature_p = signature;
+
+    return 0;
+}
+
+int
+sodium_tune_implementations(const char *profile)
+{
+    const char  *names[IMPLEMENTATIONS_COUNT];
+    unsigned int signature = 0U;
+    int          valid = 0;
+
+#ifdef FIXED_ISA
+    (void) profile;
+    errno = ENOSYS;
+    return -1;
+#endif
+    memset(names, 0, sizeof names);
+    if (profile != NULL) {
+        if (_profile_parse(profile, &signature, names) != 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        valid = 1;
+    }
+    if (sodium_crit_enter() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (initialized != 0 || tuning != 0) {
+        (void) sodium_crit_leave();
+        errno = EINVAL;
+        return -1;
+    }
+    memcpy(profiled, names, sizeof profiled);
+    profile_signature = signature;
+    profile_valid     = valid;
+    tune_requested    = 1;
+    if (sodium_crit_leave() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    return 0;
+}
+
+int
+sodium_implementation_profile(char *profile, size_t profile_maxlen)
+{
+    static const char hex[16] = "0123456789abcdef";
+    unsigned int      signature;
+    size_t            len;
+    size_t            pos;
+    size_t            i;
+    int               j;
+
+    if (initialized == 0 || profile_maxlen < 13U) {
+        errno = EINVAL;
+        return -1;
+    }
+    signature = _sodium_runtime_cpu_signature();
+    memcpy(profile, "cpu=", 4U);
+    for (j = 0; j < 8; j++) {
+        profile[4 + j] = hex[(signature >> (28 - 4 * j)) & 0xf];
+    }
+    pos = 12U;
+    for (i = 0U; i < IMPLEMENTATIONS_COUNT; i++) {
+        if (implementations[i].selected == NULL) {
+            continue;
+        }
+        len = strlen(implementations[i].primitive);
+        if (profile_maxlen - pos <= len + 2U +
+            strlen(implementations[i].selected)) {
+            profile[0] = 0;
+            errno = ERANGE;
+            return -1;
+        }
+        profile[pos++] = ' ';
+        memcpy(profile + pos, implementations[i].primitive, len);
+        pos += len;
+        profile[pos++] = '=';
+        len = strlen(implementations[i].selected);
+        memcpy(profile + pos, implementations[i].selected, len);
+        pos += len;
+    }
+    profile[pos] = 0;
+
+    return 0;
+}
+
 static void (*_misuse_handler)(void);
 
 void
@@ -0,0 +1,139 @@
+#include <errno.h>
+#include <stdlib.h>
+
+#if defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+# include <pthread.h>
+# define EXECUTOR_HAVE_THREADS
+#endif
+
+#include "core.h"
+#include "private/common.h"
+#include "private/executor.h"
+#include "private/mutex.h"
+
+#ifdef EXECUTOR_HAVE_THREADS
+typedef struct thread_task {
+    pthread_t          thread;
+    sodium_executor_fn fn;
+    void              *arg;
+} thread_task;
+
+static void *
+thread_task_run(void *task_)
+{
+    thread_task *task = (thread_task *) task_;
+
+    task->fn(task->arg);
+
+    return NULL;
+}
+
+static void *
+thread_submit(void *ctx, sodium_executor_fn fn, void *arg)
+{
+    thread_task *task;
+
+    (void) ctx;
+    if ((task = (thread_task *) malloc(sizeof *task)) == NULL) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    task->fn  = fn;
+    task->arg = arg;
+    if (pthread_create(&task->thread, NULL, thread_task_run, task) != 0) {
+        free(task); /* LCOV_EXCL_LINE */
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    return task;
+}
+
+static void
+thread_wait(void *ctx, void *task_)
+{
+    thread_task *task = (thread_task *) task_;
+
+    (void) ctx;
+    pthread_join(task->thread, NULL);
+    free(task);
+}
+# define EXECUTOR_DEFAULT_SUBMIT thread_submit
+# define EXECUTOR_DEFAULT_WAIT   thread_wait
+#else
+# define EXECUTOR_DEFAULT_SUBMIT NULL
+# define EXECUTOR_DEFAULT_WAIT   NULL
+#endif
+
+static struct {
+    sodium_executor_submit_fn submit;
+    sodium_executor_wait_fn   wait;
+    void                     *ctx;
+    unsigned int              max_parallelism;
+} executor = { EXECUTOR_DEFAULT_SUBMIT, EXECUTOR_DEFAULT_WAIT, NULL, 0U };
+
+int
+sodium_set_executor(sodium_executor_submit_fn submit,
+                    sodium_executor_wait_fn wait, void *ctx,
+                    unsigned int max_parallelism)
+{
+    if ((submit == NULL) != (wait == NULL)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (sodium_crit_enter() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (submit == NULL) {
+        executor.submit = EXECUTOR_DEFAULT_SUBMIT;
+        executor.wait   = EXECUTOR_DEFAULT_WAIT;
+        executor.ctx    = NULL;
+    } else {
+        executor.submit = submit;
+        executor.wait   = wait;
+        executor.ctx    = ctx;
+    }
+    executor.max_parallelism = max_parallelism;
+    if (sodium_crit_leave() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    return 0;
+}
+
+unsigned int
+_sodium_executor_threads(unsigned int threads)
+{
+    if (executor.submit == NULL) {
+        return 1U;
+    }
+    if (executor.max_parallelism > 0U && threads > executor.max_parallelism) {
+        threads = executor.max_parallelism;
+    }
+    if (threads < 1U) {
+        threads = 1U;
+    }
+    return threads;
+}
+
+void
+_sodium_executor_start(sodium_executor_task *task, sodium_executor_fn fn,
+                       void *arg)
+{
+    task->fn     = fn;
+    task->arg    = arg;
+    task->handle = NULL;
+    task->wait   = executor.wait;
+    task->ctx    = executor.ctx;
+    if (executor.submit != NULL) {
+        task->handle = executor.submit(executor.ctx, fn, arg);
+    }
+}
+
+void
+_sodium_executor_finish(sodium_executor_task *task)
+{
+    if (task->handle == NULL) {
+        task->fn(task->arg);
+    } else {
+        task->wait(task->ctx, task->handle);
+    }
+    task->handle = NULL;
+}
@@ -0,0 +1,508 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+
+#if defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+# include <pthread.h>
+# define JOBS_HAVE_THREADS
+#endif
+
+#include "core.h"
+#include "crypto_aead_aes256gcm.h"
+#include "crypto_aead_chacha20poly1305.h"
+#include "crypto_aead_xchacha20poly1305.h"
+#include "crypto_pwhash.h"
+#include "crypto_scalarmult_curve25519.h"
+#include "crypto_sign_ed25519.h"
+#include "jobs.h"
+#include "private/common.h"
+#include "utils.h"
+
+struct sodium_job_queue {
+#ifdef JOBS_HAVE_THREADS
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+    pthread_t      *threads;
+#endif
+    sodium_job     *head;
+    sodium_job     *tail;
+    size_t          max_batch;
+    unsigned int    workers;
+    int             stopping;
+};
+
+static void
+_queue_lock(sodium_job_queue *queue)
+{
+#ifdef JOBS_HAVE_THREADS
+    if (pthread_mutex_lock(&queue->mutex) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+#else
+    (void) queue;
+#endif
+}
+
+static void
+_queue_unlock(sodium_job_queue *queue)
+{
+#ifdef JOBS_HAVE_THREADS
+    if (pthread_mutex_unlock(&queue->mutex) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+#else
+    (void) queue;
+#endif
+}
+
+static int
+_job_op_valid(int op)
+{
+    switch (op) {
+    case SODIUM_JOB_SIGN_ED25519_VERIFY:
+    case SODIUM_JOB_SCALARMULT_CURVE25519:
+    case SODIUM_JOB_PWHASH_STR_VERIFY:
+    case SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT:
+    case SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_DECRYPT:
+    case SODIUM_JOB_AEAD_AES256GCM_ENCRYPT:
+    case SODIUM_JOB_AEAD_AES256GCM_DECRYPT:
+    case SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_ENCRYPT:
+    case SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_DECRYPT:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* Encryptions can only be batched if they use the same key */
+static int
+_jobs_batchable(const sodium_job *first, const sodium_job *job)
+{
+    if (job->op != first->op) {
+        return 0;
+    }
+    if (job->op != SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT) {
+        return 1;
+    }
+    return job->args.aead.k == first->args.aead.k ||
+        sodium_memcmp(job->args.aead.k, first->args.aead.k,
+                      crypto_aead_xchacha20poly1305_ietf_KEYBYTES) == 0;
+}
+
+/*
+ * Removes the oldest job, and the queued jobs that can be batched with it,
+ * from the queue. Must be called with the lock held, on a non-empty queue.
+ */
+static size_t
+_queue_take_batch(sodium_job_queue *queue, sodium_job **batch)
+{
+    sodium_job *first = queue->head;
+    sodium_job *prev  = NULL;
+    sodium_job *job;
+    size_t      count = 1U;
+
+    batch[0] = first;
+    queue->head = first->next_;
+    if (queue->head == NULL) {
+        queue->tail = NULL;
+    }
+    job = queue->head;
+    while (job != NULL && count < queue->max_batch) {
+        if (_jobs_batchable(first, job)) {
+            batch[count++] = job;
+            if (prev == NULL) {
+                queue->head = job->next_;
+            } else {
+                prev->next_ = job->next_;
+            }
+            if (queue->tail == job) {
+                queue->tail = prev;
+            }
+        } else {
+            prev = job;
+        }
+        job = job->next_;
+    }
+    return count;
+}
+
+static void
+_run_sign_verify(sodium_job **batch, size_t count)
+{
+    const unsigned char *sigs[SODIUM_JOB_BATCH_MAX];
+    const unsigned char *ms[SODIUM_JOB_BATCH_MAX];
+    unsigned long long   mlens[SODIUM_JOB_BATCH_MAX];
+    const unsigned char *pks[SODIUM_JOB_BATCH_MAX];
+    int                  results[SODIUM_JOB_BATCH_MAX];
+    size_t               i;
+    int                  ret;
+
+    assert(count > 0U);
+
+    for (i = 0U; i < count; i++) {
+        sigs[i]  = batch[i]->args.sign_verify.sig;
+        ms[i]    = batch[i]->args.sign_verify.m;
+        mlens[i] = batch[i]->args.sign_verify.mlen;
+        pks[i]   = batch[i]->args.sign_verify.pk;
+    }
+    ret = crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, count,
+                                           results);
+    for (i = 0U; i < count; i++) {
+        batch[i]->result = ret == 0 ? 0 : results[i];
+    }
+}
+
+static void
+_run_scalarmult(sodium_job **batch, size_t count)
+{
+    unsigned char       *qs[SODIUM_JOB_BATCH_MAX];
+    const unsigned char *ns[SODIUM_JOB_BATCH_MAX];
+    const unsigned char *ps[SODIUM_JOB_BATCH_MAX];
+    size_t               i;
+    int                  ret;
+
+    assert(count > 0U);
+
+    for (i = 0U; i < count; i++) {
+        qs[i] = batch[i]->args.scalarmult.q;
+        ns[i] = batch[i]->args.scalarmult.n;
+        ps[i] = batch[i]->args.scalarmult.p;
+    }
+    ret = crypto_scalarmult_curve25519_batch(qs, ns, ps, count);
+    for (i = 0U; i < count; i++) {
+        batch[i]->result = 0;
+        if (ret != 0 &&
+            sodium_is_zero(qs[i], crypto_scalarmult_curve25519_BYTES)) {
+            batch[i]->result = -1;
+        }
+    }
+}
+
+static void
+_run_pwhash_str_verify(sodium_job **batch, size_t count)
+{
+    const char         *strs[SODIUM_JOB_BATCH_MAX];
+    const char         *passwds[SODIUM_JOB_BATCH_MAX];
+    unsigned long long  passwdlens[SODIUM_JOB_BATCH_MAX];
+    int                 results[SODIUM_JOB_BATCH_MAX];
+    size_t              i;
+
+    assert(count > 0U);
+
+    for (i = 0U; i < count; i++) {
+        strs[i]       = batch[i]->args.pwhash_str_verify.str;
+        passwds[i]    = batch[i]->args.pwhash_str_verify.passwd;
+        passwdlens[i] = batch[i]->args.pwhash_str_verify.passwdlen;
+    }
+    if (crypto_pwhash_str_verify_many(results, strs, passwds, passwdlens,
+                                      count, 1U) == 0) {
+        for (i = 0U; i < count; i++) {
+            batch[i]->result = results[i];
+        }
+        return;
+    }
+    /* LCOV_EXCL_START */
+    for (i = 0U; i < count; i++) {
+        batch[i]->result =
+            crypto_pwhash_str_verify(strs[i], passwds[i], passwdlens[i]);
+    }
+    /* LCOV_EXCL_STOP */
+}
+
+static int
+_run_aead_encrypt_one(sodium_job *job)
+{
+    return crypto_aead_xchacha20poly1305_ietf_encrypt
+        (job->args.aead.out, NULL, job->args.aead.in, job->args.aead.inlen,
+         job->args.aead.ad, job->args.aead.adlen, NULL, job->args.aead.npub,
+         job->args.aead.k);
+}
+
+static void
+_run_aead_encrypt(sodium_job **batch, size_t count)
+{
+    unsigned char       *cs[SODIUM_JOB_BATCH_MAX];
+    const unsigned char *ms[SODIUM_JOB_BATCH_MAX];
+    unsigned long long   mlens[SODIUM_JOB_BATCH_MAX];
+    const unsigned char *ads[SODIUM_JOB_BATCH_MAX];
+    unsigned long long   adlens[SODIUM_JOB_BATCH_MAX];
+    const unsigned char *npubs[SODIUM_JOB_BATCH_MAX];
+    size_t               i;
+
+    assert(count > 0U);
+
+    if (count == 1U) {
+        batch[0]->result = _run_aead_encrypt_one(batch[0]);
+        return;
+    }
+    for (i = 0U; i < count; i++) {
+        cs[i]     = batch[i]->args.aead.out;
+        ms[i]     = batch[i]->args.aead.in;
+        mlens[i]  = batch[i]->args.aead.inlen;
+        ads[i]    = batch[i]->args.aead.ad;
+        adlens[i] = batch[i]->args.aead.adlen;
+        npubs[i]  = batch[i]->args.aead.npub;
+    }
+    if (crypto_aead_xchacha20poly1305_ietf_encrypt_batch
+        (cs, ms, mlens, ads, adlens, npubs, count, batch[0]->args.aead.k) == 0) {
+        for (i = 0U; i < count; i++) {
+            batch[i]->result = 0;
+        }
+        return;
+    }
+    /* find out which of the messages couldn't be encrypted */
+    for (i = 0U; i < count; i++) {
+        batch[i]->result = _run_aead_encrypt_one(batch[i]);
+    }
+}
+
+static void
+_run_aead_decrypt(sodium_job **batch, size_t count)
+{
+    sodium_job *job;
+    size_t      i;
+
+    for (i = 0U; i < count; i++) {
+        job = batch[i];
+        job->result = crypto_aead_xchacha20poly1305_ietf_decrypt
+            (job->args.aead.out, NULL, NULL, job->args.aead.in,
+             job->args.aead.inlen, job->args.aead.ad, job->args.aead.adlen,
+             job->args.aead.npub, job->args.aead.k);
+    }
+}
+
+static int
+_run_aead_single(const sodium_job *job)
+{
+    switch (job->op) {
+    case SODIUM_JOB_AEAD_AES256GCM_ENCRYPT:
+        return crypto_aead_aes256gcm_encrypt
+            (job->args.aead.out, NULL, job->args.aead.in, job->args.aead.inlen,
+             job->args.aead.ad, job->args.aead.adlen, NULL,
+             job->args.aead.npub, job->args.aead.k);
+    case SODIUM_JOB_AEAD_AES256GCM_DECRYPT:
+        return crypto_aead_aes256gcm_decrypt
+            (job->args.aead.out, NULL, NULL, job->args.aead.in,
+             job->args.aead.inlen, job->args.aead.ad, job->args.aead.adlen,
+             job->args.aead.npub, job->args.aead.k);
+    case SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_ENCRYPT:
+        return crypto_aead_chacha20poly1305_ietf_encrypt
+            (job->args.aead.out, NULL, job->args.aead.in, job->args.aead.inlen,
+             job->args.aead.ad, job->args.aead.adlen, NULL,
+             job->args.aead.npub, job->args.aead.k);
+    case SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_DECRYPT:
+        return crypto_aead_chacha20poly1305_ietf_decrypt
+            (job->args.aead.out, NULL, NULL, job->args.aead.in,
+             job->args.aead.inlen, job->args.aead.ad, job->args.aead.adlen,
+             job->args.aead.npub, job->args.aead.k);
+    default:
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    return -1; /* LCOV_EXCL_LINE */
+}
+
+static void
+_run_batch(sodium_job **batch, size_t count)
+{
+    size_t i;
+
+    switch (batch[0]->op) {
+    case SODIUM_JOB_SIGN_ED25519_VERIFY:
+        _run_sign_verify(batch, count);
+        break;
+    case SODIUM_JOB_SCALARMULT_CURVE25519:
+        _run_scalarmult(batch, count);
+        break;
+    case SODIUM_JOB_PWHASH_STR_VERIFY:
+        _run_pwhash_str_verify(batch, count);
+        break;
+    case SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT:
+        _run_aead_encrypt(batch, count);
+        break;
+    case SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_DECRYPT:
+        _run_aead_decrypt(batch, count);
+        break;
+    case SODIUM_JOB_AEAD_AES256GCM_ENCRYPT:
+    case SODIUM_JOB_AEAD_AES256GCM_DECRYPT:
+    case SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_ENCRYPT:
+    case SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_DECRYPT:
+        for (i = 0U; i < count; i++) {
+            batch[i]->result = _run_aead_single(batch[i]);
+        }
+        break;
+    default:
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    /* a job may be submitted again by its completion function */
+    for (i = 0U; i < count; i++) {
+        if (batch[i]->completion != NULL) {
+            batch[i]->completion(batch[i]);
+        }
+    }
+}
+
+size_t
+sodium_job_queue_run(sodium_job_queue *queue)
+{
+    sodium_job *batch[SODIUM_JOB_BATCH_MAX];
+    size_t      count;
+    size_t      total = 0U;
+
+    _queue_lock(queue);
+    while (queue->head != NULL) {
+        count = _queue_take_batch(queue, batch);
+        _queue_unlock(queue);
+        _run_batch(batch, count);
+        total += count;
+        _queue_lock(queue);
+    }
+    _queue_unlock(queue);
+
+    return total;
+}
+
+#ifdef JOBS_HAVE_THREADS
+static void *
+_queue_worker(void *queue_)
+{
+    sodium_job_queue *queue = (sodium_job_queue *) queue_;
+    sodium_job       *batch[SODIUM_JOB_BATCH_MAX];
+    size_t            count;
+
+    _queue_lock(queue);
+    for (;;) {
+        while (queue->head == NULL && queue->stopping == 0) {
+            if (pthread_cond_wait(&queue->cond, &queue->mutex) != 0) {
+                sodium_misuse(); /* LCOV_EXCL_LINE */
+            }
+        }
+        if (queue->head == NULL) {
+            break;
+        }
+        count = _queue_take_batch(queue, batch);
+        _queue_unlock(queue);
+        _run_batch(batch, count);
+        _queue_lock(queue);
+    }
+    _queue_unlock(queue);
+
+    return NULL;
+}
+
+static void
+_queue_stop_workers(sodium_job_queue *queue, unsigned int started)
+{
+    unsigned int i;
+
+    _queue_lock(queue);
+    queue->stopping = 1;
+    (void) pthread_cond_broadcast(&queue->cond);
+    _queue_unlock(queue);
+    for (i = 0U; i < started; i++) {
+        (void) pthread_join(queue->threads[i], NULL);
+    }
+}
+#endif
+
+sodium_job_queue *
+sodium_job_queue_create(unsigned int workers, size_t max_batch)
+{
+    sodium_job_queue *queue;
+#ifdef JOBS_HAVE_THREADS
+    unsigned int      i;
+    int               err;
+#else
+    if (workers > 0U) {
+        errno = ENOSYS;
+        return NULL;
+    }
+#endif
+    if ((queue = (sodium_job_queue *) calloc(1U, sizeof *queue)) == NULL) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    if (max_batch == 0U || max_batch > SODIUM_JOB_BATCH_MAX) {
+        max_batch = SODIUM_JOB_BATCH_MAX;
+    }
+    queue->max_batch = max_batch;
+    queue->workers   = workers;
+#ifdef JOBS_HAVE_THREADS
+    if (pthread_mutex_init(&queue->mutex, NULL) != 0) {
+        free(queue); /* LCOV_EXCL_LINE */
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    if (pthread_cond_init(&queue->cond, NULL) != 0) {
+        /* LCOV_EXCL_START */
+        (void) pthread_mutex_destroy(&queue->mutex);
+        free(queue);
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    if (workers > 0U &&
+        (queue->threads = (pthread_t *)
+         calloc((size_t) workers, sizeof queue->threads[0])) == NULL) {
+        queue->workers = 0U;
+        sodium_job_queue_destroy(queue);
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (i = 0U; i < workers; i++) {
+        if ((err = pthread_create(&queue->threads[i], NULL, _queue_worker,
+                                  queue)) != 0) {
+            /* LCOV_EXCL_START */
+            _queue_stop_workers(queue, i);
+            queue->workers = 0U;
+            sodium_job_queue_destroy(queue);
+            errno = err;
+            return NULL;
+            /* LCOV_EXCL_STOP */
+        }
+    }
+#endif
+    return queue;
+}
+
+void
+sodium_job_queue_destroy(sodium_job_queue *queue)
+{
+    if (queue == NULL) {
+        return;
+    }
+#ifdef JOBS_HAVE_THREADS
+    if (queue->workers > 0U) {
+        _queue_stop_workers(queue, queue->workers);
+    }
+#endif
+    (void) sodium_job_queue_run(queue);
+#ifdef JOBS_HAVE_THREADS
+    free(queue->threads);
+    (void) pthread_cond_destroy(&queue->cond);
+    (void) pthread_mutex_destroy(&queue->mutex);
+#endif
+    free(queue);
+}
+
+int
+sodium_job_submit(sodium_job_queue *queue, sodium_job *job)
+{
+    if (!_job_op_valid(job->op)) {
+        errno = EINVAL;
+        return -1;
+    }
+    job->next_ = NULL;
+    _queue_lock(queue);
+    if (queue->tail == NULL) {
+        queue->head = job;
+    } else {
+        queue->tail->next_ = job;
+    }
+    queue->tail = job;
+#ifdef JOBS_HAVE_THREADS
+    if (queue->workers > 0U) {
+        (void) pthread_cond_signal(&queue->cond);
+    }
+#endif
+    _queue_unlock(queue);
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core.h"
+#include "private/common.h"
+#include "private/mutex.h"
+#include "private/offload.h"
+
+#define OFFLOAD_KNOWN_OPS \
+    (SODIUM_OFFLOAD_AEAD_AES256GCM | SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF)
+
+/*
+ * AEAD calls read the current provider without the lock. A provider is
+ * published as an immutable record through a single pointer, so that a
+ * call sees either the previous record or the new one as a whole.
+ * Records are never freed, since a call may still be using a previous
+ * one; identical registrations reuse the same record.
+ */
+typedef struct offload_record_ {
+    sodium_offload_provider  provider;
+    size_t                   min_bytes;
+    unsigned int             capabilities;
+    struct offload_record_  *next;
+} offload_record;
+
+static offload_record *offload_records; /* every record, with the lock held */
+static void *volatile  offload_current;
+
+static const offload_record *
+_offload_get(void)
+{
+    return (const offload_record *) sodium_load_acquire_ptr(&offload_current);
+}
+
+static offload_record *
+_offload_record(const sodium_offload_provider *provider, size_t min_bytes,
+                unsigned int capabilities)
+{
+    offload_record *record;
+
+    for (record = offload_records; record != NULL; record = record->next) {
+        if (record->provider.capabilities == provider->capabilities &&
+            record->provider.aead_encrypt == provider->aead_encrypt &&
+            record->provider.aead_decrypt == provider->aead_decrypt &&
+            record->provider.ctx == provider->ctx &&
+            record->min_bytes == min_bytes &&
+            record->capabilities == capabilities) {
+            return record;
+        }
+    }
+    if ((record = (offload_record *) malloc(sizeof *record)) == NULL) {
+        /* LCOV_EXCL_START */
+        errno = ENOMEM;
+        return NULL;
+        /* LCOV_EXCL_STOP */
+    }
+    record->provider     = *provider;
+    record->min_bytes    = min_bytes;
+    record->capabilities = capabilities;
+    record->next         = offload_records;
+    offload_records      = record;
+
+    return record;
+}
+
+int
+sodium_set_offload_provider(const sodium_offload_provider *provider,
+                            size_t min_bytes)
+{
+    offload_record *record = NULL;
+    unsigned int    capabilities = 0U;
+
+    if (provider != NULL) {
+        if (provider->capabilities == NULL ||
+            provider->aead_encrypt == NULL || provider->aead_decrypt == NULL) {
+            errno = EINVAL;
+            return -1;
+        }
+        capabilities = provider->capabilities(provider->ctx) & OFFLOAD_KNOWN_OPS;
+    }
+    if (sodium_crit_enter() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    if (provider != NULL &&
+        (record = _offload_record(provider, min_bytes, capabilities)) == NULL) {
+        /* LCOV_EXCL_START */
+        (void) sodium_crit_leave();
+        return -1;
+        /* LCOV_EXCL_STOP */
+    }
+    sodium_store_release_ptr(&offload_current, (void *) record);
+    if (sodium_crit_leave() != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    return 0;
+}
+
+unsigned int
+sodium_offload_capabilities(void)
+{
+    const offload_record *record = _offload_get();
+
+    return record == NULL ? 0U : record->capabilities;
+}
+
+int
+_sodium_offload_aead_encrypt(unsigned int op, unsigned char *c,
+                             unsigned char *mac, const unsigned char *m,
+                             unsigned long long mlen,
+                             const unsigned char *ad,
+                             unsigned long long adlen,
+                             const unsigned char *npub,
+                             const unsigned char *k)
+{
+    const offload_record *record = _offload_get();
+
+    if (record == NULL || (record->capabilities & op) == 0U ||
+        mlen < (unsigned long long) record->min_bytes) {
+        return SODIUM_OFFLOAD_DECLINED;
+    }
+    if (record->provider.aead_encrypt(record->provider.ctx, op, c, mac,
+                                      m, mlen, ad, adlen, npub, k) != 0) {
+        return SODIUM_OFFLOAD_DECLINED;
+    }
+    return 0;
+}
+
+int
+_sodium_offload_aead_decrypt(unsigned int op, unsigned char *m,
+                             const unsigned char *c,
+                             unsigned long long clen,
+                             const unsigned char *mac,
+                             const unsigned char *ad,
+                             unsigned long long adlen,
+                             const unsigned char *npub,
+                             const unsigned char *k)
+{
+    const offload_record *record = _offload_get();
+    int                   ret;
+
+    if (record == NULL || (record->capabilities & op) == 0U || m == NULL ||
+        clen < (unsigned long long) record->min_bytes) {
+        return SODIUM_OFFLOAD_DECLINED;
+    }
+    ret = record->provider.aead_decrypt(record->provider.ctx, op, m, c, clen,
+                                        mac, ad, adlen, npub, k);
+    if (ret > 0) {
+        return SODIUM_OFFLOAD_DECLINED;
+    }
+    if (ret != 0) {
+        memset(m, 0, clen);
+        return -1;
+    }
+    return 0;
+}
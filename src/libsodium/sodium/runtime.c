@@ -1,3 +1,4 @@
+#include <errno.h>
 #include <stddef.h>
 #include <stdint.h>
 #ifdef HAVE_ANDROID_GETCPUFEATURES
@@ -11,6 +12,10 @@
 #ifdef HAVE_SYS_AUXV_H
 # include <sys/auxv.h>
 #endif
+#if defined(__riscv) && defined(__linux__)
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
 
 #include "private/common.h"
 #include "runtime.h"
@@ -19,22 +24,46 @@ typedef struct CPUFeatures_ {
     int initialized;
     int has_neon;
     int has_armcrypto;
+    int has_armsha2;
+    int has_armsha512;
+    int has_rndr;
+    int has_vsx;
+    int has_rvv;
     int has_sse2;
     int has_sse3;
     int has_ssse3;
     int has_sse41;
     int has_avx;
     int has_avx2;
+    int has_bmi2;
     int has_avx512f;
+    int has_avx512vl;
+    int has_avx512ifma;
+    int has_vaes;
+    int has_vpclmulqdq;
+    int has_shani;
     int has_pclmul;
     int has_aesni;
     int has_rdrand;
+    int has_rdseed;
+    int avx512_downclocks;
+    uint32_t signature;
 } CPUFeatures;
 
 static CPUFeatures _cpu_features;
 
-#define CPUID_EBX_AVX2    0x00000020
-#define CPUID_EBX_AVX512F 0x00010000
+static int _vector_policy = SODIUM_RUNTIME_VECTOR_POLICY_AUTO;
+
+#define CPUID_EBX_AVX2       0x00000020
+#define CPUID_EBX_BMI2       0x00000100
+#define CPUID_EBX_AVX512F    0x00010000
+#define CPUID_EBX_RDSEED     0x00040000
+#define CPUID_EBX_AVX512IFMA 0x00200000
+#define CPUID_EBX_SHA        0x20000000
+#define CPUID_EBX_AVX512VL   0x80000000
+
+#define CPUID_ECX_VAES       0x00000200
+#define CPUID_ECX_VPCLMULQDQ 0x00000400
 
 #define CPUID_ECX_SSE3    0x00000001
 #define CPUID_ECX_PCLMUL  0x00000002
@@ -59,6 +88,9 @@ _sodium_runtime_arm_cpu_features(CPUFeatures * const cpu_features)
 {
     cpu_features->has_neon = 0;
     cpu_features->has_armcrypto = 0;
+    cpu_features->has_armsha2 = 0;
+    cpu_features->has_armsha512 = 0;
+    cpu_features->has_rndr = 0;
 
 #ifndef __ARM_ARCH
     return -1; /* LCOV_EXCL_LINE */
@@ -91,6 +123,21 @@ _sodium_runtime_arm_cpu_features(CPUFeatures * const cpu_features)
         }
     }
 # endif
+#endif
+
+#if __ARM_FEATURE_RNG
+    cpu_features->has_rndr = 1;
+#elif defined(__aarch64__) && defined(AT_HWCAP2)
+# ifdef HAVE_GETAUXVAL
+    cpu_features->has_rndr = (getauxval(AT_HWCAP2) & (1L << 16)) != 0;
+# elif defined(HAVE_ELF_AUX_INFO)
+    {
+        unsigned long buf;
+        if (elf_aux_info(AT_HWCAP2, (void *) &buf, (int) sizeof buf) == 0) {
+            cpu_features->has_rndr = (buf & (1L << 16)) != 0;
+        }
+    }
+# endif
 #endif
 
     if (cpu_features->has_neon == 0) {
@@ -140,6 +187,136 @@ _sodium_runtime_arm_cpu_features(CPUFeatures * const cpu_features)
         }
     }
 # endif
+#endif
+
+#if __ARM_FEATURE_SHA2
+    cpu_features->has_armsha2 = 1;
+#elif defined(__APPLE__) && defined(CPU_TYPE_ARM64) && defined(CPU_SUBTYPE_ARM64E)
+    cpu_features->has_armsha2 = cpu_features->has_armcrypto;
+#elif defined(HAVE_ANDROID_GETCPUFEATURES) && defined(ANDROID_CPU_ARM64_FEATURE_SHA2)
+    cpu_features->has_armsha2 =
+        (android_getCpuFeatures() & ANDROID_CPU_ARM64_FEATURE_SHA2) != 0x0;
+#elif defined(__aarch64__) && defined(AT_HWCAP)
+# ifdef HAVE_GETAUXVAL
+    cpu_features->has_armsha2 = (getauxval(AT_HWCAP) & (1L << 6)) != 0;
+# elif defined(HAVE_ELF_AUX_INFO)
+    {
+        unsigned long buf;
+        if (elf_aux_info(AT_HWCAP, (void *) &buf, (int) sizeof buf) == 0) {
+            cpu_features->has_armsha2 = (buf & (1L << 6)) != 0;
+        }
+    }
+# endif
+#endif
+
+    if (cpu_features->has_armsha2 == 0) {
+        return 0;
+    }
+
+#if __ARM_FEATURE_SHA512
+    cpu_features->has_armsha512 = 1;
+#elif defined(__APPLE__) && defined(CPU_TYPE_ARM64) && defined(CPU_SUBTYPE_ARM64E)
+    {
+        int    has_sha512 = 0;
+        size_t has_sha512_len = sizeof has_sha512;
+
+        if (sysctlbyname("hw.optional.armv8_2_sha512", &has_sha512,
+                         &has_sha512_len, NULL, 0) == 0 && has_sha512 != 0) {
+            cpu_features->has_armsha512 = 1;
+        }
+    }
+#elif defined(__aarch64__) && defined(AT_HWCAP)
+# ifdef HAVE_GETAUXVAL
+    cpu_features->has_armsha512 = (getauxval(AT_HWCAP) & (1L << 21)) != 0;
+# elif defined(HAVE_ELF_AUX_INFO)
+    {
+        unsigned long buf;
+        if (elf_aux_info(AT_HWCAP, (void *) &buf, (int) sizeof buf) == 0) {
+            cpu_features->has_armsha512 = (buf & (1L << 21)) != 0;
+        }
+    }
+# endif
+#endif
+
+    return 0;
+}
+
+#define PPC_HWCAP_VSX        0x00000080
+#define PPC_HWCAP2_ARCH_2_07 0x80000000
+
+static int
+_sodium_runtime_ppc_cpu_features(CPUFeatures * const cpu_features)
+{
+    cpu_features->has_vsx = 0;
+
+#if !defined(__powerpc__) && !defined(__powerpc64__)
+    return -1; /* LCOV_EXCL_LINE */
+#endif
+
+#if defined(__VSX__) && defined(_ARCH_PWR8)
+    cpu_features->has_vsx = 1;
+#elif (defined(__powerpc__) || defined(__powerpc64__)) && \
+    defined(AT_HWCAP) && defined(AT_HWCAP2)
+# ifdef HAVE_GETAUXVAL
+    cpu_features->has_vsx = (getauxval(AT_HWCAP) & PPC_HWCAP_VSX) != 0 &&
+                            (getauxval(AT_HWCAP2) & PPC_HWCAP2_ARCH_2_07) != 0;
+# elif defined(HAVE_ELF_AUX_INFO)
+    {
+        unsigned long buf;
+        unsigned long buf2;
+        if (elf_aux_info(AT_HWCAP, (void *) &buf, (int) sizeof buf) == 0 &&
+            elf_aux_info(AT_HWCAP2, (void *) &buf2, (int) sizeof buf2) == 0) {
+            cpu_features->has_vsx = (buf & PPC_HWCAP_VSX) != 0 &&
+                                    (buf2 & PPC_HWCAP2_ARCH_2_07) != 0;
+        }
+    }
+# endif
+#endif
+
+    return 0;
+}
+
+#define RISCV_HWPROBE_KEY_IMA_EXT_0 4
+#define RISCV_HWPROBE_IMA_V         (1ULL << 2)
+#define RISCV_HWCAP_V               (1UL << ('V' - 'A'))
+
+static int
+_sodium_runtime_riscv_cpu_features(CPUFeatures * const cpu_features)
+{
+    cpu_features->has_rvv = 0;
+
+#ifndef __riscv
+    return -1; /* LCOV_EXCL_LINE */
+#endif
+
+#if defined(__riscv) && defined(__linux__) && defined(__NR_riscv_hwprobe)
+    {
+        struct {
+            int64_t  key;
+            uint64_t value;
+        } pair;
+
+        /* hwprobe only reports V if the kernel also enabled it for us */
+        pair.key   = RISCV_HWPROBE_KEY_IMA_EXT_0;
+        pair.value = 0U;
+        if (syscall(__NR_riscv_hwprobe, &pair, (size_t) 1U, (size_t) 0U,
+                    NULL, 0U) == 0 && pair.key == RISCV_HWPROBE_KEY_IMA_EXT_0) {
+            cpu_features->has_rvv = (pair.value & RISCV_HWPROBE_IMA_V) != 0;
+            return 0;
+        }
+    }
+#endif
+#if defined(__riscv) && defined(AT_HWCAP)
+# ifdef HAVE_GETAUXVAL
+    cpu_features->has_rvv = (getauxval(AT_HWCAP) & RISCV_HWCAP_V) != 0;
+# elif defined(HAVE_ELF_AUX_INFO)
+    {
+        unsigned long buf;
+        if (elf_aux_info(AT_HWCAP, (void *) &buf, (int) sizeof buf) == 0) {
+            cpu_features->has_rvv = (buf & RISCV_HWCAP_V) != 0;
+        }
+    }
+# endif
 #endif
 
     return 0;
@@ -192,14 +369,28 @@ static int
 _sodium_runtime_intel_cpu_features(CPUFeatures * const cpu_features)
 {
     unsigned int cpu_info[4];
+    unsigned int family, model;
     unsigned int id;
     uint32_t     xcr0 = 0U;
+    int          is_intel;
 
     _cpuid(cpu_info, 0x0);
     if ((id = cpu_info[0]) == 0U) {
         return -1; /* LCOV_EXCL_LINE */
     }
+    is_intel = cpu_info[1] == 0x756e6547 && cpu_info[3] == 0x49656e69 &&
+               cpu_info[2] == 0x6c65746e; /* GenuineIntel */
     _cpuid(cpu_info, 0x00000001);
+    cpu_features->signature = (uint32_t) cpu_info[0];
+    family = (cpu_info[0] >> 8) & 0xf;
+    model  = (cpu_info[0] >> 4) & 0xf;
+    if (family == 0x6 || family == 0xf) {
+        model |= (cpu_info[0] >> 12) & 0xf0;
+    }
+    /* Skylake-SP, Cascade Lake and Cooper Lake lower their frequency
+     * while running 512-bit code */
+    cpu_features->avx512_downclocks = is_intel && family == 0x6 &&
+                                      model == 0x55;
 #ifdef HAVE_EMMINTRIN_H
     cpu_features->has_sse2 = ((cpu_info[3] & CPUID_EDX_SSE2) != 0x0);
 #else
@@ -273,6 +464,16 @@ _sodium_runtime_intel_cpu_features(CPUFeatures * const cpu_features)
     }
 #endif
 
+    cpu_features->has_bmi2 = 0;
+#ifdef HAVE_AVX2INTRIN_H
+    if (cpu_features->has_avx2) {
+        unsigned int cpu_info7[4];
+
+        _cpuid(cpu_info7, 0x00000007);
+        cpu_features->has_bmi2 = ((cpu_info7[1] & CPUID_EBX_BMI2) != 0x0);
+    }
+#endif
+
     cpu_features->has_avx512f = 0;
 #ifdef HAVE_AVX512FINTRIN_H
     if (cpu_features->has_avx2) {
@@ -289,6 +490,58 @@ _sodium_runtime_intel_cpu_features(CPUFeatures * const cpu_features)
     }
 #endif
 
+    cpu_features->has_avx512vl = 0;
+#ifdef HAVE_AVX512FINTRIN_H
+    if (cpu_features->has_avx512f) {
+        unsigned int cpu_info7[4];
+
+        _cpuid(cpu_info7, 0x00000007);
+        /* LCOV_EXCL_START */
+        if ((cpu_info7[1] & CPUID_EBX_AVX512VL) == CPUID_EBX_AVX512VL) {
+            cpu_features->has_avx512vl = 1;
+        }
+        /* LCOV_EXCL_STOP */
+    }
+#endif
+
+    cpu_features->has_avx512ifma = 0;
+#ifdef HAVE_AVX512IFMAINTRIN_H
+    if (cpu_features->has_avx512f) {
+        unsigned int cpu_info7[4];
+
+        _cpuid(cpu_info7, 0x00000007);
+        /* LCOV_EXCL_START */
+        if ((cpu_info7[1] & (CPUID_EBX_AVX512IFMA | CPUID_EBX_AVX512VL))
+            == (CPUID_EBX_AVX512IFMA | CPUID_EBX_AVX512VL)) {
+            cpu_features->has_avx512ifma = 1;
+        }
+        /* LCOV_EXCL_STOP */
+    }
+#endif
+
+    cpu_features->has_vaes       = 0;
+    cpu_features->has_vpclmulqdq = 0;
+#ifdef HAVE_VAESINTRIN_H
+    if (cpu_features->has_avx2) {
+        unsigned int cpu_info7[4];
+
+        _cpuid(cpu_info7, 0x00000007);
+        cpu_features->has_vaes = ((cpu_info7[2] & CPUID_ECX_VAES) != 0x0);
+        cpu_features->has_vpclmulqdq =
+            ((cpu_info7[2] & CPUID_ECX_VPCLMULQDQ) != 0x0);
+    }
+#endif
+
+    cpu_features->has_shani = 0;
+#ifdef HAVE_SHAINTRIN_H
+    if (cpu_features->has_sse41 && id >= 0x00000007) {
+        unsigned int cpu_info7[4];
+
+        _cpuid(cpu_info7, 0x00000007);
+        cpu_features->has_shani = ((cpu_info7[1] & CPUID_EBX_SHA) != 0x0);
+    }
+#endif
+
 #ifdef HAVE_WMMINTRIN_H
     cpu_features->has_pclmul = ((cpu_info[2] & CPUID_ECX_PCLMUL) != 0x0);
     cpu_features->has_aesni  = ((cpu_info[2] & CPUID_ECX_AESNI) != 0x0);
@@ -303,6 +556,16 @@ _sodium_runtime_intel_cpu_features(CPUFeatures * const cpu_features)
     cpu_features->has_rdrand = 0;
 #endif
 
+    cpu_features->has_rdseed = 0;
+#ifdef HAVE_RDSEED
+    if (id >= 0x00000007) {
+        unsigned int cpu_info7[4];
+
+        _cpuid(cpu_info7, 0x00000007);
+        cpu_features->has_rdseed = ((cpu_info7[1] & CPUID_EBX_RDSEED) != 0x0);
+    }
+#endif
+
     return 0;
 }
 
@@ -313,11 +576,56 @@ _sodium_runtime_get_cpu_features(void)
 
     ret &= _sodium_runtime_arm_cpu_features(&_cpu_features);
     ret &= _sodium_runtime_intel_cpu_features(&_cpu_features);
+    ret &= _sodium_runtime_ppc_cpu_features(&_cpu_features);
+    ret &= _sodium_runtime_riscv_cpu_features(&_cpu_features);
     _cpu_features.initialized = 1;
 
     return ret;
 }
 
+int
+sodium_runtime_set_vector_policy(const int policy)
+{
+    if (policy != SODIUM_RUNTIME_VECTOR_POLICY_AUTO &&
+        policy != SODIUM_RUNTIME_VECTOR_POLICY_PREFER_256 &&
+        policy != SODIUM_RUNTIME_VECTOR_POLICY_PREFER_512) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (_cpu_features.initialized != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    _vector_policy = policy;
+
+    return 0;
+}
+
+int
+sodium_runtime_vector_policy(void)
+{
+    return _vector_policy;
+}
+
+unsigned int
+_sodium_runtime_cpu_signature(void)
+{
+    return (unsigned int) _cpu_features.signature;
+}
+
+int
+_sodium_runtime_use_512bit_vectors(void)
+{
+    switch (_vector_policy) {
+    case SODIUM_RUNTIME_VECTOR_POLICY_PREFER_256:
+        return 0;
+    case SODIUM_RUNTIME_VECTOR_POLICY_PREFER_512:
+        return 1;
+    default:
+        return !_cpu_features.avx512_downclocks;
+    }
+}
+
 int
 sodium_runtime_has_neon(void)
 {
@@ -330,6 +638,18 @@ sodium_runtime_has_armcrypto(void)
     return _cpu_features.has_armcrypto;
 }
 
+int
+sodium_runtime_has_armsha2(void)
+{
+    return _cpu_features.has_armsha2;
+}
+
+int
+sodium_runtime_has_armsha512(void)
+{
+    return _cpu_features.has_armsha512;
+}
+
 int
 sodium_runtime_has_sse2(void)
 {
@@ -366,12 +686,48 @@ sodium_runtime_has_avx2(void)
     return _cpu_features.has_avx2;
 }
 
+int
+sodium_runtime_has_bmi2(void)
+{
+    return _cpu_features.has_bmi2;
+}
+
 int
 sodium_runtime_has_avx512f(void)
 {
     return _cpu_features.has_avx512f;
 }
 
+int
+sodium_runtime_has_avx512vl(void)
+{
+    return _cpu_features.has_avx512vl;
+}
+
+int
+sodium_runtime_has_avx512ifma(void)
+{
+    return _cpu_features.has_avx512ifma;
+}
+
+int
+sodium_runtime_has_vaes(void)
+{
+    return _cpu_features.has_vaes;
+}
+
+int
+sodium_runtime_has_vpclmulqdq(void)
+{
+    return _cpu_features.has_vpclmulqdq;
+}
+
+int
+sodium_runtime_has_shani(void)
+{
+    return _cpu_features.has_shani;
+}
+
 int
 sodium_runtime_has_pclmul(void)
 {
@@ -389,3 +745,27 @@ sodium_runtime_has_rdrand(void)
 {
     return _cpu_features.has_rdrand;
 }
+
+int
+sodium_runtime_has_rdseed(void)
+{
+    return _cpu_features.has_rdseed;
+}
+
+int
+sodium_runtime_has_rndr(void)
+{
+    return _cpu_features.has_rndr;
+}
+
+int
+sodium_runtime_has_vsx(void)
+{
+    return _cpu_features.has_vsx;
+}
+
+int
+sodium_runtime_has_rvv(void)
+{
+    return _cpu_features.has_rvv;
+}
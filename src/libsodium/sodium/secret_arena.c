@@ -0,0 +1,365 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+# include <pthread.h>
+# define ARENA_HAVE_THREADS
+#endif
+
+#ifdef HAVE_SYS_MMAN_H
+# include <sys/mman.h>
+#endif
+#ifndef _WIN32
+# include <unistd.h>
+#endif
+#if defined(__linux__) && defined(HAVE_SYS_MMAN_H)
+# include <sys/syscall.h>
+#endif
+
+#include "core.h"
+#include "utils.h"
+
+#ifndef ENOSYS
+# define ENOSYS ENXIO
+#endif
+
+#if !defined(MAP_ANON) && defined(MAP_ANONYMOUS)
+# define MAP_ANON MAP_ANONYMOUS
+#endif
+#ifndef MAP_NORESERVE
+# define MAP_NORESERVE 0
+#endif
+#ifndef MAP_NOCORE
+# ifdef MAP_CONCEAL
+#  define MAP_NOCORE MAP_CONCEAL
+# else
+#  define MAP_NOCORE 0
+# endif
+#endif
+#if defined(MAP_ANON) && defined(HAVE_MMAP) && defined(HAVE_MPROTECT) && \
+    defined(_SC_PAGESIZE)
+# define ARENA_HAVE_SLABS
+#endif
+#if defined(ARENA_HAVE_SLABS) && defined(SYS_memfd_secret) && \
+    defined(MAP_FIXED)
+# define ARENA_HAVE_MEMFD_SECRET
+#endif
+
+#define ARENA_MIN_BLOCK_BITS 6U
+#define ARENA_CLASSES        9U
+#define ARENA_MAX_BLOCK      (1U << (ARENA_MIN_BLOCK_BITS + ARENA_CLASSES - 1U))
+#define ARENA_DEFAULT_SLAB   (256U * 1024U)
+
+/*
+ * Small allocations are rounded up to a power of two between 64 bytes and
+ * 16 KB, carved out of the current slab, and kept in a free list of their
+ * size class once freed. Larger ones get a slab of their own, unmapped on
+ * free. A slab is: [guard page][slab pages][guard page]
+ */
+
+typedef struct arena_slab {
+    struct arena_slab *next;
+    unsigned char     *base_ptr;
+    unsigned char     *data;
+    size_t             size;
+} arena_slab;
+
+typedef struct arena_block {
+    struct arena_block *next;
+} arena_block;
+
+struct sodium_secret_arena {
+#ifdef ARENA_HAVE_THREADS
+    pthread_mutex_t mutex;
+#endif
+    arena_slab     *slabs;
+    arena_slab     *large_slabs;
+    arena_block    *free_lists[ARENA_CLASSES];
+    size_t          slab_size;
+    size_t          used;
+    size_t          page_size;
+};
+
+#ifdef ARENA_HAVE_SLABS
+
+static int
+_arena_map_secret(unsigned char *data, const size_t size)
+{
+# ifdef ARENA_HAVE_MEMFD_SECRET
+    void *ptr;
+    int   fd;
+
+    if ((fd = (int) syscall(SYS_memfd_secret, 0U)) == -1) {
+        return -1;
+    }
+    if (ftruncate(fd, (off_t) size) != 0) {
+        (void) close(fd); /* LCOV_EXCL_LINE */
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    ptr = mmap(data, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+               fd, 0);
+    (void) close(fd);
+
+    return -(ptr == MAP_FAILED);
+# else
+    (void) data;
+    (void) size;
+
+    return -1;
+# endif
+}
+
+static arena_slab *
+_arena_slab_create(const sodium_secret_arena *arena, const size_t size)
+{
+    arena_slab *slab;
+    size_t      total_size;
+    void       *ptr;
+
+    if (size >= SIZE_MAX - arena->page_size * 2U ||
+        (slab = (arena_slab *) malloc(sizeof *slab)) == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    total_size = arena->page_size + size + arena->page_size;
+    if ((ptr = mmap(NULL, total_size, PROT_NONE,
+                    MAP_ANON | MAP_PRIVATE | MAP_NORESERVE | MAP_NOCORE,
+                    -1, 0)) == MAP_FAILED) {
+        free(slab);
+        errno = ENOMEM;
+        return NULL;
+    }
+    slab->base_ptr = (unsigned char *) ptr;
+    slab->data     = slab->base_ptr + arena->page_size;
+    slab->size     = size;
+    slab->next     = NULL;
+    if (_arena_map_secret(slab->data, size) != 0) {
+        if (mprotect(slab->data, size, PROT_READ | PROT_WRITE) != 0) {
+            (void) munmap(slab->base_ptr, total_size); /* LCOV_EXCL_LINE */
+            free(slab); /* LCOV_EXCL_LINE */
+            errno = ENOMEM; /* LCOV_EXCL_LINE */
+            return NULL; /* LCOV_EXCL_LINE */
+        }
+        (void) sodium_mlock(slab->data, size);
+    }
+    return slab;
+}
+
+static void
+_arena_slab_destroy(const sodium_secret_arena *arena, arena_slab *slab)
+{
+    (void) sodium_munlock(slab->data, slab->size);
+    (void) munmap(slab->base_ptr, arena->page_size + slab->size +
+                  arena->page_size);
+    free(slab);
+}
+
+static int
+_arena_lock(sodium_secret_arena *arena)
+{
+#ifdef ARENA_HAVE_THREADS
+    return pthread_mutex_lock(&arena->mutex);
+#else
+    (void) arena;
+    return 0;
+#endif
+}
+
+static void
+_arena_unlock(sodium_secret_arena *arena)
+{
+#ifdef ARENA_HAVE_THREADS
+    if (pthread_mutex_unlock(&arena->mutex) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+#else
+    (void) arena;
+#endif
+}
+
+static size_t
+_arena_class(const size_t size)
+{
+    size_t c = 0U;
+
+    while (((size_t) 1U << (ARENA_MIN_BLOCK_BITS + c)) < size) {
+        c++;
+    }
+    return c;
+}
+
+#endif /* ARENA_HAVE_SLABS */
+
+sodium_secret_arena *
+sodium_secret_arena_create(size_t slab_size)
+{
+#ifndef ARENA_HAVE_SLABS
+    (void) slab_size;
+    errno = ENOSYS;
+
+    return NULL;
+#else
+    sodium_secret_arena *arena;
+    long                 page_size;
+
+    if ((page_size = sysconf(_SC_PAGESIZE)) <= 0L) {
+        errno = ENOSYS; /* LCOV_EXCL_LINE */
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    if (slab_size == 0U) {
+        slab_size = ARENA_DEFAULT_SLAB;
+    } else if (slab_size < ARENA_MAX_BLOCK) {
+        slab_size = ARENA_MAX_BLOCK;
+    } else if (slab_size > SIZE_MAX / 2U) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((arena = (sodium_secret_arena *) calloc(1U, sizeof *arena)) == NULL) {
+        return NULL;
+    }
+    arena->page_size = (size_t) page_size;
+    arena->slab_size = (slab_size + arena->page_size - 1U) &
+        ~(arena->page_size - 1U);
+# ifdef ARENA_HAVE_THREADS
+    if (pthread_mutex_init(&arena->mutex, NULL) != 0) {
+        free(arena); /* LCOV_EXCL_LINE */
+        errno = ENOMEM; /* LCOV_EXCL_LINE */
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+# endif
+    if ((arena->slabs = _arena_slab_create(arena, arena->slab_size)) == NULL) {
+        sodium_secret_arena_destroy(arena);
+        errno = ENOSYS;
+        return NULL;
+    }
+    return arena;
+#endif
+}
+
+void
+sodium_secret_arena_destroy(sodium_secret_arena *arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+#ifdef ARENA_HAVE_SLABS
+    {
+        arena_slab *slab;
+        arena_slab *next;
+
+        for (slab = arena->slabs; slab != NULL; slab = next) {
+            next = slab->next;
+            _arena_slab_destroy(arena, slab);
+        }
+        for (slab = arena->large_slabs; slab != NULL; slab = next) {
+            next = slab->next;
+            _arena_slab_destroy(arena, slab);
+        }
+    }
+#endif
+#ifdef ARENA_HAVE_THREADS
+    (void) pthread_mutex_destroy(&arena->mutex);
+#endif
+    free(arena);
+}
+
+void *
+sodium_secret_arena_alloc(void *arena_, size_t size)
+{
+#ifndef ARENA_HAVE_SLABS
+    (void) arena_;
+    (void) size;
+    errno = ENOSYS;
+
+    return NULL;
+#else
+    sodium_secret_arena *arena = (sodium_secret_arena *) arena_;
+    arena_slab          *slab;
+    arena_block         *block;
+    unsigned char       *ptr = NULL;
+    size_t               block_size;
+    size_t               c;
+
+    if (_arena_lock(arena) != 0) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    if (size > ARENA_MAX_BLOCK) {
+        block_size = (size + arena->page_size - 1U) & ~(arena->page_size - 1U);
+        if (block_size >= size &&
+            (slab = _arena_slab_create(arena, block_size)) != NULL) {
+            slab->next = arena->large_slabs;
+            arena->large_slabs = slab;
+            ptr = slab->data;
+        }
+        _arena_unlock(arena);
+
+        return ptr;
+    }
+    c = _arena_class(size);
+    if ((block = arena->free_lists[c]) != NULL) {
+        arena->free_lists[c] = block->next;
+        block->next = NULL;
+        _arena_unlock(arena);
+
+        return block;
+    }
+    block_size = (size_t) 1U << (ARENA_MIN_BLOCK_BITS + c);
+    if (arena->slab_size - arena->used < block_size) {
+        if ((slab = _arena_slab_create(arena, arena->slab_size)) == NULL) {
+            _arena_unlock(arena);
+            return NULL;
+        }
+        slab->next = arena->slabs;
+        arena->slabs = slab;
+        arena->used = 0U;
+    }
+    ptr = arena->slabs->data + arena->used;
+    arena->used += block_size;
+    _arena_unlock(arena);
+
+    return ptr;
+#endif
+}
+
+void
+sodium_secret_arena_free(void *arena_, void *ptr, size_t size)
+{
+#ifdef ARENA_HAVE_SLABS
+    sodium_secret_arena *arena = (sodium_secret_arena *) arena_;
+    arena_slab         **slab_p;
+    arena_slab          *slab;
+    arena_block         *block;
+    size_t               c;
+
+    if (_arena_lock(arena) != 0) {
+        sodium_misuse(); /* LCOV_EXCL_LINE */
+    }
+    if (size > ARENA_MAX_BLOCK) {
+        for (slab_p = &arena->large_slabs; (slab = *slab_p) != NULL;
+             slab_p = &slab->next) {
+            if (slab->data == (unsigned char *) ptr) {
+                break;
+            }
+        }
+        if (slab == NULL) {
+            sodium_misuse();
+        }
+        *slab_p = slab->next;
+        _arena_unlock(arena);
+        _arena_slab_destroy(arena, slab);
+
+        return;
+    }
+    c = _arena_class(size);
+    block = (arena_block *) ptr;
+    block->next = arena->free_lists[c];
+    arena->free_lists[c] = block;
+    _arena_unlock(arena);
+#else
+    (void) arena_;
+    (void) ptr;
+    (void) size;
+#endif
+}
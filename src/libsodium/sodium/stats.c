@@ -0,0 +1,249 @@
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(ENABLE_STATS) && defined(HAVE_PTHREAD) && \
+    (!defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__))
+# include <pthread.h>
+# define STATS_THREAD_BLOCKS
+#endif
+#if defined(ENABLE_STATS_CYCLES) && defined(_MSC_VER) && \
+    (defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86))
+# include <intrin.h>
+#endif
+
+#include "core.h"
+#include "stats.h"
+#include "private/common.h"
+#include "private/stats.h"
+
+static const char *categories[SODIUM_STATS_COUNT] = {
+    "aead", "stream", "hash", "sign", "scalarmult", "pwhash"
+};
+
+const char *
+sodium_stats_name(int category)
+{
+    if (category < 0 || category >= SODIUM_STATS_COUNT) {
+        return NULL;
+    }
+    return categories[category];
+}
+
+#ifndef ENABLE_STATS
+
+int
+sodium_stats_get(sodium_stats *stats)
+{
+    memset(stats, 0, sizeof *stats);
+    errno = ENOSYS;
+
+    return -1;
+}
+
+#else
+
+/*
+ * Each thread only writes to its own block, so that updates don't need
+ * read-modify-write atomics; readers may observe a counter that is one call
+ * behind. Without POSIX threads, there is a single block, which is only
+ * accurate in single-threaded programs.
+ */
+typedef struct StatsBlock_ {
+    struct StatsBlock_ *next;
+    unsigned int        depth;
+    sodium_stats        stats;
+} StatsBlock;
+
+#ifdef __ATOMIC_RELAXED
+# define STATS_LOAD(P) __atomic_load_n((P), __ATOMIC_RELAXED)
+# define STATS_ADD(P, V) \
+    __atomic_store_n((P), __atomic_load_n((P), __ATOMIC_RELAXED) + (V), \
+                     __ATOMIC_RELAXED)
+#else
+# define STATS_LOAD(P)   (*(volatile uint64_t *) (P))
+# define STATS_ADD(P, V) (*(volatile uint64_t *) (P) += (V))
+#endif
+
+static inline uint64_t
+_stats_cycles(void)
+{
+#ifndef ENABLE_STATS_CYCLES
+    return 0U;
+#elif defined(_MSC_VER) && \
+    (defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86))
+    return (uint64_t) __rdtsc();
+#elif defined(HAVE_INLINE_ASM) && (defined(__x86_64__) || defined(__i386__))
+    uint32_t lo, hi;
+
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+
+    return ((uint64_t) hi << 32) | lo;
+#elif defined(HAVE_INLINE_ASM) && defined(__aarch64__)
+    uint64_t t;
+
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(t));
+
+    return t;
+#else
+    return 0U;
+#endif
+}
+
+static void
+_stats_accumulate(sodium_stats *total, const sodium_stats *stats)
+{
+    size_t i;
+
+    for (i = 0U; i < SODIUM_STATS_COUNT; i++) {
+        total->counters[i].calls  += STATS_LOAD(&stats->counters[i].calls);
+        total->counters[i].bytes  += STATS_LOAD(&stats->counters[i].bytes);
+        total->counters[i].cycles += STATS_LOAD(&stats->counters[i].cycles);
+    }
+}
+
+#ifdef STATS_THREAD_BLOCKS
+
+static pthread_mutex_t stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t   stats_key;
+static pthread_once_t  stats_key_once = PTHREAD_ONCE_INIT;
+static int             stats_key_ok;
+static StatsBlock     *stats_blocks;
+static sodium_stats    stats_retired;
+# ifdef TLS
+static TLS StatsBlock *stats_block_cache;
+# endif
+
+/* Called on thread exit: folds the thread counters into the retired ones */
+static void
+_stats_block_free(void *block_)
+{
+    StatsBlock  *block = (StatsBlock *) block_;
+    StatsBlock **prev;
+
+# ifdef TLS
+    stats_block_cache = NULL;
+# endif
+    if (pthread_mutex_lock(&stats_lock) != 0) {
+        return; /* LCOV_EXCL_LINE */
+    }
+    _stats_accumulate(&stats_retired, &block->stats);
+    for (prev = &stats_blocks; *prev != NULL; prev = &(*prev)->next) {
+        if (*prev == block) {
+            *prev = block->next;
+            break;
+        }
+    }
+    (void) pthread_mutex_unlock(&stats_lock);
+    free(block);
+}
+
+static void
+_stats_key_create(void)
+{
+    stats_key_ok = pthread_key_create(&stats_key, _stats_block_free) == 0;
+}
+
+static StatsBlock *
+_stats_block(const int create)
+{
+    StatsBlock *block;
+
+# ifdef TLS
+    if ((block = stats_block_cache) != NULL) {
+        return block;
+    }
+# endif
+    if (pthread_once(&stats_key_once, _stats_key_create) != 0 ||
+        stats_key_ok == 0) {
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    if ((block = (StatsBlock *) pthread_getspecific(stats_key)) == NULL) {
+        if (create == 0 ||
+            (block = (StatsBlock *) calloc(1U, sizeof *block)) == NULL) {
+            return NULL;
+        }
+        if (pthread_setspecific(stats_key, block) != 0 ||
+            pthread_mutex_lock(&stats_lock) != 0) {
+            (void) pthread_setspecific(stats_key, NULL); /* LCOV_EXCL_LINE */
+            free(block); /* LCOV_EXCL_LINE */
+            return NULL; /* LCOV_EXCL_LINE */
+        }
+        block->next  = stats_blocks;
+        stats_blocks = block;
+        (void) pthread_mutex_unlock(&stats_lock);
+    }
+# ifdef TLS
+    stats_block_cache = block;
+# endif
+    return block;
+}
+
+int
+sodium_stats_get(sodium_stats *stats)
+{
+    const StatsBlock *block;
+
+    if (pthread_mutex_lock(&stats_lock) != 0) {
+        return -1; /* LCOV_EXCL_LINE */
+    }
+    memcpy(stats, &stats_retired, sizeof *stats);
+    for (block = stats_blocks; block != NULL; block = block->next) {
+        _stats_accumulate(stats, &block->stats);
+    }
+    (void) pthread_mutex_unlock(&stats_lock);
+
+    return 0;
+}
+
+#else
+
+static StatsBlock stats_block;
+
+static StatsBlock *
+_stats_block(const int create)
+{
+    (void) create;
+
+    return &stats_block;
+}
+
+int
+sodium_stats_get(sodium_stats *stats)
+{
+    memset(stats, 0, sizeof *stats);
+    _stats_accumulate(stats, &stats_block.stats);
+
+    return 0;
+}
+
+#endif
+
+uint64_t
+_sodium_stats_begin(void)
+{
+    StatsBlock *block = _stats_block(1);
+
+    if (block == NULL || block->depth++ != 0U) {
+        return 0U;
+    }
+    return _stats_cycles();
+}
+
+void
+_sodium_stats_end(const uint64_t start, const int category,
+                  const uint64_t bytes)
+{
+    StatsBlock           *block = _stats_block(0);
+    sodium_stats_counter *counter;
+
+    if (block == NULL || block->depth == 0U || --block->depth != 0U) {
+        return;
+    }
+    counter = &block->stats.counters[category];
+    STATS_ADD(&counter->calls, 1U);
+    STATS_ADD(&counter->bytes, bytes);
+    STATS_ADD(&counter->cycles, _stats_cycles() - start);
+}
+
+#endif
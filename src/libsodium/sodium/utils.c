@@ -49,7 +49,9 @@ void *alloca (size_t);
 #include "crypto_generichash.h"
 #include "crypto_stream.h"
 #include "randombytes.h"
+#include "private/allocator.h"
 #include "private/common.h"
+#include "private/probes.h"
 #include "utils.h"
 
 #ifndef ENOSYS
@@ -64,6 +66,12 @@ void *alloca (size_t);
 #define CANARY_SIZE 16U
 #define GARBAGE_VALUE 0xdb
 
+/* [size][padding][canary] before memory from a SODIUM_ALLOC_SECRET allocator */
+#define SECRET_HEADER_SIZE 64U
+
+/* Below this size, wiping through the cache is faster */
+#define MEMZERO_BULK_MIN_LEN (256U * 1024U)
+
 #ifndef MAP_NOCORE
 # ifdef MAP_CONCEAL
 #  define MAP_NOCORE MAP_CONCEAL
@@ -102,6 +110,37 @@ void *alloca (size_t);
 static size_t        page_size = DEFAULT_PAGE_SIZE;
 static unsigned char canary[CANARY_SIZE];
 
+/*
+ * Secure memory counters are updated with relaxed atomics. Without them,
+ * they are only accurate in single-threaded programs.
+ */
+static sodium_secure_memory_stats secure_stats;
+
+#ifdef __ATOMIC_RELAXED
+# define SECURE_STATS_LOAD(P) __atomic_load_n((P), __ATOMIC_RELAXED)
+# define SECURE_STATS_ADD(P, V) __atomic_add_fetch((P), (V), __ATOMIC_RELAXED)
+# define SECURE_STATS_SUB(P, V) __atomic_sub_fetch((P), (V), __ATOMIC_RELAXED)
+# define SECURE_STATS_RAISE(P, V)                                           \
+    do {                                                                    \
+        size_t max_ = __atomic_load_n((P), __ATOMIC_RELAXED);               \
+        while ((V) > max_ &&                                                \
+               !__atomic_compare_exchange_n((P), &max_, (V), 1,             \
+                                            __ATOMIC_RELAXED,               \
+                                            __ATOMIC_RELAXED)) {            \
+        }                                                                   \
+    } while (0)
+#else
+# define SECURE_STATS_LOAD(P)   (*(volatile size_t *) (P))
+# define SECURE_STATS_ADD(P, V) (*(volatile size_t *) (P) += (V))
+# define SECURE_STATS_SUB(P, V) (*(volatile size_t *) (P) -= (V))
+# define SECURE_STATS_RAISE(P, V)                                           \
+    do {                                                                    \
+        if ((V) > *(volatile size_t *) (P)) {                               \
+            *(volatile size_t *) (P) = (V);                                 \
+        }                                                                   \
+    } while (0)
+#endif
+
 /* LCOV_EXCL_START */
 #ifdef HAVE_WEAK_SYMBOLS
 __attribute__((weak)) void
@@ -160,6 +199,203 @@ sodium_stackzero(const size_t len)
 #endif
 }
 
+/*
+ * Vectorized versions of the constant-time comparisons. They accumulate
+ * differences over whole vectors, with no data-dependent branches, and
+ * return the number of bytes they processed; the remainder is handled
+ * by the byte-oriented loops.
+ */
+
+#if defined(HAVE_EMMINTRIN_H) && defined(__SSE2__)
+
+# ifdef __GNUC__
+#  pragma GCC target("sse2")
+# endif
+# include <emmintrin.h>
+
+# define HAVE_VECTOR_COMPARE
+# define HAVE_VECTOR_ORDER
+
+# define LOAD128(P) _mm_loadu_si128((const __m128i *) (const void *) (P))
+
+static inline unsigned char
+_vector_fold(const __m128i z)
+{
+    const unsigned int m =
+        (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(z, _mm_setzero_si128())) ^
+        0xffffU;
+
+    return (unsigned char) (m | (m >> 8));
+}
+
+static size_t
+_sodium_memcmp_vector(const unsigned char *b1, const unsigned char *b2,
+                      const size_t len, volatile unsigned char *d)
+{
+    __m128i z0 = _mm_setzero_si128(), z1 = z0, z2 = z0, z3 = z0;
+    size_t  i  = 0U;
+
+    for (; len - i >= 64U; i += 64U) {
+        z0 = _mm_or_si128(z0, _mm_xor_si128(LOAD128(b1 + i), LOAD128(b2 + i)));
+        z1 = _mm_or_si128(z1, _mm_xor_si128(LOAD128(b1 + i + 16),
+                                            LOAD128(b2 + i + 16)));
+        z2 = _mm_or_si128(z2, _mm_xor_si128(LOAD128(b1 + i + 32),
+                                            LOAD128(b2 + i + 32)));
+        z3 = _mm_or_si128(z3, _mm_xor_si128(LOAD128(b1 + i + 48),
+                                            LOAD128(b2 + i + 48)));
+    }
+    z0 = _mm_or_si128(_mm_or_si128(z0, z1), _mm_or_si128(z2, z3));
+    for (; len - i >= 16U; i += 16U) {
+        z0 = _mm_or_si128(z0, _mm_xor_si128(LOAD128(b1 + i), LOAD128(b2 + i)));
+    }
+    *d |= _vector_fold(z0);
+
+    return i;
+}
+
+static size_t
+_sodium_is_zero_vector(const unsigned char *n, const size_t nlen,
+                       volatile unsigned char *d)
+{
+    __m128i z0 = _mm_setzero_si128(), z1 = z0, z2 = z0, z3 = z0;
+    size_t  i  = 0U;
+
+    for (; nlen - i >= 64U; i += 64U) {
+        z0 = _mm_or_si128(z0, LOAD128(n + i));
+        z1 = _mm_or_si128(z1, LOAD128(n + i + 16));
+        z2 = _mm_or_si128(z2, LOAD128(n + i + 32));
+        z3 = _mm_or_si128(z3, LOAD128(n + i + 48));
+    }
+    z0 = _mm_or_si128(_mm_or_si128(z0, z1), _mm_or_si128(z2, z3));
+    for (; nlen - i >= 16U; i += 16U) {
+        z0 = _mm_or_si128(z0, LOAD128(n + i));
+    }
+    *d |= _vector_fold(z0);
+
+    return i;
+}
+
+/*
+ * Bytes are compared as signed values after flipping their top bit.
+ * Within a vector, the most significant differing byte is the highest bit
+ * set in (gt | lt), so the vector is greater iff gt > lt as integers.
+ */
+static size_t
+_sodium_compare_vector(const unsigned char *b1, const unsigned char *b2,
+                       const size_t len, volatile unsigned char *gt,
+                       volatile unsigned char *eq)
+{
+    const __m128i bias = _mm_set1_epi8((char) 0x80);
+    __m128i       x1, x2;
+    uint32_t      gtm, ltm;
+    size_t        i = len;
+
+    while (i >= 16U) {
+        i -= 16U;
+        x1  = _mm_xor_si128(LOAD128(b1 + i), bias);
+        x2  = _mm_xor_si128(LOAD128(b2 + i), bias);
+        gtm = (uint32_t) _mm_movemask_epi8(_mm_cmpgt_epi8(x1, x2));
+        ltm = (uint32_t) _mm_movemask_epi8(_mm_cmpgt_epi8(x2, x1));
+        *gt |= (unsigned char) ((ltm - gtm) >> 31) & *eq;
+        *eq &= (unsigned char) (((gtm | ltm) - 1U) >> 31);
+    }
+    return i;
+}
+
+# ifdef HAVE_INLINE_ASM
+#  define HAVE_VECTOR_MEMZERO
+
+/* Non-temporal stores don't evict the working set while wiping */
+static void
+_sodium_memzero_vector(unsigned char *pnt, const size_t len)
+{
+    const __m128i z    = _mm_setzero_si128();
+    size_t        head = (size_t) (-(uintptr_t) pnt & 15U);
+    size_t        i;
+
+    sodium_memzero(pnt, head);
+    for (i = head; len - i >= 64U; i += 64U) {
+        _mm_stream_si128((__m128i *) (void *) (pnt + i), z);
+        _mm_stream_si128((__m128i *) (void *) (pnt + i + 16), z);
+        _mm_stream_si128((__m128i *) (void *) (pnt + i + 32), z);
+        _mm_stream_si128((__m128i *) (void *) (pnt + i + 48), z);
+    }
+    for (; len - i >= 16U; i += 16U) {
+        _mm_stream_si128((__m128i *) (void *) (pnt + i), z);
+    }
+    _mm_sfence();
+    __asm__ __volatile__ ("" : : "r"(pnt) : "memory");
+    sodium_memzero(pnt + i, len - i);
+}
+# endif
+
+#elif defined(HAVE_ARMNEON)
+
+# include <arm_neon.h>
+
+# define HAVE_VECTOR_COMPARE
+
+static size_t
+_sodium_memcmp_vector(const unsigned char *b1, const unsigned char *b2,
+                      const size_t len, volatile unsigned char *d)
+{
+    uint8x16_t z0 = vdupq_n_u8(0), z1 = z0, z2 = z0, z3 = z0;
+    size_t     i  = 0U;
+
+    for (; len - i >= 64U; i += 64U) {
+        z0 = vorrq_u8(z0, veorq_u8(vld1q_u8(b1 + i), vld1q_u8(b2 + i)));
+        z1 = vorrq_u8(z1, veorq_u8(vld1q_u8(b1 + i + 16),
+                                   vld1q_u8(b2 + i + 16)));
+        z2 = vorrq_u8(z2, veorq_u8(vld1q_u8(b1 + i + 32),
+                                   vld1q_u8(b2 + i + 32)));
+        z3 = vorrq_u8(z3, veorq_u8(vld1q_u8(b1 + i + 48),
+                                   vld1q_u8(b2 + i + 48)));
+    }
+    z0 = vorrq_u8(vorrq_u8(z0, z1), vorrq_u8(z2, z3));
+    for (; len - i >= 16U; i += 16U) {
+        z0 = vorrq_u8(z0, veorq_u8(vld1q_u8(b1 + i), vld1q_u8(b2 + i)));
+    }
+    *d |= vmaxvq_u8(z0);
+
+    return i;
+}
+
+static size_t
+_sodium_is_zero_vector(const unsigned char *n, const size_t nlen,
+                       volatile unsigned char *d)
+{
+    uint8x16_t z0 = vdupq_n_u8(0), z1 = z0, z2 = z0, z3 = z0;
+    size_t     i  = 0U;
+
+    for (; nlen - i >= 64U; i += 64U) {
+        z0 = vorrq_u8(z0, vld1q_u8(n + i));
+        z1 = vorrq_u8(z1, vld1q_u8(n + i + 16));
+        z2 = vorrq_u8(z2, vld1q_u8(n + i + 32));
+        z3 = vorrq_u8(z3, vld1q_u8(n + i + 48));
+    }
+    z0 = vorrq_u8(vorrq_u8(z0, z1), vorrq_u8(z2, z3));
+    for (; nlen - i >= 16U; i += 16U) {
+        z0 = vorrq_u8(z0, vld1q_u8(n + i));
+    }
+    *d |= vmaxvq_u8(z0);
+
+    return i;
+}
+
+#endif
+
+void
+sodium_memzero_bulk(void * const pnt, const size_t len)
+{
+#ifdef HAVE_VECTOR_MEMZERO
+    if (len >= MEMZERO_BULK_MIN_LEN) {
+        _sodium_memzero_vector((unsigned char *) pnt, len);
+        return;
+    }
+#endif
+    sodium_memzero(pnt, len);
+}
+
 #ifdef HAVE_WEAK_SYMBOLS
 __attribute__((weak)) void
 _sodium_dummy_symbol_to_prevent_memcmp_lto(const unsigned char *b1,
@@ -194,7 +430,13 @@ sodium_memcmp(const void *const b1_, const void *const b2_, size_t len)
 #if HAVE_WEAK_SYMBOLS
     _sodium_dummy_symbol_to_prevent_memcmp_lto(b1, b2, len);
 #endif
-    for (i = 0U; i < len; i++) {
+#ifdef HAVE_VECTOR_COMPARE
+    i = _sodium_memcmp_vector((const unsigned char *) b1,
+                              (const unsigned char *) b2, len, &d);
+#else
+    i = 0U;
+#endif
+    for (; i < len; i++) {
         d |= b1[i] ^ b2[i];
     }
     return (1 & ((d - 1) >> 8)) - 1;
@@ -236,7 +478,12 @@ sodium_compare(const unsigned char *b1_, const unsigned char *b2_, size_t len)
 #if HAVE_WEAK_SYMBOLS
     _sodium_dummy_symbol_to_prevent_compare_lto(b1, b2, len);
 #endif
+#ifdef HAVE_VECTOR_ORDER
+    i = _sodium_compare_vector((const unsigned char *) b1,
+                               (const unsigned char *) b2, len, &gt, &eq);
+#else
     i = len;
+#endif
     while (i != 0U) {
         i--;
         x1 = b1[i];
@@ -253,18 +500,45 @@ sodium_is_zero(const unsigned char *n, const size_t nlen)
     size_t                 i;
     volatile unsigned char d = 0U;
 
-    for (i = 0U; i < nlen; i++) {
+#ifdef HAVE_VECTOR_COMPARE
+    i = _sodium_is_zero_vector(n, nlen, &d);
+#else
+    i = 0U;
+#endif
+    for (; i < nlen; i++) {
         d |= n[i];
     }
     return 1 & ((d - 1) >> 8);
 }
 
+/*
+ * Multi-precision arithmetic on little-endian numbers, eight bytes at a
+ * time. Carries are computed from the top bits of the operands and of the
+ * result, and always propagated to the end of the number.
+ */
+
+static inline void
+_sodium_increment_by(unsigned char *n, const size_t nlen, uint64_t c)
+{
+    uint64_t x, s;
+    size_t   i = 0U;
+
+    for (; nlen - i >= 8U; i += 8U) {
+        x = LOAD64_LE(n + i);
+        s = x + c;
+        STORE64_LE(n + i, s);
+        c = ((x & c) | ((x | c) & ~s)) >> 63;
+    }
+    for (; i < nlen; i++) {
+        x = (c & 0xff) + (uint64_t) n[i];
+        n[i] = (unsigned char) x;
+        c = (c >> 8) + (x >> 8);
+    }
+}
+
 void
 sodium_increment(unsigned char *n, const size_t nlen)
 {
-    size_t        i = 0U;
-    uint_fast16_t c = 1U;
-
 #ifdef HAVE_AMD64_ASM
     uint64_t t64, t64_2;
     uint32_t t32;
@@ -299,18 +573,21 @@ sodium_increment(unsigned char *n, const size_t nlen)
         return;
     }
 #endif
-    for (; i < nlen; i++) {
-        c += (uint_fast16_t) n[i];
-        n[i] = (unsigned char) c;
-        c >>= 8;
-    }
+    _sodium_increment_by(n, nlen, 1U);
+}
+
+void
+sodium_increment_by(unsigned char *n, const size_t nlen, const uint64_t delta)
+{
+    _sodium_increment_by(n, nlen, delta);
 }
 
 void
 sodium_add(unsigned char *a, const unsigned char *b, const size_t len)
 {
-    size_t        i;
-    uint_fast16_t c = 0U;
+    uint64_t x, y, r;
+    uint64_t c = 0U;
+    size_t   i = 0U;
 
 #ifdef HAVE_AMD64_ASM
     uint64_t t64, t64_2, t64_3;
@@ -348,8 +625,15 @@ sodium_add(unsigned char *a, const unsigned char *b, const size_t len)
         return;
     }
 #endif
-    for (i = 0U; i < len; i++) {
-        c += (uint_fast16_t) a[i] + (uint_fast16_t) b[i];
+    for (; len - i >= 8U; i += 8U) {
+        x = LOAD64_LE(a + i);
+        y = LOAD64_LE(b + i);
+        r = x + y + c;
+        STORE64_LE(a + i, r);
+        c = ((x & y) | ((x | y) & ~r)) >> 63;
+    }
+    for (; i < len; i++) {
+        c += (uint64_t) a[i] + (uint64_t) b[i];
         a[i] = (unsigned char) c;
         c >>= 8;
     }
@@ -358,8 +642,9 @@ sodium_add(unsigned char *a, const unsigned char *b, const size_t len)
 void
 sodium_sub(unsigned char *a, const unsigned char *b, const size_t len)
 {
-    uint_fast16_t c = 0U;
-    size_t        i;
+    uint64_t x, y, r;
+    uint64_t c = 0U;
+    size_t   i = 0U;
 
 #ifdef HAVE_AMD64_ASM
     uint64_t t64_1, t64_2, t64_3, t64_4;
@@ -391,8 +676,15 @@ sodium_sub(unsigned char *a, const unsigned char *b, const size_t len)
         return;
     }
 #endif
-    for (i = 0U; i < len; i++) {
-        c = (uint_fast16_t) a[i] - (uint_fast16_t) b[i] - c;
+    for (; len - i >= 8U; i += 8U) {
+        x = LOAD64_LE(a + i);
+        y = LOAD64_LE(b + i);
+        r = x - y - c;
+        STORE64_LE(a + i, r);
+        c = ((~x & y) | (~(x ^ y) & r)) >> 63;
+    }
+    for (; i < len; i++) {
+        c = (uint64_t) a[i] - (uint64_t) b[i] - c;
         a[i] = (unsigned char) c;
         c = (c >> 8) & 1U;
     }
@@ -576,6 +868,47 @@ _unprotected_ptr_from_user_ptr(void *const ptr)
 
 #endif /* HAVE_ALIGNED_MALLOC */
 
+static void
+_secure_stats_alloc(const size_t requested, const size_t mapped,
+                    const size_t locked)
+{
+    size_t v;
+
+    v = SECURE_STATS_ADD(&secure_stats.allocations, 1U);
+    SECURE_STATS_RAISE(&secure_stats.allocations_max, v);
+    v = SECURE_STATS_ADD(&secure_stats.requested_bytes, requested);
+    SECURE_STATS_RAISE(&secure_stats.requested_bytes_max, v);
+    v = SECURE_STATS_ADD(&secure_stats.mapped_bytes, mapped);
+    SECURE_STATS_RAISE(&secure_stats.mapped_bytes_max, v);
+    v = SECURE_STATS_ADD(&secure_stats.locked_bytes, locked);
+    SECURE_STATS_RAISE(&secure_stats.locked_bytes_max, v);
+}
+
+static void
+_secure_stats_free(const size_t requested, const size_t mapped,
+                   const size_t locked)
+{
+    (void) SECURE_STATS_SUB(&secure_stats.allocations, 1U);
+    (void) SECURE_STATS_SUB(&secure_stats.requested_bytes, requested);
+    (void) SECURE_STATS_SUB(&secure_stats.mapped_bytes, mapped);
+    (void) SECURE_STATS_SUB(&secure_stats.locked_bytes, locked);
+}
+
+int
+sodium_secure_memory_stats_get(sodium_secure_memory_stats *stats)
+{
+    stats->allocations         = SECURE_STATS_LOAD(&secure_stats.allocations);
+    stats->requested_bytes     = SECURE_STATS_LOAD(&secure_stats.requested_bytes);
+    stats->mapped_bytes        = SECURE_STATS_LOAD(&secure_stats.mapped_bytes);
+    stats->locked_bytes        = SECURE_STATS_LOAD(&secure_stats.locked_bytes);
+    stats->allocations_max     = SECURE_STATS_LOAD(&secure_stats.allocations_max);
+    stats->requested_bytes_max = SECURE_STATS_LOAD(&secure_stats.requested_bytes_max);
+    stats->mapped_bytes_max    = SECURE_STATS_LOAD(&secure_stats.mapped_bytes_max);
+    stats->locked_bytes_max    = SECURE_STATS_LOAD(&secure_stats.locked_bytes_max);
+
+    return 0;
+}
+
 #ifndef HAVE_ALIGNED_MALLOC
 static __attribute__((malloc)) void *
 _sodium_malloc(const size_t size)
@@ -590,6 +923,7 @@ _sodium_malloc(const size_t size)
     unsigned char *base_ptr;
     unsigned char *canary_ptr;
     unsigned char *unprotected_ptr;
+    size_t         locked_size = 0U;
     size_t         size_with_canary;
     size_t         total_size;
     size_t         unprotected_size;
@@ -598,7 +932,8 @@ _sodium_malloc(const size_t size)
         errno = ENOMEM;
         return NULL;
     }
-    if (page_size <= sizeof canary || page_size < sizeof unprotected_size) {
+    if (page_size <= sizeof canary ||
+        page_size < sizeof unprotected_size + sizeof locked_size) {
         sodium_misuse(); /* LCOV_EXCL_LINE */
     }
     size_with_canary = (sizeof canary) + size;
@@ -613,28 +948,84 @@ _sodium_malloc(const size_t size)
     memcpy(unprotected_ptr + unprotected_size, canary, sizeof canary);
 # endif
     _mprotect_noaccess(unprotected_ptr + unprotected_size, page_size);
-    sodium_mlock(unprotected_ptr, unprotected_size);
+    if (sodium_mlock(unprotected_ptr, unprotected_size) == 0) {
+        locked_size = unprotected_size;
+    }
     canary_ptr =
         unprotected_ptr + _page_round(size_with_canary) - size_with_canary;
     user_ptr = canary_ptr + sizeof canary;
     memcpy(canary_ptr, canary, sizeof canary);
     memcpy(base_ptr, &unprotected_size, sizeof unprotected_size);
+    memcpy(base_ptr + sizeof unprotected_size, &locked_size, sizeof locked_size);
     _mprotect_readonly(base_ptr, page_size);
     assert(_unprotected_ptr_from_user_ptr(user_ptr) == unprotected_ptr);
+    _secure_stats_alloc(size, total_size, locked_size);
 
     return user_ptr;
 }
 #endif /* !HAVE_ALIGNED_MALLOC */
 
+static __attribute__((malloc)) void *
+_sodium_malloc_custom(const size_t size)
+{
+    unsigned char *base_ptr;
+    size_t         total_size;
+
+    if (size >= (size_t) SIZE_MAX - SECRET_HEADER_SIZE) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    total_size = SECRET_HEADER_SIZE + size;
+    if ((base_ptr = (unsigned char *)
+         _sodium_allocator_alloc(SODIUM_ALLOC_SECRET, total_size)) == NULL) {
+        return NULL;
+    }
+    memcpy(base_ptr, &total_size, sizeof total_size);
+    memcpy(base_ptr + SECRET_HEADER_SIZE - sizeof canary, canary,
+           sizeof canary);
+    _secure_stats_alloc(size, total_size, 0U);
+
+    return base_ptr + SECRET_HEADER_SIZE;
+}
+
+static void
+_sodium_free_custom(void *ptr)
+{
+    unsigned char *base_ptr;
+    size_t         total_size;
+
+    base_ptr = ((unsigned char *) ptr) - SECRET_HEADER_SIZE;
+    if (sodium_memcmp(base_ptr + SECRET_HEADER_SIZE - sizeof canary, canary,
+                      sizeof canary) != 0) {
+#ifdef HAVE_ALIGNED_MALLOC
+        _out_of_bounds();
+#else
+        abort();
+#endif
+    }
+    memcpy(&total_size, base_ptr, sizeof total_size);
+    sodium_memzero(base_ptr, total_size);
+    _sodium_allocator_free(SODIUM_ALLOC_SECRET, base_ptr, total_size);
+    _secure_stats_free(total_size - SECRET_HEADER_SIZE, total_size, 0U);
+}
+
 __attribute__((malloc)) void *
 sodium_malloc(const size_t size)
 {
     void *ptr;
 
-    if ((ptr = _sodium_malloc(size)) == NULL) {
+    SODIUM_PROBE1(malloc__entry, size);
+    if (_sodium_allocator_is_set(SODIUM_ALLOC_SECRET)) {
+        ptr = _sodium_malloc_custom(size);
+    } else {
+        ptr = _sodium_malloc(size);
+    }
+    if (ptr == NULL) {
+        SODIUM_PROBE2(malloc__return, NULL, size);
         return NULL;
     }
     memset(ptr, (int) GARBAGE_VALUE, size);
+    SODIUM_PROBE2(malloc__return, ptr, size);
 
     return ptr;
 }
@@ -653,6 +1044,10 @@ sodium_allocarray(size_t count, size_t size)
 void
 sodium_free(void *ptr)
 {
+    if (ptr != NULL && _sodium_allocator_is_set(SODIUM_ALLOC_SECRET)) {
+        _sodium_free_custom(ptr);
+        return;
+    }
     free(ptr);
 }
 #else
@@ -662,16 +1057,23 @@ sodium_free(void *ptr)
     unsigned char *base_ptr;
     unsigned char *canary_ptr;
     unsigned char *unprotected_ptr;
+    size_t         locked_size;
     size_t         total_size;
     size_t         unprotected_size;
 
     if (ptr == NULL) {
         return;
     }
+    if (_sodium_allocator_is_set(SODIUM_ALLOC_SECRET)) {
+        _sodium_free_custom(ptr);
+        return;
+    }
+    SODIUM_PROBE1(free__entry, ptr);
     canary_ptr      = ((unsigned char *) ptr) - sizeof canary;
     unprotected_ptr = _unprotected_ptr_from_user_ptr(ptr);
     base_ptr        = unprotected_ptr - page_size * 2U;
     memcpy(&unprotected_size, base_ptr, sizeof unprotected_size);
+    memcpy(&locked_size, base_ptr + sizeof unprotected_size, sizeof locked_size);
     total_size = page_size + page_size + unprotected_size + page_size;
     _mprotect_readwrite(base_ptr, total_size);
     if (sodium_memcmp(canary_ptr, canary, sizeof canary) != 0) {
@@ -685,6 +1087,10 @@ sodium_free(void *ptr)
 # endif
     sodium_munlock(unprotected_ptr, unprotected_size);
     _free_aligned(base_ptr, total_size);
+    _secure_stats_free((size_t) (unprotected_ptr + unprotected_size -
+                                 (unsigned char *) ptr),
+                       total_size, locked_size);
+    SODIUM_PROBE1(free__return, unprotected_size);
 }
 #endif /* HAVE_ALIGNED_MALLOC */
 
@@ -705,6 +1111,10 @@ _sodium_mprotect(void *ptr, int (*cb)(void *ptr, size_t size))
     unsigned char *unprotected_ptr;
     size_t         unprotected_size;
 
+    if (_sodium_allocator_is_set(SODIUM_ALLOC_SECRET)) {
+        errno = ENOSYS;
+        return -1;
+    }
     unprotected_ptr = _unprotected_ptr_from_user_ptr(ptr);
     base_ptr        = unprotected_ptr - page_size * 2U;
     memcpy(&unprotected_size, base_ptr, sizeof unprotected_size);
@@ -731,16 +1141,292 @@ sodium_mprotect_readwrite(void *ptr)
     return _sodium_mprotect(ptr, _mprotect_readwrite);
 }
 
+/*
+ * A secure pool is a single locked region, surrounded by guard pages,
+ * split into `count` slots. Each slot is:
+ * [16-bytes canary][user region][16-bytes canary][padding]
+ * Slots are wiped when they are returned to the pool.
+ */
+
+struct sodium_secure_pool {
+    unsigned char *base_ptr;
+    unsigned char *slots;
+    size_t         total_size;
+    size_t         slots_size;
+    size_t         slot_size;
+    size_t         stride;
+    size_t         count;
+    size_t         available;
+    size_t         locked_size;
+    size_t        *free_list;
+    unsigned char *used;
+};
+
+static size_t
+_secure_pool_slot_index(const sodium_secure_pool *pool, void *const ptr)
+{
+    uintptr_t offset;
+    size_t    i;
+
+    if ((uintptr_t) ptr < (uintptr_t) pool->slots + sizeof canary) {
+        sodium_misuse();
+    }
+    offset = (uintptr_t) ptr - (uintptr_t) pool->slots - sizeof canary;
+    i = (size_t) (offset / pool->stride);
+    if (offset % pool->stride != 0U || i >= pool->count) {
+        sodium_misuse();
+    }
+    return i;
+}
+
+sodium_secure_pool *
+sodium_secure_pool_create(const size_t slot_size, const size_t count)
+{
+    sodium_secure_pool *pool;
+    size_t              i;
+
+    if (slot_size <= 0U || count <= 0U ||
+        slot_size > SIZE_MAX - 4U * sizeof canary) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((pool = (sodium_secure_pool *) calloc(1U, sizeof *pool)) == NULL) {
+        return NULL;
+    }
+    pool->slot_size = slot_size;
+    pool->stride = (slot_size + 2U * sizeof canary + sizeof canary - 1U) &
+        ~(sizeof canary - 1U);
+    pool->count = count;
+    if (count > SIZE_MAX / pool->stride ||
+#ifdef HAVE_ALIGNED_MALLOC
+        count * pool->stride >= SIZE_MAX - page_size * 3U ||
+#endif
+        (pool->free_list = (size_t *) malloc(count * sizeof(size_t))) == NULL ||
+        (pool->used = (unsigned char *) calloc(count, 1U)) == NULL) {
+        sodium_secure_pool_destroy(pool);
+        errno = ENOMEM;
+        return NULL;
+    }
+#ifdef HAVE_ALIGNED_MALLOC
+    pool->slots_size = _page_round(count * pool->stride);
+    pool->total_size = page_size + pool->slots_size + page_size;
+    if ((pool->base_ptr = _alloc_aligned(pool->total_size)) == NULL) {
+        sodium_secure_pool_destroy(pool); /* LCOV_EXCL_LINE */
+        errno = ENOMEM; /* LCOV_EXCL_LINE */
+        return NULL; /* LCOV_EXCL_LINE */
+    }
+    pool->slots = pool->base_ptr + page_size;
+    _mprotect_noaccess(pool->base_ptr, page_size);
+    _mprotect_noaccess(pool->slots + pool->slots_size, page_size);
+#else
+    pool->slots_size = count * pool->stride;
+    pool->total_size = pool->slots_size;
+    if ((pool->base_ptr = (unsigned char *) malloc(pool->total_size)) == NULL) {
+        sodium_secure_pool_destroy(pool);
+        errno = ENOMEM;
+        return NULL;
+    }
+    pool->slots = pool->base_ptr;
+#endif
+    if (sodium_mlock(pool->slots, pool->slots_size) == 0) {
+        pool->locked_size = pool->slots_size;
+    }
+    _secure_stats_alloc(count * slot_size, pool->total_size, pool->locked_size);
+    for (i = 0U; i < count; i++) {
+        memcpy(pool->slots + i * pool->stride, canary, sizeof canary);
+        memcpy(pool->slots + i * pool->stride + sizeof canary + slot_size,
+               canary, sizeof canary);
+        pool->free_list[i] = count - 1U - i;
+    }
+    pool->available = count;
+
+    return pool;
+}
+
+void
+sodium_secure_pool_destroy(sodium_secure_pool *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    if (pool->base_ptr != NULL) {
+#ifdef HAVE_ALIGNED_MALLOC
+        _mprotect_readwrite(pool->base_ptr, pool->total_size);
+        sodium_munlock(pool->slots, pool->slots_size);
+        _free_aligned(pool->base_ptr, pool->total_size);
+#else
+        sodium_munlock(pool->slots, pool->slots_size);
+        free(pool->base_ptr);
+#endif
+        _secure_stats_free(pool->count * pool->slot_size, pool->total_size,
+                           pool->locked_size);
+    }
+    free(pool->free_list);
+    free(pool->used);
+    free(pool);
+}
+
+void *
+sodium_secure_pool_alloc(sodium_secure_pool *pool)
+{
+    unsigned char *ptr;
+    size_t         i;
+
+    if (pool->available <= 0U) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    i = pool->free_list[--pool->available];
+    pool->used[i] = 1U;
+    ptr = pool->slots + i * pool->stride + sizeof canary;
+    memset(ptr, (int) GARBAGE_VALUE, pool->slot_size);
+
+    return ptr;
+}
+
+void
+sodium_secure_pool_free(sodium_secure_pool *pool, void *ptr)
+{
+    unsigned char *slot;
+    size_t         i;
+
+    if (ptr == NULL) {
+        return;
+    }
+    i = _secure_pool_slot_index(pool, ptr);
+    if (pool->used[i] == 0U) {
+        sodium_misuse();
+    }
+    slot = pool->slots + i * pool->stride;
+#ifdef HAVE_PAGE_PROTECTION
+    if (pool->stride % page_size == 0U) {
+        _mprotect_readwrite(slot, pool->stride);
+    }
+#endif
+    if (sodium_memcmp(slot, canary, sizeof canary) != 0 ||
+        sodium_memcmp(slot + sizeof canary + pool->slot_size, canary,
+                      sizeof canary) != 0) {
+#ifdef HAVE_ALIGNED_MALLOC
+        _out_of_bounds();
+#else
+        abort();
+#endif
+    }
+    sodium_memzero(ptr, pool->slot_size);
+    pool->used[i] = 0U;
+    pool->free_list[pool->available++] = i;
+}
+
+static int
+_secure_pool_mprotect(sodium_secure_pool *pool, void *ptr,
+                      int (*cb)(void *ptr, size_t size))
+{
+    size_t i;
+
+    i = _secure_pool_slot_index(pool, ptr);
+#ifdef HAVE_PAGE_PROTECTION
+    if (pool->stride % page_size == 0U) {
+        return cb(pool->slots + i * pool->stride, pool->stride);
+    }
+    errno = EINVAL;
+#else
+    (void) i;
+    (void) cb;
+    errno = ENOSYS;
+#endif
+    return -1;
+}
+
+int
+sodium_secure_pool_mprotect_noaccess(sodium_secure_pool *pool, void *ptr)
+{
+    return _secure_pool_mprotect(pool, ptr, _mprotect_noaccess);
+}
+
+int
+sodium_secure_pool_mprotect_readonly(sodium_secure_pool *pool, void *ptr)
+{
+    return _secure_pool_mprotect(pool, ptr, _mprotect_readonly);
+}
+
+int
+sodium_secure_pool_mprotect_readwrite(sodium_secure_pool *pool, void *ptr)
+{
+    return _secure_pool_mprotect(pool, ptr, _mprotect_readwrite);
+}
+
+/*
+ * Padding works on the last block only. Which bytes are read and written
+ * only depends on the block position; within it, the number of message
+ * bytes only goes through masks. Blocks are processed 16 bytes at a time
+ * when vectors are available.
+ */
+
+#if defined(HAVE_EMMINTRIN_H) && defined(__SSE2__)
+# define PAD_SSE2
+#elif defined(HAVE_ARMNEON) && defined(__aarch64__)
+# define PAD_NEON
+#endif
+
+/* 0xff...ff if a < b, 0 otherwise; a and b must be < 2^63 */
+#define PAD_LT_MASK(A, B) \
+    ((size_t) 0U - (size_t) (((uint64_t) (A) - (uint64_t) (B)) >> 63))
+/* 0xff...ff if a == b, 0 otherwise */
+#define PAD_EQ_MASK(A, B) \
+    ((size_t) 0U - (size_t) ((((uint64_t) ((A) ^ (B))) - 1U) >> 63))
+
+/*
+ * Keeps the first len bytes of the block, sets the next one to 0x80 and
+ * clears the rest. len < blocksize.
+ */
+static void
+_sodium_pad_block(unsigned char *block, const size_t len,
+                  const size_t blocksize)
+{
+    size_t i = 0U;
+
+#if defined(PAD_SSE2) || defined(PAD_NEON)
+    for (; blocksize - i >= 16U; i += 16U) {
+        const size_t below = PAD_LT_MASK(len, i);
+        const size_t above = PAD_LT_MASK(i + 15U, len);
+        /* len - i, clamped to [-1, 16] */
+        const signed char t = (signed char) (unsigned char)
+            (((len - i) & ~below & ~above) | (16U & above) | (0xffU & below));
+# ifdef PAD_SSE2
+        const __m128i lanes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                            8, 9, 10, 11, 12, 13, 14, 15);
+        const __m128i tv = _mm_set1_epi8((char) t);
+        const __m128i v = _mm_loadu_si128((const __m128i *) (void *) &block[i]);
+
+        _mm_storeu_si128((__m128i *) (void *) &block[i],
+                         _mm_or_si128(_mm_and_si128(v, _mm_cmpgt_epi8(tv, lanes)),
+                                      _mm_and_si128(_mm_cmpeq_epi8(tv, lanes),
+                                                    _mm_set1_epi8((char) 0x80))));
+# else
+        static const int8_t lanes_[16] = { 0, 1, 2, 3, 4, 5, 6, 7,
+                                           8, 9, 10, 11, 12, 13, 14, 15 };
+        const int8x16_t  lanes = vld1q_s8(lanes_);
+        const int8x16_t  tv = vdupq_n_s8(t);
+        const uint8x16_t v = vld1q_u8(&block[i]);
+
+        vst1q_u8(&block[i],
+                 vorrq_u8(vandq_u8(v, vcgtq_s8(tv, lanes)),
+                          vandq_u8(vceqq_s8(tv, lanes), vdupq_n_u8(0x80))));
+# endif
+    }
+#endif
+    for (; i < blocksize; i++) {
+        block[i] = (unsigned char) ((block[i] & PAD_LT_MASK(i, len)) |
+                                    (0x80 & PAD_EQ_MASK(i, len)));
+    }
+}
+
 int
 sodium_pad(size_t *padded_buflen_p, unsigned char *buf,
            size_t unpadded_buflen, size_t blocksize, size_t max_buflen)
 {
-    unsigned char          *tail;
-    size_t                  i;
-    size_t                  xpadlen;
-    size_t                  xpadded_len;
-    volatile unsigned char  mask;
-    unsigned char           barrier_mask;
+    size_t xpadlen;
+    size_t xpadded_len;
 
     if (blocksize <= 0U) {
         return -1;
@@ -758,46 +1444,104 @@ sodium_pad(size_t *padded_buflen_p, unsigned char *buf,
     if (xpadded_len >= max_buflen) {
         return -1;
     }
-    tail = &buf[xpadded_len];
     if (padded_buflen_p != NULL) {
         *padded_buflen_p = xpadded_len + 1U;
     }
-    mask = 0U;
-    for (i = 0; i < blocksize; i++) {
-        barrier_mask = (unsigned char) (((i ^ xpadlen) - 1U)
-           >> ((sizeof(size_t) - 1) * CHAR_BIT));
-        *(tail - i) = ((*(tail - i)) & mask) | (0x80 & barrier_mask);
-        mask |= barrier_mask;
+    _sodium_pad_block(&buf[xpadded_len + 1U - blocksize],
+                      blocksize - 1U - xpadlen, blocksize);
+
+    return 0;
+}
+
+int
+sodium_pad_inplace(unsigned char *buf, size_t unpadded_buflen,
+                   size_t padded_buflen, size_t blocksize)
+{
+    if (blocksize <= 0U || unpadded_buflen >= padded_buflen ||
+        padded_buflen - unpadded_buflen > blocksize ||
+        padded_buflen % blocksize != 0U) {
+        return -1;
     }
+    _sodium_pad_block(&buf[padded_buflen - blocksize],
+                      unpadded_buflen - (padded_buflen - blocksize), blocksize);
+
     return 0;
 }
 
+#ifdef PAD_NEON
+static inline unsigned int
+_pad_neon_movemask(const uint8x16_t v)
+{
+    static const uint8_t bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128,
+                                      1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t     m = vandq_u8(v, vld1q_u8(bits));
+
+    return (unsigned int) vaddv_u8(vget_low_u8(m)) |
+        ((unsigned int) vaddv_u8(vget_high_u8(m)) << 8);
+}
+#endif
+
 int
 sodium_unpad(size_t *unpadded_buflen_p, const unsigned char *buf,
              size_t padded_buflen, size_t blocksize)
 {
-    const unsigned char *tail;
-    unsigned char        acc = 0U;
-    unsigned char        c;
-    unsigned char        valid = 0U;
-    volatile size_t      pad_len = 0U;
-    size_t               i;
-    size_t               is_barrier;
+    const unsigned char *block;
+    size_t               only_zeros = (size_t) 0U - 1U;
+    size_t               pad_len = 0U;
+    size_t               valid = 0U;
+    size_t               found;
+    size_t               i = blocksize;
 
     if (padded_buflen < blocksize || blocksize <= 0U) {
         return -1;
     }
-    tail = &buf[padded_buflen - 1U];
+    block = &buf[padded_buflen - blocksize];
+
+    /* the last non-zero byte of the block must be the 0x80 marker */
+#if defined(PAD_SSE2) || defined(PAD_NEON)
+    for (; i >= 16U; i -= 16U) {
+        unsigned int nz;
+        unsigned int marker;
+        unsigned int s;
+        unsigned int h1;
+# ifdef PAD_SSE2
+        const __m128i v =
+            _mm_loadu_si128((const __m128i *) (const void *) &block[i - 16U]);
+
+        nz = ~(unsigned int) _mm_movemask_epi8
+            (_mm_cmpeq_epi8(v, _mm_setzero_si128())) & 0xffffU;
+        marker = (unsigned int) _mm_movemask_epi8
+            (_mm_cmpeq_epi8(v, _mm_set1_epi8((char) 0x80)));
+# else
+        const uint8x16_t v = vld1q_u8(&block[i - 16U]);
+
+        nz = ~_pad_neon_movemask(vceqq_u8(v, vdupq_n_u8(0))) & 0xffffU;
+        marker = _pad_neon_movemask(vceqq_u8(v, vdupq_n_u8(0x80)));
+# endif
+        /* s has the bits up to the highest one of nz set, h1 counts them */
+        s = nz | (nz >> 1);
+        s |= s >> 2;
+        s |= s >> 4;
+        s |= s >> 8;
+        h1 = s - ((s >> 1) & 0x5555U);
+        h1 = (h1 & 0x3333U) + ((h1 >> 2) & 0x3333U);
+        h1 = (h1 + (h1 >> 4)) & 0x0f0fU;
+        h1 = (h1 + (h1 >> 8)) & 0x1fU;
+        found = only_zeros & PAD_LT_MASK(0U, nz);
+        pad_len |= (blocksize - (i - 16U) - h1) & found;
+        valid |= PAD_LT_MASK(0U, marker & (s ^ (s >> 1))) & found;
+        only_zeros &= ~found;
+    }
+#endif
+    for (; i > 0U; i--) {
+        const unsigned char c = block[i - 1U];
 
-    for (i = 0U; i < blocksize; i++) {
-        c = *(tail - i);
-        is_barrier =
-            (( (acc - 1U) & (pad_len - 1U) & ((c ^ 0x80) - 1U) ) >> 8) & 1U;
-        acc |= c;
-        pad_len |= i & (1U + ~is_barrier);
-        valid |= (unsigned char) is_barrier;
+        found = only_zeros & PAD_LT_MASK(0U, c);
+        pad_len |= (blocksize - i) & found;
+        valid |= PAD_EQ_MASK(c, 0x80U) & found;
+        only_zeros &= ~found;
     }
     *unpadded_buflen_p = padded_buflen - 1U - pad_len;
 
-    return (int) (valid - 1U);
+    return (int) (valid & 1U) - 1;
 }
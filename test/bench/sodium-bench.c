@@ -0,0 +1,555 @@
+/*
+ * Throughput and latency benchmarks for the public primitives.
+ *
+ * Bulk primitives are measured over message sizes from 16 bytes to 16 MiB
+ * and reported in cycles per byte; fixed-size operations are reported in
+ * operations per second. Each measurement is preceded by a warmup, and
+ * the reported figure is the median of several timed samples.
+ *
+ * Usage: sodium-bench [-j] [-q] [-c cpu] [-t seconds] [-f filter]
+ *                     [-i primitive=implementation]... [-w auto|256|512]
+ *   -j  JSON output
+ *   -q  quick run, sizes up to 64 KiB only
+ *   -c  pin the process to the given CPU (Linux only)
+ *   -t  minimum duration of every sample (default 0.05)
+ *   -f  only run benchmarks whose name contains the filter
+ *   -i  force an implementation, see sodium_set_implementation()
+ *   -w  vector width policy, see sodium_runtime_set_vector_policy()
+ */
+
+#ifdef __linux__
+# ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+# endif
+# include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sodium.h"
+
+#define MIN_SIZE      16U
+#define MAX_SIZE      (16U * 1024U * 1024U)
+#define QUICK_MAX     (64U * 1024U)
+#define SAMPLES       5
+#define WARMUP_NS     20000000ULL
+#define BUFFER_EXTRA  64U
+
+typedef void (*bench_fn)(size_t len);
+
+typedef struct bench {
+    const char *name;
+    bench_fn    fn;
+    int         bulk;
+    int       (*available)(void);
+} bench;
+
+static unsigned char *in;
+static unsigned char *out;
+static unsigned char  key[64];
+static unsigned char  nonce[32];
+static unsigned char  pk[crypto_sign_PUBLICKEYBYTES];
+static unsigned char  sk[crypto_sign_SECRETKEYBYTES];
+static unsigned char  sig[crypto_sign_BYTES];
+static unsigned char  q[crypto_scalarmult_BYTES];
+static volatile int   sink;
+
+static unsigned long long
+now_ns(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        abort();
+    }
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+        (unsigned long long) ts.tv_nsec;
+}
+
+static unsigned long long
+now_cycles(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int lo, hi;
+
+    __asm__ __volatile__ ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((unsigned long long) hi << 32) | lo;
+#else
+    return 0ULL;
+#endif
+}
+
+static void
+b_generichash(size_t len)
+{
+    crypto_generichash(out, crypto_generichash_BYTES, in, len, NULL, 0U);
+}
+
+static void
+b_generichash_blake2bp(size_t len)
+{
+    crypto_generichash_blake2bp(out, crypto_generichash_blake2bp_BYTES,
+                                in, len, NULL, 0U);
+}
+
+static void
+b_hash_sha256(size_t len)
+{
+    crypto_hash_sha256(out, in, len);
+}
+
+static void
+b_hash_sha512(size_t len)
+{
+    crypto_hash_sha512(out, in, len);
+}
+
+static void
+b_auth_hmacsha512256(size_t len)
+{
+    crypto_auth_hmacsha512256(out, in, len, key);
+}
+
+static void
+b_onetimeauth_poly1305(size_t len)
+{
+    crypto_onetimeauth_poly1305(out, in, len, key);
+}
+
+static void
+b_shorthash_siphash24(size_t len)
+{
+    crypto_shorthash_siphash24(out, in, len, key);
+}
+
+static void
+b_stream_chacha20_ietf(size_t len)
+{
+    crypto_stream_chacha20_ietf_xor(out, in, len, nonce, key);
+}
+
+static void
+b_stream_xchacha20(size_t len)
+{
+    crypto_stream_xchacha20_xor(out, in, len, nonce, key);
+}
+
+static void
+b_stream_xsalsa20(size_t len)
+{
+    crypto_stream_xsalsa20_xor(out, in, len, nonce, key);
+}
+
+static void
+b_stream_salsa2012(size_t len)
+{
+    crypto_stream_salsa2012_xor(out, in, len, nonce, key);
+}
+
+static void
+b_secretbox(size_t len)
+{
+    crypto_secretbox_easy(out, in, len, nonce, key);
+}
+
+static void
+b_aead_chacha20poly1305_ietf(size_t len)
+{
+    crypto_aead_chacha20poly1305_ietf_encrypt(out, NULL, in, len, NULL, 0U,
+                                              NULL, nonce, key);
+}
+
+static void
+b_aead_xchacha20poly1305_ietf(size_t len)
+{
+    crypto_aead_xchacha20poly1305_ietf_encrypt(out, NULL, in, len, NULL, 0U,
+                                               NULL, nonce, key);
+}
+
+static void
+b_aead_aes256gcm(size_t len)
+{
+    crypto_aead_aes256gcm_encrypt(out, NULL, in, len, NULL, 0U,
+                                  NULL, nonce, key);
+}
+
+static void
+b_aead_aegis128l(size_t len)
+{
+    crypto_aead_aegis128l_encrypt(out, NULL, in, len, NULL, 0U,
+                                  NULL, nonce, key);
+}
+
+static void
+b_aead_aegis256(size_t len)
+{
+    crypto_aead_aegis256_encrypt(out, NULL, in, len, NULL, 0U,
+                                 NULL, nonce, key);
+}
+
+static void
+b_bin2hex(size_t len)
+{
+    sodium_bin2hex((char *) out, 2U * len + 1U, in, len);
+}
+
+static void
+b_bin2base64(size_t len)
+{
+    sodium_bin2base64((char *) out, sodium_base64_ENCODED_LEN(len, 1U),
+                      in, len, sodium_base64_VARIANT_ORIGINAL);
+}
+
+static void
+b_memcmp(size_t len)
+{
+    sink = sodium_memcmp(in, out, len);
+}
+
+static void
+b_scalarmult(size_t len)
+{
+    (void) len;
+    sink = crypto_scalarmult(out, key, q);
+}
+
+static void
+b_scalarmult_base(size_t len)
+{
+    (void) len;
+    sink = crypto_scalarmult_base(out, key);
+}
+
+static void
+b_sign(size_t len)
+{
+    (void) len;
+    crypto_sign_detached(sig, NULL, in, 64U, sk);
+}
+
+static void
+b_sign_verify(size_t len)
+{
+    (void) len;
+    sink = crypto_sign_verify_detached(sig, in, 64U, pk);
+}
+
+static void
+b_box_beforenm(size_t len)
+{
+    (void) len;
+    sink = crypto_box_beforenm(out, q, key);
+}
+
+static void
+b_pwhash_argon2id(size_t len)
+{
+    (void) len;
+    sink = crypto_pwhash_argon2id(out, 32U, "password", 8U, nonce,
+                                  crypto_pwhash_argon2id_OPSLIMIT_INTERACTIVE,
+                                  crypto_pwhash_argon2id_MEMLIMIT_INTERACTIVE,
+                                  crypto_pwhash_argon2id_ALG_ARGON2ID13);
+}
+
+static const bench benches[] = {
+    { "generichash_blake2b", b_generichash, 1, NULL },
+    { "generichash_blake2bp", b_generichash_blake2bp, 1, NULL },
+    { "hash_sha256", b_hash_sha256, 1, NULL },
+    { "hash_sha512", b_hash_sha512, 1, NULL },
+    { "auth_hmacsha512256", b_auth_hmacsha512256, 1, NULL },
+    { "onetimeauth_poly1305", b_onetimeauth_poly1305, 1, NULL },
+    { "shorthash_siphash24", b_shorthash_siphash24, 1, NULL },
+    { "stream_chacha20_ietf", b_stream_chacha20_ietf, 1, NULL },
+    { "stream_xchacha20", b_stream_xchacha20, 1, NULL },
+    { "stream_xsalsa20", b_stream_xsalsa20, 1, NULL },
+    { "stream_salsa2012", b_stream_salsa2012, 1, NULL },
+    { "secretbox_xsalsa20poly1305", b_secretbox, 1, NULL },
+    { "aead_chacha20poly1305_ietf", b_aead_chacha20poly1305_ietf, 1, NULL },
+    { "aead_xchacha20poly1305_ietf", b_aead_xchacha20poly1305_ietf, 1, NULL },
+    { "aead_aes256gcm", b_aead_aes256gcm, 1, crypto_aead_aes256gcm_is_available },
+    { "aead_aegis128l", b_aead_aegis128l, 1, NULL },
+    { "aead_aegis256", b_aead_aegis256, 1, NULL },
+    { "bin2hex", b_bin2hex, 1, NULL },
+    { "bin2base64", b_bin2base64, 1, NULL },
+    { "memcmp", b_memcmp, 1, NULL },
+    { "scalarmult_curve25519", b_scalarmult, 0, NULL },
+    { "scalarmult_curve25519_base", b_scalarmult_base, 0, NULL },
+    { "sign_ed25519", b_sign, 0, NULL },
+    { "sign_ed25519_verify", b_sign_verify, 0, NULL },
+    { "box_beforenm", b_box_beforenm, 0, NULL },
+    { "pwhash_argon2id_interactive", b_pwhash_argon2id, 0, NULL }
+};
+
+static const char *primitives[] = {
+    "argon2", "blake2b", "chacha20", "curve25519", "poly1305", "salsa20"
+};
+
+static const struct {
+    const char *name;
+    int       (*has)(void);
+} features[] = {
+    { "neon", sodium_runtime_has_neon },
+    { "armcrypto", sodium_runtime_has_armcrypto },
+    { "sse2", sodium_runtime_has_sse2 },
+    { "sse3", sodium_runtime_has_sse3 },
+    { "ssse3", sodium_runtime_has_ssse3 },
+    { "sse41", sodium_runtime_has_sse41 },
+    { "avx", sodium_runtime_has_avx },
+    { "avx2", sodium_runtime_has_avx2 },
+    { "bmi2", sodium_runtime_has_bmi2 },
+    { "avx512f", sodium_runtime_has_avx512f },
+    { "aesni", sodium_runtime_has_aesni },
+    { "pclmul", sodium_runtime_has_pclmul },
+    { "vaes", sodium_runtime_has_vaes },
+    { "vpclmulqdq", sodium_runtime_has_vpclmulqdq },
+    { "shani", sodium_runtime_has_shani }
+};
+
+typedef struct result {
+    double ns_per_op;
+    double cycles_per_op;
+} result;
+
+static int
+cmp_double(const void *a_, const void *b_)
+{
+    const double a = *(const double *) a_;
+    const double b = *(const double *) b_;
+
+    return (a > b) - (a < b);
+}
+
+/* Runs fn until min_ns elapsed, returns the number of iterations done */
+static unsigned long long
+run_for(bench_fn fn, size_t len, unsigned long long min_ns)
+{
+    unsigned long long start = now_ns();
+    unsigned long long iters = 0ULL;
+
+    do {
+        fn(len);
+        iters++;
+    } while (now_ns() - start < min_ns);
+
+    return iters;
+}
+
+static void
+measure(const bench *b, size_t len, unsigned long long sample_ns, result *res)
+{
+    double             ns[SAMPLES], cycles[SAMPLES];
+    unsigned long long iters, i, t0, t1, c0, c1;
+    int                s;
+
+    iters = run_for(b->fn, len, WARMUP_NS);
+    iters = iters * sample_ns / WARMUP_NS;
+    if (iters == 0ULL) {
+        iters = 1ULL;
+    }
+    for (s = 0; s < SAMPLES; s++) {
+        t0 = now_ns();
+        c0 = now_cycles();
+        for (i = 0ULL; i < iters; i++) {
+            b->fn(len);
+        }
+        c1 = now_cycles();
+        t1 = now_ns();
+        ns[s]     = (double) (t1 - t0) / (double) iters;
+        cycles[s] = (double) (c1 - c0) / (double) iters;
+    }
+    qsort(ns, SAMPLES, sizeof ns[0], cmp_double);
+    qsort(cycles, SAMPLES, sizeof cycles[0], cmp_double);
+    res->ns_per_op     = ns[SAMPLES / 2];
+    res->cycles_per_op = cycles[SAMPLES / 2];
+}
+
+static void
+print_header(int json, int cpu)
+{
+    size_t i;
+    int    first = 1;
+
+    if (json) {
+        printf("{\n  \"version\": \"%s\",\n  \"cpu\": %d,\n  \"features\": [",
+               sodium_version_string(), cpu);
+        for (i = 0U; i < sizeof features / sizeof features[0]; i++) {
+            if (features[i].has()) {
+                printf("%s\"%s\"", first ? "" : ", ", features[i].name);
+                first = 0;
+            }
+        }
+        printf("],\n  \"implementations\": {");
+        for (i = 0U; i < sizeof primitives / sizeof primitives[0]; i++) {
+            printf("%s\"%s\": \"%s\"", i == 0U ? "" : ", ", primitives[i],
+                   sodium_implementation_name(primitives[i]));
+        }
+        printf("},\n  \"results\": [");
+        return;
+    }
+    printf("libsodium %s, features:", sodium_version_string());
+    for (i = 0U; i < sizeof features / sizeof features[0]; i++) {
+        if (features[i].has()) {
+            printf(" %s", features[i].name);
+        }
+    }
+    printf("\nimplementations:");
+    for (i = 0U; i < sizeof primitives / sizeof primitives[0]; i++) {
+        printf(" %s=%s", primitives[i],
+               sodium_implementation_name(primitives[i]));
+    }
+    printf("\n\n%-30s %10s %14s %14s %14s\n", "primitive", "size",
+           "cycles/byte", "MB/s", "ops/s");
+}
+
+static void
+print_result(int json, int *first, const bench *b, size_t len,
+             const result *res)
+{
+    const double ops = 1e9 / res->ns_per_op;
+    const double cpb = b->bulk ? res->cycles_per_op / (double) len : 0.0;
+
+    if (json) {
+        printf("%s\n    { \"primitive\": \"%s\", ", *first ? "" : ",", b->name);
+        if (b->bulk) {
+            printf("\"size\": %lu, \"cycles_per_byte\": %.3f, "
+                   "\"mb_per_sec\": %.1f, ",
+                   (unsigned long) len, cpb, ops * (double) len / 1e6);
+        }
+        printf("\"cycles_per_op\": %.0f, \"ns_per_op\": %.1f, "
+               "\"ops_per_sec\": %.1f }",
+               res->cycles_per_op, res->ns_per_op, ops);
+        *first = 0;
+        return;
+    }
+    if (b->bulk) {
+        printf("%-30s %10lu %14.3f %14.1f %14.1f\n", b->name,
+               (unsigned long) len, cpb, ops * (double) len / 1e6, ops);
+    } else {
+        printf("%-30s %10s %14s %14s %14.1f\n", b->name, "-", "-", "-", ops);
+    }
+    fflush(stdout);
+}
+
+static int
+pin_cpu(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return sched_setaffinity(0, sizeof set, &set);
+#else
+    (void) cpu;
+    return -1;
+#endif
+}
+
+int
+main(int argc, char *argv[])
+{
+    result             res;
+    const char        *filter = NULL;
+    unsigned long long sample_ns = 50000000ULL;
+    size_t             i, len, max_size = MAX_SIZE;
+    char              *sep;
+    int                c, cpu = -1, first = 1, json = 0;
+
+    while ((c = getopt(argc, argv, "jqc:t:f:i:w:")) != -1) {
+        switch (c) {
+        case 'j':
+            json = 1;
+            break;
+        case 'q':
+            max_size = QUICK_MAX;
+            break;
+        case 'c':
+            cpu = atoi(optarg);
+            break;
+        case 't':
+            sample_ns = (unsigned long long) (atof(optarg) * 1e9);
+            break;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'i':
+            if ((sep = strchr(optarg, '=')) == NULL) {
+                fprintf(stderr, "Expected primitive=implementation\n");
+                return 1;
+            }
+            *sep = 0;
+            if (sodium_set_implementation(optarg, sep + 1) != 0) {
+                fprintf(stderr, "Unknown implementation: %s=%s\n",
+                        optarg, sep + 1);
+                return 1;
+            }
+            break;
+        case 'w':
+            if (strcmp(optarg, "256") == 0) {
+                c = SODIUM_RUNTIME_VECTOR_POLICY_PREFER_256;
+            } else if (strcmp(optarg, "512") == 0) {
+                c = SODIUM_RUNTIME_VECTOR_POLICY_PREFER_512;
+            } else {
+                c = SODIUM_RUNTIME_VECTOR_POLICY_AUTO;
+            }
+            (void) sodium_runtime_set_vector_policy(c);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-j] [-q] [-c cpu] [-t seconds] "
+                    "[-f filter] [-i primitive=implementation]... "
+                    "[-w auto|256|512]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (cpu >= 0 && pin_cpu(cpu) != 0) {
+        perror("sched_setaffinity");
+        return 1;
+    }
+    if (sodium_init() < 0) {
+        return 1;
+    }
+    if ((in = (unsigned char *) malloc(MAX_SIZE + BUFFER_EXTRA)) == NULL ||
+        (out = (unsigned char *) malloc(2U * MAX_SIZE + BUFFER_EXTRA)) == NULL) {
+        perror("malloc");
+        return 1;
+    }
+    randombytes_buf(in, MAX_SIZE + BUFFER_EXTRA);
+    memcpy(out, in, MAX_SIZE + BUFFER_EXTRA);
+    randombytes_buf(key, sizeof key);
+    randombytes_buf(nonce, sizeof nonce);
+    crypto_sign_keypair(pk, sk);
+    crypto_sign_detached(sig, NULL, in, 64U, sk);
+    crypto_scalarmult_base(q, key);
+
+    print_header(json, cpu);
+    for (i = 0U; i < sizeof benches / sizeof benches[0]; i++) {
+        const bench *b = &benches[i];
+
+        if ((filter != NULL && strstr(b->name, filter) == NULL) ||
+            (b->available != NULL && b->available() == 0)) {
+            continue;
+        }
+        if (b->bulk == 0) {
+            measure(b, 0U, sample_ns, &res);
+            print_result(json, &first, b, 0U, &res);
+            continue;
+        }
+        for (len = MIN_SIZE; len <= max_size; len *= 4U) {
+            measure(b, len, sample_ns, &res);
+            print_result(json, &first, b, len, &res);
+        }
+    }
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+    free(out);
+    free(in);
+
+    return 0;
+}
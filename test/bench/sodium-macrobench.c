@@ -0,0 +1,832 @@
+/*
+ * End-to-end benchmarks for common protocol flows.
+ *
+ * Where sodium-bench measures single primitives, every operation here is a
+ * complete flow as an application would run it: a key exchange followed by
+ * the first secretstream message, a sealed box, a password verification,
+ * a signed token, or the encryption of a large file. Every operation is
+ * timed individually, so that latency percentiles can be reported in
+ * addition to throughput. With several threads, all of them run the same
+ * flow at the same time and the throughput is the aggregate.
+ *
+ * The file encryption flow streams chunks from and to memory; it measures
+ * the crypto and not the storage.
+ *
+ * The scaling mode (-s) runs the subsystems with shared state instead:
+ * sodium_init(), the random number generator, the guarded-page allocator
+ * and Argon2's large allocations, next to AEAD encryption and signing as
+ * a baseline. Every one of them runs over 1 to N threads, and the report
+ * shows the aggregate throughput and how much slower each thread gets.
+ *
+ * Usage: sodium-macrobench [-j] [-q] [-s] [-t seconds] [-f filter]
+ *                          [-T threads]
+ *   -j  JSON output
+ *   -q  quick run, 64 MiB files instead of 1 GiB
+ *   -s  scaling mode
+ *   -t  duration of every run (default 2)
+ *   -f  only run flows whose name contains the filter
+ *   -T  comma-separated list of thread counts (default 1, or
+ *       1, 2, 4, ... up to the number of CPUs in scaling mode)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef HAVE_PTHREAD
+# include <pthread.h>
+#endif
+
+#include "sodium.h"
+
+#define FILE_SIZE        (1024ULL * 1024ULL * 1024ULL)
+#define QUICK_FILE_SIZE  (64ULL * 1024ULL * 1024ULL)
+#define FILE_CHUNK_SIZE  (64U * 1024U)
+#define KX_MESSAGE_SIZE  256U
+#define SEAL_SIZE        1024U
+#define TOKEN_LIFETIME   3600
+#define MIN_OPS          3U
+#define MAX_THREADS      256
+
+typedef struct flow {
+    const char *name;
+    void     *(*setup)(void);
+    int       (*run)(void *ctx);
+    void      (*teardown)(void *ctx);
+    int         bulk;
+} flow;
+
+typedef struct worker {
+    const flow         *f;
+    void               *ctx;
+    unsigned long long *lat;
+    size_t              count;
+    size_t              cap;
+    unsigned long long  duration_ns;
+    int                 failed;
+} worker;
+
+static unsigned long long file_size = FILE_SIZE;
+
+static unsigned long long
+now_ns(void)
+{
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        abort();
+    }
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+        (unsigned long long) ts.tv_nsec;
+}
+
+/* crypto_kx handshake, then the first secretstream message each way */
+
+typedef struct kx_ctx {
+    unsigned char server_pk[crypto_kx_PUBLICKEYBYTES];
+    unsigned char server_sk[crypto_kx_SECRETKEYBYTES];
+    unsigned char m[KX_MESSAGE_SIZE];
+    unsigned char c[KX_MESSAGE_SIZE + crypto_secretstream_xchacha20poly1305_ABYTES];
+} kx_ctx;
+
+static void *
+kx_setup(void)
+{
+    kx_ctx *ctx;
+
+    if ((ctx = (kx_ctx *) malloc(sizeof *ctx)) == NULL) {
+        return NULL;
+    }
+    crypto_kx_keypair(ctx->server_pk, ctx->server_sk);
+    randombytes_buf(ctx->m, sizeof ctx->m);
+
+    return ctx;
+}
+
+static int
+kx_run(void *ctx_)
+{
+    kx_ctx        *ctx = (kx_ctx *) ctx_;
+    crypto_secretstream_xchacha20poly1305_state push, pull;
+    unsigned char  header[crypto_secretstream_xchacha20poly1305_HEADERBYTES];
+    unsigned char  client_pk[crypto_kx_PUBLICKEYBYTES];
+    unsigned char  client_sk[crypto_kx_SECRETKEYBYTES];
+    unsigned char  client_rx[crypto_kx_SESSIONKEYBYTES];
+    unsigned char  client_tx[crypto_kx_SESSIONKEYBYTES];
+    unsigned char  server_rx[crypto_kx_SESSIONKEYBYTES];
+    unsigned char  server_tx[crypto_kx_SESSIONKEYBYTES];
+    unsigned char  m2[KX_MESSAGE_SIZE];
+    unsigned char  tag;
+
+    crypto_kx_keypair(client_pk, client_sk);
+    if (crypto_kx_client_session_keys(client_rx, client_tx, client_pk,
+                                      client_sk, ctx->server_pk) != 0 ||
+        crypto_kx_server_session_keys(server_rx, server_tx, ctx->server_pk,
+                                      ctx->server_sk, client_pk) != 0) {
+        return -1;
+    }
+    crypto_secretstream_xchacha20poly1305_init_push(&push, header, client_tx);
+    crypto_secretstream_xchacha20poly1305_push(
+        &push, ctx->c, NULL, ctx->m, sizeof ctx->m, NULL, 0U,
+        crypto_secretstream_xchacha20poly1305_TAG_MESSAGE);
+    if (crypto_secretstream_xchacha20poly1305_init_pull(&pull, header,
+                                                        server_rx) != 0 ||
+        crypto_secretstream_xchacha20poly1305_pull(
+            &pull, m2, NULL, &tag, ctx->c, sizeof ctx->c, NULL, 0U) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/* crypto_box_seal of 1 KiB, and the matching open */
+
+typedef struct seal_ctx {
+    unsigned char pk[crypto_box_PUBLICKEYBYTES];
+    unsigned char sk[crypto_box_SECRETKEYBYTES];
+    unsigned char m[SEAL_SIZE];
+    unsigned char c[SEAL_SIZE + crypto_box_SEALBYTES];
+} seal_ctx;
+
+static void *
+seal_setup(void)
+{
+    seal_ctx *ctx;
+
+    if ((ctx = (seal_ctx *) malloc(sizeof *ctx)) == NULL) {
+        return NULL;
+    }
+    crypto_box_keypair(ctx->pk, ctx->sk);
+    randombytes_buf(ctx->m, sizeof ctx->m);
+    crypto_box_seal(ctx->c, ctx->m, sizeof ctx->m, ctx->pk);
+
+    return ctx;
+}
+
+static int
+seal_run(void *ctx_)
+{
+    seal_ctx *ctx = (seal_ctx *) ctx_;
+
+    return crypto_box_seal(ctx->c, ctx->m, sizeof ctx->m, ctx->pk);
+}
+
+static int
+seal_open_run(void *ctx_)
+{
+    seal_ctx *ctx = (seal_ctx *) ctx_;
+
+    return crypto_box_seal_open(ctx->m, ctx->c, sizeof ctx->c,
+                                ctx->pk, ctx->sk);
+}
+
+/* crypto_pwhash_str_verify at the interactive limits */
+
+typedef struct pwhash_ctx {
+    char str[crypto_pwhash_STRBYTES];
+} pwhash_ctx;
+
+static const char password[] = "correct horse battery staple";
+
+static void *
+pwhash_setup(void)
+{
+    pwhash_ctx *ctx;
+
+    if ((ctx = (pwhash_ctx *) malloc(sizeof *ctx)) == NULL) {
+        return NULL;
+    }
+    if (crypto_pwhash_str(ctx->str, password, sizeof password - 1U,
+                          crypto_pwhash_OPSLIMIT_INTERACTIVE,
+                          crypto_pwhash_MEMLIMIT_INTERACTIVE) != 0) {
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+static int
+pwhash_run(void *ctx_)
+{
+    pwhash_ctx *ctx = (pwhash_ctx *) ctx_;
+
+    return crypto_pwhash_str_verify(ctx->str, password, sizeof password - 1U);
+}
+
+/*
+ * Signed tokens: base64url(claims) "." base64url(Ed25519 signature).
+ * Minting builds fresh claims and signs them; verification decodes the
+ * token, checks the signature and the expiration time.
+ */
+
+#define TOKEN_CLAIMS_MAX 256U
+#define TOKEN_MAX \
+    (sodium_base64_ENCODED_LEN(TOKEN_CLAIMS_MAX, \
+                               sodium_base64_VARIANT_URLSAFE_NO_PADDING) + \
+     sodium_base64_ENCODED_LEN(crypto_sign_BYTES, \
+                               sodium_base64_VARIANT_URLSAFE_NO_PADDING))
+
+typedef struct token_ctx {
+    unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+    unsigned char sk[crypto_sign_SECRETKEYBYTES];
+    char          token[TOKEN_MAX];
+} token_ctx;
+
+static int
+token_mint(token_ctx *ctx)
+{
+    unsigned char jti[16];
+    unsigned char sig[crypto_sign_BYTES];
+    char          claims[TOKEN_CLAIMS_MAX];
+    char          jti_hex[2 * sizeof jti + 1];
+    const long    iat = (long) time(NULL);
+    size_t        claims_len, pos;
+    int           n;
+
+    randombytes_buf(jti, sizeof jti);
+    sodium_bin2hex(jti_hex, sizeof jti_hex, jti, sizeof jti);
+    n = snprintf(claims, sizeof claims,
+                 "{\"iss\":\"auth.example.com\",\"sub\":\"user-1234\","
+                 "\"aud\":\"api\",\"iat\":%ld,\"exp\":%ld,\"jti\":\"%s\"}",
+                 iat, iat + TOKEN_LIFETIME, jti_hex);
+    if (n <= 0 || (size_t) n >= sizeof claims) {
+        return -1;
+    }
+    claims_len = (size_t) n;
+    crypto_sign_detached(sig, NULL, (const unsigned char *) claims,
+                         claims_len, ctx->sk);
+    sodium_bin2base64(ctx->token, sizeof ctx->token,
+                      (const unsigned char *) claims, claims_len,
+                      sodium_base64_VARIANT_URLSAFE_NO_PADDING);
+    pos = strlen(ctx->token);
+    ctx->token[pos++] = '.';
+    sodium_bin2base64(ctx->token + pos, sizeof ctx->token - pos,
+                      sig, sizeof sig,
+                      sodium_base64_VARIANT_URLSAFE_NO_PADDING);
+    return 0;
+}
+
+static void *
+token_setup(void)
+{
+    token_ctx *ctx;
+
+    if ((ctx = (token_ctx *) malloc(sizeof *ctx)) == NULL) {
+        return NULL;
+    }
+    crypto_sign_keypair(ctx->pk, ctx->sk);
+    if (token_mint(ctx) != 0) {
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+static int
+token_mint_run(void *ctx_)
+{
+    return token_mint((token_ctx *) ctx_);
+}
+
+static int
+token_verify_run(void *ctx_)
+{
+    token_ctx    *ctx = (token_ctx *) ctx_;
+    unsigned char claims[TOKEN_CLAIMS_MAX + 1];
+    unsigned char sig[crypto_sign_BYTES];
+    const char   *dot, *exp;
+    size_t        claims_len, sig_len;
+
+    if ((dot = strchr(ctx->token, '.')) == NULL ||
+        sodium_base642bin(claims, sizeof claims - 1U, ctx->token,
+                          (size_t) (dot - ctx->token), NULL, &claims_len,
+                          NULL, sodium_base64_VARIANT_URLSAFE_NO_PADDING) != 0 ||
+        sodium_base642bin(sig, sizeof sig, dot + 1, strlen(dot + 1), NULL,
+                          &sig_len, NULL,
+                          sodium_base64_VARIANT_URLSAFE_NO_PADDING) != 0 ||
+        sig_len != sizeof sig) {
+        return -1;
+    }
+    if (crypto_sign_verify_detached(sig, claims, claims_len, ctx->pk) != 0) {
+        return -1;
+    }
+    claims[claims_len] = 0;
+    if ((exp = strstr((const char *) claims, "\"exp\":")) == NULL ||
+        strtol(exp + 6, NULL, 10) < (long) time(NULL)) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Large file encryption with secretstream, one chunk at a time */
+
+typedef struct file_ctx {
+    unsigned char key[crypto_secretstream_xchacha20poly1305_KEYBYTES];
+    unsigned char header[crypto_secretstream_xchacha20poly1305_HEADERBYTES];
+    unsigned char m[FILE_CHUNK_SIZE];
+    unsigned char c[FILE_CHUNK_SIZE + crypto_secretstream_xchacha20poly1305_ABYTES];
+} file_ctx;
+
+static void *
+file_setup(void)
+{
+    file_ctx *ctx;
+
+    if ((ctx = (file_ctx *) malloc(sizeof *ctx)) == NULL) {
+        return NULL;
+    }
+    crypto_secretstream_xchacha20poly1305_keygen(ctx->key);
+    randombytes_buf(ctx->m, sizeof ctx->m);
+
+    return ctx;
+}
+
+static int
+file_run(void *ctx_)
+{
+    file_ctx          *ctx = (file_ctx *) ctx_;
+    crypto_secretstream_xchacha20poly1305_state st;
+    unsigned long long left = file_size;
+    size_t             len;
+    unsigned char      tag;
+
+    crypto_secretstream_xchacha20poly1305_init_push(&st, ctx->header, ctx->key);
+    do {
+        len = left > FILE_CHUNK_SIZE ? FILE_CHUNK_SIZE : (size_t) left;
+        left -= len;
+        tag = left == 0ULL ? crypto_secretstream_xchacha20poly1305_TAG_FINAL : 0;
+        crypto_secretstream_xchacha20poly1305_push(&st, ctx->c, NULL, ctx->m,
+                                                   len, NULL, 0U, tag);
+    } while (left > 0ULL);
+
+    return 0;
+}
+
+static const flow flows[] = {
+    { "kx_secretstream_first_message", kx_setup, kx_run, free, 0 },
+    { "box_seal_1k", seal_setup, seal_run, free, 0 },
+    { "box_seal_open_1k", seal_setup, seal_open_run, free, 0 },
+    { "pwhash_str_verify_interactive", pwhash_setup, pwhash_run, free, 0 },
+    { "token_mint", token_setup, token_mint_run, free, 0 },
+    { "token_verify", token_setup, token_verify_run, free, 0 },
+    { "file_encrypt", file_setup, file_run, free, 1 }
+};
+
+/*
+ * Shared-state subsystems for the scaling mode. Every operation is cheap
+ * on its own; what matters is how it behaves when many threads call it.
+ */
+
+#define SCALE_AEAD_SIZE    1024U
+#define SCALE_PWHASH_MEM   (8U * 1024U * 1024U)
+
+typedef struct scale_ctx {
+    unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+    unsigned char sk[crypto_sign_SECRETKEYBYTES];
+    unsigned char key[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char nonce[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char m[SCALE_AEAD_SIZE];
+    unsigned char c[SCALE_AEAD_SIZE + crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned char sig[crypto_sign_BYTES];
+} scale_ctx;
+
+static void *
+scale_setup(void)
+{
+    scale_ctx *ctx;
+
+    if ((ctx = (scale_ctx *) malloc(sizeof *ctx)) == NULL) {
+        return NULL;
+    }
+    crypto_sign_keypair(ctx->pk, ctx->sk);
+    crypto_aead_chacha20poly1305_ietf_keygen(ctx->key);
+    randombytes_buf(ctx->nonce, sizeof ctx->nonce);
+    randombytes_buf(ctx->m, sizeof ctx->m);
+
+    return ctx;
+}
+
+static int
+scale_init_run(void *ctx_)
+{
+    (void) ctx_;
+
+    return sodium_init() < 0 ? -1 : 0;
+}
+
+static int
+scale_randombytes_run(void *ctx_)
+{
+    scale_ctx *ctx = (scale_ctx *) ctx_;
+
+    randombytes_buf(ctx->nonce, sizeof ctx->nonce);
+
+    return 0;
+}
+
+static int
+scale_malloc_run(void *ctx_)
+{
+    void *p;
+
+    (void) ctx_;
+    if ((p = sodium_malloc(64U)) == NULL) {
+        return -1;
+    }
+    sodium_free(p);
+
+    return 0;
+}
+
+static int
+scale_pwhash_run(void *ctx_)
+{
+    scale_ctx *ctx = (scale_ctx *) ctx_;
+
+    return crypto_pwhash(ctx->c, 32U, password, sizeof password - 1U,
+                         ctx->nonce, crypto_pwhash_argon2id_OPSLIMIT_MIN,
+                         SCALE_PWHASH_MEM, crypto_pwhash_ALG_ARGON2ID13);
+}
+
+static int
+scale_aead_run(void *ctx_)
+{
+    scale_ctx *ctx = (scale_ctx *) ctx_;
+
+    return crypto_aead_chacha20poly1305_ietf_encrypt(
+        ctx->c, NULL, ctx->m, sizeof ctx->m, NULL, 0U, NULL,
+        ctx->nonce, ctx->key);
+}
+
+static int
+scale_sign_run(void *ctx_)
+{
+    scale_ctx *ctx = (scale_ctx *) ctx_;
+
+    return crypto_sign_detached(ctx->sig, NULL, ctx->m, 64U, ctx->sk);
+}
+
+static const flow scale_flows[] = {
+    { "sodium_init", scale_setup, scale_init_run, free, 0 },
+    { "randombytes_buf_12", scale_setup, scale_randombytes_run, free, 0 },
+    { "sodium_malloc_free_64", scale_setup, scale_malloc_run, free, 0 },
+    { "pwhash_argon2id_8m", scale_setup, scale_pwhash_run, free, 0 },
+    { "aead_chacha20poly1305_ietf_1k", scale_setup, scale_aead_run, free, 0 },
+    { "sign_ed25519", scale_setup, scale_sign_run, free, 0 }
+};
+
+static int
+record(worker *w, unsigned long long ns)
+{
+    unsigned long long *lat;
+    size_t              cap;
+
+    if (w->count == w->cap) {
+        cap = w->cap == 0U ? 1024U : w->cap * 2U;
+        if ((lat = (unsigned long long *)
+             realloc(w->lat, cap * sizeof lat[0])) == NULL) {
+            return -1;
+        }
+        w->lat = lat;
+        w->cap = cap;
+    }
+    w->lat[w->count++] = ns;
+
+    return 0;
+}
+
+static void *
+worker_run(void *w_)
+{
+    worker            *w = (worker *) w_;
+    unsigned long long start, t0, t1;
+
+    if (w->f->run(w->ctx) != 0) {
+        w->failed = 1;
+        return NULL;
+    }
+    start = t1 = now_ns();
+    do {
+        t0 = t1;
+        if (w->f->run(w->ctx) != 0) {
+            w->failed = 1;
+            return NULL;
+        }
+        t1 = now_ns();
+        if (record(w, t1 - t0) != 0) {
+            w->failed = 1;
+            return NULL;
+        }
+    } while (t1 - start < w->duration_ns || w->count < MIN_OPS);
+
+    return NULL;
+}
+
+static int
+cmp_ull(const void *a_, const void *b_)
+{
+    const unsigned long long a = *(const unsigned long long *) a_;
+    const unsigned long long b = *(const unsigned long long *) b_;
+
+    return (a > b) - (a < b);
+}
+
+/* Nearest-rank percentile of a sorted array */
+static double
+percentile_us(const unsigned long long *v, size_t n, double p)
+{
+    size_t rank = (size_t) ((double) n * p + 0.999999);
+
+    if (rank == 0U) {
+        rank = 1U;
+    }
+    return (double) v[rank - 1U] / 1e3;
+}
+
+typedef struct stats {
+    int                threads;
+    unsigned long      ops;
+    double             p50_us;
+    double             p99_us;
+    double             p999_us;
+    double             ops_per_sec;
+    double             mb_per_sec;
+} stats;
+
+static int
+run_flow(const flow *f, int threads, unsigned long long duration_ns,
+         stats *st)
+{
+    worker             ws[MAX_THREADS];
+#ifdef HAVE_PTHREAD
+    pthread_t          tids[MAX_THREADS];
+#endif
+    unsigned long long *all;
+    unsigned long long  t0, wall_ns;
+    size_t              total = 0U, pos = 0U;
+    int                 i, ret = -1;
+
+    memset(ws, 0, sizeof ws);
+    for (i = 0; i < threads; i++) {
+        ws[i].f           = f;
+        ws[i].duration_ns = duration_ns;
+        if ((ws[i].ctx = f->setup()) == NULL) {
+            goto out;
+        }
+    }
+    t0 = now_ns();
+#ifdef HAVE_PTHREAD
+    for (i = 1; i < threads; i++) {
+        if (pthread_create(&tids[i], NULL, worker_run, &ws[i]) != 0) {
+            threads = i;
+            ws[0].failed = 1;
+            break;
+        }
+    }
+    worker_run(&ws[0]);
+    for (i = 1; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+#else
+    worker_run(&ws[0]);
+#endif
+    wall_ns = now_ns() - t0;
+    for (i = 0; i < threads; i++) {
+        if (ws[i].failed) {
+            goto out;
+        }
+        total += ws[i].count;
+    }
+    if ((all = (unsigned long long *) malloc(total * sizeof all[0])) == NULL) {
+        goto out;
+    }
+    for (i = 0; i < threads; i++) {
+        memcpy(all + pos, ws[i].lat, ws[i].count * sizeof all[0]);
+        pos += ws[i].count;
+    }
+    qsort(all, total, sizeof all[0], cmp_ull);
+    st->threads     = threads;
+    st->ops         = (unsigned long) total;
+    st->p50_us      = percentile_us(all, total, 0.50);
+    st->p99_us      = percentile_us(all, total, 0.99);
+    st->p999_us     = percentile_us(all, total, 0.999);
+    st->ops_per_sec = (double) total * 1e9 / (double) wall_ns;
+    st->mb_per_sec  =
+        f->bulk ? st->ops_per_sec * (double) file_size / 1e6 : 0.0;
+    free(all);
+    ret = 0;
+
+out:
+    for (i = 0; i < MAX_THREADS; i++) {
+        if (ws[i].ctx != NULL) {
+            f->teardown(ws[i].ctx);
+        }
+        free(ws[i].lat);
+    }
+    return ret;
+}
+
+static void
+print_header(int json, int scale)
+{
+    if (json) {
+        printf("{\n  \"version\": \"%s\",\n  \"mode\": \"%s\",\n"
+               "  \"results\": [",
+               sodium_version_string(), scale ? "scale" : "flows");
+    } else if (scale) {
+        printf("libsodium %s\n\n%-30s %7s %14s %14s %10s %10s\n",
+               sodium_version_string(), "subsystem", "threads", "ops/s",
+               "ops/s/thread", "speedup", "slowdown");
+    } else {
+        printf("libsodium %s\n\n%-30s %7s %9s %12s %12s %12s %12s %10s\n",
+               sodium_version_string(), "flow", "threads", "ops", "p50 (us)",
+               "p99 (us)", "p999 (us)", "ops/s", "MB/s");
+    }
+}
+
+static void
+print_stats(int json, int *first, const flow *f, const stats *st)
+{
+    if (json) {
+        printf("%s\n    { \"flow\": \"%s\", \"threads\": %d, \"ops\": %lu, "
+               "\"p50_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f, "
+               "\"ops_per_sec\": %.1f",
+               *first ? "" : ",", f->name, st->threads, st->ops, st->p50_us,
+               st->p99_us, st->p999_us, st->ops_per_sec);
+        if (f->bulk) {
+            printf(", \"bytes\": %llu, \"mb_per_sec\": %.1f",
+                   file_size, st->mb_per_sec);
+        }
+        printf(" }");
+        *first = 0;
+        return;
+    }
+    printf("%-30s %7d %9lu %12.1f %12.1f %12.1f %12.1f ", f->name,
+           st->threads, st->ops, st->p50_us, st->p99_us, st->p999_us,
+           st->ops_per_sec);
+    if (f->bulk) {
+        printf("%10.1f\n", st->mb_per_sec);
+    } else {
+        printf("%10s\n", "-");
+    }
+    fflush(stdout);
+}
+
+/*
+ * The speedup is the aggregate throughput relative to the first run of
+ * the series, and the slowdown is how much slower every thread got. With
+ * no contention at all, the speedup equals the thread count and the
+ * slowdown stays at 1.
+ */
+static void
+print_scale(int json, int *first, const flow *f, const stats *st,
+            const stats *base)
+{
+    const double per_thread = st->ops_per_sec / (double) st->threads;
+    const double base_per_thread =
+        base->ops_per_sec / (double) base->threads;
+    const double speedup  = st->ops_per_sec / base->ops_per_sec;
+    const double slowdown = base_per_thread / per_thread;
+
+    if (json) {
+        printf("%s\n    { \"subsystem\": \"%s\", \"threads\": %d, "
+               "\"ops_per_sec\": %.1f, \"ops_per_sec_per_thread\": %.1f, "
+               "\"speedup\": %.3f, \"slowdown\": %.3f, "
+               "\"p99_us\": %.1f }",
+               *first ? "" : ",", f->name, st->threads, st->ops_per_sec,
+               per_thread, speedup, slowdown, st->p99_us);
+        *first = 0;
+        return;
+    }
+    printf("%-30s %7d %14.1f %14.1f %10.2f %10.2f\n", f->name, st->threads,
+           st->ops_per_sec, per_thread, speedup, slowdown);
+    fflush(stdout);
+}
+
+static int
+parse_threads(const char *s, int *list, int max)
+{
+    char *end;
+    long  n;
+    int   count = 0;
+
+    do {
+        n = strtol(s, &end, 10);
+        if (end == s || n < 1 || n > MAX_THREADS || count >= max ||
+            (*end != 0 && *end != ',')) {
+            return -1;
+        }
+#ifndef HAVE_PTHREAD
+        if (n != 1) {
+            return -1;
+        }
+#endif
+        list[count++] = (int) n;
+        s = end + 1;
+    } while (*end != 0);
+
+    return count;
+}
+
+/* 1, 2, 4, ... up to the number of online CPUs */
+static int
+default_scale_threads(int *list, int max)
+{
+    long ncpu = 1;
+    int  n, count = 0;
+
+#if defined(HAVE_PTHREAD) && defined(_SC_NPROCESSORS_ONLN)
+    if ((ncpu = sysconf(_SC_NPROCESSORS_ONLN)) < 1) {
+        ncpu = 1;
+    } else if (ncpu > MAX_THREADS) {
+        ncpu = MAX_THREADS;
+    }
+#endif
+    for (n = 1; n < ncpu && count < max - 1; n *= 2) {
+        list[count++] = n;
+    }
+    list[count++] = (int) ncpu;
+
+    return count;
+}
+
+int
+main(int argc, char *argv[])
+{
+    stats              st, base;
+    const flow        *fs = flows;
+    const char        *filter = NULL;
+    unsigned long long duration_ns = 2000000000ULL;
+    size_t             i, n_flows = sizeof flows / sizeof flows[0];
+    int                thread_counts[16] = { 1 };
+    int                c, t, first = 1, json = 0, n_thread_counts = 0;
+    int                scale = 0;
+
+    while ((c = getopt(argc, argv, "jqst:f:T:")) != -1) {
+        switch (c) {
+        case 'j':
+            json = 1;
+            break;
+        case 'q':
+            file_size = QUICK_FILE_SIZE;
+            break;
+        case 's':
+            scale   = 1;
+            fs      = scale_flows;
+            n_flows = sizeof scale_flows / sizeof scale_flows[0];
+            break;
+        case 't':
+            duration_ns = (unsigned long long) (atof(optarg) * 1e9);
+            break;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'T':
+            n_thread_counts = parse_threads(optarg, thread_counts,
+                                            (int) (sizeof thread_counts /
+                                                   sizeof thread_counts[0]));
+            if (n_thread_counts <= 0) {
+                fprintf(stderr, "Invalid thread counts: %s\n", optarg);
+                return 1;
+            }
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-j] [-q] [-s] [-t seconds] "
+                    "[-f filter] [-T threads[,threads]...]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n_thread_counts == 0) {
+        n_thread_counts = scale ?
+            default_scale_threads(thread_counts,
+                                  (int) (sizeof thread_counts /
+                                         sizeof thread_counts[0])) : 1;
+    }
+    if (sodium_init() < 0) {
+        return 1;
+    }
+    print_header(json, scale);
+    for (i = 0U; i < n_flows; i++) {
+        if (filter != NULL && strstr(fs[i].name, filter) == NULL) {
+            continue;
+        }
+        for (t = 0; t < n_thread_counts; t++) {
+            if (run_flow(&fs[i], thread_counts[t], duration_ns, &st) != 0) {
+                fprintf(stderr, "%s failed\n", fs[i].name);
+                return 1;
+            }
+            if (t == 0) {
+                base = st;
+            }
+            if (scale) {
+                print_scale(json, &first, &fs[i], &st, &base);
+            } else {
+                print_stats(json, &first, &fs[i], &st);
+            }
+        }
+    }
+    if (json) {
+        printf("\n  ]\n}\n");
+    }
+    return 0;
+}
@@ -0,0 +1,348 @@
+#define TEST_NAME "aead_aegis128x"
+#include "cmptest.h"
+
+typedef struct test_vector {
+    const char *key_hex;
+    const char *nonce_hex;
+    const char *message_hex;
+    const char *ad_hex;
+    const char *ciphertext_hex;
+    const char *mac_hex;
+} test_vector;
+
+static const test_vector tests_x2[] = {
+    {
+        "000102030405060708090a0b0c0d0e0f",
+        "101112131415161718191a1b1c1d1e1f",
+        "",
+        "",
+        "",
+        "63117dc57756e402819a82e13eca8379",
+    },
+    {
+        "2e1fa972553d32f37da07e2e7a4b75e3",
+        "433240e6b11e5385acc3c92cddf7f1cf",
+        "3c",
+        "",
+        "61",
+        "05225232e9e822166a567da2c3647c20",
+    },
+    {
+        "2b3c33bc5d938133cfade4dfc1d57e37",
+        "b74c430157f96738c5ba678958979286",
+        "487a91ec80257eafcba1cb293034a5af",
+        "45d34599b54d8d1d",
+        "e7a7ed49fc4d12c158074f0c01bb4f70",
+        "721c15e7881b009913dff196bb6822bf",
+    },
+    {
+        "ce6f2168837a9219e9b433964288d856",
+        "cacfd5d2a88b78167d257a267d143fa5",
+        "aec28601fcfd22c5b0d8e2167a66d1672e626a2145b565aeb35c245556bad8",
+        "178b5a34eee9c8a164ca94d188",
+        "389e419760f0062ffc3dd8512cd9b86be3f51f599505e48d87258005fcb3c6",
+        "550d7f0307b637b995f3b2e1e1ea3161",
+    },
+    {
+        "9c4de9206ffeb28add04e6926c25c429",
+        "9dbdcea6e46d01838e8fd3758c1902c4",
+        "17ee5ac28abc2df9db8626ee3643f21329d692b2fecb3b21ed4c1b965f105b54169a44ef58b82b65b268d48368bd85feb50245ec6fcdbf0b9041664616374829",
+        "9bc5416cbe677a9c8e78de6ad6e0d6e7ca26392cdac82df55ebaa04c7e0ec7d3",
+        "b82764cf3376926e275392ed9d132f0d27b4c427ae68a4d0b5f502008f87698ff049c91a078fabac5d569e51d383d91298477f7b1c88c2ec5d2e96383cd71188",
+        "20fcc49171413925aefd1f1c3894fab9",
+    },
+    {
+        "5f22b1ada570161bc1d753d5af42c7d4",
+        "8ec67787921638b513df77e3c7f35029",
+        "be832a446a23e47f9c3e9d46790f869bb4cb59810e9c744accfeb049b5ea9e0330a9a2de8591e337052af8fd4cfed63c306911d48dde2d07748ba03f7515bcb1d57c7a3530c27152a3436e4c223260d7a154bceeb2af8d8943e5fc5f3609a9a7bf109eede9f9256411177ef5f84259f7367a11e212df5c265755036e593309ed",
+        "c2f9b817385ddc89eca37d87c5e881c661db67ad4e74c10582a5ecefd530a8ff34041565a9c05db610930347363f8923b6a55004f1213ab7b5724604866cacec",
+        "1b01ce49220ecde5f1b9b15dcb472e41d935c0f1ded7ef2fd43955b7b41212d9869b1895d31d18679f8ae20f748f98381ca61ebc2107dd3cf4ddfd2ccce579f7caabb4d6af90f49f5d5b60112966cb5cd8f4d7e47ce92b7398c31a19b0ba48cb6c6c008e046c4c154feff33a7f901069c63f78fba7160a710db914e430b927e4",
+        "863204591b28b7b0378918f76fc1355d",
+    },
+    {
+        "4935d03cf12e9d2658d0a13305960920",
+        "8fcff3c852f1260e3dabcaba29564db0",
+        "d39555dc4248f35b3bfc785e6a6a5dcf88c81d467727acecd9347d5c3b7748cf307a25424ee362b0f158c142ebd77d4f314b9205b263feae3ac1c3acf5b7640b85981bdaab5b0ec4c764c16cd4c2d8e4116ae09db4acf2e8e65b7b58db8e33fff8eeac6dcf4d8b6492e63eb6cdc186143911c1c094836d57ce426c5bad508ae15d925ab696a82f482c",
+        "8d52c79552da84",
+        "e522efa450731c01f163e9f2886a86c0d28e07460ad35ece7b904e1d0221bfcbd54d5419dc96a467d6e28306e1ba3c0ee0f0aa0c80d5a3223d8ed26ce604299d47f3099e24b24ee5cbb8e99a03953917f217cf67659bb0eb519e5db62c740c5cfb1e6509bb8b9e4449cc536a3e4b00dc2b3030b7e17c14807dd589cef91dab9d382372cd37bf133ceb",
+        "4bced0eea05848f18760ead94588e6cb",
+    },
+    {
+        "095005b6d83062c43e538ff17c1b78da",
+        "4cd252d424a1144c39f44538e1b36868",
+        "74af9e760e69170a849840280fadbeeebc459de121a7d056fea21c06aed20d071c4d5544f74c74f78a25e35664d34abe14103b879c6be211fd2043f4ab86513f8f0a0482eedac799c172a31d6156d713816ca91e45a12fadb70c50cb0b8b4c356b2c30cd23f0b679769e813db7fe0c268458fc5c46f7b3802d9c60f47286375c3da6549a79b863597ed73f6d8b63c42578055c28d28da0347f774f6df43c1dcaecfa4eb4ea010bc8b1167a3e9d6e16ad60835d0a8ff0b7f5f3c24ad80b542e58ea3c8c18aa20ffabcb999697c6e62ae1d23d2c57e10ad96f91d4476420ea7cf736a65e2726db1541caf0c86c972e9f5fd1419862a2910e331341b1798a8548",
+        "34111f6a505156c99f34b9d3e107e416c99faded8e9d93292ae9f2ac02018c21fb63d7871f9022d6829d35f56867385623a995e6636ef90c8b61df347ee5b353e8",
+        "740cd81333557fbf75d9df6df7b107e5db98709eb37d9f9e505154c78bb8cedcdc63eb7d44d880c26b41b1e003e459a8289fcab068b215339656601bf223d18a8cb2a62b14e5dc8b161fbebc574397d10aa1bc8fc5f295396867485b77c5f0e59713d9ea8fde3783c8d77906af449277979fbb8284014cb1f4939e7b061c3da6f2cd4dce093534904ec9fc9900c70328b7c2b15aaf4ecde0cf41b3e789099f054ada73a81707a9476d8128f9e98a12aa7ccbba9643c54dfe34f92765189f14e3f29adfb24c8c2594a0c9529d84021f314a57622244e6dbf900947bd2c96e90fdcf53386f5ee8a2f66674c5c67da79426a31b4945755504cf02f9110a9ab003",
+        "dadbf3df9f066a64c16fb3f324b83ccf",
+    },
+    {
+        "e8cfc6766a9475f56d722ce4af7e8aaa",
+        "7ebed88259880add2cc38f9c2fb65f42",
+        "d679b830ed240df92ace39b7f317e6c5452a1106553dd4a9d6d59f78f03fc47803ed2cf8d426c34cde669700eaf700de616c09d6fb33de5ba7968cda86ce95e2486f1c37d986d44f44e36de36946c241561fac081e0aeb8daacf600e8294afd08eae2154281e1abba1feffbb1d02dc00c49c41fa77741519d02f7701d59c6c5b6f358b24c96c92aea6d8685f31bf3d95d24c0426cf84899a5a3174a66896b8c1bbe3ecb87bada3ee3109b2800484d856eb4971ce1f652d829a05021f504b01bf116a1aaeed9ec477750db2061dd2b8eb3df0b3916005db8f102310a6e0a1d47657572066891c81a767a1d5951677632fa45f80826d149b362c3a810e0d25446e097748570a19fe34f1f2097b22efedd9f3e5ee9efed485fdfebdf9074c137f5c7d21f650a09855ddc84357e99b9b4e0c6f6285f81211ae8dd84a0d53364d9f4d59ea0ac94b27340cf4acc63c177b7603df4a632f41b13b44636dd13dfba6fa03e1f10a1ca85ba7a720c008037bb24ec4df06b1d36169c9e7058687a046c949c48f2eade1f31780843675eab0d5fadcad8816004ac3af17b276ff3524b97a719aeda5e7534e914540b790e4bdf05d815748be3627c5cf5358d4fef736b0f189daf47ebbaa9c529c2188ed4ec210b7a36e10766ef65f33c814ad48e0e79ab682be3e454ada69198755776530a141cfd82d9d8c33774b06524a1593ad0982486d1ac8",
+        "b38e0b",
+        "f0d64f431e6307742e94822f171e753fc0f15399c56d07005f628f57f4ca0a42e10a10a297a8a51b155efecb7a86b15017e478f17ea0ecd54746c9786df780779e92f3ac9d5c0178a070eac0085dddd9f546142a7a3e54309a8661ce4b4b60cf2c9b76aa5ef2188080e93b21399cb10e623cd937cc25dad6a733605a9c48e1a8726f8caada3f5bfb0bb30a499ccdb275eee1413fe782d2de5dc9da80d62915b99c9645447f922b5fa79af33a59a7478a9c7c215b95d984cb401f4def1a588cef1466f0e61b80b3a420a02d0e0b66c3396fbb4f1eb8f60e9c5a0f2be56a01cd6910efb1dfafdb5396ae1706a5d8f43ae07a0729901b7b876e1bdf42f6f43b755f6c70ff9108772fdc71d8d327a9da4419640f33010c28ee119f39b98e893afec43ef2d1d94a667f1acd38e3349ca8841060a3711f9f8ada07907b5a3e5e6aa8ff70058da0be2a3baa49cffd8ea198c7ec2001720719454609022b03afc0b91c60e380c5371d38210df0cee13946e2c6cf568aefb947a40dd77f634fee1e85406b366b431e963f527ff5a275236b5c15aadb51a0d95ce2611054b286986ec9cbaac0eedd64fa4dfcdf6bb18949cf5435b7ef3b8b31622ce0de8b88ccacadc5b98c5c52b84db9594fd2a354f46b0b2dfc3c303dc176555ea1ca17e38c95cd832b2fa18ccf9fc87ba997f7a1917e2c6ef670dd6aab911d8a2e3ef19efbcfe701f5a932",
+        "9de4afa4b005bca16173089a988ee753",
+    },
+};
+
+static const test_vector tests_x4[] = {
+    {
+        "000102030405060708090a0b0c0d0e0f",
+        "101112131415161718191a1b1c1d1e1f",
+        "",
+        "",
+        "",
+        "5bef762d0947c00455b97bb3af30dfa3",
+    },
+    {
+        "6da5d3a934dc91ad201795dd35f71cd2",
+        "621318dc1cb2206d39b1ba849cd95cae",
+        "f8",
+        "",
+        "a5",
+        "1532ea3bd3e16549a7acc6943f8b7d0b",
+    },
+    {
+        "c19ebdce74ce0065921b7dc49d97c537",
+        "ae162bfc457522ece4c9221d1b29f806",
+        "8dcd59e0d2aa178a25ffb320f1ccc2bc",
+        "a335b8f9ff520805",
+        "7ba6ad2682885f915a3e7c6dbb213c94",
+        "9ce4da6fda25ddfee79368fb554490f6",
+    },
+    {
+        "4a4c6ec2589b7b4d6b9abbc3d6e6669b",
+        "925be39a4c69e7c127ba51fbc9d576e9",
+        "73ae5519ef10b5261726d63c979c4b63043aa98d4ec298b9aed3ba9f6f7150",
+        "70e2891528007837525c09ae94",
+        "659bc2f7d4afdf2a47567e87e84170cfe16afef68ddc07122228c23dfd6416",
+        "46b70d0e5c5679e4d9c66746dd526832",
+    },
+    {
+        "9e30431cd96c0696c1c53526ce4bd0a0",
+        "f60ab0eb6fc75f824756eb3e5e767bc8",
+        "251584690a080edad144da4e39d76d497f004f0920421db5bd9329a30d8d6d02b030b07f5f59700b430cbe34a7891f602a8c369c9f5a4fa466f487054c620348",
+        "7152432ea553ed8c9a25711b0616bd5a8873634a36cfa307fb1c11f3e3033ef7",
+        "2e35f5f81451fa68d256f1ac6b00535f339fd21b908c6ddd4535a5c4f9d008a1d87c3e728bd45f107ae57b1b98676bb9dcf70d93555106960d1647628a10eb87",
+        "14eb193173e9f3a9a78b7869e4c16b04",
+    },
+    {
+        "5f82528380b31c588080138949155693",
+        "65f6a1a8e83090a58642af0d24b181af",
+        "8302066393b6e7a73f0b37254408cd24b6d23b8c76b273e49b1f279cbc1f44d05b6212784073bab584c50996d8e5a6a17d8982fcb88e45eee1f30c0b343c60c0400c389c687996ff5b9ab398680b3c6ef20eb9e04ed253c4c8feb6924d3f3585f2d7f3b7b063b160a31cce0cf9d47e89dc1c389aa1efa8410e7328aaf0a1b2a5",
+        "bb70746656ba93b05013c2d15d556682f8ae734674d38049126b372b85360dbfb43bfb1c91a7df42c23c8b33033c7a2fd151671aed37a1e8444d56d54de2c7e7",
+        "9a579ab3ebe2dae45762058d4dd72c2b7ce17403cb0bab37d7ebbac05afcc0e8a7402558302b6fd130c9f33b9115224c56178654dbc89d84f6e3d8af56c359a5dbb8ede8f970d04befef5c664a3fc0d9769b9a2b596f6620307c3dad43355263bbcca4657d86ca3ac65f4fc1c4ca143253022571c7f1db3b93d14f411ee0543c",
+        "22a447ef1e6a835b74c0f38434f35fe2",
+    },
+    {
+        "d7277fb1289f8327e5717c2c42ff07c1",
+        "cc9786ea4eba90b09b057c0fbd9c9548",
+        "dff2e3ee15dc789bcefd2560419633624a19b9eddba5544f61281e6731b7708b324dcd8654560ed70ba63d6787ad9519cc9c66260d48437990be1255722fb9819dba6cd5f9dea6015581c4119a9dea6675f8d11dc307225dac17354794faf32bcfcea7d68f35364fc54ddb9661a08b1369950702ad82e952cbcb26bbd6be035aa4fd61847785aaf7c4",
+        "f3c2813157585a",
+        "aa504e547b718a0d1e1f85a3ea0333090afea1a6fd302548e6f312bdbc21a00a2594e7423004cc3872ff77750ac632238f5c6317903a9f9b8bf68c2a0698ec8d12bcdfaf04b319618f20b3e233ca86ca4d759932a60f8343596f4d30e17122b4be3866f3667e363e61423dcfea39751130e707cf52881fa73a3ad9bb4c988751dc91e8cd24c4cd464b",
+        "ca56f5a06c6932424fed355f71a153d1",
+    },
+    {
+        "65571dd5d20d9f99d7208cb887a3b6c7",
+        "b59d80ff19bf6dff7ef9ccd70b96f7e1",
+        "159619b6b14c0d770d00f65d11fd3459b4b83e3849e3e3b9857f96756da7a3d9ded27c710a6aa7a4ec75fc5d6e855d9ec23557b790b8a548f92cb0cf45f353bb1e13f3bfb5e88238b2f32301a7f65a0e807d778466f607ac66ede10a109c49949b24ba73c757126f8cc813b661b4c6255a6141d82103f636be0561b612820045ff4476248039d959317c6ee8e490d25252e568584c3ccb1fdf38fd5ce830ba00f713f7a98cefc94c1da17e9d4a5b54ee4f348406ef65dba82ac8b7bb5869847c7b7ee2ea7bc46f8327e93996929dc05c23412e6a5adfdce93a17c6807d192ff6d21bf78e05f0e69bd0f72120b5f8c2ffd523d2a897fcd5ecb35903f26d9e16",
+        "c2dc7b5222c294f736bd5025468089f0862f5de15b7e0ddf34fd34498a75ed58233f58d563ec5bd414bd96f2ba622ab498aa15ff718d6de8473b69ee3347dc03ab",
+        "3eb7e7ae611598e5609190a97812ae866ced03cb90f87a4265d4cdf761595cfb1bd4da5f6e4e5e5d773a04b5b48c90d85fd90537cedb50101e07853e026b89210efb58f9716673c3bccadd8b1343756659557eae17ca238b3bb6bcfbff949ca9f7648ce3e701ea7774d81c9e6b5c1ff84077b35608eb065e3a693a6b73b12cdccd5f0e4cad57dc6484bdbb655106bdae6e35d698b7d00ad775b6856ebf00d151867a2820a51132bfd94bb63e952a07dcb2b3c48ed18cf7c7d765701591e8d245f8ca9fff732dc8d16d31bb3b346125331a947a5b935caffa7cf78a3be92531b72f4419a4c07b30e9d6f3063880c543767c378d0c8e3786056f307edf3f0443",
+        "df29910183da00da99199cdba5aabbe7",
+    },
+    {
+        "538238e7e152c77a74b196b8d5ae4052",
+        "cc0ba12cef87802662f83cf965fab75b",
+        "e937acfb1214dad34c343b8f94c1cde80198f937e608d0791cb2d3e167d91a12b02d99a319b86928dc9c591bd936c77d237fb34ccb4f54f65baab080fc866496f545cc355fd449f2aef3a0be7e2e3d0ac5919ae52a7b70117a1a11ae08af94c334696f3fe4ecef7d2c35da415b31f47e088a141841d140502a5add27caf86312a2b79b914032268f556fe0ed15d8a542484ddf740e98a6eb331955ef5b8acf73bf082073c2df41a79fd3b666adb7eb5ed4eec71f74719397783d7f4fd6c8a2a2297155eac15d5eb96f932e69b1531edeb912ca483e0210ffd704583d501de43089a85e1b6a5d6e2859a62f491aa6fc4321b5abcdcd6b6e9a8767f2db383d6070fbc3f102181da8cf322024a68fc4159fd0ce8297a701f6442ff95ac03348f2935463b29d23867a97da9b8ca796b876c06dfb80cae76443ffb01d21ddb5daef10903d2da4035f9c71e5e7564dc3c8d11dff6b2d0afeff8a51e500626bd6fad81eb769d57cf847103af549f3be4f4f1b1d9899c65bbbee3038dfd7820a92342e770e4ed5a27d00e0b8c95dae5ee0fd978360296cda09a41c20974f014519d11034959a41eb2118ae49e4a8bd6e518b85794129da5c672ef08a629a8e402e0aa584a4728fcadac63a564086776e4c969e791a47babd81bcf496dfbcfc5f90131728a1a99894e8d746befdddefdafe205bea4b0d7fdd9625902ff2fbb8b9be8321bb77",
+        "f611fe",
+        "3eeaba92353e50f12b868f07fd145c570035fb6b2f92e50027e55f5abd6d62a231ff78372eb3a8c789381d19087dfe6d59c89ad3d2f8ac63a4574212bb1fe1fcb927c1222fbc810ca0ca907c78b49728b423d5cddbf34c14348b6fd877be7d4b46e0a94bc257b2ebe62e5b3959e68cd016f26865654146166d04229947fb711af60e27fa7b2bb75243feccdeaf569d6d2074d7e556abc0a9bac7a1717e965fd8d585d72f2884bd16b72b92ef788d2ce036c357428dd29c52ea9a792dbd3b49c8ca94173c648d475461437187235678966fb82c0961c0a1b6086234c3e9055575ebfb2b8ee23fd9cad384ccbb99b516910cdd26af247cdd06b2eb8f35b484018d8acc6eba19270e3b67c7da4bdcea63fe59de414394d27d3ec29d612269a89b3ecfd73de5eaac2a9b85d7953fe68b92a5d946d77674e3083213b300aceeedb3ee2cdee55bc067128c4ee488ea15d9c0c471041f99e37f9976e2cdb87eb94c27e1027e7c60cdd8a8873c2edd1f3936973ffe2307d368f65e5de92ca957caca32e0def7db0490adf2bcfd779e7cdd4c9c5b6d03e4711dfe87f1973863b129f3ef5f1b680fe4278f3d259c3bcddd2a30553f91f871da6ab7c536fc088a13513bfd85babc07d6d3c60a1ce4ae54569a8aa00409bc6e4cb0fc421922d666cab733939249fdfed3ab2faf38ada227f2fdff5b03abf25390b7c2227b8cb309438c02dc76a5",
+        "435ade6b17ab163978564365d1bf3788",
+    },
+};
+
+typedef struct variant {
+    const char *name;
+    int (*encrypt)(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
+                   unsigned long long mlen, const unsigned char *ad, unsigned long long adlen,
+                   const unsigned char *nsec, const unsigned char *npub, const unsigned char *k);
+    int (*decrypt)(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
+                   const unsigned char *c, unsigned long long clen, const unsigned char *ad,
+                   unsigned long long adlen, const unsigned char *npub, const unsigned char *k);
+    int (*encrypt_detached)(unsigned char *c, unsigned char *mac, unsigned long long *maclen_p,
+                            const unsigned char *m, unsigned long long mlen,
+                            const unsigned char *ad, unsigned long long adlen,
+                            const unsigned char *nsec, const unsigned char *npub,
+                            const unsigned char *k);
+    int (*decrypt_detached)(unsigned char *m, unsigned char *nsec, const unsigned char *c,
+                            unsigned long long clen, const unsigned char *mac,
+                            const unsigned char *ad, unsigned long long adlen,
+                            const unsigned char *npub, const unsigned char *k);
+    const test_vector *tests;
+    size_t             tests_count;
+} variant;
+
+static void
+tv(const variant *v)
+{
+    unsigned char      *ad;
+    unsigned char      *ciphertext;
+    unsigned char      *decrypted;
+    unsigned char      *detached_ciphertext;
+    unsigned char      *expected_ciphertext;
+    unsigned char      *key;
+    unsigned char      *message;
+    unsigned char      *mac;
+    unsigned char      *nonce;
+    char               *hex;
+    unsigned long long  found_ciphertext_len;
+    unsigned long long  found_mac_len;
+    unsigned long long  found_message_len;
+    size_t              ad_len;
+    size_t              ciphertext_len;
+    size_t              i = 0U;
+    size_t              message_len;
+
+    key = (unsigned char *) sodium_malloc(crypto_aead_aegis128x2_KEYBYTES);
+    nonce = (unsigned char *) sodium_malloc(crypto_aead_aegis128x2_NPUBBYTES);
+    mac = (unsigned char *) sodium_malloc(crypto_aead_aegis128x2_ABYTES);
+
+    do {
+        const test_vector *t = &v->tests[i];
+
+        assert(strlen(t->key_hex) == 2 * crypto_aead_aegis128x2_KEYBYTES);
+        sodium_hex2bin(key, crypto_aead_aegis128x2_KEYBYTES, t->key_hex,
+                       strlen(t->key_hex), NULL, NULL, NULL);
+        assert(strlen(t->nonce_hex) == 2 * crypto_aead_aegis128x2_NPUBBYTES);
+        sodium_hex2bin(nonce, crypto_aead_aegis128x2_NPUBBYTES, t->nonce_hex,
+                       strlen(t->nonce_hex), NULL, NULL, NULL);
+        message_len = strlen(t->message_hex) / 2;
+        message = (unsigned char *) sodium_malloc(message_len);
+        sodium_hex2bin(message, message_len, t->message_hex, strlen(t->message_hex),
+                       NULL, NULL, NULL);
+        ad_len = strlen(t->ad_hex) / 2;
+        ad = (unsigned char *) sodium_malloc(ad_len);
+        sodium_hex2bin(ad, ad_len, t->ad_hex, strlen(t->ad_hex), NULL, NULL, NULL);
+        ciphertext_len = message_len + crypto_aead_aegis128x2_ABYTES;
+        expected_ciphertext = (unsigned char *) sodium_malloc(ciphertext_len);
+        assert(strlen(t->ciphertext_hex) == 2 * message_len);
+        sodium_hex2bin(expected_ciphertext, message_len, t->ciphertext_hex,
+                       strlen(t->ciphertext_hex), NULL, NULL, NULL);
+        assert(strlen(t->mac_hex) == 2 * crypto_aead_aegis128x2_ABYTES);
+        sodium_hex2bin(expected_ciphertext + message_len, crypto_aead_aegis128x2_ABYTES,
+                       t->mac_hex, strlen(t->mac_hex), NULL, NULL, NULL);
+        ciphertext = (unsigned char *) sodium_malloc(ciphertext_len);
+        detached_ciphertext = (unsigned char *) sodium_malloc(message_len);
+
+        v->encrypt_detached(detached_ciphertext, mac, &found_mac_len, message,
+                            message_len, ad, ad_len, NULL, nonce, key);
+        assert(found_mac_len == crypto_aead_aegis128x2_ABYTES);
+        if (memcmp(detached_ciphertext, expected_ciphertext, message_len) != 0 ||
+            memcmp(mac, expected_ciphertext + message_len, crypto_aead_aegis128x2_ABYTES) != 0) {
+            printf("Detached encryption of %s test vector #%u failed\n", v->name,
+                   (unsigned int) i);
+        }
+
+        v->encrypt(ciphertext, &found_ciphertext_len, message, message_len, ad,
+                   ad_len, NULL, nonce, key);
+        assert((size_t) found_ciphertext_len == ciphertext_len);
+        if (memcmp(ciphertext, expected_ciphertext, ciphertext_len) != 0) {
+            printf("Encryption of %s test vector #%u failed\n", v->name, (unsigned int) i);
+            hex = (char *) sodium_malloc((size_t) found_ciphertext_len * 2 + 1);
+            sodium_bin2hex(hex, (size_t) found_ciphertext_len * 2 + 1, ciphertext, ciphertext_len);
+            printf("Computed: [%s]\n", hex);
+            sodium_free(hex);
+        }
+
+        decrypted = (unsigned char *) sodium_malloc(message_len);
+        found_message_len = 1;
+        if (v->decrypt(decrypted, &found_message_len, NULL, ciphertext,
+                       randombytes_uniform((uint32_t) ciphertext_len), ad, ad_len,
+                       nonce, key) != -1) {
+            printf("Verification of %s test vector #%u after truncation succeeded\n",
+                   v->name, (unsigned int) i);
+        }
+        if (found_message_len != 0) {
+            printf("Message length should have been set to zero after a failure\n");
+        }
+        if (v->decrypt(NULL, NULL, NULL, ciphertext, ciphertext_len,
+                       ad, ad_len, nonce, key) != 0) {
+            printf("Verification of %s test vector #%u's tag failed\n", v->name,
+                   (unsigned int) i);
+        }
+        if (v->decrypt(decrypted, &found_message_len, NULL, ciphertext,
+                       ciphertext_len, ad, ad_len, nonce, key) != 0) {
+            printf("Verification of %s test vector #%u failed\n", v->name, (unsigned int) i);
+        }
+        assert((size_t) found_message_len == message_len);
+        if (memcmp(decrypted, message, message_len) != 0) {
+            printf("Incorrect decryption of %s test vector #%u\n", v->name, (unsigned int) i);
+        }
+        memset(decrypted, 0xd0, message_len);
+        if (v->decrypt_detached(decrypted, NULL, detached_ciphertext, message_len,
+                                mac, ad, ad_len, nonce, key) != 0) {
+            printf("Detached verification of %s test vector #%u failed\n", v->name,
+                   (unsigned int) i);
+        }
+        if (memcmp(decrypted, message, message_len) != 0) {
+            printf("Incorrect decryption of %s test vector #%u\n", v->name, (unsigned int) i);
+        }
+        if (message_len > 0U) {
+            ciphertext[randombytes_uniform((uint32_t) message_len)] ^= 0x01;
+            if (v->decrypt(decrypted, NULL, NULL, ciphertext, ciphertext_len,
+                           ad, ad_len, nonce, key) != -1) {
+                printf("Forgery of %s test vector #%u succeeded\n", v->name,
+                       (unsigned int) i);
+            }
+        }
+
+        sodium_free(message);
+        sodium_free(ad);
+        sodium_free(expected_ciphertext);
+        sodium_free(ciphertext);
+        sodium_free(decrypted);
+        sodium_free(detached_ciphertext);
+    } while (++i < v->tests_count);
+
+    sodium_free(key);
+    sodium_free(mac);
+    sodium_free(nonce);
+}
+
+int
+main(void)
+{
+    static const variant x2 = {
+        "aegis128x2",
+        crypto_aead_aegis128x2_encrypt, crypto_aead_aegis128x2_decrypt,
+        crypto_aead_aegis128x2_encrypt_detached, crypto_aead_aegis128x2_decrypt_detached,
+        tests_x2, (sizeof tests_x2) / (sizeof tests_x2[0])
+    };
+    static const variant x4 = {
+        "aegis128x4",
+        crypto_aead_aegis128x4_encrypt, crypto_aead_aegis128x4_decrypt,
+        crypto_aead_aegis128x4_encrypt_detached, crypto_aead_aegis128x4_decrypt_detached,
+        tests_x4, (sizeof tests_x4) / (sizeof tests_x4[0])
+    };
+
+    if (crypto_aead_aegis128x2_is_available()) {
+        tv(&x2);
+    }
+    if (crypto_aead_aegis128x4_is_available()) {
+        tv(&x4);
+    }
+    assert(crypto_aead_aegis128x2_keybytes() == crypto_aead_aegis128x2_KEYBYTES);
+    assert(crypto_aead_aegis128x2_nsecbytes() == crypto_aead_aegis128x2_NSECBYTES);
+    assert(crypto_aead_aegis128x2_npubbytes() == crypto_aead_aegis128x2_NPUBBYTES);
+    assert(crypto_aead_aegis128x2_abytes() == crypto_aead_aegis128x2_ABYTES);
+    assert(crypto_aead_aegis128x2_messagebytes_max() == crypto_aead_aegis128x2_MESSAGEBYTES_MAX);
+    assert(crypto_aead_aegis128x4_keybytes() == crypto_aead_aegis128x4_KEYBYTES);
+    assert(crypto_aead_aegis128x4_nsecbytes() == crypto_aead_aegis128x4_NSECBYTES);
+    assert(crypto_aead_aegis128x4_npubbytes() == crypto_aead_aegis128x4_NPUBBYTES);
+    assert(crypto_aead_aegis128x4_abytes() == crypto_aead_aegis128x4_ABYTES);
+    assert(crypto_aead_aegis128x4_messagebytes_max() == crypto_aead_aegis128x4_MESSAGEBYTES_MAX);
+    assert(crypto_aead_aegis128x2_KEYBYTES == crypto_aead_aegis128x4_KEYBYTES);
+    assert(crypto_aead_aegis128x2_NPUBBYTES == crypto_aead_aegis128x4_NPUBBYTES);
+    printf("OK\n");
+
+    return 0;
+}
@@ -2182,16 +2182,208 @@ tv(void)
     return 0;
 }
 
+static size_t
+split_iov(crypto_aead_iovec *iov, size_t max_count, unsigned char *buf, size_t len)
+{
+    size_t count = 0U;
+    size_t chunk;
+
+    while (len > 0U && count < max_count - 1U) {
+        chunk = (size_t) randombytes_uniform(300U);
+        if (chunk > len) {
+            chunk = len;
+        }
+        iov[count].ptr = buf;
+        iov[count].len = chunk;
+        buf += chunk;
+        len -= chunk;
+        count++;
+    }
+    iov[count].ptr = buf;
+    iov[count].len = len;
+
+    return count + 1U;
+}
+
+static void
+tv_iov(void)
+{
+    crypto_aead_iovec   m_iov[64];
+    crypto_aead_iovec   c_iov[64];
+    crypto_aead_iovec   ad_iov[64];
+    unsigned char      *key = (unsigned char *) sodium_malloc(crypto_aead_aegis256_KEYBYTES);
+    unsigned char      *nonce = (unsigned char *) sodium_malloc(crypto_aead_aegis256_NPUBBYTES);
+    unsigned char      *mac = (unsigned char *) sodium_malloc(crypto_aead_aegis256_ABYTES);
+    unsigned char      *mac2 = (unsigned char *) sodium_malloc(crypto_aead_aegis256_ABYTES);
+    unsigned char      *m;
+    unsigned char      *m2;
+    unsigned char      *c;
+    unsigned char      *c2;
+    unsigned char      *ad;
+    unsigned long long  maclen;
+    size_t              mlen;
+    size_t              adlen;
+    size_t              m_count;
+    size_t              c_count;
+    size_t              ad_count;
+    int                 i;
+
+    crypto_aead_aegis256_keygen(key);
+    randombytes_buf(nonce, crypto_aead_aegis256_NPUBBYTES);
+    for (i = 0; i < 100; i++) {
+        mlen = (size_t) randombytes_uniform(3000U);
+        adlen = (size_t) randombytes_uniform(200U);
+        m = (unsigned char *) sodium_malloc(mlen + 1U);
+        m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        c = (unsigned char *) sodium_malloc(mlen + 1U);
+        c2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        ad = (unsigned char *) sodium_malloc(adlen + 1U);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_aegis256_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen, NULL, nonce, key);
+
+        m_count = split_iov(m_iov, 64U, m, mlen);
+        c_count = split_iov(c_iov, 64U, c2, mlen);
+        ad_count = split_iov(ad_iov, 64U, ad, adlen);
+        assert(crypto_aead_aegis256_encrypt_detached_iov(c_iov, c_count, mac2, &maclen,
+               m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(maclen == crypto_aead_aegis256_ABYTES);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aegis256_ABYTES) == 0);
+
+        assert(crypto_aead_aegis256_decrypt_detached_iov(NULL, 0U, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        m_count = split_iov(m_iov, 64U, m2, mlen);
+        assert(crypto_aead_aegis256_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+
+        c_count = split_iov(c_iov, 64U, m2, mlen);
+        assert(crypto_aead_aegis256_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+               c_iov, c_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(memcmp(c, m2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aegis256_ABYTES) == 0);
+
+        mac2[0] ^= 1;
+        assert(crypto_aead_aegis256_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac2,
+               ad_iov, ad_count, nonce, key) == -1);
+        assert(mlen == 0U || sodium_is_zero(m2, mlen));
+
+        if (mlen > 0U) {
+            c_iov[c_count - 1U].len++;
+            assert(crypto_aead_aegis256_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+                   m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == -1);
+        }
+        sodium_free(m);
+        sodium_free(m2);
+        sodium_free(c);
+        sodium_free(c2);
+        sodium_free(ad);
+    }
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(mac);
+    sodium_free(mac2);
+}
+
+static void
+tv_stream(void)
+{
+    crypto_aead_aegis256_state  st;
+    unsigned char              *key = (unsigned char *) sodium_malloc(crypto_aead_aegis256_KEYBYTES);
+    unsigned char              *nonce = (unsigned char *) sodium_malloc(crypto_aead_aegis256_NPUBBYTES);
+    unsigned char              *mac = (unsigned char *) sodium_malloc(crypto_aead_aegis256_ABYTES);
+    unsigned char              *mac2 = (unsigned char *) sodium_malloc(crypto_aead_aegis256_ABYTES);
+    unsigned char              *m;
+    unsigned char              *m2;
+    unsigned char              *c;
+    unsigned char              *c2;
+    unsigned char              *ad;
+    size_t                      mlen;
+    size_t                      adlen;
+    size_t                      j;
+    size_t                      chunk;
+    int                         i;
+
+    crypto_aead_aegis256_keygen(key);
+    randombytes_buf(nonce, crypto_aead_aegis256_NPUBBYTES);
+    for (i = 0; i < 100; i++) {
+        mlen = (size_t) randombytes_uniform(3000U);
+        adlen = (size_t) randombytes_uniform(200U);
+        m = (unsigned char *) sodium_malloc(mlen + 1U);
+        m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        c = (unsigned char *) sodium_malloc(mlen + 1U);
+        c2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        ad = (unsigned char *) sodium_malloc(adlen + 1U);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_aegis256_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen, NULL, nonce, key);
+
+        assert(crypto_aead_aegis256_init(&st, nonce, key) == 0);
+        for (j = 0U; j < adlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(40U);
+            if (chunk > adlen - j) {
+                chunk = adlen - j;
+            }
+            assert(crypto_aead_aegis256_update_ad(&st, ad + j, chunk) == 0);
+        }
+        for (j = 0U; j < mlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(300U);
+            if (chunk > mlen - j) {
+                chunk = mlen - j;
+            }
+            assert(crypto_aead_aegis256_encrypt_update(&st, c2 + j, m + j, chunk) == 0);
+        }
+        if (mlen > 0U) {
+            assert(crypto_aead_aegis256_update_ad(&st, ad, adlen) == -1);
+        }
+        assert(crypto_aead_aegis256_encrypt_final(&st, mac2) == 0);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aegis256_ABYTES) == 0);
+
+        assert(crypto_aead_aegis256_init(&st, nonce, key) == 0);
+        assert(crypto_aead_aegis256_update_ad(&st, ad, adlen) == 0);
+        for (j = 0U; j < mlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(300U);
+            if (chunk > mlen - j) {
+                chunk = mlen - j;
+            }
+            assert(crypto_aead_aegis256_decrypt_update(&st, m2 + j, c + j, chunk) == 0);
+        }
+        assert(crypto_aead_aegis256_decrypt_final(&st, mac) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+
+        mac2[0] ^= 1;
+        assert(crypto_aead_aegis256_init(&st, nonce, key) == 0);
+        assert(crypto_aead_aegis256_update_ad(&st, ad, adlen) == 0);
+        assert(crypto_aead_aegis256_decrypt_update(&st, m2, c, mlen) == 0);
+        assert(crypto_aead_aegis256_decrypt_final(&st, mac2) == -1);
+
+        sodium_free(m);
+        sodium_free(m2);
+        sodium_free(c);
+        sodium_free(c2);
+        sodium_free(ad);
+    }
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(mac);
+    sodium_free(mac2);
+}
+
 int
 main(void)
 {
     if (crypto_aead_aegis256_is_available()) {
         tv();
+        tv_iov();
+        tv_stream();
     }
     assert(crypto_aead_aegis256_keybytes() == crypto_aead_aegis256_KEYBYTES);
     assert(crypto_aead_aegis256_nsecbytes() == crypto_aead_aegis256_NSECBYTES);
     assert(crypto_aead_aegis256_npubbytes() == crypto_aead_aegis256_NPUBBYTES);
     assert(crypto_aead_aegis256_abytes() == crypto_aead_aegis256_ABYTES);
+    assert(crypto_aead_aegis256_statebytes() == sizeof(crypto_aead_aegis256_state));
     assert(crypto_aead_aegis256_messagebytes_max() == crypto_aead_aegis256_MESSAGEBYTES_MAX);
     printf("OK\n");
 
@@ -0,0 +1,348 @@
+#define TEST_NAME "aead_aegis256x"
+#include "cmptest.h"
+
+typedef struct test_vector {
+    const char *key_hex;
+    const char *nonce_hex;
+    const char *message_hex;
+    const char *ad_hex;
+    const char *ciphertext_hex;
+    const char *mac_hex;
+} test_vector;
+
+static const test_vector tests_x2[] = {
+    {
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f",
+        "",
+        "",
+        "",
+        "9aec904886f48b2c73ac77e50fcb8fd0",
+    },
+    {
+        "f7f6be2e86a5a534cd7214327e64abfc4607151e65e9af40cbac85bf6cbbe7cb",
+        "0c6c99166f71712f80179d4bcdf879d6b731231a809f8b98ea54d56b9e404d88",
+        "ff",
+        "",
+        "83",
+        "c3d9447088ae49f5547474a1e7c17fe2",
+    },
+    {
+        "0e2d54333f8de54a1e6fb370761ebb10434a5f3cc25894bef4cac0b483467115",
+        "c882acbaf9c8e98f31c3006b649030727e70239ddfa82776094fa22c4804745e",
+        "1b965275bcbab6d04783bad31530e0be",
+        "848749163237bf98",
+        "4d5214edb4ada245cda60101d9a8e63e",
+        "f9f15bde86ec12115228a8efbeb6f00a",
+    },
+    {
+        "1264e548866a85583ab2db1b5a1d002047a5c5385b7835957a1c308e7c30d6de",
+        "058ee88cd6a30be251a42ab6a2833a910fac8038c57200e965c22678636d8dac",
+        "a1857ddf2ae1268055f2e502135aa1301a0ae81453463ad8586237a9b79a36",
+        "2a7326d49e523811bf78daf2d9",
+        "0ad0528fe3c412a2eddb39c4a6f94e197fdd35f57ae6296b552daa33e735fd",
+        "4976f34c32265f3408f1eaebac8276f8",
+    },
+    {
+        "037d8709b2396621aaaa7724a8434b3847b429f91cb45ee64c04007257809983",
+        "e6f0763e4643fdc7b22f86f780db4d2c522f33afb8a929805c9f5c32cfea5952",
+        "8600614a27e785f2704caceebe07bece661168f4d6ea5a4e9bd99afac4a64c2572bb509fc82d1c73d7118af03f7f8863f14191cafd1a922efc82005e8bf5829b",
+        "6ab60e7553368661b8b1ee877eefaac9da5b5d44bc749f1edb45644a5515ae9a",
+        "46811d051b3acbe08487fcaa98b0a6e7c6f85d432f14c4d64785acf839f3edcdfd9002f886eaeae2903e53fec04014f4c5f5a17a7c31fb28f1b96a85a985ece4",
+        "f62fd1f2c3325ddd53d41aa8481cc6d5",
+    },
+    {
+        "198e6cd0da8f5e03b415378d6a7cc5a0897b1cdcc1d310df80e26a4c31acb56f",
+        "bffb3b38230f1fc0689f076aaf70c9d452acbbdedf040690eade0e13b6e1a7e8",
+        "f047c5b2d860f520890d2b492a255b5672b6c34717be2ae0dea11c1e6e38eb65457b88cdf6077066ecaad290212a84a3609d714429c119aa7300d4d06c5b0ff93c5e01e75ab4204b68ccd9e83a004b51a05e3d4be132ee87aa1815b5933f7d00440ceb0c84bf0edd4311521ad85ba3fc5ca0a58cd50465063df471ca97a4f202",
+        "38af16bf66cb8ea931c5567a5649ed791f1c726c3de1e4ac1c6e97e9fcd4999bae3e4898be0e22a451be46165dadde57175cac0fc5abc4b1439d1a6ae2fe7e07",
+        "c35b18254a64e5ab8c11be62d798c1d0e223468d80c49216b17636f61e14d4b4c21a6a9ce3915ce84e4a00c0537a2f2cf21a4f0da688bb37b723d20ac5e7b0e254c59442a35597c0e39aa5dc5ba22fd5a05391d4dc8d7ac647ba0a67d85426c98b49d3afc7989c49eb948b9f54580817793b448d4db822956736712bd87b8ec0",
+        "dc44f61699ca49bf923fbbf46639926f",
+    },
+    {
+        "885c8b1f248631726b0f00d360cba77e935a8ef866b81046819fd221fb4c238d",
+        "92f8a344f52ddc550564056a189ef585324c5665c611cebbfa5342763d4c9536",
+        "3addd5d9b01c738c19ba9fae31b2abf1e11ef091ec9b120075dc554f99db763e3fe504060b4fc55cf984ea01d9e3d61583ed183b48623433fe56d2f5e034b241436520168122879afff6f9fdd7ec46a4df34310e2d5f2d33cd6c085b41c7d0cb582c83c335387fb641faa17bb5c80b8123e66fb7547a6652a601e080a0a272d7515eb104208117f4e6",
+        "16e8eb9de5421b",
+        "5f5c0e309a4dcf24326b8d28583b497ef56582d5c4d6e26755e1ed75ff1107df6245a58e4c5d50a8ad290c2794ffe6b6f0a77003867083097f991f373d6eb0b3da1432c44703750d0d5cbc49b0d84e7aa6ad23bf8f28c75e0dfacef7aee20cc5e3397e39b2d959e8c9b45120e9b3252a991dc042b07523e23da39a40277c16735a8af3ec173352cc0a",
+        "d57b30672ab74d271d47afe4fa38d0f7",
+    },
+    {
+        "051a4281c489c749a1f510bec271adf734280efdd6be7f483c21dd61439807cb",
+        "ae462544eef14ab63c51b600fb5b882b09dbef085ff290efa683cd197beb8f3e",
+        "c9c9f6197a81f43ce9de4e9193f20f6cfe65702167c2ee5848d595a93ba05c60bdf52571fa744cd873c08ed200d7da81917ebffbfa16c04e1a4c10ee5fa05921e81985dc99d65d6755c76c5f19f347e938ab91367f046cdcf111b045599f5fbb837a070b370fcc80b8f18da684fa4328b241d4e0ac1b4fec35f5dffd99dbcc43143f7120ed032f0dc9b4822655e1efb50569d5eb5640ee1ae95d3d6bc53d1efc8eade2f5058b9460184d7b5e937361084a4d273320b7832eb43740b90baf501db00298b8b02889bd73d43d130495b8f2c90911ac0868882e0fc14ea5b8f24b1d6282675476c09afc7f9a83945d54fe786c64755d2ae276f4c0ba572d9c42bf",
+        "edcc4a1e1adfcc420b008124d8ce1a54395c9522eeefca393f940d8fe34e934b0b5adb646d1b8d39b4cd4de2ed050c1ecb4156272a21a210512fd8806058aaec2c",
+        "5cdf285de175561e43fcce949e504569e4a7fc20b790c1fe06d1d0ec9b3f037d9d97e35f7cf91a24751ea52b52c520a25c47368994e92534df48c5efa4705aa12066104566d7cb818455f526df72800d594015d40564853f6a81f70fbee4ceef6b39c7ab62bf66a598435a4cde82b2ed3314909cb717c349b683f9c12d9521541338496bcf44ab6502cbe50816b164d8c4032ce1e20aab862c8ceaeb02b27415444ab7c6ff3b4bd549572ad0df2e3171255260a4f58a296422719f2fa246f46bd216bdfd12935f9af371fc4fd1e46f1a52db25f5b89d003331d1917d179e96519feb74aee6bd90d496f346094da902ca247c803c7fbfb6a00fa52266b9c331",
+        "5ccc72a75a22c9c23c6a5f4e84b39336",
+    },
+    {
+        "d528be34d634aa553a117e28409233379e64d5d854d7398c5509668097e8f91d",
+        "9cbc924ffaedab3b49326e1fccfbfbba0805fbe8eeb64637159bdbc7d21f749b",
+        "2e0f6e31ec7ef4448b8c5a3615ac098195746a7db4e5089f3434d668790fd9167b01ea837f25607ce4d5e1fd6c4fca944204c4d14959fb758e686f44cb39b250e224517c8390545cb89b2bbb6a5a767c9b564fc84f52aff05d2ceb1065e31994c0473e52f20546b7f10929967422051ed0821768aa5f61f2bcd6e886635b1fb51c3cdbf5d712a76dbb853e604eab26ef042c426e2ebd442ef1e49a551790410c484d849183c7bf850659139ca225cf67ee758909c74b8c05500540bf2fcbd26ed37acca6ac42828e42393d6e2254c3306337f97abe2c711d061858bc7ff4e4a13d0b9328b3c81eb44351c60d3bc575865ce6b2582fef825304dfb8dc2e01ce396893bb853635225eddb47960e2327ccf1f9557c51eaa87b2cabe688595f7dbbf11aa82d6569a398ed330f18af2a28c0738dc8d92acc5cb750a533b8e34ffafcebf82af451fcb7ff57cc552f475fe8552d3bf185da4ea44a59bacf32a65d5d606c245bac6b40e50d91b7ce78c605d52b03a2c77ed0317cb18b771848ac364bccbd466020a1cd8279eaacb0c1b028eb654b2809cec15f500d8693d9bcd473a7af4e4ca5eb81aa64ba9cbcc5a560ef6a9e726d7a75e542943c00c98fbb35594393834873e0f63e968d015efedefef8bc674501564085bf93f2552aa4ee5874a4e08515adfb570e05f318b97d37c824c770e0ade18b59176c4f37944660c0faeb6752c",
+        "0ae71c",
+        "7167d476f85f289237cc69f8e194292203aad67c7a9de22bc5fa46cc6d0fbee65ce1b9c54b36cfb90f27703aa3eec7c18b78a963fd2eb0f9f10a57075d57ddaf1c80536cd75907f1f2428ae6527f2653e1a96caf28b870ae596061a2e0334dedfa4ca0cd2cce0e8cb812e24e15a2f3a9aca2396a2c3cad783af8d46ae5b58afc6897b426cd40c7e2de7d748b21da9941326f39bd5d7370ca220f8ffff39d199764593e71783b6055c2c33d85d2bf8093c7413394550fe2ac6055f60591d4e16ddb3c59aaebd6522912a77303983c18ec2c62d6863b137b369d850edbe9fbc485f0d2b87f03dfc2d3b4577a7de26bfd40800942d535126ae4618827bbc5aed67f404327389d0e137343c9ea0cdf304db17f1dbfe7e1053c8b08876e4e75008adf543ea208d0d8647ae9e37abfffde2f1d2164d7eaa97ea06fb4285380458b01b8537c9eace8450fe6d7c73d477f2155ca7a126945a0f47c276a1eae6c320cb5ba31760eaf8a3f567c67b92a527eab4f13c7b5b43167b6613caa60caa1f660e1faccd4b4d84534b06bdfae2de85efde2ed427c6eb593be4f70d892e31e8f96d9ddedab797087b7421af58b2b114a4b86017816b3b36014f7c8721be7c90a0d5dfc672351d937c280a5b3a2c14fc7999f6f26c8e4402806912d53efb30bb8c7c3975567c1f258cf051c18ba9b0fca0dc46d5616b70f967afe2ef7f85f31920b03cff0",
+        "0e7850327d87dca3b909632e3baaa6f6",
+    },
+};
+
+static const test_vector tests_x4[] = {
+    {
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f",
+        "",
+        "",
+        "",
+        "2d14c1a3078250ecebb6a4f9b3e9cac6",
+    },
+    {
+        "4a5c6e849cb3768e8f4e575bfbbbd80e80f8a040de57d9059cffa2af0c554068",
+        "be3dcd00afb271e5f8619090aa7f52decd0ca671336aa2d34e44bb280200816d",
+        "a8",
+        "",
+        "a4",
+        "5ff5c5f50da2c42fe6b14049b373857e",
+    },
+    {
+        "c3e7e4749579428c00a27ec0efae44a26d51ae7012e00b38afa3e30cd2d53b8e",
+        "098cbe715951e03c0028448c25293c4a1b393ee46d0b3876b7a57eee2df20ffe",
+        "41f46b8789a29fe585fcff7256fe8a51",
+        "86cc120fd29bce98",
+        "dfa2fdd032c9ac5e34a4673cc02d2aa9",
+        "44979bf5d3038e543886fd3ff2d18a04",
+    },
+    {
+        "9a2a34e2421b07039acfd1a696b9a58bdff72567e4bce2404dd073a5677e33c3",
+        "b17ef6e4a5f4640805211fc548333b43dfa15a18fe5ffb327c62461d7335f8fe",
+        "d7f00a4bb6baabaa40dbca07508e648131ac387b3e0c2d0ea5600d7b2c3e99",
+        "64af7bf7ab8f9799071bf457fe",
+        "ee14b2d92e383418c68cd6628607d1641e384217243ffabdeb8a2c412e84a8",
+        "dc76834fe82a22028ed132d408e4b387",
+    },
+    {
+        "c71b0d76667489f4974b23813dd0683e48464c3f1f5fe9961ef356bd534919e6",
+        "1557b279073488bc7715f7100153be335644089a2acd3540e12eee1f46f6f7d8",
+        "ad63f671817f47bc218a3663023f4c9f48fe7cc5f87e883c4373037bbd95fe4fc19e364c4a12c89b5ce0a64d606d01ad26bf172bc19e4ac697be1b7c2576dfae",
+        "988d9d772c49ead924e7745b484c67a6fdc2478f1864e709baf9b21b8257fea4",
+        "ef8abb2ac30dba97b48e458470ab65b08799f886257c59056091abfb0813c6955228d0bd4458068ad03bb1de676f975384fa08197145ab54eef710b05d393a0c",
+        "92a1c9a8e98f6917f6abdb29decd30cc",
+    },
+    {
+        "cb9b3e6e4fa4db9585b6534dd8ef7001f2efd4223d775c19dae45b8a5abc12b0",
+        "c09d9f0395e5d1ac7e1cf72bf2a0c88833bfdf0873628f6cdaf57aa6f8604bc0",
+        "6d0cd5ca9c6bfc7a9c20052ae423df740645ce9fd015f3b57c9ddb13c7bfe2a274e1c410521b4d72f7988fba3d9882d63762dccf61da319bd057951b892724c83e92c409da6a99e1f2d2d2d87aed0b64fb34e889932373f56cc8f04e769bf000c4fe902745ecb4448c28870567cbc209e34a1a225ad792af78ef643baba81074",
+        "5f854c5c88212f956697d2e4ec964ed2d733e5b653c986137fac6c52c9bbfc3f0821bc089beaff033b1852b1a3bbd0202356a765ee60f3fbe5e104072d256940",
+        "98ac7c20651f52889cceb112942503c436f6998e4b08ab50390b2c9038cf64d0251b2ef7c7c017f8dfeced5255489f2878c1f224fb7edcd4f15b2f76b4853cdc3182add2cdba8c67aa1c943d8b69a949fc2d82b7a147e17dd212d97a541895bd7e124bd6ced8d428686902241269da509ad61325573d7d12d801625edcacfb8e",
+        "7642cd5126f1f8a2dd00e42754e92f14",
+    },
+    {
+        "e6a0f9e82e2565be0a0af6beca080f18ee165d55730ee8c5735ab4812803edad",
+        "88912acbdf0cd5a135aa9eb342449266c1b57daa100740827b8f03e4bfed709c",
+        "0e97879a3e60f62baa77d9796a824c636c4b6e845e0ee265335b1473d44796a768ff640f9565015bacf508c39b58c0c86e3db4bfd6caa9a10fe2436abedaefee8a5030f1f1b2d2f42e96599b2df10659dae8e2152428dd0f3aa969c6953326281b43d3949b1f9418cb09a066118d2bc34e1af16cf08b1c0022fd799c53bde18d661357395558820667",
+        "a3c17410b5d89e",
+        "8bdf3317125a9e9839f57cf6570e9adcea1be3b96274769cfc711d2c6fc062b4c52ef10e7efa7c80b950e3d312ce5a3ce748f1684b4c2fdccfb3277785def792543451153153b36d7177a309c5384bbd3bf613971eda551ca171064331ce15ab85bcefda53a688f76b023fac542d4b4e8d0ca5c56146a2ca432d97094fb4b50c348992ccbb78266da7",
+        "b1f65a26ec504514c203b0aec8db8460",
+    },
+    {
+        "ae896d7034fa8535c15c21f7966dbe6214aeb503dff0486e24dc7d0ca8cf70ae",
+        "33f8159915d05d447d9ec977091f145b717a7a8df0bce5f880011d2229fd9e29",
+        "a49d6ec514e58b8c0fc5d8b7006b410d899741a16fa2d6ef17eeaa1e7028f9ffe51746faa9c0535ee5d06a1c517375fc37ff8f33528594a34137f95edb14cf63a5df2673336e4bbf89cd1aa1be813359f6c69341f6f3ffd5af85ecd8e43fd098f6c3f6943c556fb92f15ffc2e95a0bd67e9827ae7dec9437b696610609aac2539d370daa15bd5b539fda82f98f892ceaf3eab9977157db9841b49e5f8d24ae86b2e060efb73808c9f7bca4bbaea6dbe373839e630833494db4fb5cf7370bc3166fa3f4a6067234aa62aa29581cbbac7eb9f6259e765ad8e42003e2eef07064d8d2000ee86bd590d025a9f059a1206fc8d9b79932e4ee0018a58e6acd684235",
+        "904332cce7c3ec3f7bafdb1bbeb85a4f4599aac66bb2abea3b5c0b4ed9f374486a5aa86dbab9da64e61c567ed8a0b6991c63671eca3334a898d53b66a576ad1042",
+        "e9ef1dd7c45b827cf00ad9686cd892decafb54f02e909be55576c1a8c490040ebe43447f0d4960fe9139d226713dc24926265ddeaf36da51855c0439facbcee5f27d41e6ef9b73418e863c40f4acfbe3ded0787e94f93456aa591d9472fcb0fe6e4a27fe129b7669923854153b6d9b1b19a64003acec59ccf70de9df62b11f42993de8bfd48d7e35df7d65ec96da0235d5ed5813acd10799d9434a905acbe80a34211a6211751e512575fd842f8b8acb22019bd0e439902283657077c9fb0427e3329e6fcdabb09640483c0d53833a97f41555126edf3fc766dda2594cf25b1e346172ed854f9105085aa94c1b55160a4319864ccd6751f1dc2205b072e949",
+        "3a2572837d28691eeadfa63a6309b2fe",
+    },
+    {
+        "c0462f3a82c134d5efcf0b704252d86c8b45587a1578f4a071b418ec1f0cabec",
+        "8dc5a9f3c5f063b9b02a9a6a74b779fa6ac088ed2d9b53e0be6ec6d965800ecc",
+        "e2f9a4398a255e5b9232e8171788461f196ed97f0a0dd2a20226460830a7dbaad0102d0c670c20e3c34ef2fcfddd250f79fee982c5d488ac34192230d27f7a0e93a250e8833ddb1819d63b83e474dcaac1a7fde7735e9770730f1ef8494983d3f1a25fbb8f4e6ccc98592d5f3ad6cc89b56e56572f37a2e3852b087c4c03101022127944c0730d870bc16bf820f0148f28423f96cdd229313a0be3cd376881305f9952bff7de1e6d8e7118339d9aefb938d8881978882df1b41365706f284bf76f24967b2f816deaa3229ba32c1d81a8fb20e2837e98050617adeac0e0a5d1927f0cf411cf7daee7be910c804254b3257cf13b7cf22157dcfc0ca37660e61bae57448a440daaa36a84f0f02bca5aa37739c8ce11efb6d28d84ab6ad337a8d7de9bb9cda645a936b2c96e3e602b0acf396f9757e49b454c041e74c10a9138bc42fe86cdf13ca47f164dd2ae65040e67800e9a97d12afd7135b4019ef5b4e945de2a2f7ad029a2952ea4ffb9054243dc6ca6649cb256836f247e3a63bb63d95c623743ea0bc495adb9cefc53bed8ae0eed46c742a2c1c3bc22b9362c29f2f925364417ca00ffc561ee00f418668e3b9894c324a50d654e26d39d5ba285859f97ee701480d34c6184365a83901b65c51de223c3017761eb1025e89056bb979d1259cbd3e54962e09b4e3e17946fdf49012da21b7db31c90a078087c52e7c7634d36b3",
+        "4799ff",
+        "cad1329813380580203db7ee90c092e83e65cbd675682bece0ac1ac180a1d029a712788ee410aa96f3b282725536a1f264b86306dfd24579c5d4fd65995e6afd90c861ce3e97912367f91b01130065435121a34dc8c0772c8468c2cce348ac85366f6ebaab2f7771a066ca46c4279b82b64169e4395a3298148a124cbe2386488305e2092a70d857f7db46ada8bffcdc75f51ffc7d34b2a079a9097d8f8572a960d3f2c0a9cdf4c421a3f758a106b0598efa02995e4cedd2b7fa94870c87ab632273d8fd2dbf57818131634757099c31e804ba1460fa6e1d6a0e4fd122dc7ae62184f53afac9581695428f546e4cda82a50bad33a46506e641500cd5815e8d00e0f1c951203c8d228e44116bdab578e7f97543c56bc69811fd0c5eac59a1965b760c8f8fe324460fbf8f95bc7c9139d78b2ad296b2fb44431f005d953bab3d191b860e924dbc5aa474efc0b1cac21e852e4a3f95b80ee30b3d841cbad9b4fc2776d4530e668da2f2d7bbf295a23162f9c0ebf52d1a92f52858f0d91c4ef2a4ce00e359bf0ea51264a3eba9fe911b2de0105d9463e9598750fd9a7dacc26ff9ba6e337ba3ba899b52450cd7c5d744220a45e4d9d7cf64e405582924ee30c16529130b42b90ef334484419ef8d2aba43723b3e5cf8569d6b15d264e7ccd839cdaf1357ce860ffb6a06c7905948130de69b282d1c6e48b5c0077dbde954fec887fc9d",
+        "ef2cea786eabc369a0de3fcbd290dbaf",
+    },
+};
+
+typedef struct variant {
+    const char *name;
+    int (*encrypt)(unsigned char *c, unsigned long long *clen_p, const unsigned char *m,
+                   unsigned long long mlen, const unsigned char *ad, unsigned long long adlen,
+                   const unsigned char *nsec, const unsigned char *npub, const unsigned char *k);
+    int (*decrypt)(unsigned char *m, unsigned long long *mlen_p, unsigned char *nsec,
+                   const unsigned char *c, unsigned long long clen, const unsigned char *ad,
+                   unsigned long long adlen, const unsigned char *npub, const unsigned char *k);
+    int (*encrypt_detached)(unsigned char *c, unsigned char *mac, unsigned long long *maclen_p,
+                            const unsigned char *m, unsigned long long mlen,
+                            const unsigned char *ad, unsigned long long adlen,
+                            const unsigned char *nsec, const unsigned char *npub,
+                            const unsigned char *k);
+    int (*decrypt_detached)(unsigned char *m, unsigned char *nsec, const unsigned char *c,
+                            unsigned long long clen, const unsigned char *mac,
+                            const unsigned char *ad, unsigned long long adlen,
+                            const unsigned char *npub, const unsigned char *k);
+    const test_vector *tests;
+    size_t             tests_count;
+} variant;
+
+static void
+tv(const variant *v)
+{
+    unsigned char      *ad;
+    unsigned char      *ciphertext;
+    unsigned char      *decrypted;
+    unsigned char      *detached_ciphertext;
+    unsigned char      *expected_ciphertext;
+    unsigned char      *key;
+    unsigned char      *message;
+    unsigned char      *mac;
+    unsigned char      *nonce;
+    char               *hex;
+    unsigned long long  found_ciphertext_len;
+    unsigned long long  found_mac_len;
+    unsigned long long  found_message_len;
+    size_t              ad_len;
+    size_t              ciphertext_len;
+    size_t              i = 0U;
+    size_t              message_len;
+
+    key = (unsigned char *) sodium_malloc(crypto_aead_aegis256x2_KEYBYTES);
+    nonce = (unsigned char *) sodium_malloc(crypto_aead_aegis256x2_NPUBBYTES);
+    mac = (unsigned char *) sodium_malloc(crypto_aead_aegis256x2_ABYTES);
+
+    do {
+        const test_vector *t = &v->tests[i];
+
+        assert(strlen(t->key_hex) == 2 * crypto_aead_aegis256x2_KEYBYTES);
+        sodium_hex2bin(key, crypto_aead_aegis256x2_KEYBYTES, t->key_hex,
+                       strlen(t->key_hex), NULL, NULL, NULL);
+        assert(strlen(t->nonce_hex) == 2 * crypto_aead_aegis256x2_NPUBBYTES);
+        sodium_hex2bin(nonce, crypto_aead_aegis256x2_NPUBBYTES, t->nonce_hex,
+                       strlen(t->nonce_hex), NULL, NULL, NULL);
+        message_len = strlen(t->message_hex) / 2;
+        message = (unsigned char *) sodium_malloc(message_len);
+        sodium_hex2bin(message, message_len, t->message_hex, strlen(t->message_hex),
+                       NULL, NULL, NULL);
+        ad_len = strlen(t->ad_hex) / 2;
+        ad = (unsigned char *) sodium_malloc(ad_len);
+        sodium_hex2bin(ad, ad_len, t->ad_hex, strlen(t->ad_hex), NULL, NULL, NULL);
+        ciphertext_len = message_len + crypto_aead_aegis256x2_ABYTES;
+        expected_ciphertext = (unsigned char *) sodium_malloc(ciphertext_len);
+        assert(strlen(t->ciphertext_hex) == 2 * message_len);
+        sodium_hex2bin(expected_ciphertext, message_len, t->ciphertext_hex,
+                       strlen(t->ciphertext_hex), NULL, NULL, NULL);
+        assert(strlen(t->mac_hex) == 2 * crypto_aead_aegis256x2_ABYTES);
+        sodium_hex2bin(expected_ciphertext + message_len, crypto_aead_aegis256x2_ABYTES,
+                       t->mac_hex, strlen(t->mac_hex), NULL, NULL, NULL);
+        ciphertext = (unsigned char *) sodium_malloc(ciphertext_len);
+        detached_ciphertext = (unsigned char *) sodium_malloc(message_len);
+
+        v->encrypt_detached(detached_ciphertext, mac, &found_mac_len, message,
+                            message_len, ad, ad_len, NULL, nonce, key);
+        assert(found_mac_len == crypto_aead_aegis256x2_ABYTES);
+        if (memcmp(detached_ciphertext, expected_ciphertext, message_len) != 0 ||
+            memcmp(mac, expected_ciphertext + message_len, crypto_aead_aegis256x2_ABYTES) != 0) {
+            printf("Detached encryption of %s test vector #%u failed\n", v->name,
+                   (unsigned int) i);
+        }
+
+        v->encrypt(ciphertext, &found_ciphertext_len, message, message_len, ad,
+                   ad_len, NULL, nonce, key);
+        assert((size_t) found_ciphertext_len == ciphertext_len);
+        if (memcmp(ciphertext, expected_ciphertext, ciphertext_len) != 0) {
+            printf("Encryption of %s test vector #%u failed\n", v->name, (unsigned int) i);
+            hex = (char *) sodium_malloc((size_t) found_ciphertext_len * 2 + 1);
+            sodium_bin2hex(hex, (size_t) found_ciphertext_len * 2 + 1, ciphertext, ciphertext_len);
+            printf("Computed: [%s]\n", hex);
+            sodium_free(hex);
+        }
+
+        decrypted = (unsigned char *) sodium_malloc(message_len);
+        found_message_len = 1;
+        if (v->decrypt(decrypted, &found_message_len, NULL, ciphertext,
+                       randombytes_uniform((uint32_t) ciphertext_len), ad, ad_len,
+                       nonce, key) != -1) {
+            printf("Verification of %s test vector #%u after truncation succeeded\n",
+                   v->name, (unsigned int) i);
+        }
+        if (found_message_len != 0) {
+            printf("Message length should have been set to zero after a failure\n");
+        }
+        if (v->decrypt(NULL, NULL, NULL, ciphertext, ciphertext_len,
+                       ad, ad_len, nonce, key) != 0) {
+            printf("Verification of %s test vector #%u's tag failed\n", v->name,
+                   (unsigned int) i);
+        }
+        if (v->decrypt(decrypted, &found_message_len, NULL, ciphertext,
+                       ciphertext_len, ad, ad_len, nonce, key) != 0) {
+            printf("Verification of %s test vector #%u failed\n", v->name, (unsigned int) i);
+        }
+        assert((size_t) found_message_len == message_len);
+        if (memcmp(decrypted, message, message_len) != 0) {
+            printf("Incorrect decryption of %s test vector #%u\n", v->name, (unsigned int) i);
+        }
+        memset(decrypted, 0xd0, message_len);
+        if (v->decrypt_detached(decrypted, NULL, detached_ciphertext, message_len,
+                                mac, ad, ad_len, nonce, key) != 0) {
+            printf("Detached verification of %s test vector #%u failed\n", v->name,
+                   (unsigned int) i);
+        }
+        if (memcmp(decrypted, message, message_len) != 0) {
+            printf("Incorrect decryption of %s test vector #%u\n", v->name, (unsigned int) i);
+        }
+        if (message_len > 0U) {
+            ciphertext[randombytes_uniform((uint32_t) message_len)] ^= 0x01;
+            if (v->decrypt(decrypted, NULL, NULL, ciphertext, ciphertext_len,
+                           ad, ad_len, nonce, key) != -1) {
+                printf("Forgery of %s test vector #%u succeeded\n", v->name,
+                       (unsigned int) i);
+            }
+        }
+
+        sodium_free(message);
+        sodium_free(ad);
+        sodium_free(expected_ciphertext);
+        sodium_free(ciphertext);
+        sodium_free(decrypted);
+        sodium_free(detached_ciphertext);
+    } while (++i < v->tests_count);
+
+    sodium_free(key);
+    sodium_free(mac);
+    sodium_free(nonce);
+}
+
+int
+main(void)
+{
+    static const variant x2 = {
+        "aegis256x2",
+        crypto_aead_aegis256x2_encrypt, crypto_aead_aegis256x2_decrypt,
+        crypto_aead_aegis256x2_encrypt_detached, crypto_aead_aegis256x2_decrypt_detached,
+        tests_x2, (sizeof tests_x2) / (sizeof tests_x2[0])
+    };
+    static const variant x4 = {
+        "aegis256x4",
+        crypto_aead_aegis256x4_encrypt, crypto_aead_aegis256x4_decrypt,
+        crypto_aead_aegis256x4_encrypt_detached, crypto_aead_aegis256x4_decrypt_detached,
+        tests_x4, (sizeof tests_x4) / (sizeof tests_x4[0])
+    };
+
+    if (crypto_aead_aegis256x2_is_available()) {
+        tv(&x2);
+    }
+    if (crypto_aead_aegis256x4_is_available()) {
+        tv(&x4);
+    }
+    assert(crypto_aead_aegis256x2_keybytes() == crypto_aead_aegis256x2_KEYBYTES);
+    assert(crypto_aead_aegis256x2_nsecbytes() == crypto_aead_aegis256x2_NSECBYTES);
+    assert(crypto_aead_aegis256x2_npubbytes() == crypto_aead_aegis256x2_NPUBBYTES);
+    assert(crypto_aead_aegis256x2_abytes() == crypto_aead_aegis256x2_ABYTES);
+    assert(crypto_aead_aegis256x2_messagebytes_max() == crypto_aead_aegis256x2_MESSAGEBYTES_MAX);
+    assert(crypto_aead_aegis256x4_keybytes() == crypto_aead_aegis256x4_KEYBYTES);
+    assert(crypto_aead_aegis256x4_nsecbytes() == crypto_aead_aegis256x4_NSECBYTES);
+    assert(crypto_aead_aegis256x4_npubbytes() == crypto_aead_aegis256x4_NPUBBYTES);
+    assert(crypto_aead_aegis256x4_abytes() == crypto_aead_aegis256x4_ABYTES);
+    assert(crypto_aead_aegis256x4_messagebytes_max() == crypto_aead_aegis256x4_MESSAGEBYTES_MAX);
+    assert(crypto_aead_aegis256x2_KEYBYTES == crypto_aead_aegis256x4_KEYBYTES);
+    assert(crypto_aead_aegis256x2_NPUBBYTES == crypto_aead_aegis256x4_NPUBBYTES);
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#define TEST_NAME "aead_aegis_mac"
+#include "cmptest.h"
+
+static void
+tv_aegis128l_mac(void)
+{
+    crypto_aead_aegis128l_state st;
+    unsigned char              data[1000];
+    unsigned char              k[crypto_aead_aegis128l_KEYBYTES];
+    unsigned char              npub[crypto_aead_aegis128l_NPUBBYTES];
+    unsigned char              mac[crypto_aead_aegis128l_MACBYTES_MAX];
+    unsigned char              mac2[crypto_aead_aegis128l_MACBYTES_MAX];
+    char                       hex[2 * crypto_aead_aegis128l_MACBYTES_MAX + 1];
+    size_t                     i;
+    size_t                     j;
+    size_t                     len;
+
+    for (i = 0; i < sizeof data; i++) {
+        data[i] = (unsigned char) i;
+    }
+    sodium_hex2bin(k, sizeof k, "10010000000000000000000000000000", 2 * sizeof k, NULL, NULL, NULL);
+    sodium_hex2bin(npub, sizeof npub, "10000200000000000000000000000000", 2 * sizeof npub, NULL, NULL, NULL);
+
+    assert(crypto_aead_aegis128l_mac(mac, 16U, data, 35U, npub, k) == 0);
+    sodium_bin2hex(hex, sizeof hex, mac, 16U);
+    printf("%s\n", hex);
+    assert(crypto_aead_aegis128l_mac(mac, 32U, data, 35U, npub, k) == 0);
+    sodium_bin2hex(hex, sizeof hex, mac, 32U);
+    printf("%s\n", hex);
+    assert(crypto_aead_aegis128l_mac(mac, crypto_aead_aegis128l_MACBYTES, data, sizeof data, NULL, k) == 0);
+    sodium_bin2hex(hex, sizeof hex, mac, crypto_aead_aegis128l_MACBYTES);
+    printf("%s\n", hex);
+
+    for (i = 0; i < 100; i++) {
+        assert(crypto_aead_aegis128l_mac_init(&st, npub, k) == 0);
+        for (j = 0; j < sizeof data; j += len) {
+            len = (size_t) randombytes_uniform(100);
+            if (len > sizeof data - j) {
+                len = sizeof data - j;
+            }
+            assert(crypto_aead_aegis128l_mac_update(&st, data + j, len) == 0);
+        }
+        assert(crypto_aead_aegis128l_mac_final(&st, mac2, crypto_aead_aegis128l_MACBYTES) == 0);
+        assert(crypto_aead_aegis128l_mac(mac, crypto_aead_aegis128l_MACBYTES, data, sizeof data, npub, k) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aegis128l_MACBYTES) == 0);
+    }
+
+    assert(crypto_aead_aegis128l_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis128l_mac_update(&st, data, sizeof data) == 0);
+    assert(crypto_aead_aegis128l_mac_final_verify(&st, mac, crypto_aead_aegis128l_MACBYTES) == 0);
+    mac[randombytes_uniform(crypto_aead_aegis128l_MACBYTES)] ^= 0x01;
+    assert(crypto_aead_aegis128l_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis128l_mac_update(&st, data, sizeof data) == 0);
+    assert(crypto_aead_aegis128l_mac_final_verify(&st, mac, crypto_aead_aegis128l_MACBYTES) == -1);
+
+    assert(crypto_aead_aegis128l_mac(mac, 16U, data, 35U, npub, k) == 0);
+    assert(crypto_aead_aegis128l_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis128l_mac_update(&st, data, 35U) == 0);
+    assert(crypto_aead_aegis128l_mac_final_verify(&st, mac, 16U) == 0);
+
+    assert(crypto_aead_aegis128l_mac(mac, 20U, data, 35U, npub, k) == -1);
+    assert(crypto_aead_aegis128l_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis128l_mac_final(&st, mac, 0U) == -1);
+}
+
+static void
+tv_aegis256_mac(void)
+{
+    crypto_aead_aegis256_state st;
+    unsigned char             data[1000];
+    unsigned char             k[crypto_aead_aegis256_KEYBYTES];
+    unsigned char             npub[crypto_aead_aegis256_NPUBBYTES];
+    unsigned char             mac[crypto_aead_aegis256_MACBYTES_MAX];
+    unsigned char             mac2[crypto_aead_aegis256_MACBYTES_MAX];
+    char                      hex[2 * crypto_aead_aegis256_MACBYTES_MAX + 1];
+    size_t                    i;
+    size_t                    j;
+    size_t                    len;
+
+    for (i = 0; i < sizeof data; i++) {
+        data[i] = (unsigned char) i;
+    }
+    sodium_hex2bin(k, sizeof k, "1001000000000000000000000000000000000000000000000000000000000000", 2 * sizeof k, NULL, NULL, NULL);
+    sodium_hex2bin(npub, sizeof npub, "1000020000000000000000000000000000000000000000000000000000000000", 2 * sizeof npub, NULL, NULL, NULL);
+
+    assert(crypto_aead_aegis256_mac(mac, 16U, data, 35U, npub, k) == 0);
+    sodium_bin2hex(hex, sizeof hex, mac, 16U);
+    printf("%s\n", hex);
+    assert(crypto_aead_aegis256_mac(mac, 32U, data, 35U, npub, k) == 0);
+    sodium_bin2hex(hex, sizeof hex, mac, 32U);
+    printf("%s\n", hex);
+    assert(crypto_aead_aegis256_mac(mac, crypto_aead_aegis256_MACBYTES, data, sizeof data, NULL, k) == 0);
+    sodium_bin2hex(hex, sizeof hex, mac, crypto_aead_aegis256_MACBYTES);
+    printf("%s\n", hex);
+
+    for (i = 0; i < 100; i++) {
+        assert(crypto_aead_aegis256_mac_init(&st, npub, k) == 0);
+        for (j = 0; j < sizeof data; j += len) {
+            len = (size_t) randombytes_uniform(100);
+            if (len > sizeof data - j) {
+                len = sizeof data - j;
+            }
+            assert(crypto_aead_aegis256_mac_update(&st, data + j, len) == 0);
+        }
+        assert(crypto_aead_aegis256_mac_final(&st, mac2, crypto_aead_aegis256_MACBYTES) == 0);
+        assert(crypto_aead_aegis256_mac(mac, crypto_aead_aegis256_MACBYTES, data, sizeof data, npub, k) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aegis256_MACBYTES) == 0);
+    }
+
+    assert(crypto_aead_aegis256_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis256_mac_update(&st, data, sizeof data) == 0);
+    assert(crypto_aead_aegis256_mac_final_verify(&st, mac, crypto_aead_aegis256_MACBYTES) == 0);
+    mac[randombytes_uniform(crypto_aead_aegis256_MACBYTES)] ^= 0x01;
+    assert(crypto_aead_aegis256_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis256_mac_update(&st, data, sizeof data) == 0);
+    assert(crypto_aead_aegis256_mac_final_verify(&st, mac, crypto_aead_aegis256_MACBYTES) == -1);
+
+    assert(crypto_aead_aegis256_mac(mac, 16U, data, 35U, npub, k) == 0);
+    assert(crypto_aead_aegis256_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis256_mac_update(&st, data, 35U) == 0);
+    assert(crypto_aead_aegis256_mac_final_verify(&st, mac, 16U) == 0);
+
+    assert(crypto_aead_aegis256_mac(mac, 20U, data, 35U, npub, k) == -1);
+    assert(crypto_aead_aegis256_mac_init(&st, npub, k) == 0);
+    assert(crypto_aead_aegis256_mac_final(&st, mac, 0U) == -1);
+}
+
+int
+main(void)
+{
+    if (crypto_aead_aegis128l_is_available()) {
+        tv_aegis128l_mac();
+    }
+    if (crypto_aead_aegis256_is_available()) {
+        tv_aegis256_mac();
+    }
+    assert(crypto_aead_aegis128l_macbytes() == crypto_aead_aegis128l_MACBYTES);
+    assert(crypto_aead_aegis128l_macbytes_min() == crypto_aead_aegis128l_MACBYTES_MIN);
+    assert(crypto_aead_aegis128l_macbytes_max() == crypto_aead_aegis128l_MACBYTES_MAX);
+    assert(crypto_aead_aegis256_macbytes() == crypto_aead_aegis256_MACBYTES);
+    assert(crypto_aead_aegis256_macbytes_min() == crypto_aead_aegis256_MACBYTES_MIN);
+    assert(crypto_aead_aegis256_macbytes_max() == crypto_aead_aegis256_MACBYTES_MAX);
+    printf("OK\n");
+
+    return 0;
+}
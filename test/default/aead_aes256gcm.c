@@ -3225,17 +3225,319 @@ tv(void)
     return 0;
 }
 
+static size_t
+split_iov(crypto_aead_iovec *iov, size_t max_count, unsigned char *buf, size_t len)
+{
+    size_t count = 0U;
+    size_t chunk;
+
+    while (len > 0U && count < max_count - 1U) {
+        chunk = (size_t) randombytes_uniform(300U);
+        if (chunk > len) {
+            chunk = len;
+        }
+        iov[count].ptr = buf;
+        iov[count].len = chunk;
+        buf += chunk;
+        len -= chunk;
+        count++;
+    }
+    iov[count].ptr = buf;
+    iov[count].len = len;
+
+    return count + 1U;
+}
+
+static void
+tv_iov(void)
+{
+    crypto_aead_iovec   m_iov[64];
+    crypto_aead_iovec   c_iov[64];
+    crypto_aead_iovec   ad_iov[64];
+    unsigned char      *key = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_KEYBYTES);
+    unsigned char      *nonce = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_NPUBBYTES);
+    unsigned char      *mac = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_ABYTES);
+    unsigned char      *mac2 = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_ABYTES);
+    unsigned char      *m;
+    unsigned char      *m2;
+    unsigned char      *c;
+    unsigned char      *c2;
+    unsigned char      *ad;
+    unsigned long long  maclen;
+    size_t              mlen;
+    size_t              adlen;
+    size_t              m_count;
+    size_t              c_count;
+    size_t              ad_count;
+    int                 i;
+
+    crypto_aead_aes256gcm_keygen(key);
+    randombytes_buf(nonce, crypto_aead_aes256gcm_NPUBBYTES);
+    for (i = 0; i < 100; i++) {
+        mlen = (size_t) randombytes_uniform(3000U);
+        adlen = (size_t) randombytes_uniform(200U);
+        m = (unsigned char *) sodium_malloc(mlen + 1U);
+        m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        c = (unsigned char *) sodium_malloc(mlen + 1U);
+        c2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        ad = (unsigned char *) sodium_malloc(adlen + 1U);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_aes256gcm_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen, NULL, nonce, key);
+
+        m_count = split_iov(m_iov, 64U, m, mlen);
+        c_count = split_iov(c_iov, 64U, c2, mlen);
+        ad_count = split_iov(ad_iov, 64U, ad, adlen);
+        assert(crypto_aead_aes256gcm_encrypt_detached_iov(c_iov, c_count, mac2, &maclen,
+               m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(maclen == crypto_aead_aes256gcm_ABYTES);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aes256gcm_ABYTES) == 0);
+
+        assert(crypto_aead_aes256gcm_decrypt_detached_iov(NULL, 0U, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        m_count = split_iov(m_iov, 64U, m2, mlen);
+        assert(crypto_aead_aes256gcm_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+
+        c_count = split_iov(c_iov, 64U, m2, mlen);
+        assert(crypto_aead_aes256gcm_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+               c_iov, c_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(memcmp(c, m2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aes256gcm_ABYTES) == 0);
+
+        mac2[0] ^= 1;
+        assert(crypto_aead_aes256gcm_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac2,
+               ad_iov, ad_count, nonce, key) == -1);
+        assert(mlen == 0U || sodium_is_zero(m2, mlen));
+
+        if (mlen > 0U) {
+            c_iov[c_count - 1U].len++;
+            assert(crypto_aead_aes256gcm_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+                   m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == -1);
+        }
+        sodium_free(m);
+        sodium_free(m2);
+        sodium_free(c);
+        sodium_free(c2);
+        sodium_free(ad);
+    }
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(mac);
+    sodium_free(mac2);
+}
+
+static void
+tv_stream(void)
+{
+    crypto_aead_aes256gcm_stream_state  st;
+    crypto_aead_aes256gcm_state        *ctx =
+        (crypto_aead_aes256gcm_state *) sodium_malloc(crypto_aead_aes256gcm_statebytes());
+    unsigned char                      *key = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_KEYBYTES);
+    unsigned char                      *nonce = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_NPUBBYTES);
+    unsigned char                      *mac = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_ABYTES);
+    unsigned char                      *mac2 = (unsigned char *) sodium_malloc(crypto_aead_aes256gcm_ABYTES);
+    unsigned char                      *m;
+    unsigned char                      *m2;
+    unsigned char                      *c;
+    unsigned char                      *c2;
+    unsigned char                      *ad;
+    size_t                              mlen;
+    size_t                              adlen;
+    size_t                              j;
+    size_t                              chunk;
+    int                                 i;
+
+    crypto_aead_aes256gcm_keygen(key);
+    crypto_aead_aes256gcm_beforenm(ctx, key);
+    randombytes_buf(nonce, crypto_aead_aes256gcm_NPUBBYTES);
+    for (i = 0; i < 100; i++) {
+        mlen = (size_t) randombytes_uniform(3000U);
+        adlen = (size_t) randombytes_uniform(200U);
+        m = (unsigned char *) sodium_malloc(mlen + 1U);
+        m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        c = (unsigned char *) sodium_malloc(mlen + 1U);
+        c2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        ad = (unsigned char *) sodium_malloc(adlen + 1U);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_aes256gcm_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen, NULL, nonce, key);
+
+        assert(crypto_aead_aes256gcm_init(&st, nonce, ctx) == 0);
+        for (j = 0U; j < adlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(40U);
+            if (chunk > adlen - j) {
+                chunk = adlen - j;
+            }
+            assert(crypto_aead_aes256gcm_update_ad(&st, ad + j, chunk) == 0);
+        }
+        for (j = 0U; j < mlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(300U);
+            if (chunk > mlen - j) {
+                chunk = mlen - j;
+            }
+            assert(crypto_aead_aes256gcm_encrypt_update(&st, c2 + j, m + j, chunk) == 0);
+        }
+        if (mlen > 0U) {
+            assert(crypto_aead_aes256gcm_update_ad(&st, ad, adlen) == -1);
+        }
+        assert(crypto_aead_aes256gcm_encrypt_final(&st, mac2) == 0);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_aes256gcm_ABYTES) == 0);
+
+        assert(crypto_aead_aes256gcm_init(&st, nonce, ctx) == 0);
+        assert(crypto_aead_aes256gcm_update_ad(&st, ad, adlen) == 0);
+        for (j = 0U; j < mlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(300U);
+            if (chunk > mlen - j) {
+                chunk = mlen - j;
+            }
+            assert(crypto_aead_aes256gcm_decrypt_update(&st, m2 + j, c + j, chunk) == 0);
+        }
+        assert(crypto_aead_aes256gcm_decrypt_final(&st, mac) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+
+        mac2[0] ^= 1;
+        assert(crypto_aead_aes256gcm_init(&st, nonce, ctx) == 0);
+        assert(crypto_aead_aes256gcm_update_ad(&st, ad, adlen) == 0);
+        assert(crypto_aead_aes256gcm_decrypt_update(&st, m2, c, mlen) == 0);
+        assert(crypto_aead_aes256gcm_decrypt_final(&st, mac2) == -1);
+
+        sodium_free(m);
+        sodium_free(m2);
+        sodium_free(c);
+        sodium_free(c2);
+        sodium_free(ad);
+    }
+    sodium_free(ctx);
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(mac);
+    sodium_free(mac2);
+}
+
+static void
+tv_commit(void)
+{
+    unsigned char      key[crypto_aead_aes256gcm_KEYBYTES];
+    unsigned char      key2[crypto_aead_aes256gcm_KEYBYTES];
+    unsigned char      nonce[crypto_aead_aes256gcm_NPUBBYTES];
+    unsigned char      ad[20];
+    unsigned char      m[200];
+    unsigned char      m2[200];
+    unsigned char      c[200 + crypto_aead_aes256gcm_ABYTES + crypto_aead_aes256gcm_COMMITBYTES];
+    unsigned char      c2[200 + crypto_aead_aes256gcm_ABYTES];
+    unsigned long long clen;
+    unsigned long long clen2;
+    unsigned long long mlen;
+    unsigned long long m2len;
+    int                i;
+
+    for (i = 0; i < 100; i++) {
+        crypto_aead_aes256gcm_keygen(key);
+        memcpy(key2, key, sizeof key);
+        key2[randombytes_uniform(sizeof key2)] ^= 1;
+        randombytes_buf(nonce, sizeof nonce);
+        randombytes_buf(ad, sizeof ad);
+        mlen = (unsigned long long) randombytes_uniform(sizeof m + 1U);
+        randombytes_buf(m, (size_t) mlen);
+
+        assert(crypto_aead_aes256gcm_encrypt_commit(c, &clen, m, mlen, ad, sizeof ad,
+               NULL, nonce, key) == 0);
+        assert(clen == mlen + crypto_aead_aes256gcm_ABYTES + crypto_aead_aes256gcm_COMMITBYTES);
+        crypto_aead_aes256gcm_encrypt(c2, &clen2, m, mlen, ad, sizeof ad, NULL, nonce, key);
+        assert(memcmp(c, c2, (size_t) clen2) == 0);
+
+        assert(crypto_aead_aes256gcm_decrypt_commit(m2, &m2len, NULL, c, clen, ad, sizeof ad,
+               nonce, key) == 0);
+        assert(m2len == mlen);
+        assert(memcmp(m, m2, (size_t) mlen) == 0);
+        assert(crypto_aead_aes256gcm_decrypt_commit(m2, &m2len, NULL, c, clen, ad, sizeof ad,
+               nonce, key2) == -1);
+        assert(m2len == 0U);
+        c[clen - 1U - randombytes_uniform(crypto_aead_aes256gcm_COMMITBYTES)] ^= 0x80;
+        assert(crypto_aead_aes256gcm_decrypt_commit(m2, NULL, NULL, c, clen, ad, sizeof ad,
+               nonce, key) == -1);
+    }
+    assert(crypto_aead_aes256gcm_decrypt_commit(m2, &m2len, NULL, c, crypto_aead_aes256gcm_ABYTES + crypto_aead_aes256gcm_COMMITBYTES - 1U,
+           NULL, 0U, nonce, key) == -1);
+    assert(crypto_aead_aes256gcm_commitbytes() == crypto_aead_aes256gcm_COMMITBYTES);
+}
+
+static void
+tv_compact(void)
+{
+    crypto_aead_aes256gcm_compact_key *ck;
+    crypto_aead_aes256gcm_state        ctx, ctx2;
+    unsigned char                      keys[7 * crypto_aead_aes256gcm_KEYBYTES];
+    unsigned char                      nonce[crypto_aead_aes256gcm_NPUBBYTES];
+    unsigned char                      mac[crypto_aead_aes256gcm_ABYTES];
+    unsigned char                      mac2[crypto_aead_aes256gcm_ABYTES];
+    unsigned char                      ad[100];
+    unsigned char                      m[600];
+    unsigned char                      m2[600];
+    unsigned char                      c[600];
+    unsigned char                      c2[600];
+    size_t                             mlen;
+    size_t                             adlen;
+    int                                i;
+
+    ck = (crypto_aead_aes256gcm_compact_key *)
+        sodium_malloc(7 * crypto_aead_aes256gcm_compact_keybytes());
+    randombytes_buf(keys, sizeof keys);
+    assert(crypto_aead_aes256gcm_compact_beforenm(ck, keys, 7U) == 0);
+    assert(((uintptr_t) &ck[1] & 63U) == 0U);
+    for (i = 0; i < 200; i++) {
+        const unsigned char *key = keys + (i % 7) * crypto_aead_aes256gcm_KEYBYTES;
+
+        mlen  = (size_t) randombytes_uniform(i < 100 ? 80U : sizeof m + 1U);
+        adlen = (size_t) randombytes_uniform(i < 100 ? 80U : sizeof ad + 1U);
+        randombytes_buf(nonce, sizeof nonce);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_aes256gcm_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen, NULL, nonce, key);
+        assert(crypto_aead_aes256gcm_encrypt_detached_compact(c2, mac2, NULL, m, mlen, ad, adlen,
+               NULL, nonce, &ck[i % 7]) == 0);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, sizeof mac) == 0);
+        assert(crypto_aead_aes256gcm_decrypt_detached_compact(m2, NULL, c, mlen, mac, ad, adlen,
+               nonce, &ck[i % 7]) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+        mac[0] ^= 1;
+        assert(crypto_aead_aes256gcm_decrypt_detached_compact(m2, NULL, c, mlen, mac, ad, adlen,
+               nonce, &ck[i % 7]) == -1);
+    }
+    crypto_aead_aes256gcm_beforenm(&ctx, keys + 3 * crypto_aead_aes256gcm_KEYBYTES);
+    assert(crypto_aead_aes256gcm_compact_expand(&ctx2, &ck[3]) == 0);
+    crypto_aead_aes256gcm_encrypt_detached_afternm(c, mac, NULL, m, sizeof m, ad, sizeof ad,
+                                                   NULL, nonce, &ctx);
+    crypto_aead_aes256gcm_encrypt_detached_afternm(c2, mac2, NULL, m, sizeof m, ad, sizeof ad,
+                                                   NULL, nonce, &ctx2);
+    assert(memcmp(c, c2, sizeof c) == 0);
+    assert(memcmp(mac, mac2, sizeof mac) == 0);
+    assert(crypto_aead_aes256gcm_compact_beforenm(ck, keys, 0U) == 0);
+    sodium_free(ck);
+}
+
 int
 main(void)
 {
     if (crypto_aead_aes256gcm_is_available()) {
         tv();
+        tv_iov();
+        tv_stream();
+        tv_commit();
+        tv_compact();
     }
     assert(crypto_aead_aes256gcm_keybytes() == crypto_aead_aes256gcm_KEYBYTES);
     assert(crypto_aead_aes256gcm_nsecbytes() == crypto_aead_aes256gcm_NSECBYTES);
     assert(crypto_aead_aes256gcm_npubbytes() == crypto_aead_aes256gcm_NPUBBYTES);
     assert(crypto_aead_aes256gcm_abytes() == crypto_aead_aes256gcm_ABYTES);
     assert(crypto_aead_aes256gcm_statebytes() >= sizeof(crypto_aead_aes256gcm_state));
+    assert(crypto_aead_aes256gcm_stream_statebytes() == sizeof(crypto_aead_aes256gcm_stream_state));
+    assert(crypto_aead_aes256gcm_compact_keybytes() == sizeof(crypto_aead_aes256gcm_compact_key));
     assert(crypto_aead_aes256gcm_messagebytes_max() == crypto_aead_aes256gcm_MESSAGEBYTES_MAX);
     printf("OK\n");
 
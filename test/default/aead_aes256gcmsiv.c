@@ -0,0 +1,245 @@
+
+#define TEST_NAME "aead_aes256gcmsiv"
+#include "cmptest.h"
+
+/* RFC 8452 (appendix C.2), followed by longer messages */
+static struct {
+    const char *key_hex;
+    const char *nonce_hex;
+    const char *message_hex;
+    const char *ad_hex;
+    const char *ciphertext_hex;
+    const char *mac_hex;
+} tests[] = {
+    {
+        "0100000000000000000000000000000000000000000000000000000000000000",
+        "030000000000000000000000",
+        "",
+        "",
+        "",
+        "07f5f4169bbf55a8400cd47ea6fd400f",
+    },
+    {
+        "0100000000000000000000000000000000000000000000000000000000000000",
+        "030000000000000000000000",
+        "0100000000000000",
+        "",
+        "c2ef328e5c71c83b",
+        "843122130f7364b761e0b97427e3df28",
+    },
+    {
+        "0100000000000000000000000000000000000000000000000000000000000000",
+        "030000000000000000000000",
+        "0200000000000000",
+        "01",
+        "1de22967237a8132",
+        "91213f267e3b452f02d01ae33e4ec854",
+    },
+    {
+        "e68b85fdbb9b949eff28491ba7f7830b097182c433fa06791aabc1d876d48439",
+        "8dd8fe8192e74bff2d963f9c",
+        "dc944fb2b7bb554b9d7e0dc9089e84e27e",
+        "",
+        "c82be78ead89b6b76a9435c2bfa476949d",
+        "c8c7737f0cd42cf0ee810adef9e7545c",
+    },
+    {
+        "26c0269396b206b937efc0828f31c0104631e3e8360b1f20d55b690a93cf18ff",
+        "a09b8a65a29b77c75aaacacb",
+        "c5fac87584ef4e82d8fd215a2656054a3173e83902a80d74800a40f4135fc9f0565368b18a8f08bb"
+        "bf30d660ea5c30a0ce215a82b5527b0f6d7d7448cfb1bb35",
+        "ff3fb4853e54131083667bea43",
+        "6314ccecbc838b46188d61fadf966b84d1d17de0964912f43f6c2fb76c8a4a3ec6d0f65ca11eac45"
+        "a03fd1377b97920409a13e48cdc947a5d01643aee8de625e",
+        "2583a358385ede1513aeeffb0e8856e1",
+    },
+    {
+        "7e457984c7f9f2e98407a5d78664bdb1f00080ff92b9e4a19b52741de92c1f98",
+        "bae7b3bcbdea4a05938ddbbd",
+        "cb14de78068dddd066e4c04c44d07701117384bd5f6c0ceb149c7bdf4bdf67d14ae5048f69067bef"
+        "f4856779c981eebf3eb56a7e2140eca6ae0ff9364dd206abe637ff80056fda9f8666fa9a2474dc45"
+        "679760f28f6353bc0978ff62faa1629af09d0e5d8e08320f8ba03df019d541264fedf6e12d649f7f"
+        "4d6c1cbba7eaa68cb8",
+        "0f6e7d937fb8b2b53a1e2a43cf1b22baad89285df65f4a77513f613e063c2be57cf0c1a0d5707890"
+        "4cf84d06a5278bced61a24c73be3904f66c3722b5d6104d03f2fe52cec7fd3cb3dae79ffe68d2fed"
+        "981901237202d172ba3939fff5e060614cfc766188f20c3f7e48dea6dcef97d0bc8c50efae5f9c6b"
+        "906a84ca394fdf7346bbcb54dc57759c3c4f609d3f95cc893bcb8b0d36b5ccc19ade7830531dfaa8"
+        "d68b8c63e551d647c9633c928c958e452587ac5f88b811e0da34a89efd509ffaa1dda9c3b3266a89",
+        "ce7c60e11c13ec30caee0b18a6d5b7af48ad02b03c90f5c94988e67e55e849026a9d6cb309352c74"
+        "63bf032d4e8a1d0e517ce47623939039bda3ec649cc02e79c3f6e0d4f4da2028a0d87af353e61fcc"
+        "db721d0dd900cc3237b94ee4fc7b748c8a5041f0b9128d72d282eb47a890c14eee13f336dccfa4ca"
+        "a93afc75742367b31f",
+        "4644e1b8df4b650c4e06a6cd56b48564",
+    },
+    {
+        "7e6c9067ea2028f22e4262d209a81d9edccfd48f0ce26969dea02ea38bac7963",
+        "44777294b842549d95b99499",
+        "a6ee03d98c97fb9848cd49281b2ce22f5538c0d053ea8b1531a971713463adf236f06dd0330e0350"
+        "d10cd3d3ca2626eb1ae8296c2dcbe5a6c7fcb096c0c6644ca5ebcda7373d390736f3ba314385c1f8"
+        "8681e7ca32c3a4230cf8793ad7539fc7112626e9823ab93549755f384feb3ad38ff9b1a7c285dda3"
+        "6ecdf79c2cf74088a18026bda9defa9031370dfd046897165ec1243ae6650db2670f99b0dd99ed74"
+        "e374e93af838e824bf60132d67b527e593ce93be7af2e52a5f040ab85927f1b452a325c909b5520b"
+        "b3ed867297416ccb26ce6cf8c699745853dc223baed2d3d5f5f19a237aac3bb691ba6a9aabd07871"
+        "0b4ff26a6898102bba153a34d7feab7ea37adfb7a27d5da67dba4619be0e87c781630642e428e17a"
+        "f6306ebc0c9d8a011cf05b4312fa222f54db9950",
+        "ca2a2684d80bb8480a76e32499babb0d54",
+        "cd77900894b6ae8b01b9fd6c9d2f57c8141ad404cfff1ef183b9e4426eee4ad0ee9cad6afad621e0"
+        "1a930727f2679b529686553408fe409db7e8066567c95808ab73b5ee06f53ac35f153c283d1f2471"
+        "ccd1af46ebfc17e1d2e5b3e46ed28074e719d80105caed005303c56a53803e0a396a352bdd4926f7"
+        "52fb5c3123060c38af8d331fdf87adb4973ec19fc52a6abbb6d6b46df0f7ecee43c30712b01ea301"
+        "150bae85653dc6cd31c03f3df1150ef5e9eca3e66b53709bc3c93b44f8fd759136f4ee1bb236eb6d"
+        "d144181ffec2b7da0588b6ba4b1cc59d33d24e23d8ec0e93c516796a945ba0baaea37dab56c189af"
+        "5fa3dc7e304e816d4201a6ec69c0938ddfba619ac0b3ea82670d49c54f38d16daef3aaa2a75cb4e8"
+        "88d748db4688197b9c46748d8e908a41587ce3ff",
+        "661ef65a77682453d60f32a212ffcb1d",
+    },
+};
+
+static void
+tv(void)
+{
+    unsigned char  key[crypto_aead_aes256gcmsiv_KEYBYTES];
+    unsigned char  nonce[crypto_aead_aes256gcmsiv_NPUBBYTES];
+    unsigned char  mac[crypto_aead_aes256gcmsiv_ABYTES];
+    unsigned char *ad;
+    unsigned char *ciphertext;
+    unsigned char *decrypted;
+    unsigned char *expected;
+    unsigned char *message;
+    unsigned long long found_len;
+    size_t         ad_len;
+    size_t         i;
+    size_t         message_len;
+
+    for (i = 0U; i < (sizeof tests) / (sizeof tests[0]); i++) {
+        sodium_hex2bin(key, sizeof key, tests[i].key_hex, strlen(tests[i].key_hex),
+                       NULL, NULL, NULL);
+        sodium_hex2bin(nonce, sizeof nonce, tests[i].nonce_hex, strlen(tests[i].nonce_hex),
+                       NULL, NULL, NULL);
+        message_len = strlen(tests[i].message_hex) / 2;
+        ad_len      = strlen(tests[i].ad_hex) / 2;
+        message     = (unsigned char *) sodium_malloc(message_len);
+        ad          = (unsigned char *) sodium_malloc(ad_len);
+        expected    = (unsigned char *) sodium_malloc(message_len + sizeof mac);
+        ciphertext  = (unsigned char *) sodium_malloc(message_len + sizeof mac);
+        decrypted   = (unsigned char *) sodium_malloc(message_len);
+        sodium_hex2bin(message, message_len, tests[i].message_hex,
+                       strlen(tests[i].message_hex), NULL, NULL, NULL);
+        sodium_hex2bin(ad, ad_len, tests[i].ad_hex, strlen(tests[i].ad_hex),
+                       NULL, NULL, NULL);
+        assert(strlen(tests[i].ciphertext_hex) == 2 * message_len);
+        sodium_hex2bin(expected, message_len, tests[i].ciphertext_hex,
+                       strlen(tests[i].ciphertext_hex), NULL, NULL, NULL);
+        sodium_hex2bin(expected + message_len, sizeof mac, tests[i].mac_hex,
+                       strlen(tests[i].mac_hex), NULL, NULL, NULL);
+
+        crypto_aead_aes256gcmsiv_encrypt(ciphertext, &found_len, message, message_len,
+                                         ad, ad_len, NULL, nonce, key);
+        assert(found_len == message_len + sizeof mac);
+        if (memcmp(ciphertext, expected, message_len + sizeof mac) != 0) {
+            printf("Encryption of test vector #%u failed\n", (unsigned int) i);
+        }
+        crypto_aead_aes256gcmsiv_encrypt_detached(ciphertext, mac, &found_len, message,
+                                                  message_len, ad, ad_len, NULL, nonce, key);
+        assert(found_len == sizeof mac);
+        if (memcmp(ciphertext, expected, message_len) != 0 ||
+            memcmp(mac, expected + message_len, sizeof mac) != 0) {
+            printf("Detached encryption of test vector #%u failed\n", (unsigned int) i);
+        }
+        if (crypto_aead_aes256gcmsiv_decrypt(decrypted, &found_len, NULL, expected,
+                                             message_len + sizeof mac, ad, ad_len,
+                                             nonce, key) != 0 ||
+            found_len != message_len || memcmp(decrypted, message, message_len) != 0) {
+            printf("Decryption of test vector #%u failed\n", (unsigned int) i);
+        }
+        expected[randombytes_uniform((uint32_t) (message_len + sizeof mac))] ^= 0x01;
+        found_len = 1;
+        if (crypto_aead_aes256gcmsiv_decrypt(decrypted, &found_len, NULL, expected,
+                                             message_len + sizeof mac, ad, ad_len,
+                                             nonce, key) != -1 || found_len != 0) {
+            printf("Forgery of test vector #%u was accepted\n", (unsigned int) i);
+        }
+        if (message_len > 0 && !sodium_is_zero(decrypted, message_len)) {
+            printf("Unverified plaintext of test vector #%u was released\n",
+                   (unsigned int) i);
+        }
+        if (crypto_aead_aes256gcmsiv_decrypt(decrypted, &found_len, NULL, expected,
+                                             randombytes_uniform((uint32_t) sizeof mac),
+                                             ad, ad_len, nonce, key) != -1) {
+            printf("Truncated test vector #%u was accepted\n", (unsigned int) i);
+        }
+        sodium_free(message);
+        sodium_free(ad);
+        sodium_free(expected);
+        sodium_free(ciphertext);
+        sodium_free(decrypted);
+    }
+}
+
+/* spans several decryption chunks */
+static void
+long_message(void)
+{
+    static const char expected_mac_hex[] = "cabf0243b11b5d479890d85ae221061d";
+    unsigned char     key[crypto_aead_aes256gcmsiv_KEYBYTES];
+    unsigned char     nonce[crypto_aead_aes256gcmsiv_NPUBBYTES];
+    unsigned char     ad[31];
+    unsigned char     expected_mac[crypto_aead_aes256gcmsiv_ABYTES];
+    unsigned char    *buf;
+    unsigned char    *message;
+    size_t            message_len = 5000U;
+    size_t            i;
+
+    for (i = 0U; i < sizeof key; i++) {
+        key[i] = (unsigned char) i;
+    }
+    for (i = 0U; i < sizeof nonce; i++) {
+        nonce[i] = (unsigned char) (100U + i);
+    }
+    for (i = 0U; i < sizeof ad; i++) {
+        ad[i] = (unsigned char) (i * 13U + 1U);
+    }
+    message = (unsigned char *) sodium_malloc(message_len);
+    buf     = (unsigned char *) sodium_malloc(message_len + crypto_aead_aes256gcmsiv_ABYTES);
+    for (i = 0U; i < message_len; i++) {
+        message[i] = (unsigned char) (i * 7U + 3U);
+    }
+    sodium_hex2bin(expected_mac, sizeof expected_mac, expected_mac_hex,
+                   strlen(expected_mac_hex), NULL, NULL, NULL);
+
+    memcpy(buf, message, message_len);
+    crypto_aead_aes256gcmsiv_encrypt(buf, NULL, buf, message_len, ad, sizeof ad, NULL,
+                                     nonce, key);
+    if (memcmp(buf + message_len, expected_mac, sizeof expected_mac) != 0) {
+        printf("Long message tag mismatch\n");
+    }
+    if (crypto_aead_aes256gcmsiv_decrypt(buf, NULL, NULL, buf,
+                                         message_len + crypto_aead_aes256gcmsiv_ABYTES,
+                                         ad, sizeof ad, nonce, key) != 0 ||
+        memcmp(buf, message, message_len) != 0) {
+        printf("In-place decryption of a long message failed\n");
+    }
+    sodium_free(message);
+    sodium_free(buf);
+}
+
+int
+main(void)
+{
+    unsigned char key[crypto_aead_aes256gcmsiv_KEYBYTES];
+
+    if (crypto_aead_aes256gcmsiv_is_available()) {
+        tv();
+        long_message();
+    }
+    crypto_aead_aes256gcmsiv_keygen(key);
+    assert(crypto_aead_aes256gcmsiv_keybytes() == crypto_aead_aes256gcmsiv_KEYBYTES);
+    assert(crypto_aead_aes256gcmsiv_nsecbytes() == crypto_aead_aes256gcmsiv_NSECBYTES);
+    assert(crypto_aead_aes256gcmsiv_npubbytes() == crypto_aead_aes256gcmsiv_NPUBBYTES);
+    assert(crypto_aead_aes256gcmsiv_abytes() == crypto_aead_aes256gcmsiv_ABYTES);
+    assert(crypto_aead_aes256gcmsiv_messagebytes_max() ==
+           crypto_aead_aes256gcmsiv_MESSAGEBYTES_MAX);
+    printf("OK\n");
+
+    return 0;
+}
@@ -362,11 +362,451 @@ tv_ietf(void)
     return 0;
 }
 
+static size_t
+split_iov(crypto_aead_iovec *iov, size_t max_count, unsigned char *buf, size_t len)
+{
+    size_t count = 0U;
+    size_t chunk;
+
+    while (len > 0U && count < max_count - 1U) {
+        chunk = (size_t) randombytes_uniform(300U);
+        if (chunk > len) {
+            chunk = len;
+        }
+        iov[count].ptr = buf;
+        iov[count].len = chunk;
+        buf += chunk;
+        len -= chunk;
+        count++;
+    }
+    iov[count].ptr = buf;
+    iov[count].len = len;
+
+    return count + 1U;
+}
+
+static void
+tv_iov(void)
+{
+    crypto_aead_iovec   m_iov[64];
+    crypto_aead_iovec   c_iov[64];
+    crypto_aead_iovec   ad_iov[64];
+    unsigned char      *key = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_KEYBYTES);
+    unsigned char      *nonce = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_NPUBBYTES);
+    unsigned char      *mac = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ABYTES);
+    unsigned char      *mac2 = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ABYTES);
+    unsigned char      *m;
+    unsigned char      *m2;
+    unsigned char      *c;
+    unsigned char      *c2;
+    unsigned char      *ad;
+    unsigned long long  maclen;
+    size_t              mlen;
+    size_t              adlen;
+    size_t              m_count;
+    size_t              c_count;
+    size_t              ad_count;
+    int                 i;
+
+    crypto_aead_chacha20poly1305_keygen(key);
+    randombytes_buf(nonce, crypto_aead_chacha20poly1305_NPUBBYTES);
+    for (i = 0; i < 100; i++) {
+        mlen = (size_t) randombytes_uniform(3000U);
+        adlen = (size_t) randombytes_uniform(200U);
+        m = (unsigned char *) sodium_malloc(mlen + 1U);
+        m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        c = (unsigned char *) sodium_malloc(mlen + 1U);
+        c2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        ad = (unsigned char *) sodium_malloc(adlen + 1U);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_chacha20poly1305_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen, NULL, nonce, key);
+
+        m_count = split_iov(m_iov, 64U, m, mlen);
+        c_count = split_iov(c_iov, 64U, c2, mlen);
+        ad_count = split_iov(ad_iov, 64U, ad, adlen);
+        assert(crypto_aead_chacha20poly1305_encrypt_detached_iov(c_iov, c_count, mac2, &maclen,
+               m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(maclen == crypto_aead_chacha20poly1305_ABYTES);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_chacha20poly1305_ABYTES) == 0);
+
+        assert(crypto_aead_chacha20poly1305_decrypt_detached_iov(NULL, 0U, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        m_count = split_iov(m_iov, 64U, m2, mlen);
+        assert(crypto_aead_chacha20poly1305_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+
+        c_count = split_iov(c_iov, 64U, m2, mlen);
+        assert(crypto_aead_chacha20poly1305_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+               c_iov, c_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(memcmp(c, m2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_chacha20poly1305_ABYTES) == 0);
+
+        mac2[0] ^= 1;
+        assert(crypto_aead_chacha20poly1305_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac2,
+               ad_iov, ad_count, nonce, key) == -1);
+        assert(mlen == 0U || sodium_is_zero(m2, mlen));
+
+        if (mlen > 0U) {
+            c_iov[c_count - 1U].len++;
+            assert(crypto_aead_chacha20poly1305_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+                   m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == -1);
+        }
+        sodium_free(m);
+        sodium_free(m2);
+        sodium_free(c);
+        sodium_free(c2);
+        sodium_free(ad);
+    }
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(mac);
+    sodium_free(mac2);
+}
+
+static void
+tv_ietf_iov(void)
+{
+    crypto_aead_iovec   m_iov[64];
+    crypto_aead_iovec   c_iov[64];
+    crypto_aead_iovec   ad_iov[64];
+    unsigned char      *key = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    unsigned char      *nonce = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    unsigned char      *mac = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_ABYTES);
+    unsigned char      *mac2 = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_ABYTES);
+    unsigned char      *m;
+    unsigned char      *m2;
+    unsigned char      *c;
+    unsigned char      *c2;
+    unsigned char      *ad;
+    unsigned long long  maclen;
+    size_t              mlen;
+    size_t              adlen;
+    size_t              m_count;
+    size_t              c_count;
+    size_t              ad_count;
+    int                 i;
+
+    crypto_aead_chacha20poly1305_ietf_keygen(key);
+    randombytes_buf(nonce, crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    for (i = 0; i < 100; i++) {
+        mlen = (size_t) randombytes_uniform(3000U);
+        adlen = (size_t) randombytes_uniform(200U);
+        m = (unsigned char *) sodium_malloc(mlen + 1U);
+        m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        c = (unsigned char *) sodium_malloc(mlen + 1U);
+        c2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        ad = (unsigned char *) sodium_malloc(adlen + 1U);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_chacha20poly1305_ietf_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen, NULL, nonce, key);
+
+        m_count = split_iov(m_iov, 64U, m, mlen);
+        c_count = split_iov(c_iov, 64U, c2, mlen);
+        ad_count = split_iov(ad_iov, 64U, ad, adlen);
+        assert(crypto_aead_chacha20poly1305_ietf_encrypt_detached_iov(c_iov, c_count, mac2, &maclen,
+               m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(maclen == crypto_aead_chacha20poly1305_ietf_ABYTES);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_chacha20poly1305_ietf_ABYTES) == 0);
+
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_detached_iov(NULL, 0U, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        m_count = split_iov(m_iov, 64U, m2, mlen);
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac,
+               ad_iov, ad_count, nonce, key) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+
+        c_count = split_iov(c_iov, 64U, m2, mlen);
+        assert(crypto_aead_chacha20poly1305_ietf_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+               c_iov, c_count, ad_iov, ad_count, NULL, nonce, key) == 0);
+        assert(memcmp(c, m2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_chacha20poly1305_ietf_ABYTES) == 0);
+
+        mac2[0] ^= 1;
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_detached_iov(m_iov, m_count, NULL, c_iov, c_count, mac2,
+               ad_iov, ad_count, nonce, key) == -1);
+        assert(mlen == 0U || sodium_is_zero(m2, mlen));
+
+        if (mlen > 0U) {
+            c_iov[c_count - 1U].len++;
+            assert(crypto_aead_chacha20poly1305_ietf_encrypt_detached_iov(c_iov, c_count, mac2, NULL,
+                   m_iov, m_count, ad_iov, ad_count, NULL, nonce, key) == -1);
+        }
+        sodium_free(m);
+        sodium_free(m2);
+        sodium_free(c);
+        sodium_free(c2);
+        sodium_free(ad);
+    }
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(mac);
+    sodium_free(mac2);
+}
+
+static void
+tv_ietf_batch(void)
+{
+    unsigned char      *ms[40];
+    unsigned char      *cs[40];
+    unsigned char      *ads[40];
+    unsigned char      *nonces[40];
+    unsigned long long  mlens[40];
+    unsigned long long  adlens[40];
+    unsigned char      *key = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    unsigned char      *c;
+    unsigned long long  clen;
+    size_t              count;
+    size_t              j;
+    int                 i;
+
+    crypto_aead_chacha20poly1305_ietf_keygen(key);
+    for (i = 0; i < 40; i++) {
+        count = (size_t) randombytes_uniform(40U) + 1U;
+        for (j = 0U; j < count; j++) {
+            mlens[j] = (unsigned long long) randombytes_uniform(1500U);
+            adlens[j] = (unsigned long long) randombytes_uniform(40U);
+            ms[j] = (unsigned char *) sodium_malloc(mlens[j] + 1U);
+            cs[j] = (unsigned char *) sodium_malloc(mlens[j] + crypto_aead_chacha20poly1305_ietf_ABYTES);
+            ads[j] = (unsigned char *) sodium_malloc(adlens[j] + 1U);
+            nonces[j] = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+            randombytes_buf(ms[j], mlens[j]);
+            randombytes_buf(ads[j], adlens[j]);
+            randombytes_buf(nonces[j], crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+        }
+        assert(crypto_aead_chacha20poly1305_ietf_encrypt_batch
+               (cs, (const unsigned char * const *) ms, mlens,
+                (const unsigned char * const *) ads, adlens,
+                (const unsigned char * const *) nonces, count, key) == 0);
+        for (j = 0U; j < count; j++) {
+            c = (unsigned char *) sodium_malloc(mlens[j] + crypto_aead_chacha20poly1305_ietf_ABYTES);
+            crypto_aead_chacha20poly1305_ietf_encrypt(c, &clen, ms[j], mlens[j], ads[j], adlens[j],
+                                                      NULL, nonces[j], key);
+            assert(memcmp(c, cs[j], (size_t) clen) == 0);
+            sodium_free(c);
+        }
+
+        for (j = 0U; j < count; j++) {
+            memcpy(cs[j], ms[j], (size_t) mlens[j]);
+        }
+        assert(crypto_aead_chacha20poly1305_ietf_encrypt_batch
+               (cs, (const unsigned char * const *) cs, mlens, NULL, NULL,
+                (const unsigned char * const *) nonces, count, key) == 0);
+        for (j = 0U; j < count; j++) {
+            assert(crypto_aead_chacha20poly1305_ietf_decrypt(ms[j], NULL, NULL,
+                   cs[j], mlens[j] + crypto_aead_chacha20poly1305_ietf_ABYTES,
+                   NULL, 0U, nonces[j], key) == 0);
+            sodium_free(ms[j]);
+            sodium_free(cs[j]);
+            sodium_free(ads[j]);
+            sodium_free(nonces[j]);
+        }
+    }
+    assert(crypto_aead_chacha20poly1305_ietf_encrypt_batch(NULL, NULL, NULL, NULL, NULL, NULL,
+                                                           0U, key) == 0);
+    sodium_free(key);
+}
+
+static void
+tv_commit(void)
+{
+    unsigned char      key[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char      key2[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char      nonce[crypto_aead_chacha20poly1305_ietf_NPUBBYTES];
+    unsigned char      ad[20];
+    unsigned char      m[200];
+    unsigned char      m2[200];
+    unsigned char      c[200 + crypto_aead_chacha20poly1305_ietf_ABYTES + crypto_aead_chacha20poly1305_ietf_COMMITBYTES];
+    unsigned char      c2[200 + crypto_aead_chacha20poly1305_ietf_ABYTES];
+    unsigned long long clen;
+    unsigned long long clen2;
+    unsigned long long mlen;
+    unsigned long long m2len;
+    int                i;
+
+    for (i = 0; i < 100; i++) {
+        crypto_aead_chacha20poly1305_ietf_keygen(key);
+        memcpy(key2, key, sizeof key);
+        key2[randombytes_uniform(sizeof key2)] ^= 1;
+        randombytes_buf(nonce, sizeof nonce);
+        randombytes_buf(ad, sizeof ad);
+        mlen = (unsigned long long) randombytes_uniform(sizeof m + 1U);
+        randombytes_buf(m, (size_t) mlen);
+
+        assert(crypto_aead_chacha20poly1305_ietf_encrypt_commit(c, &clen, m, mlen, ad, sizeof ad,
+               NULL, nonce, key) == 0);
+        assert(clen == mlen + crypto_aead_chacha20poly1305_ietf_ABYTES + crypto_aead_chacha20poly1305_ietf_COMMITBYTES);
+        crypto_aead_chacha20poly1305_ietf_encrypt(c2, &clen2, m, mlen, ad, sizeof ad, NULL, nonce, key);
+        assert(memcmp(c, c2, (size_t) clen2) == 0);
+
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_commit(m2, &m2len, NULL, c, clen, ad, sizeof ad,
+               nonce, key) == 0);
+        assert(m2len == mlen);
+        assert(memcmp(m, m2, (size_t) mlen) == 0);
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_commit(m2, &m2len, NULL, c, clen, ad, sizeof ad,
+               nonce, key2) == -1);
+        assert(m2len == 0U);
+        c[clen - 1U - randombytes_uniform(crypto_aead_chacha20poly1305_ietf_COMMITBYTES)] ^= 0x80;
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_commit(m2, NULL, NULL, c, clen, ad, sizeof ad,
+               nonce, key) == -1);
+    }
+    assert(crypto_aead_chacha20poly1305_ietf_decrypt_commit(m2, &m2len, NULL, c, crypto_aead_chacha20poly1305_ietf_ABYTES + crypto_aead_chacha20poly1305_ietf_COMMITBYTES - 1U,
+           NULL, 0U, nonce, key) == -1);
+    assert(crypto_aead_chacha20poly1305_ietf_commitbytes() == crypto_aead_chacha20poly1305_ietf_COMMITBYTES);
+}
+
+static void
+tv_ietf_stream(void)
+{
+    crypto_aead_chacha20poly1305_ietf_state st;
+    unsigned char *key = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    unsigned char *nonce = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    unsigned char *mac = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_ABYTES);
+    unsigned char *mac2 = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_ABYTES);
+    unsigned char *m;
+    unsigned char *m2;
+    unsigned char *c;
+    unsigned char *c2;
+    unsigned char *ad;
+    size_t         mlen;
+    size_t         adlen;
+    size_t         j;
+    size_t         chunk;
+    int            i;
+
+    crypto_aead_chacha20poly1305_ietf_keygen(key);
+    randombytes_buf(nonce, crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    for (i = 0; i < 100; i++) {
+        mlen = (size_t) randombytes_uniform(3000U);
+        adlen = (size_t) randombytes_uniform(200U);
+        m = (unsigned char *) sodium_malloc(mlen + 1U);
+        m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        c = (unsigned char *) sodium_malloc(mlen + 1U);
+        c2 = (unsigned char *) sodium_malloc(mlen + 1U);
+        ad = (unsigned char *) sodium_malloc(adlen + 1U);
+        randombytes_buf(m, mlen);
+        randombytes_buf(ad, adlen);
+        crypto_aead_chacha20poly1305_ietf_encrypt_detached(c, mac, NULL, m, mlen, ad, adlen,
+                                                           NULL, nonce, key);
+
+        assert(crypto_aead_chacha20poly1305_ietf_init(&st, nonce, key) == 0);
+        for (j = 0U; j < adlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(40U);
+            if (chunk > adlen - j) {
+                chunk = adlen - j;
+            }
+            assert(crypto_aead_chacha20poly1305_ietf_update_ad(&st, ad + j, chunk) == 0);
+        }
+        for (j = 0U; j < mlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(300U);
+            if (chunk > mlen - j) {
+                chunk = mlen - j;
+            }
+            assert(crypto_aead_chacha20poly1305_ietf_encrypt_update(&st, c2 + j, m + j, chunk) == 0);
+        }
+        if (mlen > 0U) {
+            assert(crypto_aead_chacha20poly1305_ietf_update_ad(&st, ad, adlen) == -1);
+        }
+        assert(crypto_aead_chacha20poly1305_ietf_encrypt_final(&st, mac2) == 0);
+        assert(memcmp(c, c2, mlen) == 0);
+        assert(memcmp(mac, mac2, crypto_aead_chacha20poly1305_ietf_ABYTES) == 0);
+
+        memcpy(m2, c, mlen);
+        assert(crypto_aead_chacha20poly1305_ietf_init(&st, nonce, key) == 0);
+        assert(crypto_aead_chacha20poly1305_ietf_update_ad(&st, ad, adlen) == 0);
+        for (j = 0U; j < mlen; j += chunk) {
+            chunk = (size_t) randombytes_uniform(300U);
+            if (chunk > mlen - j) {
+                chunk = mlen - j;
+            }
+            assert(crypto_aead_chacha20poly1305_ietf_decrypt_update(&st, m2 + j, m2 + j, chunk) == 0);
+        }
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_final(&st, mac) == 0);
+        assert(memcmp(m, m2, mlen) == 0);
+
+        mac2[0] ^= 1;
+        assert(crypto_aead_chacha20poly1305_ietf_init(&st, nonce, key) == 0);
+        assert(crypto_aead_chacha20poly1305_ietf_update_ad(&st, ad, adlen) == 0);
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_update(&st, m2, c, mlen) == 0);
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt_final(&st, mac2) == -1);
+
+        sodium_free(m);
+        sodium_free(m2);
+        sodium_free(c);
+        sodium_free(c2);
+        sodium_free(ad);
+    }
+    assert(crypto_aead_chacha20poly1305_ietf_statebytes() ==
+           sizeof(crypto_aead_chacha20poly1305_ietf_state));
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(mac);
+    sodium_free(mac2);
+}
+
+static void
+tv_ietf_prepared(void)
+{
+    static const size_t kslens[] = { 0U, 1U, 64U, 100U, crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX };
+    static const size_t mlens[] = { 0U, 1U, 63U, 64U, 65U, 128U, 1024U, 1025U, 5000U };
+    crypto_aead_chacha20poly1305_ietf_prepared st;
+    unsigned char     *key = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    unsigned char     *nonce = (unsigned char *) sodium_malloc(crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+    unsigned char     *ad = (unsigned char *) sodium_malloc(20U);
+    unsigned char     *m = (unsigned char *) sodium_malloc(5000U);
+    unsigned char     *c = (unsigned char *) sodium_malloc(5000U + crypto_aead_chacha20poly1305_ietf_ABYTES);
+    unsigned char     *c2 = (unsigned char *) sodium_malloc(5000U + crypto_aead_chacha20poly1305_ietf_ABYTES);
+    unsigned long long clen;
+    size_t             i, j;
+
+    randombytes_buf(key, crypto_aead_chacha20poly1305_ietf_KEYBYTES);
+    randombytes_buf(ad, 20U);
+    randombytes_buf(m, 5000U);
+    for (i = 0U; i < sizeof kslens / sizeof kslens[0]; i++) {
+        for (j = 0U; j < sizeof mlens / sizeof mlens[0]; j++) {
+            randombytes_buf(nonce, crypto_aead_chacha20poly1305_ietf_NPUBBYTES);
+            assert(crypto_aead_chacha20poly1305_ietf_encrypt(c, NULL, m, mlens[j], ad, j % 2U == 0U ? 20U : 0U,
+                   NULL, nonce, key) == 0);
+            assert(crypto_aead_chacha20poly1305_ietf_prepare(&st, kslens[i], nonce, key) == 0);
+            assert(crypto_aead_chacha20poly1305_ietf_encrypt_prepared(c2, &clen, m, mlens[j], ad,
+                   j % 2U == 0U ? 20U : 0U, &st) == 0);
+            assert(clen == mlens[j] + crypto_aead_chacha20poly1305_ietf_ABYTES);
+            assert(memcmp(c, c2, (size_t) clen) == 0);
+            assert(crypto_aead_chacha20poly1305_ietf_encrypt_prepared(c2, &clen, m, mlens[j], ad,
+                   j % 2U == 0U ? 20U : 0U, &st) == -1);
+            assert(clen == 0U);
+        }
+    }
+    assert(crypto_aead_chacha20poly1305_ietf_prepare(&st, 1000U, nonce, key) == 0);
+    memcpy(c2, m, 1000U);
+    assert(crypto_aead_chacha20poly1305_ietf_encrypt_prepared(c2, NULL, c2, 1000U, NULL, 0U, &st) == 0);
+    assert(crypto_aead_chacha20poly1305_ietf_encrypt(c, NULL, m, 1000U, NULL, 0U, NULL, nonce, key) == 0);
+    assert(memcmp(c, c2, 1000U + crypto_aead_chacha20poly1305_ietf_ABYTES) == 0);
+    assert(crypto_aead_chacha20poly1305_ietf_prepare(&st, crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX + 1U, nonce, key) == -1);
+    assert(crypto_aead_chacha20poly1305_ietf_preparedbytes_max() == crypto_aead_chacha20poly1305_ietf_PREPAREDBYTES_MAX);
+
+    sodium_free(key);
+    sodium_free(nonce);
+    sodium_free(ad);
+    sodium_free(m);
+    sodium_free(c);
+    sodium_free(c2);
+}
+
 int
 main(void)
 {
     tv();
     tv_ietf();
+    tv_iov();
+    tv_ietf_iov();
+    tv_ietf_batch();
+    tv_commit();
+    tv_ietf_stream();
+    tv_ietf_prepared();
 
     return 0;
 }
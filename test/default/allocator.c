@@ -0,0 +1,200 @@
+#define TEST_NAME "allocator"
+#include "cmptest.h"
+
+#define OPSLIMIT 1U
+#define MEMLIMIT (8U * 1024U * 1024U)
+
+typedef struct counters {
+    size_t allocated;
+    size_t freed;
+    size_t in_use;
+    int    wiped;
+} counters;
+
+static void *
+counting_alloc(void *ctx, size_t size)
+{
+    counters      *cnt = (counters *) ctx;
+    unsigned char *base;
+    unsigned char *ptr;
+
+    if ((base = (unsigned char *) malloc(size + 64U + sizeof base)) == NULL) {
+        return NULL;
+    }
+    ptr = base + sizeof base + 64U;
+    ptr -= (uintptr_t) ptr & 63U;
+    memcpy(ptr - sizeof base, &base, sizeof base);
+    cnt->allocated++;
+    cnt->in_use += size;
+
+    return ptr;
+}
+
+static void
+counting_free(void *ctx, void *ptr, size_t size)
+{
+    counters      *cnt = (counters *) ctx;
+    unsigned char *base;
+    size_t         i;
+
+    for (i = 0U; i < size; i++) {
+        if (((unsigned char *) ptr)[i] != 0U) {
+            cnt->wiped = 0;
+        }
+    }
+    memcpy(&base, (unsigned char *) ptr - sizeof base, sizeof base);
+    free(base);
+    cnt->freed++;
+    cnt->in_use -= size;
+}
+
+static void
+scratch_tests(void)
+{
+    counters      cnt;
+    unsigned char salt[crypto_pwhash_SALTBYTES];
+    unsigned char salt2[crypto_pwhash_scryptsalsa208sha256_SALTBYTES];
+    unsigned char h[32];
+    unsigned char h2[32];
+    unsigned char s[32];
+    unsigned char s2[32];
+
+    randombytes_buf(salt, sizeof salt);
+    randombytes_buf(salt2, sizeof salt2);
+    assert(crypto_pwhash(h, sizeof h, "test", 4U, salt, OPSLIMIT, MEMLIMIT,
+                         crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(crypto_pwhash_scryptsalsa208sha256(s, sizeof s, "test", 4U, salt2,
+                                              crypto_pwhash_scryptsalsa208sha256_OPSLIMIT_MIN,
+                                              MEMLIMIT) == 0);
+
+    memset(&cnt, 0, sizeof cnt);
+    cnt.wiped = 1;
+    assert(sodium_set_allocator(SODIUM_ALLOC_SCRATCH, counting_alloc,
+                                counting_free, &cnt) == 0);
+    assert(crypto_pwhash(h2, sizeof h2, "test", 4U, salt, OPSLIMIT, MEMLIMIT,
+                         crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(memcmp(h, h2, sizeof h) == 0);
+    assert(cnt.allocated == 1U && cnt.freed == 1U && cnt.in_use == 0U);
+    assert(crypto_pwhash_scryptsalsa208sha256(s2, sizeof s2, "test", 4U, salt2,
+                                              crypto_pwhash_scryptsalsa208sha256_OPSLIMIT_MIN,
+                                              MEMLIMIT) == 0);
+    assert(memcmp(s, s2, sizeof s) == 0);
+    assert(cnt.allocated >= 2U && cnt.freed == cnt.allocated);
+    assert(cnt.in_use == 0U && cnt.wiped == 1);
+    assert(sodium_set_allocator(SODIUM_ALLOC_SCRATCH, NULL, NULL, NULL) == 0);
+
+    assert(crypto_pwhash(h2, sizeof h2, "test", 4U, salt, OPSLIMIT, MEMLIMIT,
+                         crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(memcmp(h, h2, sizeof h) == 0);
+}
+
+static void
+secret_tests(void)
+{
+    counters       cnt;
+    unsigned char *p;
+    unsigned char *q;
+
+    memset(&cnt, 0, sizeof cnt);
+    cnt.wiped = 1;
+    assert(sodium_set_allocator(SODIUM_ALLOC_SECRET, counting_alloc,
+                                counting_free, &cnt) == 0);
+    p = (unsigned char *) (sodium_malloc)(100U);
+    q = (unsigned char *) (sodium_allocarray)(10U, 10U);
+    assert(p != NULL && q != NULL);
+    assert(((uintptr_t) p & 63U) == 0U);
+    assert(cnt.allocated == 2U && cnt.in_use > 200U);
+    memset(p, 0x42, 100U);
+    memset(q, 0x42, 100U);
+    assert((sodium_mprotect_noaccess)(p) == -1 && errno == ENOSYS);
+    assert((sodium_mprotect_readonly)(p) == -1 && errno == ENOSYS);
+    assert((sodium_mprotect_readwrite)(p) == -1 && errno == ENOSYS);
+    (sodium_free)(p);
+    (sodium_free)(q);
+    (sodium_free)(NULL);
+    assert(cnt.freed == 2U && cnt.in_use == 0U && cnt.wiped == 1);
+    assert((sodium_malloc)(SIZE_MAX - 1U) == NULL && errno == ENOMEM);
+    assert(sodium_set_allocator(SODIUM_ALLOC_SECRET, NULL, NULL, NULL) == 0);
+
+    p = (unsigned char *) (sodium_malloc)(100U);
+    assert(p != NULL);
+    (sodium_free)(p);
+    assert(cnt.allocated == 2U);
+}
+
+static void
+arena_tests(void)
+{
+    sodium_secret_arena *arena;
+    unsigned char       *p[64];
+    unsigned char       *q;
+    size_t               i;
+
+    if ((arena = sodium_secret_arena_create(0U)) == NULL) {
+        assert(errno == ENOSYS);
+        return;
+    }
+    assert(sodium_set_allocator(SODIUM_ALLOC_SECRET, sodium_secret_arena_alloc,
+                                sodium_secret_arena_free, arena) == 0);
+    for (i = 0U; i < 64U; i++) {
+        p[i] = (unsigned char *) (sodium_malloc)(i * 97U + 1U);
+        assert(p[i] != NULL && ((uintptr_t) p[i] & 63U) == 0U);
+        memset(p[i], (int) i, i * 97U + 1U);
+    }
+    q = (unsigned char *) (sodium_malloc)(100000U);
+    assert(q != NULL);
+    memset(q, 0x42, 100000U);
+    for (i = 0U; i < 64U; i += 2U) {
+        (sodium_free)(p[i]);
+    }
+    for (i = 0U; i < 64U; i += 2U) {
+        p[i] = (unsigned char *) (sodium_malloc)(i * 97U + 1U);
+        assert(p[i] != NULL);
+        memset(p[i], (int) i, i * 97U + 1U);
+    }
+    for (i = 0U; i < 64U; i++) {
+        assert(p[i][0] == (unsigned char) i && p[i][i * 97U] == (unsigned char) i);
+        (sodium_free)(p[i]);
+    }
+    assert(q[99999U] == 0x42);
+    (sodium_free)(q);
+    for (i = 0U; i < 1000U; i++) {
+        q = (unsigned char *) (sodium_malloc)(1000U);
+        assert(q != NULL);
+        (sodium_free)(q);
+    }
+    assert(sodium_set_allocator(SODIUM_ALLOC_SECRET, NULL, NULL, NULL) == 0);
+    sodium_secret_arena_destroy(arena);
+    sodium_secret_arena_destroy(NULL);
+
+    assert(sodium_secret_arena_create(SIZE_MAX) == NULL && errno == EINVAL);
+    arena = sodium_secret_arena_create(1U);
+    assert(arena != NULL);
+    q = (unsigned char *) sodium_secret_arena_alloc(arena, 3000U);
+    assert(q != NULL);
+    sodium_secret_arena_free(arena, q, 3000U);
+    assert(sodium_secret_arena_alloc(arena, 3000U) == q);
+    sodium_secret_arena_destroy(arena);
+}
+
+int
+main(void)
+{
+    counters cnt;
+
+    assert(sodium_set_allocator(2, counting_alloc, counting_free,
+                                &cnt) == -1 && errno == EINVAL);
+    assert(sodium_set_allocator(-1, NULL, NULL, NULL) == -1);
+    assert(sodium_set_allocator(SODIUM_ALLOC_SECRET, counting_alloc, NULL,
+                                &cnt) == -1);
+    assert(sodium_set_allocator(SODIUM_ALLOC_SCRATCH, NULL, counting_free,
+                                &cnt) == -1);
+
+    scratch_tests();
+    secret_tests();
+    arena_tests();
+
+    printf("OK\n");
+
+    return 0;
+}
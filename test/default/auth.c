@@ -119,6 +119,94 @@ main(void)
     crypto_auth_hmacsha256_final(&st256, a3);
     assert(sodium_memcmp(a2, a3, sizeof a2) == 0);
 
+    /* Precomputed keys */
+
+    {
+        crypto_auth_hmacsha256_key_state    kst256;
+        crypto_auth_hmacsha512_key_state    kst512;
+        crypto_auth_hmacsha512256_key_state kst512_256;
+
+        crypto_auth_hmacsha256_key_precompute(&kst256, key2, sizeof key2);
+        crypto_auth_hmacsha256_init(&st256, key2, sizeof key2);
+        crypto_auth_hmacsha256_update(&st256, c, sizeof c - 1U);
+        crypto_auth_hmacsha256_final(&st256, a2);
+        crypto_auth_hmacsha256_precomputed(a3, c, sizeof c - 1U, &kst256);
+        assert(sodium_memcmp(a2, a3, crypto_auth_hmacsha256_BYTES) == 0);
+        crypto_auth_hmacsha256_init_precomputed(&st256, &kst256);
+        crypto_auth_hmacsha256_update(&st256, c, 1U);
+        crypto_auth_hmacsha256_update(&st256, c + 1U, sizeof c - 2U);
+        crypto_auth_hmacsha256_final(&st256, a3);
+        assert(sodium_memcmp(a2, a3, crypto_auth_hmacsha256_BYTES) == 0);
+        assert(crypto_auth_hmacsha256_verify_precomputed(a2, c, sizeof c - 1U,
+                                                         &kst256) == 0);
+        a2[0]++;
+        assert(crypto_auth_hmacsha256_verify_precomputed(a2, c, sizeof c - 1U,
+                                                         &kst256) == -1);
+
+        crypto_auth_hmacsha512_key_precompute(&kst512, key, sizeof key);
+        crypto_auth_hmacsha512(a2, c, sizeof c - 1U, key);
+        crypto_auth_hmacsha512_precomputed(a3, c, sizeof c - 1U, &kst512);
+        assert(sodium_memcmp(a2, a3, crypto_auth_hmacsha512_BYTES) == 0);
+        assert(crypto_auth_hmacsha512_verify_precomputed(a2, c, sizeof c - 1U,
+                                                         &kst512) == 0);
+        a2[0]++;
+        assert(crypto_auth_hmacsha512_verify_precomputed(a2, c, sizeof c - 1U,
+                                                         &kst512) == -1);
+
+        crypto_auth_hmacsha512256_key_precompute(&kst512_256, key, sizeof key);
+        crypto_auth_hmacsha512256(a2, c, sizeof c - 1U, key);
+        crypto_auth_hmacsha512256_precomputed(a3, c, sizeof c - 1U, &kst512_256);
+        assert(sodium_memcmp(a2, a3, crypto_auth_hmacsha512256_BYTES) == 0);
+        assert(crypto_auth_hmacsha512256_verify_precomputed
+               (a2, c, sizeof c - 1U, &kst512_256) == 0);
+        a2[0]++;
+        assert(crypto_auth_hmacsha512256_verify_precomputed
+               (a2, c, sizeof c - 1U, &kst512_256) == -1);
+
+        assert(crypto_auth_hmacsha256_key_statebytes() == sizeof kst256);
+        assert(crypto_auth_hmacsha512_key_statebytes() == sizeof kst512);
+        assert(crypto_auth_hmacsha512256_key_statebytes() == sizeof kst512_256);
+    }
+
+    /* batch */
+
+    {
+#define BATCH_COUNT 50U
+        unsigned char      *macs[BATCH_COUNT];
+        unsigned char      *msgs[BATCH_COUNT];
+        unsigned char      *keys[BATCH_COUNT];
+        unsigned long long  lens[BATCH_COUNT];
+        size_t              i;
+
+        for (i = 0U; i < BATCH_COUNT; i++) {
+            lens[i] = (unsigned long long) ((i * 13U) % 300U);
+            macs[i] = (unsigned char *) sodium_malloc(crypto_auth_hmacsha512_BYTES);
+            msgs[i] = (unsigned char *) sodium_malloc((size_t) lens[i] + 1U);
+            keys[i] = (unsigned char *) sodium_malloc(crypto_auth_hmacsha512_KEYBYTES);
+            randombytes_buf(msgs[i], (size_t) lens[i]);
+            crypto_auth_hmacsha512_keygen(keys[i]);
+        }
+        assert(crypto_auth_hmacsha256_batch(
+                   macs, (const unsigned char * const *) msgs, lens,
+                   (const unsigned char * const *) keys, BATCH_COUNT) == 0);
+        for (i = 0U; i < BATCH_COUNT; i++) {
+            crypto_auth_hmacsha256(a2, msgs[i], lens[i], keys[i]);
+            assert(memcmp(a2, macs[i], crypto_auth_hmacsha256_BYTES) == 0);
+        }
+        assert(crypto_auth_hmacsha512_batch(
+                   macs, (const unsigned char * const *) msgs, lens,
+                   (const unsigned char * const *) keys, BATCH_COUNT) == 0);
+        for (i = 0U; i < BATCH_COUNT; i++) {
+            crypto_auth_hmacsha512(a2, msgs[i], lens[i], keys[i]);
+            assert(memcmp(a2, macs[i], crypto_auth_hmacsha512_BYTES) == 0);
+        }
+        for (i = 0U; i < BATCH_COUNT; i++) {
+            sodium_free(macs[i]);
+            sodium_free(msgs[i]);
+            sodium_free(keys[i]);
+        }
+    }
+
     /* --- */
 
     assert(crypto_auth_bytes() > 0U);
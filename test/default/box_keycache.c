@@ -0,0 +1,70 @@
+
+#define TEST_NAME "box_keycache"
+#include "cmptest.h"
+
+int
+main(void)
+{
+    crypto_box_keycache cache;
+    unsigned char       pk[3][crypto_box_PUBLICKEYBYTES];
+    unsigned char       sk[3][crypto_box_SECRETKEYBYTES];
+    unsigned char       k[crypto_box_BEFORENMBYTES];
+    unsigned char       k2[crypto_box_BEFORENMBYTES];
+    unsigned char       n[crypto_box_NONCEBYTES];
+    unsigned char       m[100];
+    unsigned char       m2[100];
+    unsigned char       c[crypto_box_MACBYTES + 100];
+    size_t              i;
+    size_t              j;
+
+    assert(crypto_box_keycache_init(&cache, 0U) == -1);
+    assert(crypto_box_keycache_init(&cache, 2U) == 0);
+    assert(cache.capacity == 2U);
+
+    for (i = 0U; i < 3U; i++) {
+        crypto_box_keypair(pk[i], sk[i]);
+    }
+    for (j = 0U; j < 3U; j++) {
+        for (i = 0U; i < 3U; i++) {
+            assert(crypto_box_keycache_beforenm(&cache, k, pk[i], sk[0]) == 0);
+            assert(crypto_box_beforenm(k2, pk[i], sk[0]) == 0);
+            assert(memcmp(k, k2, sizeof k) == 0);
+            assert(cache.count == (i + 1U < 2U && j == 0U ? i + 1U : 2U));
+        }
+    }
+    assert(crypto_box_keycache_beforenm(&cache, k, pk[0], sk[1]) == 0);
+    assert(crypto_box_beforenm(k2, pk[0], sk[1]) == 0);
+    assert(memcmp(k, k2, sizeof k) == 0);
+    assert(crypto_box_keycache_beforenm(&cache, k, pk[2], sk[0]) == 0);
+    assert(crypto_box_keycache_beforenm(&cache, k2, pk[0], sk[1]) == 0);
+    assert(memcmp(k, k2, sizeof k) != 0);
+
+    randombytes_buf(m, sizeof m);
+    randombytes_buf(n, sizeof n);
+    assert(crypto_box_keycache_easy(&cache, c, m, sizeof m, n, pk[1], sk[0]) == 0);
+    assert(crypto_box_open_easy(m2, c, sizeof c, n, pk[0], sk[1]) == 0);
+    assert(memcmp(m, m2, sizeof m) == 0);
+    assert(crypto_box_easy(c, m, sizeof m, n, pk[2], sk[1]) == 0);
+    assert(crypto_box_keycache_open_easy(&cache, m2, c, sizeof c, n,
+                                         pk[1], sk[2]) == 0);
+    assert(memcmp(m, m2, sizeof m) == 0);
+    c[0]++;
+    assert(crypto_box_keycache_open_easy(&cache, m2, c, sizeof c, n,
+                                         pk[1], sk[2]) == -1);
+
+    memset(pk[2], 0, sizeof pk[2]);
+    assert(crypto_box_keycache_beforenm(&cache, k, pk[2], sk[0]) == -1);
+
+    crypto_box_keycache_clear(&cache);
+    assert(cache.count == 0U);
+    assert(crypto_box_keycache_beforenm(&cache, k, pk[0], sk[1]) == 0);
+    assert(crypto_box_beforenm(k2, pk[0], sk[1]) == 0);
+    assert(memcmp(k, k2, sizeof k) == 0);
+
+    crypto_box_keycache_free(&cache);
+    assert(crypto_box_keycache_beforenm(&cache, k, pk[0], sk[1]) == -1);
+
+    printf("OK\n");
+
+    return 0;
+}
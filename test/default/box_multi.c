@@ -0,0 +1,77 @@
+
+#define TEST_NAME "box_multi"
+#include "cmptest.h"
+
+#define RECIPIENTS 150U
+
+int
+main(void)
+{
+    unsigned char       pks[RECIPIENTS][crypto_box_PUBLICKEYBYTES];
+    unsigned char       sks[RECIPIENTS][crypto_box_SECRETKEYBYTES];
+    const unsigned char *pk_p[RECIPIENTS];
+    unsigned char       opk[crypto_box_PUBLICKEYBYTES];
+    unsigned char       osk[crypto_box_SECRETKEYBYTES];
+    unsigned char      *c;
+    unsigned char      *m;
+    unsigned char      *m2;
+    unsigned long long  clen;
+    unsigned long long  mlen2;
+    size_t              mlen;
+    size_t              count;
+    size_t              i;
+
+    for (i = 0U; i < RECIPIENTS; i++) {
+        crypto_box_keypair(pks[i], sks[i]);
+        pk_p[i] = pks[i];
+    }
+    crypto_box_keypair(opk, osk);
+    mlen = (size_t) randombytes_uniform(1000U);
+    m    = (unsigned char *) sodium_malloc(mlen);
+    m2   = (unsigned char *) sodium_malloc
+        ((size_t) (crypto_box_multi_bytes(RECIPIENTS, mlen) -
+                   crypto_box_multi_bytes(1U, 0U)));
+    randombytes_buf(m, mlen);
+    c = (unsigned char *) sodium_malloc
+        ((size_t) crypto_box_multi_bytes(RECIPIENTS, mlen));
+
+    for (count = 1U; count <= RECIPIENTS; count += 37U) {
+        assert(crypto_box_multi_seal(c, &clen, m, mlen, pk_p, count) == 0);
+        assert(clen == crypto_box_multi_bytes(count, mlen));
+        for (i = 0U; i < count; i++) {
+            memset(m2, 0, mlen);
+            assert(crypto_box_multi_open(m2, &mlen2, c, clen, pks[i], sks[i]) == 0);
+            assert(mlen2 == mlen);
+            assert(memcmp(m, m2, mlen) == 0);
+        }
+        assert(crypto_box_multi_open(m2, NULL, c, clen, opk, osk) == -1);
+        assert(crypto_box_multi_open(m2, NULL, c, clen, pks[1], sks[0]) == -1);
+        assert(crypto_box_multi_open(m2, NULL, c, clen - 1U, pks[0], sks[0]) == -1);
+        for (i = 0U; i < clen; i += 1U + (size_t) randombytes_uniform(50U)) {
+            c[i] ^= 0x04;
+            assert(crypto_box_multi_open(m2, NULL, c, clen, pks[0], sks[0]) == -1);
+            c[i] ^= 0x04;
+        }
+    }
+    assert(crypto_box_multi_open(m2, NULL, c, crypto_box_multi_bytes(1U, 0U) - 1U,
+                                 pks[0], sks[0]) == -1);
+
+    assert(crypto_box_multi_seal(c, &clen, m, mlen, pk_p, 0U) == -1);
+    assert(errno == EINVAL);
+    memset(pks[3], 0, sizeof pks[3]);
+    assert(crypto_box_multi_seal(c, &clen, m, mlen, pk_p, 10U) == -1);
+    assert(clen == 0U);
+
+    assert(crypto_box_multi_headerbytes() == crypto_box_MULTI_HEADERBYTES);
+    assert(crypto_box_multi_slotbytes() == crypto_box_MULTI_SLOTBYTES);
+    assert(crypto_box_multi_abytes() == crypto_box_MULTI_ABYTES);
+    assert(crypto_box_multi_recipients_max() == crypto_box_MULTI_RECIPIENTS_MAX);
+
+    sodium_free(c);
+    sodium_free(m2);
+    sodium_free(m);
+
+    printf("OK\n");
+
+    return 0;
+}
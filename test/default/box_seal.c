@@ -153,6 +153,167 @@ void tv4(void)
 { }
 #endif
 
+static
+void tv_batch(void)
+{
+    unsigned char        pk[10][crypto_box_PUBLICKEYBYTES];
+    unsigned char        sk[10][crypto_box_SECRETKEYBYTES];
+    unsigned char       *c[10];
+    unsigned char       *m[10];
+    const unsigned char *pk_p[10];
+    unsigned long long   mlen[10];
+    unsigned char        m2[100];
+    size_t               i;
+
+    for (i = 0U; i < 10U; i++) {
+        crypto_box_keypair(pk[i], sk[i]);
+        pk_p[i] = pk[i];
+        mlen[i] = (unsigned long long) randombytes_uniform(100);
+        m[i]    = (unsigned char *) sodium_malloc((size_t) mlen[i]);
+        c[i]    = (unsigned char *) sodium_malloc(crypto_box_SEALBYTES + (size_t) mlen[i]);
+        randombytes_buf(m[i], (size_t) mlen[i]);
+    }
+    assert(crypto_box_seal_batch(c, (const unsigned char * const *) m, mlen,
+                                 pk_p, 10U) == 0);
+    for (i = 0U; i < 10U; i++) {
+        assert(crypto_box_seal_open(m2, c[i], crypto_box_SEALBYTES + mlen[i],
+                                    pk[i], sk[i]) == 0);
+        assert(memcmp(m2, m[i], (size_t) mlen[i]) == 0);
+    }
+    assert(crypto_box_seal_open(m2, c[0], crypto_box_SEALBYTES + mlen[0],
+                                pk[1], sk[1]) == -1);
+
+    memset(pk[3], 0, sizeof pk[3]);
+    assert(crypto_box_seal_batch(c, (const unsigned char * const *) m, mlen,
+                                 pk_p, 10U) == -1);
+    assert(crypto_box_seal_open(m2, c[4], crypto_box_SEALBYTES + mlen[4],
+                                pk[4], sk[4]) == 0);
+    assert(memcmp(m2, m[4], (size_t) mlen[4]) == 0);
+    assert(crypto_box_seal_batch(c, (const unsigned char * const *) m, mlen,
+                                 pk_p, 0U) == 0);
+
+    for (i = 0U; i < 10U; i++) {
+        sodium_free(c[i]);
+        sodium_free(m[i]);
+    }
+    printf("batch: OK\n");
+}
+
+static
+void tv_ctx(void)
+{
+    crypto_box_seal_ctx ctx;
+    unsigned char       pk[3][crypto_box_PUBLICKEYBYTES];
+    unsigned char       sk[3][crypto_box_SECRETKEYBYTES];
+    unsigned char       c[4][crypto_box_SEALBYTES + 100];
+    unsigned char       m[100];
+    unsigned char       m2[100];
+    size_t              i;
+
+    randombytes_buf(m, sizeof m);
+    for (i = 0U; i < 3U; i++) {
+        crypto_box_keypair(pk[i], sk[i]);
+    }
+    assert(crypto_box_seal_ctx_init(&ctx, crypto_box_SEAL_CTX_BATCH_MAX + 1U,
+                                    0U, 0U) == -1 && errno == EINVAL);
+    assert(crypto_box_seal_ctx_init(&ctx, 0U,
+                                    crypto_box_SEAL_CTX_REUSE_MAX + 1U,
+                                    0U) == -1 && errno == EINVAL);
+
+    /* every ephemeral key is fresh, across several batches */
+    assert(crypto_box_seal_ctx_init(&ctx, 5U, 0U, 0U) == 0);
+    assert(crypto_box_seal_ctx_seal(&ctx, c[1], m, sizeof m, pk[0]) == 0);
+    for (i = 0U; i < 23U; i++) {
+        memcpy(c[0], c[1], sizeof c[0]);
+        assert(crypto_box_seal_ctx_seal(&ctx, c[1], m, i, pk[i % 2U]) == 0);
+        assert(memcmp(c[0], c[1], crypto_box_PUBLICKEYBYTES) != 0);
+        assert(crypto_box_seal_open(m2, c[1], crypto_box_SEALBYTES + i,
+                                    pk[i % 2U], sk[i % 2U]) == 0);
+        assert(memcmp(m, m2, i) == 0);
+    }
+    crypto_box_seal_ctx_free(&ctx);
+    crypto_box_seal_ctx_free(&ctx);
+
+    /* keys are shared between distinct recipients only */
+    assert(crypto_box_seal_ctx_init(&ctx, 0U, 2U, 3600U) == 0);
+    assert(crypto_box_seal_ctx_seal(&ctx, c[0], m, sizeof m, pk[0]) == 0);
+    assert(crypto_box_seal_ctx_seal(&ctx, c[1], m, sizeof m, pk[0]) == 0);
+    assert(crypto_box_seal_ctx_seal(&ctx, c[2], m, sizeof m, pk[1]) == 0);
+    assert(crypto_box_seal_ctx_seal(&ctx, c[3], m, sizeof m, pk[2]) == 0);
+    assert(memcmp(c[0], c[1], crypto_box_PUBLICKEYBYTES) != 0);
+    assert(memcmp(c[1], c[2], crypto_box_PUBLICKEYBYTES) == 0);
+    assert(memcmp(c[2], c[3], crypto_box_PUBLICKEYBYTES) != 0);
+    for (i = 0U; i < 4U; i++) {
+        size_t r = i < 2U ? 0U : i - 1U;
+
+        assert(crypto_box_seal_open(m2, c[i], sizeof c[i], pk[r], sk[r]) == 0);
+        assert(memcmp(m, m2, sizeof m) == 0);
+    }
+    crypto_box_seal_ctx_free(&ctx);
+
+    printf("ctx: OK\n");
+}
+
+static
+void tv_stream(void)
+{
+    crypto_secretstream_xchacha20poly1305_state st;
+    unsigned char       pk[crypto_box_PUBLICKEYBYTES];
+    unsigned char       sk[crypto_box_SECRETKEYBYTES];
+    unsigned char       pk2[crypto_box_PUBLICKEYBYTES];
+    unsigned char       sk2[crypto_box_SECRETKEYBYTES];
+    unsigned char       header[crypto_box_SEAL_STREAM_HEADERBYTES];
+    unsigned char       c[3][100 + crypto_secretstream_xchacha20poly1305_ABYTES];
+    unsigned char       m[3][100];
+    unsigned char       m2[100];
+    unsigned long long  mlen;
+    unsigned char       tag;
+    size_t              i;
+
+    assert(crypto_box_seal_stream_headerbytes() == crypto_box_SEAL_STREAM_HEADERBYTES);
+    crypto_box_keypair(pk, sk);
+    crypto_box_keypair(pk2, sk2);
+    randombytes_buf(m, sizeof m);
+
+    assert(crypto_box_seal_stream_init_push(&st, header, pk) == 0);
+    for (i = 0U; i < 3U; i++) {
+        assert(crypto_secretstream_xchacha20poly1305_push
+               (&st, c[i], NULL, m[i], sizeof m[i], NULL, 0U,
+                i == 2U ? crypto_secretstream_xchacha20poly1305_TAG_FINAL : 0U) == 0);
+    }
+
+    assert(crypto_box_seal_stream_init_pull(&st, header, pk, sk) == 0);
+    for (i = 0U; i < 3U; i++) {
+        assert(crypto_secretstream_xchacha20poly1305_pull
+               (&st, m2, &mlen, &tag, c[i], sizeof c[i], NULL, 0U) == 0);
+        assert(mlen == sizeof m[i]);
+        assert(memcmp(m2, m[i], sizeof m[i]) == 0);
+        assert(tag == (i == 2U ? crypto_secretstream_xchacha20poly1305_TAG_FINAL : 0U));
+    }
+
+    /* the wrong recipient, or a different public key, derive another key */
+    assert(crypto_box_seal_stream_init_pull(&st, header, pk2, sk2) == 0);
+    assert(crypto_secretstream_xchacha20poly1305_pull
+           (&st, m2, &mlen, &tag, c[0], sizeof c[0], NULL, 0U) == -1);
+    assert(crypto_box_seal_stream_init_pull(&st, header, pk2, sk) == 0);
+    assert(crypto_secretstream_xchacha20poly1305_pull
+           (&st, m2, &mlen, &tag, c[0], sizeof c[0], NULL, 0U) == -1);
+
+    /* a different ephemeral key */
+    header[0] ^= 1;
+    assert(crypto_box_seal_stream_init_pull(&st, header, pk, sk) == 0);
+    assert(crypto_secretstream_xchacha20poly1305_pull
+           (&st, m2, &mlen, &tag, c[0], sizeof c[0], NULL, 0U) == -1);
+
+    /* low-order points are rejected */
+    memset(header, 0, crypto_box_PUBLICKEYBYTES);
+    assert(crypto_box_seal_stream_init_pull(&st, header, pk, sk) == -1);
+    memset(pk2, 0, sizeof pk2);
+    assert(crypto_box_seal_stream_init_push(&st, header, pk2) == -1);
+
+    printf("stream: OK\n");
+}
+
 int
 main(void)
 {
@@ -160,6 +321,9 @@ main(void)
     tv2();
     tv3();
     tv4();
+    tv_batch();
+    tv_ctx();
+    tv_stream();
 
     return 0;
 }
@@ -165,11 +165,116 @@ void tv_ietf(void)
     printf("[%s]\n", out_hex);
 }
 
+static void
+parallel(void)
+{
+    unsigned char  key[crypto_stream_chacha20_ietf_KEYBYTES];
+    unsigned char  nonce[crypto_stream_chacha20_ietf_NONCEBYTES];
+    unsigned char *m;
+    unsigned char *c;
+    unsigned char *c_ietf;
+    unsigned char *c2;
+    size_t         mlen = 3 * 1024 * 1024 + 17;
+    unsigned int   threads;
+
+    m = (unsigned char *) sodium_malloc(mlen);
+    c = (unsigned char *) sodium_malloc(mlen);
+    c_ietf = (unsigned char *) sodium_malloc(mlen);
+    c2 = (unsigned char *) sodium_malloc(mlen);
+    randombytes_buf(key, sizeof key);
+    randombytes_buf(nonce, sizeof nonce);
+    randombytes_buf(m, mlen);
+
+    crypto_stream_chacha20_xor_ic(c, m, mlen, nonce, 0xfffffffffffff000ULL,
+                                  key);
+    crypto_stream_chacha20_ietf_xor_ic(c_ietf, m, mlen, nonce, 42U, key);
+    for (threads = 0U; threads <= 20U; threads += 5U) {
+        crypto_stream_chacha20_xor_ic_parallel(c2, m, mlen, nonce,
+                                               0xfffffffffffff000ULL, key,
+                                               threads);
+        assert(memcmp(c2, c, mlen) == 0);
+        crypto_stream_chacha20_ietf_xor_ic_parallel(c2, m, mlen, nonce, 42U,
+                                                    key, threads);
+        assert(memcmp(c2, c_ietf, mlen) == 0);
+    }
+    sodium_free(c2);
+    sodium_free(c_ietf);
+    sodium_free(c);
+    sodium_free(m);
+}
+
+static void
+reduced_rounds(void)
+{
+    static const char *chacha12_hex =
+        "9bf49a6a0755f953811fce125f2683d50429c3bb49e074147e0089a52eae155f"
+        "0564f879d27ae3c02ce82834acfa8c793a629f2ca0de6919610be82f411326be";
+    static const char *chacha8_hex =
+        "3e00ef2f895f40d67f5bb8e81f09a5a12c840ec3ce9a7f3b181be188ef711a1e"
+        "984ce172b9216f419f445367456d5619314a42a3da86b001387bfdb80e0cfe42";
+    unsigned char  key[crypto_stream_chacha12_KEYBYTES];
+    unsigned char  nonce[crypto_stream_chacha12_NONCEBYTES];
+    unsigned char  expected[64];
+    unsigned char *stream;
+    unsigned char *out;
+    size_t         len = 2000U;
+    size_t         off;
+
+    stream = (unsigned char *) sodium_malloc(len);
+    out = (unsigned char *) sodium_malloc(len);
+
+    memset(key, 0, sizeof key);
+    memset(nonce, 0, sizeof nonce);
+    sodium_hex2bin(expected, sizeof expected, chacha12_hex, strlen(chacha12_hex),
+                   NULL, NULL, NULL);
+    crypto_stream_chacha12(out, sizeof expected, nonce, key);
+    assert(memcmp(out, expected, sizeof expected) == 0);
+    sodium_hex2bin(expected, sizeof expected, chacha8_hex, strlen(chacha8_hex),
+                   NULL, NULL, NULL);
+    crypto_stream_chacha8(out, sizeof expected, nonce, key);
+    assert(memcmp(out, expected, sizeof expected) == 0);
+
+    crypto_stream_chacha12_keygen(key);
+    randombytes_buf(nonce, sizeof nonce);
+    crypto_stream_chacha12(stream, len, nonce, key);
+    for (off = 0U; off < len; off += 64U * 3U) {
+        memset(out, 0, len);
+        crypto_stream_chacha12_xor_ic(out, out, len - off, nonce, off / 64U,
+                                      key);
+        assert(memcmp(out, stream + off, len - off) == 0);
+    }
+    crypto_stream_chacha12_xor(out, stream, len, nonce, key);
+    assert(sodium_is_zero(out, len));
+
+    crypto_stream_chacha8_keygen(key);
+    crypto_stream_chacha8(stream, len, nonce, key);
+    for (off = 0U; off < len; off += 64U * 3U) {
+        memset(out, 0, len);
+        crypto_stream_chacha8_xor_ic(out, out, len - off, nonce, off / 64U,
+                                     key);
+        assert(memcmp(out, stream + off, len - off) == 0);
+    }
+    crypto_stream_chacha8_xor(out, stream, len, nonce, key);
+    assert(sodium_is_zero(out, len));
+
+    sodium_free(out);
+    sodium_free(stream);
+
+    assert(crypto_stream_chacha12_keybytes() == crypto_stream_chacha12_KEYBYTES);
+    assert(crypto_stream_chacha12_noncebytes() == crypto_stream_chacha12_NONCEBYTES);
+    assert(crypto_stream_chacha12_messagebytes_max() == crypto_stream_chacha12_MESSAGEBYTES_MAX);
+    assert(crypto_stream_chacha8_keybytes() == crypto_stream_chacha8_KEYBYTES);
+    assert(crypto_stream_chacha8_noncebytes() == crypto_stream_chacha8_NONCEBYTES);
+    assert(crypto_stream_chacha8_messagebytes_max() == crypto_stream_chacha8_MESSAGEBYTES_MAX);
+}
+
 int
 main(void)
 {
     tv();
     tv_ietf();
+    parallel();
+    reduced_rounds();
 
     assert(crypto_stream_chacha20_keybytes() > 0U);
     assert(crypto_stream_chacha20_keybytes() == crypto_stream_chacha20_KEYBYTES);
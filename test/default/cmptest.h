@@ -33,6 +33,11 @@
 # define rand(X) arc4random(X)
 #endif
 
+/* Runs before sodium_init(), e.g. to force an implementation */
+#ifndef TEST_BEFORE_INIT
+# define TEST_BEFORE_INIT() do { } while (0)
+#endif
+
 int xmain(void);
 
 static unsigned char *guard_page;
@@ -136,12 +141,13 @@ int main(void)
     unsigned long long ts_end;
     unsigned int       i;
 
+    TEST_BEFORE_INIT();
     if (sodium_init() != 0) {
         return 99;
     }
 
 #ifndef __EMSCRIPTEN__
-    randombytes_set_implementation(&randombytes_salsa20_implementation);
+    randombytes_set_implementation(&randombytes_internal_implementation);
 #endif
     ts_start = now();
     for (i = 0; i < ITERATIONS; i++) {
@@ -175,6 +181,7 @@ int main(void)
         perror("fopen(" TEST_NAME_RES ")");
         return 99;
     }
+    TEST_BEFORE_INIT();
     if (sodium_init() != 0) {
         return 99;
     }
@@ -213,6 +220,7 @@ int main(void)
 
 int main(void)
 {
+    TEST_BEFORE_INIT();
     if (sodium_init() != 0) {
         return 99;
     }
@@ -16,6 +16,8 @@ main(void)
     size_t         b64_len;
     size_t         bin_len;
     unsigned int   i;
+    sodium_base64_encode_state es0;
+    sodium_base64_decode_state ds0;
 
     printf("%s\n",
            sodium_bin2hex(buf3, 33U, (const unsigned char *) "0123456789ABCDEF",
@@ -241,5 +243,111 @@ main(void)
         sodium_free(bin);
         sodium_free(b64_);
     }
+
+    for (i = 0; i < 100; i++) {
+        char   hex_[2 * sizeof buf1 + 1];
+        size_t pos;
+
+        bin_len = 1U + (size_t) randombytes_uniform(sizeof buf1 / 2U);
+        bin = buf1 + sizeof buf1 / 2U;
+        randombytes_buf(buf1, bin_len);
+        sodium_bin2hex(hex_, sizeof hex_, buf1, bin_len);
+        pos = (size_t) randombytes_uniform((uint32_t) bin_len) * 2U;
+        assert(sodium_hex2bin(bin, bin_len, hex_, 2U * bin_len, NULL,
+                              &b64_len, NULL) == 0);
+        assert(b64_len == bin_len && memcmp(bin, buf1, bin_len) == 0);
+        hex_[pos] = 'g';
+        assert(sodium_hex2bin(bin, bin_len, hex_, 2U * bin_len, NULL,
+                              &b64_len, &hex_end) == 0);
+        assert(hex_end == &hex_[pos]);
+        assert(b64_len == pos / 2U);
+
+        sodium_bin2base64(hex_, sizeof hex_, buf1, bin_len,
+                          sodium_base64_VARIANT_ORIGINAL_NO_PADDING);
+        b64_len = strlen(hex_);
+        assert(sodium_base642bin(bin, bin_len, hex_, b64_len, NULL, &bin_len,
+                                 NULL, sodium_base64_VARIANT_ORIGINAL_NO_PADDING) == 0);
+        assert(memcmp(bin, buf1, bin_len) == 0);
+        pos = (size_t) randombytes_uniform((uint32_t) b64_len);
+        hex_[pos] = '*';
+        assert(sodium_base642bin(bin, sizeof buf1 / 2U, hex_, b64_len, NULL,
+                                 &bin_len, &b64_end,
+                                 sodium_base64_VARIANT_ORIGINAL_NO_PADDING) == -1 ||
+               b64_end == &hex_[pos]);
+    }
+
+    for (i = 0; i < 400; i++) {
+        static const int variants[4] = {
+            sodium_base64_VARIANT_ORIGINAL, sodium_base64_VARIANT_ORIGINAL_NO_PADDING,
+            sodium_base64_VARIANT_URLSAFE, sodium_base64_VARIANT_URLSAFE_NO_PADDING
+        };
+        sodium_base64_encode_state es;
+        sodium_base64_decode_state ds;
+        char                       ref[sizeof buf1 / 2U * 4U / 3U + 5U];
+        char                       out[sizeof ref];
+        unsigned char              dec[sizeof buf1 / 2U];
+        const int                  variant = variants[i & 3U];
+        size_t                     chunk, len, out_len, dec_len, pos;
+
+        bin_len = (size_t) randombytes_uniform(sizeof buf1 / 2U);
+        randombytes_buf(buf1, bin_len);
+        sodium_bin2base64(ref, sizeof ref, buf1, bin_len, variant);
+
+        assert(sodium_base64_encode_init(&es, variant) == 0);
+        out_len = 0U;
+        for (pos = 0U; pos < bin_len; pos += chunk) {
+            chunk = 1U + randombytes_uniform(40U);
+            if (chunk > bin_len - pos) {
+                chunk = bin_len - pos;
+            }
+            assert(sodium_base64_encode_update(&es, out + out_len,
+                                               (chunk + 2U) / 3U * 4U, &len,
+                                               buf1 + pos, chunk) == 0);
+            out_len += len;
+        }
+        assert(sodium_base64_encode_final(&es, out + out_len, 4U, &len) == 0);
+        out_len += len;
+        assert(out_len == strlen(ref));
+        assert(memcmp(out, ref, out_len) == 0);
+
+        assert(sodium_base64_decode_init(&ds, variant) == 0);
+        dec_len = 0U;
+        for (pos = 0U; pos < out_len; pos += chunk) {
+            chunk = 1U + randombytes_uniform(40U);
+            if (chunk > out_len - pos) {
+                chunk = out_len - pos;
+            }
+            assert(sodium_base64_decode_update(&ds, dec + dec_len,
+                                               chunk * 3U / 4U + 1U, &len,
+                                               out + pos, chunk, NULL) == 0);
+            dec_len += len;
+        }
+        assert(sodium_base64_decode_final(&ds) == 0);
+        assert(dec_len == bin_len);
+        assert(memcmp(dec, buf1, bin_len) == 0);
+
+        if (out_len > 0U) {
+            assert(sodium_base64_decode_init(&ds, variant) == 0);
+            out[randombytes_uniform((uint32_t) out_len)] = '*';
+            assert(sodium_base64_decode_update(&ds, dec, sizeof dec, &len,
+                                               out, out_len, NULL) == -1);
+        }
+    }
+    assert(sodium_base64_encode_init(&es0, sodium_base64_VARIANT_ORIGINAL) == 0);
+    assert(sodium_base64_encode_update(&es0, buf3, 3U, &b64_len,
+                                       buf1, 3U) == -1);
+    assert(sodium_base64_encode_update(&es0, buf3, 4U, &b64_len,
+                                       buf1, 2U) == 0 && b64_len == 0U);
+    assert(sodium_base64_encode_final(&es0, buf3, 3U, &b64_len) == -1);
+    assert(sodium_base64_decode_init(&ds0, sodium_base64_VARIANT_ORIGINAL) == 0);
+    assert(sodium_base64_decode_update(&ds0, buf4, sizeof buf4, &bin_len,
+                                       "YWI", 3U, NULL) == 0 && bin_len == 2U);
+    assert(sodium_base64_decode_final(&ds0) == -1);
+    assert(sodium_base64_decode_init(&ds0, sodium_base64_VARIANT_ORIGINAL) == 0);
+    assert(sodium_base64_decode_update(&ds0, buf4, sizeof buf4, &bin_len,
+                                       "YQ==", 4U, NULL) == 0 && bin_len == 1U);
+    assert(sodium_base64_decode_update(&ds0, buf4, sizeof buf4, &bin_len,
+                                       "=", 1U, NULL) == -1);
+
     return 0;
 }
@@ -78,6 +78,12 @@ main(void)
     }
     printf("\n");
 
+    crypto_stream_salsa2012_xor(output, output, output_len - 17, noncesuffix,
+                                secondkey);
+    for (pos = 0; pos < output_len - 17; pos++) {
+        assert(output[pos] == 0);
+    }
+
     pos = 0;
     do {
         do {
@@ -94,6 +100,12 @@ main(void)
         printf("%02x", h[i]);
     }
     printf("\n");
+
+    crypto_stream_salsa208_xor(output, output, output_len - 17, noncesuffix,
+                               secondkey);
+    for (pos = 0; pos < output_len - 17; pos++) {
+        assert(output[pos] == 0);
+    }
 #else
     printf("a4e3147dddd2ba7775939b50208a22eb3277d4e4bad8a1cfbc999c6bd392b638\n"
            "017421baa9959cbe894bd003ec87938254f47c1e757eb66cf89c353d0c2b68de\n");
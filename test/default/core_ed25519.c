@@ -61,6 +61,42 @@ add_l64(unsigned char * const S)
     sodium_add(S, l, sizeof l);
 }
 
+static void
+is_valid_point_vartime(void)
+{
+    static const unsigned char t8[32] = {
+        0x26, 0xe8, 0x95, 0x8f, 0xc2, 0xb2, 0x27, 0xb0, 0x45, 0xc3, 0xf4,
+        0x89, 0xf2, 0xef, 0x98, 0xf0, 0xd5, 0xdf, 0xac, 0x05, 0xd3, 0xc6,
+        0x33, 0x39, 0xb1, 0x38, 0x02, 0x88, 0x6d, 0x53, 0xfc, 0x05
+    };
+    unsigned char p[crypto_core_ed25519_BYTES];
+    unsigned char q[crypto_core_ed25519_BYTES];
+    unsigned int  i, j;
+
+    for (i = 0; i < 1000; i++) {
+        randombytes_buf(p, sizeof p);
+        assert(crypto_core_ed25519_is_valid_point_vartime(p) ==
+               crypto_core_ed25519_is_valid_point(p));
+    }
+    for (i = 0; i < 32; i++) {
+        crypto_core_ed25519_random(p);
+        memcpy(q, p, sizeof q);
+        for (j = 0; j < 8; j++) {
+            assert(crypto_core_ed25519_is_valid_point_vartime(q) ==
+                   crypto_core_ed25519_is_valid_point(q));
+            crypto_core_ed25519_add(q, q, t8);
+        }
+        assert(memcmp(p, q, sizeof q) == 0);
+    }
+    memcpy(q, t8, sizeof q);
+    for (j = 0; j < 8; j++) {
+        assert(crypto_core_ed25519_is_valid_point_vartime(q) == 0);
+        crypto_core_ed25519_add(q, q, t8);
+    }
+    assert(crypto_core_ed25519_is_valid_point_vartime(max_canonical_p) == 1);
+    assert(crypto_core_ed25519_is_valid_point_vartime(non_canonical_p) == 0);
+}
+
 int
 main(void)
 {
@@ -147,6 +183,7 @@ main(void)
     assert(crypto_core_ed25519_is_valid_point(max_canonical_p) == 1);
     assert(crypto_core_ed25519_is_valid_point(non_canonical_invalid_p) == 0);
     assert(crypto_core_ed25519_is_valid_point(non_canonical_p) == 0);
+    is_valid_point_vartime();
 
     memcpy(p2, p, crypto_core_ed25519_BYTES);
     add_P(p2);
@@ -60,6 +60,9 @@ main(void)
     unsigned char *expected_yr, *expected_y, *y;
     char *         expected_y_hex, *y_hex;
     char *         oversized_ctx;
+    unsigned char *batch;
+    const unsigned char *msgs[20];
+    size_t         msg_lens[20];
     size_t         i, j;
     size_t         oversized_ctx_len = 500U;
 
@@ -124,6 +127,35 @@ main(void)
                    crypto_core_ed25519_BYTES);
     printf("RO with oversized context: %s\n", y_hex);
 
+    batch = (unsigned char *) sodium_malloc(20U * crypto_core_ed25519_BYTES);
+    for (i = 0U; i < 20U; i++) {
+        msgs[i] = (const unsigned char *) test_data[i % 5U].msg + i / 5U;
+        msg_lens[i] = strlen(test_data[i % 5U].msg) - i / 5U;
+        if (msg_lens[i] > strlen(test_data[i % 5U].msg)) {
+            msgs[i] = guard_page;
+            msg_lens[i] = 0U;
+        }
+    }
+    for (j = 0U; j < 2U; j++) {
+        const char *ctx = j == 0U ? "ctx" : oversized_ctx;
+
+        assert(crypto_core_ed25519_from_string_batch(batch, ctx, msgs,
+                                                     msg_lens, 20U) == 0);
+        for (i = 0U; i < 20U; i++) {
+            crypto_core_ed25519_from_string(y, ctx, msgs[i], msg_lens[i]);
+            assert(memcmp(y, &batch[i * crypto_core_ed25519_BYTES],
+                          crypto_core_ed25519_BYTES) == 0);
+        }
+        assert(crypto_core_ed25519_from_string_ro_batch(batch, ctx, msgs,
+                                                        msg_lens, 20U) == 0);
+        for (i = 0U; i < 20U; i++) {
+            crypto_core_ed25519_from_string_ro(y, ctx, msgs[i], msg_lens[i]);
+            assert(memcmp(y, &batch[i * crypto_core_ed25519_BYTES],
+                          crypto_core_ed25519_BYTES) == 0);
+        }
+    }
+    sodium_free(batch);
+
     sodium_free(oversized_ctx);
     sodium_free(y_hex);
     sodium_free(expected_y_hex);
@@ -246,6 +246,161 @@ tv4(void)
     sodium_free(r);
 }
 
+static void
+tv5(void)
+{
+    unsigned char *p;
+    unsigned char *r;
+    unsigned char *r2;
+    size_t         count = 37U;
+    size_t         i;
+
+    p = (unsigned char *) sodium_malloc(count * crypto_core_ristretto255_BYTES);
+    r = (unsigned char *) sodium_malloc(count * crypto_core_ristretto255_BYTES);
+    r2 = (unsigned char *) sodium_malloc(crypto_core_ristretto255_BYTES);
+
+    for (i = 0U; i < count; i++) {
+        crypto_core_ristretto255_random(&p[i * crypto_core_ristretto255_BYTES]);
+    }
+    memset(&p[5U * crypto_core_ristretto255_BYTES], 0,
+           crypto_core_ristretto255_BYTES);
+    assert(crypto_core_ristretto255_double_batch(r, p, count) == 0);
+    for (i = 0U; i < count; i++) {
+        const unsigned char *pi = &p[i * crypto_core_ristretto255_BYTES];
+
+        assert(crypto_core_ristretto255_add(r2, pi, pi) == 0);
+        assert(memcmp(&r[i * crypto_core_ristretto255_BYTES], r2,
+                      crypto_core_ristretto255_BYTES) == 0);
+    }
+    assert(crypto_core_ristretto255_double_batch(r, p, 0U) == 0);
+
+    memset(&p[20U * crypto_core_ristretto255_BYTES], 0xfe,
+           crypto_core_ristretto255_BYTES);
+    assert(crypto_core_ristretto255_double_batch(r, p, count) == -1);
+
+    sodium_free(r2);
+    sodium_free(r);
+    sodium_free(p);
+}
+
+static void
+tv6(void)
+{
+    crypto_core_ristretto255_point *P, *Q, *R;
+    unsigned char                  *p, *q, *r, *r2, *n;
+    int                             i;
+
+    P  = (crypto_core_ristretto255_point *) sodium_malloc(sizeof *P);
+    Q  = (crypto_core_ristretto255_point *) sodium_malloc(sizeof *Q);
+    R  = (crypto_core_ristretto255_point *) sodium_malloc(sizeof *R);
+    p  = (unsigned char *) sodium_malloc(crypto_core_ristretto255_BYTES);
+    q  = (unsigned char *) sodium_malloc(crypto_core_ristretto255_BYTES);
+    r  = (unsigned char *) sodium_malloc(crypto_core_ristretto255_BYTES);
+    r2 = (unsigned char *) sodium_malloc(crypto_core_ristretto255_BYTES);
+    n  = (unsigned char *) sodium_malloc(crypto_core_ristretto255_SCALARBYTES);
+
+    crypto_core_ristretto255_random(p);
+    crypto_core_ristretto255_random(q);
+    memcpy(r, p, crypto_core_ristretto255_BYTES);
+    assert(crypto_core_ristretto255_point_frombytes(P, p) == 0);
+    assert(crypto_core_ristretto255_point_frombytes(Q, q) == 0);
+    assert(crypto_core_ristretto255_point_frombytes(R, p) == 0);
+    for (i = 0; i < 10; i++) {
+        crypto_core_ristretto255_point_add(R, R, Q);
+        crypto_core_ristretto255_point_dbl(R, R);
+        crypto_core_ristretto255_point_sub(R, R, P);
+        assert(crypto_core_ristretto255_add(r, r, q) == 0);
+        assert(crypto_core_ristretto255_add(r, r, r) == 0);
+        assert(crypto_core_ristretto255_sub(r, r, p) == 0);
+    }
+    crypto_core_ristretto255_point_tobytes(r2, R);
+    assert(memcmp(r, r2, crypto_core_ristretto255_BYTES) == 0);
+    assert(crypto_core_ristretto255_point_is_identity(R) == 0);
+
+    crypto_core_ristretto255_scalar_random(n);
+    assert(crypto_core_ristretto255_point_scalarmult(R, n, P) == 0);
+    crypto_core_ristretto255_point_tobytes(r2, R);
+    assert(crypto_scalarmult_ristretto255(r, n, p) == 0);
+    assert(memcmp(r, r2, crypto_core_ristretto255_BYTES) == 0);
+    assert(crypto_core_ristretto255_point_scalarmult_base(R, n) == 0);
+    crypto_core_ristretto255_point_tobytes(r2, R);
+    assert(crypto_scalarmult_ristretto255_base(r, n) == 0);
+    assert(memcmp(r, r2, crypto_core_ristretto255_BYTES) == 0);
+
+    crypto_core_ristretto255_point_sub(R, P, P);
+    assert(crypto_core_ristretto255_point_is_identity(R) == 1);
+    crypto_core_ristretto255_point_tobytes(r2, R);
+    assert(sodium_is_zero(r2, crypto_core_ristretto255_BYTES));
+    memset(n, 0, crypto_core_ristretto255_SCALARBYTES);
+    assert(crypto_core_ristretto255_point_scalarmult(R, n, P) == -1);
+    assert(crypto_core_ristretto255_point_scalarmult_base(R, n) == -1);
+    memset(r, 0, crypto_core_ristretto255_BYTES);
+    assert(crypto_core_ristretto255_point_frombytes(R, r) == 0);
+    assert(crypto_core_ristretto255_point_is_identity(R) == 1);
+    memset(r, 0xfe, crypto_core_ristretto255_BYTES);
+    assert(crypto_core_ristretto255_point_frombytes(R, r) == -1);
+
+    sodium_free(n);
+    sodium_free(r2);
+    sodium_free(r);
+    sodium_free(q);
+    sodium_free(p);
+    sodium_free(R);
+    sodium_free(Q);
+    sodium_free(P);
+}
+
+static void
+tv7(void)
+{
+    unsigned char *s;
+    unsigned char *r;
+    unsigned char *z;
+    unsigned char *t;
+    size_t         count = 21U;
+    size_t         i;
+
+    s = (unsigned char *) sodium_malloc(count * crypto_core_ristretto255_SCALARBYTES);
+    r = (unsigned char *) sodium_malloc(count * crypto_core_ristretto255_SCALARBYTES);
+    z = (unsigned char *) sodium_malloc(count * crypto_core_ristretto255_SCALARBYTES);
+    t = (unsigned char *) sodium_malloc(crypto_core_ristretto255_SCALARBYTES);
+
+    for (i = 0U; i < count; i++) {
+        crypto_core_ristretto255_scalar_random(&s[i * crypto_core_ristretto255_SCALARBYTES]);
+    }
+    assert(crypto_core_ristretto255_scalar_invert_batch(r, s, count) == 0);
+    crypto_core_ristretto255_scalar_mul_many(z, r, s, count);
+    for (i = 0U; i < count; i++) {
+        assert(crypto_core_ristretto255_scalar_invert
+               (t, &s[i * crypto_core_ristretto255_SCALARBYTES]) == 0);
+        assert(memcmp(t, &r[i * crypto_core_ristretto255_SCALARBYTES],
+                      crypto_core_ristretto255_SCALARBYTES) == 0);
+        assert(z[i * crypto_core_ristretto255_SCALARBYTES] == 1);
+        assert(sodium_is_zero(&z[i * crypto_core_ristretto255_SCALARBYTES + 1],
+                              crypto_core_ristretto255_SCALARBYTES - 1));
+    }
+
+    memset(&s[3 * crypto_core_ristretto255_SCALARBYTES], 0,
+           crypto_core_ristretto255_SCALARBYTES);
+    assert(crypto_core_ristretto255_scalar_invert_batch(s, s, count) == -1);
+    for (i = 0U; i < count; i++) {
+        if (i == 3U) {
+            assert(sodium_is_zero(&s[i * crypto_core_ristretto255_SCALARBYTES],
+                                  crypto_core_ristretto255_SCALARBYTES));
+        } else {
+            assert(memcmp(&s[i * crypto_core_ristretto255_SCALARBYTES],
+                          &r[i * crypto_core_ristretto255_SCALARBYTES],
+                          crypto_core_ristretto255_SCALARBYTES) == 0);
+        }
+    }
+    assert(crypto_core_ristretto255_scalar_invert_batch(r, s, 0U) == 0);
+
+    sodium_free(t);
+    sodium_free(z);
+    sodium_free(r);
+    sodium_free(s);
+}
+
 int
 main(void)
 {
@@ -253,8 +408,12 @@ main(void)
     tv2();
     tv3();
     tv4();
+    tv5();
+    tv6();
+    tv7();
 
     assert(crypto_core_ristretto255_BYTES == crypto_core_ristretto255_bytes());
+    assert(sizeof(crypto_core_ristretto255_point) == crypto_core_ristretto255_pointbytes());
     assert(crypto_core_ristretto255_SCALARBYTES == crypto_core_ristretto255_scalarbytes());
     assert(crypto_core_ristretto255_NONREDUCEDSCALARBYTES == crypto_core_ristretto255_nonreducedscalarbytes());
     assert(crypto_core_ristretto255_NONREDUCEDSCALARBYTES >= crypto_core_ristretto255_SCALARBYTES);
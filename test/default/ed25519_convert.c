@@ -8,6 +8,46 @@ static const unsigned char keypair_seed[crypto_sign_ed25519_SEEDBYTES] = {
     0xfa, 0xbe, 0x4d, 0x14, 0x51, 0xa5, 0x59, 0xfa, 0xed, 0xee
 };
 
+static void
+batch_convert(size_t count)
+{
+    unsigned char *seeds = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char *pks = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char *sks = (unsigned char *) sodium_malloc(count * 64U);
+    unsigned char *curve25519_pks = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char  pk[crypto_sign_ed25519_PUBLICKEYBYTES];
+    unsigned char  sk[crypto_sign_ed25519_SECRETKEYBYTES];
+    unsigned char  curve25519_pk[crypto_scalarmult_curve25519_BYTES];
+    size_t         i;
+
+    randombytes_buf(seeds, count * 32U);
+    assert(crypto_sign_ed25519_seed_keypair_batch(pks, sks, seeds, count) == 0);
+    assert(crypto_sign_ed25519_pk_to_curve25519_batch(curve25519_pks, pks,
+                                                      count) == 0);
+    for (i = 0U; i < count; i++) {
+        crypto_sign_ed25519_seed_keypair(pk, sk, &seeds[i * 32U]);
+        assert(memcmp(pk, &pks[i * 32U], sizeof pk) == 0);
+        assert(memcmp(sk, &sks[i * 64U], sizeof sk) == 0);
+        assert(crypto_sign_ed25519_pk_to_curve25519(curve25519_pk, pk) == 0);
+        assert(memcmp(curve25519_pk, &curve25519_pks[i * 32U],
+                      sizeof curve25519_pk) == 0);
+    }
+    memset(&pks[(count / 2U) * 32U], 0, 32U);
+    assert(crypto_sign_ed25519_pk_to_curve25519_batch(curve25519_pks, pks,
+                                                      count) == -1);
+    assert(sodium_is_zero(&curve25519_pks[(count / 2U) * 32U], 32U) == 1);
+    if (count > 1U) {
+        assert(crypto_sign_ed25519_pk_to_curve25519(curve25519_pk, pks) == 0);
+        assert(memcmp(curve25519_pk, curve25519_pks,
+                      sizeof curve25519_pk) == 0);
+    }
+
+    sodium_free(curve25519_pks);
+    sodium_free(sks);
+    sodium_free(pks);
+    sodium_free(seeds);
+}
+
 int
 main(void)
 {
@@ -64,6 +104,9 @@ main(void)
                    64, NULL, NULL, NULL);
     assert(crypto_sign_ed25519_pk_to_curve25519(curve25519_pk, ed25519_pk) == -1);
 
+    batch_convert(1U);
+    batch_convert(77U);
+
     printf("ok\n");
 
     return 0;
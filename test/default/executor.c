@@ -0,0 +1,90 @@
+
+#define TEST_NAME "executor"
+#include "cmptest.h"
+
+#define MLEN (4U * 1024U * 1024U)
+
+static int submitted;
+static int waited;
+static int declined;
+
+/* Runs each task as it is submitted */
+static void *
+inline_submit(void *ctx, sodium_executor_fn fn, void *arg)
+{
+    (void) ctx;
+    if (declined) {
+        return NULL;
+    }
+    fn(arg);
+    submitted++;
+
+    return &submitted;
+}
+
+static void
+inline_wait(void *ctx, void *handle)
+{
+    assert(ctx == &waited);
+    assert(handle == &submitted);
+    waited++;
+}
+
+int
+main(void)
+{
+    unsigned char *m  = (unsigned char *) sodium_malloc(MLEN);
+    unsigned char *c  = (unsigned char *) sodium_malloc(MLEN);
+    unsigned char *c2 = (unsigned char *) sodium_malloc(MLEN);
+    unsigned char  k[crypto_stream_chacha20_KEYBYTES];
+    unsigned char  n[crypto_stream_chacha20_NONCEBYTES];
+
+    randombytes_buf(m, MLEN);
+    randombytes_buf(k, sizeof k);
+    randombytes_buf(n, sizeof n);
+    crypto_stream_chacha20_xor_ic(c, m, MLEN, n, 0U, k);
+
+    assert(sodium_set_executor(inline_submit, NULL, NULL, 0U) == -1);
+    assert(sodium_set_executor(NULL, inline_wait, NULL, 0U) == -1);
+
+    assert(sodium_set_executor(inline_submit, inline_wait, &waited, 0U) == 0);
+    crypto_stream_chacha20_xor_ic_parallel(c2, m, MLEN, n, 0U, k, 8U);
+    assert(memcmp(c, c2, MLEN) == 0);
+    assert(submitted == 7 && waited == 7);
+
+    assert(sodium_set_executor(inline_submit, inline_wait, &waited, 3U) == 0);
+    submitted = waited = 0;
+    memset(c2, 0, MLEN);
+    crypto_stream_chacha20_xor_ic_parallel(c2, m, MLEN, n, 0U, k, 8U);
+    assert(memcmp(c, c2, MLEN) == 0);
+    assert(submitted == 2 && waited == 2);
+
+    /* declined tasks run on the calling thread */
+    submitted = waited = 0;
+    declined  = 1;
+    memset(c2, 0, MLEN);
+    crypto_stream_chacha20_xor_ic_parallel(c2, m, MLEN, n, 0U, k, 8U);
+    assert(memcmp(c, c2, MLEN) == 0);
+    assert(submitted == 0 && waited == 0);
+    declined = 0;
+
+    assert(sodium_set_executor(inline_submit, inline_wait, &waited, 1U) == 0);
+    memset(c2, 0, MLEN);
+    crypto_stream_chacha20_xor_ic_parallel(c2, m, MLEN, n, 0U, k, 8U);
+    assert(memcmp(c, c2, MLEN) == 0);
+    assert(submitted == 0 && waited == 0);
+
+    assert(sodium_set_executor(NULL, NULL, NULL, 0U) == 0);
+    memset(c2, 0, MLEN);
+    crypto_stream_chacha20_xor_ic_parallel(c2, m, MLEN, n, 0U, k, 8U);
+    assert(memcmp(c, c2, MLEN) == 0);
+    assert(submitted == 0 && waited == 0);
+
+    sodium_free(m);
+    sodium_free(c);
+    sodium_free(c2);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+
+#define TEST_NAME "file"
+#include "cmptest.h"
+
+static void
+tv(unsigned int algorithm, size_t chunk_bytes, size_t mlen,
+   unsigned int threads)
+{
+    crypto_file_state  state;
+    crypto_file_state  state2;
+    unsigned char      header[crypto_file_HEADERBYTES];
+    unsigned char      k[crypto_file_KEYBYTES];
+    unsigned char     *m;
+    unsigned char     *m2;
+    unsigned char     *c;
+    unsigned char     *c2;
+    unsigned long long clen;
+    unsigned long long clen2;
+    unsigned long long mlen2;
+    size_t             split;
+    size_t             offset;
+    size_t             len;
+    int                i;
+
+    crypto_file_keygen(k);
+    assert(crypto_file_init_push(&state, header, k, algorithm,
+                                 chunk_bytes) == 0);
+    assert(crypto_file_state_chunkbytes(&state) == chunk_bytes);
+    clen = crypto_file_ciphertext_length(&state, mlen);
+    assert(crypto_file_plaintext_length(&state, &mlen2, clen) == 0);
+    assert(mlen2 == mlen);
+
+    m  = (unsigned char *) sodium_malloc(mlen + 1U);
+    m2 = (unsigned char *) sodium_malloc(mlen + 1U);
+    c  = (unsigned char *) sodium_malloc((size_t) clen);
+    c2 = (unsigned char *) sodium_malloc((size_t) clen);
+    randombytes_buf(m, mlen);
+    assert(crypto_file_pwrite(&state, c, m, mlen, 0U, 1, threads) == 0);
+
+    /* writing the file in two parts produces the same chunks */
+    split = (mlen / 2U) / chunk_bytes * chunk_bytes;
+    assert(crypto_file_pwrite(&state, c2, m, split, 0U, 0, threads) == 0);
+    assert(crypto_file_pwrite(&state, c2, m + split, mlen - split, split, 1,
+                              threads) == 0);
+    assert(memcmp(c, c2, (size_t) clen) == 0);
+
+    assert(crypto_file_init_pull(&state2, header, k) == 0);
+    assert(crypto_file_pread(&state2, m2, mlen, 0U, c, clen, threads) == 0);
+    assert(memcmp(m, m2, mlen) == 0);
+    for (i = 0; i < 20; i++) {
+        offset = (size_t) randombytes_uniform((uint32_t) mlen + 1U);
+        len    = (size_t) randombytes_uniform((uint32_t) (mlen - offset) + 1U);
+        assert(crypto_file_pread(&state2, m2, len, offset, c, clen,
+                                 threads) == 0);
+        assert(memcmp(m + offset, m2, len) == 0);
+    }
+    assert(crypto_file_pread(&state2, m2, 1U, mlen, c, clen, threads) == -1);
+
+    /* truncated files are rejected */
+    if (mlen > chunk_bytes) {
+        clen2 = clen - (clen - 1U) % (chunk_bytes + crypto_file_ABYTES) - 1U;
+        assert(crypto_file_plaintext_length(&state2, &mlen2, clen2) == 0);
+        assert(crypto_file_pread(&state2, m2, (size_t) mlen2, 0U, c, clen2,
+                                 threads) == -1);
+    }
+    /* and so are modified chunks */
+    c[randombytes_uniform((uint32_t) clen)] ^= 0x01;
+    if (mlen > 0U) {
+        assert(crypto_file_pread(&state2, m2, mlen, 0U, c, clen,
+                                 threads) == -1);
+    } else {
+        assert(crypto_file_decrypt_chunk(&state2, m2, c, (size_t) clen, 0U,
+                                         1) == -1);
+    }
+
+    header[randombytes_uniform(crypto_file_HEADERBYTES)] ^= 0x01;
+    assert(crypto_file_init_pull(&state2, header, k) == -1);
+
+    sodium_free(m);
+    sodium_free(m2);
+    sodium_free(c);
+    sodium_free(c2);
+}
+
+int
+main(void)
+{
+    static const size_t lens[] = { 0U, 1U, 63U, 64U, 65U, 1000U, 4096U,
+                                   100000U };
+    crypto_file_state   state;
+    unsigned char       header[crypto_file_HEADERBYTES];
+    unsigned char       k[crypto_file_KEYBYTES];
+    unsigned char       k2[crypto_file_KEYBYTES];
+    unsigned char       c[128U + crypto_file_ABYTES];
+    unsigned char       m[128U];
+    unsigned long long  mlen;
+    size_t              i;
+
+    for (i = 0U; i < sizeof lens / sizeof lens[0]; i++) {
+        tv(crypto_file_ALG_XCHACHA20POLY1305, 64U, lens[i], 1U);
+        tv(crypto_file_ALG_AEGIS256, 64U, lens[i], 2U);
+        tv(crypto_file_ALG_XCHACHA20POLY1305, 4096U, lens[i], 4U);
+        tv(crypto_file_ALG_AEGIS256, crypto_file_CHUNKBYTES, lens[i], 1U);
+    }
+    tv(crypto_file_ALG_XCHACHA20POLY1305, crypto_file_CHUNKBYTES, 5000000U, 4U);
+    tv(crypto_file_ALG_AEGIS256, crypto_file_CHUNKBYTES, 5000000U, 8U);
+
+    crypto_file_keygen(k);
+    crypto_file_keygen(k2);
+    assert(crypto_file_init_push(&state, header, k, 0U, 64U) == -1);
+    assert(crypto_file_init_push(&state, header, k,
+                                 crypto_file_ALG_AEGIS256, 63U) == -1);
+    assert(crypto_file_init_push(&state, header, k, crypto_file_ALG_AEGIS256,
+                                 crypto_file_CHUNKBYTES_MAX + 1U) == -1);
+    assert(crypto_file_init_push(&state, header, k,
+                                 crypto_file_ALG_AEGIS256, 128U) == 0);
+    assert(crypto_file_init_pull(&state, header, k2) == -1);
+    assert(crypto_file_init_pull(&state, header, k) == 0);
+
+    assert(crypto_file_plaintext_length(&state, &mlen, 0U) == -1);
+    assert(crypto_file_plaintext_length(&state, &mlen, 15U) == -1);
+    assert(crypto_file_plaintext_length(&state, &mlen, 144U + 15U) == -1);
+    assert(crypto_file_plaintext_length(&state, &mlen, 144U + 16U) == 0);
+    assert(mlen == 128U);
+
+    memset(m, 0x42, sizeof m);
+    assert(crypto_file_encrypt_chunk(&state, c, m, 127U, 0U, 0) == -1);
+    assert(crypto_file_encrypt_chunk(&state, c, m, 129U, 0U, 1) == -1);
+    assert(crypto_file_encrypt_chunk(&state, c, m, 128U, 0U, 0) == 0);
+    assert(crypto_file_decrypt_chunk(&state, m, c, sizeof c, 0U, 1) == -1);
+    assert(crypto_file_decrypt_chunk(&state, m, c, sizeof c, 1U, 0) == -1);
+    assert(crypto_file_decrypt_chunk(&state, m, c, sizeof c, 0U, 0) == 0);
+    assert(crypto_file_decrypt_chunk(&state, m, c, 15U, 0U, 1) == -1);
+    assert(crypto_file_pwrite(&state, c, m, 128U, 1U, 1, 1U) == -1);
+    assert(crypto_file_pwrite(&state, c, m, 100U, 0U, 0, 1U) == -1);
+
+    assert(crypto_file_keybytes() == crypto_file_KEYBYTES);
+    assert(crypto_file_headerbytes() == crypto_file_HEADERBYTES);
+    assert(crypto_file_abytes() == crypto_file_ABYTES);
+    assert(crypto_file_chunkbytes_min() == crypto_file_CHUNKBYTES_MIN);
+    assert(crypto_file_chunkbytes_max() == crypto_file_CHUNKBYTES_MAX);
+    assert(crypto_file_chunkbytes() == crypto_file_CHUNKBYTES);
+    assert(crypto_file_statebytes() == sizeof(crypto_file_state));
+
+    printf("OK\n");
+
+    return 0;
+}
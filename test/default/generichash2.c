@@ -43,6 +43,62 @@ main(void)
         }
     }
 
+    {
+        crypto_generichash_state *st2;
+        unsigned char             msg[300];
+        unsigned char             out2[crypto_generichash_BYTES];
+
+        st2 = (crypto_generichash_state *)
+            sodium_malloc(crypto_generichash_statebytes());
+        for (i = 0; i < sizeof msg; ++i) {
+            msg[i] = (unsigned char) (i * 7);
+        }
+        assert(crypto_generichash_init(st, k, sizeof k, sizeof out2) == 0);
+        for (i = 0; i < sizeof msg; i += 37) {
+            crypto_generichash_state_clone(st2, st);
+            crypto_generichash_update(st2, msg, i);
+            assert(crypto_generichash_final(st2, out2, sizeof out2) == 0);
+            crypto_generichash(out, sizeof out2, msg, i, k, sizeof k);
+            assert(memcmp(out, out2, sizeof out2) == 0);
+        }
+        crypto_generichash_update(st, msg, 150);
+        for (i = 0; i < 150; i += 37) {
+            crypto_generichash_state_clone(st2, st);
+            crypto_generichash_update(st2, msg + 150, i);
+            assert(crypto_generichash_final(st2, out2, sizeof out2) == 0);
+            crypto_generichash(out, sizeof out2, msg, 150 + i, k, sizeof k);
+            assert(memcmp(out, out2, sizeof out2) == 0);
+        }
+        sodium_free(st2);
+    }
+
+    /* the same message, hashed in chunks of any size and alignment */
+    {
+        unsigned char *msg = (unsigned char *) sodium_malloc(2000U);
+        unsigned char  out2[crypto_generichash_BYTES];
+        size_t         len, off, chunk;
+
+        randombytes_buf(msg, 2000U);
+        for (i = 0; i < 200U; i++) {
+            len = (size_t) randombytes_uniform(2000U);
+            h   = (size_t) randombytes_uniform(2U) * sizeof k;
+            crypto_generichash(out, sizeof out2, msg, len, k, h);
+            crypto_generichash_init(st, k, h, sizeof out2);
+            for (off = 0U; off < len; off += chunk) {
+                chunk = 1U + (size_t) randombytes_uniform
+                    (i % 2U == 0U ? 300U : 600U);
+                if (chunk > len - off) {
+                    chunk = len - off;
+                }
+                crypto_generichash_update(st, msg + off, chunk);
+                crypto_generichash_update(st, msg, 0U);
+            }
+            crypto_generichash_final(st, out2, sizeof out2);
+            assert(memcmp(out, out2, sizeof out2) == 0);
+        }
+        sodium_free(msg);
+    }
+
     assert(crypto_generichash_init(st, k, sizeof k, 0U) == -1);
     assert(crypto_generichash_init(st, k, sizeof k,
                                    crypto_generichash_BYTES_MAX + 1U) == -1);
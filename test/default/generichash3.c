@@ -172,5 +172,38 @@ main(void)
                                                          NULL, personal) == 0);
     assert(crypto_generichash_blake2b_init_salt_personal(&st, k, sizeof k, crypto_generichash_BYTES,
                                                          salt, NULL) == 0);
+
+    /* single-block messages take a shortcut in the one-shot API */
+    {
+        unsigned char in2[2 * crypto_generichash_blake2b_BYTES_MAX + 2];
+        unsigned char out2[crypto_generichash_blake2b_BYTES_MAX];
+        size_t        outlen;
+
+        for (i = 0; i < sizeof in2; ++i) {
+            in2[i] = (unsigned char) (i * 7);
+        }
+        for (i = 0; i <= sizeof in2; ++i) {
+            for (h = 0; h < 2; ++h) {
+                outlen = 1 + i % crypto_generichash_blake2b_BYTES_MAX;
+                crypto_generichash_blake2b_salt_personal(
+                    out, outlen, in2, (unsigned long long) i, h ? k : NULL,
+                    h ? sizeof k : 0U, h ? salt : NULL, personal);
+                crypto_generichash_blake2b_init_salt_personal(
+                    &st, h ? k : NULL, h ? sizeof k : 0U, outlen,
+                    h ? salt : NULL, personal);
+                crypto_generichash_blake2b_update(&st, in2,
+                                                  (unsigned long long) i);
+                crypto_generichash_blake2b_final(&st, out2, outlen);
+                assert(memcmp(out, out2, outlen) == 0);
+                crypto_generichash(out, outlen, in2, (unsigned long long) i,
+                                   h ? k : NULL, h ? sizeof k : 0U);
+                crypto_generichash_init(&st, h ? k : NULL, h ? sizeof k : 0U,
+                                        outlen);
+                crypto_generichash_update(&st, in2, (unsigned long long) i);
+                crypto_generichash_final(&st, out2, outlen);
+                assert(memcmp(out, out2, outlen) == 0);
+            }
+        }
+    }
     return 0;
 }
@@ -0,0 +1,72 @@
+
+#define TEST_NAME "generichash4"
+#include "cmptest.h"
+
+#define COUNT  37
+#define MAXLEN 600
+
+static void
+tv_multi(const unsigned char *key, size_t keylen, size_t outlen)
+{
+    unsigned char       *m[COUNT];
+    unsigned char       *out[COUNT];
+    const unsigned char *m_p[COUNT];
+    unsigned long long   mlen[COUNT];
+    unsigned char        expected[crypto_generichash_blake2b_BYTES_MAX];
+    size_t               count;
+    size_t               i;
+
+    for (i = 0U; i < COUNT; i++) {
+        mlen[i] = (unsigned long long) randombytes_uniform(MAXLEN);
+        if (i < 3U) {
+            mlen[i] = (unsigned long long) (i * crypto_generichash_blake2b_BYTES_MAX * 2U);
+        }
+        m[i]   = (unsigned char *) sodium_malloc((size_t) mlen[i]);
+        out[i] = (unsigned char *) sodium_malloc(outlen);
+        randombytes_buf(m[i], (size_t) mlen[i]);
+        m_p[i] = m[i];
+    }
+    for (count = 0U; count <= COUNT; count += 1U + randombytes_uniform(9)) {
+        assert(crypto_generichash_blake2b_multi(out, outlen, m_p, mlen, count,
+                                                key, keylen) == 0);
+        for (i = 0U; i < count; i++) {
+            assert(crypto_generichash_blake2b(expected, outlen, m[i], mlen[i],
+                                              key, keylen) == 0);
+            assert(memcmp(out[i], expected, outlen) == 0);
+        }
+    }
+    for (i = 0U; i < COUNT; i++) {
+        sodium_free(m[i]);
+        sodium_free(out[i]);
+    }
+}
+
+int
+main(void)
+{
+    unsigned char        k[crypto_generichash_blake2b_KEYBYTES_MAX];
+    unsigned char        out[crypto_generichash_blake2b_BYTES_MAX];
+    unsigned char       *out_p[1];
+    const unsigned char *in_p[1];
+    unsigned long long   inlen[1];
+
+    randombytes_buf(k, sizeof k);
+    tv_multi(NULL, 0U, crypto_generichash_blake2b_BYTES);
+    tv_multi(k, crypto_generichash_blake2b_KEYBYTES, crypto_generichash_blake2b_BYTES);
+    tv_multi(k, sizeof k, crypto_generichash_blake2b_BYTES_MAX);
+    tv_multi(k, 1U, 1U);
+
+    out_p[0] = out;
+    in_p[0]  = k;
+    inlen[0] = sizeof k;
+    assert(crypto_generichash_blake2b_multi(out_p, 0U, in_p, inlen, 1U,
+                                            NULL, 0U) == -1);
+    assert(crypto_generichash_blake2b_multi(out_p, sizeof out + 1U, in_p,
+                                            inlen, 1U, NULL, 0U) == -1);
+    assert(crypto_generichash_blake2b_multi(out_p, sizeof out, in_p, inlen,
+                                            1U, k, sizeof k + 1U) == -1);
+
+    printf("tv_multi: ok\n");
+
+    return 0;
+}
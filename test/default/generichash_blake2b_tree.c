@@ -0,0 +1,138 @@
+
+#define TEST_NAME "generichash_blake2b_tree"
+#include "cmptest.h"
+
+#define MAXLEN 5017U
+
+static unsigned char msg[MAXLEN];
+static unsigned char msg2[MAXLEN];
+
+static void
+print_root(const unsigned char *tree, size_t tree_len, size_t outlen)
+{
+    unsigned char out[crypto_generichash_blake2b_tree_BYTES_MAX];
+    char          hex[crypto_generichash_blake2b_tree_BYTES_MAX * 2 + 1];
+
+    assert(crypto_generichash_blake2b_tree_root(out, outlen, tree,
+                                                tree_len) == 0);
+    printf("%s\n", sodium_bin2hex(hex, sizeof hex, out, outlen));
+}
+
+static void
+tv(size_t inlen, size_t leaf_length, const unsigned char *key, size_t keylen,
+   size_t outlen)
+{
+    unsigned char *tree;
+    unsigned char *tree2;
+    size_t         tree_len;
+    size_t         leaves;
+    size_t         i;
+    size_t         j;
+    size_t         len;
+
+    tree_len = crypto_generichash_blake2b_tree_treebytes(inlen, leaf_length);
+    assert(tree_len > 0U);
+    tree  = (unsigned char *) sodium_malloc(tree_len);
+    tree2 = (unsigned char *) sodium_malloc(tree_len);
+    assert(crypto_generichash_blake2b_tree_init(tree, tree_len, msg, inlen,
+                                                leaf_length, key, keylen,
+                                                outlen) == 0);
+    print_root(tree, tree_len, outlen);
+
+    memcpy(msg2, msg, inlen);
+    leaves = (inlen + leaf_length - 1U) / leaf_length;
+    for (i = 0U; i < leaves; i += 7U) {
+        len = inlen - i * leaf_length;
+        if (len > leaf_length) {
+            len = leaf_length;
+        }
+        for (j = 0U; j < len; j++) {
+            msg2[i * leaf_length + j] ^= 0xff;
+        }
+        assert(crypto_generichash_blake2b_tree_update_leaf(
+                   tree, tree_len, i, msg2 + i * leaf_length, len, key,
+                   keylen) == 0);
+    }
+    print_root(tree, tree_len, outlen);
+    assert(crypto_generichash_blake2b_tree_init(tree2, tree_len, msg2, inlen,
+                                                leaf_length, key, keylen,
+                                                outlen) == 0);
+    assert(memcmp(tree, tree2, tree_len) == 0);
+
+    sodium_free(tree);
+    sodium_free(tree2);
+}
+
+int
+main(void)
+{
+    unsigned char key[crypto_generichash_blake2b_tree_KEYBYTES_MAX];
+    unsigned char tree[1024];
+    unsigned char out[crypto_generichash_blake2b_tree_BYTES_MAX];
+    size_t        tree_len;
+    size_t        i;
+
+    for (i = 0U; i < sizeof key; i++) {
+        key[i] = (unsigned char) i;
+    }
+    for (i = 0U; i < MAXLEN; i++) {
+        msg[i] = (unsigned char) (i * 7U + 3U);
+    }
+    tv(0U, 128U, NULL, 0U, 32U);
+    tv(100U, 128U, key, 32U, 64U);
+    tv(128U, 128U, NULL, 0U, 16U);
+    tv(129U, 128U, key, 16U, 32U);
+    tv(MAXLEN, 256U, NULL, 0U, 32U);
+    tv(MAXLEN, 256U, key, 64U, 64U);
+    tv(MAXLEN, 1000U, key, 32U, 32U);
+    tv(4096U, 128U, NULL, 0U, 32U);
+
+    tree_len = crypto_generichash_blake2b_tree_treebytes(1000U, 128U);
+    assert(tree_len > 0U && tree_len <= sizeof tree);
+    assert(crypto_generichash_blake2b_tree_treebytes(1000U, 127U) == 0U);
+    assert(crypto_generichash_blake2b_tree_init(tree, tree_len - 1U, msg,
+                                                1000U, 128U, NULL, 0U,
+                                                32U) == -1);
+    assert(crypto_generichash_blake2b_tree_init(tree, tree_len, msg, 1000U,
+                                                128U, NULL, 0U, 15U) == -1);
+    assert(crypto_generichash_blake2b_tree_init(tree, tree_len, msg, 1000U,
+                                                128U, NULL, 1U, 32U) == -1);
+    assert(crypto_generichash_blake2b_tree_init(tree, tree_len, msg, 1000U,
+                                                128U, NULL, 0U, 32U) == 0);
+    assert(crypto_generichash_blake2b_tree_update_leaf(tree, tree_len, 8U,
+                                                       msg, 128U, NULL,
+                                                       0U) == -1);
+    assert(crypto_generichash_blake2b_tree_update_leaf(tree, tree_len, 7U,
+                                                       msg, 128U, NULL,
+                                                       0U) == -1);
+    assert(crypto_generichash_blake2b_tree_update_leaf(tree, tree_len, 7U,
+                                                       msg, 104U, NULL,
+                                                       0U) == 0);
+    assert(crypto_generichash_blake2b_tree_update_leaf(tree, tree_len, 0U,
+                                                       msg, 128U, key,
+                                                       32U) == -1);
+    assert(crypto_generichash_blake2b_tree_root(out, 64U, tree,
+                                                tree_len) == -1);
+    assert(crypto_generichash_blake2b_tree_root(out, 32U, tree,
+                                                tree_len - 1U) == -1);
+    tree[15] = 1U;
+    assert(crypto_generichash_blake2b_tree_root(out, 32U, tree,
+                                                tree_len) == -1);
+
+    assert(crypto_generichash_blake2b_tree_bytes_min() ==
+           crypto_generichash_blake2b_tree_BYTES_MIN);
+    assert(crypto_generichash_blake2b_tree_bytes_max() ==
+           crypto_generichash_blake2b_tree_BYTES_MAX);
+    assert(crypto_generichash_blake2b_tree_keybytes_min() ==
+           crypto_generichash_blake2b_tree_KEYBYTES_MIN);
+    assert(crypto_generichash_blake2b_tree_keybytes_max() ==
+           crypto_generichash_blake2b_tree_KEYBYTES_MAX);
+    assert(crypto_generichash_blake2b_tree_leafbytes_min() ==
+           crypto_generichash_blake2b_tree_LEAFBYTES_MIN);
+    assert(crypto_generichash_blake2b_tree_leafbytes_max() ==
+           crypto_generichash_blake2b_tree_LEAFBYTES_MAX);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+
+#define TEST_NAME "generichash_blake2bp"
+#include "cmptest.h"
+
+#define MAXLEN 2048
+
+static const size_t lens[] = { 0, 1, 127, 128, 129, 511, 512, 513, 640, 1024,
+                               1025, 1151, 1537, MAXLEN };
+
+int
+main(void)
+{
+    crypto_generichash_blake2bp_state st;
+    unsigned char                     in[MAXLEN];
+    unsigned char                     out[crypto_generichash_blake2bp_BYTES_MAX];
+    unsigned char                     out2[crypto_generichash_blake2bp_BYTES_MAX];
+    unsigned char                     k[crypto_generichash_blake2bp_KEYBYTES_MAX];
+    char                              hex[2 * crypto_generichash_blake2bp_BYTES_MAX + 1];
+    size_t                            i;
+    size_t                            l;
+    size_t                            off;
+    size_t                            chunk;
+
+    for (i = 0U; i < sizeof in; i++) {
+        in[i] = (unsigned char) i;
+    }
+    for (i = 0U; i < sizeof k; i++) {
+        k[i] = (unsigned char) i;
+    }
+    crypto_generichash_blake2bp(out, sizeof out, in, 0U, NULL, 0U);
+    sodium_bin2hex(hex, sizeof hex, out, sizeof out);
+    printf("%s\n", hex);
+    for (l = 0U; l < sizeof lens / sizeof lens[0]; l++) {
+        assert(crypto_generichash_blake2bp(out, sizeof out, in, lens[l],
+                                           k, sizeof k) == 0);
+        sodium_bin2hex(hex, sizeof hex, out, sizeof out);
+        printf("%s\n", hex);
+
+        assert(crypto_generichash_blake2bp_init(&st, k, sizeof k,
+                                                sizeof out2) == 0);
+        for (off = 0U; off < lens[l]; off += chunk) {
+            chunk = (size_t) randombytes_uniform(700U);
+            if (chunk > lens[l] - off) {
+                chunk = lens[l] - off;
+            }
+            assert(crypto_generichash_blake2bp_update(&st, in + off, chunk) == 0);
+        }
+        assert(crypto_generichash_blake2bp_final(&st, out2, sizeof out2) == 0);
+        assert(memcmp(out, out2, sizeof out) == 0);
+    }
+    assert(crypto_generichash_blake2bp(out, crypto_generichash_blake2bp_BYTES,
+                                       in, sizeof in, NULL, 0U) == 0);
+    sodium_bin2hex(hex, sizeof hex, out, crypto_generichash_blake2bp_BYTES);
+    printf("%s\n", hex);
+
+    assert(crypto_generichash_blake2bp(out, 0U, in, sizeof in, NULL, 0U) == -1);
+    assert(crypto_generichash_blake2bp(out, sizeof out + 1U, in, sizeof in,
+                                       NULL, 0U) == -1);
+    assert(crypto_generichash_blake2bp(out, sizeof out, in, sizeof in,
+                                       k, sizeof k + 1U) == -1);
+    assert(crypto_generichash_blake2bp_init(&st, NULL, 0U, 0U) == -1);
+
+    assert(crypto_generichash_blake2bp_bytes_min() == crypto_generichash_blake2bp_BYTES_MIN);
+    assert(crypto_generichash_blake2bp_bytes_max() == crypto_generichash_blake2bp_BYTES_MAX);
+    assert(crypto_generichash_blake2bp_bytes() == crypto_generichash_blake2bp_BYTES);
+    assert(crypto_generichash_blake2bp_keybytes_min() == crypto_generichash_blake2bp_KEYBYTES_MIN);
+    assert(crypto_generichash_blake2bp_keybytes_max() == crypto_generichash_blake2bp_KEYBYTES_MAX);
+    assert(crypto_generichash_blake2bp_keybytes() == crypto_generichash_blake2bp_KEYBYTES);
+    assert(crypto_generichash_blake2bp_statebytes() >= sizeof st);
+
+    printf("OK\n");
+
+    return 0;
+}
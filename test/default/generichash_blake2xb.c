@@ -0,0 +1,103 @@
+
+#define TEST_NAME "generichash_blake2xb"
+#include "cmptest.h"
+
+#define MAXLEN 20000
+
+static const size_t lens[] = { 1, 32, 63, 64, 65, 128, 200, 1000 };
+
+static const size_t keyed_lens[] = { 1, 64, 300 };
+
+int
+main(void)
+{
+    crypto_generichash_blake2xb_state st;
+    unsigned char                     in[256];
+    unsigned char                     k[crypto_generichash_blake2xb_KEYBYTES_MAX];
+    unsigned char                     h[crypto_hash_sha256_BYTES];
+    unsigned char                    *out;
+    unsigned char                    *out2;
+    char                             *hex;
+    size_t                            i;
+    size_t                            l;
+    size_t                            off;
+    size_t                            chunk;
+
+    out  = (unsigned char *) sodium_malloc(MAXLEN);
+    out2 = (unsigned char *) sodium_malloc(MAXLEN);
+    hex  = (char *) sodium_malloc(2 * 1000 + 1);
+    for (i = 0U; i < sizeof in; i++) {
+        in[i] = (unsigned char) i;
+    }
+    for (i = 0U; i < sizeof k; i++) {
+        k[i] = (unsigned char) i;
+    }
+    for (l = 0U; l < sizeof lens / sizeof lens[0]; l++) {
+        assert(crypto_generichash_blake2xb(out, lens[l], in, sizeof in, NULL, 0U) == 0);
+        sodium_bin2hex(hex, 2 * 1000 + 1, out, lens[l]);
+        printf("%s\n", hex);
+    }
+    for (l = 0U; l < sizeof keyed_lens / sizeof keyed_lens[0]; l++) {
+        assert(crypto_generichash_blake2xb(out, keyed_lens[l], in, sizeof in,
+                                           k, sizeof k) == 0);
+        sodium_bin2hex(hex, 2 * 1000 + 1, out, keyed_lens[l]);
+        printf("%s\n", hex);
+    }
+
+    assert(crypto_generichash_blake2xb_init(&st, NULL, 0U,
+                                            crypto_generichash_blake2xb_BYTES_UNKNOWN) == 0);
+    assert(crypto_generichash_blake2xb_update(&st, in, 3U) == 0);
+    assert(crypto_generichash_blake2xb_squeeze(&st, out, 100U) == 0);
+    assert(crypto_generichash_blake2xb_squeeze(&st, out + 100U, 50U) == 0);
+    assert(crypto_generichash_blake2xb_update(&st, in, 3U) == -1);
+    sodium_bin2hex(hex, 2 * 1000 + 1, out, 150U);
+    printf("%s\n", hex);
+
+    assert(crypto_generichash_blake2xb(out, MAXLEN, in, sizeof in,
+                                       k, crypto_generichash_blake2xb_KEYBYTES) == 0);
+    crypto_hash_sha256(h, out, MAXLEN);
+    sodium_bin2hex(hex, 2 * 1000 + 1, h, sizeof h);
+    printf("%s\n", hex);
+
+    assert(crypto_generichash_blake2xb_init(&st, k, crypto_generichash_blake2xb_KEYBYTES,
+                                            MAXLEN) == 0);
+    for (off = 0U; off < sizeof in; off += chunk) {
+        chunk = (size_t) randombytes_uniform(100U);
+        if (chunk > sizeof in - off) {
+            chunk = sizeof in - off;
+        }
+        assert(crypto_generichash_blake2xb_update(&st, in + off, chunk) == 0);
+    }
+    for (off = 0U; off < MAXLEN; off += chunk) {
+        chunk = (size_t) randombytes_uniform(5000U);
+        if (chunk > MAXLEN - off) {
+            chunk = MAXLEN - off;
+        }
+        assert(crypto_generichash_blake2xb_squeeze(&st, out2 + off, chunk) == 0);
+    }
+    assert(memcmp(out, out2, MAXLEN) == 0);
+    assert(crypto_generichash_blake2xb_squeeze(&st, out2, 1U) == -1);
+
+    assert(crypto_generichash_blake2xb(out, 0U, in, sizeof in, NULL, 0U) == -1);
+    assert(crypto_generichash_blake2xb(out, crypto_generichash_blake2xb_BYTES_UNKNOWN, in,
+                                       sizeof in, NULL, 0U) == -1);
+    assert(crypto_generichash_blake2xb(out, 64U, in, sizeof in, k, sizeof k + 1U) == -1);
+    assert(crypto_generichash_blake2xb_bytes_min() == crypto_generichash_blake2xb_BYTES_MIN);
+    assert(crypto_generichash_blake2xb_bytes_max() == crypto_generichash_blake2xb_BYTES_MAX);
+    assert(crypto_generichash_blake2xb_bytes_unknown() ==
+           crypto_generichash_blake2xb_BYTES_UNKNOWN);
+    assert(crypto_generichash_blake2xb_keybytes_min() ==
+           crypto_generichash_blake2xb_KEYBYTES_MIN);
+    assert(crypto_generichash_blake2xb_keybytes_max() ==
+           crypto_generichash_blake2xb_KEYBYTES_MAX);
+    assert(crypto_generichash_blake2xb_keybytes() == crypto_generichash_blake2xb_KEYBYTES);
+    assert(crypto_generichash_blake2xb_statebytes() >= sizeof st);
+
+    sodium_free(hex);
+    sodium_free(out2);
+    sodium_free(out);
+
+    printf("OK\n");
+
+    return 0;
+}
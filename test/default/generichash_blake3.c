@@ -0,0 +1,110 @@
+
+#define TEST_NAME "generichash_blake3"
+#include "cmptest.h"
+
+#define MAXLEN 102400
+
+static const size_t lens[] = { 0, 1, 63, 64, 65, 1023, 1024, 1025, 2048, 2049,
+                               3072, 3073, 8192, 16385, 31744, MAXLEN };
+
+static const size_t dk_lens[] = { 0, 1, 1024, 4097 };
+
+static const char *context = "libsodium 2026-10-14 blake3 test context";
+
+int
+main(void)
+{
+    crypto_generichash_blake3_state st;
+    unsigned char                  *in;
+    unsigned char                  *big;
+    unsigned char                   out[131];
+    unsigned char                   out2[131];
+    unsigned char                   k[crypto_generichash_blake3_KEYBYTES];
+    char                            hex[2 * sizeof out + 1];
+    size_t                          i;
+    size_t                          l;
+    size_t                          off;
+    size_t                          chunk;
+    size_t                          biglen = 3 * 1024 * 1024 + 12345;
+
+    in = (unsigned char *) sodium_malloc(MAXLEN);
+    for (i = 0U; i < MAXLEN; i++) {
+        in[i] = (unsigned char) (i % 251);
+    }
+    for (i = 0U; i < sizeof k; i++) {
+        k[i] = (unsigned char) i;
+    }
+    for (l = 0U; l < sizeof lens / sizeof lens[0]; l++) {
+        assert(crypto_generichash_blake3(out, crypto_generichash_blake3_BYTES, in, lens[l],
+                                         NULL, 0U) == 0);
+        sodium_bin2hex(hex, sizeof hex, out, crypto_generichash_blake3_BYTES);
+        printf("%s\n", hex);
+
+        assert(crypto_generichash_blake3_init(&st, NULL, 0U) == 0);
+        for (off = 0U; off < lens[l]; off += chunk) {
+            chunk = (size_t) randombytes_uniform(3000U);
+            if (chunk > lens[l] - off) {
+                chunk = lens[l] - off;
+            }
+            assert(crypto_generichash_blake3_update(&st, in + off, chunk) == 0);
+        }
+        assert(crypto_generichash_blake3_final(&st, out2,
+                                               crypto_generichash_blake3_BYTES) == 0);
+        assert(memcmp(out, out2, crypto_generichash_blake3_BYTES) == 0);
+    }
+    for (l = 0U; l < sizeof lens / sizeof lens[0]; l++) {
+        assert(crypto_generichash_blake3(out, crypto_generichash_blake3_BYTES, in, lens[l],
+                                         k, sizeof k) == 0);
+        sodium_bin2hex(hex, sizeof hex, out, crypto_generichash_blake3_BYTES);
+        printf("%s\n", hex);
+    }
+    for (l = 0U; l < sizeof dk_lens / sizeof dk_lens[0]; l++) {
+        assert(crypto_generichash_blake3_derive_key(out, crypto_generichash_blake3_BYTES,
+                                                    context, in, dk_lens[l]) == 0);
+        sodium_bin2hex(hex, sizeof hex, out, crypto_generichash_blake3_BYTES);
+        printf("%s\n", hex);
+    }
+
+    assert(crypto_generichash_blake3_init(&st, NULL, 0U) == 0);
+    assert(crypto_generichash_blake3_update(&st, in, 5000U) == 0);
+    assert(crypto_generichash_blake3_final(&st, out, sizeof out) == 0);
+    sodium_bin2hex(hex, sizeof hex, out, sizeof out);
+    printf("%s\n", hex);
+    assert(crypto_generichash_blake3_final(&st, out2, 32U) == 0);
+    assert(memcmp(out, out2, 32U) == 0);
+    assert(crypto_generichash_blake3_final_seek(&st, 1000U, out, 77U) == 0);
+    sodium_bin2hex(hex, sizeof hex, out, 77U);
+    printf("%s\n", hex);
+    assert(crypto_generichash_blake3_final_seek(&st, 1050U, out2, 27U) == 0);
+    assert(memcmp(out + 50, out2, 27U) == 0);
+
+    big = (unsigned char *) sodium_malloc(biglen);
+    randombytes_buf(big, biglen);
+    assert(crypto_generichash_blake3(out, crypto_generichash_blake3_BYTES, big, biglen,
+                                     k, sizeof k) == 0);
+    for (i = 1U; i <= 5U; i++) {
+        assert(crypto_generichash_blake3_init(&st, k, sizeof k) == 0);
+        assert(crypto_generichash_blake3_update_parallel(&st, big, 1000U, (unsigned int) i) ==
+               0);
+        assert(crypto_generichash_blake3_update_parallel(&st, big + 1000U, biglen - 1000U,
+                                                         (unsigned int) i) == 0);
+        assert(crypto_generichash_blake3_final(&st, out2,
+                                               crypto_generichash_blake3_BYTES) == 0);
+        assert(memcmp(out, out2, crypto_generichash_blake3_BYTES) == 0);
+    }
+    sodium_free(big);
+
+    assert(crypto_generichash_blake3(out, sizeof out, in, MAXLEN, k, sizeof k - 1U) == -1);
+    assert(crypto_generichash_blake3(out, sizeof out, in, MAXLEN, NULL, sizeof k) == -1);
+    assert(crypto_generichash_blake3_init(&st, k, sizeof k + 1U) == -1);
+    assert(crypto_generichash_blake3_bytes() == crypto_generichash_blake3_BYTES);
+    assert(crypto_generichash_blake3_keybytes() == crypto_generichash_blake3_KEYBYTES);
+    assert(crypto_generichash_blake3_statebytes() == sizeof st);
+    crypto_generichash_blake3_keygen(k);
+
+    sodium_free(in);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+
+#define TEST_NAME "hash_sha256_multi"
+#include "cmptest.h"
+
+#define COUNT 100
+
+static const size_t merkle_tests[][2] = { { 0, 100 }, { 1, 100 }, { 2, 100 },
+                                          { 3, 100 }, { 5, 64 },  { 7, 1 },
+                                          { 16, 55 }, { 17, 56 }, { 100, 1000 },
+                                          { 1000, 100 } };
+
+int
+main(void)
+{
+    unsigned char      *data;
+    unsigned char      *msgs[COUNT];
+    unsigned char      *out_p[COUNT];
+    const unsigned char *in_p[COUNT];
+    unsigned long long  inlen[COUNT];
+    unsigned char       out[COUNT][crypto_hash_sha256_BYTES];
+    unsigned char       h[crypto_hash_sha256_BYTES];
+    char                hex[2 * crypto_hash_sha256_BYTES + 1];
+    size_t              i, j;
+
+    for (i = 0U; i < COUNT; i++) {
+        inlen[i] = (unsigned long long) ((i * 13U) % 300U);
+        msgs[i]  = (unsigned char *) sodium_malloc((size_t) inlen[i] + 1U);
+        for (j = 0U; j < inlen[i]; j++) {
+            msgs[i][j] = (unsigned char) (i * j);
+        }
+        in_p[i]  = msgs[i];
+        out_p[i] = out[i];
+    }
+    assert(crypto_hash_sha256_multi(out_p, in_p, inlen, COUNT) == 0);
+    for (i = 0U; i < COUNT; i++) {
+        crypto_hash_sha256(h, msgs[i], inlen[i]);
+        assert(memcmp(h, out[i], sizeof h) == 0);
+        sodium_free(msgs[i]);
+    }
+    assert(crypto_hash_sha256_multi(out_p, in_p, inlen, 0U) == 0);
+
+    data = (unsigned char *) sodium_malloc(1000U * 100U);
+    for (i = 0U; i < 1000U * 100U; i++) {
+        data[i] = (unsigned char) (i * 31U + 7U);
+    }
+    for (i = 0U; i < sizeof merkle_tests / sizeof merkle_tests[0]; i++) {
+        assert(crypto_hash_sha256_merkle_root(h, data, merkle_tests[i][0],
+                                              merkle_tests[i][1]) == 0);
+        sodium_bin2hex(hex, sizeof hex, h, sizeof h);
+        printf("%s\n", hex);
+    }
+    sodium_free(data);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+
+#define TEST_NAME "jobs"
+#include "cmptest.h"
+
+#define SIGN_JOBS   100U
+#define DH_JOBS     20U
+#define PWHASH_JOBS 4U
+#define AEAD_JOBS   20U
+#define MLEN        1000U
+#define JOBS        (SIGN_JOBS + DH_JOBS + PWHASH_JOBS + 2U * AEAD_JOBS)
+
+typedef struct job_set {
+    sodium_job    jobs[JOBS];
+    int           done[JOBS];
+    int           expected[JOBS];
+    unsigned char sigs[SIGN_JOBS][crypto_sign_BYTES];
+    unsigned char ms[SIGN_JOBS][32];
+    unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+    unsigned char sk[crypto_sign_SECRETKEYBYTES];
+    unsigned char dh_n[DH_JOBS][crypto_scalarmult_BYTES];
+    unsigned char dh_p[DH_JOBS][crypto_scalarmult_BYTES];
+    unsigned char dh_q[DH_JOBS][crypto_scalarmult_BYTES];
+    char          strs[PWHASH_JOBS][crypto_pwhash_STRBYTES];
+    unsigned char m[AEAD_JOBS][MLEN];
+    unsigned char c[AEAD_JOBS][MLEN + crypto_aead_xchacha20poly1305_ietf_ABYTES];
+    unsigned char m2[AEAD_JOBS][MLEN];
+    unsigned char npub[AEAD_JOBS][crypto_aead_xchacha20poly1305_ietf_NPUBBYTES];
+    unsigned char k[crypto_aead_xchacha20poly1305_ietf_KEYBYTES];
+} job_set;
+
+static void
+completion(sodium_job *job)
+{
+    (*(int *) job->opaque)++;
+}
+
+/* The decryptions of the ciphertexts are only submitted once they exist */
+static sodium_job_queue *decrypt_queue;
+
+static void
+encrypt_completion(sodium_job *job)
+{
+    sodium_job *decrypt_job = job + AEAD_JOBS;
+
+    completion(job);
+    assert(job->result == 0);
+    assert(sodium_job_submit(decrypt_queue, decrypt_job) == 0);
+}
+
+static void
+job_set_init(job_set *s)
+{
+    sodium_job *job;
+    size_t      i;
+    size_t      j = 0U;
+
+    memset(s->done, 0, sizeof s->done);
+    crypto_sign_keypair(s->pk, s->sk);
+    for (i = 0U; i < SIGN_JOBS; i++, j++) {
+        randombytes_buf(s->ms[i], sizeof s->ms[i]);
+        crypto_sign_detached(s->sigs[i], NULL, s->ms[i], sizeof s->ms[i],
+                             s->sk);
+        s->expected[j] = 0;
+        if (i % 7U == 3U) {
+            s->sigs[i][5] ^= 0x01;
+            s->expected[j] = -1;
+        }
+        job = &s->jobs[j];
+        job->op = SODIUM_JOB_SIGN_ED25519_VERIFY;
+        job->args.sign_verify.sig  = s->sigs[i];
+        job->args.sign_verify.m    = s->ms[i];
+        job->args.sign_verify.mlen = sizeof s->ms[i];
+        job->args.sign_verify.pk   = s->pk;
+    }
+    for (i = 0U; i < DH_JOBS; i++, j++) {
+        randombytes_buf(s->dh_n[i], sizeof s->dh_n[i]);
+        crypto_scalarmult_base(s->dh_p[i], s->dh_n[(i + 1U) % DH_JOBS]);
+        s->expected[j] = 0;
+        if (i == 5U) {
+            memset(s->dh_p[i], 0, sizeof s->dh_p[i]);
+            s->expected[j] = -1;
+        }
+        job = &s->jobs[j];
+        job->op = SODIUM_JOB_SCALARMULT_CURVE25519;
+        job->args.scalarmult.q = s->dh_q[i];
+        job->args.scalarmult.n = s->dh_n[i];
+        job->args.scalarmult.p = s->dh_p[i];
+    }
+    for (i = 0U; i < PWHASH_JOBS; i++, j++) {
+        assert(crypto_pwhash_str(s->strs[i], "password", 8U,
+                                 crypto_pwhash_OPSLIMIT_MIN,
+                                 crypto_pwhash_MEMLIMIT_MIN) == 0);
+        job = &s->jobs[j];
+        job->op = SODIUM_JOB_PWHASH_STR_VERIFY;
+        job->args.pwhash_str_verify.str       = s->strs[i];
+        job->args.pwhash_str_verify.passwd    = "password";
+        job->args.pwhash_str_verify.passwdlen = 8U - (i & 1U);
+        s->expected[j] = -(int) (i & 1U);
+    }
+    crypto_aead_xchacha20poly1305_ietf_keygen(s->k);
+    for (i = 0U; i < AEAD_JOBS; i++, j++) {
+        randombytes_buf(s->m[i], sizeof s->m[i]);
+        randombytes_buf(s->npub[i], sizeof s->npub[i]);
+        job = &s->jobs[j];
+        job->op = SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_ENCRYPT;
+        job->args.aead.out   = s->c[i];
+        job->args.aead.in    = s->m[i];
+        job->args.aead.inlen = (unsigned long long) (MLEN - i);
+        job->args.aead.ad    = i % 2U == 0U ? s->npub[i] : NULL;
+        job->args.aead.adlen = i % 2U == 0U ? sizeof s->npub[i] : 0U;
+        job->args.aead.npub  = s->npub[i];
+        job->args.aead.k     = s->k;
+        s->expected[j] = 0;
+        s->expected[j + AEAD_JOBS] = i == 7U ? -1 : 0;
+        s->jobs[j + AEAD_JOBS] = *job;
+        job = &s->jobs[j + AEAD_JOBS];
+        job->op = SODIUM_JOB_AEAD_XCHACHA20POLY1305_IETF_DECRYPT;
+        job->args.aead.out   = s->m2[i];
+        job->args.aead.in    = s->c[i];
+        job->args.aead.inlen = (unsigned long long) (MLEN - i) +
+            crypto_aead_xchacha20poly1305_ietf_ABYTES;
+        if (i == 7U) {
+            job->args.aead.ad    = s->npub[i];
+            job->args.aead.adlen = 1U;
+        }
+    }
+    for (j = 0U; j < JOBS; j++) {
+        s->jobs[j].completion = completion;
+        s->jobs[j].opaque     = &s->done[j];
+        s->jobs[j].result     = 42;
+    }
+    for (i = 0U; i < AEAD_JOBS; i++) {
+        s->jobs[SIGN_JOBS + DH_JOBS + PWHASH_JOBS + i].completion =
+            encrypt_completion;
+    }
+}
+
+static void
+job_set_submit(job_set *s, sodium_job_queue *queue)
+{
+    size_t j;
+
+    decrypt_queue = queue;
+    for (j = 0U; j < SIGN_JOBS + DH_JOBS + PWHASH_JOBS + AEAD_JOBS; j++) {
+        assert(sodium_job_submit(queue, &s->jobs[j]) == 0);
+    }
+}
+
+static void
+job_set_check(const job_set *s)
+{
+    size_t i;
+    size_t j;
+
+    for (j = 0U; j < JOBS; j++) {
+        assert(s->done[j] == 1);
+        assert(s->jobs[j].result == s->expected[j]);
+    }
+    for (i = 0U; i < DH_JOBS; i++) {
+        unsigned char q[crypto_scalarmult_BYTES];
+
+        if (i == 5U) {
+            continue;
+        }
+        assert(crypto_scalarmult(q, s->dh_n[i], s->dh_p[i]) == 0);
+        assert(memcmp(q, s->dh_q[i], sizeof q) == 0);
+    }
+    for (i = 0U; i < AEAD_JOBS; i++) {
+        if (i != 7U) {
+            assert(memcmp(s->m[i], s->m2[i], MLEN - i) == 0);
+        }
+    }
+}
+
+int
+main(void)
+{
+    job_set          *s = (job_set *) sodium_malloc(sizeof *s);
+    sodium_job_queue *queue;
+    sodium_job        job;
+
+    queue = sodium_job_queue_create(0U, 0U);
+    assert(queue != NULL);
+    memset(&job, 0, sizeof job);
+    job.op = 0;
+    assert(sodium_job_submit(queue, &job) == -1 && errno == EINVAL);
+    assert(sodium_job_queue_run(queue) == 0U);
+
+    job_set_init(s);
+    job_set_submit(s, queue);
+    assert(sodium_job_queue_run(queue) == JOBS);
+    job_set_check(s);
+    sodium_job_queue_destroy(queue);
+
+    /* jobs still queued are run when the queue is destroyed */
+    queue = sodium_job_queue_create(0U, 3U);
+    job_set_init(s);
+    job_set_submit(s, queue);
+    sodium_job_queue_destroy(queue);
+    job_set_check(s);
+
+    if ((queue = sodium_job_queue_create(3U, 0U)) == NULL) {
+        assert(errno == ENOSYS);
+    } else {
+        job_set_init(s);
+        job_set_submit(s, queue);
+        sodium_job_queue_destroy(queue);
+        job_set_check(s);
+    }
+    sodium_job_queue_destroy(NULL);
+    sodium_free(s);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -7,6 +7,7 @@ tv_kdf(void)
 {
     unsigned char *master_key;
     unsigned char *subkey;
+    unsigned char *subkeys;
     char          *context;
     char           hex[crypto_kdf_BYTES_MAX * 2 + 1];
     uint64_t       i;
@@ -42,6 +43,38 @@ tv_kdf(void)
         sodium_free(subkey);
     }
 
+    subkey = (unsigned char *) sodium_malloc(crypto_kdf_BYTES_MAX);
+    subkeys = (unsigned char *) sodium_malloc(19 * crypto_kdf_BYTES_MAX);
+    for (i = 0; i < 20; i++) {
+        size_t subkey_len = crypto_kdf_BYTES_MIN + (size_t) i * 2U;
+        size_t j;
+
+        ret = crypto_kdf_derive_from_key_range(subkeys, subkey_len, 1000U + i,
+                                               (size_t) i, context, master_key);
+        assert(ret == 0);
+        for (j = 0; j < (size_t) i; j++) {
+            crypto_kdf_derive_from_key(subkey, subkey_len, 1000U + i + j,
+                                       context, master_key);
+            assert(memcmp(subkey, subkeys + j * subkey_len, subkey_len) == 0);
+        }
+    }
+    ret = crypto_kdf_derive_from_key_range(subkeys, crypto_kdf_BYTES_MAX,
+                                           UINT64_MAX - 2U, 3U, context,
+                                           master_key);
+    assert(ret == 0);
+    crypto_kdf_derive_from_key(subkey, crypto_kdf_BYTES_MAX, UINT64_MAX,
+                               context, master_key);
+    assert(memcmp(subkey, subkeys + 2 * crypto_kdf_BYTES_MAX,
+                  crypto_kdf_BYTES_MAX) == 0);
+    assert(crypto_kdf_derive_from_key_range(subkeys, crypto_kdf_BYTES_MAX,
+                                            UINT64_MAX - 2U, 4U, context,
+                                            master_key) == -1);
+    assert(crypto_kdf_derive_from_key_range(subkeys, crypto_kdf_BYTES_MAX + 1U,
+                                            0U, 1U, context,
+                                            master_key) == -1);
+    sodium_free(subkeys);
+    sodium_free(subkey);
+
     sodium_free(master_key);
     sodium_free(context);
 
@@ -16,7 +16,10 @@ tv_kdf_hkdf(void)
     char          *context;
     size_t         context_len = 88;
     unsigned char *out;
+    unsigned char *out2;
     size_t         out_len = 99;
+    crypto_kdf_hkdf_sha256_state st256;
+    crypto_kdf_hkdf_sha512_state st512;
     char           hex[99 * 2 + 1];
     size_t         i;
     int            ret;
@@ -27,6 +30,7 @@ tv_kdf_hkdf(void)
     salt = (unsigned char *) sodium_malloc(salt_len);
     context = (char *) sodium_malloc(context_len);
     out = (unsigned char *) sodium_malloc(out_len);
+    out2 = (unsigned char *) sodium_malloc(out_len);
     for (i = 0; i < master_key_len; i++) {
         master_key[i] = i;
     }
@@ -54,6 +58,20 @@ tv_kdf_hkdf(void)
         printf("%s\n", sodium_bin2hex(hex, sizeof hex, out, i));
     }
 
+    assert(crypto_kdf_hkdf_sha256_precompute(&st256, prk256) == 0);
+    for (i = 0; i < out_len; i++) {
+        context[0] = i;
+        crypto_kdf_hkdf_sha256_expand(out, i, context, context_len, prk256);
+        assert(crypto_kdf_hkdf_sha256_expand_precomputed(out2, i, context,
+                                                         context_len,
+                                                         &st256) == 0);
+        assert(memcmp(out, out2, i) == 0);
+    }
+    assert(crypto_kdf_hkdf_sha256_expand_precomputed(out2,
+                                                     crypto_kdf_hkdf_sha256_BYTES_MAX + 1U,
+                                                     context, context_len,
+                                                     &st256) == -1);
+
     printf("\nHKDF/SHA-512:\n");
     crypto_kdf_hkdf_sha256_keygen(prk512);
     if (crypto_kdf_hkdf_sha512_extract(prk512, salt, salt_len,
@@ -71,6 +89,21 @@ tv_kdf_hkdf(void)
         printf("%s\n", sodium_bin2hex(hex, sizeof hex, out, i));
     }
 
+    assert(crypto_kdf_hkdf_sha512_precompute(&st512, prk512) == 0);
+    for (i = 0; i < out_len; i++) {
+        context[0] = i;
+        crypto_kdf_hkdf_sha512_expand(out, i, context, context_len, prk512);
+        assert(crypto_kdf_hkdf_sha512_expand_precomputed(out2, i, context,
+                                                         context_len,
+                                                         &st512) == 0);
+        assert(memcmp(out, out2, i) == 0);
+    }
+    assert(crypto_kdf_hkdf_sha512_expand_precomputed(out2,
+                                                     crypto_kdf_hkdf_sha512_BYTES_MAX + 1U,
+                                                     context, context_len,
+                                                     &st512) == -1);
+
+    sodium_free(out2);
     sodium_free(out);
     sodium_free(context);
     sodium_free(salt);
@@ -81,10 +114,12 @@ tv_kdf_hkdf(void)
     assert(crypto_kdf_hkdf_sha512_bytes_min() == crypto_kdf_hkdf_sha512_BYTES_MIN);
     assert(crypto_kdf_hkdf_sha512_bytes_max() == crypto_kdf_hkdf_sha512_BYTES_MAX);
     assert(crypto_kdf_hkdf_sha512_keybytes() == crypto_kdf_hkdf_sha512_KEYBYTES);
+    assert(crypto_kdf_hkdf_sha512_statebytes() == sizeof(crypto_kdf_hkdf_sha512_state));
 
     assert(crypto_kdf_hkdf_sha256_bytes_min() == crypto_kdf_hkdf_sha256_BYTES_MIN);
     assert(crypto_kdf_hkdf_sha256_bytes_max() == crypto_kdf_hkdf_sha256_BYTES_MAX);
     assert(crypto_kdf_hkdf_sha256_keybytes() == crypto_kdf_hkdf_sha256_KEYBYTES);
+    assert(crypto_kdf_hkdf_sha256_statebytes() == sizeof(crypto_kdf_hkdf_sha256_state));
 
     assert(crypto_kdf_hkdf_sha256_KEYBYTES < crypto_kdf_hkdf_sha512_KEYBYTES);
 
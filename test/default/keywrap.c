@@ -0,0 +1,114 @@
+
+#define TEST_NAME "keywrap"
+#include "cmptest.h"
+
+#define BATCH_COUNT 100U
+
+static void
+tv(const unsigned char *ad, unsigned long long adlen)
+{
+    unsigned char kek[crypto_keywrap_KEYBYTES];
+    unsigned char in[crypto_keywrap_INPUTBYTES];
+    unsigned char out[crypto_keywrap_INPUTBYTES];
+    unsigned char wrapped[crypto_keywrap_WRAPPEDBYTES];
+    char          hex[crypto_keywrap_WRAPPEDBYTES * 2 + 1];
+    size_t        i;
+
+    for (i = 0U; i < sizeof kek; i++) {
+        kek[i] = (unsigned char) i;
+    }
+    for (i = 0U; i < sizeof in; i++) {
+        in[i] = (unsigned char) (0x20 + i);
+    }
+    assert(crypto_keywrap(wrapped, in, ad, adlen, kek) == 0);
+    printf("%s\n", sodium_bin2hex(hex, sizeof hex, wrapped, sizeof wrapped));
+    assert(crypto_keywrap_open(out, wrapped, ad, adlen, kek) == 0);
+    assert(memcmp(out, in, sizeof in) == 0);
+    for (i = 0U; i < sizeof wrapped; i++) {
+        wrapped[i] ^= 0x80;
+        assert(crypto_keywrap_open(out, wrapped, ad, adlen, kek) == -1);
+        assert(sodium_is_zero(out, sizeof out));
+        wrapped[i] ^= 0x80;
+    }
+    if (adlen > 0U) {
+        assert(crypto_keywrap_open(out, wrapped, ad, adlen - 1U, kek) == -1);
+    }
+}
+
+int
+main(void)
+{
+    static unsigned char ad_long[200];
+    unsigned char       *wrapped[BATCH_COUNT];
+    unsigned char       *in[BATCH_COUNT];
+    unsigned char       *out[BATCH_COUNT];
+    unsigned char       *ad[BATCH_COUNT];
+    unsigned long long   adlen[BATCH_COUNT];
+    unsigned char        kek[crypto_keywrap_KEYBYTES];
+    unsigned char        expected[crypto_keywrap_WRAPPEDBYTES];
+    unsigned char        key[crypto_keywrap_INPUTBYTES];
+    size_t               i;
+
+    tv(NULL, 0U);
+    tv((const unsigned char *) "key id 42", 9U);
+    tv(ad_long, sizeof ad_long);
+
+    crypto_keywrap_keygen(kek);
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        adlen[i]   = (unsigned long long) ((i * 7U) % 130U);
+        wrapped[i] = (unsigned char *) sodium_malloc(crypto_keywrap_WRAPPEDBYTES);
+        in[i]      = (unsigned char *) sodium_malloc(crypto_keywrap_INPUTBYTES);
+        out[i]     = (unsigned char *) sodium_malloc(crypto_keywrap_INPUTBYTES);
+        ad[i]      = (unsigned char *) sodium_malloc((size_t) adlen[i] + 1U);
+        randombytes_buf(in[i], crypto_keywrap_INPUTBYTES);
+        randombytes_buf(ad[i], (size_t) adlen[i]);
+    }
+    assert(crypto_keywrap_batch(wrapped, (const unsigned char * const *) in,
+                                (const unsigned char * const *) ad, adlen,
+                                BATCH_COUNT, kek) == 0);
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        assert(crypto_keywrap(expected, in[i], ad[i], adlen[i], kek) == 0);
+        assert(memcmp(expected, wrapped[i], sizeof expected) == 0);
+    }
+    assert(crypto_keywrap_open_batch(out, (const unsigned char * const *) wrapped,
+                                     (const unsigned char * const *) ad, adlen,
+                                     BATCH_COUNT, kek) == 0);
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        assert(memcmp(out[i], in[i], crypto_keywrap_INPUTBYTES) == 0);
+    }
+    wrapped[3][0] ^= 0x01;
+    wrapped[77][40] ^= 0x01;
+    assert(crypto_keywrap_open_batch(out, (const unsigned char * const *) wrapped,
+                                     (const unsigned char * const *) ad, adlen,
+                                     BATCH_COUNT, kek) == -1);
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        if (i == 3U || i == 77U) {
+            assert(sodium_is_zero(out[i], crypto_keywrap_INPUTBYTES));
+        } else {
+            assert(memcmp(out[i], in[i], crypto_keywrap_INPUTBYTES) == 0);
+        }
+    }
+
+    assert(crypto_keywrap_batch(wrapped, (const unsigned char * const *) in,
+                                NULL, NULL, BATCH_COUNT, kek) == 0);
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        assert(crypto_keywrap(expected, in[i], NULL, 0U, kek) == 0);
+        assert(memcmp(expected, wrapped[i], sizeof expected) == 0);
+        assert(crypto_keywrap_open(key, wrapped[i], NULL, 0U, kek) == 0);
+    }
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        sodium_free(wrapped[i]);
+        sodium_free(in[i]);
+        sodium_free(out[i]);
+        sodium_free(ad[i]);
+    }
+
+    assert(crypto_keywrap_keybytes() == crypto_keywrap_KEYBYTES);
+    assert(crypto_keywrap_inputbytes() == crypto_keywrap_INPUTBYTES);
+    assert(crypto_keywrap_wrappedbytes() == crypto_keywrap_WRAPPEDBYTES);
+    assert(strcmp(crypto_keywrap_primitive(), crypto_keywrap_PRIMITIVE) == 0);
+
+    printf("OK\n");
+
+    return 0;
+}
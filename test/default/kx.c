@@ -140,10 +140,60 @@ tv_kx(void)
     printf("tv_kx: ok\n");
 }
 
+#define BATCH_COUNT 70
+
+static void
+tv_kx_batch(void)
+{
+    unsigned char        server_pk[crypto_kx_PUBLICKEYBYTES];
+    unsigned char        server_sk[crypto_kx_SECRETKEYBYTES];
+    unsigned char        client_pk[BATCH_COUNT][crypto_kx_PUBLICKEYBYTES];
+    unsigned char        client_sk[crypto_kx_SECRETKEYBYTES];
+    unsigned char        rx[BATCH_COUNT][crypto_kx_SESSIONKEYBYTES];
+    unsigned char        tx[BATCH_COUNT][crypto_kx_SESSIONKEYBYTES];
+    unsigned char        rx2[crypto_kx_SESSIONKEYBYTES];
+    unsigned char        tx2[crypto_kx_SESSIONKEYBYTES];
+    unsigned char       *rx_p[BATCH_COUNT];
+    unsigned char       *tx_p[BATCH_COUNT];
+    const unsigned char *client_pk_p[BATCH_COUNT];
+    int                  i;
+
+    crypto_kx_keypair(server_pk, server_sk);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        crypto_kx_keypair(client_pk[i], client_sk);
+        rx_p[i]        = rx[i];
+        tx_p[i]        = tx[i];
+        client_pk_p[i] = client_pk[i];
+    }
+    assert(crypto_kx_server_session_keys_batch(rx_p, tx_p, server_pk, server_sk,
+                                               client_pk_p, 0U) == 0);
+    assert(crypto_kx_server_session_keys_batch(rx_p, tx_p, server_pk, server_sk,
+                                               client_pk_p, BATCH_COUNT) == 0);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        assert(crypto_kx_server_session_keys(rx2, tx2, server_pk, server_sk,
+                                             client_pk[i]) == 0);
+        assert(memcmp(rx[i], rx2, sizeof rx2) == 0);
+        assert(memcmp(tx[i], tx2, sizeof tx2) == 0);
+    }
+
+    memcpy(client_pk[BATCH_COUNT / 2], small_order_p, crypto_kx_PUBLICKEYBYTES);
+    assert(crypto_kx_server_session_keys_batch(rx_p, tx_p, server_pk, server_sk,
+                                               client_pk_p, BATCH_COUNT) == -1);
+    assert(sodium_is_zero(rx[BATCH_COUNT / 2], crypto_kx_SESSIONKEYBYTES));
+    assert(sodium_is_zero(tx[BATCH_COUNT / 2], crypto_kx_SESSIONKEYBYTES));
+    assert(crypto_kx_server_session_keys(rx2, tx2, server_pk, server_sk,
+                                         client_pk[BATCH_COUNT - 1]) == 0);
+    assert(memcmp(rx[BATCH_COUNT - 1], rx2, sizeof rx2) == 0);
+    assert(memcmp(tx[BATCH_COUNT - 1], tx2, sizeof tx2) == 0);
+
+    printf("tv_kx_batch: ok\n");
+}
+
 int
 main(void)
 {
     tv_kx();
+    tv_kx_batch();
 
     return 0;
 }
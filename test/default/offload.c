@@ -0,0 +1,280 @@
+
+#define TEST_NAME "offload"
+#include "cmptest.h"
+
+#define SMALL_MLEN 100U
+#define LARGE_MLEN 10000U
+#define MIN_BYTES  1024U
+
+static int offloaded;
+static int declined;
+static int reentered;
+static int forge;
+
+static unsigned int
+test_capabilities(void *ctx)
+{
+    assert(ctx == &offloaded);
+    return SODIUM_OFFLOAD_AEAD_AES256GCM |
+           SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF | 0x80U;
+}
+
+/*
+ * The "engine" calls the library again; the nested call is declined and
+ * runs on the CPU.
+ */
+static int
+test_aead_encrypt(void *ctx, unsigned int op, unsigned char *c,
+                  unsigned char *mac, const unsigned char *m,
+                  unsigned long long mlen, const unsigned char *ad,
+                  unsigned long long adlen, const unsigned char *npub,
+                  const unsigned char *k)
+{
+    int ret;
+
+    (void) ctx;
+    if (reentered) {
+        declined++;
+        return 1;
+    }
+    reentered = 1;
+    if (op == SODIUM_OFFLOAD_AEAD_AES256GCM) {
+        ret = crypto_aead_aes256gcm_encrypt_detached(c, mac, NULL, m, mlen,
+                                                     ad, adlen, NULL, npub, k);
+    } else {
+        assert(op == SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF);
+        ret = crypto_aead_chacha20poly1305_ietf_encrypt_detached
+            (c, mac, NULL, m, mlen, ad, adlen, NULL, npub, k);
+    }
+    reentered = 0;
+    offloaded++;
+
+    return ret;
+}
+
+static int
+test_aead_decrypt(void *ctx, unsigned int op, unsigned char *m,
+                  const unsigned char *c, unsigned long long clen,
+                  const unsigned char *mac, const unsigned char *ad,
+                  unsigned long long adlen, const unsigned char *npub,
+                  const unsigned char *k)
+{
+    int ret;
+
+    (void) ctx;
+    if (reentered) {
+        declined++;
+        return 1;
+    }
+    reentered = 1;
+    if (op == SODIUM_OFFLOAD_AEAD_AES256GCM) {
+        ret = crypto_aead_aes256gcm_decrypt_detached(m, NULL, c, clen, mac,
+                                                     ad, adlen, npub, k);
+    } else {
+        assert(op == SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF);
+        ret = crypto_aead_chacha20poly1305_ietf_decrypt_detached
+            (m, NULL, c, clen, mac, ad, adlen, npub, k);
+    }
+    reentered = 0;
+    offloaded++;
+    if (forge) {
+        memset(m, 0xff, clen);
+        return -1;
+    }
+    return ret;
+}
+
+static void
+check_op(unsigned int op, unsigned long long mlen)
+{
+    unsigned char *m;
+    unsigned char *m2;
+    unsigned char *c;
+    unsigned char *c2;
+    unsigned char  ad[20];
+    unsigned char  npub[12];
+    unsigned char  k[32];
+    unsigned long long clen;
+    unsigned long long m2len;
+    int            expected_offloaded;
+
+    m  = (unsigned char *) sodium_malloc(mlen);
+    m2 = (unsigned char *) sodium_malloc(mlen);
+    c  = (unsigned char *) sodium_malloc(mlen + 16U);
+    c2 = (unsigned char *) sodium_malloc(mlen + 16U);
+    randombytes_buf(m, mlen);
+    randombytes_buf(ad, sizeof ad);
+    randombytes_buf(npub, sizeof npub);
+    randombytes_buf(k, sizeof k);
+
+    assert(sodium_set_offload_provider(NULL, 0U) == 0);
+    if (op == SODIUM_OFFLOAD_AEAD_AES256GCM) {
+        crypto_aead_aes256gcm_encrypt(c, NULL, m, mlen, ad, sizeof ad, NULL,
+                                      npub, k);
+    } else {
+        crypto_aead_chacha20poly1305_ietf_encrypt(c, NULL, m, mlen, ad,
+                                                  sizeof ad, NULL, npub, k);
+    }
+    {
+        const sodium_offload_provider provider = {
+            test_capabilities, test_aead_encrypt, test_aead_decrypt,
+            &offloaded
+        };
+        assert(sodium_set_offload_provider(&provider, MIN_BYTES) == 0);
+    }
+    expected_offloaded = offloaded + (mlen >= MIN_BYTES);
+    if (op == SODIUM_OFFLOAD_AEAD_AES256GCM) {
+        assert(crypto_aead_aes256gcm_encrypt(c2, &clen, m, mlen, ad, sizeof ad,
+                                             NULL, npub, k) == 0);
+    } else {
+        assert(crypto_aead_chacha20poly1305_ietf_encrypt
+               (c2, &clen, m, mlen, ad, sizeof ad, NULL, npub, k) == 0);
+    }
+    assert(offloaded == expected_offloaded);
+    assert(clen == mlen + 16U);
+    assert(memcmp(c, c2, mlen + 16U) == 0);
+
+    expected_offloaded = offloaded + (mlen >= MIN_BYTES);
+    if (op == SODIUM_OFFLOAD_AEAD_AES256GCM) {
+        assert(crypto_aead_aes256gcm_decrypt(m2, &m2len, NULL, c, clen, ad,
+                                             sizeof ad, npub, k) == 0);
+    } else {
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt
+               (m2, &m2len, NULL, c, clen, ad, sizeof ad, npub, k) == 0);
+    }
+    assert(offloaded == expected_offloaded);
+    assert(m2len == mlen);
+    assert(memcmp(m, m2, mlen) == 0);
+
+    c[0] ^= 0x01;
+    if (op == SODIUM_OFFLOAD_AEAD_AES256GCM) {
+        assert(crypto_aead_aes256gcm_decrypt(m2, &m2len, NULL, c, clen, ad,
+                                             sizeof ad, npub, k) == -1);
+    } else {
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt
+               (m2, &m2len, NULL, c, clen, ad, sizeof ad, npub, k) == -1);
+    }
+    assert(m2len == 0U);
+    c[0] ^= 0x01;
+
+    forge = 1;
+    if (op == SODIUM_OFFLOAD_AEAD_AES256GCM) {
+        assert(crypto_aead_aes256gcm_decrypt(m2, NULL, NULL, c, clen, ad,
+                                             sizeof ad, npub, k) ==
+               (mlen >= MIN_BYTES ? -1 : 0));
+    } else {
+        assert(crypto_aead_chacha20poly1305_ietf_decrypt
+               (m2, NULL, NULL, c, clen, ad, sizeof ad, npub, k) ==
+               (mlen >= MIN_BYTES ? -1 : 0));
+    }
+    if (mlen >= MIN_BYTES) {
+        assert(sodium_is_zero(m2, mlen));
+    }
+    forge = 0;
+
+    sodium_free(c2);
+    sodium_free(c);
+    sodium_free(m2);
+    sodium_free(m);
+}
+
+static int jobs_done;
+
+static void
+completion(sodium_job *job)
+{
+    (void) job;
+    jobs_done++;
+}
+
+static void
+check_jobs(void)
+{
+    sodium_job_queue *queue;
+    sodium_job        jobs[4];
+    unsigned char     m[LARGE_MLEN];
+    unsigned char     c[2][LARGE_MLEN + 16U];
+    unsigned char     m2[2][LARGE_MLEN];
+    unsigned char     npub[12];
+    unsigned char     k[32];
+    int               ops[4] = {
+        SODIUM_JOB_AEAD_AES256GCM_ENCRYPT,
+        SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_ENCRYPT,
+        SODIUM_JOB_AEAD_AES256GCM_DECRYPT,
+        SODIUM_JOB_AEAD_CHACHA20POLY1305_IETF_DECRYPT
+    };
+    int               expected_offloaded;
+    size_t            i;
+
+    randombytes_buf(m, sizeof m);
+    randombytes_buf(npub, sizeof npub);
+    randombytes_buf(k, sizeof k);
+    queue = sodium_job_queue_create(0U, SODIUM_JOB_BATCH_MAX);
+    assert(queue != NULL);
+    memset(jobs, 0, sizeof jobs);
+    for (i = 0U; i < 4U; i++) {
+        jobs[i].op              = ops[i];
+        jobs[i].completion      = completion;
+        jobs[i].args.aead.ad    = NULL;
+        jobs[i].args.aead.adlen = 0U;
+        jobs[i].args.aead.npub  = npub;
+        jobs[i].args.aead.k     = k;
+        if (i < 2U) {
+            jobs[i].args.aead.out   = c[i];
+            jobs[i].args.aead.in    = m;
+            jobs[i].args.aead.inlen = sizeof m;
+        } else {
+            jobs[i].args.aead.out   = m2[i - 2U];
+            jobs[i].args.aead.in    = c[i - 2U];
+            jobs[i].args.aead.inlen = sizeof c[i - 2U];
+        }
+    }
+    expected_offloaded = offloaded + 2;
+    assert(sodium_job_submit(queue, &jobs[0]) == 0);
+    assert(sodium_job_submit(queue, &jobs[1]) == 0);
+    assert(sodium_job_queue_run(queue) == 2U);
+    assert(offloaded == expected_offloaded);
+    expected_offloaded = offloaded + 2;
+    assert(sodium_job_submit(queue, &jobs[2]) == 0);
+    assert(sodium_job_submit(queue, &jobs[3]) == 0);
+    assert(sodium_job_queue_run(queue) == 2U);
+    assert(offloaded == expected_offloaded);
+    for (i = 0U; i < 4U; i++) {
+        assert(jobs[i].result == 0);
+    }
+    assert(jobs_done == 4);
+    assert(memcmp(m2[0], m, sizeof m) == 0);
+    assert(memcmp(m2[1], m, sizeof m) == 0);
+    sodium_job_queue_destroy(queue);
+}
+
+int
+main(void)
+{
+    sodium_offload_provider provider;
+
+    assert(sodium_offload_capabilities() == 0U);
+
+    memset(&provider, 0, sizeof provider);
+    provider.capabilities = test_capabilities;
+    assert(sodium_set_offload_provider(&provider, MIN_BYTES) == -1);
+    assert(errno == EINVAL);
+
+    check_op(SODIUM_OFFLOAD_AEAD_AES256GCM, SMALL_MLEN);
+    check_op(SODIUM_OFFLOAD_AEAD_AES256GCM, LARGE_MLEN);
+    check_op(SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF, SMALL_MLEN);
+    check_op(SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF, LARGE_MLEN);
+    assert(declined > 0);
+    assert(sodium_offload_capabilities() ==
+           (SODIUM_OFFLOAD_AEAD_AES256GCM |
+            SODIUM_OFFLOAD_AEAD_CHACHA20POLY1305_IETF));
+
+    check_jobs();
+
+    assert(sodium_set_offload_provider(NULL, 0U) == 0);
+    assert(sodium_offload_capabilities() == 0U);
+
+    printf("OK\n");
+
+    return 0;
+}
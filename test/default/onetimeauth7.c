@@ -6,11 +6,58 @@ static unsigned char key[32];
 static unsigned char c[1000];
 static unsigned char a[16];
 
+static int
+batch(void)
+{
+    unsigned char       msgs[11][300];
+    unsigned char       keys[11][crypto_onetimeauth_poly1305_KEYBYTES];
+    unsigned char       macs[11][crypto_onetimeauth_poly1305_BYTES];
+    unsigned char       expected[crypto_onetimeauth_poly1305_BYTES];
+    unsigned char      *mac_ptrs[11];
+    const unsigned char *msg_ptrs[11];
+    const unsigned char *key_ptrs[11];
+    unsigned long long  mlens[11];
+    size_t              count;
+    size_t              i;
+
+    for (i = 0; i < 11; i++) {
+        crypto_onetimeauth_poly1305_keygen(keys[i]);
+        mlens[i] = (unsigned long long) randombytes_uniform(sizeof msgs[i] + 1U);
+        randombytes_buf(msgs[i], sizeof msgs[i]);
+        mac_ptrs[i] = macs[i];
+        msg_ptrs[i] = msgs[i];
+        key_ptrs[i] = keys[i];
+    }
+    mlens[0] = 0U;
+    mlens[1] = 16U;
+    mlens[2] = 17U;
+    for (count = 0; count <= 11; count++) {
+        memset(macs, 0, sizeof macs);
+        crypto_onetimeauth_poly1305_batch(mac_ptrs, msg_ptrs, mlens, key_ptrs,
+                                          count);
+        for (i = 0; i < count; i++) {
+            crypto_onetimeauth_poly1305(expected, msgs[i], mlens[i], keys[i]);
+            if (memcmp(expected, macs[i], sizeof expected) != 0) {
+                printf("batch %u %u\n", (unsigned int) count, (unsigned int) i);
+                return 100;
+            }
+        }
+        for (; i < 11; i++) {
+            assert(sodium_is_zero(macs[i], sizeof macs[i]));
+        }
+    }
+    return 0;
+}
+
 int
 main(void)
 {
     int clen;
 
+    if (batch() != 0) {
+        return 100;
+    }
+
     for (clen = 0; clen < 1000; ++clen) {
         crypto_onetimeauth_keygen(key);
         randombytes_buf(c, clen);
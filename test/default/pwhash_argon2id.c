@@ -226,10 +226,12 @@ tv3(void)
 static void
 str_tests(void)
 {
-    char       *str_out;
-    char       *str_out2;
-    char       *salt;
-    const char *passwd = "Correct Horse Battery Staple";
+    crypto_pwhash_argon2_arena arena;
+    char                      *str_out;
+    char                      *str_out2;
+    char                      *salt;
+    const char                *passwd = "Correct Horse Battery Staple";
+    int                        i;
 
     salt     = (char *) sodium_malloc(crypto_pwhash_argon2id_SALTBYTES);
     str_out  = (char *) sodium_malloc(crypto_pwhash_argon2id_STRBYTES);
@@ -388,11 +390,271 @@ str_tests(void)
     assert(crypto_pwhash_argon2i_str_needs_rehash("", OPSLIMIT, MEMLIMIT) == -1);
     assert(crypto_pwhash_argon2i_str_needs_rehash(str_out + 1,
                                                   OPSLIMIT, MEMLIMIT) == -1);
+
+    assert(crypto_pwhash_argon2id_str_parallel(str_out, "test", 4, OPSLIMIT,
+                                               MEMLIMIT, 4U) == 0);
+    assert(strstr(str_out, ",p=4$") != NULL);
+    assert(crypto_pwhash_argon2id_str_verify(str_out, "test", 4) == 0);
+    assert(crypto_pwhash_argon2id_str_verify(str_out, "tesT", 4) == -1);
+    assert(crypto_pwhash_argon2id_parallel((unsigned char *) str_out, 32,
+                                           "test", 4, (unsigned char *) salt,
+                                           OPSLIMIT, MEMLIMIT, 1U,
+                                           crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(crypto_pwhash_argon2id((unsigned char *) str_out2, 32, "test", 4,
+                                  (unsigned char *) salt, OPSLIMIT, MEMLIMIT,
+                                  crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(memcmp(str_out, str_out2, 32) == 0);
+    assert(crypto_pwhash_argon2id_parallel((unsigned char *) str_out, 32,
+                                           "test", 4, (unsigned char *) salt,
+                                           OPSLIMIT, MEMLIMIT, 20U,
+                                           crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(memcmp(str_out, str_out2, 32) != 0);
+    assert(crypto_pwhash_argon2id_parallel((unsigned char *) str_out, 32,
+                                           "test", 4, (unsigned char *) salt,
+                                           OPSLIMIT, MEMLIMIT, 0U,
+                                           crypto_pwhash_ALG_ARGON2ID13) == -1);
+    assert(errno == EINVAL);
+    assert(crypto_pwhash_argon2id_str_parallel(str_out, "test", 4, OPSLIMIT,
+                                               crypto_pwhash_argon2id_MEMLIMIT_MIN,
+                                               2U) == -1);
+    assert(errno == EINVAL);
+
+    assert(crypto_pwhash_argon2_arena_init(&arena, 0U, 0) == -1);
+    assert(errno == EINVAL);
+    assert(crypto_pwhash_argon2_arena_init(&arena, MEMLIMIT, 0) == 0);
+    for (i = 0; i < 2; i++) {
+        assert(crypto_pwhash_argon2id_arena(&arena, (unsigned char *) str_out,
+                                            32, "test", 4,
+                                            (unsigned char *) salt, OPSLIMIT,
+                                            MEMLIMIT, 1U,
+                                            crypto_pwhash_ALG_ARGON2ID13) == 0);
+        assert(memcmp(str_out, str_out2, 32) == 0);
+        assert(sodium_is_zero((const unsigned char *) arena.memory,
+                              arena.size) == 1);
+    }
+    assert(crypto_pwhash_argon2id_arena(&arena, (unsigned char *) str_out, 32,
+                                        "test", 4, (unsigned char *) salt,
+                                        OPSLIMIT, MEMLIMIT * 2U, 1U,
+                                        crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(memcmp(str_out, str_out2, 32) != 0);
+    assert(crypto_pwhash_argon2id_arena(&arena, (unsigned char *) str_out, 32,
+                                        "test", 4, (unsigned char *) salt,
+                                        OPSLIMIT, MEMLIMIT, 1U,
+                                        crypto_pwhash_ALG_ARGON2ID13) == 0);
+    assert(memcmp(str_out, str_out2, 32) == 0);
+    assert(crypto_pwhash_argon2id_str_arena(&arena, str_out, "test", 4,
+                                            OPSLIMIT, MEMLIMIT, 2U) == 0);
+    assert(crypto_pwhash_argon2id_str_verify(str_out, "test", 4) == 0);
+    assert(crypto_pwhash_argon2id_str_verify_arena(&arena, str_out,
+                                                   "test", 4) == 0);
+    assert(crypto_pwhash_argon2id_str_verify_arena(&arena, str_out,
+                                                   "tesT", 4) == -1);
+    assert(sodium_is_zero((const unsigned char *) arena.memory,
+                          arena.size) == 1);
+    crypto_pwhash_argon2_arena_free(&arena);
+    assert(arena.memory == NULL);
+    if (crypto_pwhash_argon2_arena_init(&arena, MEMLIMIT, 1) == 0) {
+        assert(arena.locked == 1);
+        assert(crypto_pwhash_argon2id_str_verify_arena(&arena, str_out,
+                                                       "test", 4) == 0);
+        crypto_pwhash_argon2_arena_free(&arena);
+    }
+    if (crypto_pwhash_set_huge_pages(1) == 0) {
+        assert(crypto_pwhash_argon2id((unsigned char *) str_out, 32, "test", 4,
+                                      (unsigned char *) salt, OPSLIMIT,
+                                      MEMLIMIT,
+                                      crypto_pwhash_ALG_ARGON2ID13) == 0);
+        assert(memcmp(str_out, str_out2, 32) == 0);
+        assert(crypto_pwhash_set_huge_pages(0) == 0);
+    }
+    if (crypto_pwhash_set_memory_budget(MEMLIMIT / 2U) == 0) {
+        assert(crypto_pwhash_argon2id((unsigned char *) str_out, 32, "test", 4,
+                                      (unsigned char *) salt, OPSLIMIT,
+                                      MEMLIMIT,
+                                      crypto_pwhash_ALG_ARGON2ID13) == -1);
+        assert(errno == ENOMEM);
+        assert(crypto_pwhash_set_memory_budget(MEMLIMIT) == 0);
+        assert(crypto_pwhash_argon2id((unsigned char *) str_out, 32, "test", 4,
+                                      (unsigned char *) salt, OPSLIMIT,
+                                      MEMLIMIT,
+                                      crypto_pwhash_ALG_ARGON2ID13) == 0);
+        assert(memcmp(str_out, str_out2, 32) == 0);
+        assert(crypto_pwhash_set_memory_budget(0U) == 0);
+    }
     sodium_free(salt);
     sodium_free(str_out);
     sodium_free(str_out2);
 }
 
+static void
+calibrate_tests(void)
+{
+    unsigned long long opslimit;
+    size_t             memlimit;
+
+    assert(crypto_pwhash_calibrate(0U, MEMLIMIT, &opslimit, &memlimit) == -1);
+    assert(errno == EINVAL);
+    assert(crypto_pwhash_calibrate(100U, crypto_pwhash_MEMLIMIT_MIN - 1U,
+                                   &opslimit, &memlimit) == -1);
+    assert(errno == EINVAL);
+    assert(crypto_pwhash_calibrate(20U, MEMLIMIT, &opslimit, &memlimit) == 0);
+    assert(opslimit >= crypto_pwhash_OPSLIMIT_MIN);
+    assert(memlimit >= crypto_pwhash_MEMLIMIT_MIN && memlimit <= MEMLIMIT);
+    assert(memlimit % 1024U == 0U);
+}
+
+static void
+verify_many_tests(void)
+{
+    char               strs[4][crypto_pwhash_STRBYTES];
+    const char        *strs_p[5];
+    const char        *passwds[5];
+    unsigned long long passwdlens[5];
+    int                results[5];
+    unsigned int       threads;
+    size_t             i;
+
+    assert(crypto_pwhash_str(strs[0], "pw0", 3, OPSLIMIT, MEMLIMIT) == 0);
+    assert(crypto_pwhash_str(strs[1], "pw1", 3, OPSLIMIT, MEMLIMIT / 2) == 0);
+    assert(crypto_pwhash_str_alg(strs[2], "pw2", 3, OPSLIMIT, MEMLIMIT,
+                                 crypto_pwhash_ALG_ARGON2I13) == 0);
+    assert(crypto_pwhash_str(strs[3], "pw3", 3, OPSLIMIT, MEMLIMIT) == 0);
+    for (i = 0; i < 4; i++) {
+        strs_p[i] = strs[i];
+    }
+    strs_p[4]  = "$invalid$";
+    passwds[0] = "pw0";
+    passwds[1] = "pw1";
+    passwds[2] = "pw2";
+    passwds[3] = "pw0";
+    passwds[4] = "pw4";
+    for (i = 0; i < 5; i++) {
+        passwdlens[i] = 3;
+    }
+    for (threads = 1U; threads <= 6U; threads += 5U) {
+        assert(crypto_pwhash_str_verify_many(results, strs_p, passwds,
+                                             passwdlens, 5U, threads) == 0);
+        assert(results[0] == 0 && results[1] == 0 && results[2] == 0);
+        assert(results[3] == -1 && results[4] == -1);
+    }
+    assert(crypto_pwhash_str_verify_many(results, strs_p, passwds,
+                                         passwdlens, 0U, 1U) == 0);
+    assert(crypto_pwhash_str_verify_many(results, strs_p, passwds,
+                                         passwdlens, 5U, 0U) == -1);
+    assert(errno == EINVAL);
+}
+
+static void
+many_tests(void)
+{
+    unsigned char        salts[6][crypto_pwhash_argon2id_SALTBYTES];
+    unsigned char        outs[6][32];
+    unsigned char        expected[32];
+    unsigned char       *outs_p[6];
+    const unsigned char *salts_p[6];
+    const char          *passwds[6];
+    unsigned long long   passwdlens[6];
+    size_t               i;
+
+    for (i = 0; i < 6; i++) {
+        randombytes_buf(salts[i], sizeof salts[i]);
+        salts_p[i]    = salts[i];
+        outs_p[i]     = outs[i];
+        passwds[i]    = "many passwords";
+        passwdlens[i] = (unsigned long long) i * 2U;
+    }
+    assert(crypto_pwhash_argon2id_many(outs_p, sizeof outs[0], passwds,
+                                       passwdlens, salts_p, 6U, OPSLIMIT,
+                                       MEMLIMIT,
+                                       crypto_pwhash_argon2id_ALG_ARGON2ID13) == 0);
+    for (i = 0; i < 6; i++) {
+        assert(crypto_pwhash_argon2id(expected, sizeof expected, passwds[i],
+                                      passwdlens[i], salts[i], OPSLIMIT,
+                                      MEMLIMIT,
+                                      crypto_pwhash_argon2id_ALG_ARGON2ID13) == 0);
+        assert(memcmp(outs[i], expected, sizeof expected) == 0);
+    }
+    assert(crypto_pwhash_argon2id_many(outs_p, sizeof outs[0], passwds,
+                                       passwdlens, salts_p, 1U, 1U, 8192U,
+                                       crypto_pwhash_argon2id_ALG_ARGON2ID13) == 0);
+    assert(crypto_pwhash_argon2id(expected, sizeof expected, passwds[0],
+                                  passwdlens[0], salts[0], 1U, 8192U,
+                                  crypto_pwhash_argon2id_ALG_ARGON2ID13) == 0);
+    assert(memcmp(outs[0], expected, sizeof expected) == 0);
+    assert(crypto_pwhash_argon2id_many(outs_p, sizeof outs[0], passwds,
+                                       passwdlens, salts_p, 0U, OPSLIMIT,
+                                       MEMLIMIT,
+                                       crypto_pwhash_argon2id_ALG_ARGON2ID13) == 0);
+    assert(crypto_pwhash_argon2id_many(outs_p, sizeof outs[0], passwds,
+                                       passwdlens, salts_p, 2U, OPSLIMIT,
+                                       MEMLIMIT,
+                                       crypto_pwhash_ALG_ARGON2I13) == -1);
+    assert(errno == EINVAL);
+    assert(sodium_is_zero(outs[1], sizeof outs[1]));
+}
+
+typedef struct progress_state {
+    unsigned long long calls;
+    unsigned long long done;
+    unsigned long long total;
+    unsigned long long stop_after;
+} progress_state;
+
+static int
+progress_cb(void *opaque, unsigned long long done, unsigned long long total)
+{
+    progress_state *state = (progress_state *) opaque;
+
+    assert(done == state->done + 1U && done <= total);
+    state->calls++;
+    state->done  = done;
+    state->total = total;
+
+    return state->calls == state->stop_after;
+}
+
+static void
+progress_tests(void)
+{
+    unsigned char  salt[crypto_pwhash_SALTBYTES];
+    unsigned char  out[32];
+    unsigned char  out2[32];
+    char           str[crypto_pwhash_STRBYTES];
+    progress_state state;
+    int            alg;
+
+    memset(salt, 0x42, sizeof salt);
+    for (alg = 1; alg <= 2; alg++) {
+        assert(crypto_pwhash(out, sizeof out, "password", 8, salt,
+                             OPSLIMIT, MEMLIMIT, alg) == 0);
+        memset(&state, 0, sizeof state);
+        assert(crypto_pwhash_progress(out2, sizeof out2, "password", 8, salt,
+                                      OPSLIMIT, MEMLIMIT, alg,
+                                      progress_cb, &state) == 0);
+        assert(memcmp(out, out2, sizeof out) == 0);
+        assert(state.calls == OPSLIMIT * 4U && state.total == state.calls);
+
+        memset(&state, 0, sizeof state);
+        state.stop_after = 5U;
+        assert(crypto_pwhash_progress(out2, sizeof out2, "password", 8, salt,
+                                      OPSLIMIT, MEMLIMIT, alg,
+                                      progress_cb, &state) == -1);
+        assert(errno == ECANCELED);
+        assert(state.calls == 5U);
+        assert(sodium_is_zero(out2, sizeof out2));
+    }
+    memset(&state, 0, sizeof state);
+    assert(crypto_pwhash_str_progress(str, "password", 8, OPSLIMIT, MEMLIMIT,
+                                      progress_cb, &state) == 0);
+    assert(crypto_pwhash_str_verify(str, "password", 8) == 0);
+    memset(&state, 0, sizeof state);
+    state.stop_after = 1U;
+    assert(crypto_pwhash_str_progress(str, "password", 8, OPSLIMIT, MEMLIMIT,
+                                      progress_cb, &state) == -1);
+    assert(errno == ECANCELED);
+    assert(sodium_is_zero((const unsigned char *) str, sizeof str));
+}
+
 int
 main(void)
 {
@@ -400,6 +662,10 @@ main(void)
     tv2();
     tv3();
     str_tests();
+    calibrate_tests();
+    verify_many_tests();
+    many_tests();
+    progress_tests();
 
     assert(crypto_pwhash_bytes_min() > 0U);
     assert(crypto_pwhash_bytes_max() > crypto_pwhash_bytes_min());
@@ -418,6 +684,10 @@ main(void)
     assert(crypto_pwhash_memlimit_moderate() > 0U);
     assert(crypto_pwhash_opslimit_sensitive() > 0U);
     assert(crypto_pwhash_memlimit_sensitive() > 0U);
+    assert(crypto_pwhash_argon2id_parallelism_min() ==
+           crypto_pwhash_argon2id_PARALLELISM_MIN);
+    assert(crypto_pwhash_argon2id_parallelism_max() ==
+           crypto_pwhash_argon2id_PARALLELISM_MAX);
     assert(strcmp(crypto_pwhash_primitive(), "argon2i") == 0);
 
     assert(crypto_pwhash_bytes_min() == crypto_pwhash_BYTES_MIN);
@@ -0,0 +1,133 @@
+
+#define TEST_NAME "pwhash_pbkdf2"
+#include "cmptest.h"
+
+typedef struct tv_pbkdf2 {
+    const char        *passwd;
+    size_t             passwdlen;
+    const char        *salt;
+    size_t             saltlen;
+    unsigned long long iterations;
+    size_t             outlen;
+} tv_pbkdf2;
+
+static const tv_pbkdf2 tests[] = {
+    { "password", 8U, "salt", 4U, 1U, 20U },
+    { "password", 8U, "salt", 4U, 2U, 32U },
+    { "password", 8U, "salt", 4U, 4096U, 32U },
+    { "passwordPASSWORDpassword", 24U,
+      "saltSALTsaltSALTsaltSALTsaltSALTsalt", 36U, 4096U, 40U },
+    { "pass\0word", 9U, "sa\0lt", 5U, 4096U, 16U },
+    { "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+      "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef",
+      128U, "", 0U, 1000U, 150U },
+};
+
+#define MULTI_COUNT 37U
+#define MULTI_BYTES 100U
+
+static void
+tv(void)
+{
+    unsigned char out[150];
+    char          hex[150 * 2 + 1];
+    size_t        i;
+
+    for (i = 0U; i < (sizeof tests) / (sizeof tests[0]); i++) {
+        if (crypto_pwhash_pbkdf2_sha256(out, tests[i].outlen, tests[i].passwd,
+                                        tests[i].passwdlen,
+                                        (const unsigned char *) tests[i].salt,
+                                        tests[i].saltlen,
+                                        tests[i].iterations) != 0) {
+            printf("pbkdf2_sha256 failed\n");
+        }
+        printf("%s\n", sodium_bin2hex(hex, sizeof hex, out, tests[i].outlen));
+        if (crypto_pwhash_pbkdf2_sha512(out, tests[i].outlen, tests[i].passwd,
+                                        tests[i].passwdlen,
+                                        (const unsigned char *) tests[i].salt,
+                                        tests[i].saltlen,
+                                        tests[i].iterations) != 0) {
+            printf("pbkdf2_sha512 failed\n");
+        }
+        printf("%s\n", sodium_bin2hex(hex, sizeof hex, out, tests[i].outlen));
+    }
+}
+
+static void
+tv_multi(void)
+{
+    unsigned char *out[MULTI_COUNT];
+    char          *passwds[MULTI_COUNT];
+    unsigned char *salts[MULTI_COUNT];
+    size_t         passwdlens[MULTI_COUNT];
+    size_t         saltlens[MULTI_COUNT];
+    unsigned char  expected[MULTI_BYTES];
+    size_t         i;
+
+    for (i = 0U; i < MULTI_COUNT; i++) {
+        passwdlens[i] = i * 5U;
+        saltlens[i]   = 16U + i;
+        passwds[i]    = (char *) sodium_malloc(passwdlens[i] + 1U);
+        salts[i]      = (unsigned char *) sodium_malloc(saltlens[i]);
+        out[i]        = (unsigned char *) sodium_malloc(MULTI_BYTES);
+        randombytes_buf(passwds[i], passwdlens[i]);
+        randombytes_buf(salts[i], saltlens[i]);
+    }
+    assert(crypto_pwhash_pbkdf2_sha256_multi(
+               out, MULTI_BYTES, (const char * const *) passwds, passwdlens,
+               (const unsigned char * const *) salts, saltlens, 100U,
+               MULTI_COUNT) == 0);
+    for (i = 0U; i < MULTI_COUNT; i++) {
+        assert(crypto_pwhash_pbkdf2_sha256(expected, MULTI_BYTES, passwds[i],
+                                           passwdlens[i], salts[i],
+                                           saltlens[i], 100U) == 0);
+        assert(memcmp(expected, out[i], MULTI_BYTES) == 0);
+    }
+    assert(crypto_pwhash_pbkdf2_sha512_multi(
+               out, MULTI_BYTES, (const char * const *) passwds, passwdlens,
+               (const unsigned char * const *) salts, saltlens, 100U,
+               MULTI_COUNT) == 0);
+    for (i = 0U; i < MULTI_COUNT; i++) {
+        assert(crypto_pwhash_pbkdf2_sha512(expected, MULTI_BYTES, passwds[i],
+                                           passwdlens[i], salts[i],
+                                           saltlens[i], 100U) == 0);
+        assert(memcmp(expected, out[i], MULTI_BYTES) == 0);
+    }
+    for (i = 0U; i < MULTI_COUNT; i++) {
+        sodium_free(passwds[i]);
+        sodium_free(salts[i]);
+        sodium_free(out[i]);
+    }
+}
+
+int
+main(void)
+{
+    unsigned char out[32];
+
+    tv();
+    tv_multi();
+
+    assert(crypto_pwhash_pbkdf2_sha256(out, 0U, "", 0U, out, 0U, 1U) == -1);
+    assert(crypto_pwhash_pbkdf2_sha256(out, sizeof out, "", 0U, out, 0U,
+                                       0U) == -1);
+    assert(crypto_pwhash_pbkdf2_sha512(out, 0U, "", 0U, out, 0U, 1U) == -1);
+    assert(crypto_pwhash_pbkdf2_sha512(out, sizeof out, "", 0U, out, 0U,
+                                       0U) == -1);
+    assert(crypto_pwhash_pbkdf2_sha256_bytes_min() ==
+           crypto_pwhash_pbkdf2_sha256_BYTES_MIN);
+    assert(crypto_pwhash_pbkdf2_sha256_bytes_max() ==
+           crypto_pwhash_pbkdf2_sha256_BYTES_MAX);
+    assert(crypto_pwhash_pbkdf2_sha256_iterations_min() ==
+           crypto_pwhash_pbkdf2_sha256_ITERATIONS_MIN);
+    assert(crypto_pwhash_pbkdf2_sha512_bytes_min() ==
+           crypto_pwhash_pbkdf2_sha512_BYTES_MIN);
+    assert(crypto_pwhash_pbkdf2_sha512_bytes_max() ==
+           crypto_pwhash_pbkdf2_sha512_BYTES_MAX);
+    assert(crypto_pwhash_pbkdf2_sha512_iterations_min() ==
+           crypto_pwhash_pbkdf2_sha512_ITERATIONS_MIN);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -20,15 +20,37 @@ static const uint64_t N3      = 16384U;
 static const uint32_t r3      = 8U;
 static const uint32_t p3      = 1U;
 
+typedef struct progress_state {
+    unsigned long long calls;
+    unsigned long long done;
+    unsigned long long total;
+    unsigned long long stop_after;
+} progress_state;
+
+static int
+progress_cb(void *opaque, unsigned long long done, unsigned long long total)
+{
+    progress_state *state = (progress_state *) opaque;
+
+    assert(done > state->done && done <= total);
+    state->calls++;
+    state->done  = done;
+    state->total = total;
+
+    return state->calls == state->stop_after;
+}
+
 static void
 tv(const char *passwd, const char *salt, uint64_t N, uint32_t r, uint32_t p)
 {
-    uint8_t data[64];
-    size_t  i;
-    size_t  olen       = (sizeof data / sizeof data[0]);
-    size_t  passwd_len = strlen(passwd);
-    size_t  salt_len   = strlen(salt);
-    int     line_items  = 0;
+    uint8_t        data[64];
+    uint8_t        data2[64];
+    progress_state state;
+    size_t         i;
+    size_t         olen       = (sizeof data / sizeof data[0]);
+    size_t         passwd_len = strlen(passwd);
+    size_t         salt_len   = strlen(salt);
+    int            line_items  = 0;
 
     if (crypto_pwhash_scryptsalsa208sha256_ll(
             (const uint8_t *) passwd, passwd_len, (const uint8_t *) salt,
@@ -37,6 +59,17 @@ tv(const char *passwd, const char *salt, uint64_t N, uint32_t r, uint32_t p)
                salt);
         return;
     }
+    assert(crypto_pwhash_scryptsalsa208sha256_ll_threads(
+               (const uint8_t *) passwd, passwd_len, (const uint8_t *) salt,
+               salt_len, N, r, p, 4U, data2, olen) == 0);
+    assert(memcmp(data, data2, olen) == 0);
+    memset(&state, 0, sizeof state);
+    assert(crypto_pwhash_scryptsalsa208sha256_ll_progress(
+               (const uint8_t *) passwd, passwd_len, (const uint8_t *) salt,
+               salt_len, N, r, p, data2, olen, progress_cb, &state) == 0);
+    assert(memcmp(data, data2, olen) == 0);
+    assert(state.calls > 0U && state.done == 2U * N * p);
+    assert(state.total == state.done);
 
     printf("scrypt('%s', '%s', %lu, %lu, %lu, %lu) =\n", passwd, salt,
            (unsigned long) N, (unsigned long) r, (unsigned long) p,
@@ -48,12 +81,62 @@ tv(const char *passwd, const char *salt, uint64_t N, uint32_t r, uint32_t p)
     }
 }
 
+static void
+tv_threads(void)
+{
+    uint8_t  out1[32];
+    uint8_t  out2[32];
+    uint32_t p;
+    uint32_t r;
+    unsigned int threads;
+
+    for (r = 1U; r <= 3U; r++) {
+        for (p = 1U; p <= 5U; p++) {
+            assert(crypto_pwhash_scryptsalsa208sha256_ll(
+                       (const uint8_t *) passwd2, strlen(passwd2),
+                       (const uint8_t *) salt2, strlen(salt2), 64U, r, p,
+                       out1, sizeof out1) == 0);
+            for (threads = 2U; threads <= 5U; threads++) {
+                assert(crypto_pwhash_scryptsalsa208sha256_ll_threads(
+                           (const uint8_t *) passwd2, strlen(passwd2),
+                           (const uint8_t *) salt2, strlen(salt2), 64U, r, p,
+                           threads, out2, sizeof out2) == 0);
+                assert(memcmp(out1, out2, sizeof out1) == 0);
+            }
+        }
+    }
+}
+
+static void
+tv_progress_cancel(void)
+{
+    uint8_t        out[32];
+    progress_state state;
+
+    memset(&state, 0, sizeof state);
+    state.stop_after = 2U;
+    assert(crypto_pwhash_scryptsalsa208sha256_ll_progress(
+               (const uint8_t *) passwd3, strlen(passwd3),
+               (const uint8_t *) salt3, strlen(salt3), N3, r3, p3,
+               out, sizeof out, progress_cb, &state) == -1);
+    assert(errno == ECANCELED);
+    assert(state.calls == 2U && state.done < state.total);
+}
+
 int
 main(void)
 {
+    uint8_t out[16];
+
     tv(passwd1, salt1, N1, r1, p1);
     tv(passwd2, salt2, N2, r2, p2);
     tv(passwd3, salt3, N3, r3, p3);
+    tv_threads();
+    tv_progress_cancel();
+
+    assert(crypto_pwhash_scryptsalsa208sha256_ll_threads(
+               (const uint8_t *) passwd1, 0U, (const uint8_t *) salt1, 0U,
+               N1, r1, p1, 0U, out, sizeof out) == -1);
 
     return 0;
 }
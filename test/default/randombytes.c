@@ -100,6 +100,13 @@ randombytes_tests(void)
             printf("randombytes_buf() test failed\n");
         }
     }
+    for (i = 0; i < 1000; ++i) {
+        randombytes_buf(out, 24U);
+        randombytes_buf(out + 24, 24U);
+        assert(memcmp(out, out + 24, 24U) != 0);
+        randombytes_buf(x, 1U + i % 300U);
+        (void) randombytes_random();
+    }
     assert(randombytes_uniform(1U) == 0U);
 
     randombytes_buf_deterministic(out, sizeof out, seed);
@@ -119,6 +126,232 @@ randombytes_tests(void)
     return 0;
 }
 
+static void
+deterministic_many_tests(void)
+{
+    static const size_t sizes[] = { 0U, 1U, 63U, 64U, 65U, 200U, 256U, 1000U };
+    unsigned char      *outs[19];
+    unsigned char      *seeds[19];
+    unsigned char       expected[1000];
+    size_t              i;
+    size_t              j;
+    size_t              n;
+
+    for (i = 0U; i < 19U; i++) {
+        outs[i]  = (unsigned char *) sodium_malloc(1000U);
+        seeds[i] = (unsigned char *) sodium_malloc(randombytes_SEEDBYTES);
+        randombytes_buf(seeds[i], randombytes_SEEDBYTES);
+    }
+    for (n = 0U; n <= 19U; n += 1U + n / 2U) {
+        for (j = 0U; j < sizeof sizes / sizeof sizes[0]; j++) {
+            randombytes_buf_deterministic_many
+                (outs, sizes[j], (const unsigned char * const *) seeds, n);
+            for (i = 0U; i < n; i++) {
+                randombytes_buf_deterministic(expected, sizes[j], seeds[i]);
+                assert(memcmp(outs[i], expected, sizes[j]) == 0);
+            }
+        }
+    }
+    for (i = 0U; i < 19U; i++) {
+        sodium_free(seeds[i]);
+        sodium_free(outs[i]);
+    }
+}
+
+static void
+uniform_many_tests(void)
+{
+    static uint32_t out32[10000];
+    static uint64_t out64[1000];
+    unsigned int    freq[10];
+    size_t          i;
+
+    memset(freq, 0, sizeof freq);
+    randombytes_uniform_many(out32, 10000U, 10U);
+    for (i = 0; i < 10000U; ++i) {
+        assert(out32[i] < 10U);
+        freq[out32[i]]++;
+    }
+    for (i = 0; i < 10U; ++i) {
+        assert(freq[i] > 0U);
+    }
+    randombytes_uniform_many(out32, 10U, 1U);
+    for (i = 0; i < 10U; ++i) {
+        assert(out32[i] == 0U);
+    }
+    randombytes_uniform_many(out32, 0U, 10U);
+    randombytes_uniform64_many(out64, 1000U, 0x8000000000000001ULL);
+    for (i = 0; i < 1000U; ++i) {
+        assert(out64[i] < 0x8000000000000001ULL);
+    }
+    memset(freq, 0, sizeof freq);
+    randombytes_uniform64_many(out64, 1000U, 3U);
+    for (i = 0; i < 1000U; ++i) {
+        assert(out64[i] < 3U);
+        freq[out64[i]]++;
+    }
+    assert(freq[0] > 0U && freq[1] > 0U && freq[2] > 0U);
+}
+
+#ifndef __EMSCRIPTEN__
+static void
+chacha12_tests(void)
+{
+    unsigned char out[100];
+    unsigned int  i;
+
+    randombytes_close();
+    randombytes_set_implementation(&randombytes_chacha12_implementation);
+    assert(strcmp(randombytes_implementation_name(), "chacha12") == 0);
+    for (i = 0; i < 1000; ++i) {
+        randombytes_buf(out, 24U);
+        randombytes_buf(out + 24, 24U);
+        assert(memcmp(out, out + 24, 24U) != 0);
+        randombytes_buf(out, 1U + i % (unsigned int) sizeof out);
+        (void) randombytes_random();
+    }
+    assert(randombytes_uniform(1U) == 0U);
+    randombytes_close();
+    randombytes_set_implementation(&randombytes_internal_implementation);
+}
+#endif
+
+#ifndef __EMSCRIPTEN__
+static void
+percpu_tests(void)
+{
+    unsigned char out[100];
+    unsigned int  i;
+
+    randombytes_close();
+    randombytes_set_implementation(&randombytes_percpu_implementation);
+    assert(strcmp(randombytes_implementation_name(), "percpu") == 0);
+    for (i = 0; i < 1000; ++i) {
+        randombytes_buf(out, 24U);
+        randombytes_buf(out + 24, 24U);
+        assert(memcmp(out, out + 24, 24U) != 0);
+        randombytes_buf(out, 1U + i % (unsigned int) sizeof out);
+        (void) randombytes_random();
+        if (i % 100U == 0U) {
+            randombytes_stir();
+            assert(randombytes_internal_reseed() == 0);
+        }
+    }
+    randombytes_buf(x, sizeof x);
+    assert(randombytes_uniform(1U) == 0U);
+    randombytes_close();
+    randombytes_set_implementation(&randombytes_internal_implementation);
+}
+#endif
+
+#if defined(HAVE_PTHREAD) && !defined(_WIN32) && !defined(__EMSCRIPTEN__) && \
+    !defined(__wasi__)
+# include <sys/wait.h>
+# include <unistd.h>
+
+static void
+fork_tests(randombytes_implementation *impl)
+{
+    unsigned char parent[32];
+    unsigned char child[32];
+    int           fds[2];
+    int           status;
+    pid_t         pid;
+
+    randombytes_set_implementation(impl);
+    (void) randombytes_random();
+    assert(pipe(fds) == 0);
+    if ((pid = fork()) == 0) {
+        randombytes_buf(child, sizeof child);
+        _exit(write(fds[1], child, sizeof child) == (ssize_t) sizeof child ?
+              0 : 1);
+    }
+    assert(pid > 0);
+    randombytes_buf(parent, sizeof parent);
+    assert(read(fds[0], child, sizeof child) == (ssize_t) sizeof child);
+    assert(waitpid(pid, &status, 0) == pid);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(memcmp(parent, child, sizeof parent) != 0);
+    close(fds[0]);
+    close(fds[1]);
+    randombytes_set_implementation(&randombytes_internal_implementation);
+}
+
+# if defined(__linux__)
+#  include <signal.h>
+#  include <sys/syscall.h>
+# endif
+
+static void
+clone_tests(randombytes_implementation *impl)
+{
+# if defined(__linux__) && defined(SYS_clone)
+    unsigned char parent[32];
+    unsigned char child[32];
+    int           fds[2];
+    int           status;
+    pid_t         pid;
+
+    randombytes_set_implementation(impl);
+    (void) randombytes_random();
+    assert(pipe(fds) == 0);
+    /* no pthread_atfork() handlers run in this child */
+    if ((pid = (pid_t) syscall(SYS_clone, SIGCHLD, 0, 0, 0, 0)) == 0) {
+        randombytes_buf(child, sizeof child);
+        _exit(write(fds[1], child, sizeof child) == (ssize_t) sizeof child ?
+              0 : 1);
+    }
+    assert(pid > 0);
+    randombytes_buf(parent, sizeof parent);
+    assert(waitpid(pid, &status, 0) == pid);
+    /* the child either reseeds or aborts, but never reuses our stream */
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        assert(read(fds[0], child, sizeof child) == (ssize_t) sizeof child);
+        assert(memcmp(parent, child, sizeof parent) != 0);
+    } else {
+        assert(WIFSIGNALED(status));
+    }
+    close(fds[0]);
+    close(fds[1]);
+    randombytes_set_implementation(&randombytes_internal_implementation);
+# else
+    (void) impl;
+# endif
+}
+#endif
+
+#ifndef __EMSCRIPTEN__
+static void
+reseed_tests(void)
+{
+    unsigned char out[2][4096];
+    unsigned int  i;
+    int           hwrand;
+
+    randombytes_set_implementation(&randombytes_internal_implementation);
+    assert(randombytes_internal_set_reseed(2, 1U) == -1 && errno == EINVAL);
+    hwrand = randombytes_internal_set_reseed(RANDOMBYTES_INTERNAL_RESEED_HWRAND, 1U);
+    assert(hwrand == 0 || errno == ENOSYS);
+    if (hwrand != 0) {
+        assert(randombytes_internal_set_reseed(RANDOMBYTES_INTERNAL_RESEED_OS,
+                                               1U) == 0);
+    }
+    for (i = 0; i < 100; i++) {
+        randombytes_buf(out[0], 1U + i * 40U);
+        (void) randombytes_random();
+        if (i % 10U == 0U) {
+            assert(randombytes_internal_reseed() == 0);
+        }
+    }
+    randombytes_buf(out[0], sizeof out[0]);
+    assert(randombytes_internal_reseed() == 0);
+    randombytes_buf(out[1], sizeof out[1]);
+    assert(memcmp(out[0], out[1], sizeof out[0]) != 0);
+    assert(randombytes_internal_set_reseed(RANDOMBYTES_INTERNAL_RESEED_OS,
+                                           0U) == 0);
+}
+#endif
+
 static uint32_t
 randombytes_uniform_impl(const uint32_t upper_bound)
 {
@@ -130,6 +363,7 @@ impl_tests(void)
 {
     randombytes_implementation impl = randombytes_sysrandom_implementation;
     uint32_t                   v = randombytes_random();
+    uint32_t                   w[2];
 
     impl.uniform = randombytes_uniform_impl;
     randombytes_close();
@@ -139,6 +373,8 @@ impl_tests(void)
     assert(randombytes_uniform(v) == v);
     assert(randombytes_uniform(v) == v);
     assert(randombytes_uniform(v) == v);
+    randombytes_uniform_many(w, 2U, v);
+    assert(w[0] == v && w[1] == v);
     randombytes_close();
     impl.close = NULL;
     randombytes_close();
@@ -151,8 +387,20 @@ main(void)
 {
     compat_tests();
     randombytes_tests();
+    uniform_many_tests();
+    deterministic_many_tests();
 #ifndef __EMSCRIPTEN__
+    reseed_tests();
+    chacha12_tests();
+    percpu_tests();
     impl_tests();
+#endif
+#if defined(HAVE_PTHREAD) && !defined(_WIN32) && !defined(__EMSCRIPTEN__) && \
+    !defined(__wasi__)
+    fork_tests(&randombytes_internal_implementation);
+    fork_tests(&randombytes_percpu_implementation);
+    clone_tests(&randombytes_internal_implementation);
+    clone_tests(&randombytes_percpu_implementation);
 #endif
     printf("OK\n");
 
@@ -22,6 +22,64 @@ static const unsigned char small_order_p[crypto_scalarmult_BYTES] = {
 
 static char hex[crypto_scalarmult_BYTES * 2 + 1];
 
+#define BATCH_COUNT 70
+
+static void
+batch(void)
+{
+    unsigned char  *ns  = (unsigned char *) sodium_malloc(BATCH_COUNT * 32);
+    unsigned char  *ps  = (unsigned char *) sodium_malloc(BATCH_COUNT * 32);
+    unsigned char  *qs  = (unsigned char *) sodium_malloc(BATCH_COUNT * 32);
+    unsigned char  *q   = (unsigned char *) sodium_malloc(32);
+    unsigned char  *qv[BATCH_COUNT];
+    const unsigned char *nv[BATCH_COUNT];
+    const unsigned char *pv[BATCH_COUNT];
+    size_t          i;
+
+    assert(ns != NULL && ps != NULL && qs != NULL && q != NULL);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        randombytes_buf(&ns[i * 32], 32);
+        randombytes_buf(q, 32);
+        crypto_scalarmult_base(&ps[i * 32], q);
+        ps[i * 32 + 31] |= (unsigned char) ((i & 1) << 7);
+        qv[i] = &qs[i * 32];
+        nv[i] = &ns[i * 32];
+        pv[i] = &ps[i * 32];
+    }
+    assert(crypto_scalarmult_curve25519_batch(qv, nv, pv, 0) == 0);
+    assert(crypto_scalarmult_curve25519_batch(qv, nv, pv, BATCH_COUNT) == 0);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        assert(crypto_scalarmult(q, nv[i], pv[i]) == 0);
+        assert(memcmp(q, qv[i], 32) == 0);
+    }
+    assert(crypto_scalarmult_curve25519_batch(qv, nv, pv, 3) == 0);
+    for (i = 0; i < 3; i++) {
+        assert(crypto_scalarmult(q, nv[i], pv[i]) == 0);
+        assert(memcmp(q, qv[i], 32) == 0);
+    }
+    pv[BATCH_COUNT / 2] = small_order_p;
+    memset(qs, 0xff, BATCH_COUNT * 32);
+    assert(crypto_scalarmult_curve25519_batch(qv, nv, pv, BATCH_COUNT) == -1);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        if (i == BATCH_COUNT / 2) {
+            continue;
+        }
+        assert(crypto_scalarmult(q, nv[i], pv[i]) == 0);
+        assert(memcmp(q, qv[i], 32) == 0);
+    }
+
+    crypto_scalarmult_curve25519_base_batch(qs, ns, 0);
+    crypto_scalarmult_curve25519_base_batch(qs, ns, BATCH_COUNT);
+    for (i = 0; i < BATCH_COUNT; i++) {
+        crypto_scalarmult_base(q, &ns[i * 32]);
+        assert(memcmp(q, &qs[i * 32], 32) == 0);
+    }
+    sodium_free(q);
+    sodium_free(qs);
+    sodium_free(ps);
+    sodium_free(ns);
+}
+
 int
 main(void)
 {
@@ -61,6 +119,8 @@ main(void)
     ret = crypto_scalarmult(k, bobsk, small_order_p);
     assert(ret == -1);
 
+    batch();
+
     sodium_free(bobpk);
     sodium_free(alicepk);
     sodium_free(k);
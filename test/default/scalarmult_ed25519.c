@@ -19,6 +19,42 @@ static const unsigned char B[32] = {
     0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66
 };
 
+static void
+multi_scalarmult(size_t count)
+{
+    unsigned char *ns = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char *ps = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char  q[crypto_scalarmult_ed25519_BYTES];
+    unsigned char  q2[crypto_scalarmult_ed25519_BYTES];
+    unsigned char  t[crypto_scalarmult_ed25519_BYTES];
+    size_t         i;
+
+    for (i = 0U; i < count; i++) {
+        crypto_core_ed25519_scalar_random(&ns[i * 32U]);
+        crypto_core_ed25519_random(&ps[i * 32U]);
+    }
+    if (crypto_scalarmult_ed25519_multi_noclamp(q, ns, ps, count) != 0) {
+        printf("crypto_scalarmult_ed25519_multi_noclamp(%u) != 0\n",
+               (unsigned int) count);
+    }
+    assert(crypto_scalarmult_ed25519_noclamp(q2, ns, ps) == 0);
+    for (i = 1U; i < count; i++) {
+        assert(crypto_scalarmult_ed25519_noclamp(t, &ns[i * 32U],
+                                                 &ps[i * 32U]) == 0);
+        assert(crypto_core_ed25519_add(q2, q2, t) == 0);
+    }
+    assert(memcmp(q, q2, sizeof q) == 0);
+
+    memcpy(ps, non_canonical_p, 32U);
+    assert(crypto_scalarmult_ed25519_multi_noclamp(q, ns, ps, count) == -1);
+    memset(ns, 0, count * 32U);
+    assert(crypto_scalarmult_ed25519_multi_noclamp(q, ns, &ps[32U],
+                                                   count - 1U) == -1);
+
+    sodium_free(ps);
+    sodium_free(ns);
+}
+
 int
 main(void)
 {
@@ -125,6 +161,11 @@ main(void)
     sodium_free(p);
     sodium_free(n);
 
+    multi_scalarmult(2U);
+    multi_scalarmult(64U);
+    multi_scalarmult(600U);
+    multi_scalarmult(1000U);
+
     assert(crypto_scalarmult_ed25519_BYTES == crypto_scalarmult_ed25519_bytes());
     assert(crypto_scalarmult_ed25519_SCALARBYTES == crypto_scalarmult_ed25519_scalarbytes());
 
@@ -3,6 +3,121 @@
 
 #define B_HEX "e2f2ae0a6abc4e71a884a961c500515f58e30b6aa582dd8db6a65945e08d2d76"
 
+static void
+multi_scalarmult(size_t count)
+{
+    unsigned char *ns = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char *ps = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char  q[crypto_scalarmult_ristretto255_BYTES];
+    unsigned char  q2[crypto_scalarmult_ristretto255_BYTES];
+    unsigned char  t[crypto_scalarmult_ristretto255_BYTES];
+    size_t         i;
+
+    for (i = 0U; i < count; i++) {
+        crypto_core_ristretto255_scalar_random(&ns[i * 32U]);
+        crypto_core_ristretto255_random(&ps[i * 32U]);
+    }
+    if (crypto_scalarmult_ristretto255_multi(q, ns, ps, count) != 0) {
+        printf("crypto_scalarmult_ristretto255_multi(%u) != 0\n",
+               (unsigned int) count);
+    }
+    assert(crypto_scalarmult_ristretto255(q2, ns, ps) == 0);
+    for (i = 1U; i < count; i++) {
+        assert(crypto_scalarmult_ristretto255(t, &ns[i * 32U],
+                                              &ps[i * 32U]) == 0);
+        assert(crypto_core_ristretto255_add(q2, q2, t) == 0);
+    }
+    assert(memcmp(q, q2, sizeof q) == 0);
+
+    memset(ps, 0xfe, 32U);
+    assert(crypto_scalarmult_ristretto255_multi(q, ns, ps, count) == -1);
+    memset(ns, 0, count * 32U);
+    assert(crypto_scalarmult_ristretto255_multi(q, ns, &ps[32U],
+                                                count - 1U) == -1);
+
+    sodium_free(ps);
+    sodium_free(ns);
+}
+
+static void
+msm_fixed(size_t count)
+{
+    crypto_scalarmult_ristretto255_msm_table *table;
+    unsigned char *ns = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char *ps = (unsigned char *) sodium_malloc(count * 32U);
+    unsigned char  q[crypto_scalarmult_ristretto255_BYTES];
+    unsigned char  q2[crypto_scalarmult_ristretto255_BYTES];
+    size_t         i;
+    int            round;
+
+    for (i = 0U; i < count; i++) {
+        crypto_core_ristretto255_random(&ps[i * 32U]);
+    }
+    table = crypto_scalarmult_ristretto255_msm_precompute(ps, count);
+    assert(table != NULL);
+    for (round = 0; round < 2; round++) {
+        for (i = 0U; i < count; i++) {
+            crypto_core_ristretto255_scalar_random(&ns[i * 32U]);
+        }
+        if (round == 1) {
+            memset(ns, 0xff, 32U);
+        }
+        assert(crypto_scalarmult_ristretto255_msm_fixed(q, ns, count,
+                                                        table) == 0);
+        assert(crypto_scalarmult_ristretto255_multi(q2, ns, ps, count) == 0);
+        assert(memcmp(q, q2, sizeof q) == 0);
+        assert(crypto_scalarmult_ristretto255_msm_fixed(q, ns, count / 2U + 1U,
+                                                        table) == 0);
+        assert(crypto_scalarmult_ristretto255_multi(q2, ns, ps,
+                                                    count / 2U + 1U) == 0);
+        assert(memcmp(q, q2, sizeof q) == 0);
+    }
+    assert(crypto_scalarmult_ristretto255_msm_fixed(q, ns, count + 1U,
+                                                    table) == -1);
+    memset(ns, 0, count * 32U);
+    assert(crypto_scalarmult_ristretto255_msm_fixed(q, ns, count,
+                                                    table) == -1);
+    crypto_scalarmult_ristretto255_msm_free(table);
+
+    memset(&ps[(count - 1U) * 32U], 0xfe, 32U);
+    assert(crypto_scalarmult_ristretto255_msm_precompute(ps, count) == NULL);
+
+    sodium_free(ps);
+    sodium_free(ns);
+}
+
+static void
+table_scalarmult(void)
+{
+    crypto_scalarmult_ristretto255_table *table;
+    unsigned char  n[crypto_scalarmult_ristretto255_SCALARBYTES];
+    unsigned char  p[crypto_scalarmult_ristretto255_BYTES];
+    unsigned char  q[crypto_scalarmult_ristretto255_BYTES];
+    unsigned char  q2[crypto_scalarmult_ristretto255_BYTES];
+    int            i;
+
+    table = (crypto_scalarmult_ristretto255_table *)
+        sodium_malloc(crypto_scalarmult_ristretto255_tablebytes());
+    crypto_core_ristretto255_random(p);
+    assert(crypto_scalarmult_ristretto255_table_create(table, p) == 0);
+    for (i = 0; i < 100; i++) {
+        crypto_core_ristretto255_scalar_random(n);
+        if (i == 1) {
+            memset(n, 0xff, sizeof n);
+        }
+        assert(crypto_scalarmult_ristretto255_table_mul(q, n, table) == 0);
+        assert(crypto_scalarmult_ristretto255(q2, n, p) == 0);
+        assert(memcmp(q, q2, sizeof q) == 0);
+    }
+    memset(n, 0, sizeof n);
+    assert(crypto_scalarmult_ristretto255_table_mul(q, n, table) == -1);
+
+    memset(p, 0xfe, sizeof p);
+    assert(crypto_scalarmult_ristretto255_table_create(table, p) == -1);
+
+    sodium_free(table);
+}
+
 int
 main(void)
 {
@@ -36,6 +151,15 @@ main(void)
     memset(p, 0xfe, crypto_scalarmult_ristretto255_BYTES);
     assert(crypto_scalarmult_ristretto255(guard_page, n, p) == -1);
 
+    multi_scalarmult(2U);
+    multi_scalarmult(64U);
+    multi_scalarmult(600U);
+    multi_scalarmult(1000U);
+    table_scalarmult();
+    msm_fixed(1U);
+    msm_fixed(64U);
+    msm_fixed(600U);
+
     sodium_free(hex);
     sodium_free(p2);
     sodium_free(p);
@@ -44,6 +168,7 @@ main(void)
 
     assert(crypto_scalarmult_ristretto255_BYTES == crypto_scalarmult_ristretto255_bytes());
     assert(crypto_scalarmult_ristretto255_SCALARBYTES == crypto_scalarmult_ristretto255_scalarbytes());
+    assert(sizeof(crypto_scalarmult_ristretto255_table) == crypto_scalarmult_ristretto255_tablebytes());
 
     printf("OK\n");
 
@@ -27,6 +27,72 @@ static unsigned char m[131] = {
     0xe0, 0x82, 0xf9, 0x37, 0x76, 0x38, 0x48, 0x64, 0x5e, 0x07, 0x05
 };
 
+static void
+large_messages(void)
+{
+    unsigned char *big_m;
+    unsigned char *big_c;
+    unsigned char *big_m2;
+    size_t         big_len = 50000U;
+
+    big_m  = (unsigned char *) sodium_malloc(big_len);
+    big_c  = (unsigned char *) sodium_malloc(big_len + crypto_secretbox_MACBYTES);
+    big_m2 = (unsigned char *) sodium_malloc(big_len);
+    randombytes_buf(big_m, big_len);
+    crypto_secretbox_easy(big_c, big_m, big_len, nonce, firstkey);
+    assert(crypto_secretbox_open_easy(big_m2, big_c,
+                                      big_len + crypto_secretbox_MACBYTES,
+                                      nonce, firstkey) == 0);
+    assert(memcmp(big_m, big_m2, big_len) == 0);
+    big_c[crypto_secretbox_MACBYTES + big_len / 2]++;
+    assert(crypto_secretbox_open_easy(big_m2, big_c,
+                                      big_len + crypto_secretbox_MACBYTES,
+                                      nonce, firstkey) == -1);
+    assert(sodium_is_zero(big_m2, big_len));
+    big_c[crypto_secretbox_MACBYTES + big_len / 2]--;
+    assert(crypto_secretbox_open_easy(big_c, big_c,
+                                      big_len + crypto_secretbox_MACBYTES,
+                                      nonce, firstkey) == 0);
+    assert(memcmp(big_m, big_c, big_len) == 0);
+    sodium_free(big_m2);
+    sodium_free(big_c);
+    sodium_free(big_m);
+}
+
+static void
+inplace_forgeries(void)
+{
+    unsigned char  buf[64 + crypto_secretbox_MACBYTES];
+    unsigned char  copy[64 + crypto_secretbox_MACBYTES];
+    unsigned char *c;
+    size_t         mlen;
+
+    /* A failed in-place open must leave the ciphertext and the MAC intact */
+    for (mlen = 0U; mlen <= 32U; mlen++) {
+        crypto_secretbox_easy(buf, m, mlen, nonce, firstkey);
+        buf[randombytes_uniform((uint32_t) mlen + crypto_secretbox_MACBYTES)]++;
+        memcpy(copy, buf, mlen + crypto_secretbox_MACBYTES);
+        assert(crypto_secretbox_open_easy(buf, buf,
+                                          mlen + crypto_secretbox_MACBYTES,
+                                          nonce, firstkey) == -1);
+        assert(memcmp(buf, copy, mlen + crypto_secretbox_MACBYTES) == 0);
+    }
+
+    /* The output overlaps the MAC, but not the ciphertext */
+    c = (unsigned char *) sodium_malloc(32U);
+    crypto_secretbox_detached(c, buf + 8, m, 32U, nonce, firstkey);
+    c[0]++;
+    memcpy(copy, buf, sizeof buf);
+    assert(crypto_secretbox_open_detached(buf, c, buf + 8, 32U,
+                                          nonce, firstkey) == -1);
+    assert(memcmp(buf, copy, sizeof buf) == 0);
+    c[0]--;
+    assert(crypto_secretbox_open_detached(buf, c, buf + 8, 32U,
+                                          nonce, firstkey) == 0);
+    assert(memcmp(buf, m, 32U) == 0);
+    sodium_free(c);
+}
+
 int
 main(void)
 {
@@ -120,5 +186,8 @@ main(void)
     sodium_free(mac);
     sodium_free(c);
 
+    large_messages();
+    inplace_forgeries();
+
     return 0;
 }
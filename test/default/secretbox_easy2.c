@@ -61,6 +61,16 @@ main(void)
     }
     printf("%d\n", memcmp(m, c, mlen));
 
+    /* in-place, with the output overlapping the MAC */
+    for (i = 1; i <= 2 * crypto_secretbox_MACBYTES && i <= mlen; i++) {
+        memcpy(c, m, i);
+        crypto_secretbox_easy(c, c, (unsigned long long) i, nonce, k);
+        assert(crypto_secretbox_open_easy(
+                   c, c, (unsigned long long) i + crypto_secretbox_MACBYTES,
+                   nonce, k) == 0);
+        assert(memcmp(m, c, i) == 0);
+    }
+
     sodium_free(m);
     sodium_free(m2);
     sodium_free(c);
@@ -16,8 +16,10 @@ main(void)
     unsigned long long  res_len;
     size_t              ad_len;
     size_t              m1_len, m2_len, m3_len;
+    unsigned char       mac[crypto_secretstream_xchacha20poly1305_MACBYTES];
     int                 ret;
     unsigned char       tag;
+    unsigned char       enc_tag;
 
     state = (crypto_secretstream_xchacha20poly1305_state *)
         sodium_malloc(crypto_secretstream_xchacha20poly1305_statebytes());
@@ -289,6 +291,112 @@ main(void)
     assert(tag == 0);
     assert(memcmp(m2, m2_, m2_len) == 0);
 
+    /* detached, in place */
+
+    ret = crypto_secretstream_xchacha20poly1305_init_push(state, header, k);
+    assert(ret == 0);
+    memcpy(statesave, state, sizeof *state);
+    ret = crypto_secretstream_xchacha20poly1305_push
+        (state, c1, NULL, m1_, m1_len, ad, ad_len, 0);
+    assert(ret == 0);
+
+    memcpy(state, statesave, sizeof *state);
+    memcpy(csave, m1_, m1_len);
+    ret = crypto_secretstream_xchacha20poly1305_push_detached
+        (state, csave, &enc_tag, mac, csave, m1_len, ad, ad_len, 0);
+    assert(ret == 0);
+    assert(enc_tag == c1[0]);
+    assert(memcmp(csave, c1 + 1, m1_len) == 0);
+    assert(memcmp(mac, c1 + 1 + m1_len, sizeof mac) == 0);
+    ret = crypto_secretstream_xchacha20poly1305_push_detached
+        (state, c2 + 1, c2, c2 + 1 + m2_len, m2_, m2_len, NULL, 0,
+         crypto_secretstream_xchacha20poly1305_TAG_FINAL);
+    assert(ret == 0);
+
+    ret = crypto_secretstream_xchacha20poly1305_init_pull(state, header, k);
+    assert(ret == 0);
+    ret = crypto_secretstream_xchacha20poly1305_pull_detached
+        (state, csave, &tag, csave, m1_len, &enc_tag, mac, ad, ad_len);
+    assert(ret == 0);
+    assert(tag == 0);
+    assert(memcmp(csave, m1_, m1_len) == 0);
+    memcpy(statesave, state, sizeof *state);
+    c2[m2_len + 1]++;
+    ret = crypto_secretstream_xchacha20poly1305_pull_detached
+        (state, m2, &tag, c2 + 1, m2_len, &c2[0], c2 + 1 + m2_len, NULL, 0);
+    assert(ret == -1);
+    assert(tag == 0xff);
+    c2[m2_len + 1]--;
+    assert(memcmp(statesave, state, sizeof *state) == 0);
+    ret = crypto_secretstream_xchacha20poly1305_pull
+        (state, m2, &res_len, &tag,
+         c2, m2_len + crypto_secretstream_xchacha20poly1305_ABYTES, NULL, 0);
+    assert(ret == 0);
+    assert(res_len == m2_len);
+    assert(tag == crypto_secretstream_xchacha20poly1305_TAG_FINAL);
+    assert(memcmp(m2, m2_, m2_len) == 0);
+
+    /* batch */
+
+    {
+        const unsigned char *ms[20];
+        unsigned long long   mlens[20];
+        unsigned char        tags[20];
+        unsigned char       *cs;
+        unsigned char       *cs2;
+        unsigned char       *p;
+        size_t               i;
+
+        cs = (unsigned char *) sodium_malloc
+            (20U * (740U + crypto_secretstream_xchacha20poly1305_ABYTES));
+        cs2 = (unsigned char *) sodium_malloc
+            (20U * (740U + crypto_secretstream_xchacha20poly1305_ABYTES));
+        for (i = 0U; i < 20U; i++) {
+            ms[i]    = m1_;
+            mlens[i] = (unsigned long long) (i * 37U) % (m1_len + 1U);
+            tags[i]  = i == 7U ? crypto_secretstream_xchacha20poly1305_TAG_REKEY : 0;
+        }
+        tags[19] = crypto_secretstream_xchacha20poly1305_TAG_FINAL;
+        ret = crypto_secretstream_xchacha20poly1305_init_push(state, header, k);
+        assert(ret == 0);
+        memcpy(statesave, state, sizeof *state);
+        ret = crypto_secretstream_xchacha20poly1305_push_many
+            (state, cs, &res_len, ms, mlens, tags, 20U);
+        assert(ret == 0);
+        memcpy(&state_copy, state, sizeof state_copy);
+        memcpy(state, statesave, sizeof *state);
+        p = cs2;
+        for (i = 0U; i < 20U; i++) {
+            ret = crypto_secretstream_xchacha20poly1305_push
+                (state, p, NULL, ms[i], mlens[i], NULL, 0, tags[i]);
+            assert(ret == 0);
+            p += mlens[i] + crypto_secretstream_xchacha20poly1305_ABYTES;
+        }
+        assert(res_len == (unsigned long long) (p - cs2));
+        assert(memcmp(cs, cs2, (size_t) res_len) == 0);
+        assert(memcmp(&state_copy, state, sizeof *state) == 0);
+
+        ret = crypto_secretstream_xchacha20poly1305_init_pull(state, header, k);
+        assert(ret == 0);
+        p = cs;
+        for (i = 0U; i < 20U; i++) {
+            ret = crypto_secretstream_xchacha20poly1305_pull
+                (state, m1, NULL, &tag, p,
+                 mlens[i] + crypto_secretstream_xchacha20poly1305_ABYTES,
+                 NULL, 0);
+            assert(ret == 0);
+            assert(tag == tags[i]);
+            assert(memcmp(m1, m1_, (size_t) mlens[i]) == 0);
+            p += mlens[i] + crypto_secretstream_xchacha20poly1305_ABYTES;
+        }
+        ret = crypto_secretstream_xchacha20poly1305_push_many
+            (state, cs, &res_len, ms, mlens, tags, 0U);
+        assert(ret == 0 && res_len == 0U);
+
+        sodium_free(cs2);
+        sodium_free(cs);
+    }
+
     sodium_free(m3_);
     sodium_free(m2_);
     sodium_free(m1_);
@@ -311,6 +419,8 @@ main(void)
            crypto_secretstream_xchacha20poly1305_HEADERBYTES);
     assert(crypto_secretstream_xchacha20poly1305_keybytes() ==
            crypto_secretstream_xchacha20poly1305_KEYBYTES);
+    assert(crypto_secretstream_xchacha20poly1305_macbytes() ==
+           crypto_secretstream_xchacha20poly1305_MACBYTES);
     assert(crypto_secretstream_xchacha20poly1305_messagebytes_max() ==
            crypto_secretstream_xchacha20poly1305_MESSAGEBYTES_MAX);
 
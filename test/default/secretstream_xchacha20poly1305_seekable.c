@@ -0,0 +1,135 @@
+#define TEST_NAME "secretstream_xchacha20poly1305_seekable"
+#include "cmptest.h"
+
+#define CHUNKS     10U
+#define CHUNK_SIZE 1000U
+
+int
+main(void)
+{
+    crypto_secretstream_xchacha20poly1305_state  state_copy;
+    crypto_secretstream_xchacha20poly1305_state *state;
+    unsigned char                               *header;
+    unsigned char                               *k;
+    unsigned char                               *c, *m, *m2;
+    unsigned char                                ad[10];
+    unsigned long long                           res_len;
+    size_t                                       clen;
+    size_t                                       i;
+    int                                          ret;
+    unsigned char                                tag;
+
+    state = (crypto_secretstream_xchacha20poly1305_state *)
+        sodium_malloc(crypto_secretstream_xchacha20poly1305_statebytes());
+    header = (unsigned char *)
+        sodium_malloc(crypto_secretstream_xchacha20poly1305_HEADERBYTES);
+    k = (unsigned char *)
+        sodium_malloc(crypto_secretstream_xchacha20poly1305_KEYBYTES);
+    clen = CHUNK_SIZE + crypto_secretstream_xchacha20poly1305_ABYTES;
+    c  = (unsigned char *) sodium_malloc(CHUNKS * clen);
+    m  = (unsigned char *) sodium_malloc(CHUNKS * CHUNK_SIZE);
+    m2 = (unsigned char *) sodium_malloc(CHUNKS * CHUNK_SIZE);
+
+    crypto_secretstream_xchacha20poly1305_keygen(k);
+    randombytes_buf(m, CHUNKS * CHUNK_SIZE);
+    randombytes_buf(ad, sizeof ad);
+
+    /* push in reverse order */
+
+    ret = crypto_secretstream_xchacha20poly1305_init_push_seekable(state, header, k);
+    assert(ret == 0);
+    state_copy = *state;
+    for (i = CHUNKS; i > 0U; i--) {
+        ret = crypto_secretstream_xchacha20poly1305_push_at
+            (state, c + (i - 1U) * clen, &res_len, m + (i - 1U) * CHUNK_SIZE,
+             CHUNK_SIZE, ad, sizeof ad, (uint64_t) (i - 1U),
+             i == CHUNKS ? crypto_secretstream_xchacha20poly1305_TAG_FINAL : 0);
+        assert(ret == 0);
+        assert(res_len == clen);
+    }
+    assert(memcmp(&state_copy, state, sizeof *state) == 0);
+
+    /* pull in a random order, using a separate state */
+
+    ret = crypto_secretstream_xchacha20poly1305_init_pull_seekable(state, header, k);
+    assert(ret == 0);
+    assert(memcmp(&state_copy, state, sizeof *state) == 0);
+    for (i = 0U; i < CHUNKS; i++) {
+        size_t j = (i * 7U) % CHUNKS;
+
+        ret = crypto_secretstream_xchacha20poly1305_pull_at
+            (state, m2 + j * CHUNK_SIZE, &res_len, &tag, c + j * clen, clen,
+             ad, sizeof ad, (uint64_t) j);
+        assert(ret == 0);
+        assert(res_len == CHUNK_SIZE);
+        assert(tag == (j == CHUNKS - 1U ?
+                       crypto_secretstream_xchacha20poly1305_TAG_FINAL : 0));
+    }
+    assert(memcmp(m, m2, CHUNKS * CHUNK_SIZE) == 0);
+
+    /* chunks are bound to their index, their ad and their length */
+
+    ret = crypto_secretstream_xchacha20poly1305_pull_at
+        (state, m2, NULL, &tag, c + clen, clen, ad, sizeof ad, 0U);
+    assert(ret == -1);
+    assert(tag == 0xff);
+    ret = crypto_secretstream_xchacha20poly1305_pull_at
+        (state, m2, NULL, &tag, c, clen, ad, sizeof ad - 1U, 0U);
+    assert(ret == -1);
+    ret = crypto_secretstream_xchacha20poly1305_pull_at
+        (state, m2, NULL, &tag, c, clen - 1U, ad, sizeof ad, 0U);
+    assert(ret == -1);
+    c[randombytes_uniform((uint32_t) clen)]++;
+    ret = crypto_secretstream_xchacha20poly1305_pull_at
+        (state, m2, NULL, &tag, c, clen, ad, sizeof ad, 0U);
+    assert(ret == -1);
+    ret = crypto_secretstream_xchacha20poly1305_pull_at
+        (state, m2, NULL, &tag, c, 0U, ad, sizeof ad, 0U);
+    assert(ret == -1);
+
+    /* out of range indices */
+
+    ret = crypto_secretstream_xchacha20poly1305_push_at
+        (state, c, &res_len, m, CHUNK_SIZE, NULL, 0U,
+         crypto_secretstream_xchacha20poly1305_INDEX_MAX + 1U, 0);
+    assert(ret == -1);
+    assert(res_len == 0U);
+    ret = crypto_secretstream_xchacha20poly1305_pull_at
+        (state, m2, NULL, &tag, c + clen, clen, ad, sizeof ad,
+         crypto_secretstream_xchacha20poly1305_INDEX_MAX + 1U);
+    assert(ret == -1);
+    ret = crypto_secretstream_xchacha20poly1305_push_at
+        (state, c, NULL, m, CHUNK_SIZE, NULL, 0U,
+         crypto_secretstream_xchacha20poly1305_INDEX_MAX, 0);
+    assert(ret == 0);
+    ret = crypto_secretstream_xchacha20poly1305_pull_at
+        (state, m2, NULL, &tag, c, clen, NULL, 0U,
+         crypto_secretstream_xchacha20poly1305_INDEX_MAX);
+    assert(ret == 0);
+    assert(memcmp(m, m2, CHUNK_SIZE) == 0);
+
+    /* seekable chunks are not regular stream chunks */
+
+    ret = crypto_secretstream_xchacha20poly1305_push_at
+        (state, c, NULL, m, CHUNK_SIZE, NULL, 0U, 1U, 0);
+    assert(ret == 0);
+    ret = crypto_secretstream_xchacha20poly1305_init_pull(state, header, k);
+    assert(ret == 0);
+    ret = crypto_secretstream_xchacha20poly1305_pull
+        (state, m2, NULL, &tag, c, clen, NULL, 0U);
+    assert(ret == -1);
+
+    sodium_free(m2);
+    sodium_free(m);
+    sodium_free(c);
+    sodium_free(k);
+    sodium_free(header);
+    sodium_free(state);
+
+    assert(crypto_secretstream_xchacha20poly1305_index_max() ==
+           crypto_secretstream_xchacha20poly1305_INDEX_MAX);
+
+    printf("OK\n");
+
+    return 0;
+}
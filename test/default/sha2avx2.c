@@ -0,0 +1,64 @@
+
+#define TEST_NAME "sha2avx2"
+static int avx2_forced;
+#define TEST_BEFORE_INIT()                                                    \
+    (void) (avx2_forced = sodium_set_implementation("sha256", "avx2") == 0 && \
+                          sodium_set_implementation("sha512", "avx2") == 0)
+#include "cmptest.h"
+
+/*
+ * The expected output was computed with the portable implementations.
+ * Lengths cover both an odd and an even number of blocks, since the
+ * SHA-256 transform computes two message schedules at once.
+ */
+
+#define MAX_LEN 1000
+
+static const size_t lens[] = { 0,   1,   55,  56,  63,  64,  65,  111,
+                               112, 127, 128, 129, 191, 192, 255, 256,
+                               257, 383, 384, 511, 512, 513, MAX_LEN };
+
+static unsigned char m[MAX_LEN];
+
+int
+main(void)
+{
+    crypto_hash_sha256_state st256;
+    crypto_hash_sha512_state st512;
+    unsigned char            h256[crypto_hash_sha256_BYTES];
+    unsigned char            h512[crypto_hash_sha512_BYTES];
+    unsigned char            h2[crypto_hash_sha512_BYTES];
+    char                     hex[crypto_hash_sha512_BYTES * 2 + 1];
+    size_t                   i;
+    size_t                   j;
+
+    if (avx2_forced && sodium_runtime_has_avx2() && sodium_runtime_has_bmi2()) {
+        assert(strcmp(sodium_implementation_name("sha256"), "avx2") == 0);
+        assert(strcmp(sodium_implementation_name("sha512"), "avx2") == 0);
+    }
+    for (i = 0; i < MAX_LEN; i++) {
+        m[i] = (unsigned char) (i * 7U + 3U);
+    }
+    for (i = 0; i < sizeof lens / sizeof lens[0]; i++) {
+        crypto_hash_sha256(h256, m, lens[i]);
+        crypto_hash_sha512(h512, m, lens[i]);
+        printf("%u\n", (unsigned int) lens[i]);
+        printf("%s\n", sodium_bin2hex(hex, sizeof hex, h256, sizeof h256));
+        printf("%s\n", sodium_bin2hex(hex, sizeof hex, h512, sizeof h512));
+
+        /* Unaligned updates go through the single-block path */
+        crypto_hash_sha256_init(&st256);
+        crypto_hash_sha512_init(&st512);
+        for (j = 0; j < lens[i]; j += 37U) {
+            crypto_hash_sha256_update(&st256, m + j,
+                                      lens[i] - j < 37U ? lens[i] - j : 37U);
+            crypto_hash_sha512_update(&st512, m + j,
+                                      lens[i] - j < 37U ? lens[i] - j : 37U);
+        }
+        crypto_hash_sha256_final(&st256, h2);
+        assert(memcmp(h2, h256, sizeof h256) == 0);
+        crypto_hash_sha512_final(&st512, h2);
+        assert(memcmp(h2, h512, sizeof h512) == 0);
+    }
+    return 0;
+}
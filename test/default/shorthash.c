@@ -4,12 +4,28 @@
 
 #define MAXLEN 64
 
+static uint64_t
+load64_le(const unsigned char *p)
+{
+    uint64_t x = 0U;
+    int      i;
+
+    for (i = 7; i >= 0; i--) {
+        x = (x << 8) | p[i];
+    }
+    return x;
+}
+
 int
 main(void)
 {
     unsigned char in[MAXLEN];
     unsigned char out[crypto_shorthash_BYTES];
     unsigned char k[crypto_shorthash_KEYBYTES];
+    unsigned char outs[MAXLEN * crypto_shorthash_siphash24_BYTES];
+    const unsigned char *ins[MAXLEN];
+    unsigned long long   inlens[MAXLEN];
+    size_t        count;
     size_t        i;
     size_t        j;
 
@@ -24,6 +40,34 @@ main(void)
         }
         printf("\n");
     }
+    for (i = 0; i < MAXLEN; ++i) {
+        ins[i]    = in + (i & 7);
+        inlens[i] = (unsigned long long) ((i * 37) % (MAXLEN - 7));
+    }
+    for (count = 0; count <= MAXLEN; count += 1 + count / 4) {
+        memset(outs, 0, sizeof outs);
+        assert(crypto_shorthash_siphash24_multi(outs, ins, inlens, count, k) == 0);
+        for (i = 0; i < count; ++i) {
+            crypto_shorthash_siphash24(out, ins[i], inlens[i], k);
+            assert(memcmp(out, outs + i * crypto_shorthash_siphash24_BYTES,
+                          crypto_shorthash_siphash24_BYTES) == 0);
+        }
+        for (; i < MAXLEN; ++i) {
+            assert(sodium_is_zero(outs + i * crypto_shorthash_siphash24_BYTES,
+                                  crypto_shorthash_siphash24_BYTES));
+        }
+    }
+    for (i = 0; i + 32 <= MAXLEN; ++i) {
+        crypto_shorthash_siphash24(out, in + i, 8, k);
+        assert(crypto_shorthash_siphash24_u64(load64_le(in + i), k) ==
+               load64_le(out));
+        crypto_shorthash_siphash24(out, in + i, 16, k);
+        assert(crypto_shorthash_siphash24_16(in + i, k) == load64_le(out));
+        crypto_shorthash_siphash24(out, in + i, 32, k);
+        assert(crypto_shorthash_siphash24_32(in + i, k) == load64_le(out));
+        crypto_shorthash_siphash24(out, in, i, k);
+        assert(crypto_shorthash_siphash24_value(in, i, k) == load64_le(out));
+    }
     assert(crypto_shorthash_bytes() > 0);
     assert(crypto_shorthash_keybytes() > 0);
     assert(strcmp(crypto_shorthash_primitive(), "siphash24") == 0);
@@ -1057,6 +1057,452 @@ static void add_l(unsigned char * const S)
     sodium_add(S, l, sizeof l);
 }
 
+#ifndef ED25519_COMPAT
+/* Points of order 8 and 2 */
+static const unsigned char torsion8[32] = {
+    0x26, 0xe8, 0x95, 0x8f, 0xc2, 0xb2, 0x27, 0xb0, 0x45, 0xc3, 0xf4,
+    0x89, 0xf2, 0xef, 0x98, 0xf0, 0xd5, 0xdf, 0xac, 0x05, 0xd3, 0xc6,
+    0x33, 0x39, 0xb1, 0x38, 0x02, 0x88, 0x6d, 0x53, 0xfc, 0x05
+};
+static const unsigned char torsion2[32] = {
+    0xec, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f
+};
+
+/*
+ * Signs m with R = r * B + T, T being a point of small order: the signature
+ * satisfies the cofactored equation, but not the cofactorless one checked
+ * by crypto_sign_ed25519_verify_detached().
+ */
+static void
+torsioned_sign(unsigned char *sig, const unsigned char *m,
+               unsigned long long mlen, const unsigned char *seed,
+               const unsigned char *pk, const unsigned char *torsion)
+{
+    crypto_hash_sha512_state hs;
+    unsigned char            az[64];
+    unsigned char            a[crypto_core_ed25519_SCALARBYTES];
+    unsigned char            r[crypto_core_ed25519_SCALARBYTES];
+    unsigned char            h[64];
+    unsigned char            k[crypto_core_ed25519_SCALARBYTES];
+
+    crypto_hash_sha512(az, seed, 32);
+    az[0] &= 248;
+    az[31] &= 127;
+    az[31] |= 64;
+    memset(az + 32, 0, 32);
+    crypto_core_ed25519_scalar_reduce(a, az);
+    crypto_core_ed25519_scalar_random(r);
+    assert(crypto_scalarmult_ed25519_base_noclamp(sig, r) == 0);
+    assert(crypto_core_ed25519_add(sig, sig, torsion) == 0);
+    crypto_hash_sha512_init(&hs);
+    crypto_hash_sha512_update(&hs, sig, 32);
+    crypto_hash_sha512_update(&hs, pk, 32);
+    crypto_hash_sha512_update(&hs, m, mlen);
+    crypto_hash_sha512_final(&hs, h);
+    crypto_core_ed25519_scalar_reduce(k, h);
+    crypto_core_ed25519_scalar_mul(sig + 32, k, a);
+    crypto_core_ed25519_scalar_add(sig + 32, sig + 32, r);
+}
+#endif
+
+#define BATCH_COUNT ((sizeof test_data) / (sizeof test_data[0]))
+
+static void batch_verify(void)
+{
+    static const unsigned char *sigs[BATCH_COUNT];
+    static const unsigned char *ms[BATCH_COUNT];
+    static const unsigned char *pks[BATCH_COUNT];
+    static unsigned long long   mlens[BATCH_COUNT];
+    static int                  results[BATCH_COUNT];
+    unsigned char               bad_sig[crypto_sign_BYTES];
+    unsigned int                i;
+
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        sigs[i] = test_data[i].sig;
+        ms[i] = (const unsigned char *) test_data[i].m;
+        mlens[i] = i;
+        pks[i] = test_data[i].pk;
+    }
+    assert(crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, 0U,
+                                            NULL) == 0);
+    assert(crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, 1U,
+                                            NULL) == 0);
+    if (crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, BATCH_COUNT,
+                                         results) != 0) {
+        printf("batch verification failed\n");
+    }
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        assert(results[i] == 0);
+    }
+
+    memcpy(bad_sig, test_data[100].sig, sizeof bad_sig);
+    bad_sig[0]++;
+    sigs[100] = bad_sig;
+    mlens[700] = 699;
+    pks[900] = non_canonical_p;
+    if (crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, BATCH_COUNT,
+                                         results) != -1) {
+        printf("batch verification with invalid signatures didn't fail\n");
+    }
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        assert(results[i] == -((i == 100U) | (i == 700U) | (i == 900U)));
+    }
+
+#ifndef ED25519_COMPAT
+    memcpy(bad_sig, test_data[100].sig, sizeof bad_sig);
+    add_l(bad_sig + 32);
+    if (crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, 101U,
+                                         results) != -1) {
+        printf("batch verification with a malleable signature didn't fail\n");
+    }
+    assert(results[100] == -1);
+
+    sigs[100] = test_data[100].sig;
+    mlens[700] = 700;
+    pks[900] = test_data[900].pk;
+    torsioned_sign(bad_sig, ms[5], mlens[5], test_data[5].sk,
+                   test_data[5].pk, torsion8);
+    assert(crypto_sign_ed25519_verify_detached(bad_sig, ms[5], mlens[5],
+                                               pks[5]) == -1);
+    sigs[5] = bad_sig;
+    assert(crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, BATCH_COUNT,
+                                            results) == -1);
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        assert(results[i] == -(i == 5U));
+    }
+    torsioned_sign(bad_sig, ms[5], mlens[5], test_data[5].sk,
+                   test_data[5].pk, torsion2);
+    assert(crypto_sign_ed25519_verify_detached(bad_sig, ms[5], mlens[5],
+                                               pks[5]) == -1);
+    assert(crypto_sign_ed25519_verify_batch(sigs, ms, mlens, pks, BATCH_COUNT,
+                                            results) == -1);
+    for (i = 0U; i < BATCH_COUNT; i++) {
+        assert(results[i] == -(i == 5U));
+    }
+#endif
+    printf("batch verification: ok\n");
+}
+
+static void precomputed_verify(void)
+{
+    crypto_sign_ed25519_pk_state *pk_st;
+    unsigned char                 sig[crypto_sign_BYTES];
+    unsigned int                  i;
+
+    pk_st = (crypto_sign_ed25519_pk_state *)
+        sodium_malloc(crypto_sign_ed25519_pk_statebytes());
+    for (i = 0U; i < (sizeof test_data) / (sizeof test_data[0]); i += 7U) {
+        if (crypto_sign_ed25519_pk_precompute(pk_st, test_data[i].pk) != 0) {
+            printf("crypto_sign_ed25519_pk_precompute() failure: [%u]\n", i);
+            continue;
+        }
+        if (crypto_sign_ed25519_verify_detached_precomputed
+            (test_data[i].sig, (const unsigned char *) test_data[i].m, i,
+             pk_st) != 0) {
+            printf("precomputed verification failure: [%u]\n", i);
+            continue;
+        }
+        memcpy(sig, test_data[i].sig, sizeof sig);
+        sig[i % crypto_sign_BYTES]++;
+        if (crypto_sign_ed25519_verify_detached_precomputed
+            (sig, (const unsigned char *) test_data[i].m, i, pk_st) != -1) {
+            printf("precomputed verification can be forged: [%u]\n", i);
+            continue;
+        }
+        memcpy(sig, test_data[i].sig, sizeof sig);
+        add_l(sig + 32);
+#ifndef ED25519_COMPAT
+        if (crypto_sign_ed25519_verify_detached_precomputed
+            (sig, (const unsigned char *) test_data[i].m, i, pk_st) != -1) {
+            printf("precomputed verification: signature [%u] is malleable\n", i);
+            continue;
+        }
+#endif
+    }
+#ifndef ED25519_COMPAT
+    assert(crypto_sign_ed25519_pk_precompute(pk_st, non_canonical_p) == -1);
+#endif
+    sodium_free(pk_st);
+    assert(crypto_sign_ed25519_pk_statebytes() ==
+           sizeof(crypto_sign_ed25519_pk_state));
+}
+
+static void streamed_verify(void)
+{
+    crypto_sign_ed25519_verify_state st;
+    unsigned char                    sig[crypto_sign_BYTES];
+    const unsigned char             *m;
+    unsigned long long               j;
+    unsigned long long               len;
+    unsigned int                     i;
+
+    for (i = 0U; i < (sizeof test_data) / (sizeof test_data[0]); i += 13U) {
+        m = (const unsigned char *) test_data[i].m;
+        assert(crypto_sign_ed25519_verify_init(&st, test_data[i].sig,
+                                               test_data[i].pk) == 0);
+        for (j = 0U; j < i; j += len) {
+            len = 1U + j % 37U;
+            if (len > i - j) {
+                len = i - j;
+            }
+            assert(crypto_sign_ed25519_verify_update(&st, m + j, len) == 0);
+        }
+        if (crypto_sign_ed25519_verify_final(&st) != 0) {
+            printf("streamed verification failure: [%u]\n", i);
+            continue;
+        }
+        memcpy(sig, test_data[i].sig, sizeof sig);
+        sig[i % crypto_sign_BYTES]++;
+        (void) crypto_sign_ed25519_verify_init(&st, sig, test_data[i].pk);
+        crypto_sign_ed25519_verify_update(&st, m, i);
+        if (crypto_sign_ed25519_verify_final(&st) != -1) {
+            printf("streamed verification can be forged: [%u]\n", i);
+            continue;
+        }
+        if (i > 0U) {
+            assert(crypto_sign_ed25519_verify_init(&st, test_data[i].sig,
+                                                   test_data[i].pk) == 0);
+            crypto_sign_ed25519_verify_update(&st, m, i - 1U);
+            assert(crypto_sign_ed25519_verify_final(&st) == -1);
+        }
+    }
+#ifndef ED25519_COMPAT
+    assert(crypto_sign_ed25519_verify_init(&st, test_data[0].sig,
+                                           non_canonical_p) == -1);
+    assert(crypto_sign_ed25519_verify_final(&st) == -1);
+#endif
+    assert(crypto_sign_ed25519_verify_statebytes() ==
+           sizeof(crypto_sign_ed25519_verify_state));
+}
+
+#define SIGN_BATCH_COUNT 150U
+
+static void batch_sign(void)
+{
+    unsigned char             *sigs[SIGN_BATCH_COUNT];
+    const unsigned char       *ms[SIGN_BATCH_COUNT];
+    unsigned long long         mlens[SIGN_BATCH_COUNT];
+    unsigned char              skpk[crypto_sign_SECRETKEYBYTES];
+    unsigned char              sig[crypto_sign_BYTES];
+    unsigned char             *sigs_buf;
+    unsigned int               i;
+
+    memcpy(skpk, test_data[1].sk, crypto_sign_SEEDBYTES);
+    memcpy(skpk + crypto_sign_SEEDBYTES, test_data[1].pk,
+           crypto_sign_PUBLICKEYBYTES);
+    sigs_buf = (unsigned char *) sodium_malloc(SIGN_BATCH_COUNT *
+                                               crypto_sign_BYTES);
+    for (i = 0U; i < SIGN_BATCH_COUNT; i++) {
+        sigs[i] = &sigs_buf[i * crypto_sign_BYTES];
+        ms[i] = (const unsigned char *) test_data[i].m;
+        mlens[i] = i;
+    }
+    assert(crypto_sign_ed25519_detached_batch(sigs, ms, mlens,
+                                              SIGN_BATCH_COUNT, skpk) == 0);
+    for (i = 0U; i < SIGN_BATCH_COUNT; i++) {
+        crypto_sign_ed25519_detached(sig, NULL, ms[i], mlens[i], skpk);
+        if (memcmp(sig, sigs[i], crypto_sign_BYTES) != 0) {
+            printf("batch signature failure: [%u]\n", i);
+        }
+    }
+    assert(memcmp(sigs[1], test_data[1].sig, crypto_sign_BYTES) == 0);
+    assert(crypto_sign_ed25519_detached_batch(sigs, ms, mlens, 0U, skpk) == 0);
+    sodium_free(sigs_buf);
+}
+
+#define SIGN_AGGREGATE_COUNT 200U
+
+#ifndef ED25519_COMPAT
+/* Aggregates a single signature without checking it */
+static void
+aggregate_unchecked(unsigned char *agg, const unsigned char *sig,
+                    const unsigned char *m, unsigned long long mlen,
+                    const unsigned char *pk)
+{
+    static const char        domain[] = "Ed25519 half-aggregation";
+    static const unsigned char index0[8] = { 0 };
+    crypto_hash_sha512_state hs;
+    unsigned char            h[64];
+    unsigned char            k[crypto_core_ed25519_SCALARBYTES];
+    unsigned char            z[crypto_core_ed25519_SCALARBYTES];
+
+    crypto_hash_sha512_init(&hs);
+    crypto_hash_sha512_update(&hs, sig, 32);
+    crypto_hash_sha512_update(&hs, pk, 32);
+    crypto_hash_sha512_update(&hs, m, mlen);
+    crypto_hash_sha512_final(&hs, h);
+    crypto_core_ed25519_scalar_reduce(k, h);
+    crypto_hash_sha512_init(&hs);
+    crypto_hash_sha512_update(&hs, (const unsigned char *) domain,
+                              sizeof domain - 1U);
+    crypto_hash_sha512_update(&hs, sig, 32);
+    crypto_hash_sha512_update(&hs, pk, 32);
+    crypto_hash_sha512_update(&hs, k, sizeof k);
+    crypto_hash_sha512_update(&hs, index0, sizeof index0);
+    crypto_hash_sha512_final(&hs, h);
+    memset(z, 0, sizeof z);
+    memcpy(z, h, 16U);
+    memcpy(agg, sig, 32);
+    crypto_core_ed25519_scalar_mul(agg + 32, z, sig + 32);
+}
+#endif
+
+static void aggregate_verify(void)
+{
+    const unsigned char *sigs[SIGN_AGGREGATE_COUNT];
+    const unsigned char *ms[SIGN_AGGREGATE_COUNT];
+    unsigned long long   mlens[SIGN_AGGREGATE_COUNT];
+    const unsigned char *pks[SIGN_AGGREGATE_COUNT];
+    unsigned char       *agg;
+    unsigned long long   agglen;
+#ifndef ED25519_COMPAT
+    unsigned char        bad_sig[crypto_sign_BYTES];
+#endif
+    unsigned int         i;
+
+    for (i = 0U; i < SIGN_AGGREGATE_COUNT; i++) {
+        sigs[i]  = test_data[i].sig;
+        ms[i]    = (const unsigned char *) test_data[i].m;
+        mlens[i] = i;
+        pks[i]   = test_data[i].pk;
+    }
+    agg = (unsigned char *)
+        sodium_malloc(crypto_sign_ed25519_AGGREGATEBYTES(SIGN_AGGREGATE_COUNT));
+    for (i = 1U; i <= SIGN_AGGREGATE_COUNT; i += 66U) {
+        agglen = 0U;
+        assert(crypto_sign_ed25519_aggregate(agg, &agglen, sigs, ms, mlens,
+                                             pks, i) == 0);
+        assert(agglen == crypto_sign_ed25519_AGGREGATEBYTES(i));
+        if (crypto_sign_ed25519_verify_aggregate(agg, ms, mlens, pks,
+                                                 i) != 0) {
+            printf("aggregate verification failure: [%u]\n", i);
+            continue;
+        }
+        agg[agglen - 1U - i % 32U] ^= 0x01;
+        assert(crypto_sign_ed25519_verify_aggregate(agg, ms, mlens, pks,
+                                                    i) == -1);
+        agg[agglen - 1U - i % 32U] ^= 0x01;
+        ms[i - 1U] = (const unsigned char *) test_data[i].m;
+        mlens[i - 1U]++;
+        assert(crypto_sign_ed25519_verify_aggregate(agg, ms, mlens, pks,
+                                                    i) == -1);
+        ms[i - 1U] = (const unsigned char *) test_data[i - 1U].m;
+        mlens[i - 1U]--;
+    }
+    assert(crypto_sign_ed25519_aggregate(agg, NULL, sigs, ms, mlens,
+                                         pks, SIGN_AGGREGATE_COUNT) == 0);
+    assert(crypto_sign_ed25519_verify_aggregate(agg, ms, mlens, pks,
+                                                SIGN_AGGREGATE_COUNT) == 0);
+    pks[3] = test_data[4].pk;
+    assert(crypto_sign_ed25519_verify_aggregate(agg, ms, mlens, pks,
+                                                SIGN_AGGREGATE_COUNT) == -1);
+    assert(crypto_sign_ed25519_aggregate(agg, NULL, sigs, ms, mlens,
+                                         pks, 0U) == -1);
+    assert(crypto_sign_ed25519_verify_aggregate(agg, ms, mlens, pks,
+                                                0U) == -1);
+#ifndef ED25519_COMPAT
+    pks[3] = test_data[3].pk;
+    aggregate_unchecked(agg, sigs[3], ms[3], mlens[3], pks[3]);
+    assert(crypto_sign_ed25519_verify_aggregate(agg, &ms[3], &mlens[3],
+                                                &pks[3], 1U) == 0);
+    torsioned_sign(bad_sig, ms[3], mlens[3], test_data[3].sk,
+                   test_data[3].pk, torsion8);
+    sigs[3] = bad_sig;
+    assert(crypto_sign_ed25519_aggregate(agg, NULL, sigs, ms, mlens,
+                                         pks, SIGN_AGGREGATE_COUNT) == -1);
+    aggregate_unchecked(agg, bad_sig, ms[3], mlens[3], pks[3]);
+    assert(crypto_sign_ed25519_verify_aggregate(agg, &ms[3], &mlens[3],
+                                                &pks[3], 1U) == -1);
+#endif
+    sodium_free(agg);
+    printf("aggregate verification: ok\n");
+}
+
+static void expanded_sign(void)
+{
+    crypto_sign_ed25519_sk_state *sk_st;
+    unsigned char                 skpk[crypto_sign_SECRETKEYBYTES];
+    unsigned char                 sig[crypto_sign_BYTES];
+    unsigned long long            siglen;
+    unsigned int                  i;
+
+    sk_st = (crypto_sign_ed25519_sk_state *)
+        sodium_malloc(crypto_sign_ed25519_sk_statebytes());
+    for (i = 0U; i < (sizeof test_data) / (sizeof test_data[0]); i += 7U) {
+        memcpy(skpk, test_data[i].sk, crypto_sign_SEEDBYTES);
+        memcpy(skpk + crypto_sign_SEEDBYTES, test_data[i].pk,
+               crypto_sign_PUBLICKEYBYTES);
+        assert(crypto_sign_ed25519_sk_expand(sk_st, skpk) == 0);
+        siglen = 0U;
+        assert(crypto_sign_ed25519_detached_expanded
+               (sig, &siglen, (const unsigned char *) test_data[i].m, i,
+                sk_st) == 0);
+        assert(siglen == crypto_sign_BYTES);
+        if (memcmp(test_data[i].sig, sig, crypto_sign_BYTES) != 0) {
+            printf("expanded signature failure: [%u]\n", i);
+            continue;
+        }
+        assert(crypto_sign_ed25519_detached_expanded
+               (sig, NULL, (const unsigned char *) test_data[i].m, i,
+                sk_st) == 0);
+        assert(memcmp(test_data[i].sig, sig, crypto_sign_BYTES) == 0);
+    }
+    sodium_memzero(sk_st, crypto_sign_ed25519_sk_statebytes());
+    sodium_free(sk_st);
+    assert(crypto_sign_ed25519_sk_statebytes() ==
+           sizeof(crypto_sign_ed25519_sk_state));
+}
+
+static void streamed_sign(void)
+{
+    crypto_sign_ed25519_sign_state st;
+    unsigned char                  skpk[crypto_sign_SECRETKEYBYTES];
+    unsigned char                  sig[crypto_sign_BYTES];
+    unsigned char                  sig2[crypto_sign_BYTES];
+    const unsigned char           *m;
+    unsigned long long             siglen;
+    unsigned long long             j;
+    unsigned long long             len;
+    unsigned int                   i;
+
+    for (i = 0U; i < (sizeof test_data) / (sizeof test_data[0]); i += 11U) {
+        m = (const unsigned char *) test_data[i].m;
+        memcpy(skpk, test_data[i].sk, crypto_sign_SEEDBYTES);
+        memcpy(skpk + crypto_sign_SEEDBYTES, test_data[i].pk,
+               crypto_sign_PUBLICKEYBYTES);
+        assert(crypto_sign_ed25519_sign_init(&st, skpk) == 0);
+        for (j = 0U; j < i; j += len) {
+            len = 1U + j % 29U;
+            if (len > i - j) {
+                len = i - j;
+            }
+            assert(crypto_sign_ed25519_sign_update(&st, m + j, len) == 0);
+        }
+        siglen = 0U;
+        assert(crypto_sign_ed25519_sign_final(&st, sig, &siglen) == 0);
+        assert(siglen == crypto_sign_BYTES);
+        if (crypto_sign_ed25519_verify_detached(sig, m, i,
+                                                test_data[i].pk) != 0) {
+            printf("streamed signature failure: [%u]\n", i);
+            continue;
+        }
+        assert(crypto_sign_ed25519_sign_init(&st, skpk) == 0);
+        assert(crypto_sign_ed25519_sign_update(&st, m, i) == 0);
+        assert(crypto_sign_ed25519_sign_final(&st, sig2, NULL) == 0);
+        assert(memcmp(sig, sig2, crypto_sign_BYTES) != 0);
+        assert(crypto_sign_ed25519_verify_detached(sig2, m, i,
+                                                   test_data[i].pk) == 0);
+        if (i > 0U) {
+            assert(crypto_sign_ed25519_verify_detached(sig, m, i - 1U,
+                                                       test_data[i].pk) == -1);
+        }
+    }
+    assert(crypto_sign_ed25519_sign_statebytes() ==
+           sizeof(crypto_sign_ed25519_sign_state));
+}
+
 int main(void)
 {
     crypto_sign_state  st;
@@ -1150,6 +1596,14 @@ int main(void)
     }
     printf("%u tests\n", i);
 
+    batch_verify();
+    precomputed_verify();
+    streamed_verify();
+    streamed_sign();
+    aggregate_verify();
+    expanded_sign();
+    batch_sign();
+
     i--;
 
     memcpy(sm, test_data[i].m, i);
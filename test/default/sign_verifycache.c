@@ -0,0 +1,48 @@
+
+#define TEST_NAME "sign_verifycache"
+#include "cmptest.h"
+
+int
+main(void)
+{
+    crypto_sign_ed25519_verifycache *cache;
+    unsigned char                    pk[crypto_sign_ed25519_PUBLICKEYBYTES];
+    unsigned char                    sk[crypto_sign_ed25519_SECRETKEYBYTES];
+    unsigned char                    sig[10][crypto_sign_ed25519_BYTES];
+    unsigned char                    m[10][100];
+    size_t                           i;
+    size_t                           j;
+
+    assert(crypto_sign_ed25519_verifycache_create(0U, 100U) == NULL);
+    assert(crypto_sign_ed25519_verifycache_create(4U, SIZE_MAX) == NULL);
+    cache = crypto_sign_ed25519_verifycache_create(4U, 64U);
+    assert(cache != NULL);
+
+    crypto_sign_ed25519_keypair(pk, sk);
+    for (i = 0U; i < 10U; i++) {
+        randombytes_buf(m[i], sizeof m[i]);
+        crypto_sign_ed25519_detached(sig[i], NULL, m[i], i * 10U, sk);
+    }
+    for (j = 0U; j < 3U; j++) {
+        for (i = 0U; i < 10U; i++) {
+            assert(crypto_sign_ed25519_verify_detached_cached
+                   (cache, sig[i], m[i], i * 10U, pk) == 0);
+            assert(crypto_sign_ed25519_verify_detached_cached
+                   (cache, sig[i], m[i], i * 10U + 1U, pk) == -1);
+            assert(crypto_sign_ed25519_verify_detached_cached
+                   (cache, sig[(i + 1U) % 10U], m[i], i * 10U, pk) == -1);
+            m[i][0] ^= 1U;
+            assert(crypto_sign_ed25519_verify_detached_cached
+                   (cache, sig[i], m[i], i * 10U, pk) == (i == 0U ? 0 : -1));
+            m[i][0] ^= 1U;
+            assert(crypto_sign_ed25519_verify_detached_cached
+                   (NULL, sig[i], m[i], i * 10U, pk) == 0);
+        }
+    }
+    crypto_sign_ed25519_verifycache_destroy(cache);
+    crypto_sign_ed25519_verifycache_destroy(NULL);
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#define TEST_NAME "siphash13"
+#include "cmptest.h"
+
+#define MAXLEN 64
+
+int
+main(void)
+{
+    unsigned char        in[MAXLEN];
+    unsigned char        out[crypto_shorthash_siphash13_BYTES];
+    unsigned char        hout[crypto_shorthash_halfsiphash24_BYTES];
+    unsigned char        k[crypto_shorthash_siphash13_KEYBYTES];
+    unsigned char        outs[MAXLEN * crypto_shorthash_siphash13_BYTES];
+    const unsigned char *ins[MAXLEN];
+    unsigned long long   inlens[MAXLEN];
+    size_t               count;
+    size_t               i;
+    size_t               j;
+
+    for (i = 0; i < crypto_shorthash_siphash13_KEYBYTES; ++i) {
+        k[i] = (unsigned char) i;
+    }
+    for (i = 0; i < MAXLEN; ++i) {
+        in[i] = (unsigned char) i;
+        crypto_shorthash_siphash13(out, in, (unsigned long long) i, k);
+        for (j = 0; j < crypto_shorthash_siphash13_BYTES; ++j) {
+            printf("%02x", (unsigned int) out[j]);
+        }
+        printf("\n");
+        assert(crypto_shorthash_siphash13_value(in, i, k) ==
+               ((uint64_t) out[0] | ((uint64_t) out[1] << 8) |
+                ((uint64_t) out[2] << 16) | ((uint64_t) out[3] << 24) |
+                ((uint64_t) out[4] << 32) | ((uint64_t) out[5] << 40) |
+                ((uint64_t) out[6] << 48) | ((uint64_t) out[7] << 56)));
+    }
+    for (i = 0; i < MAXLEN; ++i) {
+        crypto_shorthash_halfsiphash24(hout, in, (unsigned long long) i, k);
+        for (j = 0; j < crypto_shorthash_halfsiphash24_BYTES; ++j) {
+            printf("%02x", (unsigned int) hout[j]);
+        }
+        printf("\n");
+        assert(crypto_shorthash_halfsiphash24_value(in, i, k) ==
+               ((uint32_t) hout[0] | ((uint32_t) hout[1] << 8) |
+                ((uint32_t) hout[2] << 16) | ((uint32_t) hout[3] << 24)));
+    }
+    for (i = 0; i < MAXLEN; ++i) {
+        ins[i]    = in + (i & 7);
+        inlens[i] = (unsigned long long) ((i * 37) % (MAXLEN - 7));
+    }
+    for (count = 0; count <= MAXLEN; count += 1 + count / 4) {
+        memset(outs, 0, sizeof outs);
+        assert(crypto_shorthash_siphash13_multi(outs, ins, inlens, count, k) == 0);
+        for (i = 0; i < count; ++i) {
+            crypto_shorthash_siphash13(out, ins[i], inlens[i], k);
+            assert(memcmp(out, outs + i * crypto_shorthash_siphash13_BYTES,
+                          crypto_shorthash_siphash13_BYTES) == 0);
+        }
+        for (; i < MAXLEN; ++i) {
+            assert(sodium_is_zero(outs + i * crypto_shorthash_siphash13_BYTES,
+                                  crypto_shorthash_siphash13_BYTES));
+        }
+    }
+    assert(crypto_shorthash_siphash13_bytes() == crypto_shorthash_siphash13_BYTES);
+    assert(crypto_shorthash_siphash13_keybytes() == crypto_shorthash_siphash13_KEYBYTES);
+    assert(crypto_shorthash_halfsiphash24_bytes() == crypto_shorthash_halfsiphash24_BYTES);
+    assert(crypto_shorthash_halfsiphash24_keybytes() ==
+           crypto_shorthash_halfsiphash24_KEYBYTES);
+
+    return 0;
+}
@@ -1,5 +1,17 @@
 
 #define TEST_NAME "sodium_core"
+
+static const char *salsa20_forced;
+
+#define TEST_BEFORE_INIT()                                              \
+    do {                                                                \
+        assert(sodium_set_implementation("salsa20", "xmm") == -1);      \
+        if (sodium_set_implementation("salsa20", "ref") == 0) {         \
+            salsa20_forced = "ref";                                     \
+        } else if (sodium_set_implementation("salsa20", "xmm6") == 0) { \
+            salsa20_forced = "xmm6";                                    \
+        }                                                               \
+    } while (0)
 #include "cmptest.h"
 
 static void
@@ -12,6 +24,12 @@ misuse_handler(void)
 int
 main(void)
 {
+    sodium_stats  stats;
+    uint64_t      calls;
+    unsigned char h[crypto_hash_sha256_BYTES];
+    char          profile[sodium_IMPLEMENTATION_PROFILEBYTES];
+    char          word[64];
+
     sodium_set_misuse_handler(NULL);
     sodium_set_misuse_handler(misuse_handler);
     sodium_set_misuse_handler(NULL);
@@ -20,16 +38,65 @@ main(void)
 
     (void) sodium_runtime_has_neon();
     (void) sodium_runtime_has_armcrypto();
+    (void) sodium_runtime_has_armsha2();
+    (void) sodium_runtime_has_armsha512();
     (void) sodium_runtime_has_sse2();
     (void) sodium_runtime_has_sse3();
     (void) sodium_runtime_has_ssse3();
     (void) sodium_runtime_has_sse41();
     (void) sodium_runtime_has_avx();
     (void) sodium_runtime_has_avx2();
+    (void) sodium_runtime_has_bmi2();
     (void) sodium_runtime_has_avx512f();
+    (void) sodium_runtime_has_avx512vl();
+    (void) sodium_runtime_has_shani();
     (void) sodium_runtime_has_pclmul();
     (void) sodium_runtime_has_aesni();
     (void) sodium_runtime_has_rdrand();
+    (void) sodium_runtime_has_rdseed();
+    (void) sodium_runtime_has_rndr();
+
+    assert(sodium_implementation_name("argon2") != NULL);
+    assert(sodium_implementation_name("blake2b") != NULL);
+    assert(sodium_implementation_name("chacha20") != NULL);
+    assert(sodium_implementation_name("curve25519") != NULL);
+    assert(sodium_implementation_name("poly1305") != NULL);
+    assert(sodium_implementation_name("salsa20") != NULL);
+    assert(salsa20_forced == NULL ||
+           strcmp(sodium_implementation_name("salsa20"), salsa20_forced) == 0);
+    assert(sodium_implementation_name("rot13") == NULL);
+    assert(sodium_set_implementation("rot13", "ref") == -1);
+    assert(sodium_set_implementation("chacha20", "rot13") == -1);
+    assert(sodium_set_implementation("chacha20", "ref") == -1);
+    assert(sodium_set_implementation("chacha20", NULL) == -1);
+    assert(sodium_implementation_profile(profile, sizeof profile) == 0);
+    assert(strncmp(profile, "cpu=", 4U) == 0);
+    snprintf(word, sizeof word, " chacha20=%s",
+             sodium_implementation_name("chacha20"));
+    assert(strstr(profile, word) != NULL);
+    assert(sodium_implementation_profile(profile, 20U) == -1);
+    assert(sodium_tune_implementations(NULL) == -1);
+    assert(sodium_tune_implementations("cpu=0000000 chacha20=ref") == -1);
+    assert(sodium_tune_implementations("cpu=00000000 chacha20") == -1);
+
+    assert(sodium_runtime_vector_policy() == SODIUM_RUNTIME_VECTOR_POLICY_AUTO);
+    assert(sodium_runtime_set_vector_policy(42) == -1);
+    assert(sodium_runtime_set_vector_policy(SODIUM_RUNTIME_VECTOR_POLICY_PREFER_256) == -1);
+
+    assert(strcmp(sodium_stats_name(SODIUM_STATS_HASH), "hash") == 0);
+    assert(sodium_stats_name(SODIUM_STATS_COUNT) == NULL);
+    assert(sodium_stats_name(-1) == NULL);
+    if (sodium_stats_get(&stats) == 0) {
+        calls = stats.counters[SODIUM_STATS_HASH].calls;
+        memset(h, 0, sizeof h);
+        crypto_hash_sha256(h, h, sizeof h);
+        assert(sodium_stats_get(&stats) == 0);
+        assert(stats.counters[SODIUM_STATS_HASH].calls == calls + 1U);
+        assert(stats.counters[SODIUM_STATS_HASH].bytes >= sizeof h);
+    } else {
+        assert(errno == ENOSYS);
+        assert(stats.counters[SODIUM_STATS_HASH].calls == 0U);
+    }
 
     sodium_set_misuse_handler(misuse_handler);
 #ifndef __EMSCRIPTEN__
@@ -1,6 +1,23 @@
 #define TEST_NAME "sodium_utils"
 #include "cmptest.h"
 
+static int
+unpad_ref(size_t *unpadded_buflen_p, const unsigned char *block,
+          size_t blocksize)
+{
+    size_t i = blocksize;
+
+    while (i > 0U && block[i - 1U] == 0x00) {
+        i--;
+    }
+    if (i == 0U || block[i - 1U] != 0x80) {
+        return -1;
+    }
+    *unpadded_buflen_p = i - 1U;
+
+    return 0;
+}
+
 int
 main(void)
 {
@@ -33,6 +50,16 @@ main(void)
     printf("%d\n", sodium_memcmp(guard_page, buf2, 0U));
     printf("%d\n", sodium_memcmp(guard_page, guard_page, 0U));
     sodium_memzero(guard_page, 0U);
+    sodium_memzero_bulk(guard_page, 0U);
+    for (j = 0U; j < 2U; j++) {
+        bin_len = (size_t) (j * 1024U * 1024U) + randombytes_uniform(1000U);
+        bin_padded = (unsigned char *) sodium_malloc(bin_len + 1U);
+        memset(bin_padded, 0xff, bin_len + 1U);
+        sodium_memzero_bulk(bin_padded + 1U, bin_len);
+        assert(bin_padded[0] == 0xff);
+        assert(sodium_is_zero(bin_padded + 1U, bin_len) == 1);
+        sodium_free(bin_padded);
+    }
 
     memset(nonce, 0, sizeof nonce);
     sodium_increment(nonce, sizeof nonce);
@@ -73,6 +100,16 @@ main(void)
             printf("sodium_compare() equality failure with length=%u\n",
                    (unsigned int) bin_len);
         }
+        if (bin_len > 0U) {
+            j = randombytes_uniform((uint32_t) bin_len);
+            buf1[j] = (unsigned char) randombytes_uniform(256U);
+            if (sodium_compare(buf1, buf2, bin_len) !=
+                (buf1[j] > buf2[j]) - (buf1[j] < buf2[j]) ||
+                sodium_memcmp(buf1, buf2, bin_len) != -(buf1[j] != buf2[j])) {
+                printf("sodium_compare() failure with length=%u\n",
+                       (unsigned int) bin_len);
+            }
+        }
     }
     printf("%d\n", sodium_compare(buf1, NULL, 0U));
     printf("%d\n", sodium_compare(NULL, buf1, 0U));
@@ -100,6 +137,14 @@ main(void)
     if (sodium_compare(buf1, buf2, bin_len) != 0) {
         printf("sodium_add() failed\n");
     }
+    sodium_sub(buf2, buf_add, bin_len);
+    sodium_increment_by(buf2, bin_len, (uint64_t) j);
+    if (sodium_compare(buf1, buf2, bin_len) != 0) {
+        printf("sodium_increment_by() failed\n");
+    }
+    memset(buf1, 0xff, 24U);
+    sodium_increment_by(buf1, 24U, 0xffffffffffffffffULL);
+    assert(buf1[0] == 0xfe && buf1[8] == 0x00 && buf1[23] == 0x00);
     bin_len = randombytes_uniform(sizeof buf1);
     randombytes_buf(buf1, bin_len);
     memcpy(buf2, buf1, bin_len);
@@ -215,9 +260,60 @@ main(void)
                             blocksize) == 0);
         assert(bin_len2 == bin_len);
 
+        randombytes_buf(bin_padded, bin_padded_maxlen);
+        assert(sodium_pad_inplace(bin_padded, bin_len, bin_padded_maxlen,
+                                  blocksize) == 0);
+        assert(sodium_unpad(&bin_len2, bin_padded, bin_padded_maxlen,
+                            blocksize) == 0);
+        assert(bin_len2 == bin_len);
+        assert(sodium_pad_inplace(bin_padded, bin_len, bin_padded_maxlen,
+                                  0U) == -1);
+        assert(sodium_pad_inplace(bin_padded, bin_padded_maxlen,
+                                  bin_padded_maxlen, blocksize) == -1);
+        if (bin_padded_maxlen > blocksize) {
+            assert(sodium_pad_inplace(bin_padded, bin_len,
+                                      bin_padded_maxlen - 1U, blocksize) == -1);
+        }
+        memset(bin_padded + bin_padded_maxlen - blocksize, 0, blocksize);
+        assert(sodium_unpad(&bin_len2, bin_padded, bin_padded_maxlen,
+                            blocksize) == -1);
+
         sodium_free(bin_padded);
     }
 
+    for (blocksize = 1U; blocksize <= 70U; blocksize++) {
+        unsigned char block[70];
+        unsigned char ref[70];
+        int           ret;
+
+        for (bin_len = 0U; bin_len < blocksize; bin_len++) {
+            randombytes_buf(block, sizeof block);
+            memcpy(ref, block, sizeof ref);
+            memset(ref + bin_len, 0, blocksize - bin_len);
+            ref[bin_len] = 0x80;
+            assert(sodium_pad_inplace(block, bin_len, blocksize,
+                                      blocksize) == 0);
+            assert(memcmp(block, ref, sizeof block) == 0);
+            assert(sodium_unpad(&bin_len2, block, blocksize, blocksize) == 0);
+            assert(bin_len2 == bin_len);
+            block[bin_len] = 0x81;
+            assert(sodium_unpad(&bin_len2, block, blocksize, blocksize) == -1);
+        }
+        /* random blocks made of 0x00, 0x80 and other bytes */
+        for (i = 0U; i < 200U; i++) {
+            for (bin_len = 0U; bin_len < blocksize; bin_len++) {
+                const uint32_t r = randombytes_uniform(4U);
+
+                block[bin_len] = r == 0U ? 0x80 :
+                    (unsigned char) (r == 1U ? 0x01 : 0x00);
+            }
+            bin_len = 0U;
+            ret = unpad_ref(&bin_len, block, blocksize);
+            assert(sodium_unpad(&bin_len2, block, blocksize, blocksize) == ret);
+            assert(ret != 0 || bin_len2 == bin_len);
+        }
+    }
+
     sodium_stackzero(512);
 
     return 0;
@@ -39,6 +39,105 @@ segv_handler(int sig)
     exit(0);
 }
 
+static void
+secure_pool_tests(void)
+{
+    sodium_secure_pool *pool;
+    unsigned char      *slots[16];
+    unsigned char      *slot;
+    size_t              i;
+
+    assert(sodium_secure_pool_create(0U, 16U) == NULL);
+    assert(sodium_secure_pool_create(32U, 0U) == NULL);
+    assert(sodium_secure_pool_create(SIZE_MAX, 1U) == NULL);
+    assert(sodium_secure_pool_create(SIZE_MAX / 64U, 64U) == NULL);
+    sodium_secure_pool_destroy(NULL);
+
+    pool = sodium_secure_pool_create(33U, 16U);
+    assert(pool != NULL);
+    for (i = 0U; i < 16U; i++) {
+        slots[i] = (unsigned char *) sodium_secure_pool_alloc(pool);
+        assert(slots[i] != NULL);
+        memset(slots[i], (int) i, 33U);
+    }
+    errno = 0;
+    assert(sodium_secure_pool_alloc(pool) == NULL);
+    assert(errno == ENOMEM);
+    for (i = 0U; i < 16U; i++) {
+        assert(slots[i][0] == i && slots[i][32] == i);
+    }
+    assert(sodium_secure_pool_mprotect_noaccess(pool, slots[0]) == -1);
+    slot = slots[5];
+    sodium_secure_pool_free(pool, slot);
+    assert(sodium_is_zero(slot, 33U));
+    assert(sodium_secure_pool_alloc(pool) == slot);
+    assert(slot[0] == 0xdb && slot[32] == 0xdb);
+    for (i = 0U; i < 16U; i++) {
+        sodium_secure_pool_free(pool, slots[i]);
+    }
+    sodium_secure_pool_free(pool, NULL);
+    sodium_secure_pool_destroy(pool);
+
+    pool = sodium_secure_pool_create(4096U - 32U, 2U);
+    assert(pool != NULL);
+    slot = (unsigned char *) sodium_secure_pool_alloc(pool);
+    assert(slot != NULL);
+    if (sodium_secure_pool_mprotect_readonly(pool, slot) == 0) {
+        assert(slot[0] == 0xdb);
+        assert(sodium_secure_pool_mprotect_noaccess(pool, slot) == 0);
+        assert(sodium_secure_pool_mprotect_readwrite(pool, slot) == 0);
+        slot[0] = 0;
+        assert(sodium_secure_pool_mprotect_noaccess(pool, slot) == 0);
+    }
+    sodium_secure_pool_free(pool, slot);
+    sodium_secure_pool_destroy(pool);
+}
+
+static void
+secure_memory_stats_tests(void)
+{
+    sodium_secure_memory_stats before;
+    sodium_secure_memory_stats stats;
+    sodium_secure_pool        *pool;
+    void                      *buf1;
+    void                      *buf2;
+
+    assert(sodium_secure_memory_stats_get(&before) == 0);
+    buf1 = sodium_malloc(100U);
+    buf2 = sodium_malloc(10000U);
+    assert(buf1 != NULL && buf2 != NULL);
+    assert(sodium_secure_memory_stats_get(&stats) == 0);
+    if (stats.allocations == before.allocations) {
+        sodium_free(buf1);
+        sodium_free(buf2);
+        return;
+    }
+    assert(stats.allocations == before.allocations + 2U);
+    assert(stats.requested_bytes == before.requested_bytes + 10100U);
+    assert(stats.mapped_bytes >= before.mapped_bytes + 10100U + 6U * 4096U);
+    assert(stats.locked_bytes <= stats.mapped_bytes);
+    assert(stats.allocations_max >= stats.allocations);
+    assert(stats.requested_bytes_max >= stats.requested_bytes);
+    assert(stats.mapped_bytes_max >= stats.mapped_bytes);
+    assert(stats.locked_bytes_max >= stats.locked_bytes);
+    sodium_free(buf1);
+
+    pool = sodium_secure_pool_create(32U, 4U);
+    assert(pool != NULL);
+    assert(sodium_secure_memory_stats_get(&stats) == 0);
+    assert(stats.allocations == before.allocations + 2U);
+    assert(stats.requested_bytes == before.requested_bytes + 10000U + 128U);
+    sodium_secure_pool_destroy(pool);
+
+    sodium_free(buf2);
+    assert(sodium_secure_memory_stats_get(&stats) == 0);
+    assert(stats.allocations == before.allocations);
+    assert(stats.requested_bytes == before.requested_bytes);
+    assert(stats.mapped_bytes == before.mapped_bytes);
+    assert(stats.locked_bytes == before.locked_bytes);
+    assert(stats.requested_bytes_max >= before.requested_bytes + 10100U);
+}
+
 int
 main(void)
 {
@@ -73,6 +172,8 @@ main(void)
         sodium_mprotect_noaccess(buf);
         sodium_free(buf);
     }
+    secure_pool_tests();
+    secure_memory_stats_tests();
     printf("OK\n");
 #ifdef SIG_DFL
 # ifdef SIGSEGV
@@ -0,0 +1,312 @@
+
+#define TEST_NAME "softaes"
+static int soft_forced;
+#define TEST_BEFORE_INIT() \
+    (void) (soft_forced = sodium_set_implementation("aes", "soft") == 0)
+#include "cmptest.h"
+
+/*
+ * The expected output was computed with the AES-NI implementations,
+ * so that this checks that the portable ones compute the same thing.
+ */
+
+#define MAX_LEN 300
+
+static const size_t lens[] = { 0, 1, 15, 16, 17, 47, 48, 49, 63, 64,
+                               65, 127, 128, 129, 255, 256, 257, MAX_LEN };
+
+static unsigned char k[32];
+static unsigned char npub[32];
+static unsigned char m[MAX_LEN];
+static unsigned char ad[MAX_LEN];
+static unsigned char c[MAX_LEN + 32];
+static unsigned char c2[MAX_LEN + 32];
+static unsigned char m2[MAX_LEN];
+static unsigned char mac[32];
+static unsigned char mac2[32];
+
+static void
+fill(unsigned char *buf, size_t len, unsigned char seed)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        buf[i] = (unsigned char) (seed + i * 7U);
+    }
+}
+
+static void
+setup(size_t len, size_t *adlen_p)
+{
+    fill(k, sizeof k, (unsigned char) len);
+    fill(npub, sizeof npub, (unsigned char) (len + 1U));
+    fill(m, len, (unsigned char) (len + 2U));
+    *adlen_p = len % 37U;
+    fill(ad, *adlen_p, (unsigned char) (len + 3U));
+}
+
+static void
+print_digest(const char *name, size_t len, const unsigned char *buf, size_t buf_len)
+{
+    unsigned char h[16];
+    char          hex[2 * sizeof h + 1];
+
+    crypto_generichash(h, sizeof h, buf, buf_len, NULL, 0);
+    sodium_bin2hex(hex, sizeof hex, h, sizeof h);
+    printf("%s %u %s\n", name, (unsigned int) len, hex);
+}
+
+static void
+check_same(size_t len, size_t maclen)
+{
+    assert(memcmp(c, c2, len) == 0);
+    assert(memcmp(mac, mac2, maclen) == 0);
+}
+
+/* Splits buf into 3 fragments, at different offsets for the input and the output */
+static void
+split3(crypto_aead_iovec iov[3], unsigned char *buf, size_t len, size_t a)
+{
+    size_t b = len / 2U;
+
+    if (a > len) {
+        a = len;
+    }
+    if (b < a) {
+        b = a;
+    }
+    iov[0].ptr = buf;
+    iov[0].len = a;
+    iov[1].ptr = buf + a;
+    iov[1].len = b - a;
+    iov[2].ptr = buf + b;
+    iov[2].len = len - b;
+}
+
+static void
+tv_aes256gcm(void)
+{
+    crypto_aead_aes256gcm_state        *ctx;
+    crypto_aead_aes256gcm_compact_key  *ck;
+    crypto_aead_aes256gcm_stream_state  st;
+    crypto_aead_iovec                   m_iov[3], c_iov[3], ad_iov[3];
+    size_t                              i, len, adlen, j, n;
+
+    ctx = (crypto_aead_aes256gcm_state *) sodium_malloc(sizeof *ctx);
+    ck  = (crypto_aead_aes256gcm_compact_key *) sodium_malloc(sizeof *ck);
+    for (i = 0; i < sizeof lens / sizeof lens[0]; i++) {
+        len = lens[i];
+        setup(len, &adlen);
+        crypto_aead_aes256gcm_encrypt_detached(c, mac, NULL, m, len, ad, adlen,
+                                               NULL, npub, k);
+        memcpy(c + len, mac, crypto_aead_aes256gcm_ABYTES);
+        print_digest("aes256gcm", len, c, len + crypto_aead_aes256gcm_ABYTES);
+
+        crypto_aead_aes256gcm_beforenm(ctx, k);
+        crypto_aead_aes256gcm_encrypt_detached_afternm(c2, mac2, NULL, m, len, ad, adlen,
+                                                       NULL, npub, ctx);
+        check_same(len, crypto_aead_aes256gcm_ABYTES);
+
+        crypto_aead_aes256gcm_compact_beforenm(ck, k, 1U);
+        crypto_aead_aes256gcm_encrypt_detached_compact(c2, mac2, NULL, m, len, ad, adlen,
+                                                       NULL, npub, ck);
+        check_same(len, crypto_aead_aes256gcm_ABYTES);
+
+        crypto_aead_aes256gcm_init(&st, npub, ctx);
+        crypto_aead_aes256gcm_update_ad(&st, ad, adlen / 3U);
+        crypto_aead_aes256gcm_update_ad(&st, ad + adlen / 3U, adlen - adlen / 3U);
+        for (j = 0; j < len; j += n) {
+            n = (j * 5U) % 71U + 1U;
+            if (n > len - j) {
+                n = len - j;
+            }
+            crypto_aead_aes256gcm_encrypt_update(&st, c2 + j, m + j, n);
+        }
+        crypto_aead_aes256gcm_encrypt_final(&st, mac2);
+        check_same(len, crypto_aead_aes256gcm_ABYTES);
+
+        split3(m_iov, m, len, 5U);
+        split3(c_iov, c2, len, 21U);
+        split3(ad_iov, ad, adlen, 3U);
+        memset(c2, 0, len);
+        assert(crypto_aead_aes256gcm_encrypt_detached_iov(c_iov, 3U, mac2, NULL, m_iov, 3U,
+                                                          ad_iov, 3U, NULL, npub, k) == 0);
+        check_same(len, crypto_aead_aes256gcm_ABYTES);
+
+        assert(crypto_aead_aes256gcm_decrypt_detached(m2, NULL, c, len, mac, ad, adlen,
+                                                      npub, k) == 0);
+        assert(memcmp(m, m2, len) == 0);
+        split3(m_iov, m2, len, 9U);
+        split3(c_iov, c, len, 1U);
+        memset(m2, 0, len);
+        assert(crypto_aead_aes256gcm_decrypt_detached_iov(m_iov, 3U, NULL, c_iov, 3U, mac,
+                                                          ad_iov, 3U, npub, k) == 0);
+        assert(memcmp(m, m2, len) == 0);
+        assert(crypto_aead_aes256gcm_decrypt_detached_iov(NULL, 0U, NULL, c_iov, 3U, mac,
+                                                          ad_iov, 3U, npub, k) == 0);
+
+        crypto_aead_aes256gcm_init(&st, npub, ctx);
+        crypto_aead_aes256gcm_update_ad(&st, ad, adlen);
+        memcpy(m2, c, len);
+        for (j = 0; j < len; j += n) {
+            n = (j * 3U) % 67U + 1U;
+            if (n > len - j) {
+                n = len - j;
+            }
+            crypto_aead_aes256gcm_decrypt_update(&st, m2 + j, m2 + j, n);
+        }
+        assert(crypto_aead_aes256gcm_decrypt_final(&st, mac) == 0);
+        assert(memcmp(m, m2, len) == 0);
+
+        mac[0] ^= 1;
+        assert(crypto_aead_aes256gcm_decrypt_detached(m2, NULL, c, len, mac, ad, adlen,
+                                                      npub, k) == -1);
+        assert(sodium_is_zero(m2, len));
+        assert(crypto_aead_aes256gcm_decrypt_detached_afternm(NULL, NULL, c, len, mac,
+                                                              ad, adlen, npub, ctx) == -1);
+    }
+    sodium_free(ck);
+    sodium_free(ctx);
+}
+
+static void
+tv_aegis256(void)
+{
+    crypto_aead_aegis256_state st;
+    crypto_aead_iovec          m_iov[3], c_iov[3], ad_iov[3];
+    size_t                     i, len, adlen, j, n;
+
+    for (i = 0; i < sizeof lens / sizeof lens[0]; i++) {
+        len = lens[i];
+        setup(len, &adlen);
+        crypto_aead_aegis256_encrypt_detached(c, mac, NULL, m, len, ad, adlen,
+                                              NULL, npub, k);
+        memcpy(c + len, mac, crypto_aead_aegis256_ABYTES);
+        print_digest("aegis256", len, c, len + crypto_aead_aegis256_ABYTES);
+
+        crypto_aead_aegis256_init(&st, npub, k);
+        crypto_aead_aegis256_update_ad(&st, ad, adlen / 3U);
+        crypto_aead_aegis256_update_ad(&st, ad + adlen / 3U, adlen - adlen / 3U);
+        for (j = 0; j < len; j += n) {
+            n = (j * 5U) % 71U + 1U;
+            if (n > len - j) {
+                n = len - j;
+            }
+            crypto_aead_aegis256_encrypt_update(&st, c2 + j, m + j, n);
+        }
+        crypto_aead_aegis256_encrypt_final(&st, mac2);
+        check_same(len, crypto_aead_aegis256_ABYTES);
+
+        split3(m_iov, m, len, 5U);
+        split3(c_iov, c2, len, 21U);
+        split3(ad_iov, ad, adlen, 3U);
+        memset(c2, 0, len);
+        assert(crypto_aead_aegis256_encrypt_detached_iov(c_iov, 3U, mac2, NULL, m_iov, 3U,
+                                                         ad_iov, 3U, NULL, npub, k) == 0);
+        check_same(len, crypto_aead_aegis256_ABYTES);
+
+        assert(crypto_aead_aegis256_decrypt_detached(m2, NULL, c, len, mac, ad, adlen,
+                                                     npub, k) == 0);
+        assert(memcmp(m, m2, len) == 0);
+
+        crypto_aead_aegis256_mac(mac2, 32U, m, len, npub, k);
+        print_digest("aegis256_mac", len, mac2, 32U);
+
+        mac[0] ^= 1;
+        assert(crypto_aead_aegis256_decrypt_detached(m2, NULL, c, len, mac, ad, adlen,
+                                                     npub, k) == -1);
+    }
+}
+
+static void
+tv_aegis128l(void)
+{
+    crypto_aead_aegis128l_state st;
+    crypto_aead_iovec           m_iov[3], c_iov[3], ad_iov[3];
+    size_t                      i, len, adlen, j, n;
+
+    for (i = 0; i < sizeof lens / sizeof lens[0]; i++) {
+        len = lens[i];
+        setup(len, &adlen);
+        crypto_aead_aegis128l_encrypt_detached(c, mac, NULL, m, len, ad, adlen,
+                                               NULL, npub, k);
+        memcpy(c + len, mac, crypto_aead_aegis128l_ABYTES);
+        print_digest("aegis128l", len, c, len + crypto_aead_aegis128l_ABYTES);
+
+        crypto_aead_aegis128l_init(&st, npub, k);
+        crypto_aead_aegis128l_update_ad(&st, ad, adlen / 3U);
+        crypto_aead_aegis128l_update_ad(&st, ad + adlen / 3U, adlen - adlen / 3U);
+        for (j = 0; j < len; j += n) {
+            n = (j * 5U) % 71U + 1U;
+            if (n > len - j) {
+                n = len - j;
+            }
+            crypto_aead_aegis128l_encrypt_update(&st, c2 + j, m + j, n);
+        }
+        crypto_aead_aegis128l_encrypt_final(&st, mac2);
+        check_same(len, crypto_aead_aegis128l_ABYTES);
+
+        split3(m_iov, m, len, 5U);
+        split3(c_iov, c2, len, 21U);
+        split3(ad_iov, ad, adlen, 3U);
+        memset(c2, 0, len);
+        assert(crypto_aead_aegis128l_encrypt_detached_iov(c_iov, 3U, mac2, NULL, m_iov, 3U,
+                                                          ad_iov, 3U, NULL, npub, k) == 0);
+        check_same(len, crypto_aead_aegis128l_ABYTES);
+
+        assert(crypto_aead_aegis128l_decrypt_detached(m2, NULL, c, len, mac, ad, adlen,
+                                                      npub, k) == 0);
+        assert(memcmp(m, m2, len) == 0);
+
+        crypto_aead_aegis128l_mac(mac2, 32U, m, len, npub, k);
+        print_digest("aegis128l_mac", len, mac2, 32U);
+
+        mac[0] ^= 1;
+        assert(crypto_aead_aegis128l_decrypt_detached(m2, NULL, c, len, mac, ad, adlen,
+                                                      npub, k) == -1);
+    }
+}
+
+#define TV_AEGISX(NAME)                                                           \
+    static void tv_##NAME(void)                                                   \
+    {                                                                             \
+        size_t i, len, adlen;                                                     \
+                                                                                  \
+        for (i = 0; i < sizeof lens / sizeof lens[0]; i++) {                      \
+            len = lens[i];                                                        \
+            setup(len, &adlen);                                                   \
+            crypto_aead_##NAME##_encrypt_detached(c, mac, NULL, m, len, ad, adlen, \
+                                                  NULL, npub, k);                 \
+            memcpy(c + len, mac, crypto_aead_##NAME##_ABYTES);                    \
+            print_digest(#NAME, len, c, len + crypto_aead_##NAME##_ABYTES);       \
+            assert(crypto_aead_##NAME##_decrypt_detached(m2, NULL, c, len, mac,   \
+                                                         ad, adlen, npub, k) == 0); \
+            assert(memcmp(m, m2, len) == 0);                                      \
+        }                                                                         \
+    }
+
+TV_AEGISX(aegis128x2)
+TV_AEGISX(aegis128x4)
+TV_AEGISX(aegis256x2)
+TV_AEGISX(aegis256x4)
+
+int
+main(void)
+{
+    if (soft_forced) {
+        assert(strcmp(sodium_implementation_name("aes"), "soft") == 0);
+    }
+    assert(crypto_aead_aes256gcm_is_available());
+    assert(crypto_aead_aegis256_is_available());
+    assert(crypto_aead_aegis128l_is_available());
+    tv_aes256gcm();
+    tv_aegis256();
+    tv_aegis128l();
+    tv_aegis128x2();
+    tv_aegis128x4();
+    tv_aegis256x2();
+    tv_aegis256x4();
+    printf("OK\n");
+
+    return 0;
+}
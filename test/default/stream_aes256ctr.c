@@ -0,0 +1,92 @@
+
+#define TEST_NAME "stream_aes256ctr"
+#include "cmptest.h"
+
+static void
+tv(void)
+{
+    /* NIST SP 800-38A, F.5.5 */
+    static const char key_hex[] =
+        "603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4";
+    static const char nonce_hex[] = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+    static const char message_hex[] =
+        "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+        "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+    static const char ciphertext_hex[] =
+        "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+        "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6";
+    /* the counter carries into the upper 64 bits */
+    static const char carry_nonce_hex[] = "0102030405060708fffffffffffffffd";
+    static const char carry_stream_hex[] =
+        "efbfe7e05e17d69f2f195823598a492d27130fc91d62ec45c3f23b716912c933"
+        "cc832ea242a984d3c4c4d8089c0c4cc316fa19273ace87f3b83601e02245f14d"
+        "4b673a388d251b6c4231672a591c3de0f6a171d4cd2a3aa95835a0bd3ddc0cfa"
+        "e9ddd5f172eb8fec0bc76f58fe4ec0837452a3eaae856e6729e580655745bce1"
+        "a2f422cc21881f7ac4f7d9179549355c795a4bcb190b925778ec1c5549db3e4a"
+        "2d88fd68320240711bbd8ea162a86010919d5b9c5de0af908d2092bf3774f813"
+        "789c30b86b7815465a228d88807ce63a866083958af2710b5f32737c4aa0ed1d"
+        "f88ef79665b4dd344dac30101be704178e046a657be38d228ec60408145b82f4"
+        "b3b5e11b97c428ae2224a240b495d601be967167c4b329201c9550ba5024d796"
+        "729a7f251f454cf664d7f637"
+        ;
+    crypto_stream_aes256ctr_state st;
+    unsigned char                 key[crypto_stream_aes256ctr_KEYBYTES];
+    unsigned char                 nonce[crypto_stream_aes256ctr_NONCEBYTES];
+    unsigned char                 message[64];
+    unsigned char                 expected[300];
+    unsigned char                 out[300];
+    unsigned char                 out2[300];
+    unsigned int                  i;
+
+    sodium_hex2bin(key, sizeof key, key_hex, strlen(key_hex), NULL, NULL, NULL);
+    sodium_hex2bin(nonce, sizeof nonce, nonce_hex, strlen(nonce_hex), NULL, NULL, NULL);
+    sodium_hex2bin(message, sizeof message, message_hex, strlen(message_hex),
+                   NULL, NULL, NULL);
+    sodium_hex2bin(expected, sizeof message, ciphertext_hex, strlen(ciphertext_hex),
+                   NULL, NULL, NULL);
+    crypto_stream_aes256ctr_xor(out, message, sizeof message, nonce, key);
+    assert(memcmp(out, expected, sizeof message) == 0);
+
+    crypto_stream_aes256ctr_beforenm(&st, key);
+    crypto_stream_aes256ctr_block_afternm(out, nonce, &st);
+    for (i = 0; i < 16; i++) {
+        out[i] ^= message[i];
+    }
+    assert(memcmp(out, expected, 16) == 0);
+    crypto_stream_aes256ctr_xor_ic_afternm(out, message + 32, 32, nonce, 2U, &st);
+    assert(memcmp(out, expected + 32, 32) == 0);
+
+    sodium_hex2bin(nonce, sizeof nonce, carry_nonce_hex, strlen(carry_nonce_hex),
+                   NULL, NULL, NULL);
+    sodium_hex2bin(expected, sizeof expected, carry_stream_hex, strlen(carry_stream_hex),
+                   NULL, NULL, NULL);
+    crypto_stream_aes256ctr(out, sizeof out, nonce, key);
+    assert(memcmp(out, expected, sizeof out) == 0);
+
+    for (i = 0; i < 18; i++) {
+        memset(out2, 0, sizeof out2);
+        crypto_stream_aes256ctr_xor_ic(out2, out2, sizeof out2 - 16 * i, nonce, i, key);
+        assert(memcmp(out2, expected + 16 * i, sizeof out2 - 16 * i) == 0);
+    }
+    memcpy(out2, out, sizeof out2);
+    crypto_stream_aes256ctr_xor(out2, out2, sizeof out2, nonce, key);
+    assert(sodium_is_zero(out2, sizeof out2));
+    sodium_memzero(&st, sizeof st);
+}
+
+int
+main(void)
+{
+    if (crypto_stream_aes256ctr_is_available()) {
+        tv();
+    }
+    assert(crypto_stream_aes256ctr_keybytes() == crypto_stream_aes256ctr_KEYBYTES);
+    assert(crypto_stream_aes256ctr_noncebytes() == crypto_stream_aes256ctr_NONCEBYTES);
+    assert(crypto_stream_aes256ctr_blockbytes() == crypto_stream_aes256ctr_BLOCKBYTES);
+    assert(crypto_stream_aes256ctr_messagebytes_max() ==
+           crypto_stream_aes256ctr_MESSAGEBYTES_MAX);
+    assert(crypto_stream_aes256ctr_statebytes() == sizeof(crypto_stream_aes256ctr_state));
+    printf("OK\n");
+
+    return 0;
+}
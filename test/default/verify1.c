@@ -9,6 +9,8 @@ main(void)
     unsigned char *v32, *v32x;
     unsigned char *v64, *v64x;
     uint32_t       r;
+    static const size_t lens[] = { 0, 1, 7, 8, 15, 16, 17, 31, 32, 33,
+                                   48, 63, 64, 65, 100, 1000 };
     uint8_t        o;
     int            i;
 
@@ -61,6 +63,25 @@ main(void)
     }
     printf("OK\n");
 
+    for (i = 0; i < (int) (sizeof lens / sizeof lens[0]); i++) {
+        unsigned char *a = (unsigned char *) sodium_malloc(lens[i]);
+        unsigned char *b = (unsigned char *) sodium_malloc(lens[i]);
+        size_t         j;
+
+        randombytes_buf(a, lens[i]);
+        memcpy(b, a, lens[i]);
+        assert(crypto_verify_n(a, b, lens[i]) == 0);
+        for (j = 0U; j < lens[i] * 8U; j++) {
+            b[j / 8U] ^= (unsigned char) (1U << (j % 8U));
+            assert(crypto_verify_n(a, b, lens[i]) == -1);
+            assert(crypto_verify_n(a, b, j / 8U) == 0);
+            b[j / 8U] ^= (unsigned char) (1U << (j % 8U));
+        }
+        assert(crypto_verify_n(a, b, lens[i]) == 0);
+        sodium_free(a);
+        sodium_free(b);
+    }
+
     assert(crypto_verify_16_bytes() == 16U);
     assert(crypto_verify_32_bytes() == 32U);
     assert(crypto_verify_64_bytes() == 64U);
@@ -211,6 +211,7 @@ tv_secretbox_xchacha20poly1305(void)
         { "7b043dd27476cf5a2baf2907541d8241ecd8b97d38d08911737e69b0846732fb", "74706a2855f946ed600e9b453c1ac372520b6a76a3c48a76", "dbf165bb8352d6823991b99f3981ba9c8153635e5695477cba54e96a2a8c4dc5f9dbe817887d7340e3f48a", "ce57261afba90a9598de15481c43f26f7b8c8cb2806c7c977752dba898dc51b92a3f1a62ebf696747bfccf72e0edda97f2ccd6d496f55aefbb3ec2" },
         { "e588e418d658df1b2b1583122e26f74ca3506b425087bea895d81021168f8164", "4f4d0ffd699268cd841ce4f603fe0cd27b8069fcf8215fbb", "f91bcdcf4d08ba8598407ba8ef661e66c59ca9d89f3c0a3542e47246c777091e4864e63e1e3911dc01257255e551527a53a34481be", "22dc88de7cacd4d9ce73359f7d6e16e74caeaa7b0d1ef2bb10fda4e79c3d5a9aa04b8b03575fd27bc970c9ed0dc80346162469e0547030ddccb8cdc95981400907c87c9442" }
     };
+    crypto_secretbox_xchacha20poly1305_precomputed pre;
     const XChaCha20Poly1305TV *tv;
     unsigned char             *m;
     unsigned char             *nonce;
@@ -281,6 +282,25 @@ tv_secretbox_xchacha20poly1305(void)
              m_len, nonce, key);
         assert(memcmp(out, out2,
                       crypto_secretbox_xchacha20poly1305_MACBYTES + m_len) == 0);
+        assert(crypto_secretbox_xchacha20poly1305_beforenm(&pre, nonce, key) == 0);
+        memset(out2, 0, crypto_secretbox_xchacha20poly1305_MACBYTES + m_len);
+        assert(crypto_secretbox_xchacha20poly1305_easy_afternm
+               (out2, m, m_len,
+                nonce + crypto_secretbox_xchacha20poly1305_NONCEPREFIXBYTES, &pre) == 0);
+        assert(memcmp(out, out2,
+                      crypto_secretbox_xchacha20poly1305_MACBYTES + m_len) == 0);
+        assert(crypto_secretbox_xchacha20poly1305_open_easy_afternm
+               (out2, out2, crypto_secretbox_xchacha20poly1305_MACBYTES + m_len,
+                nonce + crypto_secretbox_xchacha20poly1305_NONCEPREFIXBYTES, &pre) == 0);
+        assert(memcmp(m, out2, m_len) == 0);
+        out[n]++;
+        assert(crypto_secretbox_xchacha20poly1305_open_easy_afternm
+               (out2, out, crypto_secretbox_xchacha20poly1305_MACBYTES + m_len,
+                nonce + crypto_secretbox_xchacha20poly1305_NONCEPREFIXBYTES, &pre) == -1);
+        out[n]--;
+        assert(crypto_secretbox_xchacha20poly1305_open_easy_afternm
+               (out2, out, crypto_secretbox_xchacha20poly1305_MACBYTES - 1,
+                nonce + crypto_secretbox_xchacha20poly1305_NONCEPREFIXBYTES, &pre) == -1);
         sodium_free(out);
         sodium_free(out2);
         sodium_free(m);
@@ -416,11 +436,36 @@ tv_box_xchacha20poly1305(void)
     printf("tv_box_xchacha20poly1305: ok\n");
 }
 
+static void
+tv_stream_xchacha20_parallel(void)
+{
+    unsigned char  key[crypto_stream_xchacha20_KEYBYTES];
+    unsigned char  nonce[crypto_stream_xchacha20_NONCEBYTES];
+    unsigned char *m;
+    unsigned char *c;
+    unsigned char *c2;
+    size_t         mlen = 2 * 1024 * 1024 + 1;
+
+    m = (unsigned char *) sodium_malloc(mlen);
+    c = (unsigned char *) sodium_malloc(mlen);
+    c2 = (unsigned char *) sodium_malloc(mlen);
+    crypto_stream_xchacha20_keygen(key);
+    randombytes_buf(nonce, sizeof nonce);
+    randombytes_buf(m, mlen);
+    crypto_stream_xchacha20_xor_ic(c, m, mlen, nonce, 7U, key);
+    crypto_stream_xchacha20_xor_ic_parallel(c2, m, mlen, nonce, 7U, key, 4U);
+    assert(memcmp(c, c2, mlen) == 0);
+    sodium_free(c2);
+    sodium_free(c);
+    sodium_free(m);
+}
+
 int
 main(void)
 {
     tv_hchacha20();
     tv_stream_xchacha20();
+    tv_stream_xchacha20_parallel();
     tv_secretbox_xchacha20poly1305();
     tv_box_xchacha20poly1305();
 